@@ -0,0 +1,303 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+/**
+ * lovepack: builds a LOVE pack (.lpk) archive from a directory.
+ *
+ * Usage: lovepack [-a alignment] [-c none|lz4] <directory> <output.lpk>
+ *
+ * Files are LZ4 compressed when that makes them meaningfully smaller, and
+ * stored as-is otherwise. Every file's contents start at a multiple of the
+ * alignment (16 bytes by default), so stored files which are mapped with
+ * love.filesystem.mapFile can be handed to the GPU without being copied.
+ **/
+
+#include "modules/filesystem/PackFormat.h"
+#include "libraries/lz4/lz4.h"
+#include "libraries/lz4/lz4hc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace love;
+using namespace love::filesystem;
+namespace fs = std::filesystem;
+
+struct PackItem
+{
+	std::string name;
+	fs::path path;
+	bool directory;
+	int64 modtime;
+	std::vector<size_t> children;
+	pack::Entry entry;
+};
+
+static int64 getModTime(const fs::path &path)
+{
+	std::error_code ec;
+	auto ftime = fs::last_write_time(path, ec);
+	if (ec)
+		return -1;
+
+	auto stime = std::chrono::time_point_cast<std::chrono::system_clock::duration>(ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
+	return (int64) std::chrono::system_clock::to_time_t(stime);
+}
+
+static bool readFile(const fs::path &path, std::vector<char> &contents)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	std::streamsize size = file.tellg();
+	file.seekg(0);
+	contents.resize((size_t) size);
+	return size == 0 || (bool) file.read(contents.data(), size);
+}
+
+static void pad(std::ofstream &out, uint64 alignment)
+{
+	static const char zeros[4096] = {};
+	uint64 pos = (uint64) out.tellp();
+	uint64 aligned = (pos + alignment - 1) / alignment * alignment;
+	while (pos < aligned)
+	{
+		uint64 n = std::min<uint64>(aligned - pos, sizeof(zeros));
+		out.write(zeros, (std::streamsize) n);
+		pos += n;
+	}
+}
+
+static int usage()
+{
+	fprintf(stderr, "Usage: lovepack [-a alignment] [-c none|lz4] <directory> <output.lpk>\n");
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	uint32 alignment = 16;
+	bool compress = true;
+	std::vector<std::string> args;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+			alignment = (uint32) strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			const char *mode = argv[++i];
+			if (strcmp(mode, "lz4") == 0)
+				compress = true;
+			else if (strcmp(mode, "none") == 0)
+				compress = false;
+			else
+				return usage();
+		}
+		else
+			args.push_back(argv[i]);
+	}
+
+	if (args.size() != 2 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+		return usage();
+
+	fs::path root = args[0];
+	std::error_code ec;
+	if (!fs::is_directory(root, ec))
+	{
+		fprintf(stderr, "lovepack: %s is not a directory.\n", args[0].c_str());
+		return 1;
+	}
+
+	// Gather everything, with the root directory first.
+	std::vector<PackItem> items;
+	items.push_back({"", root, true, getModTime(root), {}, {}});
+
+	std::vector<fs::path> paths;
+	for (auto it = fs::recursive_directory_iterator(root, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+	{
+		if (it->is_directory(ec) || it->is_regular_file(ec))
+			paths.push_back(it->path());
+	}
+
+	if (ec)
+	{
+		fprintf(stderr, "lovepack: could not read %s: %s\n", args[0].c_str(), ec.message().c_str());
+		return 1;
+	}
+
+	std::sort(paths.begin(), paths.end());
+
+	for (const fs::path &path : paths)
+	{
+		std::string name = fs::relative(path, root, ec).generic_string();
+		bool directory = fs::is_directory(path, ec);
+		items.push_back({name, path, directory, getModTime(path), {}, {}});
+	}
+
+	// Link every item to its parent directory. Paths are sorted, so parents
+	// have already been added.
+	for (size_t i = 1; i < items.size(); i++)
+	{
+		size_t slash = items[i].name.rfind('/');
+		std::string parent = slash == std::string::npos ? "" : items[i].name.substr(0, slash);
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (items[j].directory && items[j].name == parent)
+			{
+				items[j].children.push_back(i);
+				break;
+			}
+		}
+	}
+
+	// The entry table is sorted by path hash, for binary searching.
+	std::vector<size_t> order(items.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		items[i].entry = {};
+		items[i].entry.hash = pack::hashPath(items[i].name.c_str(), items[i].name.size());
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+	{
+		if (items[a].entry.hash != items[b].entry.hash)
+			return items[a].entry.hash < items[b].entry.hash;
+		return items[a].name < items[b].name;
+	});
+
+	std::vector<uint32> sortedIndex(items.size());
+	for (size_t i = 0; i < order.size(); i++)
+		sortedIndex[order[i]] = (uint32) i;
+
+	std::string names;
+	std::vector<uint32> children;
+
+	for (PackItem &item : items)
+	{
+		item.entry.nameOffset = (uint32) names.size();
+		item.entry.nameLength = (uint32) item.name.size();
+		item.entry.modtime = item.modtime;
+		names += item.name;
+
+		if (item.directory)
+		{
+			item.entry.flags = pack::ENTRY_DIRECTORY;
+			item.entry.offset = children.size();
+			item.entry.size = item.children.size();
+			for (size_t child : item.children)
+				children.push_back(sortedIndex[child]);
+		}
+	}
+
+	pack::Header header = {};
+	memcpy(header.magic, pack::MAGIC, sizeof(header.magic));
+	header.version = pack::VERSION;
+	header.entryCount = (uint32) items.size();
+	header.childCount = (uint32) children.size();
+	header.alignment = alignment;
+	header.entriesOffset = sizeof(pack::Header);
+	header.childrenOffset = header.entriesOffset + items.size() * sizeof(pack::Entry);
+	header.namesOffset = header.childrenOffset + children.size() * sizeof(uint32);
+	header.namesSize = names.size();
+
+	std::ofstream out(args[1], std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		fprintf(stderr, "lovepack: could not open %s for writing.\n", args[1].c_str());
+		return 1;
+	}
+
+	// The index size doesn't depend on the contents, so the contents are
+	// written first and the index is filled in afterwards.
+	out.seekp((std::streamoff) (header.namesOffset + header.namesSize));
+
+	std::vector<char> contents;
+	std::vector<char> compressed;
+	uint64 storedTotal = 0;
+	uint64 uncompressedTotal = 0;
+
+	for (PackItem &item : items)
+	{
+		if (item.directory)
+			continue;
+
+		if (!readFile(item.path, contents))
+		{
+			fprintf(stderr, "lovepack: could not read %s.\n", item.path.string().c_str());
+			return 1;
+		}
+
+		const char *data = contents.data();
+		uint64 size = contents.size();
+		item.entry.compression = pack::COMPRESSION_NONE;
+
+		if (compress && size > 0 && size <= (uint64) LZ4_MAX_INPUT_SIZE)
+		{
+			compressed.resize((size_t) LZ4_compressBound((int) size));
+			int n = LZ4_compress_HC(contents.data(), compressed.data(), (int) size, (int) compressed.size(), LZ4HC_CLEVEL_DEFAULT);
+
+			// Not worth decompressing for less than an eighth saved.
+			if (n > 0 && (uint64) n < size - size / 8)
+			{
+				data = compressed.data();
+				size = (uint64) n;
+				item.entry.compression = pack::COMPRESSION_LZ4;
+			}
+		}
+
+		pad(out, alignment);
+
+		item.entry.offset = (uint64) out.tellp();
+		item.entry.size = size;
+		item.entry.uncompressedSize = contents.size();
+		out.write(data, (std::streamsize) size);
+
+		storedTotal += size;
+		uncompressedTotal += contents.size();
+	}
+
+	out.seekp(0);
+	out.write((const char *) &header, sizeof(header));
+	for (size_t i : order)
+		out.write((const char *) &items[i].entry, sizeof(pack::Entry));
+	out.write((const char *) children.data(), (std::streamsize) (children.size() * sizeof(uint32)));
+	out.write(names.data(), (std::streamsize) names.size());
+
+	if (!out)
+	{
+		fprintf(stderr, "lovepack: could not write %s.\n", args[1].c_str());
+		return 1;
+	}
+
+	printf("lovepack: wrote %zu entries, %llu of %llu bytes stored.\n", items.size(),
+		(unsigned long long) storedTotal, (unsigned long long) uncompressedTotal);
+	return 0;
+}
@@ -133,6 +133,64 @@ void Matrix4::multiply(const Matrix4 &a, const Matrix4 &b, Matrix4 &t)
 	multiply(a, b, t.e);
 }
 
+static_assert(sizeof(Vector2) == sizeof(float) * 2, "Vector2 must be tightly packed for Matrix4::transformXY.");
+
+void Matrix4::transformXY(Vector2 *dst, const Vector2 *src, int size) const
+{
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	__m128 e0 = _mm_set1_ps(e[0]);
+	__m128 e1 = _mm_set1_ps(e[1]);
+	__m128 e4 = _mm_set1_ps(e[4]);
+	__m128 e5 = _mm_set1_ps(e[5]);
+	__m128 e12 = _mm_set1_ps(e[12]);
+	__m128 e13 = _mm_set1_ps(e[13]);
+
+	for (; i + 4 <= size; i += 4)
+	{
+		// Both loads happen before the stores, in case src = dst.
+		__m128 xy01 = _mm_loadu_ps(&src[i + 0].x);
+		__m128 xy23 = _mm_loadu_ps(&src[i + 2].x);
+
+		__m128 x = _mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 y = _mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 1, 3, 1));
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e0, x), _mm_mul_ps(e4, y)), e12);
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1, x), _mm_mul_ps(e5, y)), e13);
+
+		_mm_storeu_ps(&dst[i + 0].x, _mm_unpacklo_ps(rx, ry));
+		_mm_storeu_ps(&dst[i + 2].x, _mm_unpackhi_ps(rx, ry));
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i + 4 <= size; i += 4)
+	{
+		// De-interleaves into 4 x and 4 y components.
+		float32x4x2_t v = vld2q_f32(&src[i].x);
+
+		float32x4x2_t r;
+		r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[12]), v.val[0], e[0]), v.val[1], e[4]);
+		r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[13]), v.val[0], e[1]), v.val[1], e[5]);
+
+		vst2q_f32(&dst[i].x, r);
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		// Store in temp variables in case src = dst
+		float x = (e[0]*src[i].x) + (e[4]*src[i].y) + (e[12]);
+		float y = (e[1]*src[i].x) + (e[5]*src[i].y) + (e[13]);
+
+		dst[i].x = x;
+		dst[i].y = y;
+	}
+}
+
 // | e0 e4 e8  e12 |
 // | e1 e5 e9  e13 |
 // | e2 e6 e10 e14 |
@@ -281,32 +339,50 @@ void Matrix4::setTransformation(float x, float y, float angle, float sx, float s
 	e[13] = y - ox * e[1] - oy * e[5];
 }
 
+// The functions below multiply this matrix by a translation, rotation, scale
+// or shear matrix. Those only affect a couple of columns of the result, so
+// just those are computed instead of doing a full multiplication.
+
 void Matrix4::translate(float x, float y)
 {
-	Matrix4 t;
-	t.setTranslation(x, y);
-	this->operator *=(t);
+	// col3 = col0 * x + col1 * y + col3
+	for (int i = 0; i < 4; i++)
+		e[12 + i] = (e[0 + i] * x) + (e[4 + i] * y) + e[12 + i];
 }
 
 void Matrix4::rotate(float rad)
 {
-	Matrix4 t;
-	t.setRotation(rad);
-	this->operator *=(t);
+	float c = cosf(rad), s = sinf(rad);
+
+	// col0 = col0 * c + col1 * s, col1 = col1 * c - col0 * s
+	for (int i = 0; i < 4; i++)
+	{
+		float col0 = e[0 + i];
+		float col1 = e[4 + i];
+		e[0 + i] = (col0 * c) + (col1 * s);
+		e[4 + i] = (col1 * c) - (col0 * s);
+	}
 }
 
 void Matrix4::scale(float sx, float sy)
 {
-	Matrix4 t;
-	t.setScale(sx, sy);
-	this->operator *=(t);
+	for (int i = 0; i < 4; i++)
+	{
+		e[0 + i] *= sx;
+		e[4 + i] *= sy;
+	}
 }
 
 void Matrix4::shear(float kx, float ky)
 {
-	Matrix4 t;
-	t.setShear(kx,ky);
-	this->operator *=(t);
+	// col0 = col0 + col1 * ky, col1 = col0 * kx + col1
+	for (int i = 0; i < 4; i++)
+	{
+		float col0 = e[0 + i];
+		float col1 = e[4 + i];
+		e[0 + i] = col0 + (col1 * ky);
+		e[4 + i] = (col0 * kx) + col1;
+	}
 }
 
 bool Matrix4::isAffine2DTransform() const
@@ -197,6 +197,13 @@ public:
 	template <typename Vdst, typename Vsrc>
 	void transformXY(Vdst *dst, const Vsrc *src, int size) const;
 
+	/**
+	 * Transforms tightly packed 2-component vertices by this Matrix, four at a
+	 * time when SIMD is available. The source and destination arrays may be
+	 * the same.
+	 **/
+	void transformXY(Vector2 *dst, const Vector2 *src, int size) const;
+
 	/**
 	 * Transforms an array of 2-component vertices by this Matrix, and stores
 	 * them in an array of 3-component vertices.
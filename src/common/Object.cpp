@@ -28,11 +28,15 @@ love::Type Object::type("Object", nullptr);
 
 Object::Object()
 	: count(1)
+	, proxyCacheOwner(nullptr)
+	, proxyCacheSlot(0)
 {
 }
 
 Object::Object(const Object & /*other*/)
 	: count(1) // Always start with a reference count of 1.
+	, proxyCacheOwner(nullptr)
+	, proxyCacheSlot(0)
 {
 }
 
@@ -60,4 +64,20 @@ void Object::release()
 	}
 }
 
+bool Object::claimProxyCache(const void *owner, int slot)
+{
+	const void *expected = nullptr;
+	if (!proxyCacheOwner.compare_exchange_strong(expected, owner, std::memory_order_acq_rel))
+		return false;
+
+	// Only the owner reads the slot, from the same thread that claimed it.
+	proxyCacheSlot = slot;
+	return true;
+}
+
+void Object::releaseProxyCache()
+{
+	proxyCacheOwner.store(nullptr, std::memory_order_release);
+}
+
 } // love
@@ -71,11 +71,24 @@ public:
 	 **/
 	void release();
 
+	/**
+	 * Used by luax_pushtype to find this object's Proxy in a Lua state without
+	 * a hash lookup. The owner identifies the Lua state whose proxy cache
+	 * holds the Proxy, and only that state uses the slot.
+	 **/
+	const void *getProxyCacheOwner() const { return proxyCacheOwner.load(std::memory_order_acquire); }
+	int getProxyCacheSlot() const { return proxyCacheSlot; }
+	bool claimProxyCache(const void *owner, int slot);
+	void releaseProxyCache();
+
 private:
 
 	// The reference count.
 	std::atomic<int> count;
 
+	std::atomic<const void *> proxyCacheOwner;
+	int proxyCacheSlot;
+
 }; // Object
 
 /**
@@ -23,6 +23,7 @@
 #include <stddef.h>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 namespace love
 {
@@ -91,4 +92,77 @@ struct Range
 	}
 };
 
+/**
+ * A sorted list of disjoint ranges. Ranges which are closer together than the
+ * merge distance are coalesced, and if there are more than the maximum number
+ * of ranges they are all merged into one.
+ **/
+class RangeSet
+{
+public:
+
+	RangeSet(size_t mergeDistance = 0, size_t maxRanges = 16)
+		: mergeDistance(mergeDistance)
+		, maxRanges(std::max(maxRanges, (size_t) 1))
+	{}
+
+	bool isValid() const { return !ranges.empty(); }
+	void invalidate() { ranges.clear(); }
+
+	const std::vector<Range> &getRanges() const { return ranges; }
+
+	Range getBounds() const
+	{
+		if (ranges.empty())
+			return Range();
+
+		Range bounds = ranges.front();
+		bounds.encapsulate(ranges.back());
+		return bounds;
+	}
+
+	void encapsulate(size_t index)
+	{
+		encapsulate(index, 1);
+	}
+
+	void encapsulate(size_t offset, size_t size)
+	{
+		if (size == 0)
+			return;
+
+		Range r(offset, size);
+
+		// First existing range which ends within the merge distance of (or
+		// after) the start of the new range.
+		auto it = std::lower_bound(ranges.begin(), ranges.end(), r, [this](const Range &a, const Range &b)
+		{
+			return a.last + mergeDistance + 1 < b.first;
+		});
+
+		auto end = it;
+		while (end != ranges.end() && end->first <= r.last + mergeDistance + 1)
+		{
+			r.encapsulate(*end);
+			++end;
+		}
+
+		it = ranges.erase(it, end);
+		ranges.insert(it, r);
+
+		if (ranges.size() > maxRanges)
+		{
+			Range bounds = getBounds();
+			ranges.clear();
+			ranges.push_back(bounds);
+		}
+	}
+
+private:
+
+	std::vector<Range> ranges;
+	size_t mergeDistance;
+	size_t maxRanges;
+};
+
 } // love
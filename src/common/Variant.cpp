@@ -21,11 +21,187 @@
 #include <memory>
 
 #include "Variant.h"
+#include "common/Exception.h"
 #include "common/StringMap.h"
 
 namespace love
 {
 
+Variant::SharedTable::Reader::Reader(const SharedTable *table)
+	: table(table)
+	, offset(0)
+{
+}
+
+void Variant::SharedTable::Reader::read(void *dst, size_t size)
+{
+	if (offset + size > table->buffer.size())
+		throw love::Exception("Invalid shared table data.");
+
+	memcpy(dst, table->buffer.data() + offset, size);
+	offset += size;
+}
+
+Variant::SharedTable::ValueType Variant::SharedTable::Reader::readType()
+{
+	uint8 type = 0;
+	read(&type, sizeof(type));
+	return (ValueType) type;
+}
+
+double Variant::SharedTable::Reader::readNumber()
+{
+	double number = 0.0;
+	read(&number, sizeof(number));
+	return number;
+}
+
+const char *Variant::SharedTable::Reader::readString(size_t &len)
+{
+	uint64 len64 = 0;
+	read(&len64, sizeof(len64));
+
+	if (offset + len64 > table->buffer.size())
+		throw love::Exception("Invalid shared table data.");
+
+	const char *str = (const char *) table->buffer.data() + offset;
+	offset += (size_t) len64;
+	len = (size_t) len64;
+	return str;
+}
+
+void *Variant::SharedTable::Reader::readLightUserdata()
+{
+	void *userdata = nullptr;
+	read(&userdata, sizeof(userdata));
+	return userdata;
+}
+
+Proxy Variant::SharedTable::Reader::readObject()
+{
+	Proxy proxy = {};
+	read(&proxy.type, sizeof(proxy.type));
+	read(&proxy.object, sizeof(proxy.object));
+	return proxy;
+}
+
+uint32 Variant::SharedTable::Reader::readPairCount()
+{
+	uint32 pairs = 0;
+	read(&pairs, sizeof(pairs));
+	return pairs;
+}
+
+Variant::SharedTable::SharedTable()
+	: pairCount(0)
+{
+}
+
+Variant::SharedTable::~SharedTable()
+{
+	for (Object *object : objects)
+		object->release();
+}
+
+void Variant::SharedTable::add(const Variant &key, const Variant &value)
+{
+	write(key);
+	write(value);
+	pairCount++;
+}
+
+void Variant::SharedTable::writeType(ValueType type)
+{
+	buffer.push_back((uint8) type);
+}
+
+void Variant::SharedTable::writeBytes(const void *src, size_t size)
+{
+	const uint8 *bytes = (const uint8 *) src;
+	buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void Variant::SharedTable::write(const Variant &v)
+{
+	const Data &data = v.getData();
+
+	switch (v.getType())
+	{
+	case BOOLEAN:
+		writeType(data.boolean ? VALUE_TRUE : VALUE_FALSE);
+		break;
+	case NUMBER:
+		writeType(VALUE_NUMBER);
+		writeBytes(&data.number, sizeof(data.number));
+		break;
+	case STRING:
+		writeString(data.string->str, data.string->len);
+		break;
+	case SMALLSTRING:
+		writeString(data.smallstring.str, data.smallstring.len);
+		break;
+	case STATICSTRING:
+		writeString(data.staticstring.str, data.staticstring.len);
+		break;
+	case LUSERDATA:
+		writeType(VALUE_LUSERDATA);
+		writeBytes(&data.userdata, sizeof(data.userdata));
+		break;
+	case LOVEOBJECT:
+		writeType(VALUE_LOVEOBJECT);
+		writeBytes(&data.objectproxy.type, sizeof(data.objectproxy.type));
+		writeBytes(&data.objectproxy.object, sizeof(data.objectproxy.object));
+		if (data.objectproxy.object != nullptr)
+		{
+			data.objectproxy.object->retain();
+			objects.push_back(data.objectproxy.object);
+		}
+		break;
+	case TABLE:
+	{
+		// The nested table's buffer is copied as-is, since it doesn't contain
+		// any offsets.
+		const SharedTable *table = data.table;
+		size_t position = beginTable();
+		buffer.insert(buffer.end(), table->buffer.begin(), table->buffer.end());
+		endTable(position, table->pairCount);
+
+		for (Object *object : table->objects)
+		{
+			object->retain();
+			objects.push_back(object);
+		}
+		break;
+	}
+	case NIL:
+	default:
+		writeType(VALUE_NIL);
+		break;
+	}
+}
+
+void Variant::SharedTable::writeString(const char *str, size_t len)
+{
+	uint64 len64 = (uint64) len;
+	writeType(VALUE_STRING);
+	writeBytes(&len64, sizeof(len64));
+	writeBytes(str, len);
+}
+
+size_t Variant::SharedTable::beginTable()
+{
+	writeType(VALUE_TABLE);
+	size_t position = buffer.size();
+	uint32 pairs = 0;
+	writeBytes(&pairs, sizeof(pairs));
+	return position;
+}
+
+void Variant::SharedTable::endTable(size_t position, uint32 pairs)
+{
+	memcpy(buffer.data() + position, &pairs, sizeof(pairs));
+}
+
 Variant::Variant(Type vtype)
 	: type(vtype)
 {}
@@ -66,6 +242,14 @@ Variant::Variant(const std::string &str)
 {
 }
 
+Variant Variant::fromStaticString(const char *str)
+{
+	Variant v(STATICSTRING);
+	v.data.staticstring.str = str;
+	v.data.staticstring.len = strlen(str);
+	return v;
+}
+
 Variant::Variant(void *lightuserdata)
 	: type(LUSERDATA)
 {
@@ -140,4 +324,24 @@ Variant &Variant::operator = (const Variant &v)
 	return *this;
 }
 
+Variant &Variant::operator = (Variant &&v)
+{
+	if (this == &v)
+		return *this;
+
+	// The reference is taken over from v, so nothing needs to be retained.
+	if (type == STRING)
+		data.string->release();
+	else if (type == LOVEOBJECT && data.objectproxy.object != nullptr)
+		data.objectproxy.object->release();
+	else if (type == TABLE)
+		data.table->release();
+
+	type = v.type;
+	data = v.data;
+	v.type = NIL;
+
+	return *this;
+}
+
 } // love
@@ -45,6 +45,7 @@ public:
 		NUMBER,
 		STRING,
 		SMALLSTRING,
+		STATICSTRING,
 		LUSERDATA,
 		LOVEOBJECT,
 		NIL,
@@ -68,14 +69,83 @@ public:
 		size_t len;
 	};
 
+	/**
+	 * A table stored as a single compact buffer of tagged values, so copying a
+	 * table (including any nested tables and strings in it) takes one
+	 * allocation instead of one per key and value.
+	 **/
 	class SharedTable : public love::Object
 	{
 	public:
 
-		SharedTable() {}
-		virtual ~SharedTable() {}
+		enum ValueType
+		{
+			VALUE_NIL,
+			VALUE_FALSE,
+			VALUE_TRUE,
+			VALUE_NUMBER,
+			VALUE_STRING,
+			VALUE_LUSERDATA,
+			VALUE_LOVEOBJECT,
+			VALUE_TABLE,
+		};
+
+		/**
+		 * Reads the values of a SharedTable in the order they were written.
+		 **/
+		class Reader
+		{
+		public:
+
+			Reader(const SharedTable *table);
+
+			bool hasMore() const { return offset < table->buffer.size(); }
+
+			ValueType readType();
+			double readNumber();
+			const char *readString(size_t &len);
+			void *readLightUserdata();
+			Proxy readObject();
+			uint32 readPairCount();
+
+		private:
+
+			void read(void *dst, size_t size);
+
+			const SharedTable *table;
+			size_t offset;
+		};
+
+		SharedTable();
+		virtual ~SharedTable();
 
-		std::vector<std::pair<Variant, Variant>> pairs;
+		/**
+		 * Adds a key/value pair to the end of the table.
+		 **/
+		void add(const Variant &key, const Variant &value);
+
+		/**
+		 * Low level writing of the values of key/value pairs. Nested tables
+		 * are written with beginTable and endTable, around their pairs.
+		 **/
+		void write(const Variant &v);
+		void writeString(const char *str, size_t len);
+		size_t beginTable();
+		void endTable(size_t position, uint32 pairs);
+		void addPairCount(uint32 pairs) { pairCount += pairs; }
+
+		uint32 getPairCount() const { return pairCount; }
+
+	private:
+
+		void writeType(ValueType type);
+		void writeBytes(const void *src, size_t size);
+
+		uint32 pairCount;
+		std::vector<uint8> buffer;
+
+		// Objects referenced by the buffer, which are retained by the table.
+		std::vector<Object *> objects;
 	};
 
 	union Data
@@ -91,6 +161,11 @@ public:
 			char str[MAX_SMALL_STRING_LENGTH];
 			uint8 len;
 		} smallstring;
+		struct
+		{
+			const char *str;
+			size_t len;
+		} staticstring;
 	};
 
 	Variant();
@@ -106,12 +181,21 @@ public:
 	~Variant();
 
 	Variant &operator = (const Variant &v);
+	Variant &operator = (Variant &&v);
 
 	Type getType() const { return type; }
 	const Data &getData() const { return data; }
 
 	static Variant unknown() { return Variant(UNKNOWN); }
 
+	/**
+	 * Creates a string Variant which points to the given string instead of
+	 * copying it, and isn't reference counted. The string must stay valid for
+	 * as long as any copy of the Variant exists, e.g. a string literal or a
+	 * StringMap constant name.
+	 **/
+	static Variant fromStaticString(const char *str);
+
 private:
 
 	Variant(Type vtype);
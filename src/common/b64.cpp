@@ -21,8 +21,10 @@
 #include "b64.h"
 #include "Exception.h"
 
+#include <algorithm>
 #include <limits>
 #include <stdio.h>
+#include <string.h>
 
 namespace love
 {
@@ -33,81 +35,174 @@ static const char cb64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz01
 // Translation table to decode (created by Bob Trower)
 static const char cd64[]="|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
 
+#if defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#	define LOVE_B64_NEON
+#	include <arm_neon.h>
+#endif
+
 /**
- * encode 3 8-bit binary bytes as 4 '6-bit' characters
+ * Each 12 bit half of a 3 byte group maps to a pair of characters, so a group
+ * is encoded with two lookups instead of four shifts and masks per character.
  **/
-static void b64_encode_block(char in[3], char out[4], int len)
+struct B64PairTable
+{
+	char pairs[4096][2];
+
+	B64PairTable()
+	{
+		for (int i = 0; i < 4096; i++)
+		{
+			pairs[i][0] = cb64[i >> 6];
+			pairs[i][1] = cb64[i & 0x3F];
+		}
+	}
+};
+
+static const B64PairTable &getPairTable()
 {
-	out[0] = (char) cb64[(int)((in[0] & 0xfc) >> 2)];
-	out[1] = (char) cb64[(int)(((in[0] & 0x03) << 4) | ((in[1] & 0xf0) >> 4))];
-	out[2] = (char) (len > 1 ? cb64[(int)(((in[1] & 0x0f) << 2) | ((in[2] & 0xc0) >> 6))] : '=');
-	out[3] = (char) (len > 2 ? cb64[(int)(in[2] & 0x3f)] : '=');
+	static const B64PairTable table;
+	return table;
 }
 
-char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
+/**
+ * Encodes whole 3 byte groups, without padding or line breaks.
+ **/
+static void b64_encode_groups(const unsigned char *src, size_t groups, char *dst)
 {
-	if (linelen == 0)
-		linelen = std::numeric_limits<size_t>::max();
+#if defined(LOVE_B64_NEON)
+	if (groups >= 16)
+	{
+		uint8x16x4_t table;
+		table.val[0] = vld1q_u8((const uint8_t *) cb64 + 0);
+		table.val[1] = vld1q_u8((const uint8_t *) cb64 + 16);
+		table.val[2] = vld1q_u8((const uint8_t *) cb64 + 32);
+		table.val[3] = vld1q_u8((const uint8_t *) cb64 + 48);
 
-	size_t blocksout = 0;
-	size_t srcpos = 0;
+		const uint8x16_t mask6 = vdupq_n_u8(0x3F);
 
-	size_t adjustment = (srclen % 3) ? (3 - (srclen % 3)) : 0;
-	size_t paddedlen = ((srclen + adjustment) / 3) * 4;
+		// 48 input bytes to 64 characters at a time. vld3q deinterleaves the
+		// groups so each lane holds one group's bytes.
+		while (groups >= 16)
+		{
+			uint8x16x3_t in = vld3q_u8(src);
+			uint8x16x4_t out;
 
-	dstlen = paddedlen + paddedlen / linelen;
+			out.val[0] = vshrq_n_u8(in.val[0], 2);
+			out.val[1] = vandq_u8(vsliq_n_u8(vshrq_n_u8(in.val[1], 4), in.val[0], 4), mask6);
+			out.val[2] = vandq_u8(vsliq_n_u8(vshrq_n_u8(in.val[2], 6), in.val[1], 2), mask6);
+			out.val[3] = vandq_u8(in.val[2], mask6);
 
-	if (dstlen == 0)
-		return nullptr;
+			out.val[0] = vqtbl4q_u8(table, out.val[0]);
+			out.val[1] = vqtbl4q_u8(table, out.val[1]);
+			out.val[2] = vqtbl4q_u8(table, out.val[2]);
+			out.val[3] = vqtbl4q_u8(table, out.val[3]);
 
-	char *dst = nullptr;
-	try
-	{
-		dst = new char[dstlen + 1];
+			vst4q_u8((uint8_t *) dst, out);
+
+			src += 48;
+			dst += 64;
+			groups -= 16;
+		}
 	}
-	catch (std::exception &)
+#endif
+
+	const B64PairTable &table = getPairTable();
+
+	for (size_t i = 0; i < groups; i++)
 	{
-		throw love::Exception("Out of memory.");
+		unsigned int v = (src[0] << 16) | (src[1] << 8) | src[2];
+		memcpy(dst + 0, table.pairs[v >> 12], 2);
+		memcpy(dst + 2, table.pairs[v & 0xFFF], 2);
+		src += 3;
+		dst += 4;
 	}
+}
+
+static size_t b64_line_length(size_t linelen)
+{
+	// Lines always hold whole 4 character blocks.
+	if (linelen == 0)
+		return 0;
+	return std::max(linelen - (linelen % 4), (size_t) 4);
+}
 
-	size_t dstpos = 0;
+size_t b64_encode_size(size_t srclen, size_t linelen)
+{
+	linelen = b64_line_length(linelen);
+
+	size_t paddedlen = ((srclen + 2) / 3) * 4;
+	return paddedlen + (linelen > 0 ? paddedlen / linelen : 0);
+}
+
+size_t b64_encode_into(const char *src, size_t srclen, size_t linelen, char *dst)
+{
+	linelen = b64_line_length(linelen);
+
+	const unsigned char *s = (const unsigned char *) src;
+	char *d = dst;
+
+	size_t groups = srclen / 3;
+	size_t remainder = srclen % 3;
 
-	while (srcpos < srclen)
+	size_t linegroups = linelen > 0 ? linelen / 4 : std::numeric_limits<size_t>::max();
+	size_t linepos = 0;
+
+	while (groups > 0)
 	{
-		char in[3]  = {0};
-		char out[4] = {0};
+		size_t count = std::min(groups, linegroups - linepos);
+		b64_encode_groups(s, count, d);
 
-		int len = 0;
+		s += count * 3;
+		d += count * 4;
+		groups -= count;
+		linepos += count;
 
-		for (int i = 0; i < 3; i++)
+		if (linepos == linegroups)
 		{
-			if (srcpos >= srclen)
-				break;
-
-			in[i] = src[srcpos++];
-			len++;
+			*d++ = '\n';
+			linepos = 0;
 		}
+	}
 
-		if (len > 0)
-		{
-			b64_encode_block(in, out, len);
+	if (remainder > 0)
+	{
+		unsigned int v = s[0] << 16;
+		if (remainder > 1)
+			v |= s[1] << 8;
+
+		d[0] = cb64[(v >> 18) & 0x3F];
+		d[1] = cb64[(v >> 12) & 0x3F];
+		d[2] = remainder > 1 ? cb64[(v >> 6) & 0x3F] : '=';
+		d[3] = '=';
+		d += 4;
+
+		if (++linepos == linegroups)
+			*d++ = '\n';
+	}
 
-			for (int i = 0; i < 4 && dstpos < dstlen; i++, dstpos++)
-				dst[dstpos] = out[i];
+	return (size_t) (d - dst);
+}
 
-			blocksout++;
-		}
+char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
+{
+	dstlen = b64_encode_size(srclen, linelen);
 
-		if (blocksout >= linelen / 4 || srcpos >= srclen)
-		{
-			if (blocksout > 0 && dstpos < dstlen)
-				dst[dstpos++] = '\n';
+	if (dstlen == 0)
+		return nullptr;
 
-			blocksout = 0;
-		}
+	char *dst = nullptr;
+	try
+	{
+		dst = new char[dstlen + 1];
 	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	b64_encode_into(src, srclen, linelen, dst);
 
-	dst[dstpos] = '\0';
+	dst[dstlen] = '\0';
 	return dst;
 }
 
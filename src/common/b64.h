@@ -40,6 +40,20 @@ namespace love
  */
 char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen);
 
+/**
+ * Gets the length of the base64-encoded string for data of the given size.
+ * Line lengths are rounded down to a multiple of 4 (with a minimum of 4).
+ **/
+size_t b64_encode_size(size_t srclen, size_t linelen);
+
+/**
+ * Base64-encode data into existing memory, which must hold at least
+ * b64_encode_size(srclen, linelen) bytes. No null terminator is written.
+ *
+ * @return The number of characters written.
+ */
+size_t b64_encode_into(const char *src, size_t srclen, size_t linelen, char *dst);
+
 /**
  * Decode base64 encoded data.
  *
@@ -22,6 +22,7 @@
 #include "memory.h"
 
 #include <stdlib.h>
+#include <atomic>
 
 #ifdef LOVE_WINDOWS
 #define WIN32_LEAN_AND_MEAN
@@ -76,4 +77,59 @@ size_t alignUp(size_t size, size_t alignment)
 	return (size + alignment - 1) & (~(alignment - 1));
 }
 
+struct MemoryCounters
+{
+	std::atomic<int64> current;
+	std::atomic<int64> peak;
+	std::atomic<int64> allocations;
+};
+
+static MemoryCounters memoryCounters[MEMORY_MAX_ENUM] = {};
+
+void trackAllocation(MemoryCategory category, size_t size)
+{
+	MemoryCounters &counters = memoryCounters[category];
+
+	int64 current = counters.current.fetch_add((int64) size, std::memory_order_relaxed) + (int64) size;
+	counters.allocations.fetch_add(1, std::memory_order_relaxed);
+
+	int64 peak = counters.peak.load(std::memory_order_relaxed);
+	while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+	{
+	}
+}
+
+void trackDeallocation(MemoryCategory category, size_t size)
+{
+	memoryCounters[category].current.fetch_sub((int64) size, std::memory_order_relaxed);
+}
+
+MemoryStats getMemoryStats(MemoryCategory category)
+{
+	const MemoryCounters &counters = memoryCounters[category];
+
+	MemoryStats stats;
+	stats.current = counters.current.load(std::memory_order_relaxed);
+	stats.peak = counters.peak.load(std::memory_order_relaxed);
+	stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void resetMemoryPeaks()
+{
+	for (MemoryCounters &counters : memoryCounters)
+		counters.peak.store(counters.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+STRINGMAP_BEGIN(MemoryCategory, MEMORY_MAX_ENUM, memoryCategory)
+{
+	{ "data",    MEMORY_DATA    },
+	{ "file",    MEMORY_FILE    },
+	{ "image",   MEMORY_IMAGE   },
+	{ "sound",   MEMORY_SOUND   },
+	{ "font",    MEMORY_FONT    },
+	{ "physics", MEMORY_PHYSICS },
+}
+STRINGMAP_END(MemoryCategory, MEMORY_MAX_ENUM, memoryCategory)
+
 } // love
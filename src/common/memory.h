@@ -20,6 +20,9 @@
 
 #pragma once
 
+#include "int.h"
+#include "StringMap.h"
+
 #include <stddef.h>
 
 namespace love
@@ -35,4 +38,42 @@ size_t getPageSize();
  **/
 size_t alignUp(size_t size, size_t alignment);
 
+/**
+ * CPU memory owned by the engine, grouped by what it's used for. GPU memory
+ * is reported separately by love.graphics.getStats.
+ **/
+enum MemoryCategory
+{
+	MEMORY_DATA, // ByteData, CompressedData
+	MEMORY_FILE, // FileData
+	MEMORY_IMAGE, // ImageData
+	MEMORY_SOUND, // SoundData
+	MEMORY_FONT, // Rasterized glyphs
+	MEMORY_PHYSICS, // Box2D
+	MEMORY_MAX_ENUM
+};
+
+struct MemoryStats
+{
+	int64 current = 0;
+	int64 peak = 0;
+	int64 allocations = 0;
+};
+
+/**
+ * Records an allocation or deallocation of the given number of bytes. Safe to
+ * call from any thread.
+ **/
+void trackAllocation(MemoryCategory category, size_t size);
+void trackDeallocation(MemoryCategory category, size_t size);
+
+MemoryStats getMemoryStats(MemoryCategory category);
+
+/**
+ * Sets the peak of each category to its current usage.
+ **/
+void resetMemoryPeaks();
+
+STRINGMAP_DECLARE(MemoryCategory);
+
 } // love
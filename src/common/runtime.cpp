@@ -24,6 +24,7 @@
 // LOVE
 #include "Module.h"
 #include "Object.h"
+#include "Data.h"
 #include "Reference.h"
 #include "StringMap.h"
 
@@ -34,11 +35,119 @@
 #include <cstdio>
 #include <cstddef>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 
 namespace love
 {
 
+// registry._loveobjectcache is an array of Proxy userdata with weak values,
+// indexed by the cache slot of each object whose Object::getProxyCacheOwner
+// is this table. Unused slots form a list of numbers starting at cache[0],
+// and cache[-1] is the number of slots created so far.
+static const char OBJECT_CACHE_KEY[] = "_loveobjectcache";
+
+// registry._loveexternalmemory is the number of bytes reported with
+// luax_addexternalmemory which the collector hasn't been stepped for yet.
+static const char EXTERNAL_MEMORY_KEY[] = "_loveexternalmemory";
+
+// Smaller amounts are accumulated before stepping the collector, so lots of
+// small Data objects don't each run a step.
+static const size_t EXTERNAL_MEMORY_STEP_SIZE = 256 * 1024;
+
+static int luax_newproxycacheslot(lua_State *L, int cacheidx)
+{
+	lua_rawgeti(L, cacheidx, 0);
+	int slot = (int) lua_tointeger(L, -1);
+	lua_pop(L, 1);
+
+	if (slot > 0)
+	{
+		// cache[0] = cache[slot], the next unused slot.
+		lua_rawgeti(L, cacheidx, slot);
+		lua_rawseti(L, cacheidx, 0);
+	}
+	else
+	{
+		lua_rawgeti(L, cacheidx, -1);
+		slot = (int) lua_tointeger(L, -1) + 1;
+		lua_pop(L, 1);
+
+		lua_pushinteger(L, slot);
+		lua_rawseti(L, cacheidx, -1);
+	}
+
+	return slot;
+}
+
+static void luax_freeproxycacheslot(lua_State *L, int cacheidx, int slot)
+{
+	lua_rawgeti(L, cacheidx, 0);
+	lua_rawseti(L, cacheidx, slot);
+
+	lua_pushinteger(L, slot);
+	lua_rawseti(L, cacheidx, 0);
+}
+
+/**
+ * Remembers the Proxy on the top of the stack in the proxy cache, if the
+ * object's cache slot isn't owned by another Lua state.
+ **/
+static void luax_cacheproxy(lua_State *L, int cacheidx, love::Object *object)
+{
+	const void *cache = lua_topointer(L, cacheidx);
+	const void *owner = object->getProxyCacheOwner();
+
+	if (owner == nullptr)
+	{
+		int slot = luax_newproxycacheslot(L, cacheidx);
+
+		if (!object->claimProxyCache(cache, slot))
+		{
+			luax_freeproxycacheslot(L, cacheidx, slot);
+			return;
+		}
+
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, cacheidx, slot);
+	}
+	else if (owner == cache)
+	{
+		// The slot is still ours, but its previous Proxy was collected.
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, cacheidx, object->getProxyCacheSlot());
+	}
+}
+
+/**
+ * Gives back the object's cache slot when the Proxy at proxyidx, which is
+ * being collected or released, was the one in it.
+ **/
+static void luax_uncacheproxy(lua_State *L, int proxyidx, love::Object *object)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, OBJECT_CACHE_KEY);
+	const void *cache = lua_topointer(L, -1);
+
+	if (cache != nullptr && object->getProxyCacheOwner() == cache)
+	{
+		int cacheidx = lua_gettop(L);
+		int slot = object->getProxyCacheSlot();
+
+		// Weak values are cleared before the Proxy's __gc is called.
+		lua_rawgeti(L, cacheidx, slot);
+		bool unused = lua_isnil(L, -1) || lua_rawequal(L, -1, proxyidx);
+		lua_pop(L, 1);
+
+		if (unused)
+		{
+			luax_freeproxycacheslot(L, cacheidx, slot);
+			object->releaseProxyCache();
+		}
+	}
+
+	lua_pop(L, 1);
+}
+
 /**
  * Called when an object is collected. The object is released
  * once in this function, possibly deleting it.
@@ -48,6 +157,7 @@ static int w__gc(lua_State *L)
 	Proxy *p = (Proxy *) lua_touserdata(L, 1);
 	if (p->object != nullptr)
 	{
+		luax_uncacheproxy(L, 1, p->object);
 		p->object->release();
 		p->object = nullptr;
 	}
@@ -174,6 +284,8 @@ static int w__release(lua_State *L)
 
 	if (object != nullptr)
 	{
+		luax_uncacheproxy(L, 1, object);
+
 		p->object = nullptr;
 		object->release();
 
@@ -486,6 +598,41 @@ int luax_preload(lua_State *L, lua_CFunction f, const char *name)
 	return 0;
 }
 
+/**
+ * __index of the metatable of each type's metatable. Methods are only pushed
+ * as Lua functions and stored in the type's metatable the first time they're
+ * looked up, so registering a type doesn't create all of them up front.
+ * Upvalue 1 is the number of luaL_Reg arrays, which are the other upvalues.
+ **/
+static int w__indexmethod(lua_State *L)
+{
+	if (lua_type(L, 2) != LUA_TSTRING)
+		return 0;
+
+	const char *name = lua_tostring(L, 2);
+	int count = (int) lua_tointeger(L, lua_upvalueindex(1));
+
+	// Later arrays take precedence, like they would with luax_setfuncs.
+	for (int i = count; i > 0; i--)
+	{
+		auto l = (const luaL_Reg *) lua_touserdata(L, lua_upvalueindex(i + 1));
+
+		for (; l->name != nullptr; l++)
+		{
+			if (strcmp(l->name, name) != 0)
+				continue;
+
+			lua_pushcfunction(L, l->func);
+			lua_pushvalue(L, 2);
+			lua_pushvalue(L, -2);
+			lua_rawset(L, 1);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 int luax_register_type(lua_State *L, love::Type *type, ...)
 {
 	type->init();
@@ -493,24 +640,29 @@ int luax_register_type(lua_State *L, love::Type *type, ...)
 	// Get the place for storing and re-using instantiated love types.
 	luax_getregistry(L, REGISTRY_OBJECTS);
 
-	// Create registry._loveobjects if it doesn't exist yet.
+	// Create registry._loveobjects and registry._loveobjectcache if they
+	// don't exist yet.
 	if (!lua_istable(L, -1))
 	{
-		lua_newtable(L);
-		lua_replace(L, -2);
+		lua_pop(L, 1);
 
-		// Create a metatable.
-		lua_newtable(L);
+		for (const char *name : {"_loveobjects", OBJECT_CACHE_KEY})
+		{
+			lua_newtable(L);
+
+			// Create a metatable.
+			lua_newtable(L);
 
-		// metatable.__mode = "v". Weak userdata values.
-		lua_pushliteral(L, "v");
-		lua_setfield(L, -2, "__mode");
+			// metatable.__mode = "v". Weak userdata values.
+			lua_pushliteral(L, "v");
+			lua_setfield(L, -2, "__mode");
 
-		// setmetatable(newtable, metatable)
-		lua_setmetatable(L, -2);
+			// setmetatable(newtable, metatable)
+			lua_setmetatable(L, -2);
 
-		// registry._loveobjects = newtable
-		lua_setfield(L, LUA_REGISTRYINDEX, "_loveobjects");
+			// registry[name] = newtable
+			lua_setfield(L, LUA_REGISTRYINDEX, name);
+		}
 	}
 	else
 		lua_pop(L, 1);
@@ -551,12 +703,39 @@ int luax_register_type(lua_State *L, love::Type *type, ...)
 	lua_pushcfunction(L, w__release);
 	lua_setfield(L, -2, "__close");
 
+	// Metamethods have to be in the metatable itself. Everything else is
+	// added when it's first used, by w__indexmethod.
+	int count = 0;
+	lua_pushnil(L); // Placeholder for the count.
+
 	va_list fs;
 	va_start(fs, type);
 	for (const luaL_Reg *f = va_arg(fs, const luaL_Reg *); f; f = va_arg(fs, const luaL_Reg *))
-		luax_setfuncs(L, f);
+	{
+		for (const luaL_Reg *l = f; l->name != nullptr; l++)
+		{
+			if (l->name[0] == '_' && l->name[1] == '_')
+			{
+				lua_pushcfunction(L, l->func);
+				lua_setfield(L, -3 - count, l->name);
+			}
+		}
+
+		lua_pushlightuserdata(L, (void *) f);
+		count++;
+	}
 	va_end(fs);
 
+	lua_pushinteger(L, count);
+	lua_replace(L, -2 - count);
+
+	// setmetatable(m, {__index = w__indexmethod})
+	lua_createtable(L, 0, 1);
+	lua_insert(L, -2 - count);
+	lua_pushcclosure(L, w__indexmethod, count + 1);
+	lua_setfield(L, -2, "__index");
+	lua_setmetatable(L, -2);
+
 	lua_pop(L, 1); // Pops metatable.
 	return 0;
 }
@@ -620,8 +799,34 @@ int luax_register_searcher(lua_State *L, lua_CFunction f, int pos)
 	return 0;
 }
 
+void luax_addexternalmemory(lua_State *L, size_t bytes)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, EXTERNAL_MEMORY_KEY);
+	double pending = lua_tonumber(L, -1) + (double) bytes;
+	lua_pop(L, 1);
+
+	if (pending >= (double) EXTERNAL_MEMORY_STEP_SIZE)
+	{
+		// A step of n KB does as much collection work as allocating n KB
+		// inside Lua would have.
+		lua_pushnumber(L, 0);
+		lua_setfield(L, LUA_REGISTRYINDEX, EXTERNAL_MEMORY_KEY);
+		lua_gc(L, LUA_GCSTEP, (int) std::min(pending / 1024.0, (double) LOVE_INT32_MAX));
+	}
+	else
+	{
+		lua_pushnumber(L, pending);
+		lua_setfield(L, LUA_REGISTRYINDEX, EXTERNAL_MEMORY_KEY);
+	}
+}
+
 void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object)
 {
+	// Data objects are usually far bigger than their Proxy, which is all the
+	// collector would see otherwise.
+	if (type.isa(love::Data::type))
+		luax_addexternalmemory(L, static_cast<love::Data *>(object)->getSize());
+
 	Proxy *u = (Proxy *)lua_newuserdata(L, sizeof(Proxy));
 
 	object->retain();
@@ -655,13 +860,30 @@ void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
 		return;
 	}
 
+	// Fast path: the object knows where its Proxy is in this state's cache.
+	lua_getfield(L, LUA_REGISTRYINDEX, OBJECT_CACHE_KEY);
+	const void *cache = lua_topointer(L, -1);
+
+	if (cache != nullptr && object->getProxyCacheOwner() == cache)
+	{
+		lua_rawgeti(L, -1, object->getProxyCacheSlot());
+
+		if (lua_type(L, -1) == LUA_TUSERDATA && ((Proxy *) lua_touserdata(L, -1))->object == object)
+		{
+			lua_remove(L, -2);
+			return;
+		}
+
+		lua_pop(L, 1);
+	}
+
 	// Fetch the registry table of instantiated objects.
 	luax_getregistry(L, REGISTRY_OBJECTS);
 
 	// The table might not exist - it should be insisted in luax_register_type.
 	if (lua_isnoneornil(L, -1))
 	{
-		lua_pop(L, 1);
+		lua_pop(L, 2);
 		return luax_rawnewtype(L, type, object);
 	}
 
@@ -688,6 +910,12 @@ void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
 	// Remove the loveobjects table from the stack.
 	lua_remove(L, -2);
 
+	if (cache != nullptr)
+		luax_cacheproxy(L, lua_gettop(L) - 1, object);
+
+	// Remove the proxy cache table from the stack.
+	lua_remove(L, -2);
+
 	// Keep the Proxy userdata on the stack.
 }
 
@@ -719,6 +947,77 @@ static Proxy *tryextractproxy(lua_State *L, int idx)
 	return nullptr;
 }
 
+// Writes the key/value pairs of the table at index n directly into the shared
+// table's buffer, including any nested tables.
+static bool writesharedtable(lua_State *L, int n, bool allowuserdata, std::set<const void *> *tableSet, Variant::SharedTable *table, uint32 &pairs);
+
+static bool writesharedvalue(lua_State *L, int n, bool allowuserdata, std::set<const void *> *tableSet, Variant::SharedTable *table)
+{
+	if (n < 0)
+		n += lua_gettop(L) + 1;
+
+	switch (lua_type(L, n))
+	{
+	case LUA_TSTRING:
+		{
+			size_t len = 0;
+			const char *str = lua_tolstring(L, n, &len);
+			table->writeString(str, len);
+		}
+		return true;
+	case LUA_TTABLE:
+		{
+			size_t position = table->beginTable();
+			uint32 pairs = 0;
+			if (!writesharedtable(L, n, allowuserdata, tableSet, table, pairs))
+				return false;
+			table->endTable(position, pairs);
+		}
+		return true;
+	default:
+		{
+			Variant v = luax_checkvariant(L, n, allowuserdata, tableSet);
+			if (v.getType() == Variant::UNKNOWN)
+				return false;
+			table->write(v);
+		}
+		return true;
+	}
+}
+
+static bool writesharedtable(lua_State *L, int n, bool allowuserdata, std::set<const void *> *tableSet, Variant::SharedTable *table, uint32 &pairs)
+{
+	// Now make sure this table wasn't already serialised
+	const void *tablePointer = lua_topointer(L, n);
+	{
+		auto result = tableSet->insert(tablePointer);
+		if (!result.second) // insertion failed
+			throw love::Exception("Cycle detected in table");
+	}
+
+	bool success = true;
+
+	lua_pushnil(L);
+
+	while (lua_next(L, n))
+	{
+		if (!writesharedvalue(L, -2, allowuserdata, tableSet, table) || !writesharedvalue(L, -1, allowuserdata, tableSet, table))
+		{
+			lua_pop(L, 2);
+			success = false;
+			break;
+		}
+
+		lua_pop(L, 1);
+		pairs++;
+	}
+
+	// And remove the table from the set again
+	tableSet->erase(tablePointer);
+
+	return success;
+}
+
 Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<const void*> *tableSet)
 {
 	size_t len;
@@ -757,7 +1056,6 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 		return Variant();
 	case LUA_TTABLE:
 		{
-			bool success = true;
 			std::set<const void *> topTableSet;
 
 			// We can use a pointer to a stack-allocated variable because it's
@@ -765,40 +1063,20 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 			if (tableSet == nullptr)
 				tableSet = &topTableSet;
 
-			// Now make sure this table wasn't already serialised
-			const void *tablePointer = lua_topointer(L, n);
-			{
-				auto result = tableSet->insert(tablePointer);
-				if (!result.second) // insertion failed
-					throw love::Exception("Cycle detected in table");
-			}
-
 			Variant::SharedTable *table = new Variant::SharedTable();
+			bool success = false;
 
-			size_t len = luax_objlen(L, -1);
-			if (len > 0)
-				table->pairs.reserve(len);
-
-			lua_pushnil(L);
-
-			while (lua_next(L, n))
+			try
 			{
-				table->pairs.emplace_back(
-					luax_checkvariant(L, -2, allowuserdata, tableSet),
-					luax_checkvariant(L, -1, allowuserdata, tableSet)
-				);
-				lua_pop(L, 1);
-
-				const auto &p = table->pairs.back();
-				if (p.first.getType() == Variant::UNKNOWN || p.second.getType() == Variant::UNKNOWN)
-				{
-					success = false;
-					break;
-				}
+				uint32 pairs = 0;
+				success = writesharedtable(L, n, allowuserdata, tableSet, table, pairs);
+				table->addPairCount(pairs);
+			}
+			catch (love::Exception &)
+			{
+				table->release();
+				throw;
 			}
-
-			// And remove the table from the set again
-			tableSet->erase(tablePointer);
 
 			if (success)
 				return Variant(table);
@@ -811,6 +1089,59 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 	return Variant::unknown();
 }
 
+static void pushsharedtable(lua_State *L, Variant::SharedTable::Reader &reader, uint32 pairs);
+
+static void pushsharedvalue(lua_State *L, Variant::SharedTable::Reader &reader)
+{
+	switch (reader.readType())
+	{
+	case Variant::SharedTable::VALUE_FALSE:
+		lua_pushboolean(L, 0);
+		break;
+	case Variant::SharedTable::VALUE_TRUE:
+		lua_pushboolean(L, 1);
+		break;
+	case Variant::SharedTable::VALUE_NUMBER:
+		lua_pushnumber(L, reader.readNumber());
+		break;
+	case Variant::SharedTable::VALUE_STRING:
+		{
+			size_t len = 0;
+			const char *str = reader.readString(len);
+			lua_pushlstring(L, str, len);
+		}
+		break;
+	case Variant::SharedTable::VALUE_LUSERDATA:
+		lua_pushlightuserdata(L, reader.readLightUserdata());
+		break;
+	case Variant::SharedTable::VALUE_LOVEOBJECT:
+		{
+			Proxy proxy = reader.readObject();
+			luax_pushtype(L, *proxy.type, proxy.object);
+		}
+		break;
+	case Variant::SharedTable::VALUE_TABLE:
+		pushsharedtable(L, reader, reader.readPairCount());
+		break;
+	case Variant::SharedTable::VALUE_NIL:
+	default:
+		lua_pushnil(L);
+		break;
+	}
+}
+
+static void pushsharedtable(lua_State *L, Variant::SharedTable::Reader &reader, uint32 pairs)
+{
+	lua_createtable(L, 0, (int) pairs);
+
+	for (uint32 i = 0; i < pairs; i++)
+	{
+		pushsharedvalue(L, reader);
+		pushsharedvalue(L, reader);
+		lua_settable(L, -3);
+	}
+}
+
 void luax_pushvariant(lua_State *L, const Variant &v)
 {
 	const Variant::Data &data = v.getData();
@@ -828,6 +1159,9 @@ void luax_pushvariant(lua_State *L, const Variant &v)
 	case Variant::SMALLSTRING:
 		lua_pushlstring(L, data.smallstring.str, data.smallstring.len);
 		break;
+	case Variant::STATICSTRING:
+		lua_pushlstring(L, data.staticstring.str, data.staticstring.len);
+		break;
 	case Variant::LUSERDATA:
 		lua_pushlightuserdata(L, data.userdata);
 		break;
@@ -836,19 +1170,8 @@ void luax_pushvariant(lua_State *L, const Variant &v)
 		break;
 	case Variant::TABLE:
 	{
-		std::vector<std::pair<Variant, Variant>> &table = data.table->pairs;
-		int tsize = (int) table.size();
-
-		lua_createtable(L, 0, tsize);
-
-		for (int i = 0; i < tsize; ++i)
-		{
-			std::pair<Variant, Variant> &kv = table[i];
-			luax_pushvariant(L, kv.first);
-			luax_pushvariant(L, kv.second);
-			lua_settable(L, -3);
-		}
-
+		Variant::SharedTable::Reader reader(data.table);
+		pushsharedtable(L, reader, data.table->getPairCount());
 		break;
 	}
 	case Variant::NIL:
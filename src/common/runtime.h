@@ -332,6 +332,16 @@ int luax_table_insert(lua_State *L, int tindex, int vindex, int pos = -1);
  **/
 int luax_register_searcher(lua_State *L, lua_CFunction f, int pos = -1);
 
+/**
+ * Tells the Lua garbage collector about memory allocated outside of Lua which
+ * is owned by a Lua-side object, such as the contents of a Data object. The
+ * collector is stepped in proportion, so collection follows native memory use
+ * instead of only the size of the Proxy userdata.
+ * @param L The Lua state.
+ * @param bytes The number of newly allocated bytes.
+ **/
+void luax_addexternalmemory(lua_State *L, size_t bytes);
+
 /**
  * Pushes a Lua representation of the given object onto the stack, creating and
  * storing the Lua representation in a weak table if it doesn't exist yet.
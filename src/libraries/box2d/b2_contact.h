@@ -126,6 +126,11 @@ public:
 	/// Get the child primitive index for fixture B.
 	int32 GetChildIndexB() const;
 
+	/// Get the user data pointer. Use this to store your application specific data.
+	/// b2ContactListener::DestroyContact is called before the contact is destroyed.
+	b2ContactUserData& GetUserData();
+	const b2ContactUserData& GetUserData() const;
+
 	/// Override the default friction mixture. You can call this in b2ContactListener::PreSolve.
 	/// This value persists until set or reset.
 	void SetFriction(float friction);
@@ -210,6 +215,14 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Compute the new manifold and touching state without changing this contact.
+	// This only reads the contact and its bodies, so different contacts can be
+	// evaluated concurrently.
+	bool ComputeManifold(b2Manifold* manifold);
+
+	// Apply a manifold computed by ComputeManifold and report to the listener.
+	void Update(b2ContactListener* listener, const b2Manifold& manifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
@@ -239,8 +252,20 @@ protected:
 	float m_restitutionThreshold;
 
 	float m_tangentSpeed;
+
+	b2ContactUserData m_userData;
 };
 
+inline b2ContactUserData& b2Contact::GetUserData()
+{
+	return m_userData;
+}
+
+inline const b2ContactUserData& b2Contact::GetUserData() const
+{
+	return m_userData;
+}
+
 inline b2Manifold* b2Contact::GetManifold()
 {
 	return &m_manifold;
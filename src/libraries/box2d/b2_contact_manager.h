@@ -30,6 +30,8 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2TaskRunner;
+struct b2ContactUpdate;
 
 // Delegate of b2World.
 class B2_API b2ContactManager
@@ -46,12 +48,20 @@ public:
 
 	void Collide();
 
+	// Evaluate the manifolds of awake contacts on the task runner. Returns the
+	// number of entries written to updates, in contact list order.
+	int32 EvaluateContacts(b2ContactUpdate* updates);
+
+	// Task for EvaluateContacts.
+	static void EvaluateContactBlock(int32 index, void* context);
+
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+	b2TaskRunner* m_taskRunner;
 };
 
 #endif
@@ -140,6 +140,8 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data) override;
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
+	void GetImpulses(float* impulses) const override;
+	void SetImpulses(const float* impulses) override;
 
 	float m_stiffness;
 	float m_damping;
@@ -96,6 +96,8 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data) override;
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
+	void GetImpulses(float* impulses) const override;
+	void SetImpulses(const float* impulses) override;
 
 	b2Vec2 m_localAnchorA;
 	b2Vec2 m_localAnchorB;
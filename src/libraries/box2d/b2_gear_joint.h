@@ -88,6 +88,8 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data) override;
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
+	void GetImpulses(float* impulses) const override;
+	void SetImpulses(const float* impulses) override;
 
 	b2Joint* m_joint1;
 	b2Joint* m_joint2;
@@ -26,6 +26,9 @@
 #include "b2_api.h"
 #include "b2_math.h"
 
+/// The largest number of warm starting impulses stored by a joint.
+#define b2_maxJointImpulses 5
+
 class b2Body;
 class b2Draw;
 class b2Joint;
@@ -174,6 +177,11 @@ protected:
 	// This returns true if the position errors are within tolerance.
 	virtual bool SolvePositionConstraints(const b2SolverData& data) = 0;
 
+	// Copy the impulses used for warm starting to or from an array of
+	// b2_maxJointImpulses floats. Used by b2World::SaveState.
+	virtual void GetImpulses(float* impulses) const { B2_NOT_USED(impulses); }
+	virtual void SetImpulses(const float* impulses) { B2_NOT_USED(impulses); }
+
 	b2JointType m_type;
 	b2Joint* m_prev;
 	b2Joint* m_next;
@@ -90,6 +90,18 @@ struct B2_API b2JointUserData
 	uintptr_t pointer;
 };
 
+/// You can define this to inject whatever data you want in b2Contact
+struct B2_API b2ContactUserData
+{
+	b2ContactUserData()
+	{
+		pointer = 0;
+	}
+
+	/// For legacy compatibility
+	uintptr_t pointer;
+};
+
 // Memory Allocation
 
 /// Default allocation functions
@@ -63,12 +63,15 @@ struct B2_API b2Velocity
 	float w;
 };
 
+class b2Island;
+
 /// Solver Data
 struct B2_API b2SolverData
 {
 	b2TimeStep step;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const b2Island* island;
 };
 
 #endif
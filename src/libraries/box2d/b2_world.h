@@ -39,6 +39,8 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+struct b2StateReader;
+struct b2StateWriter;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -71,6 +73,14 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task runner used to solve islands and evaluate contacts on several
+	/// threads during Step. Pass nullptr to step on the calling thread only. The runner
+	/// is owned by you and must remain in scope. Listener callbacks are still called on
+	/// the thread calling Step and in the same order, but PostSolve is reported once all
+	/// islands have been solved.
+	void SetTaskRunner(b2TaskRunner* runner);
+	b2TaskRunner* GetTaskRunner() const { return m_taskRunner; }
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -214,6 +224,23 @@ public:
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+	/// Get the number of bytes written by SaveState.
+	int32 GetStateSize() const;
+
+	/// Write the simulation state of the world to data, which must hold GetStateSize()
+	/// bytes. This includes body transforms and velocities, contacts with their warm
+	/// starting impulses, joint impulses and the broad-phase, but not the bodies,
+	/// fixtures and joints themselves. It can only be restored into this world.
+	/// @warning this should be called outside of a time step.
+	void SaveState(void* data) const;
+
+	/// Restore a state written by SaveState. All contacts are recreated, so
+	/// b2ContactListener::DestroyContact is called for every current contact.
+	/// Returns false and leaves the world unchanged if the data is invalid, or if
+	/// bodies, fixtures or joints were created or destroyed since it was saved.
+	/// @warning This function is locked during callbacks.
+	bool RestoreState(const void* data, int32 size);
+
 private:
 
 	friend class b2Body;
@@ -224,6 +251,11 @@ private:
 	void Solve(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	static void SolveIslandTask(int32 index, void* context);
+
+	void WriteState(b2StateWriter& writer) const;
+	bool ReadState(b2StateReader& reader, bool apply);
+
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
 	b2BlockAllocator m_blockAllocator;
@@ -259,6 +291,12 @@ private:
 	bool m_stepComplete;
 
 	b2Profile m_profile;
+
+	b2TaskRunner* m_taskRunner;
+
+	// One stack allocator per concurrent task when solving islands in parallel.
+	b2StackAllocator* m_taskAllocators;
+	int32 m_taskAllocatorCount;
 };
 
 inline b2Body* b2World::GetBodyList()
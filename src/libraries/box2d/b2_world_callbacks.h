@@ -94,6 +94,10 @@ public:
 	/// Called when two fixtures cease to touch.
 	virtual void EndContact(b2Contact* contact) { B2_NOT_USED(contact); }
 
+	/// Called when a contact is about to be destroyed, after EndContact if the
+	/// fixtures were touching. Use this to clear references to the contact.
+	virtual void DestroyContact(b2Contact* contact) { B2_NOT_USED(contact); }
+
 	/// This is called after a contact is updated. This allows you to inspect a
 	/// contact before it goes to the solver. If you are careful, you can modify the
 	/// contact manifold (e.g. disable contact).
@@ -158,4 +162,22 @@ public:
 									const b2Vec2& normal, float fraction) = 0;
 };
 
+/// Interface used by the world to run parts of a time step on several threads.
+/// See b2World::SetTaskRunner
+class B2_API b2TaskRunner
+{
+public:
+	virtual ~b2TaskRunner() {}
+
+	/// A task called with an index and the context given to ParallelFor.
+	typedef void b2TaskFunction(int32 index, void* context);
+
+	/// Call task(i, context) for every i in [0, count), possibly concurrently,
+	/// and return once all calls have finished.
+	virtual void ParallelFor(int32 count, b2TaskFunction* task, void* context) = 0;
+
+	/// The number of tasks that can run at the same time.
+	virtual int32 GetThreadCount() const = 0;
+};
+
 #endif
@@ -28,18 +28,36 @@
 #include <stdlib.h>
 
 #include "common/Exception.h"
+#include "common/memory.h"
+
+#include <stddef.h>
 
 b2Version b2_version = {2, 4, 0};
 
 // Memory allocators. Modify these to use your own allocator.
+// LOVE: each block is prefixed with its size, so love's memory stats can
+// account for it when it's freed.
+static const size_t b2_allocHeaderSize = sizeof(max_align_t);
+
 void* b2Alloc_Default(int32 size)
 {
-	return malloc(size);
+	char* mem = (char*) malloc(b2_allocHeaderSize + size);
+	if (mem == nullptr)
+		return nullptr;
+
+	*(int32*) mem = size;
+	love::trackAllocation(love::MEMORY_PHYSICS, (size_t) size);
+	return mem + b2_allocHeaderSize;
 }
 
 void b2Free_Default(void* mem)
 {
-	free(mem);
+	if (mem == nullptr)
+		return;
+
+	char* block = (char*) mem - b2_allocHeaderSize;
+	love::trackDeallocation(love::MEMORY_PHYSICS, (size_t) *(int32*) block);
+	free(block);
 }
 
 // You can modify this to use your logging facility.
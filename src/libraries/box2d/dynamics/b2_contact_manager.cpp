@@ -29,6 +29,52 @@
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
+// Contacts are only evaluated on the task runner when there are enough of them,
+// and are handed out to tasks in blocks of this size.
+static const int32 b2_parallelContactBlock = 64;
+
+// A contact manifold computed ahead of b2Contact::Update.
+struct b2ContactUpdate
+{
+	b2Contact* contact;
+	b2Manifold manifold;
+	bool touching;
+	bool evaluated;
+};
+
+struct b2ContactUpdateContext
+{
+	const b2BroadPhase* broadPhase;
+	b2ContactUpdate* updates;
+	int32 count;
+};
+
+void b2ContactManager::EvaluateContactBlock(int32 index, void* context)
+{
+	b2ContactUpdateContext* ctx = (b2ContactUpdateContext*)context;
+
+	int32 begin = index * b2_parallelContactBlock;
+	int32 end = b2Min(begin + b2_parallelContactBlock, ctx->count);
+
+	for (int32 i = begin; i < end; ++i)
+	{
+		b2ContactUpdate* update = ctx->updates + i;
+		b2Contact* c = update->contact;
+
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+		int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+
+		// Contacts that cease to overlap are destroyed by Collide.
+		update->evaluated = ctx->broadPhase->TestOverlap(proxyIdA, proxyIdB);
+		if (update->evaluated)
+		{
+			update->touching = c->ComputeManifold(&update->manifold);
+		}
+	}
+}
+
 b2ContactManager::b2ContactManager()
 {
 	m_contactList = nullptr;
@@ -36,6 +82,7 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_taskRunner = nullptr;
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -50,6 +97,11 @@ void b2ContactManager::Destroy(b2Contact* c)
 		m_contactListener->EndContact(c);
 	}
 
+	if (m_contactListener)
+	{
+		m_contactListener->DestroyContact(c);
+	}
+
 	// Remove from the world.
 	if (c->m_prev)
 	{
@@ -106,12 +158,67 @@ void b2ContactManager::Destroy(b2Contact* c)
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
+int32 b2ContactManager::EvaluateContacts(b2ContactUpdate* updates)
+{
+	// Gather the contacts that are active now. Waking bodies during Collide may
+	// activate more contacts, those are updated as usual.
+	int32 count = 0;
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		b2Body* bodyA = c->GetFixtureA()->GetBody();
+		b2Body* bodyB = c->GetFixtureB()->GetBody();
+		bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+		bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+		if (activeA || activeB)
+		{
+			updates[count].contact = c;
+			updates[count].evaluated = false;
+			++count;
+		}
+	}
+
+	if (count < b2_parallelContactBlock)
+	{
+		return 0;
+	}
+
+	b2ContactUpdateContext context;
+	context.broadPhase = &m_broadPhase;
+	context.updates = updates;
+	context.count = count;
+
+	int32 blockCount = (count + b2_parallelContactBlock - 1) / b2_parallelContactBlock;
+	m_taskRunner->ParallelFor(blockCount, EvaluateContactBlock, &context);
+
+	return count;
+}
+
 void b2ContactManager::Collide()
 {
+	// Evaluate contact manifolds ahead of time on the task runner, if there is one.
+	// Filtering, destruction and listener callbacks still happen below in list order.
+	b2ContactUpdate* updates = nullptr;
+	int32 updateCount = 0;
+	int32 updateIndex = 0;
+	if (m_taskRunner != nullptr && m_taskRunner->GetThreadCount() > 1 && m_contactCount >= b2_parallelContactBlock)
+	{
+		updates = (b2ContactUpdate*)b2Alloc(m_contactCount * sizeof(b2ContactUpdate));
+		updateCount = EvaluateContacts(updates);
+	}
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
 	{
+		// Contacts are only ever destroyed at the current position in the list,
+		// so the evaluated contacts are reached in the same order.
+		const b2ContactUpdate* update = nullptr;
+		if (updateIndex < updateCount && updates[updateIndex].contact == c)
+		{
+			update = updates + updateIndex;
+			++updateIndex;
+		}
+
 		b2Fixture* fixtureA = c->GetFixtureA();
 		b2Fixture* fixtureB = c->GetFixtureB();
 		int32 indexA = c->GetChildIndexA();
@@ -168,9 +275,21 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (update != nullptr && update->evaluated)
+		{
+			c->Update(m_contactListener, update->manifold, update->touching);
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
+
+	if (updates != nullptr)
+	{
+		b2Free(updates);
+	}
 }
 
 void b2ContactManager::FindNewContacts()
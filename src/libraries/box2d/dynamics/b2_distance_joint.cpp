@@ -25,6 +25,8 @@
 #include "box2d/b2_distance_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // 1-D constrained system
 // m (v2 - v1) = lambda
 // v2 + (beta/h) * x1 + gamma * lambda = 0, gamma has units of inverse mass.
@@ -75,8 +77,8 @@ b2DistanceJoint::b2DistanceJoint(const b2DistanceJointDef* def)
 
 void b2DistanceJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -419,3 +421,17 @@ void b2DistanceJoint::Draw(b2Draw* draw) const
 		}
 	}
 }
+
+void b2DistanceJoint::GetImpulses(float* impulses) const
+{
+	impulses[0] = m_impulse;
+	impulses[1] = m_lowerImpulse;
+	impulses[2] = m_upperImpulse;
+}
+
+void b2DistanceJoint::SetImpulses(const float* impulses)
+{
+	m_impulse = impulses[0];
+	m_lowerImpulse = impulses[1];
+	m_upperImpulse = impulses[2];
+}
@@ -32,14 +32,18 @@ class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
 struct b2ContactVelocityConstraint;
+struct b2ContactImpulse;
 struct b2Profile;
 
 /// This is an internal class.
 class b2Island
 {
 public:
+	/// If shareStatic is true, static bodies don't store their island index in the
+	/// body itself, so that several islands can be solved concurrently while sharing
+	/// the same static bodies.
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener, bool shareStatic = false);
 	~b2Island();
 
 	void Clear()
@@ -47,6 +51,7 @@ public:
 		m_bodyCount = 0;
 		m_contactCount = 0;
 		m_jointCount = 0;
+		m_staticCount = 0;
 	}
 
 	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
@@ -56,7 +61,16 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+		if (m_statics != nullptr && body->m_type == b2_staticBody)
+		{
+			m_statics[m_staticCount].body = body;
+			m_statics[m_staticCount].index = m_bodyCount;
+			++m_staticCount;
+		}
+		else
+		{
+			body->m_islandIndex = m_bodyCount;
+		}
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -73,11 +87,36 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
+	/// Get the index of a body in this island's solver arrays.
+	int32 GetIndex(const b2Body* body) const
+	{
+		if (m_statics == nullptr || body->m_type != b2_staticBody)
+		{
+			return body->m_islandIndex;
+		}
+		return FindStatic(body);
+	}
+
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	struct b2StaticIndex
+	{
+		const b2Body* body;
+		int32 index;
+	};
+
+	int32 FindStatic(const b2Body* body) const;
+
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
+	/// If set, contact impulses are stored here instead of being sent to the listener.
+	b2ContactImpulse* m_impulses;
+
+	/// Static body indices, sorted by body. Only used when static bodies are shared.
+	b2StaticIndex* m_statics;
+	int32 m_staticCount;
+
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
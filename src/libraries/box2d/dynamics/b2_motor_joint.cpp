@@ -24,6 +24,8 @@
 #include "box2d/b2_motor_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // Point-to-point constraint
 // Cdot = v2 - v1
 //      = v2 + cross(w2, r2) - v1 - cross(w1, r1)
@@ -67,8 +69,8 @@ b2MotorJoint::b2MotorJoint(const b2MotorJointDef* def)
 
 void b2MotorJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -309,3 +311,17 @@ void b2MotorJoint::Dump()
 	b2Dump("  jd.correctionFactor = %.9g;\n", m_correctionFactor);
 	b2Dump("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2MotorJoint::GetImpulses(float* impulses) const
+{
+	impulses[0] = m_linearImpulse.x;
+	impulses[1] = m_linearImpulse.y;
+	impulses[2] = m_angularImpulse;
+}
+
+void b2MotorJoint::SetImpulses(const float* impulses)
+{
+	m_linearImpulse.x = impulses[0];
+	m_linearImpulse.y = impulses[1];
+	m_angularImpulse = impulses[2];
+}
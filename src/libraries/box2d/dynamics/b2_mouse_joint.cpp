@@ -24,6 +24,8 @@
 #include "box2d/b2_mouse_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // p = attached point, m = mouse point
 // C = p - m
 // Cdot = v
@@ -72,7 +74,7 @@ float b2MouseJoint::GetMaxForce() const
 
 void b2MouseJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassB = m_bodyB->m_invMass;
 	m_invIB = m_bodyB->m_invI;
@@ -190,3 +192,15 @@ void b2MouseJoint::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	m_targetA -= newOrigin;
 }
+
+void b2MouseJoint::GetImpulses(float* impulses) const
+{
+	impulses[0] = m_impulse.x;
+	impulses[1] = m_impulse.y;
+}
+
+void b2MouseJoint::SetImpulses(const float* impulses)
+{
+	m_impulse.x = impulses[0];
+	m_impulse.y = impulses[1];
+}
@@ -25,6 +25,8 @@
 #include "box2d/b2_wheel_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // Linear constraint (point-to-line)
 // d = pB - pA = xB + rB - xA - rA
 // C = dot(ay, d)
@@ -88,8 +90,8 @@ b2WheelJoint::b2WheelJoint(const b2WheelJointDef* def)
 
 void b2WheelJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -670,3 +672,21 @@ void b2WheelJoint::Draw(b2Draw* draw) const
 	draw->DrawPoint(pA, 5.0f, c1);
 	draw->DrawPoint(pB, 5.0f, c4);
 }
+
+void b2WheelJoint::GetImpulses(float* impulses) const
+{
+	impulses[0] = m_impulse;
+	impulses[1] = m_motorImpulse;
+	impulses[2] = m_springImpulse;
+	impulses[3] = m_lowerImpulse;
+	impulses[4] = m_upperImpulse;
+}
+
+void b2WheelJoint::SetImpulses(const float* impulses)
+{
+	m_impulse = impulses[0];
+	m_motorImpulse = impulses[1];
+	m_springImpulse = impulses[2];
+	m_lowerImpulse = impulses[3];
+	m_upperImpulse = impulses[4];
+}
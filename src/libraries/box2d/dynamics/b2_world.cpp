@@ -38,8 +38,42 @@
 #include "box2d/b2_timer.h"
 #include "box2d/b2_world.h"
 
+#include <algorithm>
+#include <atomic>
 #include <new>
 
+// An island found by b2World::Solve, stored as ranges into shared arrays so
+// that the islands can be solved in parallel.
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+};
+
+struct b2IslandTaskContext
+{
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
+
+	const b2IslandRange* ranges;
+	const int32* order;
+	int32 rangeCount;
+	std::atomic<int32> next;
+
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2ContactImpulse* impulses;
+
+	b2StackAllocator* allocators;
+	b2Profile* profiles;
+};
+
 b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = nullptr;
@@ -69,6 +103,10 @@ b2World::b2World(const b2Vec2& gravity)
 	m_contactManager.m_allocator = &m_blockAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
+
+	m_taskRunner = nullptr;
+	m_taskAllocators = nullptr;
+	m_taskAllocatorCount = 0;
 }
 
 b2World::~b2World()
@@ -90,6 +128,19 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	for (int32 i = 0; i < m_taskAllocatorCount; ++i)
+	{
+		m_taskAllocators[i].~b2StackAllocator();
+	}
+	b2Free(m_taskAllocators);
+}
+
+void b2World::SetTaskRunner(b2TaskRunner* runner)
+{
+	b2Assert(IsLocked() == false);
+	m_taskRunner = runner;
+	m_contactManager.m_taskRunner = runner;
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -421,6 +472,27 @@ void b2World::Solve(const b2TimeStep& step)
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+
+	// With a task runner, islands are only recorded here and solved in parallel below.
+	// Static bodies can appear in several islands, which bounds the body count.
+	int32 threadCount = m_taskRunner != nullptr ? m_taskRunner->GetThreadCount() : 1;
+	bool parallel = threadCount > 1;
+	b2IslandRange* ranges = nullptr;
+	b2Body** islandBodies = nullptr;
+	b2Contact** islandContacts = nullptr;
+	b2Joint** islandJoints = nullptr;
+	int32 rangeCount = 0;
+	int32 islandBodyCount = 0;
+	int32 islandContactCount = 0;
+	int32 islandJointCount = 0;
+	if (parallel)
+	{
+		ranges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+		islandBodies = (b2Body**)m_stackAllocator.Allocate((m_bodyCount + m_contactManager.m_contactCount + m_jointCount) * sizeof(b2Body*));
+		islandContacts = (b2Contact**)m_stackAllocator.Allocate(m_contactManager.m_contactCount * sizeof(b2Contact*));
+		islandJoints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	}
+
 	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 	{
 		if (seed->m_flags & b2Body::e_islandFlag)
@@ -535,11 +607,31 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (parallel)
+		{
+			b2IslandRange* range = ranges + rangeCount++;
+			range->bodyStart = islandBodyCount;
+			range->bodyCount = island.m_bodyCount;
+			range->contactStart = islandContactCount;
+			range->contactCount = island.m_contactCount;
+			range->jointStart = islandJointCount;
+			range->jointCount = island.m_jointCount;
+
+			memcpy(islandBodies + islandBodyCount, island.m_bodies, island.m_bodyCount * sizeof(b2Body*));
+			memcpy(islandContacts + islandContactCount, island.m_contacts, island.m_contactCount * sizeof(b2Contact*));
+			memcpy(islandJoints + islandJointCount, island.m_joints, island.m_jointCount * sizeof(b2Joint*));
+			islandBodyCount += island.m_bodyCount;
+			islandContactCount += island.m_contactCount;
+			islandJointCount += island.m_jointCount;
+		}
+		else
+		{
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -553,6 +645,95 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 	}
 
+	if (parallel)
+	{
+		b2ContactListener* listener = m_contactManager.m_contactListener;
+
+		int32 taskCount = b2Min(threadCount, rangeCount);
+		if (m_taskAllocatorCount < taskCount)
+		{
+			for (int32 i = 0; i < m_taskAllocatorCount; ++i)
+			{
+				m_taskAllocators[i].~b2StackAllocator();
+			}
+			b2Free(m_taskAllocators);
+
+			m_taskAllocators = (b2StackAllocator*)b2Alloc(taskCount * sizeof(b2StackAllocator));
+			for (int32 i = 0; i < taskCount; ++i)
+			{
+				new (m_taskAllocators + i) b2StackAllocator();
+			}
+			m_taskAllocatorCount = taskCount;
+		}
+
+		// Solve the largest islands first so the work is spread evenly.
+		int32* order = (int32*)m_stackAllocator.Allocate(rangeCount * sizeof(int32));
+		for (int32 i = 0; i < rangeCount; ++i)
+		{
+			order[i] = i;
+		}
+		std::stable_sort(order, order + rangeCount, [ranges](int32 a, int32 b)
+		{
+			return ranges[a].bodyCount + ranges[a].contactCount > ranges[b].bodyCount + ranges[b].contactCount;
+		});
+
+		b2ContactImpulse* impulses = nullptr;
+		if (listener != nullptr)
+		{
+			impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(islandContactCount * sizeof(b2ContactImpulse));
+		}
+
+		b2Profile* profiles = (b2Profile*)m_stackAllocator.Allocate(taskCount * sizeof(b2Profile));
+		memset(profiles, 0, taskCount * sizeof(b2Profile));
+
+		b2IslandTaskContext context;
+		context.step = &step;
+		context.gravity = m_gravity;
+		context.allowSleep = m_allowSleep;
+		context.ranges = ranges;
+		context.order = order;
+		context.rangeCount = rangeCount;
+		context.next = 0;
+		context.bodies = islandBodies;
+		context.contacts = islandContacts;
+		context.joints = islandJoints;
+		context.impulses = impulses;
+		context.allocators = m_taskAllocators;
+		context.profiles = profiles;
+
+		if (taskCount > 0)
+		{
+			m_taskRunner->ParallelFor(taskCount, SolveIslandTask, &context);
+		}
+
+		for (int32 i = 0; i < taskCount; ++i)
+		{
+			m_profile.solveInit += profiles[i].solveInit;
+			m_profile.solveVelocity += profiles[i].solveVelocity;
+			m_profile.solvePosition += profiles[i].solvePosition;
+		}
+
+		// Report contact impulses in island order, as the serial solver does.
+		if (listener != nullptr)
+		{
+			for (int32 i = 0; i < islandContactCount; ++i)
+			{
+				listener->PostSolve(islandContacts[i], impulses + i);
+			}
+		}
+
+		m_stackAllocator.Free(profiles);
+		if (impulses != nullptr)
+		{
+			m_stackAllocator.Free(impulses);
+		}
+		m_stackAllocator.Free(order);
+		m_stackAllocator.Free(islandJoints);
+		m_stackAllocator.Free(islandContacts);
+		m_stackAllocator.Free(islandBodies);
+		m_stackAllocator.Free(ranges);
+	}
+
 	m_stackAllocator.Free(stack);
 
 	{
@@ -581,6 +762,49 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+void b2World::SolveIslandTask(int32 index, void* context)
+{
+	b2IslandTaskContext* ctx = (b2IslandTaskContext*)context;
+	b2StackAllocator* allocator = ctx->allocators + index;
+	b2Profile* taskProfile = ctx->profiles + index;
+
+	for (;;)
+	{
+		int32 next = ctx->next.fetch_add(1, std::memory_order_relaxed);
+		if (next >= ctx->rangeCount)
+		{
+			break;
+		}
+
+		const b2IslandRange* range = ctx->ranges + ctx->order[next];
+
+		b2Island island(range->bodyCount, range->contactCount, range->jointCount, allocator, nullptr, true);
+		for (int32 i = 0; i < range->bodyCount; ++i)
+		{
+			island.Add(ctx->bodies[range->bodyStart + i]);
+		}
+		for (int32 i = 0; i < range->contactCount; ++i)
+		{
+			island.Add(ctx->contacts[range->contactStart + i]);
+		}
+		for (int32 i = 0; i < range->jointCount; ++i)
+		{
+			island.Add(ctx->joints[range->jointStart + i]);
+		}
+
+		if (ctx->impulses != nullptr)
+		{
+			island.m_impulses = ctx->impulses + range->contactStart;
+		}
+
+		b2Profile profile;
+		island.Solve(&profile, *ctx->step, ctx->gravity, ctx->allowSleep);
+		taskProfile->solveInit += profile.solveInit;
+		taskProfile->solveVelocity += profile.solveVelocity;
+		taskProfile->solvePosition += profile.solvePosition;
+	}
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
@@ -1320,3 +1544,493 @@ void b2World::Dump()
 
 	b2CloseDump();
 }
+
+// Saved world states start with this, followed by the addresses of the bodies,
+// fixtures and joints they belong to, then the simulation state.
+static const uint32 b2_worldStateMagic = 0x53573262;
+
+// Writes a world state, or only counts its size if data is null.
+struct b2StateWriter
+{
+	uint8* data;
+	int32 size;
+
+	template <typename T>
+	void Write(const T& value)
+	{
+		WriteBytes(&value, sizeof(T));
+	}
+
+	void WriteBytes(const void* bytes, int32 count)
+	{
+		if (data != nullptr)
+		{
+			memcpy(data + size, bytes, count);
+		}
+		size += count;
+	}
+};
+
+// Reads a world state. Once reading goes past the end, valid is false and all
+// further reads return zeroes.
+struct b2StateReader
+{
+	const uint8* data;
+	int32 size;
+	int32 offset;
+	bool valid;
+
+	template <typename T>
+	T Read()
+	{
+		T value{};
+		const void* bytes = ReadBytes(sizeof(T));
+		if (bytes != nullptr)
+		{
+			memcpy(&value, bytes, sizeof(T));
+		}
+		return value;
+	}
+
+	const void* ReadBytes(int32 count)
+	{
+		if (valid == false || count < 0 || count > size - offset)
+		{
+			valid = false;
+			return nullptr;
+		}
+		const void* bytes = data + offset;
+		offset += count;
+		return bytes;
+	}
+};
+
+// The part of a contact's state which is saved.
+struct b2ContactState
+{
+	int32 proxyIdA;
+	int32 proxyIdB;
+	uint32 flags;
+	b2Manifold manifold;
+	int32 toiCount;
+	float toi;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+};
+
+void b2World::WriteState(b2StateWriter& writer) const
+{
+	writer.Write(b2_worldStateMagic);
+	writer.Write(m_bodyCount);
+	writer.Write(m_jointCount);
+
+	// Topology, to detect when the state doesn't belong to the world anymore.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		writer.Write(b);
+		writer.Write(b->m_fixtureCount);
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			writer.Write(f);
+			writer.Write(f->m_proxies);
+			writer.Write(f->m_proxyCount);
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				writer.Write(f->m_proxies[i].proxyId);
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		writer.Write(j);
+	}
+
+	writer.Write(m_inv_dt0);
+	writer.Write(m_newContacts);
+	writer.Write(m_stepComplete);
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		writer.Write(b->m_flags);
+		writer.Write(b->m_xf);
+		writer.Write(b->m_sweep);
+		writer.Write(b->m_linearVelocity);
+		writer.Write(b->m_angularVelocity);
+		writer.Write(b->m_force);
+		writer.Write(b->m_torque);
+		writer.Write(b->m_sleepTime);
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				writer.Write(f->m_proxies[i].aabb);
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		float impulses[b2_maxJointImpulses] = {};
+		j->GetImpulses(impulses);
+		writer.WriteBytes(impulses, sizeof(impulses));
+	}
+
+	// Contacts are recreated in reverse list order when restoring. That also
+	// restores the order of each body's contact edges, which matches the list.
+	writer.Write(m_contactManager.m_contactCount);
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2ContactState state{};
+		state.proxyIdA = c->m_fixtureA->m_proxies[c->m_indexA].proxyId;
+		state.proxyIdB = c->m_fixtureB->m_proxies[c->m_indexB].proxyId;
+		state.flags = c->m_flags;
+		state.manifold = c->m_manifold;
+		state.toiCount = c->m_toiCount;
+		state.toi = c->m_toi;
+		state.friction = c->m_friction;
+		state.restitution = c->m_restitution;
+		state.restitutionThreshold = c->m_restitutionThreshold;
+		state.tangentSpeed = c->m_tangentSpeed;
+		writer.Write(state);
+	}
+
+	const b2BroadPhase& broadPhase = m_contactManager.m_broadPhase;
+	writer.Write(broadPhase.m_proxyCount);
+	writer.Write(broadPhase.m_moveCount);
+	writer.WriteBytes(broadPhase.m_moveBuffer, broadPhase.m_moveCount * sizeof(int32));
+
+	const b2DynamicTree& tree = broadPhase.m_tree;
+	writer.Write(tree.m_root);
+	writer.Write(tree.m_nodeCount);
+	writer.Write(tree.m_nodeCapacity);
+	writer.Write(tree.m_freeList);
+	writer.Write(tree.m_insertionCount);
+	writer.WriteBytes(tree.m_nodes, tree.m_nodeCapacity * sizeof(b2TreeNode));
+}
+
+bool b2World::ReadState(b2StateReader& reader, bool apply)
+{
+	if (reader.Read<uint32>() != b2_worldStateMagic ||
+		reader.Read<int32>() != m_bodyCount ||
+		reader.Read<int32>() != m_jointCount)
+	{
+		return false;
+	}
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (reader.Read<b2Body*>() != b || reader.Read<int32>() != b->m_fixtureCount)
+		{
+			return false;
+		}
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			if (reader.Read<b2Fixture*>() != f ||
+				reader.Read<b2FixtureProxy*>() != f->m_proxies ||
+				reader.Read<int32>() != f->m_proxyCount)
+			{
+				return false;
+			}
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				if (reader.Read<int32>() != f->m_proxies[i].proxyId)
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		if (reader.Read<b2Joint*>() != j)
+		{
+			return false;
+		}
+	}
+
+	if (apply)
+	{
+		// Destroying a touching contact wakes its bodies, so this happens
+		// before the body flags are restored.
+		b2Contact* c = m_contactManager.m_contactList;
+		while (c)
+		{
+			b2Contact* next = c->m_next;
+			if (m_contactManager.m_contactListener)
+			{
+				m_contactManager.m_contactListener->DestroyContact(c);
+			}
+			b2Contact::Destroy(c, &m_blockAllocator);
+			c = next;
+		}
+
+		m_contactManager.m_contactList = nullptr;
+		m_contactManager.m_contactCount = 0;
+
+		for (b2Body* b = m_bodyList; b; b = b->m_next)
+		{
+			b->m_contactList = nullptr;
+		}
+	}
+
+	float inv_dt0 = reader.Read<float>();
+	bool newContacts = reader.Read<bool>();
+	bool stepComplete = reader.Read<bool>();
+	if (apply)
+	{
+		m_inv_dt0 = inv_dt0;
+		m_newContacts = newContacts;
+		m_stepComplete = stepComplete;
+	}
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		uint16 flags = reader.Read<uint16>();
+		b2Transform xf = reader.Read<b2Transform>();
+		b2Sweep sweep = reader.Read<b2Sweep>();
+		b2Vec2 linearVelocity = reader.Read<b2Vec2>();
+		float angularVelocity = reader.Read<float>();
+		b2Vec2 force = reader.Read<b2Vec2>();
+		float torque = reader.Read<float>();
+		float sleepTime = reader.Read<float>();
+
+		if (apply)
+		{
+			b->m_flags = flags;
+			b->m_xf = xf;
+			b->m_sweep = sweep;
+			b->m_linearVelocity = linearVelocity;
+			b->m_angularVelocity = angularVelocity;
+			b->m_force = force;
+			b->m_torque = torque;
+			b->m_sleepTime = sleepTime;
+		}
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2AABB aabb = reader.Read<b2AABB>();
+				if (apply)
+				{
+					f->m_proxies[i].aabb = aabb;
+				}
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		const void* impulses = reader.ReadBytes(b2_maxJointImpulses * sizeof(float));
+		if (apply && impulses != nullptr)
+		{
+			float values[b2_maxJointImpulses];
+			memcpy(values, impulses, sizeof(values));
+			j->SetImpulses(values);
+		}
+	}
+
+	b2DynamicTree& tree = m_contactManager.m_broadPhase.m_tree;
+
+	int32 contactCount = reader.Read<int32>();
+	if (contactCount < 0 || contactCount > reader.size / (int32)sizeof(b2ContactState))
+	{
+		return false;
+	}
+
+	const uint8* contacts = (const uint8*)reader.ReadBytes(contactCount * sizeof(b2ContactState));
+	if (contacts == nullptr)
+	{
+		return false;
+	}
+
+	for (int32 i = contactCount - 1; i >= 0; --i)
+	{
+		b2ContactState state;
+		memcpy(&state, contacts + i * sizeof(b2ContactState), sizeof(state));
+
+		// Proxy ids are part of the topology checked above, so the current
+		// tree still maps them to the same fixtures.
+		if (state.proxyIdA < 0 || state.proxyIdA >= tree.m_nodeCapacity || tree.m_nodes[state.proxyIdA].height != 0 ||
+			state.proxyIdB < 0 || state.proxyIdB >= tree.m_nodeCapacity || tree.m_nodes[state.proxyIdB].height != 0 ||
+			state.manifold.pointCount < 0 || state.manifold.pointCount > b2_maxManifoldPoints)
+		{
+			return false;
+		}
+
+		if (apply == false)
+		{
+			continue;
+		}
+
+		b2FixtureProxy* proxyA = (b2FixtureProxy*)tree.GetUserData(state.proxyIdA);
+		b2FixtureProxy* proxyB = (b2FixtureProxy*)tree.GetUserData(state.proxyIdB);
+		b2Contact* c = b2Contact::Create(proxyA->fixture, proxyA->childIndex, proxyB->fixture, proxyB->childIndex, &m_blockAllocator);
+		if (c == nullptr)
+		{
+			continue;
+		}
+
+		c->m_flags = state.flags;
+		c->m_manifold = state.manifold;
+		c->m_toiCount = state.toiCount;
+		c->m_toi = state.toi;
+		c->m_friction = state.friction;
+		c->m_restitution = state.restitution;
+		c->m_restitutionThreshold = state.restitutionThreshold;
+		c->m_tangentSpeed = state.tangentSpeed;
+
+		b2Body* bodyA = c->m_fixtureA->m_body;
+		b2Body* bodyB = c->m_fixtureB->m_body;
+
+		c->m_prev = nullptr;
+		c->m_next = m_contactManager.m_contactList;
+		if (m_contactManager.m_contactList != nullptr)
+		{
+			m_contactManager.m_contactList->m_prev = c;
+		}
+		m_contactManager.m_contactList = c;
+
+		c->m_nodeA.contact = c;
+		c->m_nodeA.other = bodyB;
+		c->m_nodeA.prev = nullptr;
+		c->m_nodeA.next = bodyA->m_contactList;
+		if (bodyA->m_contactList != nullptr)
+		{
+			bodyA->m_contactList->prev = &c->m_nodeA;
+		}
+		bodyA->m_contactList = &c->m_nodeA;
+
+		c->m_nodeB.contact = c;
+		c->m_nodeB.other = bodyA;
+		c->m_nodeB.prev = nullptr;
+		c->m_nodeB.next = bodyB->m_contactList;
+		if (bodyB->m_contactList != nullptr)
+		{
+			bodyB->m_contactList->prev = &c->m_nodeB;
+		}
+		bodyB->m_contactList = &c->m_nodeB;
+
+		++m_contactManager.m_contactCount;
+	}
+
+	b2BroadPhase& broadPhase = m_contactManager.m_broadPhase;
+	int32 proxyCount = reader.Read<int32>();
+	int32 moveCount = reader.Read<int32>();
+	if (proxyCount != broadPhase.m_proxyCount || moveCount < 0)
+	{
+		return false;
+	}
+
+	const void* moveBuffer = reader.ReadBytes(moveCount * sizeof(int32));
+
+	int32 root = reader.Read<int32>();
+	int32 nodeCount = reader.Read<int32>();
+	int32 nodeCapacity = reader.Read<int32>();
+	int32 freeList = reader.Read<int32>();
+	int32 insertionCount = reader.Read<int32>();
+	if (nodeCapacity <= 0 || nodeCapacity > reader.size / (int32)sizeof(b2TreeNode))
+	{
+		return false;
+	}
+
+	const void* nodes = reader.ReadBytes(nodeCapacity * sizeof(b2TreeNode));
+	if (reader.valid == false || moveBuffer == nullptr || nodes == nullptr || reader.offset != reader.size)
+	{
+		return false;
+	}
+
+	if (apply == false)
+	{
+		return true;
+	}
+
+	if (broadPhase.m_moveCapacity < moveCount)
+	{
+		b2Free(broadPhase.m_moveBuffer);
+		broadPhase.m_moveCapacity = moveCount;
+		broadPhase.m_moveBuffer = (int32*)b2Alloc(moveCount * sizeof(int32));
+	}
+	memcpy(broadPhase.m_moveBuffer, moveBuffer, moveCount * sizeof(int32));
+	broadPhase.m_moveCount = moveCount;
+
+	if (tree.m_nodeCapacity < nodeCapacity)
+	{
+		b2Free(tree.m_nodes);
+		tree.m_nodes = (b2TreeNode*)b2Alloc(nodeCapacity * sizeof(b2TreeNode));
+		tree.m_nodeCapacity = nodeCapacity;
+	}
+	memcpy(tree.m_nodes, nodes, nodeCapacity * sizeof(b2TreeNode));
+
+	tree.m_root = root;
+	tree.m_nodeCount = nodeCount;
+	tree.m_freeList = freeList;
+	tree.m_insertionCount = insertionCount;
+
+	// Nodes allocated since the state was saved go to the end of the free
+	// list, where growing the tree would have put them.
+	if (tree.m_nodeCapacity > nodeCapacity)
+	{
+		for (int32 i = nodeCapacity; i < tree.m_nodeCapacity - 1; ++i)
+		{
+			tree.m_nodes[i].next = i + 1;
+			tree.m_nodes[i].height = -1;
+		}
+		tree.m_nodes[tree.m_nodeCapacity - 1].next = b2_nullNode;
+		tree.m_nodes[tree.m_nodeCapacity - 1].height = -1;
+
+		if (tree.m_freeList == b2_nullNode)
+		{
+			tree.m_freeList = nodeCapacity;
+		}
+		else
+		{
+			int32 last = tree.m_freeList;
+			while (tree.m_nodes[last].next != b2_nullNode)
+			{
+				last = tree.m_nodes[last].next;
+			}
+			tree.m_nodes[last].next = nodeCapacity;
+		}
+	}
+
+	return true;
+}
+
+int32 b2World::GetStateSize() const
+{
+	b2StateWriter writer = {nullptr, 0};
+	WriteState(writer);
+	return writer.size;
+}
+
+void b2World::SaveState(void* data) const
+{
+	b2StateWriter writer = {(uint8*)data, 0};
+	WriteState(writer);
+}
+
+bool b2World::RestoreState(const void* data, int32 size)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return false;
+	}
+
+	// Validate everything before changing the world.
+	b2StateReader validator = {(const uint8*)data, size, 0, true};
+	if (ReadState(validator, false) == false)
+	{
+		return false;
+	}
+
+	b2StateReader reader = {(const uint8*)data, size, 0, true};
+	return ReadState(reader, true);
+}
@@ -33,6 +33,14 @@
 #include <cstdio>
 #include <cstddef>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 extern "C" {
 #define LUA_COMPAT_ALL
@@ -243,13 +251,38 @@ static void push_event(lua_State *l, ENetEvent *event) {
 	lua_setfield(l, -2, "type");
 }
 
+/**
+ * Read the optional channel id and flag string of a packet
+ * idx is position of the channel id
+ */
+static void read_packet_options(lua_State *l, int idx, enet_uint8 *channel_id, enet_uint32 *flags) {
+	int argc = lua_gettop(l);
+	*channel_id = 0;
+
+	if (argc >= idx+1 && !lua_isnil(l, idx+1)) {
+		const char *flag_str = luaL_checkstring(l, idx+1);
+		if (strcmp("unsequenced", flag_str) == 0) {
+			*flags = ENET_PACKET_FLAG_UNSEQUENCED;
+		} else if (strcmp("reliable", flag_str) == 0) {
+			*flags = ENET_PACKET_FLAG_RELIABLE;
+		} else if (strcmp("unreliable", flag_str) == 0) {
+			*flags = 0;
+		} else {
+			luaL_error(l, "Unknown packet flag: %s", flag_str);
+		}
+	}
+
+	if (argc >= idx && !lua_isnil(l, idx)) {
+		*channel_id = (int) luaL_checknumber(l, idx);
+	}
+}
+
 /**
  * Read a packet off the stack as a string
  * idx is position of string or lightuserdata
  */
 static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
 	size_t size;
-	int argc = lua_gettop(l);
 	const void* data;
 
 	if (lua_islightuserdata(l, idx)) {
@@ -263,31 +296,177 @@ static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
 	ENetPacket *packet;
 
 	enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
-	*channel_id = 0;
+	read_packet_options(l, idx+1, channel_id, &flags);
 
-	if (argc >= idx+2 && !lua_isnil(l, idx+2)) {
-		const char *flag_str = luaL_checkstring(l, idx+2);
-		if (strcmp("unsequenced", flag_str) == 0) {
-			flags = ENET_PACKET_FLAG_UNSEQUENCED;
-		} else if (strcmp("reliable", flag_str) == 0) {
-			flags = ENET_PACKET_FLAG_RELIABLE;
-		} else if (strcmp("unreliable", flag_str) == 0) {
-			flags = 0;
-		} else {
-			luaL_error(l, "Unknown packet flag: %s", flag_str);
+	packet = enet_packet_create(data, size, flags);
+	if (packet == NULL) {
+		luaL_error(l, "Failed to create packet");
+	}
+
+	return packet;
+}
+
+/**
+ * A thread that services a host continuously, so acks, pings and incoming
+ * packets are handled regardless of how often Lua gets to run. Events are
+ * queued for host:service() and host:check_events() to pick up, and sends
+ * made from Lua go out on the thread's next pass.
+ *
+ * While a host has a service thread, every ENet call on it or its peers has
+ * to hold the service's mutex (see HostLock). Nothing that can raise a Lua
+ * error may run while it is held.
+ */
+struct HostService {
+	ENetHost *host;
+	std::thread thread;
+	std::atomic<bool> running;
+	enet_uint32 interval;
+
+	// Guards the host and its peers.
+	std::mutex host_mutex;
+
+	// Guards events and failed.
+	std::mutex event_mutex;
+	std::condition_variable event_cond;
+	std::deque<ENetEvent> events;
+	bool failed;
+};
+
+static std::mutex services_mutex;
+static std::unordered_map<ENetHost *, HostService *> services;
+static std::atomic<int> service_count(0);
+
+static HostService *find_service(ENetHost *host) {
+	// Hosts without a service thread are the common case, skip the lookup.
+	if (service_count.load(std::memory_order_acquire) == 0)
+		return NULL;
+
+	std::lock_guard<std::mutex> lock(services_mutex);
+	auto it = services.find(host);
+	return it != services.end() ? it->second : NULL;
+}
+
+class HostLock {
+public:
+	HostLock(ENetHost *host) : service(find_service(host)) {
+		if (service)
+			service->host_mutex.lock();
+	}
+
+	~HostLock() {
+		if (service)
+			service->host_mutex.unlock();
+	}
+
+private:
+	HostService *service;
+};
+
+static void service_thread(HostService *service) {
+	ENetHost *host = service->host;
+	ENetEvent event;
+
+	while (service->running.load()) {
+		bool received = false;
+		int out = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(service->host_mutex);
+
+			// Queue everything that's ready in one pass, holding the event
+			// lock only briefly for each so Lua is never kept waiting.
+			out = enet_host_service(host, &event, 0);
+			while (out > 0) {
+				{
+					std::lock_guard<std::mutex> elock(service->event_mutex);
+					service->events.push_back(event);
+				}
+				received = true;
+				out = enet_host_check_events(host, &event);
+			}
+		}
+
+		if (out < 0) {
+			std::lock_guard<std::mutex> elock(service->event_mutex);
+			service->failed = true;
+			received = true;
 		}
+
+		if (received)
+			service->event_cond.notify_all();
+
+		if (out < 0)
+			break;
+
+		// Sleep until data arrives, or the interval passes so that queued
+		// sends and resends go out.
+		enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+		enet_socket_wait(host->socket, &condition, service->interval);
 	}
+}
 
-	if (argc >= idx+1 && !lua_isnil(l, idx+1)) {
-		*channel_id = (int) luaL_checknumber(l, idx+1);
+static void start_service(ENetHost *host, enet_uint32 interval) {
+	HostService *service = new HostService();
+	service->host = host;
+	service->running = true;
+	service->interval = interval;
+	service->failed = false;
+
+	{
+		std::lock_guard<std::mutex> lock(services_mutex);
+		services[host] = service;
 	}
+	service_count++;
 
-	packet = enet_packet_create(data, size, flags);
-	if (packet == NULL) {
-		luaL_error(l, "Failed to create packet");
+	service->thread = std::thread(service_thread, service);
+}
+
+/**
+ * Stops the service thread of a host, if it has one. Events it queued that
+ * weren't picked up are discarded.
+ */
+static void stop_service(ENetHost *host) {
+	HostService *service = find_service(host);
+	if (!service) return;
+
+	service->running = false;
+	service->thread.join();
+
+	{
+		std::lock_guard<std::mutex> lock(services_mutex);
+		services.erase(host);
 	}
+	service_count--;
 
-	return packet;
+	for (ENetEvent &event : service->events) {
+		if (event.type == ENET_EVENT_TYPE_RECEIVE)
+			enet_packet_destroy(event.packet);
+	}
+
+	delete service;
+}
+
+/**
+ * Takes the oldest event queued by a service thread, waiting up to timeout
+ * milliseconds for one. Returns like enet_host_service.
+ */
+static int pop_service_event(HostService *service, ENetEvent *event, int timeout) {
+	std::unique_lock<std::mutex> lock(service->event_mutex);
+
+	if (service->events.empty() && !service->failed && timeout > 0) {
+		service->event_cond.wait_for(lock, std::chrono::milliseconds(timeout), [&]() {
+			return !service->events.empty() || service->failed;
+		});
+	}
+
+	if (service->events.empty())
+		return service->failed ? -1 : 0;
+
+	// The received packet is handed over as-is, its data is only copied
+	// once into the Lua string.
+	*event = service->events.front();
+	service->events.pop_front();
+	return 1;
 }
 
 /**
@@ -370,7 +549,12 @@ static int host_service(lua_State *l) {
 	if (lua_gettop(l) > 1)
 		timeout = (int) luaL_checknumber(l, 2);
 
-	out = enet_host_service(host, &event, timeout);
+	HostService *service = find_service(host);
+	if (service) {
+		out = pop_service_event(service, &event, timeout);
+	} else {
+		out = enet_host_service(host, &event, timeout);
+	}
 	if (out == 0) return 0;
 	if (out < 0) return luaL_error(l, "Error during service");
 
@@ -387,7 +571,13 @@ static int host_check_events(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 	ENetEvent event;
-	int out = enet_host_check_events(host, &event);
+	int out;
+	HostService *service = find_service(host);
+	if (service) {
+		out = pop_service_event(service, &event, 0);
+	} else {
+		out = enet_host_check_events(host, &event);
+	}
 	if (out == 0) return 0;
 	if (out < 0) return luaL_error(l, "Error checking event");
 
@@ -405,7 +595,11 @@ static int host_compress_with_range_coder(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 
-	int result = enet_host_compress_with_range_coder (host);
+	int result;
+	{
+		HostLock lock(host);
+		result = enet_host_compress_with_range_coder (host);
+	}
 	if (result == 0) {
 		lua_pushboolean (l, 1);
 	} else {
@@ -443,7 +637,10 @@ static int host_connect(lua_State *l) {
 	}
 
 	// printf("host connect, channels=%d, data=%d\n", channel_count, data);
-	peer = enet_host_connect(host, &address, channel_count, data);
+	{
+		HostLock lock(host);
+		peer = enet_host_connect(host, &address, channel_count, data);
+	}
 
 	if (peer == NULL) {
 		return luaL_error(l, "Failed to create peer");
@@ -459,6 +656,7 @@ static int host_flush(lua_State *l) {
 	if (!host) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
+	HostLock lock(host);
 	enet_host_flush(host);
 	return 0;
 }
@@ -471,6 +669,7 @@ static int host_broadcast(lua_State *l) {
 
 	enet_uint8 channel_id;
 	ENetPacket *packet = read_packet(l, 2, &channel_id);
+	HostLock lock(host);
 	enet_host_broadcast(host, channel_id, packet);
 	return 0;
 }
@@ -482,6 +681,7 @@ static int host_channel_limit(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 	int limit = (int) luaL_checknumber(l, 2);
+	HostLock lock(host);
 	enet_host_channel_limit(host, limit);
 	return 0;
 }
@@ -493,6 +693,7 @@ static int host_bandwidth_limit(lua_State *l) {
 	}
 	enet_uint32 in_bandwidth = (int) luaL_checknumber(l, 2);
 	enet_uint32 out_bandwidth = (int) luaL_checknumber(l, 2);
+	HostLock lock(host);
 	enet_host_bandwidth_limit(host, in_bandwidth, out_bandwidth);
 	return 0;
 }
@@ -579,6 +780,7 @@ static int host_gc(lua_State *l) {
 	ENetHost** host = (ENetHost**)luaL_checkudata(l, 1, "enet_host");
 	// We don't want to crash by destroying a non-existant host.
 	if (*host) {
+		stop_service(*host);
 		enet_host_destroy(*host);
 	}
 	*host = NULL;
@@ -599,6 +801,7 @@ static int peer_tostring(lua_State *l) {
 
 static int peer_ping(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
+	HostLock lock(peer->host);
 	enet_peer_ping(peer);
 	return 0;
 }
@@ -610,6 +813,7 @@ static int peer_throttle_configure(lua_State *l) {
 	enet_uint32 acceleration = (int) luaL_checknumber(l, 3);
 	enet_uint32 deceleration = (int) luaL_checknumber(l, 4);
 
+	HostLock lock(peer->host);
 	enet_peer_throttle_configure(peer, interval, acceleration, deceleration);
 	return 0;
 }
@@ -644,6 +848,7 @@ static int peer_ping_interval(lua_State *l) {
 
 	if (lua_gettop(l) > 1) {
 		enet_uint32 interval = (int) luaL_checknumber(l, 2);
+		HostLock lock(peer->host);
 		enet_peer_ping_interval (peer, interval);
 	}
 
@@ -668,6 +873,7 @@ static int peer_timeout(lua_State *l) {
 			if (!lua_isnil(l, 2)) timeout_limit = (int) luaL_checknumber(l, 2);
 	}
 
+	HostLock lock(peer->host);
 	enet_peer_timeout (peer, timeout_limit, timeout_minimum, timeout_maximum);
 
 	lua_pushinteger (l, peer->timeoutLimit);
@@ -681,6 +887,7 @@ static int peer_disconnect(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect(peer, data);
 	return 0;
 }
@@ -689,6 +896,7 @@ static int peer_disconnect_now(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect_now(peer, data);
 	return 0;
 }
@@ -697,6 +905,7 @@ static int peer_disconnect_later(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect_later(peer, data);
 	return 0;
 }
@@ -713,7 +922,13 @@ static int peer_index(lua_State *l) {
 static int peer_state(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
-	switch (peer->state) {
+	ENetPeerState state;
+	{
+		HostLock lock(peer->host);
+		state = peer->state;
+	}
+
+	switch (state) {
 		case (ENET_PEER_STATE_DISCONNECTED):
 			lua_pushstring (l, "disconnected");
 			break;
@@ -762,6 +977,7 @@ static int peer_connect_id(lua_State *l) {
 
 static int peer_reset(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
+	HostLock lock(peer->host);
 	enet_peer_reset(peer);
 	return 0;
 }
@@ -775,7 +991,10 @@ static int peer_receive(lua_State *l) {
 		channel_id = (int) luaL_checknumber(l, 2);
 	}
 
-	packet = enet_peer_receive(peer, &channel_id);
+	{
+		HostLock lock(peer->host);
+		packet = enet_peer_receive(peer, &channel_id);
+	}
 	if (packet == NULL) return 0;
 
 	lua_pushlstring(l, (const char *)packet->data, packet->dataLength);
@@ -801,7 +1020,11 @@ static int peer_send(lua_State *l) {
 	ENetPacket *packet = read_packet(l, 2, &channel_id);
 
 	// printf("sending, channel_id=%d\n", channel_id);
-	int ret = enet_peer_send(peer, channel_id, packet);
+	int ret;
+	{
+		HostLock lock(peer->host);
+		ret = enet_peer_send(peer, channel_id, packet);
+	}
 	if (ret < 0) {
 		enet_packet_destroy(packet);
 	}
@@ -811,6 +1034,109 @@ static int peer_send(lua_State *l) {
 	return 1;
 }
 
+/**
+ * Send a list of lua strings to a peer, queueing them all at once
+ * Args:
+ *	table of packet data strings
+ *	channel id
+ *	flags ["reliable", nil]
+ *
+ * Return
+ *	the number of packets queued
+ */
+static int peer_send_batch(lua_State *l) {
+	ENetPeer *peer = check_peer(l, 1);
+	luaL_checktype(l, 2, LUA_TTABLE);
+
+	enet_uint8 channel_id;
+	enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+	read_packet_options(l, 3, &channel_id, &flags);
+
+	// Check every entry before creating any packets, so an error can't leak
+	// them. The strings stay alive in the table for the rest of the call.
+	int count = (int) lua_objlen(l, 2);
+	std::vector<ENetPacket *> packets(count, NULL);
+	std::vector<const char *> datas(count);
+	std::vector<size_t> sizes(count);
+
+	for (int i = 0; i < count; i++) {
+		lua_rawgeti(l, 2, i + 1);
+		if (lua_type(l, -1) != LUA_TSTRING)
+			return luaL_error(l, "Packet %d in the list is not a string", i + 1);
+		datas[i] = lua_tolstring(l, -1, &sizes[i]);
+		lua_pop(l, 1);
+	}
+
+	for (int i = 0; i < count; i++) {
+		packets[i] = enet_packet_create(datas[i], sizes[i], flags);
+		if (packets[i] == NULL) {
+			for (int j = 0; j < i; j++)
+				enet_packet_destroy(packets[j]);
+			return luaL_error(l, "Failed to create packet");
+		}
+	}
+
+	int sent = 0;
+	{
+		HostLock lock(peer->host);
+		for (int i = 0; i < count; i++) {
+			if (enet_peer_send(peer, channel_id, packets[i]) < 0) {
+				enet_packet_destroy(packets[i]);
+			} else {
+				sent++;
+			}
+		}
+	}
+
+	lua_pushinteger(l, sent);
+
+	return 1;
+}
+
+/**
+ * Service the host on a separate thread until stopped or destroyed
+ * Args:
+ *	[interval = 1], maximum milliseconds between passes
+ */
+static int host_start_service_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+
+	int interval = 1;
+	if (lua_gettop(l) > 1 && !lua_isnil(l, 2))
+		interval = (int) luaL_checknumber(l, 2);
+	if (interval < 0)
+		return luaL_argerror(l, 2, "interval must not be negative");
+
+	if (find_service(host))
+		return luaL_error(l, "Host already has a service thread");
+
+	start_service(host, (enet_uint32) interval);
+	return 0;
+}
+
+static int host_stop_service_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+
+	stop_service(host);
+	return 0;
+}
+
+static int host_has_service_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+
+	lua_pushboolean(l, find_service(host) != NULL);
+	return 1;
+}
+
 static const struct luaL_Reg enet_funcs [] = {
 	{"host_create", host_create},
 	{"linked_version", linked_version},
@@ -838,6 +1164,11 @@ static const struct luaL_Reg enet_host_funcs [] = {
 	{"service_time", host_service_time},
 	{"peer_count", host_peer_count},
 	{"get_peer", host_get_peer},
+
+	// servicing the host on its own thread
+	{"start_service_thread", host_start_service_thread},
+	{"stop_service_thread", host_stop_service_thread},
+	{"has_service_thread", host_has_service_thread},
 	{NULL, NULL}
 };
 
@@ -849,6 +1180,7 @@ static const struct luaL_Reg enet_peer_funcs [] = {
 	{"ping", peer_ping},
 	{"receive", peer_receive},
 	{"send", peer_send},
+	{"send_batch", peer_send_batch},
 	{"throttle_configure", peer_throttle_configure},
 	{"ping_interval", peer_ping_interval},
 	{"timeout", peer_timeout},
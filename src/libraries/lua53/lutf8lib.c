@@ -87,6 +87,17 @@ static const char *utf8_decode (const char *o, int *val) {
 }
 
 
+/*
+** Check whether the next 8 bytes are all ascii.
+*/
+static int isascii8 (const char *s) {
+  unsigned int a, b;
+  memcpy(&a, s, 4);
+  memcpy(&b, s + 4, 4);
+  return ((a | b) & 0x80808080u) == 0;
+}
+
+
 /*
 ** utf8len(s [, i [, j]]) --> number of characters that start in the
 ** range [i,j], or nil + current position if 's' is not well formed in
@@ -103,7 +114,15 @@ static int utflen (lua_State *L) {
   luaL_argcheck(L, --posj < (lua_Integer)len, 3,
                    "final position out of string");
   while (posi <= posj) {
-    const char *s1 = utf8_decode(s + posi, NULL);
+    const char *s1;
+    /* ascii characters don't need decoding, count them 8 at a time */
+    while (posj - posi >= 7 && isascii8(s + posi)) {
+      posi += 8;
+      n += 8;
+    }
+    if (posi > posj)
+      break;
+    s1 = utf8_decode(s + posi, NULL);
     if (s1 == NULL) {  /* conversion error? */
       lua_pushnil(L);  /* return nil ... */
       lua_pushinteger(L, posi + 1);  /* ... and current position */
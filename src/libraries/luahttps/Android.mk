@@ -19,6 +19,7 @@ LOCAL_SRC_FILES := \
 	src/common/HTTPRequest.cpp \
 	src/common/HTTPSClient.cpp \
 	src/common/PlaintextConnection.cpp \
+	src/common/RequestQueue.cpp \
 	src/android/AndroidClient.cpp
 
 LOCAL_SHARED_LIBRARIES := liblove
@@ -0,0 +1,142 @@
+#include "RequestQueue.h"
+#include "HTTPS.h"
+
+#include <algorithm>
+#include <exception>
+
+RequestQueue::Task::Task(const HTTPSClient::Request &req)
+: request(req)
+, failed(false)
+, complete(false)
+, cancelled(false)
+{
+	reply.responseCode = 0;
+}
+
+RequestQueue::RequestQueue()
+: maxConcurrent(4)
+, active(0)
+, quit(false)
+{
+}
+
+RequestQueue::~RequestQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+		pending.clear();
+	}
+	workCond.notify_all();
+
+	// Requests that are already running still finish.
+	for (auto &worker : workers)
+		worker.join();
+}
+
+std::shared_ptr<RequestQueue::Task> RequestQueue::push(const HTTPSClient::Request &req)
+{
+	std::shared_ptr<Task> task(new Task(req));
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(task);
+
+		startWorkers();
+	}
+
+	workCond.notify_one();
+	return task;
+}
+
+void RequestQueue::wait(const std::shared_ptr<Task> &task)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	completeCond.wait(lock, [&]() { return task->complete.load(); });
+}
+
+bool RequestQueue::cancel(const std::shared_ptr<Task> &task)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = std::find(pending.begin(), pending.end(), task);
+	if (it == pending.end())
+		return false;
+
+	pending.erase(it);
+	task->error = "Request cancelled";
+	task->failed = true;
+	task->cancelled = true;
+	task->complete = true;
+	completeCond.notify_all();
+	return true;
+}
+
+void RequestQueue::setMaxConcurrent(int count)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		maxConcurrent = std::max(count, 1);
+
+		// Raising the limit should pick up waiting requests right away.
+		startWorkers();
+	}
+
+	workCond.notify_all();
+}
+
+int RequestQueue::getMaxConcurrent()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return maxConcurrent;
+}
+
+void RequestQueue::startWorkers()
+{
+	// Enough workers for every pending request, within the limit.
+	while ((int) workers.size() < std::min(maxConcurrent, active + (int) pending.size()))
+		workers.push_back(std::thread(&RequestQueue::work, this));
+}
+
+void RequestQueue::work()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+		// Lowering the limit leaves extra workers idle rather than stopping
+		// requests that are in flight.
+		workCond.wait(lock, [&]() { return quit || (!pending.empty() && active < maxConcurrent); });
+
+		if (quit)
+			return;
+
+		std::shared_ptr<Task> task = pending.front();
+		pending.pop_front();
+		active++;
+
+		lock.unlock();
+
+		try
+		{
+			task->reply = request(task->request);
+		}
+		catch (const std::exception &e)
+		{
+			task->error = e.what();
+			task->failed = true;
+		}
+
+		lock.lock();
+
+		active--;
+		task->complete = true;
+		completeCond.notify_all();
+	}
+}
+
+RequestQueue &RequestQueue::get()
+{
+	static RequestQueue queue;
+	return queue;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HTTPSClient.h"
+
+// Runs requests on a pool of worker threads, so Lua doesn't have to wait for
+// them. At most getMaxConcurrent() requests are in flight at once, the rest
+// wait in the order they were queued.
+class RequestQueue
+{
+public:
+	struct Task
+	{
+		Task(const HTTPSClient::Request &req);
+
+		HTTPSClient::Request request;
+		HTTPSClient::Reply reply;
+		std::string error;
+		bool failed;
+
+		// Set once reply or error is ready, and never changed after.
+		std::atomic<bool> complete;
+		std::atomic<bool> cancelled;
+	};
+
+	RequestQueue();
+	~RequestQueue();
+
+	std::shared_ptr<Task> push(const HTTPSClient::Request &req);
+
+	// Blocks until the task is complete.
+	void wait(const std::shared_ptr<Task> &task);
+
+	// Removes the task if it hasn't started yet, and returns whether it was.
+	bool cancel(const std::shared_ptr<Task> &task);
+
+	void setMaxConcurrent(int count);
+	int getMaxConcurrent();
+
+	static RequestQueue &get();
+
+private:
+	// Must be called with the mutex locked.
+	void startWorkers();
+	void work();
+
+	std::mutex mutex;
+	std::condition_variable workCond;
+	std::condition_variable completeCond;
+	std::deque<std::shared_ptr<Task>> pending;
+
+	// Started as needed, and kept around idle so later requests don't pay for
+	// a new thread.
+	std::vector<std::thread> workers;
+
+	int maxConcurrent;
+	int active;
+	bool quit;
+};
@@ -19,6 +19,7 @@ CurlClient::Curl::Curl()
 , global_cleanup(nullptr)
 , easy_init(nullptr)
 , easy_cleanup(nullptr)
+, easy_reset(nullptr)
 , easy_setopt(nullptr)
 , easy_perform(nullptr)
 , easy_getinfo(nullptr)
@@ -45,6 +46,8 @@ CurlClient::Curl::Curl()
 		return;
 	if (!LoadSymbol(easy_cleanup, handle, "curl_easy_cleanup"))
 		return;
+	if (!LoadSymbol(easy_reset, handle, "curl_easy_reset"))
+		return;
 	if (!LoadSymbol(easy_setopt, handle, "curl_easy_setopt"))
 		return;
 	if (!LoadSymbol(easy_perform, handle, "curl_easy_perform"))
@@ -116,6 +119,33 @@ bool CurlClient::valid() const
 	return curl.loaded;
 }
 
+CURL *CurlClient::acquireHandle()
+{
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		if (!pool.empty())
+		{
+			CURL *handle = pool.back();
+			pool.pop_back();
+			return handle;
+		}
+	}
+
+	return curl.easy_init();
+}
+
+void CurlClient::releaseHandle(CURL *handle)
+{
+	// Reset clears the options of the last request but keeps the connections.
+	curl.easy_reset(handle);
+
+	std::lock_guard<std::mutex> lock(poolMutex);
+	if (pool.size() < MAX_POOLED_HANDLES)
+		pool.push_back(handle);
+	else
+		curl.easy_cleanup(handle);
+}
+
 HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 {
 	Reply reply;
@@ -124,13 +154,19 @@ HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 	// Use sensible default header for later
 	HTTPSClient::header_map newHeaders = req.headers;
 
-	CURL *handle = curl.easy_init();
+	CURL *handle = acquireHandle();
 	if (!handle)
 		throw std::runtime_error("Could not create curl request");
 
 	curl.easy_setopt(handle, CURLOPT_URL, req.url.c_str());
 	curl.easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
 	curl.easy_setopt(handle, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+	curl.easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+#ifdef CURL_HTTP_VERSION_2TLS
+	// Negotiated with ALPN, servers without HTTP/2 get HTTP/1.1. Older curl
+	// versions reject the option and keep their default.
+	curl.easy_setopt(handle, CURLOPT_HTTP_VERSION, (long) CURL_HTTP_VERSION_2TLS);
+#endif
 
 	StringReader reader {};
 
@@ -184,7 +220,7 @@ HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 
 	reply.body = body.str();
 
-	curl.easy_cleanup(handle);
+	releaseHandle(handle);
 	return reply;
 }
 
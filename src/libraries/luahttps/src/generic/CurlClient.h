@@ -6,6 +6,9 @@
 
 #include <curl/curl.h>
 
+#include <mutex>
+#include <vector>
+
 #include "../common/HTTPSClient.h"
 #include "../common/LibraryLoader.h"
 
@@ -16,6 +19,18 @@ public:
 	virtual HTTPSClient::Reply request(const HTTPSClient::Request &req) override;
 
 private:
+	// Finished handles are kept for later requests, which lets curl reuse
+	// their open connections instead of connecting (and handshaking) again.
+	// They're left for process exit to clean up, since the library may
+	// already be unloaded by the time the client is destroyed.
+	static const size_t MAX_POOLED_HANDLES = 8;
+
+	CURL *acquireHandle();
+	void releaseHandle(CURL *handle);
+
+	std::mutex poolMutex;
+	std::vector<CURL *> pool;
+
 	static struct Curl
 	{
 		Curl();
@@ -27,6 +42,7 @@ private:
 
 		decltype(&curl_easy_init) easy_init;
 		decltype(&curl_easy_cleanup) easy_cleanup;
+		decltype(&curl_easy_reset) easy_reset;
 		decltype(&curl_easy_setopt) easy_setopt;
 		decltype(&curl_easy_perform) easy_perform;
 		decltype(&curl_easy_getinfo) easy_getinfo;
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <new>
 #include <set>
 
 extern "C"
@@ -8,8 +9,11 @@ extern "C"
 }
 
 #include "../common/HTTPS.h"
+#include "../common/RequestQueue.h"
 #include "../common/config.h"
 
+#define REQUEST_METATABLE "https.Request"
+
 static std::string validMethod[] = {"GET", "HEAD", "POST", "PUT", "DELETE", "PATCH"};
 
 static int str_toupper(char c)
@@ -61,11 +65,8 @@ static std::string w_optmethod(lua_State *L, int idx, const std::string &default
 	return str;
 }
 
-static int w_request(lua_State *L)
+static bool w_readrequest(lua_State *L, HTTPSClient::Request &req)
 {
-	auto url = w_checkstring(L, 1);
-	HTTPSClient::Request req(url);
-
 	bool advanced = false;
 
 	if (lua_istable(L, 2))
@@ -93,6 +94,35 @@ static int w_request(lua_State *L)
 		lua_pop(L, 1);
 	}
 
+	return advanced;
+}
+
+static int w_pushreply(lua_State *L, const HTTPSClient::Reply &reply, bool advanced)
+{
+	lua_pushinteger(L, reply.responseCode);
+	w_pushstring(L, reply.body);
+
+	if (advanced)
+	{
+		lua_newtable(L);
+		for (const auto &header : reply.headers)
+		{
+			w_pushstring(L, header.first);
+			w_pushstring(L, header.second);
+			lua_settable(L, -3);
+		}
+	}
+
+	return advanced ? 3 : 2;
+}
+
+static int w_request(lua_State *L)
+{
+	auto url = w_checkstring(L, 1);
+	HTTPSClient::Request req(url);
+
+	bool advanced = w_readrequest(L, req);
+
 	HTTPSClient::Reply reply;
 
 	try
@@ -107,29 +137,135 @@ static int w_request(lua_State *L)
 		return 2;
 	}
 
-	lua_pushinteger(L, reply.responseCode);
-	w_pushstring(L, reply.body);
+	return w_pushreply(L, reply, advanced);
+}
 
-	if (advanced)
+// Requests made with requestAsync are userdata holding a reference to their
+// task, which the worker running it may outlive or be outlived by.
+struct AsyncRequest
+{
+	std::shared_ptr<RequestQueue::Task> task;
+	bool advanced;
+};
+
+static AsyncRequest *w_checkasyncrequest(lua_State *L, int idx)
+{
+	return (AsyncRequest *) luaL_checkudata(L, idx, REQUEST_METATABLE);
+}
+
+static int w_requestAsync(lua_State *L)
+{
+	auto url = w_checkstring(L, 1);
+	HTTPSClient::Request req(url);
+
+	bool advanced = w_readrequest(L, req);
+
+	AsyncRequest *r = (AsyncRequest *) lua_newuserdata(L, sizeof(AsyncRequest));
+	new (r) AsyncRequest();
+	r->advanced = advanced;
+	luaL_getmetatable(L, REQUEST_METATABLE);
+	lua_setmetatable(L, -2);
+
+	r->task = RequestQueue::get().push(req);
+	return 1;
+}
+
+static int w_Request_gc(lua_State *L)
+{
+	AsyncRequest *r = w_checkasyncrequest(L, 1);
+	r->~AsyncRequest();
+	return 0;
+}
+
+static int w_Request_isComplete(lua_State *L)
+{
+	AsyncRequest *r = w_checkasyncrequest(L, 1);
+	lua_pushboolean(L, r->task->complete.load());
+	return 1;
+}
+
+// Returns the same values as https.request, or nothing if the request is
+// still running.
+static int w_Request_getResult(lua_State *L)
+{
+	AsyncRequest *r = w_checkasyncrequest(L, 1);
+	const RequestQueue::Task &task = *r->task;
+
+	if (!task.complete.load())
+		return 0;
+
+	if (task.failed)
 	{
-		lua_newtable(L);
-		for (const auto &header : reply.headers)
-		{
-			w_pushstring(L, header.first);
-			w_pushstring(L, header.second);
-			lua_settable(L, -3);
-		}
+		lua_pushnil(L);
+		w_pushstring(L, task.error);
+		return 2;
 	}
 
-	return advanced ? 3 : 2;
+	return w_pushreply(L, task.reply, r->advanced);
+}
+
+static int w_Request_wait(lua_State *L)
+{
+	AsyncRequest *r = w_checkasyncrequest(L, 1);
+	RequestQueue::get().wait(r->task);
+	return w_Request_getResult(L);
+}
+
+static int w_Request_cancel(lua_State *L)
+{
+	AsyncRequest *r = w_checkasyncrequest(L, 1);
+	lua_pushboolean(L, RequestQueue::get().cancel(r->task));
+	return 1;
+}
+
+static int w_setMaxConcurrentRequests(lua_State *L)
+{
+	int count = (int) luaL_checkinteger(L, 1);
+	if (count < 1)
+		return luaL_argerror(L, 1, "expected at least 1");
+	RequestQueue::get().setMaxConcurrent(count);
+	return 0;
+}
+
+static int w_getMaxConcurrentRequests(lua_State *L)
+{
+	lua_pushinteger(L, RequestQueue::get().getMaxConcurrent());
+	return 1;
 }
 
 extern "C" int HTTPS_DLLEXPORT luaopen_https(lua_State *L)
 {
+	if (luaL_newmetatable(L, REQUEST_METATABLE))
+	{
+		lua_pushcfunction(L, w_Request_gc);
+		lua_setfield(L, -2, "__gc");
+
+		lua_newtable(L);
+		lua_pushcfunction(L, w_Request_isComplete);
+		lua_setfield(L, -2, "isComplete");
+		lua_pushcfunction(L, w_Request_getResult);
+		lua_setfield(L, -2, "getResult");
+		lua_pushcfunction(L, w_Request_wait);
+		lua_setfield(L, -2, "wait");
+		lua_pushcfunction(L, w_Request_cancel);
+		lua_setfield(L, -2, "cancel");
+		lua_setfield(L, -2, "__index");
+	}
+	lua_pop(L, 1);
+
 	lua_newtable(L);
 
 	lua_pushcfunction(L, w_request);
 	lua_setfield(L, -2, "request");
 
+	lua_pushcfunction(L, w_requestAsync);
+	lua_setfield(L, -2, "requestAsync");
+
+	lua_pushcfunction(L, w_setMaxConcurrentRequests);
+	lua_setfield(L, -2, "setMaxConcurrentRequests");
+
+	lua_pushcfunction(L, w_getMaxConcurrentRequests);
+	lua_setfield(L, -2, "getMaxConcurrentRequests");
+
 	return 1;
 }
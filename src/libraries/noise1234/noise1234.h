@@ -45,6 +45,10 @@ class Noise1234 {
     static double pnoise( double x, double y, double z, double w,
                               int px, int py, int pz, int pw );
 
+/** The 512 entry permutation table used by the functions above.
+ */
+    static const unsigned char *getPermutation() { return perm; }
+
   private:
     static unsigned char perm[];
     static double  grad( int hash, double x );
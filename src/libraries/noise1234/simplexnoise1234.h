@@ -39,6 +39,10 @@ class SimplexNoise1234 {
     static double noise( double x, double y, double z );
     static double noise( double x, double y, double z, double w);
 
+/** The 512 entry permutation table used by the functions above.
+ */
+    static const unsigned char *getPermutation() { return perm; }
+
   private:
     static unsigned char perm[];
     static double  grad( int hash, double x );
@@ -23,9 +23,11 @@
 
 // STL
 #include <vector>
+#include <string>
 
 // LOVE
 #include "common/Module.h"
+#include "common/int.h"
 #include "common/StringMap.h"
 #include "Source.h"
 #include "Effect.h"
@@ -102,8 +104,56 @@ public:
 	virtual ~Audio() {}
 
 	virtual Source *newSource(love::sound::Decoder *decoder) = 0;
+
+	/**
+	 * Creates a Source which streams from a Decoder reading encoded audio held
+	 * in memory. Clones decode on their own, sharing the encoded data.
+	 **/
+	virtual Source *newCompressedSource(love::sound::Decoder *decoder) = 0;
+
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
-	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
+
+	/**
+	 * Creates a queueable Source.
+	 * @param ringSamples If greater than 0, queued audio goes through a
+	 * lock-free ring buffer of this many sample frames instead of OpenAL
+	 * buffers. It can then be queued from another thread without contention,
+	 * and plays with roughly the ring's length of latency.
+	 **/
+	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers, int ringSamples) = 0;
+
+	/**
+	 * Creates a static Source which shares its decoded audio with every other
+	 * Source created using the same cache key.
+	 * @param soundData The decoded audio to cache if the key isn't cached yet.
+	 * @param cacheKey Identifies the audio file the SoundData was decoded from.
+	 **/
+	virtual Source *newSource(love::sound::SoundData *soundData, const std::string &cacheKey) = 0;
+
+	/**
+	 * Creates a static Source from previously cached decoded audio.
+	 * @param cacheKey The key the audio was cached with.
+	 * @return A new Source, or nullptr if nothing is cached with the key.
+	 **/
+	virtual Source *newCachedSource(const std::string &cacheKey) = 0;
+
+	/**
+	 * Sets the maximum amount of decoded audio memory (in bytes) the sound
+	 * cache may hold before least recently used entries are evicted.
+	 **/
+	virtual void setSoundCacheLimit(int64 bytes) = 0;
+	virtual int64 getSoundCacheLimit() const = 0;
+
+	/**
+	 * Gets the amount of decoded audio memory (in bytes) in the sound cache.
+	 **/
+	virtual int64 getSoundCacheSize() const = 0;
+
+	/**
+	 * Removes every entry from the sound cache. Existing Sources keep their
+	 * audio data.
+	 **/
+	virtual void clearSoundCache() = 0;
 
 	/**
 	 * Gets the current number of simultaneous playing sources.
@@ -163,6 +213,27 @@ public:
 	 **/
 	virtual std::vector<Source*> pause() = 0;
 
+	/**
+	 * Sets the positions (and optionally velocities) of many Sources at once.
+	 * @param sources The mono Sources to update.
+	 * @param data components floats per Source: [x,y,z] for its position,
+	 * followed by [x,y,z] for its velocity if components is 6.
+	 * @param components Either 3 or 6.
+	 **/
+	virtual void setSourceTransforms(const std::vector<Source*> &sources, const float *data, int components) = 0;
+
+	/**
+	 * Plays the SoundData once on an internal voice, without creating a
+	 * Source for it. Voices and their decoded buffers are reused between
+	 * calls with the same SoundData.
+	 * @param volume The volume of the voice.
+	 * @param pitch The pitch of the voice.
+	 * @param position The position of the voice, or null to play it at the
+	 * listener's position.
+	 * @return True if the voice started playing.
+	 **/
+	virtual bool playOneShot(love::sound::SoundData *soundData, float volume, float pitch, const float *position) = 0;
+
 	/**
 	 * Sets the master volume, where 0.0f is min (off) and 1.0f is max.
 	 * @param volume The new master volume.
@@ -257,6 +328,24 @@ public:
 	 */
 	virtual bool getEffect(const char *name, std::map<Effect::Parameter, float> &params) = 0;
 
+	/**
+	 * Routes the output of a scene EFX effect into another scene effect
+	 * instead of the main output, so effects can be chained into submix buses
+	 * which are only processed once for every Source sent to them.
+	 * @param name Effect name to route.
+	 * @param target Effect name to route into, or null for the main output.
+	 * @return true if successful, false otherwise.
+	 */
+	virtual bool setEffectTarget(const char *name, const char *target) = 0;
+
+	/**
+	 * Gets the scene EFX effect another one is routed into.
+	 * @param name Effect name to get the target of.
+	 * @param target Name of the effect it's routed into.
+	 * @return true if the effect is routed into another effect.
+	 */
+	virtual bool getEffectTarget(const char *name, std::string &target) const = 0;
+
 	/**
 	 * Gets list of EFX effect names.
 	 * @param list List of EFX names to fill.
@@ -282,6 +371,13 @@ public:
 	 */
 	virtual bool isEFXsupported() const = 0;
 
+	/**
+	 * Gets the sample rate the output device mixes at. Audio already at this
+	 * rate doesn't need to be resampled while it's mixed.
+	 * @return The sample rate, or 0 if it can't be determined.
+	 */
+	virtual int getOutputSampleRate() const = 0;
+
 	virtual bool setOutputSpatialization(bool enable, const char *filter = nullptr) = 0;
 	virtual bool getOutputSpatialization(const char *&filter) const = 0;
 	virtual void getOutputSpatializationFilters(std::vector<std::string> &list) const = 0;
@@ -28,6 +28,11 @@
 
 namespace love
 {
+namespace thread
+{
+class Channel;
+}
+
 namespace audio
 {
 
@@ -41,6 +46,7 @@ public:
 	static const int DEFAULT_SAMPLE_RATE = 8000;
 	static const int DEFAULT_BIT_DEPTH = 16;
 	static const int DEFAULT_CHANNELS = 1;
+	static const int DEFAULT_BLOCK_SAMPLES = 1024;
 
 	RecordingDevice();
 	virtual ~RecordingDevice();
@@ -66,6 +72,26 @@ public:
 	 **/
 	virtual love::sound::SoundData *getData() = 0;
 
+	/**
+	 * Delivers recorded data to a Channel in fixed size blocks, as soon as
+	 * each block has been captured, instead of requiring getData to be polled.
+	 * The SoundData blocks are reused once nothing else references them.
+	 * getData returns nothing while a Channel is set.
+	 * @param channel The Channel to push blocks to, or null to stop delivery.
+	 * @param blockSamples Number of sample frames in each delivered block.
+	 **/
+	virtual void setChannel(love::thread::Channel *channel, int blockSamples) = 0;
+
+	/**
+	 * @return The Channel recorded blocks are delivered to, or null.
+	 **/
+	virtual love::thread::Channel *getChannel() const = 0;
+
+	/**
+	 * @return Number of sample frames in each block delivered to the Channel.
+	 **/
+	virtual int getBlockSampleCount() const = 0;
+
 	/**
 	 * @return C string device name.
 	 **/ 
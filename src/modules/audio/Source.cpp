@@ -29,6 +29,7 @@ love::Type Source::type("Source", &Object::type);
 
 Source::Source(Type sourceType)
 	: sourceType(sourceType)
+	, compressed(false)
 {
 }
 
@@ -38,7 +39,7 @@ Source::~Source()
 
 Source::Type Source::getType() const
 {
-	return sourceType;
+	return compressed ? TYPE_COMPRESSED : sourceType;
 }
 
 bool Source::getConstant(const char *in, Type &out)
@@ -76,6 +77,7 @@ StringMap<Source::Type, Source::TYPE_MAX_ENUM>::Entry Source::typeEntries[] =
 	{"static", Source::TYPE_STATIC},
 	{"stream", Source::TYPE_STREAM},
 	{"queue",  Source::TYPE_QUEUE},
+	{"compressed", Source::TYPE_COMPRESSED},
 };
 
 StringMap<Source::Type, Source::TYPE_MAX_ENUM> Source::types(Source::typeEntries, sizeof(Source::typeEntries));
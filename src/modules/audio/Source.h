@@ -44,6 +44,7 @@ public:
 		TYPE_STATIC,
 		TYPE_STREAM,
 		TYPE_QUEUE,
+		TYPE_COMPRESSED,
 		TYPE_MAX_ENUM
 	};
 
@@ -122,6 +123,19 @@ public:
 	virtual int getFreeBufferCount() const = 0;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels) = 0;
 
+	/**
+	 * When there are more playing Sources than the system can mix, the ones
+	 * with the lowest priority (and then the quietest) keep playing without
+	 * being heard until a mixing voice is free.
+	 **/
+	virtual void setPriority(int priority) = 0;
+	virtual int getPriority() const = 0;
+
+	/**
+	 * Whether the Source is playing without being mixed.
+	 **/
+	virtual bool isVirtual() const = 0;
+
 	virtual Type getType() const;
 
 	static bool getConstant(const char *in, Type &out);
@@ -135,6 +149,10 @@ protected:
 
 	Type sourceType;
 
+	// Streaming Sources which decode encoded audio held in memory, instead of
+	// reading from a file as they play. Their type is TYPE_COMPRESSED.
+	bool compressed;
+
 private:
 
 	static StringMap<Type, TYPE_MAX_ENUM>::Entry typeEntries[];
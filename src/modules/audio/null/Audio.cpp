@@ -42,16 +42,49 @@ love::audio::Source *Audio::newSource(love::sound::Decoder *)
 	return new Source();
 }
 
+love::audio::Source *Audio::newCompressedSource(love::sound::Decoder *)
+{
+	return new Source();
+}
+
 love::audio::Source *Audio::newSource(love::sound::SoundData *)
 {
 	return new Source();
 }
 
-love::audio::Source *Audio::newSource(int, int, int, int)
+love::audio::Source *Audio::newSource(int, int, int, int, int)
 {
 	return new Source();
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *, const std::string &)
+{
+	return new Source();
+}
+
+love::audio::Source *Audio::newCachedSource(const std::string &)
+{
+	return nullptr;
+}
+
+void Audio::setSoundCacheLimit(int64)
+{
+}
+
+int64 Audio::getSoundCacheLimit() const
+{
+	return 0;
+}
+
+int64 Audio::getSoundCacheSize() const
+{
+	return 0;
+}
+
+void Audio::clearSoundCache()
+{
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return 0;
@@ -97,6 +130,15 @@ std::vector<love::audio::Source*> Audio::pause()
 	return {};
 }
 
+void Audio::setSourceTransforms(const std::vector<love::audio::Source*>&, const float*, int)
+{
+}
+
+bool Audio::playOneShot(love::sound::SoundData*, float, float, const float*)
+{
+	return false;
+}
+
 void Audio::setVolume(float volume)
 {
 	this->volume = volume;
@@ -179,6 +221,16 @@ bool Audio::getEffect(const char *, std::map<Effect::Parameter, float> &)
 	return false;
 }
 
+bool Audio::setEffectTarget(const char *, const char *)
+{
+	return false;
+}
+
+bool Audio::getEffectTarget(const char *, std::string &) const
+{
+	return false;
+}
+
 bool Audio::getActiveEffects(std::vector<std::string> &) const
 {
 	return false;
@@ -199,6 +251,11 @@ bool Audio::isEFXsupported() const
 	return false;
 }
 
+int Audio::getOutputSampleRate() const
+{
+	return 0;
+}
+
 bool Audio::setOutputSpatialization(bool, const char *)
 {
 	return false;
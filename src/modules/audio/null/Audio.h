@@ -43,8 +43,15 @@ public:
 
 	// Implements Audio.
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
+	love::audio::Source *newCompressedSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
-	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers, int ringSamples);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const std::string &cacheKey);
+	love::audio::Source *newCachedSource(const std::string &cacheKey);
+	void setSoundCacheLimit(int64 bytes);
+	int64 getSoundCacheLimit() const;
+	int64 getSoundCacheSize() const;
+	void clearSoundCache();
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -55,6 +62,8 @@ public:
 	void pause(love::audio::Source *source);
 	void pause(const std::vector<love::audio::Source*> &sources);
 	std::vector<love::audio::Source*> pause();
+	void setSourceTransforms(const std::vector<love::audio::Source*> &sources, const float *data, int components);
+	bool playOneShot(love::sound::SoundData *soundData, float volume, float pitch, const float *position);
 	void setVolume(float volume);
 	float getVolume() const;
 
@@ -78,10 +87,13 @@ public:
 	bool setEffect(const char *, std::map<Effect::Parameter, float> &params);
 	bool unsetEffect(const char *);
 	bool getEffect(const char *, std::map<Effect::Parameter, float> &params);
+	bool setEffectTarget(const char *, const char *);
+	bool getEffectTarget(const char *, std::string &) const;
 	bool getActiveEffects(std::vector<std::string> &list) const;
 	int getMaxSceneEffects() const;
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
+	int getOutputSampleRate() const;
 
 	bool setOutputSpatialization(bool enable, const char *filter = nullptr) override;
 	bool getOutputSpatialization(const char *&filter) const override;
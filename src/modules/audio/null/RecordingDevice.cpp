@@ -52,6 +52,20 @@ love::sound::SoundData *RecordingDevice::getData()
 	return nullptr;
 }
 
+void RecordingDevice::setChannel(love::thread::Channel *, int)
+{
+}
+
+love::thread::Channel *RecordingDevice::getChannel() const
+{
+	return nullptr;
+}
+
+int RecordingDevice::getBlockSampleCount() const
+{
+	return 0;
+}
+
 int RecordingDevice::getSampleCount() const
 {
 	return 0;
@@ -39,6 +39,9 @@ public:
 	virtual bool start(int samples, int sampleRate, int bitDepth, int channels);
 	virtual void stop();
 	virtual love::sound::SoundData *getData();
+	virtual void setChannel(love::thread::Channel *channel, int blockSamples);
+	virtual love::thread::Channel *getChannel() const;
+	virtual int getBlockSampleCount() const;
 	virtual const char *getName() const;
 	virtual int getMaxSamples() const;
 	virtual int getSampleCount() const;
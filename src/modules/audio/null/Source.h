@@ -85,6 +85,9 @@ public:
 
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+	virtual bool isVirtual() const;
 
 	virtual bool setFilter(const std::map<Filter::Parameter, float> &params);
 	virtual bool setFilter();
@@ -106,6 +109,7 @@ private:
 	float coneOuterHighGain = 1.0f;
 	bool relative = false;
 	bool looping = false;
+	int priority = 0;
 	float minVolume = 0.0f;
 	float maxVolume = 1.0f;
 	float referenceDistance = 1.0f;
@@ -19,10 +19,10 @@
  **/
 
 #include "Audio.h"
-#include "common/delay.h"
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -61,15 +61,21 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		// Sleep until a streaming buffer is about to run out, or until a
+		// source is played, seeked or has data queued.
+		double next = pool->update();
+		pool->waitForUpdate(next);
 	}
 }
 
 void Audio::PoolThread::setFinish()
 {
-	thread::Lock lock(mutex);
-	finish = true;
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+
+	pool->wake();
 }
 
 ALenum Audio::getFormat(int bitDepth, int channels)
@@ -147,9 +153,22 @@ Audio::Audio()
 			throw love::Exception("Could not make context current: %s", alcGetString(device, alcGetError(device)));
 	}
 
+	if (alIsExtensionPresent("AL_SOFT_callback_buffer"))
+		alBufferCallbackSOFT = (LPALBUFFERCALLBACKSOFT) alGetProcAddress("alBufferCallbackSOFT");
+
+	if (alIsExtensionPresent("AL_SOFT_deferred_updates"))
+	{
+		alDeferUpdatesSOFT = (LPALDEFERUPDATESSOFT) alGetProcAddress("alDeferUpdatesSOFT");
+		alProcessUpdatesSOFT = (LPALPROCESSUPDATESSOFT) alGetProcAddress("alProcessUpdatesSOFT");
+		if (alDeferUpdatesSOFT == nullptr || alProcessUpdatesSOFT == nullptr)
+			alDeferUpdatesSOFT = alProcessUpdatesSOFT = nullptr;
+	}
+
 #ifdef ALC_EXT_EFX
 	initializeEFX();
 
+	hasEffectTargetExtension = alIsExtensionPresent("AL_SOFT_effect_target") == AL_TRUE;
+
 	alcGetIntegerv(device, ALC_MAX_AUXILIARY_SENDS, 1, &MAX_SOURCE_EFFECTS);
 
 	alGetError();
@@ -226,6 +245,10 @@ Audio::~Audio()
 	poolThread->setFinish();
 	poolThread->wait();
 
+	// Cached buffers must be deleted while the context still exists.
+	soundCache.clear();
+	oneShotVoices.clear();
+
 	delete poolThread;
 	delete pool;
 
@@ -296,14 +319,120 @@ love::audio::Source *Audio::newSource(love::sound::Decoder *decoder)
 	return new Source(pool, decoder);
 }
 
+love::audio::Source *Audio::newCompressedSource(love::sound::Decoder *decoder)
+{
+	return new Source(pool, decoder, true);
+}
+
 love::audio::Source *Audio::newSource(love::sound::SoundData *soundData)
 {
 	return new Source(pool, soundData);
 }
 
-love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels, int buffers)
+love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels, int buffers, int ringSamples)
+{
+	return new Source(pool, sampleRate, bitDepth, channels, buffers, ringSamples);
+}
+
+love::audio::Source *Audio::newSource(love::sound::SoundData *soundData, const std::string &cacheKey)
+{
+	thread::Lock lock(soundCacheMutex);
+
+	auto it = soundCache.find(cacheKey);
+	if (it != soundCache.end())
+	{
+		SoundCacheEntry &entry = it->second;
+		entry.lastUse = ++soundCacheCounter;
+		return new Source(pool, entry.buffer, entry.sampleRate, entry.bitDepth, entry.channels);
+	}
+
+	Source *source = new Source(pool, soundData);
+
+	int64 size = (int64) soundData->getSize();
+
+	// Audio bigger than the whole cache would just evict everything else.
+	if (size <= soundCacheLimit)
+	{
+		trimSoundCache(soundCacheLimit - size);
+
+		SoundCacheEntry entry;
+		entry.buffer.set(source->getStaticBuffer());
+		entry.sampleRate = soundData->getSampleRate();
+		entry.bitDepth = soundData->getBitDepth();
+		entry.channels = soundData->getChannelCount();
+		entry.lastUse = ++soundCacheCounter;
+
+		soundCache[cacheKey] = entry;
+		soundCacheSize += size;
+	}
+
+	return source;
+}
+
+love::audio::Source *Audio::newCachedSource(const std::string &cacheKey)
+{
+	thread::Lock lock(soundCacheMutex);
+
+	auto it = soundCache.find(cacheKey);
+	if (it == soundCache.end())
+		return nullptr;
+
+	SoundCacheEntry &entry = it->second;
+	entry.lastUse = ++soundCacheCounter;
+	return new Source(pool, entry.buffer, entry.sampleRate, entry.bitDepth, entry.channels);
+}
+
+void Audio::setSoundCacheLimit(int64 bytes)
+{
+	thread::Lock lock(soundCacheMutex);
+	soundCacheLimit = std::max(bytes, (int64) 0);
+	trimSoundCache(soundCacheLimit);
+}
+
+int64 Audio::getSoundCacheLimit() const
+{
+	return soundCacheLimit;
+}
+
+int64 Audio::getSoundCacheSize() const
+{
+	thread::Lock lock(soundCacheMutex);
+	return soundCacheSize;
+}
+
+void Audio::clearSoundCache()
+{
+	thread::Lock lock(soundCacheMutex);
+	soundCache.clear();
+	soundCacheSize = 0;
+}
+
+void Audio::trimSoundCache(int64 limit)
+{
+	// Dropping an entry only releases the cache's reference, Sources which
+	// still use the buffer keep it alive.
+	while (soundCacheSize > limit && !soundCache.empty())
+	{
+		auto oldest = soundCache.begin();
+		for (auto it = soundCache.begin(); it != soundCache.end(); ++it)
+		{
+			if (it->second.lastUse < oldest->second.lastUse)
+				oldest = it;
+		}
+
+		soundCacheSize -= oldest->second.buffer->getSize();
+		soundCache.erase(oldest);
+	}
+}
+
+bool Audio::setBufferCallback(ALuint buffer, ALenum format, ALsizei freq, ALBUFFERCALLBACKTYPESOFT callback, void *userptr)
 {
-	return new Source(pool, sampleRate, bitDepth, channels, buffers);
+	if (alBufferCallbackSOFT == nullptr)
+		return false;
+
+	alGetError();
+	alBufferCallbackSOFT(buffer, format, freq, callback, userptr);
+	return alGetError() == AL_NO_ERROR;
 }
 
 int Audio::getActiveSourceCount() const
@@ -351,11 +480,102 @@ void Audio::pause(const std::vector<love::audio::Source*> &sources)
 	return Source::pause(sources);
 }
 
+void Audio::setSourceTransforms(const std::vector<love::audio::Source*> &sources, const float *data, int components)
+{
+	if (sources.empty())
+		return;
+
+	// The mixer picks up every change at once instead of one property at a
+	// time, which also keeps moving sources in sync with each other.
+	if (alDeferUpdatesSOFT != nullptr)
+		alDeferUpdatesSOFT();
+
+	try
+	{
+		Source::setTransforms(sources, data, components);
+	}
+	catch (love::Exception &)
+	{
+		if (alProcessUpdatesSOFT != nullptr)
+			alProcessUpdatesSOFT();
+		throw;
+	}
+
+	if (alProcessUpdatesSOFT != nullptr)
+		alProcessUpdatesSOFT();
+}
+
 std::vector<love::audio::Source*> Audio::pause()
 {
 	return Source::pause(pool);
 }
 
+bool Audio::playOneShot(love::sound::SoundData *soundData, float volume, float pitch, const float *position)
+{
+	thread::Lock lock(oneShotMutex);
+
+	Source *source = nullptr;
+	StaticDataBuffer *buffer = nullptr;
+
+	for (const OneShotVoice &voice : oneShotVoices)
+	{
+		if (voice.soundData.get() != soundData)
+			continue;
+
+		buffer = voice.source->getStaticBuffer();
+
+		if (voice.source->getReferenceCount() == 1)
+		{
+			source = voice.source.get();
+			break;
+		}
+	}
+
+	StrongRef<Source> newsource;
+
+	if (source == nullptr)
+	{
+		// Share the decoded audio with the other voices playing this sound.
+		if (buffer != nullptr)
+			newsource.set(new Source(pool, buffer, soundData->getSampleRate(), soundData->getBitDepth(), soundData->getChannelCount()), Acquire::NORETAIN);
+		else
+			newsource.set(new Source(pool, soundData), Acquire::NORETAIN);
+
+		source = newsource.get();
+
+		if ((int) oneShotVoices.size() >= MAX_ONESHOT_VOICES)
+		{
+			auto newend = std::remove_if(oneShotVoices.begin(), oneShotVoices.end(), [](const OneShotVoice &voice) {
+				return voice.source->getReferenceCount() == 1;
+			});
+			oneShotVoices.erase(newend, oneShotVoices.end());
+		}
+
+		// If every voice is busy the new one isn't kept, the Pool releases it
+		// once it's done playing.
+		if ((int) oneShotVoices.size() < MAX_ONESHOT_VOICES)
+			oneShotVoices.push_back({soundData, newsource});
+	}
+
+	source->setVolume(volume);
+	source->setPitch(pitch);
+
+	if (position != nullptr)
+	{
+		// Throws for sounds with more than one channel.
+		source->setPosition((float *) position);
+		source->setRelative(false);
+	}
+	else if (source->getChannelCount() == 1)
+	{
+		float zero[3] = {0.0f, 0.0f, 0.0f};
+		source->setPosition(zero);
+		source->setRelative(true);
+	}
+
+	return source->play();
+}
+
 void Audio::pauseContext()
 {
 #ifdef LOVE_ANDROID
@@ -692,7 +912,19 @@ bool Audio::unsetEffect(const char *name)
 
 #ifdef ALC_EXT_EFX
 	if (alAuxiliaryEffectSloti)
+	{
+		// The slot gets reused, so nothing can stay routed into or out of it.
+		for (auto &e : effectmap)
+		{
+			if (e.second.target == iter->first || (&e.second == &iter->second && !e.second.target.empty()))
+			{
+				alAuxiliaryEffectSloti(e.second.slot, AL_EFFECTSLOT_TARGET_SOFT, AL_EFFECTSLOT_NULL);
+				e.second.target.clear();
+			}
+		}
+
 		alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, AL_EFFECT_NULL);
+	}
 #endif
 
 	delete effect;
@@ -712,6 +944,60 @@ bool Audio::getEffect(const char *name, std::map<Effect::Parameter, float> &para
 	return true;
 }
 
+bool Audio::setEffectTarget(const char *name, const char *target)
+{
+	auto iter = effectmap.find(name);
+	if (iter == effectmap.end())
+		return false;
+
+#ifdef ALC_EXT_EFX
+	if (!alAuxiliaryEffectSloti || !hasEffectTargetExtension)
+		return false;
+
+	if (target == nullptr)
+	{
+		if (!iter->second.target.empty())
+			alAuxiliaryEffectSloti(iter->second.slot, AL_EFFECTSLOT_TARGET_SOFT, AL_EFFECTSLOT_NULL);
+		iter->second.target.clear();
+		return true;
+	}
+
+	auto targetiter = effectmap.find(target);
+	if (targetiter == effectmap.end())
+		return false;
+
+	// Follow the chain from the target to make sure it doesn't lead back here.
+	for (auto next = targetiter; next != effectmap.end(); next = effectmap.find(next->second.target))
+	{
+		if (next == iter)
+			throw love::Exception("Routing effect '%s' into '%s' would create a loop.", name, target);
+		if (next->second.target.empty())
+			break;
+	}
+
+	alGetError();
+	alAuxiliaryEffectSloti(iter->second.slot, AL_EFFECTSLOT_TARGET_SOFT, targetiter->second.slot);
+	if (alGetError() != AL_NO_ERROR)
+		return false;
+
+	iter->second.target = target;
+	return true;
+#else
+	LOVE_UNUSED(target);
+	return false;
+#endif
+}
+
+bool Audio::getEffectTarget(const char *name, std::string &target) const
+{
+	auto iter = effectmap.find(name);
+	if (iter == effectmap.end() || iter->second.target.empty())
+		return false;
+
+	target = iter->second.target;
+	return true;
+}
+
 bool Audio::getActiveEffects(std::vector<std::string> &list) const
 {
 	if (effectmap.empty())
@@ -743,6 +1029,13 @@ bool Audio::isEFXsupported() const
 #endif
 }
 
+int Audio::getOutputSampleRate() const
+{
+	ALCint frequency = 0;
+	alcGetIntegerv(device, ALC_FREQUENCY, 1, &frequency);
+	return frequency;
+}
+
 bool Audio::setOutputSpatialization(bool enable, const char *filter)
 {
 	requestEnableHRTF = enable;
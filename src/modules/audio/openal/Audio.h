@@ -24,6 +24,8 @@
 // STD
 #include <queue>
 #include <map>
+#include <unordered_map>
+#include <string>
 #include <vector>
 #include <stack>
 #include <cmath>
@@ -55,6 +57,20 @@
 #include <alext.h>
 #endif
 
+#ifndef AL_SOFT_effect_target
+#define AL_EFFECTSLOT_TARGET_SOFT 0x199C
+#endif
+
+#ifndef AL_SOFT_deferred_updates
+typedef void (AL_APIENTRY*LPALDEFERUPDATESSOFT)(void);
+typedef void (AL_APIENTRY*LPALPROCESSUPDATESSOFT)(void);
+#endif
+
+#ifndef AL_SOFT_callback_buffer
+typedef ALsizei (AL_APIENTRY*ALBUFFERCALLBACKTYPESOFT)(ALvoid *userptr, ALvoid *sampledata, ALsizei numbytes);
+typedef void (AL_APIENTRY*LPALBUFFERCALLBACKSOFT)(ALuint buffer, ALenum format, ALsizei freq, ALBUFFERCALLBACKTYPESOFT callback, ALvoid *userptr);
+#endif
+
 namespace love
 {
 namespace audio
@@ -62,6 +78,8 @@ namespace audio
 namespace openal
 {
 
+class StaticDataBuffer;
+
 class Audio : public love::audio::Audio
 {
 public:
@@ -80,8 +98,15 @@ public:
 
 	// Implements Audio.
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
+	love::audio::Source *newCompressedSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
-	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers, int ringSamples);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const std::string &cacheKey);
+	love::audio::Source *newCachedSource(const std::string &cacheKey);
+	void setSoundCacheLimit(int64 bytes);
+	int64 getSoundCacheLimit() const;
+	int64 getSoundCacheSize() const;
+	void clearSoundCache();
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -92,6 +117,8 @@ public:
 	void pause(love::audio::Source *source);
 	void pause(const std::vector<love::audio::Source*> &sources);
 	std::vector<love::audio::Source*> pause();
+	void setSourceTransforms(const std::vector<love::audio::Source*> &sources, const float *data, int components);
+	bool playOneShot(love::sound::SoundData *soundData, float volume, float pitch, const float *position);
 	void pauseContext();
 	void resumeContext();
 	void setVolume(float volume);
@@ -117,10 +144,13 @@ public:
 	bool setEffect(const char *name, std::map<Effect::Parameter, float> &params);
 	bool unsetEffect(const char *name);
 	bool getEffect(const char *name, std::map<Effect::Parameter, float> &params);
+	bool setEffectTarget(const char *name, const char *target);
+	bool getEffectTarget(const char *name, std::string &target) const;
 	bool getActiveEffects(std::vector<std::string> &list) const;
 	int getMaxSceneEffects() const;
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
+	int getOutputSampleRate() const;
 
 	bool setOutputSpatialization(bool enable, const char *filter = nullptr) override;
 	bool getOutputSpatialization(const char *&filter) const override;
@@ -128,15 +158,42 @@ public:
 
 	bool getEffectID(const char *name, ALuint &id);
 
+	/**
+	 * Makes OpenAL pull the buffer's data from a callback while mixing.
+	 * @return False if AL_SOFT_callback_buffer isn't supported.
+	 **/
+	bool setBufferCallback(ALuint buffer, ALenum format, ALsizei freq, ALBUFFERCALLBACKTYPESOFT callback, void *userptr);
+
 	std::string getPlaybackDevice();
 	void getPlaybackDevices(std::vector<std::string> &list);
 	void setPlaybackDevice(const char *name);
 
 private:
 
+	// Decoded audio shared between static Sources loaded from the same file.
+	struct SoundCacheEntry
+	{
+		StrongRef<StaticDataBuffer> buffer;
+		int sampleRate;
+		int bitDepth;
+		int channels;
+		uint64 lastUse;
+	};
+
+	// An internal Source used by playOneShot. It's idle when the list holds
+	// its only reference, since the Pool retains Sources while they play.
+	struct OneShotVoice
+	{
+		StrongRef<love::sound::SoundData> soundData;
+		StrongRef<Source> source;
+	};
+
 	std::vector<ALint> computeContextAttribs();
 	void initializeEFX();
 
+	// Must be called with soundCacheMutex locked.
+	void trimSoundCache(int64 limit);
+
 	// The OpenAL device.
 	ALCdevice *device;
 
@@ -151,6 +208,8 @@ private:
 	{
 		Effect *effect;
 		ALuint slot;
+		// Name of the effect this one's output is routed into, if any.
+		std::string target;
 	};
 	std::map<std::string, struct EffectMapStorage> effectmap;
 	std::stack<ALuint> slotlist;
@@ -165,6 +224,19 @@ private:
 	// The Pool.
 	Pool *pool;
 
+	static const int64 DEFAULT_SOUND_CACHE_LIMIT = 64 * 1024 * 1024;
+
+	std::unordered_map<std::string, SoundCacheEntry> soundCache;
+	int64 soundCacheSize = 0;
+	int64 soundCacheLimit = DEFAULT_SOUND_CACHE_LIMIT;
+	uint64 soundCacheCounter = 0;
+	love::thread::MutexRef soundCacheMutex;
+
+	static const int MAX_ONESHOT_VOICES = 64;
+
+	std::vector<OneShotVoice> oneShotVoices;
+	love::thread::MutexRef oneShotMutex;
+
 	class PoolThread: public thread::Threadable
 	{
 	protected:
@@ -191,6 +263,11 @@ private:
 	//float metersPerUnit = 1.0;
 
 	bool hasHRTFExtension = false;
+	bool hasEffectTargetExtension = false;
+
+	LPALBUFFERCALLBACKSOFT alBufferCallbackSOFT = nullptr;
+	LPALDEFERUPDATESSOFT alDeferUpdatesSOFT = nullptr;
+	LPALPROCESSUPDATESSOFT alProcessUpdatesSOFT = nullptr;
 
 #ifdef LOVE_ANDROID
 #	ifndef ALC_SOFT_pause_device
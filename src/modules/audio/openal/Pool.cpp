@@ -21,7 +21,13 @@
 #include "Pool.h"
 
 #include "event/Event.h"
+#include "profiler/Profiler.h"
 #include "Source.h"
+#include "StreamReader.h"
+
+// STD
+#include <deque>
+#include <thread>
 
 namespace love
 {
@@ -35,16 +41,123 @@ static Variant::SharedTable *putSourcesAsSharedTable(std::vector<audio::Source *
 	Variant::SharedTable *table = new Variant::SharedTable();
 
 	for (int i = 0; i < (int) sources.size(); i++)
-		table->pairs.emplace_back((double) (i + 1), Variant(&Source::type, sources[i]));
+		table->add(Variant((double) (i + 1)), Variant(&Source::type, sources[i]));
 
 	return table;
 }
 
+class Pool::DecodeThreadPool
+{
+public:
+
+	DecodeThreadPool(int threadcount)
+		: stopping(false)
+	{
+		for (int i = 0; i < threadcount; i++)
+		{
+			Worker *worker = new Worker(this);
+			workers.push_back(worker);
+			worker->start();
+		}
+	}
+
+	~DecodeThreadPool()
+	{
+		mutex->lock();
+		stopping = true;
+		workCond->broadcast();
+		mutex->unlock();
+
+		for (Worker *worker : workers)
+		{
+			worker->wait();
+			delete worker;
+		}
+
+		for (auto &reader : queue)
+			reader->queued = false;
+	}
+
+	void queueRead(StreamReader *reader)
+	{
+		thread::Lock lock(mutex);
+
+		if (reader->queued || stopping)
+			return;
+
+		reader->queued = true;
+		queue.emplace_back(reader);
+		workCond->signal();
+	}
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(DecodeThreadPool *pool)
+			: pool(pool)
+		{
+			threadName = "AudioDecoder";
+		}
+
+		void threadFunction() override
+		{
+			pool->mutex->lock();
+
+			while (!pool->stopping)
+			{
+				if (pool->queue.empty())
+				{
+					pool->workCond->wait(pool->mutex);
+					continue;
+				}
+
+				StrongRef<StreamReader> reader = pool->queue.front();
+				pool->queue.pop_front();
+
+				pool->mutex->unlock();
+
+				reader->decodeNext();
+
+				pool->mutex->lock();
+
+				// Readers go to the back of the queue after each chunk, so a
+				// slow decoder can't starve the others. Chunks used while this
+				// one was decoding are picked up here too.
+				reader->queued = false;
+				if (reader->needsDecode())
+				{
+					reader->queued = true;
+					pool->queue.push_back(reader);
+				}
+			}
+
+			pool->mutex->unlock();
+		}
+
+	private:
+
+		DecodeThreadPool *pool;
+	};
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workCond;
+
+	std::vector<Worker *> workers;
+	std::deque<StrongRef<StreamReader>> queue;
+
+	bool stopping;
+};
+
 Pool::Pool(ALCdevice *device)
 	: device(device)
 	, sources()
 	, disconnectNotified(false)
 	, totalSources(0)
+	, wakeRequested(false)
+	, decodeThreads(nullptr)
 {
 	// Clear errors.
 	alGetError();
@@ -74,6 +187,13 @@ Pool::~Pool()
 {
 	Source::stop(this);
 
+	// Stopping the sources rewinds their readers, which queues them again.
+	{
+		thread::Lock lock(decodeThreadsMutex);
+		delete decodeThreads;
+		decodeThreads = nullptr;
+	}
+
 	// Free all sources.
 	alDeleteSources(totalSources, sources);
 }
@@ -98,8 +218,10 @@ bool Pool::isPlaying(Source *s)
 	return p;
 }
 
-void Pool::update()
+double Pool::update()
 {
+	LOVE_PROFILE_ZONE("love.audio.update");
+
 #ifndef ALC_CONNECTED
 	constexpr ALCenum ALC_CONNECTED = 0x313;
 #endif
@@ -108,12 +230,16 @@ void Pool::update()
 
 	static bool disconnectExtSupported = alcIsExtensionPresent(device, "ALC_EXT_Disconnect") == ALC_TRUE;
 
+	double next = -1.0;
+
 	// Device disconnection event
 	if (disconnectExtSupported)
 	{
 		auto eventModule = Module::getInstance<event::Event>(Module::M_EVENT);
 		if (eventModule)
 		{
+			next = MAX_UPDATE_INTERVAL;
+
 			ALCint connected;
 			alcGetIntegerv(device, ALC_CONNECTED, 1, &connected);
 
@@ -147,6 +273,60 @@ void Pool::update()
 
 	for (Source *s : torelease)
 		releaseSource(s);
+
+	updateVirtualSources();
+
+	// Virtual sources have to be checked for becoming audible.
+	if (!virtualSources.empty())
+		next = MAX_UPDATE_INTERVAL;
+
+	for (const auto &i : playing)
+	{
+		double t = i.first->getTimeUntilUpdate();
+		if (t < 0.0)
+			continue;
+
+		t = std::min(t, MAX_UPDATE_INTERVAL);
+		next = next < 0.0 ? t : std::min(next, t);
+	}
+
+	return next;
+}
+
+void Pool::waitForUpdate(double seconds)
+{
+	thread::Lock lock(wakeMutex);
+
+	if (!wakeRequested)
+	{
+		// Wake up a little early rather than late, so streams don't run dry.
+		int timeout = seconds < 0.0 ? -1 : std::max((int) (seconds * 1000.0 * 0.9), 1);
+		wakeCond->wait(wakeMutex, timeout);
+	}
+
+	wakeRequested = false;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(wakeMutex);
+	wakeRequested = true;
+	wakeCond->signal();
+}
+
+void Pool::queueRead(StreamReader *reader)
+{
+	thread::Lock lock(decodeThreadsMutex);
+
+	if (decodeThreads == nullptr)
+	{
+		// Leave a core for the main thread, but always use more than one
+		// thread so a single slow decoder doesn't hold up every stream.
+		int threadcount = (int) std::thread::hardware_concurrency() - 1;
+		decodeThreads = new DecodeThreadPool(std::max(std::min(threadcount, MAX_DECODE_THREADS), 2));
+	}
+
+	decodeThreads->queueRead(reader);
 }
 
 int Pool::getActiveSourceCount() const
@@ -159,6 +339,11 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
+int Pool::getVirtualSourceCount() const
+{
+	return (int) virtualSources.size();
+}
+
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 {
 	out = 0;
@@ -169,20 +354,141 @@ bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 	wasPlaying = false;
 
 	if (available.empty())
-		return false;
+	{
+		float listener[3];
+		alGetListenerfv(AL_POSITION, listener);
 
-	out = available.front();
-	available.pop();
+		if (!stealSource(source, 1.0f, listener, out))
+			return false;
+	}
+	else
+	{
+		out = available.front();
+		available.pop();
+	}
 
 	playing.insert(std::make_pair(source, out));
 	source->retain();
 	return true;
 }
 
+void Pool::addVirtualSource(Source *source)
+{
+	if (virtualSources.insert(source).second)
+	{
+		source->startVirtualAtomic();
+		source->retain();
+	}
+}
+
+bool Pool::stealSource(Source *source, float margin, const float *listener, ALuint &out)
+{
+	Source *victim = nullptr;
+
+	for (const auto &i : playing)
+	{
+		// Sources which are still being started don't have anything to keep.
+		Source *s = i.first;
+		if (s == source || !s->valid || !s->canVirtualize())
+			continue;
+
+		if (victim == nullptr || isMoreImportant(victim, s, 1.0f, listener))
+			victim = s;
+	}
+
+	if (victim == nullptr || !isMoreImportant(source, victim, margin, listener))
+		return false;
+
+	findSource(victim, out);
+
+	// The retain from playing moves over to the virtual list.
+	victim->virtualizeAtomic();
+	playing.erase(victim);
+	virtualSources.insert(victim);
+
+	return true;
+}
+
+float Pool::getAudibility(Source *source, const float *listener) const
+{
+	// Paused sources aren't heard at all.
+	if (!source->isPlaying())
+		return 0.0f;
+
+	return source->getAudibility(listener);
+}
+
+bool Pool::isMoreImportant(Source *a, Source *b, float margin, const float *listener) const
+{
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+
+	return getAudibility(a, listener) > getAudibility(b, listener) * margin;
+}
+
+void Pool::updateVirtualSources()
+{
+	if (virtualSources.empty())
+		return;
+
+	std::vector<Source *> candidates;
+	std::vector<Source *> finished;
+
+	for (Source *s : virtualSources)
+	{
+		if (s->isVirtualFinished())
+			finished.push_back(s);
+		else if (s->isPlaying())
+			candidates.push_back(s);
+	}
+
+	for (Source *s : finished)
+		releaseSource(s);
+
+	if (candidates.empty())
+		return;
+
+	float listener[3];
+	alGetListenerfv(AL_POSITION, listener);
+
+	std::sort(candidates.begin(), candidates.end(), [&](Source *a, Source *b)
+	{
+		return isMoreImportant(a, b, 1.0f, listener);
+	});
+
+	for (Source *s : candidates)
+	{
+		ALuint id = 0;
+
+		if (!available.empty())
+		{
+			id = available.front();
+			available.pop();
+		}
+		else if (!stealSource(s, VIRTUAL_SWAP_MARGIN, listener, id))
+		{
+			// The rest are less important than this one.
+			break;
+		}
+
+		virtualSources.erase(s);
+		playing.insert(std::make_pair(s, id));
+
+		s->devirtualizeAtomic(id);
+	}
+}
+
 bool Pool::releaseSource(Source *source, bool stop)
 {
 	ALuint s;
 
+	if (virtualSources.erase(source) > 0)
+	{
+		source->stopVirtualAtomic();
+		source->release();
+		return true;
+	}
+
 	if (findSource(source, s))
 	{
 		if (stop)
@@ -215,9 +521,11 @@ thread::Lock Pool::lock()
 std::vector<love::audio::Source*> Pool::getPlayingSources()
 {
 	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
+	sources.reserve(playing.size() + virtualSources.size());
 	for (auto &i : playing)
 		sources.push_back(i.first);
+	for (Source *s : virtualSources)
+		sources.push_back(s);
 	return sources;
 }
 
@@ -23,7 +23,9 @@
 
 // STD
 #include <queue>
+#include <algorithm>
 #include <map>
+#include <set>
 #include <vector>
 #include <cmath>
 
@@ -59,6 +61,7 @@ namespace openal
 {
 
 class Source;
+class StreamReader;
 
 class Pool
 {
@@ -78,13 +81,44 @@ public:
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Updates all playing sources.
+	 * @return Seconds until the next update is needed, or a negative value if
+	 * nothing needs to be updated until a source's state changes.
+	 **/
+	double update();
+
+	/**
+	 * Blocks until the given number of seconds has passed (forever, if
+	 * negative), or until wake is called.
+	 **/
+	void waitForUpdate(double seconds);
+
+	/**
+	 * Makes the thread in waitForUpdate update the sources immediately, e.g.
+	 * because a source started playing or new data was queued.
+	 **/
+	void wake();
+
+	/**
+	 * Queues a streaming Source's reader to decode ahead on one of the
+	 * decoding threads, if it isn't queued already.
+	 **/
+	void queueRead(StreamReader *reader);
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 
+	/**
+	 * Number of playing Sources which don't have an OpenAL source, because
+	 * more important ones are using them all.
+	 **/
+	int getVirtualSourceCount() const;
+
 private:
 
+	class DecodeThreadPool;
+
 	friend class Source;
 	LOVE_WARN_UNUSED thread::Lock lock();
 	std::vector<love::audio::Source*> getPlayingSources();
@@ -98,9 +132,39 @@ private:
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
 
+	/**
+	 * Adds a Source which couldn't be assigned an OpenAL source to the
+	 * virtual list, playing from its current offset.
+	 **/
+	void addVirtualSource(Source *source);
+
+	/**
+	 * Virtualizes the least important playing Source, if the given Source is
+	 * more important than it by the given factor, and returns its OpenAL
+	 * source.
+	 **/
+	bool stealSource(Source *source, float margin, const float *listener, ALuint &out);
+
+	float getAudibility(Source *source, const float *listener) const;
+	bool isMoreImportant(Source *a, Source *b, float margin, const float *listener) const;
+
+	void updateVirtualSources();
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
+	// Longest time between updates while anything is playing, or while device
+	// disconnection has to be polled for.
+	static constexpr double MAX_UPDATE_INTERVAL = 0.1;
+
+	// A virtual Source has to be this much louder than a playing Source with
+	// the same priority to take its place, so similar sounds don't keep
+	// swapping.
+	static constexpr float VIRTUAL_SWAP_MARGIN = 1.25f;
+
+	// Streams are spread over this many decoding threads at most.
+	static const int MAX_DECODE_THREADS = 4;
+
 	// Current OpenAL device
 	ALCdevice *device;
 
@@ -119,10 +183,22 @@ private:
 	// A map of playing sources.
 	std::map<Source *, ALuint> playing;
 
+	// Playing or paused sources without an OpenAL source.
+	std::set<Source *> virtualSources;
+
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	// Separate from the main mutex, so waking never waits on an update.
+	love::thread::MutexRef wakeMutex;
+	love::thread::ConditionalRef wakeCond;
+	bool wakeRequested;
+
+	// Created when the first streaming Source needs to decode.
+	DecodeThreadPool *decodeThreads;
+	love::thread::MutexRef decodeThreadsMutex;
+
 }; // Pool
 
 } // openal
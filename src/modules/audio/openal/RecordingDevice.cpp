@@ -22,6 +22,8 @@
 #include "Audio.h"
 #include "sound/Sound.h"
 
+#include <algorithm>
+
 namespace love
 {
 namespace audio
@@ -42,6 +44,42 @@ public:
 
 };
 
+RecordingDevice::CaptureThread::CaptureThread(RecordingDevice *device)
+	: device(device)
+	, finish(false)
+{
+	threadName = "RecordingDevice";
+}
+
+RecordingDevice::CaptureThread::~CaptureThread()
+{
+}
+
+void RecordingDevice::CaptureThread::setFinish()
+{
+	thread::Lock lock(mutex);
+	finish = true;
+	cond->signal();
+}
+
+void RecordingDevice::CaptureThread::threadFunction()
+{
+	// Wake up twice per block so a block is delivered soon after it's ready.
+	int interval = std::max((device->blockSamples * 500) / device->sampleRate, 1);
+
+	while (true)
+	{
+		device->deliverBlocks();
+
+		thread::Lock lock(mutex);
+		if (finish)
+			return;
+		cond->wait(mutex, interval);
+		if (finish)
+			return;
+	}
+}
+
 RecordingDevice::RecordingDevice(const char *name) 
 	: name(name)
 {
@@ -70,7 +108,11 @@ bool RecordingDevice::start(int samples, int sampleRate, int bitDepth, int chann
 	// This hard-crashes on iOS with Apple's OpenAL implementation, even when
 	// the user gives permission to the app.
 #ifndef LOVE_IOS
-	device = alcCaptureOpenDevice(name.c_str(), sampleRate, format, samples);
+	int bufferSamples = samples;
+	if (channel.get() != nullptr)
+		bufferSamples = std::max(samples, blockSamples * CHANNEL_BUFFER_BLOCKS);
+
+	device = alcCaptureOpenDevice(name.c_str(), sampleRate, format, bufferSamples);
 #endif
 	if (device == nullptr)
 		return false;
@@ -82,6 +124,11 @@ bool RecordingDevice::start(int samples, int sampleRate, int bitDepth, int chann
 	this->bitDepth = bitDepth;
 	this->channels = channels;
 
+	blockPool.clear();
+
+	if (channel.get() != nullptr)
+		startCaptureThread();
+
 	return true;
 }
 
@@ -90,6 +137,8 @@ void RecordingDevice::stop()
 	if (!isRecording())
 		return;
 
+	stopCaptureThread();
+
 	alcCaptureStop(device);
 	alcCaptureCloseDevice(device);
 	device = nullptr;
@@ -97,7 +146,7 @@ void RecordingDevice::stop()
 
 love::sound::SoundData *RecordingDevice::getData()
 {
-	if (!isRecording())
+	if (!isRecording() || channel.get() != nullptr)
 		return nullptr;
 
 	int samples = getSampleCount();
@@ -111,6 +160,87 @@ love::sound::SoundData *RecordingDevice::getData()
 	return soundData;
 }
 
+void RecordingDevice::setChannel(love::thread::Channel *channel, int blockSamples)
+{
+	if (channel != nullptr && blockSamples <= 0)
+		throw love::Exception("Invalid number of samples per block.");
+
+	stopCaptureThread();
+
+	this->channel.set(channel);
+	if (channel != nullptr)
+		this->blockSamples = blockSamples;
+
+	blockPool.clear();
+
+	if (channel != nullptr && isRecording())
+		startCaptureThread();
+}
+
+love::thread::Channel *RecordingDevice::getChannel() const
+{
+	return channel.get();
+}
+
+int RecordingDevice::getBlockSampleCount() const
+{
+	return blockSamples;
+}
+
+void RecordingDevice::startCaptureThread()
+{
+	captureThread = new CaptureThread(this);
+	if (!captureThread->start())
+	{
+		captureThread->release();
+		captureThread = nullptr;
+		throw love::Exception("Could not start the recording thread.");
+	}
+}
+
+void RecordingDevice::stopCaptureThread()
+{
+	if (captureThread == nullptr)
+		return;
+
+	captureThread->setFinish();
+	captureThread->wait();
+	captureThread->release();
+	captureThread = nullptr;
+}
+
+love::sound::SoundData *RecordingDevice::acquireBlock()
+{
+	// A pooled block only referenced by the pool has been let go of by
+	// whoever received it, and can be filled again.
+	for (const auto &block : blockPool)
+	{
+		if (block->getReferenceCount() == 1)
+		{
+			block->retain();
+			return block.get();
+		}
+	}
+
+	love::sound::SoundData *block = soundInstance()->newSoundData(blockSamples, sampleRate, bitDepth, channels);
+
+	if ((int) blockPool.size() < MAX_POOLED_BLOCKS)
+		blockPool.emplace_back(block);
+
+	return block;
+}
+
+void RecordingDevice::deliverBlocks()
+{
+	while (getSampleCount() >= blockSamples)
+	{
+		love::sound::SoundData *block = acquireBlock();
+		alcCaptureSamples(device, block->getData(), blockSamples);
+		channel->push(Variant(&love::sound::SoundData::type, block));
+		block->release();
+	}
+}
+
 int RecordingDevice::getSampleCount() const
 {
 	if (!isRecording())
@@ -37,7 +37,12 @@
 #endif
 
 #include "audio/RecordingDevice.h"
+#include "common/Object.h"
 #include "sound/SoundData.h"
+#include "thread/threads.h"
+#include "thread/Channel.h"
+
+#include <vector>
 
 namespace love
 {
@@ -55,6 +60,9 @@ public:
 	virtual bool start(int samples, int sampleRate, int bitDepth, int channels);
 	virtual void stop();
 	virtual love::sound::SoundData *getData();
+	virtual void setChannel(love::thread::Channel *channel, int blockSamples);
+	virtual love::thread::Channel *getChannel() const;
+	virtual int getBlockSampleCount() const;
 	virtual const char *getName() const;
 	virtual int getSampleCount() const;
 	virtual int getMaxSamples() const;
@@ -65,6 +73,36 @@ public:
 
 private:
 
+	class CaptureThread : public thread::Threadable
+	{
+	public:
+
+		CaptureThread(RecordingDevice *device);
+		virtual ~CaptureThread();
+		void setFinish();
+		void threadFunction();
+
+	private:
+
+		RecordingDevice *device;
+		bool finish;
+
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+	};
+
+	// The capture buffer is made at least this many blocks long when blocks
+	// are delivered to a Channel, so a late wakeup doesn't drop input.
+	static const int CHANNEL_BUFFER_BLOCKS = 4;
+
+	// Blocks beyond this many in flight at once are allocated and not reused.
+	static const int MAX_POOLED_BLOCKS = 16;
+
+	void startCaptureThread();
+	void stopCaptureThread();
+	love::sound::SoundData *acquireBlock();
+	void deliverBlocks();
+
 	int samples = DEFAULT_SAMPLES;
 	int sampleRate = DEFAULT_SAMPLE_RATE;
 	int bitDepth = DEFAULT_BIT_DEPTH;
@@ -73,6 +111,11 @@ private:
 	std::string name;
 	ALCdevice *device = nullptr;
 
+	StrongRef<love::thread::Channel> channel;
+	int blockSamples = DEFAULT_BLOCK_SAMPLES;
+	std::vector<StrongRef<love::sound::SoundData>> blockPool;
+	CaptureThread *captureThread = nullptr;
+
 }; //RecordingDevice
 
 } //openal
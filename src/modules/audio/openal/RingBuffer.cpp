@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "RingBuffer.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+RingBuffer::RingBuffer(size_t capacity)
+	: data(new unsigned char[capacity])
+	, capacity(capacity)
+	, readPos(0)
+	, writePos(0)
+{
+}
+
+RingBuffer::~RingBuffer()
+{
+	delete[] data;
+}
+
+size_t RingBuffer::write(const void *src, size_t size)
+{
+	size_t w = writePos.load(std::memory_order_relaxed);
+	size_t r = readPos.load(std::memory_order_acquire);
+
+	size = std::min(size, capacity - (w - r));
+
+	size_t offset = w % capacity;
+	size_t first = std::min(size, capacity - offset);
+
+	memcpy(data + offset, src, first);
+	memcpy(data, (const unsigned char *) src + first, size - first);
+
+	// Publish the data to the consumer only once it's been copied.
+	writePos.store(w + size, std::memory_order_release);
+	return size;
+}
+
+size_t RingBuffer::read(void *dst, size_t size)
+{
+	size_t r = readPos.load(std::memory_order_relaxed);
+	size_t w = writePos.load(std::memory_order_acquire);
+
+	size = std::min(size, w - r);
+
+	size_t offset = r % capacity;
+	size_t first = std::min(size, capacity - offset);
+
+	memcpy(dst, data + offset, first);
+	memcpy((unsigned char *) dst + first, data, size - first);
+
+	// The producer may overwrite the space once it's been copied out.
+	readPos.store(r + size, std::memory_order_release);
+	return size;
+}
+
+void RingBuffer::clear()
+{
+	readPos.store(writePos.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+size_t RingBuffer::getReadSpace() const
+{
+	// Read first, so a write in between can't make the result negative.
+	size_t r = readPos.load(std::memory_order_acquire);
+	size_t w = writePos.load(std::memory_order_acquire);
+	return w - r;
+}
+
+size_t RingBuffer::getWriteSpace() const
+{
+	return capacity - getReadSpace();
+}
+
+} // openal
+} // audio
+} // love
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_RING_BUFFER_H
+#define LOVE_AUDIO_OPENAL_RING_BUFFER_H
+
+// LOVE
+#include "common/config.h"
+
+// STD
+#include <atomic>
+#include <cstddef>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+/**
+ * A lock-free single producer, single consumer byte queue. One thread may
+ * write while another reads without either ever waiting for the other, which
+ * lets low latency queueable Sources be fed without taking the Pool's lock.
+ **/
+class RingBuffer
+{
+public:
+
+	RingBuffer(size_t capacity);
+	~RingBuffer();
+
+	/**
+	 * Copies data into the buffer. Must only be called by the producer.
+	 * @return The number of bytes written, which is less than size if the
+	 * buffer doesn't have enough free space.
+	 **/
+	size_t write(const void *data, size_t size);
+
+	/**
+	 * Copies data out of the buffer. Must only be called by the consumer.
+	 * @return The number of bytes read.
+	 **/
+	size_t read(void *dst, size_t size);
+
+	/**
+	 * Discards everything currently readable. Must only be called by the
+	 * consumer.
+	 **/
+	void clear();
+
+	size_t getReadSpace() const;
+	size_t getWriteSpace() const;
+
+	inline size_t getCapacity() const
+	{
+		return capacity;
+	}
+
+private:
+
+	unsigned char *data;
+	size_t capacity;
+
+	// Total bytes ever read and written. Only the consumer stores readPos and
+	// only the producer stores writePos.
+	std::atomic<size_t> readPos;
+	std::atomic<size_t> writePos;
+
+}; // RingBuffer
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_RING_BUFFER_H
@@ -23,10 +23,12 @@
 #include "Pool.h"
 #include "Audio.h"
 #include "common/math.h"
+#include "timer/Timer.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -141,7 +143,25 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 		slotlist.push(i);
 }
 
-Source::Source(Pool *pool, love::sound::Decoder *decoder)
+Source::Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, pool(pool)
+	, staticBuffer(buffer)
+	, sampleRate(sampleRate)
+	, channels(channels)
+	, bitDepth(bitDepth)
+{
+	float z[3] = {0, 0, 0};
+
+	setFloatv(position, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+
+	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
+		slotlist.push(i);
+}
+
+Source::Source(Pool *pool, love::sound::Decoder *decoder, bool compressed)
 	: love::audio::Source(Source::TYPE_STREAM)
 	, pool(pool)
 	, sampleRate(decoder->getSampleRate())
@@ -153,6 +173,12 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	if (Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount()) == AL_NONE)
 		throw InvalidFormatException(decoder->getChannelCount(), decoder->getBitDepth());
 
+	this->compressed = compressed;
+
+	// Start decoding straight away, so playing doesn't have to wait for it.
+	reader.set(new StreamReader(pool, decoder, buffers), Acquire::NORETAIN);
+	pool->queueRead(reader);
+
 	for (int i = 0; i < buffers; i++)
 	{
 		ALuint buf;
@@ -176,7 +202,7 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 		slotlist.push(i);
 }
 
-Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int b)
+Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int b, int ringSamples)
 	: love::audio::Source(Source::TYPE_QUEUE)
 	, pool(pool)
 	, sampleRate(sampleRate)
@@ -193,7 +219,11 @@ Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int b)
 	if (buffers > MAX_BUFFERS)
 		buffers = MAX_BUFFERS;
 
-	for (int i = 0; i < buffers; i++)
+	if (ringSamples > 0)
+		initRingBuffer(ringSamples);
+
+	// The callback buffer replaces the streaming buffers.
+	for (int i = 0; i < buffers && callbackBuffer == AL_NONE; i++)
 	{
 		ALuint buf;
 		alGenBuffers(1, &buf);
@@ -232,6 +262,7 @@ Source::Source(const Source &s)
 	, maxDistance(s.maxDistance)
 	, cone(s.cone)
 	, offsetSamples(0)
+	, priority(s.priority)
 	, sampleRate(s.sampleRate)
 	, channels(s.channels)
 	, bitDepth(s.bitDepth)
@@ -239,12 +270,23 @@ Source::Source(const Source &s)
 	, toLoop(0)
 	, buffers(s.buffers)
 {
+	compressed = s.compressed;
+
 	if (sourceType == TYPE_STREAM)
 	{
 		if (s.decoder.get())
+		{
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+
+			reader.set(new StreamReader(pool, decoder, buffers), Acquire::NORETAIN);
+			reader->setLooping(looping);
+			pool->queueRead(reader);
+		}
 	}
-	if (sourceType != TYPE_STATIC)
+	if (s.ringBuffer != nullptr)
+		initRingBuffer((int) s.ringBuffer->getCapacity() / (channels * (bitDepth / 8)));
+
+	if (sourceType != TYPE_STATIC && callbackBuffer == AL_NONE)
 	{
 		for (int i = 0; i < buffers; i++)
 		{
@@ -308,6 +350,11 @@ Source::~Source()
 		}
 	}
 
+	if (callbackBuffer != AL_NONE)
+		alDeleteBuffers(1, &callbackBuffer);
+
+	delete ringBuffer;
+
 	if (directfilter)
 		delete directfilter;
 
@@ -326,11 +373,35 @@ love::audio::Source *Source::clone()
 bool Source::play()
 {
 	Lock l = pool->lock();
+
+	if (virtualVoice)
+	{
+		if (virtualPaused)
+		{
+			virtualPaused = false;
+			virtualStartTime = love::timer::Timer::getTime();
+		}
+
+		pool->wake();
+		return true;
+	}
+
 	ALuint out;
 
 	char wasPlaying;
 	if (!pool->assignSource(this, out, wasPlaying))
-		return valid = false;
+	{
+		if (!canVirtualize())
+			return valid = false;
+
+		// Every OpenAL source is used by something more important, so this
+		// plays unheard until one is free.
+		pool->addVirtualSource(this);
+		pool->wake();
+		return true;
+	}
+
+	pool->wake();
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -341,7 +412,7 @@ bool Source::play()
 
 void Source::stop()
 {
-	if (!valid)
+	if (!valid && !virtualVoice)
 		return;
 
 	Lock l = pool->lock();
@@ -351,12 +422,15 @@ void Source::stop()
 void Source::pause()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (virtualVoice || pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	if (virtualVoice)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -367,10 +441,17 @@ bool Source::isPlaying() const
 
 bool Source::isFinished() const
 {
+	if (virtualVoice)
+		return isVirtualFinished();
+
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (sourceType == TYPE_STREAM && (isLooping() || !reader->isFinished()))
+		return false;
+
+	// Ring buffered Sources play silence when starved, until stopped.
+	if (ringBuffer != nullptr)
 		return false;
 
 	ALenum state;
@@ -419,7 +500,7 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
+					if (streamAtomic(buffer, false) > 0)
 						alSourceQueueBuffers(source, 1, &buffer);
 					else
 						unusedBuffers.push(buffer);
@@ -428,7 +509,7 @@ bool Source::update()
 				while (!unusedBuffers.empty())
 				{
 					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					if (streamAtomic(b, false) > 0)
 					{
 						alSourceQueueBuffers(source, 1, &b);
 						unusedBuffers.pop();
@@ -445,9 +526,31 @@ bool Source::update()
 			ALint processed;
 			ALuint buffers[MAX_BUFFERS];
 
+			// OpenAL pulls from the ring itself.
+			if (callbackBuffer != AL_NONE)
+				return true;
+
 			alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
 			alSourceUnqueueBuffers(source, processed, buffers);
 
+			if (ringBuffer != nullptr)
+			{
+				for (int i = 0; i < processed; i++)
+				{
+					streamRingAtomic(buffers[i]);
+					alSourceQueueBuffers(source, 1, &buffers[i]);
+				}
+
+				// Restart playback if the update came too late and every
+				// buffer ran out.
+				ALenum state;
+				alGetSourcei(source, AL_SOURCE_STATE, &state);
+				if (state == AL_STOPPED)
+					alSourcePlay(source);
+
+				return true;
+			}
+
 			for (int i = 0; i < processed; i++)
 			{
 				ALint size;
@@ -457,6 +560,7 @@ bool Source::update()
 			}
 			return !isFinished();
 		}
+		case TYPE_COMPRESSED:
 		case TYPE_MAX_ENUM:
 			break;
 	}
@@ -464,11 +568,91 @@ bool Source::update()
 	return false;
 }
 
+double Source::getTimeUntilUpdate() const
+{
+	if (!valid)
+		return -1.0;
+
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	// Paused and stopped sources only change when they're played again.
+	if (state != AL_PLAYING)
+		return -1.0;
+
+	ALfloat p = 1.0f;
+	alGetSourcef(source, AL_PITCH, &p);
+
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	double rate = sampleRate * std::max((double) p, 0.001);
+	int framesize = channels * (bitDepth / 8);
+
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+	{
+		// Only the end of a non-looping source needs to be noticed.
+		if (isLooping())
+			return -1.0;
+
+		int samples = staticBuffer->getSize() / framesize;
+		return std::max(samples - offset, 0) / rate;
+	}
+	case TYPE_STREAM:
+	{
+		// Processed buffers were unqueued by the last update, so the offset
+		// is into the oldest queued buffer. Decoded buffers are full except
+		// at the end of the stream, where an early update is harmless.
+		int samples = decoder->getSize() / framesize;
+		return std::max(samples - offset, 0) / rate;
+	}
+	case TYPE_QUEUE:
+	{
+		if (callbackBuffer != AL_NONE)
+			return -1.0;
+
+		// Every queued ring block is full.
+		if (ringBuffer != nullptr)
+			return std::max(ringBlockSize / framesize - offset, 0) / rate;
+
+		ALint queued = 0;
+		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+
+		if (queued <= 0)
+			return 0.0;
+
+		// Queued buffers can have any size, so aim for roughly one free
+		// buffer per update.
+		int samples = bufferedBytes / framesize;
+		return std::max(samples - offset, 0) / rate / queued;
+	}
+	case TYPE_COMPRESSED:
+	case TYPE_MAX_ENUM:
+		break;
+	}
+
+	return -1.0;
+}
+
 void Source::setPitch(float pitch)
 {
+	// The virtual position so far was at the old pitch.
+	if (virtualVoice && !virtualPaused)
+	{
+		virtualStartOffset = getVirtualOffset(false);
+		virtualStartTime = love::timer::Timer::getTime();
+	}
+
 	if (valid)
+	{
 		alSourcef(source, AL_PITCH, pitch);
 
+		// Buffers play for a different length of time now.
+		pool->wake();
+	}
+
 	this->pitch = pitch;
 }
 
@@ -526,6 +710,14 @@ void Source::seek(double offset, Source::Unit unit)
 		break;
 	}
 
+	if (virtualVoice)
+	{
+		// Streams are seeked when they get an OpenAL source again.
+		virtualStartOffset = offsetSeconds;
+		virtualStartTime = love::timer::Timer::getTime();
+		return;
+	}
+
 	bool wasPlaying = isPlaying();
 	switch (sourceType)
 	{
@@ -542,7 +734,7 @@ void Source::seek(double offset, Source::Unit unit)
 			if (valid)
 				stop();
 
-			decoder->seek(offsetSeconds);
+			reader->seek(offsetSeconds);
 
 			if (wasPlaying)
 				play();
@@ -550,7 +742,10 @@ void Source::seek(double offset, Source::Unit unit)
 			break;
 		}
 		case TYPE_QUEUE:
-			if (valid)
+			// Ring buffered audio is discarded as soon as it's played.
+			if (ringBuffer != nullptr)
+				offsetSamples = 0;
+			else if (valid)
 			{
 				alSourcei(source, AL_SAMPLE_OFFSET, offsetSamples);
 				offsetSamples = offsetSeconds = 0;
@@ -576,6 +771,7 @@ void Source::seek(double offset, Source::Unit unit)
 				offsetSeconds = offsetSamples / (double) sampleRate;
 			}
 			break;
+		case TYPE_COMPRESSED:
 		case TYPE_MAX_ENUM:
 			break;
 	}
@@ -589,12 +785,21 @@ void Source::seek(double offset, Source::Unit unit)
 	}
 
 	this->offsetSamples = offsetSamples;
+
+	if (valid)
+		pool->wake();
 }
 
 double Source::tell(Source::Unit unit)
 {
 	Lock l = pool->lock();
 
+	if (virtualVoice)
+	{
+		double seconds = getVirtualOffset(true);
+		return unit == UNIT_SECONDS ? seconds : std::floor(seconds * sampleRate);
+	}
+
 	int offset = 0;
 
 	if (valid)
@@ -626,7 +831,7 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
-		double seconds = decoder->getDuration();
+		double seconds = reader->getDuration();
 
 		if (unit == UNIT_SECONDS)
 			return seconds;
@@ -637,11 +842,15 @@ double Source::getDuration(Unit unit)
 	{
 		ALsizei samples = (bufferedBytes / channels) / (bitDepth / 8);
 
+		if (ringBuffer != nullptr)
+			samples = (ALsizei) (ringBuffer->getReadSpace() / (channels * (bitDepth / 8)));
+
 		if (unit == UNIT_SAMPLES)
 			return (double)samples;
 		else
 			return (double)samples / (double)sampleRate;
 	}
+	case TYPE_COMPRESSED:
 	case TYPE_MAX_ENUM:
 		return 0.0;
 	}
@@ -771,8 +980,16 @@ void Source::setLooping(bool enable)
 		throw QueueLoopingException();
 
 	if (valid && sourceType == TYPE_STATIC)
+	{
 		alSourcei(source, AL_LOOPING, enable ? AL_TRUE : AL_FALSE);
 
+		// The end of the source might need to be noticed now.
+		pool->wake();
+	}
+
+	if (sourceType == TYPE_STREAM)
+		reader->setLooping(enable);
+
 	looping = enable;
 }
 
@@ -795,6 +1012,17 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	if (length == 0)
 		return true;
 
+	// The ring is lock-free, so it can be filled from another thread while
+	// the Pool is updating.
+	if (ringBuffer != nullptr)
+	{
+		if (ringBuffer->getWriteSpace() < length)
+			return false;
+
+		ringBuffer->write(data, length);
+		return true;
+	}
+
 	Lock l = pool->lock();
 
 	if (unusedBuffers.empty())
@@ -806,7 +1034,10 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	bufferedBytes += length;
 
 	if (valid)
+	{
 		alSourceQueueBuffers(source, 1, &buffer);
+		pool->wake();
+	}
 	else
 		streamBuffers.push(buffer);
 
@@ -822,13 +1053,143 @@ int Source::getFreeBufferCount() const
 	case TYPE_STREAM:
 		return unusedBuffers.size();
 	case TYPE_QUEUE:
+		if (ringBuffer != nullptr)
+			return (int) (ringBuffer->getWriteSpace() / ringBlockSize);
 		return unusedBuffers.size();
+	case TYPE_COMPRESSED:
 	case TYPE_MAX_ENUM:
 		return 0;
 	}
 	return 0;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+bool Source::isVirtual() const
+{
+	return virtualVoice;
+}
+
+float Source::getAudibility(const float *listenerPosition) const
+{
+	float gain = std::min(std::max(volume, minVolume), maxVolume);
+
+	// Only mono sources are spatialized.
+	if (channels > 1)
+		return gain;
+
+	float d[3];
+	for (int i = 0; i < 3; i++)
+		d[i] = relative ? position[i] : position[i] - listenerPosition[i];
+
+	float distance = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+	// Roughly the default inverse clamped distance model.
+	float ref = std::max(referenceDistance, 0.0001f);
+	distance = std::min(std::max(distance, ref), std::max(maxDistance, ref));
+
+	return gain * ref / (ref + rolloffFactor * (distance - ref));
+}
+
+double Source::getVirtualDuration() const
+{
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+		return (staticBuffer->getSize() / (channels * (bitDepth / 8))) / (double) sampleRate;
+	case TYPE_STREAM:
+		return reader->getDuration();
+	default:
+		return -1.0;
+	}
+}
+
+double Source::getVirtualOffset(bool wrap) const
+{
+	double offset = virtualStartOffset;
+
+	if (!virtualPaused)
+		offset += (love::timer::Timer::getTime() - virtualStartTime) * pitch;
+
+	if (wrap && isLooping())
+	{
+		double duration = getVirtualDuration();
+		if (duration > 0.0)
+			offset = fmod(offset, duration);
+	}
+
+	return offset;
+}
+
+bool Source::isVirtualFinished() const
+{
+	if (!virtualVoice || isLooping())
+		return false;
+
+	// Streams of unknown length finish once they're heard again.
+	double duration = getVirtualDuration();
+	return duration >= 0.0 && getVirtualOffset(false) >= duration;
+}
+
+void Source::startVirtualAtomic()
+{
+	virtualVoice = true;
+	virtualPaused = false;
+	virtualStartOffset = offsetSamples / (double) sampleRate;
+	virtualStartTime = love::timer::Timer::getTime();
+}
+
+void Source::virtualizeAtomic()
+{
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	double seconds = (offset + offsetSamples) / (double) sampleRate;
+
+	stopAtomic();
+
+	virtualVoice = true;
+	virtualPaused = state == AL_PAUSED;
+	virtualStartOffset = seconds;
+	virtualStartTime = love::timer::Timer::getTime();
+}
+
+bool Source::devirtualizeAtomic(ALuint source)
+{
+	double seconds = getVirtualOffset(true);
+
+	virtualVoice = false;
+	virtualPaused = false;
+
+	if (sourceType == TYPE_STREAM)
+		reader->seek(seconds);
+
+	offsetSamples = (int) (seconds * sampleRate);
+
+	return valid = playAtomic(source);
+}
+
+void Source::stopVirtualAtomic()
+{
+	virtualVoice = false;
+	virtualPaused = false;
+	offsetSamples = 0;
+
+	if (sourceType == TYPE_STREAM)
+		reader->rewind();
+}
+
 void Source::prepareAtomic()
 {
 	// This Source may now be associated with an OpenAL source that still has
@@ -845,18 +1206,31 @@ void Source::prepareAtomic()
 		while (!unusedBuffers.empty())
 		{
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b, true) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
 
-			if (decoder->isFinished())
+			if (reader->isFinished())
 				break;
 		}
 		break;
 	case TYPE_QUEUE:
 	{
+		if (callbackBuffer != AL_NONE)
+			alSourcei(source, AL_BUFFER, callbackBuffer);
+		else if (ringBuffer != nullptr)
+		{
+			while (!unusedBuffers.empty())
+			{
+				auto b = unusedBuffers.top();
+				streamRingAtomic(b);
+				alSourceQueueBuffers(source, 1, &b);
+				unusedBuffers.pop();
+			}
+		}
+
 		while (!streamBuffers.empty())
 		{
 			alSourceQueueBuffers(source, 1, &streamBuffers.front());
@@ -864,6 +1238,7 @@ void Source::prepareAtomic()
 		}
 		break;
 	}
+	case TYPE_COMPRESSED:
 	case TYPE_MAX_ENUM:
 		break;
 	}
@@ -884,7 +1259,7 @@ void Source::teardownAtomic()
 		ALuint buffers[MAX_BUFFERS];
 
 		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		reader->rewind();
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -902,6 +1277,13 @@ void Source::teardownAtomic()
 		ALint queued;
 		ALuint buffers[MAX_BUFFERS];
 
+		// Stopping discards queued audio, and the mixer has stopped reading.
+		if (ringBuffer != nullptr)
+			ringBuffer->clear();
+
+		if (callbackBuffer != AL_NONE)
+			break;
+
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
 		alSourceUnqueueBuffers(source, queued, buffers);
 
@@ -909,6 +1291,7 @@ void Source::teardownAtomic()
 			unusedBuffers.push(buffers[i]);
 		break;
 	}
+	case TYPE_COMPRESSED:
 	case TYPE_MAX_ENUM:
 		break;
 	}
@@ -962,7 +1345,15 @@ void Source::stopAtomic()
 
 void Source::pauseAtomic()
 {
-	if (valid)
+	if (virtualVoice)
+	{
+		if (!virtualPaused)
+		{
+			virtualStartOffset = getVirtualOffset(false);
+			virtualPaused = true;
+		}
+	}
+	else if (valid)
 		alSourcePause(source);
 }
 
@@ -989,12 +1380,28 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	// NOTE: not bool, because std::vector<bool> is implemented as a bitvector
 	// which means no bool references can be created.
 	std::vector<char> wasPlaying(sources.size());
+	std::vector<char> isVirtual(sources.size());
 	std::vector<ALuint> ids(sources.size());
 
 	for (size_t i = 0; i < sources.size(); i++)
 	{
-		if (!pool->assignSource((Source*) sources[i], ids[i], wasPlaying[i]))
+		Source *source = (Source*) sources[i];
+
+		if (source->virtualVoice)
+		{
+			wasPlaying[i] = isVirtual[i] = true;
+			continue;
+		}
+
+		if (!pool->assignSource(source, ids[i], wasPlaying[i]))
 		{
+			if (source->canVirtualize())
+			{
+				pool->addVirtualSource(source);
+				isVirtual[i] = true;
+				continue;
+			}
+
 			for (size_t j = 0; j < i; j++)
 				if (!wasPlaying[j])
 					pool->releaseSource((Source*) sources[j], false);
@@ -1006,6 +1413,17 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	toPlay.reserve(sources.size());
 	for (size_t i = 0; i < sources.size(); i++)
 	{
+		if (isVirtual[i])
+		{
+			Source *source = (Source*) sources[i];
+			if (source->virtualPaused)
+			{
+				source->virtualPaused = false;
+				source->virtualStartTime = love::timer::Timer::getTime();
+			}
+			continue;
+		}
+
 		// If the source was paused, wasPlaying[i] will be true but we still
 		// want to resume it. We don't want to call alSourcePlay on sources
 		// that are actually playing though.
@@ -1022,13 +1440,22 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 		toPlay.push_back(ids[i]);
 	}
 
-	alGetError();
-	alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
-	bool success = alGetError() == AL_NO_ERROR;
+	bool success = true;
+	if (!toPlay.empty())
+	{
+		alGetError();
+		alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
+		success = alGetError() == AL_NO_ERROR;
+	}
+
+	pool->wake();
 
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		if (source->virtualVoice)
+			continue;
+
 		source->valid = source->valid || success;
 
 		if (success && source->sourceType != TYPE_STREAM)
@@ -1055,7 +1482,8 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 			sourceIds.push_back(source->source);
 	}
 
-	alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
 
 	for (auto &_source : sources)
 	{
@@ -1082,7 +1510,50 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 			sourceIds.push_back(source->source);
 	}
 
-	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
+
+	for (auto &_source : sources)
+	{
+		Source *source = (Source*) _source;
+		if (source->virtualVoice)
+			source->pauseAtomic();
+	}
+}
+
+void Source::setTransforms(const std::vector<love::audio::Source*> &sources, const float *data, int components)
+{
+	if (components != 3 && components != 6)
+		throw love::Exception("Source transforms must have 3 or 6 components.");
+
+	for (auto &_source : sources)
+	{
+		if (((Source *) _source)->channels > 1)
+			throw SpatialSupportException();
+	}
+
+	if (sources.empty())
+		return;
+
+	Pool *pool = ((Source *) sources[0])->pool;
+	Lock l = pool->lock();
+
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		Source *source = (Source *) sources[i];
+		const float *v = data + i * components;
+
+		if (source->valid)
+			alSourcefv(source->source, AL_POSITION, v);
+		source->setFloatv(source->position, v);
+
+		if (components == 6)
+		{
+			if (source->valid)
+				alSourcefv(source->source, AL_VELOCITY, v + 3);
+			source->setFloatv(source->velocity, v + 3);
+		}
+	}
 }
 
 std::vector<love::audio::Source*> Source::pause(Pool *pool)
@@ -1144,22 +1615,29 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer, bool wait)
 {
-	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	// Get more sound data. It's normally decoded ahead of time by the Pool's
+	// decoding threads.
+	StreamReader::Chunk chunk;
+	if (!reader->peek(chunk, wait))
+		return 0;
+
+	int decoded = chunk.size;
 
 	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
 	if (decoded > 0)
 	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+		int fmt = Audio::getFormat(bitDepth, channels);
 
 		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
+			alBufferData(buffer, fmt, chunk.data, decoded, sampleRate);
 		else
 			decoded = 0;
 	}
 
+	reader->pop();
+
 	// This shouldn't run after toLoop is calculated in this streamAtomic call,
 	// otherwise it'll decrease too quickly.
 	// TODO: this code is hard to understand, can it be made more clear?
@@ -1173,7 +1651,8 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 		}
 	}
 
-	if (decoder->isFinished() && isLooping())
+	// The decoder was already rewound by the reader.
+	if (chunk.loopEnd)
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1182,12 +1661,56 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
 	}
 
 	return decoded;
 }
 
+void Source::initRingBuffer(int ringSamples)
+{
+	int framesize = channels * (bitDepth / 8);
+
+	ringBuffer = new RingBuffer((size_t) ringSamples * framesize);
+
+	// Without the callback extension the ring is split across the streaming
+	// buffers, so latency is roughly the ring's length either way.
+	ringBlockSize = std::max(ringSamples / buffers, 1) * framesize;
+
+	alGenBuffers(1, &callbackBuffer);
+	if (alGetError() != AL_NO_ERROR)
+		callbackBuffer = AL_NONE;
+	else if (!audiomodule()->setBufferCallback(callbackBuffer, Audio::getFormat(bitDepth, channels), sampleRate, ringBufferCallback, this))
+	{
+		alDeleteBuffers(1, &callbackBuffer);
+		callbackBuffer = AL_NONE;
+	}
+
+	if (callbackBuffer == AL_NONE)
+		ringBlockData.resize(ringBlockSize);
+}
+
+void Source::fillRingData(void *dst, size_t size)
+{
+	size_t read = ringBuffer->read(dst, size);
+
+	// Underruns play silence rather than stopping the Source.
+	if (read < size)
+		memset((char *) dst + read, bitDepth == 8 ? 128 : 0, size - read);
+}
+
+void Source::streamRingAtomic(ALuint buffer)
+{
+	fillRingData(ringBlockData.data(), ringBlockSize);
+	alBufferData(buffer, Audio::getFormat(bitDepth, channels), ringBlockData.data(), ringBlockSize, sampleRate);
+}
+
+ALsizei AL_APIENTRY Source::ringBufferCallback(ALvoid *userptr, ALvoid *data, ALsizei size)
+{
+	// Runs on OpenAL's mixing thread.
+	((Source *) userptr)->fillRingData(data, (size_t) size);
+	return size;
+}
+
 void Source::setMinVolume(float volume)
 {
 	if (valid)
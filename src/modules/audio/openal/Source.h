@@ -30,6 +30,8 @@
 #include "sound/Decoder.h"
 #include "Audio.h"
 #include "Filter.h"
+#include "StreamReader.h"
+#include "RingBuffer.h"
 
 // STL
 #include <vector>
@@ -99,8 +101,9 @@ class Source : public love::audio::Source
 public:
 
 	Source(Pool *pool, love::sound::SoundData *soundData);
-	Source(Pool *pool, love::sound::Decoder *decoder);
-	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers);
+	Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels);
+	Source(Pool *pool, love::sound::Decoder *decoder, bool compressed = false);
+	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers, int ringSamples);
 	Source(const Source &s);
 	virtual ~Source();
 
@@ -157,6 +160,15 @@ public:
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
 
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+	virtual bool isVirtual() const;
+
+	inline StaticDataBuffer *getStaticBuffer() const
+	{
+		return staticBuffer.get();
+	}
+
 	void prepareAtomic();
 	void teardownAtomic();
 
@@ -165,20 +177,74 @@ public:
 	void pauseAtomic();
 	void resumeAtomic();
 
+	/**
+	 * Seconds until this Source's playing buffers need to be updated again,
+	 * or a negative value if it doesn't need an update until its state is
+	 * changed. Must be called with the Pool locked.
+	 **/
+	double getTimeUntilUpdate() const;
+
+	/**
+	 * Estimates how loud this Source is at the listener's position, from its
+	 * volume and distance attenuation.
+	 **/
+	float getAudibility(const float *listenerPosition) const;
+
+	/**
+	 * Moves a playing or paused Source off its OpenAL source, keeping its
+	 * playback position going by the clock. Must be called with the Pool
+	 * locked, and the Pool's lists updated by the caller.
+	 **/
+	void virtualizeAtomic();
+
+	/**
+	 * Starts a virtual Source on the given OpenAL source from where it would
+	 * be by now.
+	 **/
+	bool devirtualizeAtomic(ALuint source);
+
+	/**
+	 * Starts playing virtually from the current offset, for when no OpenAL
+	 * source could be assigned.
+	 **/
+	void startVirtualAtomic();
+
+	// Queueable sources have no way to reproduce data they've skipped.
+	bool canVirtualize() const { return sourceType != TYPE_QUEUE; }
+	bool isVirtualFinished() const;
+
 	static bool play(const std::vector<love::audio::Source*> &sources);
 	static void stop(const std::vector<love::audio::Source*> &sources);
 	static void pause(const std::vector<love::audio::Source*> &sources);
 
+	// Every Source is checked before any are changed. The caller holds the
+	// pool lock.
+	static void setTransforms(const std::vector<love::audio::Source*> &sources, const float *data, int components);
+
 	static std::vector<love::audio::Source*> pause(Pool *pool);
 	static void stop(Pool *pool);
 
 private:
 
+	friend class Pool;
+
+	// Virtual playback position.
+	double getVirtualOffset(bool wrap) const;
+	double getVirtualDuration() const;
+	void stopVirtualAtomic();
+
 	void reset();
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	int streamAtomic(ALuint buffer, bool wait);
+
+	void initRingBuffer(int ringSamples);
+	void streamRingAtomic(ALuint buffer);
+	void fillRingData(void *dst, size_t size);
+
+	// Called by OpenAL's mixer when the callback buffer extension is used.
+	static ALsizei AL_APIENTRY ringBufferCallback(ALvoid *userptr, ALvoid *data, ALsizei size);
 
 	Pool *pool = nullptr;
 	ALuint source = 0;
@@ -215,16 +281,34 @@ private:
 
 	int offsetSamples = 0;
 
+	int priority = 0;
+
+	// Playing (or paused) without an OpenAL source, with the playback
+	// position advanced by the clock instead.
+	bool virtualVoice = false;
+	bool virtualPaused = false;
+	double virtualStartTime = 0.0;
+	double virtualStartOffset = 0.0;
+
 	int sampleRate = 0;
 	int channels = 0;
 	int bitDepth = 0;
 
 	StrongRef<love::sound::Decoder> decoder;
+	StrongRef<StreamReader> reader;
 
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
 
+	// Low latency queueable Sources are fed through a lock-free ring, which
+	// OpenAL either reads from directly via a callback buffer, or which is
+	// copied into streaming buffers of ringBlockSize bytes by the Pool.
+	RingBuffer *ringBuffer = nullptr;
+	ALuint callbackBuffer = AL_NONE;
+	int ringBlockSize = 0;
+	std::vector<char> ringBlockData;
+
 	Filter *directfilter = nullptr;
 
 	struct EffectMapStorage
@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "StreamReader.h"
+#include "Pool.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+StreamReader::StreamReader(Pool *pool, love::sound::Decoder *decoder, int chunkCount)
+	: queued(false)
+	, pool(pool)
+	, decoder(decoder)
+	, readIndex(0)
+	, count(0)
+	, decoderFinished(false)
+	, looping(false)
+{
+	slots.resize(std::max(chunkCount, 1));
+
+	for (Slot &slot : slots)
+		slot.data.resize(decoder->getSize());
+}
+
+StreamReader::~StreamReader()
+{
+}
+
+bool StreamReader::peek(Chunk &chunk, bool wait)
+{
+	if (wait)
+	{
+		bool empty = false;
+		{
+			thread::Lock lock(mutex);
+			empty = count == 0 && !decoderFinished;
+		}
+
+		if (empty)
+		{
+			thread::Lock lock(decodeMutex);
+			decodeAtomic();
+		}
+	}
+
+	thread::Lock lock(mutex);
+
+	if (count == 0)
+		return false;
+
+	const Slot &slot = slots[readIndex];
+
+	chunk.data = slot.data.data();
+	chunk.size = slot.size;
+	chunk.loopEnd = slot.loopEnd;
+
+	return true;
+}
+
+void StreamReader::pop()
+{
+	{
+		thread::Lock lock(mutex);
+
+		if (count == 0)
+			return;
+
+		readIndex = (readIndex + 1) % (int) slots.size();
+		count--;
+	}
+
+	pool->queueRead(this);
+}
+
+void StreamReader::rewind()
+{
+	{
+		thread::Lock lock(decodeMutex);
+		decoder->rewind();
+		discardAtomic();
+	}
+
+	pool->queueRead(this);
+}
+
+void StreamReader::seek(double seconds)
+{
+	{
+		thread::Lock lock(decodeMutex);
+		decoder->seek(seconds);
+		discardAtomic();
+	}
+
+	pool->queueRead(this);
+}
+
+double StreamReader::getDuration()
+{
+	thread::Lock lock(decodeMutex);
+	return decoder->getDuration();
+}
+
+bool StreamReader::isFinished() const
+{
+	thread::Lock lock(mutex);
+	return decoderFinished && count == 0;
+}
+
+void StreamReader::setLooping(bool enable)
+{
+	looping = enable;
+
+	if (!enable)
+		return;
+
+	bool restart = false;
+
+	{
+		thread::Lock lock(decodeMutex);
+
+		{
+			thread::Lock innerlock(mutex);
+			restart = decoderFinished;
+		}
+
+		// The end was already reached, so looping has to start over here.
+		if (restart)
+		{
+			decoder->rewind();
+
+			thread::Lock innerlock(mutex);
+			decoderFinished = false;
+		}
+	}
+
+	if (restart)
+		pool->queueRead(this);
+}
+
+void StreamReader::decodeNext()
+{
+	thread::Lock lock(decodeMutex);
+	decodeAtomic();
+}
+
+bool StreamReader::needsDecode() const
+{
+	thread::Lock lock(mutex);
+	return count < (int) slots.size() && !decoderFinished;
+}
+
+void StreamReader::decodeAtomic()
+{
+	int index = 0;
+	{
+		thread::Lock lock(mutex);
+
+		if (count == (int) slots.size() || decoderFinished)
+			return;
+
+		index = (readIndex + count) % (int) slots.size();
+	}
+
+	// This slot isn't in the ring yet, so nothing else reads it.
+	Slot &slot = slots[index];
+
+	int decoded = std::min(std::max(decoder->decode(), 0), (int) slot.data.size());
+	if (decoded > 0)
+		memcpy(slot.data.data(), decoder->getBuffer(), decoded);
+
+	slot.size = decoded;
+	slot.loopEnd = false;
+
+	bool finished = false;
+
+	if (decoder->isFinished())
+	{
+		if (looping)
+		{
+			decoder->rewind();
+			slot.loopEnd = true;
+		}
+		else
+			finished = true;
+	}
+
+	bool wasEmpty = false;
+	{
+		thread::Lock lock(mutex);
+
+		wasEmpty = count == 0;
+
+		// Empty chunks only matter when they mark a loop.
+		if (decoded > 0 || slot.loopEnd)
+			count++;
+
+		decoderFinished = finished;
+	}
+
+	// The audio thread might be waiting on this data.
+	if (wasEmpty)
+		pool->wake();
+}
+
+void StreamReader::discardAtomic()
+{
+	thread::Lock lock(mutex);
+
+	readIndex = 0;
+	count = 0;
+	decoderFinished = false;
+}
+
+} // openal
+} // audio
+} // love
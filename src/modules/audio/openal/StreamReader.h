@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_STREAM_READER_H
+#define LOVE_AUDIO_OPENAL_STREAM_READER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "sound/Decoder.h"
+
+// STD
+#include <atomic>
+#include <vector>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class Pool;
+
+/**
+ * Decodes a streaming Source's audio ahead of time on the Pool's decoding
+ * threads, into a ring of PCM chunks which the audio thread hands to OpenAL.
+ * A slow decoder then only delays its own Source, and the Pool's lock is
+ * never held while decoding.
+ **/
+class StreamReader : public love::Object
+{
+public:
+
+	struct Chunk
+	{
+		const void *data;
+		int size;
+
+		// The decoder was rewound to loop after this chunk.
+		bool loopEnd;
+	};
+
+	StreamReader(Pool *pool, love::sound::Decoder *decoder, int chunkCount);
+	virtual ~StreamReader();
+
+	/**
+	 * Gets the oldest decoded chunk, without removing it. If none is ready
+	 * and wait is true, one is decoded on the calling thread.
+	 * @return False if no chunk is ready.
+	 **/
+	bool peek(Chunk &chunk, bool wait);
+
+	/**
+	 * Removes the chunk returned by peek, so its space can be decoded into.
+	 **/
+	void pop();
+
+	/**
+	 * Discards decoded chunks and moves the decoder. These wait for a decode
+	 * in progress to finish.
+	 **/
+	void rewind();
+	void seek(double seconds);
+
+	double getDuration();
+
+	/**
+	 * Whether the end of the stream has been reached and all of its chunks
+	 * have been used.
+	 **/
+	bool isFinished() const;
+
+	void setLooping(bool looping);
+
+	/**
+	 * Decodes one chunk, if there's space for it. Called by the decoding
+	 * threads.
+	 **/
+	void decodeNext();
+
+	/**
+	 * Whether there's space for more chunks before the end of the stream.
+	 **/
+	bool needsDecode() const;
+
+	/**
+	 * Whether this reader is waiting in the Pool's decoding queue. Only
+	 * accessed with the decoding queue locked.
+	 **/
+	bool queued;
+
+private:
+
+	struct Slot
+	{
+		std::vector<char> data;
+		int size = 0;
+		bool loopEnd = false;
+	};
+
+	void decodeAtomic();
+	void discardAtomic();
+
+	Pool *pool;
+
+	StrongRef<love::sound::Decoder> decoder;
+
+	// Held while the decoder is used.
+	love::thread::MutexRef decodeMutex;
+
+	// Protects the ring's indices and flags. Slot contents are only written by
+	// the thread holding decodeMutex, and only read while they're in the ring.
+	love::thread::MutexRef mutex;
+
+	std::vector<Slot> slots;
+	int readIndex;
+	int count;
+
+	// The end of the stream has been decoded and it wasn't looping.
+	bool decoderFinished;
+
+	std::atomic<bool> looping;
+
+}; // StreamReader
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_STREAM_READER_H
@@ -21,6 +21,8 @@
 // LOVE
 #include "wrap_Audio.h"
 #include "filesystem/wrap_Filesystem.h"
+#include "filesystem/Filesystem.h"
+#include "data/DataModule.h"
 
 #include "openal/Audio.h"
 #include "null/Audio.h"
@@ -30,6 +32,7 @@
 // C++
 #include <iostream>
 #include <cmath>
+#include <string.h>
 
 namespace love
 {
@@ -44,9 +47,40 @@ int w_getActiveSourceCount(lua_State *L)
 	return 1;
 }
 
+// Gets a key identifying the decoded contents of a file, filename or FileData.
+static bool getSoundCacheKey(lua_State *L, int idx, std::string &key)
+{
+	using namespace love::filesystem;
+
+	if (luax_istype(L, idx, FileData::type))
+	{
+		FileData *fd = luax_totype<FileData>(L, idx);
+		key = "data:" + love::data::hash(love::data::HashFunction::FUNCTION_SHA1, fd);
+		return true;
+	}
+
+	std::string filename;
+	if (lua_isstring(L, idx))
+		filename = lua_tostring(L, idx);
+	else if (luax_istype(L, idx, File::type))
+		filename = luax_totype<File>(L, idx)->getFilename();
+	else
+		return false;
+
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	Filesystem::Info info = {};
+	if (fs == nullptr || !fs->getInfo(filename.c_str(), info) || info.type != Filesystem::FILETYPE_FILE)
+		return false;
+
+	// Include the modification time and size so edited files are reloaded.
+	key = "file:" + filename + ":" + std::to_string(info.modtime) + ":" + std::to_string(info.size);
+	return true;
+}
+
 int w_newSource(lua_State *L)
 {
 	Source::Type stype = Source::TYPE_STREAM;
+	std::string cacheKey;
 
 	if (!luax_istype(L, 1, love::sound::SoundData::type))
 	{
@@ -62,8 +96,22 @@ int w_newSource(lua_State *L)
 
 		if (love::filesystem::luax_cangetdata(L, 1))
 		{
-			// stream type
-			if (stype == Source::TYPE_STATIC)
+			if (stype == Source::TYPE_STATIC && getSoundCacheKey(L, 1, cacheKey))
+			{
+				Source *cached = nullptr;
+				luax_catchexcept(L, [&]() { cached = instance()->newCachedSource(cacheKey); });
+
+				if (cached != nullptr)
+				{
+					luax_pushtype(L, cached);
+					cached->release();
+					return 1;
+				}
+			}
+
+			// stream type. Compressed sources decode from the encoded data in
+			// memory, which their clones share.
+			if (stype == Source::TYPE_STATIC || stype == Source::TYPE_COMPRESSED)
 				lua_pushstring(L, "memory");
 			else if (!lua_isnone(L, 3))
 				lua_pushvalue(L, 3);
@@ -85,8 +133,12 @@ int w_newSource(lua_State *L)
 	Source *t = nullptr;
 
 	luax_catchexcept(L, [&]() {
-		if (luax_istype(L, 1, love::sound::SoundData::type))
+		if (luax_istype(L, 1, love::sound::SoundData::type) && !cacheKey.empty())
+			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1), cacheKey);
+		else if (luax_istype(L, 1, love::sound::SoundData::type))
 			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
+		else if (luax_istype(L, 1, love::sound::Decoder::type) && stype == Source::TYPE_COMPRESSED)
+			t = instance()->newCompressedSource(luax_totype<love::sound::Decoder>(L, 1));
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
 	});
@@ -107,9 +159,10 @@ int w_newQueueableSource(lua_State *L)
 	int bitdepth = (int) luaL_checkinteger(L, 2);
 	int channels = (int) luaL_checkinteger(L, 3);
 	int buffers = (int) luaL_optinteger(L, 4, 0);
+	int ringsamples = (int) luaL_optinteger(L, 5, 0);
 
 	Source *t = nullptr;
-	luax_catchexcept(L, [&]() { t = instance()->newSource(samplerate, bitdepth, channels, buffers); });
+	luax_catchexcept(L, [&]() { t = instance()->newSource(samplerate, bitdepth, channels, buffers, ringsamples); });
 
 	luax_pushtype(L, t);
 	t->release();
@@ -208,6 +261,70 @@ int w_pause(lua_State *L)
 	return 0;
 }
 
+int w_setSourceTransforms(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	std::vector<Source*> sources = readSourceList(L, 1);
+
+	int components = (int) luaL_optinteger(L, 3, 6);
+	if (components != 3 && components != 6)
+		return luaL_argerror(L, 3, "component count must be 3 or 6");
+
+	size_t count = sources.size() * components;
+	std::vector<float> data(count);
+
+	if (lua_istable(L, 2))
+	{
+		if (luax_objlen(L, 2) < count)
+			return luaL_error(L, "Expected %d values for %d Sources.", (int) count, (int) sources.size());
+
+		for (size_t i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, 2, (int) i + 1);
+			data[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		// Tightly packed floats, for example from the FFI.
+		love::Data *d = luax_checktype<love::Data>(L, 2);
+		if (d->getSize() < count * sizeof(float))
+			return luaL_error(L, "Expected %d floats for %d Sources.", (int) count, (int) sources.size());
+
+		if (count > 0)
+			memcpy(data.data(), d->getData(), count * sizeof(float));
+	}
+
+	luax_catchexcept(L, [&]() { instance()->setSourceTransforms(sources, data.data(), components); });
+	return 0;
+}
+
+int w_playOneShot(lua_State *L)
+{
+	love::sound::SoundData *s = luax_checktype<love::sound::SoundData>(L, 1);
+	float volume = (float) luaL_optnumber(L, 2, 1.0);
+	float pitch = (float) luaL_optnumber(L, 3, 1.0);
+
+	if (pitch <= 0.0f || std::isinf(pitch) || std::isnan(pitch))
+		return luaL_error(L, "Pitch has to be non-zero, positive, finite number.");
+
+	float v[3];
+	const float *position = nullptr;
+	if (!lua_isnoneornil(L, 4))
+	{
+		v[0] = (float) luaL_checknumber(L, 4);
+		v[1] = (float) luaL_checknumber(L, 5);
+		v[2] = (float) luaL_optnumber(L, 6, 0.0);
+		position = v;
+	}
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = instance()->playOneShot(s, volume, pitch, position); });
+	luax_pushboolean(L, success);
+	return 1;
+}
+
 int w_setVolume(lua_State *L)
 {
 	float v = (float)luaL_checknumber(L, 1);
@@ -507,6 +624,30 @@ int w_getEffect(lua_State *L)
 	return 1;
 }
 
+int w_setEffectTarget(lua_State *L)
+{
+	const char *namestr = luaL_checkstring(L, 1);
+	const char *targetstr = luaL_optstring(L, 2, nullptr);
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = instance()->setEffectTarget(namestr, targetstr); });
+
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_getEffectTarget(lua_State *L)
+{
+	const char *namestr = luaL_checkstring(L, 1);
+
+	std::string target;
+	if (!instance()->getEffectTarget(namestr, target))
+		return 0;
+
+	luax_pushstring(L, target);
+	return 1;
+}
+
 int w_getActiveEffects(lua_State *L)
 {
 	std::vector<std::string> list;
@@ -540,6 +681,12 @@ int w_isEffectsSupported(lua_State *L)
 	return 1;
 }
 
+int w_getOutputSampleRate(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getOutputSampleRate());
+	return 1;
+}
+
 int w_setOutputSpatialization(lua_State *L)
 {
 	bool enable = luax_checkboolean(L, 1);
@@ -627,6 +774,31 @@ int w_setPlaybackDevice(lua_State* L)
 	return 0;
 }
 
+int w_setSoundCacheLimit(lua_State *L)
+{
+	int64 bytes = (int64) luaL_checknumber(L, 1);
+	instance()->setSoundCacheLimit(bytes);
+	return 0;
+}
+
+int w_getSoundCacheLimit(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getSoundCacheLimit());
+	return 1;
+}
+
+int w_getSoundCacheSize(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getSoundCacheSize());
+	return 1;
+}
+
+int w_clearSoundCache(lua_State *)
+{
+	instance()->clearSoundCache();
+	return 0;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -636,6 +808,8 @@ static const luaL_Reg functions[] =
 	{ "play", w_play },
 	{ "stop", w_stop },
 	{ "pause", w_pause },
+	{ "setSourceTransforms", w_setSourceTransforms },
+	{ "playOneShot", w_playOneShot },
 	{ "setVolume", w_setVolume },
 	{ "getVolume", w_getVolume },
 	{ "setPosition", w_setPosition },
@@ -653,10 +827,13 @@ static const luaL_Reg functions[] =
 	{ "getRecordingDevices", w_getRecordingDevices },
 	{ "setEffect", w_setEffect },
 	{ "getEffect", w_getEffect },
+	{ "setEffectTarget", w_setEffectTarget },
+	{ "getEffectTarget", w_getEffectTarget },
 	{ "getActiveEffects", w_getActiveEffects },
 	{ "getMaxSceneEffects", w_getMaxSceneEffects },
 	{ "getMaxSourceEffects", w_getMaxSourceEffects },
 	{ "isEffectsSupported", w_isEffectsSupported },
+	{ "getOutputSampleRate", w_getOutputSampleRate },
 	{ "setOutputSpatialization", w_setOutputSpatialization },
 	{ "getOutputSpatialization", w_getOutputSpatialization },
 	{ "getOutputSpatializationFilters", w_getOutputSpatializationFilters },
@@ -664,6 +841,10 @@ static const luaL_Reg functions[] =
 	{ "getPlaybackDevice", w_getPlaybackDevice },
 	{ "getPlaybackDevices", w_getPlaybackDevices },
 	{ "setPlaybackDevice", w_setPlaybackDevice },
+	{ "setSoundCacheLimit", w_setSoundCacheLimit },
+	{ "getSoundCacheLimit", w_getSoundCacheLimit },
+	{ "getSoundCacheSize", w_getSoundCacheSize },
+	{ "clearSoundCache", w_clearSoundCache },
 
 	{ 0, 0 }
 };
@@ -22,6 +22,7 @@
 #include "wrap_Audio.h"
 
 #include "sound/SoundData.h"
+#include "thread/wrap_Channel.h"
 namespace love
 {
 namespace audio
@@ -136,6 +137,26 @@ int w_RecordingDevice_isRecording(lua_State *L)
 	return 1;
 }
 
+int w_RecordingDevice_setChannel(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	love::thread::Channel *channel = nullptr;
+	if (!lua_isnoneornil(L, 2))
+		channel = love::thread::luax_checkchannel(L, 2);
+	int blocksamples = (int) luaL_optinteger(L, 3, RecordingDevice::DEFAULT_BLOCK_SAMPLES);
+
+	luax_catchexcept(L, [&]() { d->setChannel(channel, blocksamples); });
+	return 0;
+}
+
+int w_RecordingDevice_getChannel(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	luax_pushtype(L, d->getChannel());
+	lua_pushinteger(L, d->getBlockSampleCount());
+	return 2;
+}
+
 static const luaL_Reg w_RecordingDevice_functions[] =
 {
 	{ "start", w_RecordingDevice_start },
@@ -147,6 +168,8 @@ static const luaL_Reg w_RecordingDevice_functions[] =
 	{ "getChannelCount", w_RecordingDevice_getChannelCount },
 	{ "getName", w_RecordingDevice_getName },
 	{ "isRecording", w_RecordingDevice_isRecording },
+	{ "setChannel", w_RecordingDevice_setChannel },
+	{ "getChannel", w_RecordingDevice_getChannel },
 	{ 0, 0 }
 };
 
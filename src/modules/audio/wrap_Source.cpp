@@ -261,6 +261,27 @@ int w_Source_isLooping(lua_State *L)
 	return 1;
 }
 
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	t->setPriority((int) luaL_checkinteger(L, 2));
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
+int w_Source_isVirtual(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	luax_pushboolean(L, t->isVirtual());
+	return 1;
+}
+
 int w_Source_isPlaying(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -631,6 +652,9 @@ static const luaL_Reg w_Source_functions[] =
 	{ "setLooping", w_Source_setLooping },
 	{ "isLooping", w_Source_isLooping },
 	{ "isPlaying", w_Source_isPlaying },
+	{ "setPriority", w_Source_setPriority },
+	{ "getPriority", w_Source_getPriority },
+	{ "isVirtual", w_Source_isVirtual },
 
 	{ "setVolumeLimits", w_Source_setVolumeLimits },
 	{ "getVolumeLimits", w_Source_getVolumeLimits },
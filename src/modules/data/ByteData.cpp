@@ -21,8 +21,10 @@
 #include "ByteData.h"
 #include "common/Exception.h"
 #include "common/int.h"
+#include "common/memory.h"
 
 #include <string.h>
+#include <atomic>
 
 namespace love
 {
@@ -31,6 +33,44 @@ namespace data
 
 love::Type ByteData::type("ByteData", &Data::type);
 
+template <typename T>
+static std::atomic<T> *toAtomic(void *p)
+{
+	static_assert(sizeof(std::atomic<T>) == sizeof(T), "Atomic values must have the same layout as plain values.");
+	return (std::atomic<T> *) p;
+}
+
+static std::memory_order getMemoryOrder(ByteData::AtomicOrder order)
+{
+	switch (order)
+	{
+	case ByteData::ATOMIC_ORDER_RELAXED: return std::memory_order_relaxed;
+	case ByteData::ATOMIC_ORDER_ACQUIRE: return std::memory_order_acquire;
+	case ByteData::ATOMIC_ORDER_RELEASE: return std::memory_order_release;
+	case ByteData::ATOMIC_ORDER_ACQREL: return std::memory_order_acq_rel;
+	case ByteData::ATOMIC_ORDER_SEQCST:
+	default: return std::memory_order_seq_cst;
+	}
+}
+
+static std::memory_order getLoadOrder(ByteData::AtomicOrder order)
+{
+	if (order == ByteData::ATOMIC_ORDER_RELEASE)
+		return std::memory_order_relaxed;
+	if (order == ByteData::ATOMIC_ORDER_ACQREL)
+		return std::memory_order_acquire;
+	return getMemoryOrder(order);
+}
+
+static std::memory_order getStoreOrder(ByteData::AtomicOrder order)
+{
+	if (order == ByteData::ATOMIC_ORDER_ACQUIRE)
+		return std::memory_order_relaxed;
+	if (order == ByteData::ATOMIC_ORDER_ACQREL)
+		return std::memory_order_release;
+	return getMemoryOrder(order);
+}
+
 ByteData::ByteData(size_t size, bool clear)
 	: size(size)
 {
@@ -51,7 +91,10 @@ ByteData::ByteData(void *d, size_t size, bool own)
 	: size(size)
 {
 	if (own)
+	{
 		data = (char *) d;
+		trackAllocation(MEMORY_DATA, size);
+	}
 	else
 	{
 		create();
@@ -69,6 +112,8 @@ ByteData::ByteData(const ByteData &d)
 
 ByteData::~ByteData()
 {
+	if (data != nullptr)
+		trackDeallocation(MEMORY_DATA, size);
 	delete[] data;
 }
 
@@ -85,6 +130,92 @@ void ByteData::create()
 	{
 		throw love::Exception("Out of memory.");
 	}
+
+	trackAllocation(MEMORY_DATA, size);
+}
+
+ByteData *ByteData::transfer()
+{
+	trackDeallocation(MEMORY_DATA, size);
+	ByteData *d = new ByteData(data, size, true);
+	data = nullptr;
+	size = 0;
+	return d;
+}
+
+void *ByteData::getAtomicPointer(AtomicType type, size_t offset) const
+{
+	size_t valuesize = 4;
+
+	if (type != ATOMIC_INT32 && type != ATOMIC_UINT32)
+		throw love::Exception("Invalid atomic value type.");
+
+	if (data == nullptr || offset > size || size - offset < valuesize || ((uintptr_t) data + offset) % valuesize != 0)
+		throw love::Exception("The given offset must be within the ByteData and aligned to the size of the value.");
+
+	return data + offset;
+}
+
+int64 ByteData::atomicLoad(AtomicType type, size_t offset, AtomicOrder order) const
+{
+	void *p = getAtomicPointer(type, offset);
+
+	if (type == ATOMIC_INT32)
+		return toAtomic<int32>(p)->load(getLoadOrder(order));
+	else
+		return toAtomic<uint32>(p)->load(getLoadOrder(order));
+}
+
+void ByteData::atomicStore(AtomicType type, size_t offset, int64 value, AtomicOrder order)
+{
+	void *p = getAtomicPointer(type, offset);
+
+	if (type == ATOMIC_INT32)
+		toAtomic<int32>(p)->store((int32) value, getStoreOrder(order));
+	else
+		toAtomic<uint32>(p)->store((uint32) value, getStoreOrder(order));
+}
+
+int64 ByteData::atomicAdd(AtomicType type, size_t offset, int64 value, AtomicOrder order)
+{
+	void *p = getAtomicPointer(type, offset);
+
+	// Signed overflow wraps around, the same as unsigned.
+	if (type == ATOMIC_INT32)
+		return (int32) toAtomic<uint32>(p)->fetch_add((uint32) value, getMemoryOrder(order));
+	else
+		return toAtomic<uint32>(p)->fetch_add((uint32) value, getMemoryOrder(order));
+}
+
+int64 ByteData::atomicExchange(AtomicType type, size_t offset, int64 value, AtomicOrder order)
+{
+	void *p = getAtomicPointer(type, offset);
+
+	if (type == ATOMIC_INT32)
+		return toAtomic<int32>(p)->exchange((int32) value, getMemoryOrder(order));
+	else
+		return toAtomic<uint32>(p)->exchange((uint32) value, getMemoryOrder(order));
+}
+
+bool ByteData::atomicCompareExchange(AtomicType type, size_t offset, int64 &expected, int64 desired, AtomicOrder order)
+{
+	void *p = getAtomicPointer(type, offset);
+	bool success = false;
+
+	if (type == ATOMIC_INT32)
+	{
+		int32 value = (int32) expected;
+		success = toAtomic<int32>(p)->compare_exchange_strong(value, (int32) desired, getMemoryOrder(order), getLoadOrder(order));
+		expected = value;
+	}
+	else
+	{
+		uint32 value = (uint32) expected;
+		success = toAtomic<uint32>(p)->compare_exchange_strong(value, (uint32) desired, getMemoryOrder(order), getLoadOrder(order));
+		expected = value;
+	}
+
+	return success;
 }
 
 ByteData *ByteData::clone() const
@@ -102,5 +233,22 @@ size_t ByteData::getSize() const
 	return size;
 }
 
+STRINGMAP_CLASS_BEGIN(ByteData, ByteData::AtomicType, ByteData::ATOMIC_MAX_ENUM, atomicType)
+{
+	{ "int32",  ByteData::ATOMIC_INT32  },
+	{ "uint32", ByteData::ATOMIC_UINT32 },
+}
+STRINGMAP_CLASS_END(ByteData, ByteData::AtomicType, ByteData::ATOMIC_MAX_ENUM, atomicType)
+
+STRINGMAP_CLASS_BEGIN(ByteData, ByteData::AtomicOrder, ByteData::ATOMIC_ORDER_MAX_ENUM, atomicOrder)
+{
+	{ "relaxed", ByteData::ATOMIC_ORDER_RELAXED },
+	{ "acquire", ByteData::ATOMIC_ORDER_ACQUIRE },
+	{ "release", ByteData::ATOMIC_ORDER_RELEASE },
+	{ "acqrel",  ByteData::ATOMIC_ORDER_ACQREL  },
+	{ "seqcst",  ByteData::ATOMIC_ORDER_SEQCST  },
+}
+STRINGMAP_CLASS_END(ByteData, ByteData::AtomicOrder, ByteData::ATOMIC_ORDER_MAX_ENUM, atomicOrder)
+
 } // data
 } // love
@@ -21,6 +21,8 @@
 #pragma once
 
 #include "common/Data.h"
+#include "common/int.h"
+#include "common/StringMap.h"
 
 #include <stddef.h>
 
@@ -35,20 +37,64 @@ public:
 
 	static love::Type type;
 
+	enum AtomicType
+	{
+		ATOMIC_INT32,
+		ATOMIC_UINT32,
+		ATOMIC_MAX_ENUM
+	};
+
+	enum AtomicOrder
+	{
+		ATOMIC_ORDER_RELAXED,
+		ATOMIC_ORDER_ACQUIRE,
+		ATOMIC_ORDER_RELEASE,
+		ATOMIC_ORDER_ACQREL,
+		ATOMIC_ORDER_SEQCST,
+		ATOMIC_ORDER_MAX_ENUM
+	};
+
 	ByteData(size_t size, bool clear = true);
 	ByteData(const void *d, size_t size);
 	ByteData(void *d, size_t size, bool own);
 	ByteData(const ByteData &d);
 	virtual ~ByteData();
 
+	/**
+	 * Moves this ByteData's memory into a new ByteData without copying it.
+	 * This ByteData is left empty.
+	 **/
+	ByteData *transfer();
+
+	/**
+	 * Atomic operations on values in this ByteData's memory, so threads which
+	 * share the ByteData can update it in place. The offset is in bytes and
+	 * must be aligned to the size of the value. Orders which don't apply to an
+	 * operation (such as acquire for a store) are weakened to ones which do.
+	 **/
+	int64 atomicLoad(AtomicType type, size_t offset, AtomicOrder order) const;
+	void atomicStore(AtomicType type, size_t offset, int64 value, AtomicOrder order);
+	int64 atomicAdd(AtomicType type, size_t offset, int64 value, AtomicOrder order);
+	int64 atomicExchange(AtomicType type, size_t offset, int64 value, AtomicOrder order);
+
+	/**
+	 * Replaces the value with desired if it's equal to expected. Returns
+	 * whether it was replaced. expected is set to the previous value.
+	 **/
+	bool atomicCompareExchange(AtomicType type, size_t offset, int64 &expected, int64 desired, AtomicOrder order);
+
 	// Implements Data.
 	ByteData *clone() const override;
 	void *getData() const override;
 	size_t getSize() const override;
 
+	STRINGMAP_CLASS_DECLARE(AtomicType);
+	STRINGMAP_CLASS_DECLARE(AtomicOrder);
+
 private:
 
 	void create();
+	void *getAtomicPointer(AtomicType type, size_t offset) const;
 
 	char *data;
 	size_t size;
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressJob.h"
+#include "DataModule.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace data
+{
+
+love::Type CompressJob::type("CompressJob", &Object::type);
+
+CompressJob::CompressJob(Compressor::Format format, Data *input, int level)
+	: format(format)
+	, input(input)
+	, level(level)
+	, complete(false)
+{
+}
+
+CompressJob::~CompressJob()
+{
+}
+
+bool CompressJob::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+void CompressJob::wait()
+{
+	love::thread::Lock lock(mutex);
+	while (!complete)
+		completeCond->wait(mutex);
+}
+
+CompressedData *CompressJob::getResult() const
+{
+	love::thread::Lock lock(mutex);
+	return result.get();
+}
+
+std::string CompressJob::getError() const
+{
+	love::thread::Lock lock(mutex);
+	return error;
+}
+
+void CompressJob::compress()
+{
+	CompressedData *data = nullptr;
+	std::string err;
+
+	try
+	{
+		data = love::data::compress(format, (const char *) input->getData(), input->getSize(), level);
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+	}
+
+	finish(data, err);
+
+	if (data != nullptr)
+		data->release();
+}
+
+void CompressJob::cancel()
+{
+	finish(nullptr, "The compression was cancelled.");
+}
+
+void CompressJob::finish(CompressedData *data, const std::string &err)
+{
+	love::thread::Lock lock(mutex);
+
+	result.set(data);
+	error = err;
+	complete = true;
+
+	// The input is no longer needed once the compression is done.
+	input.set(nullptr);
+
+	completeCond->broadcast();
+}
+
+} // data
+} // love
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "Compressor.h"
+#include "CompressedData.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * An in-flight compression of some Data, run on the shared job system. The
+ * input Data shouldn't be modified until the compression is complete.
+ **/
+class CompressJob : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	CompressJob(Compressor::Format format, Data *input, int level);
+	virtual ~CompressJob();
+
+	bool isComplete() const;
+
+	/**
+	 * Blocks until the compression has finished.
+	 **/
+	void wait();
+
+	/**
+	 * Returns the compressed data if the compression has finished and
+	 * succeeded, or null otherwise.
+	 **/
+	CompressedData *getResult() const;
+
+	/**
+	 * Returns the error message if the compression has finished and failed,
+	 * or an empty string otherwise.
+	 **/
+	std::string getError() const;
+
+	// Called by a worker thread.
+	void compress();
+	void cancel();
+
+private:
+
+	void finish(CompressedData *data, const std::string &err);
+
+	Compressor::Format format;
+	StrongRef<Data> input;
+	int level;
+
+	StrongRef<CompressedData> result;
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef completeCond;
+
+}; // CompressJob
+
+} // data
+} // love
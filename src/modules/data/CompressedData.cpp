@@ -21,6 +21,7 @@
 // LOVE
 #include "CompressedData.h"
 #include "common/Exception.h"
+#include "common/memory.h"
 
 namespace love
 {
@@ -50,6 +51,8 @@ CompressedData::CompressedData(Compressor::Format format, char *cdata, size_t co
 
 		memcpy(data, cdata, dataSize);
 	}
+
+	trackAllocation(MEMORY_DATA, dataSize);
 }
 
 CompressedData::CompressedData(const CompressedData &c)
@@ -68,10 +71,13 @@ CompressedData::CompressedData(const CompressedData &c)
 	}
 
 	memcpy(data, c.data, dataSize);
+
+	trackAllocation(MEMORY_DATA, dataSize);
 }
 
 CompressedData::~CompressedData()
 {
+	trackDeallocation(MEMORY_DATA, dataSize);
 	delete[] data;
 }
 
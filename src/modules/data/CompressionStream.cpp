@@ -0,0 +1,417 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressionStream.h"
+#include "common/Exception.h"
+#include "common/int.h"
+
+#include "libraries/lz4/lz4.h"
+#include "libraries/lz4/lz4hc.h"
+
+#include <zlib.h>
+
+// C++
+#include <algorithm>
+#include <limits>
+
+namespace love
+{
+namespace data
+{
+
+class zlibCompressionStream : public CompressionStream
+{
+public:
+
+	zlibCompressionStream(Mode mode, Compressor::Format format, int level)
+		: CompressionStream(mode, format)
+		, stream()
+	{
+		if (level < 0)
+			level = Z_DEFAULT_COMPRESSION;
+		else if (level > 9)
+			level = 9;
+
+		int err = Z_OK;
+
+		if (mode == MODE_COMPRESS)
+		{
+			int windowbits = 15;
+			if (format == Compressor::FORMAT_GZIP)
+				windowbits += 16; // This tells zlib to use a gzip header.
+			else if (format == Compressor::FORMAT_DEFLATE)
+				windowbits = -windowbits;
+
+			err = deflateInit2(&stream, level, Z_DEFLATED, windowbits, 8, Z_DEFAULT_STRATEGY);
+		}
+		else
+		{
+			// 15 is the default. Adding 32 makes zlib auto-detect the header type.
+			int windowbits = 15 + 32;
+			if (format == Compressor::FORMAT_DEFLATE)
+				windowbits = -15;
+
+			err = inflateInit2(&stream, windowbits);
+		}
+
+		if (err != Z_OK)
+			throw love::Exception("Could not create zlib/gzip stream (error code: %d).", err);
+	}
+
+	virtual ~zlibCompressionStream()
+	{
+		if (mode == MODE_COMPRESS)
+			deflateEnd(&stream);
+		else
+			inflateEnd(&stream);
+	}
+
+protected:
+
+	void pushInput(const char *data, size_t size, std::vector<char> &out) override
+	{
+		if (ended)
+			return;
+
+		// zlib's sizes are 32 bits.
+		const size_t maxinput = std::numeric_limits<uInt>::max();
+
+		do
+		{
+			size_t insize = std::min(size, maxinput);
+			run(data, insize, Z_NO_FLUSH, out);
+			data += insize;
+			size -= insize;
+		} while (size > 0 && !ended);
+	}
+
+	void finishInput(std::vector<char> &out) override
+	{
+		if (mode == MODE_COMPRESS)
+			run(nullptr, 0, Z_FINISH, out);
+		else if (!ended)
+			throw love::Exception("Could not decompress zlib/gzip stream: the data is incomplete.");
+	}
+
+private:
+
+	void run(const char *data, size_t size, int flush, std::vector<char> &out)
+	{
+		const size_t chunksize = 64 * 1024;
+
+		stream.next_in = (Bytef *) data;
+		stream.avail_in = (uInt) size;
+
+		// Keep going until zlib doesn't fill the whole output chunk, which
+		// means it has consumed all of the input.
+		do
+		{
+			size_t offset = out.size();
+			out.resize(offset + chunksize);
+
+			stream.next_out = (Bytef *) out.data() + offset;
+			stream.avail_out = (uInt) chunksize;
+
+			int err = Z_OK;
+			if (mode == MODE_COMPRESS)
+				err = deflate(&stream, flush);
+			else
+				err = inflate(&stream, flush);
+
+			out.resize(offset + chunksize - stream.avail_out);
+
+			if (err == Z_STREAM_END)
+			{
+				ended = true;
+				break;
+			}
+			else if (err != Z_OK && err != Z_BUF_ERROR)
+			{
+				const char *verb = mode == MODE_COMPRESS ? "compress" : "decompress";
+				throw love::Exception("Could not %s zlib/gzip stream (error code: %d).", verb, err);
+			}
+		} while (stream.avail_out == 0 || (flush == Z_FINISH && !ended));
+	}
+
+	z_stream stream;
+
+}; // zlibCompressionStream
+
+
+class LZ4CompressionStream : public CompressionStream
+{
+public:
+
+	LZ4CompressionStream(Mode mode, int level)
+		: CompressionStream(mode, Compressor::FORMAT_LZ4)
+		, level(level)
+	{
+	}
+
+	virtual ~LZ4CompressionStream()
+	{
+	}
+
+protected:
+
+	void pushInput(const char *data, size_t size, std::vector<char> &out) override
+	{
+		if (mode == MODE_COMPRESS)
+			compressInput(data, size, out);
+		else
+			decompressInput(data, size, out);
+	}
+
+	void finishInput(std::vector<char> &out) override
+	{
+		if (mode == MODE_COMPRESS)
+		{
+			if (!pending.empty())
+				compressBlock(pending.data(), pending.size(), out);
+			pending.clear();
+
+			// A zero-size block marks the end of the stream.
+			out.resize(out.size() + sizeof(uint32));
+			writeUint32(out.data() + out.size() - sizeof(uint32), 0);
+		}
+		else if (!ended)
+			throw love::Exception("Could not decompress LZ4 stream: the data is incomplete.");
+	}
+
+private:
+
+	// Each block is stored as its compressed size, its uncompressed size and
+	// then the compressed bytes.
+	static const size_t BLOCK_SIZE = 256 * 1024;
+	static const size_t BLOCK_HEADER_SIZE = sizeof(uint32) * 2;
+
+	static void writeUint32(char *dst, uint32 value)
+	{
+		// Stored little-endian.
+		for (int i = 0; i < 4; i++)
+			dst[i] = (char) ((value >> (i * 8)) & 0xFF);
+	}
+
+	static uint32 readUint32(const char *data)
+	{
+		const uint8 *bytes = (const uint8 *) data;
+		return (uint32) bytes[0] | ((uint32) bytes[1] << 8) | ((uint32) bytes[2] << 16) | ((uint32) bytes[3] << 24);
+	}
+
+	void compressInput(const char *data, size_t size, std::vector<char> &out)
+	{
+		// Top up a partially filled block first.
+		if (!pending.empty())
+		{
+			size_t count = std::min(size, BLOCK_SIZE - pending.size());
+			pending.insert(pending.end(), data, data + count);
+			data += count;
+			size -= count;
+
+			if (pending.size() < BLOCK_SIZE)
+				return;
+
+			compressBlock(pending.data(), pending.size(), out);
+			pending.clear();
+		}
+
+		// Full blocks are compressed straight from the input.
+		while (size >= BLOCK_SIZE)
+		{
+			compressBlock(data, BLOCK_SIZE, out);
+			data += BLOCK_SIZE;
+			size -= BLOCK_SIZE;
+		}
+
+		pending.insert(pending.end(), data, data + size);
+	}
+
+	void compressBlock(const char *data, size_t size, std::vector<char> &out)
+	{
+		int maxsize = LZ4_compressBound((int) size);
+
+		size_t offset = out.size();
+		out.resize(offset + BLOCK_HEADER_SIZE + maxsize);
+		char *dst = out.data() + offset + BLOCK_HEADER_SIZE;
+
+		// Use LZ4-HC for compression level 9 and higher.
+		int csize = 0;
+		if (level > 8)
+			csize = LZ4_compress_HC(data, dst, (int) size, maxsize, LZ4HC_CLEVEL_DEFAULT);
+		else
+			csize = LZ4_compress_default(data, dst, (int) size, maxsize);
+
+		if (csize <= 0)
+			throw love::Exception("Could not LZ4-compress data.");
+
+		writeUint32(out.data() + offset, (uint32) csize);
+		writeUint32(out.data() + offset + sizeof(uint32), (uint32) size);
+		out.resize(offset + BLOCK_HEADER_SIZE + csize);
+	}
+
+	void decompressInput(const char *data, size_t size, std::vector<char> &out)
+	{
+		if (ended)
+			return;
+
+		pending.insert(pending.end(), data, data + size);
+
+		size_t offset = 0;
+
+		while (pending.size() - offset >= sizeof(uint32))
+		{
+			const char *block = pending.data() + offset;
+			uint32 csize = readUint32(block);
+
+			if (csize == 0)
+			{
+				ended = true;
+				break;
+			}
+
+			if (pending.size() - offset < BLOCK_HEADER_SIZE + csize)
+				break;
+
+			uint32 rawsize = readUint32(block + sizeof(uint32));
+			if (rawsize > BLOCK_SIZE || csize > (uint32) LZ4_compressBound((int) BLOCK_SIZE))
+				throw love::Exception("Could not decompress LZ4 stream: invalid block size.");
+
+			size_t outoffset = out.size();
+			out.resize(outoffset + rawsize);
+
+			int result = LZ4_decompress_safe(block + BLOCK_HEADER_SIZE, out.data() + outoffset, (int) csize, (int) rawsize);
+			if (result < 0 || (uint32) result != rawsize)
+				throw love::Exception("Could not decompress LZ4-compressed data.");
+
+			offset += BLOCK_HEADER_SIZE + csize;
+		}
+
+		pending.erase(pending.begin(), pending.begin() + offset);
+	}
+
+	int level;
+
+	// Input that hasn't made up a whole block yet.
+	std::vector<char> pending;
+
+}; // LZ4CompressionStream
+
+
+love::Type CompressionStream::type("CompressionStream", &Object::type);
+
+CompressionStream *CompressionStream::create(Mode mode, Compressor::Format format, int level)
+{
+	switch (format)
+	{
+	case Compressor::FORMAT_LZ4:
+		return new LZ4CompressionStream(mode, level);
+	case Compressor::FORMAT_ZLIB:
+	case Compressor::FORMAT_GZIP:
+	case Compressor::FORMAT_DEFLATE:
+		return new zlibCompressionStream(mode, format, level);
+	default:
+		throw love::Exception("Invalid compression format.");
+	}
+}
+
+CompressionStream::CompressionStream(Mode mode, Compressor::Format format)
+	: mode(mode)
+	, format(format)
+	, ended(false)
+	, finished(false)
+{
+}
+
+CompressionStream::~CompressionStream()
+{
+}
+
+void CompressionStream::push(const char *data, size_t size, std::vector<char> &out)
+{
+	love::thread::Lock lock(mutex);
+
+	if (finished)
+		throw love::Exception("The CompressionStream has already been finished.");
+
+	if (size > 0)
+		pushInput(data, size, out);
+}
+
+void CompressionStream::finish(std::vector<char> &out)
+{
+	love::thread::Lock lock(mutex);
+
+	if (finished)
+		return;
+
+	finishInput(out);
+	finished = true;
+}
+
+bool CompressionStream::isFinished() const
+{
+	love::thread::Lock lock(mutex);
+	return finished || ended;
+}
+
+void CompressionStream::process(Stream *source, Stream *dest, size_t chunkSize)
+{
+	if (!source->isReadable())
+		throw love::Exception("The source stream must be readable.");
+
+	if (!dest->isWritable())
+		throw love::Exception("The destination stream must be writable.");
+
+	if (chunkSize == 0)
+		throw love::Exception("Chunk size must be greater than zero.");
+
+	std::vector<char> input(chunkSize);
+	std::vector<char> output;
+
+	while (true)
+	{
+		int64 count = source->read(input.data(), (int64) chunkSize);
+		if (count <= 0)
+			break;
+
+		output.clear();
+		push(input.data(), (size_t) count, output);
+
+		if (!output.empty() && !dest->write(output.data(), (int64) output.size()))
+			throw love::Exception("Could not write to the destination stream.");
+	}
+
+	output.clear();
+	finish(output);
+
+	if (!output.empty() && !dest->write(output.data(), (int64) output.size()))
+		throw love::Exception("Could not write to the destination stream.");
+}
+
+STRINGMAP_CLASS_BEGIN(CompressionStream, CompressionStream::Mode, CompressionStream::MODE_MAX_ENUM, mode)
+{
+	{ "compress",   CompressionStream::MODE_COMPRESS   },
+	{ "decompress", CompressionStream::MODE_DECOMPRESS },
+}
+STRINGMAP_CLASS_END(CompressionStream, CompressionStream::Mode, CompressionStream::MODE_MAX_ENUM, mode)
+
+} // data
+} // love
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Stream.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
+#include "Compressor.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Compresses or decompresses data a chunk at a time, so neither the whole
+ * input nor the whole output has to be in memory at once.
+ *
+ * LZ4 streams are stored as a series of independent blocks, each with its own
+ * size header, and can only be decompressed by another CompressionStream.
+ **/
+class CompressionStream : public love::Object
+{
+public:
+
+	enum Mode
+	{
+		MODE_COMPRESS,
+		MODE_DECOMPRESS,
+		MODE_MAX_ENUM
+	};
+
+	static love::Type type;
+
+	/**
+	 * @param mode Whether to compress or decompress.
+	 * @param format The compression format to use.
+	 * @param level The amount of compression to apply (between 0 and 9), or -1
+	 *        for the default. Ignored when decompressing.
+	 **/
+	static CompressionStream *create(Mode mode, Compressor::Format format, int level = -1);
+
+	virtual ~CompressionStream();
+
+	Mode getMode() const { return mode; }
+	Compressor::Format getFormat() const { return format; }
+
+	/**
+	 * Processes the next chunk of input, and appends any output that's ready
+	 * to the given vector. Output may be held back until later chunks.
+	 **/
+	void push(const char *data, size_t size, std::vector<char> &out);
+
+	/**
+	 * Ends the stream and appends the remaining output. Throws an exception
+	 * when decompressing if the compressed stream was cut short.
+	 **/
+	void finish(std::vector<char> &out);
+
+	/**
+	 * Gets whether finish has been called, or the end of the compressed stream
+	 * has been reached when decompressing.
+	 **/
+	bool isFinished() const;
+
+	/**
+	 * Reads the source until it runs out, writes the result to the destination
+	 * and finishes the stream.
+	 * @param chunkSize The number of bytes read from the source at a time.
+	 **/
+	void process(Stream *source, Stream *dest, size_t chunkSize);
+
+	STRINGMAP_CLASS_DECLARE(Mode);
+
+protected:
+
+	CompressionStream(Mode mode, Compressor::Format format);
+
+	virtual void pushInput(const char *data, size_t size, std::vector<char> &out) = 0;
+	virtual void finishInput(std::vector<char> &out) = 0;
+
+	Mode mode;
+	Compressor::Format format;
+
+	// Set by subclasses when the end of a compressed stream is reached.
+	bool ended;
+
+private:
+
+	bool finished;
+
+	love::thread::MutexRef mutex;
+
+}; // CompressionStream
+
+} // data
+} // love
@@ -23,17 +23,28 @@
 #include "common/config.h"
 #include "common/int.h"
 #include "common/Exception.h"
+#include "thread/JobSystem.h"
 
 #include "libraries/lz4/lz4.h"
 #include "libraries/lz4/lz4hc.h"
 
 #include <zlib.h>
 
+// C++
+#include <vector>
+#include <limits>
+#include <algorithm>
+
 namespace love
 {
 namespace data
 {
 
+char *Compressor::compressParallel(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize)
+{
+	return compress(format, data, dataSize, level, compressedSize);
+}
+
 class LZ4Compressor : public Compressor
 {
 public:
@@ -256,8 +267,199 @@ private:
 		return inflateEnd(&stream);
 	}
 
+	// Blocks for parallel compression are raw deflate data ending on a byte
+	// boundary, so they can be joined into one stream. Like pigz, each block
+	// is primed with the end of the previous one so the ratio barely changes.
+	static constexpr size_t PARALLEL_BLOCK_SIZE = 1024 * 1024;
+	static constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+
+	struct ParallelBlock
+	{
+		const Bytef *data;
+		size_t size;
+		bool last;
+
+		std::vector<char> output;
+		uLong check;
+		bool failed;
+	};
+
+	struct ParallelJob
+	{
+		Format format;
+		int level;
+		const Bytef *start;
+		std::vector<ParallelBlock> blocks;
+	};
+
+	static void compressBlock(ParallelJob *job, ParallelBlock &block)
+	{
+		z_stream stream = {};
+
+		block.failed = true;
+
+		if (deflateInit2(&stream, job->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			return;
+
+		if (block.data > job->start)
+		{
+			size_t dictsize = std::min((size_t) (block.data - job->start), DICTIONARY_SIZE);
+			deflateSetDictionary(&stream, block.data - dictsize, (uInt) dictsize);
+		}
+
+		if (job->format == FORMAT_GZIP)
+			block.check = crc32(crc32(0L, Z_NULL, 0), block.data, (uInt) block.size);
+		else if (job->format == FORMAT_ZLIB)
+			block.check = adler32(adler32(0L, Z_NULL, 0), block.data, (uInt) block.size);
+
+		// Extra room for the sync flush marker.
+		block.output.resize(deflateBound(&stream, (uLong) block.size) + 16);
+
+		stream.next_in = (Bytef *) block.data;
+		stream.avail_in = (uInt) block.size;
+		stream.next_out = (Bytef *) block.output.data();
+		stream.avail_out = (uInt) block.output.size();
+
+		// Only the last block ends the stream. The others are byte-aligned by
+		// the sync flush, without marking the final deflate block.
+		int err = deflate(&stream, block.last ? Z_FINISH : Z_SYNC_FLUSH);
+
+		if ((block.last && err == Z_STREAM_END) || (!block.last && err == Z_OK && stream.avail_in == 0 && stream.avail_out > 0))
+		{
+			block.output.resize(stream.total_out);
+			block.failed = false;
+		}
+
+		deflateEnd(&stream);
+	}
+
+	static void writeUint32(std::vector<char> &out, uLong value, bool bigendian)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			int shift = bigendian ? (3 - i) * 8 : i * 8;
+			out.push_back((char) ((value >> shift) & 0xFF));
+		}
+	}
+
 public:
 
+	char *compressParallel(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
+	{
+		if (!isSupported(format))
+			throw love::Exception("Invalid format (expecting zlib or gzip)");
+
+		size_t blockcount = (dataSize + PARALLEL_BLOCK_SIZE - 1) / PARALLEL_BLOCK_SIZE;
+
+		if (blockcount < 2 || blockcount > (size_t) std::numeric_limits<int>::max())
+			return compress(format, data, dataSize, level, compressedSize);
+
+		if (level < 0)
+			level = Z_DEFAULT_COMPRESSION;
+		else if (level > 9)
+			level = 9;
+
+		ParallelJob job;
+		job.format = format;
+		job.level = level;
+		job.start = (const Bytef *) data;
+		job.blocks.resize(blockcount);
+
+		for (size_t i = 0; i < blockcount; i++)
+		{
+			ParallelBlock &block = job.blocks[i];
+			block.data = job.start + i * PARALLEL_BLOCK_SIZE;
+			block.size = std::min(PARALLEL_BLOCK_SIZE, dataSize - i * PARALLEL_BLOCK_SIZE);
+			block.last = i + 1 == blockcount;
+			block.check = 0;
+			block.failed = true;
+		}
+
+		love::thread::JobSystemRef jobSystem;
+		jobSystem->runParallel((int) blockcount, [&](int i)
+		{
+			compressBlock(&job, job.blocks[i]);
+		});
+
+		std::vector<char> header;
+		uLong check = 0;
+
+		if (format == FORMAT_ZLIB)
+		{
+			int flevel = 2;
+			if (level == 1 || level == 0)
+				flevel = 0;
+			else if (level >= 2 && level < 6)
+				flevel = 1;
+			else if (level > 6)
+				flevel = 3;
+
+			int cmf = 0x78;
+			int flg = flevel << 6;
+			flg += 31 - ((cmf << 8) + flg) % 31;
+
+			header.push_back((char) cmf);
+			header.push_back((char) flg);
+			check = adler32(0L, Z_NULL, 0);
+		}
+		else if (format == FORMAT_GZIP)
+		{
+			const unsigned char gzipheader[] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+			header.insert(header.end(), gzipheader, gzipheader + sizeof(gzipheader));
+			header[8] = (char) (level == 9 ? 2 : (level == 1 ? 4 : 0));
+			check = crc32(0L, Z_NULL, 0);
+		}
+
+		size_t totalsize = header.size() + 8;
+		for (const ParallelBlock &block : job.blocks)
+		{
+			if (block.failed)
+				throw love::Exception("Could not zlib/gzip-compress data.");
+
+			totalsize += block.output.size();
+
+			if (format == FORMAT_ZLIB)
+				check = adler32_combine(check, block.check, (z_off_t) block.size);
+			else if (format == FORMAT_GZIP)
+				check = crc32_combine(check, block.check, (z_off_t) block.size);
+		}
+
+		std::vector<char> trailer;
+		if (format == FORMAT_ZLIB)
+			writeUint32(trailer, check, true);
+		else if (format == FORMAT_GZIP)
+		{
+			writeUint32(trailer, check, false);
+			writeUint32(trailer, (uLong) (dataSize & 0xFFFFFFFF), false);
+		}
+
+		char *compressedbytes = nullptr;
+		try
+		{
+			compressedbytes = new char[totalsize];
+		}
+		catch (std::bad_alloc &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		char *dst = compressedbytes;
+		memcpy(dst, header.data(), header.size());
+		dst += header.size();
+
+		for (const ParallelBlock &block : job.blocks)
+		{
+			memcpy(dst, block.output.data(), block.output.size());
+			dst += block.output.size();
+		}
+
+		memcpy(dst, trailer.data(), trailer.size());
+		dst += trailer.size();
+
+		compressedSize = (size_t) (dst - compressedbytes);
+		return compressedbytes;
+	}
+
 	char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
 	{
 		if (!isSupported(format))
@@ -67,6 +67,14 @@ public:
 	 **/
 	virtual char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) = 0;
 
+	/**
+	 * Like compress, but large inputs are split into blocks which are
+	 * compressed on several threads at once. The result is still a standard
+	 * stream in the given format, though not byte-for-byte the same as what
+	 * compress produces. Formats that can't be split are compressed normally.
+	 **/
+	virtual char *compressParallel(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize);
+
 	/**
 	 * Decompresses compressed data, and returns the decompressed result.
 	 *
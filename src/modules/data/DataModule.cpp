@@ -29,11 +29,69 @@
 #include <list>
 #include <iostream>
 
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
 namespace
 {
 
 static const char hexchars[] = "0123456789abcdef";
 
+void bytesToHex(const love::uint8 *src, size_t srclen, char *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i zero = _mm_set1_epi8('0');
+	const __m128i letteroffset = _mm_set1_epi8('a' - '0' - 10);
+
+	for (; i + 16 <= srclen; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+		__m128i lo = _mm_and_si128(v, mask);
+
+		hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letteroffset));
+		lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letteroffset));
+
+		_mm_storeu_si128((__m128i *) (dst + i * 2 + 0), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const uint8x16_t nine = vdupq_n_u8(9);
+	const uint8x16_t zero = vdupq_n_u8('0');
+	const uint8x16_t letteroffset = vdupq_n_u8('a' - '0' - 10);
+
+	for (; i + 16 <= srclen; i += 16)
+	{
+		uint8x16_t v = vld1q_u8(src + i);
+		uint8x16x2_t out;
+		out.val[0] = vshrq_n_u8(v, 4);
+		out.val[1] = vandq_u8(v, vdupq_n_u8(0x0F));
+
+		out.val[0] = vaddq_u8(vaddq_u8(out.val[0], zero), vandq_u8(vcgtq_u8(out.val[0], nine), letteroffset));
+		out.val[1] = vaddq_u8(vaddq_u8(out.val[1], zero), vandq_u8(vcgtq_u8(out.val[1], nine), letteroffset));
+
+		// Interleaves the high and low nibble characters.
+		vst2q_u8((uint8_t *) dst + i * 2, out);
+	}
+#endif
+
+	for (; i < srclen; i++)
+	{
+		love::uint8 b = src[i];
+		dst[i * 2 + 0] = hexchars[b >> 4];
+		dst[i * 2 + 1] = hexchars[b & 0xF];
+	}
+}
+
 char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 {
 	dstlen = srclen * 2;
@@ -51,29 +109,40 @@ char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < srclen; i++)
-	{
-		love::uint8 b = src[i];
-		dst[i * 2 + 0] = hexchars[b >> 4];
-		dst[i * 2 + 1] = hexchars[b & 0xF];
-	}
+	bytesToHex(src, srclen, dst);
 
 	dst[dstlen] = '\0';
 	return dst;
 }
 
-love::uint8 nibble(char c)
+/**
+ * Maps every character to its hex digit value. Anything that isn't a hex
+ * digit decodes as 0.
+ **/
+struct NibbleTable
 {
-	if (c >= '0' && c <= '9')
-		return (love::uint8) (c - '0');
-
-	if (c >= 'A' && c <= 'F')
-		return (love::uint8) (c - 'A' + 0x0a);
+	love::uint8 values[256];
 
-	if (c >= 'a' && c <= 'f')
-		return (love::uint8) (c - 'a' + 0x0a);
+	NibbleTable()
+	{
+		for (int c = 0; c < 256; c++)
+		{
+			if (c >= '0' && c <= '9')
+				values[c] = (love::uint8) (c - '0');
+			else if (c >= 'A' && c <= 'F')
+				values[c] = (love::uint8) (c - 'A' + 0x0a);
+			else if (c >= 'a' && c <= 'f')
+				values[c] = (love::uint8) (c - 'a' + 0x0a);
+			else
+				values[c] = 0;
+		}
+	}
+};
 
-	return 0;
+const NibbleTable &getNibbleTable()
+{
+	static const NibbleTable table;
+	return table;
 }
 
 love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
@@ -99,13 +168,15 @@ love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < dstlen; i++)
-	{
-		dst[i] = nibble(src[i * 2]) << 4;
+	const love::uint8 *nibbles = getNibbleTable().values;
+	const love::uint8 *s = (const love::uint8 *) src;
 
-		if (i * 2 + 1 < srclen)
-			dst[i] |= nibble(src[i * 2 + 1]);
-	}
+	size_t pairs = srclen / 2;
+	for (size_t i = 0; i < pairs; i++)
+		dst[i] = (love::uint8) ((nibbles[s[i * 2]] << 4) | nibbles[s[i * 2 + 1]]);
+
+	if (pairs < dstlen)
+		dst[pairs] = (love::uint8) (nibbles[s[pairs * 2]] << 4);
 
 	return dst;
 }
@@ -117,7 +188,7 @@ namespace love
 namespace data
 {
 
-CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level)
+CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level, bool parallel)
 {
 	Compressor *compressor = Compressor::getCompressor(format);
 
@@ -125,7 +196,12 @@ CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t
 		throw love::Exception("Invalid compression format.");
 
 	size_t compressedsize = 0;
-	char *cbytes = compressor->compress(format, rawbytes, rawsize, level, compressedsize);
+	char *cbytes = nullptr;
+
+	if (parallel)
+		cbytes = compressor->compressParallel(format, rawbytes, rawsize, level, compressedsize);
+	else
+		cbytes = compressor->compress(format, rawbytes, rawsize, level, compressedsize);
 
 	CompressedData *data = nullptr;
 
@@ -175,6 +251,31 @@ char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen
 	}
 }
 
+size_t getEncodedSize(EncodeFormat format, size_t srclen, size_t linelen)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_encode_size(srclen, linelen);
+	case ENCODE_HEX:
+		return srclen * 2;
+	}
+}
+
+size_t encode(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t linelen)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_encode_into(src, srclen, linelen, dst);
+	case ENCODE_HEX:
+		bytesToHex((const uint8 *) src, srclen, dst);
+		return srclen * 2;
+	}
+}
+
 char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen)
 {
 	switch (format)
@@ -220,6 +321,7 @@ DataModule::DataModule()
 
 DataModule::~DataModule()
 {
+	jobs.wait();
 }
 
 DataView *DataModule::newDataView(Data *data, size_t offset, size_t size)
@@ -242,6 +344,29 @@ ByteData *DataModule::newByteData(void *d, size_t size, bool own)
 	return new ByteData(d, size, own);
 }
 
+CompressionStream *DataModule::newCompressionStream(CompressionStream::Mode mode, Compressor::Format format, int level)
+{
+	return CompressionStream::create(mode, format, level);
+}
+
+Hasher *DataModule::newHasher(HashFunction::Function function)
+{
+	return new Hasher(function);
+}
+
+PackFormat *DataModule::newPackFormat(const std::string &format)
+{
+	return new PackFormat(format);
+}
+
+CompressJob *DataModule::compressAsync(Compressor::Format format, Data *input, int level)
+{
+	CompressJob *job = new CompressJob(format, input, level);
+	StrongRef<CompressJob> ref(job);
+	jobSystem->submit([ref]() { ref->compress(); }, [ref]() { ref->cancel(); }, &jobs);
+	return job;
+}
+
 static StringMap<EncodeFormat, ENCODE_MAX_ENUM>::Entry encoderEntries[] =
 {
 	{ "base64", ENCODE_BASE64 },
@@ -22,13 +22,18 @@
 
 #include "CompressedData.h"
 #include "Compressor.h"
+#include "CompressionStream.h"
+#include "CompressJob.h"
+#include "Hasher.h"
 #include "HashFunction.h"
 #include "DataView.h"
 #include "ByteData.h"
+#include "PackFormat.h"
 
 // LOVE
 #include "common/Module.h"
 #include "common/int.h"
+#include "thread/JobSystem.h"
 
 namespace love
 {
@@ -58,9 +63,10 @@ enum ContainerType
  * @param level The amount of compression to apply (between 0 and 9.)
  *              A value of -1 indicates the default amount of compression.
  *              Specific formats may not use every level.
+ * @param parallel Whether to split large inputs across several threads.
  * @return The newly compressed data.
  **/
-CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level = -1);
+CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level = -1, bool parallel = false);
 
 /**
  * Decompresses existing compressed data into raw bytes.
@@ -85,6 +91,19 @@ char *decompress(CompressedData *data, size_t &decompressedsize);
 char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize);
 
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen = 0);
+
+/**
+ * Gets the size in bytes of the encoded form of data of the given size.
+ **/
+size_t getEncodedSize(EncodeFormat format, size_t srclen, size_t linelen = 0);
+
+/**
+ * Encodes data into existing memory, which must hold at least
+ * getEncodedSize(format, srclen, linelen) bytes.
+ *
+ * @return The number of bytes written.
+ **/
+size_t encode(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t linelen = 0);
 char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen);
 
 /**
@@ -121,6 +140,19 @@ public:
 	ByteData *newByteData(size_t size);
 	ByteData *newByteData(const void *d, size_t size);
 	ByteData *newByteData(void *d, size_t size, bool own);
+	CompressionStream *newCompressionStream(CompressionStream::Mode mode, Compressor::Format format, int level = -1);
+	Hasher *newHasher(HashFunction::Function function);
+	PackFormat *newPackFormat(const std::string &format);
+
+	/**
+	 * Compresses the given Data on the shared job system.
+	 **/
+	CompressJob *compressAsync(Compressor::Format format, Data *input, int level = -1);
+
+private:
+
+	love::thread::JobSystemRef jobSystem;
+	love::thread::JobGroup jobs;
 
 }; // DataModule
 
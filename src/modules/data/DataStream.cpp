@@ -19,6 +19,7 @@
  **/
 
 #include "DataStream.h"
+#include "DataView.h"
 #include "common/Exception.h"
 #include "common/int.h"
 #include "common/Data.h"
@@ -90,6 +91,19 @@ int64 DataStream::read(void* data, int64 size)
 	return readsize;
 }
 
+Data *DataStream::read(int64 size)
+{
+	int64 readsize = std::min<int64>(size, getSize() - (int64) offset);
+
+	if (readsize <= 0)
+		return Stream::read(size);
+
+	DataView *view = new DataView(data, offset, (size_t) readsize);
+
+	offset += readsize;
+	return view;
+}
+
 bool DataStream::write(const void* data, int64 size)
 {
 	if (size <= 0 || writableMemory == nullptr)
@@ -44,6 +44,12 @@ public:
 	bool isSeekable() const override;
 
 	int64 read(void* data, int64 size) override;
+
+	/**
+	 * Returns a DataView of the stream's memory instead of a copy, so it
+	 * sees any later writes to the same bytes.
+	 **/
+	Data *read(int64 size) override;
 	bool write(const void* data, int64 size) override;
 
 	bool flush() override;
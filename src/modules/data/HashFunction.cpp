@@ -18,19 +18,53 @@
  * 3. This notice may not be removed or altered from any source distribution.
  **/
 
+#include "common/config.h"
 #include "HashFunction.h"
 #include "common/Exception.h"
 
+#include "libraries/xxHash/xxhash.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 // FIXME: Probably trivial by having tole and tobe functions, which can be ifdeffed to being identity functions
 #ifdef LOVE_BIG_ENDIAN
 #	error Hashing not yet implemented for big endian
 #endif
 
+// SHA-1 and SHA-256 use the SHA extensions on x86 CPUs that have them.
+#if defined(LOVE_SIMD_SSE) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#	define LOVE_HASH_SHA_X86
+#	include <immintrin.h>
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#		define LOVE_HASH_TARGET_SHA
+#	else
+#		include <cpuid.h>
+#		define LOVE_HASH_TARGET_SHA __attribute__((target("sha,sse4.1")))
+#	endif
+#endif
+
+// ARMv8 builds use the crypto extensions when the compiler targets them.
+#if defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#	define LOVE_HASH_SHA_ARM
+#	include <arm_neon.h>
+#endif
+
 namespace love
 {
 namespace data
 {
 
+void HashFunction::hash(Function function, const char *input, uint64 length, Value &output) const
+{
+	std::unique_ptr<Context> context(newContext(function));
+	context->update(input, length);
+	context->finish(output);
+}
+
 namespace
 {
 namespace impl
@@ -51,63 +85,244 @@ inline uint64 rightrot(uint64 x, uint8 amount)
 	return (x >> amount) | (x << (64 - amount));
 }
 
-// Extend the value of `a` to make it a multiple of `n`.
-inline uint64 extend_multiple(uint64 a, uint64 n)
+inline uint32 loadLE32(const uint8 *p)
+{
+	return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+inline uint32 loadBE32(const uint8 *p)
+{
+	return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+}
+
+inline uint64 loadBE64(const uint8 *p)
+{
+	return ((uint64) loadBE32(p) << 32) | (uint64) loadBE32(p + 4);
+}
+
+inline void storeBE32(char *p, uint32 x)
+{
+	p[0] = (x >> 24) & 0xFF;
+	p[1] = (x >> 16) & 0xFF;
+	p[2] = (x >>  8) & 0xFF;
+	p[3] = (x >>  0) & 0xFF;
+}
+
+inline void storeBE64(char *p, uint64 x)
 {
-	uint64 r = a % n;
-	return r == 0 ? a : a + (n-r);
+	storeBE32(p, (uint32) (x >> 32));
+	storeBE32(p + 4, (uint32) x);
 }
 
+static const uint8 md5Shifts[64] = {
+	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+};
+
+static const uint32 md5Constants[64] = {
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+	0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+	0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+	0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+	0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+	0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+	0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+static const uint32 sha224Initial[8] = {
+	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+};
+
+static const uint32 sha256Initial[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+alignas(16) static const uint32 sha256Constants[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint64 sha384Initial[8] = {
+	0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+	0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
+};
+
+static const uint64 sha512Initial[8] = {
+	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
+};
+
+static const uint64 sha512Constants[80] = {
+	0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+	0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+	0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+	0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+	0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+	0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+	0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+	0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+	0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+	0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+	0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+	0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+	0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+	0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+	0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+	0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+	0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+	0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+	0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+};
+
+// Processes whole blocks of input, updating the intermediate hash state.
+typedef void (*SHA1BlockFunction)(uint32 state[5], const uint8 *blocks, size_t count);
+typedef void (*SHA256BlockFunction)(uint32 state[8], const uint8 *blocks, size_t count);
+
 /**
- * The following implementation is based on the pseudocode provided by multiple
- * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
- * The pseudocode is licensed under the CC-BY-SA license, but no authorship
- * information is present. I believe this note, and the zlib license of this
- * project satisfy the conditions of the license.
+ * Buffers input into whole blocks and pads the final one, for the
+ * Merkle-Damgard hash functions (MD5, SHA-1 and SHA-2). The message length is
+ * stored at the end of the padding in bits.
  **/
-class MD5 : public HashFunction
+template <size_t BLOCK_SIZE, size_t LENGTH_SIZE, bool BIG_ENDIAN_LENGTH>
+class BlockContext : public HashFunction::Context
 {
-private:
-	static const uint8 shifts[64];
-	static const uint32 constants[64];
-
 public:
-	bool isSupported(Function function) const override
+
+	BlockContext()
+		: total(0)
+		, buffered(0)
 	{
-		return function == FUNCTION_MD5;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	void update(const char *input, uint64 length) override
 	{
-		if (function != FUNCTION_MD5)
-			throw love::Exception("Hash function not supported by MD5 implementation");
+		const uint8 *data = (const uint8 *) input;
+		total += length;
+
+		// Top up a partially filled block first.
+		if (buffered > 0)
+		{
+			size_t count = (size_t) std::min(length, (uint64) (BLOCK_SIZE - buffered));
+			memcpy(buffer + buffered, data, count);
+			buffered += count;
+			data += count;
+			length -= count;
+
+			if (buffered < BLOCK_SIZE)
+				return;
+
+			processBlocks(buffer, 1);
+			buffered = 0;
+		}
+
+		// Whole blocks are processed straight from the input.
+		uint64 blocks = length / BLOCK_SIZE;
+		if (blocks > 0)
+		{
+			processBlocks(data, (size_t) blocks);
+			data += blocks * BLOCK_SIZE;
+			length -= blocks * BLOCK_SIZE;
+		}
+
+		memcpy(buffer, data, (size_t) length);
+		buffered = (size_t) length;
+	}
+
+	void finish(HashFunction::Value &output) override
+	{
+		uint64 bitlength = total * 8;
 
-		uint32 a0 = 0x67452301;
-		uint32 b0 = 0xefcdab89;
-		uint32 c0 = 0x98badcfe;
-		uint32 d0 = 0x10325476;
+		// A 1 bit, then zeroes up to the length at the end of a block.
+		uint8 padding[BLOCK_SIZE * 2] = {};
+		padding[0] = 0x80;
+		size_t padsize = BLOCK_SIZE - ((buffered + LENGTH_SIZE) % BLOCK_SIZE);
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 8, 64);
+		// Lengths larger than 64 bits are never needed, so any extra length
+		// bytes (SHA-384 and SHA-512) stay zero.
+		uint8 *lengthbytes = padding + padsize + LENGTH_SIZE - 8;
+		for (int i = 0; i < 8; i++)
+		{
+			int shift = BIG_ENDIAN_LENGTH ? (7 - i) * 8 : i * 8;
+			lengthbytes[i] = (bitlength >> shift) & 0xFF;
+		}
+
+		update((const char *) padding, padsize + LENGTH_SIZE);
+		getDigest(output);
+	}
+
+protected:
+
+	virtual void processBlocks(const uint8 *blocks, size_t count) = 0;
+	virtual void getDigest(HashFunction::Value &output) = 0;
+
+private:
+
+	uint64 total;
+	uint8 buffer[BLOCK_SIZE];
+	size_t buffered;
+
+}; // BlockContext
+
+/**
+ * The following implementation is based on the pseudocode provided by multiple
+ * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
+ * The pseudocode is licensed under the CC-BY-SA license, but no authorship
+ * information is present. I believe this note, and the zlib license of this
+ * project satisfy the conditions of the license.
+ **/
+class MD5Context : public BlockContext<64, 8, false>
+{
+public:
 
-		uint32 *padded = new uint32[paddedLength / 4];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+	MD5Context()
+		: state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476}
+	{
+	}
 
-		// Append length in bits
-		uint64 bit_length = length * 8;
-		memcpy(((uint8*)padded) + paddedLength - 8, &bit_length, 8);
+protected:
 
-		// Process chunks
-		for (uint64 i = 0; i < paddedLength/4; i += 16)
+	void processBlocks(const uint8 *blocks, size_t count) override
+	{
+		for (size_t i = 0; i < count; i++)
 		{
-			uint32 *chunk = &padded[i];
+			const uint8 *block = blocks + i * 64;
+
+			uint32 chunk[16];
+			for (int j = 0; j < 16; j++)
+				chunk[j] = loadLE32(block + j * 4);
 
-			uint32 A = a0;
-			uint32 B = b0;
-			uint32 C = c0;
-			uint32 D = d0;
+			uint32 A = state[0];
+			uint32 B = state[1];
+			uint32 C = state[2];
+			uint32 D = state[3];
 			uint32 F;
 			uint32 g;
 
@@ -137,357 +352,540 @@ public:
 				uint32 temp = D;
 				D = C;
 				C = B;
-				B += leftrot(A + F + constants[j] + chunk[g], shifts[j]);
+				B += leftrot(A + F + md5Constants[j] + chunk[g], md5Shifts[j]);
 				A = temp;
 			}
 
-			a0 += A;
-			b0 += B;
-			c0 += C;
-			d0 += D;
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
 		}
+	}
 
-		delete[] padded;
-
-		memcpy(&output.data[ 0], &a0, 4);
-		memcpy(&output.data[ 4], &b0, 4);
-		memcpy(&output.data[ 8], &c0, 4);
-		memcpy(&output.data[12], &d0, 4);
+	void getDigest(HashFunction::Value &output) override
+	{
+		memcpy(output.data, state, 16);
 		output.size = 16;
 	}
-} md5;
 
-const uint8 MD5::shifts[64] = {
-	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
-	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
-	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
-	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
-};
+private:
 
-const uint32 MD5::constants[64] = {
-	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
-	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
-	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
-	0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
-	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
-	0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
-	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
-	0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
-	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
-	0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
-	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
-	0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
-	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
-	0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
-	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
-	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
-};
+	uint32 state[4];
+
+}; // MD5Context
 
 /**
  * The following implementation was based on the text, not the code listings,
  * in RFC3174. I believe this means no copyright other than that of the L�VE
  * Development Team applies.
  **/
-class SHA1 : public HashFunction
+static void sha1Blocks(uint32 state[5], const uint8 *blocks, size_t count)
 {
-public:
-	bool isSupported(Function function) const override
-	{
-		return function == FUNCTION_SHA1;
-	}
+	// Allocate our extended words
+	uint32 words[80];
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	for (size_t i = 0; i < count; i++)
 	{
-		if (function != FUNCTION_SHA1)
-			throw love::Exception("Hash function not supported by SHA1 implementation");
-
-		uint32 intermediate[5] = {
-			0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
-		};
-
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 8, 64);
+		const uint8 *block = blocks + i * 64;
 
-		uint32 *padded = new uint32[paddedLength / 4];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+		for (int j = 0; j < 16; j++)
+			words[j] = loadBE32(block + j * 4);
+		for (int j = 16; j < 80; j++)
+			words[j] = leftrot(words[j-3] ^ words[j-8] ^ words[j-14] ^ words[j-16], 1);
 
-		// Append length in bits (big endian)
-		uint64 bit_length = length * 8;
-		for (int i = 0; i < 8; ++i)
-			*(((uint8*)padded) + (paddedLength - 8 + i)) = (bit_length >> (56 - i * 8)) & 0xFF;
+		uint32 A = state[0];
+		uint32 B = state[1];
+		uint32 C = state[2];
+		uint32 D = state[3];
+		uint32 E = state[4];
 
-		// Allocate our extended words
-		uint32 words[80];
-
-		for (uint64 i = 0; i < paddedLength/4; i += 16)
+		for (int j = 0; j < 80; j++)
 		{
-			uint32 *chunk = &padded[i];
-			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
-			for (int j = 16; j < 80; j++)
-				words[j] = leftrot(words[j-3] ^ words[j-8] ^ words[j-14] ^ words[j-16], 1);
+			uint32 temp = leftrot(A, 5) + E + words[j];
+
+			if (j < 20)
+				temp += 0x5A827999 + ((B & C) | (~B & D));
+			else if (j < 40)
+				temp += 0x6ED9EBA1 + (B ^ C ^ D);
+			else if (j < 60)
+				temp += 0x8F1BBCDC + ((B & C) | (B & D) | (C & D));
+			else
+				temp += 0xCA62C1D6 + (B ^ C ^ D);
+
+			E = D;
+			D = C;
+			C = leftrot(B, 30);
+			B = A;
+			A = temp;
+		}
 
-			uint32 A = intermediate[0];
-			uint32 B = intermediate[1];
-			uint32 C = intermediate[2];
-			uint32 D = intermediate[3];
-			uint32 E = intermediate[4];
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+	}
+}
 
-			for (int j = 0; j < 80; j++)
-			{
-				uint32 temp = leftrot(A, 5) + E + words[j];
-
-				if (j < 20)
-					temp += 0x5A827999 + ((B & C) | (~B & D));
-				else if (j < 40)
-					temp += 0x6ED9EBA1 + (B ^ C ^ D);
-				else if (j < 60)
-					temp += 0x8F1BBCDC + ((B & C) | (B & D) | (C & D));
-				else
-					temp += 0xCA62C1D6 + (B ^ C ^ D);
+/**
+ * This implementation was based on the description in RFC-6234.
+ **/
+static void sha256Blocks(uint32 state[8], const uint8 *blocks, size_t count)
+{
+	// Allocate our extended words
+	uint32 words[64];
 
-				E = D;
-				D = C;
-				C = leftrot(B, 30);
-				B = A;
-				A = temp;
-			}
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8 *block = blocks + i * 64;
 
-			intermediate[0] += A;
-			intermediate[1] += B;
-			intermediate[2] += C;
-			intermediate[3] += D;
-			intermediate[4] += E;
+		for (int j = 0; j < 16; j++)
+			words[j] = loadBE32(block + j * 4);
+		for (int j = 16; j < 64; j++)
+		{
+			words[j] = rightrot(words[j-2], 17) ^ rightrot(words[j-2], 19) ^ (words[j-2] >> 10);
+			words[j] += rightrot(words[j-15], 7) ^ rightrot(words[j-15], 18) ^ (words[j-15] >> 3);
+			words[j] += words[j-7] + words[j-16];
 		}
 
-		delete[] padded;
+		uint32 A = state[0];
+		uint32 B = state[1];
+		uint32 C = state[2];
+		uint32 D = state[3];
+		uint32 E = state[4];
+		uint32 F = state[5];
+		uint32 G = state[6];
+		uint32 H = state[7];
 
-		for (int i = 0; i < 20; i += 4)
+		for (int j = 0; j < 64; j++)
 		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
+			uint32 temp1 = H + sha256Constants[j] + words[j];
+			temp1 += rightrot(E, 6) ^ rightrot(E, 11) ^ rightrot(E, 25);
+			temp1 += (E & F) ^ (~E & G);
+			uint32 temp2 = rightrot(A, 2) ^ rightrot(A, 13) ^ rightrot(A, 22);
+			temp2 += (A & B) ^ (A & C) ^ (B & C);
+
+			H = G;
+			G = F;
+			F = E;
+			E = D + temp1;
+			D = C;
+			C = B;
+			B = A;
+			A = temp1 + temp2;
 		}
 
-		output.size = 20;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+		state[5] += F;
+		state[6] += G;
+		state[7] += H;
 	}
-} sha1;
+}
 
-/**
- * This implementation was based on the description in RFC-6234.
- **/
-// SHA-2: SHA-224 and SHA-256
-class SHA256 : public HashFunction
+#if defined(LOVE_HASH_SHA_X86)
+
+static bool hasSHAInstructions()
 {
-private:
-	static const uint32 initial224[8];
-	static const uint32 initial256[8];
-	static const uint32 constants[64];
+	// SHA extensions are leaf 7 EBX bit 29. SSE4.1 (which implies SSSE3) is
+	// leaf 1 ECX bit 19.
+#ifdef _MSC_VER
+	int info[4] = {};
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	bool sha = (info[1] & (1 << 29)) != 0;
+
+	__cpuid(info, 1);
+	bool sse41 = (info[2] & (1 << 19)) != 0;
+#else
+	unsigned int a = 0, b = 0, c = 0, d = 0;
+	if (!__get_cpuid_count(7, 0, &a, &b, &c, &d))
+		return false;
+
+	bool sha = (b & (1 << 29)) != 0;
+
+	if (!__get_cpuid(1, &a, &b, &c, &d))
+		return false;
+
+	bool sse41 = (c & (1 << 19)) != 0;
+#endif
 
-public:
-	bool isSupported(Function function) const override
-	{
-		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
-	}
+	return sha && sse41;
+}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
-	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
+LOVE_HASH_TARGET_SHA
+static void sha1BlocksX86(uint32 state[5], const uint8 *blocks, size_t count)
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 8, 64);
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0x1B);
+	__m128i e0 = _mm_set_epi32((int) state[4], 0, 0, 0);
 
-		uint32 *padded = new uint32[paddedLength / 4];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8 *block = blocks + i * 64;
 
-		// Append length in bits (big endian)
-		uint64 bit_length = length * 8;
-		for (int i = 0; i < 8; ++i)
-			*(((uint8*)padded) + (paddedLength - 8 + i)) = (bit_length >> (56 - i * 8)) & 0xFF;
+		__m128i abcdsave = abcd;
+		__m128i e0save = e0;
 
-		uint32 intermediate[8];
-		if (function == FUNCTION_SHA224)
-			memcpy(intermediate, initial224, sizeof(intermediate));
-		else
-			memcpy(intermediate, initial256, sizeof(intermediate));
+		__m128i msg[4];
+		for (int j = 0; j < 4; j++)
+			msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (block + j * 16)), mask);
 
-		// Allocate our extended words
-		uint32 words[64];
+		// The E values alternate between two registers every four rounds.
+		__m128i e[2] = {e0, e0};
 
-		for (uint64 i = 0; i < paddedLength/4; i += 16)
+		for (int g = 0; g < 20; g++)
 		{
-			uint32 *chunk = &padded[i];
-			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
-			for (int j = 16; j < 64; j++)
-			{
-				words[j] = rightrot(words[j-2], 17) ^ rightrot(words[j-2], 19) ^ (words[j-2] >> 10);
-				words[j] += rightrot(words[j-15], 7) ^ rightrot(words[j-15], 18) ^ (words[j-15] >> 3);
-				words[j] += words[j-7] + words[j-16];
-			}
+			__m128i &cur = e[g & 1];
+			__m128i &next = e[(g + 1) & 1];
 
-			uint32 A = intermediate[0];
-			uint32 B = intermediate[1];
-			uint32 C = intermediate[2];
-			uint32 D = intermediate[3];
-			uint32 E = intermediate[4];
-			uint32 F = intermediate[5];
-			uint32 G = intermediate[6];
-			uint32 H = intermediate[7];
+			if (g == 0)
+				cur = _mm_add_epi32(cur, msg[0]);
+			else
+				cur = _mm_sha1nexte_epu32(cur, msg[g & 3]);
 
-			for (int j = 0; j < 64; j++)
-			{
-				uint32 temp1 = H + constants[j] + words[j];
-				temp1 += rightrot(E, 6) ^ rightrot(E, 11) ^ rightrot(E, 25);
-				temp1 += (E & F) ^ (~E & G);
-				uint32 temp2 = rightrot(A, 2) ^ rightrot(A, 13) ^ rightrot(A, 22);
-				temp2 += (A & B) ^ (A & C) ^ (B & C);
+			next = abcd;
 
-				H = G;
-				G = F;
-				F = E;
-				E = D + temp1;
-				D = C;
-				C = B;
-				B = A;
-				A = temp1 + temp2;
+			if (g >= 3 && g <= 18)
+				msg[(g + 1) & 3] = _mm_sha1msg2_epu32(msg[(g + 1) & 3], msg[g & 3]);
+
+			switch (g / 5)
+			{
+			case 0: abcd = _mm_sha1rnds4_epu32(abcd, cur, 0); break;
+			case 1: abcd = _mm_sha1rnds4_epu32(abcd, cur, 1); break;
+			case 2: abcd = _mm_sha1rnds4_epu32(abcd, cur, 2); break;
+			default: abcd = _mm_sha1rnds4_epu32(abcd, cur, 3); break;
 			}
 
-			intermediate[0] += A;
-			intermediate[1] += B;
-			intermediate[2] += C;
-			intermediate[3] += D;
-			intermediate[4] += E;
-			intermediate[5] += F;
-			intermediate[6] += G;
-			intermediate[7] += H;
+			if (g >= 1 && g <= 16)
+				msg[(g - 1) & 3] = _mm_sha1msg1_epu32(msg[(g - 1) & 3], msg[g & 3]);
+			if (g >= 2 && g <= 17)
+				msg[(g - 2) & 3] = _mm_xor_si128(msg[(g - 2) & 3], msg[g & 3]);
 		}
 
-		delete[] padded;
+		e0 = _mm_sha1nexte_epu32(e[0], e0save);
+		abcd = _mm_add_epi32(abcd, abcdsave);
+	}
+
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	_mm_storeu_si128((__m128i *) state, abcd);
+	state[4] = (uint32) _mm_extract_epi32(e0, 3);
+}
+
+LOVE_HASH_TARGET_SHA
+static void sha256BlocksX86(uint32 state[8], const uint8 *blocks, size_t count)
+{
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+	// The instructions want the state as ABEF and CDGH.
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[0]), 0xB1);
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[4]), 0x1B);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8 *block = blocks + i * 64;
+
+		__m128i abefsave = state0;
+		__m128i cdghsave = state1;
 
-		int hashlength = 32;
-		if (function == FUNCTION_SHA224)
-			hashlength = 28;
+		__m128i msg[4];
+		for (int j = 0; j < 4; j++)
+			msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (block + j * 16)), mask);
 
-		for (int i = 0; i < hashlength; i += 4)
+		for (int g = 0; g < 16; g++)
 		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
+			__m128i wk = _mm_add_epi32(msg[g & 3], _mm_load_si128((const __m128i *) &sha256Constants[g * 4]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+
+			if (g >= 3 && g <= 14)
+			{
+				tmp = _mm_alignr_epi8(msg[g & 3], msg[(g - 1) & 3], 4);
+				msg[(g + 1) & 3] = _mm_add_epi32(msg[(g + 1) & 3], tmp);
+				msg[(g + 1) & 3] = _mm_sha256msg2_epu32(msg[(g + 1) & 3], msg[g & 3]);
+			}
+
+			wk = _mm_shuffle_epi32(wk, 0x0E);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+
+			if (g >= 1 && g <= 12)
+				msg[(g - 1) & 3] = _mm_sha256msg1_epu32(msg[(g - 1) & 3], msg[g & 3]);
 		}
 
-		output.size = hashlength;
+		state0 = _mm_add_epi32(state0, abefsave);
+		state1 = _mm_add_epi32(state1, cdghsave);
 	}
-} sha256;
 
-const uint32 SHA256::initial224[8] = {
-	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
-	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
-};
+	tmp = _mm_shuffle_epi32(state0, 0x1B);
+	state1 = _mm_shuffle_epi32(state1, 0xB1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
 
-const uint32 SHA256::initial256[8] = {
-	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
-};
+	_mm_storeu_si128((__m128i *) &state[0], state0);
+	_mm_storeu_si128((__m128i *) &state[4], state1);
+}
 
-const uint32 SHA256::constants[64] = {
-	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+#endif // LOVE_HASH_SHA_X86
+
+#if defined(LOVE_HASH_SHA_ARM)
+
+static void sha1BlocksARM(uint32 state[5], const uint8 *blocks, size_t count)
+{
+	const uint32x4_t k[4] = {
+		vdupq_n_u32(0x5A827999), vdupq_n_u32(0x6ED9EBA1),
+		vdupq_n_u32(0x8F1BBCDC), vdupq_n_u32(0xCA62C1D6),
+	};
+
+	uint32x4_t abcd = vld1q_u32(state);
+	uint32_t e0 = state[4];
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8 *block = blocks + i * 64;
+
+		uint32x4_t abcdsave = abcd;
+		uint32_t e0save = e0;
+
+		uint32x4_t msg[4];
+		for (int j = 0; j < 4; j++)
+			msg[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + j * 16)));
+
+		uint32_t e = e0;
+
+		for (int g = 0; g < 20; g++)
+		{
+			uint32x4_t wk = vaddq_u32(msg[g & 3], k[g / 5]);
+			uint32_t enext = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+			if (g < 5)
+				abcd = vsha1cq_u32(abcd, e, wk);
+			else if (g >= 10 && g < 15)
+				abcd = vsha1mq_u32(abcd, e, wk);
+			else
+				abcd = vsha1pq_u32(abcd, e, wk);
+
+			e = enext;
+
+			// Replace the words just used with the ones 16 words later.
+			if (g < 16)
+				msg[g & 3] = vsha1su1q_u32(vsha1su0q_u32(msg[g & 3], msg[(g + 1) & 3], msg[(g + 2) & 3]), msg[(g + 3) & 3]);
+		}
+
+		abcd = vaddq_u32(abcd, abcdsave);
+		e0 = e + e0save;
+	}
+
+	vst1q_u32(state, abcd);
+	state[4] = e0;
+}
+
+static void sha256BlocksARM(uint32 state[8], const uint8 *blocks, size_t count)
+{
+	uint32x4_t state0 = vld1q_u32(&state[0]);
+	uint32x4_t state1 = vld1q_u32(&state[4]);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8 *block = blocks + i * 64;
+
+		uint32x4_t abcdsave = state0;
+		uint32x4_t efghsave = state1;
+
+		uint32x4_t msg[4];
+		for (int j = 0; j < 4; j++)
+			msg[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + j * 16)));
+
+		for (int g = 0; g < 16; g++)
+		{
+			uint32x4_t wk = vaddq_u32(msg[g & 3], vld1q_u32(&sha256Constants[g * 4]));
+
+			// Replace the words just used with the ones 16 words later.
+			if (g < 12)
+				msg[g & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[g & 3], msg[(g + 1) & 3]), msg[(g + 2) & 3], msg[(g + 3) & 3]);
+
+			uint32x4_t abcd = state0;
+			state0 = vsha256hq_u32(state0, state1, wk);
+			state1 = vsha256h2q_u32(state1, abcd, wk);
+		}
+
+		state0 = vaddq_u32(state0, abcdsave);
+		state1 = vaddq_u32(state1, efghsave);
+	}
+
+	vst1q_u32(&state[0], state0);
+	vst1q_u32(&state[4], state1);
+}
+
+#endif // LOVE_HASH_SHA_ARM
+
+// Picks the fastest block function, after checking it against the portable
+// one on a test block.
+template <typename BlockFunction, size_t STATE_SIZE>
+static BlockFunction chooseBlockFunction(BlockFunction portable, BlockFunction accelerated, const uint32 *initial)
+{
+	if (accelerated == nullptr)
+		return portable;
+
+	uint8 block[128];
+	for (int i = 0; i < 128; i++)
+		block[i] = (uint8) (i * 7 + 3);
+
+	uint32 expected[STATE_SIZE];
+	uint32 actual[STATE_SIZE];
+	memcpy(expected, initial, sizeof(expected));
+	memcpy(actual, initial, sizeof(actual));
+
+	portable(expected, block, 2);
+	accelerated(actual, block, 2);
+
+	return memcmp(expected, actual, sizeof(expected)) == 0 ? accelerated : portable;
+}
+
+static const uint32 sha1Initial[5] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
 };
 
-/**
- * This implementation was based on the description in RFC-6234.
- **/
-// SHA-2: SHA-384 and SHA-512
-class SHA512 : public HashFunction
+static SHA1BlockFunction getSHA1BlockFunction()
 {
-private:
-	static const uint64 initial384[8];
-	static const uint64 initial512[8];
-	static const uint64 constants[80];
+	static SHA1BlockFunction function = []()
+	{
+		SHA1BlockFunction accelerated = nullptr;
+#if defined(LOVE_HASH_SHA_X86)
+		if (hasSHAInstructions())
+			accelerated = sha1BlocksX86;
+#elif defined(LOVE_HASH_SHA_ARM)
+		accelerated = sha1BlocksARM;
+#endif
+		return chooseBlockFunction<SHA1BlockFunction, 5>(sha1Blocks, accelerated, sha1Initial);
+	}();
+
+	return function;
+}
+
+static SHA256BlockFunction getSHA256BlockFunction()
+{
+	static SHA256BlockFunction function = []()
+	{
+		SHA256BlockFunction accelerated = nullptr;
+#if defined(LOVE_HASH_SHA_X86)
+		if (hasSHAInstructions())
+			accelerated = sha256BlocksX86;
+#elif defined(LOVE_HASH_SHA_ARM)
+		accelerated = sha256BlocksARM;
+#endif
+		return chooseBlockFunction<SHA256BlockFunction, 8>(sha256Blocks, accelerated, sha256Initial);
+	}();
+
+	return function;
+}
 
+class SHA1Context : public BlockContext<64, 8, true>
+{
 public:
-	bool isSupported(Function function) const override
+
+	SHA1Context()
+		: blockFunction(getSHA1BlockFunction())
 	{
-		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
+		memcpy(state, sha1Initial, sizeof(state));
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+protected:
+
+	void processBlocks(const uint8 *blocks, size_t count) override
 	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+		blockFunction(state, blocks, count);
+	}
+
+	void getDigest(HashFunction::Value &output) override
+	{
+		for (int i = 0; i < 5; i++)
+			storeBE32(&output.data[i * 4], state[i]);
+		output.size = 20;
+	}
+
+private:
+
+	SHA1BlockFunction blockFunction;
+	uint32 state[5];
+
+}; // SHA1Context
 
-		uint64 intermediates[8];
-		if (function == FUNCTION_SHA384)
-			memcpy(intermediates, initial384, sizeof(intermediates));
+// SHA-2: SHA-224 and SHA-256
+class SHA256Context : public BlockContext<64, 8, true>
+{
+public:
+
+	SHA256Context(HashFunction::Function function)
+		: blockFunction(getSHA256BlockFunction())
+		, hashLength(function == HashFunction::FUNCTION_SHA224 ? 28 : 32)
+	{
+		if (function == HashFunction::FUNCTION_SHA224)
+			memcpy(state, sha224Initial, sizeof(state));
 		else
-			memcpy(intermediates, initial512, sizeof(intermediates));
+			memcpy(state, sha256Initial, sizeof(state));
+	}
+
+protected:
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 16, 128);
+	void processBlocks(const uint8 *blocks, size_t count) override
+	{
+		blockFunction(state, blocks, count);
+	}
 
-		uint64 *padded = new uint64[paddedLength / 8];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+	void getDigest(HashFunction::Value &output) override
+	{
+		for (int i = 0; i < hashLength; i += 4)
+			storeBE32(&output.data[i], state[i / 4]);
+		output.size = hashLength;
+	}
+
+private:
+
+	SHA256BlockFunction blockFunction;
+	int hashLength;
+	uint32 state[8];
+
+}; // SHA256Context
+
+/**
+ * This implementation was based on the description in RFC-6234.
+ **/
+// SHA-2: SHA-384 and SHA-512
+class SHA512Context : public BlockContext<128, 16, true>
+{
+public:
+
+	SHA512Context(HashFunction::Function function)
+		: hashLength(function == HashFunction::FUNCTION_SHA384 ? 48 : 64)
+	{
+		if (function == HashFunction::FUNCTION_SHA384)
+			memcpy(state, sha384Initial, sizeof(state));
+		else
+			memcpy(state, sha512Initial, sizeof(state));
+	}
 
-		// Append length in bits (big endian), note we only write a 64-bit int, so
-		// we have filled the first 8 bytes with zeroes
-		uint64 bit_length = length * 8;
-		for (int i = 0; i < 8; ++i)
-			*(((uint8*)padded) + (paddedLength - 8 + i)) = (bit_length >> (56 - i * 8)) & 0xFF;
+protected:
 
+	void processBlocks(const uint8 *blocks, size_t count) override
+	{
 		// Allocate our extended words
 		uint64 words[80];
 
-		for (uint64 i = 0; i < paddedLength/8; i += 16)
+		for (size_t i = 0; i < count; i++)
 		{
-			uint64 *chunk = &padded[i];
+			const uint8 *block = blocks + i * 128;
+
 			for (int j = 0; j < 16; ++j)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 56) & 0xFF;
-				c[1] = (chunk[j] >> 48) & 0xFF;
-				c[2] = (chunk[j] >> 40) & 0xFF;
-				c[3] = (chunk[j] >> 32) & 0xFF;
-				c[4] = (chunk[j] >> 24) & 0xFF;
-				c[5] = (chunk[j] >> 16) & 0xFF;
-				c[6] = (chunk[j] >>  8) & 0xFF;
-				c[7] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadBE64(block + j * 8);
 			for (int j = 16; j < 80; ++j)
 			{
 				words[j] = words[j-7] + words[j-16];
@@ -495,18 +893,18 @@ public:
 				words[j] += rightrot(words[j-15], 1) ^ rightrot(words[j-15], 8) ^ (words[j-15] >> 7);
 			}
 
-			uint64 A = intermediates[0];
-			uint64 B = intermediates[1];
-			uint64 C = intermediates[2];
-			uint64 D = intermediates[3];
-			uint64 E = intermediates[4];
-			uint64 F = intermediates[5];
-			uint64 G = intermediates[6];
-			uint64 H = intermediates[7];
+			uint64 A = state[0];
+			uint64 B = state[1];
+			uint64 C = state[2];
+			uint64 D = state[3];
+			uint64 E = state[4];
+			uint64 F = state[5];
+			uint64 G = state[6];
+			uint64 H = state[7];
 
 			for (int j = 0; j < 80; ++j)
 			{
-				uint64 temp1 = H + constants[j] + words[j];
+				uint64 temp1 = H + sha512Constants[j] + words[j];
 				temp1 += rightrot(E, 14) ^ rightrot(E, 18) ^ rightrot(E, 41);
 				temp1 += (E & F) ^ (~E & G);
 				uint64 temp2 = rightrot(A, 28) ^ rightrot(A, 34) ^ rightrot(A, 39);
@@ -521,70 +919,191 @@ public:
 				A = temp1 + temp2;
 			}
 
-			intermediates[0] += A;
-			intermediates[1] += B;
-			intermediates[2] += C;
-			intermediates[3] += D;
-			intermediates[4] += E;
-			intermediates[5] += F;
-			intermediates[6] += G;
-			intermediates[7] += H;
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
+			state[4] += E;
+			state[5] += F;
+			state[6] += G;
+			state[7] += H;
 		}
+	}
+
+	void getDigest(HashFunction::Value &output) override
+	{
+		for (int i = 0; i < hashLength; i += 8)
+			storeBE64(&output.data[i], state[i / 8]);
+		output.size = hashLength;
+	}
+
+private:
 
-		delete[] padded;
+	int hashLength;
+	uint64 state[8];
 
-		int hashlength = 64;
-		if (function == FUNCTION_SHA384)
-			hashlength = 48;
+}; // SHA512Context
 
-		for (int i = 0; i < hashlength; i += 8)
+// Non-cryptographic, but much faster. Results are stored big-endian, like
+// xxHash's canonical representation.
+class XXHashContext : public HashFunction::Context
+{
+public:
+
+	XXHashContext(HashFunction::Function function)
+		: state32(nullptr)
+		, state64(nullptr)
+	{
+		if (function == HashFunction::FUNCTION_XXH32)
 		{
-			output.data[i+0] = (intermediates[i/8] >> 56) & 0xFF;
-			output.data[i+1] = (intermediates[i/8] >> 48) & 0xFF;
-			output.data[i+2] = (intermediates[i/8] >> 40) & 0xFF;
-			output.data[i+3] = (intermediates[i/8] >> 32) & 0xFF;
-			output.data[i+4] = (intermediates[i/8] >> 24) & 0xFF;
-			output.data[i+5] = (intermediates[i/8] >> 16) & 0xFF;
-			output.data[i+6] = (intermediates[i/8] >>  8) & 0xFF;
-			output.data[i+7] = (intermediates[i/8] >>  0) & 0xFF;
+			state32 = XXH32_createState();
+			XXH32_reset(state32, 0);
 		}
+		else
+		{
+			state64 = XXH64_createState();
+			XXH64_reset(state64, 0);
+		}
+	}
+
+	virtual ~XXHashContext()
+	{
+		if (state32 != nullptr)
+			XXH32_freeState(state32);
+		if (state64 != nullptr)
+			XXH64_freeState(state64);
+	}
+
+	void update(const char *input, uint64 length) override
+	{
+		if (state32 != nullptr)
+			XXH32_update(state32, input, (size_t) length);
+		else
+			XXH64_update(state64, input, (size_t) length);
+	}
+
+	void finish(HashFunction::Value &output) override
+	{
+		if (state32 != nullptr)
+		{
+			storeBE32(output.data, XXH32_digest(state32));
+			output.size = 4;
+		}
+		else
+		{
+			storeBE64(output.data, XXH64_digest(state64));
+			output.size = 8;
+		}
+	}
+
+private:
+
+	XXH32_state_t *state32;
+	XXH64_state_t *state64;
+
+}; // XXHashContext
+
+class MD5 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_MD5;
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (function != FUNCTION_MD5)
+			throw love::Exception("Hash function not supported by MD5 implementation");
+
+		return new MD5Context();
+	}
+} md5;
+
+class SHA1 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA1;
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (function != FUNCTION_SHA1)
+			throw love::Exception("Hash function not supported by SHA1 implementation");
+
+		return new SHA1Context();
+	}
+} sha1;
+
+class SHA256 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
 
-		output.size = hashlength;
+		return new SHA256Context(function);
+	}
+} sha256;
+
+class SHA512 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+
+		return new SHA512Context(function);
 	}
 } sha512;
 
-const uint64 SHA512::initial384[8] = {
-	0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
-	0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
-};
+class XXHash : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_XXH32 || function == FUNCTION_XXH64;
+	}
 
-const uint64 SHA512::initial512[8] = {
-	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
-	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
-};
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by xxHash implementation");
 
-const uint64 SHA512::constants[80] = {
-	0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
-	0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
-	0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
-	0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
-	0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
-	0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
-	0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
-	0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
-	0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
-	0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
-	0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
-	0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
-	0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
-	0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
-	0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
-	0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
-	0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
-	0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
-	0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
-	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
-};
+		if (function == FUNCTION_XXH32)
+		{
+			storeBE32(output.data, XXH32(input, (size_t) length, 0));
+			output.size = 4;
+		}
+		else
+		{
+			storeBE64(output.data, XXH64(input, (size_t) length, 0));
+			output.size = 8;
+		}
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by xxHash implementation");
+
+		return new XXHashContext(function);
+	}
+} xxhash;
 
 } // impl
 }
@@ -603,6 +1122,9 @@ HashFunction *HashFunction::getHashFunction(Function function)
 	case FUNCTION_SHA384:
 	case FUNCTION_SHA512:
 		return &impl::sha512;
+	case FUNCTION_XXH32:
+	case FUNCTION_XXH64:
+		return &impl::xxhash;
 	case FUNCTION_MAX_ENUM:
 		return nullptr;
 	// No default for compiler warnings
@@ -632,6 +1154,8 @@ StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM>::Entry HashFu
 	{"sha256", FUNCTION_SHA256},
 	{"sha384", FUNCTION_SHA384},
 	{"sha512", FUNCTION_SHA512},
+	{"xxh32", FUNCTION_XXH32},
+	{"xxh64", FUNCTION_XXH64},
 };
 
 StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM> HashFunction::functionNames(HashFunction::functionEntries, sizeof(HashFunction::functionEntries));
@@ -42,6 +42,8 @@ public:
 		FUNCTION_SHA256,
 		FUNCTION_SHA384,
 		FUNCTION_SHA512,
+		FUNCTION_XXH32,
+		FUNCTION_XXH64,
 		FUNCTION_MAX_ENUM
 	};
 
@@ -51,6 +53,24 @@ public:
 		size_t size;
 	};
 
+	/**
+	 * Hashes input a piece at a time. The result is the same as hashing all of
+	 * the input at once.
+	 **/
+	class Context
+	{
+	public:
+
+		virtual ~Context() {}
+
+		virtual void update(const char *input, uint64 length) = 0;
+
+		/**
+		 * Gets the result. The Context can't be updated afterwards.
+		 **/
+		virtual void finish(Value &output) = 0;
+	};
+
 	/**
 	 * Get a HashFunction instance for the given function.
 	 *
@@ -70,7 +90,15 @@ public:
 	 * @param[in] length The length of the input data.
 	 * @param[out] output The result of the hash function.
 	 **/
-	virtual void hash(Function function, const char *input, uint64 length, Value &output) const = 0;
+	virtual void hash(Function function, const char *input, uint64 length, Value &output) const;
+
+	/**
+	 * Creates a Context for hashing input incrementally.
+	 *
+	 * @param[in] function The selected hash function.
+	 * @return A new Context, to be deleted by the caller.
+	 **/
+	virtual Context *newContext(Function function) const = 0;
 
 	/**
 	 * @param[in] function The requested hash function.
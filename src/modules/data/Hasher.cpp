@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Hasher.h"
+#include "common/Exception.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+love::Type Hasher::type("Hasher", &Object::type);
+
+Hasher::Hasher(HashFunction::Function function)
+	: function(function)
+	, finished(false)
+{
+	HashFunction *hashfunction = HashFunction::getHashFunction(function);
+	if (hashfunction == nullptr)
+		throw love::Exception("Invalid hash function.");
+
+	context.reset(hashfunction->newContext(function));
+}
+
+Hasher::~Hasher()
+{
+}
+
+void Hasher::update(const char *data, size_t size)
+{
+	love::thread::Lock lock(mutex);
+
+	if (finished)
+		throw love::Exception("The Hasher has already been finished.");
+
+	context->update(data, size);
+}
+
+void Hasher::update(Stream *stream, size_t chunkSize)
+{
+	if (!stream->isReadable())
+		throw love::Exception("The stream must be readable.");
+
+	if (chunkSize == 0)
+		throw love::Exception("Chunk size must be greater than zero.");
+
+	std::vector<char> buffer(chunkSize);
+
+	while (true)
+	{
+		int64 count = stream->read(buffer.data(), (int64) chunkSize);
+		if (count <= 0)
+			break;
+
+		update(buffer.data(), (size_t) count);
+	}
+}
+
+void Hasher::finish(HashFunction::Value &output)
+{
+	love::thread::Lock lock(mutex);
+
+	if (finished)
+		throw love::Exception("The Hasher has already been finished.");
+
+	context->finish(output);
+	finished = true;
+}
+
+bool Hasher::isFinished() const
+{
+	love::thread::Lock lock(mutex);
+	return finished;
+}
+
+} // data
+} // love
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Stream.h"
+#include "thread/threads.h"
+#include "HashFunction.h"
+
+// C++
+#include <memory>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Hashes data incrementally, so large inputs such as files can be hashed a
+ * chunk at a time instead of being loaded into memory all at once.
+ **/
+class Hasher : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	Hasher(HashFunction::Function function);
+	virtual ~Hasher();
+
+	HashFunction::Function getFunction() const { return function; }
+
+	/**
+	 * Adds the given bytes to the hash.
+	 **/
+	void update(const char *data, size_t size);
+
+	/**
+	 * Reads the stream from its current position until it runs out, adding
+	 * everything read to the hash.
+	 * @param chunkSize The number of bytes read from the stream at a time.
+	 **/
+	void update(Stream *stream, size_t chunkSize);
+
+	/**
+	 * Completes the hash. No more data can be added afterwards.
+	 **/
+	void finish(HashFunction::Value &output);
+
+	bool isFinished() const;
+
+private:
+
+	HashFunction::Function function;
+	std::unique_ptr<HashFunction::Context> context;
+
+	bool finished;
+
+	love::thread::MutexRef mutex;
+
+}; // Hasher
+
+} // data
+} // love
@@ -0,0 +1,264 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "PackFormat.h"
+#include "common/Exception.h"
+
+// C++
+#include <cstddef>
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+love::Type PackFormat::type("PackFormat", &Object::type);
+
+static bool isNativeLittleEndian()
+{
+	const uint16 v = 1;
+	uint8 b = 0;
+	memcpy(&b, &v, 1);
+	return b == 1;
+}
+
+static const bool nativeLittleEndian = isNativeLittleEndian();
+
+// Matches the maximum native alignment used by love.data.pack.
+struct MaxAlignTest
+{
+	char c;
+	union { double d; void *p; int64 i; } u;
+};
+
+static const int MAX_NATIVE_ALIGN = (int) offsetof(MaxAlignTest, u);
+
+static bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static int parseNumber(const char *&fmt, int def)
+{
+	if (!isDigit(*fmt))
+		return def;
+
+	int n = 0;
+	do
+	{
+		n = n * 10 + (*(fmt++) - '0');
+	} while (isDigit(*fmt) && n <= (0x7FFFFFFF - 9) / 10);
+
+	return n;
+}
+
+static int parseIntSize(const char *&fmt, int def)
+{
+	int size = parseNumber(fmt, def);
+	if (size > PackFormat::MAX_INT_SIZE || size <= 0)
+		throw love::Exception("Integral size (%d) out of limits [1,%d] in pack format.", size, PackFormat::MAX_INT_SIZE);
+	return size;
+}
+
+/**
+ * Parses the next option into f. Returns false for options that only change
+ * the configuration (endianness, alignment) or are spaces.
+ **/
+static bool parseField(const char *&fmt, PackFormat::Field &f, bool &littleEndian, int &maxAlign)
+{
+	char opt = *(fmt++);
+
+	f = PackFormat::Field();
+	f.littleEndian = littleEndian;
+
+	switch (opt)
+	{
+	case 'b': f.type = PackFormat::FIELD_INT; f.size = sizeof(char); break;
+	case 'B': f.type = PackFormat::FIELD_UINT; f.size = sizeof(char); break;
+	case 'h': f.type = PackFormat::FIELD_INT; f.size = sizeof(short); break;
+	case 'H': f.type = PackFormat::FIELD_UINT; f.size = sizeof(short); break;
+	case 'l': f.type = PackFormat::FIELD_INT; f.size = sizeof(long); break;
+	case 'L': f.type = PackFormat::FIELD_UINT; f.size = sizeof(long); break;
+	case 'j': f.type = PackFormat::FIELD_INT; f.size = sizeof(int64); break;
+	case 'J': f.type = PackFormat::FIELD_UINT; f.size = sizeof(int64); break;
+	case 'T': f.type = PackFormat::FIELD_UINT; f.size = sizeof(size_t); break;
+	case 'f': f.type = PackFormat::FIELD_FLOAT; f.size = sizeof(float); break;
+	case 'd': f.type = PackFormat::FIELD_FLOAT; f.size = sizeof(double); break;
+	case 'n': f.type = PackFormat::FIELD_FLOAT; f.size = sizeof(double); break;
+	case 'i': f.type = PackFormat::FIELD_INT; f.size = parseIntSize(fmt, sizeof(int)); break;
+	case 'I': f.type = PackFormat::FIELD_UINT; f.size = parseIntSize(fmt, sizeof(int)); break;
+	case 's': f.type = PackFormat::FIELD_STRING; f.size = parseIntSize(fmt, sizeof(size_t)); break;
+	case 'c':
+		f.type = PackFormat::FIELD_CHAR;
+		f.size = parseNumber(fmt, -1);
+		if (f.size == -1)
+			throw love::Exception("Missing size for format option 'c'.");
+		break;
+	case 'z': f.type = PackFormat::FIELD_ZSTRING; f.size = 0; break;
+	case 'x': f.type = PackFormat::FIELD_PADDING; f.size = 1; break;
+	case 'X':
+	{
+		// Aligns to the size of the following option, which is otherwise
+		// ignored.
+		PackFormat::Field next;
+		if (*fmt == '\0' || !parseField(fmt, next, littleEndian, maxAlign) || next.type == PackFormat::FIELD_CHAR || next.size == 0)
+			throw love::Exception("Invalid next option for option 'X' in pack format.");
+		f.type = PackFormat::FIELD_ALIGN;
+		f.size = 0;
+		f.align = next.size;
+		break;
+	}
+	case ' ': return false;
+	case '<': littleEndian = true; return false;
+	case '>': littleEndian = false; return false;
+	case '=': littleEndian = nativeLittleEndian; return false;
+	case '!': maxAlign = parseIntSize(fmt, MAX_NATIVE_ALIGN); return false;
+	default:
+		throw love::Exception("Invalid format option '%c' in pack format.", opt);
+	}
+
+	if (f.type != PackFormat::FIELD_ALIGN)
+		f.align = f.type == PackFormat::FIELD_CHAR ? 1 : f.size;
+
+	if (f.align > maxAlign)
+		f.align = maxAlign;
+	if (f.align > 1 && (f.align & (f.align - 1)) != 0)
+		throw love::Exception("Pack format asks for alignment not power of 2.");
+
+	return true;
+}
+
+PackFormat::PackFormat(const std::string &format)
+	: format(format)
+	, valueCount(0)
+	, fixedSize(true)
+	, size(0)
+{
+	bool littleEndian = nativeLittleEndian;
+	int maxAlign = 1;
+
+	const char *fmt = format.c_str();
+
+	while (*fmt != '\0')
+	{
+		Field f;
+		if (!parseField(fmt, f, littleEndian, maxAlign))
+			continue;
+
+		if (fixedSize)
+		{
+			size += getAlignPadding(size, f.align);
+			f.offset = size;
+			size += f.size;
+		}
+
+		if (f.type == FIELD_STRING || f.type == FIELD_ZSTRING)
+			fixedSize = false;
+
+		if (f.type != FIELD_PADDING && f.type != FIELD_ALIGN)
+			valueCount++;
+
+		fields.push_back(f);
+	}
+
+	if (!fixedSize)
+		size = 0;
+}
+
+PackFormat::~PackFormat()
+{
+}
+
+bool PackFormat::readInt(const uint8 *src, int size, bool littleEndian, bool issigned, int64 &result)
+{
+	uint64 v = 0;
+	int limit = size <= 8 ? size : 8;
+
+	for (int i = limit - 1; i >= 0; i--)
+		v = (v << 8) | src[littleEndian ? i : size - 1 - i];
+
+	if (size < 8)
+	{
+		if (issigned)
+		{
+			uint64 mask = (uint64) 1 << (size * 8 - 1);
+			v = (v ^ mask) - mask;
+		}
+	}
+	else if (size > 8)
+	{
+		uint8 mask = (!issigned || (int64) v >= 0) ? 0 : 0xFF;
+		for (int i = limit; i < size; i++)
+		{
+			if (src[littleEndian ? i : size - 1 - i] != mask)
+				return false;
+		}
+	}
+
+	result = (int64) v;
+	return true;
+}
+
+void PackFormat::writeInt(uint8 *dst, uint64 value, int size, bool littleEndian, bool negative)
+{
+	for (int i = 0; i < size; i++)
+	{
+		uint8 b = i < 8 ? (uint8) (value >> (i * 8)) : (negative ? 0xFF : 0);
+		dst[littleEndian ? i : size - 1 - i] = b;
+	}
+}
+
+double PackFormat::readFloat(const uint8 *src, int size, bool littleEndian)
+{
+	uint8 bytes[8];
+	for (int i = 0; i < size; i++)
+		bytes[i] = src[littleEndian == nativeLittleEndian ? i : size - 1 - i];
+
+	if (size == sizeof(float))
+	{
+		float f;
+		memcpy(&f, bytes, sizeof(float));
+		return f;
+	}
+
+	double d;
+	memcpy(&d, bytes, sizeof(double));
+	return d;
+}
+
+void PackFormat::writeFloat(uint8 *dst, double value, int size, bool littleEndian)
+{
+	uint8 bytes[8];
+	if (size == sizeof(float))
+	{
+		float f = (float) value;
+		memcpy(bytes, &f, sizeof(float));
+	}
+	else
+		memcpy(bytes, &value, sizeof(double));
+
+	for (int i = 0; i < size; i++)
+		dst[littleEndian == nativeLittleEndian ? i : size - 1 - i] = bytes[i];
+}
+
+} // data
+} // love
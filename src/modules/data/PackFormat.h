@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * A love.data.pack format string, parsed once so it can be used to pack and
+ * unpack many values (or records of values) without parsing it each time.
+ *
+ * Alignment ('!' and 'X') is relative to the start of each packed record,
+ * rather than the start of the string or Data it's in.
+ **/
+class PackFormat : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum FieldType
+	{
+		FIELD_INT,
+		FIELD_UINT,
+		FIELD_FLOAT,
+		FIELD_CHAR, // fixed-size string
+		FIELD_STRING, // string with a size prefix
+		FIELD_ZSTRING, // zero-terminated string
+		FIELD_PADDING, // size bytes of padding
+		FIELD_ALIGN, // padding up to a multiple of align
+	};
+
+	struct Field
+	{
+		FieldType type;
+		int size;
+		int align;
+		bool littleEndian;
+
+		// Offset from the start of the record, only valid if the format has
+		// a fixed size.
+		size_t offset;
+	};
+
+	static const int MAX_INT_SIZE = 16;
+
+	PackFormat(const std::string &format);
+	virtual ~PackFormat();
+
+	const std::string &getFormat() const { return format; }
+	const std::vector<Field> &getFields() const { return fields; }
+
+	// The number of values a record packs or unpacks.
+	int getValueCount() const { return valueCount; }
+
+	// Formats with strings that have a size prefix or are zero-terminated
+	// don't have a fixed size.
+	bool isFixedSize() const { return fixedSize; }
+	size_t getSize() const { return size; }
+
+	static size_t getAlignPadding(size_t pos, int align)
+	{
+		return align > 1 ? (align - (pos & (align - 1))) & (align - 1) : 0;
+	}
+
+	/**
+	 * Reads an integer of 1 to MAX_INT_SIZE bytes. Returns false if it
+	 * doesn't fit in 64 bits.
+	 **/
+	static bool readInt(const uint8 *src, int size, bool littleEndian, bool issigned, int64 &result);
+	static void writeInt(uint8 *dst, uint64 value, int size, bool littleEndian, bool negative);
+
+	static double readFloat(const uint8 *src, int size, bool littleEndian);
+	static void writeFloat(uint8 *dst, double value, int size, bool littleEndian);
+
+private:
+
+	std::string format;
+	std::vector<Field> fields;
+	int valueCount;
+	bool fixedSize;
+	size_t size;
+
+}; // PackFormat
+
+} // data
+} // love
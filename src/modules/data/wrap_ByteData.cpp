@@ -135,6 +135,108 @@ int w_ByteData_setUInt32(lua_State *L)
 	return w_ByteData_setT<uint32>(L);
 }
 
+static ByteData::AtomicType luax_checkatomictype(lua_State *L, int idx)
+{
+	const char *str = luaL_checkstring(L, idx);
+	ByteData::AtomicType type = ByteData::ATOMIC_MAX_ENUM;
+	if (!ByteData::getConstant(str, type))
+		luax_enumerror(L, "atomic value type", ByteData::getConstants(type), str);
+	return type;
+}
+
+static ByteData::AtomicOrder luax_optatomicorder(lua_State *L, int idx)
+{
+	ByteData::AtomicOrder order = ByteData::ATOMIC_ORDER_SEQCST;
+	if (lua_isnoneornil(L, idx))
+		return order;
+
+	const char *str = luaL_checkstring(L, idx);
+	if (!ByteData::getConstant(str, order))
+		luax_enumerror(L, "memory order", ByteData::getConstants(order), str);
+	return order;
+}
+
+static size_t luax_checkatomicoffset(lua_State *L, int idx)
+{
+	int64 offset = (int64) luaL_checknumber(L, idx);
+	if (offset < 0)
+		luaL_error(L, "The given offset must be within the ByteData and aligned to the size of the value.");
+	return (size_t) offset;
+}
+
+int w_ByteData_atomicLoad(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	ByteData::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = luax_checkatomicoffset(L, 3);
+	ByteData::AtomicOrder order = luax_optatomicorder(L, 4);
+
+	int64 value = 0;
+	luax_catchexcept(L, [&]() { value = t->atomicLoad(type, offset, order); });
+
+	lua_pushnumber(L, (lua_Number) value);
+	return 1;
+}
+
+int w_ByteData_atomicStore(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	ByteData::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = luax_checkatomicoffset(L, 3);
+	int64 value = (int64) luaL_checknumber(L, 4);
+	ByteData::AtomicOrder order = luax_optatomicorder(L, 5);
+
+	luax_catchexcept(L, [&]() { t->atomicStore(type, offset, value, order); });
+	return 0;
+}
+
+int w_ByteData_atomicAdd(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	ByteData::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = luax_checkatomicoffset(L, 3);
+	int64 value = (int64) luaL_checknumber(L, 4);
+	ByteData::AtomicOrder order = luax_optatomicorder(L, 5);
+
+	int64 previous = 0;
+	luax_catchexcept(L, [&]() { previous = t->atomicAdd(type, offset, value, order); });
+
+	lua_pushnumber(L, (lua_Number) previous);
+	return 1;
+}
+
+int w_ByteData_atomicExchange(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	ByteData::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = luax_checkatomicoffset(L, 3);
+	int64 value = (int64) luaL_checknumber(L, 4);
+	ByteData::AtomicOrder order = luax_optatomicorder(L, 5);
+
+	int64 previous = 0;
+	luax_catchexcept(L, [&]() { previous = t->atomicExchange(type, offset, value, order); });
+
+	lua_pushnumber(L, (lua_Number) previous);
+	return 1;
+}
+
+int w_ByteData_atomicCompareExchange(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	ByteData::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = luax_checkatomicoffset(L, 3);
+	int64 expected = (int64) luaL_checknumber(L, 4);
+	int64 desired = (int64) luaL_checknumber(L, 5);
+	ByteData::AtomicOrder order = luax_optatomicorder(L, 6);
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = t->atomicCompareExchange(type, offset, expected, desired, order); });
+
+	luax_pushboolean(L, success);
+	lua_pushnumber(L, (lua_Number) expected);
+	return 2;
+}
+
 static const luaL_Reg w_ByteData_functions[] =
 {
 	{ "clone", w_ByteData_clone },
@@ -147,6 +249,11 @@ static const luaL_Reg w_ByteData_functions[] =
 	{ "setUInt16", w_ByteData_setUInt16 },
 	{ "setInt32", w_ByteData_setInt32 },
 	{ "setUInt32", w_ByteData_setUInt32 },
+	{ "atomicLoad", w_ByteData_atomicLoad },
+	{ "atomicStore", w_ByteData_atomicStore },
+	{ "atomicAdd", w_ByteData_atomicAdd },
+	{ "atomicExchange", w_ByteData_atomicExchange },
+	{ "atomicCompareExchange", w_ByteData_atomicCompareExchange },
 	{ 0, 0 }
 };
 
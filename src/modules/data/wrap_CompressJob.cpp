@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_CompressJob.h"
+
+namespace love
+{
+namespace data
+{
+
+CompressJob *luax_checkcompressjob(lua_State *L, int idx)
+{
+	return luax_checktype<CompressJob>(L, idx);
+}
+
+int w_CompressJob_isComplete(lua_State *L)
+{
+	CompressJob *j = luax_checkcompressjob(L, 1);
+	luax_pushboolean(L, j->isComplete());
+	return 1;
+}
+
+int w_CompressJob_wait(lua_State *L)
+{
+	CompressJob *j = luax_checkcompressjob(L, 1);
+	j->wait();
+	return 0;
+}
+
+int w_CompressJob_getResult(lua_State *L)
+{
+	CompressJob *j = luax_checkcompressjob(L, 1);
+	luax_pushtype(L, j->getResult());
+	return 1;
+}
+
+int w_CompressJob_getError(lua_State *L)
+{
+	CompressJob *j = luax_checkcompressjob(L, 1);
+	std::string err = j->getError();
+	if (err.empty())
+		lua_pushnil(L);
+	else
+		luax_pushstring(L, err);
+	return 1;
+}
+
+static const luaL_Reg w_CompressJob_functions[] =
+{
+	{ "isComplete", w_CompressJob_isComplete },
+	{ "wait", w_CompressJob_wait },
+	{ "getResult", w_CompressJob_getResult },
+	{ "getError", w_CompressJob_getError },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_compressjob(lua_State *L)
+{
+	return luax_register_type(L, &CompressJob::type, w_CompressJob_functions, nullptr);
+}
+
+} // data
+} // love
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressionStream.h"
+#include "wrap_DataModule.h"
+#include "DataModule.h"
+
+namespace love
+{
+namespace data
+{
+
+CompressionStream *luax_checkcompressionstream(lua_State *L, int idx)
+{
+	return luax_checktype<CompressionStream>(L, idx);
+}
+
+static int pushOutput(lua_State *L, ContainerType ctype, const std::vector<char> &out)
+{
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *data = nullptr;
+		luax_catchexcept(L, [&]() { data = new ByteData(out.data(), out.size()); });
+		luax_pushtype(L, data);
+		data->release();
+	}
+	else
+		lua_pushlstring(L, out.data(), out.size());
+
+	return 1;
+}
+
+int w_CompressionStream_push(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	const char *bytes = nullptr;
+	size_t size = 0;
+
+	if (luax_istype(L, 3, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 3);
+		bytes = (const char *) data->getData();
+		size = data->getSize();
+	}
+	else
+		bytes = luaL_checklstring(L, 3, &size);
+
+	std::vector<char> out;
+	luax_catchexcept(L, [&]() { t->push(bytes, size, out); });
+
+	return pushOutput(L, ctype, out);
+}
+
+int w_CompressionStream_finish(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	std::vector<char> out;
+	luax_catchexcept(L, [&]() { t->finish(out); });
+
+	return pushOutput(L, ctype, out);
+}
+
+int w_CompressionStream_process(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	Stream *source = luax_checktype<Stream>(L, 2);
+	Stream *dest = luax_checktype<Stream>(L, 3);
+
+	lua_Integer chunksize = luaL_optinteger(L, 4, 1024 * 1024);
+	if (chunksize <= 0)
+		return luaL_error(L, "Chunk size must be greater than zero.");
+
+	luax_catchexcept(L, [&]() { t->process(source, dest, (size_t) chunksize); });
+	return 0;
+}
+
+int w_CompressionStream_isFinished(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	luax_pushboolean(L, t->isFinished());
+	return 1;
+}
+
+int w_CompressionStream_getMode(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+
+	const char *str = nullptr;
+	if (!CompressionStream::getConstant(t->getMode(), str))
+		return luaL_error(L, "Unknown compression stream mode.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_CompressionStream_getFormat(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+
+	const char *fname = nullptr;
+	if (!Compressor::getConstant(t->getFormat(), fname))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(Compressor::FORMAT_MAX_ENUM), fname);
+
+	lua_pushstring(L, fname);
+	return 1;
+}
+
+static const luaL_Reg w_CompressionStream_functions[] =
+{
+	{ "push", w_CompressionStream_push },
+	{ "finish", w_CompressionStream_finish },
+	{ "process", w_CompressionStream_process },
+	{ "isFinished", w_CompressionStream_isFinished },
+	{ "getMode", w_CompressionStream_getMode },
+	{ "getFormat", w_CompressionStream_getFormat },
+	{ 0, 0 },
+};
+
+extern "C" int luaopen_compressionstream(lua_State *L)
+{
+	return luax_register_type(L, &CompressionStream::type, w_CompressionStream_functions, nullptr);
+}
+
+} // data
+} // love
@@ -19,9 +19,14 @@
  **/
 
 #include "wrap_Data.h"
+#include "ByteData.h"
+#include "common/Exception.h"
 #include "common/int.h"
 #include "thread/threads.h"
 
+// C++
+#include <cstring>
+
 // Put the Lua code directly into a raw string literal.
 static const char data_lua[] =
 #include "wrap_Data.lua"
@@ -106,16 +111,37 @@ static int w_Data_getT(lua_State* L)
 	int64 offset = (int64)luaL_checknumber(L, 2);
 	int count = (int)luaL_optinteger(L, 3, 1);
 
+	// Bytes between the start of each value, to read one field of a series
+	// of records.
+	int64 stride = (int64)luaL_optinteger(L, 4, sizeof(T));
+
 	if (count <= 0)
 		return luaL_error(L, "Invalid count parameter (must be greater than 0)");
 
-	if (offset < 0 || offset + sizeof(T) * count > t->getSize())
+	if (stride < (int64)sizeof(T))
+		return luaL_error(L, "Invalid stride parameter (must be at least the size of the value)");
+
+	if (offset < 0 || offset + stride * (count - 1) + (int64)sizeof(T) > (int64)t->getSize())
 		return luaL_error(L, "The given offset and count parameters don't fit within the Data's size.");
 
-	auto data = (const T*)((uint8*)t->getData() + offset);
+	luaL_checkstack(L, count, nullptr);
+
+	auto data = (const uint8*)t->getData() + offset;
 
-	for (int i = 0; i < count; i++)
-		lua_pushnumber(L, (lua_Number)data[i]);
+	if (stride == (int64)sizeof(T))
+	{
+		for (int i = 0; i < count; i++)
+			lua_pushnumber(L, (lua_Number)((const T*)data)[i]);
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+		{
+			T v;
+			memcpy(&v, data + stride * i, sizeof(T));
+			lua_pushnumber(L, (lua_Number)v);
+		}
+	}
 
 	return count;
 }
@@ -164,6 +190,16 @@ int w_Data_getUInt32(lua_State* L)
 struct FFI_Data
 {
 	void *(*getFFIPointer)(Proxy *p);
+	bool (*atomic)(Proxy *p, int op, int type, int order, double offset, double value, double desired, double *result);
+};
+
+enum FFIAtomicOp
+{
+	FFI_ATOMIC_LOAD,
+	FFI_ATOMIC_STORE,
+	FFI_ATOMIC_ADD,
+	FFI_ATOMIC_EXCHANGE,
+	FFI_ATOMIC_COMPARE_EXCHANGE,
 };
 
 static FFI_Data ffifuncs =
@@ -172,7 +208,53 @@ static FFI_Data ffifuncs =
 	{
 		auto data = luax_ffi_checktype<Data>(p);
 		return data != nullptr ? data->getData() : nullptr;
-	}
+	},
+
+	// atomic. Returns false for invalid arguments, so the Lua side can call
+	// the regular method to raise the error.
+	[](Proxy *p, int op, int type, int order, double offset, double value, double desired, double *result) -> bool
+	{
+		auto data = luax_ffi_checktype<ByteData>(p);
+		if (data == nullptr || offset < 0 || type < 0 || type >= ByteData::ATOMIC_MAX_ENUM || order < 0 || order >= ByteData::ATOMIC_ORDER_MAX_ENUM)
+			return false;
+
+		auto atype = (ByteData::AtomicType) type;
+		auto aorder = (ByteData::AtomicOrder) order;
+
+		try
+		{
+			switch (op)
+			{
+			case FFI_ATOMIC_LOAD:
+				result[0] = (double) data->atomicLoad(atype, (size_t) offset, aorder);
+				break;
+			case FFI_ATOMIC_STORE:
+				data->atomicStore(atype, (size_t) offset, (int64) value, aorder);
+				break;
+			case FFI_ATOMIC_ADD:
+				result[0] = (double) data->atomicAdd(atype, (size_t) offset, (int64) value, aorder);
+				break;
+			case FFI_ATOMIC_EXCHANGE:
+				result[0] = (double) data->atomicExchange(atype, (size_t) offset, (int64) value, aorder);
+				break;
+			case FFI_ATOMIC_COMPARE_EXCHANGE:
+			{
+				int64 expected = (int64) value;
+				result[1] = data->atomicCompareExchange(atype, (size_t) offset, expected, (int64) desired, aorder) ? 1.0 : 0.0;
+				result[0] = (double) expected;
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		catch (love::Exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
 };
 
 const luaL_Reg w_Data_functions[] =
@@ -38,6 +38,7 @@ typedef struct Proxy Proxy;
 typedef struct FFI_Data
 {
 	void *(*getFFIPointer)(Proxy *p);
+	bool (*atomic)(Proxy *p, int op, int type, int order, double offset, double value, double desired, double *result);
 } FFI_Data;
 ]])
 
@@ -51,5 +52,66 @@ function Data:getFFIPointer()
 	return ffifuncs.getFFIPointer(self)
 end
 
+-- Only ByteData has atomic methods.
+if Data.atomicLoad == nil then return end
+
+local atomictypes = { int32 = 0, uint32 = 1 }
+local atomicorders = { relaxed = 0, acquire = 1, release = 2, acqrel = 3, seqcst = 4 }
+local atomicresult = ffi.new("double[2]")
+
+local C_atomicLoad = Data.atomicLoad
+local C_atomicStore = Data.atomicStore
+local C_atomicAdd = Data.atomicAdd
+local C_atomicExchange = Data.atomicExchange
+local C_atomicCompareExchange = Data.atomicCompareExchange
+
+-- Returns false for any invalid argument. The regular method is called in
+-- that case, so it can raise the error.
+local function atomic(self, op, atype, offset, value, desired, order)
+	if self == nil or type(offset) ~= "number" or type(value) ~= "number" or type(desired) ~= "number" then
+		return false
+	end
+	local t = atomictypes[atype]
+	local o = atomicorders[order == nil and "seqcst" or order]
+	if t == nil or o == nil then
+		return false
+	end
+	return ffifuncs.atomic(self, op, t, o, offset, value, desired, atomicresult)
+end
+
+function Data:atomicLoad(atype, offset, order)
+	if not atomic(self, 0, atype, offset, 0, 0, order) then
+		return C_atomicLoad(self, atype, offset, order)
+	end
+	return atomicresult[0]
+end
+
+function Data:atomicStore(atype, offset, value, order)
+	if not atomic(self, 1, atype, offset, value, 0, order) then
+		return C_atomicStore(self, atype, offset, value, order)
+	end
+end
+
+function Data:atomicAdd(atype, offset, value, order)
+	if not atomic(self, 2, atype, offset, value, 0, order) then
+		return C_atomicAdd(self, atype, offset, value, order)
+	end
+	return atomicresult[0]
+end
+
+function Data:atomicExchange(atype, offset, value, order)
+	if not atomic(self, 3, atype, offset, value, 0, order) then
+		return C_atomicExchange(self, atype, offset, value, order)
+	end
+	return atomicresult[0]
+end
+
+function Data:atomicCompareExchange(atype, offset, expected, desired, order)
+	if not atomic(self, 4, atype, offset, expected, desired, order) then
+		return C_atomicCompareExchange(self, atype, offset, expected, desired, order)
+	end
+	return atomicresult[1] ~= 0, atomicresult[0]
+end
+
 -- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
 --)luastring"--"
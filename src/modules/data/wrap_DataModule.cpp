@@ -24,6 +24,11 @@
 #include "wrap_ByteData.h"
 #include "wrap_DataView.h"
 #include "wrap_CompressedData.h"
+#include "wrap_CompressionStream.h"
+#include "wrap_Hasher.h"
+#include "wrap_CompressJob.h"
+#include "wrap_Serialize.h"
+#include "wrap_PackFormat.h"
 #include "DataModule.h"
 #include "common/b64.h"
 
@@ -113,6 +118,51 @@ int w_newByteData(lua_State *L)
 	return 1;
 }
 
+int w_newCompressionStream(lua_State *L)
+{
+	const char *mstr = luaL_checkstring(L, 1);
+	CompressionStream::Mode mode = CompressionStream::MODE_COMPRESS;
+	if (!CompressionStream::getConstant(mstr, mode))
+		return luax_enumerror(L, "compression stream mode", CompressionStream::getConstants(mode), mstr);
+
+	const char *fstr = luaL_checkstring(L, 2);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	int level = (int) luaL_optinteger(L, 3, -1);
+
+	CompressionStream *s = nullptr;
+	luax_catchexcept(L, [&]() { s = instance()->newCompressionStream(mode, format, level); });
+	luax_pushtype(L, s);
+	s->release();
+	return 1;
+}
+
+int w_newHasher(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	HashFunction::Function function = HashFunction::FUNCTION_MD5;
+	if (!HashFunction::getConstant(fstr, function))
+		return luax_enumerror(L, "hash function", HashFunction::getConstants(function), fstr);
+
+	Hasher *h = nullptr;
+	luax_catchexcept(L, [&]() { h = instance()->newHasher(function); });
+	luax_pushtype(L, h);
+	h->release();
+	return 1;
+}
+
+int w_newPackFormat(lua_State *L)
+{
+	std::string format = luax_checkstring(L, 1);
+	PackFormat *f = nullptr;
+	luax_catchexcept(L, [&]() { f = instance()->newPackFormat(format); });
+	luax_pushtype(L, f);
+	f->release();
+	return 1;
+}
+
 int w_compress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -124,6 +174,7 @@ int w_compress(lua_State *L)
 		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
 
 	int level = (int) luaL_optinteger(L, 4, -1);
+	bool parallel = luax_optboolean(L, 5, false);
 	size_t rawsize = 0;
 	const char *rawbytes = nullptr;
 
@@ -137,7 +188,7 @@ int w_compress(lua_State *L)
 	}
 
 	CompressedData *cdata = nullptr;
-	luax_catchexcept(L, [&](){ cdata = compress(format, rawbytes, rawsize, level); });
+	luax_catchexcept(L, [&](){ cdata = compress(format, rawbytes, rawsize, level, parallel); });
 
 	if (ctype == CONTAINER_DATA)
 		luax_pushtype(L, cdata);
@@ -148,6 +199,42 @@ int w_compress(lua_State *L)
 	return 1;
 }
 
+int w_compressAsync(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	int level = (int) luaL_optinteger(L, 3, -1);
+
+	Data *input = nullptr;
+
+	// Strings are copied, since the Lua string might not outlive the job.
+	if (lua_isstring(L, 2))
+	{
+		size_t size = 0;
+		const char *str = luaL_checklstring(L, 2, &size);
+		luax_catchexcept(L, [&]() { input = instance()->newByteData(str, size); });
+	}
+	else
+	{
+		input = luax_checktype<Data>(L, 2);
+		input->retain();
+	}
+
+	CompressJob *job = nullptr;
+	luax_catchexcept(L,
+		[&]() { job = instance()->compressAsync(format, input, level); },
+		[&](bool) { input->release(); }
+	);
+
+	luax_pushtype(L, job);
+	job->release();
+	return 1;
+}
+
 int w_decompress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -202,6 +289,46 @@ int w_decompress(lua_State *L)
 
 int w_encode(lua_State *L)
 {
+	// Encoding into an existing ByteData avoids creating any new objects.
+	if (luax_istype(L, 1, ByteData::type))
+	{
+		ByteData *d = luax_checkbytedata(L, 1);
+		lua_Integer offset = luaL_checkinteger(L, 2);
+
+		const char *formatstr = luaL_checkstring(L, 3);
+		EncodeFormat format;
+		if (!getConstant(formatstr, format))
+			return luax_enumerror(L, "encode format", getConstants(format), formatstr);
+
+		size_t srclen = 0;
+		const char *src = nullptr;
+
+		if (luax_istype(L, 4, Data::type))
+		{
+			Data *data = luax_totype<Data>(L, 4);
+			src = (const char *) data->getData();
+			srclen = data->getSize();
+		}
+		else
+			src = luaL_checklstring(L, 4, &srclen);
+
+		size_t linelen = (size_t) luaL_optinteger(L, 5, 0);
+
+		if (offset < 0 || (size_t) offset > d->getSize())
+			return luaL_error(L, "The given byte offset is outside of the ByteData's size.");
+
+		size_t dstlen = getEncodedSize(format, srclen, linelen);
+
+		if ((size_t) offset + dstlen > d->getSize())
+			return luaL_error(L, "The encoded data (%d bytes) does not fit within the ByteData at the given offset.", (int) dstlen);
+
+		dstlen = encode(format, src, srclen, (char *) d->getData() + offset, linelen);
+
+		luax_pushtype(L, Data::type, d);
+		lua_pushinteger(L, (lua_Integer) dstlen);
+		return 2;
+	}
+
 	ContainerType ctype = luax_checkcontainertype(L, 1);
 
 	const char *formatstr = luaL_checkstring(L, 2);
@@ -223,23 +350,24 @@ int w_encode(lua_State *L)
 
 	size_t linelen = (size_t) luaL_optinteger(L, 4, 0);
 
-	size_t dstlen = 0;
-	char *dst = nullptr;
-	luax_catchexcept(L, [&](){ dst = encode(format, src, srclen, dstlen, linelen); });
-
 	if (ctype == CONTAINER_DATA)
 	{
+		// Encode straight into the new ByteData's memory.
 		ByteData *data = nullptr;
-		if (dst != nullptr)
-			luax_catchexcept(L, [&]() { data = instance()->newByteData(dst, dstlen, true); });
-		else
-			luax_catchexcept(L, [&]() { data = instance()->newByteData(0); });
+		luax_catchexcept(L, [&]() {
+			data = instance()->newByteData(getEncodedSize(format, srclen, linelen));
+			encode(format, src, srclen, (char *) data->getData(), linelen);
+		});
 
 		luax_pushtype(L, Data::type, data);
 		data->release();
 	}
 	else
 	{
+		size_t dstlen = 0;
+		char *dst = nullptr;
+		luax_catchexcept(L, [&](){ dst = encode(format, src, srclen, dstlen, linelen); });
+
 		if (dst != nullptr)
 			lua_pushlstring(L, dst, dstlen);
 		else
@@ -355,6 +483,9 @@ int w_pack(lua_State *L)
 {
 	if (luax_istype(L, 1, ByteData::type))
 	{
+		if (luax_istype(L, 3, PackFormat::type))
+			return luax_packformat_pack(L, luax_checkpackformat(L, 3), 1, 4);
+
 		ByteData *d = luax_checkbytedata(L, 1);
 		size_t offset = (size_t) luaL_checknumber(L, 2);
 		const char *fmt = luaL_checkstring(L, 3);
@@ -375,6 +506,10 @@ int w_pack(lua_State *L)
 		return 1;
 	}
 
+	// Precompiled formats take the same arguments, minus the format.
+	if (luax_istype(L, 2, PackFormat::type))
+		return luax_packformat_pack(L, luax_checkpackformat(L, 2), 1, 3);
+
 	ContainerType ctype = luax_checkcontainertype(L, 1);
 	const char *fmt = luaL_checkstring(L, 2);
 	luaL_Buffer_53 b;
@@ -398,6 +533,9 @@ int w_pack(lua_State *L)
 
 int w_unpack(lua_State *L)
 {
+	if (luax_istype(L, 1, PackFormat::type))
+		return luax_packformat_unpack(L, luax_checkpackformat(L, 1), 2);
+
 	const char *fmt = luaL_checkstring(L, 1);
 
 	const char *data = nullptr;
@@ -415,12 +553,87 @@ int w_unpack(lua_State *L)
 	return lua53_str_unpack(L, fmt, data, datasize, 2, 3);
 }
 
+int w_serialize(lua_State *L)
+{
+	// Reused between calls, so serializing every frame (or a large save
+	// repeatedly) doesn't reallocate.
+	thread_local std::vector<uint8> buffer;
+	buffer.clear();
+
+	if (luax_istype(L, 1, ByteData::type))
+	{
+		ByteData *d = luax_checkbytedata(L, 1);
+		lua_Integer offset = luaL_checkinteger(L, 2);
+		luaL_checkany(L, 3);
+
+		if (offset < 0 || (size_t) offset > d->getSize())
+			return luaL_error(L, "The given byte offset is outside of the ByteData's size.");
+
+		luax_catchexcept(L, [&]() { luax_serialize(L, 3, buffer); });
+
+		if ((size_t) offset + buffer.size() > d->getSize())
+			return luaL_error(L, "The serialized value (%d bytes) does not fit within the ByteData at the given offset.", (int) buffer.size());
+
+		memcpy((uint8 *) d->getData() + offset, buffer.data(), buffer.size());
+
+		luax_pushtype(L, Data::type, d);
+		lua_pushinteger(L, (lua_Integer) buffer.size());
+		return 2;
+	}
+
+	ContainerType ctype = luax_checkcontainertype(L, 1);
+	luaL_checkany(L, 2);
+
+	luax_catchexcept(L, [&]() { luax_serialize(L, 2, buffer); });
+
+	if (ctype == CONTAINER_DATA)
+	{
+		Data *d = nullptr;
+		luax_catchexcept(L, [&]() { d = instance()->newByteData(buffer.data(), buffer.size()); });
+		luax_pushtype(L, Data::type, d);
+		d->release();
+	}
+	else
+		lua_pushlstring(L, (const char *) buffer.data(), buffer.size());
+
+	return 1;
+}
+
+int w_deserialize(lua_State *L)
+{
+	const char *data = nullptr;
+	size_t datasize = 0;
+
+	if (luax_istype(L, 1, Data::type))
+	{
+		Data *d = luax_checkdata(L, 1);
+		data = (const char *) d->getData();
+		datasize = d->getSize();
+	}
+	else
+		data = luaL_checklstring(L, 1, &datasize);
+
+	lua_Integer offset = luaL_optinteger(L, 2, 0);
+	if (offset < 0 || (size_t) offset > datasize)
+		return luaL_error(L, "The given byte offset is outside of the data's size.");
+
+	size_t readsize = 0;
+	luax_catchexcept(L, [&]() { readsize = luax_deserialize(L, data + offset, datasize - (size_t) offset); });
+
+	lua_pushinteger(L, (lua_Integer) readsize);
+	return 2;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
 	{ "newDataView", w_newDataView },
 	{ "newByteData", w_newByteData },
+	{ "newCompressionStream", w_newCompressionStream },
+	{ "newHasher", w_newHasher },
+	{ "newPackFormat", w_newPackFormat },
 	{ "compress", w_compress },
+	{ "compressAsync", w_compressAsync },
 	{ "decompress", w_decompress },
 	{ "encode", w_encode },
 	{ "decode", w_decode },
@@ -430,6 +643,9 @@ static const luaL_Reg functions[] =
 	{ "unpack", w_unpack },
 	{ "getPackedSize", lua53_str_packsize },
 
+	{ "serialize", w_serialize },
+	{ "deserialize", w_deserialize },
+
 	{ 0, 0 }
 };
 
@@ -439,6 +655,10 @@ static const lua_CFunction types[] =
 	luaopen_bytedata,
 	luaopen_dataview,
 	luaopen_compresseddata,
+	luaopen_compressionstream,
+	luaopen_hasher,
+	luaopen_compressjob,
+	luaopen_packformat,
 	nullptr
 };
 
@@ -0,0 +1,406 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_PackFormat.h"
+#include "wrap_Data.h"
+#include "wrap_ByteData.h"
+#include "wrap_DataModule.h"
+
+// C++
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+#define instance() (Module::getInstance<DataModule>(Module::M_DATA))
+
+PackFormat *luax_checkpackformat(lua_State *L, int idx)
+{
+	return luax_checktype<PackFormat>(L, idx);
+}
+
+// Appends one record, packed from the Lua values starting at arg. Alignment
+// is relative to the start of the record.
+static void packRecord(lua_State *L, const PackFormat *format, int arg, std::vector<uint8> &out)
+{
+	size_t start = out.size();
+
+	for (const PackFormat::Field &f : format->getFields())
+	{
+		out.insert(out.end(), PackFormat::getAlignPadding(out.size() - start, f.align), 0);
+
+		switch (f.type)
+		{
+		case PackFormat::FIELD_INT:
+		{
+			lua_Integer n = luaL_checkinteger(L, arg);
+			if (f.size < (int) sizeof(lua_Integer))
+			{
+				lua_Integer lim = (lua_Integer) 1 << ((f.size * 8) - 1);
+				luaL_argcheck(L, -lim <= n && n < lim, arg, "integer overflow");
+			}
+			size_t o = out.size();
+			out.resize(o + f.size);
+			PackFormat::writeInt(&out[o], (uint64) n, f.size, f.littleEndian, n < 0);
+			arg++;
+			break;
+		}
+		case PackFormat::FIELD_UINT:
+		{
+			lua_Integer n = luaL_checkinteger(L, arg);
+			if (f.size < (int) sizeof(lua_Integer))
+				luaL_argcheck(L, (uint64) n < ((uint64) 1 << (f.size * 8)), arg, "unsigned overflow");
+			size_t o = out.size();
+			out.resize(o + f.size);
+			PackFormat::writeInt(&out[o], (uint64) n, f.size, f.littleEndian, false);
+			arg++;
+			break;
+		}
+		case PackFormat::FIELD_FLOAT:
+		{
+			double n = (double) luaL_checknumber(L, arg);
+			size_t o = out.size();
+			out.resize(o + f.size);
+			PackFormat::writeFloat(&out[o], n, f.size, f.littleEndian);
+			arg++;
+			break;
+		}
+		case PackFormat::FIELD_CHAR:
+		{
+			size_t len = 0;
+			const char *str = luaL_checklstring(L, arg, &len);
+			luaL_argcheck(L, len <= (size_t) f.size, arg, "string longer than given size");
+			out.insert(out.end(), (const uint8 *) str, (const uint8 *) str + len);
+			out.insert(out.end(), f.size - len, 0);
+			arg++;
+			break;
+		}
+		case PackFormat::FIELD_STRING:
+		{
+			size_t len = 0;
+			const char *str = luaL_checklstring(L, arg, &len);
+			luaL_argcheck(L, f.size >= (int) sizeof(size_t) || len < ((size_t) 1 << (f.size * 8)), arg, "string length does not fit in given size");
+			size_t o = out.size();
+			out.resize(o + f.size);
+			PackFormat::writeInt(&out[o], (uint64) len, f.size, f.littleEndian, false);
+			out.insert(out.end(), (const uint8 *) str, (const uint8 *) str + len);
+			arg++;
+			break;
+		}
+		case PackFormat::FIELD_ZSTRING:
+		{
+			size_t len = 0;
+			const char *str = luaL_checklstring(L, arg, &len);
+			luaL_argcheck(L, strlen(str) == len, arg, "string contains zeros");
+			out.insert(out.end(), (const uint8 *) str, (const uint8 *) str + len + 1);
+			arg++;
+			break;
+		}
+		case PackFormat::FIELD_PADDING:
+			out.push_back(0);
+			break;
+		case PackFormat::FIELD_ALIGN:
+			break;
+		}
+	}
+}
+
+static void pushInt(lua_State *L, const uint8 *src, const PackFormat::Field &f)
+{
+	int64 v = 0;
+	if (!PackFormat::readInt(src, f.size, f.littleEndian, f.type == PackFormat::FIELD_INT, v))
+		luaL_error(L, "%d-byte integer does not fit into Lua Integer", f.size);
+	lua_pushinteger(L, (lua_Integer) v);
+}
+
+/**
+ * Unpacks the record at pos, calling emit after pushing each value. Returns
+ * the position after the record.
+ **/
+template <typename Emit>
+static size_t unpackRecord(lua_State *L, const PackFormat *format, const uint8 *data, size_t size, size_t pos, int dataidx, Emit emit)
+{
+	// Fixed-size records are bounds checked once, and their fields are at
+	// known offsets.
+	if (format->isFixedSize())
+	{
+		if (format->getSize() > size - pos)
+			luaL_argerror(L, dataidx, "data string too short");
+
+		const uint8 *record = data + pos;
+
+		for (const PackFormat::Field &f : format->getFields())
+		{
+			const uint8 *src = record + f.offset;
+
+			switch (f.type)
+			{
+			case PackFormat::FIELD_INT:
+			case PackFormat::FIELD_UINT:
+				pushInt(L, src, f);
+				break;
+			case PackFormat::FIELD_FLOAT:
+				lua_pushnumber(L, (lua_Number) PackFormat::readFloat(src, f.size, f.littleEndian));
+				break;
+			case PackFormat::FIELD_CHAR:
+				lua_pushlstring(L, (const char *) src, f.size);
+				break;
+			default:
+				continue;
+			}
+
+			emit();
+		}
+
+		return pos + format->getSize();
+	}
+
+	size_t start = pos;
+
+	for (const PackFormat::Field &f : format->getFields())
+	{
+		pos += PackFormat::getAlignPadding(pos - start, f.align);
+
+		if (pos > size || (size_t) f.size > size - pos)
+			luaL_argerror(L, dataidx, "data string too short");
+
+		const uint8 *src = data + pos;
+
+		switch (f.type)
+		{
+		case PackFormat::FIELD_INT:
+		case PackFormat::FIELD_UINT:
+			pushInt(L, src, f);
+			break;
+		case PackFormat::FIELD_FLOAT:
+			lua_pushnumber(L, (lua_Number) PackFormat::readFloat(src, f.size, f.littleEndian));
+			break;
+		case PackFormat::FIELD_CHAR:
+			lua_pushlstring(L, (const char *) src, f.size);
+			break;
+		case PackFormat::FIELD_STRING:
+		{
+			int64 len = 0;
+			if (!PackFormat::readInt(src, f.size, f.littleEndian, false, len))
+				luaL_error(L, "%d-byte integer does not fit into Lua Integer", f.size);
+			if ((uint64) len > size - pos - f.size)
+				luaL_argerror(L, dataidx, "data string too short");
+			lua_pushlstring(L, (const char *) src + f.size, (size_t) len);
+			pos += (size_t) len;
+			break;
+		}
+		case PackFormat::FIELD_ZSTRING:
+		{
+			const void *end = memchr(src, 0, size - pos);
+			if (end == nullptr)
+				luaL_argerror(L, dataidx, "unfinished string for format 'z'");
+			size_t len = (const uint8 *) end - src;
+			lua_pushlstring(L, (const char *) src, len);
+			pos += len + 1;
+			break;
+		}
+		case PackFormat::FIELD_PADDING:
+		case PackFormat::FIELD_ALIGN:
+			pos += f.size;
+			continue;
+		}
+
+		pos += f.size;
+		emit();
+	}
+
+	return pos;
+}
+
+static const uint8 *checkUnpackData(lua_State *L, int idx, size_t &size)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *d = luax_checkdata(L, idx);
+		size = d->getSize();
+		return (const uint8 *) d->getData();
+	}
+
+	return (const uint8 *) luaL_checklstring(L, idx, &size);
+}
+
+static size_t checkUnpackPosition(lua_State *L, int idx, size_t size)
+{
+	lua_Integer pos = luaL_optinteger(L, idx, 1);
+	if (pos < 0)
+		pos = (0u - (size_t) pos > size) ? 0 : (lua_Integer) size + pos + 1;
+	luaL_argcheck(L, pos >= 1 && (size_t) pos - 1 <= size, idx, "initial position out of string");
+	return (size_t) pos - 1;
+}
+
+int luax_packformat_pack(lua_State *L, PackFormat *format, int containeridx, int valuesidx)
+{
+	thread_local std::vector<uint8> buffer;
+	buffer.clear();
+
+	if (luax_istype(L, containeridx, ByteData::type))
+	{
+		ByteData *d = luax_checkbytedata(L, containeridx);
+		size_t offset = (size_t) luaL_checknumber(L, containeridx + 1);
+
+		packRecord(L, format, valuesidx > 0 ? valuesidx : containeridx + 2, buffer);
+
+		if (offset + buffer.size() > d->getSize())
+			return luaL_error(L, "The given byte offset and pack format parameters do not fit within the ByteData's size.");
+
+		memcpy((uint8 *) d->getData() + offset, buffer.data(), buffer.size());
+
+		luax_pushtype(L, Data::type, d);
+		return 1;
+	}
+
+	ContainerType ctype = luax_checkcontainertype(L, containeridx);
+
+	packRecord(L, format, valuesidx > 0 ? valuesidx : containeridx + 1, buffer);
+
+	if (ctype == CONTAINER_DATA)
+	{
+		Data *d = nullptr;
+		luax_catchexcept(L, [&]() { d = instance()->newByteData(buffer.data(), buffer.size()); });
+		luax_pushtype(L, Data::type, d);
+		d->release();
+	}
+	else
+		lua_pushlstring(L, (const char *) buffer.data(), buffer.size());
+
+	return 1;
+}
+
+int luax_packformat_unpack(lua_State *L, PackFormat *format, int dataidx)
+{
+	size_t size = 0;
+	const uint8 *data = checkUnpackData(L, dataidx, size);
+	size_t pos = checkUnpackPosition(L, dataidx + 1, size);
+
+	luaL_checkstack(L, format->getValueCount() + 1, "too many results");
+
+	pos = unpackRecord(L, format, data, size, pos, dataidx, []() {});
+
+	lua_pushinteger(L, (lua_Integer) pos + 1);
+	return format->getValueCount() + 1;
+}
+
+int w_PackFormat_pack(lua_State *L)
+{
+	PackFormat *format = luax_checkpackformat(L, 1);
+	return luax_packformat_pack(L, format, 2);
+}
+
+int w_PackFormat_unpack(lua_State *L)
+{
+	PackFormat *format = luax_checkpackformat(L, 1);
+	return luax_packformat_unpack(L, format, 2);
+}
+
+int w_PackFormat_unpackArray(lua_State *L)
+{
+	PackFormat *format = luax_checkpackformat(L, 1);
+
+	size_t size = 0;
+	const uint8 *data = checkUnpackData(L, 2, size);
+
+	lua_Integer count = luaL_checkinteger(L, 3);
+	luaL_argcheck(L, count >= 0, 3, "count must not be negative");
+
+	size_t pos = checkUnpackPosition(L, 4, size);
+
+	int valuecount = format->getValueCount();
+
+	// Fixed-size formats can check that every record fits up front, before
+	// the table is allocated.
+	if (format->isFixedSize() && (size_t) count > 0 && (size - pos) / format->getSize() < (size_t) count)
+		return luaL_argerror(L, 2, "data string too short");
+
+	int index = (int) luaL_optinteger(L, 6, 1);
+
+	lua_settop(L, 5);
+	if (lua_isnil(L, 5))
+	{
+		lua_createtable(L, (int) (count * valuecount), 0);
+		lua_replace(L, 5);
+	}
+	else
+		luaL_checktype(L, 5, LUA_TTABLE);
+
+	int tidx = 5;
+
+	// Values are stored one record after another, like the data itself.
+	for (lua_Integer i = 0; i < count; i++)
+	{
+		pos = unpackRecord(L, format, data, size, pos, 2, [&]()
+		{
+			lua_rawseti(L, tidx, index++);
+		});
+	}
+
+	lua_pushvalue(L, tidx);
+	lua_pushinteger(L, (lua_Integer) pos + 1);
+	return 2;
+}
+
+int w_PackFormat_getSize(lua_State *L)
+{
+	PackFormat *format = luax_checkpackformat(L, 1);
+	if (format->isFixedSize())
+		lua_pushinteger(L, (lua_Integer) format->getSize());
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_PackFormat_getValueCount(lua_State *L)
+{
+	PackFormat *format = luax_checkpackformat(L, 1);
+	lua_pushinteger(L, format->getValueCount());
+	return 1;
+}
+
+int w_PackFormat_getFormat(lua_State *L)
+{
+	PackFormat *format = luax_checkpackformat(L, 1);
+	luax_pushstring(L, format->getFormat());
+	return 1;
+}
+
+static const luaL_Reg w_PackFormat_functions[] =
+{
+	{ "pack", w_PackFormat_pack },
+	{ "unpack", w_PackFormat_unpack },
+	{ "unpackArray", w_PackFormat_unpackArray },
+	{ "getSize", w_PackFormat_getSize },
+	{ "getValueCount", w_PackFormat_getValueCount },
+	{ "getFormat", w_PackFormat_getFormat },
+	{ 0, 0 }
+};
+
+int luaopen_packformat(lua_State *L)
+{
+	return luax_register_type(L, &PackFormat::type, w_PackFormat_functions, nullptr);
+}
+
+} // data
+} // love
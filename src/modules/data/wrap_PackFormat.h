@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/runtime.h"
+#include "PackFormat.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+PackFormat *luax_checkpackformat(lua_State *L, int idx);
+
+/**
+ * Implementations of love.data.pack and unpack for a PackFormat. The values
+ * to pack start at valuesidx, or right after the container arguments if it's
+ * 0.
+ **/
+int luax_packformat_pack(lua_State *L, PackFormat *format, int containeridx, int valuesidx = 0);
+int luax_packformat_unpack(lua_State *L, PackFormat *format, int dataidx);
+
+int luaopen_packformat(lua_State *L);
+
+} // data
+} // love
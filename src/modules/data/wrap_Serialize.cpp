@@ -0,0 +1,453 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_Serialize.h"
+#include "common/Exception.h"
+
+// C++
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace love
+{
+namespace data
+{
+
+// The first byte of serialized data, so the format can change later.
+static const uint8 SERIALIZE_VERSION = 1;
+
+// Tables nested deeper than this are assumed to be a mistake, and would
+// otherwise overflow the C stack.
+static const int MAX_SERIALIZE_DEPTH = 256;
+
+// Strings shorter than this cost as much to reference as to repeat.
+static const size_t MIN_INTERNED_STRING_LENGTH = 2;
+
+enum SerializeTag
+{
+	TAG_NIL = 0,
+	TAG_FALSE,
+	TAG_TRUE,
+	TAG_INTEGER, // zigzag varint
+	TAG_NUMBER, // little-endian double
+	TAG_STRING, // varint length, then bytes
+	TAG_STRING_REF, // varint index of an earlier interned string
+	TAG_TABLE, // varint array length, array values, key/value pairs, TAG_END
+	TAG_TABLE_REF, // varint index of an earlier table
+	TAG_END,
+};
+
+struct StringKey
+{
+	const char *str;
+	size_t len;
+
+	bool operator == (const StringKey &other) const
+	{
+		return len == other.len && (str == other.str || memcmp(str, other.str, len) == 0);
+	}
+};
+
+struct StringKeyHash
+{
+	size_t operator () (const StringKey &key) const
+	{
+		// FNV-1a over at most 32 bytes from each end, long strings with a
+		// shared middle are rare enough to be left to operator ==.
+		size_t hash = 2166136261u ^ key.len;
+		size_t head = std::min(key.len, (size_t) 32);
+		for (size_t i = 0; i < head; i++)
+			hash = (hash ^ (uint8) key.str[i]) * 16777619u;
+		for (size_t i = std::max(head, key.len - std::min(key.len, (size_t) 32)); i < key.len; i++)
+			hash = (hash ^ (uint8) key.str[i]) * 16777619u;
+		return hash;
+	}
+};
+
+class Serializer
+{
+public:
+
+	Serializer(lua_State *L, std::vector<uint8> &out)
+		: L(L)
+		, out(out)
+	{
+	}
+
+	void writeValue(int idx, int depth)
+	{
+		switch (lua_type(L, idx))
+		{
+		case LUA_TNIL:
+			out.push_back(TAG_NIL);
+			break;
+		case LUA_TBOOLEAN:
+			out.push_back(lua_toboolean(L, idx) ? TAG_TRUE : TAG_FALSE);
+			break;
+		case LUA_TNUMBER:
+			writeNumber(lua_tonumber(L, idx));
+			break;
+		case LUA_TSTRING:
+			writeString(idx);
+			break;
+		case LUA_TTABLE:
+			writeTable(idx, depth);
+			break;
+		default:
+			throw love::Exception("Cannot serialize values of type '%s'.", luaL_typename(L, idx));
+		}
+	}
+
+private:
+
+	void writeVarint(uint64 v)
+	{
+		while (v >= 0x80)
+		{
+			out.push_back((uint8) (v | 0x80));
+			v >>= 7;
+		}
+		out.push_back((uint8) v);
+	}
+
+	void writeNumber(lua_Number n)
+	{
+		// Integers that a double holds exactly are stored as varints, which
+		// is most numbers in typical data. -0 keeps its sign as a double.
+		if (n == std::floor(n) && std::fabs(n) <= 9007199254740992.0 && !(n == 0 && std::signbit(n)))
+		{
+			int64 i = (int64) n;
+			out.push_back(TAG_INTEGER);
+			writeVarint(((uint64) i << 1) ^ (uint64) (i >> 63));
+			return;
+		}
+
+		double d = (double) n;
+		uint64 bits = 0;
+		memcpy(&bits, &d, sizeof(double));
+
+		out.push_back(TAG_NUMBER);
+		for (int i = 0; i < 8; i++)
+			out.push_back((uint8) (bits >> (i * 8)));
+	}
+
+	void writeString(int idx)
+	{
+		size_t len = 0;
+		const char *str = lua_tolstring(L, idx, &len);
+
+		if (len >= MIN_INTERNED_STRING_LENGTH)
+		{
+			// The strings are owned by the value being serialized, so they
+			// outlive the map.
+			StringKey key = {str, len};
+			auto it = strings.find(key);
+			if (it != strings.end())
+			{
+				out.push_back(TAG_STRING_REF);
+				writeVarint(it->second);
+				return;
+			}
+
+			uint64 index = strings.size();
+			strings[key] = index;
+		}
+
+		out.push_back(TAG_STRING);
+		writeVarint(len);
+		out.insert(out.end(), (const uint8 *) str, (const uint8 *) str + len);
+	}
+
+	void writeTable(int idx, int depth)
+	{
+		const void *ptr = lua_topointer(L, idx);
+		auto it = tables.find(ptr);
+		if (it != tables.end())
+		{
+			out.push_back(TAG_TABLE_REF);
+			writeVarint(it->second);
+			return;
+		}
+
+		if (depth >= MAX_SERIALIZE_DEPTH)
+			throw love::Exception("Cannot serialize tables nested more than %d levels deep.", MAX_SERIALIZE_DEPTH);
+
+		uint64 index = tables.size();
+		tables[ptr] = index;
+
+		if (idx < 0)
+			idx += lua_gettop(L) + 1;
+
+		luaL_checkstack(L, 3, nullptr);
+
+		// The array part is written without keys. Holes (possible with
+		// objlen's border) are written as nil and skipped when reading.
+		size_t arraylen = luax_objlen(L, idx);
+
+		out.push_back(TAG_TABLE);
+		writeVarint(arraylen);
+
+		for (size_t i = 1; i <= arraylen; i++)
+		{
+			lua_rawgeti(L, idx, (int) i);
+			writeValue(-1, depth + 1);
+			lua_pop(L, 1);
+		}
+
+		lua_pushnil(L);
+		while (lua_next(L, idx))
+		{
+			if (!isArrayKey(-2, arraylen))
+			{
+				writeValue(-2, depth + 1);
+				writeValue(-1, depth + 1);
+			}
+			lua_pop(L, 1);
+		}
+
+		out.push_back(TAG_END);
+	}
+
+	bool isArrayKey(int idx, size_t arraylen)
+	{
+		if (arraylen == 0 || lua_type(L, idx) != LUA_TNUMBER)
+			return false;
+
+		lua_Number n = lua_tonumber(L, idx);
+		return n >= 1 && n <= (lua_Number) arraylen && n == std::floor(n);
+	}
+
+	lua_State *L;
+	std::vector<uint8> &out;
+
+	std::unordered_map<StringKey, uint64, StringKeyHash> strings;
+	std::unordered_map<const void *, uint64> tables;
+
+}; // Serializer
+
+class Deserializer
+{
+public:
+
+	Deserializer(lua_State *L, const uint8 *data, size_t size, int tablesidx)
+		: L(L)
+		, data(data)
+		, size(size)
+		, pos(0)
+		, tablesIdx(tablesidx)
+		, tableCount(0)
+	{
+	}
+
+	uint8 readByte()
+	{
+		if (pos >= size)
+			throw love::Exception("Serialized data is truncated.");
+		return data[pos++];
+	}
+
+	// Pushes the next value. Returns false (and pushes nothing) for TAG_END.
+	bool readValue(int depth)
+	{
+		uint8 tag = readByte();
+
+		switch (tag)
+		{
+		case TAG_NIL:
+			lua_pushnil(L);
+			break;
+		case TAG_FALSE:
+			lua_pushboolean(L, 0);
+			break;
+		case TAG_TRUE:
+			lua_pushboolean(L, 1);
+			break;
+		case TAG_INTEGER:
+		{
+			uint64 v = readVarint();
+			int64 i = (int64) (v >> 1) ^ -(int64) (v & 1);
+			lua_pushnumber(L, (lua_Number) i);
+			break;
+		}
+		case TAG_NUMBER:
+		{
+			uint64 bits = 0;
+			for (int i = 0; i < 8; i++)
+				bits |= (uint64) readByte() << (i * 8);
+			double d = 0.0;
+			memcpy(&d, &bits, sizeof(double));
+			lua_pushnumber(L, (lua_Number) d);
+			break;
+		}
+		case TAG_STRING:
+		{
+			size_t len = (size_t) readVarint();
+			if (len > size - pos)
+				throw love::Exception("Serialized data is truncated.");
+			const char *str = (const char *) data + pos;
+			pos += len;
+			if (len >= MIN_INTERNED_STRING_LENGTH)
+				strings.push_back({str, len});
+			lua_pushlstring(L, str, len);
+			break;
+		}
+		case TAG_STRING_REF:
+		{
+			uint64 index = readVarint();
+			if (index >= strings.size())
+				throw love::Exception("Invalid string reference in serialized data.");
+			lua_pushlstring(L, strings[index].str, strings[index].len);
+			break;
+		}
+		case TAG_TABLE:
+			readTable(depth);
+			break;
+		case TAG_TABLE_REF:
+		{
+			uint64 index = readVarint();
+			if (index >= (uint64) tableCount)
+				throw love::Exception("Invalid table reference in serialized data.");
+			lua_rawgeti(L, tablesIdx, (int) index + 1);
+			break;
+		}
+		case TAG_END:
+			return false;
+		default:
+			throw love::Exception("Invalid value type (%d) in serialized data.", (int) tag);
+		}
+
+		return true;
+	}
+
+	size_t getPosition() const { return pos; }
+
+private:
+
+	uint64 readVarint()
+	{
+		uint64 v = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			uint8 b = readByte();
+			v |= (uint64) (b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+				return v;
+		}
+		throw love::Exception("Invalid integer in serialized data.");
+	}
+
+	void readTable(int depth)
+	{
+		if (depth >= MAX_SERIALIZE_DEPTH)
+			throw love::Exception("Serialized tables are nested more than %d levels deep.", MAX_SERIALIZE_DEPTH);
+
+		uint64 arraylen = readVarint();
+
+		// Every array entry takes at least one byte, so a length past the end
+		// of the data is invalid rather than something to allocate for.
+		if (arraylen > size - pos)
+			throw love::Exception("Serialized data is truncated.");
+
+		luaL_checkstack(L, 4, nullptr);
+
+		lua_createtable(L, (int) arraylen, 0);
+		int idx = lua_gettop(L);
+
+		// Registered before the contents, so references to it from inside
+		// itself resolve.
+		lua_pushvalue(L, idx);
+		lua_rawseti(L, tablesIdx, ++tableCount);
+
+		for (uint64 i = 1; i <= arraylen; i++)
+		{
+			readValue(depth + 1);
+			if (lua_isnil(L, -1))
+				lua_pop(L, 1);
+			else
+				lua_rawseti(L, idx, (int) i);
+		}
+
+		while (readValue(depth + 1))
+		{
+			if (lua_isnil(L, -1) || (lua_type(L, -1) == LUA_TNUMBER && std::isnan(lua_tonumber(L, -1))))
+				throw love::Exception("Invalid table key in serialized data.");
+
+			if (!readValue(depth + 1))
+				throw love::Exception("Missing table value in serialized data.");
+
+			lua_rawset(L, idx);
+		}
+	}
+
+	struct StringRef
+	{
+		const char *str;
+		size_t len;
+	};
+
+	lua_State *L;
+	const uint8 *data;
+	size_t size;
+	size_t pos;
+
+	std::vector<StringRef> strings;
+
+	int tablesIdx;
+	int tableCount;
+
+}; // Deserializer
+
+void luax_serialize(lua_State *L, int idx, std::vector<uint8> &out)
+{
+	if (idx < 0)
+		idx += lua_gettop(L) + 1;
+
+	out.push_back(SERIALIZE_VERSION);
+
+	Serializer s(L, out);
+	s.writeValue(idx, 0);
+}
+
+size_t luax_deserialize(lua_State *L, const void *data, size_t size)
+{
+	const uint8 *bytes = (const uint8 *) data;
+
+	if (size == 0)
+		throw love::Exception("Serialized data is empty.");
+
+	if (bytes[0] != SERIALIZE_VERSION)
+		throw love::Exception("Unknown serialized data version (%d).", (int) bytes[0]);
+
+	// Tables are kept in a list on the stack, for references to them.
+	lua_newtable(L);
+	int tablesidx = lua_gettop(L);
+
+	Deserializer d(L, bytes + 1, size - 1, tablesidx);
+	if (!d.readValue(0))
+		throw love::Exception("Invalid value type in serialized data.");
+
+	lua_remove(L, tablesidx);
+	return d.getPosition() + 1;
+}
+
+} // data
+} // love
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/runtime.h"
+#include "common/int.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Appends the value at the given index to out, in love.data.serialize's
+ * binary format. Tables shared or nested in themselves are written once and
+ * referenced after that. Throws for values that can't be serialized, such as
+ * functions and userdata.
+ **/
+void luax_serialize(lua_State *L, int idx, std::vector<uint8> &out);
+
+/**
+ * Pushes the value serialized at the start of the given data and returns the
+ * number of bytes it used. Throws if the data is truncated or invalid.
+ **/
+size_t luax_deserialize(lua_State *L, const void *data, size_t size);
+
+} // data
+} // love
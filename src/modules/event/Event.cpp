@@ -20,6 +20,9 @@
 
 #include "Event.h"
 
+// C++
+#include <algorithm>
+
 using love::thread::Mutex;
 using love::thread::Lock;
 
@@ -29,19 +32,63 @@ namespace event
 {
 
 Message::Message(const std::string &name, const std::vector<Variant> &vargs)
-	: name(name)
-	, args(vargs)
+	: argCount(0)
 {
+	set(name.c_str(), vargs.data(), vargs.size());
+}
+
+Message::Message(const char *name, const Variant *args, size_t count)
+	: argCount(0)
+{
+	set(name, args, count);
 }
 
 Message::~Message()
 {
 }
 
+const Variant &Message::getArg(size_t i) const
+{
+	if (i < MAX_INLINE_ARGS)
+		return inlineArgs[i];
+	return extraArgs[i - MAX_INLINE_ARGS];
+}
+
+void Message::set(const char *name, const Variant *args, size_t count)
+{
+	// Assigning reuses the string's memory when the Message is recycled.
+	this->name = name;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i < MAX_INLINE_ARGS)
+			inlineArgs[i] = args[i];
+		else
+			extraArgs.push_back(args[i]);
+	}
+
+	argCount = count;
+}
+
+void Message::clear()
+{
+	// Let go of any objects held by the arguments.
+	for (size_t i = 0; i < std::min(argCount, (size_t) MAX_INLINE_ARGS); i++)
+		inlineArgs[i] = Variant();
+
+	extraArgs.clear();
+	argCount = 0;
+}
+
 Event::Event(const char *name)
 	: Module(M_EVENT, name)
 	, modalDrawData()
 	, defaultModalDrawData()
+	, queueHead(0)
+	, inputSampleStart(0)
+	, inputSampleCount(0)
+	, lostInputSamples(0)
+	, inputSampling(false)
 {
 }
 
@@ -52,34 +99,151 @@ Event::~Event()
 
 	if (defaultModalDrawData.cleanup != nullptr)
 		defaultModalDrawData.cleanup(defaultModalDrawData.context);
+
+	for (size_t i = queueHead; i < queue.size(); i++)
+		queue[i]->release();
+
+	for (Message *msg : messagePool)
+		msg->release();
 }
 
 void Event::push(Message *msg)
 {
 	Lock lock(mutex);
 	msg->retain();
-	queue.push(msg);
+	queue.push_back(msg);
 }
 
 bool Event::poll(Message *&msg)
 {
 	Lock lock(mutex);
-	if (queue.empty())
+	if (queueHead >= queue.size())
 		return false;
-	msg = queue.front();
-	queue.pop();
+
+	msg = queue[queueHead++];
+
+	if (queueHead == queue.size())
+	{
+		queue.clear();
+		queueHead = 0;
+	}
+
 	return true;
 }
 
 void Event::clear()
 {
 	Lock lock(mutex);
-	while (!queue.empty())
+
+	for (size_t i = queueHead; i < queue.size(); i++)
+		queue[i]->release();
+
+	queue.clear();
+	queueHead = 0;
+}
+
+Message *Event::newMessage(const char *name, const MessageArgs &args)
+{
+	Message *msg = nullptr;
+
 	{
-		// std::queue::pop will remove the first (front) element.
-		queue.front()->release();
-		queue.pop();
+		Lock lock(mutex);
+		if (!messagePool.empty())
+		{
+			msg = messagePool.back();
+			messagePool.pop_back();
+		}
 	}
+
+	if (msg == nullptr)
+		return new Message(name, args.data(), args.size());
+
+	msg->set(name, args.data(), args.size());
+	return msg;
+}
+
+void Event::releaseMessage(Message *msg)
+{
+	// Something else (such as the code which pushed it) still has it.
+	if (msg->getReferenceCount() > 1)
+	{
+		msg->release();
+		return;
+	}
+
+	msg->clear();
+
+	{
+		Lock lock(mutex);
+		if (messagePool.size() < MAX_POOLED_MESSAGES)
+		{
+			messagePool.push_back(msg);
+			return;
+		}
+	}
+
+	msg->release();
+}
+
+void Event::setInputSampling(bool enable, int capacity)
+{
+	if (enable && capacity <= 0)
+		throw love::Exception("Input sample capacity must be greater than 0.");
+
+	inputSampling = enable;
+	inputSampleStart = 0;
+	inputSampleCount = 0;
+	lostInputSamples = 0;
+
+	if (enable)
+		inputSamples.resize(capacity);
+	else
+		std::vector<InputSample>().swap(inputSamples);
+}
+
+bool Event::isInputSampling() const
+{
+	return inputSampling;
+}
+
+void Event::addInputSample(const InputSample &sample)
+{
+	if (!inputSampling)
+		return;
+
+	size_t capacity = inputSamples.size();
+
+	if (inputSampleCount == capacity)
+	{
+		// Overwrite the oldest sample.
+		inputSamples[inputSampleStart] = sample;
+		inputSampleStart = (inputSampleStart + 1) % capacity;
+		lostInputSamples++;
+	}
+	else
+	{
+		inputSamples[(inputSampleStart + inputSampleCount) % capacity] = sample;
+		inputSampleCount++;
+	}
+}
+
+bool Event::pollInputSample(InputSample &sample)
+{
+	if (inputSampleCount == 0)
+		return false;
+
+	sample = inputSamples[inputSampleStart];
+	inputSampleStart = (inputSampleStart + 1) % inputSamples.size();
+	inputSampleCount--;
+
+	return true;
+}
+
+uint64 Event::takeLostInputSampleCount()
+{
+	uint64 lost = lostInputSamples;
+	lostInputSamples = 0;
+	return lost;
 }
 
 void Event::setModalDrawData(const ModalDrawData &data)
@@ -117,5 +281,22 @@ void Event::modalDraw()
 	}
 }
 
+STRINGMAP_CLASS_BEGIN(Event, Event::InputSampleType, Event::INPUT_MAX_ENUM, inputSampleType)
+{
+	{ "mousemoved",       Event::INPUT_MOUSE_MOVED       },
+	{ "mousepressed",     Event::INPUT_MOUSE_PRESSED     },
+	{ "mousereleased",    Event::INPUT_MOUSE_RELEASED    },
+	{ "touchpressed",     Event::INPUT_TOUCH_PRESSED     },
+	{ "touchmoved",       Event::INPUT_TOUCH_MOVED       },
+	{ "touchreleased",    Event::INPUT_TOUCH_RELEASED    },
+	{ "joystickaxis",     Event::INPUT_JOYSTICK_AXIS     },
+	{ "joystickpressed",  Event::INPUT_JOYSTICK_PRESSED  },
+	{ "joystickreleased", Event::INPUT_JOYSTICK_RELEASED },
+	{ "gamepadaxis",      Event::INPUT_GAMEPAD_AXIS      },
+	{ "gamepadpressed",   Event::INPUT_GAMEPAD_PRESSED   },
+	{ "gamepadreleased",  Event::INPUT_GAMEPAD_RELEASED  },
+}
+STRINGMAP_CLASS_END(Event, Event::InputSampleType, Event::INPUT_MAX_ENUM, inputSampleType)
+
 } // event
 } // love
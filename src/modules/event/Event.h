@@ -31,8 +31,8 @@
 #include "thread/threads.h"
 
 // C++
-#include <queue>
 #include <vector>
+#include <utility>
 
 namespace love
 {
@@ -43,20 +43,104 @@ class Message : public Object
 {
 public:
 
+	// Messages with up to this many arguments store them inline, so they
+	// don't need any allocations of their own.
+	static const size_t MAX_INLINE_ARGS = 8;
+
 	Message(const std::string &name, const std::vector<Variant> &vargs = {});
+	Message(const char *name, const Variant *args, size_t count);
 	~Message();
 
-	const std::string name;
-	const std::vector<Variant> args;
+	const std::string &getName() const { return name; }
+	size_t getArgCount() const { return argCount; }
+	const Variant &getArg(size_t i) const;
+
+private:
+
+	friend class Event;
+
+	void set(const char *name, const Variant *args, size_t count);
+	void clear();
+
+	std::string name;
+	Variant inlineArgs[MAX_INLINE_ARGS];
+	std::vector<Variant> extraArgs;
+	size_t argCount;
 
 }; // Message
 
+/**
+ * Arguments for a Message, stored without any allocations. Holds up to
+ * Message::MAX_INLINE_ARGS arguments.
+ **/
+class MessageArgs
+{
+public:
+
+	template <typename... Args>
+	void emplace_back(Args&&... args)
+	{
+		if (count < Message::MAX_INLINE_ARGS)
+			values[count++] = Variant(std::forward<Args>(args)...);
+	}
+
+	const Variant *data() const { return values; }
+	size_t size() const { return count; }
+
+private:
+
+	Variant values[Message::MAX_INLINE_ARGS];
+	size_t count = 0;
+
+}; // MessageArgs
+
 class Event : public Module
 {
 public:
 
 	typedef void (*ModalDrawCallback)(void *context);
 
+	enum InputSampleType
+	{
+		INPUT_MOUSE_MOVED,
+		INPUT_MOUSE_PRESSED,
+		INPUT_MOUSE_RELEASED,
+		INPUT_TOUCH_PRESSED,
+		INPUT_TOUCH_MOVED,
+		INPUT_TOUCH_RELEASED,
+		INPUT_JOYSTICK_AXIS,
+		INPUT_JOYSTICK_PRESSED,
+		INPUT_JOYSTICK_RELEASED,
+		INPUT_GAMEPAD_AXIS,
+		INPUT_GAMEPAD_PRESSED,
+		INPUT_GAMEPAD_RELEASED,
+		INPUT_MAX_ENUM
+	};
+
+	/**
+	 * A single input change, with the time (on the love.timer.getTime clock)
+	 * the OS reported it at rather than the time it was pumped.
+	 **/
+	struct InputSample
+	{
+		InputSampleType type;
+		double time;
+
+		// Joystick instance ID or touch ID.
+		int64 id;
+
+		// Mouse button, joystick axis or button, or gamepad axis or button
+		// enum value.
+		int index;
+
+		// Mouse and touch: x, y, dx, dy, pressure. Axes: value.
+		double values[5];
+	};
+
+	static const int DEFAULT_INPUT_SAMPLE_CAPACITY = 1024;
+
+	STRINGMAP_CLASS_DECLARE(InputSampleType);
+
 	struct ModalDrawData
 	{
 		ModalDrawCallback draw;
@@ -70,6 +154,36 @@ public:
 	bool poll(Message *&msg);
 	virtual void clear();
 
+	/**
+	 * Gets a Message from the pool of unused ones, or creates a new one.
+	 **/
+	Message *newMessage(const char *name, const MessageArgs &args = MessageArgs());
+
+	/**
+	 * Releases a Message returned by poll or wait. It's kept for reuse if
+	 * nothing else references it.
+	 **/
+	void releaseMessage(Message *msg);
+
+	/**
+	 * Starts or stops recording every mouse, touch, and joystick input change
+	 * as an InputSample when events are pumped. Once capacity samples are
+	 * waiting, the oldest ones are overwritten.
+	 **/
+	void setInputSampling(bool enable, int capacity = DEFAULT_INPUT_SAMPLE_CAPACITY);
+	bool isInputSampling() const;
+
+	/**
+	 * Gets the oldest recorded InputSample and removes it.
+	 **/
+	bool pollInputSample(InputSample &sample);
+
+	/**
+	 * Gets the number of samples which were overwritten before they were
+	 * polled, since the last call.
+	 **/
+	uint64 takeLostInputSampleCount();
+
 	virtual void pump(float waitTimeout = 0.0f) = 0;
 	virtual Message *wait() = 0;
 
@@ -84,12 +198,30 @@ protected:
 
 	Event(const char *name);
 
+	void addInputSample(const InputSample &sample);
+
 	ModalDrawData modalDrawData;
 	ModalDrawData defaultModalDrawData;
 	std::string deferredExceptionMessage;
 
+	// Unused Messages kept for newMessage, up to this many.
+	static const size_t MAX_POOLED_MESSAGES = 256;
+
 	love::thread::MutexRef mutex;
-	std::queue<Message *> queue;
+
+	// Pending messages start at queueHead. The vector is only cleared once
+	// everything has been polled, so it keeps its capacity.
+	std::vector<Message *> queue;
+	size_t queueHead;
+
+	std::vector<Message *> messagePool;
+
+	// Ring buffer of recorded input, used only on the main thread.
+	std::vector<InputSample> inputSamples;
+	size_t inputSampleStart;
+	size_t inputSampleCount;
+	uint64 lostInputSamples;
+	bool inputSampling;
 
 }; // Event
 
@@ -32,9 +32,18 @@
 #include "common/config.h"
 #include "timer/Timer.h"
 #include "sensor/sdl/Sensor.h"
+#include "profiler/Profiler.h"
 
 #include <cmath>
 
+#include <SDL3/SDL_timer.h>
+
+#ifdef LOVE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
 #include "joystick/sdl/Joystick.h"
 #include "window/sdl/Window.h"
 
@@ -80,6 +89,20 @@ static void normalizedToDPICoords(love::window::Window *window, double *x, doubl
 // SDL, unlike with SDL_PollEvents. This is useful for some events which require
 // handling inside the function which triggered them on some backends.
 // Note: this may run on non-main threads on some platforms (Android?)
+static int convertMouseButton(int button)
+{
+	// SDL uses button 3 for the right mouse button, but we use button 2
+	switch (button)
+	{
+	case SDL_BUTTON_RIGHT:
+		return 2;
+	case SDL_BUTTON_MIDDLE:
+		return 3;
+	default:
+		return button;
+	}
+}
+
 static bool SDLCALL watchAppEvents(void *udata, SDL_Event *event)
 {
 	auto eventModule = (Event *)udata;
@@ -99,7 +122,7 @@ static bool SDLCALL watchAppEvents(void *udata, SDL_Event *event)
 		break;
 	case SDL_EVENT_WINDOW_EXPOSED:
 		if (eventModule != nullptr && SDL_IsMainThread() && eventModule->allowModalDraws())
-			eventModule->modalDraw();
+			eventModule->runModalFrame();
 		break;
 	default:
 		break;
@@ -119,12 +142,15 @@ Event::Event()
 
 Event::~Event()
 {
+	endModalLoop();
 	SDL_RemoveEventWatch(watchAppEvents, this);
 	SDL_QuitSubSystem(SDL_INIT_EVENTS);
 }
 
 void Event::pump(float waitTimeout)
 {
+	LOVE_PROFILE_ZONE("love.event.pump");
+
 	exceptionIfInRenderPass("love.event.pump");
 
 	bool shouldPoll = false;
@@ -154,10 +180,13 @@ void Event::pump(float waitTimeout)
 		catch (std::exception &)
 		{
 			insideEventPump = false;
+			endModalLoop();
 			throw;
 		}
 		insideEventPump = false;
 
+		endModalLoop();
+
 		if (success)
 		{
 			StrongRef<Message> msg(convert(e), Acquire::NORETAIN);
@@ -221,6 +250,32 @@ bool Event::allowModalDraws() const
 	return insideEventPump;
 }
 
+void Event::runModalFrame()
+{
+#ifdef LOVE_WINDOWS
+	// SDL keeps frames coming during move and resize loops with a Win32 timer,
+	// which only fires at the system timer resolution (usually 15.6ms) unless
+	// it's raised.
+	if (!inModalLoop)
+		timeBeginPeriod(1);
+#endif
+
+	inModalLoop = true;
+	modalDraw();
+}
+
+void Event::endModalLoop()
+{
+	if (!inModalLoop)
+		return;
+
+#ifdef LOVE_WINDOWS
+	timeEndPeriod(1);
+#endif
+
+	inModalLoop = false;
+}
+
 void Event::exceptionIfInRenderPass(const char *name)
 {
 	// Some core OS graphics functionality (e.g. swap buffers on some platforms)
@@ -236,8 +291,7 @@ Message *Event::convert(const SDL_Event &e)
 {
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	MessageArgs vargs;
 
 	love::filesystem::Filesystem *filesystem = nullptr;
 	love::sensor::Sensor *sensorInstance = nullptr;
@@ -261,6 +315,9 @@ Message *Event::convert(const SDL_Event &e)
 			sdlwin->handleSDLEvent(e);
 	}
 
+	if (isInputSampling())
+		recordInputSample(e, win);
+
 	switch (e.type)
 	{
 	case SDL_EVENT_KEY_DOWN:
@@ -279,10 +336,10 @@ Message *Event::convert(const SDL_Event &e)
 		if (!love::keyboard::Keyboard::getConstant(scancode, txt2))
 			txt2 = "unknown";
 
-		vargs.emplace_back(txt, strlen(txt));
-		vargs.emplace_back(txt2, strlen(txt2));
+		vargs.emplace_back(Variant::fromStaticString(txt));
+		vargs.emplace_back(Variant::fromStaticString(txt2));
 		vargs.emplace_back(e.key.repeat != 0);
-		msg = new Message("keypressed", vargs);
+		msg = newMessage("keypressed", vargs);
 		break;
 	case SDL_EVENT_KEY_UP:
 		love::keyboard::sdl::Keyboard::getConstant(e.key.key, key);
@@ -293,21 +350,21 @@ Message *Event::convert(const SDL_Event &e)
 		if (!love::keyboard::Keyboard::getConstant(scancode, txt2))
 			txt2 = "unknown";
 
-		vargs.emplace_back(txt, strlen(txt));
-		vargs.emplace_back(txt2, strlen(txt2));
-		msg = new Message("keyreleased", vargs);
+		vargs.emplace_back(Variant::fromStaticString(txt));
+		vargs.emplace_back(Variant::fromStaticString(txt2));
+		msg = newMessage("keyreleased", vargs);
 		break;
 	case SDL_EVENT_TEXT_INPUT:
 		txt = e.text.text;
 		vargs.emplace_back(txt, strlen(txt));
-		msg = new Message("textinput", vargs);
+		msg = newMessage("textinput", vargs);
 		break;
 	case SDL_EVENT_TEXT_EDITING:
 		txt = e.edit.text;
 		vargs.emplace_back(txt, strlen(txt));
 		vargs.emplace_back((double) e.edit.start);
 		vargs.emplace_back((double) e.edit.length);
-		msg = new Message("textedited", vargs);
+		msg = newMessage("textedited", vargs);
 		break;
 	case SDL_EVENT_MOUSE_MOTION:
 		{
@@ -330,23 +387,13 @@ Message *Event::convert(const SDL_Event &e)
 			vargs.emplace_back(xrel);
 			vargs.emplace_back(yrel);
 			vargs.emplace_back(e.motion.which == SDL_TOUCH_MOUSEID);
-			msg = new Message("mousemoved", vargs);
+			msg = newMessage("mousemoved", vargs);
 		}
 		break;
 	case SDL_EVENT_MOUSE_BUTTON_DOWN:
 	case SDL_EVENT_MOUSE_BUTTON_UP:
 		{
-			// SDL uses button 3 for the right mouse button, but we use button 2
-			int button = e.button.button;
-			switch (button)
-			{
-			case SDL_BUTTON_RIGHT:
-				button = 2;
-				break;
-			case SDL_BUTTON_MIDDLE:
-				button = 3;
-				break;
-			}
+			int button = convertMouseButton(e.button.button);
 
 			double px = (double) e.button.x;
 			double py = (double) e.button.y;
@@ -361,7 +408,7 @@ Message *Event::convert(const SDL_Event &e)
 			vargs.emplace_back((double) e.button.clicks);
 
 			bool down = e.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
-			msg = new Message(down ? "mousepressed" : "mousereleased", vargs);
+			msg = newMessage(down ? "mousepressed" : "mousereleased", vargs);
 		}
 		break;
 	case SDL_EVENT_MOUSE_WHEEL:
@@ -369,9 +416,9 @@ Message *Event::convert(const SDL_Event &e)
 		vargs.emplace_back((double) e.wheel.y);
 
 		txt = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? "flipped" : "standard";
-		vargs.emplace_back(txt, strlen(txt));
+		vargs.emplace_back(Variant::fromStaticString(txt));
 
-		msg = new Message("wheelmoved", vargs);
+		msg = newMessage("wheelmoved", vargs);
 		break;
 	case SDL_EVENT_FINGER_DOWN:
 	case SDL_EVENT_FINGER_UP:
@@ -411,7 +458,7 @@ Message *Event::convert(const SDL_Event &e)
 		vargs.emplace_back(touchinfo.dx);
 		vargs.emplace_back(touchinfo.dy);
 		vargs.emplace_back(touchinfo.pressure);
-		vargs.emplace_back(txt, strlen(txt));
+		vargs.emplace_back(Variant::fromStaticString(txt));
 		vargs.emplace_back(touchinfo.mouse);
 
 		if (e.type == SDL_EVENT_FINGER_DOWN)
@@ -420,7 +467,7 @@ Message *Event::convert(const SDL_Event &e)
 			txt = "touchreleased";
 		else
 			txt = "touchmoved";
-		msg = new Message(txt, vargs);
+		msg = newMessage(txt, vargs);
 		break;
 	case SDL_EVENT_JOYSTICK_BUTTON_DOWN:
 	case SDL_EVENT_JOYSTICK_BUTTON_UP:
@@ -487,13 +534,13 @@ Message *Event::convert(const SDL_Event &e)
 			}
 			SDL_free(displays);
 			vargs.emplace_back((double)(displayindex + 1));
-			vargs.emplace_back(txt, strlen(txt));
+			vargs.emplace_back(Variant::fromStaticString(txt));
 
-			msg = new Message("displayrotated", vargs);
+			msg = newMessage("displayrotated", vargs);
 		}
 		break;
 	case SDL_EVENT_DROP_BEGIN:
-		msg = new Message("dropbegan", vargs);
+		msg = newMessage("dropbegan", vargs);
 		break;
 	case SDL_EVENT_DROP_COMPLETE:
 		{
@@ -502,7 +549,7 @@ Message *Event::convert(const SDL_Event &e)
 			windowToDPICoords(win, &x, &y);
 			vargs.emplace_back(x);
 			vargs.emplace_back(y);
-			msg = new Message("dropcompleted", vargs);
+			msg = newMessage("dropcompleted", vargs);
 		}
 		break;
 	case SDL_EVENT_DROP_POSITION:
@@ -512,7 +559,7 @@ Message *Event::convert(const SDL_Event &e)
 			windowToDPICoords(win, &x, &y);
 			vargs.emplace_back(x);
 			vargs.emplace_back(y);
-			msg = new Message("dropmoved", vargs);
+			msg = newMessage("dropmoved", vargs);
 		}
 		break;
 	case SDL_EVENT_DROP_FILE:
@@ -532,7 +579,7 @@ Message *Event::convert(const SDL_Event &e)
 				vargs.emplace_back(filepath, strlen(filepath));
 				vargs.emplace_back(x);
 				vargs.emplace_back(y);
-				msg = new Message("directorydropped", vargs);
+				msg = newMessage("directorydropped", vargs);
 			}
 			else
 			{
@@ -540,20 +587,20 @@ Message *Event::convert(const SDL_Event &e)
 				vargs.emplace_back(&love::filesystem::File::type, file);
 				vargs.emplace_back(x);
 				vargs.emplace_back(y);
-				msg = new Message("filedropped", vargs);
+				msg = newMessage("filedropped", vargs);
 				file->release();
 			}
 		}
 		break;
 	case SDL_EVENT_QUIT:
 	case SDL_EVENT_TERMINATING:
-		msg = new Message("quit");
+		msg = newMessage("quit");
 		break;
 	case SDL_EVENT_LOW_MEMORY:
-		msg = new Message("lowmemory");
+		msg = newMessage("lowmemory");
 		break;
 	case SDL_EVENT_LOCALE_CHANGED:
-		msg = new Message("localechanged");
+		msg = newMessage("localechanged");
 		break;
 	case SDL_EVENT_SENSOR_UPDATE:
 		sensorInstance = Module::getInstance<sensor::Sensor>(M_SENSOR);
@@ -574,13 +621,13 @@ Message *Event::convert(const SDL_Event &e)
 					if (!sensor::Sensor::getConstant(sensor::sdl::Sensor::convert(sdltype), sensorType))
 						sensorType = "unknown";
 
-					vargs.emplace_back(sensorType, strlen(sensorType));
+					vargs.emplace_back(Variant::fromStaticString(sensorType));
 					// Both accelerometer and gyroscope only pass up to 3 values.
 					// https://github.com/libsdl-org/SDL/blob/SDL2/include/SDL_sensor.h#L81-L127
 					vargs.emplace_back(e.sensor.data[0]);
 					vargs.emplace_back(e.sensor.data[1]);
 					vargs.emplace_back(e.sensor.data[2]);
-					msg = new Message("sensorupdated", vargs);
+					msg = newMessage("sensorupdated", vargs);
 
 					break;
 				}
@@ -594,7 +641,102 @@ Message *Event::convert(const SDL_Event &e)
 	return msg;
 }
 
-Message *Event::convertJoystickEvent(const SDL_Event &e) const
+void Event::recordInputSample(const SDL_Event &e, love::window::Window *win)
+{
+	InputSample sample = {};
+
+	switch (e.type)
+	{
+	case SDL_EVENT_MOUSE_MOTION:
+		sample.type = INPUT_MOUSE_MOVED;
+		sample.values[0] = e.motion.x;
+		sample.values[1] = e.motion.y;
+		sample.values[2] = e.motion.xrel;
+		sample.values[3] = e.motion.yrel;
+		clampToWindow(win, &sample.values[0], &sample.values[1]);
+		windowToDPICoords(win, &sample.values[0], &sample.values[1]);
+		windowToDPICoords(win, &sample.values[2], &sample.values[3]);
+		break;
+	case SDL_EVENT_MOUSE_BUTTON_DOWN:
+	case SDL_EVENT_MOUSE_BUTTON_UP:
+		sample.type = e.type == SDL_EVENT_MOUSE_BUTTON_DOWN ? INPUT_MOUSE_PRESSED : INPUT_MOUSE_RELEASED;
+		sample.index = convertMouseButton(e.button.button);
+		sample.values[0] = e.button.x;
+		sample.values[1] = e.button.y;
+		clampToWindow(win, &sample.values[0], &sample.values[1]);
+		windowToDPICoords(win, &sample.values[0], &sample.values[1]);
+		break;
+	case SDL_EVENT_FINGER_DOWN:
+	case SDL_EVENT_FINGER_UP:
+	case SDL_EVENT_FINGER_MOTION:
+		if (e.type == SDL_EVENT_FINGER_DOWN)
+			sample.type = INPUT_TOUCH_PRESSED;
+		else if (e.type == SDL_EVENT_FINGER_UP)
+			sample.type = INPUT_TOUCH_RELEASED;
+		else
+			sample.type = INPUT_TOUCH_MOVED;
+		sample.id = (int64) e.tfinger.fingerID;
+		sample.values[0] = e.tfinger.x;
+		sample.values[1] = e.tfinger.y;
+		sample.values[2] = e.tfinger.dx;
+		sample.values[3] = e.tfinger.dy;
+		sample.values[4] = e.tfinger.pressure;
+		if (love::touch::sdl::Touch::getDeviceType(SDL_GetTouchDeviceType(e.tfinger.touchID)) == love::touch::Touch::DEVICE_TOUCHSCREEN)
+		{
+			normalizedToDPICoords(win, &sample.values[0], &sample.values[1]);
+			normalizedToDPICoords(win, &sample.values[2], &sample.values[3]);
+		}
+		break;
+	case SDL_EVENT_JOYSTICK_AXIS_MOTION:
+		sample.type = INPUT_JOYSTICK_AXIS;
+		sample.id = e.jaxis.which;
+		sample.index = e.jaxis.axis + 1;
+		sample.values[0] = joystick::Joystick::clampval(e.jaxis.value / 32768.0f);
+		break;
+	case SDL_EVENT_JOYSTICK_BUTTON_DOWN:
+	case SDL_EVENT_JOYSTICK_BUTTON_UP:
+		sample.type = e.type == SDL_EVENT_JOYSTICK_BUTTON_DOWN ? INPUT_JOYSTICK_PRESSED : INPUT_JOYSTICK_RELEASED;
+		sample.id = e.jbutton.which;
+		sample.index = e.jbutton.button + 1;
+		break;
+	case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+		{
+			joystick::Joystick::GamepadAxis axis;
+			if (!joystick::sdl::Joystick::getConstant((SDL_GamepadAxis) e.gaxis.axis, axis))
+				return;
+
+			sample.type = INPUT_GAMEPAD_AXIS;
+			sample.id = e.gaxis.which;
+			sample.index = axis;
+			sample.values[0] = joystick::Joystick::clampval(e.gaxis.value / 32768.0f);
+		}
+		break;
+	case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+	case SDL_EVENT_GAMEPAD_BUTTON_UP:
+		{
+			joystick::Joystick::GamepadButton button;
+			if (!joystick::sdl::Joystick::getConstant((SDL_GamepadButton) e.gbutton.button, button))
+				return;
+
+			sample.type = e.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN ? INPUT_GAMEPAD_PRESSED : INPUT_GAMEPAD_RELEASED;
+			sample.id = e.gbutton.which;
+			sample.index = button;
+		}
+		break;
+	default:
+		return;
+	}
+
+	// Event timestamps use SDL's tick clock. Measure how long ago the event
+	// happened and use that to put it on love.timer's clock.
+	Uint64 now = SDL_GetTicksNS();
+	double age = e.common.timestamp < now ? (now - e.common.timestamp) / 1.0e9 : 0.0;
+	sample.time = love::timer::Timer::getTime() - age;
+
+	addInputSample(sample);
+}
+
+Message *Event::convertJoystickEvent(const SDL_Event &e)
 {
 	auto joymodule = Module::getInstance<joystick::JoystickModule>(Module::M_JOYSTICK);
 	if (!joymodule)
@@ -602,8 +744,7 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	MessageArgs vargs;
 
 	love::Type *joysticktype = &love::joystick::Joystick::type;
 	love::joystick::Joystick *stick = nullptr;
@@ -622,9 +763,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 
 		vargs.emplace_back(joysticktype, stick);
 		vargs.emplace_back((double)(e.jbutton.button+1));
-		msg = new Message((e.type == SDL_EVENT_JOYSTICK_BUTTON_DOWN) ?
-						  "joystickpressed" : "joystickreleased",
-						  vargs);
+		msg = newMessage((e.type == SDL_EVENT_JOYSTICK_BUTTON_DOWN) ?
+						 "joystickpressed" : "joystickreleased",
+						 vargs);
 		break;
 	case SDL_EVENT_JOYSTICK_AXIS_MOTION:
 		{
@@ -636,7 +777,7 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 			vargs.emplace_back((double)(e.jaxis.axis+1));
 			float value = joystick::Joystick::clampval(e.jaxis.value / 32768.0f);
 			vargs.emplace_back((double) value);
-			msg = new Message("joystickaxis", vargs);
+			msg = newMessage("joystickaxis", vargs);
 		}
 		break;
 	case SDL_EVENT_JOYSTICK_HAT_MOTION:
@@ -649,8 +790,8 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 
 		vargs.emplace_back(joysticktype, stick);
 		vargs.emplace_back((double)(e.jhat.hat+1));
-		vargs.emplace_back(txt, strlen(txt));
-		msg = new Message("joystickhat", vargs);
+		vargs.emplace_back(Variant::fromStaticString(txt));
+		msg = newMessage("joystickhat", vargs);
 		break;
 	case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
 	case SDL_EVENT_GAMEPAD_BUTTON_UP:
@@ -667,9 +808,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 				break;
 
 			vargs.emplace_back(joysticktype, stick);
-			vargs.emplace_back(txt, strlen(txt));
-			msg = new Message(e.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN ?
-							  "gamepadpressed" : "gamepadreleased", vargs);
+			vargs.emplace_back(Variant::fromStaticString(txt));
+			msg = newMessage(e.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN ?
+							 "gamepadpressed" : "gamepadreleased", vargs);
 		}
 		break;
 	case SDL_EVENT_GAMEPAD_AXIS_MOTION:
@@ -684,10 +825,10 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 				break;
 
 			vargs.emplace_back(joysticktype, stick);
-			vargs.emplace_back(txt, strlen(txt));
+			vargs.emplace_back(Variant::fromStaticString(txt));
 			float value = joystick::Joystick::clampval(a.value / 32768.0f);
 			vargs.emplace_back((double) value);
-			msg = new Message("gamepadaxis", vargs);
+			msg = newMessage("gamepadaxis", vargs);
 		}
 		break;
 	case SDL_EVENT_JOYSTICK_ADDED:
@@ -696,7 +837,7 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		if (stick)
 		{
 			vargs.emplace_back(joysticktype, stick);
-			msg = new Message("joystickadded", vargs);
+			msg = newMessage("joystickadded", vargs);
 		}
 		break;
 	case SDL_EVENT_JOYSTICK_REMOVED:
@@ -706,7 +847,7 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		{
 			joymodule->removeJoystick(stick);
 			vargs.emplace_back(joysticktype, stick);
-			msg = new Message("joystickremoved", vargs);
+			msg = newMessage("joystickremoved", vargs);
 		}
 		break;
 #if defined(LOVE_ENABLE_SENSOR)
@@ -724,11 +865,11 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 					sensorName = "unknown";
 
 				vargs.emplace_back(joysticktype, stick);
-				vargs.emplace_back(sensorName, strlen(sensorName));
+				vargs.emplace_back(Variant::fromStaticString(sensorName));
 				vargs.emplace_back(sens.data[0]);
 				vargs.emplace_back(sens.data[1]);
 				vargs.emplace_back(sens.data[2]);
-				msg = new Message("joysticksensorupdated", vargs);
+				msg = newMessage("joysticksensorupdated", vargs);
 			}
 		}
 		break;
@@ -744,8 +885,7 @@ Message *Event::convertWindowEvent(const SDL_Event &e, love::window::Window *win
 {
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	MessageArgs vargs;
 
 	graphics::Graphics *gfx = nullptr;
 
@@ -756,12 +896,12 @@ Message *Event::convertWindowEvent(const SDL_Event &e, love::window::Window *win
 	case SDL_EVENT_WINDOW_FOCUS_GAINED:
 	case SDL_EVENT_WINDOW_FOCUS_LOST:
 		vargs.emplace_back(event == SDL_EVENT_WINDOW_FOCUS_GAINED);
-		msg = new Message("focus", vargs);
+		msg = newMessage("focus", vargs);
 		break;
 	case SDL_EVENT_WINDOW_MOUSE_ENTER:
 	case SDL_EVENT_WINDOW_MOUSE_LEAVE:
 		vargs.emplace_back(event == SDL_EVENT_WINDOW_MOUSE_ENTER);
-		msg = new Message("mousefocus", vargs);
+		msg = newMessage("mousefocus", vargs);
 		break;
 	case SDL_EVENT_WINDOW_SHOWN:
 	case SDL_EVENT_WINDOW_HIDDEN:
@@ -779,13 +919,13 @@ Message *Event::convertWindowEvent(const SDL_Event &e, love::window::Window *win
 		// WINDOW_RESTORED can also happen when going from maximized -> unmaximized,
 		// but there isn't a nice way to avoid sending our event in that situation.
 		vargs.emplace_back(event == SDL_EVENT_WINDOW_SHOWN || event == SDL_EVENT_WINDOW_RESTORED);
-		msg = new Message("visible", vargs);
+		msg = newMessage("visible", vargs);
 		break;
 	case SDL_EVENT_WINDOW_EXPOSED:
-		msg = new Message("exposed");
+		msg = newMessage("exposed");
 		break;
 	case SDL_EVENT_WINDOW_OCCLUDED:
-		msg = new Message("occluded");
+		msg = newMessage("occluded");
 		break;
 	case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
 		{
@@ -812,7 +952,7 @@ Message *Event::convertWindowEvent(const SDL_Event &e, love::window::Window *win
 
 			vargs.emplace_back(width);
 			vargs.emplace_back(height);
-			msg = new Message("resize", vargs);
+			msg = newMessage("resize", vargs);
 		}
 		break;
 	}
@@ -64,16 +64,29 @@ public:
 
 	bool allowModalDraws() const;
 
+	/**
+	 * Runs the modal draw callback while the OS is running its own event loop,
+	 * e.g. while a window is being moved or resized.
+	 **/
+	void runModalFrame();
+
 private:
 
 	void exceptionIfInRenderPass(const char *name);
 
 	Message *convert(const SDL_Event &e);
-	Message *convertJoystickEvent(const SDL_Event &e) const;
+	Message *convertJoystickEvent(const SDL_Event &e);
 	Message *convertWindowEvent(const SDL_Event &e, love::window::Window *win);
 
+	void recordInputSample(const SDL_Event &e, love::window::Window *win);
+
+	void endModalLoop();
+
 	bool insideEventPump = false;
 
+	// Whether a modal frame has run since pump started waiting for events.
+	bool inModalLoop = false;
+
 }; // Event
 
 } // sdl
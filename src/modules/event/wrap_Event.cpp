@@ -23,6 +23,7 @@
 // LOVE
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "joystick/JoystickModule.h"
 #include "sdl/Event.h"
 
 #include <algorithm>
@@ -41,12 +42,12 @@ namespace event
 
 static int luax_pushmessage(lua_State *L, const Message &m)
 {
-	luax_pushstring(L, m.name);
+	luax_pushstring(L, m.getName());
 
-	for (const Variant &v : m.args)
-		luax_pushvariant(L, v);
+	for (size_t i = 0; i < m.getArgCount(); i++)
+		luax_pushvariant(L, m.getArg(i));
 
-	return (int) m.args.size() + 1;
+	return (int) m.getArgCount() + 1;
 }
 
 static int w_poll_i(lua_State *L)
@@ -56,7 +57,7 @@ static int w_poll_i(lua_State *L)
 	if (instance()->poll(m) && m != nullptr)
 	{
 		int args = luax_pushmessage(L, *m);
-		m->release();
+		instance()->releaseMessage(m);
 		return args;
 	}
 
@@ -64,6 +65,186 @@ static int w_poll_i(lua_State *L)
 	return 0;
 }
 
+// Pushes t[index] from the table at tidx, creating it if needed, and returns
+// the number of values it held.
+static int luax_pushbatchentry(lua_State *L, int tidx, int index)
+{
+	lua_rawgeti(L, tidx, index);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_createtable(L, 8, 1);
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, tidx, index);
+	}
+
+	lua_getfield(L, -1, "n");
+	int oldsize = lua_isnumber(L, -1) ? (int) lua_tointeger(L, -1) : 0;
+	lua_pop(L, 1);
+
+	return oldsize;
+}
+
+// Clears values left over from the entry's previous contents, and pops it.
+static void luax_finishbatchentry(lua_State *L, int size, int oldsize)
+{
+	for (int i = size + 1; i <= oldsize; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+
+	lua_pushinteger(L, size);
+	lua_setfield(L, -2, "n");
+
+	lua_pop(L, 1);
+}
+
+int w_pollBatch(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	int maxcount = (int) luaL_optinteger(L, 2, LOVE_INT32_MAX);
+
+	int count = 0;
+	Message *m = nullptr;
+
+	while (count < maxcount && instance()->poll(m))
+	{
+		if (m == nullptr)
+			continue;
+
+		count++;
+
+		// Reuse the table from a previous call if there is one.
+		int oldsize = luax_pushbatchentry(L, 1, count);
+
+		luax_pushstring(L, m->getName());
+		lua_rawseti(L, -2, 1);
+
+		int size = (int) m->getArgCount() + 1;
+		for (int i = 2; i <= size; i++)
+		{
+			luax_pushvariant(L, m->getArg(i - 2));
+			lua_rawseti(L, -2, i);
+		}
+
+		luax_finishbatchentry(L, size, oldsize);
+		instance()->releaseMessage(m);
+	}
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
+int w_setInputSampling(lua_State *L)
+{
+	bool enable = luax_checkboolean(L, 1);
+	int capacity = (int) luaL_optinteger(L, 2, Event::DEFAULT_INPUT_SAMPLE_CAPACITY);
+	luax_catchexcept(L, [&]() { instance()->setInputSampling(enable, capacity); });
+	return 0;
+}
+
+int w_isInputSampling(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isInputSampling());
+	return 1;
+}
+
+static int luax_pushinputsample(lua_State *L, const Event::InputSample &sample)
+{
+	auto joymodule = Module::getInstance<joystick::JoystickModule>(Module::M_JOYSTICK);
+	joystick::Joystick *stick = nullptr;
+	const char *txt = nullptr;
+
+	switch (sample.type)
+	{
+	case Event::INPUT_MOUSE_MOVED:
+		for (int i = 0; i < 4; i++)
+			lua_pushnumber(L, sample.values[i]);
+		return 4;
+	case Event::INPUT_MOUSE_PRESSED:
+	case Event::INPUT_MOUSE_RELEASED:
+		lua_pushnumber(L, sample.values[0]);
+		lua_pushnumber(L, sample.values[1]);
+		lua_pushinteger(L, sample.index);
+		return 3;
+	case Event::INPUT_TOUCH_PRESSED:
+	case Event::INPUT_TOUCH_MOVED:
+	case Event::INPUT_TOUCH_RELEASED:
+		// Touch IDs are light userdata, as in touch events.
+		lua_pushlightuserdata(L, (void *) (intptr_t) sample.id);
+		for (int i = 0; i < 5; i++)
+			lua_pushnumber(L, sample.values[i]);
+		return 6;
+	default:
+		break;
+	}
+
+	if (joymodule != nullptr)
+		stick = joymodule->getJoystickFromID((int) sample.id);
+
+	// The joystick is nil if it was disconnected since.
+	luax_pushtype(L, stick);
+
+	switch (sample.type)
+	{
+	case Event::INPUT_JOYSTICK_AXIS:
+		lua_pushinteger(L, sample.index);
+		lua_pushnumber(L, sample.values[0]);
+		return 3;
+	case Event::INPUT_JOYSTICK_PRESSED:
+	case Event::INPUT_JOYSTICK_RELEASED:
+		lua_pushinteger(L, sample.index);
+		return 2;
+	case Event::INPUT_GAMEPAD_AXIS:
+		joystick::Joystick::getConstant((joystick::Joystick::GamepadAxis) sample.index, txt);
+		lua_pushstring(L, txt);
+		lua_pushnumber(L, sample.values[0]);
+		return 3;
+	case Event::INPUT_GAMEPAD_PRESSED:
+	case Event::INPUT_GAMEPAD_RELEASED:
+		joystick::Joystick::getConstant((joystick::Joystick::GamepadButton) sample.index, txt);
+		lua_pushstring(L, txt);
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+int w_getInputSamples(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	int maxcount = (int) luaL_optinteger(L, 2, LOVE_INT32_MAX);
+
+	int count = 0;
+	Event::InputSample sample;
+
+	while (count < maxcount && instance()->pollInputSample(sample))
+	{
+		count++;
+
+		int oldsize = luax_pushbatchentry(L, 1, count);
+
+		const char *typestr = nullptr;
+		Event::getConstant(sample.type, typestr);
+		lua_pushstring(L, typestr);
+		lua_rawseti(L, -2, 1);
+
+		lua_pushnumber(L, sample.time);
+		lua_rawseti(L, -2, 2);
+
+		int values = luax_pushinputsample(L, sample);
+		for (int i = values; i > 0; i--)
+			lua_rawseti(L, -1 - i, 2 + i);
+
+		luax_finishbatchentry(L, 2 + values, oldsize);
+	}
+
+	lua_pushinteger(L, count);
+	lua_pushnumber(L, (lua_Number) instance()->takeLostInputSampleCount());
+	return 2;
+}
+
 int w_pump(lua_State *L)
 {
 	float waitTimeout = (float)luaL_optnumber(L, 1, 0.0f);
@@ -80,7 +261,7 @@ int w_wait(lua_State *L)
 	if (m != nullptr)
 	{
 		int args = luax_pushmessage(L, *m);
-		m->release();
+		instance()->releaseMessage(m);
 		return args;
 	}
 
@@ -221,6 +402,10 @@ static const luaL_Reg functions[] =
 {
 	{ "pump", w_pump },
 	{ "poll_i", w_poll_i },
+	{ "pollBatch", w_pollBatch },
+	{ "setInputSampling", w_setInputSampling },
+	{ "isInputSampling", w_isInputSampling },
+	{ "getInputSamples", w_getInputSamples },
 	{ "wait", w_wait },
 	{ "push", w_push },
 	{ "clear", w_clear },
@@ -0,0 +1,515 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "DirectoryWatcher.h"
+#include "common/Exception.h"
+
+#if defined(LOVE_LINUX) || defined(LOVE_ANDROID)
+#	define LOVE_WATCHER_INOTIFY
+#	include "thread/threads.h"
+#	include <cerrno>
+#	include <cstring>
+#	include <dirent.h>
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#	include <unordered_map>
+#elif defined(LOVE_WINDOWS) && !defined(LOVE_WINDOWS_UWP)
+#	define LOVE_WATCHER_WINDOWS
+#	include "thread/threads.h"
+#	include "common/utf8.h"
+#	include <windows.h>
+#elif defined(LOVE_MACOS)
+#	define LOVE_WATCHER_FSEVENTS
+#	include <CoreServices/CoreServices.h>
+#	include <dispatch/dispatch.h>
+#	include <limits.h>
+#	include <stdlib.h>
+#	include <unistd.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+#if defined(LOVE_WATCHER_INOTIFY)
+
+// inotify watches single directories, so every subdirectory gets its own
+// watch and new ones are added as they're created.
+struct DirectoryWatcher::Impl : public love::thread::Threadable
+{
+	static const uint32_t MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+	DirectoryWatcher *watcher;
+	int fd;
+	int wakefds[2];
+
+	// Watch descriptors to directory paths relative to the watched one.
+	std::unordered_map<int, std::string> directories;
+
+	Impl(DirectoryWatcher *watcher)
+		: watcher(watcher)
+		, fd(-1)
+		, wakefds{-1, -1}
+	{
+		threadName = "DirectoryWatcher";
+
+		fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0 || pipe(wakefds) != 0)
+		{
+			closeAll();
+			throw love::Exception("Could not watch directory %s.", watcher->path.c_str());
+		}
+
+		if (!addWatches(""))
+		{
+			closeAll();
+			throw love::Exception("Could not watch directory %s.", watcher->path.c_str());
+		}
+
+		if (!start())
+		{
+			closeAll();
+			throw love::Exception("Could not start the directory watcher thread.");
+		}
+	}
+
+	virtual ~Impl()
+	{
+		closeAll();
+	}
+
+	void closeAll()
+	{
+		if (fd >= 0)
+			close(fd);
+		for (int wakefd : wakefds)
+		{
+			if (wakefd >= 0)
+				close(wakefd);
+		}
+		fd = -1;
+		wakefds[0] = wakefds[1] = -1;
+	}
+
+	void stop()
+	{
+		char c = 0;
+		while (write(wakefds[1], &c, 1) < 0 && errno == EINTR) {}
+		wait();
+	}
+
+	std::string getFullPath(const std::string &relative) const
+	{
+		return relative.empty() ? watcher->path : watcher->path + "/" + relative;
+	}
+
+	bool addWatches(const std::string &relative)
+	{
+		std::string fullpath = getFullPath(relative);
+
+		int wd = inotify_add_watch(fd, fullpath.c_str(), MASK);
+		if (wd < 0)
+			return false;
+
+		directories[wd] = relative;
+
+		DIR *dir = opendir(fullpath.c_str());
+		if (dir == nullptr)
+			return true;
+
+		while (dirent *entry = readdir(dir))
+		{
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+				continue;
+
+			std::string child = relative.empty() ? entry->d_name : relative + "/" + entry->d_name;
+
+			bool isdir = entry->d_type == DT_DIR;
+			if (entry->d_type == DT_UNKNOWN)
+			{
+				struct stat st = {};
+				isdir = stat(getFullPath(child).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+			}
+
+			if (isdir)
+				addWatches(child);
+		}
+
+		closedir(dir);
+		return true;
+	}
+
+	// A moved directory's watches would report its old paths.
+	void removeWatches(const std::string &relative)
+	{
+		for (auto it = directories.begin(); it != directories.end();)
+		{
+			const std::string &dir = it->second;
+			if (dir == relative || dir.compare(0, relative.size() + 1, relative + "/") == 0)
+			{
+				inotify_rm_watch(fd, it->first);
+				it = directories.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void handle(const inotify_event *event)
+	{
+		if ((event->mask & IN_IGNORED) != 0)
+		{
+			directories.erase(event->wd);
+			return;
+		}
+
+		auto it = directories.find(event->wd);
+		if (it == directories.end() || event->len == 0)
+			return;
+
+		std::string path = it->second.empty() ? event->name : it->second + "/" + event->name;
+
+		if ((event->mask & IN_ISDIR) != 0)
+		{
+			if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+				addWatches(path);
+			else if ((event->mask & IN_MOVED_FROM) != 0)
+				removeWatches(path);
+		}
+
+		if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+			watcher->callback(path, CHANGE_CREATED);
+		else if ((event->mask & IN_CLOSE_WRITE) != 0)
+			watcher->callback(path, CHANGE_MODIFIED);
+		else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+			watcher->callback(path, CHANGE_REMOVED);
+	}
+
+	void threadFunction() override
+	{
+		alignas(inotify_event) char buffer[16 * 1024];
+
+		while (true)
+		{
+			pollfd fds[2] = {{fd, POLLIN, 0}, {wakefds[0], POLLIN, 0}};
+
+			if (poll(fds, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				break;
+			}
+
+			if ((fds[1].revents & POLLIN) != 0)
+				break;
+
+			ssize_t size = read(fd, buffer, sizeof(buffer));
+			if (size <= 0)
+				continue;
+
+			for (ssize_t i = 0; i < size;)
+			{
+				const inotify_event *event = (const inotify_event *) (buffer + i);
+				handle(event);
+				i += sizeof(inotify_event) + event->len;
+			}
+		}
+	}
+};
+
+#elif defined(LOVE_WATCHER_WINDOWS)
+
+struct DirectoryWatcher::Impl : public love::thread::Threadable
+{
+	static const DWORD FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+	DirectoryWatcher *watcher;
+	HANDLE directory;
+	HANDLE stopEvent;
+	OVERLAPPED overlapped;
+	DWORD buffer[16 * 1024];
+
+	Impl(DirectoryWatcher *watcher)
+		: watcher(watcher)
+		, directory(INVALID_HANDLE_VALUE)
+		, stopEvent(nullptr)
+		, overlapped()
+	{
+		threadName = "DirectoryWatcher";
+
+		std::wstring wpath = to_widestr(watcher->path);
+		directory = CreateFileW(wpath.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+		stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		overlapped.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+		if (directory == INVALID_HANDLE_VALUE || stopEvent == nullptr || overlapped.hEvent == nullptr || !request())
+		{
+			closeAll();
+			throw love::Exception("Could not watch directory %s.", watcher->path.c_str());
+		}
+
+		if (!start())
+		{
+			cancel();
+			closeAll();
+			throw love::Exception("Could not start the directory watcher thread.");
+		}
+	}
+
+	virtual ~Impl()
+	{
+		closeAll();
+	}
+
+	void closeAll()
+	{
+		if (directory != INVALID_HANDLE_VALUE)
+			CloseHandle(directory);
+		if (stopEvent != nullptr)
+			CloseHandle(stopEvent);
+		if (overlapped.hEvent != nullptr)
+			CloseHandle(overlapped.hEvent);
+
+		directory = INVALID_HANDLE_VALUE;
+		stopEvent = nullptr;
+		overlapped.hEvent = nullptr;
+	}
+
+	bool request()
+	{
+		return ReadDirectoryChangesW(directory, buffer, sizeof(buffer), TRUE, FILTER, nullptr, &overlapped, nullptr) != 0;
+	}
+
+	// The pending read writes into the buffer, so it has to be finished
+	// before anything is freed.
+	void cancel()
+	{
+		DWORD bytes = 0;
+		if (CancelIoEx(directory, &overlapped) || GetLastError() != ERROR_NOT_FOUND)
+			GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+	}
+
+	void stop()
+	{
+		SetEvent(stopEvent);
+		wait();
+		cancel();
+	}
+
+	void handle(const FILE_NOTIFY_INFORMATION *info)
+	{
+		std::wstring wname(info->FileName, info->FileNameLength / sizeof(WCHAR));
+		std::string path = to_utf8(wname.c_str());
+		std::replace(path.begin(), path.end(), '\\', '/');
+
+		switch (info->Action)
+		{
+		case FILE_ACTION_ADDED:
+		case FILE_ACTION_RENAMED_NEW_NAME:
+			watcher->callback(path, CHANGE_CREATED);
+			break;
+		case FILE_ACTION_MODIFIED:
+			watcher->callback(path, CHANGE_MODIFIED);
+			break;
+		case FILE_ACTION_REMOVED:
+		case FILE_ACTION_RENAMED_OLD_NAME:
+			watcher->callback(path, CHANGE_REMOVED);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void threadFunction() override
+	{
+		HANDLE handles[2] = {overlapped.hEvent, stopEvent};
+
+		while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0)
+		{
+			DWORD bytes = 0;
+			if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE))
+				break;
+
+			// Zero bytes means the buffer overflowed and changes were lost.
+			const char *data = (const char *) buffer;
+			for (DWORD offset = 0; bytes > 0;)
+			{
+				const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *) (data + offset);
+				handle(info);
+
+				if (info->NextEntryOffset == 0)
+					break;
+				offset += info->NextEntryOffset;
+			}
+
+			if (!request())
+				break;
+		}
+	}
+};
+
+#elif defined(LOVE_WATCHER_FSEVENTS)
+
+struct DirectoryWatcher::Impl
+{
+	DirectoryWatcher *watcher;
+	FSEventStreamRef stream;
+	dispatch_queue_t queue;
+
+	// FSEvents reports canonical paths, e.g. /private/var instead of /var.
+	std::string root;
+
+	Impl(DirectoryWatcher *watcher)
+		: watcher(watcher)
+		, stream(nullptr)
+		, queue(nullptr)
+	{
+		char resolved[PATH_MAX];
+		if (realpath(watcher->path.c_str(), resolved) == nullptr)
+			throw love::Exception("Could not watch directory %s.", watcher->path.c_str());
+
+		root = std::string(resolved) + "/";
+
+		CFStringRef cfpath = CFStringCreateWithFileSystemRepresentation(nullptr, resolved);
+		CFArrayRef paths = CFArrayCreate(nullptr, (const void **) &cfpath, 1, &kCFTypeArrayCallBacks);
+
+		FSEventStreamContext context = {0, this, nullptr, nullptr, nullptr};
+		FSEventStreamCreateFlags flags = kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer;
+		stream = FSEventStreamCreate(nullptr, callback, &context, paths, kFSEventStreamEventIdSinceNow, 0.05, flags);
+
+		CFRelease(paths);
+		CFRelease(cfpath);
+
+		if (stream == nullptr)
+			throw love::Exception("Could not watch directory %s.", watcher->path.c_str());
+
+		queue = dispatch_queue_create("org.love2d.DirectoryWatcher", DISPATCH_QUEUE_SERIAL);
+		FSEventStreamSetDispatchQueue(stream, queue);
+
+		if (!FSEventStreamStart(stream))
+		{
+			stop();
+			throw love::Exception("Could not watch directory %s.", watcher->path.c_str());
+		}
+	}
+
+	void stop()
+	{
+		FSEventStreamStop(stream);
+		FSEventStreamInvalidate(stream);
+		FSEventStreamRelease(stream);
+
+		// Waits for a callback which might still be running.
+		dispatch_sync_f(queue, nullptr, [](void *) {});
+		dispatch_release(queue);
+	}
+
+	static void callback(ConstFSEventStreamRef, void *info, size_t count, void *eventpaths, const FSEventStreamEventFlags flags[], const FSEventStreamEventId[])
+	{
+		Impl *impl = (Impl *) info;
+		const char **paths = (const char **) eventpaths;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			std::string fullpath = paths[i];
+			if (fullpath.compare(0, impl->root.size(), impl->root) != 0)
+				continue;
+
+			std::string path = fullpath.substr(impl->root.size());
+
+			// Events are coalesced, so one can have every flag set. The file's
+			// current state decides which change it was.
+			if (access(paths[i], F_OK) != 0)
+				impl->watcher->callback(path, CHANGE_REMOVED);
+			else if ((flags[i] & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRenamed)) != 0 && (flags[i] & kFSEventStreamEventFlagItemModified) == 0)
+				impl->watcher->callback(path, CHANGE_CREATED);
+			else if ((flags[i] & (kFSEventStreamEventFlagItemModified | kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRenamed)) != 0)
+				impl->watcher->callback(path, CHANGE_MODIFIED);
+		}
+	}
+};
+
+#else
+
+struct DirectoryWatcher::Impl
+{
+	Impl(DirectoryWatcher *)
+	{
+		throw love::Exception("Watching directories is not supported on this platform.");
+	}
+
+	void stop() {}
+};
+
+#endif
+
+DirectoryWatcher::DirectoryWatcher(const std::string &path, const Callback &callback)
+	: path(path)
+	, callback(callback)
+	, impl(nullptr)
+{
+	impl = new Impl(this);
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+	impl->stop();
+
+#if defined(LOVE_WATCHER_INOTIFY) || defined(LOVE_WATCHER_WINDOWS)
+	impl->release();
+#else
+	delete impl;
+#endif
+}
+
+const std::string &DirectoryWatcher::getPath() const
+{
+	return path;
+}
+
+bool DirectoryWatcher::isSupported()
+{
+#if defined(LOVE_WATCHER_INOTIFY) || defined(LOVE_WATCHER_WINDOWS) || defined(LOVE_WATCHER_FSEVENTS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+STRINGMAP_CLASS_BEGIN(DirectoryWatcher, DirectoryWatcher::Change, DirectoryWatcher::CHANGE_MAX_ENUM, change)
+{
+	{ "created",  DirectoryWatcher::CHANGE_CREATED  },
+	{ "modified", DirectoryWatcher::CHANGE_MODIFIED },
+	{ "removed",  DirectoryWatcher::CHANGE_REMOVED  },
+}
+STRINGMAP_CLASS_END(DirectoryWatcher, DirectoryWatcher::Change, DirectoryWatcher::CHANGE_MAX_ENUM, change)
+
+} // filesystem
+} // love
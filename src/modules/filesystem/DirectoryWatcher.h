@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/StringMap.h"
+
+// C++
+#include <functional>
+#include <string>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * Watches a directory on disk and everything inside it for changes, using
+ * the OS's change notifications rather than polling. Changes are reported
+ * from a background thread.
+ **/
+class DirectoryWatcher
+{
+public:
+
+	enum Change
+	{
+		CHANGE_CREATED,
+		CHANGE_MODIFIED,
+		CHANGE_REMOVED,
+		CHANGE_MAX_ENUM
+	};
+
+	// Called with the changed file's path relative to the watched directory,
+	// using forward slashes.
+	typedef std::function<void(const std::string &path, Change change)> Callback;
+
+	/**
+	 * Starts watching. Throws if the directory can't be watched.
+	 * @param path The native path of the directory.
+	 **/
+	DirectoryWatcher(const std::string &path, const Callback &callback);
+
+	/**
+	 * Stops watching. The callback isn't called again once this returns.
+	 **/
+	~DirectoryWatcher();
+
+	const std::string &getPath() const;
+
+	/**
+	 * Whether directories can be watched on this platform.
+	 **/
+	static bool isSupported();
+
+	STRINGMAP_CLASS_DECLARE(Change);
+
+private:
+
+	struct Impl;
+
+	std::string path;
+	Callback callback;
+	Impl *impl;
+
+}; // DirectoryWatcher
+
+} // filesystem
+} // love
@@ -19,6 +19,7 @@
  **/
 
 #include "FileData.h"
+#include "common/memory.h"
 
 // C++
 #include <iostream>
@@ -34,7 +35,6 @@ love::Type FileData::type("FileData", &Data::type);
 FileData::FileData(uint64 size, const std::string &filename)
 	: data(nullptr)
 	, size((size_t) size)
-	, filename(filename)
 {
 	try
 	{
@@ -45,15 +45,15 @@ FileData::FileData(uint64 size, const std::string &filename)
 		throw love::Exception("Out of memory.");
 	}
 
-	size_t dotpos = filename.rfind('.');
+	trackAllocation(MEMORY_FILE, this->size);
+	setFilename(filename);
+}
 
-	if (dotpos != std::string::npos)
-	{
-		extension = filename.substr(dotpos + 1);
-		name = filename.substr(0, dotpos);
-	}
-	else
-		name = filename;
+FileData::FileData(const std::string &filename)
+	: data(nullptr)
+	, size(0)
+{
+	setFilename(filename);
 }
 
 FileData::FileData(const FileData &c)
@@ -72,13 +72,32 @@ FileData::FileData(const FileData &c)
 		throw love::Exception("Out of memory.");
 	}
 	memcpy(data, c.data, size);
+	trackAllocation(MEMORY_FILE, size);
 }
 
 FileData::~FileData()
 {
+	// Subclasses which don't own their data set it to null before this runs.
+	if (data != nullptr)
+		trackDeallocation(MEMORY_FILE, size);
 	delete [] data;
 }
 
+void FileData::setFilename(const std::string &filename)
+{
+	this->filename = filename;
+
+	size_t dotpos = filename.rfind('.');
+
+	if (dotpos != std::string::npos)
+	{
+		extension = filename.substr(dotpos + 1);
+		name = filename.substr(0, dotpos);
+	}
+	else
+		name = filename;
+}
+
 FileData *FileData::clone() const
 {
 	return new FileData(*this);
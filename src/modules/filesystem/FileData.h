@@ -52,7 +52,11 @@ public:
 	const std::string &getExtension() const;
 	const std::string &getName() const;
 
-private:
+protected:
+
+	// For subclasses which provide the data's memory themselves. They must
+	// set data and size, and clear data before it would be deleted.
+	FileData(const std::string &filename);
 
 	// The actual data.
 	char *data;
@@ -60,6 +64,10 @@ private:
 	// Size of the data.
 	uint64 size;
 
+private:
+
+	void setFilename(const std::string &filename);
+
 	// The filename used for error purposes.
 	std::string filename;
 
@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "FileOperation.h"
+#include "Filesystem.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+love::Type FileOperation::type("FileOperation", &Object::type);
+
+FileOperation::FileOperation(Kind kind, const std::string &filename, Data *data, love::thread::Channel *channel)
+	: kind(kind)
+	, filename(filename)
+	, data(data)
+	, channel(channel)
+	, complete(false)
+{
+}
+
+FileOperation::FileOperation(const std::vector<StagedFile> &files, love::thread::Channel *channel)
+	: kind(KIND_COMMIT)
+	, filename(files.empty() ? std::string() : files[0].filename)
+	, files(files)
+	, channel(channel)
+	, complete(false)
+{
+}
+
+FileOperation::FileOperation(const std::string &dir, const std::string &pattern, love::thread::Channel *channel)
+	: kind(KIND_SCAN)
+	, filename(dir)
+	, pattern(pattern)
+	, channel(channel)
+	, complete(false)
+{
+}
+
+FileOperation::FileOperation(const std::string &tag, const std::vector<std::string> &filenames, love::thread::Channel *channel)
+	: kind(KIND_PREFETCH)
+	, filename(tag)
+	, prefetchFiles(filenames)
+	, channel(channel)
+	, complete(false)
+{
+}
+
+FileOperation::~FileOperation()
+{
+}
+
+bool FileOperation::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+void FileOperation::wait()
+{
+	love::thread::Lock lock(mutex);
+	while (!complete)
+		completeCond->wait(mutex);
+}
+
+FileData *FileOperation::getFileData()
+{
+	wait();
+
+	love::thread::Lock lock(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return fileData.get();
+}
+
+const std::vector<DirectoryEntry> &FileOperation::getDirectoryEntries()
+{
+	wait();
+
+	love::thread::Lock lock(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return entries;
+}
+
+std::string FileOperation::getError() const
+{
+	love::thread::Lock lock(mutex);
+	return error;
+}
+
+void FileOperation::run(Filesystem *fs)
+{
+	FileData *result = nullptr;
+	std::string err;
+
+	try
+	{
+		if (kind == KIND_READ)
+			result = fs->read(filename.c_str());
+		else if (kind == KIND_COMMIT)
+			fs->commit(files);
+		else if (kind == KIND_SCAN)
+		{
+			std::vector<DirectoryEntry> found;
+			fs->scanDirectory(filename.c_str(), pattern, found);
+
+			love::thread::Lock lock(mutex);
+			entries.swap(found);
+		}
+		else if (kind == KIND_PREFETCH)
+		{
+			std::vector<StrongRef<FileData>> results;
+			fs->readMany(prefetchFiles, results);
+			fs->addPrefetchedFiles(prefetchFiles, results);
+		}
+		else if (kind == KIND_APPEND)
+			fs->append(filename.c_str(), data->getData(), (int64) data->getSize());
+		else
+			fs->write(filename.c_str(), data->getData(), (int64) data->getSize());
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+
+		// Nothing was prefetched, but the files are no longer pending.
+		if (kind == KIND_PREFETCH)
+			fs->addPrefetchedFiles(prefetchFiles, {});
+	}
+
+	finish(result, err);
+
+	if (result != nullptr)
+		result->release();
+}
+
+void FileOperation::finish(FileData *result, const std::string &err)
+{
+	StrongRef<love::thread::Channel> notify;
+
+	{
+		love::thread::Lock lock(mutex);
+
+		fileData.set(result);
+		error = err;
+		complete = true;
+
+		// Written data is no longer needed once the operation is done.
+		data.set(nullptr);
+		files.clear();
+		prefetchFiles.clear();
+		notify.set(channel.get());
+		channel.set(nullptr);
+
+		completeCond->broadcast();
+	}
+
+	if (notify.get() != nullptr)
+		notify->push(Variant(&FileOperation::type, this));
+}
+
+} // filesystem
+} // love
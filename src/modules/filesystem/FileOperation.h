@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "thread/Channel.h"
+#include "FileData.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+class Filesystem;
+struct DirectoryEntry;
+
+/**
+ * An in-flight read, write, append, commit, directory scan or prefetch, run on
+ * love.filesystem's I/O thread. If a Channel was given, the FileOperation pushes itself to it once
+ * it has finished.
+ **/
+class FileOperation : public love::Object
+{
+public:
+
+	enum Kind
+	{
+		KIND_READ,
+		KIND_WRITE,
+		KIND_APPEND,
+		KIND_COMMIT,
+		KIND_SCAN,
+		KIND_PREFETCH,
+	};
+
+	// A file written by a commit.
+	struct StagedFile
+	{
+		std::string filename;
+		StrongRef<Data> data;
+	};
+
+	static love::Type type;
+
+	FileOperation(Kind kind, const std::string &filename, Data *data, love::thread::Channel *channel);
+	FileOperation(const std::vector<StagedFile> &files, love::thread::Channel *channel);
+	FileOperation(const std::string &dir, const std::string &pattern, love::thread::Channel *channel);
+	FileOperation(const std::string &tag, const std::vector<std::string> &filenames, love::thread::Channel *channel);
+	virtual ~FileOperation();
+
+	Kind getKind() const { return kind; }
+
+	// The first file's name for a commit, the directory for a scan, or the
+	// tag for a prefetch.
+	const std::string &getFilename() const { return filename; }
+
+	bool isComplete() const;
+
+	/**
+	 * Blocks until the operation has finished.
+	 **/
+	void wait();
+
+	/**
+	 * Waits for the operation to finish and returns the file's contents for a
+	 * read, or null for a write. Throws an exception if the operation failed.
+	 **/
+	FileData *getFileData();
+
+	/**
+	 * Waits for a scan to finish and returns what it found. Throws an
+	 * exception if the operation failed.
+	 **/
+	const std::vector<DirectoryEntry> &getDirectoryEntries();
+
+	/**
+	 * Returns the error message if the operation has finished and failed, or
+	 * an empty string otherwise.
+	 **/
+	std::string getError() const;
+
+	// Called by the I/O thread.
+	void run(Filesystem *fs);
+
+private:
+
+	void finish(FileData *result, const std::string &err);
+
+	Kind kind;
+	std::string filename;
+
+	StrongRef<Data> data;
+	std::vector<StagedFile> files;
+	std::string pattern;
+	std::vector<std::string> prefetchFiles;
+	StrongRef<love::thread::Channel> channel;
+
+	StrongRef<FileData> fileData;
+	std::vector<DirectoryEntry> entries;
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef completeCond;
+
+}; // FileOperation
+
+} // filesystem
+} // love
@@ -58,6 +58,161 @@ Filesystem::~Filesystem()
 {
 }
 
+void Filesystem::setBytecodeCacheEnabled(bool enable)
+{
+	bytecodeCacheEnabled = enable;
+}
+
+bool Filesystem::isBytecodeCacheEnabled() const
+{
+	return bytecodeCacheEnabled;
+}
+
+// Where read recordings are stored in the save directory.
+static const char *READ_RECORDING_DIRECTORY = ".readrecordings";
+
+std::string Filesystem::getReadRecordingFilename(const std::string &tag)
+{
+	return std::string(READ_RECORDING_DIRECTORY) + "/" + tag + ".txt";
+}
+
+void Filesystem::setReadRecording(const std::string &tag)
+{
+	if (!tag.empty() && (tag[0] == '.' || tag.find_first_of("/\\") != std::string::npos))
+		throw love::Exception("Invalid read recording tag: %s", tag.c_str());
+
+	std::string oldtag;
+	std::vector<std::string> files;
+
+	{
+		love::thread::Lock lock(prefetchMutex);
+
+		if (tag == readRecordingTag)
+			return;
+
+		oldtag = readRecordingTag;
+		files.swap(recordedReads);
+		recordedReadSet.clear();
+		readRecordingTag = tag;
+	}
+
+	if (oldtag.empty())
+		return;
+
+	std::string contents;
+	for (const std::string &file : files)
+		contents += file + "\n";
+
+	if (!createDirectory(READ_RECORDING_DIRECTORY))
+		throw love::Exception("Could not create the read recording directory.");
+
+	// Written on the I/O thread, like other saves which nothing waits on.
+	std::string filename = getReadRecordingFilename(oldtag);
+	StrongRef<FileData> data(newFileData(contents.data(), contents.size(), filename.c_str()), Acquire::NORETAIN);
+	FileOperation *op = newFileOperation(FileOperation::KIND_WRITE, filename.c_str(), data, nullptr);
+	op->release();
+}
+
+std::string Filesystem::getReadRecording() const
+{
+	love::thread::Lock lock(prefetchMutex);
+	return readRecordingTag;
+}
+
+FileOperation *Filesystem::prefetch(const std::string &tag, love::thread::Channel *channel)
+{
+	std::string filename = getReadRecordingFilename(tag);
+	if (tag.empty() || !exists(filename.c_str()))
+		return nullptr;
+
+	// Not read with read(), so the recording itself isn't recorded.
+	StrongRef<File> file(openFile(filename.c_str(), File::MODE_READ), Acquire::NORETAIN);
+	StrongRef<FileData> manifest(file->read(), Acquire::NORETAIN);
+
+	const char *contents = (const char *) manifest->getData();
+	std::string list(contents, (size_t) manifest->getSize());
+
+	std::vector<std::string> candidates;
+	size_t start = 0;
+	while (start < list.size())
+	{
+		size_t end = list.find('\n', start);
+		if (end == std::string::npos)
+			end = list.size();
+
+		// Files removed since the recording was made are skipped.
+		std::string name = list.substr(start, end - start);
+		if (!name.empty() && exists(name.c_str()))
+			candidates.push_back(name);
+
+		start = end + 1;
+	}
+
+	std::vector<std::string> filenames;
+
+	{
+		love::thread::Lock lock(prefetchMutex);
+		for (const std::string &name : candidates)
+		{
+			if (prefetchedFiles.count(name) == 0 && pendingPrefetches.insert(name).second)
+				filenames.push_back(name);
+		}
+	}
+
+	return newPrefetchOperation(tag, filenames, channel);
+}
+
+void Filesystem::addPrefetchedFiles(const std::vector<std::string> &filenames, const std::vector<StrongRef<FileData>> &data)
+{
+	love::thread::Lock lock(prefetchMutex);
+
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		// Files which were read while the prefetch was running aren't kept.
+		if (pendingPrefetches.erase(filenames[i]) > 0 && i < data.size() && data[i].get() != nullptr)
+			prefetchedFiles[filenames[i]] = data[i];
+	}
+}
+
+FileData *Filesystem::takePrefetchedFile(const char *filename) const
+{
+	love::thread::Lock lock(prefetchMutex);
+
+	std::string name(filename);
+	pendingPrefetches.erase(name);
+
+	auto it = prefetchedFiles.find(name);
+	if (it == prefetchedFiles.end())
+		return nullptr;
+
+	FileData *data = it->second.get();
+	data->retain();
+	prefetchedFiles.erase(it);
+
+	return data;
+}
+
+void Filesystem::forgetPrefetchedFile(const char *filename) const
+{
+	love::thread::Lock lock(prefetchMutex);
+
+	std::string name(filename);
+	pendingPrefetches.erase(name);
+	prefetchedFiles.erase(name);
+}
+
+void Filesystem::recordRead(const char *filename) const
+{
+	love::thread::Lock lock(prefetchMutex);
+
+	if (readRecordingTag.empty())
+		return;
+
+	std::string name(filename);
+	if (recordedReadSet.insert(name).second)
+		recordedReads.push_back(name);
+}
+
 void Filesystem::setAndroidSaveExternal(bool useExternal)
 {	
 	this->useExternal = useExternal;
@@ -203,6 +358,53 @@ std::string Filesystem::canonicalizeRealPath(const std::string &p) const
 	}
 }
 
+bool Filesystem::matchGlob(const char *pattern, const char *path)
+{
+	while (*pattern != '\0')
+	{
+		if (pattern[0] == '*' && pattern[1] == '*')
+		{
+			pattern += 2;
+
+			// "**/" can match zero directories.
+			if (*pattern == '/' && matchGlob(pattern + 1, path))
+				return true;
+
+			for (const char *p = path; ; p++)
+			{
+				if (matchGlob(pattern, p))
+					return true;
+				if (*p == '\0')
+					return false;
+			}
+		}
+		else if (*pattern == '*')
+		{
+			pattern++;
+
+			for (const char *p = path; ; p++)
+			{
+				if (matchGlob(pattern, p))
+					return true;
+				if (*p == '\0' || *p == '/')
+					return false;
+			}
+		}
+		else if (*pattern == '?')
+		{
+			if (*path == '\0' || *path == '/')
+				return false;
+		}
+		else if (*pattern != *path)
+			return false;
+
+		pattern++;
+		path++;
+	}
+
+	return *path == '\0';
+}
+
 std::string Filesystem::getExecutablePath() const
 {
 #if defined(LOVE_MACOS) || defined(LOVE_IOS)
@@ -27,11 +27,14 @@
 #include "common/int.h"
 #include "common/StringMap.h"
 #include "FileData.h"
+#include "FileOperation.h"
 #include "File.h"
 
 // C++
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 // In Windows, we would like to use "LOVE" as the
 // application folder, but in Linux, we like .love.
@@ -253,6 +256,22 @@ public:
 	virtual FileData *read(const char *filename, int64 size) const = 0;
 	virtual FileData *read(const char *filename) const = 0;
 
+	/**
+	 * Gets a file's contents without reading them into memory up front, by
+	 * memory-mapping the file if it's a regular file on disk. Files inside
+	 * archives are read normally instead.
+	 * @param filename The name of the file to map.
+	 **/
+	virtual FileData *mapFile(const char *filename) const = 0;
+
+	/**
+	 * Reads several files at once. Files in archives are read in the order
+	 * they're stored, and decompressed in parallel.
+	 * @param filenames The files to read.
+	 * @param results The contents of each file, in the same order.
+	 **/
+	virtual void readMany(const std::vector<std::string> &filenames, std::vector<StrongRef<FileData>> &results) = 0;
+
 	/**
 	 * Write data to a file.
 	 * @param filename The name of the file to write to.
@@ -269,12 +288,50 @@ public:
 	 **/
 	virtual void append(const char *filename, const void *data, int64 size) const = 0;
 
+	/**
+	 * Writes several files so that each one is either fully replaced or left
+	 * as it was, even if the game crashes or the power is lost partway. Every
+	 * file is written to a temporary file and synced to disk before any of
+	 * them is renamed over the original.
+	 * @param files The files to write, relative to the save directory.
+	 **/
+	virtual void commit(const std::vector<FileOperation::StagedFile> &files) = 0;
+
+	/**
+	 * Reads, writes or appends to a file on the I/O thread instead of blocking
+	 * the calling thread.
+	 * @param kind Whether to read, write or append.
+	 * @param filename The file to operate on.
+	 * @param data The data to write or append. Ignored for reads.
+	 * @param channel Optional Channel the operation is pushed to once done.
+	 **/
+	virtual FileOperation *newFileOperation(FileOperation::Kind kind, const char *filename, Data *data, love::thread::Channel *channel) = 0;
+
+	/**
+	 * Commits the files on the I/O thread, after any operations queued before.
+	 **/
+	virtual FileOperation *newCommitOperation(const std::vector<FileOperation::StagedFile> &files, love::thread::Channel *channel) = 0;
+
 	/**
 	 * This "native" method returns a table of all
 	 * files in a given directory.
 	 **/
 	virtual bool getDirectoryItems(const char *dir, std::vector<std::string> &items) = 0;
 
+	/**
+	 * Finds everything inside a directory and its subdirectories, along with
+	 * each item's info, sorted by path. Paths are relative to the directory.
+	 * Symlinked directories aren't followed.
+	 * @param pattern If not empty, only items whose relative path matches
+	 * this glob pattern (see matchGlob) are returned.
+	 **/
+	virtual void scanDirectory(const char *dir, const std::string &pattern, std::vector<DirectoryEntry> &entries) = 0;
+
+	/**
+	 * Scans a directory on the I/O thread, after any operations queued before.
+	 **/
+	virtual FileOperation *newScanOperation(const char *dir, const std::string &pattern, love::thread::Channel *channel) = 0;
+
 	/**
 	 * Enable or disable symbolic link support in love.filesystem.
 	 **/
@@ -285,6 +342,67 @@ public:
 	 **/
 	virtual bool areSymlinksEnabled() const = 0;
 
+	/**
+	 * Enable or disable caching of which paths exist, used by exists, getInfo
+	 * and require. Disabled by default. The cache is cleared whenever
+	 * love.filesystem mounts, unmounts, creates or removes something, but
+	 * changes made to mounted directories by other means won't be seen while
+	 * it's enabled, unless watching is enabled.
+	 **/
+	virtual void setPathCacheEnabled(bool enable) = 0;
+	virtual bool isPathCacheEnabled() const = 0;
+
+	/**
+	 * Forgets all cached path lookups.
+	 **/
+	virtual void clearPathCache() = 0;
+
+	/**
+	 * Enable or disable watching the source and save directories for changes
+	 * made on disk, which are pushed to the event queue as filechanged
+	 * events. Only directories can be watched, not a .love file.
+	 * @return False if watching isn't supported on this platform.
+	 **/
+	virtual bool setWatchEnabled(bool enable) = 0;
+	virtual bool isWatchEnabled() const = 0;
+
+	/**
+	 * Enable or disable caching the compiled bytecode of required Lua files
+	 * in the save directory, so they don't have to be compiled again on
+	 * later runs. Cached bytecode is only used when the source, its path and
+	 * the Lua version all match.
+	 **/
+	void setBytecodeCacheEnabled(bool enable);
+	bool isBytecodeCacheEnabled() const;
+
+	/**
+	 * Starts recording the names of files read in full with read() under the
+	 * given tag, in the order they're first read. The list is saved in the
+	 * save directory when recording stops or another tag is started, so a
+	 * later run can prefetch the same files. An empty tag stops recording.
+	 **/
+	void setReadRecording(const std::string &tag);
+	std::string getReadRecording() const;
+
+	/**
+	 * Reads the files recorded under the tag by an earlier run on the I/O
+	 * thread, so read() can return their contents without going to disk.
+	 * Each prefetched file is handed out once, and files read before their
+	 * prefetch finishes are skipped. Returns null if nothing was recorded.
+	 * @param tag The tag the files were recorded under.
+	 * @param channel Optional Channel the operation is pushed to once done.
+	 **/
+	FileOperation *prefetch(const std::string &tag, love::thread::Channel *channel);
+
+	/**
+	 * Reads files on the I/O thread for prefetch, after any operations queued
+	 * before.
+	 **/
+	virtual FileOperation *newPrefetchOperation(const std::string &tag, const std::vector<std::string> &filenames, love::thread::Channel *channel) = 0;
+
+	// Called once a prefetch operation has read its files.
+	void addPrefetchedFiles(const std::vector<std::string> &filenames, const std::vector<StrongRef<FileData>> &data);
+
 	// Require path accessors
 	// Not const because it's R/W
 	virtual std::vector<std::string> &getRequirePath() = 0;
@@ -316,6 +434,14 @@ public:
 	 **/
 	virtual std::string getExecutablePath() const;
 
+	/**
+	 * Matches a '/' separated path against a glob pattern. '*' matches any
+	 * characters except '/', '?' matches one character except '/', and '**'
+	 * matches anything, including across directories. A '**' followed by a
+	 * '/' can also match no directories at all.
+	 **/
+	static bool matchGlob(const char *pattern, const char *path);
+
 	STRINGMAP_CLASS_DECLARE(FileType);
 	STRINGMAP_CLASS_DECLARE(CommonPath);
 	STRINGMAP_CLASS_DECLARE(MountPermissions);
@@ -325,15 +451,46 @@ protected:
 
 	Filesystem(const char *name);
 
+	/**
+	 * Returns the prefetched contents of a file and forgets them, or null if
+	 * the file hasn't been prefetched.
+	 **/
+	FileData *takePrefetchedFile(const char *filename) const;
+	void forgetPrefetchedFile(const char *filename) const;
+	void recordRead(const char *filename) const;
+
 private:
 
+	static std::string getReadRecordingFilename(const std::string &tag);
+
 	bool getRealPathType(const std::string &path, FileType &ftype) const;
 
 	// Should we save external or internal for Android
 	bool useExternal = false;
 
+	bool bytecodeCacheEnabled = false;
+
+	// Guards the read recording and prefetched files, which are used by
+	// reads on any thread.
+	love::thread::MutexRef prefetchMutex;
+
+	std::string readRecordingTag;
+	mutable std::vector<std::string> recordedReads;
+	mutable std::unordered_set<std::string> recordedReadSet;
+
+	// Files which are being prefetched and haven't been read yet.
+	mutable std::unordered_set<std::string> pendingPrefetches;
+	mutable std::unordered_map<std::string, StrongRef<FileData>> prefetchedFiles;
+
 }; // Filesystem
 
+// An item found by Filesystem::scanDirectory.
+struct DirectoryEntry
+{
+	std::string path;
+	Filesystem::Info info;
+};
+
 } // filesystem
 } // love
 
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "MappedFileData.h"
+
+#ifdef LOVE_WINDOWS
+#	include "common/utf8.h"
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace filesystem
+{
+
+MappedFileData::MappedFileData(MappedFileData *parent, uint64 offset, uint64 size, const std::string &filename)
+	: FileData(filename)
+	, parent(parent)
+#ifdef LOVE_WINDOWS
+	, mapping(nullptr)
+#endif
+{
+	if (offset > parent->getSize() || size > parent->getSize() - offset)
+		throw love::Exception("Mapped range is outside of %s.", parent->getFilename().c_str());
+
+	this->data = (char *) parent->getData() + offset;
+	this->size = size;
+}
+
+#ifdef LOVE_WINDOWS
+
+MappedFileData::MappedFileData(const std::string &path, const std::string &filename)
+	: FileData(filename)
+	, mapping(nullptr)
+{
+	std::wstring wpath = to_widestr(path);
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw love::Exception("Could not open file %s.", path.c_str());
+
+	LARGE_INTEGER filesize = {};
+	if (!GetFileSizeEx(file, &filesize) || filesize.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		throw love::Exception("Could not map file %s.", path.c_str());
+	}
+
+	// The mapping keeps the file open by itself.
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+		throw love::Exception("Could not map file %s.", path.c_str());
+
+	data = (char *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		throw love::Exception("Could not map file %s.", path.c_str());
+	}
+
+	size = (uint64) filesize.QuadPart;
+}
+
+MappedFileData::~MappedFileData()
+{
+	if (parent.get() == nullptr)
+	{
+		UnmapViewOfFile(data);
+		CloseHandle(mapping);
+	}
+
+	// FileData would delete[] it otherwise.
+	data = nullptr;
+}
+
+void MappedFileData::prefetch(uint64 /*offset*/, uint64 /*size*/) const
+{
+	// PrefetchVirtualMemory needs Windows 8. The file cache's own readahead
+	// still picks up sequential accesses.
+}
+
+#else // LOVE_WINDOWS
+
+MappedFileData::MappedFileData(const std::string &path, const std::string &filename)
+	: FileData(filename)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw love::Exception("Could not open file %s.", path.c_str());
+
+	struct stat st = {};
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+	{
+		close(fd);
+		throw love::Exception("Could not map file %s.", path.c_str());
+	}
+
+	// The mapping stays valid after the descriptor is closed.
+	void *mem = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mem == MAP_FAILED)
+		throw love::Exception("Could not map file %s.", path.c_str());
+
+	data = (char *) mem;
+	size = (uint64) st.st_size;
+}
+
+MappedFileData::~MappedFileData()
+{
+	if (parent.get() == nullptr)
+		munmap(data, (size_t) size);
+
+	// FileData would delete[] it otherwise.
+	data = nullptr;
+}
+
+void MappedFileData::prefetch(uint64 offset, uint64 size) const
+{
+	if (offset >= this->size || size == 0)
+		return;
+
+	size = std::min(size, this->size - offset);
+
+	// madvise needs a page-aligned start address.
+	uintptr_t pagesize = (uintptr_t) sysconf(_SC_PAGESIZE);
+	uintptr_t start = (uintptr_t) data + (uintptr_t) offset;
+	uintptr_t alignedstart = start - (start % pagesize);
+
+	madvise((void *) alignedstart, (size_t) (start + size - alignedstart), MADV_WILLNEED);
+}
+
+#endif // LOVE_WINDOWS
+
+} // filesystem
+} // love
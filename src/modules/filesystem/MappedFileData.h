@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "FileData.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * FileData whose contents are a read-only memory mapping of a file on disk,
+ * so nothing is copied until the pages are actually used.
+ **/
+class MappedFileData : public FileData
+{
+public:
+
+	/**
+	 * @param path The native path of the file to map.
+	 * @param filename The (virtual) filename reported by getFilename.
+	 **/
+	MappedFileData(const std::string &path, const std::string &filename);
+
+	/**
+	 * Creates a view of part of another mapping, e.g. a file stored
+	 * uncompressed inside a mapped archive. The view keeps it mapped.
+	 **/
+	MappedFileData(MappedFileData *parent, uint64 offset, uint64 size, const std::string &filename);
+
+	virtual ~MappedFileData();
+
+	/**
+	 * Asks the OS to start reading part of the mapping from disk, so later
+	 * accesses don't wait on it. This is only a hint, and it does nothing on
+	 * some platforms.
+	 **/
+	void prefetch(uint64 offset, uint64 size) const;
+
+private:
+
+	StrongRef<MappedFileData> parent;
+
+#ifdef LOVE_WINDOWS
+	void *mapping;
+#endif
+
+}; // MappedFileData
+
+} // filesystem
+} // love
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+
+// C++
+#include <cstddef>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * The layout of LOVE pack (.lpk) archives, which are written by the lovepack
+ * tool and mounted like zip files. Everything is little-endian.
+ *
+ * The file starts with a Header, followed by the Entry table sorted by the
+ * hash of each entry's path, the child index table of every directory, the
+ * path strings, and finally the file contents, each starting at a multiple
+ * of the pack's alignment. Looking up a path is a binary search of the entry
+ * table, so nothing has to be parsed when a pack is mounted.
+ **/
+namespace pack
+{
+
+static const char MAGIC[4] = {'L', 'P', 'A', 'K'};
+static const uint32 VERSION = 1;
+
+enum Compression
+{
+	COMPRESSION_NONE = 0,
+	COMPRESSION_LZ4 = 1,
+};
+
+enum EntryFlags
+{
+	ENTRY_DIRECTORY = 1 << 0,
+};
+
+struct Header
+{
+	char magic[4];
+	uint32 version;
+	uint32 entryCount;
+	uint32 childCount;
+	uint32 alignment;
+	uint32 reserved0;
+
+	// Offsets are from the start of the pack.
+	uint64 entriesOffset;
+	uint64 childrenOffset;
+	uint64 namesOffset;
+	uint64 namesSize;
+	uint64 reserved1;
+};
+
+struct Entry
+{
+	// hashPath of the entry's full path, without a leading slash. The root
+	// directory's path is the empty string.
+	uint64 hash;
+
+	// For files, the location and stored size of the contents. For
+	// directories, the first index into the child table and the child count.
+	uint64 offset;
+	uint64 size;
+
+	uint64 uncompressedSize;
+	int64 modtime;
+
+	// The full path, in the path strings. Not null-terminated.
+	uint32 nameOffset;
+	uint32 nameLength;
+
+	uint32 flags;
+	uint32 compression;
+};
+
+static_assert(sizeof(Header) == 64, "Pack header must be tightly packed.");
+static_assert(sizeof(Entry) == 56, "Pack entries must be tightly packed.");
+
+// 64-bit FNV-1a.
+inline uint64 hashPath(const char *path, size_t length)
+{
+	uint64 hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (uint8) path[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+} // pack
+} // filesystem
+} // love
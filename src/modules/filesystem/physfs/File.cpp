@@ -45,6 +45,21 @@ static bool setupWriteDirectory()
 	return fs != nullptr && fs->setupWriteDirectory();
 }
 
+static bool exists(const std::string &filename)
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs != nullptr)
+		return fs->exists(filename.c_str());
+	return PHYSFS_exists(filename.c_str()) != 0;
+}
+
+static void clearPathCache()
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs != nullptr)
+		fs->clearPathCache();
+}
+
 File::File(const std::string &filename, Mode mode)
 	: filename(filename)
 	, file(nullptr)
@@ -105,7 +120,7 @@ bool File::open(Mode mode)
 		throw love::Exception("PhysFS is not initialized.");
 
 	// File must exist if read mode.
-	if ((mode == MODE_READ) && !PHYSFS_exists(filename.c_str()))
+	if ((mode == MODE_READ) && !exists(filename))
 		throw love::Exception("Could not open file %s. Does not exist.", filename.c_str());
 
 	// Check whether the write directory is set.
@@ -145,6 +160,10 @@ bool File::open(Mode mode)
 
 	this->mode = mode;
 
+	// Opening for writing can create the file.
+	if (mode == MODE_APPEND || mode == MODE_WRITE)
+		clearPathCache();
+
 	if (file != nullptr && !setBuffer(bufferMode, bufferSize))
 	{
 		// Revert to buffer defaults if we don't successfully set the buffer.
@@ -28,6 +28,11 @@
 #include "Filesystem.h"
 #include "File.h"
 #include "PhysfsIo.h"
+#include "PackArchiver.h"
+#include "ReadBatch.h"
+#include "filesystem/MappedFileData.h"
+#include "thread/threads.h"
+#include "event/Event.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -45,6 +50,7 @@
 #else
 #	include <sys/param.h>
 #	include <unistd.h>
+#	include <fcntl.h>
 #endif
 
 #if defined(LOVE_IOS) || defined(LOVE_MACOS)
@@ -60,6 +66,8 @@
 #endif
 
 #include <string>
+#include <set>
+#include <deque>
 
 #ifdef LOVE_ANDROID
 #include <SDL3/SDL.h>
@@ -73,6 +81,82 @@ namespace filesystem
 namespace physfs
 {
 
+// A single thread is enough to keep file I/O off the caller's thread: PhysFS
+// serializes every file access behind its own lock anyway.
+class Filesystem::IOThread : public love::thread::Threadable
+{
+public:
+
+	IOThread(Filesystem *fs)
+		: fs(fs)
+		, stopping(false)
+	{
+		threadName = "FilesystemIO";
+	}
+
+	virtual ~IOThread()
+	{
+	}
+
+	void queue(FileOperation *op)
+	{
+		love::thread::Lock lock(mutex);
+		operations.emplace_back(op);
+		workCond->signal();
+	}
+
+	void stop()
+	{
+		{
+			love::thread::Lock lock(mutex);
+			stopping = true;
+			workCond->signal();
+		}
+
+		wait();
+	}
+
+	void threadFunction() override
+	{
+		mutex->lock();
+
+		// Queued operations are still run after stop() is called, so pending
+		// save writes aren't lost when the game quits.
+		while (true)
+		{
+			if (operations.empty())
+			{
+				if (stopping)
+					break;
+				workCond->wait(mutex);
+				continue;
+			}
+
+			StrongRef<FileOperation> op = operations.front();
+			operations.pop_front();
+
+			mutex->unlock();
+
+			op->run(fs);
+			op.set(nullptr);
+
+			mutex->lock();
+		}
+
+		mutex->unlock();
+	}
+
+private:
+
+	Filesystem *fs;
+	bool stopping;
+
+	std::deque<StrongRef<FileOperation>> operations;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workCond;
+};
+
 static std::string normalize(const std::string &input)
 {
 	std::stringstream out;
@@ -106,6 +190,65 @@ static bool isAppCommonPath(Filesystem::CommonPath path)
 	}
 }
 
+/**
+ * Gets the real directory (or archive) a file is in, and the file's path
+ * within it, which doesn't include the directory's mount point.
+ **/
+static bool getRealPath(const char *filename, std::string &dir, std::string &inner)
+{
+	const char *realdir = PHYSFS_getRealDir(filename);
+	if (realdir == nullptr)
+		return false;
+
+	dir = realdir;
+	inner = filename;
+
+	const char *mountpoint = PHYSFS_getMountPoint(realdir);
+	std::string mount = mountpoint != nullptr ? mountpoint : "";
+
+	if (!mount.empty() && mount[0] == '/')
+		mount = mount.substr(1);
+	if (!inner.empty() && inner[0] == '/')
+		inner = inner.substr(1);
+	if (!mount.empty() && inner.compare(0, mount.size(), mount) == 0)
+		inner = inner.substr(mount.size());
+
+	return true;
+}
+
+// Makes sure a file's contents have reached the disk, not just the OS cache.
+static bool syncRealFile(const std::string &path)
+{
+#ifdef LOVE_WINDOWS
+	HANDLE handle = CreateFileW(to_widestr(path).c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	bool success = FlushFileBuffers(handle) != 0;
+	CloseHandle(handle);
+	return success;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	bool success = fsync(fd) == 0;
+	close(fd);
+	return success;
+#endif
+}
+
+// Replaces the destination if it exists. Atomic on the same volume.
+static bool renameRealFile(const std::string &from, const std::string &to)
+{
+#ifdef LOVE_WINDOWS
+	DWORD flags = MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH;
+	return MoveFileExW(to_widestr(from).c_str(), to_widestr(to).c_str(), flags) != 0;
+#else
+	return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
 static bool isMounted(const std::string &path)
 {
 	char **mountedpaths = PHYSFS_getSearchPath();
@@ -129,12 +272,15 @@ static bool isMounted(const std::string &path)
 
 Filesystem::Filesystem()
 	: love::filesystem::Filesystem("love.filesystem.physfs")
+	, ioThread(nullptr)
 	, appendIdentityToPath(false)
 	, fused(false)
 	, fusedSet(false)
 	, fullPaths()
 	, commonPathMountInfo()
 	, saveDirectoryNeedsMounting(false)
+	, pathCacheEnabled(false)
+	, watchEnabled(false)
 {
 	requirePath = {"?.lua", "?/init.lua"};
 	cRequirePath = {"??"};
@@ -142,6 +288,26 @@ Filesystem::Filesystem()
 
 Filesystem::~Filesystem()
 {
+	// Save any read recording in progress, on the I/O thread below.
+	try
+	{
+		setReadRecording("");
+	}
+	catch (love::Exception &)
+	{
+	}
+
+	// Queued operations use PhysFS, so they have to finish first.
+	if (ioThread != nullptr)
+	{
+		ioThread->stop();
+		ioThread->release();
+	}
+
+	// Watchers call back into this object from their own threads.
+	for (const auto &watcher : watchers)
+		delete watcher.second;
+
 #ifdef LOVE_ANDROID
 	love::android::deinitializeVirtualArchive();
 #endif
@@ -159,6 +325,10 @@ void Filesystem::init(const char *arg0)
 	if (!PHYSFS_init(arg0))
 		throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
 
+	// Lets LOVE pack archives be mounted like any other archive.
+	if (!PHYSFS_registerArchiver(getPackArchiver()))
+		throw love::Exception("Failed to register the pack archiver: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+
 	// Enable symlinks by default.
 	setSymlinksEnabled(true);
 }
@@ -248,6 +418,9 @@ bool Filesystem::setIdentity(const char *ident, bool appendToPath)
 		}
 	}
 
+	if (watchEnabled)
+		updateWatchers();
+
 	return true;
 }
 
@@ -258,6 +431,7 @@ const char *Filesystem::getIdentity() const
 
 bool Filesystem::setSource(const char *source)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -345,6 +519,9 @@ bool Filesystem::setSource(const char *source)
 	// Save the game source.
 	gameSource = new_search_path;
 
+	if (watchEnabled)
+		updateWatchers();
+
 	return true;
 }
 
@@ -371,6 +548,10 @@ bool Filesystem::setupWriteDirectory()
 		return false;
 
 	saveDirectoryNeedsMounting = false;
+
+	if (watchEnabled)
+		updateWatchers();
+
 	return true;
 }
 
@@ -419,6 +600,7 @@ bool Filesystem::mount(const char *archive, const char *mountpoint, bool appendT
 
 bool Filesystem::mountFullPath(const char *archive, const char *mountpoint, MountPermissions permissions, bool appendToPath)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
@@ -481,6 +663,7 @@ bool Filesystem::mountCommonPath(CommonPath path, const char *mountpoint, MountP
 
 bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoint, bool appendToPath)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -498,6 +681,7 @@ bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoi
 
 bool Filesystem::unmount(const char *archive)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
@@ -533,17 +717,32 @@ bool Filesystem::unmount(const char *archive)
 	if (PHYSFS_getMountPoint(canonpath.c_str()) == nullptr)
 		return false;
 
-	return PHYSFS_unmount(canonpath.c_str()) != 0;
+	if (PHYSFS_unmount(canonpath.c_str()) == 0)
+		return false;
+
+	forgetZipIndex(canonpath);
+	return true;
 }
 
 bool Filesystem::unmountFullPath(const char *fullpath)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit() || !fullpath)
 		return false;
 
 	std::string canonpath = canonicalizeRealPath(fullpath);
 
-	return PHYSFS_unmount(canonpath.c_str()) != 0;
+	if (PHYSFS_unmount(canonpath.c_str()) == 0)
+		return false;
+
+	forgetZipIndex(canonpath);
+	return true;
+}
+
+void Filesystem::forgetZipIndex(const std::string &archive)
+{
+	love::thread::Lock lock(zipIndexMutex);
+	zipIndices.erase(archive);
 }
 
 bool Filesystem::unmount(CommonPath path)
@@ -820,17 +1019,14 @@ std::string Filesystem::getRealDirectory(const char *filename) const
 
 bool Filesystem::exists(const char *filepath) const
 {
-	if (!PHYSFS_isInit())
+	if (!PHYSFS_isInit() || !mightExist(filepath))
 		return false;
 
 	return PHYSFS_exists(filepath) != 0;
 }
 
-bool Filesystem::getInfo(const char *filepath, Info &info) const
+static bool statInfo(const char *filepath, Filesystem::Info &info)
 {
-	if (!PHYSFS_isInit())
-		return false;
-
 	PHYSFS_Stat stat = {};
 	if (!PHYSFS_stat(filepath, &stat))
 		return false;
@@ -840,19 +1036,28 @@ bool Filesystem::getInfo(const char *filepath, Info &info) const
 	info.readonly = stat.readonly != 0;
 
 	if (stat.filetype == PHYSFS_FILETYPE_REGULAR)
-		info.type = FILETYPE_FILE;
+		info.type = Filesystem::FILETYPE_FILE;
 	else if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
-		info.type = FILETYPE_DIRECTORY;
+		info.type = Filesystem::FILETYPE_DIRECTORY;
 	else if (stat.filetype == PHYSFS_FILETYPE_SYMLINK)
-		info.type = FILETYPE_SYMLINK;
+		info.type = Filesystem::FILETYPE_SYMLINK;
 	else
-		info.type = FILETYPE_OTHER;
+		info.type = Filesystem::FILETYPE_OTHER;
 
 	return true;
 }
 
+bool Filesystem::getInfo(const char *filepath, Info &info) const
+{
+	if (!PHYSFS_isInit() || !mightExist(filepath))
+		return false;
+
+	return statInfo(filepath, info);
+}
+
 bool Filesystem::createDirectory(const char *dir)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -877,6 +1082,9 @@ bool Filesystem::createDirectory(const char *dir)
 
 bool Filesystem::remove(const char *file)
 {
+	PathCacheGuard invalidate(this);
+	forgetPrefetchedFile(file);
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -899,14 +1107,120 @@ FileData *Filesystem::read(const char *filename, int64 size) const
 
 FileData* Filesystem::read(const char* filename) const
 {
-	File file(filename, File::MODE_READ);
+	FileData *data = takePrefetchedFile(filename);
 
-	// close() is called in the File destructor.
-	return file.read();
+	if (data == nullptr)
+	{
+		File file(filename, File::MODE_READ);
+
+		// close() is called in the File destructor.
+		data = file.read();
+	}
+
+	recordRead(filename);
+	return data;
+}
+
+FileData *Filesystem::mapFile(const char *filename) const
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	std::string dir;
+	std::string inner;
+
+	if (getRealPath(filename, dir, inner))
+	{
+		std::string path = dir + LOVE_PATH_SEPARATOR + inner;
+
+		try
+		{
+			return new MappedFileData(path, filename);
+		}
+		catch (love::Exception &)
+		{
+			// Not a regular file on disk, e.g. it's inside an archive.
+		}
+
+		// Files stored uncompressed in a pack or in a zip on disk (including
+		// a fused executable) can be mapped straight out of the archive.
+		// Mounted Data archives don't have a file to map.
+		MappedFileData *packed = mapPackFile(dir, inner, filename);
+		if (packed != nullptr)
+			return packed;
+
+		if (mountedData.find(dir) == mountedData.end())
+		{
+			love::thread::Lock lock(zipIndexMutex);
+
+			auto it = zipIndices.find(dir);
+			if (it == zipIndices.end())
+				it = zipIndices.emplace(dir, ZipIndex(dir)).first;
+
+			MappedFileData *stored = it->second.getFile(inner, filename);
+			if (stored != nullptr)
+				return stored;
+		}
+	}
+
+	return read(filename);
+}
+
+void Filesystem::readMany(const std::vector<std::string> &filenames, std::vector<StrongRef<FileData>> &results)
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	ReadBatch batch(filenames.size());
+
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		const std::string &filename = filenames[i];
+		std::string dir;
+		std::string inner;
+
+		// Missing files are left to the normal read, for its error message.
+		if (!getRealPath(filename.c_str(), dir, inner))
+		{
+			batch.addFile(i, filename, "");
+			continue;
+		}
+
+		ArchiveSpan span;
+		if (findPackFile(dir, inner, span))
+		{
+			batch.addSpan(i, filename, span);
+			continue;
+		}
+
+		if (mountedData.find(dir) == mountedData.end())
+		{
+			love::thread::Lock lock(zipIndexMutex);
+
+			auto it = zipIndices.find(dir);
+			if (it == zipIndices.end())
+				it = zipIndices.emplace(dir, ZipIndex(dir)).first;
+
+			if (it->second.findFile(inner, span))
+			{
+				batch.addSpan(i, filename, span);
+				continue;
+			}
+		}
+
+		batch.addFile(i, filename, dir);
+	}
+
+	batch.run([this](int count, const std::function<void(int)> &func)
+	{
+		jobSystem->runParallel(count, func);
+	}, results);
 }
 
 void Filesystem::write(const char *filename, const void *data, int64 size) const
 {
+	forgetPrefetchedFile(filename);
+
 	File file(filename, File::MODE_WRITE);
 
 	// close() is called in the File destructor.
@@ -916,6 +1230,8 @@ void Filesystem::write(const char *filename, const void *data, int64 size) const
 
 void Filesystem::append(const char *filename, const void *data, int64 size) const
 {
+	forgetPrefetchedFile(filename);
+
 	File file(filename, File::MODE_APPEND);
 
 	// close() is called in the File destructor.
@@ -923,6 +1239,132 @@ void Filesystem::append(const char *filename, const void *data, int64 size) cons
 		throw love::Exception("Data could not be written.");
 }
 
+void Filesystem::commit(const std::vector<FileOperation::StagedFile> &files)
+{
+	PathCacheGuard invalidate(this);
+
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	// Temporary files go next to their destination, so renaming them over it
+	// never has to copy between volumes.
+	const char *suffix = ".commit~";
+
+	std::vector<std::string> tempnames;
+	std::vector<std::string> temppaths;
+	std::vector<std::string> realpaths;
+	std::string err;
+
+	for (const FileOperation::StagedFile &f : files)
+	{
+		std::string tempname = f.filename + suffix;
+
+		size_t slash = f.filename.find_last_of('/');
+		if (slash != std::string::npos && slash > 0)
+			PHYSFS_mkdir(f.filename.substr(0, slash).c_str());
+
+		try
+		{
+			write(tempname.c_str(), f.data->getData(), (int64) f.data->getSize());
+		}
+		catch (love::Exception &e)
+		{
+			err = "Could not write file '" + f.filename + "': " + e.what();
+			break;
+		}
+
+		std::string dir;
+		std::string inner;
+		if (!getRealPath(tempname.c_str(), dir, inner))
+		{
+			PHYSFS_delete(tempname.c_str());
+			err = "Could not find the file '" + f.filename + "' on disk.";
+			break;
+		}
+
+		std::string temppath = dir + LOVE_PATH_SEPARATOR + inner;
+		tempnames.push_back(tempname);
+		temppaths.push_back(temppath);
+		realpaths.push_back(temppath.substr(0, temppath.size() - strlen(suffix)));
+
+		if (!syncRealFile(temppath))
+		{
+			err = "Could not sync file '" + f.filename + "' to disk.";
+			break;
+		}
+	}
+
+	// Nothing has been replaced yet, so a failure leaves every original file
+	// as it was.
+	if (!err.empty())
+	{
+		for (const std::string &name : tempnames)
+			PHYSFS_delete(name.c_str());
+		throw love::Exception("%s", err.c_str());
+	}
+
+	for (size_t i = 0; i < temppaths.size(); i++)
+	{
+		if (!renameRealFile(temppaths[i], realpaths[i]))
+		{
+			for (size_t j = i; j < temppaths.size(); j++)
+				PHYSFS_delete(tempnames[j].c_str());
+			throw love::Exception("Could not replace file '%s'.", files[i].filename.c_str());
+		}
+	}
+
+#ifndef LOVE_WINDOWS
+	// The renames themselves are only durable once their directories are.
+	std::set<std::string> dirs;
+	for (const std::string &path : realpaths)
+		dirs.insert(path.substr(0, path.find_last_of('/')));
+	for (const std::string &dir : dirs)
+		syncRealFile(dir);
+#endif
+}
+
+Filesystem::IOThread *Filesystem::getIOThread()
+{
+	if (ioThread == nullptr)
+	{
+		ioThread = new IOThread(this);
+		if (!ioThread->start())
+		{
+			ioThread->release();
+			ioThread = nullptr;
+			throw love::Exception("Could not start the file I/O thread.");
+		}
+	}
+
+	return ioThread;
+}
+
+FileOperation *Filesystem::newFileOperation(FileOperation::Kind kind, const char *filename, Data *data, love::thread::Channel *channel)
+{
+	// The save directory is mounted on demand, which isn't safe to do from
+	// the I/O thread while this thread might be using PhysFS too.
+	if (kind != FileOperation::KIND_READ && !setupWriteDirectory())
+		throw love::Exception("Could not set write directory.");
+
+	IOThread *thread = getIOThread();
+
+	FileOperation *op = new FileOperation(kind, filename, data, channel);
+	thread->queue(op);
+	return op;
+}
+
+FileOperation *Filesystem::newCommitOperation(const std::vector<FileOperation::StagedFile> &files, love::thread::Channel *channel)
+{
+	if (!setupWriteDirectory())
+		throw love::Exception("Could not set write directory.");
+
+	IOThread *thread = getIOThread();
+
+	FileOperation *op = new FileOperation(files, channel);
+	thread->queue(op);
+	return op;
+}
+
 bool Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &items)
 {
 	if (!PHYSFS_isInit())
@@ -940,8 +1382,78 @@ bool Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &it
 	return true;
 }
 
+void Filesystem::scanDirectory(const char *dir, const std::string &pattern, std::vector<DirectoryEntry> &entries)
+{
+	if (!PHYSFS_isInit())
+		return;
+
+	std::string base = dir;
+	while (!base.empty() && base.back() == '/')
+		base.pop_back();
+
+	// Paths of the directories left to list, relative to the base.
+	std::vector<std::string> pending;
+	pending.push_back("");
+
+	while (!pending.empty())
+	{
+		std::string reldir = pending.back();
+		pending.pop_back();
+
+		std::string fulldir = base;
+		if (!reldir.empty())
+			fulldir = base.empty() ? reldir : base + "/" + reldir;
+
+		char **list = PHYSFS_enumerateFiles(fulldir.c_str());
+		if (list == nullptr)
+			continue;
+
+		for (char **i = list; *i != 0; i++)
+		{
+			DirectoryEntry entry;
+			entry.path = reldir.empty() ? std::string(*i) : reldir + "/" + *i;
+
+			std::string fullpath = fulldir.empty() ? entry.path : fulldir + "/" + *i;
+			if (!statInfo(fullpath.c_str(), entry.info))
+				continue;
+
+			if (entry.info.type == FILETYPE_DIRECTORY)
+				pending.push_back(entry.path);
+
+			if (pattern.empty() || matchGlob(pattern.c_str(), entry.path.c_str()))
+				entries.push_back(entry);
+		}
+
+		PHYSFS_freeList(list);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const DirectoryEntry &a, const DirectoryEntry &b)
+	{
+		return a.path < b.path;
+	});
+}
+
+FileOperation *Filesystem::newScanOperation(const char *dir, const std::string &pattern, love::thread::Channel *channel)
+{
+	IOThread *thread = getIOThread();
+
+	FileOperation *op = new FileOperation(dir, pattern, channel);
+	thread->queue(op);
+	return op;
+}
+
+FileOperation *Filesystem::newPrefetchOperation(const std::string &tag, const std::vector<std::string> &filenames, love::thread::Channel *channel)
+{
+	IOThread *thread = getIOThread();
+
+	FileOperation *op = new FileOperation(tag, filenames, channel);
+	thread->queue(op);
+	return op;
+}
+
 void Filesystem::setSymlinksEnabled(bool enable)
 {
+	PathCacheGuard invalidate(this);
 	if (!PHYSFS_isInit())
 		return;
 
@@ -956,6 +1468,179 @@ bool Filesystem::areSymlinksEnabled() const
 	return PHYSFS_symbolicLinksPermitted() != 0;
 }
 
+void Filesystem::setPathCacheEnabled(bool enable)
+{
+	PathCacheGuard invalidate(this);
+	pathCacheEnabled = enable;
+}
+
+bool Filesystem::isPathCacheEnabled() const
+{
+	return pathCacheEnabled;
+}
+
+void Filesystem::clearPathCache()
+{
+	love::thread::Lock lock(pathIndexMutex);
+	pathIndex.clear();
+}
+
+bool Filesystem::setWatchEnabled(bool enable)
+{
+	if (enable && !DirectoryWatcher::isSupported())
+		return false;
+
+	watchEnabled = enable;
+	updateWatchers();
+	return true;
+}
+
+bool Filesystem::isWatchEnabled() const
+{
+	return watchEnabled;
+}
+
+void Filesystem::updateWatchers()
+{
+	std::vector<std::string> paths;
+
+	if (watchEnabled)
+	{
+		if (!gameSource.empty() && isRealDirectory(gameSource))
+			paths.push_back(gameSource);
+
+		// The save directory might not have been created yet, in which case
+		// setupWriteDirectory calls this again once it has.
+		if (!saveIdentity.empty() && !saveDirectoryNeedsMounting)
+		{
+			std::string savedir = getFullCommonPath(COMMONPATH_APP_SAVEDIR);
+			if (!savedir.empty() && savedir != gameSource)
+				paths.push_back(savedir);
+		}
+	}
+
+	for (auto it = watchers.begin(); it != watchers.end();)
+	{
+		if (std::find(paths.begin(), paths.end(), it->first) == paths.end())
+		{
+			delete it->second;
+			it = watchers.erase(it);
+		}
+		else
+			++it;
+	}
+
+	for (const std::string &path : paths)
+	{
+		if (watchers.find(path) != watchers.end())
+			continue;
+
+		try
+		{
+			watchers[path] = new DirectoryWatcher(path, [this](const std::string &file, DirectoryWatcher::Change change)
+			{
+				onFileChanged(file, change);
+			});
+		}
+		catch (love::Exception &)
+		{
+			// Not being able to watch one directory (e.g. because of the OS's
+			// watch limit) shouldn't stop the others from being watched.
+		}
+	}
+}
+
+void Filesystem::onFileChanged(const std::string &path, DirectoryWatcher::Change change)
+{
+	// Called from a watcher's thread.
+	if (change != DirectoryWatcher::CHANGE_MODIFIED)
+		clearPathCache();
+
+	auto eventmodule = Module::getInstance<event::Event>(Module::M_EVENT);
+	if (!eventmodule)
+		return;
+
+	const char *changestr = nullptr;
+	if (!DirectoryWatcher::getConstant(change, changestr))
+		return;
+
+	std::vector<Variant> vargs = {
+		Variant(path.c_str(), path.length()),
+		Variant(changestr, strlen(changestr))
+	};
+
+	StrongRef<event::Message> msg(new event::Message("filechanged", vargs), Acquire::NORETAIN);
+	eventmodule->push(msg);
+}
+
+// Native directories on these platforms are usually case-insensitive, so
+// names are compared that way to never rule out a path PhysFS would find.
+static std::string indexName(const std::string &name)
+{
+#if defined(LOVE_WINDOWS) || defined(LOVE_MACOS) || defined(LOVE_IOS)
+	std::string folded = name;
+	std::transform(folded.begin(), folded.end(), folded.begin(), ::tolower);
+	return folded;
+#else
+	return name;
+#endif
+}
+
+bool Filesystem::mightExist(const char *filepath) const
+{
+	if (!pathCacheEnabled || filepath == nullptr)
+		return true;
+
+	std::string path = filepath;
+	while (!path.empty() && path[0] == '/')
+		path = path.substr(1);
+	while (!path.empty() && path.back() == '/')
+		path.pop_back();
+
+	if (path.empty())
+		return true;
+
+	// Leave anything unusual to PhysFS, which rejects most of it anyway.
+	if (path.find("//") != std::string::npos || path.find('\\') != std::string::npos
+		|| path == "." || path == ".." || path.find("./") != std::string::npos)
+		return true;
+
+	love::thread::Lock lock(pathIndexMutex);
+	return isIndexed(path);
+}
+
+bool Filesystem::isIndexed(const std::string &path) const
+{
+	size_t slash = path.rfind('/');
+	std::string dir = slash == std::string::npos ? "" : path.substr(0, slash);
+	std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+	auto it = pathIndex.find(dir);
+	if (it == pathIndex.end())
+	{
+		// Enumerating a directory searches every mount once, after which
+		// every lookup in it (e.g. require trying each of its patterns) is a
+		// hash lookup.
+		DirectoryIndex index;
+		index.exists = dir.empty() || isIndexed(dir);
+
+		if (index.exists)
+		{
+			char **list = PHYSFS_enumerateFiles(dir.c_str());
+			if (list != nullptr)
+			{
+				for (char **i = list; *i != nullptr; i++)
+					index.names.insert(indexName(*i));
+				PHYSFS_freeList(list);
+			}
+		}
+
+		it = pathIndex.emplace(dir, std::move(index)).first;
+	}
+
+	return it->second.exists && it->second.names.count(indexName(name)) > 0;
+}
+
 std::vector<std::string> &Filesystem::getRequirePath()
 {
 	return requirePath;
@@ -25,9 +25,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 // LOVE
 #include "filesystem/Filesystem.h"
+#include "thread/threads.h"
+#include "thread/JobSystem.h"
+#include "ZipIndex.h"
+#include "filesystem/DirectoryWatcher.h"
 
 namespace love
 {
@@ -88,14 +94,31 @@ public:
 
 	FileData *read(const char *filename, int64 size) const override;
 	FileData *read(const char *filename) const override;
+	FileData *mapFile(const char *filename) const override;
+	void readMany(const std::vector<std::string> &filenames, std::vector<StrongRef<FileData>> &results) override;
 	void write(const char *filename, const void *data, int64 size) const override;
 	void append(const char *filename, const void *data, int64 size) const override;
 
+	void commit(const std::vector<FileOperation::StagedFile> &files) override;
+
+	FileOperation *newFileOperation(FileOperation::Kind kind, const char *filename, Data *data, love::thread::Channel *channel) override;
+	FileOperation *newCommitOperation(const std::vector<FileOperation::StagedFile> &files, love::thread::Channel *channel) override;
+
 	bool getDirectoryItems(const char *dir, std::vector<std::string> &items) override;
+	void scanDirectory(const char *dir, const std::string &pattern, std::vector<DirectoryEntry> &entries) override;
+	FileOperation *newScanOperation(const char *dir, const std::string &pattern, love::thread::Channel *channel) override;
+	FileOperation *newPrefetchOperation(const std::string &tag, const std::vector<std::string> &filenames, love::thread::Channel *channel) override;
 
 	void setSymlinksEnabled(bool enable) override;
 	bool areSymlinksEnabled() const override;
 
+	void setPathCacheEnabled(bool enable) override;
+	bool isPathCacheEnabled() const override;
+	void clearPathCache() override;
+
+	bool setWatchEnabled(bool enable) override;
+	bool isWatchEnabled() const override;
+
 	std::vector<std::string> &getRequirePath() override;
 	std::vector<std::string> &getCRequirePath() override;
 
@@ -103,6 +126,8 @@ public:
 
 private:
 
+	class IOThread;
+
 	struct CommonPathMountInfo
 	{
 		bool mounted;
@@ -112,6 +137,44 @@ private:
 
 	bool mountCommonPathInternal(CommonPath path, const char *mountpoint, MountPermissions permissions, bool appendToPath, bool createDir);
 
+	void forgetZipIndex(const std::string &archive);
+
+	IOThread *getIOThread();
+
+	// Clears the path cache when it goes out of scope, after a change to the
+	// search path or the write directory has been made.
+	struct PathCacheGuard
+	{
+		Filesystem *fs;
+		PathCacheGuard(Filesystem *fs) : fs(fs) {}
+		~PathCacheGuard() { fs->clearPathCache(); }
+	};
+
+	// The names in a directory, merged across every mount.
+	struct DirectoryIndex
+	{
+		bool exists;
+		std::unordered_set<std::string> names;
+	};
+
+	/**
+	 * Returns false if the path is known not to exist, without searching
+	 * every mount. Returns true if it might exist.
+	 **/
+	bool mightExist(const char *filepath) const;
+	bool isIndexed(const std::string &path) const;
+
+	// Starts or stops watchers so the source and save directories are
+	// watched while watching is enabled.
+	void updateWatchers();
+	void onFileChanged(const std::string &path, DirectoryWatcher::Change change);
+
+	// Runs FileOperations in the order they were queued. Created on first use.
+	IOThread *ioThread;
+
+	// Decompresses files for readMany, which doesn't touch PhysFS.
+	love::thread::JobSystemRef jobSystem;
+
 	// Contains the current working directory (UTF8).
 	std::string cwd;
 
@@ -140,6 +203,21 @@ private:
 
 	bool saveDirectoryNeedsMounting;
 
+	// Files in mounted zip archives, which mapFile hands out as views of the
+	// mapped archive and readMany decompresses straight from it. Indexed the
+	// first time a file in the archive is mapped or batch read.
+	mutable std::map<std::string, ZipIndex> zipIndices;
+	mutable love::thread::MutexRef zipIndexMutex;
+
+	// Directory listings keyed by virtual path, filled in as lookups happen.
+	mutable std::unordered_map<std::string, DirectoryIndex> pathIndex;
+	mutable love::thread::MutexRef pathIndexMutex;
+	bool pathCacheEnabled;
+
+	// By native directory path.
+	std::map<std::string, DirectoryWatcher *> watchers;
+	bool watchEnabled;
+
 }; // Filesystem
 
 } // physfs
@@ -0,0 +1,534 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "PackArchiver.h"
+#include "PhysfsIo.h"
+#include "filesystem/PackFormat.h"
+#include "thread/threads.h"
+
+// LZ4
+#include "libraries/lz4/lz4.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+// Internal to PhysFS, but exported. It's what PHYSFS_mount uses to open
+// archives on disk.
+extern "C" PHYSFS_Io *__PHYSFS_createNativeIo(const char *path, const int mode);
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+struct Pack
+{
+	std::string name;
+	PHYSFS_Io *io = nullptr;
+	uint64 size = 0;
+
+	// The whole pack when it's a file on disk, otherwise just its index.
+	StrongRef<MappedFileData> mapping;
+	StrongRef<FileData> index;
+
+	const pack::Header *header = nullptr;
+	const pack::Entry *entries = nullptr;
+	const uint32 *children = nullptr;
+	const char *names = nullptr;
+
+	const pack::Entry *find(const char *path) const
+	{
+		size_t length = strlen(path);
+		uint64 hash = pack::hashPath(path, length);
+
+		const pack::Entry *end = entries + header->entryCount;
+		const pack::Entry *it = std::lower_bound(entries, end, hash, [](const pack::Entry &e, uint64 h) { return e.hash < h; });
+
+		for (; it != end && it->hash == hash; ++it)
+		{
+			if (!isValid(*it))
+				return nullptr;
+			if (it->nameLength == length && memcmp(names + it->nameOffset, path, length) == 0)
+				return it;
+		}
+
+		return nullptr;
+	}
+
+	// Entries are checked when they're used rather than when the pack is
+	// mounted, so mounting stays independent of the number of files.
+	bool isValid(const pack::Entry &e) const
+	{
+		if ((uint64) e.nameOffset + e.nameLength > header->namesSize)
+			return false;
+
+		if ((e.flags & pack::ENTRY_DIRECTORY) != 0)
+			return e.offset <= header->childCount && e.size <= header->childCount - e.offset;
+
+		if (e.offset > size || e.size > size - e.offset)
+			return false;
+
+		if (e.compression == pack::COMPRESSION_NONE)
+			return e.size == e.uncompressedSize;
+
+		return e.compression == pack::COMPRESSION_LZ4 && e.size <= (uint64) LZ4_MAX_INPUT_SIZE && e.uncompressedSize <= (uint64) LZ4_MAX_INPUT_SIZE;
+	}
+
+	/**
+	 * Gets the decompressed contents of a file entry.
+	 **/
+	FileData *read(const pack::Entry &e) const
+	{
+		std::string filename(names + e.nameOffset, e.nameLength);
+
+		if (e.compression == pack::COMPRESSION_NONE && mapping.get() != nullptr)
+			return new MappedFileData(mapping.get(), e.offset, e.size, filename);
+
+		StrongRef<FileData> stored;
+		const char *src = nullptr;
+
+		if (mapping.get() != nullptr)
+			src = (const char *) mapping->getData() + e.offset;
+		else
+		{
+			stored.set(new FileData(e.size, filename), Acquire::NORETAIN);
+			if (!readRange(e.offset, stored->getData(), e.size))
+				return nullptr;
+			src = (const char *) stored->getData();
+		}
+
+		if (e.compression == pack::COMPRESSION_NONE)
+		{
+			stored->retain();
+			return stored.get();
+		}
+
+		FileData *decompressed = new FileData(e.uncompressedSize, filename);
+		int result = LZ4_decompress_safe(src, (char *) decompressed->getData(), (int) e.size, (int) e.uncompressedSize);
+
+		if (result < 0 || (uint64) result != e.uncompressedSize)
+		{
+			decompressed->release();
+			PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+			return nullptr;
+		}
+
+		return decompressed;
+	}
+
+	bool readRange(uint64 offset, void *dst, uint64 length) const
+	{
+		// A duplicate has its own position, so reads don't interfere with
+		// each other.
+		PHYSFS_Io *dup = io->duplicate(io);
+		if (dup == nullptr)
+			return false;
+
+		bool success = dup->seek(dup, offset) != 0;
+
+		uint64 total = 0;
+		while (success && total < length)
+		{
+			PHYSFS_sint64 n = dup->read(dup, (char *) dst + total, length - total);
+			if (n <= 0)
+				success = false;
+			else
+				total += (uint64) n;
+		}
+
+		dup->destroy(dup);
+
+		if (!success)
+			PHYSFS_setErrorCode(PHYSFS_ERR_IO);
+		return success;
+	}
+};
+
+// Packs which are memory-mapped, by their real directory, so mapFile can
+// hand out views of their stored files.
+static love::thread::Mutex *getMappedPacksMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
+static std::map<std::string, Pack *> mappedPacks;
+
+// Reads a file entry's contents from memory.
+struct PackIo : public PhysfsIo<PackIo>
+{
+	static const uint32 version = 0;
+
+	StrongRef<FileData> data;
+	uint64 pos;
+
+	// The constructor is private in favor of this function to prevent stack allocation
+	// because Physfs will take ownership of this object and call destroy on it later.
+	static PackIo *create(FileData *data) { return new PackIo(data); }
+
+	PackIo(const PackIo &other)
+		: PackIo(other.data.get())
+	{
+	}
+
+	virtual ~PackIo() {}
+
+	int64 read(void *buf, uint64 len)
+	{
+		uint64 size = data->getSize();
+		uint64 n = pos < size ? std::min(len, size - pos) : 0;
+		memcpy(buf, (const char *) data->getData() + pos, (size_t) n);
+		pos += n;
+		return (int64) n;
+	}
+
+	int64 write(const void */*buf*/, uint64 /*len*/)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return -1;
+	}
+
+	int64 seek(uint64 offset)
+	{
+		if (offset > data->getSize())
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+			return 0;
+		}
+		pos = offset;
+		return 1;
+	}
+
+	int64 tell() { return (int64) pos; }
+	int64 length() { return (int64) data->getSize(); }
+	int64 flush() { return 1; }
+
+private:
+
+	PackIo(FileData *data)
+		: data(data)
+		, pos(0)
+	{
+	}
+};
+
+/**
+ * Whether the io is PhysFS' own io for the file at path. Archives mounted
+ * from Data or other custom io can be given the name of an unrelated file on
+ * disk, so the name alone doesn't say the pack can be mapped from there.
+ **/
+static bool isNativeFileIo(PHYSFS_Io *io, const char *path)
+{
+	PHYSFS_Io *native = __PHYSFS_createNativeIo(path, 'r');
+	if (native == nullptr)
+		return false;
+
+	bool same = native->read == io->read;
+	native->destroy(native);
+	return same;
+}
+
+static void *packOpenArchive(PHYSFS_Io *io, const char *name, int forWrite, int *claimed)
+{
+	pack::Header header = {};
+
+	if (!io->seek(io, 0) || io->read(io, &header, sizeof(header)) != (PHYSFS_sint64) sizeof(header)
+		|| memcmp(header.magic, pack::MAGIC, sizeof(pack::MAGIC)) != 0)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+		return nullptr;
+	}
+
+	*claimed = 1;
+
+	if (forWrite)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return nullptr;
+	}
+
+	if (header.version != pack::VERSION)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+		return nullptr;
+	}
+
+	PHYSFS_sint64 length = io->length(io);
+
+	// The tables have to be in bounds and aligned for their types.
+	uint64 entriesEnd = header.entriesOffset + (uint64) header.entryCount * sizeof(pack::Entry);
+	uint64 childrenEnd = header.childrenOffset + (uint64) header.childCount * sizeof(uint32);
+	uint64 namesEnd = header.namesOffset + header.namesSize;
+	uint64 indexEnd = std::max(std::max(entriesEnd, childrenEnd), namesEnd);
+
+	if (length < 0 || header.entryCount == 0 || header.entriesOffset % alignof(pack::Entry) != 0
+		|| header.childrenOffset % alignof(uint32) != 0 || entriesEnd < header.entriesOffset
+		|| childrenEnd < header.childrenOffset || namesEnd < header.namesOffset || indexEnd > (uint64) length)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	Pack *p = new Pack();
+	p->name = name;
+	p->io = io;
+	p->size = (uint64) length;
+
+	// Map the whole pack if it's a file on disk, so the index can be used in
+	// place and stored files don't have to be copied.
+	if (isNativeFileIo(io, name))
+	{
+		try
+		{
+			p->mapping.set(new MappedFileData(name, name), Acquire::NORETAIN);
+			if (p->mapping->getSize() != p->size)
+				p->mapping.set(nullptr);
+		}
+		catch (love::Exception &)
+		{
+		}
+	}
+
+	const char *base = nullptr;
+
+	if (p->mapping.get() != nullptr)
+		base = (const char *) p->mapping->getData();
+	else
+	{
+		p->index.set(new FileData(indexEnd, name), Acquire::NORETAIN);
+		if (!p->readRange(0, p->index->getData(), indexEnd))
+		{
+			delete p;
+			return nullptr;
+		}
+		base = (const char *) p->index->getData();
+	}
+
+	p->header = (const pack::Header *) base;
+	p->entries = (const pack::Entry *) (base + header.entriesOffset);
+	p->children = (const uint32 *) (base + header.childrenOffset);
+	p->names = base + header.namesOffset;
+
+	if (p->mapping.get() != nullptr)
+	{
+		love::thread::Lock lock(getMappedPacksMutex());
+		mappedPacks[p->name] = p;
+	}
+
+	return p;
+}
+
+static PHYSFS_EnumerateCallbackResult packEnumerate(void *opaque, const char *dirname, PHYSFS_EnumerateCallback cb, const char *origdir, void *callbackdata)
+{
+	const Pack *p = (const Pack *) opaque;
+	const pack::Entry *dir = p->find(dirname);
+
+	if (dir == nullptr || (dir->flags & pack::ENTRY_DIRECTORY) == 0)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return PHYSFS_ENUM_ERROR;
+	}
+
+	std::string name;
+	for (uint64 i = dir->offset; i < dir->offset + dir->size; i++)
+	{
+		uint32 child = p->children[i];
+		if (child >= p->header->entryCount || !p->isValid(p->entries[child]))
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+			return PHYSFS_ENUM_ERROR;
+		}
+
+		// Callbacks get the last component of the path.
+		const pack::Entry &e = p->entries[child];
+		name.assign(p->names + e.nameOffset, e.nameLength);
+		size_t slash = name.rfind('/');
+		if (slash != std::string::npos)
+			name = name.substr(slash + 1);
+
+		PHYSFS_EnumerateCallbackResult result = cb(callbackdata, origdir, name.c_str());
+		if (result == PHYSFS_ENUM_ERROR)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_APP_CALLBACK);
+			return PHYSFS_ENUM_ERROR;
+		}
+		else if (result == PHYSFS_ENUM_STOP)
+			return PHYSFS_ENUM_STOP;
+	}
+
+	return PHYSFS_ENUM_OK;
+}
+
+static PHYSFS_Io *packOpenRead(void *opaque, const char *filename)
+{
+	const Pack *p = (const Pack *) opaque;
+	const pack::Entry *e = p->find(filename);
+
+	if (e == nullptr)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return nullptr;
+	}
+
+	if ((e->flags & pack::ENTRY_DIRECTORY) != 0)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_A_FILE);
+		return nullptr;
+	}
+
+	FileData *data = nullptr;
+	try
+	{
+		data = p->read(*e);
+	}
+	catch (love::Exception &)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_OUT_OF_MEMORY);
+		return nullptr;
+	}
+
+	if (data == nullptr)
+		return nullptr;
+
+	PackIo *io = PackIo::create(data);
+	data->release();
+	return io;
+}
+
+static PHYSFS_Io *packOpenWrite(void */*opaque*/, const char */*filename*/)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return nullptr;
+}
+
+static int packModify(void */*opaque*/, const char */*filename*/)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return 0;
+}
+
+static int packStat(void *opaque, const char *filename, PHYSFS_Stat *stat)
+{
+	const Pack *p = (const Pack *) opaque;
+	const pack::Entry *e = p->find(filename);
+
+	if (e == nullptr)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return 0;
+	}
+
+	bool isdir = (e->flags & pack::ENTRY_DIRECTORY) != 0;
+
+	stat->filesize = isdir ? 0 : (PHYSFS_sint64) e->uncompressedSize;
+	stat->modtime = e->modtime;
+	stat->createtime = e->modtime;
+	stat->accesstime = e->modtime;
+	stat->filetype = isdir ? PHYSFS_FILETYPE_DIRECTORY : PHYSFS_FILETYPE_REGULAR;
+	stat->readonly = 1;
+	return 1;
+}
+
+static void packCloseArchive(void *opaque)
+{
+	Pack *p = (Pack *) opaque;
+
+	if (p->mapping.get() != nullptr)
+	{
+		love::thread::Lock lock(getMappedPacksMutex());
+		mappedPacks.erase(p->name);
+	}
+
+	p->io->destroy(p->io);
+	delete p;
+}
+
+static const PHYSFS_Archiver packArchiver =
+{
+	0,
+	{
+		"LPK",
+		"LOVE pack archive",
+		"LOVE Development Team",
+		"https://love2d.org/",
+		0,
+	},
+	packOpenArchive,
+	packEnumerate,
+	packOpenRead,
+	packOpenWrite,
+	packOpenWrite,
+	packModify,
+	packModify,
+	packStat,
+	packCloseArchive,
+};
+
+const PHYSFS_Archiver *getPackArchiver()
+{
+	return &packArchiver;
+}
+
+MappedFileData *mapPackFile(const std::string &archive, const std::string &name, const std::string &filename)
+{
+	love::thread::Lock lock(getMappedPacksMutex());
+
+	auto it = mappedPacks.find(archive);
+	if (it == mappedPacks.end())
+		return nullptr;
+
+	const Pack *p = it->second;
+	const pack::Entry *e = p->find(name.c_str());
+
+	if (e == nullptr || (e->flags & pack::ENTRY_DIRECTORY) != 0 || e->compression != pack::COMPRESSION_NONE)
+		return nullptr;
+
+	return new MappedFileData(p->mapping.get(), e->offset, e->size, filename);
+}
+
+bool findPackFile(const std::string &archive, const std::string &name, ArchiveSpan &span)
+{
+	love::thread::Lock lock(getMappedPacksMutex());
+
+	auto it = mappedPacks.find(archive);
+	if (it == mappedPacks.end())
+		return false;
+
+	const Pack *p = it->second;
+	const pack::Entry *e = p->find(name.c_str());
+
+	if (e == nullptr || (e->flags & pack::ENTRY_DIRECTORY) != 0)
+		return false;
+
+	span.archive = p->mapping;
+	span.offset = e->offset;
+	span.size = e->size;
+	span.uncompressedSize = e->uncompressedSize;
+	span.compression = e->compression == pack::COMPRESSION_LZ4 ? ArchiveSpan::COMPRESSION_LZ4 : ArchiveSpan::COMPRESSION_NONE;
+	return true;
+}
+
+} // physfs
+} // filesystem
+} // love
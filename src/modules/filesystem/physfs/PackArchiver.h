@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVER_H
+#define LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVER_H
+
+// LOVE
+#include "libraries/physfs/physfs.h"
+#include "filesystem/MappedFileData.h"
+#include "ReadBatch.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+/**
+ * The PhysFS archiver for LOVE pack (.lpk) archives, see PackFormat.h.
+ **/
+const PHYSFS_Archiver *getPackArchiver();
+
+/**
+ * Gets a view of a file stored uncompressed in a mounted, memory-mapped pack.
+ * @param archive The real directory of the file, i.e. the pack's path.
+ * @param name The file's path inside the pack.
+ * @param filename The (virtual) filename reported by getFilename.
+ * @return The view, or null if it isn't such a file.
+ **/
+MappedFileData *mapPackFile(const std::string &archive, const std::string &name, const std::string &filename);
+
+/**
+ * Gets where a file's contents are in a mounted, memory-mapped pack.
+ * @return False if it isn't such a file.
+ **/
+bool findPackFile(const std::string &archive, const std::string &name, ArchiveSpan &span);
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVER_H
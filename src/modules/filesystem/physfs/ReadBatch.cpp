@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ReadBatch.h"
+#include "File.h"
+#include "common/Exception.h"
+
+#include "libraries/lz4/lz4.h"
+
+#include <zlib.h>
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+ReadBatch::ReadBatch(size_t count)
+	: count(count)
+{
+}
+
+void ReadBatch::addSpan(size_t index, const std::string &filename, const ArchiveSpan &span)
+{
+	spans.push_back({index, filename, "", span});
+}
+
+void ReadBatch::addFile(size_t index, const std::string &filename, const std::string &archive)
+{
+	files.push_back({index, filename, archive, ArchiveSpan()});
+}
+
+static bool inflateRaw(const void *src, uint64 srcsize, void *dst, uint64 dstsize)
+{
+	z_stream stream = {};
+	stream.next_in = (Bytef *) src;
+	stream.avail_in = (uInt) srcsize;
+	stream.next_out = (Bytef *) dst;
+	stream.avail_out = (uInt) dstsize;
+
+	// Zip entries are raw deflate streams, without a zlib header.
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+		return false;
+
+	int err = inflate(&stream, Z_FINISH);
+	uLong total = stream.total_out;
+	inflateEnd(&stream);
+
+	return err == Z_STREAM_END && total == dstsize;
+}
+
+FileData *ReadBatch::decode(const Request &request)
+{
+	const ArchiveSpan &span = request.span;
+	const char *src = (const char *) span.archive->getData() + span.offset;
+
+	StrongRef<FileData> data(new FileData(span.uncompressedSize, request.filename), Acquire::NORETAIN);
+	bool success = false;
+
+	switch (span.compression)
+	{
+	case ArchiveSpan::COMPRESSION_NONE:
+		memcpy(data->getData(), src, (size_t) span.size);
+		success = true;
+		break;
+	case ArchiveSpan::COMPRESSION_LZ4:
+		success = LZ4_decompress_safe(src, (char *) data->getData(), (int) span.size, (int) span.uncompressedSize) == (int) span.uncompressedSize;
+		break;
+	case ArchiveSpan::COMPRESSION_DEFLATE:
+		success = inflateRaw(src, span.size, data->getData(), span.uncompressedSize);
+		break;
+	}
+
+	if (!success)
+		throw love::Exception("Could not decompress file %s.", request.filename.c_str());
+
+	data->retain();
+	return data.get();
+}
+
+void ReadBatch::run(const ParallelFor &parallelFor, std::vector<StrongRef<FileData>> &results)
+{
+	results.clear();
+	results.resize(count);
+
+	std::sort(spans.begin(), spans.end(), [](const Request &a, const Request &b)
+	{
+		if (a.span.archive.get() != b.span.archive.get())
+			return a.span.archive.get() < b.span.archive.get();
+		return a.span.offset < b.span.offset;
+	});
+
+	// Nearby files are prefetched as one range, which the OS can read from
+	// disk sequentially while the other files are being read.
+	for (size_t i = 0; i < spans.size();)
+	{
+		MappedFileData *archive = spans[i].span.archive.get();
+		uint64 start = spans[i].span.offset;
+		uint64 end = start + spans[i].span.size;
+
+		size_t j = i + 1;
+		for (; j < spans.size(); j++)
+		{
+			const ArchiveSpan &next = spans[j].span;
+			if (next.archive.get() != archive || next.offset > end + MAX_COALESCE_GAP)
+				break;
+			end = std::max(end, next.offset + next.size);
+		}
+
+		archive->prefetch(start, end - start);
+		i = j;
+	}
+
+	// Reading the other files in order keeps files in the same directory or
+	// archive together.
+	std::sort(files.begin(), files.end(), [](const Request &a, const Request &b)
+	{
+		if (a.archive != b.archive)
+			return a.archive < b.archive;
+		return a.filename < b.filename;
+	});
+
+	for (const Request &request : files)
+	{
+		File file(request.filename, File::MODE_READ);
+		results[request.index].set(file.read(), Acquire::NORETAIN);
+	}
+
+	// Only the first error is reported, but every decode has to finish
+	// before this function can return.
+	std::vector<std::string> errors(spans.size());
+
+	parallelFor((int) spans.size(), [&](int i)
+	{
+		const Request &request = spans[i];
+		try
+		{
+			results[request.index].set(decode(request), Acquire::NORETAIN);
+		}
+		catch (love::Exception &e)
+		{
+			errors[i] = e.what();
+		}
+		catch (std::bad_alloc &)
+		{
+			errors[i] = "Out of memory.";
+		}
+	});
+
+	for (const std::string &error : errors)
+	{
+		if (!error.empty())
+			throw love::Exception("%s", error.c_str());
+	}
+}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_READ_BATCH_H
+#define LOVE_FILESYSTEM_PHYSFS_READ_BATCH_H
+
+// LOVE
+#include "common/int.h"
+#include "common/Object.h"
+#include "filesystem/FileData.h"
+#include "filesystem/MappedFileData.h"
+
+// C++
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+/**
+ * Where a file's stored contents are in a memory-mapped archive.
+ **/
+struct ArchiveSpan
+{
+	enum Compression
+	{
+		COMPRESSION_NONE,
+		COMPRESSION_LZ4,
+		COMPRESSION_DEFLATE,
+	};
+
+	StrongRef<MappedFileData> archive;
+	uint64 offset = 0;
+	uint64 size = 0;
+	uint64 uncompressedSize = 0;
+	Compression compression = COMPRESSION_NONE;
+};
+
+/**
+ * Reads many files at once. Files in memory-mapped archives are sorted by
+ * their offset, nearby ones are prefetched together as one sequential read,
+ * and they're copied or decompressed in parallel. Everything else is read
+ * through PhysFS in path order.
+ **/
+class ReadBatch
+{
+public:
+
+	// Calls func(i) for every i in [0, count), possibly on several threads,
+	// and returns once all calls have finished.
+	typedef std::function<void(int count, const std::function<void(int)> &func)> ParallelFor;
+
+	// Ranges closer together than this are prefetched as one.
+	static const uint64 MAX_COALESCE_GAP = 64 * 1024;
+
+	explicit ReadBatch(size_t count);
+
+	void addSpan(size_t index, const std::string &filename, const ArchiveSpan &span);
+	void addFile(size_t index, const std::string &filename, const std::string &archive);
+
+	/**
+	 * Reads every file. Throws if any of them can't be read.
+	 * @param results The FileData of each file, by index.
+	 **/
+	void run(const ParallelFor &parallelFor, std::vector<StrongRef<FileData>> &results);
+
+private:
+
+	struct Request
+	{
+		size_t index;
+		std::string filename;
+		std::string archive;
+		ArchiveSpan span;
+	};
+
+	static FileData *decode(const Request &request);
+
+	size_t count;
+	std::vector<Request> spans;
+	std::vector<Request> files;
+
+}; // ReadBatch
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_READ_BATCH_H
@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ZipIndex.h"
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+// Record signatures, from the zip file format specification.
+static const uint32 ZIP_LOCAL_HEADER = 0x04034b50;
+static const uint32 ZIP_CENTRAL_HEADER = 0x02014b50;
+static const uint32 ZIP_END_OF_CENTRAL_DIR = 0x06054b50;
+static const uint32 ZIP64_END_OF_CENTRAL_DIR = 0x06064b50;
+static const uint32 ZIP64_END_LOCATOR = 0x07064b50;
+
+static const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+static const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+static const size_t ZIP_END_SIZE = 22;
+static const size_t ZIP64_END_SIZE = 56;
+static const size_t ZIP64_LOCATOR_SIZE = 20;
+
+static inline uint16 readU16(const uint8 *p)
+{
+	return (uint16) (p[0] | (p[1] << 8));
+}
+
+static inline uint32 readU32(const uint8 *p)
+{
+	return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+static inline uint64 readU64(const uint8 *p)
+{
+	return (uint64) readU32(p) | ((uint64) readU32(p + 4) << 32);
+}
+
+ZipIndex::ZipIndex()
+{
+}
+
+ZipIndex::ZipIndex(const std::string &path)
+{
+	try
+	{
+		archive.set(new MappedFileData(path, path), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return;
+	}
+
+	// There's no point keeping the archive mapped if nothing can use it.
+	if (!parse((const uint8 *) archive->getData(), archive->getSize()) || entries.empty())
+	{
+		entries.clear();
+		archive.set(nullptr);
+	}
+}
+
+MappedFileData *ZipIndex::getFile(const std::string &name, const std::string &filename) const
+{
+	auto it = entries.find(name);
+	if (it == entries.end() || it->second.deflated)
+		return nullptr;
+
+	return new MappedFileData(archive.get(), it->second.offset, it->second.size, filename);
+}
+
+bool ZipIndex::findFile(const std::string &name, ArchiveSpan &span) const
+{
+	auto it = entries.find(name);
+	if (it == entries.end())
+		return false;
+
+	span.archive = archive;
+	span.offset = it->second.offset;
+	span.size = it->second.size;
+	span.uncompressedSize = it->second.uncompressedSize;
+	span.compression = it->second.deflated ? ArchiveSpan::COMPRESSION_DEFLATE : ArchiveSpan::COMPRESSION_NONE;
+	return true;
+}
+
+bool ZipIndex::parse(const uint8 *data, uint64 size)
+{
+	if (size < ZIP_END_SIZE)
+		return false;
+
+	// Like StripSuffixIo, search backwards through the whole file for the end
+	// of central directory record, since data such as a code signature may
+	// follow the zip.
+	for (int64 i = (int64) (size - ZIP_END_SIZE); i >= 0; i--)
+	{
+		const uint8 *end = data + i;
+		if (readU32(end) != ZIP_END_OF_CENTRAL_DIR)
+			continue;
+
+		if ((uint64) i + ZIP_END_SIZE + readU16(end + 20) > size)
+			continue;
+
+		uint64 count = readU16(end + 10);
+		uint64 dirsize = readU32(end + 12);
+		uint64 diroffset = readU32(end + 16);
+		uint64 dirend = (uint64) i;
+
+		// Archives with lots of files or large offsets have a zip64 record
+		// just before the zip64 locator, which itself precedes the normal one.
+		if ((uint64) i >= ZIP64_LOCATOR_SIZE + ZIP64_END_SIZE && readU32(end - ZIP64_LOCATOR_SIZE) == ZIP64_END_LOCATOR)
+		{
+			const uint8 *end64 = end - ZIP64_LOCATOR_SIZE - ZIP64_END_SIZE;
+			if (readU32(end64) == ZIP64_END_OF_CENTRAL_DIR)
+			{
+				count = readU64(end64 + 32);
+				dirsize = readU64(end64 + 40);
+				diroffset = readU64(end64 + 48);
+				dirend = (uint64) (end64 - data);
+			}
+		}
+
+		if (dirsize > dirend || dirend - dirsize < diroffset)
+			continue;
+
+		// Offsets in the zip are relative to its start, which isn't the start
+		// of the file when something (e.g. an executable) is in front of it.
+		uint64 dirstart = dirend - dirsize;
+		uint64 base = dirstart - diroffset;
+
+		if (count > 0 && (dirsize < ZIP_CENTRAL_HEADER_SIZE || readU32(data + dirstart) != ZIP_CENTRAL_HEADER))
+			continue;
+
+		uint64 pos = dirstart;
+		for (uint64 n = 0; n < count; n++)
+		{
+			if (pos + ZIP_CENTRAL_HEADER_SIZE > dirend)
+				return false;
+
+			const uint8 *header = data + pos;
+			if (readU32(header) != ZIP_CENTRAL_HEADER)
+				return false;
+
+			uint16 flags = readU16(header + 8);
+			uint16 method = readU16(header + 10);
+			uint64 compressedsize = readU32(header + 20);
+			uint64 uncompressedsize = readU32(header + 24);
+			uint16 namelen = readU16(header + 28);
+			uint16 extralen = readU16(header + 30);
+			uint16 commentlen = readU16(header + 32);
+			uint64 localoffset = readU32(header + 42);
+
+			uint64 next = pos + ZIP_CENTRAL_HEADER_SIZE + namelen + extralen + commentlen;
+			if (next > dirend)
+				return false;
+
+			const char *name = (const char *) header + ZIP_CENTRAL_HEADER_SIZE;
+			const uint8 *extra = header + ZIP_CENTRAL_HEADER_SIZE + namelen;
+
+			// Values too large for the header are in the zip64 extra field,
+			// in this order and only when the header's value is saturated.
+			for (uint16 e = 0; e + 4 <= extralen;)
+			{
+				uint16 id = readU16(extra + e);
+				uint16 len = readU16(extra + e + 2);
+				if (e + 4 + len > extralen)
+					break;
+
+				if (id == 0x0001)
+				{
+					const uint8 *field = extra + e + 4;
+					const uint8 *fieldend = field + len;
+
+					if (uncompressedsize == 0xFFFFFFFF && field + 8 <= fieldend)
+					{
+						uncompressedsize = readU64(field);
+						field += 8;
+					}
+					if (compressedsize == 0xFFFFFFFF && field + 8 <= fieldend)
+					{
+						compressedsize = readU64(field);
+						field += 8;
+					}
+					if (localoffset == 0xFFFFFFFF && field + 8 <= fieldend)
+						localoffset = readU64(field);
+					break;
+				}
+
+				e += 4 + len;
+			}
+
+			pos = next;
+
+			// Only files stored as-is or deflated can be used directly. Bit 0
+			// of the flags means the file is encrypted.
+			bool isdir = namelen > 0 && name[namelen - 1] == '/';
+			bool deflated = method == 8;
+			if ((method != 0 && !deflated) || (flags & 1) != 0 || isdir)
+				continue;
+			if (!deflated && compressedsize != uncompressedsize)
+				continue;
+
+			// zlib's stream sizes are 32 bit.
+			if (deflated && (compressedsize > 0xFFFFFFFF || uncompressedsize > 0xFFFFFFFF))
+				continue;
+
+			uint64 local = base + localoffset;
+			if (local + ZIP_LOCAL_HEADER_SIZE > size || readU32(data + local) != ZIP_LOCAL_HEADER)
+				continue;
+
+			// The local header's extra field can differ from the central one.
+			uint64 offset = local + ZIP_LOCAL_HEADER_SIZE + readU16(data + local + 26) + readU16(data + local + 28);
+			if (offset > size || compressedsize > size - offset)
+				continue;
+
+			entries[std::string(name, namelen)] = {offset, compressedsize, uncompressedsize, deflated};
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_ZIP_INDEX_H
+#define LOVE_FILESYSTEM_PHYSFS_ZIP_INDEX_H
+
+// LOVE
+#include "ReadBatch.h"
+#include "common/int.h"
+#include "filesystem/MappedFileData.h"
+
+// C++
+#include <string>
+#include <unordered_map>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+/**
+ * The files in a memory-mapped zip archive. Stored files can be handed out
+ * as views of the archive instead of being read, and deflated ones can be
+ * decompressed straight from it. Data before or after the zip, such as a
+ * fused executable or its signature, is allowed.
+ **/
+class ZipIndex
+{
+public:
+
+	ZipIndex();
+
+	/**
+	 * Maps the archive at the given native path and indexes its files.
+	 * The index is left empty if the file can't be mapped or isn't a zip.
+	 **/
+	explicit ZipIndex(const std::string &path);
+
+	/**
+	 * Gets a view of a stored file in the archive.
+	 * @param name The file's path inside the archive.
+	 * @param filename The (virtual) filename reported by getFilename.
+	 * @return The view, or null if the file isn't stored uncompressed.
+	 **/
+	MappedFileData *getFile(const std::string &name, const std::string &filename) const;
+
+	/**
+	 * Gets where a stored or deflated file's contents are in the archive.
+	 * @return False if the file isn't in the index.
+	 **/
+	bool findFile(const std::string &name, ArchiveSpan &span) const;
+
+private:
+
+	struct Entry
+	{
+		uint64 offset;
+		uint64 size;
+		uint64 uncompressedSize;
+		bool deflated;
+	};
+
+	bool parse(const uint8 *data, uint64 size);
+
+	StrongRef<MappedFileData> archive;
+	std::unordered_map<std::string, Entry> entries;
+
+}; // ZipIndex
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_ZIP_INDEX_H
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_FileOperation.h"
+#include "wrap_Filesystem.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+FileOperation *luax_checkfileoperation(lua_State *L, int idx)
+{
+	return luax_checktype<FileOperation>(L, idx);
+}
+
+int w_FileOperation_isComplete(lua_State *L)
+{
+	FileOperation *op = luax_checkfileoperation(L, 1);
+	luax_pushboolean(L, op->isComplete());
+	return 1;
+}
+
+int w_FileOperation_wait(lua_State *L)
+{
+	FileOperation *op = luax_checkfileoperation(L, 1);
+	op->wait();
+	return 0;
+}
+
+int w_FileOperation_getFileData(lua_State *L)
+{
+	FileOperation *op = luax_checkfileoperation(L, 1);
+	FileData *filedata = nullptr;
+	luax_catchexcept(L, [&]() { filedata = op->getFileData(); });
+	luax_pushtype(L, filedata);
+	return 1;
+}
+
+int w_FileOperation_getDirectoryEntries(lua_State *L)
+{
+	FileOperation *op = luax_checkfileoperation(L, 1);
+	const std::vector<DirectoryEntry> *entries = nullptr;
+	luax_catchexcept(L, [&]() { entries = &op->getDirectoryEntries(); });
+	return luax_pushdirectoryentries(L, *entries);
+}
+
+int w_FileOperation_getError(lua_State *L)
+{
+	FileOperation *op = luax_checkfileoperation(L, 1);
+	std::string err = op->getError();
+	if (err.empty())
+		lua_pushnil(L);
+	else
+		luax_pushstring(L, err);
+	return 1;
+}
+
+int w_FileOperation_getFilename(lua_State *L)
+{
+	FileOperation *op = luax_checkfileoperation(L, 1);
+	luax_pushstring(L, op->getFilename());
+	return 1;
+}
+
+static const luaL_Reg w_FileOperation_functions[] =
+{
+	{ "isComplete", w_FileOperation_isComplete },
+	{ "wait", w_FileOperation_wait },
+	{ "getFileData", w_FileOperation_getFileData },
+	{ "getDirectoryEntries", w_FileOperation_getDirectoryEntries },
+	{ "getError", w_FileOperation_getError },
+	{ "getFilename", w_FileOperation_getFilename },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_fileoperation(lua_State *L)
+{
+	return luax_register_type(L, &FileOperation::type, w_FileOperation_functions, nullptr);
+}
+
+} // filesystem
+} // love
@@ -24,11 +24,15 @@
 #include "wrap_File.h"
 #include "wrap_NativeFile.h"
 #include "wrap_FileData.h"
+#include "wrap_FileOperation.h"
+#include "thread/wrap_Channel.h"
 #include "data/wrap_Data.h"
 #include "data/wrap_DataModule.h"
 
 #include "physfs/Filesystem.h"
 
+#include "libraries/xxHash/xxhash.h"
+
 #ifdef LOVE_ANDROID
 #include "common/android.h"
 #endif
@@ -41,6 +45,8 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 namespace love
 {
@@ -541,6 +547,55 @@ int w_exists(lua_State *L)
 	return 1;
 }
 
+// Sets the type, readonly, size and modtime fields of the table at the top of
+// the stack.
+static void setInfoFields(lua_State *L, Filesystem::Info info)
+{
+	const char *typestr = nullptr;
+	if (!Filesystem::getConstant(info.type, typestr))
+		luaL_error(L, "Unknown file type.");
+
+	lua_pushstring(L, typestr);
+	lua_setfield(L, -2, "type");
+
+	luax_pushboolean(L, info.readonly);
+	lua_setfield(L, -2, "readonly");
+
+	// Lua numbers (doubles) can't fit the full range of 64 bit ints.
+	info.size = std::min<int64>(info.size, 0x20000000000000LL);
+	if (info.size >= 0)
+	{
+		lua_pushnumber(L, (lua_Number) info.size);
+		lua_setfield(L, -2, "size");
+	}
+
+	info.modtime = std::min<int64>(info.modtime, 0x20000000000000LL);
+	if (info.modtime >= 0)
+	{
+		lua_pushnumber(L, (lua_Number) info.modtime);
+		lua_setfield(L, -2, "modtime");
+	}
+}
+
+int luax_pushdirectoryentries(lua_State *L, const std::vector<DirectoryEntry> &entries)
+{
+	lua_createtable(L, (int) entries.size(), 0);
+
+	for (int i = 0; i < (int) entries.size(); i++)
+	{
+		lua_createtable(L, 0, 5);
+
+		luax_pushstring(L, entries[i].path);
+		lua_setfield(L, -2, "path");
+
+		setInfoFields(L, entries[i].info);
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 int w_getInfo(lua_State *L)
 {
 	const char *filepath = luaL_checkstring(L, 1);
@@ -565,35 +620,12 @@ int w_getInfo(lua_State *L)
 			return 1;
 		}
 
-		const char *typestr = nullptr;
-		if (!Filesystem::getConstant(info.type, typestr))
-			return luaL_error(L, "Unknown file type.");
-
 		if (lua_istable(L, startidx))
 			lua_pushvalue(L, startidx);
 		else
-			lua_createtable(L, 0, 3);
+			lua_createtable(L, 0, 4);
 
-		lua_pushstring(L, typestr);
-		lua_setfield(L, -2, "type");
-
-		luax_pushboolean(L, info.readonly);
-		lua_setfield(L, -2, "readonly");
-
-		// Lua numbers (doubles) can't fit the full range of 64 bit ints.
-		info.size = std::min<int64>(info.size, 0x20000000000000LL);
-		if (info.size >= 0)
-		{
-			lua_pushnumber(L, (lua_Number) info.size);
-			lua_setfield(L, -2, "size");
-		}
-
-		info.modtime = std::min<int64>(info.modtime, 0x20000000000000LL);
-		if (info.modtime >= 0)
-		{
-			lua_pushnumber(L, (lua_Number) info.modtime);
-			lua_setfield(L, -2, "modtime");
-		}
+		setInfoFields(L, info);
 	}
 	else
 		lua_pushnil(L);
@@ -658,6 +690,76 @@ int w_read(lua_State *L)
 	return 2;
 }
 
+int w_readMany(lua_State *L)
+{
+	love::data::ContainerType ctype = love::data::CONTAINER_STRING;
+	int tableidx = 1;
+
+	if (lua_type(L, 1) == LUA_TSTRING)
+	{
+		ctype = love::data::luax_checkcontainertype(L, 1);
+		tableidx = 2;
+	}
+
+	luaL_checktype(L, tableidx, LUA_TTABLE);
+
+	std::vector<std::string> filenames;
+	int count = (int) luax_objlen(L, tableidx);
+	filenames.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, tableidx, i);
+		filenames.push_back(luax_checkstring(L, -1));
+		lua_pop(L, 1);
+	}
+
+	std::vector<StrongRef<FileData>> results;
+	try
+	{
+		instance()->readMany(filenames, results);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	lua_createtable(L, count, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		FileData *data = results[i].get();
+
+		if (ctype == love::data::CONTAINER_DATA)
+			luax_pushtype(L, data);
+		else
+			lua_pushlstring(L, (const char *) data->getData(), data->getSize());
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_mapFile(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	FileData *data = nullptr;
+	try
+	{
+		data = instance()->mapFile(filename);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushtype(L, data);
+	data->release();
+	return 1;
+}
+
 static int w_write_or_append(lua_State *L, File::Mode mode)
 {
 	const char *filename = luaL_checkstring(L, 1);
@@ -705,6 +807,135 @@ int w_append(lua_State *L)
 	return w_write_or_append(L, File::MODE_APPEND);
 }
 
+static love::thread::Channel *luax_optchannel(lua_State *L, int idx)
+{
+	if (lua_isnoneornil(L, idx))
+		return nullptr;
+	return love::thread::luax_checkchannel(L, idx);
+}
+
+int w_readAsync(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	love::thread::Channel *channel = luax_optchannel(L, 2);
+
+	FileOperation *op = nullptr;
+	luax_catchexcept(L, [&]() { op = instance()->newFileOperation(FileOperation::KIND_READ, filename, nullptr, channel); });
+
+	luax_pushtype(L, op);
+	op->release();
+	return 1;
+}
+
+static int w_writeAsync_or_appendAsync(lua_State *L, FileOperation::Kind kind)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	love::thread::Channel *channel = luax_optchannel(L, 3);
+
+	StrongRef<love::Data> data;
+
+	if (luax_istype(L, 2, love::Data::type))
+		data.set(luax_totype<love::Data>(L, 2));
+	else if (lua_isstring(L, 2))
+	{
+		// Lua strings can't be held onto from another thread, so strings are
+		// copied. Data objects are used in place and shouldn't be modified
+		// until the operation is complete.
+		size_t len = 0;
+		const char *input = lua_tolstring(L, 2, &len);
+		luax_catchexcept(L, [&]() { data.set(instance()->newFileData(input, len, filename), Acquire::NORETAIN); });
+	}
+	else
+		return luaL_argerror(L, 2, "string or Data expected");
+
+	FileOperation *op = nullptr;
+	luax_catchexcept(L, [&]() { op = instance()->newFileOperation(kind, filename, data.get(), channel); });
+
+	luax_pushtype(L, op);
+	op->release();
+	return 1;
+}
+
+int w_writeAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, FileOperation::KIND_WRITE);
+}
+
+int w_appendAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, FileOperation::KIND_APPEND);
+}
+
+int w_commitAsync(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	love::thread::Channel *channel = luax_optchannel(L, 2);
+
+	std::vector<FileOperation::StagedFile> files;
+
+	lua_pushnil(L);
+	while (lua_next(L, 1))
+	{
+		if (lua_type(L, -2) != LUA_TSTRING)
+			return luaL_error(L, "File names in the table must be strings.");
+
+		FileOperation::StagedFile f;
+		f.filename = lua_tostring(L, -2);
+
+		if (luax_istype(L, -1, love::Data::type))
+			f.data.set(luax_totype<love::Data>(L, -1));
+		else if (lua_isstring(L, -1))
+		{
+			size_t len = 0;
+			const char *input = lua_tolstring(L, -1, &len);
+			luax_catchexcept(L, [&]() { f.data.set(instance()->newFileData(input, len, f.filename.c_str()), Acquire::NORETAIN); });
+		}
+		else
+			return luaL_error(L, "Contents of file '%s' must be a string or Data.", f.filename.c_str());
+
+		files.push_back(f);
+		lua_pop(L, 1);
+	}
+
+	// Table order isn't stable, so files are always written in name order.
+	std::sort(files.begin(), files.end(), [](const FileOperation::StagedFile &a, const FileOperation::StagedFile &b)
+	{
+		return a.filename < b.filename;
+	});
+
+	FileOperation *op = nullptr;
+	luax_catchexcept(L, [&]() { op = instance()->newCommitOperation(files, channel); });
+
+	luax_pushtype(L, op);
+	op->release();
+	return 1;
+}
+
+int w_scanDirectory(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	const char *pattern = luaL_optstring(L, 2, "");
+
+	std::vector<DirectoryEntry> entries;
+	luax_catchexcept(L, [&]() { instance()->scanDirectory(dir, pattern, entries); });
+
+	return luax_pushdirectoryentries(L, entries);
+}
+
+int w_scanDirectoryAsync(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	const char *pattern = luaL_optstring(L, 2, "");
+	love::thread::Channel *channel = luax_optchannel(L, 3);
+
+	FileOperation *op = nullptr;
+	luax_catchexcept(L, [&]() { op = instance()->newScanOperation(dir, pattern, channel); });
+
+	luax_pushtype(L, op);
+	op->release();
+	return 1;
+}
+
 int w_getDirectoryItems(lua_State *L)
 {
 	const char *dir = luaL_checkstring(L, 1);
@@ -812,6 +1043,78 @@ int w_areSymlinksEnabled(lua_State *L)
 	return 1;
 }
 
+int w_setPathCacheEnabled(lua_State *L)
+{
+	instance()->setPathCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isPathCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isPathCacheEnabled());
+	return 1;
+}
+
+int w_setBytecodeCacheEnabled(lua_State *L)
+{
+	instance()->setBytecodeCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isBytecodeCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isBytecodeCacheEnabled());
+	return 1;
+}
+
+int w_setReadRecording(lua_State *L)
+{
+	std::string tag = lua_isnoneornil(L, 1) ? std::string() : luax_checkstring(L, 1);
+	luax_catchexcept(L, [&]() { instance()->setReadRecording(tag); });
+	return 0;
+}
+
+int w_getReadRecording(lua_State *L)
+{
+	std::string tag = instance()->getReadRecording();
+	if (tag.empty())
+		lua_pushnil(L);
+	else
+		luax_pushstring(L, tag);
+	return 1;
+}
+
+int w_prefetch(lua_State *L)
+{
+	std::string tag = luax_checkstring(L, 1);
+	love::thread::Channel *channel = luax_optchannel(L, 2);
+
+	FileOperation *op = nullptr;
+	luax_catchexcept(L, [&]() { op = instance()->prefetch(tag, channel); });
+
+	if (op == nullptr)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	luax_pushtype(L, op);
+	op->release();
+	return 1;
+}
+
+int w_setWatchEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->setWatchEnabled(luax_checkboolean(L, 1)));
+	return 1;
+}
+
+int w_isWatchEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isWatchEnabled());
+	return 1;
+}
+
 int w_getRequirePath(lua_State *L)
 {
 	std::stringstream path;
@@ -894,6 +1197,149 @@ static void replaceAll(std::string &str, const std::string &substr, const std::s
 		str.replace(locations[i], sublen, replacement);
 }
 
+// Where cached bytecode is stored in the save directory.
+static const char *BYTECODE_CACHE_DIRECTORY = ".bytecodecache";
+static const char BYTECODE_CACHE_MAGIC[8] = {'L', 'O', 'V', 'E', 'B', 'C', '0', '1'};
+
+// Bytecode isn't compatible between Lua implementations, versions or
+// architectures.
+static const std::string &getLuaVersion(lua_State *L)
+{
+	static std::string version;
+
+	if (version.empty())
+	{
+		version = LUA_RELEASE;
+
+		lua_getglobal(L, "jit");
+		if (lua_istable(L, -1))
+		{
+			lua_getfield(L, -1, "version");
+			lua_getfield(L, -2, "arch");
+			if (lua_isstring(L, -2))
+				version += std::string(" ") + lua_tostring(L, -2);
+			if (lua_isstring(L, -1))
+				version += std::string(" ") + lua_tostring(L, -1);
+			lua_pop(L, 2);
+		}
+		lua_pop(L, 1);
+
+		version += sizeof(void *) == 8 ? " 64" : " 32";
+	}
+
+	return version;
+}
+
+static int writeBytecode(lua_State *, const void *p, size_t size, void *ud)
+{
+	((std::string *) ud)->append((const char *) p, size);
+	return 0;
+}
+
+/**
+ * Loads a required file like w_load, but uses the file's cached bytecode
+ * when it's in the cache, and adds it otherwise.
+ **/
+static int loadCached(lua_State *L, const std::string &filename)
+{
+	auto *inst = instance();
+
+	StrongRef<FileData> source;
+	try
+	{
+		source.set(inst->read(filename.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	std::string chunkname = "@" + filename;
+	const std::string &version = getLuaVersion(L);
+
+	uint64 hash = XXH64(source->getData(), (size_t) source->getSize(), 0);
+	hash = XXH64(chunkname.data(), chunkname.size(), hash);
+	hash = XXH64(version.data(), version.size(), hash);
+
+	// The header repeats the chunk name, version and source size, so an
+	// entry for another file or build is never used.
+	uint64 sourcesize = source->getSize();
+	std::string header(BYTECODE_CACHE_MAGIC, sizeof(BYTECODE_CACHE_MAGIC));
+	header.append((const char *) &hash, sizeof(hash));
+	header.append((const char *) &sourcesize, sizeof(sourcesize));
+	header += version + '\0' + chunkname + '\0';
+
+	char cachename[64];
+	snprintf(cachename, sizeof(cachename), "%s/%016llx.luac", BYTECODE_CACHE_DIRECTORY, (unsigned long long) hash);
+
+	StrongRef<FileData> cached;
+	try
+	{
+		if (inst->exists(cachename))
+			cached.set(inst->read(cachename), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+	}
+
+	if (cached.get() != nullptr && cached->getSize() > header.size()
+		&& memcmp(cached->getData(), header.data(), header.size()) == 0)
+	{
+		const char *bytecode = (const char *) cached->getData() + header.size();
+		size_t size = (size_t) cached->getSize() - header.size();
+
+#if (LUA_VERSION_NUM > 501) || defined(LUA_JITLIBNAME)
+		int status = luaL_loadbufferx(L, bytecode, size, chunkname.c_str(), "b");
+#else
+		int status = luaL_loadbuffer(L, bytecode, size, chunkname.c_str());
+#endif
+
+		if (status == 0)
+			return 1;
+
+		// Corrupt or otherwise unusable, so it's replaced below.
+		lua_pop(L, 1);
+	}
+
+	int status = luaL_loadbuffer(L, (const char *) source->getData(), (size_t) source->getSize(), chunkname.c_str());
+
+	switch (status)
+	{
+	case LUA_ERRMEM:
+		return luaL_error(L, "Memory allocation error: %s\n", lua_tostring(L, -1));
+	case LUA_ERRSYNTAX:
+		return luaL_error(L, "Syntax error: %s\n", lua_tostring(L, -1));
+	default:
+		break;
+	}
+
+	std::string contents = header;
+
+#if LUA_VERSION_NUM >= 503
+	status = lua_dump(L, writeBytecode, &contents, 0);
+#else
+	status = lua_dump(L, writeBytecode, &contents);
+#endif
+
+	// The cache is written on the I/O thread, so only the first run pays
+	// for compiling and nothing waits on the write.
+	try
+	{
+		if (status == 0 && inst->createDirectory(BYTECODE_CACHE_DIRECTORY))
+		{
+			StrongRef<FileData> data(inst->newFileData(contents.data(), contents.size(), cachename), Acquire::NORETAIN);
+			FileOperation *op = inst->newFileOperation(FileOperation::KIND_WRITE, cachename, data, nullptr);
+			op->release();
+		}
+	}
+	catch (love::Exception &)
+	{
+		// Not having a save directory just means nothing is cached.
+	}
+
+	return 1;
+}
+
 int loader(lua_State *L)
 {
 	std::string modulename = luax_checkstring(L, 1);
@@ -916,6 +1362,9 @@ int loader(lua_State *L)
 			if (hasSlash)
 				luax_markdeprecated(L, 2, "character in require string (forward slashes), use dots instead.", API_CUSTOM);
 
+			if (inst->isBytecodeCacheEnabled())
+				return loadCached(L, element);
+
 			lua_pop(L, 1);
 			lua_pushstring(L, element.c_str());
 			return w_load(L);
@@ -1069,15 +1518,32 @@ static const luaL_Reg functions[] =
 	{ "createDirectory", w_createDirectory },
 	{ "remove", w_remove },
 	{ "read", w_read },
+	{ "mapFile", w_mapFile },
+	{ "readMany", w_readMany },
 	{ "write", w_write },
 	{ "append", w_append },
+	{ "readAsync", w_readAsync },
+	{ "writeAsync", w_writeAsync },
+	{ "appendAsync", w_appendAsync },
+	{ "commitAsync", w_commitAsync },
 	{ "getDirectoryItems", w_getDirectoryItems },
+	{ "scanDirectory", w_scanDirectory },
+	{ "scanDirectoryAsync", w_scanDirectoryAsync },
 	{ "lines", w_lines },
 	{ "load", w_load },
 	{ "exists", w_exists },
 	{ "getInfo", w_getInfo },
 	{ "setSymlinksEnabled", w_setSymlinksEnabled },
 	{ "areSymlinksEnabled", w_areSymlinksEnabled },
+	{ "setPathCacheEnabled", w_setPathCacheEnabled },
+	{ "isPathCacheEnabled", w_isPathCacheEnabled },
+	{ "setBytecodeCacheEnabled", w_setBytecodeCacheEnabled },
+	{ "isBytecodeCacheEnabled", w_isBytecodeCacheEnabled },
+	{ "setReadRecording", w_setReadRecording },
+	{ "getReadRecording", w_getReadRecording },
+	{ "prefetch", w_prefetch },
+	{ "setWatchEnabled", w_setWatchEnabled },
+	{ "isWatchEnabled", w_isWatchEnabled },
 	{ "newFileData", w_newFileData },
 	{ "getRequirePath", w_getRequirePath },
 	{ "setRequirePath", w_setRequirePath },
@@ -1095,6 +1561,7 @@ static const lua_CFunction types[] =
 	luaopen_file,
 	luaopen_nativefile,
 	luaopen_filedata,
+	luaopen_fileoperation,
 	0
 };
 
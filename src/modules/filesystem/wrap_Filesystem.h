@@ -25,6 +25,7 @@
 #include "common/runtime.h"
 #include "File.h"
 #include "FileData.h"
+#include "Filesystem.h"
 
 namespace love
 {
@@ -47,6 +48,12 @@ bool luax_cangetfile(lua_State *L, int idx);
 Data *luax_getdata(lua_State *L, int idx);
 bool luax_cangetdata(lua_State *L, int idx);
 
+/**
+ * Pushes a table with a {path, type, size, modtime, readonly} table for each
+ * entry, in order.
+ **/
+int luax_pushdirectoryentries(lua_State *L, const std::vector<DirectoryEntry> &entries);
+
 int loader(lua_State *L);
 int extloader(lua_State *L);
 extern "C" LOVE_EXPORT int luaopen_love_filesystem(lua_State *L);
@@ -37,18 +37,27 @@ namespace font
 Font::Font(const char *name)
 	: Module(M_FONT, name)
 {
-	auto compressedbytes = (const char *) NotoSans_Regular_ttf_gzip;
-	size_t compressedsize = NotoSans_Regular_ttf_gzip_len;
+}
+
+Data *Font::getDefaultFontData()
+{
+	std::call_once(defaultFontDataCreated, [this]()
+	{
+		auto compressedbytes = (const char *) NotoSans_Regular_ttf_gzip;
+		size_t compressedsize = NotoSans_Regular_ttf_gzip_len;
+
+		size_t rawsize = 0;
+		char *fontdata = data::decompress(data::Compressor::FORMAT_GZIP, compressedbytes, compressedsize, rawsize);
 
-	size_t rawsize = 0;
-	char *fontdata = data::decompress(data::Compressor::FORMAT_GZIP, compressedbytes, compressedsize, rawsize);
+		defaultFontData.set(new data::ByteData(fontdata, rawsize, true), Acquire::NORETAIN);
+	});
 
-	defaultFontData.set(new data::ByteData(fontdata, rawsize, true), Acquire::NORETAIN);
+	return defaultFontData.get();
 }
 
 Rasterizer *Font::newTrueTypeRasterizer(int size, const TrueTypeRasterizer::Settings &settings)
 {
-	return newTrueTypeRasterizer(defaultFontData.get(), size, settings);
+	return newTrueTypeRasterizer(getDefaultFontData(), size, settings);
 }
 
 Rasterizer *Font::newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale)
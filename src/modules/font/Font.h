@@ -32,6 +32,7 @@
 // C++
 #include <string>
 #include <vector>
+#include <mutex>
 
 namespace love
 {
@@ -63,7 +64,12 @@ protected:
 
 private:
 
+	Data *getDefaultFontData();
+
+	// Decompressed the first time it's used rather than when the module is
+	// loaded, since many games never use the default font.
 	StrongRef<Data> defaultFontData;
+	std::once_flag defaultFontDataCreated;
 
 }; // Font
 
@@ -35,10 +35,11 @@ public:
 	GenericShaper(Rasterizer *rasterizer);
 	virtual ~GenericShaper();
 
-	void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) override;
 	int computeWordWrapIndex(const ColoredCodepoints &codepoints, Range range, float wraplimit, float *width) override;
 
-private:
+protected:
+
+	void computeGlyphPositionsInternal(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) override;
 
 }; // GenericShaper
 
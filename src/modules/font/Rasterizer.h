@@ -141,13 +141,26 @@ public:
 
 	virtual TextShaper *newTextShaper() = 0;
 
+	/**
+	 * Creates a new Rasterizer with the same data and settings, which can be
+	 * used from a different thread than this one. Returns null if the
+	 * Rasterizer type doesn't support it.
+	 **/
+	virtual Rasterizer *clone() const { return nullptr; }
+
 	float getDPIScale() const;
 
+	/**
+	 * Gets whether glyphs are rasterized as signed distance fields, with the
+	 * glyph's edge at half of the maximum value.
+	 **/
+	bool isSDF() const;
+
 protected:
 
 	FontMetrics metrics;
 	float dpiScale;
-	bool sdf;
+	bool sdf = false;
 
 }; // Rasterizer
 
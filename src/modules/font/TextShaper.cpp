@@ -22,33 +22,112 @@
 #include "TextShaper.h"
 #include "Rasterizer.h"
 #include "common/Exception.h"
+#include "thread/threads.h"
 
 #include "libraries/utf8/utf8.h"
+#include "libraries/xxHash/xxhash.h"
+
+#include <string.h>
+#include <algorithm>
+
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#	define LOVE_TEXTSHAPER_NEON
+#	include <arm_neon.h>
+#endif
 
 namespace love
 {
 namespace font
 {
 
+/**
+ * Converts the run of 7 bit ASCII characters at the start of the string,
+ * returning its length.
+ **/
+static size_t decodeASCIIRun(const char *src, size_t len, uint32 *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+		if (_mm_movemask_epi8(v) != 0)
+			break;
+
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+		_mm_storeu_si128((__m128i *) (dst + i + 0), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#elif defined(LOVE_TEXTSHAPER_NEON)
+	for (; i + 16 <= len; i += 16)
+	{
+		uint8x16_t v = vld1q_u8((const uint8_t *) src + i);
+		if (vmaxvq_u8(v) >= 0x80)
+			break;
+
+		uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+		uint16x8_t hi = vmovl_high_u8(v);
+
+		vst1q_u32(dst + i + 0, vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32(dst + i + 4, vmovl_high_u16(lo));
+		vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32(dst + i + 12, vmovl_high_u16(hi));
+	}
+#endif
+
+	for (; i < len && (unsigned char) src[i] < 0x80; i++)
+		dst[i] = (unsigned char) src[i];
+
+	return i;
+}
+
 void getCodepointsFromString(const std::string &text, std::vector<uint32> &codepoints)
 {
-	codepoints.reserve(text.size());
+	const char *str = text.data();
+	size_t len = text.size();
+
+	// Every codepoint takes at least one byte, so the string's length is an
+	// upper bound.
+	size_t start = codepoints.size();
+	codepoints.resize(start + len);
+	uint32 *dst = codepoints.data() + start;
+
+	size_t i = 0;
 
 	try
 	{
-		utf8::iterator<std::string::const_iterator> i(text.begin(), text.begin(), text.end());
-		utf8::iterator<std::string::const_iterator> end(text.end(), text.begin(), text.end());
-
-		while (i != end)
+		while (i < len)
 		{
-			uint32 g = *i++;
-			codepoints.push_back(g);
+			// Most text is ASCII, which doesn't need to go through the
+			// decoder one character at a time.
+			size_t run = decodeASCIIRun(str + i, len - i, dst);
+			i += run;
+			dst += run;
+
+			if (i < len)
+			{
+				const char *it = str + i;
+				*dst++ = utf8::next(it, str + len);
+				i = it - str;
+			}
 		}
 	}
 	catch (utf8::exception &e)
 	{
+		codepoints.resize(start);
 		throw love::Exception("UTF-8 decoding error: %s", e.what());
 	}
+
+	codepoints.resize(dst - codepoints.data());
 }
 
 void getCodepointsFromString(const std::vector<ColoredString> &strs, ColoredCodepoints &codepoints)
@@ -82,6 +161,14 @@ void getCodepointsFromString(const std::vector<ColoredString> &strs, ColoredCode
 
 love::Type TextShaper::type("TextShaper", &Object::type);
 
+std::vector<TextShaper::FallbackCache *> TextShaper::fallbackCaches;
+
+static thread::Mutex *getFallbackCacheMutex()
+{
+	static thread::MutexRef mutex;
+	return mutex;
+}
+
 TextShaper::TextShaper(Rasterizer *rasterizer)
 	: rasterizers{rasterizer}
 	, dpiScales{rasterizer->getDPIScale()}
@@ -89,6 +176,7 @@ TextShaper::TextShaper(Rasterizer *rasterizer)
 	, pixelHeight(rasterizer->getHeight())
 	, lineHeight(1)
 	, useSpacesForTab(false)
+	, fallbackCache(nullptr)
 {
 	if (!rasterizer->hasGlyph('\t'))
 		useSpacesForTab = true;
@@ -96,6 +184,7 @@ TextShaper::TextShaper(Rasterizer *rasterizer)
 
 TextShaper::~TextShaper()
 {
+	releaseFallbackCache();
 }
 
 float TextShaper::getHeight() const
@@ -115,6 +204,8 @@ float TextShaper::getCombinedHeight() const
 
 void TextShaper::setLineHeight(float h)
 {
+	if (h != lineHeight)
+		clearRunCache();
 	lineHeight = h;
 }
 
@@ -146,13 +237,7 @@ float TextShaper::getBaseline() const
 
 bool TextShaper::hasGlyph(uint32 glyph) const
 {
-	for (const StrongRef<Rasterizer> &r : rasterizers)
-	{
-		if (r->hasGlyph(glyph))
-			return true;
-	}
-
-	return false;
+	return getGlyphMask(glyph) != 0;
 }
 
 bool TextShaper::hasGlyphs(const std::string &text) const
@@ -189,21 +274,13 @@ float TextShaper::getKerning(uint32 leftglyph, uint32 rightglyph)
 	if (it != kerning.end())
 		return it->second;
 
-	float k = 0.0f;
-	bool found = false;
+	// Use the first rasterizer which has both glyphs, if there is one.
+	int rasterizeri = getFirstRasterizer(getGlyphMask(leftglyph) & getGlyphMask(rightglyph));
+	if (rasterizeri < 0)
+		rasterizeri = 0;
 
-	for (const auto &r : rasterizers)
-	{
-		if (r->hasGlyph(leftglyph) && r->hasGlyph(rightglyph))
-		{
-			found = true;
-			k = r->getKerning(leftglyph, rightglyph) / r->getDPIScale();
-			break;
-		}
-	}
-
-	if (!found)
-		k = rasterizers[0]->getKerning(leftglyph, rightglyph) / rasterizers[0]->getDPIScale();
+	const auto &r = rasterizers[rasterizeri];
+	float k = r->getKerning(leftglyph, rightglyph) / r->getDPIScale();
 
 	kerning[packedglyphs] = k;
 	return k;
@@ -237,20 +314,14 @@ float TextShaper::getGlyphAdvance(uint32 glyph, GlyphIndex *glyphindex)
 		return it->second.first;
 	}
 
-	int rasterizeri = 0;
 	uint32 realglyph = glyph;
 
 	if (glyph == '\t' && isUsingSpacesForTab())
 		realglyph = ' ';
 
-	for (size_t i = 0; i < rasterizers.size(); i++)
-	{
-		if (rasterizers[i]->hasGlyph(realglyph))
-		{
-			rasterizeri = (int) i;
-			break;
-		}
-	}
+	int rasterizeri = getFirstRasterizer(getGlyphMask(realglyph));
+	if (rasterizeri < 0)
+		rasterizeri = 0;
 
 	const auto &r = rasterizers[rasterizeri];
 	float advance = r->getGlyphSpacing(realglyph) / r->getDPIScale();
@@ -279,6 +350,125 @@ float TextShaper::getWidth(const std::string& str)
 	return info.width;
 }
 
+static bool isSameColors(const std::vector<IndexedColor> &a, const std::vector<IndexedColor> &b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		const Colorf &ca = a[i].color;
+		const Colorf &cb = b[i].color;
+		if (a[i].index != b[i].index || ca.r != cb.r || ca.g != cb.g || ca.b != cb.b || ca.a != cb.a)
+			return false;
+	}
+
+	return true;
+}
+
+template <typename T>
+T *TextShaper::RunCache<T>::find(uint64 hash)
+{
+	auto it = lookup.find(hash);
+	if (it == lookup.end())
+		return nullptr;
+
+	// Keep the most recently used run at the front of the list, so the least
+	// recently used one is always at the back.
+	entries.splice(entries.begin(), entries, it->second);
+	return &entries.front();
+}
+
+template <typename T>
+T &TextShaper::RunCache<T>::insert(uint64 hash)
+{
+	auto it = lookup.find(hash);
+	if (it != lookup.end())
+	{
+		entries.erase(it->second);
+		lookup.erase(it);
+	}
+	else if (entries.size() >= MAX_CACHED_RUNS)
+	{
+		lookup.erase(entries.back().hash);
+		entries.pop_back();
+	}
+
+	entries.emplace_front();
+	entries.front().hash = hash;
+	lookup[hash] = entries.begin();
+	return entries.front();
+}
+
+template <typename T>
+void TextShaper::RunCache<T>::clear()
+{
+	entries.clear();
+	lookup.clear();
+}
+
+void TextShaper::computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
+{
+	if (codepoints.cps.empty() || codepoints.cps.size() > MAX_CACHED_RUN_LENGTH)
+		return computeGlyphPositionsInternal(codepoints, range, offset, extraspacing, positions, colors, info);
+
+	if (!range.isValid())
+		range = Range(0, codepoints.cps.size());
+
+	uint32 spacingbits = 0;
+	memcpy(&spacingbits, &extraspacing, sizeof(float));
+	uint64 params[] = {(uint64) range.first, (uint64) range.last, spacingbits};
+
+	uint64 hash = XXH64(codepoints.cps.data(), codepoints.cps.size() * sizeof(uint32), 0);
+	hash = XXH64(codepoints.colors.data(), codepoints.colors.size() * sizeof(IndexedColor), hash);
+	hash = XXH64(params, sizeof(params), hash);
+
+	ShapedRun *run = shapedRuns.find(hash);
+
+	if (run == nullptr || run->range.first != range.first || run->range.last != range.last
+		|| run->extraSpacing != extraspacing || run->codepoints.cps != codepoints.cps
+		|| !isSameColors(run->codepoints.colors, codepoints.colors))
+	{
+		// Shape at the origin, so the run can be reused at any offset.
+		std::vector<GlyphPosition> newpositions;
+		std::vector<IndexedColor> newcolors;
+		TextInfo newinfo = {};
+		computeGlyphPositionsInternal(codepoints, range, Vector2(0.0f, 0.0f), extraspacing, &newpositions, &newcolors, &newinfo);
+
+		run = &shapedRuns.insert(hash);
+		run->codepoints = codepoints;
+		run->range = range;
+		run->extraSpacing = extraspacing;
+		run->positions = std::move(newpositions);
+		run->colors = std::move(newcolors);
+		run->info = newinfo;
+	}
+
+	if (positions)
+	{
+		size_t start = positions->size();
+		positions->reserve(start + run->positions.size());
+
+		for (const GlyphPosition &p : run->positions)
+			positions->push_back({p.position + offset, p.glyphIndex});
+
+		if (colors)
+		{
+			for (const IndexedColor &c : run->colors)
+				colors->push_back({c.color, c.index + (int) start});
+		}
+	}
+
+	if (info != nullptr)
+		*info = run->info;
+}
+
+void TextShaper::clearRunCache()
+{
+	shapedRuns.clear();
+	wrappedRuns.clear();
+}
+
 static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 {
 	for (size_t i = start; i < codepoints.cps.size(); i++)
@@ -293,6 +483,34 @@ static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 }
 
 void TextShaper::getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths)
+{
+	if (codepoints.cps.empty() || codepoints.cps.size() > MAX_CACHED_RUN_LENGTH)
+		return getWrapInternal(codepoints, wraplimit, lineranges, linewidths);
+
+	uint64 hash = XXH64(codepoints.cps.data(), codepoints.cps.size() * sizeof(uint32), 0);
+	hash = XXH64(&wraplimit, sizeof(float), hash);
+
+	WrappedRun *run = wrappedRuns.find(hash);
+
+	if (run == nullptr || run->wrapLimit != wraplimit || run->codepoints != codepoints.cps)
+	{
+		std::vector<Range> newranges;
+		std::vector<float> newwidths;
+		getWrapInternal(codepoints, wraplimit, newranges, &newwidths);
+
+		run = &wrappedRuns.insert(hash);
+		run->codepoints = codepoints.cps;
+		run->wrapLimit = wraplimit;
+		run->lineRanges = std::move(newranges);
+		run->lineWidths = std::move(newwidths);
+	}
+
+	lineranges.insert(lineranges.end(), run->lineRanges.begin(), run->lineRanges.end());
+	if (linewidths)
+		linewidths->insert(linewidths->end(), run->lineWidths.begin(), run->lineWidths.end());
+}
+
+void TextShaper::getWrapInternal(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths)
 {
 	size_t nextnewline = findNewline(codepoints, 0);
 
@@ -368,6 +586,9 @@ void TextShaper::getWrap(const std::vector<ColoredString> &text, float wraplimit
 
 void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 {
+	if (fallbacks.size() >= MAX_RASTERIZERS)
+		throw love::Exception("Fonts can have at most %d fallbacks.", MAX_RASTERIZERS - 1);
+
 	for (Rasterizer *r : fallbacks)
 	{
 		if (r->getDataType() != rasterizers[0]->getDataType())
@@ -377,6 +598,9 @@ void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 	// Clear caches.
 	kerning.clear();
 	glyphAdvances.clear();
+	glyphMasks.clear();
+	clearRunCache();
+	releaseFallbackCache();
 
 	rasterizers.resize(1);
 	dpiScales.resize(1);
@@ -386,6 +610,101 @@ void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 		rasterizers.push_back(r);
 		dpiScales.push_back(r->getDPIScale());
 	}
+
+	if (rasterizers.size() > 1)
+		acquireFallbackCache();
+}
+
+uint64 TextShaper::getGlyphMask(uint32 glyph) const
+{
+	const auto it = glyphMasks.find(glyph);
+	if (it != glyphMasks.end())
+		return it->second;
+
+	uint64 mask = 0;
+
+	if (fallbackCache != nullptr)
+	{
+		// Another Font with the same fallbacks may have resolved it already.
+		thread::Lock lock(getFallbackCacheMutex());
+
+		const auto sharedit = fallbackCache->glyphMasks.find(glyph);
+		if (sharedit != fallbackCache->glyphMasks.end())
+			mask = sharedit->second;
+		else
+		{
+			mask = computeGlyphMask(glyph);
+			fallbackCache->glyphMasks[glyph] = mask;
+		}
+	}
+	else
+		mask = computeGlyphMask(glyph);
+
+	glyphMasks[glyph] = mask;
+	return mask;
+}
+
+uint64 TextShaper::computeGlyphMask(uint32 glyph) const
+{
+	uint64 mask = 0;
+	for (size_t i = 0; i < rasterizers.size(); i++)
+	{
+		if (rasterizers[i]->hasGlyph(glyph))
+			mask |= 1ULL << i;
+	}
+	return mask;
+}
+
+int TextShaper::getFirstRasterizer(uint64 mask)
+{
+	for (int i = 0; i < MAX_RASTERIZERS; i++)
+	{
+		if (mask & (1ULL << i))
+			return i;
+	}
+	return -1;
+}
+
+void TextShaper::acquireFallbackCache()
+{
+	thread::Lock lock(getFallbackCacheMutex());
+
+	std::vector<Rasterizer *> chain;
+	for (const StrongRef<Rasterizer> &r : rasterizers)
+		chain.push_back(r.get());
+
+	for (FallbackCache *cache : fallbackCaches)
+	{
+		if (cache->rasterizers == chain)
+		{
+			cache->references++;
+			fallbackCache = cache;
+			return;
+		}
+	}
+
+	// The cache only stays alive while a TextShaper which references the
+	// same rasterizers does, so their addresses can't be reused meanwhile.
+	fallbackCache = new FallbackCache();
+	fallbackCache->rasterizers = chain;
+	fallbackCache->references = 1;
+	fallbackCaches.push_back(fallbackCache);
+}
+
+void TextShaper::releaseFallbackCache()
+{
+	if (fallbackCache == nullptr)
+		return;
+
+	thread::Lock lock(getFallbackCacheMutex());
+
+	if (--fallbackCache->references == 0)
+	{
+		fallbackCaches.erase(std::find(fallbackCaches.begin(), fallbackCaches.end(), fallbackCache));
+		delete fallbackCache;
+	}
+
+	fallbackCache = nullptr;
 }
 
 } // font
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <list>
 #include <unordered_map>
 
 namespace love
@@ -84,6 +85,15 @@ public:
 	// This will be used if the Rasterizer doesn't have a tab character itself.
 	static const int SPACES_PER_TAB = 4;
 
+	// Maximum number of shaped and wrapped runs kept in the LRU caches.
+	static const size_t MAX_CACHED_RUNS = 256;
+
+	// Longer texts are shaped every time instead of being cached.
+	static const size_t MAX_CACHED_RUN_LENGTH = 2048;
+
+	// Maximum number of rasterizers, including fallbacks.
+	static const int MAX_RASTERIZERS = 64;
+
 	static love::Type type;
 
 	virtual ~TextShaper();
@@ -128,13 +138,25 @@ public:
 
 	virtual void setFallbacks(const std::vector<Rasterizer *> &fallbacks);
 
-	virtual void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
+	/**
+	 * Computes the positions of the glyphs in the given codepoint range.
+	 * Results are kept in an LRU cache of shaped runs, so shaping the same
+	 * text repeatedly (at any offset) only runs the shaper once.
+	 **/
+	void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info);
 	virtual int computeWordWrapIndex(const ColoredCodepoints &codepoints, Range range, float wraplimit, float *width) = 0;
 
+	/**
+	 * Discards all cached shaped and wrapped runs.
+	 **/
+	void clearRunCache();
+
 protected:
 
 	TextShaper(Rasterizer *rasterizer);
 
+	virtual void computeGlyphPositionsInternal(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
+
 	static inline bool isWhitespace(uint32 codepoint) { return codepoint == ' ' || codepoint == '\t'; }
 
 	std::vector<StrongRef<Rasterizer>> rasterizers;
@@ -142,6 +164,56 @@ protected:
 
 private:
 
+	struct ShapedRun
+	{
+		uint64 hash;
+		ColoredCodepoints codepoints;
+		Range range;
+		float extraSpacing;
+		std::vector<GlyphPosition> positions;
+		std::vector<IndexedColor> colors;
+		TextInfo info;
+	};
+
+	struct WrappedRun
+	{
+		uint64 hash;
+		std::vector<uint32> codepoints;
+		float wrapLimit;
+		std::vector<Range> lineRanges;
+		std::vector<float> lineWidths;
+	};
+
+	template <typename T>
+	struct RunCache
+	{
+		std::list<T> entries;
+		std::unordered_map<uint64, typename std::list<T>::iterator> lookup;
+
+		T *find(uint64 hash);
+		T &insert(uint64 hash);
+		void clear();
+	};
+
+	// Glyph masks of the rasterizers in a fallback chain, shared by every
+	// TextShaper using the same chain so each codepoint is only resolved once.
+	struct FallbackCache
+	{
+		std::vector<Rasterizer *> rasterizers;
+		std::unordered_map<uint32, uint64> glyphMasks;
+		int references;
+	};
+
+	void getWrapInternal(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths);
+
+	// Bit i of the mask is set if rasterizer i has the glyph.
+	uint64 getGlyphMask(uint32 glyph) const;
+	uint64 computeGlyphMask(uint32 glyph) const;
+	static int getFirstRasterizer(uint64 mask);
+
+	void acquireFallbackCache();
+	void releaseFallbackCache();
+
 	int height;
 	int pixelHeight;
 	float lineHeight;
@@ -154,6 +226,17 @@ private:
 	// map of left/right glyph pairs to horizontal kerning.
 	std::unordered_map<uint64, float> kerning;
 
+	// maps glyphs to the rasterizers which have them, see getGlyphMask.
+	mutable std::unordered_map<uint32, uint64> glyphMasks;
+	FallbackCache *fallbackCache;
+
+	// Shared fallback caches, protected by getFallbackCacheMutex.
+	static std::vector<FallbackCache *> fallbackCaches;
+
+	// LRU caches of recently shaped and wrapped text.
+	RunCache<ShapedRun> shapedRuns;
+	RunCache<WrappedRun> wrappedRuns;
+
 }; // TextShaper
 
 } // font
@@ -34,7 +34,11 @@ namespace freetype
 {
 
 TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, const Settings &settings, float defaultdpiscale)
-	: data(data)
+	: library(library)
+	, size(size)
+	, settings(settings)
+	, defaultDPIScale(defaultdpiscale)
+	, data(data)
 	, hinting(settings.hinting)
 {
 	dpiScale = settings.dpiScale.get(defaultdpiscale);
@@ -230,6 +234,13 @@ TextShaper *TrueTypeRasterizer::newTextShaper()
 	return new HarfbuzzShaper(this);
 }
 
+Rasterizer *TrueTypeRasterizer::clone() const
+{
+	// Faces sharing an FT_Library can be used on different threads, but they
+	// must be created and destroyed by the thread which owns the library.
+	return new TrueTypeRasterizer(library, data, size, settings, defaultDPIScale);
+}
+
 bool TrueTypeRasterizer::accepts(FT_Library library, love::Data *data)
 {
 	const FT_Byte *fbase = (const FT_Byte *) data->getData();
@@ -57,6 +57,7 @@ public:
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
 	TextShaper *newTextShaper() override;
+	Rasterizer *clone() const override;
 
 	ptrdiff_t getHandle() const override { return (ptrdiff_t) face; }
 
@@ -69,6 +70,12 @@ private:
 	// TrueType face
 	FT_Face face;
 
+	// Everything needed to create another face for clone().
+	FT_Library library;
+	int size;
+	Settings settings;
+	float defaultDPIScale;
+
 	// Font data
 	StrongRef<love::Data> data;
 
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Atlas.h"
+#include "Graphics.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type Atlas::type("Atlas", &Object::type);
+
+Atlas::Atlas(Graphics *gfx, const Settings &settings)
+	: gfx(gfx)
+	, settings(settings)
+	, alignment(settings.mipmaps ? MIPMAP_ALIGNMENT : 1)
+	, imageCount(0)
+{
+	if (settings.width <= 0 || settings.height <= 0 || settings.pages <= 0)
+		throw love::Exception("Atlas dimensions and page count must be greater than 0.");
+
+	if (settings.padding < 0)
+		throw love::Exception("Atlas padding cannot be negative.");
+
+	if (isPixelFormatCompressed(settings.format) || isPixelFormatDepthStencil(settings.format))
+		throw love::Exception("Atlases must use an uncompressed color pixel format.");
+
+	Texture::Settings s;
+	s.width = settings.width;
+	s.height = settings.height;
+	s.layers = settings.pages;
+	s.type = TEXTURE_2D_ARRAY;
+	s.format = settings.format;
+	s.mipmaps = settings.mipmaps ? Texture::MIPMAPS_AUTO : Texture::MIPMAPS_NONE;
+	s.linear = settings.linear;
+	s.debugName = settings.debugName;
+
+	texture.set(gfx->newTexture(s, nullptr), Acquire::NORETAIN);
+
+	pages.resize(settings.pages);
+	for (SkylinePacker &page : pages)
+		page.reset(settings.width, settings.height);
+
+	pageViews.resize(settings.pages);
+}
+
+Atlas::~Atlas()
+{
+}
+
+Quad *Atlas::add(love::image::ImageData *data, bool updatemipmaps)
+{
+	if (data->getFormat() != settings.format)
+	{
+		const char *fstr = "unknown";
+		const char *dstr = "unknown";
+		love::getConstant(settings.format, fstr);
+		love::getConstant(data->getFormat(), dstr);
+		throw love::Exception("ImageData pixel format (%s) must match the Atlas' pixel format (%s).", dstr, fstr);
+	}
+
+	int w = data->getWidth();
+	int h = data->getHeight();
+	int p = settings.padding;
+
+	int pw = w + p * 2;
+	int ph = h + p * 2;
+
+	// Rounding the packed sizes up keeps every packed position aligned too.
+	int rw = ((pw + alignment - 1) / alignment) * alignment;
+	int rh = ((ph + alignment - 1) / alignment) * alignment;
+
+	int page = -1;
+	int x = 0;
+	int y = 0;
+
+	for (int i = 0; i < (int) pages.size(); i++)
+	{
+		if (pages[i].pack(rw, rh, x, y))
+		{
+			page = i;
+			break;
+		}
+	}
+
+	if (page < 0)
+		throw love::Exception("Not enough space in the Atlas for a %dx%d image.", w, h);
+
+	// Copy the image into the middle of the padded rect and repeat its edge
+	// pixels outward.
+	size_t pixelsize = getPixelFormatBlockSize(settings.format);
+	std::vector<uint8> padded(pixelsize * pw * ph);
+
+	{
+		love::thread::Lock lock(data->getMutex());
+		const uint8 *src = (const uint8 *) data->getData();
+
+		for (int row = 0; row < ph; row++)
+		{
+			int srcrow = std::min(std::max(row - p, 0), h - 1);
+			const uint8 *srcline = src + pixelsize * w * srcrow;
+			uint8 *dstline = padded.data() + pixelsize * pw * row;
+
+			for (int col = 0; col < p; col++)
+			{
+				memcpy(dstline + pixelsize * col, srcline, pixelsize);
+				memcpy(dstline + pixelsize * (p + w + col), srcline + pixelsize * (w - 1), pixelsize);
+			}
+
+			memcpy(dstline + pixelsize * p, srcline, pixelsize * w);
+		}
+	}
+
+	Rect rect = {x, y, pw, ph};
+	texture->replacePixels(padded.data(), padded.size(), page, 0, rect, updatemipmaps && settings.mipmaps);
+
+	Quad::Viewport v = {(double) (x + p), (double) (y + p), (double) w, (double) h};
+	Quad *quad = gfx->newQuad(v, texture->getWidth(), texture->getHeight());
+	quad->setLayer(page);
+
+	imageCount++;
+	return quad;
+}
+
+void Atlas::generateMipmaps()
+{
+	if (settings.mipmaps)
+		texture->generateMipmaps();
+}
+
+Texture *Atlas::getPageTexture(int page)
+{
+	if (page < 0 || page >= (int) pageViews.size())
+		throw love::Exception("Invalid Atlas page: %d", page + 1);
+
+	if (pageViews[page].get() == nullptr)
+	{
+		Texture::ViewSettings viewsettings;
+		viewsettings.type.set(TEXTURE_2D);
+		viewsettings.layerStart.set(page);
+		viewsettings.layerCount.set(1);
+		pageViews[page].set(gfx->newTextureView(texture, viewsettings), Acquire::NORETAIN);
+	}
+
+	return pageViews[page];
+}
+
+} // graphics
+} // love
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/pixelformat.h"
+#include "image/ImageData.h"
+#include "SkylinePacker.h"
+#include "Texture.h"
+#include "Quad.h"
+
+// C++
+#include <vector>
+#include <string>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Packs ImageData into the layers (pages) of an array texture at runtime, so
+ * many small images can be drawn with a single texture and batch together.
+ * Each added image gets a Quad with its page as the layer, which can be used
+ * with the array texture anywhere a Quad is accepted, or with the texture view
+ * of its page where a 2D texture is needed.
+ **/
+class Atlas : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	struct Settings
+	{
+		int width = 2048;
+		int height = 2048;
+		int pages = 1;
+		PixelFormat format = PIXELFORMAT_RGBA8_UNORM;
+		bool mipmaps = false;
+		bool linear = false;
+		// Edge pixels of each image are repeated into this many pixels around
+		// it, so filtering doesn't bleed in neighbouring images.
+		int padding = 1;
+		std::string debugName;
+	};
+
+	// Images are placed at multiples of this many pixels when the atlas has
+	// mipmaps, so that the smaller mipmap levels don't mix neighbouring images
+	// (up to this level: log2(MIPMAP_ALIGNMENT)).
+	static const int MIPMAP_ALIGNMENT = 16;
+
+	Atlas(Graphics *gfx, const Settings &settings);
+	virtual ~Atlas();
+
+	/**
+	 * Packs and uploads the image, and returns a new Quad for it. Mipmaps are
+	 * only regenerated if updatemipmaps is true, so adding many images can do
+	 * it once at the end with generateMipmaps().
+	 **/
+	Quad *add(love::image::ImageData *data, bool updatemipmaps = true);
+
+	void generateMipmaps();
+
+	Texture *getTexture() const { return texture; }
+
+	/**
+	 * A 2D view of a single page, for things that don't support array
+	 * textures.
+	 **/
+	Texture *getPageTexture(int page);
+
+	int getPageCount() const { return (int) pages.size(); }
+	int getImageCount() const { return imageCount; }
+
+	const Settings &getSettings() const { return settings; }
+
+private:
+
+	Graphics *gfx;
+	Settings settings;
+
+	StrongRef<Texture> texture;
+
+	std::vector<SkylinePacker> pages;
+	std::vector<StrongRef<Texture>> pageViews;
+
+	int alignment;
+	int imageCount;
+
+}; // Atlas
+
+} // graphics
+} // love
@@ -31,6 +31,7 @@ love::Type Buffer::type("GraphicsBuffer", &Object::type);
 
 int Buffer::bufferCount = 0;
 int64 Buffer::totalGraphicsMemory = 0;
+int64 Buffer::frameBytesUploaded = 0;
 
 Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDeclaration> &bufferformat, size_t size, size_t arraylength)
 	: arrayLength(0)
@@ -54,6 +55,7 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 	bool indexbuffer = usageFlags & BUFFERUSAGEFLAG_INDEX;
 	bool vertexbuffer = usageFlags & BUFFERUSAGEFLAG_VERTEX;
 	bool texelbuffer = usageFlags & BUFFERUSAGEFLAG_TEXEL;
+	bool uniformbuffer = usageFlags & BUFFERUSAGEFLAG_UNIFORM;
 	bool storagebuffer = usageFlags & BUFFERUSAGEFLAG_SHADER_STORAGE;
 	bool indirectbuffer = usageFlags & BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS;
 
@@ -69,8 +71,8 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 	if (indirectbuffer && !caps.features[Graphics::FEATURE_INDIRECT_DRAW])
 		throw love::Exception("Indirect argument buffers are not supported on this system.");
 
-	if (dataUsage == BUFFERDATAUSAGE_READBACK && (indexbuffer || vertexbuffer || texelbuffer || storagebuffer || indirectbuffer))
-		throw love::Exception("Buffers created with 'readback' data usage cannot be index, vertex, texel, shaderstorage, or indirectarguments buffer types.");
+	if (dataUsage == BUFFERDATAUSAGE_READBACK && (indexbuffer || vertexbuffer || texelbuffer || uniformbuffer || storagebuffer || indirectbuffer))
+		throw love::Exception("Buffers created with 'readback' data usage cannot be index, vertex, texel, uniform, shaderstorage, or indirectarguments buffer types.");
 
 	size_t offset = 0;
 	size_t stride = 0;
@@ -190,6 +192,39 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 					member.decl.name.c_str(), memberoffset, offset);
 		}
 
+		// Uniform buffers are treated as a structure (or an array of them)
+		// which matches a uniform block declared with the std140 layout.
+		if (uniformbuffer)
+		{
+			if (decl.arrayLength > 0)
+				throw love::Exception("Arrays are not currently supported in uniform buffers.");
+
+			if (info.baseType == DATA_BASETYPE_BOOL)
+				throw love::Exception("Bool types are not supported in uniform buffers.");
+
+			if (info.baseType == DATA_BASETYPE_UNORM || info.baseType == DATA_BASETYPE_SNORM)
+				throw love::Exception("Normalized formats are not supported in uniform buffers.");
+
+			// std140 rounds the stride of matrix columns up to that of a vec4,
+			// which would need padding that the Buffer's format can't express.
+			if (info.componentSize != 4 || (info.isMatrix && info.matrixRows != 4))
+			{
+				const char *fstr = "unknown";
+				getConstant(decl.format, fstr);
+				throw love::Exception("Data format %s is not currently supported in uniform buffers.", fstr);
+			}
+
+			// Same base alignment rules as std430 for the formats allowed here.
+			int c = info.isMatrix ? info.matrixRows : info.components;
+			size_t alignment = c == 3 ? 4 * info.componentSize : c * info.componentSize;
+
+			memberoffset = alignUp(memberoffset, alignment);
+
+			if (memberoffset != offset && (indexbuffer || vertexbuffer || texelbuffer))
+				throw love::Exception("Cannot create Buffer:\nInternal alignment of member '%s' is preventing Buffer from being created as both a uniform buffer and other buffer types\nMember byte offset needed for uniform buffer: %d\nMember byte offset needed for other buffer types: %d",
+					member.decl.name.c_str(), memberoffset, offset);
+		}
+
 		if (indirectbuffer)
 		{
 			if (info.isMatrix || info.components != 1
@@ -210,6 +245,18 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 		dataMembers.push_back(member);
 	}
 
+	if (uniformbuffer)
+	{
+		// "the structure may have padding at the end; the base offset of the
+		// member following the sub-structure is rounded up to the next multiple
+		// of the base alignment of the structure", which is a vec4's in std140.
+		if (storagebuffer && alignUp(offset, structurealignment) != alignUp(offset, 16))
+			throw love::Exception("Cannot create Buffer:\nBuffer used as a uniform buffer would have a different number of bytes per array element (%d) than when used as a shader storage buffer (%d)",
+				alignUp(offset, 16), alignUp(offset, structurealignment));
+
+		structurealignment = std::max(structurealignment, (size_t) 16);
+	}
+
 	stride = alignUp(offset, structurealignment);
 
 	if (storagebuffer && (indexbuffer || vertexbuffer || texelbuffer))
@@ -219,6 +266,13 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 				stride, offset);
 	}
 
+	if (uniformbuffer && (indexbuffer || vertexbuffer || texelbuffer))
+	{
+		if (stride != offset)
+			throw love::Exception("Cannot create Buffer:\nBuffer used as a uniform buffer would have a different number of bytes per array element (%d) than when used as other buffer types (%d)",
+				stride, offset);
+	}
+
 	if (storagebuffer && stride > SHADER_STORAGE_BUFFER_MAX_STRIDE)
 		throw love::Exception("Shader storage buffers cannot have more than %d bytes within each array element.", SHADER_STORAGE_BUFFER_MAX_STRIDE);
 
@@ -238,6 +292,9 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 	this->arrayLength = arraylength;
 	this->size = size;
 
+	if (uniformbuffer && size > UNIFORM_BUFFER_MAX_SIZE)
+		throw love::Exception("Uniform buffers cannot be larger than %d bytes.", (int) UNIFORM_BUFFER_MAX_SIZE);
+
 	if (texelbuffer && arraylength * dataMembers.size() > caps.limits[Graphics::LIMIT_TEXEL_BUFFER_SIZE])
 		throw love::Exception("Cannot create texel buffer: total number of values in the buffer (%d * %d) is too large for this system (maximum %d).",
 			(int) dataMembers.size(), (int) arraylength, caps.limits[Graphics::LIMIT_TEXEL_BUFFER_SIZE]);
@@ -274,11 +331,40 @@ int Buffer::getDataMemberIndex(int bindingLocation) const
 	return -1;
 }
 
+void *Buffer::mapWrite(size_t offset, size_t size)
+{
+	if (writeMapped || isMapped())
+		throw love::Exception("Buffer is already mapped.");
+	else if (isImmutable())
+		throw love::Exception("Cannot map an immutable Buffer.");
+	else if (dataUsage == BUFFERDATAUSAGE_READBACK)
+		throw love::Exception("Cannot map a Buffer with readback data usage for writing.");
+	else if (size == 0 || !Range(0, getSize()).contains(Range(offset, size)))
+		throw love::Exception("The given range is not within the Buffer's size.");
+
+	void *data = map(MAP_WRITE_INVALIDATE, offset, size);
+	if (data == nullptr)
+		throw love::Exception("Could not map Buffer.");
+
+	writeMapped = true;
+	writeMappedRange = Range(offset, size);
+	return data;
+}
+
+void Buffer::unmapWrite()
+{
+	if (!writeMapped)
+		return;
+
+	writeMapped = false;
+	unmap(writeMappedRange.getOffset(), writeMappedRange.getSize());
+}
+
 void Buffer::clear(size_t offset, size_t size)
 {
 	if (isImmutable())
 		throw love::Exception("Cannot clear an immutable Buffer.");
-	else if (isMapped())
+	else if (isMapped() || writeMapped)
 		throw love::Exception("Cannot clear a mapped Buffer.");
 	else if (offset + size > getSize())
 		throw love::Exception("The given offset and size parameters to clear() are not within the Buffer's size.");
@@ -25,6 +25,7 @@
 #include "common/int.h"
 #include "common/Object.h"
 #include "common/Optional.h"
+#include "common/Range.h"
 #include "vertex.h"
 #include "Resource.h"
 
@@ -52,7 +53,15 @@ public:
 	static int bufferCount;
 	static int64 totalGraphicsMemory;
 
+	// Bytes uploaded via fill() since the last present.
+	static int64 frameBytesUploaded;
+
 	static const size_t SHADER_STORAGE_BUFFER_MAX_STRIDE = 2048;
+	static const size_t UNIFORM_BUFFER_MAX_SIZE = 16384;
+
+	// Modified regions of CPU-side copies closer together than this are
+	// uploaded with a single fill, since each separate upload has a cost.
+	static const size_t FILL_MERGE_DISTANCE = 1024;
 
 	enum MapType
 	{
@@ -136,6 +145,15 @@ public:
 	 */
 	virtual void unmap(size_t usedoffset, size_t usedsize) = 0;
 
+	/**
+	 * Maps a range of the Buffer for writing, for Buffer:map in Lua. Unlike
+	 * map(), this throws on failure. The written data is uploaded by
+	 * unmapWrite, and the previous contents of the range aren't kept.
+	 **/
+	void *mapWrite(size_t offset, size_t size);
+	void unmapWrite();
+	bool isWriteMapped() const { return writeMapped; }
+
 	/**
 	 * Fill a portion of the buffer with data.
 	 */
@@ -204,6 +222,9 @@ protected:
 	MapType mappedType;
 	bool immutable;
 
+	bool writeMapped = false;
+	Range writeMappedRange;
+
 	bool legacyVertexBindings = false;
 	
 }; // Buffer
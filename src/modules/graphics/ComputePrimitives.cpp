@@ -0,0 +1,585 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ComputePrimitives.h"
+#include "Graphics.h"
+#include "Shader.h"
+#include "Buffer.h"
+#include "common/math.h"
+
+// C++
+#include <algorithm>
+#include <memory>
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+namespace
+{
+
+// Each scan threadgroup scans two values per thread.
+static const uint32 SCAN_BLOCK_SIZE = 512;
+
+// Each sort and compaction threadgroup handles one value per thread.
+static const uint32 SORT_BLOCK_SIZE = 256;
+static const uint32 COMPACT_BLOCK_SIZE = 256;
+
+static const uint32 SORT_DIGIT_BITS = 4;
+
+// Work-efficient (Blelloch) scan of a 512 value block in shared memory. The
+// total of each block is written out so a second level can offset them.
+static const char scanBlocksCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 256) in;
+
+buffer love_ScanInput { uint love_ScanIn[]; };
+buffer love_ScanOutput { uint love_ScanOut[]; };
+writeonly buffer love_ScanBlockSums { uint love_ScanSums[]; };
+
+uniform uvec4 love_ScanParams; // x: count, y: count nonzero values as 1, z: write block sums
+
+shared uint scanValues[512];
+
+uint loadValue(uint index)
+{
+	if (index >= love_ScanParams.x)
+		return 0u;
+
+	uint v = love_ScanIn[index];
+	return love_ScanParams.y != 0u ? min(v, 1u) : v;
+}
+
+void computemain()
+{
+	uint local = love_LocalThreadID.x;
+	uint base = love_ThreadGroupID.x * 512u;
+
+	scanValues[local] = loadValue(base + local);
+	scanValues[local + 256u] = loadValue(base + local + 256u);
+
+	uint offset = 1u;
+	for (uint d = 256u; d > 0u; d >>= 1u)
+	{
+		memoryBarrierShared();
+		barrier();
+
+		if (local < d)
+		{
+			uint a = offset * (2u * local + 1u) - 1u;
+			uint b = offset * (2u * local + 2u) - 1u;
+			scanValues[b] += scanValues[a];
+		}
+
+		offset <<= 1u;
+	}
+
+	memoryBarrierShared();
+	barrier();
+
+	if (local == 0u)
+	{
+		if (love_ScanParams.z != 0u)
+			love_ScanSums[love_ThreadGroupID.x] = scanValues[511];
+		scanValues[511] = 0u;
+	}
+
+	for (uint d = 1u; d < 512u; d <<= 1u)
+	{
+		offset >>= 1u;
+
+		memoryBarrierShared();
+		barrier();
+
+		if (local < d)
+		{
+			uint a = offset * (2u * local + 1u) - 1u;
+			uint b = offset * (2u * local + 2u) - 1u;
+			uint t = scanValues[a];
+			scanValues[a] = scanValues[b];
+			scanValues[b] += t;
+		}
+	}
+
+	memoryBarrierShared();
+	barrier();
+
+	if (base + local < love_ScanParams.x)
+		love_ScanOut[base + local] = scanValues[local];
+	if (base + local + 256u < love_ScanParams.x)
+		love_ScanOut[base + local + 256u] = scanValues[local + 256u];
+}
+)";
+
+static const char scanAddCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 256) in;
+
+buffer love_ScanOutput { uint love_ScanOut[]; };
+readonly buffer love_ScanBlockSums { uint love_ScanSums[]; };
+
+uniform uvec4 love_ScanParams; // x: count
+
+void computemain()
+{
+	uint offset = love_ScanSums[love_ThreadGroupID.x];
+	uint index = love_ThreadGroupID.x * 512u + love_LocalThreadID.x;
+
+	if (index < love_ScanParams.x)
+		love_ScanOut[index] += offset;
+	if (index + 256u < love_ScanParams.x)
+		love_ScanOut[index + 256u] += offset;
+}
+)";
+
+// Counts each block's 4 bit digits. The counts are stored digit-major so a
+// scan over the whole histogram gives every block's output offset per digit.
+static const char sortHistogramCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 256) in;
+
+readonly buffer love_SortKeys { uint love_SortKeysIn[]; };
+writeonly buffer love_SortHistogram { uint love_SortCounts[]; };
+
+uniform uvec4 love_SortParams; // x: count, y: digit shift, z: block count
+
+shared uint digitCounts[16];
+
+void computemain()
+{
+	uint local = love_LocalThreadID.x;
+	uint block = love_ThreadGroupID.x;
+	uint index = block * 256u + local;
+
+	if (local < 16u)
+		digitCounts[local] = 0u;
+
+	memoryBarrierShared();
+	barrier();
+
+	if (index < love_SortParams.x)
+		atomicAdd(digitCounts[(love_SortKeysIn[index] >> love_SortParams.y) & 15u], 1u);
+
+	memoryBarrierShared();
+	barrier();
+
+	if (local < 16u)
+		love_SortCounts[local * love_SortParams.z + block] = digitCounts[local];
+}
+)";
+
+// Sorts each block by digit in shared memory with four stable one bit splits,
+// then scatters the keys (and values) to the offsets from the scanned
+// histogram plus their rank within the block.
+static const char sortScatterCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 256) in;
+
+readonly buffer love_SortKeys { uint love_SortKeysIn[]; };
+readonly buffer love_SortValues { uint love_SortValuesIn[]; };
+writeonly buffer love_SortKeysOutput { uint love_SortKeysOut[]; };
+writeonly buffer love_SortValuesOutput { uint love_SortValuesOut[]; };
+readonly buffer love_SortHistogram { uint love_SortOffsets[]; };
+
+uniform uvec4 love_SortParams; // x: count, y: digit shift, z: block count, w: sort values
+
+shared uint sortKeys[256];
+shared uint sortSources[256];
+shared uint sortScan[256];
+shared uint digitStarts[16];
+
+uint getDigit(uint key, uint source)
+{
+	// Values past the end sort last. They're already at the end of the block,
+	// so the stable splits keep them after any real digit 15 values.
+	if (source >= love_SortParams.x)
+		return 15u;
+	return (key >> love_SortParams.y) & 15u;
+}
+
+void computemain()
+{
+	uint local = love_LocalThreadID.x;
+	uint block = love_ThreadGroupID.x;
+	uint base = block * 256u;
+
+	uint source = base + local;
+	uint key = source < love_SortParams.x ? love_SortKeysIn[source] : 0u;
+
+	for (uint bit = 0u; bit < 4u; bit++)
+	{
+		uint digit = getDigit(key, source);
+		uint zero = ((digit >> bit) & 1u) ^ 1u;
+
+		sortScan[local] = zero;
+
+		for (uint o = 1u; o < 256u; o <<= 1u)
+		{
+			memoryBarrierShared();
+			barrier();
+
+			uint t = local >= o ? sortScan[local - o] : 0u;
+
+			memoryBarrierShared();
+			barrier();
+
+			sortScan[local] += t;
+		}
+
+		memoryBarrierShared();
+		barrier();
+
+		uint zerosBefore = sortScan[local] - zero;
+		uint totalZeros = sortScan[255];
+		uint dest = zero != 0u ? zerosBefore : totalZeros + local - zerosBefore;
+
+		sortKeys[dest] = key;
+		sortSources[dest] = source;
+
+		memoryBarrierShared();
+		barrier();
+
+		key = sortKeys[local];
+		source = sortSources[local];
+
+		memoryBarrierShared();
+		barrier();
+	}
+
+	uint digit = getDigit(key, source);
+
+	sortScan[local] = digit;
+
+	memoryBarrierShared();
+	barrier();
+
+	if (local == 0u || sortScan[local - 1u] != digit)
+		digitStarts[digit] = local;
+
+	memoryBarrierShared();
+	barrier();
+
+	if (source >= love_SortParams.x)
+		return;
+
+	uint dest = love_SortOffsets[digit * love_SortParams.z + block] + local - digitStarts[digit];
+
+	love_SortKeysOut[dest] = key;
+	if (love_SortParams.w != 0u)
+		love_SortValuesOut[dest] = love_SortValuesIn[source];
+}
+)";
+
+static const char compactCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 256) in;
+
+readonly buffer love_CompactFlags { uint love_CompactFlagValues[]; };
+readonly buffer love_CompactOffsets { uint love_CompactOffsetValues[]; };
+readonly buffer love_CompactInput { uint love_CompactIn[]; };
+writeonly buffer love_CompactOutput { uint love_CompactOut[]; };
+writeonly buffer love_CompactCount { uint love_CompactCountValue[]; };
+
+uniform uvec4 love_CompactParams; // x: count, y: copy from the input buffer
+
+void computemain()
+{
+	uint index = love_GlobalThreadID.x;
+	uint count = love_CompactParams.x;
+
+	if (index >= count)
+		return;
+
+	bool keep = love_CompactFlagValues[index] != 0u;
+	uint offset = love_CompactOffsetValues[index];
+
+	if (keep)
+		love_CompactOut[offset] = love_CompactParams.y != 0u ? love_CompactIn[index] : index;
+
+	if (index == count - 1u)
+		love_CompactCountValue[0] = offset + (keep ? 1u : 0u);
+}
+)";
+
+enum ComputeShader
+{
+	COMPUTE_SHADER_SCAN_BLOCKS,
+	COMPUTE_SHADER_SCAN_ADD,
+	COMPUTE_SHADER_SORT_HISTOGRAM,
+	COMPUTE_SHADER_SORT_SCATTER,
+	COMPUTE_SHADER_COMPACT,
+	COMPUTE_SHADER_MAX_ENUM
+};
+
+Shader *computeShaders[COMPUTE_SHADER_MAX_ENUM] = {};
+
+Shader *getComputeShader(Graphics *gfx, ComputeShader type)
+{
+	if (computeShaders[type] == nullptr)
+	{
+		static const char *code[COMPUTE_SHADER_MAX_ENUM] =
+		{
+			scanBlocksCode,
+			scanAddCode,
+			sortHistogramCode,
+			sortScatterCode,
+			compactCode,
+		};
+
+		Shader::CompileOptions options;
+		options.debugName = "ComputePrimitives";
+
+		computeShaders[type] = gfx->newComputeShader(code[type], options);
+	}
+
+	return computeShaders[type];
+}
+
+void sendComputeParams(Shader *shader, const char *name, uint32 x, uint32 y = 0, uint32 z = 0, uint32 w = 0)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr)
+		return;
+
+	uint32 params[4] = {x, y, z, w};
+	memcpy(info->data, params, std::min(sizeof(params), info->dataSize));
+	shader->updateUniform(info, info->count);
+}
+
+void sendComputeBuffer(Shader *shader, const char *name, Buffer *buffer)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info != nullptr)
+		shader->sendBuffers(info, &buffer, 1);
+}
+
+// Scratch space from Graphics' temporary buffer pool, returned when it goes
+// out of scope.
+struct ScratchBuffer
+{
+	ScratchBuffer(Graphics *gfx, uint32 count)
+		: gfx(gfx)
+	{
+		// Rounded up so calls with similar counts can share pooled buffers.
+		size_t size = sizeof(uint32) * (size_t) nextP2((int) std::max(count, 1u));
+		buffer = gfx->getTemporaryBuffer(size, DATAFORMAT_UINT32, BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+	}
+
+	~ScratchBuffer()
+	{
+		gfx->releaseTemporaryBuffer(buffer);
+	}
+
+	Graphics *gfx;
+	Buffer *buffer;
+};
+
+void checkValueBuffer(Buffer *buffer, const char *name, int count, bool writable)
+{
+	if ((buffer->getUsageFlags() & BUFFERUSAGEFLAG_SHADER_STORAGE) == 0)
+		throw love::Exception("The %s Buffer must be created with the shaderstorage usage flag set.", name);
+
+	DataFormat format = buffer->getDataMember(0).decl.format;
+
+	if (buffer->getDataMembers().size() != 1 || buffer->getArrayStride() != sizeof(uint32)
+		|| (format != DATAFORMAT_UINT32 && format != DATAFORMAT_INT32 && format != DATAFORMAT_FLOAT))
+	{
+		throw love::Exception("The %s Buffer must have a single uint32, int32 or float member.", name);
+	}
+
+	if ((size_t) count > buffer->getArrayLength())
+		throw love::Exception("The %s Buffer has %d elements, but %d are used.", name, (int) buffer->getArrayLength(), count);
+
+	if (writable && buffer->isImmutable())
+		throw love::Exception("The %s Buffer cannot be immutable.", name);
+}
+
+void checkCount(int count)
+{
+	if (count <= 0)
+		throw love::Exception("The number of values must be positive.");
+}
+
+void scan(Graphics *gfx, Buffer *source, Buffer *dest, uint32 count, bool binary)
+{
+	uint32 blocks = (count + SCAN_BLOCK_SIZE - 1) / SCAN_BLOCK_SIZE;
+
+	ScratchBuffer sums(gfx, blocks);
+
+	Shader *shader = getComputeShader(gfx, COMPUTE_SHADER_SCAN_BLOCKS);
+	sendComputeParams(shader, "love_ScanParams", count, binary ? 1 : 0, blocks > 1 ? 1 : 0);
+	sendComputeBuffer(shader, "love_ScanInput", source);
+	sendComputeBuffer(shader, "love_ScanOutput", dest);
+	sendComputeBuffer(shader, "love_ScanBlockSums", sums.buffer);
+	gfx->dispatchThreadgroups(shader, (int) blocks, 1, 1);
+
+	if (blocks > 1)
+	{
+		scan(gfx, sums.buffer, sums.buffer, blocks, false);
+
+		shader = getComputeShader(gfx, COMPUTE_SHADER_SCAN_ADD);
+		sendComputeParams(shader, "love_ScanParams", count);
+		sendComputeBuffer(shader, "love_ScanOutput", dest);
+		sendComputeBuffer(shader, "love_ScanBlockSums", sums.buffer);
+		gfx->dispatchThreadgroups(shader, (int) blocks, 1, 1);
+	}
+}
+
+} // anonymous namespace
+
+void ComputePrimitives::prefixSum(Graphics *gfx, Buffer *source, Buffer *dest, int count)
+{
+	checkCount(count);
+	checkValueBuffer(source, "source", count, false);
+	checkValueBuffer(dest, "destination", count, true);
+
+	scan(gfx, source, dest, (uint32) count, false);
+}
+
+void ComputePrimitives::radixSort(Graphics *gfx, Buffer *keys, Buffer *values, int count, int keybits)
+{
+	checkCount(count);
+	checkValueBuffer(keys, "keys", count, true);
+
+	if (keys->getDataMember(0).decl.format != DATAFORMAT_UINT32)
+		throw love::Exception("The keys Buffer must have a uint32 member.");
+
+	if (values != nullptr)
+	{
+		checkValueBuffer(values, "values", count, true);
+		if (values == keys)
+			throw love::Exception("The keys and values Buffers must be different.");
+	}
+
+	if (keybits < 1 || keybits > 32)
+		throw love::Exception("The number of key bits must be between 1 and 32.");
+
+	uint32 blocks = ((uint32) count + SORT_BLOCK_SIZE - 1) / SORT_BLOCK_SIZE;
+	uint32 passes = ((uint32) keybits + SORT_DIGIT_BITS - 1) / SORT_DIGIT_BITS;
+
+	ScratchBuffer histogram(gfx, blocks * 16);
+	ScratchBuffer scratchkeys(gfx, (uint32) count);
+
+	// Values ping-pong alongside the keys. Without them the key buffers are
+	// bound in their place, but never accessed.
+	std::unique_ptr<ScratchBuffer> scratchvalues;
+	if (values != nullptr)
+		scratchvalues.reset(new ScratchBuffer(gfx, (uint32) count));
+
+	Buffer *keybuffers[2] = {keys, scratchkeys.buffer};
+	Buffer *valuebuffers[2] = {values, scratchvalues ? scratchvalues->buffer : nullptr};
+
+	Shader *histogramshader = getComputeShader(gfx, COMPUTE_SHADER_SORT_HISTOGRAM);
+	Shader *scattershader = getComputeShader(gfx, COMPUTE_SHADER_SORT_SCATTER);
+
+	for (uint32 pass = 0; pass < passes; pass++)
+	{
+		Buffer *srckeys = keybuffers[pass % 2];
+		Buffer *dstkeys = keybuffers[(pass + 1) % 2];
+		Buffer *srcvalues = values != nullptr ? valuebuffers[pass % 2] : srckeys;
+		Buffer *dstvalues = values != nullptr ? valuebuffers[(pass + 1) % 2] : dstkeys;
+
+		uint32 shift = pass * SORT_DIGIT_BITS;
+
+		sendComputeParams(histogramshader, "love_SortParams", (uint32) count, shift, blocks);
+		sendComputeBuffer(histogramshader, "love_SortKeys", srckeys);
+		sendComputeBuffer(histogramshader, "love_SortHistogram", histogram.buffer);
+		gfx->dispatchThreadgroups(histogramshader, (int) blocks, 1, 1);
+
+		scan(gfx, histogram.buffer, histogram.buffer, blocks * 16, false);
+
+		sendComputeParams(scattershader, "love_SortParams", (uint32) count, shift, blocks, values != nullptr ? 1 : 0);
+		sendComputeBuffer(scattershader, "love_SortKeys", srckeys);
+		sendComputeBuffer(scattershader, "love_SortValues", srcvalues);
+		sendComputeBuffer(scattershader, "love_SortKeysOutput", dstkeys);
+		sendComputeBuffer(scattershader, "love_SortValuesOutput", dstvalues);
+		sendComputeBuffer(scattershader, "love_SortHistogram", histogram.buffer);
+		gfx->dispatchThreadgroups(scattershader, (int) blocks, 1, 1);
+	}
+
+	// An odd number of passes leaves the results in the scratch buffers.
+	if (passes % 2 == 1)
+	{
+		size_t size = sizeof(uint32) * (size_t) count;
+		gfx->copyBuffer(scratchkeys.buffer, keys, 0, 0, size);
+		if (values != nullptr)
+			gfx->copyBuffer(scratchvalues->buffer, values, 0, 0, size);
+	}
+}
+
+void ComputePrimitives::compact(Graphics *gfx, Buffer *flags, Buffer *source, Buffer *dest, int count, Buffer *countbuffer, int countindex)
+{
+	checkCount(count);
+	checkValueBuffer(flags, "flags", count, false);
+	if (source != nullptr)
+		checkValueBuffer(source, "source", count, false);
+	checkValueBuffer(dest, "destination", count, true);
+
+	if (dest == flags || dest == source)
+		throw love::Exception("The destination Buffer must be different from the flags and source Buffers.");
+
+	if (countbuffer != nullptr)
+	{
+		if (countindex < 0 || (size_t) (countindex + 1) * sizeof(uint32) > countbuffer->getSize())
+			throw love::Exception("The count index does not fit within the count Buffer's size.");
+		if (countbuffer->isImmutable())
+			throw love::Exception("The count Buffer cannot be immutable.");
+	}
+
+	ScratchBuffer offsets(gfx, (uint32) count);
+	ScratchBuffer total(gfx, 1);
+
+	scan(gfx, flags, offsets.buffer, (uint32) count, true);
+
+	Shader *shader = getComputeShader(gfx, COMPUTE_SHADER_COMPACT);
+	sendComputeParams(shader, "love_CompactParams", (uint32) count, source != nullptr ? 1 : 0);
+	sendComputeBuffer(shader, "love_CompactFlags", flags);
+	sendComputeBuffer(shader, "love_CompactOffsets", offsets.buffer);
+	sendComputeBuffer(shader, "love_CompactInput", source != nullptr ? source : flags);
+	sendComputeBuffer(shader, "love_CompactOutput", dest);
+	sendComputeBuffer(shader, "love_CompactCount", total.buffer);
+	gfx->dispatchThreadgroups(shader, (int) ((count + COMPACT_BLOCK_SIZE - 1) / COMPACT_BLOCK_SIZE), 1, 1);
+
+	// Indirect argument Buffers usually have several members per element, so
+	// the count is copied in rather than written by the shader.
+	if (countbuffer != nullptr)
+		gfx->copyBuffer(total.buffer, countbuffer, 0, sizeof(uint32) * countindex, sizeof(uint32));
+}
+
+void ComputePrimitives::releaseSharedResources()
+{
+	for (Shader *&shader : computeShaders)
+	{
+		if (shader != nullptr)
+			shader->release();
+		shader = nullptr;
+	}
+}
+
+} // graphics
+} // love
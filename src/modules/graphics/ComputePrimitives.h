@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+class Buffer;
+
+/**
+ * Built-in compute shader routines which operate on Buffers of 32 bit values
+ * (Buffers with a single int32, uint32 or float member), for GPU culling,
+ * sorting and histogramming without writing scan and sort kernels by hand.
+ *
+ * Everything runs as a sequence of dispatches on the GPU, so results are only
+ * visible to later GPU work or through a readback. Intermediate data lives in
+ * Graphics' temporary buffer pool.
+ **/
+class ComputePrimitives
+{
+public:
+
+	/**
+	 * Writes the exclusive prefix sum of the first count uint32 values of
+	 * source to dest. source and dest may be the same Buffer.
+	 **/
+	static void prefixSum(Graphics *gfx, Buffer *source, Buffer *dest, int count);
+
+	/**
+	 * Sorts the first count uint32 keys in ascending order, along with their
+	 * values if a values Buffer is given. The sort is stable and only looks at
+	 * the lowest keybits bits of each key.
+	 **/
+	static void radixSort(Graphics *gfx, Buffer *keys, Buffer *values, int count, int keybits);
+
+	/**
+	 * Writes the values of source whose flag is nonzero to the start of dest,
+	 * keeping their order. Without a source Buffer the indices of the flagged
+	 * values are written instead. The number of values written is stored as a
+	 * uint32 at countindex in countbuffer (for example the instance count of
+	 * an indirect draw), if one is given.
+	 **/
+	static void compact(Graphics *gfx, Buffer *flags, Buffer *source, Buffer *dest, int count, Buffer *countbuffer, int countindex);
+
+	static void releaseSharedResources();
+
+}; // ComputePrimitives
+
+} // graphics
+} // love
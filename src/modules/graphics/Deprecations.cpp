@@ -82,7 +82,7 @@ void Deprecations::draw(Graphics *gfx)
 		font.set(gfx->newDefaultFont(9, settings), Acquire::NORETAIN);
 	}
 
-	gfx->flushBatchedDraws();
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
 
 	gfx->push(Graphics::STACK_ALL);
 	gfx->reset();
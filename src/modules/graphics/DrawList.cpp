@@ -0,0 +1,260 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "DrawList.h"
+#include "Graphics.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type DrawList::type("DrawList", &Drawable::type);
+
+DrawList::DrawList(Graphics *gfx)
+	: gfx(gfx)
+	, totalVertexCount(0)
+{
+}
+
+DrawList::~DrawList()
+{
+}
+
+void DrawList::beginRecording()
+{
+	gfx->beginDrawListRecording(this);
+}
+
+void DrawList::endRecording()
+{
+	if (!isRecording())
+		throw love::Exception("This DrawList is not being recorded.");
+
+	gfx->endDrawListRecording();
+	bake();
+}
+
+bool DrawList::isRecording() const
+{
+	return gfx->getRecordingDrawList() == this;
+}
+
+void DrawList::clear()
+{
+	segments.clear();
+
+	for (int i = 0; i < 2; i++)
+	{
+		vertexData[i].clear();
+		vertexBuffers[i].set(nullptr);
+	}
+
+	indexData.clear();
+	indexBuffer.set(nullptr);
+
+	totalVertexCount = 0;
+}
+
+int DrawList::getDrawCallCount() const
+{
+	return (int) segments.size();
+}
+
+int DrawList::getVertexCount() const
+{
+	return totalVertexCount;
+}
+
+bool DrawList::canMerge(const Segment &s, const RecordedDraw &draw) const
+{
+	if (s.primitiveMode != draw.primitiveMode || s.formats[0] != draw.formats[0]
+		|| s.formats[1] != draw.formats[1] || s.texture.get() != draw.texture
+		|| s.shader.get() != draw.shader || s.standardShaderType != draw.standardShaderType)
+		return false;
+
+	if ((s.indexCount > 0) != (draw.indexCount > 0))
+		return false;
+
+	if (s.indexCount > 0)
+	{
+		// Indices are 16 bit, so the merged vertex range has to fit in that.
+		return s.vertexCount + draw.vertexCount <= LOVE_UINT16_MAX;
+	}
+
+	// Strips can't be concatenated without extra degenerate geometry.
+	return draw.primitiveMode != PRIMITIVE_TRIANGLE_STRIP && draw.primitiveMode != PRIMITIVE_TRIANGLE_FAN;
+}
+
+void DrawList::addDraw(const RecordedDraw &draw)
+{
+	if (draw.vertexCount <= 0)
+		return;
+
+	int basevertex = 0;
+
+	if (!segments.empty() && canMerge(segments.back(), draw))
+	{
+		Segment &s = segments.back();
+		basevertex = s.vertexCount;
+		s.vertexCount += draw.vertexCount;
+		s.indexCount += draw.indexCount;
+	}
+	else
+	{
+		Segment s;
+		s.primitiveMode = draw.primitiveMode;
+		s.texture.set(draw.texture);
+		s.shader.set(draw.shader);
+		s.standardShaderType = draw.standardShaderType;
+		s.vertexCount = draw.vertexCount;
+
+		for (int i = 0; i < 2; i++)
+		{
+			s.formats[i] = draw.formats[i];
+			s.vertexOffsets[i] = vertexData[i].size();
+		}
+
+		// Some backends need index buffer offsets to be aligned to 4 bytes.
+		if (indexData.size() % 2 != 0)
+			indexData.push_back(0);
+
+		s.indexStart = indexData.size();
+		s.indexCount = draw.indexCount;
+
+		VertexAttributes attributes;
+		for (int i = 0; i < 2; i++)
+			attributes.setCommonFormat(s.formats[i], (uint8) i);
+		s.attributesID = gfx->registerVertexAttributes(attributes);
+
+		segments.push_back(s);
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (draw.formats[i] == CommonFormat::NONE)
+			continue;
+
+		const uint8 *data = (const uint8 *) draw.vertexData[i];
+		size_t size = getFormatStride(draw.formats[i]) * draw.vertexCount;
+		vertexData[i].insert(vertexData[i].end(), data, data + size);
+	}
+
+	for (int i = 0; i < draw.indexCount; i++)
+		indexData.push_back((uint16) (draw.indexData[i] + basevertex));
+
+	totalVertexCount += draw.vertexCount;
+}
+
+void DrawList::bake()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		vertexBuffers[i].set(nullptr);
+
+		if (vertexData[i].empty())
+			continue;
+
+		// Every batched vertex format has a stride which is a multiple of 4.
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		settings.debugName = "DrawList vertices";
+		vertexBuffers[i].set(gfx->newBuffer(settings, DATAFORMAT_FLOAT, vertexData[i].data(), vertexData[i].size(), 0), Acquire::NORETAIN);
+
+		std::vector<uint8>().swap(vertexData[i]);
+	}
+
+	indexBuffer.set(nullptr);
+
+	if (!indexData.empty())
+	{
+		if (indexData.size() % 2 != 0)
+			indexData.push_back(0);
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_INDEX, BUFFERDATAUSAGE_STATIC);
+		settings.debugName = "DrawList indices";
+		indexBuffer.set(gfx->newBuffer(settings, DATAFORMAT_UINT16, indexData.data(), indexData.size() * sizeof(uint16), 0), Acquire::NORETAIN);
+
+		std::vector<uint16>().swap(indexData);
+	}
+}
+
+void DrawList::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("DrawLists cannot be drawn while a DrawList is being recorded.");
+
+	if (segments.empty())
+		return;
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	for (const Segment &s : segments)
+	{
+		if (s.shader.get() != nullptr)
+			s.shader->attach();
+		else
+			Shader::attachDefault(s.standardShaderType);
+
+		if (Shader::current)
+			Shader::current->validateDrawState(s.primitiveMode, s.texture);
+
+		BufferBindings buffers;
+		for (int i = 0; i < 2; i++)
+		{
+			if (s.formats[i] != CommonFormat::NONE)
+				buffers.set(i, vertexBuffers[i], s.vertexOffsets[i]);
+		}
+
+		if (s.indexCount > 0)
+		{
+			Graphics::DrawIndexedCommand cmd(s.attributesID, &buffers, indexBuffer);
+			cmd.primitiveType = s.primitiveMode;
+			cmd.indexCount = s.indexCount;
+			cmd.indexType = INDEX_UINT16;
+			cmd.indexBufferOffset = s.indexStart * sizeof(uint16);
+			cmd.texture = gfx->getTextureOrDefaultForActiveShader(s.texture);
+			gfx->draw(cmd);
+		}
+		else
+		{
+			Graphics::DrawCommand cmd(s.attributesID, &buffers);
+			cmd.primitiveType = s.primitiveMode;
+			cmd.vertexStart = 0;
+			cmd.vertexCount = s.vertexCount;
+			cmd.texture = gfx->getTextureOrDefaultForActiveShader(s.texture);
+			gfx->draw(cmd);
+		}
+	}
+
+	Shader *prevshader = gfx->getShader();
+	if (prevshader != nullptr)
+		prevshader->attach();
+	else
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "common/Matrix.h"
+#include "Drawable.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "Buffer.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Records the batched geometry produced by regular draw calls (shapes,
+ * textures, quads, text, etc.) between beginRecording and endRecording, and
+ * keeps it in static GPU Buffers so it can be replayed later with a single
+ * draw, without regenerating or re-uploading any vertices.
+ *
+ * Vertices are stored after being transformed by the transform stack and
+ * multiplied by the current color at recording time. Replaying a DrawList
+ * applies the current transform and color on top of that. Consecutive draws
+ * which share a texture, shader and vertex format are merged.
+ **/
+class DrawList : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	struct RecordedDraw
+	{
+		PrimitiveType primitiveMode;
+		CommonFormat formats[2];
+		Texture *texture;
+		Shader *shader; // nullptr when a standard shader is active.
+		Shader::StandardShader standardShaderType;
+		const void *vertexData[2];
+		int vertexCount;
+		const uint16 *indexData;
+		int indexCount;
+	};
+
+	DrawList(Graphics *gfx);
+	virtual ~DrawList();
+
+	// Drawable
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+	void beginRecording();
+	void endRecording();
+	bool isRecording() const;
+
+	void clear();
+
+	int getDrawCallCount() const;
+	int getVertexCount() const;
+
+	// Called by Graphics when batched draws are flushed while recording.
+	void addDraw(const RecordedDraw &draw);
+
+private:
+
+	struct Segment
+	{
+		PrimitiveType primitiveMode;
+		CommonFormat formats[2];
+		StrongRef<Texture> texture;
+		StrongRef<Shader> shader;
+		Shader::StandardShader standardShaderType;
+		VertexAttributesID attributesID;
+
+		size_t vertexOffsets[2];
+		int vertexCount;
+
+		size_t indexStart;
+		int indexCount;
+	};
+
+	bool canMerge(const Segment &s, const RecordedDraw &draw) const;
+	void bake();
+
+	Graphics *gfx;
+
+	std::vector<Segment> segments;
+
+	// Only used while recording, freed once the data is in the Buffers.
+	std::vector<uint8> vertexData[2];
+	std::vector<uint16> indexData;
+
+	StrongRef<Buffer> vertexBuffers[2];
+	StrongRef<Buffer> indexBuffer;
+
+	int totalVertexCount;
+
+}; // DrawList
+
+} // graphics
+} // love
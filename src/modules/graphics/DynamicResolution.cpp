@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "DynamicResolution.h"
+#include "Graphics.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "timer/Timer.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace love
+{
+namespace graphics
+{
+
+static const char GPU_TIMER_NAME[] = "DynamicResolution";
+
+// The scale used for rendering is rounded to a multiple of this, so small
+// adjustments don't create a new canvas every frame.
+static const float SCALE_STEP = 1.0f / 32.0f;
+
+// Without GPU timestamps, frame intervals can't go below the display's
+// refresh interval when vsync is on, so frames which fit in the budget raise
+// the scale by this much to find out whether there's headroom.
+static const float PROBE_STEP = 1.0f / 64.0f;
+
+static const char sharpenShaderCode[] = R"(
+#pragma language glsl3
+
+uniform float love_DynamicResolutionSharpness;
+
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	vec2 texel = 1.0 / vec2(textureSize(tex, 0));
+
+	vec4 c = Texel(tex, texcoord);
+	vec4 n = Texel(tex, texcoord + vec2(0.0, -texel.y))
+		+ Texel(tex, texcoord + vec2(0.0, texel.y))
+		+ Texel(tex, texcoord + vec2(-texel.x, 0.0))
+		+ Texel(tex, texcoord + vec2(texel.x, 0.0));
+
+	// Unsharp mask using the source's immediate neighbours.
+	vec4 sharpened = c + (c * 4.0 - n) * (love_DynamicResolutionSharpness * 0.25);
+	return clamp(sharpened, 0.0, 1.0) * vcolor;
+}
+)";
+
+love::Type DynamicResolution::type("DynamicResolution", &Object::type);
+
+DynamicResolution::DynamicResolution(Graphics *gfx, const Settings &settings)
+	: gfx(gfx)
+	, settings(settings)
+	, canvas(nullptr)
+	, scale(1.0f)
+	, lastFrameTime(0.0)
+	, lastBeginTime(-1.0)
+	, renderWidth(0)
+	, renderHeight(0)
+	, gpuTimed(false)
+	, inFrame(false)
+{
+	setScaleRange(settings.minScale, settings.maxScale);
+	setTargetFrameTime(settings.targetFrameTime);
+	setSharpness(settings.sharpness);
+
+	scale = this->settings.maxScale;
+}
+
+DynamicResolution::~DynamicResolution()
+{
+	if (canvas != nullptr)
+		gfx->releaseTemporaryTexture(canvas);
+}
+
+void DynamicResolution::setScale(float s)
+{
+	scale = std::min(std::max(s, settings.minScale), settings.maxScale);
+}
+
+void DynamicResolution::setScaleRange(float minscale, float maxscale)
+{
+	if (minscale <= 0.0f || maxscale <= 0.0f)
+		throw love::Exception("Dynamic resolution scales must be greater than 0.");
+
+	if (minscale > maxscale)
+		throw love::Exception("The minimum dynamic resolution scale must not be greater than the maximum.");
+
+	if (maxscale > 2.0f)
+		throw love::Exception("The maximum dynamic resolution scale must not be greater than 2.");
+
+	settings.minScale = minscale;
+	settings.maxScale = maxscale;
+
+	setScale(scale);
+}
+
+void DynamicResolution::getScaleRange(float &minscale, float &maxscale) const
+{
+	minscale = settings.minScale;
+	maxscale = settings.maxScale;
+}
+
+void DynamicResolution::setTargetFrameTime(double seconds)
+{
+	if (!(seconds > 0.0))
+		throw love::Exception("The target frame time must be greater than 0.");
+
+	settings.targetFrameTime = seconds;
+}
+
+void DynamicResolution::setSharpness(float sharpness)
+{
+	settings.sharpness = std::min(std::max(sharpness, 0.0f), 1.0f);
+}
+
+void DynamicResolution::getRenderDimensions(int &w, int &h) const
+{
+	w = renderWidth;
+	h = renderHeight;
+}
+
+void DynamicResolution::updateScale(double frametime)
+{
+	if (!(frametime > 0.0))
+		return;
+
+	lastFrameTime = frametime;
+
+	// The cost of a frame is mostly proportional to its pixel count, which
+	// goes with the square of the scale.
+	double desired = scale * std::sqrt(settings.targetFrameTime / frametime);
+
+	if (!gpuTimed && frametime <= settings.targetFrameTime * 1.05)
+		desired = std::max(desired, (double) (scale + PROBE_STEP));
+
+	// Drop quickly when over budget, and come back up slowly so a single fast
+	// frame doesn't cause a visible jump. GPU timings also arrive a few
+	// frames late, which a slow approach keeps from overshooting.
+	double rate = desired < scale ? 0.5 : 0.1;
+
+	setScale((float) (scale + (desired - scale) * rate));
+}
+
+Shader *DynamicResolution::getSharpenShader()
+{
+	if (sharpenShader.get() == nullptr)
+	{
+		Shader::CompileOptions options;
+		options.debugName = "DynamicResolution sharpen";
+
+		std::vector<std::string> stages = {sharpenShaderCode};
+		sharpenShader.set(gfx->newShader(stages, options), Acquire::NORETAIN);
+	}
+
+	return sharpenShader;
+}
+
+void DynamicResolution::beginFrame()
+{
+	if (inFrame)
+		throw love::Exception("DynamicResolution:beginFrame cannot be called twice without endFrame.");
+
+	if (gfx->isRenderTargetActive())
+		throw love::Exception("DynamicResolution:beginFrame must be called while rendering to the screen.");
+
+	gpuTimed = gfx->getCapabilities().features[Graphics::FEATURE_GPU_TIMESTAMPS];
+
+	double now = love::timer::Timer::getTime();
+
+	if (gpuTimed)
+	{
+		for (const auto &timing : gfx->getGPUTimings())
+		{
+			if (timing.name == GPU_TIMER_NAME)
+			{
+				updateScale(timing.time);
+				break;
+			}
+		}
+	}
+	else if (lastBeginTime >= 0.0)
+		updateScale(now - lastBeginTime);
+
+	lastBeginTime = now;
+
+	float renderscale = std::max(std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP, SCALE_STEP);
+
+	renderWidth = std::max((int) (gfx->getPixelWidth() * renderscale + 0.5f), 1);
+	renderHeight = std::max((int) (gfx->getPixelHeight() * renderscale + 0.5f), 1);
+
+	PixelFormat format = gfx->getSizedFormat(PIXELFORMAT_NORMAL);
+	canvas = gfx->getTemporaryTexture(format, renderWidth, renderHeight, 1);
+
+	if (gpuTimed)
+		gfx->pushGPUTimer(GPU_TIMER_NAME);
+
+	Matrix4 transform = gfx->getTransform();
+
+	gfx->push(Graphics::STACK_ALL);
+
+	uint32 rtflags = Graphics::TEMPORARY_RT_DEPTH | Graphics::TEMPORARY_RT_STENCIL;
+	gfx->setRenderTarget(Graphics::RenderTarget(canvas), rtflags);
+
+	// Map screen coordinates onto the smaller canvas.
+	gfx->origin();
+	gfx->scale((float) renderWidth / gfx->getWidth(), (float) renderHeight / gfx->getHeight());
+	gfx->applyTransform(transform);
+
+	inFrame = true;
+}
+
+void DynamicResolution::endFrame()
+{
+	if (!inFrame)
+		throw love::Exception("DynamicResolution:endFrame must be called after beginFrame.");
+
+	inFrame = false;
+
+	gfx->pop();
+	gfx->push(Graphics::STACK_ALL);
+
+	SamplerState s = canvas->getSamplerState();
+	s.minFilter = s.magFilter = SamplerState::FILTER_LINEAR;
+	canvas->setSamplerState(s);
+
+	Shader *shader = nullptr;
+	if (settings.upscaler == UPSCALER_SHARPEN)
+	{
+		shader = getSharpenShader();
+
+		const Shader::UniformInfo *info = shader->getUniformInfo("love_DynamicResolutionSharpness");
+		if (info != nullptr)
+		{
+			info->floats[0] = settings.sharpness;
+			shader->updateUniform(info, 1);
+		}
+	}
+
+	if (shader != nullptr)
+		gfx->setShader(shader);
+	else
+		gfx->setShader();
+
+	gfx->origin();
+	gfx->setColor(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+	gfx->setBlendMode(BLEND_REPLACE, BLENDALPHA_PREMULTIPLIED);
+	gfx->setColorMask(ColorChannelMask());
+	gfx->setScissor();
+	gfx->setStencilState();
+	gfx->setDepthMode();
+	gfx->setWireframe(false);
+
+	float sx = (float) gfx->getWidth() / canvas->getWidth();
+	float sy = (float) gfx->getHeight() / canvas->getHeight();
+	gfx->draw(canvas, Matrix4(0, 0, 0, sx, sy, 0, 0, 0, 0));
+
+	gfx->pop();
+
+	if (gpuTimed)
+		gfx->popGPUTimer();
+
+	gfx->releaseTemporaryTexture(canvas);
+	canvas = nullptr;
+}
+
+bool DynamicResolution::getConstant(const char *in, Upscaler &out)
+{
+	return upscalers.find(in, out);
+}
+
+bool DynamicResolution::getConstant(Upscaler in, const char *&out)
+{
+	return upscalers.find(in, out);
+}
+
+std::vector<std::string> DynamicResolution::getConstants(Upscaler)
+{
+	return upscalers.getNames();
+}
+
+StringMap<DynamicResolution::Upscaler, DynamicResolution::UPSCALER_MAX_ENUM>::Entry DynamicResolution::upscalerEntries[] =
+{
+	{ "linear",  UPSCALER_LINEAR },
+	{ "sharpen", UPSCALER_SHARPEN },
+};
+
+StringMap<DynamicResolution::Upscaler, DynamicResolution::UPSCALER_MAX_ENUM> DynamicResolution::upscalers(DynamicResolution::upscalerEntries, sizeof(DynamicResolution::upscalerEntries));
+
+} // graphics
+} // love
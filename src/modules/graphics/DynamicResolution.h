@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+
+// C++
+#include <vector>
+#include <string>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+class Texture;
+class Shader;
+
+/**
+ * Renders everything drawn between beginFrame and endFrame into an internal
+ * canvas, whose resolution is scaled between a minimum and maximum fraction
+ * of the screen's so the frame fits in a target frame time. The canvas is
+ * upscaled to the screen in endFrame.
+ *
+ * Frame times come from GPU timestamps when they're supported, and from the
+ * time between beginFrame calls otherwise.
+ **/
+class DynamicResolution : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum Upscaler
+	{
+		UPSCALER_LINEAR,
+		UPSCALER_SHARPEN,
+		UPSCALER_MAX_ENUM
+	};
+
+	struct Settings
+	{
+		float minScale = 0.5f;
+		float maxScale = 1.0f;
+		double targetFrameTime = 1.0 / 60.0;
+		Upscaler upscaler = UPSCALER_LINEAR;
+		float sharpness = 0.5f;
+	};
+
+	DynamicResolution(Graphics *gfx, const Settings &settings);
+	virtual ~DynamicResolution();
+
+	/**
+	 * Picks the resolution for this frame and starts rendering to it. The
+	 * transform is kept, so drawing code can use screen coordinates.
+	 **/
+	void beginFrame();
+
+	/**
+	 * Restores the state from before beginFrame and draws the upscaled frame
+	 * to the screen.
+	 **/
+	void endFrame();
+
+	bool isInFrame() const { return inFrame; }
+
+	/**
+	 * The scale which will be used for the next frame. Setting it overrides
+	 * the current estimate, which is still adjusted every frame afterwards.
+	 **/
+	void setScale(float scale);
+	float getScale() const { return scale; }
+
+	void setScaleRange(float minscale, float maxscale);
+	void getScaleRange(float &minscale, float &maxscale) const;
+
+	void setTargetFrameTime(double seconds);
+	double getTargetFrameTime() const { return settings.targetFrameTime; }
+
+	void setUpscaler(Upscaler upscaler) { settings.upscaler = upscaler; }
+	Upscaler getUpscaler() const { return settings.upscaler; }
+
+	void setSharpness(float sharpness);
+	float getSharpness() const { return settings.sharpness; }
+
+	/**
+	 * The most recent frame time given to the controller, in seconds.
+	 **/
+	double getLastFrameTime() const { return lastFrameTime; }
+
+	bool isGPUTimed() const { return gpuTimed; }
+
+	/**
+	 * Dimensions, in pixels, of the internal canvas of the current (or last)
+	 * frame.
+	 **/
+	void getRenderDimensions(int &w, int &h) const;
+
+	static bool getConstant(const char *in, Upscaler &out);
+	static bool getConstant(Upscaler in, const char *&out);
+	static std::vector<std::string> getConstants(Upscaler);
+
+private:
+
+	void updateScale(double frametime);
+	Shader *getSharpenShader();
+
+	Graphics *gfx;
+
+	Settings settings;
+
+	Texture *canvas;
+	StrongRef<Shader> sharpenShader;
+
+	float scale;
+
+	double lastFrameTime;
+	double lastBeginTime;
+
+	int renderWidth;
+	int renderHeight;
+
+	bool gpuTimed;
+	bool inFrame;
+
+	static StringMap<Upscaler, UPSCALER_MAX_ENUM>::Entry upscalerEntries[];
+	static StringMap<Upscaler, UPSCALER_MAX_ENUM> upscalers;
+
+}; // DynamicResolution
+
+} // graphics
+} // love
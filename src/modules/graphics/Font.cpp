@@ -23,7 +23,9 @@
 
 #include "common/math.h"
 #include "common/Matrix.h"
+#include "thread/threads.h"
 #include "Graphics.h"
+#include "libraries/xxHash/xxhash.h"
 
 #include <math.h>
 #include <sstream>
@@ -45,9 +47,132 @@ static inline uint64 packGlyphIndex(love::font::TextShaper::GlyphIndex glyphinde
 	return ((uint64)glyphindex.rasterizerIndex << 32) | (uint64)glyphindex.index;
 }
 
-static inline love::font::TextShaper::GlyphIndex unpackGlyphIndex(uint64 packedindex)
+struct Font::PrewarmJob
 {
-	return {(int) (packedindex & 0xFFFFFFFF), (int) (packedindex >> 32)};
+	// Clones of the Font's rasterizers, indexed the same way. Only the ones
+	// used by this job's glyphs are set.
+	std::vector<StrongRef<love::font::Rasterizer>> rasterizers;
+	std::vector<love::font::TextShaper::GlyphIndex> glyphs;
+	std::vector<StrongRef<love::font::GlyphData>> results;
+	bool cancelled = false;
+	bool done = false;
+};
+
+// Rasterizes glyphs for Font::prewarm. Jobs are owned by their Font, which
+// cancels and waits for them before deleting them, so the rasterizer clones
+// are always created and destroyed on the main thread.
+class GlyphRasterizerThread : public love::thread::Threadable
+{
+public:
+
+	GlyphRasterizerThread()
+		: stopping(false)
+	{
+		threadName = "GlyphRasterizer";
+	}
+
+	void stop()
+	{
+		mutex->lock();
+		stopping = true;
+
+		// A job which is being processed is finished by the thread itself.
+		for (Font::PrewarmJob *job : jobs)
+			job->done = true;
+		jobs.clear();
+		workCond->broadcast();
+		doneCond->broadcast();
+		mutex->unlock();
+
+		wait();
+	}
+
+	void queue(Font::PrewarmJob *job)
+	{
+		love::thread::Lock lock(mutex);
+		jobs.push_back(job);
+		workCond->signal();
+	}
+
+	bool isDone(Font::PrewarmJob *job)
+	{
+		love::thread::Lock lock(mutex);
+		return job->done;
+	}
+
+	void cancel(Font::PrewarmJob *job)
+	{
+		love::thread::Lock lock(mutex);
+		job->cancelled = true;
+		while (!job->done)
+			doneCond->wait(mutex);
+	}
+
+	void threadFunction() override
+	{
+		mutex->lock();
+
+		while (!stopping)
+		{
+			if (jobs.empty())
+			{
+				workCond->wait(mutex);
+				continue;
+			}
+
+			Font::PrewarmJob *job = jobs.front();
+			jobs.erase(jobs.begin());
+
+			for (size_t i = 0; i < job->glyphs.size() && !job->cancelled && !stopping; i++)
+			{
+				mutex->unlock();
+
+				const auto &glyph = job->glyphs[i];
+				love::font::GlyphData *gd = nullptr;
+
+				try
+				{
+					gd = job->rasterizers[glyph.rasterizerIndex]->getGlyphDataForIndex(glyph.index);
+				}
+				catch (love::Exception &)
+				{
+					// The glyph will be rasterized on the main thread when
+					// it's used, which reports the error.
+				}
+
+				mutex->lock();
+				job->results[i].set(gd, Acquire::NORETAIN);
+			}
+
+			job->done = true;
+			doneCond->broadcast();
+		}
+
+		mutex->unlock();
+	}
+
+private:
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workCond;
+	love::thread::ConditionalRef doneCond;
+
+	std::vector<Font::PrewarmJob *> jobs;
+
+	bool stopping;
+};
+
+static GlyphRasterizerThread *glyphRasterizerThread = nullptr;
+
+static GlyphRasterizerThread *getGlyphRasterizerThread()
+{
+	if (glyphRasterizerThread == nullptr)
+	{
+		glyphRasterizerThread = new GlyphRasterizerThread();
+		glyphRasterizerThread->start();
+	}
+
+	return glyphRasterizerThread;
 }
 
 love::Type Font::type("Font", &Object::type);
@@ -57,25 +182,34 @@ const CommonFormat Font::vertexFormat = CommonFormat::XYf_STus_RGBAub;
 
 Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 	: shaper(r->newTextShaper(), Acquire::NORETAIN)
+	, printCacheSweepFrame(0)
 	, textureWidth(128)
 	, textureHeight(128)
 	, samplerState()
 	, dpiScale(r->getDPIScale())
+	, glyphPass(0)
 	, textureCacheID(0)
 {
 	samplerState.minFilter = s.minFilter;
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
-	// Try to find the best texture size match for the font size. default to the
-	// largest texture size if no rough match is found.
+	// Distance fields need linear filtering to reconstruct smooth edges.
+	if (r->isSDF())
+	{
+		samplerState.minFilter = SamplerState::FILTER_LINEAR;
+		samplerState.magFilter = SamplerState::FILTER_LINEAR;
+	}
+
+	// Try to find a page size which fits a couple hundred glyphs of the font's
+	// size. Default to the largest texture size if no rough match is found.
 	while (true)
 	{
 		float dpiscale = r->getDPIScale();
-		if ((shaper->getHeight() * 0.8 * dpiscale) * shaper->getHeight() * 30 * dpiscale <= textureWidth * textureHeight)
+		if ((shaper->getHeight() * 0.8 * dpiscale) * shaper->getHeight() * 256 * dpiscale <= textureWidth * textureHeight)
 			break;
 
-		TextureSize nextsize = getNextTextureSize();
+		TextureSize nextsize = getNextTextureSize({textureWidth, textureHeight});
 
 		if (nextsize.width <= textureWidth && nextsize.height <= textureHeight)
 			break;
@@ -100,13 +234,12 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 
 Font::~Font()
 {
+	cancelPrewarmJobs();
 	--fontCount;
 }
 
-Font::TextureSize Font::getNextTextureSize() const
+Font::TextureSize Font::getNextTextureSize(TextureSize size) const
 {
-	TextureSize size = {textureWidth, textureHeight};
-
 	int maxsize = 2048;
 	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 	if (gfx != nullptr)
@@ -134,97 +267,147 @@ bool Font::loadVolatile()
 {
 	textureCacheID++;
 	glyphs.clear();
-	textures.clear();
-	createTexture();
+	pages.clear();
+	createTexturePage(0, 0);
 	return true;
 }
 
-void Font::createTexture()
+int Font::createTexturePage(int minwidth, int minheight)
 {
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	gfx->flushBatchedDraws();
 
-	Texture *texture = nullptr;
 	TextureSize size = {textureWidth, textureHeight};
-	TextureSize nextsize = getNextTextureSize();
-	bool recreatetexture = false;
 
-	// If we have an existing texture already, we'll try replacing it with a
-	// larger-sized one rather than creating a second one. Having a single
-	// texture reduces texture switches and draw calls when rendering.
-	if ((nextsize.width > size.width || nextsize.height > size.height) && !textures.empty())
+	// Glyphs which are too big for a regular page get a larger one.
+	while (size.width < minwidth + TEXTURE_PADDING * 2 || size.height < minheight + TEXTURE_PADDING * 2)
 	{
-		recreatetexture = true;
+		TextureSize nextsize = getNextTextureSize(size);
+		if (nextsize.width <= size.width && nextsize.height <= size.height)
+			throw love::Exception("Font glyph is too large to fit in a texture (%dx%d).", minwidth, minheight);
 		size = nextsize;
-		textures.pop_back();
 	}
 
 	Texture::Settings settings;
 	settings.format = pixelFormat;
 	settings.width = size.width;
 	settings.height = size.height;
-	texture = gfx->newTexture(settings, nullptr);
-	texture->setSamplerState(samplerState);
 
-	{
-		size_t datasize = getPixelFormatSliceSize(pixelFormat, size.width, size.height);
-		size_t pixelcount = size.width * size.height;
+	TexturePage page;
+	page.texture.set(gfx->newTexture(settings, nullptr), Acquire::NORETAIN);
+	page.texture->setSamplerState(samplerState);
+	page.width = size.width;
+	page.height = size.height;
+	page.lastUsedPass = glyphPass;
+
+	clearTexturePage(page);
+
+	pages.push_back(page);
+	return (int) pages.size() - 1;
+}
+
+void Font::clearTexturePage(TexturePage &page)
+{
+	size_t datasize = getPixelFormatSliceSize(pixelFormat, page.width, page.height);
+	size_t pixelcount = page.width * page.height;
 
-		// Initialize the texture with transparent white for truetype fonts
-		// (since we keep luminance constant and vary alpha in those glyphs),
-		// and transparent black otherwise.
-		std::vector<uint8> emptydata(datasize, 0);
+	// Initialize the texture with transparent white for truetype fonts
+	// (since we keep luminance constant and vary alpha in those glyphs),
+	// and transparent black otherwise.
+	std::vector<uint8> emptydata(datasize, 0);
 
-		if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
+	if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
+	{
+		if (pixelFormat == PIXELFORMAT_LA8_UNORM)
 		{
-			if (pixelFormat == PIXELFORMAT_LA8_UNORM)
+			for (size_t i = 0; i < pixelcount; i++)
+				emptydata[i * 2 + 0] = 255;
+		}
+		else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
+		{
+			for (size_t i = 0; i < pixelcount; i++)
 			{
-				for (size_t i = 0; i < pixelcount; i++)
-					emptydata[i * 2 + 0] = 255;
-			}
-			else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-				{
-					emptydata[i * 4 + 0] = 255;
-					emptydata[i * 4 + 1] = 255;
-					emptydata[i * 4 + 2] = 255;
-				}
+				emptydata[i * 4 + 0] = 255;
+				emptydata[i * 4 + 1] = 255;
+				emptydata[i * 4 + 2] = 255;
 			}
 		}
-
-		Rect rect = {0, 0, size.width, size.height};
-		texture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
 	}
 
-	textures.emplace_back(texture, Acquire::NORETAIN);
+	Rect rect = {0, 0, page.width, page.height};
+	page.texture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
 
-	textureWidth  = size.width;
-	textureHeight = size.height;
+	// The first row and column are left as padding. Every packed glyph is
+	// followed by its own padding on the right and bottom.
+	page.skyline.reset(page.width, page.height, TEXTURE_PADDING);
+}
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+void Font::evictTexturePage(int page)
+{
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	gfx->flushBatchedDraws();
 
-	// Re-add the old glyphs if we re-created the existing texture object.
-	if (recreatetexture)
+	for (auto it = glyphs.begin(); it != glyphs.end();)
 	{
-		textureCacheID++;
+		if (it->second.page == page)
+			it = glyphs.erase(it);
+		else
+			++it;
+	}
+
+	clearTexturePage(pages[page]);
+
+	// Text vertices which reference the evicted glyphs need to be regenerated.
+	textureCacheID++;
+}
+
+void Font::findGlyphSpace(int w, int h, int &page, int &x, int &y)
+{
+	// Newer pages are the most likely to have space left.
+	for (int i = (int) pages.size() - 1; i >= 0; i--)
+	{
+		if (pages[i].skyline.pack(w + TEXTURE_PADDING, h + TEXTURE_PADDING, x, y))
+		{
+			page = i;
+			return;
+		}
+	}
+
+	// Evict the least recently used page once the page limit is reached, as
+	// long as it isn't used by the text currently being generated.
+	int evictpage = -1;
 
-		std::vector<love::font::TextShaper::GlyphIndex> glyphstoadd;
+	if ((int) pages.size() >= MAX_TEXTURE_PAGES)
+	{
+		for (int i = 0; i < (int) pages.size(); i++)
+		{
+			if (pages[i].lastUsedPass == glyphPass)
+				continue;
 
-		for (const auto &glyphpair : glyphs)
-			glyphstoadd.push_back(unpackGlyphIndex(glyphpair.first));
+			if (evictpage < 0 || pages[i].lastUsedPass < pages[evictpage].lastUsedPass)
+				evictpage = i;
+		}
+	}
 
-		glyphs.clear();
-		
-		for (auto glyphindex : glyphstoadd)
-			addGlyph(glyphindex);
+	if (evictpage >= 0)
+	{
+		evictTexturePage(evictpage);
+		if (pages[evictpage].skyline.pack(w + TEXTURE_PADDING, h + TEXTURE_PADDING, x, y))
+		{
+			page = evictpage;
+			return;
+		}
 	}
+
+	page = createTexturePage(w, h);
+	if (!pages[page].skyline.pack(w + TEXTURE_PADDING, h + TEXTURE_PADDING, x, y))
+		throw love::Exception("Font glyph is too large to fit in a texture (%dx%d).", w, h);
 }
 
 void Font::unloadVolatile()
 {
 	glyphs.clear();
-	textures.clear();
+	pages.clear();
 }
 
 love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale)
@@ -239,39 +422,31 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 	float glyphdpiscale = getDPIScale();
 	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
 
+	return addGlyph(glyphindex, gd, glyphdpiscale);
+}
+
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale)
+{
 	int w = gd->getWidth();
 	int h = gd->getHeight();
 
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
-	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
-		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
-		}
-
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
-		{
-			// Totally out of space - new texture!
-			createTexture();
-
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyphindex);
-		}
-	}
-
 	Glyph g;
 
 	g.texture = nullptr;
+	g.page = -1;
 	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
 
 	// Don't waste space for empty glyphs.
 	if (w > 0 && h > 0)
 	{
-		Texture *texture = textures.back();
+		int textureX = 0;
+		int textureY = 0;
+		findGlyphSpace(w, h, g.page, textureX, textureY);
+
+		TexturePage &page = pages[g.page];
+		page.lastUsedPass = glyphPass;
+
+		Texture *texture = page.texture;
 		g.texture = texture;
 
 		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
@@ -303,7 +478,7 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 		}
 
 		double tX     = (double) textureX,     tY      = (double) textureY;
-		double tWidth = (double) textureWidth, tHeight = (double) textureHeight;
+		double tWidth = (double) page.width,   tHeight = (double) page.height;
 
 		Color32 c(255, 255, 255, 255);
 
@@ -332,9 +507,6 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 			g.vertices[i].x /= glyphdpiscale;
 			g.vertices[i].y /= glyphdpiscale;
 		}
-
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
 	}
 
 	uint64 packedindex = packGlyphIndex(glyphindex);
@@ -348,7 +520,11 @@ const Font::Glyph &Font::findGlyph(love::font::TextShaper::GlyphIndex glyphindex
 	const auto it = glyphs.find(packedindex);
 
 	if (it != glyphs.end())
+	{
+		if (it->second.page >= 0)
+			pages[it->second.page].lastUsedPass = glyphPass;
 		return it->second;
+	}
 
 	return addGlyph(glyphindex);
 }
@@ -369,6 +545,13 @@ float Font::getHeight() const
 }
 
 std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info)
+{
+	updatePrewarmJobs();
+	glyphPass++;
+	return generateVerticesInternal(codepoints, range, constantcolor, vertices, extra_spacing, offset, info);
+}
+
+std::vector<Font::DrawCommand> Font::generateVerticesInternal(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info)
 {
 	std::vector<love::font::TextShaper::GlyphPosition> glyphpositions;
 	std::vector<love::font::IndexedColor> colors;
@@ -463,6 +646,13 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 }
 
 std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info)
+{
+	updatePrewarmJobs();
+	glyphPass++;
+	return generateVerticesFormattedInternal(text, constantcolor, wrap, align, vertices, info);
+}
+
+std::vector<Font::DrawCommand> Font::generateVerticesFormattedInternal(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info)
 {
 	wrap = std::max(wrap, 0.0f);
 
@@ -522,7 +712,7 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 				break;
 		}
 
-		std::vector<DrawCommand> newcommands = generateVertices(text, range, constantcolor, vertices, extraspacing, offset);
+		std::vector<DrawCommand> newcommands = generateVerticesInternal(text, range, constantcolor, vertices, extraspacing, offset, nullptr);
 
 		if (!newcommands.empty())
 		{
@@ -557,7 +747,7 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 	if (cacheid != textureCacheID)
 	{
 		vertices.clear();
-		drawcommands = generateVerticesFormatted(text, constantcolor, wrap, align, vertices);
+		drawcommands = generateVerticesFormattedInternal(text, constantcolor, wrap, align, vertices, info);
 	}
 
 	return drawcommands;
@@ -568,7 +758,7 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 	if (vertices.empty() || drawcommands.empty())
 		return;
 
-	Matrix4 m(gfx->getTransform(), t);
+	Matrix4 m = gfx->getCombinedTransform(t);
 
 	for (const DrawCommand &cmd : drawcommands)
 	{
@@ -577,35 +767,130 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 		streamcmd.indexMode = TRIANGLEINDEX_QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
+		streamcmd.standardShaderType = getStandardShader();
+		streamcmd.allowUntransformed = true;
+		streamcmd.localTransform = &t;
 
 		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
 
 		memcpy(vertexdata, &vertices[cmd.startvertex], sizeof(GlyphVertex) * cmd.vertexcount);
-		m.transformXY(vertexdata, &vertices[cmd.startvertex], cmd.vertexcount);
+
+		if (data.transformVertices)
+			m.transformXY(vertexdata, &vertices[cmd.startvertex], cmd.vertexcount);
 	}
 }
 
-void Font::print(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
+const love::font::ColoredCodepoints &Font::getPrintCodepoints(const std::vector<love::font::ColoredString> &text)
 {
-	love::font::ColoredCodepoints codepoints;
-	love::font::getCodepointsFromString(text, codepoints);
+	// Text drawn every frame is usually the same as last time, and comparing
+	// it is cheaper than decoding it again.
+	bool same = text.size() == printText.size();
+	for (size_t i = 0; same && i < text.size(); i++)
+		same = text[i].str == printText[i].str && text[i].color == printText[i].color;
+
+	if (same)
+		return printCodepoints;
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVertices(codepoints, Range(), constantcolor, vertices);
+	printText.clear();
+	printCodepoints.cps.clear();
+	printCodepoints.colors.clear();
 
-	printv(gfx, m, drawcommands, vertices);
+	love::font::getCodepointsFromString(text, printCodepoints);
+	printText = text;
+
+	return printCodepoints;
 }
 
-void Font::printf(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
+void Font::printCached(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, bool formatted, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
 {
-	love::font::ColoredCodepoints codepoints;
-	love::font::getCodepointsFromString(text, codepoints);
+	uint64 frame = gfx->getPresentedFrameCount();
+
+	if (frame != printCacheSweepFrame)
+	{
+		printCacheSweepFrame = frame;
+		for (auto it = printCache.begin(); it != printCache.end(); )
+		{
+			if (frame - it->second.lastUsedFrame > MAX_PRINT_CACHE_UNUSED_FRAMES)
+				it = printCache.erase(it);
+			else
+				++it;
+		}
+	}
+
+	uint64 hash = XXH64(&formatted, sizeof(bool), 0);
+	hash = XXH64(&wrap, sizeof(float), hash);
+	hash = XXH64(&align, sizeof(AlignMode), hash);
+	hash = XXH64(&constantcolor, sizeof(Colorf), hash);
+	for (const auto &str : text)
+	{
+		hash = XXH64(str.str.data(), str.str.size(), hash);
+		hash = XXH64(&str.color, sizeof(Colorf), hash);
+	}
+
+	auto it = printCache.find(hash);
+	if (it != printCache.end())
+	{
+		CachedPrint &cached = it->second;
+
+		bool same = cached.textureCacheID == textureCacheID && cached.formatted == formatted && cached.wrap == wrap && cached.align == align
+			&& cached.constantColor == constantcolor && cached.text.size() == text.size();
+		for (size_t i = 0; same && i < text.size(); i++)
+			same = text[i].str == cached.text[i].str && text[i].color == cached.text[i].color;
+
+		if (same)
+		{
+			cached.lastUsedFrame = frame;
+
+			// Keep the glyphs' pages from looking unused to the atlas.
+			for (const DrawCommand &cmd : cached.drawCommands)
+			{
+				for (TexturePage &page : pages)
+				{
+					if (page.texture.get() == cmd.texture)
+						page.lastUsedPass = glyphPass;
+				}
+			}
+
+			printv(gfx, m, cached.drawCommands, cached.vertices);
+			return;
+		}
+	}
+
+	const love::font::ColoredCodepoints &codepoints = getPrintCodepoints(text);
+
+	printVertices.clear();
+	std::vector<DrawCommand> drawcommands;
+	if (formatted)
+		drawcommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, printVertices);
+	else
+		drawcommands = generateVertices(codepoints, Range(), constantcolor, printVertices);
+
+	printv(gfx, m, drawcommands, printVertices);
+
+	if (it == printCache.end() && printCache.size() >= MAX_PRINT_CACHE_ENTRIES)
+		return;
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, vertices);
+	CachedPrint &cached = printCache[hash];
+	cached.text = text;
+	cached.constantColor = constantcolor;
+	cached.formatted = formatted;
+	cached.wrap = wrap;
+	cached.align = align;
+	cached.textureCacheID = textureCacheID;
+	cached.lastUsedFrame = frame;
+	cached.vertices = printVertices;
+	cached.drawCommands = drawcommands;
+}
 
-	printv(gfx, m, drawcommands, vertices);
+void Font::print(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
+{
+	printCached(gfx, text, false, 0.0f, ALIGN_LEFT, m, constantcolor);
+}
+
+void Font::printf(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
+{
+	printCached(gfx, text, true, wrap, align, m, constantcolor);
 }
 
 int Font::getWidth(const std::string &str)
@@ -631,6 +916,7 @@ void Font::getWrap(const std::vector<love::font::ColoredString> &text, float wra
 void Font::setLineHeight(float height)
 {
 	shaper->setLineHeight(height);
+	printCache.clear();
 }
 
 float Font::getLineHeight() const
@@ -644,8 +930,8 @@ void Font::setSamplerState(const SamplerState &s)
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
-	for (const auto &texture : textures)
-		texture->setSamplerState(samplerState);
+	for (const TexturePage &page : pages)
+		page.texture->setSamplerState(samplerState);
 }
 
 const SamplerState &Font::getSamplerState() const
@@ -678,21 +964,176 @@ bool Font::hasGlyphs(const std::string &text) const
 	return shaper->hasGlyphs(text);
 }
 
+bool Font::isSDF() const
+{
+	return shaper->getRasterizers()[0]->isSDF();
+}
+
+Shader::StandardShader Font::getStandardShader() const
+{
+	return isSDF() ? Shader::STANDARD_SDF_FONT : Shader::STANDARD_DEFAULT;
+}
+
 void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 {
 	std::vector<love::font::Rasterizer*> rasterizerfallbacks;
 	for (const Font* f : fallbacks)
+	{
+		if (f->isSDF() != isSDF())
+			throw love::Exception("Font fallbacks must use the same SDF setting as the main Font.");
 		rasterizerfallbacks.push_back(f->shaper->getRasterizers()[0]);
+	}
+
+	// Glyph indices from pending prewarms may refer to the old fallbacks.
+	cancelPrewarmJobs();
 
 	shaper->setFallbacks(rasterizerfallbacks);
 
 	// Invalidate existing textures.
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	gfx->flushBatchedDraws();
+
 	textureCacheID++;
 	glyphs.clear();
-	while (textures.size() > 1)
-		textures.pop_back();
+	while (pages.size() > 1)
+		pages.pop_back();
+
+	if (!pages.empty())
+		clearTexturePage(pages[0]);
+}
+
+bool Font::prewarm(const std::vector<uint32> &codepoints, bool async)
+{
+	updatePrewarmJobs();
+
+	love::font::ColoredCodepoints text;
+	text.cps = codepoints;
+
+	std::vector<love::font::TextShaper::GlyphPosition> glyphpositions;
+	shaper->computeGlyphPositions(text, Range(), Vector2(), 0.0f, &glyphpositions, nullptr, nullptr);
+
+	bool pending = false;
+	std::vector<love::font::TextShaper::GlyphIndex> missing;
+	std::unordered_set<uint64> seen;
+
+	for (const auto &info : glyphpositions)
+	{
+		uint64 packedindex = packGlyphIndex(info.glyphIndex);
+
+		if (glyphs.find(packedindex) != glyphs.end() || !seen.insert(packedindex).second)
+			continue;
+
+		if (prewarmingGlyphs.find(packedindex) != prewarmingGlyphs.end())
+			pending = true;
+		else
+			missing.push_back(info.glyphIndex);
+	}
+
+	if (missing.empty())
+		return pending;
+
+	const auto &rasterizers = shaper->getRasterizers();
+
+	PrewarmJob *job = nullptr;
+	if (async)
+	{
+		job = new PrewarmJob();
+		job->rasterizers.resize(rasterizers.size());
+	}
+
+	std::vector<bool> triedclone(rasterizers.size(), false);
+
+	for (auto glyphindex : missing)
+	{
+		int r = glyphindex.rasterizerIndex;
+
+		if (job != nullptr && !triedclone[r])
+		{
+			job->rasterizers[r].set(rasterizers[r]->clone(), Acquire::NORETAIN);
+			triedclone[r] = true;
+		}
+
+		if (job != nullptr && job->rasterizers[r].get() != nullptr)
+		{
+			job->glyphs.push_back(glyphindex);
+			prewarmingGlyphs.insert(packGlyphIndex(glyphindex));
+		}
+		else
+			findGlyph(glyphindex);
+	}
+
+	if (job != nullptr && !job->glyphs.empty())
+	{
+		job->results.resize(job->glyphs.size());
+		prewarmJobs.push_back(job);
+		getGlyphRasterizerThread()->queue(job);
+		pending = true;
+	}
+	else
+		delete job;
+
+	return pending;
+}
+
+bool Font::isPrewarming()
+{
+	updatePrewarmJobs();
+	return !prewarmJobs.empty();
+}
+
+void Font::updatePrewarmJobs()
+{
+	for (size_t i = 0; i < prewarmJobs.size();)
+	{
+		PrewarmJob *job = prewarmJobs[i];
+
+		if (glyphRasterizerThread != nullptr && !glyphRasterizerThread->isDone(job))
+		{
+			i++;
+			continue;
+		}
+
+		prewarmJobs.erase(prewarmJobs.begin() + i);
+
+		// All of the job's glyphs are added to the atlas together, rather
+		// than while text is being generated.
+		for (size_t j = 0; j < job->glyphs.size(); j++)
+		{
+			auto glyphindex = job->glyphs[j];
+			uint64 packedindex = packGlyphIndex(glyphindex);
+
+			prewarmingGlyphs.erase(packedindex);
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+			love::font::GlyphData *gd = job->results[j];
+			if (gd != nullptr && glyphs.find(packedindex) == glyphs.end())
+				addGlyph(glyphindex, gd, job->rasterizers[glyphindex.rasterizerIndex]->getDPIScale());
+		}
+
+		delete job;
+	}
+}
+
+void Font::cancelPrewarmJobs()
+{
+	for (PrewarmJob *job : prewarmJobs)
+	{
+		if (glyphRasterizerThread != nullptr)
+			glyphRasterizerThread->cancel(job);
+		delete job;
+	}
+
+	prewarmJobs.clear();
+	prewarmingGlyphs.clear();
+}
+
+void Font::releaseSharedResources()
+{
+	if (glyphRasterizerThread != nullptr)
+	{
+		glyphRasterizerThread->stop();
+		delete glyphRasterizerThread;
+		glyphRasterizerThread = nullptr;
+	}
 }
 
 float Font::getDPIScale() const
@@ -22,6 +22,7 @@
 
 // STD
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <stddef.h>
@@ -35,8 +36,10 @@
 #include "font/Rasterizer.h"
 #include "font/TextShaper.h"
 #include "Texture.h"
+#include "Shader.h"
 #include "vertex.h"
 #include "Volatile.h"
+#include "SkylinePacker.h"
 
 namespace love
 {
@@ -44,6 +47,7 @@ namespace graphics
 {
 
 class Graphics;
+class GlyphRasterizerThread;
 
 class Font : public Object, public Volatile
 {
@@ -141,11 +145,36 @@ public:
 	bool hasGlyph(uint32 glyph) const;
 	bool hasGlyphs(const std::string &text) const;
 
+	/**
+	 * Gets whether the Font's glyphs are signed distance fields, which are
+	 * drawn with a dedicated standard shader and stay sharp when scaled.
+	 **/
+	bool isSDF() const;
+
+	/**
+	 * Gets the standard shader used when drawing this Font's text.
+	 **/
+	Shader::StandardShader getStandardShader() const;
+
 	float getKerning(uint32 leftglyph, uint32 rightglyph);
 	float getKerning(const std::string &leftchar, const std::string &rightchar);
 
 	void setFallbacks(const std::vector<Font *> &fallbacks);
 
+	/**
+	 * Rasterizes and adds the glyphs used by the given codepoints to the
+	 * atlas ahead of time. When async is true, glyphs are rasterized on a
+	 * separate thread where possible and added to the atlas once they're done.
+	 * Returns true if any of the glyphs are still being rasterized.
+	 **/
+	bool prewarm(const std::vector<uint32> &codepoints, bool async);
+
+	/**
+	 * Gets whether glyphs from an earlier async prewarm are still being
+	 * rasterized. Adds any finished glyphs to the atlas.
+	 **/
+	bool isPrewarming();
+
 	float getDPIScale() const;
 
 	uint32 getTextureCacheID() const;
@@ -160,13 +189,20 @@ public:
 	static bool getConstant(AlignMode in, const char *&out);
 	static std::vector<std::string> getConstants(AlignMode);
 
+	static void releaseSharedResources();
+
 	static int fontCount;
 
 private:
 
+	friend class GlyphRasterizerThread;
+
+	struct PrewarmJob;
+
 	struct Glyph
 	{
 		Texture *texture;
+		int page;
 		GlyphVertex vertices[4];
 	};
 
@@ -176,32 +212,88 @@ private:
 		int height;
 	};
 
-	void createTexture();
+	// Vertices generated by print or printf, reused while the same text is
+	// drawn with the same parameters in later frames.
+	struct CachedPrint
+	{
+		std::vector<love::font::ColoredString> text;
+		Colorf constantColor;
+		bool formatted;
+		float wrap;
+		AlignMode align;
+		uint32 textureCacheID;
+		uint64 lastUsedFrame;
+		std::vector<GlyphVertex> vertices;
+		std::vector<DrawCommand> drawCommands;
+	};
+
+	struct TexturePage
+	{
+		StrongRef<Texture> texture;
+		int width;
+		int height;
+		SkylinePacker skyline;
+		uint32 lastUsedPass;
+	};
+
+	int createTexturePage(int minwidth, int minheight);
+	void clearTexturePage(TexturePage &page);
+	void evictTexturePage(int page);
+	void findGlyphSpace(int w, int h, int &page, int &x, int &y);
 
-	TextureSize getNextTextureSize() const;
+	TextureSize getNextTextureSize(TextureSize size) const;
 	love::font::GlyphData *getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale);
 	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale);
 	const Glyph &findGlyph(love::font::TextShaper::GlyphIndex glyphindex);
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
+	const love::font::ColoredCodepoints &getPrintCodepoints(const std::vector<love::font::ColoredString> &text);
+	void printCached(Graphics *gfx, const std::vector<love::font::ColoredString> &text, bool formatted, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantColor);
+
+	void updatePrewarmJobs();
+	void cancelPrewarmJobs();
+
+	std::vector<DrawCommand> generateVerticesInternal(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantColor, std::vector<GlyphVertex> &vertices,
+	                                                  float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info);
+	std::vector<DrawCommand> generateVerticesFormattedInternal(const love::font::ColoredCodepoints &text, const Colorf &constantColor, float wrap, AlignMode align,
+	                                                           std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info);
 
 	StrongRef<love::font::TextShaper> shaper;
 
+	// The most recently printed text and its decoded codepoints, plus vertex
+	// memory which is reused by each print.
+	std::vector<love::font::ColoredString> printText;
+	love::font::ColoredCodepoints printCodepoints;
+	std::vector<GlyphVertex> printVertices;
+
+	// Keyed by a hash of the text and print parameters.
+	std::unordered_map<uint64, CachedPrint> printCache;
+	uint64 printCacheSweepFrame;
+
+	// Size of each glyph atlas page. Pages never grow, so existing glyphs
+	// don't need to be re-rasterized when more space is needed.
 	int textureWidth;
 	int textureHeight;
 
-	std::vector<StrongRef<Texture>> textures;
+	std::vector<TexturePage> pages;
 
 	// maps packed glyph index values to glyph texture information
 	std::unordered_map<uint64, Glyph> glyphs;
 
+	std::vector<PrewarmJob *> prewarmJobs;
+
+	// packed glyph index values which prewarm jobs are rasterizing
+	std::unordered_set<uint64> prewarmingGlyphs;
+
 	PixelFormat pixelFormat;
 
 	SamplerState samplerState;
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
+	// Incremented for each generated string. Pages with glyphs used by the
+	// string being generated are never evicted while generating it.
+	uint32 glyphPass;
 
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
@@ -213,6 +305,17 @@ private:
 	// use, for edge antialiasing.
 	static const int TEXTURE_PADDING = 2;
 
+	// When this many pages are full, the least recently used page is cleared
+	// to make room for new glyphs.
+	static const int MAX_TEXTURE_PAGES = 8;
+
+	// Cached print vertices are dropped after this many frames without being
+	// drawn. Text which changes every frame is never reused, so this is short.
+	static const int MAX_PRINT_CACHE_UNUSED_FRAMES = 4;
+
+	// Text printed once the cache is this full isn't cached.
+	static const size_t MAX_PRINT_CACHE_ENTRIES = 256;
+
 	static StringMap<AlignMode, ALIGN_MAX_ENUM>::Entry alignModeEntries[];
 	static StringMap<AlignMode, ALIGN_MAX_ENUM> alignModes;
 	
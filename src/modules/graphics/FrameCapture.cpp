@@ -0,0 +1,406 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "FrameCapture.h"
+#include "Mesh.h"
+#include "timer/Timer.h"
+#include "filesystem/Filesystem.h"
+
+// C++
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type FrameCapture::type("FrameCapture", &Object::type);
+
+FrameCapture::FrameCapture(Graphics *gfx)
+	: gfx(gfx)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+}
+
+void FrameCapture::beginCapture()
+{
+	gfx->beginFrameCapture(this);
+}
+
+void FrameCapture::endCapture()
+{
+	if (!isCapturing())
+		throw love::Exception("This FrameCapture is not capturing.");
+
+	gfx->endFrameCapture();
+}
+
+bool FrameCapture::isCapturing() const
+{
+	return gfx->isFrameCaptureRunning(this);
+}
+
+void FrameCapture::clear()
+{
+	commands.clear();
+
+	for (int i = 0; i < 2; i++)
+		vertexData[i].clear();
+
+	indexData.clear();
+	uploadData.clear();
+}
+
+int FrameCapture::getCommandCount() const
+{
+	return (int) commands.size();
+}
+
+FrameCapture::CommandType FrameCapture::getCommandType(int index) const
+{
+	return commands[index].type;
+}
+
+double FrameCapture::getCommandTime(int index) const
+{
+	return commands[index].time;
+}
+
+FrameCapture::Command &FrameCapture::addCommand(CommandType type)
+{
+	commands.emplace_back();
+
+	Command &cmd = commands.back();
+	cmd.type = type;
+	cmd.state = gfx->states.back();
+	cmd.transform = gfx->getTransform();
+
+	return cmd;
+}
+
+void FrameCapture::captureBatch()
+{
+	const auto &sbstate = gfx->batchedDrawState;
+
+	Command &cmd = addCommand(COMMAND_BATCH);
+	cmd.primitiveMode = sbstate.primitiveMode;
+	cmd.texture.set(sbstate.texture);
+	cmd.standardShaderType = sbstate.standardShaderType;
+	cmd.untransformed = sbstate.untransformed;
+	cmd.vertexCount = sbstate.vertexCount;
+	cmd.indexCount = sbstate.indexCount;
+
+	if (sbstate.untransformed)
+		cmd.transform = sbstate.transform;
+
+	// The mapped pointers have been advanced past everything written since
+	// the last flush.
+	for (int i = 0; i < 2; i++)
+	{
+		cmd.formats[i] = sbstate.formats[i];
+		cmd.vertexOffsets[i] = vertexData[i].size();
+
+		if (sbstate.formats[i] == CommonFormat::NONE)
+			continue;
+
+		size_t size = getFormatStride(sbstate.formats[i]) * sbstate.vertexCount;
+		const uint8 *data = sbstate.vbMap[i].data - size;
+		vertexData[i].insert(vertexData[i].end(), data, data + size);
+	}
+
+	cmd.indexStart = indexData.size();
+
+	if (sbstate.indexCount > 0)
+	{
+		const uint16 *indices = (const uint16 *) sbstate.indexBufferMap.data - sbstate.indexCount;
+		indexData.insert(indexData.end(), indices, indices + sbstate.indexCount);
+	}
+}
+
+void FrameCapture::captureDrawable(Drawable *drawable, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount)
+{
+	Command &cmd = addCommand(COMMAND_DRAWABLE);
+	cmd.drawable.set(drawable);
+	cmd.drawableTransform = m;
+	cmd.instanceCount = instancecount;
+	cmd.indirectArgs.set(indirectargs);
+	cmd.argsIndex = argsindex;
+	cmd.drawCount = drawcount;
+}
+
+void FrameCapture::captureDrawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Buffer *indexbuffer, int startindex, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture)
+{
+	Command &cmd = addCommand(COMMAND_DRAW_FROM_SHADER);
+	cmd.primitiveMode = primtype;
+	cmd.vertexCount = vertexcount;
+	cmd.instanceCount = instancecount;
+	cmd.indexBuffer.set(indexbuffer);
+	cmd.startIndex = startindex;
+	cmd.indirectArgs.set(indirectargs);
+	cmd.argsIndex = argsindex;
+	cmd.drawCount = drawcount;
+	cmd.texture.set(maintexture);
+}
+
+void FrameCapture::captureClear(OptionalColorD color, const std::vector<OptionalColorD> &colors, OptionalInt stencil, OptionalDouble depth)
+{
+	Command &cmd = addCommand(COMMAND_CLEAR);
+	cmd.clearColor = color;
+	cmd.clearColors = colors;
+	cmd.clearStencil = stencil;
+	cmd.clearDepth = depth;
+}
+
+void FrameCapture::captureTextureUpload(Texture *texture, const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
+{
+	Command &cmd = addCommand(COMMAND_TEXTURE_UPLOAD);
+	cmd.texture.set(texture);
+	cmd.slice = slice;
+	cmd.mipmap = mipmap;
+	cmd.rect = rect;
+	cmd.reloadMipmaps = reloadmipmaps;
+	cmd.uploadOffset = uploadData.size();
+	cmd.uploadSize = size;
+
+	const uint8 *bytes = (const uint8 *) data;
+	uploadData.insert(uploadData.end(), bytes, bytes + size);
+}
+
+void FrameCapture::replayBatch(const Command &cmd)
+{
+	auto &sbstate = gfx->batchedDrawState;
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
+
+	size_t sizes[2] = {0, 0};
+	size_t indexsize = sizeof(uint16) * cmd.indexCount;
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (cmd.formats[i] == CommonFormat::NONE)
+			continue;
+
+		sizes[i] = getFormatStride(cmd.formats[i]) * cmd.vertexCount;
+
+		if (sizes[i] > sbstate.vb[i]->getUsableSize())
+		{
+			size_t newsize = std::max(sizes[i], sbstate.vb[i]->getSize() * 2);
+			sbstate.vb[i]->release();
+			sbstate.vb[i] = gfx->newStreamBuffer(BUFFERUSAGE_VERTEX, newsize);
+		}
+	}
+
+	if (indexsize > sbstate.indexBuffer->getUsableSize())
+	{
+		size_t newsize = std::max(indexsize, sbstate.indexBuffer->getSize() * 2);
+		sbstate.indexBuffer->release();
+		sbstate.indexBuffer = gfx->newStreamBuffer(BUFFERUSAGE_INDEX, newsize);
+	}
+
+	// Goes through the same upload and flush path as the original batch.
+	for (int i = 0; i < 2; i++)
+	{
+		if (sizes[i] == 0)
+			continue;
+
+		sbstate.vbMap[i] = sbstate.vb[i]->map(sizes[i]);
+		memcpy(sbstate.vbMap[i].data, vertexData[i].data() + cmd.vertexOffsets[i], sizes[i]);
+		sbstate.vbMap[i].data += sizes[i];
+	}
+
+	if (indexsize > 0)
+	{
+		sbstate.indexBufferMap = sbstate.indexBuffer->map(indexsize);
+		memcpy(sbstate.indexBufferMap.data, indexData.data() + cmd.indexStart, indexsize);
+		sbstate.indexBufferMap.data += indexsize;
+	}
+
+	sbstate.primitiveMode = cmd.primitiveMode;
+	sbstate.formats[0] = cmd.formats[0];
+	sbstate.formats[1] = cmd.formats[1];
+	sbstate.texture.set(cmd.texture);
+	sbstate.standardShaderType = cmd.standardShaderType;
+	sbstate.untransformed = cmd.untransformed;
+	sbstate.transform = cmd.transform;
+	sbstate.vertexCount = cmd.vertexCount;
+	sbstate.indexCount = cmd.indexCount;
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(cmd.standardShaderType);
+
+	if (Shader::current != nullptr)
+		Shader::current->validateDrawState(cmd.primitiveMode, cmd.texture);
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
+}
+
+void FrameCapture::replayCommand(Command &cmd)
+{
+	gfx->restoreStateChecked(cmd.state);
+
+	gfx->transformStack.back() = cmd.transform;
+	gfx->updateTransformKind();
+
+	switch (cmd.type)
+	{
+	case COMMAND_BATCH:
+		replayBatch(cmd);
+		break;
+	case COMMAND_DRAWABLE:
+		if (cmd.indirectArgs.get() != nullptr)
+			gfx->drawIndirect((Mesh *) cmd.drawable.get(), cmd.drawableTransform, cmd.indirectArgs, cmd.argsIndex, cmd.drawCount);
+		else if (cmd.instanceCount > 0)
+			gfx->drawInstanced((Mesh *) cmd.drawable.get(), cmd.drawableTransform, cmd.instanceCount);
+		else
+			gfx->draw(cmd.drawable, cmd.drawableTransform);
+		break;
+	case COMMAND_DRAW_FROM_SHADER:
+		if (cmd.indexBuffer.get() != nullptr && cmd.indirectArgs.get() != nullptr)
+			gfx->drawFromShaderIndirect(cmd.indexBuffer, cmd.indirectArgs, cmd.argsIndex, cmd.drawCount, cmd.texture);
+		else if (cmd.indirectArgs.get() != nullptr)
+			gfx->drawFromShaderIndirect(cmd.primitiveMode, cmd.indirectArgs, cmd.argsIndex, cmd.drawCount, cmd.texture);
+		else if (cmd.indexBuffer.get() != nullptr)
+			gfx->drawFromShader(cmd.indexBuffer, cmd.vertexCount, cmd.instanceCount, cmd.startIndex, cmd.texture);
+		else
+			gfx->drawFromShader(cmd.primitiveMode, cmd.vertexCount, cmd.instanceCount, cmd.texture);
+		break;
+	case COMMAND_CLEAR:
+		if (cmd.clearColors.empty())
+			gfx->clear(cmd.clearColor, cmd.clearStencil, cmd.clearDepth);
+		else
+			gfx->clear(cmd.clearColors, cmd.clearStencil, cmd.clearDepth);
+		break;
+	case COMMAND_TEXTURE_UPLOAD:
+		cmd.texture->replacePixels(uploadData.data() + cmd.uploadOffset, cmd.uploadSize, cmd.slice, cmd.mipmap, cmd.rect, cmd.reloadMipmaps);
+		break;
+	case COMMAND_MAX_ENUM:
+		break;
+	}
+
+	// Batched draws made by the command count towards its time.
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
+}
+
+double FrameCapture::replay()
+{
+	if (gfx->frameCapture != nullptr)
+		throw love::Exception("FrameCaptures cannot be replayed while a FrameCapture is active.");
+
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("FrameCaptures cannot be replayed while a DrawList is being recorded.");
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
+	gfx->push(Graphics::STACK_ALL);
+
+	double total = 0.0;
+
+	try
+	{
+		for (Command &cmd : commands)
+		{
+			double start = love::timer::Timer::getTime();
+			replayCommand(cmd);
+			cmd.time = love::timer::Timer::getTime() - start;
+			total += cmd.time;
+		}
+	}
+	catch (love::Exception &)
+	{
+		gfx->pop();
+		throw;
+	}
+
+	gfx->pop();
+	return total;
+}
+
+void FrameCapture::save(const char *filename) const
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		throw love::Exception("love.filesystem must be loaded in order to save a FrameCapture.");
+
+	Graphics::RendererInfo info = gfx->getRendererInfo();
+
+	std::stringstream ss;
+	ss << "renderer\t" << info.name << "\t" << info.version << "\t" << info.device << "\n";
+	ss << "command\ttype\tdetail\ttime\n";
+
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		const Command &cmd = commands[i];
+
+		const char *typestr = nullptr;
+		getConstant(cmd.type, typestr);
+
+		ss << (i + 1) << "\t" << typestr << "\t";
+
+		switch (cmd.type)
+		{
+		case COMMAND_BATCH:
+			ss << cmd.vertexCount << " vertices, " << cmd.indexCount << " indices";
+			break;
+		case COMMAND_DRAWABLE:
+			if (cmd.indirectArgs.get() != nullptr)
+				ss << cmd.drawCount << " indirect draws";
+			else
+				ss << std::max(cmd.instanceCount, 1) << " instances";
+			break;
+		case COMMAND_DRAW_FROM_SHADER:
+			ss << cmd.vertexCount << (cmd.indexBuffer.get() != nullptr ? " indices, " : " vertices, ") << cmd.instanceCount << " instances";
+			break;
+		case COMMAND_CLEAR:
+			ss << std::max<size_t>(cmd.clearColors.size(), 1) << " colors";
+			break;
+		case COMMAND_TEXTURE_UPLOAD:
+			ss << cmd.rect.w << "x" << cmd.rect.h << ", " << cmd.uploadSize << " bytes";
+			break;
+		case COMMAND_MAX_ENUM:
+			break;
+		}
+
+		ss << "\t";
+		if (cmd.time >= 0.0)
+			ss << cmd.time;
+		ss << "\n";
+	}
+
+	std::string str = ss.str();
+	fs->write(filename, str.data(), (int64) str.size());
+}
+
+STRINGMAP_CLASS_BEGIN(FrameCapture, FrameCapture::CommandType, FrameCapture::COMMAND_MAX_ENUM, commandType)
+{
+	{ "batch",          FrameCapture::COMMAND_BATCH            },
+	{ "drawable",       FrameCapture::COMMAND_DRAWABLE         },
+	{ "drawfromshader", FrameCapture::COMMAND_DRAW_FROM_SHADER },
+	{ "clear",          FrameCapture::COMMAND_CLEAR            },
+	{ "textureupload",  FrameCapture::COMMAND_TEXTURE_UPLOAD   },
+}
+STRINGMAP_CLASS_END(FrameCapture, FrameCapture::CommandType, FrameCapture::COMMAND_MAX_ENUM, commandType)
+
+} // graphics
+} // love
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "common/Matrix.h"
+#include "common/StringMap.h"
+#include "Graphics.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Records the graphics commands issued between beginCapture and endCapture
+ * (batched geometry with its vertex data, other drawables, drawFromShader
+ * calls, clears and texture uploads), along with the graphics state each one
+ * was issued with. Unlike a DrawList, everything is still drawn normally
+ * while capturing.
+ *
+ * Replaying re-executes the commands in order with their captured state and
+ * measures the CPU time each one takes, which makes a frame's cost
+ * reproducible without the code that generated it.
+ **/
+class FrameCapture : public Object
+{
+public:
+
+	static love::Type type;
+
+	enum CommandType
+	{
+		COMMAND_BATCH,
+		COMMAND_DRAWABLE,
+		COMMAND_DRAW_FROM_SHADER,
+		COMMAND_CLEAR,
+		COMMAND_TEXTURE_UPLOAD,
+		COMMAND_MAX_ENUM
+	};
+
+	FrameCapture(Graphics *gfx);
+	virtual ~FrameCapture();
+
+	void beginCapture();
+	void endCapture();
+	bool isCapturing() const;
+
+	void clear();
+
+	int getCommandCount() const;
+	CommandType getCommandType(int index) const;
+
+	// CPU time in seconds of the command during the most recent replay, or a
+	// negative value if it hasn't been replayed.
+	double getCommandTime(int index) const;
+
+	/**
+	 * Re-executes every captured command with the state it was captured with.
+	 * The graphics state is restored afterwards. Returns the total CPU time.
+	 **/
+	double replay();
+
+	/**
+	 * Writes a text summary of the commands and their most recent replay times
+	 * to a file in the save directory.
+	 **/
+	void save(const char *filename) const;
+
+	// Called by Graphics while capturing.
+	void captureBatch();
+	void captureDrawable(Drawable *drawable, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount);
+	void captureDrawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Buffer *indexbuffer, int startindex, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture);
+	void captureClear(OptionalColorD color, const std::vector<OptionalColorD> &colors, OptionalInt stencil, OptionalDouble depth);
+	void captureTextureUpload(Texture *texture, const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
+
+	STRINGMAP_CLASS_DECLARE(CommandType);
+
+private:
+
+	struct Command
+	{
+		CommandType type;
+
+		Graphics::DisplayState state;
+		Matrix4 transform;
+
+		PrimitiveType primitiveMode = PRIMITIVE_TRIANGLES;
+		StrongRef<Texture> texture;
+
+		// COMMAND_BATCH. The vertex data is pre-transformed unless the batch
+		// is untransformed, in which case transform is the one it's drawn with.
+		CommonFormat formats[2] = {CommonFormat::NONE, CommonFormat::NONE};
+		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
+		bool untransformed = false;
+		int vertexCount = 0;
+		int indexCount = 0;
+		size_t vertexOffsets[2] = {0, 0};
+		size_t indexStart = 0;
+
+		// COMMAND_DRAWABLE. instanceCount is 0 for a regular draw. Indirect
+		// Mesh draws use the indirect fields below.
+		StrongRef<Drawable> drawable;
+		Matrix4 drawableTransform;
+		int instanceCount = 0;
+
+		// COMMAND_DRAW_FROM_SHADER. vertexCount is the index count when there's
+		// an index buffer.
+		StrongRef<Buffer> indexBuffer;
+		StrongRef<Buffer> indirectArgs;
+		int startIndex = 0;
+		int argsIndex = 0;
+		int drawCount = 0;
+
+		// COMMAND_CLEAR. clearColor applies to every render target when
+		// clearColors is empty.
+		OptionalColorD clearColor;
+		std::vector<OptionalColorD> clearColors;
+		OptionalInt clearStencil;
+		OptionalDouble clearDepth;
+
+		// COMMAND_TEXTURE_UPLOAD.
+		int slice = 0;
+		int mipmap = 0;
+		Rect rect = {};
+		bool reloadMipmaps = false;
+		size_t uploadOffset = 0;
+		size_t uploadSize = 0;
+
+		double time = -1.0;
+	};
+
+	Command &addCommand(CommandType type);
+
+	void replayCommand(Command &cmd);
+	void replayBatch(const Command &cmd);
+
+	Graphics *gfx;
+
+	std::vector<Command> commands;
+
+	std::vector<uint8> vertexData[2];
+	std::vector<uint16> indexData;
+	std::vector<uint8> uploadData;
+
+}; // FrameCapture
+
+} // graphics
+} // love
@@ -30,13 +30,25 @@
 #include "ParticleSystem.h"
 #include "Font.h"
 #include "Video.h"
+#include "VirtualTexture.h"
+#include "DrawList.h"
+#include "FrameCapture.h"
+#include "ComputePrimitives.h"
+#include "RenderGraph.h"
+#include "VideoRecorder.h"
 #include "TextBatch.h"
+#include "filesystem/Filesystem.h"
 #include "common/deprecation.h"
+#include "profiler/Profiler.h"
+#include "timer/Timer.h"
 #include "common/config.h"
 
 // C++
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdlib.h>
+#include <string.h>
 
 namespace love
 {
@@ -45,6 +57,8 @@ namespace graphics
 
 static bool gammaCorrect = false;
 static bool lowPowerPreferred = false;
+static bool shaderCacheEnabled = false;
+static int framesInFlight = 0;
 static bool debugMode = false;
 static bool debugModeQueried = false;
 
@@ -160,6 +174,78 @@ bool isLowPowerPreferred()
 	return lowPowerPreferred;
 }
 
+void setShaderCacheEnabled(bool enable)
+{
+	shaderCacheEnabled = enable;
+}
+
+bool isShaderCacheEnabled()
+{
+	return shaderCacheEnabled;
+}
+
+void setFramesInFlight(int frames)
+{
+	framesInFlight = std::max(frames, 0);
+}
+
+int getFramesInFlight()
+{
+	return framesInFlight;
+}
+
+static const char *SHADER_CACHE_DIRECTORY = "love_shadercache";
+
+bool readShaderCacheFile(const std::string &name, std::vector<uint8> &data)
+{
+	if (!shaderCacheEnabled)
+		return false;
+
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return false;
+
+	std::string path = std::string(SHADER_CACHE_DIRECTORY) + "/" + name;
+
+	try
+	{
+		if (!fs->exists(path.c_str()))
+			return false;
+
+		StrongRef<filesystem::FileData> filedata(fs->read(path.c_str()), Acquire::NORETAIN);
+
+		const uint8 *bytes = (const uint8 *) filedata->getData();
+		data.assign(bytes, bytes + filedata->getSize());
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void writeShaderCacheFile(const std::string &name, const void *data, size_t size)
+{
+	if (!shaderCacheEnabled)
+		return;
+
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return;
+
+	std::string path = std::string(SHADER_CACHE_DIRECTORY) + "/" + name;
+
+	try
+	{
+		fs->createDirectory(SHADER_CACHE_DIRECTORY);
+		fs->write(path.c_str(), data, (int64) size);
+	}
+	catch (love::Exception &)
+	{
+	}
+}
+
 Graphics *Graphics::createInstance()
 {
 	Graphics *instance = Module::getInstance<Graphics>(M_GRAPHICS);
@@ -197,6 +283,13 @@ Graphics::DisplayState::DisplayState()
 	defaultSamplerState.mipmapFilter = SamplerState::MIPMAP_FILTER_LINEAR;
 }
 
+static void updateMainThreadJobsWhileWaiting()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr)
+		gfx->updateMainThreadJobs();
+}
+
 Graphics::Graphics(const char *name)
 	: Module(M_GRAPHICS, name)
 	, width(0)
@@ -207,22 +300,32 @@ Graphics::Graphics(const char *name)
 	, backbufferHasDepth(false)
 	, created(false)
 	, active(true)
+	, redrawOnDemand(false)
+	, redrawTime(std::numeric_limits<double>::infinity())
+	, statsOverlayEnabled(false)
+	, arrayLayerBatching(false)
 	, batchedDrawState()
 	, deviceProjectionMatrix()
 	, renderTargetSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
+	, batchFlushCounts()
 	, quadIndexBuffer(nullptr)
 	, fanIndexBuffer(nullptr)
 	, capabilities()
 	, defaultTextures()
 	, defaultTexelBuffers()
 	, defaultStorageBuffer(nullptr)
+	, defaultUniformBuffer(nullptr)
+	, uniformBuffersVersion(1)
 	, cachedShaderStages()
 {
 	transformStack.reserve(16);
 	transformStack.push_back(Matrix4());
 
+	transformKindStack.reserve(16);
+	transformKindStack.push_back(TRANSFORM_IDENTITY);
+
 	pixelScaleStack.reserve(16);
 	pixelScaleStack.push_back(1);
 
@@ -233,17 +336,47 @@ Graphics::Graphics(const char *name)
 
 	if (!Shader::initialize())
 		throw love::Exception("Shader support failed to initialize.");
+
+	love::thread::setMainThreadWaitCallback(updateMainThreadJobsWhileWaiting);
 }
 
 Graphics::~Graphics()
 {
+	love::thread::setMainThreadWaitCallback(nullptr);
+
+	{
+		love::thread::Lock lock(mainThreadJobMutex);
+		mainThreadJobsStopped = true;
+		for (MainThreadJob *job : mainThreadJobs)
+		{
+			job->error = "The graphics module was destroyed before the function could run on the main thread.";
+			job->done = true;
+		}
+		mainThreadJobs.clear();
+		mainThreadJobCond->broadcast();
+	}
+
+	threadCreatedObjects.clear();
+
+	if (drawListRecording != nullptr)
+		drawListRecording->release();
+
+	if (frameCapture != nullptr)
+		frameCapture->release();
+
 	if (quadIndexBuffer != nullptr)
 		quadIndexBuffer->release();
 	if (fanIndexBuffer != nullptr)
 		fanIndexBuffer->release();
 
+	uniformBuffers.clear();
 	releaseDefaultResources();
 
+	ParticleSystem::releaseSharedResources();
+	ComputePrimitives::releaseSharedResources();
+	Texture::releaseSharedResources();
+	Font::releaseSharedResources();
+
 	// Clean up standard shaders before the active shader. If we do it after,
 	// the active shader may try to activate a standard shader when deactivating
 	// itself, which will cause problems since it calls Graphics methods in the
@@ -272,6 +405,8 @@ Graphics::~Graphics()
 		cachedShaderStages[i].clear();
 
 	pendingReadbacks.clear();
+	pendingTextureUploads.clear();
+	evictableTextures.clear();
 	clearTemporaryResources();
 
 	Shader::deinitialize();
@@ -336,14 +471,54 @@ Video *Graphics::newVideo(love::video::VideoStream *stream, float dpiscale)
 	return new Video(this, stream, dpiscale);
 }
 
-love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage)
+VideoRecorder *Graphics::newVideoRecorder(love::filesystem::File *file, int width, int height, int fpsnumerator, int fpsdenominator)
+{
+	return new VideoRecorder(this, file, width, height, fpsnumerator, fpsdenominator);
+}
+
+VirtualTexture *Graphics::newVirtualTexture(int width, int height, int pagesize, int cachesize, PixelFormat format, bool linear)
+{
+	return new VirtualTexture(this, width, height, pagesize, cachesize, format, linear);
+}
+
+DrawList *Graphics::newDrawList()
 {
-	return new SpriteBatch(this, texture, size, usage);
+	return new DrawList(this);
 }
 
-love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
+FrameCapture *Graphics::newFrameCapture()
 {
-	return new ParticleSystem(texture, size);
+	return new FrameCapture(this);
+}
+
+RenderGraph *Graphics::newRenderGraph()
+{
+	return new RenderGraph(this);
+}
+
+DynamicResolution *Graphics::newDynamicResolution(const DynamicResolution::Settings &settings)
+{
+	return new DynamicResolution(this, settings);
+}
+
+Atlas *Graphics::newAtlas(const Atlas::Settings &settings)
+{
+	return new Atlas(this, settings);
+}
+
+OcclusionQuery *Graphics::newOcclusionQuery()
+{
+	throw love::Exception("Occlusion queries are not supported on this system.");
+}
+
+love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced)
+{
+	return new SpriteBatch(this, texture, size, usage, instanced);
+}
+
+love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size, bool gpuSimulated)
+{
+	return new ParticleSystem(texture, size, gpuSimulated);
 }
 
 ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache)
@@ -351,16 +526,16 @@ ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &
 	ShaderStage *s = nullptr;
 	std::string cachekey;
 
-	// Never cache if there are custom defines set... because hashing would get
-	// more complicated/expensive, and there shouldn't be a lot of duplicate
-	// shader stages with custom defines anyway.
-	if (!options.defines.empty())
-		cache = false;
-
 	if (cache && !source.empty())
 	{
+		// Custom defines change the generated code, so shader variants which
+		// share source code are cached separately.
+		std::string keysource = source;
+		for (const auto &def : options.defines)
+			keysource += "\n#define " + def.first + " " + def.second;
+
 		data::HashFunction::Value hashvalue;
-		data::hash(data::HashFunction::FUNCTION_SHA1, source.c_str(), source.size(), hashvalue);
+		data::hash(data::HashFunction::FUNCTION_SHA1, keysource.c_str(), keysource.size(), hashvalue);
 
 		cachekey = std::string(hashvalue.data, hashvalue.size);
 
@@ -386,6 +561,8 @@ ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &
 
 Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options)
 {
+	LOVE_PROFILE_ZONE("love.graphics.newShader");
+
 	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM] = {};
 
 	bool validstages[SHADERSTAGE_MAX_ENUM] = {};
@@ -426,7 +603,9 @@ Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const
 
 	}
 
-	return newShaderInternal(stages, options);
+	Shader *shader = newShaderInternal(stages, options);
+	shader->setVariantSource(stagessource, false);
+	return shader;
 }
 
 Shader *Graphics::newComputeShader(const std::string &source, const Shader::CompileOptions &options)
@@ -442,7 +621,9 @@ Shader *Graphics::newComputeShader(const std::string &source, const Shader::Comp
 	// shouldn't be much reuse.
 	stages[SHADERSTAGE_COMPUTE].set(newShaderStage(SHADERSTAGE_COMPUTE, source, options, info, false));
 
-	return newShaderInternal(stages, options);
+	Shader *shader = newShaderInternal(stages, options);
+	shader->setVariantSource({source}, true);
+	return shader;
 }
 
 Buffer *Graphics::newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength)
@@ -494,7 +675,7 @@ GraphicsReadback *Graphics::readbackBufferAsync(Buffer *buffer, size_t offset, s
 image::ImageData *Graphics::readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
 {
 	StrongRef<GraphicsReadback> readback;
-	readback.set(newReadbackInternal(READBACK_IMMEDIATE, texture, slice, mipmap, rect, dest, destx, desty), Acquire::NORETAIN);
+	readback.set(newReadbackInternal(READBACK_IMMEDIATE, texture, slice, mipmap, rect, dest, destx, desty, nullptr, 0), Acquire::NORETAIN);
 
 	auto imagedata = readback->getImageData();
 	if (imagedata == nullptr)
@@ -504,13 +685,21 @@ image::ImageData *Graphics::readbackTexture(Texture *texture, int slice, int mip
 	return imagedata;
 }
 
-GraphicsReadback *Graphics::readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+GraphicsReadback *Graphics::readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset)
 {
-	auto readback = newReadbackInternal(READBACK_ASYNC, texture, slice, mipmap, rect, dest, destx, desty);
+	auto readback = newReadbackInternal(READBACK_ASYNC, texture, slice, mipmap, rect, dest, destx, desty, destbytes, destbytesoffset);
 	pendingReadbacks.push_back(readback);
 	return readback;
 }
 
+TextureUpload *Graphics::uploadTextureAsync(Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	auto upload = newTextureUploadInternal(texture, data, slice, mipmap, x, y, reloadmipmaps);
+	if (!upload->isComplete())
+		pendingTextureUploads.push_back(upload);
+	return upload;
+}
+
 void Graphics::cleanupCachedShaderStage(ShaderStageType type, const std::string &hashkey)
 {
 	cachedShaderStages[type].erase(hashkey);
@@ -683,6 +872,20 @@ Buffer *Graphics::getDefaultStorageBuffer()
 	return defaultStorageBuffer;
 }
 
+Buffer *Graphics::getDefaultUniformBuffer()
+{
+	if (defaultUniformBuffer != nullptr)
+		return defaultUniformBuffer;
+
+	Buffer::Settings settings(BUFFERUSAGEFLAG_UNIFORM, BUFFERDATAUSAGE_STATIC);
+	settings.zeroInitialize = true;
+	settings.debugName = "default_uniformbuffer";
+
+	defaultUniformBuffer = newBuffer(settings, DATAFORMAT_FLOAT_VEC4, nullptr, Buffer::UNIFORM_BUFFER_MAX_SIZE, 0);
+
+	return defaultUniformBuffer;
+}
+
 void Graphics::releaseDefaultResources()
 {
 	for (int type = 0; type < TEXTURE_MAX_ENUM; type++)
@@ -708,6 +911,10 @@ void Graphics::releaseDefaultResources()
 	if (defaultStorageBuffer)
 		defaultStorageBuffer->release();
 	defaultStorageBuffer = nullptr;
+
+	if (defaultUniformBuffer)
+		defaultUniformBuffer->release();
+	defaultUniformBuffer = nullptr;
 }
 
 Texture *Graphics::getTextureOrDefaultForActiveShader(Texture *tex)
@@ -802,6 +1009,61 @@ bool Graphics::isActive() const
 	return active && isCreated() && window != nullptr && window->isOpen();
 }
 
+void Graphics::setRedrawOnDemand(bool enable)
+{
+	// Make sure the first frame after switching is drawn.
+	if (enable && !redrawOnDemand)
+		invalidate();
+
+	redrawOnDemand = enable;
+}
+
+bool Graphics::isRedrawOnDemand() const
+{
+	return redrawOnDemand;
+}
+
+void Graphics::invalidate(double delay)
+{
+	double time = love::timer::Timer::getTime() + std::max(delay, 0.0);
+	redrawTime = std::min(redrawTime, time);
+}
+
+void Graphics::validate()
+{
+	redrawTime = std::numeric_limits<double>::infinity();
+}
+
+double Graphics::getRedrawDelay() const
+{
+	if (std::isinf(redrawTime))
+		return -1.0;
+
+	return std::max(redrawTime - love::timer::Timer::getTime(), 0.0);
+}
+
+void Graphics::setStatsOverlayEnabled(bool enable)
+{
+	// Don't measure a frame time across the time it was hidden.
+	if (enable && !statsOverlayEnabled)
+		statsOverlay.clear();
+
+	statsOverlayEnabled = enable;
+}
+
+bool Graphics::isStatsOverlayEnabled() const
+{
+	return statsOverlayEnabled;
+}
+
+void Graphics::drawStatsOverlay(double cputime, const std::vector<std::string> &lines)
+{
+	if (!statsOverlayEnabled)
+		return;
+
+	statsOverlay.draw(this, cputime, lines);
+}
+
 void Graphics::reset()
 {
 	DisplayState s;
@@ -828,6 +1090,7 @@ void Graphics::restoreState(const DisplayState &s)
 	setLineWidth(s.lineWidth);
 	setLineStyle(s.lineStyle);
 	setLineJoin(s.lineJoin);
+	setShapeRendering(s.shapeRendering);
 
 	setPointSize(s.pointSize);
 
@@ -873,6 +1136,7 @@ void Graphics::restoreStateChecked(const DisplayState &s)
 	setLineWidth(s.lineWidth);
 	setLineStyle(s.lineStyle);
 	setLineJoin(s.lineJoin);
+	setShapeRendering(s.shapeRendering);
 
 	if (s.pointSize != cur.pointSize)
 		setPointSize(s.pointSize);
@@ -911,7 +1175,7 @@ void Graphics::restoreStateChecked(const DisplayState &s)
 		if (!rtschanged && sRTs.depthStencil != curRTs.depthStencil)
 			rtschanged = true;
 
-		if (sRTs.temporaryRTFlags != curRTs.temporaryRTFlags)
+		if (sRTs.temporaryRTFlags != curRTs.temporaryRTFlags || sRTs.resolve != curRTs.resolve)
 			rtschanged = true;
 	}
 
@@ -1003,6 +1267,34 @@ love::graphics::Shader *Graphics::getShader() const
 	return states.back().shader.get();
 }
 
+void Graphics::setUniformBuffer(const std::string &name, Buffer *buffer)
+{
+	if (buffer != nullptr && (buffer->getUsageFlags() & BUFFERUSAGEFLAG_UNIFORM) == 0)
+		throw love::Exception("Buffer must be created with uniform buffer usage in order to be used for uniform blocks.");
+
+	if (getUniformBuffer(name) == buffer)
+		return;
+
+	flushBatchedDraws(BATCHFLUSH_UNIFORM);
+
+	if (buffer != nullptr)
+		uniformBuffers[name].set(buffer);
+	else
+		uniformBuffers.erase(name);
+
+	uniformBuffersVersion++;
+
+	// Other shaders pick up the change the next time they're attached.
+	if (Shader::current != nullptr)
+		Shader::current->updateSharedUniformBuffers();
+}
+
+Buffer *Graphics::getUniformBuffer(const std::string &name) const
+{
+	const auto it = uniformBuffers.find(name);
+	return it != uniformBuffers.end() ? it->second.get() : nullptr;
+}
+
 void Graphics::setRenderTarget(RenderTarget rt, uint32 temporaryRTFlags)
 {
 	if (rt.texture == nullptr)
@@ -1025,6 +1317,7 @@ void Graphics::setRenderTargets(const RenderTargetsStrongRef &rts)
 
 	targets.depthStencil = RenderTarget(rts.depthStencil.texture, rts.depthStencil.slice, rts.depthStencil.mipmap);
 	targets.temporaryRTFlags = rts.temporaryRTFlags;
+	targets.resolve = rts.resolve;
 
 	return setRenderTargets(targets);
 }
@@ -1058,7 +1351,7 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 		if (!modified && rts.depthStencil != prevRTsRef.depthStencil)
 			modified = true;
 
-		if (rts.temporaryRTFlags != prevRTsRef.temporaryRTFlags)
+		if (rts.temporaryRTFlags != prevRTsRef.temporaryRTFlags || rts.resolve != prevRTsRef.resolve)
 			modified = true;
 
 		if (!modified)
@@ -1102,6 +1395,9 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 		if (isPixelFormatSRGB(format))
 			hasSRGBtexture = true;
+
+		if (!rts.resolve && c->getMSAA() > 1 && c->isTransient())
+			throw love::Exception("Transient MSAA textures must be resolved at the end of each pass.");
 	}
 
 	if (rts.depthStencil.texture != nullptr)
@@ -1129,7 +1425,7 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 			throw love::Exception("Invalid slice index: %d.", slice + 1);
 	}
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 	if (rts.depthStencil.texture == nullptr && rts.temporaryRTFlags != 0)
 	{
@@ -1197,9 +1493,12 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 	refs.depthStencil = RenderTargetStrongRef(rts.depthStencil.texture, rts.depthStencil.slice);
 	refs.temporaryRTFlags = rts.temporaryRTFlags;
+	refs.resolve = rts.resolve;
 
 	std::swap(state.renderTargets, refs);
 
+	updateResolvePending(prevRTs);
+
 	renderTargetSwitchCount++;
 
 	resetProjection();
@@ -1232,12 +1531,14 @@ void Graphics::setRenderTarget()
 
 	const RenderTargetsStrongRef prevRTs = state.renderTargets;
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 	setRenderTargetsInternal(RenderTargets(), pixelWidth, pixelHeight, isGammaCorrect());
 
 	state.renderTargets = RenderTargetsStrongRef();
 	renderTargetSwitchCount++;
 
+	updateResolvePending(prevRTs);
+
 	resetProjection();
 
 	// generateMipmaps can't be used for depth/stencil textures.
@@ -1260,10 +1561,22 @@ Graphics::RenderTargets Graphics::getRenderTargets() const
 
 	rts.depthStencil = RenderTarget(curRTs.depthStencil.texture, curRTs.depthStencil.slice, curRTs.depthStencil.mipmap);
 	rts.temporaryRTFlags = curRTs.temporaryRTFlags;
+	rts.resolve = curRTs.resolve;
 
 	return rts;
 }
 
+void Graphics::updateResolvePending(const RenderTargetsStrongRef &endedRTs)
+{
+	// The pass which rendered to these targets has just ended.
+	for (const auto &rt : endedRTs.colors)
+	{
+		Texture *tex = rt.texture.get();
+		if (tex != nullptr && tex->getMSAA() > 1 && tex->isReadable())
+			tex->setResolvePending(!endedRTs.resolve);
+	}
+}
+
 bool Graphics::isRenderTargetActive() const
 {
 	const auto &rts = states.back().renderTargets;
@@ -1362,6 +1675,18 @@ void Graphics::releaseTemporaryTexture(Texture *texture)
 	}
 }
 
+Texture *Graphics::getTemporaryCanvas(PixelFormat format, int w, int h, int msaa)
+{
+	if (w <= 0 || h <= 0)
+		throw love::Exception("Temporary canvas dimensions must be greater than 0.");
+
+	// Pooled textures are matched by their sized format.
+	Texture *texture = getTemporaryTexture(getSizedFormat(format), w, h, std::max(msaa, 1));
+	frameTemporaryTextures.push_back(texture);
+
+	return texture;
+}
+
 Buffer *Graphics::getTemporaryBuffer(size_t size, DataFormat format, uint32 usageflags, BufferDataUsage datausage)
 {
 	Buffer *buffer = nullptr;
@@ -1405,8 +1730,147 @@ void Graphics::releaseTemporaryBuffer(Buffer *buffer)
 	}
 }
 
+void Graphics::registerEvictableTexture(Texture *texture)
+{
+	evictableTextures.push_back(texture);
+}
+
+void Graphics::unregisterEvictableTexture(Texture *texture)
+{
+	auto it = std::find(evictableTextures.begin(), evictableTextures.end(), texture);
+	if (it != evictableTextures.end())
+	{
+		*it = evictableTextures.back();
+		evictableTextures.pop_back();
+	}
+}
+
+void Graphics::setTextureMemoryBudget(int64 bytes)
+{
+	textureMemoryBudget = std::max(bytes, (int64) 0);
+}
+
+int64 Graphics::getTextureMemoryBudget() const
+{
+	return textureMemoryBudget;
+}
+
+void Graphics::setTextureStreamingBudget(int64 bytes)
+{
+	textureStreamingBudget = std::max(bytes, (int64) 0);
+}
+
+int64 Graphics::getTextureStreamingBudget() const
+{
+	return textureStreamingBudget;
+}
+
+void Graphics::setFrameLatency(int frames)
+{
+	frameLatency = std::min(std::max(frames, 0), MAX_FRAME_LATENCY);
+}
+
+int Graphics::getFrameLatency() const
+{
+	return frameLatency;
+}
+
+void Graphics::setDrawReorderWindow(int draws)
+{
+	flushBatchedDraws();
+	drawReorderState.window = std::min(std::max(draws, 0), MAX_DRAW_REORDER_WINDOW);
+}
+
+int Graphics::getDrawReorderWindow() const
+{
+	return drawReorderState.window;
+}
+
+void Graphics::updateTextureStreaming()
+{
+	std::vector<Texture *> waiting;
+	for (Texture *tex : evictableTextures)
+	{
+		if (tex->isStreaming() && tex->getStreamingDemand() < tex->getResidentMipmap())
+			waiting.push_back(tex);
+	}
+
+	// Textures furthest from the detail they're drawn at go first.
+	std::sort(waiting.begin(), waiting.end(), [](const Texture *a, const Texture *b)
+	{
+		return a->getResidentMipmap() - a->getStreamingDemand() > b->getResidentMipmap() - b->getStreamingDemand();
+	});
+
+	int64 uploaded = 0;
+
+	// Each texture gets at most one level larger per frame.
+	for (Texture *tex : waiting)
+	{
+		int mip = tex->getResidentMipmap() - 1;
+		int64 size = (int64) getPixelFormatSliceSize(tex->getPixelFormat(), tex->getPixelWidth(mip), tex->getPixelHeight(mip));
+
+		if (uploaded > 0 && uploaded + size > textureStreamingBudget)
+			break;
+
+		if (tex->setResidentMipmap(mip))
+			uploaded += size;
+	}
+
+	for (Texture *tex : evictableTextures)
+	{
+		if (tex->isStreaming())
+			tex->resetStreamingDemand();
+	}
+}
+
+void Graphics::updateTextureResidency()
+{
+	updateTextureStreaming();
+
+	for (Texture *tex : evictableTextures)
+		tex->incrementFramesSinceUse();
+
+	if (textureMemoryBudget <= 0 || Texture::totalGraphicsMemory <= textureMemoryBudget)
+		return;
+
+	std::vector<Texture *> candidates;
+	for (Texture *tex : evictableTextures)
+	{
+		if (tex->getFramesSinceUse() >= MIN_EVICTION_UNUSED_FRAMES && tex->getResidentMipmap() < tex->getMipmapCount() - 1)
+			candidates.push_back(tex);
+	}
+
+	// Least recently used first, and the largest first out of those.
+	std::sort(candidates.begin(), candidates.end(), [](const Texture *a, const Texture *b)
+	{
+		if (a->getFramesSinceUse() != b->getFramesSinceUse())
+			return a->getFramesSinceUse() > b->getFramesSinceUse();
+		return a->getGraphicsMemorySize() > b->getGraphicsMemorySize();
+	});
+
+	// Every candidate loses at most one mipmap level per frame, so textures
+	// are demoted in steps rather than fully thrown out at once.
+	for (Texture *tex : candidates)
+	{
+		if (Texture::totalGraphicsMemory <= textureMemoryBudget)
+			break;
+
+		tex->setResidentMipmap(tex->getResidentMipmap() + 1);
+	}
+}
+
 void Graphics::updateTemporaryResources()
 {
+	// Called once at the end of every present.
+	presentedFrameCount++;
+
+	// The frame's GPU work has been submitted, so commands using these in
+	// later frames are ordered after it.
+	for (Texture *texture : frameTemporaryTextures)
+		releaseTemporaryTexture(texture);
+
+	frameTemporaryTextures.clear();
+
 	for (int i = (int) temporaryTextures.size() - 1; i >= 0; i--)
 	{
 		auto &t = temporaryTextures[i];
@@ -1444,51 +1908,174 @@ void Graphics::clearTemporaryResources()
 
 	temporaryBuffers.clear();
 	temporaryTextures.clear();
+	frameTemporaryTextures.clear();
 }
 
 void Graphics::updatePendingReadbacks()
 {
-	for (int i = (int)pendingReadbacks.size() - 1; i >= 0; i--)
+	std::vector<StrongRef<GraphicsReadback>> completed;
+	size_t count = 0;
+
+	// Keep the pending list in submission order, so completion callbacks of
+	// per-frame readbacks are called in the same order they were started.
+	for (size_t i = 0; i < pendingReadbacks.size(); i++)
 	{
 		pendingReadbacks[i]->update();
 		if (pendingReadbacks[i]->isComplete())
 		{
-			pendingReadbacks[i] = pendingReadbacks.back();
-			pendingReadbacks.pop_back();
+			if (pendingReadbacks[i]->hasCompletionCallback())
+				completed.push_back(pendingReadbacks[i]);
 		}
+		else
+			pendingReadbacks[count++] = pendingReadbacks[i];
 	}
+
+	pendingReadbacks.erase(pendingReadbacks.begin() + count, pendingReadbacks.end());
+
+	// Callbacks can start new readbacks, so they're run after the pending
+	// list is no longer being iterated.
+	for (auto &readback : completed)
+		readback->runCompletionCallback();
 }
 
-VertexAttributesID Graphics::registerVertexAttributes(const VertexAttributes &attributes)
+bool Graphics::isMainThread() const
 {
-	for (size_t i = 0; i < vertexAttributesDatabase.size(); i++)
+	return std::this_thread::get_id() == mainThreadID;
+}
+
+void Graphics::runOnMainThread(const std::function<void()> &func)
+{
+	if (isMainThread())
 	{
-		if (attributes == vertexAttributesDatabase[i])
-			return { (int)i + 1 };
+		func();
+		return;
 	}
 
-	vertexAttributesDatabase.push_back(attributes);
-	return { (int)vertexAttributesDatabase.size() };
+	MainThreadJob job = {&func, std::string(), false};
+
+	love::thread::Lock lock(mainThreadJobMutex);
+
+	if (mainThreadJobsStopped)
+		throw love::Exception("The graphics module has been destroyed.");
+
+	mainThreadJobs.push_back(&job);
+
+	while (!job.done)
+		mainThreadJobCond->wait(mainThreadJobMutex);
+
+	if (!job.error.empty())
+		throw love::Exception("%s", job.error.c_str());
 }
 
-bool Graphics::findVertexAttributes(VertexAttributesID id, VertexAttributes &attributes)
+void Graphics::deferThreadedRelease(Object *object)
 {
-	int index = id.id - 1;
+	threadCreatedObjects.emplace_back(object);
+}
 
-	if (index < 0 || index >= (int)vertexAttributesDatabase.size())
-		return false;
+void Graphics::setThreadedCreationBudget(double seconds)
+{
+	threadedCreationBudget = std::max(seconds, 0.0);
+}
 
-	attributes = vertexAttributesDatabase[index];
-	return true;
+double Graphics::getThreadedCreationBudget() const
+{
+	return threadedCreationBudget;
 }
 
-void Graphics::intersectScissor(const Rect &rect)
+void Graphics::updateMainThreadJobs()
 {
-	Rect currect = states.back().scissorRect;
+	double start = love::timer::Timer::getTime();
 
-	if (!states.back().scissor)
+	while (true)
 	{
-		currect.x = 0;
+		MainThreadJob *job = nullptr;
+
+		{
+			love::thread::Lock lock(mainThreadJobMutex);
+			if (mainThreadJobs.empty())
+				break;
+			job = mainThreadJobs.front();
+			mainThreadJobs.erase(mainThreadJobs.begin());
+		}
+
+		std::string error;
+		try
+		{
+			(*job->func)();
+		}
+		catch (std::exception &e)
+		{
+			error = e.what();
+			if (error.empty())
+				error = "Unknown error.";
+		}
+
+		{
+			love::thread::Lock lock(mainThreadJobMutex);
+			job->error = error;
+			job->done = true;
+			mainThreadJobCond->broadcast();
+		}
+
+		if (love::timer::Timer::getTime() - start >= threadedCreationBudget)
+			break;
+	}
+
+	// Objects only Graphics still references were dropped by the threads they
+	// were created for.
+	for (int i = (int) threadCreatedObjects.size() - 1; i >= 0; i--)
+	{
+		if (threadCreatedObjects[i]->getReferenceCount() == 1)
+		{
+			threadCreatedObjects[i] = threadCreatedObjects.back();
+			threadCreatedObjects.pop_back();
+		}
+	}
+}
+
+void Graphics::updatePendingTextureUploads()
+{
+	for (int i = (int)pendingTextureUploads.size() - 1; i >= 0; i--)
+	{
+		pendingTextureUploads[i]->update();
+		if (pendingTextureUploads[i]->isComplete())
+		{
+			pendingTextureUploads[i] = pendingTextureUploads.back();
+			pendingTextureUploads.pop_back();
+		}
+	}
+}
+
+VertexAttributesID Graphics::registerVertexAttributes(const VertexAttributes &attributes)
+{
+	for (size_t i = 0; i < vertexAttributesDatabase.size(); i++)
+	{
+		if (attributes == vertexAttributesDatabase[i])
+			return { (int)i + 1 };
+	}
+
+	vertexAttributesDatabase.push_back(attributes);
+	return { (int)vertexAttributesDatabase.size() };
+}
+
+bool Graphics::findVertexAttributes(VertexAttributesID id, VertexAttributes &attributes)
+{
+	int index = id.id - 1;
+
+	if (index < 0 || index >= (int)vertexAttributesDatabase.size())
+		return false;
+
+	attributes = vertexAttributesDatabase[index];
+	return true;
+}
+
+void Graphics::intersectScissor(const Rect &rect)
+{
+	Rect currect = states.back().scissorRect;
+
+	if (!states.back().scissor)
+	{
+		currect.x = 0;
 		currect.y = 0;
 		currect.w = std::numeric_limits<int>::max();
 		currect.h = std::numeric_limits<int>::max();
@@ -1511,6 +2098,30 @@ bool Graphics::getScissor(Rect &rect) const
 	return state.scissor;
 }
 
+Rect Graphics::getVisibleArea() const
+{
+	Rect view = {0, 0, getWidth(), getHeight()};
+
+	const auto &rt = states.back().renderTargets.getFirstTarget();
+	if (rt.texture.get() != nullptr)
+	{
+		view.w = rt.texture->getWidth(rt.mipmap);
+		view.h = rt.texture->getHeight(rt.mipmap);
+	}
+
+	Rect scissor;
+	if (getScissor(scissor))
+	{
+		int x1 = std::max(view.x, scissor.x);
+		int y1 = std::max(view.y, scissor.y);
+		int x2 = std::min(view.x + view.w, scissor.x + scissor.w);
+		int y2 = std::min(view.y + view.h, scissor.y + scissor.h);
+		view = {x1, y1, std::max(x2 - x1, 0), std::max(y2 - y1, 0)};
+	}
+
+	return view;
+}
+
 void Graphics::setStencilMode(StencilMode mode, int value)
 {
 	setStencilState(computeStencilState(mode, value));
@@ -1641,6 +2252,16 @@ Graphics::LineJoin Graphics::getLineJoin() const
 	return states.back().lineJoin;
 }
 
+void Graphics::setShapeRendering(ShapeRendering rendering)
+{
+	states.back().shapeRendering = rendering;
+}
+
+Graphics::ShapeRendering Graphics::getShapeRendering() const
+{
+	return states.back().shapeRendering;
+}
+
 float Graphics::getPointSize() const
 {
 	return states.back().pointSize;
@@ -1651,6 +2272,16 @@ bool Graphics::isWireframe() const
 	return states.back().wireframe;
 }
 
+void Graphics::setArrayLayerBatching(bool enable)
+{
+	arrayLayerBatching = enable;
+}
+
+bool Graphics::isArrayLayerBatching() const
+{
+	return arrayLayerBatching;
+}
+
 void Graphics::captureScreenshot(const ScreenshotInfo &info)
 {
 	pendingScreenshotCallbacks.push_back(info);
@@ -1790,6 +2421,9 @@ void Graphics::copyBufferToTexture(Buffer *source, Texture *dest, size_t sourceo
 	if (isRenderTargetActive(dest))
 		throw love::Exception("copyBufferToTexture cannot be called while the Texture is an active render target.");
 
+	if (dest->isEvictable())
+		throw love::Exception("copyBufferToTexture cannot be called on evictable Textures.");
+
 	if (mipmap < 0 || mipmap >= dest->getMipmapCount())
 		throw love::Exception("Invalid texture mipmap index %d.", mipmap + 1);
 
@@ -1866,7 +2500,19 @@ static const char *getIndirectArgsTypeName(Graphics::IndirectArgsType argstype)
 	return "(Unknown argument data)";
 }
 
-void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex)
+size_t Graphics::getIndirectArgsStride(IndirectArgsType argstype)
+{
+	switch (argstype)
+	{
+		case INDIRECT_ARGS_DISPATCH: return sizeof(uint32) * 3;
+		case INDIRECT_ARGS_DRAW_VERTICES: return sizeof(uint32) * 4;
+		case INDIRECT_ARGS_DRAW_INDICES: return sizeof(uint32) * 5;
+	}
+
+	return 0;
+}
+
+void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex, int count)
 {
 	if (!capabilities.features[FEATURE_INDIRECT_DRAW])
 		throw love::Exception("Indirect draws and compute dispatches are not supported on this system.");
@@ -1877,13 +2523,10 @@ void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *ind
 	if (argsindex < 0)
 		throw love::Exception("The given indirect argument index cannot be negative.");
 
-	size_t argelements = 0;
-	if (argstype == INDIRECT_ARGS_DISPATCH)
-		argelements = 3;
-	else if (argstype == INDIRECT_ARGS_DRAW_VERTICES)
-		argelements = 4;
-	else if (argstype == INDIRECT_ARGS_DRAW_INDICES)
-		argelements = 5;
+	if (count <= 0)
+		throw love::Exception("The number of indirect argument records to use must be positive.");
+
+	size_t argelements = getIndirectArgsStride(argstype) / sizeof(uint32);
 
 	size_t totalmembers = indirectargs->getArrayLength() * indirectargs->getDataMembers().size();
 
@@ -1892,8 +2535,13 @@ void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *ind
 
 	size_t argsoffset = argsindex * indirectargs->getArrayStride();
 
-	if (indirectargs->getSize() < argsoffset + sizeof(uint32) * argelements)
-		throw love::Exception("The given index into the indirect argument Buffer does not fit within the Buffer's size.");
+	if (indirectargs->getSize() < argsoffset + sizeof(uint32) * argelements * count)
+	{
+		if (count > 1)
+			throw love::Exception("The given index and draw count do not fit within the indirect argument Buffer's size.");
+		else
+			throw love::Exception("The given index into the indirect argument Buffer does not fit within the Buffer's size.");
+	}
 }
 
 void Graphics::dispatchThreadgroups(Shader *shader, int x, int y, int z)
@@ -1911,7 +2559,7 @@ void Graphics::dispatchThreadgroups(Shader *shader, int x, int y, int z)
 		throw love::Exception("Too many threadgroups dispatched.");
 	}
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 
 	auto prevshader = Shader::current;
 	shader->attach();
@@ -1930,9 +2578,9 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 	if (!shader->hasStage(SHADERSTAGE_COMPUTE))
 		throw love::Exception("Only compute shaders can have threads dispatched.");
 
-	validateIndirectArgsBuffer(INDIRECT_ARGS_DISPATCH, indirectargs, argsindex);
+	validateIndirectArgsBuffer(INDIRECT_ARGS_DISPATCH, indirectargs, argsindex, 1);
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 
 	auto prevshader = Shader::current;
 	shader->attach();
@@ -1946,27 +2594,102 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 		throw love::Exception("Compute shader must have resources bound to all writable texture and buffer variables.");
 }
 
-Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &cmd)
+void Graphics::prefixSum(Buffer *source, Buffer *dest, int count)
+{
+	if (!capabilities.features[FEATURE_GLSL4])
+		throw love::Exception("Compute shaders are not supported on this system.");
+
+	ComputePrimitives::prefixSum(this, source, dest, count);
+}
+
+void Graphics::radixSort(Buffer *keys, Buffer *values, int count, int keybits)
+{
+	if (!capabilities.features[FEATURE_GLSL4])
+		throw love::Exception("Compute shaders are not supported on this system.");
+
+	ComputePrimitives::radixSort(this, keys, values, count, keybits);
+}
+
+void Graphics::compactBuffer(Buffer *flags, Buffer *source, Buffer *dest, int count, Buffer *countbuffer, int countindex)
 {
+	if (!capabilities.features[FEATURE_GLSL4])
+		throw love::Exception("Compute shaders are not supported on this system.");
+
+	ComputePrimitives::compact(this, flags, source, dest, count, countbuffer, countindex);
+}
+
+Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &command)
+{
+	DrawReorderState &reorder = drawReorderState;
+
+	if (reorder.window > 0 && !reorder.replaying)
+	{
+		if (isDrawReorderable(command))
+			return addReorderedDraw(command);
+
+		// Draws that can't be reordered keep their place after everything
+		// in the window.
+		flushDrawReorderWindow();
+	}
+
 	BatchedDrawState &state = batchedDrawState;
+	BatchedDrawCommand cmd = command;
 
 	bool shouldflush = false;
 	bool shouldresize = false;
+	BatchFlushReason flushreason = BATCHFLUSH_OTHER;
 
-	if (cmd.primitiveMode != state.primitiveMode
-		|| cmd.formats[0] != state.formats[0] || cmd.formats[1] != state.formats[1]
-		|| ((cmd.indexMode != TRIANGLEINDEX_NONE) != (state.indexCount > 0))
-		|| cmd.texture != state.texture
-		|| cmd.standardShaderType != state.standardShaderType)
+	// The first reason found is the one that's counted.
+	auto flushfor = [&](BatchFlushReason reason)
 	{
+		if (!shouldflush)
+			flushreason = reason;
 		shouldflush = true;
+	};
+
+	// Large draws leave their vertices untransformed and get a batch (and
+	// draw call) of their own, so the CPU work scales with the number of draws
+	// rather than vertices. DrawLists replay vertices with their own transform.
+	// With an identity transform and no local one, pre-transformed vertices
+	// are just copies.
+	bool identity = transformKindStack.back() == TRANSFORM_IDENTITY && cmd.localTransform == nullptr;
+	bool untransformed = cmd.allowUntransformed && !identity
+		&& cmd.vertexCount >= MIN_UNTRANSFORMED_BATCH_VERTICES
+		&& drawListRecording == nullptr;
+
+	Matrix4 transform;
+
+	if (untransformed)
+	{
+		// Untransformed positions are always 2D.
+		if (cmd.formats[0] == CommonFormat::XYZf)
+			cmd.formats[0] = CommonFormat::XYf;
+
+		if (cmd.localTransform != nullptr)
+			transform = getCombinedTransform(*cmd.localTransform);
+		else
+			transform = getTransform();
+
+		if (!state.untransformed || memcmp(state.transform.getElements(), transform.getElements(), sizeof(float) * 16) != 0)
+			flushfor(BATCHFLUSH_TRANSFORM);
 	}
+	else if (state.untransformed)
+		flushfor(BATCHFLUSH_TRANSFORM);
+
+	if (cmd.primitiveMode != state.primitiveMode || ((cmd.indexMode != TRIANGLEINDEX_NONE) != (state.indexCount > 0)))
+		flushfor(BATCHFLUSH_PRIMITIVE);
+	else if (cmd.formats[0] != state.formats[0] || cmd.formats[1] != state.formats[1])
+		flushfor(BATCHFLUSH_VERTEX_FORMAT);
+	else if (cmd.texture != state.texture)
+		flushfor(BATCHFLUSH_TEXTURE);
+	else if (cmd.standardShaderType != state.standardShaderType)
+		flushfor(BATCHFLUSH_SHADER);
 
 	int totalvertices = state.vertexCount + cmd.vertexCount;
 
 	// We only support uint16 index buffers for now.
 	if (totalvertices > LOVE_UINT16_MAX && cmd.indexMode != TRIANGLEINDEX_NONE)
-		shouldflush = true;
+		flushfor(BATCHFLUSH_BUFFER_FULL);
 
 	int reqIndexCount = getIndexCount(cmd.indexMode, cmd.vertexCount);
 	size_t reqIndexSize = reqIndexCount * sizeof(uint16);
@@ -1983,7 +2706,7 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 		size_t datasize = stride * totalvertices;
 
 		if (state.vbMap[i].data != nullptr && datasize > state.vbMap[i].size)
-			shouldflush = true;
+			flushfor(BATCHFLUSH_BUFFER_FULL);
 
 		if (datasize > state.vb[i]->getUsableSize())
 		{
@@ -1999,7 +2722,7 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 		size_t datasize = (state.indexCount + reqIndexCount) * sizeof(uint16);
 
 		if (state.indexBufferMap.data != nullptr && datasize > state.indexBufferMap.size)
-			shouldflush = true;
+			flushfor(BATCHFLUSH_BUFFER_FULL);
 
 		if (datasize > state.indexBuffer->getUsableSize())
 		{
@@ -2010,13 +2733,17 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	if (shouldflush || shouldresize)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(shouldflush ? flushreason : BATCHFLUSH_BUFFER_FULL);
 
 		state.primitiveMode = cmd.primitiveMode;
 		state.formats[0] = cmd.formats[0];
 		state.formats[1] = cmd.formats[1];
 		state.texture = cmd.texture;
 		state.standardShaderType = cmd.standardShaderType;
+		state.untransformed = untransformed;
+
+		if (untransformed)
+			state.transform = transform;
 	}
 
 	if (state.vertexCount == 0)
@@ -2059,6 +2786,8 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	BatchedVertexData d;
 
+	d.transformVertices = !untransformed && !(cmd.allowUntransformed && identity);
+
 	for (int i = 0; i < 2; i++)
 	{
 		if (newdatasizes[i] > 0)
@@ -2081,13 +2810,20 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 	return d;
 }
 
-void Graphics::flushBatchedDraws()
+void Graphics::flushBatchedDraws(BatchFlushReason reason)
 {
+	LOVE_PROFILE_ZONE("love.graphics.flushBatchedDraws");
+
 	auto &sbstate = batchedDrawState;
 
+	if (!drawReorderState.draws.empty() && !drawReorderState.replaying)
+		flushDrawReorderWindow();
+
 	if ((sbstate.vertexCount == 0 && sbstate.indexCount == 0) || sbstate.flushing)
 		return;
 
+	batchFlushCounts[reason]++;
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
@@ -2102,6 +2838,12 @@ void Graphics::flushBatchedDraws()
 		sbstate.attributesIDs[(int)sbstate.formats[0]][(int)sbstate.formats[1]] = attributesID;
 	}
 
+	if (drawListRecording != nullptr)
+		return recordBatchedDraws();
+
+	if (getActiveFrameCapture() != nullptr)
+		frameCapture->captureBatch();
+
 	size_t usedsizes[3] = {0, 0, 0};
 
 	for (int i = 0; i < 2; i++)
@@ -2127,6 +2869,12 @@ void Graphics::flushBatchedDraws()
 
 	pushIdentityTransform();
 
+	if (sbstate.untransformed)
+	{
+		transformStack.back() = sbstate.transform;
+		updateTransformKind();
+	}
+
 	if (sbstate.indexCount > 0)
 	{
 		usedsizes[2] = sizeof(uint16) * sbstate.indexCount;
@@ -2170,11 +2918,391 @@ void Graphics::flushBatchedDraws()
 	sbstate.flushing = false;
 }
 
-void Graphics::flushBatchedDrawsGlobal()
+void Graphics::recordBatchedDraws()
+{
+	auto &sbstate = batchedDrawState;
+
+	DrawList::RecordedDraw draw = {};
+	draw.primitiveMode = sbstate.primitiveMode;
+	draw.texture = sbstate.texture;
+	draw.shader = Shader::isDefaultActive() ? nullptr : Shader::current;
+	draw.standardShaderType = sbstate.standardShaderType;
+	draw.vertexCount = sbstate.vertexCount;
+	draw.indexCount = sbstate.indexCount;
+
+	size_t usedsizes[3] = {0, 0, 0};
+
+	// The mapped pointers have been advanced past everything written since
+	// the last flush.
+	for (int i = 0; i < 2; i++)
+	{
+		draw.formats[i] = sbstate.formats[i];
+		if (sbstate.formats[i] == CommonFormat::NONE)
+			continue;
+
+		usedsizes[i] = getFormatStride(sbstate.formats[i]) * sbstate.vertexCount;
+		draw.vertexData[i] = sbstate.vbMap[i].data - usedsizes[i];
+	}
+
+	if (sbstate.indexCount > 0)
+	{
+		usedsizes[2] = sizeof(uint16) * sbstate.indexCount;
+		draw.indexData = (const uint16 *) (sbstate.indexBufferMap.data - usedsizes[2]);
+	}
+
+	sbstate.flushing = true;
+
+	drawListRecording->addDraw(draw);
+
+	// Nothing is drawn, so the stream buffer space isn't marked as used and
+	// gets overwritten by the next batch.
+	for (int i = 0; i < 2; i++)
+	{
+		if (sbstate.formats[i] == CommonFormat::NONE)
+			continue;
+
+		sbstate.vb[i]->unmap(usedsizes[i]);
+		sbstate.vbMap[i] = StreamBuffer::MapInfo();
+	}
+
+	if (sbstate.indexCount > 0)
+	{
+		sbstate.indexBuffer->unmap(usedsizes[2]);
+		sbstate.indexBufferMap = StreamBuffer::MapInfo();
+	}
+
+	sbstate.vertexCount = 0;
+	sbstate.indexCount = 0;
+	sbstate.flushing = false;
+}
+
+bool Graphics::isDrawReorderable(const BatchedDrawCommand &cmd) const
+{
+	// Bounds are only known for 2D triangles. Points are sized in pixels.
+	if (cmd.primitiveMode != PRIMITIVE_TRIANGLES || cmd.vertexCount <= 0)
+		return false;
+
+	switch (cmd.formats[0])
+	{
+	case CommonFormat::XYf:
+	case CommonFormat::XYf_STf:
+	case CommonFormat::XYf_STPf:
+	case CommonFormat::XYf_STf_RGBAub:
+	case CommonFormat::XYf_STus_RGBAub:
+	case CommonFormat::XYf_STPf_RGBAub:
+		break;
+	default:
+		return false;
+	}
+
+	// Large draws are cheaper to leave untransformed in a batch of their own.
+	if (cmd.allowUntransformed && cmd.vertexCount >= MIN_UNTRANSFORMED_BATCH_VERTICES)
+		return false;
+
+	if (cmd.indexMode != TRIANGLEINDEX_NONE && cmd.vertexCount > LOVE_UINT16_MAX)
+		return false;
+
+	if (drawListRecording != nullptr)
+		return false;
+
+	// These standard shaders get textures sent per draw, which only flushes
+	// batched draws while they're active.
+	if (cmd.standardShaderType == Shader::STANDARD_VIDEO || cmd.standardShaderType == Shader::STANDARD_PALETTE)
+		return false;
+
+	// Custom vertex code can move vertices outside of their bounds.
+	if (Shader::current != nullptr && !Shader::isDefaultActive() && !Shader::current->hasDefaultVertexStage())
+		return false;
+
+	return true;
+}
+
+Graphics::BatchedVertexData Graphics::addReorderedDraw(const BatchedDrawCommand &cmd)
+{
+	DrawReorderState &reorder = drawReorderState;
+
+	if ((int) reorder.draws.size() >= reorder.window)
+		flushDrawReorderWindow();
+
+	// Errors should come from the draw that caused them.
+	if (Shader::current != nullptr && !Shader::isDefaultActive())
+		Shader::current->validateDrawState(cmd.primitiveMode, cmd.texture);
+
+	ReorderedDraw draw = {};
+	draw.primitiveMode = cmd.primitiveMode;
+	draw.indexMode = cmd.indexMode;
+	draw.vertexCount = cmd.vertexCount;
+	draw.texture = cmd.texture;
+	draw.standardShaderType = cmd.standardShaderType;
+	draw.next = -1;
+
+	BatchedVertexData d;
+	d.stream[0] = d.stream[1] = nullptr;
+
+	for (int i = 0; i < 2; i++)
+	{
+		draw.formats[i] = cmd.formats[i];
+		if (cmd.formats[i] == CommonFormat::NONE)
+			continue;
+
+		// Earlier draws have already written their vertices, so the data can
+		// move when it grows.
+		std::vector<uint8> &data = reorder.vertexData[i];
+		draw.dataOffsets[i] = data.size();
+		data.resize(data.size() + getFormatStride(cmd.formats[i]) * cmd.vertexCount);
+		d.stream[i] = data.data() + draw.dataOffsets[i];
+	}
+
+	reorder.draws.push_back(draw);
+
+	return d;
+}
+
+void Graphics::flushDrawReorderWindow()
+{
+	DrawReorderState &reorder = drawReorderState;
+
+	if (reorder.draws.empty() || reorder.replaying)
+		return;
+
+	LOVE_PROFILE_ZONE("love.graphics.flushDrawReorderWindow");
+
+	reorder.replaying = true;
+
+	int drawcount = (int) reorder.draws.size();
+
+	// The positions are always the first two floats of each vertex.
+	for (ReorderedDraw &draw : reorder.draws)
+	{
+		size_t stride = getFormatStride(draw.formats[0]);
+		const uint8 *data = reorder.vertexData[0].data() + draw.dataOffsets[0];
+
+		draw.minX = draw.minY = std::numeric_limits<float>::max();
+		draw.maxX = draw.maxY = -std::numeric_limits<float>::max();
+
+		for (int v = 0; v < draw.vertexCount; v++)
+		{
+			const float *pos = (const float *) (data + stride * v);
+			draw.minX = std::min(draw.minX, pos[0]);
+			draw.minY = std::min(draw.minY, pos[1]);
+			draw.maxX = std::max(draw.maxX, pos[0]);
+			draw.maxY = std::max(draw.maxY, pos[1]);
+		}
+	}
+
+	auto overlaps = [](const ReorderedDraw &a, float minx, float miny, float maxx, float maxy) -> bool
+	{
+		// Touching edges can share pixels, so they count as overlapping.
+		return a.minX <= maxx && a.maxX >= minx && a.minY <= maxy && a.maxY >= miny;
+	};
+
+	auto compatible = [](const ReorderedDraw &a, const ReorderedDraw &b) -> bool
+	{
+		return a.formats[0] == b.formats[0] && a.formats[1] == b.formats[1]
+			&& (a.indexMode != TRIANGLEINDEX_NONE) == (b.indexMode != TRIANGLEINDEX_NONE)
+			&& a.texture.get() == b.texture.get()
+			&& a.standardShaderType == b.standardShaderType;
+	};
+
+	// Each draw joins the latest group it's compatible with, as long as it
+	// doesn't overlap anything in the groups drawn after that one.
+	for (int i = 0; i < drawcount; i++)
+	{
+		ReorderedDraw &draw = reorder.draws[i];
+		int target = -1;
+
+		for (int g = (int) reorder.groups.size() - 1; g >= 0; g--)
+		{
+			const ReorderGroup &group = reorder.groups[g];
+
+			if (compatible(reorder.draws[group.first], draw))
+			{
+				target = g;
+				break;
+			}
+
+			bool blocked = false;
+			if (overlaps(draw, group.minX, group.minY, group.maxX, group.maxY))
+			{
+				for (int j = group.first; j != -1 && !blocked; j = reorder.draws[j].next)
+				{
+					const ReorderedDraw &other = reorder.draws[j];
+					blocked = overlaps(draw, other.minX, other.minY, other.maxX, other.maxY);
+				}
+			}
+
+			if (blocked)
+				break;
+		}
+
+		if (target == -1)
+		{
+			ReorderGroup group = {i, i, draw.minX, draw.minY, draw.maxX, draw.maxY};
+			reorder.groups.push_back(group);
+		}
+		else
+		{
+			ReorderGroup &group = reorder.groups[target];
+			reorder.draws[group.last].next = i;
+			group.last = i;
+			group.minX = std::min(group.minX, draw.minX);
+			group.minY = std::min(group.minY, draw.minY);
+			group.maxX = std::max(group.maxX, draw.maxX);
+			group.maxY = std::max(group.maxY, draw.maxY);
+		}
+	}
+
+	try
+	{
+		for (const ReorderGroup &group : reorder.groups)
+		{
+			for (int i = group.first; i != -1; i = reorder.draws[i].next)
+			{
+				const ReorderedDraw &draw = reorder.draws[i];
+
+				BatchedDrawCommand cmd;
+				cmd.primitiveMode = draw.primitiveMode;
+				cmd.formats[0] = draw.formats[0];
+				cmd.formats[1] = draw.formats[1];
+				cmd.indexMode = draw.indexMode;
+				cmd.vertexCount = draw.vertexCount;
+				cmd.texture = draw.texture;
+				cmd.standardShaderType = draw.standardShaderType;
+
+				BatchedVertexData data = requestBatchedDraw(cmd);
+
+				for (int j = 0; j < 2; j++)
+				{
+					if (draw.formats[j] != CommonFormat::NONE)
+					{
+						size_t size = getFormatStride(draw.formats[j]) * draw.vertexCount;
+						memcpy(data.stream[j], reorder.vertexData[j].data() + draw.dataOffsets[j], size);
+					}
+				}
+			}
+		}
+	}
+	catch (love::Exception &)
+	{
+		reorder.draws.clear();
+		reorder.groups.clear();
+		reorder.vertexData[0].clear();
+		reorder.vertexData[1].clear();
+		reorder.replaying = false;
+		throw;
+	}
+
+	reorder.draws.clear();
+	reorder.groups.clear();
+	reorder.vertexData[0].clear();
+	reorder.vertexData[1].clear();
+	reorder.replaying = false;
+}
+
+void Graphics::beginDrawListRecording(DrawList *list)
+{
+	if (drawListRecording != nullptr)
+		throw love::Exception("Only one DrawList can be recorded at a time.");
+
+	flushBatchedDraws();
+
+	list->clear();
+	list->retain();
+	drawListRecording = list;
+}
+
+void Graphics::endDrawListRecording()
+{
+	if (drawListRecording == nullptr)
+		return;
+
+	flushBatchedDraws();
+
+	drawListRecording->release();
+	drawListRecording = nullptr;
+}
+
+void Graphics::beginFrameCapture(FrameCapture *capture)
+{
+	if (frameCapture != nullptr)
+		throw love::Exception("Only one FrameCapture can be active at a time.");
+
+	// Draws from before the capture shouldn't be part of it.
+	flushBatchedDraws(BATCHFLUSH_EXPLICIT);
+
+	capture->clear();
+	capture->retain();
+	frameCapture = capture;
+}
+
+void Graphics::endFrameCapture()
+{
+	if (frameCapture == nullptr)
+		return;
+
+	flushBatchedDraws(BATCHFLUSH_EXPLICIT);
+
+	frameCapture->release();
+	frameCapture = nullptr;
+}
+
+void Graphics::updateBatchedDrawBuffers()
+{
+	// Number of frames to observe before shrinking a stream buffer.
+	const int SHRINK_CHECK_FRAMES = 300;
+
+	auto &state = batchedDrawState;
+	StreamBuffer **buffers[3] = {&state.vb[0], &state.vb[1], &state.indexBuffer};
+
+	bool checkshrink = ++state.framesSinceShrinkCheck >= SHRINK_CHECK_FRAMES;
+	if (checkshrink)
+		state.framesSinceShrinkCheck = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		StreamBuffer *&buffer = *buffers[i];
+
+		size_t size = buffer->getSize();
+		size_t used = buffer->getFrameUsedSize();
+
+		if (state.initialSizes[i] == 0)
+			state.initialSizes[i] = size;
+
+		state.peakFrameUsage[i] = std::max(state.peakFrameUsage[i], used);
+
+		buffer->nextFrame();
+
+		// Grow when a frame came close to filling the buffer, so the next
+		// similar frame doesn't need extra flushes or a mid-frame resize.
+		size_t newsize = size;
+		while (used > newsize - newsize / 4)
+			newsize *= 2;
+
+		// Shrink back towards the initial size after a while if recent frames
+		// haven't needed most of the space.
+		if (checkshrink && newsize == size)
+		{
+			while (newsize / 2 >= state.initialSizes[i] && state.peakFrameUsage[i] < newsize / 4)
+				newsize /= 2;
+		}
+
+		if (checkshrink)
+			state.peakFrameUsage[i] = 0;
+
+		if (newsize != size)
+		{
+			BufferUsage mode = buffer->getMode();
+			buffer->release();
+			buffer = newStreamBuffer(mode, newsize);
+		}
+	}
+}
+
+void Graphics::flushBatchedDrawsGlobal(BatchFlushReason reason)
 {
 	Graphics *instance = getInstance<Graphics>(M_GRAPHICS);
 	if (instance != nullptr)
-		instance->flushBatchedDraws();
+		instance->flushBatchedDraws(reason);
 }
 
 /**
@@ -2183,7 +3311,17 @@ void Graphics::flushBatchedDrawsGlobal()
 
 void Graphics::draw(Drawable *drawable, const Matrix4 &m)
 {
+	// Textures go through the batching system and are captured as batches.
+	FrameCapture *capture = getActiveFrameCapture();
+	if (capture == nullptr || dynamic_cast<Texture *>(drawable) != nullptr)
+		return drawable->draw(this, m);
+
+	flushBatchedDraws(BATCHFLUSH_DRAW);
+	capture->captureDrawable(drawable, m, 0, nullptr, 0, 0);
+
+	FrameCaptureSuppressor suppressor(this);
 	drawable->draw(this, m);
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 }
 
 void Graphics::draw(Texture *texture, Quad *quad, const Matrix4 &m)
@@ -2201,18 +3339,42 @@ void Graphics::drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4
 	texture->drawLayer(this, layer, quad, m);
 }
 
+void Graphics::drawMany(Texture *texture, Quad * const *quads, int quadcount, const Texture::ManySprite *sprites, int count)
+{
+	texture->drawMany(this, quads, quadcount, sprites, count);
+}
+
 void Graphics::drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount)
 {
+	FrameCapture *capture = getActiveFrameCapture();
+	if (capture == nullptr)
+		return mesh->drawInstanced(this, m, instancecount);
+
+	flushBatchedDraws(BATCHFLUSH_DRAW);
+	capture->captureDrawable(mesh, m, std::max(instancecount, 1), nullptr, 0, 0);
+
+	FrameCaptureSuppressor suppressor(this);
 	mesh->drawInstanced(this, m, instancecount);
 }
 
-void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex)
+void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount)
 {
-	mesh->drawIndirect(this, m, indirectargs, argsindex);
+	FrameCapture *capture = getActiveFrameCapture();
+	if (capture == nullptr)
+		return mesh->drawIndirect(this, m, indirectargs, argsindex, drawcount);
+
+	flushBatchedDraws(BATCHFLUSH_DRAW);
+	capture->captureDrawable(mesh, m, 0, indirectargs, argsindex, drawcount);
+
+	FrameCaptureSuppressor suppressor(this);
+	mesh->drawIndirect(this, m, indirectargs, argsindex, drawcount);
 }
 
 void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture)
 {
+	if (drawListRecording != nullptr)
+		throw love::Exception("drawFromShader cannot be recorded into a DrawList.");
+
 	if (primtype == PRIMITIVE_TRIANGLE_FAN && vertexcount > LOVE_UINT16_MAX)
 		throw love::Exception("drawFromShader cannot draw more than %d vertices when the 'fan' draw mode is used.", LOVE_UINT16_MAX);
 
@@ -2224,7 +3386,7 @@ void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int insta
 		return;
 	}
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 
 	if (Shader::isDefaultActive() || !Shader::current)
 		throw love::Exception("drawFromShader can only be used with a custom shader.");
@@ -2242,12 +3404,18 @@ void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int insta
 	cmd.instanceCount = std::max(1, instancecount);
 	cmd.texture = getTextureOrDefaultForActiveShader(maintexture);
 
+	if (getActiveFrameCapture() != nullptr)
+		frameCapture->captureDrawFromShader(primtype, vertexcount, instancecount, nullptr, 0, nullptr, 0, 0, maintexture);
+
 	draw(cmd);
 }
 
 void Graphics::drawFromShader(Buffer *indexbuffer, int indexcount, int instancecount, int startindex, Texture *maintexture)
 {
-	flushBatchedDraws();
+	if (drawListRecording != nullptr)
+		throw love::Exception("drawFromShader cannot be recorded into a DrawList.");
+
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 
 	if (!(indexbuffer->getUsageFlags() & BUFFERUSAGEFLAG_INDEX))
 		throw love::Exception("The buffer passed to drawFromShader must be an index buffer.");
@@ -2278,12 +3446,18 @@ void Graphics::drawFromShader(Buffer *indexbuffer, int indexcount, int instancec
 
 	cmd.texture = getTextureOrDefaultForActiveShader(maintexture);
 
+	if (getActiveFrameCapture() != nullptr)
+		frameCapture->captureDrawFromShader(PRIMITIVE_TRIANGLES, indexcount, instancecount, indexbuffer, startindex, nullptr, 0, 0, maintexture);
+
 	draw(cmd);
 }
 
-void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture)
+void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture)
 {
-	flushBatchedDraws();
+	if (drawListRecording != nullptr)
+		throw love::Exception("drawFromShaderIndirect cannot be recorded into a DrawList.");
+
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 
 	if (primtype == PRIMITIVE_TRIANGLE_FAN)
 		throw love::Exception("The fan draw mode is not supported in indirect draws.");
@@ -2291,7 +3465,7 @@ void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectar
 	if (Shader::isDefaultActive() || !Shader::current)
 		throw love::Exception("drawFromShaderIndirect can only be used with a custom shader.");
 
-	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex);
+	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex, drawcount);
 
 	Shader::current->validateDrawState(primtype, maintexture);
 
@@ -2301,14 +3475,21 @@ void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectar
 	cmd.primitiveType = primtype;
 	cmd.indirectBuffer = indirectargs;
 	cmd.indirectBufferOffset = argsindex * indirectargs->getArrayStride();
+	cmd.indirectDrawCount = drawcount;
 	cmd.texture = getTextureOrDefaultForActiveShader(maintexture);
 
+	if (getActiveFrameCapture() != nullptr)
+		frameCapture->captureDrawFromShader(primtype, 0, 0, nullptr, 0, indirectargs, argsindex, drawcount, maintexture);
+
 	draw(cmd);
 }
 
-void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture)
+void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture)
 {
-	flushBatchedDraws();
+	if (drawListRecording != nullptr)
+		throw love::Exception("drawFromShaderIndirect cannot be recorded into a DrawList.");
+
+	flushBatchedDraws(BATCHFLUSH_DRAW);
 
 	if (!(indexbuffer->getUsageFlags() & BUFFERUSAGEFLAG_INDEX))
 		throw love::Exception("The buffer passed to the indexed variant of drawFromShaderIndirect must be an index buffer.");
@@ -2316,7 +3497,7 @@ void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs,
 	if (Shader::isDefaultActive() || !Shader::current)
 		throw love::Exception("drawFromShaderIndirect can only be used with a custom shader.");
 
-	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex);
+	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex, drawcount);
 
 	Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
 
@@ -2326,9 +3507,13 @@ void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs,
 	cmd.primitiveType = PRIMITIVE_TRIANGLES;
 	cmd.indexType = getIndexDataType(indexbuffer->getDataMember(0).decl.format);
 	cmd.indirectBuffer = indirectargs;
-	cmd.indexBufferOffset = argsindex * indirectargs->getArrayStride();
+	cmd.indirectBufferOffset = argsindex * indirectargs->getArrayStride();
+	cmd.indirectDrawCount = drawcount;
 	cmd.texture = getTextureOrDefaultForActiveShader(maintexture);
 
+	if (getActiveFrameCapture() != nullptr)
+		frameCapture->captureDrawFromShader(PRIMITIVE_TRIANGLES, 0, 0, indexbuffer, 0, indirectargs, argsindex, drawcount, maintexture);
+
 	draw(cmd);
 }
 
@@ -2365,7 +3550,7 @@ void Graphics::printf(const std::vector<love::font::ColoredString> &str, Font *f
 void Graphics::points(const Vector2 *positions, const Colorf *colors, size_t numpoints)
 {
 	const Matrix4 &t = getTransform();
-	bool is2D = t.isAffine2DTransform();
+	bool is2D = isTransformAffine2D();
 
 	BatchedDrawCommand cmd;
 	cmd.primitiveMode = PRIMITIVE_POINTS;
@@ -2373,10 +3558,13 @@ void Graphics::points(const Vector2 *positions, const Colorf *colors, size_t num
 	cmd.formats[1] = CommonFormat::RGBAub;
 	cmd.vertexCount = (int) numpoints;
 	cmd.standardShaderType = Shader::STANDARD_POINTS;
+	cmd.allowUntransformed = true;
 
 	BatchedVertexData data = requestBatchedDraw(cmd);
 
-	if (is2D)
+	if (!data.transformVertices)
+		memcpy(data.stream[0], positions, sizeof(Vector2) * cmd.vertexCount);
+	else if (is2D)
 		t.transformXY((Vector2 *) data.stream[0], positions, cmd.vertexCount);
 	else
 		t.transformXY0((Vector3 *) data.stream[0], positions, cmd.vertexCount);
@@ -2515,6 +3703,17 @@ void Graphics::rectangle(DrawMode mode, float x, float y, float w, float h, floa
 
 void Graphics::rectangle(DrawMode mode, float x, float y, float w, float h, float rx, float ry)
 {
+	// Rounded rectangles with elliptical corners don't have a simple distance
+	// function, so only circular corners are drawn as SDF shapes.
+	if (rx > 0 && rx == ry)
+	{
+		float hx = std::abs(w) / 2.0f;
+		float hy = std::abs(h) / 2.0f;
+		float radius = std::min(rx, std::min(hx, hy));
+		if (drawSDFShape(mode, x + w / 2.0f, y + h / 2.0f, hx, hy, radius, false))
+			return;
+	}
+
 	int points = calculateEllipsePoints(std::min(rx, std::abs(w/2)), std::min(ry, std::abs(h/2)));
 	rectangle(mode, x, y, w, h, rx, ry, points);
 }
@@ -2564,9 +3763,100 @@ void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b, int po
 
 void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b)
 {
+	// The outline of an ellipse isn't at a constant distance from its center,
+	// so only circles are drawn as SDF shapes in line mode.
+	if (a == b || mode == DRAW_FILL)
+	{
+		a = std::abs(a);
+		b = std::abs(b);
+		if (drawSDFShape(mode, x, y, a, b, std::min(a, b), a != b))
+			return;
+	}
+
 	ellipse(mode, x, y, a, b, calculateEllipsePoints(a, b));
 }
 
+bool Graphics::drawSDFShape(DrawMode mode, float x, float y, float hx, float hy, float radius, bool isEllipse)
+{
+	// The SDF pixel shader replaces the active one, so custom shaders keep
+	// getting tessellated geometry they can rely on.
+	if (getShapeRendering() != SHAPE_RENDERING_SDF || isWireframe() || !Shader::isDefaultActive())
+		return false;
+
+	if (hx <= 0.0f || hy <= 0.0f || radius <= 0.0f)
+		return false;
+
+	const Matrix4 &t = getTransform();
+	if (!isTransformAffine2D())
+		return false;
+
+	// The smallest scale of the transform is at least |det| / |M|, which gives
+	// a conservative size of one pixel in local coordinates for the AA border.
+	const float *e = t.getElements();
+	float det = std::abs(e[0] * e[5] - e[4] * e[1]);
+	float norm = sqrtf(e[0] * e[0] + e[1] * e[1] + e[4] * e[4] + e[5] * e[5]);
+	if (det <= 0.0f || norm <= 0.0f)
+		return false;
+
+	float pixelsize = norm / (det * std::max((float) pixelScaleStack.back(), 0.000001f));
+	float halfwidth = mode == DRAW_LINE ? getLineWidth() * 0.5f : 0.0f;
+	float margin = halfwidth + pixelsize;
+
+	// The shape is described by a box with rounded corners: the vertex
+	// attributes hold the position relative to the box shrunk by the corner
+	// radius, divided by that radius. Ellipses are a circle with unit radius in
+	// coordinates scaled by their radii. p is the half line width in the same
+	// units, or negative for filled shapes.
+	float kx = isEllipse ? 1.0f / hx : 1.0f / radius;
+	float ky = isEllipse ? 1.0f / hy : 1.0f / radius;
+	float bx = isEllipse ? 0.0f : (hx - radius) / radius;
+	float by = isEllipse ? 0.0f : (hy - radius) / radius;
+	float p = mode == DRAW_LINE ? halfwidth / radius : -1.0f;
+
+	float ex = hx + margin;
+	float ey = hy + margin;
+
+	// The distance function mirrors the position into the first quadrant, so
+	// each quadrant gets its own quad to keep the attributes linear.
+	const float quadrants[4][2] = {{1.0f, 1.0f}, {-1.0f, 1.0f}, {-1.0f, -1.0f}, {1.0f, -1.0f}};
+	const float corners[4][2] = {{0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}};
+
+	Vector2 positions[16];
+
+	BatchedDrawCommand cmd;
+	cmd.formats[0] = CommonFormat::XYf;
+	cmd.formats[1] = CommonFormat::STPf_RGBAub;
+	cmd.indexMode = TRIANGLEINDEX_QUADS;
+	cmd.vertexCount = 16;
+	cmd.standardShaderType = Shader::STANDARD_SDF_SHAPE;
+
+	BatchedVertexData data = requestBatchedDraw(cmd);
+
+	STPf_RGBAub *vertexdata = (STPf_RGBAub *) data.stream[1];
+	Color32 c = toColor32(getColor());
+
+	for (int i = 0; i < 16; i++)
+	{
+		const float *quadrant = quadrants[i / 4];
+		const float *corner = corners[i % 4];
+
+		float lx = corner[0] * ex;
+		float ly = corner[1] * ey;
+
+		positions[i].x = x + quadrant[0] * lx;
+		positions[i].y = y + quadrant[1] * ly;
+
+		vertexdata[i].s = lx * kx - bx;
+		vertexdata[i].t = ly * ky - by;
+		vertexdata[i].p = p;
+		vertexdata[i].color = c;
+	}
+
+	t.transformXY((Vector2 *) data.stream[0], positions, 16);
+
+	return true;
+}
+
 void Graphics::arc(DrawMode drawmode, ArcMode arcmode, float x, float y, float radius, float angle1, float angle2, int points)
 {
 	// Nothing to display with no points or equal angles. (Or is there with line mode?)
@@ -2663,13 +3953,14 @@ void Graphics::polygon(DrawMode mode, const Vector2 *coords, size_t count, bool
 	else
 	{
 		const Matrix4 &t = getTransform();
-		bool is2D = t.isAffine2DTransform();
+		bool is2D = isTransformAffine2D();
 
 		BatchedDrawCommand cmd;
 		cmd.formats[0] = getSinglePositionFormat(is2D);
 		cmd.formats[1] = CommonFormat::STf_RGBAub;
 		cmd.indexMode = TRIANGLEINDEX_FAN;
 		cmd.vertexCount = (int)count - (skipLastFilledVertex ? 1 : 0);
+		cmd.allowUntransformed = true;
 
 		BatchedVertexData data = requestBatchedDraw(cmd);
 
@@ -2699,7 +3990,9 @@ void Graphics::polygon(DrawMode mode, const Vector2 *coords, size_t count, bool
 			attributes[i].color = c;
 		}
 
-		if (is2D)
+		if (!data.transformVertices)
+			memcpy(data.stream[0], coords, sizeof(Vector2) * cmd.vertexCount);
+		else if (is2D)
 			t.transformXY((Vector2*)data.stream[0], coords, cmd.vertexCount);
 		else
 			t.transformXY0((Vector3*)data.stream[0], coords, cmd.vertexCount);
@@ -2732,22 +4025,192 @@ Graphics::Stats Graphics::getStats() const
 	Stats stats;
 
 	getAPIStats(stats.shaderSwitches);
+	getMemoryBudget(stats.gpuMemoryUsage, stats.gpuMemoryBudget);
 
 	stats.drawCalls = drawCalls;
-	if (batchedDrawState.vertexCount > 0)
+	if (batchedDrawState.vertexCount > 0 || !drawReorderState.draws.empty())
 		stats.drawCalls++;
 
 	stats.renderTargetSwitches = renderTargetSwitchCount;
 	stats.drawCallsBatched = drawCallsBatched;
+	memcpy(stats.batchFlushes, batchFlushCounts, sizeof(batchFlushCounts));
 	stats.textures = Texture::textureCount;
 	stats.fonts = Font::fontCount;
 	stats.buffers = Buffer::bufferCount;
 	stats.textureMemory = Texture::totalGraphicsMemory;
 	stats.bufferMemory = Buffer::totalGraphicsMemory;
+	stats.bufferBytesUploaded = Buffer::frameBytesUploaded;
+	stats.uniformBytesUploaded = Shader::frameUniformBytesUploaded;
+	stats.streamBufferStallTime = StreamBuffer::frameStallTime;
 
 	return stats;
 }
 
+void Graphics::getMemoryBudget(int64 &usage, int64 &budget) const
+{
+	usage = 0;
+	budget = 0;
+}
+
+void Graphics::pushGPUTimer(const std::string &name)
+{
+	if (!capabilities.features[FEATURE_GPU_TIMESTAMPS])
+		throw love::Exception("GPU timestamp queries are not supported on this system.");
+
+	GPUTimerFrame &frame = gpuTimerFrames[currentGPUTimerFrame];
+
+	if (frame.queryCount + 2 > MAX_GPU_TIMER_QUERIES)
+		throw love::Exception("Too many GPU timers were used in a single frame (the maximum is %d.)", MAX_GPU_TIMER_QUERIES / 2);
+
+	// Batched draws from before the scope shouldn't be counted in it.
+	flushBatchedDraws(BATCHFLUSH_QUERY);
+
+	GPUTimerScope scope;
+	scope.name = name;
+	scope.depth = (int) gpuTimerStack.size();
+	scope.beginQuery = frame.queryCount++;
+	scope.endQuery = -1;
+
+	writeTimestampQuery(currentGPUTimerFrame, scope.beginQuery);
+
+	gpuTimerStack.push_back((int) frame.scopes.size());
+	frame.scopes.push_back(scope);
+}
+
+void Graphics::popGPUTimer()
+{
+	if (gpuTimerStack.empty())
+		throw love::Exception("popGPUTimer must be called after pushGPUTimer.");
+
+	GPUTimerFrame &frame = gpuTimerFrames[currentGPUTimerFrame];
+
+	flushBatchedDraws(BATCHFLUSH_QUERY);
+
+	GPUTimerScope &scope = frame.scopes[gpuTimerStack.back()];
+	scope.endQuery = frame.queryCount++;
+
+	writeTimestampQuery(currentGPUTimerFrame, scope.endQuery);
+
+	gpuTimerStack.pop_back();
+}
+
+const std::vector<Graphics::GPUTiming> &Graphics::getGPUTimings() const
+{
+	return gpuTimings;
+}
+
+void Graphics::beginOcclusionQuery(OcclusionQuery *query)
+{
+	if (activeOcclusionQuery.get() != nullptr)
+		throw love::Exception("beginOcclusionQuery cannot be called while another occlusion query is active.");
+
+	// Batched draws from before the query shouldn't be counted in it.
+	flushBatchedDraws(BATCHFLUSH_QUERY);
+
+	query->begin();
+	activeOcclusionQuery.set(query);
+}
+
+void Graphics::endOcclusionQuery()
+{
+	if (activeOcclusionQuery.get() == nullptr)
+		throw love::Exception("endOcclusionQuery must be called after beginOcclusionQuery.");
+
+	flushBatchedDraws(BATCHFLUSH_QUERY);
+
+	activeOcclusionQuery->end();
+	activeOcclusionQuery.set(nullptr);
+}
+
+OcclusionQuery *Graphics::getActiveOcclusionQuery() const
+{
+	return activeOcclusionQuery.get();
+}
+
+void Graphics::beginConditionalRender(OcclusionQuery *query)
+{
+	if (conditionalRenderQuery.get() != nullptr)
+		throw love::Exception("beginConditionalRender cannot be called while conditional rendering is active.");
+
+	if (query->isActive())
+		throw love::Exception("An active OcclusionQuery cannot be used for conditional rendering.");
+
+	flushBatchedDraws(BATCHFLUSH_QUERY);
+
+	conditionalRenderOnGPU = query->beginConditionalRender();
+
+	bool anysamples = true;
+	conditionalRenderSkip = !conditionalRenderOnGPU && query->getResult(anysamples) && !anysamples;
+
+	conditionalRenderQuery.set(query);
+}
+
+void Graphics::endConditionalRender()
+{
+	if (conditionalRenderQuery.get() == nullptr)
+		throw love::Exception("endConditionalRender must be called after beginConditionalRender.");
+
+	// Draws batched inside the conditional block are still skipped.
+	flushBatchedDraws(BATCHFLUSH_QUERY);
+
+	if (conditionalRenderOnGPU)
+		conditionalRenderQuery->endConditionalRender();
+
+	conditionalRenderQuery.set(nullptr);
+	conditionalRenderOnGPU = false;
+	conditionalRenderSkip = false;
+}
+
+void Graphics::updateGPUTimers()
+{
+	// Scopes still open at the end of a frame are discarded.
+	gpuTimerStack.clear();
+
+	GPUTimerFrame &current = gpuTimerFrames[currentGPUTimerFrame];
+	current.pending = current.queryCount > 0;
+
+	std::vector<uint64> results;
+
+	// Check from oldest to newest, so the newest available frame wins.
+	for (int i = 1; i <= GPU_TIMER_FRAMES; i++)
+	{
+		int index = (currentGPUTimerFrame + i) % GPU_TIMER_FRAMES;
+		GPUTimerFrame &frame = gpuTimerFrames[index];
+
+		if (!frame.pending)
+			continue;
+
+		results.resize(frame.queryCount);
+		if (!getTimestampQueryResults(index, frame.queryCount, results.data()))
+			continue;
+
+		gpuTimings.clear();
+
+		for (const GPUTimerScope &scope : frame.scopes)
+		{
+			if (scope.endQuery < 0)
+				continue;
+
+			uint64 begin = results[scope.beginQuery];
+			uint64 end = results[scope.endQuery];
+			double time = end > begin ? (double) (end - begin) / 1.0e9 : 0.0;
+
+			gpuTimings.push_back({scope.name, scope.depth, time});
+		}
+
+		frame.pending = false;
+	}
+
+	// Results which still aren't available when a query set is reused are
+	// dropped, rather than stalling.
+	currentGPUTimerFrame = (currentGPUTimerFrame + 1) % GPU_TIMER_FRAMES;
+
+	GPUTimerFrame &next = gpuTimerFrames[currentGPUTimerFrame];
+	next.scopes.clear();
+	next.queryCount = 0;
+	next.pending = false;
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
@@ -2803,45 +4266,107 @@ const Matrix4 &Graphics::getDeviceProjection() const
 	return deviceProjectionMatrix;
 }
 
+Matrix4 Graphics::getCombinedTransform(const Matrix4 &local) const
+{
+	TransformKind kind = transformKindStack.back();
+
+	if (kind == TRANSFORM_IDENTITY)
+		return local;
+
+	if (kind == TRANSFORM_TRANSLATION)
+	{
+		// Multiplying by a translation only adds it (scaled by the w row) to
+		// the x and y rows of the local transform.
+		const float *t = transformStack.back().getElements();
+		float e[16];
+		memcpy(e, local.getElements(), sizeof(float) * 16);
+
+		for (int i = 0; i < 16; i += 4)
+		{
+			e[i + 0] += t[12] * e[i + 3];
+			e[i + 1] += t[13] * e[i + 3];
+		}
+
+		return Matrix4(e);
+	}
+
+	return Matrix4(transformStack.back(), local);
+}
+
+bool Graphics::isTransformAffine2D() const
+{
+	return transformKindStack.back() != TRANSFORM_GENERAL;
+}
+
 void Graphics::pushTransform()
 {
 	transformStack.push_back(transformStack.back());
+	transformKindStack.push_back(transformKindStack.back());
 }
 
 void Graphics::pushIdentityTransform()
 {
 	transformStack.push_back(Matrix4());
+	transformKindStack.push_back(TRANSFORM_IDENTITY);
 }
 
 void Graphics::popTransform()
 {
 	transformStack.pop_back();
+	transformKindStack.pop_back();
+}
+
+void Graphics::updateTransformKind()
+{
+	const Matrix4 &m = transformStack.back();
+	const float *e = m.getElements();
+
+	// Everything but the x and y translation has to exactly match the identity
+	// for the translation-only shortcut in getCombinedTransform.
+	bool translation = true;
+	for (int i = 0; i < 16 && translation; i++)
+	{
+		if (i != 12 && i != 13)
+			translation = e[i] == ((i % 5) == 0 ? 1.0f : 0.0f);
+	}
+
+	if (translation)
+		transformKindStack.back() = (e[12] == 0.0f && e[13] == 0.0f) ? TRANSFORM_IDENTITY : TRANSFORM_TRANSLATION;
+	else if (m.isAffine2DTransform())
+		transformKindStack.back() = TRANSFORM_AFFINE_2D;
+	else
+		transformKindStack.back() = TRANSFORM_GENERAL;
 }
 
 void Graphics::rotate(float r)
 {
 	transformStack.back().rotate(r);
+	updateTransformKind();
 }
 
 void Graphics::scale(float x, float y)
 {
 	transformStack.back().scale(x, y);
 	pixelScaleStack.back() *= (fabs(x) + fabs(y)) / 2.0;
+	updateTransformKind();
 }
 
 void Graphics::translate(float x, float y)
 {
 	transformStack.back().translate(x, y);
+	updateTransformKind();
 }
 
 void Graphics::shear(float kx, float ky)
 {
 	transformStack.back().shear(kx, ky);
+	updateTransformKind();
 }
 
 void Graphics::origin()
 {
 	transformStack.back().setIdentity();
+	transformKindStack.back() = TRANSFORM_IDENTITY;
 	pixelScaleStack.back() = 1;
 }
 
@@ -2849,6 +4374,7 @@ void Graphics::applyTransform(const Matrix4 &m)
 {
 	Matrix4 &current = transformStack.back();
 	current *= m;
+	updateTransformKind();
 
 	float sx, sy;
 	current.getApproximateScale(sx, sy);
@@ -2858,6 +4384,7 @@ void Graphics::applyTransform(const Matrix4 &m)
 void Graphics::replaceTransform(const Matrix4 &m)
 {
 	transformStack.back() = m;
+	updateTransformKind();
 
 	float sx, sy;
 	m.getApproximateScale(sx, sy);
@@ -2882,7 +4409,7 @@ Vector2 Graphics::inverseTransformPoint(Vector2 point)
 
 void Graphics::setProjection(const Matrix4 &m)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	auto &state = states.back();
 
@@ -2894,7 +4421,7 @@ void Graphics::setProjection(const Matrix4 &m)
 
 void Graphics::resetProjection()
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	auto &state = states.back();
 	int w = getWidth();
@@ -2949,6 +4476,13 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::LineJoin, Graphics::LINE_JOIN_MAX_ENUM
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::LineJoin, Graphics::LINE_JOIN_MAX_ENUM, lineJoin)
 
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::ShapeRendering, Graphics::SHAPE_RENDERING_MAX_ENUM, shapeRendering)
+{
+	{ "tessellate", Graphics::SHAPE_RENDERING_TESSELLATE },
+	{ "sdf",        Graphics::SHAPE_RENDERING_SDF        },
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::ShapeRendering, Graphics::SHAPE_RENDERING_MAX_ENUM, shapeRendering)
+
 STRINGMAP_CLASS_BEGIN(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, feature)
 {
 	{ "multicanvasformats",       Graphics::FEATURE_MULTI_RENDER_TARGET_FORMATS },
@@ -2964,6 +4498,8 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, f
 	{ "texelbuffer",              Graphics::FEATURE_TEXEL_BUFFER         },
 	{ "copytexturetobuffer",      Graphics::FEATURE_COPY_TEXTURE_TO_BUFFER },
 	{ "indirectdraw",             Graphics::FEATURE_INDIRECT_DRAW        },
+	{ "gputimestamps",            Graphics::FEATURE_GPU_TIMESTAMPS       },
+	{ "occlusionquery",           Graphics::FEATURE_OCCLUSION_QUERY      },
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, feature)
 
@@ -2992,6 +4528,26 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, s
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, stackType)
 
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::BatchFlushReason, Graphics::BATCHFLUSH_MAX_ENUM, batchFlushReason)
+{
+	{ "other",        Graphics::BATCHFLUSH_OTHER         },
+	{ "texture",      Graphics::BATCHFLUSH_TEXTURE       },
+	{ "shader",       Graphics::BATCHFLUSH_SHADER        },
+	{ "primitive",    Graphics::BATCHFLUSH_PRIMITIVE     },
+	{ "vertexformat", Graphics::BATCHFLUSH_VERTEX_FORMAT },
+	{ "transform",    Graphics::BATCHFLUSH_TRANSFORM     },
+	{ "bufferfull",   Graphics::BATCHFLUSH_BUFFER_FULL   },
+	{ "state",        Graphics::BATCHFLUSH_STATE         },
+	{ "uniform",      Graphics::BATCHFLUSH_UNIFORM       },
+	{ "rendertarget", Graphics::BATCHFLUSH_RENDER_TARGET },
+	{ "draw",         Graphics::BATCHFLUSH_DRAW          },
+	{ "query",        Graphics::BATCHFLUSH_QUERY         },
+	{ "readback",     Graphics::BATCHFLUSH_READBACK      },
+	{ "present",      Graphics::BATCHFLUSH_PRESENT       },
+	{ "explicit",     Graphics::BATCHFLUSH_EXPLICIT      },
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::BatchFlushReason, Graphics::BATCHFLUSH_MAX_ENUM, batchFlushReason)
+
 STRINGMAP_BEGIN(Renderer, RENDERER_MAX_ENUM, renderer)
 {
 	{ "opengl", RENDERER_OPENGL },
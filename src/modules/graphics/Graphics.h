@@ -38,6 +38,11 @@
 #include "Quad.h"
 #include "Mesh.h"
 #include "GraphicsReadback.h"
+#include "TextureUpload.h"
+#include "OcclusionQuery.h"
+#include "DynamicResolution.h"
+#include "StatsOverlay.h"
+#include "Atlas.h"
 #include "Deprecations.h"
 #include "renderstate.h"
 #include "math/Transform.h"
@@ -45,9 +50,12 @@
 #include "font/Font.h"
 #include "video/VideoStream.h"
 #include "data/HashFunction.h"
+#include "thread/threads.h"
 
 // C++
+#include <functional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace love
@@ -60,6 +68,11 @@ class SpriteBatch;
 class ParticleSystem;
 class TextBatch;
 class Video;
+class VirtualTexture;
+class VideoRecorder;
+class DrawList;
+class FrameCapture;
+class RenderGraph;
 class Buffer;
 
 typedef Optional<ColorD> OptionalColorD;
@@ -112,6 +125,30 @@ void setRenderers(const std::vector<Renderer> &renderers);
 void setLowPowerPreferred(bool preferred);
 bool isLowPowerPreferred();
 
+void setShaderCacheEnabled(bool enable);
+bool isShaderCacheEnabled();
+
+/**
+ * Sets the number of frames the CPU may queue up before waiting for the GPU,
+ * for backends which control this. 0 uses the backend's default. Must be set
+ * before the graphics module is used.
+ **/
+void setFramesInFlight(int frames);
+int getFramesInFlight();
+
+/**
+ * Reads a file from the shader cache directory in the save folder. Returns
+ * false if the shader cache is disabled or the file couldn't be read.
+ **/
+bool readShaderCacheFile(const std::string &name, std::vector<uint8> &data);
+
+/**
+ * Writes a file to the shader cache directory in the save folder, if the
+ * shader cache is enabled. Failures are ignored since the cache is only used
+ * to speed up later runs.
+ **/
+void writeShaderCacheFile(const std::string &name, const void *data, size_t size);
+
 class Graphics : public Module
 {
 public:
@@ -148,6 +185,13 @@ public:
 		LINE_JOIN_MAX_ENUM
 	};
 
+	enum ShapeRendering
+	{
+		SHAPE_RENDERING_TESSELLATE,
+		SHAPE_RENDERING_SDF,
+		SHAPE_RENDERING_MAX_ENUM
+	};
+
 	enum Feature
 	{
 		FEATURE_MULTI_RENDER_TARGET_FORMATS, // Deprecated
@@ -163,6 +207,8 @@ public:
 		FEATURE_TEXEL_BUFFER,
 		FEATURE_COPY_TEXTURE_TO_BUFFER,
 		FEATURE_INDIRECT_DRAW,
+		FEATURE_GPU_TIMESTAMPS,
+		FEATURE_OCCLUSION_QUERY,
 		FEATURE_MAX_ENUM
 	};
 
@@ -191,6 +237,27 @@ public:
 		STACK_MAX_ENUM
 	};
 
+	// Why batched draws were flushed, counted per frame in getStats.
+	enum BatchFlushReason
+	{
+		BATCHFLUSH_OTHER,
+		BATCHFLUSH_TEXTURE, // A different texture, or new pixels in one.
+		BATCHFLUSH_SHADER, // Different standard shader or Shader::attach.
+		BATCHFLUSH_PRIMITIVE, // Different primitive or index mode.
+		BATCHFLUSH_VERTEX_FORMAT,
+		BATCHFLUSH_TRANSFORM, // Large untransformed draws.
+		BATCHFLUSH_BUFFER_FULL,
+		BATCHFLUSH_STATE, // Blend, stencil, scissor, depth and similar state.
+		BATCHFLUSH_UNIFORM, // Sending new values to the active shader.
+		BATCHFLUSH_RENDER_TARGET, // Canvas switches, clears and discards.
+		BATCHFLUSH_DRAW, // Meshes, SpriteBatches and other unbatched draws.
+		BATCHFLUSH_QUERY, // GPU timers and occlusion queries.
+		BATCHFLUSH_READBACK,
+		BATCHFLUSH_PRESENT,
+		BATCHFLUSH_EXPLICIT, // love.graphics.flushBatch.
+		BATCHFLUSH_MAX_ENUM
+	};
+
 	enum TemporaryRenderTargetFlags
 	{
 		TEMPORARY_RT_DEPTH   = (1 << 0),
@@ -230,6 +297,19 @@ public:
 		int buffers;
 		int64 textureMemory;
 		int64 bufferMemory;
+		int64 bufferBytesUploaded;
+		int64 uniformBytesUploaded;
+		double streamBufferStallTime;
+		int64 gpuMemoryUsage;
+		int64 gpuMemoryBudget;
+		int batchFlushes[BATCHFLUSH_MAX_ENUM];
+	};
+
+	struct GPUTiming
+	{
+		std::string name;
+		int depth;
+		double time; // In seconds.
 	};
 
 	struct DrawCommand
@@ -246,6 +326,10 @@ public:
 		Buffer *indirectBuffer = nullptr;
 		size_t indirectBufferOffset = 0;
 
+		// Number of consecutive, tightly packed argument records to draw from
+		// the indirect buffer.
+		int indirectDrawCount = 1;
+
 		Texture *texture = nullptr;
 
 		// TODO: This should be moved out to a state transition API?
@@ -274,6 +358,10 @@ public:
 		Buffer *indirectBuffer = nullptr;
 		size_t indirectBufferOffset = 0;
 
+		// Number of consecutive, tightly packed argument records to draw from
+		// the indirect buffer.
+		int indirectDrawCount = 1;
+
 		Texture *texture = nullptr;
 
 		// TODO: This should be moved out to a state transition API?
@@ -295,6 +383,14 @@ public:
 		Texture *texture = nullptr;
 		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
 
+		// Whether the caller can write untransformed vertices when
+		// BatchedVertexData::transformVertices is false.
+		bool allowUntransformed = false;
+
+		// Transform of the untransformed vertices relative to the current
+		// one, if they have one.
+		const Matrix4 *localTransform = nullptr;
+
 		BatchedDrawCommand()
 		{
 			// VS2013 can't initialize arrays in the above manner...
@@ -305,6 +401,10 @@ public:
 	struct BatchedVertexData
 	{
 		void *stream[2];
+
+		// When false the vertex positions are written as-is, as Vector2s, and
+		// the batch is drawn with the current transform.
+		bool transformVertices = true;
 	};
 
 	class TempTransform
@@ -322,6 +422,7 @@ public:
 		{
 			gfx->pushTransform();
 			gfx->transformStack.back() *= t;
+			gfx->updateTransformKind();
 		}
 
 		~TempTransform()
@@ -402,9 +503,16 @@ public:
 		RenderTarget depthStencil;
 		uint32 temporaryRTFlags;
 
+		// Whether MSAA textures are resolved when the pass ends. When false the
+		// multisampled contents are kept, so several passes can render into
+		// them before a later pass resolves once. This doesn't affect which
+		// attachments are used, so operator == ignores it.
+		bool resolve;
+
 		RenderTargets()
 			: depthStencil(nullptr)
 			, temporaryRTFlags(0)
+			, resolve(true)
 		{}
 
 		const RenderTarget &getFirstTarget() const
@@ -436,10 +544,12 @@ public:
 		std::vector<RenderTargetStrongRef> colors;
 		RenderTargetStrongRef depthStencil;
 		uint32 temporaryRTFlags;
+		bool resolve;
 
 		RenderTargetsStrongRef()
 			: depthStencil(nullptr)
 			, temporaryRTFlags(0)
+			, resolve(true)
 		{}
 
 		const RenderTargetStrongRef &getFirstTarget() const
@@ -458,9 +568,16 @@ public:
 	Font *newFont(love::font::Rasterizer *data);
 	Font *newDefaultFont(int size, const font::TrueTypeRasterizer::Settings &settings);
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
+	VideoRecorder *newVideoRecorder(love::filesystem::File *file, int width, int height, int fpsnumerator, int fpsdenominator);
+	VirtualTexture *newVirtualTexture(int width, int height, int pagesize, int cachesize, PixelFormat format, bool linear);
+	DrawList *newDrawList();
+	FrameCapture *newFrameCapture();
+	RenderGraph *newRenderGraph();
+	DynamicResolution *newDynamicResolution(const DynamicResolution::Settings &settings);
+	Atlas *newAtlas(const Atlas::Settings &settings);
 
-	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage);
-	ParticleSystem *newParticleSystem(Texture *texture, int size);
+	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced);
+	ParticleSystem *newParticleSystem(Texture *texture, int size, bool gpuSimulated);
 
 	Shader *newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
 	Shader *newComputeShader(const std::string &source, const Shader::CompileOptions &options);
@@ -468,6 +585,8 @@ public:
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) = 0;
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength);
 
+	virtual OcclusionQuery *newOcclusionQuery();
+
 	Mesh *newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, int vertexcount, PrimitiveType drawmode, BufferDataUsage usage);
 	Mesh *newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, BufferDataUsage usage);
 	Mesh *newMesh(const std::vector<Mesh::BufferAttribute> &attributes, PrimitiveType drawmode);
@@ -478,13 +597,16 @@ public:
 	GraphicsReadback *readbackBufferAsync(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 
 	image::ImageData *readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
-	GraphicsReadback *readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
+	GraphicsReadback *readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset);
+
+	TextureUpload *uploadTextureAsync(Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 
 	bool validateShader(bool gles, const std::vector<std::string> &stages, const Shader::CompileOptions &options, std::string &err);
 
 	Texture *getDefaultTexture(TextureType type, DataBaseType dataType, bool depthSample);
 	Buffer *getDefaultTexelBuffer(DataBaseType dataType);
 	Buffer *getDefaultStorageBuffer();
+	Buffer *getDefaultUniformBuffer();
 	Texture *getTextureOrDefaultForActiveShader(Texture *tex);
 
 	/**
@@ -533,6 +655,46 @@ public:
 	 **/
 	bool isActive() const;
 
+	/**
+	 * When redrawing on demand, love.run waits for events instead of running
+	 * at full rate, and only draws and presents a frame after an event or a
+	 * call to invalidate.
+	 **/
+	void setRedrawOnDemand(bool enable);
+	bool isRedrawOnDemand() const;
+
+	/**
+	 * Requests a redraw as soon as possible, or after a delay in seconds. The
+	 * earliest request wins.
+	 **/
+	void invalidate(double delay = 0.0);
+
+	/**
+	 * Forgets pending redraw requests. Called at the start of a redraw, so
+	 * anything invalidated while drawing causes another redraw.
+	 **/
+	void validate();
+
+	/**
+	 * Gets the time in seconds until a requested redraw is due, which is 0 if
+	 * one is due now, or a negative number if none has been requested.
+	 **/
+	double getRedrawDelay() const;
+
+	/**
+	 * The stats overlay shows frame times and renderer stats in the corner of
+	 * the screen. drawStatsOverlay does nothing while it's disabled.
+	 **/
+	void setStatsOverlayEnabled(bool enable);
+	bool isStatsOverlayEnabled() const;
+
+	/**
+	 * Draws the stats overlay. Should be called once per frame, right before
+	 * present. cputime is the time spent on the frame outside of waiting, or
+	 * negative if it's unknown. lines are printed below the built-in stats.
+	 **/
+	void drawStatsOverlay(double cputime, const std::vector<std::string> &lines);
+
 	/**
 	 * True if a graphics viewport is set.
 	 **/
@@ -580,6 +742,16 @@ public:
 
 	Shader *getShader() const;
 
+	/**
+	 * Sets the Buffer which backs uniform blocks with the given name, in all
+	 * Shaders. Passing nullptr makes those blocks read zeroes.
+	 **/
+	void setUniformBuffer(const std::string &name, Buffer *buffer);
+	Buffer *getUniformBuffer(const std::string &name) const;
+
+	// Incremented whenever a uniform buffer binding changes.
+	uint32 getUniformBuffersVersion() const { return uniformBuffersVersion; }
+
 	void setRenderTarget(RenderTarget rt, uint32 temporaryRTFlags);
 	void setRenderTargets(const RenderTargets &rts);
 	void setRenderTargets(const RenderTargetsStrongRef &rts);
@@ -609,6 +781,13 @@ public:
 	 */
 	bool getScissor(Rect &rect) const;
 
+	/**
+	 * Gets the area of the active render target (or the window) which can be
+	 * drawn to, with the scissor rectangle applied. It's in the same units as
+	 * the transform stack.
+	 **/
+	Rect getVisibleArea() const;
+
 	void setStencilMode(StencilMode mode, int value);
 	void setStencilMode();
 	StencilMode getStencilMode(int &value) const;
@@ -682,6 +861,15 @@ public:
 	void setLineJoin(LineJoin style);
 	LineJoin getLineJoin() const;
 
+	/**
+	 * Sets how circles, ellipses and rounded rectangles are drawn. With
+	 * SHAPE_RENDERING_SDF they're drawn as a few quads each, with an analytic
+	 * antialiased edge computed in the pixel shader instead of a tessellated
+	 * outline. Shapes which can't be expressed that way still get tessellated.
+	 **/
+	void setShapeRendering(ShapeRendering rendering);
+	ShapeRendering getShapeRendering() const;
+
 	/**
 	 * Sets the size of points.
 	 **/
@@ -705,6 +893,19 @@ public:
 	 **/
 	bool isWireframe() const;
 
+	/**
+	 * Sets whether 2D texture views of a single layer of an array texture are
+	 * drawn using the array texture directly (with the layer index in the
+	 * vertex data) when the default shader is active. Draws from different
+	 * layers of the same array texture can then be batched together.
+	 **/
+	void setArrayLayerBatching(bool enable);
+
+	/**
+	 * Gets whether array layer batching is enabled.
+	 **/
+	bool isArrayLayerBatching() const;
+
 	void captureScreenshot(const ScreenshotInfo &info);
 
 	void copyBuffer(Buffer *source, Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size);
@@ -714,17 +915,26 @@ public:
 	void dispatchThreadgroups(Shader *shader, int x, int y, int z);
 	void dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsindex);
 
+	/**
+	 * Built-in compute routines on Buffers of 32 bit values. See
+	 * ComputePrimitives for details.
+	 **/
+	void prefixSum(Buffer *source, Buffer *dest, int count);
+	void radixSort(Buffer *keys, Buffer *values, int count, int keybits);
+	void compactBuffer(Buffer *flags, Buffer *source, Buffer *dest, int count, Buffer *countbuffer, int countindex);
+
 	void draw(Drawable *drawable, const Matrix4 &m);
 	void draw(Texture *texture, Quad *quad, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4 &m);
+	void drawMany(Texture *texture, Quad * const *quads, int quadcount, const Texture::ManySprite *sprites, int count);
 	void drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount);
-	void drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex);
+	void drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount);
 
 	void drawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture);
 	void drawFromShader(Buffer *indexbuffer, int indexcount, int instancecount, int startindex, Texture *maintexture);
-	void drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture);
-	void drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture);
+	void drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture);
+	void drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture);
 
 	/**
 	 * Draws text at the specified coordinates
@@ -856,6 +1066,111 @@ public:
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * The number of frames presented so far.
+	 **/
+	uint64 getPresentedFrameCount() const { return presentedFrameCount; }
+
+	/**
+	 * Named, nestable GPU timer scopes. Timestamps are recorded on the GPU
+	 * at the start and end of each scope, and read back a few frames later
+	 * without waiting for the GPU.
+	 **/
+	void pushGPUTimer(const std::string &name);
+	void popGPUTimer();
+
+	/**
+	 * Gets the scopes of the most recent frame whose GPU timestamps are
+	 * available, in the order they were pushed.
+	 **/
+	const std::vector<GPUTiming> &getGPUTimings() const;
+
+	/**
+	 * Counts whether anything drawn until endOcclusionQuery passes the depth
+	 * and stencil tests. Only one query can be active at a time.
+	 **/
+	void beginOcclusionQuery(OcclusionQuery *query);
+	void endOcclusionQuery();
+	OcclusionQuery *getActiveOcclusionQuery() const;
+
+	/**
+	 * Skips the draws until endConditionalRender if nothing passed in the
+	 * query's most recent result. This never waits for the GPU: backends
+	 * without GPU-side predicates use the newest result available on the CPU,
+	 * and draw everything until one has arrived.
+	 **/
+	void beginConditionalRender(OcclusionQuery *query);
+	void endConditionalRender();
+	bool isConditionalRenderSkippingDraws() const { return conditionalRenderSkip; }
+
+	/**
+	 * Sets the amount of texture memory, in bytes, which evictable textures
+	 * are demoted to smaller mipmap levels to stay under. 0 disables it.
+	 **/
+	void setTextureMemoryBudget(int64 bytes);
+	int64 getTextureMemoryBudget() const;
+
+	/**
+	 * Sets the number of bytes of mipmap data streaming textures may upload
+	 * at the end of each frame. At least one level is uploaded per frame
+	 * while any are waiting, even if it's larger than this.
+	 **/
+	void setTextureStreamingBudget(int64 bytes);
+	int64 getTextureStreamingBudget() const;
+
+	/**
+	 * Whether the calling thread is the one the graphics module was created
+	 * on. GPU resources may only be created and destroyed on that thread.
+	 **/
+	bool isMainThread() const;
+
+	/**
+	 * Runs func on the main thread. Called from another thread, func is queued
+	 * and run during a later present (or while the main thread is blocked in
+	 * a love.thread wait), and the calling thread waits until it has
+	 * finished. Exceptions thrown by func are rethrown on the calling thread.
+	 **/
+	void runOnMainThread(const std::function<void()> &func);
+
+	/**
+	 * Runs functions queued by runOnMainThread, within the threaded creation
+	 * budget. Done during present, and while the main thread is blocked in
+	 * Thread:wait or a Channel wait, since the thread it waits on may itself
+	 * be waiting here.
+	 **/
+	void updateMainThreadJobs();
+
+	/**
+	 * Holds a reference to an Object created on behalf of another thread until
+	 * Graphics has the only one left, so it's always destroyed on the main
+	 * thread. Must be called on the main thread.
+	 **/
+	void deferThreadedRelease(Object *object);
+
+	/**
+	 * Sets the time in seconds each present may spend running functions queued
+	 * by other threads. At least one is run per present while any are waiting.
+	 **/
+	void setThreadedCreationBudget(double seconds);
+	double getThreadedCreationBudget() const;
+
+	/**
+	 * Sets the maximum number of presented frames the GPU may still be working
+	 * on when present returns. Lower values reduce input latency at the cost
+	 * of less CPU and GPU overlap. 0 leaves frame pacing to the backend.
+	 **/
+	void setFrameLatency(int frames);
+	int getFrameLatency() const;
+
+	/**
+	 * Sets how many batched draws are buffered before being drawn, so draws
+	 * which share a texture and shader can be grouped into fewer draw calls.
+	 * A draw is only moved ahead of others when their bounds don't overlap,
+	 * so the visible result doesn't change. 0 disables it.
+	 **/
+	void setDrawReorderWindow(int draws);
+	int getDrawReorderWindow() const;
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -863,6 +1178,19 @@ public:
 	const Matrix4 &getTransform() const;
 	const Matrix4 &getDeviceProjection() const;
 
+	/**
+	 * Gets the current transform multiplied by the given local transform. The
+	 * multiplication is skipped when the current transform is the identity or
+	 * only a translation.
+	 **/
+	Matrix4 getCombinedTransform(const Matrix4 &local) const;
+
+	/**
+	 * Same as getTransform().isAffine2DTransform(), but doesn't need to check
+	 * the matrix.
+	 **/
+	bool isTransformAffine2D() const;
+
 	void rotate(float r);
 	void scale(float x, float y = 1.0f);
 	void translate(float x, float y);
@@ -882,20 +1210,51 @@ public:
 	virtual void draw(const DrawIndexedCommand &cmd) = 0;
 	virtual void drawQuads(int start, int count, VertexAttributesID attributesID, const BufferBindings &buffers, Texture *texture) = 0;
 
-	void flushBatchedDraws();
+	void flushBatchedDraws(BatchFlushReason reason = BATCHFLUSH_OTHER);
 	BatchedVertexData requestBatchedDraw(const BatchedDrawCommand &command);
 
-	static void flushBatchedDrawsGlobal();
+	static void flushBatchedDrawsGlobal(BatchFlushReason reason = BATCHFLUSH_OTHER);
+
+	/**
+	 * While a DrawList is being recorded, flushed batched draws are copied into
+	 * it instead of being drawn. Draws which don't go through the batching
+	 * system can't be recorded.
+	 **/
+	void beginDrawListRecording(DrawList *list);
+	void endDrawListRecording();
+	DrawList *getRecordingDrawList() const { return drawListRecording; }
+
+	/**
+	 * While a FrameCapture is active, graphics commands are copied into it
+	 * as well as being executed. Returns nullptr from getActiveFrameCapture
+	 * while a command that was already captured as a whole is running.
+	 **/
+	void beginFrameCapture(FrameCapture *capture);
+	void endFrameCapture();
+	FrameCapture *getActiveFrameCapture() const { return frameCaptureSuppressed == 0 ? frameCapture : nullptr; }
+	bool isFrameCaptureRunning(const FrameCapture *capture) const { return frameCapture == capture; }
 
 	Texture *getTemporaryTexture(PixelFormat format, int w, int h, int samples);
 	void releaseTemporaryTexture(Texture *texture);
 
+	/**
+	 * Gets a render target from the temporary texture pool, which is given
+	 * back to the pool when the frame is presented. Its contents are undefined
+	 * and it shouldn't be used after the frame ends, since later frames may
+	 * reuse it.
+	 **/
+	Texture *getTemporaryCanvas(PixelFormat format, int w, int h, int msaa);
+
 	Buffer *getTemporaryBuffer(size_t size, DataFormat format, uint32 usageflags, BufferDataUsage datausage);
 	void releaseTemporaryBuffer(Buffer *buffer);
 
+	void registerEvictableTexture(Texture *texture);
+	void unregisterEvictableTexture(Texture *texture);
+
 	void cleanupCachedShaderStage(ShaderStageType type, const std::string &cachekey);
 
-	void validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex);
+	void validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex, int count);
+	static size_t getIndirectArgsStride(IndirectArgsType argstype);
 
 	VertexAttributesID registerVertexAttributes(const VertexAttributes &attributes);
 	bool findVertexAttributes(VertexAttributesID id, VertexAttributes &attributes);
@@ -920,12 +1279,16 @@ public:
 	STRINGMAP_CLASS_DECLARE(ArcMode);
 	STRINGMAP_CLASS_DECLARE(LineStyle);
 	STRINGMAP_CLASS_DECLARE(LineJoin);
+	STRINGMAP_CLASS_DECLARE(ShapeRendering);
 	STRINGMAP_CLASS_DECLARE(Feature);
 	STRINGMAP_CLASS_DECLARE(SystemLimit);
 	STRINGMAP_CLASS_DECLARE(StackType);
+	STRINGMAP_CLASS_DECLARE(BatchFlushReason);
 
 protected:
 
+	friend class FrameCapture;
+
 	struct DisplayState
 	{
 		DisplayState();
@@ -938,6 +1301,7 @@ protected:
 		float lineWidth = 1.0f;
 		LineStyle lineStyle = LINE_SMOOTH;
 		LineJoin lineJoin = LINE_JOIN_MITER;
+		ShapeRendering shapeRendering = SHAPE_RENDERING_TESSELLATE;
 
 		float pointSize = 1.0f;
 
@@ -980,14 +1344,63 @@ protected:
 		int vertexCount = 0;
 		int indexCount = 0;
 
+		// Set when the vertices aren't pre-transformed and the batch is drawn
+		// with this transform instead.
+		bool untransformed = false;
+		Matrix4 transform;
+
 		VertexAttributesID attributesIDs[(int)CommonFormat::COUNT][(int)CommonFormat::COUNT] = {};
 
 		StreamBuffer::MapInfo vbMap[2] = {};
 		StreamBuffer::MapInfo indexBufferMap = StreamBuffer::MapInfo();
 
+		// Used to resize the stream buffers between frames based on how much of
+		// them recent frames have used. Indexed by vb[0], vb[1], indexBuffer.
+		size_t initialSizes[3] = {};
+		size_t peakFrameUsage[3] = {};
+		int framesSinceShrinkCheck = 0;
+
 		bool flushing = false;
 	};
 
+	struct ReorderedDraw
+	{
+		PrimitiveType primitiveMode;
+		CommonFormat formats[2];
+		TriangleIndexMode indexMode;
+		int vertexCount;
+		StrongRef<Texture> texture;
+		Shader::StandardShader standardShaderType;
+
+		// Offsets of the vertices in DrawReorderState::vertexData.
+		size_t dataOffsets[2];
+
+		// Bounds of the (already transformed) positions.
+		float minX, minY, maxX, maxY;
+
+		// Next draw in the same group, or -1.
+		int next;
+	};
+
+	struct ReorderGroup
+	{
+		int first;
+		int last;
+		float minX, minY, maxX, maxY;
+	};
+
+	// Batched draws buffered by the draw reorder window. The vertices are
+	// written to CPU memory and copied to the stream buffers when the window
+	// is flushed.
+	struct DrawReorderState
+	{
+		int window = 0;
+		std::vector<ReorderedDraw> draws;
+		std::vector<ReorderGroup> groups;
+		std::vector<uint8> vertexData[2];
+		bool replaying = false;
+	};
+
 	struct TemporaryBuffer
 	{
 		Buffer *buffer;
@@ -1018,16 +1431,32 @@ protected:
 	virtual StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) = 0;
 
 	virtual GraphicsReadback *newReadbackInternal(ReadbackMethod method, Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) = 0;
-	virtual GraphicsReadback *newReadbackInternal(ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty) = 0;
+	virtual GraphicsReadback *newReadbackInternal(ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset) = 0;
+	virtual TextureUpload *newTextureUploadInternal(Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps) = 0;
 
 	virtual bool dispatch(Shader *shader, int x, int y, int z) = 0;
 	virtual bool dispatch(Shader *shader, Buffer *indirectargs, size_t argsoffset) = 0;
 
 	virtual void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) = 0;
 
+	// Called after the pass which rendered to the given targets has ended.
+	void updateResolvePending(const RenderTargetsStrongRef &endedRTs);
+
 	virtual void initCapabilities() = 0;
 	virtual void getAPIStats(int &shaderswitches) const = 0;
 
+	// Device-local memory used by the whole process and how much of it the
+	// OS lets the process use, both 0 when the backend can't tell.
+	virtual void getMemoryBudget(int64 &usage, int64 &budget) const;
+
+	/**
+	 * Backend timestamp queries. Each of the GPU_TIMER_FRAMES query sets holds
+	 * up to MAX_GPU_TIMER_QUERIES timestamps. Results are in nanoseconds, and
+	 * getTimestampQueryResults must not wait for the GPU.
+	 **/
+	virtual void writeTimestampQuery(int /*frame*/, int /*index*/) {}
+	virtual bool getTimestampQueryResults(int /*frame*/, int /*count*/, uint64 */*results*/) { return false; }
+
 	void createQuadIndexBuffer();
 	void createFanIndexBuffer();
 
@@ -1035,6 +1464,10 @@ protected:
 	void clearTemporaryResources();
 
 	void updatePendingReadbacks();
+	void updatePendingTextureUploads();
+	void updateTextureResidency();
+	void updateTextureStreaming();
+	void updateGPUTimers();
 
 	void releaseDefaultResources();
 
@@ -1047,6 +1480,25 @@ protected:
 	void pushTransform();
 	void pushIdentityTransform();
 	void popTransform();
+	void updateTransformKind();
+
+	// Advances the batched draw stream buffers to the next frame, and grows or
+	// shrinks them based on their recent per-frame usage.
+	void updateBatchedDrawBuffers();
+	void recordBatchedDraws();
+
+	// Draws which are captured as a single command keep everything they draw
+	// internally out of the active FrameCapture.
+	struct FrameCaptureSuppressor
+	{
+		FrameCaptureSuppressor(Graphics *gfx) : gfx(gfx) { gfx->frameCaptureSuppressed++; }
+		~FrameCaptureSuppressor() { gfx->frameCaptureSuppressed--; }
+		Graphics *gfx;
+	};
+
+	bool isDrawReorderable(const BatchedDrawCommand &cmd) const;
+	BatchedVertexData addReorderedDraw(const BatchedDrawCommand &cmd);
+	void flushDrawReorderWindow();
 
 	void updateDeviceProjection(const Matrix4 &projection);
 
@@ -1061,14 +1513,100 @@ protected:
 	bool created;
 	bool active;
 
+	bool redrawOnDemand;
+
+	// The time a redraw was requested for, or infinity if none was.
+	double redrawTime;
+
+	bool statsOverlayEnabled;
+	StatsOverlay statsOverlay;
+
+	bool arrayLayerBatching;
+
 	StrongRef<love::graphics::Font> defaultFont;
 
 	std::vector<ScreenshotInfo> pendingScreenshotCallbacks;
 	std::vector<StrongRef<GraphicsReadback>> pendingReadbacks;
+	std::vector<StrongRef<TextureUpload>> pendingTextureUploads;
+
+	// Timestamp query sets are reused after this many frames, which is more
+	// than the number of frames the GPU can fall behind.
+	static const int GPU_TIMER_FRAMES = 4;
+	static const int MAX_GPU_TIMER_QUERIES = 512;
+
+	struct GPUTimerScope
+	{
+		std::string name;
+		int depth;
+		int beginQuery;
+		int endQuery;
+	};
+
+	struct GPUTimerFrame
+	{
+		std::vector<GPUTimerScope> scopes;
+		int queryCount = 0;
+		bool pending = false;
+	};
+
+	GPUTimerFrame gpuTimerFrames[GPU_TIMER_FRAMES];
+	int currentGPUTimerFrame = 0;
+	std::vector<int> gpuTimerStack;
+	std::vector<GPUTiming> gpuTimings;
+
+	StrongRef<OcclusionQuery> activeOcclusionQuery;
+	StrongRef<OcclusionQuery> conditionalRenderQuery;
+	bool conditionalRenderOnGPU = false;
+	bool conditionalRenderSkip = false;
+
+	std::vector<Texture *> evictableTextures;
+	int64 textureMemoryBudget = 0;
+	int64 textureStreamingBudget = 8 * 1024 * 1024;
+
+	struct MainThreadJob
+	{
+		const std::function<void()> *func;
+		std::string error;
+		bool done;
+	};
+
+	// Graphics is created on the main thread.
+	std::thread::id mainThreadID = std::this_thread::get_id();
+	love::thread::MutexRef mainThreadJobMutex;
+	love::thread::ConditionalRef mainThreadJobCond;
+	std::vector<MainThreadJob *> mainThreadJobs;
+	bool mainThreadJobsStopped = false;
+	double threadedCreationBudget = 0.004;
+
+	std::vector<StrongRef<Object>> threadCreatedObjects;
+
+	static const int MAX_FRAME_LATENCY = 3;
+
+	// Batched draws with at least this many vertices are drawn with the
+	// current transform instead of transforming each vertex on the CPU, if the
+	// caller allows it. Below this, a separate draw call costs more.
+	static const int MIN_UNTRANSFORMED_BATCH_VERTICES = 1024;
+	int frameLatency = 0;
+
+	static const int MAX_DRAW_REORDER_WINDOW = 4096;
 
 	BatchedDrawState batchedDrawState;
+	DrawReorderState drawReorderState;
+	DrawList *drawListRecording = nullptr;
+	FrameCapture *frameCapture = nullptr;
+	int frameCaptureSuppressed = 0;
+
+	// What each matrix in transformStack is made of, so draws can skip work.
+	enum TransformKind
+	{
+		TRANSFORM_IDENTITY,
+		TRANSFORM_TRANSLATION,
+		TRANSFORM_AFFINE_2D,
+		TRANSFORM_GENERAL,
+	};
 
 	std::vector<Matrix4> transformStack;
+	std::vector<TransformKind> transformKindStack;
 	Matrix4 deviceProjectionMatrix;
 
 	std::vector<double> pixelScaleStack;
@@ -1079,9 +1617,16 @@ protected:
 	std::vector<TemporaryBuffer> temporaryBuffers;
 	std::vector<TemporaryTexture> temporaryTextures;
 
+	// Temporary textures from getTemporaryCanvas, released at the end of the
+	// frame.
+	std::vector<Texture *> frameTemporaryTextures;
+
+	uint64 presentedFrameCount = 0;
+
 	int renderTargetSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
+	int batchFlushCounts[BATCHFLUSH_MAX_ENUM];
 
 	Buffer *quadIndexBuffer;
 	Buffer *fanIndexBuffer;
@@ -1095,14 +1640,23 @@ protected:
 	static const size_t MAX_USER_STACK_DEPTH = 128;
 	static const int MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES = 16;
 
+	// Textures used this recently are never evicted, so data the GPU may still
+	// be reading isn't thrown away and textures drawn every frame don't thrash.
+	static const int MIN_EVICTION_UNUSED_FRAMES = 4;
+
 private:
 
 	void checkSetDefaultFont();
 	int calculateEllipsePoints(float rx, float ry) const;
+	bool drawSDFShape(DrawMode mode, float x, float y, float hx, float hy, float radius, bool isEllipse);
 
 	Texture *defaultTextures[TEXTURE_MAX_ENUM][DATA_BASETYPE_MAX_ENUM][2];
 	Buffer *defaultTexelBuffers[DATA_BASETYPE_MAX_ENUM];
 	Buffer *defaultStorageBuffer;
+	Buffer *defaultUniformBuffer;
+
+	std::unordered_map<std::string, StrongRef<Buffer>> uniformBuffers;
+	uint32 uniformBuffersVersion;
 
 	std::vector<uint8> scratchBuffer;
 
@@ -47,7 +47,7 @@ GraphicsReadback::GraphicsReadback(Graphics */*gfx*/, ReadbackMethod method, Buf
 	bufferDataOffset = dest != nullptr ? destoffset : 0;
 }
 
-GraphicsReadback::GraphicsReadback(Graphics *gfx, ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, love::image::ImageData *dest, int destx, int desty)
+GraphicsReadback::GraphicsReadback(Graphics *gfx, ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, love::image::ImageData *dest, int destx, int desty, love::data::ByteData *destbytes, size_t destbytesoffset)
 	: dataType(DATA_TEXTURE)
 	, method(method)
 	, imageData(dest)
@@ -98,6 +98,19 @@ GraphicsReadback::GraphicsReadback(Graphics *gfx, ReadbackMethod method, Texture
 			throw love::Exception("readbackTexture with a non-render-target texture is not supported on this system.");
 	}
 
+	if (dest != nullptr && destbytes != nullptr)
+		throw love::Exception("Texture readbacks can only have one destination.");
+
+	if (destbytes != nullptr)
+	{
+		size_t size = getPixelFormatSliceSize(textureFormat, rect.w, rect.h);
+		if (destbytesoffset + size > destbytes->getSize())
+			throw love::Exception("Invalid destination offset or size for the given ByteData.");
+
+		bufferData.set(destbytes);
+		bufferDataOffset = destbytesoffset;
+	}
+
 	if (dest != nullptr)
 	{
 		if (getLinearPixelFormat(dest->getFormat()) != textureFormat)
@@ -116,6 +129,51 @@ GraphicsReadback::GraphicsReadback(Graphics *gfx, ReadbackMethod method, Texture
 
 GraphicsReadback::~GraphicsReadback()
 {
+	if (completionCleanup != nullptr)
+		completionCleanup(completionContext);
+}
+
+void GraphicsReadback::setCompletionCallback(CompletionCallback callback, CleanupCallback cleanup, void *context)
+{
+	if (completionCleanup != nullptr)
+		completionCleanup(completionContext);
+
+	completionCallback = callback;
+	completionCleanup = cleanup;
+	completionContext = context;
+
+	if (isComplete())
+		runCompletionCallback();
+}
+
+void GraphicsReadback::runCompletionCallback()
+{
+	if (completionCallback == nullptr || !isComplete())
+		return;
+
+	CompletionCallback callback = completionCallback;
+	CleanupCallback cleanup = completionCleanup;
+	void *context = completionContext;
+
+	// Clear these first so the callback is only ever called once, even if it
+	// throws or sets a new callback.
+	completionCallback = nullptr;
+	completionCleanup = nullptr;
+	completionContext = nullptr;
+
+	try
+	{
+		callback(context, this);
+	}
+	catch (love::Exception &)
+	{
+		if (cleanup != nullptr)
+			cleanup(context);
+		throw;
+	}
+
+	if (cleanup != nullptr)
+		cleanup(context);
 }
 
 love::data::ByteData *GraphicsReadback::getBufferData() const
@@ -134,7 +192,12 @@ love::image::ImageData *GraphicsReadback::getImageData() const
 
 void *GraphicsReadback::prepareReadbackDest(size_t size)
 {
-	if (dataType == DATA_TEXTURE)
+	if (dataType == DATA_TEXTURE && bufferData.get())
+	{
+		// Raw readback into a ByteData: tightly packed rows, no conversion.
+		return (uint8 *) bufferData->getData() + bufferDataOffset;
+	}
+	else if (dataType == DATA_TEXTURE)
 	{
 		if (imageData.get())
 		{
@@ -209,7 +272,7 @@ GraphicsReadback::Status GraphicsReadback::readbackBuffer(Buffer *buffer, size_t
 		}
 		else
 		{
-			memcpy(dest, data, std::min(size, bufferData->getSize()));
+			memcpy(dest, data, std::min(size, bufferData->getSize() - bufferDataOffset));
 		}
 	}
 	catch (love::Exception &)
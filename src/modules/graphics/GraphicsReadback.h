@@ -66,10 +66,13 @@ public:
 		STATUS_MAX_ENUM
 	};
 
+	typedef void (*CompletionCallback)(void *context, GraphicsReadback *readback);
+	typedef void (*CleanupCallback)(void *context);
+
 	static love::Type type;
 
 	GraphicsReadback(Graphics *gfx, ReadbackMethod method, Buffer *buffer, size_t offset, size_t size, love::data::ByteData *dest, size_t destoffset);
-	GraphicsReadback(Graphics *gfx, ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, love::image::ImageData *dest, int destx, int desty);
+	GraphicsReadback(Graphics *gfx, ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, love::image::ImageData *dest, int destx, int desty, love::data::ByteData *destbytes, size_t destbytesoffset);
 	virtual ~GraphicsReadback();
 
 	virtual void wait() = 0;
@@ -82,6 +85,16 @@ public:
 	love::data::ByteData *getBufferData() const;
 	love::image::ImageData *getImageData() const;
 
+	/**
+	 * Sets a function which is called once the readback has finished, from
+	 * Graphics::present or runCompletionCallback (or immediately if it has
+	 * already finished). The cleanup function is called when the callback is
+	 * replaced or after it's been called.
+	 **/
+	void setCompletionCallback(CompletionCallback callback, CleanupCallback cleanup, void *context);
+	bool hasCompletionCallback() const { return completionCallback != nullptr; }
+	void runCompletionCallback();
+
 protected:
 
 	enum DataType
@@ -107,6 +120,10 @@ protected:
 	int imageDataX = 0;
 	int imageDataY = 0;
 
+	CompletionCallback completionCallback = nullptr;
+	CleanupCallback completionCleanup = nullptr;
+	void *completionContext = nullptr;
+
 }; // GraphicsReadback
 
 } // graphics
@@ -20,6 +20,7 @@
 
 // LOVE
 #include "Mesh.h"
+#include "MeshOptimizer.h"
 #include "common/Matrix.h"
 #include "common/Exception.h"
 #include "Shader.h"
@@ -420,9 +421,12 @@ void Mesh::flush()
 		}
 		else
 		{
-			size_t offset = modifiedVertexData.getOffset();
-			size_t size = modifiedVertexData.getSize();
-			vertexBuffer->fill(offset, size, vertexData + offset);
+			for (const Range &r : modifiedVertexData.getRanges())
+			{
+				size_t offset = r.getOffset();
+				size_t size = r.getSize();
+				vertexBuffer->fill(offset, size, vertexData + offset);
+			}
 		}
 
 		modifiedVertexData.invalidate();
@@ -627,6 +631,26 @@ Texture *Mesh::getTexture() const
 	return texture.get();
 }
 
+void Mesh::setBoneBuffer(Buffer *buffer)
+{
+	if (buffer != nullptr)
+	{
+		if ((buffer->getUsageFlags() & BUFFERUSAGEFLAG_TEXEL) == 0)
+			throw love::Exception("A Mesh's bone Buffer must be created as a texel buffer.");
+
+		const auto &members = buffer->getDataMembers();
+		if (members.size() != 1 || members[0].decl.format != DATAFORMAT_FLOAT_VEC4)
+			throw love::Exception("A Mesh's bone Buffer must use the floatvec4 format.");
+	}
+
+	boneBuffer.set(buffer);
+}
+
+Buffer *Mesh::getBoneBuffer() const
+{
+	return boneBuffer.get();
+}
+
 void Mesh::setDrawMode(PrimitiveType mode)
 {
 	primitiveType = mode;
@@ -660,6 +684,106 @@ bool Mesh::getDrawRange(int &start, int &count) const
 	return true;
 }
 
+void Mesh::optimize(const OptimizeSettings &settings, float &missratiobefore, float &missratioafter)
+{
+	if (vertexData == nullptr)
+		throw love::Exception("Mesh:optimize requires a Mesh with its own vertex data.");
+
+	if (primitiveType != PRIMITIVE_TRIANGLES)
+		throw love::Exception("Mesh:optimize requires a Mesh with the triangles draw mode.");
+
+	if (useIndexBuffer && indexData == nullptr)
+		throw love::Exception("Mesh:optimize cannot be used with an index Buffer set via Mesh:setIndexBuffer.");
+
+	if (drawRange.isValid())
+		throw love::Exception("Mesh:optimize cannot be used while the Mesh has a draw range.");
+
+	std::vector<uint32> indices;
+	if (!getVertexMap(indices))
+	{
+		indices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+			indices[i] = (uint32) i;
+	}
+
+	if (indices.size() % 3 != 0)
+		throw love::Exception("Mesh:optimize requires the number of vertices drawn to be a multiple of 3.");
+
+	for (uint32 index : indices)
+	{
+		if (index >= vertexCount)
+			throw love::Exception("Invalid vertex map value: %d", index + 1);
+	}
+
+	missratiobefore = getVertexCacheMissRatio(indices.data(), indices.size(), vertexCount);
+
+	std::vector<uint32> optimized(indices.size());
+
+	if (settings.vertexCache)
+	{
+		optimizeVertexCache(optimized.data(), indices.data(), indices.size(), vertexCount);
+		std::swap(indices, optimized);
+	}
+
+	if (settings.overdraw)
+	{
+		const Buffer::DataMember *position = nullptr;
+		for (const BufferAttribute &attrib : attachedAttributes)
+		{
+			if (attrib.bindingLocation == ATTRIB_POS && attrib.buffer.get() == vertexBuffer.get() && attrib.enabled)
+				position = &vertexFormat[attrib.indexInBuffer];
+		}
+
+		bool is3D = position != nullptr
+			&& (position->decl.format == DATAFORMAT_FLOAT_VEC3 || position->decl.format == DATAFORMAT_FLOAT_VEC4);
+
+		if (is3D)
+		{
+			const uint8 *positions = vertexData + position->offset;
+			optimizeOverdraw(optimized.data(), indices.data(), indices.size(), positions, vertexStride, vertexCount, settings.overdrawThreshold);
+			std::swap(indices, optimized);
+		}
+	}
+
+	missratioafter = getVertexCacheMissRatio(indices.data(), indices.size(), vertexCount);
+
+	size_t usedcount = vertexCount;
+
+	bool externalattributes = false;
+	for (const BufferAttribute &attrib : attachedAttributes)
+	{
+		if (attrib.buffer.get() != vertexBuffer.get() && attrib.step == STEP_PER_VERTEX)
+			externalattributes = true;
+	}
+
+	if (settings.vertexFetch && !externalattributes)
+	{
+		std::vector<uint32> remap(vertexCount);
+		usedcount = optimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertexCount);
+
+		std::vector<uint8> olddata(vertexData, vertexData + vertexCount * vertexStride);
+		for (size_t v = 0; v < vertexCount; v++)
+			memcpy(vertexData + remap[v] * vertexStride, olddata.data() + v * vertexStride, vertexStride);
+
+		for (uint32 &index : indices)
+			index = remap[index];
+
+		setVertexDataModified(0, vertexCount * vertexStride);
+	}
+
+	// Only the used vertices need to fit in the index type, and they're packed
+	// at the start once vertices are reordered.
+	IndexDataType datatype = getIndexDataTypeFromMax(usedcount);
+
+	if (datatype == INDEX_UINT16)
+	{
+		std::vector<uint16> data(indices.begin(), indices.end());
+		setVertexMap(datatype, data.data(), data.size() * sizeof(uint16));
+	}
+	else
+		setVertexMap(datatype, indices.data(), indices.size() * sizeof(uint32));
+}
+
 void Mesh::updateVertexAttributes(Graphics *gfx)
 {
 	VertexAttributes attributes;
@@ -714,20 +838,20 @@ void Mesh::updateVertexAttributes(Graphics *gfx)
 
 void Mesh::draw(Graphics *gfx, const love::Matrix4 &m)
 {
-	drawInternal(gfx, m, 1, nullptr, 0);
+	drawInternal(gfx, m, 1, nullptr, 0, 0);
 }
 
 void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 {
-	drawInternal(gfx, m, instancecount, nullptr, 0);
+	drawInternal(gfx, m, instancecount, nullptr, 0, 0);
 }
 
-void Mesh::drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex)
+void Mesh::drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount)
 {
-	drawInternal(gfx, m, 0, indirectargs, argsindex);
+	drawInternal(gfx, m, 0, indirectargs, argsindex, drawcount);
 }
 
-void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex)
+void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount)
 {
 	if (vertexCount <= 0 || (instancecount <= 0 && indirectargs == nullptr))
 		return;
@@ -738,9 +862,9 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 			throw love::Exception("The fan draw mode is not supported in indirect draws.");
 
 		if (useIndexBuffer && indexBuffer != nullptr)
-			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex);
+			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex, drawcount);
 		else
-			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex);
+			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex, drawcount);
 	}
 
 	// Some graphics backends don't natively support triangle fans. So we'd
@@ -749,12 +873,27 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 	if (primitiveType == PRIMITIVE_TRIANGLE_FAN && useIndexBuffer && indexBuffer != nullptr)
 		throw love::Exception("The 'fan' Mesh draw mode cannot be used with an index buffer / vertex map.");
 
-	gfx->flushBatchedDraws();
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("Meshes cannot be recorded into a DrawList.");
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
 
 	flush();
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(primitiveType == PRIMITIVE_POINTS ? Shader::STANDARD_POINTS : Shader::STANDARD_DEFAULT);
+	{
+		Shader::StandardShader stype = Shader::STANDARD_DEFAULT;
+		if (primitiveType == PRIMITIVE_POINTS)
+			stype = Shader::STANDARD_POINTS;
+		else if (boneBuffer.get() != nullptr)
+			stype = Shader::STANDARD_SKINNED;
+
+		Shader::attachDefault(stype);
+	}
+
+	// Custom shaders can declare love_BoneTransforms to skin the Mesh too.
+	if (boneBuffer.get() != nullptr && Shader::current != nullptr)
+		Shader::current->setBoneBuffer(boneBuffer);
 
 	if (Shader::current)
 		Shader::current->validateDrawState(primitiveType, texture);
@@ -816,6 +955,7 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 
 		cmd.indirectBuffer = indirectargs;
 		cmd.indirectBufferOffset = argsindex * (indirectargs != nullptr ? indirectargs->getArrayStride() : 0);
+		cmd.indirectDrawCount = drawcount;
 
 		if (cmd.indexCount > 0)
 			gfx->draw(cmd);
@@ -837,6 +977,7 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 
 		cmd.indirectBuffer = indirectargs;
 		cmd.indirectBufferOffset = argsindex * (indirectargs != nullptr ? indirectargs->getArrayStride() : 0);
+		cmd.indirectDrawCount = drawcount;
 
 		if (cmd.vertexCount > 0)
 			gfx->draw(cmd);
@@ -65,6 +65,14 @@ public:
 		bool enabled = false;
 	};
 
+	struct OptimizeSettings
+	{
+		bool vertexCache = true;
+		bool overdraw = true;
+		float overdrawThreshold = 1.05f;
+		bool vertexFetch = true;
+	};
+
 	static love::Type type;
 
 	Mesh(Graphics *gfx, const std::vector<Buffer::DataDeclaration> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, BufferDataUsage usage);
@@ -169,6 +177,16 @@ public:
 	 **/
 	Texture *getTexture() const;
 
+	/**
+	 * Sets the texel Buffer of bone transforms used to skin the Mesh on the
+	 * GPU. Each vertex is moved by up to 4 bones, using its love_BoneIndices
+	 * and love_BoneWeights attributes. The Buffer must use the floatvec4
+	 * format, with 3 elements per bone holding the first 3 rows of the bone's
+	 * matrix. May be null.
+	 **/
+	void setBoneBuffer(Buffer *buffer);
+	Buffer *getBoneBuffer() const;
+
 	/**
 	 * Sets the draw mode used when drawing the Mesh.
 	 **/
@@ -179,11 +197,21 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * Reorders the Mesh's triangles and vertices so the GPU can draw them more
+	 * efficiently, without changing what's drawn. Requires the triangles draw
+	 * mode and the Mesh's own vertex data. Overdraw optimization is skipped
+	 * if the Mesh doesn't have a 3D VertexPosition attribute, and vertices are
+	 * only reordered if no per-vertex attributes are attached from elsewhere.
+	 * Outputs the average vertex cache misses per triangle before and after.
+	 **/
+	void optimize(const OptimizeSettings &settings, float &missratiobefore, float &missratioafter);
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
 	void drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount);
-	void drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex);
+	void drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount);
 
 	static std::vector<Buffer::DataDeclaration> getDefaultVertexFormat();
 
@@ -198,7 +226,7 @@ private:
 
 	void updateVertexAttributes(Graphics *gfx);
 
-	void drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex);
+	void drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount);
 
 	std::vector<Buffer::DataMember> vertexFormat;
 
@@ -209,7 +237,7 @@ private:
 	// Vertex buffer, for the vertex data.
 	StrongRef<Buffer> vertexBuffer;
 	uint8 *vertexData = nullptr;
-	Range modifiedVertexData = Range();
+	RangeSet modifiedVertexData = RangeSet(Buffer::FILL_MERGE_DISTANCE);
 
 	size_t vertexCount = 0;
 	size_t vertexStride = 0;
@@ -228,6 +256,8 @@ private:
 
 	StrongRef<Texture> texture;
 
+	StrongRef<Buffer> boneBuffer;
+
 	BufferBindings bufferBindings;
 
 }; // Mesh
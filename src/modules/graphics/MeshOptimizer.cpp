@@ -0,0 +1,414 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "MeshOptimizer.h"
+
+// C++
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+static const uint32 INVALID_INDEX = 0xFFFFFFFF;
+
+// Cache size used for scoring vertices in optimizeVertexCache.
+static const int FORSYTH_CACHE_SIZE = 32;
+
+// Cache size used to simulate the GPU when splitting triangles into clusters
+// for optimizeOverdraw.
+static const uint32 OVERDRAW_CACHE_SIZE = 16;
+
+static float getVertexScore(int cacheposition, uint32 remaining)
+{
+	// Vertices without any triangles left shouldn't attract new triangles.
+	if (remaining == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+
+	if (cacheposition >= 0)
+	{
+		// The last triangle's vertices get a fixed score, so the next triangle
+		// doesn't strongly prefer reusing all of them.
+		if (cacheposition < 3)
+			score = 0.75f;
+		else
+		{
+			float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+			score = powf(1.0f - (cacheposition - 3) * scale, 1.5f);
+		}
+	}
+
+	// Prefer vertices with few triangles left, to avoid leaving lone
+	// triangles behind.
+	score += 2.0f * powf((float) remaining, -0.5f);
+
+	return score;
+}
+
+void optimizeVertexCache(uint32 *dst, const uint32 *indices, size_t indexcount, size_t vertexcount)
+{
+	size_t tricount = indexcount / 3;
+	if (tricount == 0)
+		return;
+
+	// Lists of the triangles which still need to be output, for each vertex.
+	std::vector<uint32> remaining(vertexcount, 0);
+	for (size_t i = 0; i < tricount * 3; i++)
+		remaining[indices[i]]++;
+
+	std::vector<uint32> offsets(vertexcount, 0);
+	for (size_t i = 1; i < vertexcount; i++)
+		offsets[i] = offsets[i - 1] + remaining[i - 1];
+
+	std::vector<uint32> adjacency(tricount * 3);
+	{
+		std::vector<uint32> counts(vertexcount, 0);
+		for (size_t i = 0; i < tricount * 3; i++)
+		{
+			uint32 v = indices[i];
+			adjacency[offsets[v] + counts[v]++] = (uint32) (i / 3);
+		}
+	}
+
+	std::vector<int> cachepositions(vertexcount, -1);
+	std::vector<float> vertexscores(vertexcount);
+	for (size_t v = 0; v < vertexcount; v++)
+		vertexscores[v] = getVertexScore(-1, remaining[v]);
+
+	std::vector<float> triscores(tricount);
+	std::vector<bool> emitted(tricount, false);
+
+	uint32 besttri = 0;
+	for (size_t t = 0; t < tricount; t++)
+	{
+		const uint32 *tri = &indices[t * 3];
+		triscores[t] = vertexscores[tri[0]] + vertexscores[tri[1]] + vertexscores[tri[2]];
+		if (triscores[t] > triscores[besttri])
+			besttri = (uint32) t;
+	}
+
+	// The cache has room for the vertices pushed out by the newest triangle.
+	uint32 cache[FORSYTH_CACHE_SIZE + 3];
+	uint32 newcache[FORSYTH_CACHE_SIZE + 3];
+	int cachecount = 0;
+
+	size_t nextunemitted = 0;
+
+	for (size_t out = 0; out < tricount; out++)
+	{
+		// None of the cached vertices have triangles left, so start again from
+		// the next triangle in the original order.
+		if (besttri == INVALID_INDEX)
+		{
+			while (emitted[nextunemitted])
+				nextunemitted++;
+			besttri = (uint32) nextunemitted;
+		}
+
+		const uint32 *tri = &indices[besttri * 3];
+		memcpy(&dst[out * 3], tri, sizeof(uint32) * 3);
+		emitted[besttri] = true;
+
+		for (int i = 0; i < 3; i++)
+		{
+			uint32 v = tri[i];
+			uint32 *list = &adjacency[offsets[v]];
+
+			for (uint32 j = 0; j < remaining[v]; j++)
+			{
+				if (list[j] == besttri)
+				{
+					list[j] = list[remaining[v] - 1];
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		// Move the triangle's vertices to the front of the cache.
+		int newcount = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			if (std::find(newcache, newcache + newcount, tri[i]) == newcache + newcount)
+				newcache[newcount++] = tri[i];
+		}
+
+		for (int i = 0; i < cachecount; i++)
+		{
+			uint32 v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newcache[newcount++] = v;
+		}
+
+		// Update the scores of everything which was or is now in the cache,
+		// including vertices which have just been pushed out.
+		for (int i = 0; i < newcount; i++)
+		{
+			uint32 v = newcache[i];
+			cachepositions[v] = i < FORSYTH_CACHE_SIZE ? i : -1;
+
+			float score = getVertexScore(cachepositions[v], remaining[v]);
+			float diff = score - vertexscores[v];
+			vertexscores[v] = score;
+
+			const uint32 *list = &adjacency[offsets[v]];
+			for (uint32 j = 0; j < remaining[v]; j++)
+				triscores[list[j]] += diff;
+		}
+
+		besttri = INVALID_INDEX;
+		float bestscore = -std::numeric_limits<float>::max();
+
+		cachecount = std::min(newcount, FORSYTH_CACHE_SIZE);
+
+		for (int i = 0; i < cachecount; i++)
+		{
+			uint32 v = newcache[i];
+			cache[i] = v;
+
+			const uint32 *list = &adjacency[offsets[v]];
+			for (uint32 j = 0; j < remaining[v]; j++)
+			{
+				if (triscores[list[j]] > bestscore)
+				{
+					besttri = list[j];
+					bestscore = triscores[list[j]];
+				}
+			}
+		}
+	}
+}
+
+// Returns the number of the triangle's vertices which weren't in the FIFO
+// cache, and adds them to it.
+static int updateCache(const uint32 *tri, std::vector<uint32> &timestamps, uint32 &time, uint32 cachesize)
+{
+	int misses = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		uint32 v = tri[i];
+		if (time - timestamps[v] > cachesize)
+		{
+			timestamps[v] = time++;
+			misses++;
+		}
+	}
+
+	return misses;
+}
+
+void optimizeOverdraw(uint32 *dst, const uint32 *indices, size_t indexcount, const uint8 *positions, size_t positionstride, size_t vertexcount, float threshold)
+{
+	size_t tricount = indexcount / 3;
+	if (tricount == 0)
+		return;
+
+	std::vector<uint32> timestamps(vertexcount, 0);
+	uint32 time = OVERDRAW_CACHE_SIZE + 1;
+
+	// Triangles which miss the cache entirely start a new cluster, since
+	// moving them around won't affect the cache.
+	std::vector<size_t> hardclusters;
+	for (size_t t = 0; t < tricount; t++)
+	{
+		if (updateCache(&indices[t * 3], timestamps, time, OVERDRAW_CACHE_SIZE) == 3 || t == 0)
+			hardclusters.push_back(t);
+	}
+
+	// Split those further wherever the cache efficiency of the cluster so far
+	// is close enough to the whole cluster's.
+	std::vector<size_t> clusters;
+	for (size_t i = 0; i < hardclusters.size(); i++)
+	{
+		size_t start = hardclusters[i];
+		size_t end = i + 1 < hardclusters.size() ? hardclusters[i + 1] : tricount;
+
+		time += OVERDRAW_CACHE_SIZE + 1;
+
+		int clustermisses = 0;
+		for (size_t t = start; t < end; t++)
+			clustermisses += updateCache(&indices[t * 3], timestamps, time, OVERDRAW_CACHE_SIZE);
+
+		float clusterthreshold = threshold * ((float) clustermisses / (float) (end - start));
+
+		time += OVERDRAW_CACHE_SIZE + 1;
+
+		clusters.push_back(start);
+
+		size_t clusterstart = start;
+		int misses = 0;
+
+		for (size_t t = start; t < end - 1; t++)
+		{
+			misses += updateCache(&indices[t * 3], timestamps, time, OVERDRAW_CACHE_SIZE);
+
+			if ((float) misses / (float) (t + 1 - clusterstart) <= clusterthreshold)
+			{
+				clusters.push_back(t + 1);
+				clusterstart = t + 1;
+				misses = 0;
+				time += OVERDRAW_CACHE_SIZE + 1;
+			}
+		}
+	}
+
+	auto getPosition = [&](uint32 v, float *p)
+	{
+		memcpy(p, positions + v * positionstride, sizeof(float) * 3);
+	};
+
+	float meshcenter[3] = {0.0f, 0.0f, 0.0f};
+	for (size_t i = 0; i < tricount * 3; i++)
+	{
+		float p[3];
+		getPosition(indices[i], p);
+		for (int c = 0; c < 3; c++)
+			meshcenter[c] += p[c];
+	}
+
+	for (int c = 0; c < 3; c++)
+		meshcenter[c] /= (float) (tricount * 3);
+
+	// Clusters further out along their average normal are drawn first, since
+	// they're more likely to cover the rest of the mesh.
+	struct Cluster
+	{
+		size_t start;
+		size_t end;
+		float sortkey;
+	};
+
+	std::vector<Cluster> sorted(clusters.size());
+
+	for (size_t i = 0; i < clusters.size(); i++)
+	{
+		Cluster &cluster = sorted[i];
+		cluster.start = clusters[i];
+		cluster.end = i + 1 < clusters.size() ? clusters[i + 1] : tricount;
+
+		float normal[3] = {0.0f, 0.0f, 0.0f};
+		float center[3] = {0.0f, 0.0f, 0.0f};
+		float area = 0.0f;
+
+		for (size_t t = cluster.start; t < cluster.end; t++)
+		{
+			float p0[3], p1[3], p2[3];
+			getPosition(indices[t * 3 + 0], p0);
+			getPosition(indices[t * 3 + 1], p1);
+			getPosition(indices[t * 3 + 2], p2);
+
+			float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+			// The cross product's length is twice the triangle's area, so
+			// larger triangles count for more.
+			float n[3] = {
+				e1[1] * e2[2] - e1[2] * e2[1],
+				e1[2] * e2[0] - e1[0] * e2[2],
+				e1[0] * e2[1] - e1[1] * e2[0],
+			};
+
+			float a = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int c = 0; c < 3; c++)
+			{
+				normal[c] += n[c];
+				center[c] += (p0[c] + p1[c] + p2[c]) * (a / 3.0f);
+			}
+
+			area += a;
+		}
+
+		float normallength = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+		cluster.sortkey = 0.0f;
+
+		if (area > 0.0f && normallength > 0.0f)
+		{
+			for (int c = 0; c < 3; c++)
+				cluster.sortkey += (center[c] / area - meshcenter[c]) * (normal[c] / normallength);
+		}
+	}
+
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster &a, const Cluster &b)
+	{
+		return a.sortkey > b.sortkey;
+	});
+
+	size_t out = 0;
+	for (const Cluster &cluster : sorted)
+	{
+		size_t count = (cluster.end - cluster.start) * 3;
+		memcpy(&dst[out], &indices[cluster.start * 3], sizeof(uint32) * count);
+		out += count;
+	}
+}
+
+size_t optimizeVertexFetchRemap(uint32 *remap, const uint32 *indices, size_t indexcount, size_t vertexcount)
+{
+	for (size_t v = 0; v < vertexcount; v++)
+		remap[v] = INVALID_INDEX;
+
+	uint32 next = 0;
+
+	for (size_t i = 0; i < indexcount; i++)
+	{
+		uint32 v = indices[i];
+		if (remap[v] == INVALID_INDEX)
+			remap[v] = next++;
+	}
+
+	size_t usedcount = next;
+
+	for (size_t v = 0; v < vertexcount; v++)
+	{
+		if (remap[v] == INVALID_INDEX)
+			remap[v] = next++;
+	}
+
+	return usedcount;
+}
+
+float getVertexCacheMissRatio(const uint32 *indices, size_t indexcount, size_t vertexcount, size_t cachesize)
+{
+	size_t tricount = indexcount / 3;
+	if (tricount == 0)
+		return 0.0f;
+
+	std::vector<uint32> timestamps(vertexcount, 0);
+	uint32 time = (uint32) cachesize + 1;
+
+	size_t misses = 0;
+	for (size_t t = 0; t < tricount; t++)
+		misses += updateCache(&indices[t * 3], timestamps, time, (uint32) cachesize);
+
+	return (float) misses / (float) tricount;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+
+// C++
+#include <stddef.h>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Triangle list optimizations for Mesh:optimize. Each function takes a list of
+ * indexcount indices (3 per triangle) referring to vertexcount vertices.
+ * Output index lists must not overlap the input.
+ **/
+
+/**
+ * Reorders triangles so vertices are reused while they're still in the GPU's
+ * post-transform vertex cache, using Tom Forsyth's linear-speed algorithm.
+ **/
+void optimizeVertexCache(uint32 *dst, const uint32 *indices, size_t indexcount, size_t vertexcount);
+
+/**
+ * Reorders groups of triangles (as output by optimizeVertexCache) so that
+ * outward-facing parts of the mesh tend to be drawn before the parts they
+ * cover, without increasing the vertex cache miss ratio of each group by more
+ * than the given threshold (e.g. 1.05 for 5%). Positions are 3 floats per
+ * vertex, positionstride bytes apart.
+ **/
+void optimizeOverdraw(uint32 *dst, const uint32 *indices, size_t indexcount, const uint8 *positions, size_t positionstride, size_t vertexcount, float threshold);
+
+/**
+ * Fills remap (vertexcount elements) with the new position of each vertex,
+ * in the order the vertices are first used by the triangles. Unused vertices
+ * are moved to the end. Returns the number of used vertices.
+ **/
+size_t optimizeVertexFetchRemap(uint32 *remap, const uint32 *indices, size_t indexcount, size_t vertexcount);
+
+/**
+ * Returns the average number of vertex cache misses per triangle, for a FIFO
+ * cache of the given size.
+ **/
+float getVertexCacheMissRatio(const uint32 *indices, size_t indexcount, size_t vertexcount, size_t cachesize = 16);
+
+} // graphics
+} // love
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type OcclusionQuery::type("OcclusionQuery", &Object::type);
+
+OcclusionQuery::OcclusionQuery()
+	: lastEndedSlot(-1)
+	, nextSerial(0)
+	, activeSlot(-1)
+	, active(false)
+	, hasResult(false)
+	, lastResult(false)
+{
+	for (int i = 0; i < QUERY_SLOTS; i++)
+	{
+		slotSerials[i] = 0;
+		slotPending[i] = false;
+	}
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+}
+
+void OcclusionQuery::begin()
+{
+	if (active)
+		throw love::Exception("This OcclusionQuery is already active.");
+
+	activeSlot = (lastEndedSlot + 1) % QUERY_SLOTS;
+
+	// Reusing a slot whose result never arrived drops that result.
+	slotPending[activeSlot] = false;
+
+	beginQuery(activeSlot);
+	active = true;
+}
+
+void OcclusionQuery::end()
+{
+	if (!active)
+		throw love::Exception("This OcclusionQuery is not active.");
+
+	endQuery(activeSlot);
+
+	slotPending[activeSlot] = true;
+	slotSerials[activeSlot] = nextSerial++;
+	lastEndedSlot = activeSlot;
+
+	active = false;
+	activeSlot = -1;
+}
+
+bool OcclusionQuery::getResult(bool &anysamples)
+{
+	// Check from newest to oldest, so the newest available result wins and
+	// anything older than it doesn't need to be checked again.
+	int newest = -1;
+	for (int i = 0; i < QUERY_SLOTS; i++)
+	{
+		int slot = (lastEndedSlot - i + QUERY_SLOTS) % QUERY_SLOTS;
+		if (lastEndedSlot < 0 || !slotPending[slot])
+			continue;
+
+		bool result = false;
+		if (getQueryResult(slot, result))
+		{
+			hasResult = true;
+			lastResult = result;
+			newest = slot;
+			break;
+		}
+	}
+
+	if (newest >= 0)
+	{
+		uint64 serial = slotSerials[newest];
+		for (int i = 0; i < QUERY_SLOTS; i++)
+		{
+			if (slotPending[i] && slotSerials[i] <= serial)
+				slotPending[i] = false;
+		}
+	}
+
+	anysamples = lastResult;
+	return hasResult;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Counts whether any samples pass the depth and stencil tests for the draws
+ * between begin() and end(). Results are never waited for: each query cycles
+ * through a few GPU queries, and getResult returns the newest one which has
+ * finished.
+ **/
+class OcclusionQuery : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	OcclusionQuery();
+	virtual ~OcclusionQuery();
+
+	void begin();
+	void end();
+
+	bool isActive() const { return active; }
+
+	/**
+	 * Gets whether any samples passed in the most recent begin/end pair whose
+	 * result is available. Returns false if no result has arrived yet.
+	 **/
+	bool getResult(bool &anysamples);
+
+	/**
+	 * Starts GPU-side conditional rendering based on the most recently ended
+	 * query. Returns false if the backend can't do that, in which case draws
+	 * are skipped on the CPU based on getResult instead.
+	 **/
+	virtual bool beginConditionalRender() { return false; }
+	virtual void endConditionalRender() {}
+
+protected:
+
+	// Queries are reused after this many begin/end pairs. Results which still
+	// aren't available by then are dropped.
+	static const int QUERY_SLOTS = 4;
+
+	virtual void beginQuery(int slot) = 0;
+	virtual void endQuery(int slot) = 0;
+	virtual bool getQueryResult(int slot, bool &anysamples) = 0;
+
+	// The most recently ended slot, or -1.
+	int lastEndedSlot;
+
+private:
+
+	uint64 slotSerials[QUERY_SLOTS];
+	bool slotPending[QUERY_SLOTS];
+	uint64 nextSerial;
+
+	int activeSlot;
+	bool active;
+
+	bool hasResult;
+	bool lastResult;
+
+}; // OcclusionQuery
+
+} // graphics
+} // love
@@ -22,14 +22,27 @@
 #include "common/config.h"
 #include "ParticleSystem.h"
 #include "Graphics.h"
+#include "Shader.h"
+#include "modules/data/ByteData.h"
 
 #include "common/math.h"
 #include "modules/math/RandomGenerator.h"
+#include "thread/JobSystem.h"
 
 // STD
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <cfloat>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -49,15 +62,378 @@ float calculate_variation(float inner, float outer, float var)
 	return low*(1-r)+high*r;
 }
 
+// Large ParticleSystems split their update across the shared job system's
+// workers. Acquired on first use.
+love::thread::JobSystem *jobSystem = nullptr;
+
+// Built-in shaders used by GPU-simulated ParticleSystems. Every particle is
+// stored as six vec4s, which keeps the std430 layout free of padding.
+static const char gpuParticleStructCode[] = R"(
+#pragma language glsl4
+
+struct Particle
+{
+	vec4 positionVelocity;   // xy: position, zw: velocity
+	vec4 originAcceleration; // xy: origin, zw: linear acceleration
+	vec4 color;
+	vec4 lifeAcceleration;   // x: life, y: lifetime, z: radial, w: tangential acceleration
+	vec4 sizeRotation;       // x: linear damping, y: size offset, z: size interval, w: rotation
+	vec4 spinAngleSize;      // x: spin start, y: spin end, z: angle, w: size
+};
+)";
+
+// Resets the per-update counts and computes the simulation's dispatch size
+// from the number of particles left alive by the previous update.
+static const char gpuPrepareCode[] = R"(
+layout (local_size_x = 1) in;
+
+buffer love_ParticleArgs { uint love_ParticleArgValues[]; };
+
+uniform uvec4 love_ParticleCounts; // x: spawn count, y: max particles
+
+void computemain()
+{
+	uint live = love_ParticleArgValues[1];
+	uint spawn = min(love_ParticleCounts.x, love_ParticleCounts.y - live);
+
+	// Indirect draw arguments. The instance count is accumulated by the
+	// simulation pass.
+	love_ParticleArgValues[0] = 4u;
+	love_ParticleArgValues[1] = 0u;
+	love_ParticleArgValues[2] = 0u;
+	love_ParticleArgValues[3] = 0u;
+
+	// Indirect dispatch arguments for the simulation pass.
+	love_ParticleArgValues[4] = (live + spawn + 63u) / 64u;
+	love_ParticleArgValues[5] = 1u;
+	love_ParticleArgValues[6] = 1u;
+
+	love_ParticleArgValues[7] = live;
+	love_ParticleArgValues[8] = spawn;
+}
+)";
+
+static const char gpuSimulateCode[] = R"(
+layout (local_size_x = 64) in;
+
+readonly buffer love_ParticleInput { Particle love_ParticlesIn[]; };
+writeonly buffer love_ParticleOutput { Particle love_ParticlesOut[]; };
+buffer love_ParticleArgs { uint love_ParticleArgValues[]; };
+
+// See ParticleSystem::updateGPU for the layout.
+uniform vec4 love_ParticleParams[20];
+uniform uvec4 love_ParticleCounts; // z: random seed
+
+#define Dt love_ParticleParams[0].x
+#define SpawnT love_ParticleParams[0].y
+#define SpawnTStep love_ParticleParams[0].z
+#define PrevPosition love_ParticleParams[1].xy
+#define Position love_ParticleParams[1].zw
+#define LifeMin love_ParticleParams[2].x
+#define LifeMax love_ParticleParams[2].y
+#define Direction love_ParticleParams[2].z
+#define Spread love_ParticleParams[2].w
+#define SpeedMin love_ParticleParams[3].x
+#define SpeedMax love_ParticleParams[3].y
+#define AreaDistribution int(love_ParticleParams[3].z)
+#define AreaAngle love_ParticleParams[3].w
+#define Area love_ParticleParams[4].xy
+#define DirectionRelativeToCenter (love_ParticleParams[4].z != 0.0)
+#define RelativeRotation (love_ParticleParams[4].w != 0.0)
+#define LinearAccelerationMin love_ParticleParams[5].xy
+#define LinearAccelerationMax love_ParticleParams[5].zw
+#define RadialAccelerationMin love_ParticleParams[6].x
+#define RadialAccelerationMax love_ParticleParams[6].y
+#define TangentialAccelerationMin love_ParticleParams[6].z
+#define TangentialAccelerationMax love_ParticleParams[6].w
+#define LinearDampingMin love_ParticleParams[7].x
+#define LinearDampingMax love_ParticleParams[7].y
+#define SizeVariation love_ParticleParams[7].z
+#define SizeCount int(love_ParticleParams[7].w)
+#define RotationMin love_ParticleParams[8].x
+#define RotationMax love_ParticleParams[8].y
+#define SpinStart love_ParticleParams[8].z
+#define SpinEnd love_ParticleParams[8].w
+#define SpinVariation love_ParticleParams[9].x
+#define ColorCount int(love_ParticleParams[9].y)
+
+float getSize(int i) { return love_ParticleParams[10 + i / 4][i % 4]; }
+vec4 getColor(int i) { return love_ParticleParams[12 + i]; }
+
+uint randomState;
+
+float random()
+{
+	// PCG hash.
+	randomState = randomState * 747796405u + 2891336453u;
+	uint word = ((randomState >> ((randomState >> 28u) + 4u)) ^ randomState) * 277803737u;
+	word = (word >> 22u) ^ word;
+	return float(word >> 8u) / 16777216.0;
+}
+
+float random(float low, float high)
+{
+	return mix(low, high, random());
+}
+
+float randomNormal(float stddev)
+{
+	float u1 = max(random(), 1.0e-7);
+	float u2 = random();
+	return sqrt(-2.0 * log(u1)) * cos(6.28318530718 * u2) * stddev;
+}
+
+float calculateVariation(float inner, float outer, float variation)
+{
+	return random(inner - (outer / 2.0) * variation, inner + (outer / 2.0) * variation);
+}
+
+Particle spawnParticle(float t)
+{
+	Particle p;
+
+	// Linearly interpolate between the previous and current emitter position.
+	vec2 pos = mix(PrevPosition, Position, t);
+
+	float life = LifeMin == LifeMax ? LifeMin : random(LifeMin, LifeMax);
+	float dir = random(Direction - Spread / 2.0, Direction + Spread / 2.0);
+
+	vec2 offset = vec2(0.0);
+	int distribution = AreaDistribution;
+
+	if (distribution == 1) // uniform
+	{
+		offset = vec2(random(-Area.x, Area.x), random(-Area.y, Area.y));
+	}
+	else if (distribution == 2) // normal
+	{
+		offset = vec2(randomNormal(Area.x), randomNormal(Area.y));
+	}
+	else if (distribution == 3) // ellipse
+	{
+		float rx = random(-1.0, 1.0);
+		float ry = random(-1.0, 1.0);
+		offset = Area * vec2(rx * sqrt(1.0 - 0.5 * ry * ry), ry * sqrt(1.0 - 0.5 * rx * rx));
+	}
+	else if (distribution == 4) // borderellipse
+	{
+		float a = random(0.0, 6.28318530718);
+		offset = vec2(cos(a), sin(a)) * Area;
+	}
+	else if (distribution == 5) // borderrectangle
+	{
+		float r = random((Area.x + Area.y) * -2.0, (Area.x + Area.y) * 2.0);
+		float h = Area.y * 2.0;
+		if (r < -h)
+			offset = vec2(r + h + Area.x, -Area.y);
+		else if (r < 0.0)
+			offset = vec2(-Area.x, r + Area.y);
+		else if (r < h)
+			offset = vec2(Area.x, r - Area.y);
+		else
+			offset = vec2(r - h - Area.x, Area.y);
+	}
+
+	float c = cos(AreaAngle);
+	float s = sin(AreaAngle);
+	offset = vec2(c * offset.x - s * offset.y, s * offset.x + c * offset.y);
+
+	if (DirectionRelativeToCenter && (offset.x != 0.0 || offset.y != 0.0))
+		dir += atan(offset.y, offset.x);
+
+	vec2 velocity = vec2(cos(dir), sin(dir)) * random(SpeedMin, SpeedMax);
+	vec2 linearAcceleration = vec2(random(LinearAccelerationMin.x, LinearAccelerationMax.x), random(LinearAccelerationMin.y, LinearAccelerationMax.y));
+
+	p.positionVelocity = vec4(pos + offset, velocity);
+	p.originAcceleration = vec4(pos, linearAcceleration);
+
+	p.lifeAcceleration.x = life;
+	p.lifeAcceleration.y = life;
+	p.lifeAcceleration.z = random(RadialAccelerationMin, RadialAccelerationMax);
+	p.lifeAcceleration.w = random(TangentialAccelerationMin, TangentialAccelerationMax);
+
+	float sizeOffset = random(0.0, SizeVariation);
+	p.sizeRotation.x = random(LinearDampingMin, LinearDampingMax);
+	p.sizeRotation.y = sizeOffset;
+	p.sizeRotation.z = (1.0 - random(0.0, SizeVariation)) - sizeOffset;
+	p.sizeRotation.w = random(RotationMin, RotationMax);
+
+	p.spinAngleSize.x = calculateVariation(SpinStart, SpinEnd, SpinVariation);
+	p.spinAngleSize.y = calculateVariation(SpinEnd, SpinStart, SpinVariation);
+
+	return p;
+}
+
+void integrate(inout Particle p)
+{
+	vec2 pos = p.positionVelocity.xy;
+	vec2 velocity = p.positionVelocity.zw;
+
+	// Get vector from particle center to particle.
+	vec2 radial = pos - p.originAcceleration.xy;
+	float len = length(radial);
+	radial = len > 0.0 ? radial / len : vec2(0.0);
+
+	vec2 tangential = vec2(-radial.y, radial.x);
+
+	velocity += (radial * p.lifeAcceleration.z + tangential * p.lifeAcceleration.w + p.originAcceleration.zw) * Dt;
+	velocity *= 1.0 / (1.0 + p.sizeRotation.x * Dt);
+
+	p.positionVelocity = vec4(pos + velocity * Dt, velocity);
+
+	float t = 1.0 - p.lifeAcceleration.x / p.lifeAcceleration.y;
+	p.sizeRotation.w += mix(p.spinAngleSize.x, p.spinAngleSize.y, t) * Dt;
+}
+
+void updateAppearance(inout Particle p)
+{
+	float t = 1.0 - p.lifeAcceleration.x / p.lifeAcceleration.y;
+
+	// Change size and color according to the given intervals, as on the CPU.
+	float s = (p.sizeRotation.y + t * p.sizeRotation.z) * float(SizeCount - 1);
+	int i = clamp(int(s), 0, SizeCount - 1);
+	int k = min(i + 1, SizeCount - 1);
+	p.spinAngleSize.w = mix(getSize(i), getSize(k), s - float(i));
+
+	s = t * float(ColorCount - 1);
+	i = clamp(int(s), 0, ColorCount - 1);
+	k = min(i + 1, ColorCount - 1);
+	p.color = mix(getColor(i), getColor(k), s - float(i));
+
+	p.spinAngleSize.z = p.sizeRotation.w;
+	if (RelativeRotation)
+		p.spinAngleSize.z += atan(p.positionVelocity.w, p.positionVelocity.z);
+}
+
+void computemain()
+{
+	uint index = love_GlobalThreadID.x;
+	uint live = love_ParticleArgValues[7];
+	uint spawn = love_ParticleArgValues[8];
+
+	Particle p;
+
+	if (index < live)
+	{
+		p = love_ParticlesIn[index];
+
+		p.lifeAcceleration.x -= Dt;
+		if (p.lifeAcceleration.x <= 0.0)
+			return;
+
+		integrate(p);
+	}
+	else if (index < live + spawn)
+	{
+		randomState = index * 1664525u + love_ParticleCounts.z;
+		random();
+		p = spawnParticle(SpawnT + SpawnTStep * float(index - live));
+	}
+	else
+		return;
+
+	updateAppearance(p);
+
+	// Surviving particles are compacted, so the draw order isn't stable.
+	uint outIndex = atomicAdd(love_ParticleArgValues[1], 1u);
+	love_ParticlesOut[outIndex] = p;
+}
+)";
+
+static const char gpuDrawVertexCode[] = R"(
+readonly buffer love_ParticleBuffer { Particle love_Particles[]; };
+
+// Two entries per quad: its size, then its texture coordinate rectangle.
+readonly buffer love_ParticleQuadBuffer { vec4 love_ParticleQuads[]; };
+
+uniform vec4 love_ParticleDrawParams; // xy: offset, z: quad count
+
+varying highp vec4 VaryingTexCoord;
+varying mediump vec4 VaryingColor;
+
+void vertexmain()
+{
+	Particle p = love_Particles[love_InstanceID];
+
+	// Each instance is a quad drawn as a 4 vertex triangle strip.
+	vec2 corner = vec2(float(love_VertexID >> 1), float(love_VertexID & 1));
+
+	int quadCount = int(love_ParticleDrawParams.z);
+	float t = 1.0 - p.lifeAcceleration.x / p.lifeAcceleration.y;
+	int quad = clamp(int(t * float(quadCount)), 0, quadCount - 1);
+	vec4 quadSize = love_ParticleQuads[quad * 2];
+	vec4 texRect = love_ParticleQuads[quad * 2 + 1];
+
+	float angle = p.spinAngleSize.z;
+	vec2 local = (corner * quadSize.xy - love_ParticleDrawParams.xy) * p.spinAngleSize.w;
+	float c = cos(angle);
+	float s = sin(angle);
+	vec2 pos = p.positionVelocity.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+	VaryingTexCoord = vec4(texRect.xy + texRect.zw * corner, 0.0, 0.0);
+	VaryingColor = gammaCorrectColor(p.color) * ConstantColor;
+	love_Position = ClipSpaceFromLocal * vec4(pos, 0.0, 1.0);
+}
+)";
+
+enum GPUShader
+{
+	GPU_SHADER_PREPARE,
+	GPU_SHADER_SIMULATE,
+	GPU_SHADER_DRAW,
+	GPU_SHADER_MAX_ENUM
+};
+
+Shader *gpuShaders[GPU_SHADER_MAX_ENUM] = {};
+
+Shader *getGPUShader(Graphics *gfx, GPUShader type)
+{
+	if (gpuShaders[type] == nullptr)
+	{
+		Shader::CompileOptions options;
+		options.debugName = "ParticleSystem";
+
+		std::string header = gpuParticleStructCode;
+
+		if (type == GPU_SHADER_PREPARE)
+			gpuShaders[type] = gfx->newComputeShader(header + gpuPrepareCode, options);
+		else if (type == GPU_SHADER_SIMULATE)
+			gpuShaders[type] = gfx->newComputeShader(header + gpuSimulateCode, options);
+		else
+			gpuShaders[type] = gfx->newShader({header + gpuDrawVertexCode}, options);
+	}
+
+	return gpuShaders[type];
+}
+
+void sendGPUUniform(Shader *shader, const char *name, const void *data, size_t size)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr)
+		return;
+
+	memcpy(info->data, data, std::min(size, info->dataSize));
+	shader->updateUniform(info, info->count);
+}
+
+void sendGPUBuffer(Shader *shader, const char *name, Buffer *buffer)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info != nullptr)
+		shader->sendBuffers(info, &buffer, 1);
+}
+
 } // anonymous namespace
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
-ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
-	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+ParticleSystem::ParticleSystem(Texture *texture, uint32 size, bool gpuSimulated)
+	: particleData(nullptr)
+	, gpuSimulated(gpuSimulated)
+	, gpuParticleBuffers()
+	, gpuCurrentBuffer(0)
+	, gpuArgsBuffer(nullptr)
+	, gpuQuadBuffer(nullptr)
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
@@ -65,6 +441,7 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, activeParticles(0)
 	, emissionRate(0)
 	, emitCounter(0)
+	, emitterCount(0)
 	, emissionAreaDistribution(DISTRIBUTION_NONE)
 	, emissionAreaAngle(0)
 	, directionRelativeToEmissionCenter(false)
@@ -93,8 +470,6 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, offset(float(texture->getWidth())*0.5f, float(texture->getHeight())*0.5f)
 	, defaultOffset(true)
 	, relativeRotation(false)
-	, vertexAttributesID(Module::getInstance<Graphics>(Module::M_GRAPHICS)->registerVertexAttributes(VertexAttributes(CommonFormat::XYf_STf_RGBAub, 0)))
-	, buffer(nullptr)
 {
 	if (size == 0 || size > MAX_PARTICLES)
 		throw love::Exception("Invalid ParticleSystem size.");
@@ -102,6 +477,15 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	if (texture->getTextureType() != TEXTURE_2D)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
+	if (gpuSimulated)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		const auto &caps = gfx->getCapabilities();
+
+		if (!caps.features[Graphics::FEATURE_GLSL4] || !caps.features[Graphics::FEATURE_INDIRECT_DRAW])
+			throw love::Exception("GPU-simulated ParticleSystems are not supported on this system (GLSL 4 and indirect draw support is necessary.)");
+	}
+
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
@@ -109,10 +493,12 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
-	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	: particleData(nullptr)
+	, gpuSimulated(p.gpuSimulated)
+	, gpuParticleBuffers()
+	, gpuCurrentBuffer(0)
+	, gpuArgsBuffer(nullptr)
+	, gpuQuadBuffer(nullptr)
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
@@ -122,6 +508,8 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, emitCounter(0.0f)
 	, position(p.position)
 	, prevPosition(p.prevPosition)
+	, emitters(p.emitters)
+	, emitterCount(p.emitterCount)
 	, emissionAreaDistribution(p.emissionAreaDistribution)
 	, emissionArea(p.emissionArea)
 	, emissionAreaAngle(p.emissionAreaAngle)
@@ -154,8 +542,6 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, colors(p.colors)
 	, quads(p.quads)
 	, relativeRotation(p.relativeRotation)
-	, vertexAttributesID(p.vertexAttributesID)
-	, buffer(nullptr)
 {
 	setBufferSize(maxParticles);
 }
@@ -170,6 +556,20 @@ ParticleSystem *ParticleSystem::clone()
 	return new ParticleSystem(*this);
 }
 
+void ParticleSystem::releaseSharedResources()
+{
+	if (jobSystem != nullptr)
+		love::thread::JobSystem::releaseShared();
+	jobSystem = nullptr;
+
+	for (Shader *&shader : gpuShaders)
+	{
+		if (shader != nullptr)
+			shader->release();
+		shader = nullptr;
+	}
+}
+
 void ParticleSystem::resetOffset()
 {
 	if (quads.empty())
@@ -185,15 +585,35 @@ void ParticleSystem::createBuffers(size_t size)
 {
 	try
 	{
-		pFree = pMem = new Particle[size];
-		maxParticles = (uint32) size;
-
-		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gpuSimulated)
+		{
+			auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+			std::vector<Buffer::DataDeclaration> format = {
+				{"positionVelocity", DATAFORMAT_FLOAT_VEC4},
+				{"originAcceleration", DATAFORMAT_FLOAT_VEC4},
+				{"color", DATAFORMAT_FLOAT_VEC4},
+				{"lifeAcceleration", DATAFORMAT_FLOAT_VEC4},
+				{"sizeRotation", DATAFORMAT_FLOAT_VEC4},
+				{"spinAngleSize", DATAFORMAT_FLOAT_VEC4},
+			};
+
+			Buffer::Settings settings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+			settings.debugName = "ParticleSystem particles";
+
+			for (int i = 0; i < 2; i++)
+				gpuParticleBuffers[i] = gfx->newBuffer(settings, format, nullptr, 0, size);
+
+			// See the prepare shader for the layout.
+			Buffer::Settings argsettings(BUFFERUSAGEFLAG_SHADER_STORAGE | BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS, BUFFERDATAUSAGE_STATIC);
+			argsettings.zeroInitialize = true;
+			argsettings.debugName = "ParticleSystem arguments";
+			gpuArgsBuffer = gfx->newBuffer(argsettings, DATAFORMAT_UINT32, nullptr, 0, 12);
+		}
+		else
+			particleData = new float[size * FIELD_MAX_ENUM];
 
-		size_t bytes = sizeof(Vertex) * size * 4;
-		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STREAM);
-		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf_STf_RGBAub);
-		buffer = gfx->newBuffer(settings, decl, nullptr, bytes, 0);
+		maxParticles = (uint32) size;
 	}
 	catch (std::bad_alloc &)
 	{
@@ -204,12 +624,26 @@ void ParticleSystem::createBuffers(size_t size)
 
 void ParticleSystem::deleteBuffers()
 {
-	delete[] pMem;
-	if (buffer)
-		buffer->release();
+	delete[] particleData;
+
+	for (Buffer *&buffer : gpuParticleBuffers)
+	{
+		if (buffer != nullptr)
+			buffer->release();
+		buffer = nullptr;
+	}
 
-	pMem = nullptr;
-	buffer = nullptr;
+	if (gpuArgsBuffer != nullptr)
+		gpuArgsBuffer->release();
+	if (gpuQuadBuffer != nullptr)
+		gpuQuadBuffer->release();
+
+	gpuCountReadback.set(nullptr);
+
+	particleData = nullptr;
+	gpuArgsBuffer = nullptr;
+	gpuQuadBuffer = nullptr;
+	gpuQuadData.clear();
 	maxParticles = 0;
 	activeParticles = 0;
 }
@@ -228,48 +662,67 @@ uint32 ParticleSystem::getBufferSize() const
 	return maxParticles;
 }
 
-void ParticleSystem::addParticle(float t)
+void ParticleSystem::addParticles(uint32 count, const love::Vector2 &from, const love::Vector2 &to, float t, float tstep)
 {
-	if (isFull())
+	count = std::min(count, maxParticles - activeParticles);
+	if (count == 0)
 		return;
 
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
+	uint32 first = activeParticles;
 
-	switch (insertMode)
+	if (insertMode == INSERT_MODE_BOTTOM)
 	{
-	default:
-	case INSERT_MODE_TOP:
-		insertTop(p);
-		break;
-	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
-		break;
-	case INSERT_MODE_RANDOM:
-		insertRandom(p);
-		break;
+		// Particles are stored in draw order, so new bottom particles go at
+		// the front of every array.
+		for (int i = 0; i < FIELD_MAX_ENUM; i++)
+		{
+			float *field = getField((ParticleField) i);
+			memmove(field + count, field, sizeof(float) * activeParticles);
+		}
+
+		for (uint32 i = 0; i < count; i++)
+			initParticle(count - 1 - i, from + (to - from) * (t + tstep * i));
+	}
+	else
+	{
+		for (uint32 i = 0; i < count; i++)
+			initParticle(first + i, from + (to - from) * (t + tstep * i));
 	}
 
-	activeParticles++;
+	activeParticles += count;
+
+	if (insertMode == INSERT_MODE_RANDOM)
+	{
+		// Swap each new particle with a random one, which may be itself.
+		for (uint32 i = first; i < activeParticles; i++)
+		{
+			// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+			uint32 other = (uint32) (rng.rand() % ((uint64) i + 1));
+			if (other == i)
+				continue;
+
+			for (int f = 0; f < FIELD_MAX_ENUM; f++)
+			{
+				float *field = getField((ParticleField) f);
+				std::swap(field[i], field[other]);
+			}
+		}
+	}
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::initParticle(uint32 index, const love::Vector2 &pos)
 {
 	float min,max;
 
-	// Linearly interpolate between the previous and current emitter position.
-	love::Vector2 pos = prevPosition + (position - prevPosition) * t;
-
 	min = particleLifeMin;
 	max = particleLifeMax;
+	float plife;
 	if (min == max)
-		p->life = min;
+		plife = min;
 	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+		plife = (float) rng.random(min, max);
 
-	p->position = pos;
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -285,15 +738,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -301,16 +754,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -319,26 +772,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -348,154 +801,53 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
-
-	p->origin = pos;
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+
+	getField(FIELD_LIFETIME)[index] = plife;
+	getField(FIELD_LIFE)[index] = plife;
+
+	getField(FIELD_POSITION_X)[index] = ppos.x;
+	getField(FIELD_POSITION_Y)[index] = ppos.y;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	getField(FIELD_ORIGIN_X)[index] = pos.x;
+	getField(FIELD_ORIGIN_Y)[index] = pos.y;
+
+	getField(FIELD_VELOCITY_X)[index] = velocity.x;
+	getField(FIELD_VELOCITY_Y)[index] = velocity.y;
+
+	getField(FIELD_LINEAR_ACCELERATION_X)[index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	getField(FIELD_LINEAR_ACCELERATION_Y)[index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	getField(FIELD_RADIAL_ACCELERATION)[index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	getField(FIELD_TANGENTIAL_ACCELERATION)[index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	getField(FIELD_LINEAR_DAMPING)[index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeoffset = (float) rng.random(sizeVariation); // time offset for size change
+	getField(FIELD_SIZE_OFFSET)[index] = sizeoffset;
+	getField(FIELD_SIZE_INTERVAL_SIZE)[index] = (1.0f - (float) rng.random(sizeVariation)) - sizeoffset;
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
-
-	p->angle = p->rotation;
-	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
-
-	p->color = colors[0];
+	getField(FIELD_SPIN_START)[index] = calculate_variation(spinStart, spinEnd, spinVariation);
+	getField(FIELD_SPIN_END)[index] = calculate_variation(spinEnd, spinStart, spinVariation);
+	getField(FIELD_ROTATION)[index] = (float) rng.random(min, max);
 
-	p->quadIndex = 0;
-}
-
-void ParticleSystem::insertTop(Particle *p)
-{
-	if (pHead == nullptr)
-	{
-		pHead = p;
-		p->prev = nullptr;
-	}
-	else
-	{
-		pTail->next = p;
-		p->prev = pTail;
-	}
-	p->next = nullptr;
-	pTail = p;
-}
-
-void ParticleSystem::insertBottom(Particle *p)
-{
-	if (pTail == nullptr)
-	{
-		pTail = p;
-		p->next = nullptr;
-	}
-	else
-	{
-		pHead->prev = p;
-		p->next = pHead;
-	}
-	p->prev = nullptr;
-	pHead = p;
-}
-
-void ParticleSystem::insertRandom(Particle *p)
-{
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
-
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
-		return;
-	}
-
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
-}
-
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
-{
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
-
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
-
-	if (p->next)
-	{
-		p->next->prev = p->prev;
-		pNext = p->next;
-	}
-	else
-		pTail = p->prev;
-
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
-	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
-
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
-
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
-	}
-
-	activeParticles--;
-	return pNext;
+	// The size, color, quad and final angle of a particle only depend on the
+	// fields above, so they're computed when the particle is drawn.
 }
 
 void ParticleSystem::setTexture(Texture *tex)
@@ -580,6 +932,95 @@ void ParticleSystem::moveTo(float x, float y)
 	position = love::Vector2(x, y);
 }
 
+int ParticleSystem::addEmitter(float x, float y)
+{
+	if (gpuSimulated)
+		throw love::Exception("GPU-simulated ParticleSystems do not support extra emitters.");
+
+	Emitter e;
+	e.position = love::Vector2(x, y);
+	e.prevPosition = e.position;
+	e.emitCounter = 0.0f;
+	e.life = lifetime;
+	e.active = true;
+	e.used = true;
+
+	emitterCount++;
+
+	for (size_t i = 0; i < emitters.size(); i++)
+	{
+		if (!emitters[i].used)
+		{
+			emitters[i] = e;
+			return (int) i + 1;
+		}
+	}
+
+	emitters.push_back(e);
+	return (int) emitters.size();
+}
+
+void ParticleSystem::removeEmitter(int id)
+{
+	getEmitter(id).used = false;
+	emitterCount--;
+
+	while (!emitters.empty() && !emitters.back().used)
+		emitters.pop_back();
+}
+
+int ParticleSystem::getEmitterCount() const
+{
+	return emitterCount;
+}
+
+void ParticleSystem::setEmitterPosition(int id, float x, float y)
+{
+	Emitter &e = getEmitter(id);
+	e.position = love::Vector2(x, y);
+	e.prevPosition = e.position;
+}
+
+void ParticleSystem::moveEmitter(int id, float x, float y)
+{
+	getEmitter(id).position = love::Vector2(x, y);
+}
+
+love::Vector2 ParticleSystem::getEmitterPosition(int id) const
+{
+	return getEmitter(id).position;
+}
+
+void ParticleSystem::setEmitterActive(int id, bool active)
+{
+	Emitter &e = getEmitter(id);
+	if (!active)
+	{
+		e.life = lifetime;
+		e.emitCounter = 0;
+	}
+	e.active = active;
+}
+
+bool ParticleSystem::isEmitterActive(int id) const
+{
+	return getEmitter(id).active;
+}
+
+ParticleSystem::Emitter &ParticleSystem::getEmitter(int id)
+{
+	if (id < 1 || id > (int) emitters.size() || !emitters[id - 1].used)
+		throw love::Exception("Invalid emitter id: %d", id);
+	return emitters[id - 1];
+}
+
+const ParticleSystem::Emitter &ParticleSystem::getEmitter(int id) const
+{
+	if (id < 1 || id > (int) emitters.size() || !emitters[id - 1].used)
+		throw love::Exception("Invalid emitter id: %d", id);
+	return emitters[id - 1];
+}
+
 void ParticleSystem::setEmissionArea(AreaSpreadDistribution distribution, float x, float y, float angle, bool directionRelativeToCenter)
 {
 	emissionArea = love::Vector2(x, y);
@@ -862,15 +1303,24 @@ void ParticleSystem::pause()
 
 void ParticleSystem::reset()
 {
-	if (pMem == nullptr)
+	if (particleData == nullptr && gpuArgsBuffer == nullptr)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
+	if (gpuArgsBuffer != nullptr)
+	{
+		gpuArgsBuffer->clear(0, gpuArgsBuffer->getSize());
+		gpuCountReadback.set(nullptr);
+	}
+
 	activeParticles = 0;
 	life = lifetime;
 	emitCounter = 0;
+
+	for (Emitter &e : emitters)
+	{
+		e.life = lifetime;
+		e.emitCounter = 0;
+	}
 }
 
 void ParticleSystem::emit(uint32 num)
@@ -878,10 +1328,10 @@ void ParticleSystem::emit(uint32 num)
 	if (!active)
 		return;
 
-	num = std::min(num, maxParticles - activeParticles);
-
-	while (num--)
-		addParticle(1.0f);
+	if (gpuSimulated)
+		updateGPU(0.0f, num, 1.0f, 0.0f);
+	else
+		addParticles(num, prevPosition, position, 1.0f, 0.0f);
 }
 
 bool ParticleSystem::isActive() const
@@ -909,185 +1359,550 @@ bool ParticleSystem::isFull() const
 	return activeParticles == maxParticles;
 }
 
-void ParticleSystem::update(float dt)
+void ParticleSystem::removeDeadParticles(float dt)
 {
-	if (pMem == nullptr || dt == 0.0f)
-		return;
+	float *plife = getField(FIELD_LIFE);
+	uint32 count = activeParticles;
+
+	// Decrease lifespan.
+	uint32 alive = 0;
+	for (uint32 i = 0; i < count; i++)
+	{
+		plife[i] -= dt;
+		alive += plife[i] > 0.0f ? 1 : 0;
+	}
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
+	if (alive == count)
+		return;
 
-	while (p)
+	// Compact every array while keeping the draw order intact. The life field
+	// decides what's kept, so it has to be compacted last.
+	for (int f = FIELD_MAX_ENUM - 1; f >= 0; f--)
 	{
-		// Decrease lifespan.
-		p->life -= dt;
+		float *field = getField((ParticleField) f);
+		uint32 j = 0;
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
+		for (uint32 i = 0; i < count; i++)
 		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
+			if (plife[i] > 0.0f)
+				field[j++] = field[i];
+		}
+	}
 
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
+	activeParticles = alive;
+}
 
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
+void ParticleSystem::updateParticles(uint32 first, uint32 last, float dt)
+{
+	const float *plife = getField(FIELD_LIFE);
+	const float *plifetime = getField(FIELD_LIFETIME);
+	float *px = getField(FIELD_POSITION_X);
+	float *py = getField(FIELD_POSITION_Y);
+	const float *pox = getField(FIELD_ORIGIN_X);
+	const float *poy = getField(FIELD_ORIGIN_Y);
+	float *pvx = getField(FIELD_VELOCITY_X);
+	float *pvy = getField(FIELD_VELOCITY_Y);
+	const float *plax = getField(FIELD_LINEAR_ACCELERATION_X);
+	const float *play = getField(FIELD_LINEAR_ACCELERATION_Y);
+	const float *pradial = getField(FIELD_RADIAL_ACCELERATION);
+	const float *ptangential = getField(FIELD_TANGENTIAL_ACCELERATION);
+	const float *pdamping = getField(FIELD_LINEAR_DAMPING);
+	float *protation = getField(FIELD_ROTATION);
+	const float *pspinstart = getField(FIELD_SPIN_START);
+	const float *pspinend = getField(FIELD_SPIN_END);
 
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
+	uint32 i = first;
 
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
+#if defined(LOVE_SIMD_SSE)
 
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minlength = _mm_set1_ps(FLT_MIN);
 
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
+	// Four particles at a time. We can't guarantee 16-byte alignment for
+	// every range so we use unaligned loads and stores.
+	for (; i + 4 <= last; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(px + i);
+		__m128 y = _mm_loadu_ps(py + i);
+
+		__m128 rx = _mm_sub_ps(x, _mm_loadu_ps(pox + i));
+		__m128 ry = _mm_sub_ps(y, _mm_loadu_ps(poy + i));
+		__m128 lengthsq = _mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry));
+		__m128 invlength = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(lengthsq, minlength)));
+		rx = _mm_mul_ps(rx, invlength);
+		ry = _mm_mul_ps(ry, invlength);
+
+		__m128 radial = _mm_loadu_ps(pradial + i);
+		__m128 tangential = _mm_loadu_ps(ptangential + i);
+		__m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, radial), _mm_mul_ps(ry, tangential)), _mm_loadu_ps(plax + i));
+		__m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, radial), _mm_mul_ps(rx, tangential)), _mm_loadu_ps(play + i));
+
+		__m128 damping = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(pdamping + i), vdt)));
+		__m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pvx + i), _mm_mul_ps(ax, vdt)), damping);
+		__m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pvy + i), _mm_mul_ps(ay, vdt)), damping);
+
+		_mm_storeu_ps(pvx + i, vx);
+		_mm_storeu_ps(pvy + i, vy);
+		_mm_storeu_ps(px + i, _mm_add_ps(x, _mm_mul_ps(vx, vdt)));
+		_mm_storeu_ps(py + i, _mm_add_ps(y, _mm_mul_ps(vy, vdt)));
+
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(plife + i), _mm_loadu_ps(plifetime + i)));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pspinstart + i), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(pspinend + i), t));
+		_mm_storeu_ps(protation + i, _mm_add_ps(_mm_loadu_ps(protation + i), _mm_mul_ps(spin, vdt)));
+	}
 
-			// Modify position.
-			ppos += p->velocity * dt;
+#elif defined(LOVE_SIMD_NEON)
 
-			p->position = ppos;
+	const float32x4_t vdt = vdupq_n_f32(dt);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t minlength = vdupq_n_f32(FLT_MIN);
 
-			const float t = 1.0f - p->life / p->lifetime;
+	// 32-bit ARM has no vector division or square root, so the estimates are
+	// refined with two Newton-Raphson steps instead.
+	auto reciprocal = [](float32x4_t v)
+	{
+		float32x4_t r = vrecpeq_f32(v);
+		r = vmulq_f32(vrecpsq_f32(v, r), r);
+		return vmulq_f32(vrecpsq_f32(v, r), r);
+	};
 
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
+	auto reciprocalsqrt = [](float32x4_t v)
+	{
+		float32x4_t r = vrsqrteq_f32(v);
+		r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(v, r), r), r);
+		return vmulq_f32(vrsqrtsq_f32(vmulq_f32(v, r), r), r);
+	};
 
-			p->angle = p->rotation;
+	for (; i + 4 <= last; i += 4)
+	{
+		float32x4_t x = vld1q_f32(px + i);
+		float32x4_t y = vld1q_f32(py + i);
+
+		float32x4_t rx = vsubq_f32(x, vld1q_f32(pox + i));
+		float32x4_t ry = vsubq_f32(y, vld1q_f32(poy + i));
+		float32x4_t lengthsq = vmlaq_f32(vmulq_f32(rx, rx), ry, ry);
+		float32x4_t invlength = reciprocalsqrt(vmaxq_f32(lengthsq, minlength));
+		rx = vmulq_f32(rx, invlength);
+		ry = vmulq_f32(ry, invlength);
+
+		float32x4_t radial = vld1q_f32(pradial + i);
+		float32x4_t tangential = vld1q_f32(ptangential + i);
+		float32x4_t ax = vaddq_f32(vmlsq_f32(vmulq_f32(rx, radial), ry, tangential), vld1q_f32(plax + i));
+		float32x4_t ay = vaddq_f32(vmlaq_f32(vmulq_f32(ry, radial), rx, tangential), vld1q_f32(play + i));
+
+		float32x4_t damping = reciprocal(vmlaq_f32(one, vld1q_f32(pdamping + i), vdt));
+		float32x4_t vx = vmulq_f32(vmlaq_f32(vld1q_f32(pvx + i), ax, vdt), damping);
+		float32x4_t vy = vmulq_f32(vmlaq_f32(vld1q_f32(pvy + i), ay, vdt), damping);
+
+		vst1q_f32(pvx + i, vx);
+		vst1q_f32(pvy + i, vy);
+		vst1q_f32(px + i, vmlaq_f32(x, vx, vdt));
+		vst1q_f32(py + i, vmlaq_f32(y, vy, vdt));
+
+		float32x4_t t = vmlsq_f32(one, vld1q_f32(plife + i), reciprocal(vld1q_f32(plifetime + i)));
+		float32x4_t spin = vmlaq_f32(vmulq_f32(vld1q_f32(pspinstart + i), vsubq_f32(one, t)), vld1q_f32(pspinend + i), t);
+		vst1q_f32(protation + i, vmlaq_f32(vld1q_f32(protation + i), spin, vdt));
+	}
 
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
+#endif
 
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
-			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
-			size_t i = (size_t)s;
-			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
-			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
-
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
-
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
+	// Any particles left over (or all of them, without SIMD support).
+	for (; i < last; i++)
+	{
+		// Get vector from particle center to particle, normalized. A
+		// zero-length vector stays zero.
+		float rx = px[i] - pox[i];
+		float ry = py[i] - poy[i];
+		float invlength = 1.0f / sqrtf(std::max(rx * rx + ry * ry, FLT_MIN));
+		rx *= invlength;
+		ry *= invlength;
+
+		// Radial acceleration plus tangential acceleration (perpendicular to
+		// the radial direction) plus linear acceleration.
+		float ax = rx * pradial[i] - ry * ptangential[i] + plax[i];
+		float ay = ry * pradial[i] + rx * ptangential[i] + play[i];
+
+		// Update velocity and apply damping.
+		float damping = 1.0f / (1.0f + pdamping[i] * dt);
+		float vx = (pvx[i] + ax * dt) * damping;
+		float vy = (pvy[i] + ay * dt) * damping;
+
+		pvx[i] = vx;
+		pvy[i] = vy;
+
+		// Modify position.
+		px[i] += vx * dt;
+		py[i] += vy * dt;
+
+		const float t = 1.0f - plife[i] / plifetime[i];
+
+		// Rotate.
+		protation[i] += (pspinstart[i] * (1.0f - t) + pspinend[i] * t) * dt;
+	}
+}
+
+void ParticleSystem::update(float dt)
+{
+	if ((particleData == nullptr && gpuArgsBuffer == nullptr) || dt == 0.0f)
+		return;
 
-			// Next particle.
-			p = p->next;
+	if (!gpuSimulated)
+	{
+		removeDeadParticles(dt);
+
+		uint32 count = activeParticles;
+		if (count >= PARALLEL_UPDATE_THRESHOLD)
+		{
+			if (jobSystem == nullptr)
+				jobSystem = love::thread::JobSystem::acquireShared();
+
+			int ranges = std::min(jobSystem->getWorkerCount() + 1, (int) (count / (PARALLEL_UPDATE_THRESHOLD / 2)));
+
+			jobSystem->runParallel(ranges, [&](int i)
+			{
+				uint32 first = (uint32) (((uint64) count * i) / ranges);
+				uint32 last = (uint32) (((uint64) count * (i + 1)) / ranges);
+				updateParticles(first, last, dt);
+			});
 		}
+		else
+			updateParticles(0, count, dt);
 	}
 
+	uint32 emitcount = 0;
+	float t = 0.0f;
+	float tstep = 0.0f;
+
 	// Make some more particles.
 	if (active)
 	{
-		float rate = 1.0f / emissionRate; // the amount of time between each particle emit
-		emitCounter += dt;
-		float total = emitCounter - rate;
-		while (emitCounter > rate)
-		{
-			addParticle(1.0f - (emitCounter - rate) / total);
-			emitCounter -= rate;
-		}
+		emitcount = advanceEmitCounter(emitCounter, dt, t, tstep);
+
+		// Each particle's position is interpolated between the emitter's
+		// previous and current positions.
+		if (emitcount > 0 && !gpuSimulated)
+			addParticles(emitcount, prevPosition, position, t, tstep);
 
 		life -= dt;
 		if (lifetime != -1 && life < 0)
 			stop();
 	}
 
+	if (gpuSimulated)
+		updateGPU(dt, emitcount, t, tstep);
+
 	prevPosition = position;
+
+	// Extra emitters all add to the same particle arrays, so their particles
+	// are updated and drawn along with the rest.
+	for (Emitter &e : emitters)
+	{
+		if (!e.used)
+			continue;
+
+		if (e.active)
+		{
+			uint32 count = advanceEmitCounter(e.emitCounter, dt, t, tstep);
+			if (count > 0)
+				addParticles(count, e.prevPosition, e.position, t, tstep);
+
+			e.life -= dt;
+			if (lifetime != -1 && e.life < 0)
+			{
+				e.active = false;
+				e.life = lifetime;
+				e.emitCounter = 0;
+			}
+		}
+
+		e.prevPosition = e.position;
+	}
 }
 
-void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
+uint32 ParticleSystem::advanceEmitCounter(float &counter, float dt, float &t, float &tstep) const
 {
-	uint32 pCount = getCount();
+	float rate = 1.0f / emissionRate; // the amount of time between each particle emit
+	counter += dt;
+	float total = counter - rate;
+
+	t = 1.0f - (counter - rate) / total;
+	tstep = rate / total;
 
-	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
+	uint32 count = 0;
+	while (counter > rate)
+	{
+		counter -= rate;
+		count++;
+	}
+
+	return count;
+}
+
+void ParticleSystem::updateGPU(float dt, uint32 spawncount, float t, float tstep)
+{
+	if (gpuArgsBuffer == nullptr)
 		return;
 
-	gfx->flushBatchedDraws();
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	Shader *prepare = getGPUShader(gfx, GPU_SHADER_PREPARE);
+	Shader *simulate = getGPUShader(gfx, GPU_SHADER_SIMULATE);
 
-	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	uint32 counts[4] = {spawncount, maxParticles, (uint32) rng.rand(), 0};
 
-	if (Shader::current)
-		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+	sendGPUUniform(prepare, "love_ParticleCounts", counts, sizeof(counts));
+	sendGPUBuffer(prepare, "love_ParticleArgs", gpuArgsBuffer);
+	gfx->dispatchThreadgroups(prepare, 1, 1, 1);
+
+	Vector4 params[20] = {};
+
+	params[0] = Vector4(dt, t, tstep, 0.0f);
+	params[1] = Vector4(prevPosition.x, prevPosition.y, position.x, position.y);
+	params[2] = Vector4(particleLifeMin, particleLifeMax, direction, spread);
+	params[3] = Vector4(speedMin, speedMax, (float) emissionAreaDistribution, emissionAreaAngle);
+	params[4] = Vector4(emissionArea.x, emissionArea.y, directionRelativeToEmissionCenter ? 1.0f : 0.0f, relativeRotation ? 1.0f : 0.0f);
+	params[5] = Vector4(linearAccelerationMin.x, linearAccelerationMin.y, linearAccelerationMax.x, linearAccelerationMax.y);
+	params[6] = Vector4(radialAccelerationMin, radialAccelerationMax, tangentialAccelerationMin, tangentialAccelerationMax);
+	params[7] = Vector4(linearDampingMin, linearDampingMax, sizeVariation, (float) sizes.size());
+	params[8] = Vector4(rotationMin, rotationMax, spinStart, spinEnd);
+	params[9] = Vector4(spinVariation, (float) colors.size(), 0.0f, 0.0f);
+
+	float *sizeparams = &params[10].x;
+	for (size_t i = 0; i < sizes.size() && i < 8; i++)
+		sizeparams[i] = sizes[i];
+
+	for (size_t i = 0; i < colors.size() && i < 8; i++)
+		params[12 + i] = Vector4(colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+
+	Buffer *source = gpuParticleBuffers[gpuCurrentBuffer];
+	Buffer *dest = gpuParticleBuffers[1 - gpuCurrentBuffer];
+
+	sendGPUUniform(simulate, "love_ParticleParams", params, sizeof(params));
+	sendGPUUniform(simulate, "love_ParticleCounts", counts, sizeof(counts));
+	sendGPUBuffer(simulate, "love_ParticleInput", source);
+	sendGPUBuffer(simulate, "love_ParticleOutput", dest);
+	sendGPUBuffer(simulate, "love_ParticleArgs", gpuArgsBuffer);
+	gfx->dispatchIndirect(simulate, gpuArgsBuffer, 4);
+
+	gpuCurrentBuffer = 1 - gpuCurrentBuffer;
+
+	// The CPU never waits for the GPU's particle count, it only picks up the
+	// latest value which has finished reading back.
+	if (gpuCountReadback.get() != nullptr && gpuCountReadback->isComplete())
+	{
+		data::ByteData *data = gpuCountReadback->getBufferData();
+		if (data != nullptr && !gpuCountReadback->hasError())
+			activeParticles = std::min(*(const uint32 *) data->getData(), maxParticles);
+
+		gpuCountReadback.set(nullptr);
+	}
+
+	if (gpuCountReadback.get() == nullptr)
+		gpuCountReadback.set(gfx->readbackBufferAsync(gpuArgsBuffer, sizeof(uint32), sizeof(uint32), nullptr, 0), Acquire::NORETAIN);
+}
+
+void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (gpuSimulated)
+		return drawGPU(gfx, m);
+
+	uint32 pCount = getCount();
+
+	if (pCount == 0 || texture.get() == nullptr || particleData == nullptr)
+		return;
+
+	const float *plife = getField(FIELD_LIFE);
+	const float *plifetime = getField(FIELD_LIFETIME);
+	const float *px = getField(FIELD_POSITION_X);
+	const float *py = getField(FIELD_POSITION_Y);
+	const float *pvx = getField(FIELD_VELOCITY_X);
+	const float *pvy = getField(FIELD_VELOCITY_Y);
+	const float *psizeoffset = getField(FIELD_SIZE_OFFSET);
+	const float *psizeinterval = getField(FIELD_SIZE_INTERVAL_SIZE);
+	const float *protation = getField(FIELD_ROTATION);
 
 	const Vector2 *positions = texture->getQuad()->getVertexPositions();
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
-	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
-	Particle *p = pHead;
-
 	bool useQuads = !quads.empty();
 
+	bool is2D = gfx->isTransformAffine2D();
+
+	Matrix4 transform = gfx->getCombinedTransform(m);
+
+	// Vertices are written straight into the batched draw stream buffers, in
+	// chunks that fit the batch's 16-bit index buffer.
+	const uint32 maxBatchParticles = LOVE_UINT16_MAX / 4;
+
+	Graphics::BatchedDrawCommand cmd;
+	cmd.formats[0] = getSinglePositionFormat(is2D);
+	cmd.formats[1] = CommonFormat::STf_RGBAub;
+	cmd.indexMode = TRIANGLEINDEX_QUADS;
+	cmd.texture = texture;
+
+	Colorf constantcolor = gfx->getColor();
+
 	Matrix3 t;
 
-	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (uint32 start = 0; start < pCount; start += maxBatchParticles)
 	{
-		if (useQuads)
+		uint32 end = std::min(start + maxBatchParticles, pCount);
+
+		cmd.vertexCount = (int) (end - start) * 4;
+		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+
+		char *posdata = (char *) data.stream[0];
+		size_t posstride = is2D ? sizeof(Vector2) : sizeof(Vector3);
+		STf_RGBAub *vertexdata = (STf_RGBAub *) data.stream[1];
+
+		// set the vertex data for each particle (transformation, texcoords, color)
+		for (uint32 i = start; i < end; i++)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			const float pt = 1.0f - plife[i] / plifetime[i];
+
+			// Change size according to given intervals:
+			// i = 0       1       2      3          n-1
+			//     |-------|-------|------|--- ... ---|
+			// t = 0    1/(n-1)        3/(n-1)        1
+			//
+			// `s' is the interpolation variable scaled to the current
+			// interval width, e.g. if n = 5 and t = 0.3, then the current
+			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+			float s = psizeoffset[i] + pt * psizeinterval[i]; // size variation
+			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
+			size_t a = (size_t)s;
+			size_t k = (a == sizes.size() - 1) ? a : a + 1; // boundary check (prevents failing on t = 1.0f)
+			s -= (float)a; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
+			float size = sizes[a] * (1.0f - s) + sizes[k] * s;
+
+			// Interpolate color according to given intervals (as above)
+			s = pt * (float)(colors.size() - 1);
+			a = (size_t)s;
+			k = (a == colors.size() - 1) ? a : a + 1;
+			s -= (float)a;                            // 0 <= s <= 1
+			Colorf color = colors[a] * (1.0f - s) + colors[k] * s;
+
+			// Pick the quad.
+			if (useQuads)
+			{
+				k = quads.size();
+				s = pt * (float) k; // [0:numquads-1] (clamped below)
+				a = (s > 0.0f) ? (size_t) s : 0;
+				a = (a < k) ? a : k - 1;
+
+				positions = quads[a]->getVertexPositions();
+				texcoords = quads[a]->getVertexTexCoords();
+			}
+
+			float angle = protation[i];
+			if (relativeRotation)
+				angle += atan2f(pvy[i], pvx[i]);
+
+			// particle vertices are image vertices transformed by particle info
+			Vector2 localpositions[4];
+			t.setTransformation(px[i], py[i], angle, size, size, offset.x, offset.y, 0.0f, 0.0f);
+			t.transformXY(localpositions, positions, 4);
+
+			if (is2D)
+				transform.transformXY((Vector2 *) posdata, localpositions, 4);
+			else
+				transform.transformXY0((Vector3 *) posdata, localpositions, 4);
+
+			// Particle colors are stored as floats (0-1) but vertex colors are
+			// unsigned bytes (0-255). The batch is drawn with a white constant
+			// color, so the current color is applied here.
+			Color32 c = toColor32(color * constantcolor);
+
+			// set the texture coordinate and color data for particle vertices
+			for (int v = 0; v < 4; v++)
+			{
+				vertexdata[v].s = texcoords[v].x;
+				vertexdata[v].t = texcoords[v].y;
+				vertexdata[v].color = c;
+			}
+
+			posdata += posstride * 4;
+			vertexdata += 4;
 		}
+	}
+}
 
-		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
-		t.transformXY(pVerts, positions, 4);
+void ParticleSystem::drawGPU(Graphics *gfx, const Matrix4 &m)
+{
+	if (texture.get() == nullptr || gpuArgsBuffer == nullptr)
+		return;
 
-		// Particle colors are stored as floats (0-1) but vertex colors are
-		// unsigned bytes (0-255).
-		Color32 c = toColor32(p->color);
+	// Two entries per quad, see the draw shader.
+	std::vector<Vector4> quaddata;
 
-		// set the texture coordinate and color data for particle vertices
-		for (int v = 0; v < 4; v++)
+	if (quads.empty())
+	{
+		const Quad *quad = texture->getQuad();
+		const Vector2 *positions = quad->getVertexPositions();
+		const Vector2 *texcoords = quad->getVertexTexCoords();
+		quaddata.push_back(Vector4(positions[3].x, positions[3].y, 0.0f, 0.0f));
+		quaddata.push_back(Vector4(texcoords[0].x, texcoords[0].y, texcoords[3].x - texcoords[0].x, texcoords[3].y - texcoords[0].y));
+	}
+	else
+	{
+		for (const StrongRef<Quad> &quad : quads)
 		{
-			pVerts[v].s = texcoords[v].x;
-			pVerts[v].t = texcoords[v].y;
-			pVerts[v].color = c;
+			const Vector2 *positions = quad->getVertexPositions();
+			const Vector2 *texcoords = quad->getVertexTexCoords();
+			quaddata.push_back(Vector4(positions[3].x, positions[3].y, 0.0f, 0.0f));
+			quaddata.push_back(Vector4(texcoords[0].x, texcoords[0].y, texcoords[3].x - texcoords[0].x, texcoords[3].y - texcoords[0].y));
 		}
+	}
+
+	size_t quadsize = sizeof(Vector4) * quaddata.size();
 
-		pVerts += 4;
-		p = p->next;
+	if (gpuQuadBuffer == nullptr || gpuQuadBuffer->getSize() < quadsize)
+	{
+		if (gpuQuadBuffer != nullptr)
+			gpuQuadBuffer->release();
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_DYNAMIC);
+		settings.debugName = "ParticleSystem quads";
+		gpuQuadBuffer = gfx->newBuffer(settings, DATAFORMAT_FLOAT_VEC4, quaddata.data(), quadsize, 0);
+		gpuQuadData = quaddata;
+	}
+	else if (quaddata.size() != gpuQuadData.size() || memcmp(quaddata.data(), gpuQuadData.data(), quadsize) != 0)
+	{
+		gpuQuadBuffer->fill(0, quadsize, quaddata.data());
+		gpuQuadData = quaddata;
 	}
 
-	buffer->unmap(0, pCount * sizeof(Vertex) * 4);
+	// Custom shaders can be used as long as they read the particle data the
+	// same way the built-in shader does.
+	Shader *prevshader = Shader::current;
+	bool usedefault = Shader::isDefaultActive() || prevshader == nullptr;
+	Shader *shader = usedefault ? getGPUShader(gfx, GPU_SHADER_DRAW) : prevshader;
 
-	Graphics::TempTransform transform(gfx, m);
+	if (!usedefault && !shader->hasUniform("love_ParticleBuffer"))
+		throw love::Exception("The active shader must read from the love_ParticleBuffer buffer to draw a GPU-simulated ParticleSystem.");
+
+	Vector4 drawparams(offset.x, offset.y, (float) (quaddata.size() / 2), 0.0f);
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
 
-	BufferBindings vertexbuffers;
-	vertexbuffers.set(0, buffer, 0);
+	sendGPUUniform(shader, "love_ParticleDrawParams", &drawparams, sizeof(drawparams));
+	sendGPUBuffer(shader, "love_ParticleBuffer", gpuParticleBuffers[gpuCurrentBuffer]);
+	sendGPUBuffer(shader, "love_ParticleQuadBuffer", gpuQuadBuffer);
 
-	Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
-	gfx->drawQuads(0, pCount, vertexAttributesID, vertexbuffers, tex);
+	if (usedefault)
+		shader->attach();
+
+	Graphics::TempTransform transform(gfx, m);
+	gfx->drawFromShaderIndirect(PRIMITIVE_TRIANGLE_STRIP, gpuArgsBuffer, 0, 1, texture);
+
+	if (usedefault)
+	{
+		if (prevshader != nullptr)
+			prevshader->attach();
+		else
+			Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	}
 }
 
 bool ParticleSystem::getConstant(const char *in, AreaSpreadDistribution &out)
@@ -30,6 +30,7 @@
 #include "Quad.h"
 #include "Texture.h"
 #include "Buffer.h"
+#include "GraphicsReadback.h"
 
 // STL
 #include <vector>
@@ -85,8 +86,10 @@ public:
 
 	/**
 	 * Creates a particle system with the specified buffer size and texture.
+	 * GPU-simulated systems emit, update and draw their particles entirely in
+	 * built-in compute and vertex shaders.
 	 **/
-	ParticleSystem(Texture *texture, uint32 buffer);
+	ParticleSystem(Texture *texture, uint32 buffer, bool gpuSimulated = false);
 	ParticleSystem(const ParticleSystem &p);
 
 	/**
@@ -101,6 +104,18 @@ public:
 	 **/
 	ParticleSystem *clone();
 
+	/**
+	 * Releases the job system used to update large particle systems and
+	 * releases the shaders used by GPU-simulated systems. They're created
+	 * again the next time they're needed.
+	 **/
+	static void releaseSharedResources();
+
+	/**
+	 * Gets whether this ParticleSystem is simulated on the GPU.
+	 **/
+	bool isGPUSimulated() const { return gpuSimulated; }
+
 	/**
 	 * Sets the texture used in the particle system.
 	 * @param texture The new texture.
@@ -193,6 +208,34 @@ public:
 	 **/
 	void moveTo(float x, float y);
 
+	/**
+	 * Adds an extra emitter at the given position. Extra emitters use all of
+	 * the system's settings and share its particle buffer, so many identical
+	 * effects (torches, sparks) can be updated together and drawn with one
+	 * draw instead of being separate cloned systems. They emit independently
+	 * of the system's own emitter, and are not supported by GPU-simulated
+	 * systems.
+	 * @return The emitter's id, starting at 1. Ids of removed emitters are
+	 * reused.
+	 **/
+	int addEmitter(float x, float y);
+	void removeEmitter(int id);
+	int getEmitterCount() const;
+
+	/**
+	 * Sets or moves an extra emitter's position, as setPosition and moveTo do
+	 * for the system's own emitter.
+	 **/
+	void setEmitterPosition(int id, float x, float y);
+	void moveEmitter(int id, float x, float y);
+	love::Vector2 getEmitterPosition(int id) const;
+
+	/**
+	 * Starts or stops an extra emitter. Stopping it resets its lifetime.
+	 **/
+	void setEmitterActive(int id, bool active);
+	bool isEmitterActive(int id) const;
+
 	/**
 	 * Sets the emission area spread parameters and distribution type. The interpretation of
 	 * the parameters depends on the distribution type:
@@ -453,6 +496,8 @@ public:
 
 	/**
 	 * Returns the amount of particles that are currently active in the system.
+	 * The count of GPU-simulated systems is read back asynchronously, so it
+	 * may be a few frames old.
 	 **/
 	uint32 getCount() const;
 
@@ -523,66 +568,94 @@ public:
 
 private:
 
-	// Represents a single particle.
-	struct Particle
+	// Per-particle properties. Particles are stored as one array per field
+	// (structure-of-arrays), in draw order, so updates can run as tight loops
+	// over contiguous memory.
+	enum ParticleField
 	{
-		Particle *prev;
-		Particle *next;
-
-		float lifetime;
-		float life;
-
-		love::Vector2 position;
-
-		// Particles gravitate towards this point.
-		love::Vector2 origin;
-
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
+		FIELD_LIFETIME,
+		FIELD_LIFE,
+		FIELD_POSITION_X,
+		FIELD_POSITION_Y,
+		FIELD_ORIGIN_X, // Particles gravitate towards this point.
+		FIELD_ORIGIN_Y,
+		FIELD_VELOCITY_X,
+		FIELD_VELOCITY_Y,
+		FIELD_LINEAR_ACCELERATION_X,
+		FIELD_LINEAR_ACCELERATION_Y,
+		FIELD_RADIAL_ACCELERATION,
+		FIELD_TANGENTIAL_ACCELERATION,
+		FIELD_LINEAR_DAMPING,
+		FIELD_SIZE_OFFSET,
+		FIELD_SIZE_INTERVAL_SIZE,
+		FIELD_ROTATION, // Amount of rotation applied to the final angle.
+		FIELD_SPIN_START,
+		FIELD_SPIN_END,
+		FIELD_MAX_ENUM
+	};
 
-		float linearDamping;
+	// Systems with fewer active particles than this are always updated on the
+	// calling thread, since waking the worker threads would cost more than the
+	// update itself.
+	static const uint32 PARALLEL_UPDATE_THRESHOLD = 16384;
 
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
+	float *getField(ParticleField field) const
+	{
+		return particleData + (size_t) field * maxParticles;
+	}
 
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
+	void resetOffset();
 
-		Colorf color;
+	void createBuffers(size_t size);
+	void deleteBuffers();
 
-		int quadIndex;
+	// Adds up to count particles, the first with the given interpolation
+	// value for the emitter's position and the rest spaced by tstep.
+	// Extra emitters, see addEmitter.
+	struct Emitter
+	{
+		love::Vector2 position;
+		love::Vector2 prevPosition;
+		float emitCounter;
+		float life;
+		bool active;
+		bool used;
 	};
 
-	void resetOffset();
+	Emitter &getEmitter(int id);
+	const Emitter &getEmitter(int id) const;
 
-	void createBuffers(size_t size);
-	void deleteBuffers();
+	// Advances an emission counter by dt, returning the number of particles
+	// to emit along with the t and tstep values for addParticles.
+	uint32 advanceEmitCounter(float &counter, float dt, float &t, float &tstep) const;
+
+	void addParticles(uint32 count, const love::Vector2 &from, const love::Vector2 &to, float t, float tstep);
+	void initParticle(uint32 index, const love::Vector2 &pos);
 
-	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
+	void removeDeadParticles(float dt);
+	void updateParticles(uint32 first, uint32 last, float dt);
 
-	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	// Runs the built-in simulation compute shaders, spawning up to spawncount
+	// new particles (see addParticles for t and tstep).
+	void updateGPU(float dt, uint32 spawncount, float t, float tstep);
+	void drawGPU(Graphics *gfx, const Matrix4 &m);
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	// Storage for every particle field, FIELD_MAX_ENUM arrays of maxParticles
+	// floats each.
+	float *particleData;
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	bool gpuSimulated;
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	// GPU-simulated systems ping-pong particles between two storage buffers.
+	// The args buffer holds the indirect draw and dispatch arguments as well
+	// as the particle counts used between the simulation passes.
+	Buffer *gpuParticleBuffers[2];
+	int gpuCurrentBuffer;
+	Buffer *gpuArgsBuffer;
+	Buffer *gpuQuadBuffer;
+	std::vector<Vector4> gpuQuadData;
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	StrongRef<GraphicsReadback> gpuCountReadback;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
@@ -609,6 +682,9 @@ private:
 	love::Vector2 position;
 	love::Vector2 prevPosition;
 
+	std::vector<Emitter> emitters;
+	int emitterCount;
+
 	// Emission area spread.
 	AreaSpreadDistribution emissionAreaDistribution;
 	love::Vector2 emissionArea;
@@ -673,9 +749,6 @@ private:
 
 	bool relativeRotation;
 
-	VertexAttributesID vertexAttributesID;
-	Buffer *buffer;
-
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM>::Entry distributionsEntries[];
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM> distributions;
 
@@ -24,6 +24,15 @@
 
 // C++
 #include <algorithm>
+#include <cfloat>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 // treat adjacent segments with angles between their directions <5 degree as straight
 static const float LINES_PARALLEL_EPS = 0.05f;
@@ -33,6 +42,56 @@ namespace love
 namespace graphics
 {
 
+/**
+ * Computes the length of every segment of the line, i.e. |coords[i+1] - coords[i]|
+ * for each i < count - 1.
+ **/
+static void computeSegmentLengths(const Vector2 *coords, size_t count, float *lengths)
+{
+	const float *p = (const float *) coords;
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Four segments at a time. The points are interleaved x,y pairs, so the
+	// differences are split into separate x and y vectors before squaring.
+	for (; i + 5 <= count; i += 4)
+	{
+		__m128 d0 = _mm_sub_ps(_mm_loadu_ps(p + 2 * i + 2), _mm_loadu_ps(p + 2 * i + 0));
+		__m128 d1 = _mm_sub_ps(_mm_loadu_ps(p + 2 * i + 6), _mm_loadu_ps(p + 2 * i + 4));
+		__m128 x = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 y = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(3, 1, 3, 1));
+		_mm_storeu_ps(lengths + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i + 5 <= count; i += 4)
+	{
+		float32x4x2_t a = vld2q_f32(p + 2 * i + 0);
+		float32x4x2_t b = vld2q_f32(p + 2 * i + 2);
+		float32x4_t x = vsubq_f32(b.val[0], a.val[0]);
+		float32x4_t y = vsubq_f32(b.val[1], a.val[1]);
+		float32x4_t lengthsq = vmlaq_f32(vmulq_f32(x, x), y, y);
+#if defined(__aarch64__) || defined(_M_ARM64)
+		vst1q_f32(lengths + i, vsqrtq_f32(lengthsq));
+#else
+		// 32-bit ARM has no vector square root. x * 1/sqrt(x) keeps zero-length
+		// segments at exactly zero.
+		float32x4_t r = vrsqrteq_f32(vmaxq_f32(lengthsq, vdupq_n_f32(FLT_MIN)));
+		r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(lengthsq, r), r), r);
+		r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(lengthsq, r), r), r);
+		vst1q_f32(lengths + i, vmulq_f32(lengthsq, r));
+#endif
+	}
+
+#endif
+
+	// Any segments left over (or all of them, without SIMD support).
+	for (; i + 1 < count; i++)
+		lengths[i] = (coords[i + 1] - coords[i]).getLength();
+}
+
 void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, float halfwidth, float pixel_size, bool draw_overdraw)
 {
 	static std::vector<Vector2> anchors;
@@ -43,6 +102,10 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	normals.clear();
 	normals.reserve(size_hint);
 
+	static std::vector<float> lengths;
+	lengths.resize(count - 1);
+	computeSegmentLengths(coords, count, lengths.data());
+
 	// prepare vertex arrays
 	if (draw_overdraw)
 		halfwidth -= pixel_size * 0.3f;
@@ -63,12 +126,12 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	{
 		pointA = pointB;
 		pointB = coords[i + 1];
-		renderEdge(anchors, normals, segment, segmentLength, segmentNormal, pointA, pointB, halfwidth);
+		renderEdge(anchors, normals, segment, segmentLength, segmentNormal, pointA, pointB, lengths[i], halfwidth);
 	}
 
 	pointA = pointB;
 	pointB = is_looping ? coords[1] : pointB + segment;
-	renderEdge(anchors, normals, segment, segmentLength, segmentNormal, pointA, pointB, halfwidth);
+	renderEdge(anchors, normals, segment, segmentLength, segmentNormal, pointA, pointB, is_looping ? lengths[0] : segmentLength, halfwidth);
 
 	vertex_count = normals.size();
 
@@ -87,7 +150,11 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	}
 
 	// Use a single linear array for both the regular and overdraw vertices.
-	vertices = new Vector2[vertex_count + extra_vertices + overdraw_vertex_count];
+	// Its storage is reused between lines, so steady-state line drawing
+	// doesn't allocate.
+	static std::vector<Vector2> vertexstorage;
+	vertexstorage.resize(vertex_count + extra_vertices + overdraw_vertex_count);
+	vertices = vertexstorage.data();
 
 	for (size_t i = 0; i < vertex_count; ++i)
 		vertices[i] = anchors[i] + normals[i];
@@ -109,7 +176,7 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 
 void NoneJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
                                 Vector2 &segment, float &segmentLength, Vector2 &segmentNormal,
-                                const Vector2 &pointA, const Vector2 &pointB, float halfWidth)
+                                const Vector2 &pointA, const Vector2 &pointB, float newLength, float halfWidth)
 {
 	//   ns1------ns2
 	//    |        |
@@ -123,7 +190,7 @@ void NoneJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vec
 	normals.push_back(-segmentNormal);
 
 	segment = (pointB - pointA);
-	segmentLength = segment.getLength();
+	segmentLength = newLength;
 	segmentNormal = segment.getNormal(halfWidth / segmentLength);
 
 	anchors.push_back(pointA);
@@ -172,10 +239,10 @@ void NoneJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vec
  */
 void MiterJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
                                    Vector2 &segment, float &segmentLength, Vector2 &segmentNormal,
-                                   const Vector2 &pointA, const Vector2 &pointB, float halfwidth)
+                                   const Vector2 &pointA, const Vector2 &pointB, float newLength, float halfwidth)
 {
 	Vector2 newSegment = (pointB - pointA);
-	float newSegmentLength = newSegment.getLength();
+	float newSegmentLength = newLength;
 	if (newSegmentLength == 0.0f)
 	{
 		// degenerate segment, skip it
@@ -242,10 +309,10 @@ void MiterJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Ve
  */
 void BevelJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
                                    Vector2 &segment, float &segmentLength, Vector2 &segmentNormal,
-                                   const Vector2 &pointA, const Vector2 &pointB, float halfWidth)
+                                   const Vector2 &pointA, const Vector2 &pointB, float newLength, float halfWidth)
 {
 	Vector2 newSegment = (pointB - pointA);
-	float newSegmentLength = newSegment.getLength();
+	float newSegmentLength = newLength;
 
 	float det = Vector2::cross(segment, newSegment);
 	if (fabs(det) / (segmentLength * newSegmentLength) < LINES_PARALLEL_EPS)
@@ -393,14 +460,12 @@ void NoneJoinPolyline::render_overdraw(const std::vector<Vector2> &/*normals*/,
 
 Polyline::~Polyline()
 {
-	if (vertices)
-		delete[] vertices;
 }
 
 void Polyline::draw(love::graphics::Graphics *gfx)
 {
 	const Matrix4 &t = gfx->getTransform();
-	bool is2D = t.isAffine2DTransform();
+	bool is2D = gfx->isTransformAffine2D();
 	Color32 curcolor = toColor32(gfx->getColor());
 
 	int overdraw_start = (int) overdraw_vertex_start;
@@ -427,10 +492,13 @@ void Polyline::draw(love::graphics::Graphics *gfx)
 		cmd.formats[1] = CommonFormat::STf_RGBAub;
 		cmd.indexMode = triangle_mode;
 		cmd.vertexCount = std::min(maxvertices, total_vertex_count - vertex_start);
+		cmd.allowUntransformed = true;
 
 		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
 
-		if (is2D)
+		if (!data.transformVertices)
+			memcpy(data.stream[0], verts, sizeof(Vector2) * cmd.vertexCount);
+		else if (is2D)
 			t.transformXY((Vector2 *) data.stream[0], verts, cmd.vertexCount);
 		else
 			t.transformXY0((Vector3 *) data.stream[0], verts, cmd.vertexCount);
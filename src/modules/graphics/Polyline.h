@@ -84,11 +84,12 @@ protected:
 	 * @param[in,out] segmentNormal Normal on the segment pq (updated to the segment qr).
 	 * @param[in]     pointA        Current point on the line (q).
 	 * @param[in]     pointB        Next point on the line (r).
+	 * @param[in]     newLength     Length of the segment qr.
 	 * @param[in]     halfWidth     Half line width (see Polyline.render()).
 	 */
 	virtual void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
 	                        Vector2 &segment, float &segmentLength, Vector2 &segmentNormal,
-	                        const Vector2 &pointA, const Vector2 &pointB, float halfWidth) = 0;
+	                        const Vector2 &pointA, const Vector2 &pointB, float newLength, float halfWidth) = 0;
 
 	Vector2 *vertices;
 	Vector2 *overdraw;
@@ -136,7 +137,7 @@ protected:
 	void fill_color_array(Color32 constant_color, STf_RGBAub *attributes, int count) override;
 	void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
 	                Vector2 &s, float &len_s, Vector2 &ns, const Vector2 &q,
-	                const Vector2 &r, float hw) override;
+	                const Vector2 &r, float len_qr, float hw) override;
 
 }; // NoneJoinPolyline
 
@@ -158,7 +159,7 @@ protected:
 
 	void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
 	                Vector2 &s, float &len_s, Vector2 &ns, const Vector2 &q,
-	                const Vector2 &r, float hw) override;
+	                const Vector2 &r, float len_qr, float hw) override;
 
 }; // MiterJoinPolyline
 
@@ -180,7 +181,7 @@ protected:
 
 	void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
 	                Vector2 &s, float &len_s, Vector2 &ns, const Vector2 &q,
-	                const Vector2 &r, float hw) override;
+	                const Vector2 &r, float len_qr, float hw) override;
 
 }; // BevelJoinPolyline
 
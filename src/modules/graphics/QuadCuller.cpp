@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "QuadCuller.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+
+QuadCuller::QuadCuller()
+	: enabled(false)
+{
+}
+
+void QuadCuller::setEnabled(bool enable)
+{
+	if (enable && !enabled)
+		invalidateAll();
+
+	enabled = enable;
+}
+
+void QuadCuller::invalidate(int quad)
+{
+	size_t c = (size_t) (quad / CHUNK_QUADS);
+	if (c < chunks.size())
+		chunks[c].dirty = true;
+}
+
+void QuadCuller::invalidate(int firstquad, int count)
+{
+	if (count <= 0)
+		return;
+
+	size_t first = (size_t) (firstquad / CHUNK_QUADS);
+	size_t last = std::min((size_t) ((firstquad + count - 1) / CHUNK_QUADS), chunks.size() - 1);
+
+	for (size_t c = first; c <= last && c < chunks.size(); c++)
+		chunks[c].dirty = true;
+}
+
+void QuadCuller::invalidateAll()
+{
+	for (Chunk &chunk : chunks)
+		chunk.dirty = true;
+}
+
+void QuadCuller::resize(int quadcount)
+{
+	size_t count = (size_t) ((quadcount + CHUNK_QUADS - 1) / CHUNK_QUADS);
+
+	if (count == chunks.size())
+		return;
+
+	// The partially filled last chunk changes size too.
+	if (!chunks.empty())
+		chunks.back().dirty = true;
+
+	Chunk newchunk;
+	newchunk.dirty = true;
+	chunks.resize(count, newchunk);
+}
+
+bool QuadCuller::getVisibleRanges(Graphics *gfx, const Matrix4 &m, int start, int count, std::vector<Range> &ranges) const
+{
+	ranges.clear();
+
+	Matrix4 t = gfx->getCombinedTransform(m);
+	if (!t.isAffine2DTransform())
+		return false;
+
+	Rect view = gfx->getVisibleArea();
+	if (view.w <= 0 || view.h <= 0)
+		return true;
+
+	const Vector2 viewcorners[4] =
+	{
+		Vector2((float) view.x, (float) view.y),
+		Vector2((float) view.x, (float) (view.y + view.h)),
+		Vector2((float) (view.x + view.w), (float) view.y),
+		Vector2((float) (view.x + view.w), (float) (view.y + view.h)),
+	};
+
+	// Chunk bounds are in local space, so the visible area is brought into
+	// local space instead of transforming every chunk.
+	Vector2 localcorners[4];
+	t.inverse().transformXY(localcorners, viewcorners, 4);
+
+	float minx = localcorners[0].x, maxx = localcorners[0].x;
+	float miny = localcorners[0].y, maxy = localcorners[0].y;
+	for (int i = 1; i < 4; i++)
+	{
+		minx = std::min(minx, localcorners[i].x);
+		maxx = std::max(maxx, localcorners[i].x);
+		miny = std::min(miny, localcorners[i].y);
+		maxy = std::max(maxy, localcorners[i].y);
+	}
+
+	int end = start + count;
+
+	for (int c = start / CHUNK_QUADS; c < (int) chunks.size() && c * CHUNK_QUADS < end; c++)
+	{
+		const Chunk &chunk = chunks[c];
+
+		if (chunk.maxx < minx || chunk.minx > maxx || chunk.maxy < miny || chunk.miny > maxy)
+			continue;
+
+		int first = std::max(c * CHUNK_QUADS, start);
+		int last = std::min((c + 1) * CHUNK_QUADS, end);
+
+		// Merge with the previous range when the chunks are adjacent.
+		if (!ranges.empty() && ranges.back().last + 1 == (size_t) first)
+			ranges.back().last = (size_t) (last - 1);
+		else
+			ranges.push_back(Range((size_t) first, (size_t) (last - first)));
+	}
+
+	return true;
+}
+
+} // graphics
+} // love
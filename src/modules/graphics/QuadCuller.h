@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Matrix.h"
+#include "common/Range.h"
+#include "common/Vector.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Keeps axis-aligned bounds for fixed-size chunks of consecutive quads, so
+ * batches of quads can skip drawing the chunks which fall outside the visible
+ * area. Bounds of modified chunks are lazily recomputed before drawing.
+ **/
+class QuadCuller
+{
+public:
+
+	static const int CHUNK_QUADS = 128;
+
+	QuadCuller();
+
+	void setEnabled(bool enable);
+	bool isEnabled() const { return enabled; }
+
+	void invalidate(int quad);
+	void invalidate(int firstquad, int count);
+	void invalidateAll();
+
+	/**
+	 * Recomputes the bounds of modified chunks. getcorners(quad, corners) must
+	 * write the 4 corner positions of the given quad.
+	 **/
+	template <typename GetCorners>
+	void update(int quadcount, GetCorners getcorners)
+	{
+		resize(quadcount);
+
+		for (size_t c = 0; c < chunks.size(); c++)
+		{
+			if (!chunks[c].dirty)
+				continue;
+
+			Chunk &chunk = chunks[c];
+			chunk = Chunk();
+
+			int last = std::min((int) (c + 1) * CHUNK_QUADS, quadcount);
+			for (int q = (int) c * CHUNK_QUADS; q < last; q++)
+			{
+				Vector2 corners[4];
+				getcorners(q, corners);
+
+				for (int i = 0; i < 4; i++)
+				{
+					chunk.minx = std::min(chunk.minx, corners[i].x);
+					chunk.miny = std::min(chunk.miny, corners[i].y);
+					chunk.maxx = std::max(chunk.maxx, corners[i].x);
+					chunk.maxy = std::max(chunk.maxy, corners[i].y);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Gets the contiguous ranges of quads within [start, start + count) whose
+	 * chunks intersect the visible area when drawn with the given transform.
+	 * Returns false (without culling anything) if the transform isn't 2D.
+	 **/
+	bool getVisibleRanges(Graphics *gfx, const Matrix4 &m, int start, int count, std::vector<Range> &ranges) const;
+
+private:
+
+	struct Chunk
+	{
+		float minx = std::numeric_limits<float>::max();
+		float miny = std::numeric_limits<float>::max();
+		float maxx = std::numeric_limits<float>::lowest();
+		float maxy = std::numeric_limits<float>::lowest();
+		bool dirty = false;
+	};
+
+	void resize(int quadcount);
+
+	std::vector<Chunk> chunks;
+	bool enabled;
+
+}; // QuadCuller
+
+} // graphics
+} // love
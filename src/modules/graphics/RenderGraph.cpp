@@ -0,0 +1,538 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "RenderGraph.h"
+#include "Graphics.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type RenderGraph::type("RenderGraph", &Object::type);
+
+RenderGraph::RenderGraph(Graphics *gfx)
+	: gfx(gfx)
+	, dirty(true)
+	, executing(false)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	for (const Pass &pass : passes)
+	{
+		if (pass.cleanup != nullptr)
+			pass.cleanup(pass.context);
+	}
+}
+
+void RenderGraph::checkNotExecuting(const char *action) const
+{
+	if (executing)
+		throw love::Exception("Cannot %s while the RenderGraph is executing.", action);
+}
+
+int RenderGraph::addTransientCanvas(const std::string &name, const Texture::Settings &settings)
+{
+	checkNotExecuting("add a transient canvas");
+
+	if (getTransientCanvasIndex(name) >= 0)
+		throw love::Exception("A transient canvas named '%s' already exists in this RenderGraph.", name.c_str());
+
+	if (!settings.renderTarget)
+		throw love::Exception("Transient canvases must be render targets.");
+
+	TransientCanvas canvas;
+	canvas.name = name;
+	canvas.settings = settings;
+	canvas.physical = -1;
+
+	transientCanvases.push_back(canvas);
+	dirty = true;
+
+	return (int) transientCanvases.size() - 1;
+}
+
+int RenderGraph::getTransientCanvasIndex(const std::string &name) const
+{
+	for (size_t i = 0; i < transientCanvases.size(); i++)
+	{
+		if (transientCanvases[i].name == name)
+			return (int) i;
+	}
+
+	return -1;
+}
+
+Texture *RenderGraph::getCanvas(int transient)
+{
+	if (transient < 0 || transient >= (int) transientCanvases.size())
+		throw love::Exception("Invalid transient canvas index: %d", transient + 1);
+
+	if (dirty)
+		compile();
+
+	int physical = transientCanvases[transient].physical;
+	return physical >= 0 ? physicalTextures[physical].texture.get() : nullptr;
+}
+
+void RenderGraph::addPass(const PassSettings &settings, PassFunction function, CleanupFunction cleanup, void *context)
+{
+	try
+	{
+		checkNotExecuting("add a pass");
+
+		auto checkresource = [&](const Resource &r)
+		{
+			if (r.transient >= (int) transientCanvases.size())
+				throw love::Exception("Invalid transient canvas index: %d", r.transient + 1);
+
+			if (r.texture.get() != nullptr && !r.texture->isRenderTarget())
+				throw love::Exception("Render pass targets must be canvases.");
+		};
+
+		for (const Resource &r : settings.colors)
+		{
+			if (!r.isValid())
+				throw love::Exception("Invalid render pass color target.");
+			checkresource(r);
+		}
+
+		if (settings.depthStencil.isValid())
+			checkresource(settings.depthStencil);
+
+		for (const Resource &r : settings.reads)
+		{
+			if (r.transient >= (int) transientCanvases.size())
+				throw love::Exception("Invalid transient canvas index: %d", r.transient + 1);
+		}
+	}
+	catch (love::Exception &)
+	{
+		if (cleanup != nullptr)
+			cleanup(context);
+		throw;
+	}
+
+	Pass pass;
+	pass.settings = settings;
+	pass.function = function;
+	pass.cleanup = cleanup;
+	pass.context = context;
+
+	for (const Resource &r : settings.colors)
+		pass.writeKeys.push_back(getResourceKey(r));
+
+	if (settings.depthStencil.isValid())
+		pass.writeKeys.push_back(getResourceKey(settings.depthStencil));
+
+	if (pass.writeKeys.empty())
+		pass.writeKeys.push_back(ResourceKey(nullptr, -1));
+
+	for (const Resource &r : settings.reads)
+	{
+		if (r.isValid())
+			pass.readKeys.push_back(getResourceKey(r));
+	}
+
+	passes.push_back(pass);
+	dirty = true;
+}
+
+int RenderGraph::getPassCount() const
+{
+	return (int) passes.size();
+}
+
+void RenderGraph::reset()
+{
+	checkNotExecuting("reset");
+
+	for (const Pass &pass : passes)
+	{
+		if (pass.cleanup != nullptr)
+			pass.cleanup(pass.context);
+	}
+
+	passes.clear();
+	dirty = true;
+}
+
+RenderGraph::ResourceKey RenderGraph::getResourceKey(const Resource &r)
+{
+	if (r.texture.get() != nullptr)
+		return ResourceKey(r.texture.get(), -1);
+	return ResourceKey(nullptr, r.transient);
+}
+
+bool RenderGraph::areSettingsCompatible(const Texture::Settings &a, const Texture::Settings &b)
+{
+	return a.width == b.width && a.height == b.height && a.layers == b.layers
+		&& a.type == b.type && a.mipmaps == b.mipmaps && a.mipmapCount == b.mipmapCount
+		&& a.format == b.format && a.linear == b.linear && a.dpiScale == b.dpiScale
+		&& a.msaa == b.msaa && a.computeWrite == b.computeWrite
+		&& a.readable.hasValue == b.readable.hasValue && a.readable.value == b.readable.value
+		&& a.viewFormats == b.viewFormats;
+}
+
+Texture *RenderGraph::getTexture(const Resource &r) const
+{
+	if (r.texture.get() != nullptr)
+		return r.texture.get();
+
+	int physical = transientCanvases[r.transient].physical;
+	return physical >= 0 ? physicalTextures[physical].texture.get() : nullptr;
+}
+
+void RenderGraph::compile()
+{
+	size_t npasses = passes.size();
+
+	auto contains = [](const std::vector<ResourceKey> &keys, const ResourceKey &key)
+	{
+		return std::find(keys.begin(), keys.end(), key) != keys.end();
+	};
+
+	// Walk backwards to find the passes whose results end up somewhere outside
+	// the graph, directly or through transient canvases read by later passes.
+	std::vector<bool> needed(npasses, false);
+	std::vector<ResourceKey> liveTransients;
+
+	for (size_t i = npasses; i > 0; i--)
+	{
+		const Pass &pass = passes[i - 1];
+
+		for (const ResourceKey &key : pass.writeKeys)
+		{
+			if (!isTransientKey(key) || contains(liveTransients, key))
+				needed[i - 1] = true;
+		}
+
+		if (!needed[i - 1])
+			continue;
+
+		for (const ResourceKey &key : pass.readKeys)
+		{
+			if (isTransientKey(key) && !contains(liveTransients, key))
+				liveTransients.push_back(key);
+		}
+	}
+
+	// A pass has to run after every earlier pass which writes something it
+	// uses, or which reads something it writes.
+	std::vector<std::vector<int>> dependents(npasses);
+	std::vector<int> dependencyCounts(npasses, 0);
+
+	for (size_t j = 0; j < npasses; j++)
+	{
+		if (!needed[j])
+			continue;
+
+		const Pass &later = passes[j];
+
+		for (size_t i = 0; i < j; i++)
+		{
+			if (!needed[i])
+				continue;
+
+			const Pass &earlier = passes[i];
+			bool conflict = false;
+
+			for (const ResourceKey &key : later.writeKeys)
+			{
+				if (contains(earlier.writeKeys, key) || contains(earlier.readKeys, key))
+					conflict = true;
+			}
+
+			for (const ResourceKey &key : later.readKeys)
+			{
+				if (contains(earlier.writeKeys, key))
+					conflict = true;
+			}
+
+			if (conflict)
+			{
+				dependents[i].push_back((int) j);
+				dependencyCounts[j]++;
+			}
+		}
+	}
+
+	// Prefer a pass with the same render targets as the previous one, so the
+	// render pass doesn't have to be ended and restarted. Otherwise keep the
+	// order the passes were added in.
+	std::vector<int> order;
+	std::vector<bool> scheduled(npasses, false);
+	size_t nneeded = std::count(needed.begin(), needed.end(), true);
+
+	stats = Stats();
+	stats.passes = (int) nneeded;
+	stats.culledPasses = (int) (npasses - nneeded);
+	stats.transientCanvases = (int) transientCanvases.size();
+
+	while (order.size() < nneeded)
+	{
+		int next = -1;
+
+		for (size_t i = 0; i < npasses; i++)
+		{
+			if (!needed[i] || scheduled[i] || dependencyCounts[i] > 0)
+				continue;
+
+			if (!order.empty() && passes[i].writeKeys == passes[order.back()].writeKeys)
+			{
+				next = (int) i;
+				break;
+			}
+
+			if (next < 0)
+				next = (int) i;
+		}
+
+		if (!order.empty() && passes[next].writeKeys == passes[order.back()].writeKeys)
+			stats.mergedPasses++;
+
+		scheduled[next] = true;
+		order.push_back(next);
+
+		for (int dependent : dependents[next])
+			dependencyCounts[dependent]--;
+	}
+
+	// Assign textures to transient canvases. Canvases whose lifetimes don't
+	// overlap can share a texture if their settings match.
+	size_t ntransients = transientCanvases.size();
+	std::vector<int> firstUse(ntransients, -1);
+	std::vector<int> lastUse(ntransients, -1);
+
+	for (size_t step = 0; step < order.size(); step++)
+	{
+		const Pass &pass = passes[order[step]];
+
+		for (const auto *keys : { &pass.writeKeys, &pass.readKeys })
+		{
+			for (const ResourceKey &key : *keys)
+			{
+				if (!isTransientKey(key))
+					continue;
+
+				if (firstUse[key.second] < 0)
+					firstUse[key.second] = (int) step;
+				lastUse[key.second] = (int) step;
+			}
+		}
+	}
+
+	std::vector<int> transientOrder;
+	for (size_t i = 0; i < ntransients; i++)
+	{
+		transientCanvases[i].physical = -1;
+		if (firstUse[i] >= 0)
+			transientOrder.push_back((int) i);
+	}
+
+	std::stable_sort(transientOrder.begin(), transientOrder.end(), [&](int a, int b)
+	{
+		return firstUse[a] < firstUse[b];
+	});
+
+	for (PhysicalTexture &physical : physicalTextures)
+		physical.lastUse = -2;
+
+	for (int i : transientOrder)
+	{
+		TransientCanvas &canvas = transientCanvases[i];
+
+		for (size_t p = 0; p < physicalTextures.size(); p++)
+		{
+			const PhysicalTexture &physical = physicalTextures[p];
+			if (physical.lastUse < firstUse[i] && areSettingsCompatible(physical.settings, canvas.settings))
+			{
+				canvas.physical = (int) p;
+				break;
+			}
+		}
+
+		if (canvas.physical < 0)
+		{
+			PhysicalTexture physical;
+			physical.texture.set(gfx->newTexture(canvas.settings), Acquire::NORETAIN);
+			physical.settings = canvas.settings;
+			physicalTextures.push_back(physical);
+			canvas.physical = (int) physicalTextures.size() - 1;
+		}
+
+		physicalTextures[canvas.physical].lastUse = lastUse[i];
+	}
+
+	// Free textures no transient canvas uses anymore.
+	std::vector<int> remap(physicalTextures.size(), -1);
+	std::vector<PhysicalTexture> usedTextures;
+
+	for (size_t p = 0; p < physicalTextures.size(); p++)
+	{
+		if (physicalTextures[p].lastUse == -2)
+			continue;
+
+		remap[p] = (int) usedTextures.size();
+		usedTextures.push_back(physicalTextures[p]);
+	}
+
+	physicalTextures = std::move(usedTextures);
+
+	for (TransientCanvas &canvas : transientCanvases)
+	{
+		if (canvas.physical >= 0)
+			canvas.physical = remap[canvas.physical];
+	}
+
+	stats.transientTextures = (int) physicalTextures.size();
+
+	// A transient canvas has no meaningful contents at its first use, so
+	// loading them can be skipped unless it's cleared anyway.
+	steps.clear();
+
+	for (size_t step = 0; step < order.size(); step++)
+	{
+		const Pass &pass = passes[order[step]];
+		const PassSettings &settings = pass.settings;
+
+		Step s;
+		s.pass = order[step];
+		s.merged = step > 0 && pass.writeKeys == passes[order[step - 1]].writeKeys;
+		s.discardColors.resize(settings.colors.size(), false);
+		s.discardDepthStencil = false;
+
+		auto isfirstuse = [&](const Resource &r)
+		{
+			return r.texture.get() == nullptr && r.transient >= 0 && firstUse[r.transient] == (int) step;
+		};
+
+		for (size_t i = 0; i < settings.colors.size(); i++)
+		{
+			bool cleared = i < settings.clearColors.size() && settings.clearColors[i].hasValue;
+			s.discardColors[i] = !cleared && isfirstuse(settings.colors[i]);
+		}
+
+		if (settings.depthStencil.isValid())
+		{
+			bool cleared = settings.clearDepth.hasValue || settings.clearStencil.hasValue;
+			s.discardDepthStencil = !cleared && isfirstuse(settings.depthStencil);
+		}
+
+		steps.push_back(s);
+	}
+
+	dirty = false;
+}
+
+void RenderGraph::execute()
+{
+	checkNotExecuting("execute the RenderGraph");
+
+	if (dirty)
+		compile();
+
+	Graphics::RenderTargets previous = gfx->getRenderTargets();
+
+	Graphics::RenderTargetsStrongRef previousRefs;
+	for (const auto &rt : previous.colors)
+		previousRefs.colors.emplace_back(rt.texture, rt.slice, rt.mipmap);
+	previousRefs.depthStencil = Graphics::RenderTargetStrongRef(previous.depthStencil.texture, previous.depthStencil.slice, previous.depthStencil.mipmap);
+	previousRefs.temporaryRTFlags = previous.temporaryRTFlags;
+	previousRefs.resolve = previous.resolve;
+
+	executing = true;
+
+	try
+	{
+		for (const Step &step : steps)
+		{
+			const Pass &pass = passes[step.pass];
+			const PassSettings &settings = pass.settings;
+
+			// Setting the same targets again is a no-op, but passes may have
+			// changed them.
+			Graphics::RenderTargets rts;
+			for (const Resource &r : settings.colors)
+				rts.colors.emplace_back(getTexture(r));
+			if (settings.depthStencil.isValid())
+				rts.depthStencil = Graphics::RenderTarget(getTexture(settings.depthStencil));
+
+			if (rts.getFirstTarget().texture == nullptr)
+				gfx->setRenderTarget();
+			else
+				gfx->setRenderTargets(rts);
+
+			bool clearcolor = false;
+			for (const auto &color : settings.clearColors)
+				clearcolor = clearcolor || color.hasValue;
+
+			if (clearcolor || settings.clearDepth.hasValue || settings.clearStencil.hasValue)
+				gfx->clear(settings.clearColors, settings.clearStencil, settings.clearDepth);
+
+			bool discard = step.discardDepthStencil;
+			for (bool d : step.discardColors)
+				discard = discard || d;
+
+			if (discard)
+				gfx->discard(step.discardColors, step.discardDepthStencil);
+
+			if (pass.function != nullptr)
+				pass.function(pass.context, this);
+		}
+	}
+	catch (love::Exception &)
+	{
+		executing = false;
+		gfx->setRenderTargets(previousRefs);
+		throw;
+	}
+
+	executing = false;
+	gfx->setRenderTargets(previousRefs);
+}
+
+const RenderGraph::Stats &RenderGraph::getStats()
+{
+	if (dirty)
+		compile();
+	return stats;
+}
+
+std::vector<std::string> RenderGraph::getExecutionOrder()
+{
+	if (dirty)
+		compile();
+
+	std::vector<std::string> names;
+	for (const Step &step : steps)
+		names.push_back(passes[step.pass].settings.name);
+
+	return names;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Optional.h"
+#include "common/Color.h"
+#include "common/int.h"
+#include "Texture.h"
+
+// C++
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A list of render passes which declare the textures they render to and read
+ * from. When executed, the passes are reordered (within the constraints of
+ * their dependencies) so passes with the same render targets run back to back,
+ * passes whose results are never used are skipped, and the textures of
+ * transient canvases whose lifetimes don't overlap are shared.
+ *
+ * Passes which render to the screen or to a Texture owned by the caller are
+ * always kept. Transient canvases are owned by the graph and their contents
+ * are only defined between the first and last pass which uses them.
+ **/
+class RenderGraph : public Object
+{
+public:
+
+	static love::Type type;
+
+	typedef void (*PassFunction)(void *context, RenderGraph *graph);
+	typedef void (*CleanupFunction)(void *context);
+
+	// Either a Texture owned by the caller, or one of the graph's transient
+	// canvases.
+	struct Resource
+	{
+		StrongRef<Texture> texture;
+		int transient = -1;
+
+		bool isValid() const { return texture.get() != nullptr || transient >= 0; }
+	};
+
+	struct PassSettings
+	{
+		std::string name;
+
+		// No color or depth/stencil targets means the pass renders to the screen.
+		std::vector<Resource> colors;
+		Resource depthStencil;
+
+		std::vector<Resource> reads;
+
+		std::vector<Optional<ColorD>> clearColors;
+		OptionalInt clearStencil;
+		OptionalDouble clearDepth;
+	};
+
+	struct Stats
+	{
+		int passes = 0;
+		int culledPasses = 0;
+		int mergedPasses = 0;
+		int transientCanvases = 0;
+		int transientTextures = 0;
+	};
+
+	RenderGraph(Graphics *gfx);
+	virtual ~RenderGraph();
+
+	int addTransientCanvas(const std::string &name, const Texture::Settings &settings);
+	int getTransientCanvasIndex(const std::string &name) const;
+
+	/**
+	 * Returns the Texture currently backing a transient canvas, or nullptr if
+	 * no pass which is executed uses it.
+	 **/
+	Texture *getCanvas(int transient);
+
+	void addPass(const PassSettings &settings, PassFunction function, CleanupFunction cleanup, void *context);
+	int getPassCount() const;
+
+	// Removes all passes. Transient canvases and their textures are kept.
+	void reset();
+
+	void execute();
+	bool isExecuting() const { return executing; }
+
+	const Stats &getStats();
+
+	// Returns the names of the passes which are executed, in execution order.
+	std::vector<std::string> getExecutionOrder();
+
+private:
+
+	// The Texture for external resources, otherwise the transient canvas index.
+	// The screen is { nullptr, -1 }.
+	typedef std::pair<Texture *, int> ResourceKey;
+
+	struct Pass
+	{
+		PassSettings settings;
+		PassFunction function;
+		CleanupFunction cleanup;
+		void *context;
+
+		std::vector<ResourceKey> writeKeys;
+		std::vector<ResourceKey> readKeys;
+	};
+
+	struct Step
+	{
+		int pass;
+		bool merged;
+		std::vector<bool> discardColors;
+		bool discardDepthStencil;
+	};
+
+	struct TransientCanvas
+	{
+		std::string name;
+		Texture::Settings settings;
+		int physical;
+	};
+
+	struct PhysicalTexture
+	{
+		StrongRef<Texture> texture;
+		Texture::Settings settings;
+		int lastUse;
+	};
+
+	static ResourceKey getResourceKey(const Resource &r);
+	static bool isTransientKey(const ResourceKey &key) { return key.first == nullptr && key.second >= 0; }
+	static bool areSettingsCompatible(const Texture::Settings &a, const Texture::Settings &b);
+
+	void compile();
+	void checkNotExecuting(const char *action) const;
+	Texture *getTexture(const Resource &r) const;
+
+	Graphics *gfx;
+
+	std::vector<Pass> passes;
+	std::vector<TransientCanvas> transientCanvases;
+	std::vector<PhysicalTexture> physicalTextures;
+
+	std::vector<Step> steps;
+	Stats stats;
+
+	bool dirty;
+	bool executing;
+
+}; // RenderGraph
+
+} // graphics
+} // love
@@ -23,6 +23,8 @@
 #include "Graphics.h"
 #include "math/MathModule.h"
 #include "common/Range.h"
+#include "thread/JobSystem.h"
+#include "profiler/Profiler.h"
 
 // glslang
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
@@ -36,6 +38,7 @@
 #include <string>
 #include <regex>
 #include <sstream>
+#include <atomic>
 
 namespace love
 {
@@ -563,6 +566,7 @@ static_assert(sizeof(Shader::BuiltinUniformData) == sizeof(float) * 4 * 12, "Upd
 love::Type Shader::type("Shader", &Object::type);
 
 Shader *Shader::current = nullptr;
+int64 Shader::frameUniformBytesUploaded = 0;
 Shader *Shader::standardShaders[Shader::STANDARD_MAX_ENUM] = {nullptr};
 
 Shader::SourceInfo Shader::getSourceInfo(const std::string &src)
@@ -642,14 +646,81 @@ std::string Shader::createShaderStageCode(Graphics *gfx, ShaderStageType stage,
 	return ss.str();
 }
 
+struct Shader::AsyncValidation
+{
+	love::thread::JobGroup group;
+	std::atomic<bool> finished;
+	std::atomic<bool> cancelled;
+	bool success;
+	std::string error;
+	Reflection reflection;
+
+	AsyncValidation()
+		: finished(false)
+		, cancelled(false)
+		, success(false)
+	{}
+};
+
 Shader::Shader(StrongRef<ShaderStage> _stages[], const CompileOptions &options)
 	: stages()
+	, sharedUniformBuffersVersion(0)
 	, debugName(options.debugName)
+	, compileOptions(options)
+	, variantSourceCompute(false)
+	, asyncValidation(nullptr)
 {
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		stages[i] = _stages[i];
+
+	if (options.async)
+	{
+		startAsyncValidation();
+		return;
+	}
+
 	std::string err;
-	if (!validateInternal(_stages, err, reflection))
+	if (!validateInternal(stages, err, reflection))
 		throw love::Exception("%s", err.c_str());
 
+	setupReflectionState();
+}
+
+void Shader::startAsyncValidation()
+{
+	AsyncValidation *validation = new AsyncValidation();
+	asyncValidation = validation;
+
+	// The destructor waits for the job, so the stages outlive it.
+	StrongRef<ShaderStage> *jobstages = stages;
+
+	auto run = [validation, jobstages]()
+	{
+		if (!validation->cancelled)
+		{
+			try
+			{
+				validation->success = validateInternal(jobstages, validation->error, validation->reflection);
+			}
+			catch (love::Exception &e)
+			{
+				validation->error = e.what();
+			}
+		}
+		validation->finished = true;
+	};
+
+	auto cancel = [validation]()
+	{
+		validation->error = "Shader compilation was cancelled.";
+		validation->finished = true;
+	};
+
+	love::thread::JobSystem::acquireShared()->submit(run, cancel, &validation->group);
+}
+
+void Shader::setupReflectionState()
+{
 	std::vector<std::string> unsetVertexInputLocations;
 
 	for (const auto &kvp : reflection.vertexInputs)
@@ -691,11 +762,15 @@ Shader::Shader(StrongRef<ShaderStage> _stages[], const CompileOptions &options)
 				activeTextures[u.resourceIndex + i] = tex;
 			}
 		}
-		else if (u.baseType == UNIFORM_TEXELBUFFER || u.baseType == UNIFORM_STORAGEBUFFER)
+		else if (u.baseType == UNIFORM_TEXELBUFFER || u.baseType == UNIFORM_STORAGEBUFFER || u.baseType == UNIFORM_UNIFORMBUFFER)
 		{
-			auto buffer = u.baseType == UNIFORM_TEXELBUFFER
-				? gfx->getDefaultTexelBuffer(u.dataBaseType)
-				: gfx->getDefaultStorageBuffer();
+			Buffer *buffer = nullptr;
+			if (u.baseType == UNIFORM_TEXELBUFFER)
+				buffer = gfx->getDefaultTexelBuffer(u.dataBaseType);
+			else if (u.baseType == UNIFORM_STORAGEBUFFER)
+				buffer = gfx->getDefaultStorageBuffer();
+			else
+				buffer = gfx->getDefaultUniformBuffer();
 
 			for (int i = 0; i < u.count; i++)
 			{
@@ -705,12 +780,18 @@ Shader::Shader(StrongRef<ShaderStage> _stages[], const CompileOptions &options)
 		}
 	}
 
-	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
-		stages[i] = _stages[i];
 }
 
 Shader::~Shader()
 {
+	if (asyncValidation != nullptr)
+	{
+		asyncValidation->cancelled = true;
+		asyncValidation->group.wait();
+		delete asyncValidation;
+		love::thread::JobSystem::releaseShared();
+	}
+
 	for (int i = 0; i < STANDARD_MAX_ENUM; i++)
 	{
 		if (this == standardShaders[i])
@@ -733,11 +814,58 @@ Shader::~Shader()
 	}
 }
 
+bool Shader::isReady()
+{
+	return asyncValidation == nullptr || asyncValidation->finished;
+}
+
+void Shader::waitUntilReady()
+{
+	if (!asyncError.empty())
+		throw love::Exception("%s", asyncError.c_str());
+
+	if (asyncValidation == nullptr)
+		return;
+
+	LOVE_PROFILE_ZONE("love.graphics.waitForShader");
+
+	asyncValidation->group.wait();
+
+	bool success = asyncValidation->success;
+	std::string err = asyncValidation->error;
+	reflection = std::move(asyncValidation->reflection);
+
+	delete asyncValidation;
+	asyncValidation = nullptr;
+	love::thread::JobSystem::releaseShared();
+
+	try
+	{
+		if (!success)
+			throw love::Exception("%s", err.c_str());
+
+		setupReflectionState();
+		finishCompiling();
+	}
+	catch (love::Exception &e)
+	{
+		asyncError = e.what();
+		throw;
+	}
+}
+
 bool Shader::hasStage(ShaderStageType stage)
 {
 	return stages[stage] != nullptr;
 }
 
+bool Shader::hasDefaultVertexStage() const
+{
+	// Shaders without vertex code share the cached default vertex stage.
+	Shader *standard = standardShaders[STANDARD_DEFAULT];
+	return standard != nullptr && stages[SHADERSTAGE_VERTEX].get() == standard->stages[SHADERSTAGE_VERTEX].get();
+}
+
 void Shader::attachDefault(StandardShader defaultType)
 {
 	Shader *defaultshader = standardShaders[defaultType];
@@ -815,6 +943,39 @@ void Shader::setVideoTextures(love::graphics::Texture *ytexture, love::graphics:
 	}
 }
 
+void Shader::setPaletteTexture(love::graphics::Texture *palette)
+{
+	const UniformInfo *info = getUniformInfo(BUILTIN_TEXTURE_PALETTE);
+	if (info == nullptr || activeTextures[info->resourceIndex] == palette)
+		return;
+
+	// Unlike the video textures, the palette can change between draws which
+	// share a batch.
+	flushBatchedDraws();
+	sendTextures(info, &palette, 1, true);
+}
+
+void Shader::setBoneBuffer(love::graphics::Buffer *bones)
+{
+	const UniformInfo *info = getUniformInfo(BUILTIN_TEXELBUFFER_BONES);
+	if (info == nullptr || activeBuffers[info->resourceIndex] == bones)
+		return;
+
+	sendBuffers(info, &bones, 1, true);
+}
+
+void Shader::markTexturesUsed()
+{
+	if (Texture::evictableTextureCount == 0)
+		return;
+
+	for (Texture *tex : activeTextures)
+	{
+		if (tex != nullptr)
+			tex->markUsed();
+	}
+}
+
 void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count)
 {
 	Shader::sendTextures(info, textures, count, false);
@@ -870,7 +1031,7 @@ void Shader::sendBuffers(const UniformInfo *info, Buffer **buffers, int count, b
 {
 	UniformType basetype = info->baseType;
 
-	if (basetype != UNIFORM_TEXELBUFFER && basetype != UNIFORM_STORAGEBUFFER)
+	if (basetype != UNIFORM_TEXELBUFFER && basetype != UNIFORM_STORAGEBUFFER && basetype != UNIFORM_UNIFORMBUFFER)
 		return;
 
 	if (!internalUpdate && current == this)
@@ -893,8 +1054,10 @@ void Shader::sendBuffers(const UniformInfo *info, Buffer **buffers, int count, b
 			auto gfx = Module::getInstance<love::graphics::Graphics>(Module::M_GRAPHICS);
 			if (basetype == UNIFORM_TEXELBUFFER)
 				buffer = gfx->getDefaultTexelBuffer(info->dataBaseType);
-			else
+			else if (basetype == UNIFORM_STORAGEBUFFER)
 				buffer = gfx->getDefaultStorageBuffer();
+			else
+				buffer = gfx->getDefaultUniformBuffer();
 		}
 
 		buffer->retain();
@@ -910,10 +1073,79 @@ void Shader::sendBuffers(const UniformInfo *info, Buffer **buffers, int count, b
 	}
 }
 
+Shader *Shader::getVariant(const std::map<std::string, std::string> &defines)
+{
+	if (variantSource.empty())
+		throw love::Exception("Variants can only be created from Shaders made with love.graphics.newShader or newComputeShader.");
+
+	CompileOptions options = compileOptions;
+	for (const auto &def : defines)
+		options.defines[def.first] = def.second;
+
+	if (options.defines == compileOptions.defines)
+		return this;
+
+	std::string key;
+	for (const auto &def : options.defines)
+	{
+		key += def.first;
+		key += '\n';
+		key += def.second;
+		key += '\n';
+	}
+
+	auto it = variants.find(key);
+	if (it != variants.end())
+		return it->second.get();
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	StrongRef<Shader> variant;
+	if (variantSourceCompute)
+		variant.set(gfx->newComputeShader(variantSource[0], options), Acquire::NORETAIN);
+	else
+		variant.set(gfx->newShader(variantSource, options), Acquire::NORETAIN);
+
+	variants[key] = variant;
+	return variant.get();
+}
+
+void Shader::setVariantSource(const std::vector<std::string> &stagessource, bool compute)
+{
+	variantSource = stagessource;
+	variantSourceCompute = compute;
+}
+
+void Shader::updateSharedUniformBuffers()
+{
+	if (reflection.uniformBuffers.empty())
+		return;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr || gfx->getUniformBuffersVersion() == sharedUniformBuffersVersion)
+		return;
+
+	sharedUniformBuffersVersion = gfx->getUniformBuffersVersion();
+
+	for (auto &kvp : reflection.uniformBuffers)
+	{
+		const UniformInfo *info = &kvp.second;
+		if (!info->active)
+			continue;
+
+		// Blocks without a usable Buffer read zeroes from the default one.
+		Buffer *buffer = gfx->getUniformBuffer(info->name);
+		if (buffer != nullptr && !validateBuffer(info, buffer, true))
+			buffer = nullptr;
+
+		sendBuffers(info, &buffer, 1, true);
+	}
+}
+
 void Shader::flushBatchedDraws() const
 {
 	if (current == this)
-		Graphics::flushBatchedDrawsGlobal();
+		Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_UNIFORM);
 }
 
 const Shader::UniformInfo *Shader::getMainTextureInfo() const
@@ -1245,12 +1477,25 @@ static bool AddFieldsToFormat(std::vector<Buffer::DataDeclaration> &format, int
 
 bool Shader::validateInternal(StrongRef<ShaderStage> stages[], std::string &err, Reflection &reflection)
 {
+	// Cached stages can be shared with Shaders being validated on other
+	// threads, and linking modifies their glslang shaders. Locking in stage
+	// order keeps two validations from deadlocking.
+	love::thread::EmptyLock locks[SHADERSTAGE_MAX_ENUM];
+
 	glslang::TProgram program;
 
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		if (stages[i] != nullptr)
-			program.addShader(stages[i]->getGLSLangValidationShader());
+		if (stages[i] == nullptr)
+			continue;
+
+		locks[i].setLock(stages[i]->getValidationMutex());
+
+		glslang::TShader *glslangshader = stages[i]->getGLSLangValidationShader(err);
+		if (glslangshader == nullptr)
+			return false;
+
+		program.addShader(glslangshader);
 	}
 
 	if (!program.link((EShMessages)(EshMsgCrossStageIO | EshMsgOverlappingLocations)))
@@ -1311,6 +1556,10 @@ bool Shader::validateInternal(StrongRef<ShaderStage> stages[], std::string &err,
 		if (type == nullptr)
 			continue;
 
+		// Members of uniform blocks are backed by a Buffer, not set individually.
+		if (info.index >= 0)
+			continue;
+
 		const glslang::TQualifier &qualifiers = type->getQualifier();
 
 		UniformInfo u = {};
@@ -1530,9 +1779,59 @@ bool Shader::validateInternal(StrongRef<ShaderStage> stages[], std::string &err,
 		}
 	}
 
+	for (int i = 0; i < program.getNumUniformBlocks(); i++)
+	{
+		const glslang::TObjectReflection &info = program.getUniformBlock(i);
+		const glslang::TType *type = info.getType();
+		if (type == nullptr)
+		{
+			err = "Shader validation error:\nCannot retrieve type information for Uniform Block '" + info.name + "'.";
+			return false;
+		}
+
+		if (type->getQualifier().layoutPacking != glslang::ElpStd140)
+		{
+			err = "Shader validation error:\nUniform block '" + info.name + "' must use the std140 packing layout.";
+			return false;
+		}
+
+		if (type->isArray())
+		{
+			err = "Shader validation error:\nUniform block '" + info.name + "' cannot be an array.";
+			return false;
+		}
+
+		if (info.size > (int) Buffer::UNIFORM_BUFFER_MAX_SIZE)
+		{
+			err = "Shader validation error:\nUniform block '" + info.name + "' is larger than " + std::to_string(Buffer::UNIFORM_BUFFER_MAX_SIZE) + " bytes.";
+			return false;
+		}
+
+		UniformInfo u = {};
+		u.name = canonicaliizeUniformName(info.name);
+		u.location = -1;
+		u.access = ACCESS_READ;
+		u.stageMask = getStageMask(info.stages);
+		u.components = 1;
+		u.baseType = UNIFORM_UNIFORMBUFFER;
+		u.count = 1;
+
+		// The minimum number of bytes a Buffer needs to back the block.
+		u.bufferStride = (size_t) info.size;
+		u.bufferMemberCount = (size_t) info.numMembers;
+
+		u.resourceIndex = reflection.bufferCount;
+		reflection.bufferCount += u.count;
+
+		reflection.uniformBuffers[u.name] = u;
+	}
+
 	for (auto &kvp : reflection.texelBuffers)
 		reflection.allUniforms[kvp.first] = &kvp.second;
 
+	for (auto &kvp : reflection.uniformBuffers)
+		reflection.allUniforms[kvp.first] = &kvp.second;
+
 	for (auto &kvp : reflection.storageBuffers)
 		reflection.allUniforms[kvp.first] = &kvp.second;
 
@@ -1619,11 +1918,14 @@ bool Shader::validateBuffer(const UniformInfo *info, Buffer *buffer, bool intern
 
 	bool texelbinding = info->baseType == UNIFORM_TEXELBUFFER;
 	bool storagebinding = info->baseType == UNIFORM_STORAGEBUFFER;
+	bool uniformbinding = info->baseType == UNIFORM_UNIFORMBUFFER;
 
 	if (texelbinding)
 		requiredtypeflags = BUFFERUSAGEFLAG_TEXEL;
 	else if (storagebinding)
 		requiredtypeflags = BUFFERUSAGEFLAG_SHADER_STORAGE;
+	else if (uniformbinding)
+		requiredtypeflags = BUFFERUSAGEFLAG_UNIFORM;
 
 	if ((buffer->getUsageFlags() & requiredtypeflags) == 0)
 	{
@@ -1633,6 +1935,8 @@ bool Shader::validateBuffer(const UniformInfo *info, Buffer *buffer, bool intern
 			throw love::Exception("Shader uniform '%s' is a texel buffer, but the given Buffer was not created with texel buffer capabilities.", info->name.c_str());
 		else if (storagebinding)
 			throw love::Exception("Shader uniform '%s' is a shader storage buffer block, but the given Buffer was not created with shader storage buffer capabilities.", info->name.c_str());
+		else if (uniformbinding)
+			throw love::Exception("Shader uniform '%s' is a uniform block, but the given Buffer was not created with uniform buffer capabilities.", info->name.c_str());
 		else
 			throw love::Exception("Shader uniform '%s' does not match the types supported by the given Buffer.", info->name.c_str());
 	}
@@ -1665,6 +1969,17 @@ bool Shader::validateBuffer(const UniformInfo *info, Buffer *buffer, bool intern
 					info->name.c_str(), info->bufferMemberCount, buffer->getDataMembers().size());
 		}
 	}
+	else if (uniformbinding)
+	{
+		if (buffer->getSize() < info->bufferStride)
+		{
+			if (internalUpdate)
+				return false;
+			else
+				throw love::Exception("Uniform block '%s' uses %d bytes, but the given Buffer only has %d bytes.",
+					info->name.c_str(), (int) info->bufferStride, (int) buffer->getSize());
+		}
+	}
 
 	return true;
 }
@@ -1740,6 +2055,42 @@ void Shader::copyToUniformBuffer(const UniformInfo *info, const void *src, void
 	}
 }
 
+bool Shader::isUniformBufferDataEqual(const UniformInfo *info, const void *src, const void *dst, int count) const
+{
+	count = std::min(count, info->count);
+
+	size_t elementsize = info->components * 4;
+	if (info->baseType == UNIFORM_MATRIX)
+		elementsize = info->matrix.columns * info->matrix.rows * 4;
+
+	// Same packing cases as copyToUniformBuffer.
+	if (elementsize * info->count == info->dataSize || (count == 1 && info->baseType != UNIFORM_MATRIX))
+		return memcmp(dst, src, elementsize * count) == 0;
+
+	int veccount = count;
+	int comp = info->components;
+
+	if (info->baseType == UNIFORM_MATRIX)
+	{
+		veccount *= info->matrix.rows;
+		comp = info->matrix.columns;
+	}
+
+	const int *isrc = (const int *) src;
+	const int *idst = (const int *) dst;
+
+	for (int i = 0; i < veccount; i++)
+	{
+		for (int c = 0; c < comp; c++)
+		{
+			if (idst[i * 4 + c] != isrc[i * comp + c])
+				return false;
+		}
+	}
+
+	return true;
+}
+
 bool Shader::initialize()
 {
 	bool success = glslang::InitializeProcess();
@@ -1776,6 +2127,57 @@ vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
 }
 )";
 
+// Skinned Meshes have up to 4 bones per vertex. Each bone's transform is 3
+// floatvec4 texels in love_BoneTransforms, holding the first 3 rows of its
+// matrix. Texel buffers need GLSL ES 3.20 on mobile, so older versions draw
+// the Mesh unskinned.
+static const std::string defaultSkinnedVertex = R"(
+#if !defined(GL_ES) || __VERSION__ >= 320
+uniform highp samplerBuffer love_BoneTransforms;
+#endif
+attribute vec4 love_BoneIndices;
+attribute vec4 love_BoneWeights;
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+#if !defined(GL_ES) || __VERSION__ >= 320
+	vec3 skinned = vec3(0.0);
+	for (int i = 0; i < 4; i++)
+	{
+		int base = int(love_BoneIndices[i] + 0.5) * 3;
+		vec3 p;
+		p.x = dot(texelFetch(love_BoneTransforms, base + 0), localPosition);
+		p.y = dot(texelFetch(love_BoneTransforms, base + 1), localPosition);
+		p.z = dot(texelFetch(love_BoneTransforms, base + 2), localPosition);
+		skinned += p * love_BoneWeights[i];
+	}
+	localPosition = vec4(skinned, localPosition.w);
+#endif
+	return clipSpaceFromLocal * localPosition;
+}
+)";
+
+static const std::string defaultInstancedSpritesVertex = R"(
+attribute vec4 love_SpriteTransform;
+attribute vec2 love_SpriteOffset;
+attribute vec4 love_SpriteTexRect;
+attribute vec4 love_SpriteColor;
+
+varying highp vec4 VaryingTexCoord;
+varying mediump vec4 VaryingColor;
+
+void vertexmain()
+{
+	// Each instance is a quad drawn as a 4 vertex triangle strip.
+	vec2 corner = vec2(float(love_VertexID >> 1), float(love_VertexID & 1));
+	vec2 pos = love_SpriteOffset + love_SpriteTransform.xy * corner.x + love_SpriteTransform.zw * corner.y;
+
+	VaryingTexCoord = vec4(love_SpriteTexRect.xy + love_SpriteTexRect.zw * corner, 0.0, 0.0);
+	VaryingColor = gammaCorrectColor(love_SpriteColor) * ConstantColor;
+	love_Position = ClipSpaceFromLocal * vec4(pos, 0.0, 1.0);
+}
+)";
+
 static const std::string defaultStandardPixel = R"(
 vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
 {
@@ -1798,12 +2200,57 @@ void effect()
 }
 )";
 
+// Indexed images store an index into a 1 pixel tall palette texture in the red
+// component of each pixel.
+static const std::string defaultPalettePixel = R"(
+uniform sampler2D love_PaletteTexture;
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	int index = int(Texel(tex, texcoord).r * 255.0 + 0.5);
+	return texelFetch(love_PaletteTexture, ivec2(index, 0), 0) * vcolor;
+}
+)";
+
+// Distance field glyphs have their edge at 0.5, and are antialiased across
+// about one screen pixel regardless of how much the text is scaled.
+static const std::string defaultSDFFontPixel = R"(
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	vec4 texel = Texel(tex, texcoord);
+	float dist = texel.a;
+	float width = max(fwidth(dist) * 0.5, 0.0001);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+	return vec4(texel.rgb, alpha) * vcolor;
+}
+)";
+
+// Circles, ellipses and rounded rectangles drawn by Graphics::drawSDFShape.
+// The texture coordinates are the position relative to a rounded box with unit
+// corner radius, and p is the half line width (negative when filled).
+static const std::string defaultSDFShapePixel = R"(
+void effect()
+{
+	vec2 q = VaryingTexCoord.xy;
+	float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - 1.0;
+	if (VaryingTexCoord.z >= 0.0)
+		dist = abs(dist) - VaryingTexCoord.z;
+	float alpha = clamp(0.5 - dist / max(fwidth(dist), 0.0001), 0.0, 1.0);
+	if (alpha <= 0.0)
+		discard;
+	love_PixelColor = vec4(VaryingColor.rgb, VaryingColor.a * alpha);
+}
+)";
+
 const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType stage)
 {
 	if (stage == SHADERSTAGE_VERTEX)
 	{
 		if (shader == STANDARD_POINTS)
 			return defaultPointsVertex;
+		else if (shader == STANDARD_INSTANCED_SPRITES)
+			return defaultInstancedSpritesVertex;
+		else if (shader == STANDARD_SKINNED)
+			return defaultSkinnedVertex;
 		else
 			return defaultVertex;
 	}
@@ -1816,6 +2263,11 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 		case STANDARD_VIDEO: return defaultVideoPixel;
 		case STANDARD_ARRAY: return defaultArrayPixel;
 		case STANDARD_POINTS: return defaultStandardPixel;
+		case STANDARD_INSTANCED_SPRITES: return defaultStandardPixel;
+		case STANDARD_SDF_FONT: return defaultSDFFontPixel;
+		case STANDARD_SDF_SHAPE: return defaultSDFShapePixel;
+		case STANDARD_PALETTE: return defaultPalettePixel;
+		case STANDARD_SKINNED: return defaultStandardPixel;
 		case STANDARD_MAX_ENUM: return nocode;
 	}
 
@@ -1836,6 +2288,8 @@ static StringMap<Shader::BuiltinUniform, Shader::BUILTIN_MAX_ENUM>::Entry builti
 	{ "love_VideoYChannel",    Shader::BUILTIN_TEXTURE_VIDEO_Y   },
 	{ "love_VideoCbChannel",   Shader::BUILTIN_TEXTURE_VIDEO_CB  },
 	{ "love_VideoCrChannel",   Shader::BUILTIN_TEXTURE_VIDEO_CR  },
+	{ "love_PaletteTexture",   Shader::BUILTIN_TEXTURE_PALETTE   },
+	{ "love_BoneTransforms",   Shader::BUILTIN_TEXELBUFFER_BONES },
 	{ "love_UniformsPerDraw",  Shader::BUILTIN_UNIFORMS_PER_DRAW },
 };
 
@@ -63,6 +63,8 @@ public:
 		BUILTIN_TEXTURE_VIDEO_Y,
 		BUILTIN_TEXTURE_VIDEO_CB,
 		BUILTIN_TEXTURE_VIDEO_CR,
+		BUILTIN_TEXTURE_PALETTE,
+		BUILTIN_TEXELBUFFER_BONES,
 		BUILTIN_UNIFORMS_PER_DRAW,
 		BUILTIN_MAX_ENUM
 	};
@@ -79,6 +81,7 @@ public:
 		UNIFORM_STORAGETEXTURE,
 		UNIFORM_TEXELBUFFER,
 		UNIFORM_STORAGEBUFFER,
+		UNIFORM_UNIFORMBUFFER,
 		UNIFORM_UNKNOWN,
 		UNIFORM_MAX_ENUM
 	};
@@ -89,6 +92,11 @@ public:
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
 		STANDARD_POINTS,
+		STANDARD_INSTANCED_SPRITES,
+		STANDARD_SDF_FONT,
+		STANDARD_SDF_SHAPE,
+		STANDARD_PALETTE,
+		STANDARD_SKINNED,
 		STANDARD_MAX_ENUM
 	};
 
@@ -119,6 +127,7 @@ public:
 	{
 		std::map<std::string, std::string> defines;
 		std::string debugName;
+		bool async = false;
 	};
 
 	struct SourceInfo
@@ -193,6 +202,9 @@ public:
 	// Pointer to currently active Shader.
 	static Shader *current;
 
+	// Bytes of uniform data uploaded to the GPU since the start of the frame.
+	static int64 frameUniformBytesUploaded;
+
 	// Pointer to the default Shader.
 	static Shader *standardShaders[STANDARD_MAX_ENUM];
 
@@ -204,6 +216,12 @@ public:
 	 **/
 	bool hasStage(ShaderStageType stage);
 
+	/**
+	 * Whether the vertex stage is the default one, i.e. vertex positions are
+	 * passed through without being moved.
+	 **/
+	bool hasDefaultVertexStage() const;
+
 	/**
 	 * Binds this Shader's program to be used when rendering.
 	 **/
@@ -236,8 +254,36 @@ public:
 	 **/
 	virtual std::string getWarnings() const = 0;
 
+	/**
+	 * Gets whether this Shader has finished compiling. Shaders created with
+	 * the async compile option are validated on a JobSystem worker, and the
+	 * backend may compile them in the background as well, so they may not be
+	 * ready right away.
+	 **/
+	virtual bool isReady();
+
+	/**
+	 * Blocks until this Shader has finished compiling. Errors from an
+	 * asynchronous compile are thrown here, and again by later calls.
+	 **/
+	void waitUntilReady();
+
 	const std::string &getDebugName() const { return debugName; }
 
+	/**
+	 * Gets a version of this Shader compiled with the given defines added to,
+	 * or replacing, the ones it was created with. Variants are cached by their
+	 * full set of defines, so requesting the same permutation again doesn't
+	 * compile anything.
+	 **/
+	Shader *getVariant(const std::map<std::string, std::string> &defines);
+
+	/**
+	 * Stores the source code this Shader was created from, for getVariant.
+	 * For internal use only.
+	 **/
+	void setVariantSource(const std::vector<std::string> &stagessource, bool compute);
+
 	virtual int getVertexAttributeIndex(const std::string &name) = 0;
 
 	const UniformInfo *getUniformInfo(const std::string &name) const;
@@ -248,6 +294,18 @@ public:
 	void sendTextures(const UniformInfo *info, Texture **textures, int count);
 	void sendBuffers(const UniformInfo *info, Buffer **buffers, int count);
 
+	/**
+	 * Binds the Buffers set via Graphics::setUniformBuffer to this Shader's
+	 * uniform blocks of the same names. Does nothing if they haven't changed
+	 * since the last call.
+	 **/
+	void updateSharedUniformBuffers();
+
+	/**
+	 * Marks the textures sent to this Shader as used, for texture residency.
+	 **/
+	void markTexturesUsed();
+
 	/**
 	 * Gets whether a uniform with the specified name exists and is actively
 	 * used in the shader.
@@ -259,6 +317,18 @@ public:
 	 **/
 	void setVideoTextures(Texture *ytexture, Texture *cbtexture, Texture *crtexture);
 
+	/**
+	 * Sets the colors looked up by love_PaletteTexture when drawing a Texture
+	 * with a palette. Flushes batched draws if the palette changes.
+	 **/
+	void setPaletteTexture(Texture *palette);
+
+	/**
+	 * Sets the texel buffer read by love_BoneTransforms when drawing a Mesh
+	 * with a bone Buffer.
+	 **/
+	void setBoneBuffer(Buffer *bones);
+
 	const UniformInfo *getMainTextureInfo() const;
 	void validateDrawState(PrimitiveType primtype, Texture *maintexture) const;
 
@@ -295,6 +365,7 @@ protected:
 
 		std::map<std::string, UniformInfo> texelBuffers;
 		std::map<std::string, UniformInfo> storageBuffers;
+		std::map<std::string, UniformInfo> uniformBuffers;
 		std::map<std::string, UniformInfo> sampledTextures;
 		std::map<std::string, UniformInfo> storageTextures;
 		std::map<std::string, UniformInfo> localUniforms;
@@ -312,6 +383,18 @@ protected:
 		bool usesPointSize;
 	};
 
+	struct AsyncValidation;
+
+	/**
+	 * Called by waitUntilReady once an async Shader has been validated and
+	 * its reflection info has been set up, to create the backend's objects.
+	 **/
+	virtual void finishCompiling() = 0;
+
+	// False while an async Shader is still being validated, or once compiling
+	// it has failed. Backends don't create their objects until it's true.
+	bool isValidated() const { return asyncValidation == nullptr && asyncError.empty(); }
+
 	std::string getShaderStageDebugName(ShaderStageType stage) const;
 
 	void handleUnknownUniformName(const char *name);
@@ -319,6 +402,10 @@ protected:
 	// std140 uniform buffer alignment-aware copy.
 	void copyToUniformBuffer(const UniformInfo *info, const void *src, void *dst, int count) const;
 
+	// Whether copyToUniformBuffer with the same arguments would leave dst
+	// unchanged, so redundant sends can skip flushing and uploading.
+	bool isUniformBufferDataEqual(const UniformInfo *info, const void *src, const void *dst, int count) const;
+
 	void sendTextures(const UniformInfo *info, Texture **textures, int count, bool internalupdate);
 	void sendBuffers(const UniformInfo *info, Buffer **buffers, int count, bool internalupdate);
 
@@ -327,6 +414,9 @@ protected:
 
 	void flushBatchedDraws() const;
 
+	void startAsyncValidation();
+	void setupReflectionState();
+
 	static std::string canonicaliizeUniformName(const std::string &name);
 	static bool validateInternal(StrongRef<ShaderStage> stages[], std::string& err, Reflection &reflection);
 	static DataBaseType getDataBaseType(PixelFormat format);
@@ -342,10 +432,21 @@ protected:
 	std::vector<Texture *> activeTextures;
 	std::vector<Buffer *> activeBuffers;
 
+	// Graphics::getUniformBuffersVersion at the last updateSharedUniformBuffers.
+	uint32 sharedUniformBuffersVersion;
+
 	std::string debugName;
 
 	std::string unsetVertexInputLocationsString;
 
+	CompileOptions compileOptions;
+	std::vector<std::string> variantSource;
+	bool variantSourceCompute;
+	std::map<std::string, StrongRef<Shader>> variants;
+
+	AsyncValidation *asyncValidation;
+	std::string asyncError;
+
 }; // Shader
 
 } // graphics
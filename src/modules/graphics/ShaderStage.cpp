@@ -21,6 +21,7 @@
 #include "ShaderStage.h"
 #include "common/Exception.h"
 #include "Graphics.h"
+#include "profiler/Profiler.h"
 
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
 #include "libraries/glslang/glslang/Public/ResourceLimits.h"
@@ -34,25 +35,54 @@ ShaderStage::ShaderStage(Graphics */*gfx*/, ShaderStageType stage, const std::st
 	: stageType(stage)
 	, source(glsl)
 	, cacheKey(cachekey)
+	, gles(gles)
 	, glslangValidationShader(nullptr)
 {
+	if (stage != SHADERSTAGE_VERTEX && stage != SHADERSTAGE_PIXEL && stage != SHADERSTAGE_COMPUTE)
+		throw love::Exception("Cannot compile shader stage: unknown stage type.");
+}
+
+ShaderStage::~ShaderStage()
+{
+	if (!cacheKey.empty())
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			gfx->cleanupCachedShaderStage(stageType, cacheKey);
+	}
+
+	delete glslangValidationShader;
+}
+
+glslang::TShader *ShaderStage::getGLSLangValidationShader(std::string &err)
+{
+	if (glslangValidationShader != nullptr)
+		return glslangValidationShader;
+
+	// Don't parse code we already know is invalid again.
+	if (!validationError.empty())
+	{
+		err = validationError;
+		return nullptr;
+	}
+
+	LOVE_PROFILE_ZONE("love.graphics.compileShaderStage");
+
 	EShLanguage glslangStage = EShLangCount;
-	if (stage == SHADERSTAGE_VERTEX)
+	if (stageType == SHADERSTAGE_VERTEX)
 		glslangStage = EShLangVertex;
-	else if (stage == SHADERSTAGE_PIXEL)
+	else if (stageType == SHADERSTAGE_PIXEL)
 		glslangStage = EShLangFragment;
-	else if (stage == SHADERSTAGE_COMPUTE)
+	else if (stageType == SHADERSTAGE_COMPUTE)
 		glslangStage = EShLangCompute;
-	else
-		throw love::Exception("Cannot compile shader stage: unknown stage type.");
 
 	auto glslangShader = new glslang::TShader(glslangStage);
 
 	int defaultversion = gles ? 300 : 330;
 	EProfile defaultprofile = gles ? EEsProfile : ECoreProfile;
 
-	const char *csrc = glsl.c_str();
-	int srclen = (int) glsl.length();
+	const char *csrc = source.c_str();
+	int srclen = (int) source.length();
 	glslangShader->setStringsWithLengths(&csrc, &srclen, 1);
 
 	bool forcedefault = false;
@@ -61,29 +91,19 @@ ShaderStage::ShaderStage(Graphics */*gfx*/, ShaderStageType stage, const std::st
 	if (!glslangShader->parse(GetResources(), defaultversion, defaultprofile, forcedefault, forwardcompat, (EShMessages)(EShMsgSuppressWarnings | EshMsgOverlappingLocations)))
 	{
 		const char *stagename = "unknown";
-		getConstant(stage, stagename);
+		getConstant(stageType, stagename);
 
-		std::string err = "Error validating " + std::string(stagename) + " shader:\n\n"
+		validationError = "Error validating " + std::string(stagename) + " shader:\n\n"
 			+ std::string(glslangShader->getInfoLog()) + "\n"
 			+ std::string(glslangShader->getInfoDebugLog());
 
 		delete glslangShader;
-		throw love::Exception("%s", err.c_str());
+		err = validationError;
+		return nullptr;
 	}
 
 	glslangValidationShader = glslangShader;
-}
-
-ShaderStage::~ShaderStage()
-{
-	if (!cacheKey.empty())
-	{
-		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
-		if (gfx != nullptr)
-			gfx->cleanupCachedShaderStage(stageType, cacheKey);
-	}
-
-	delete glslangValidationShader;
+	return glslangValidationShader;
 }
 
 bool ShaderStage::getConstant(const char *in, ShaderStageType &out)
@@ -23,6 +23,7 @@
 #include "common/Object.h"
 #include "common/StringMap.h"
 #include "Resource.h"
+#include "thread/threads.h"
 
 #include <stddef.h>
 #include <string>
@@ -68,7 +69,15 @@ public:
 	ShaderStageType getStageType() const { return stageType; }
 	const std::string &getSource() const { return source; }
 	const std::string &getWarnings() const { return warnings; }
-	glslang::TShader *getGLSLangValidationShader() const { return glslangValidationShader; }
+
+	/**
+	 * Parses the stage's code with glslang the first time it's called, so
+	 * it can be done by whichever thread validates the Shader. Returns null
+	 * and sets err if the code has errors. The caller must hold the
+	 * validation mutex, since stages can be shared between Shaders.
+	 **/
+	glslang::TShader *getGLSLangValidationShader(std::string &err);
+	love::thread::Mutex *getValidationMutex() const { return validationMutex; }
 
 	static bool getConstant(const char *in, ShaderStageType &out);
 	static bool getConstant(ShaderStageType in, const char *&out);
@@ -83,7 +92,10 @@ private:
 	ShaderStageType stageType;
 	std::string source;
 	std::string cacheKey;
+	bool gles;
 	glslang::TShader *glslangValidationShader;
+	std::string validationError;
+	love::thread::MutexRef validationMutex;
 
 	static StringMap<ShaderStageType, SHADERSTAGE_MAX_ENUM>::Entry stageNameEntries[];
 	static StringMap<ShaderStageType, SHADERSTAGE_MAX_ENUM> stageNames;
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SkylinePacker.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+SkylinePacker::SkylinePacker()
+	: width(0)
+	, height(0)
+{
+}
+
+void SkylinePacker::reset(int width, int height, int border)
+{
+	this->width = width;
+	this->height = height;
+
+	nodes.clear();
+	nodes.push_back({border, border, width - border});
+}
+
+bool SkylinePacker::pack(int w, int h, int &x, int &y)
+{
+	int bestindex = -1;
+	int bestbottom = std::numeric_limits<int>::max();
+	int bestwidth = std::numeric_limits<int>::max();
+
+	// Bottom-left heuristic: place the rect where its bottom edge is lowest,
+	// preferring narrower skyline segments to reduce wasted space.
+	for (int i = 0; i < (int) nodes.size(); i++)
+	{
+		int nodex = nodes[i].x;
+
+		// Nodes are sorted by x, so later ones can't fit either.
+		if (nodex + w > width)
+			break;
+
+		int nodey = 0;
+		int remaining = w;
+
+		for (int j = i; j < (int) nodes.size() && remaining > 0; j++)
+		{
+			nodey = std::max(nodey, nodes[j].y);
+			remaining -= nodes[j].width;
+		}
+
+		if (nodey + h > height)
+			continue;
+
+		if (nodey + h < bestbottom || (nodey + h == bestbottom && nodes[i].width < bestwidth))
+		{
+			bestindex = i;
+			bestbottom = nodey + h;
+			bestwidth = nodes[i].width;
+			x = nodex;
+			y = nodey;
+		}
+	}
+
+	if (bestindex < 0)
+		return false;
+
+	nodes.insert(nodes.begin() + bestindex, {x, y + h, w});
+
+	// Trim the nodes which are now covered by the new one.
+	for (int i = bestindex + 1; i < (int) nodes.size();)
+	{
+		int prevend = nodes[i - 1].x + nodes[i - 1].width;
+		if (nodes[i].x >= prevend)
+			break;
+
+		int shrink = prevend - nodes[i].x;
+		nodes[i].x += shrink;
+		nodes[i].width -= shrink;
+
+		if (nodes[i].width > 0)
+			break;
+
+		nodes.erase(nodes.begin() + i);
+	}
+
+	for (int i = 0; i + 1 < (int) nodes.size();)
+	{
+		if (nodes[i].y == nodes[i + 1].y)
+		{
+			nodes[i].width += nodes[i + 1].width;
+			nodes.erase(nodes.begin() + i + 1);
+		}
+		else
+			i++;
+	}
+
+	return true;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Packs rectangles into a fixed-size area, using the bottom-left skyline
+ * heuristic. Rectangle sizes passed to pack() should include any padding they
+ * need on the right and bottom.
+ **/
+class SkylinePacker
+{
+public:
+
+	SkylinePacker();
+
+	/**
+	 * Empties the packed area. The first rows and columns up to the given
+	 * border are left unused.
+	 **/
+	void reset(int width, int height, int border = 0);
+
+	bool pack(int w, int h, int &x, int &y);
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+private:
+
+	// A horizontal segment of the top edge of the packed area.
+	struct Node
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	std::vector<Node> nodes;
+
+	int width;
+	int height;
+
+}; // SkylinePacker
+
+} // graphics
+} // love
@@ -40,12 +40,13 @@ namespace graphics
 
 love::Type SpriteBatch::type("SpriteBatch", &Drawable::type);
 
-SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage)
+SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced)
 	: texture(texture)
 	, size(size)
 	, next(0)
 	, color(255, 255, 255, 255)
 	, colorf(1.0f, 1.0f, 1.0f, 1.0f)
+	, instanced(instanced)
 	, attributesID()
 	, array_buf(nullptr)
 	, vertex_data(nullptr)
@@ -60,13 +61,26 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 		throw love::Exception("A texture must be used when creating a SpriteBatch.");
 
 	if (texture->getTextureType() == TEXTURE_2D_ARRAY)
+	{
+		if (instanced)
+			throw love::Exception("Instanced SpriteBatches cannot use Array Textures.");
 		vertex_format = CommonFormat::XYf_STPf_RGBAub;
+	}
 	else
 		vertex_format = CommonFormat::XYf_STf_RGBAub;
 
 	vertex_stride = getFormatStride(vertex_format);
 
-	size_t vertex_size = vertex_stride * 4 * size;
+	if (instanced)
+		sprite_stride = sizeof(SpriteInstance);
+	else
+		sprite_stride = vertex_stride * 4;
+
+	// Separate uploads have some overhead, so nearby modified sprites are
+	// uploaded together with the unmodified ones between them.
+	modified_sprites = RangeSet(std::max(Buffer::FILL_MERGE_DISTANCE / sprite_stride, (size_t) 1));
+
+	size_t vertex_size = sprite_stride * size;
 
 	vertex_data = (uint8 *) malloc(vertex_size);
 	if (vertex_data == nullptr)
@@ -75,7 +89,12 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 	memset(vertex_data, 0, vertex_size);
 
 	Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, usage);
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+
+	std::vector<Buffer::DataDeclaration> decl;
+	if (instanced)
+		decl = getInstanceFormatDeclaration();
+	else
+		decl = Buffer::getCommonFormatDeclaration(vertex_format);
 
 	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
 }
@@ -106,19 +125,53 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
+	size_t offset = spriteindex * sprite_stride;
 
-	m.transformXY(verts, quadpositions, 4);
+	if (instanced)
+	{
+		// Quad vertices are the top-left, bottom-left, top-right and
+		// bottom-right corners, in that order.
+		Vector2 corners[3];
+		m.transformXY(corners, quadpositions, 3);
 
-	for (int i = 0; i < 4; i++)
+		auto inst = (SpriteInstance *) (vertex_data + offset);
+
+		inst->transform[0] = corners[2].x - corners[0].x;
+		inst->transform[1] = corners[2].y - corners[0].y;
+		inst->transform[2] = corners[1].x - corners[0].x;
+		inst->transform[3] = corners[1].y - corners[0].y;
+
+		inst->offset[0] = corners[0].x;
+		inst->offset[1] = corners[0].y;
+
+		inst->texRect[0] = quadtexcoords[0].x;
+		inst->texRect[1] = quadtexcoords[0].y;
+		inst->texRect[2] = quadtexcoords[2].x - quadtexcoords[0].x;
+		inst->texRect[3] = quadtexcoords[1].y - quadtexcoords[0].y;
+
+		inst->color = color;
+	}
+	else
 	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].color = color;
+		auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
+
+		// Transform the packed positions with the SIMD path, then write each
+		// vertex in a single pass.
+		Vector2 positions[4];
+		m.transformXY(positions, quadpositions, 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].x = positions[i].x;
+			verts[i].y = positions[i].y;
+			verts[i].s = quadtexcoords[i].x;
+			verts[i].t = quadtexcoords[i].y;
+			verts[i].color = color;
+		}
 	}
 
 	modified_sprites.encapsulate(spriteindex);
+	culler.invalidate(spriteindex);
 
 	// Increment counter.
 	if (index == -1)
@@ -151,13 +204,16 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
+	size_t offset = spriteindex * sprite_stride;
 	auto verts = (XYf_STPf_RGBAub *) (vertex_data + offset);
 
-	m.transformXY(verts, quadpositions, 4);
+	Vector2 positions[4];
+	m.transformXY(positions, quadpositions, 4);
 
 	for (int i = 0; i < 4; i++)
 	{
+		verts[i].x = positions[i].x;
+		verts[i].y = positions[i].y;
 		verts[i].s = quadtexcoords[i].x;
 		verts[i].t = quadtexcoords[i].y;
 		verts[i].p = (float) layer;
@@ -165,6 +221,7 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	}
 
 	modified_sprites.encapsulate(spriteindex);
+	culler.invalidate(spriteindex);
 
 	// Increment counter.
 	if (index == -1)
@@ -183,13 +240,17 @@ void SpriteBatch::flush()
 {
 	if (modified_sprites.isValid())
 	{
-		size_t offset = modified_sprites.getOffset() * vertex_stride * 4;
-		size_t size = modified_sprites.getSize() * vertex_stride * 4;
-
 		if (array_buf->getDataUsage() == BUFFERDATAUSAGE_STREAM)
 			array_buf->fill(0, array_buf->getSize(), vertex_data);
 		else
-			array_buf->fill(offset, size, vertex_data + offset);
+		{
+			for (const Range &r : modified_sprites.getRanges())
+			{
+				size_t offset = r.getOffset() * sprite_stride;
+				size_t size = r.getSize() * sprite_stride;
+				array_buf->fill(offset, size, vertex_data + offset);
+			}
+		}
 
 		modified_sprites.invalidate();
 	}
@@ -236,7 +297,7 @@ void SpriteBatch::setBufferSize(int newsize)
 	if (newsize == size)
 		return;
 
-	size_t vertex_size = vertex_stride * 4 * newsize;
+	size_t vertex_size = sprite_stride * newsize;
 
 	int new_next = std::min(next, newsize);
 
@@ -246,11 +307,16 @@ void SpriteBatch::setBufferSize(int newsize)
 
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	Buffer::Settings settings(array_buf->getUsageFlags(), array_buf->getDataUsage());
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+
+	std::vector<Buffer::DataDeclaration> decl;
+	if (instanced)
+		decl = getInstanceFormatDeclaration();
+	else
+		decl = Buffer::getCommonFormatDeclaration(vertex_format);
 
 	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
 
-	array_buf->fill(0, vertex_stride * 4 * new_next, new_vertex_data);
+	array_buf->fill(0, sprite_stride * new_next, new_vertex_data);
 
 	vertex_data = (uint8 *) new_vertex_data;
 
@@ -265,6 +331,21 @@ int SpriteBatch::getBufferSize() const
 	return size;
 }
 
+bool SpriteBatch::isInstanced() const
+{
+	return instanced;
+}
+
+std::vector<Buffer::DataDeclaration> SpriteBatch::getInstanceFormatDeclaration()
+{
+	return {
+		{ "love_SpriteTransform", DATAFORMAT_FLOAT_VEC4 },
+		{ "love_SpriteOffset", DATAFORMAT_FLOAT_VEC2 },
+		{ "love_SpriteTexRect", DATAFORMAT_FLOAT_VEC4 },
+		{ "love_SpriteColor", DATAFORMAT_UNORM8_VEC4 },
+	};
+}
+
 void SpriteBatch::attachAttribute(const std::string &name, Buffer *buffer, Mesh *mesh)
 {
 	if ((buffer->getUsageFlags() & BUFFERUSAGEFLAG_VERTEX) == 0)
@@ -273,8 +354,9 @@ void SpriteBatch::attachAttribute(const std::string &name, Buffer *buffer, Mesh
 	AttachedAttribute oldattrib = {};
 	AttachedAttribute newattrib = {};
 
-	if (buffer->getArrayLength() < (size_t) next * 4)
-		throw love::Exception("Buffer has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*4);
+	int vertsPerSprite = instanced ? 1 : 4;
+	if (buffer->getArrayLength() < (size_t) next * vertsPerSprite)
+		throw love::Exception("Buffer has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*vertsPerSprite);
 
 	auto it = attached_attributes.find(name);
 	if (it != attached_attributes.end())
@@ -322,13 +404,79 @@ bool SpriteBatch::getDrawRange(int &start, int &count) const
 	return true;
 }
 
-void SpriteBatch::updateVertexAttributes(Graphics *gfx)
+void SpriteBatch::setCullingEnabled(bool enable)
+{
+	culler.setEnabled(enable);
+}
+
+bool SpriteBatch::isCullingEnabled() const
+{
+	return culler.isEnabled();
+}
+
+void SpriteBatch::updateCullingBounds()
+{
+	culler.update(next, [&](int sprite, Vector2 corners[4])
+	{
+		const uint8 *data = vertex_data + sprite * sprite_stride;
+
+		if (instanced)
+		{
+			auto inst = (const SpriteInstance *) data;
+			Vector2 offset(inst->offset[0], inst->offset[1]);
+			Vector2 x(inst->transform[0], inst->transform[1]);
+			Vector2 y(inst->transform[2], inst->transform[3]);
+
+			corners[0] = offset;
+			corners[1] = offset + y;
+			corners[2] = offset + x;
+			corners[3] = offset + x + y;
+		}
+		else
+		{
+			// Both vertex formats start with the XY position.
+			for (int i = 0; i < 4; i++)
+			{
+				auto pos = (const float *) (data + i * vertex_stride);
+				corners[i] = Vector2(pos[0], pos[1]);
+			}
+		}
+	});
+}
+
+void SpriteBatch::updateVertexAttributes(Graphics *gfx, int firstinstance)
 {
 	VertexAttributes attributes;
 	BufferBindings &buffers = bufferBindings;
 
-	buffers.set(0, array_buf, 0);
-	attributes.setCommonFormat(vertex_format, 0);
+	AttributeStep step = instanced ? STEP_PER_INSTANCE : STEP_PER_VERTEX;
+
+	if (instanced)
+	{
+		// Not all backends support a base instance, so the start of the draw
+		// range is applied as an offset into each per-instance buffer.
+		buffers.set(0, array_buf, firstinstance * sprite_stride);
+
+		for (const auto &member : array_buf->getDataMembers())
+		{
+			int bindingindex = -1;
+			if (Shader::current)
+				bindingindex = Shader::current->getVertexAttributeIndex(member.decl.name);
+
+			if (bindingindex >= 0)
+				attributes.set(bindingindex, member.decl.format, (uint16) member.offset, 0);
+		}
+
+		if (attributes.enableBits == 0)
+			throw love::Exception("The active Shader does not use any of the per-sprite attributes of instanced SpriteBatches.");
+
+		attributes.setBufferLayout(0, (uint16) sprite_stride, step);
+	}
+	else
+	{
+		buffers.set(0, array_buf, 0);
+		attributes.setCommonFormat(vertex_format, 0);
+	}
 
 	int activebuffers = 1;
 
@@ -362,9 +510,9 @@ void SpriteBatch::updateVertexAttributes(Graphics *gfx)
 			}
 
 			attributes.set(bindingindex, member.decl.format, offset, bufferindex);
-			attributes.setBufferLayout(bufferindex, stride);
+			attributes.setBufferLayout(bufferindex, stride, step);
 
-			buffers.set(bufferindex, buffer, 0);
+			buffers.set(bufferindex, buffer, instanced ? firstinstance * stride : 0);
 
 			activebuffers = std::max(activebuffers, bufferindex + 1);
 		}
@@ -378,14 +526,19 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 	if (next == 0)
 		return;
 
-	gfx->flushBatchedDraws();
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("SpriteBatches cannot be recorded into a DrawList.");
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
 
 	if (texture.get())
 	{
 		if (Shader::isDefaultActive())
 		{
 			Shader::StandardShader defaultshader = Shader::STANDARD_DEFAULT;
-			if (texture->getTextureType() == TEXTURE_2D_ARRAY)
+			if (instanced)
+				defaultshader = Shader::STANDARD_INSTANCED_SPRITES;
+			else if (texture->getTextureType() == TEXTURE_2D_ARRAY)
 				defaultshader = Shader::STANDARD_ARRAY;
 
 			Shader::attachDefault(defaultshader);
@@ -405,7 +558,7 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 		// We have to do this check here as wll because setBufferSize can be
 		// called after attachAttribute.
-		if (buffer->getArrayLength() < (size_t) next * 4)
+		if (buffer->getArrayLength() < (size_t) next * (instanced ? 1 : 4))
 			throw love::Exception("Buffer with attribute '%s' attached to this SpriteBatch has too few vertices", it.first.c_str());
 
 		// If the attribute is one of the LOVE-defined ones, use the constant
@@ -417,11 +570,6 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 			it.second.mesh->flush();
 	}
 
-	if (attributesIDneedsupdate)
-		updateVertexAttributes(gfx);
-
-	Graphics::TempTransform transform(gfx, m);
-
 	int start = std::min(std::max(0, range_start), next - 1);
 
 	int count = next;
@@ -430,10 +578,42 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 	count = std::min(count, next - start);
 
-	if (count > 0)
+	draw_ranges.clear();
+
+	if (count > 0 && culler.isEnabled())
+	{
+		updateCullingBounds();
+		if (!culler.getVisibleRanges(gfx, m, start, count, draw_ranges))
+			draw_ranges.push_back(Range(start, count));
+	}
+	else if (count > 0)
+		draw_ranges.push_back(Range(start, count));
+
+	if (attributesIDneedsupdate && !instanced)
+		updateVertexAttributes(gfx, 0);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
+
+	for (const Range &r : draw_ranges)
 	{
-		Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
-		gfx->drawQuads(start, count, attributesID, bufferBindings, tex);
+		if (instanced)
+		{
+			// Attribute locations for the per-sprite data come from the active
+			// shader, and the range start is baked into the buffer offsets.
+			updateVertexAttributes(gfx, (int) r.getOffset());
+
+			Graphics::DrawCommand cmd(attributesID, &bufferBindings);
+			cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+			cmd.vertexCount = 4;
+			cmd.instanceCount = (int) r.getSize();
+			cmd.texture = tex;
+
+			gfx->draw(cmd);
+		}
+		else
+			gfx->drawQuads((int) r.getOffset(), (int) r.getSize(), attributesID, bufferBindings, tex);
 	}
 }
 
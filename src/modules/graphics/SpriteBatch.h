@@ -33,6 +33,8 @@
 #include "common/Range.h"
 #include "Drawable.h"
 #include "Mesh.h"
+#include "Buffer.h"
+#include "QuadCuller.h"
 #include "vertex.h"
 
 namespace love
@@ -44,7 +46,6 @@ namespace graphics
 class Graphics;
 class Texture;
 class Quad;
-class Buffer;
 
 class SpriteBatch : public Drawable
 {
@@ -52,7 +53,7 @@ public:
 
 	static love::Type type;
 
-	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage);
+	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced);
 	virtual ~SpriteBatch();
 
 	int add(const Matrix4 &m, int index = -1);
@@ -90,6 +91,12 @@ public:
 	 **/
 	int getBufferSize() const;
 
+	/**
+	 * Gets whether each sprite is stored as a single per-instance record that
+	 * is expanded into a quad on the GPU, rather than as 4 vertices.
+	 **/
+	bool isInstanced() const;
+
 	/**
 	 * Attaches a specific vertex attribute from a Buffer to this SpriteBatch.
 	 * The vertex attribute will be used when drawing the SpriteBatch.
@@ -103,12 +110,34 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * When enabled, sprites are grouped into chunks with their own bounds, and
+	 * chunks outside the visible area are skipped when the SpriteBatch is
+	 * drawn with a 2D transform.
+	 **/
+	void setCullingEnabled(bool enable);
+	bool isCullingEnabled() const;
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
 private:
 
-	void updateVertexAttributes(Graphics *gfx);
+	// Per-sprite data used by instanced SpriteBatches. The shader reconstructs
+	// the quad's corners from love_VertexID.
+	struct SpriteInstance
+	{
+		// The 2x2 part of the sprite's transform, scaled by the quad's size.
+		float transform[4];
+		float offset[2];
+		float texRect[4];
+		Color32 color;
+	};
+
+	static std::vector<Buffer::DataDeclaration> getInstanceFormatDeclaration();
+
+	void updateVertexAttributes(Graphics *gfx, int firstinstance);
+	void updateCullingBounds();
 
 	struct AttachedAttribute
 	{
@@ -139,18 +168,29 @@ private:
 	CommonFormat vertex_format;
 	size_t vertex_stride;
 
+	bool instanced;
+
+	// Size in bytes of each sprite's data (4 vertices, or 1 instance).
+	size_t sprite_stride;
+
 	VertexAttributesID attributesID;
 	BufferBindings bufferBindings;
 
 	StrongRef<love::graphics::Buffer> array_buf;
 	uint8 *vertex_data;
 
-	Range modified_sprites;
+	// Sprites which need to be uploaded to the GPU on the next flush.
+	RangeSet modified_sprites;
 
 	std::unordered_map<std::string, AttachedAttribute> attached_attributes;
 	
 	int range_start;
 	int range_count;
+
+	QuadCuller culler;
+
+	// Sprite ranges to draw, reused between draws.
+	std::vector<Range> draw_ranges;
 	
 }; // SpriteBatch
 
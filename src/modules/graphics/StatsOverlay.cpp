@@ -0,0 +1,201 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+// LOVE
+#include "StatsOverlay.h"
+#include "Graphics.h"
+#include "Font.h"
+#include "timer/Timer.h"
+
+// C++
+#include <algorithm>
+#include <cstdio>
+
+namespace love
+{
+namespace graphics
+{
+
+const char *StatsOverlay::GPU_TIMER_NAME = "frame";
+
+// Frame times at or above this fill the whole graph.
+static const double GRAPH_MAX_TIME = 1.0 / 30.0;
+
+static const float MARGIN = 8.0f;
+static const float PADDING = 4.0f;
+static const float WIDTH = 240.0f;
+static const float GRAPH_HEIGHT = 48.0f;
+
+static const Colorf BACKGROUND_COLOR(0.0f, 0.0f, 0.0f, 0.7f);
+static const Colorf TEXT_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+static const Colorf FRAME_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+static const Colorf CPU_COLOR(0.4f, 0.8f, 1.0f, 1.0f);
+static const Colorf GPU_COLOR(1.0f, 0.6f, 0.2f, 1.0f);
+
+StatsOverlay::StatsOverlay()
+	: samples()
+	, sampleCount(0)
+	, nextSample(0)
+	, lastTime(-1.0)
+{
+}
+
+StatsOverlay::~StatsOverlay()
+{
+}
+
+void StatsOverlay::clear()
+{
+	sampleCount = 0;
+	nextSample = 0;
+	lastTime = -1.0;
+}
+
+void StatsOverlay::draw(Graphics *gfx, double cputime, const std::vector<std::string> &lines)
+{
+	double now = love::timer::Timer::getTime();
+
+	Sample sample;
+	sample.frameTime = lastTime >= 0.0 ? now - lastTime : -1.0;
+	sample.cpuTime = cputime;
+	sample.gpuTime = -1.0;
+
+	lastTime = now;
+
+	for (const auto &timing : gfx->getGPUTimings())
+	{
+		if (timing.name == GPU_TIMER_NAME)
+		{
+			sample.gpuTime = timing.time;
+			break;
+		}
+	}
+
+	samples[nextSample] = sample;
+	nextSample = (nextSample + 1) % MAX_SAMPLES;
+	sampleCount = std::min(sampleCount + 1, MAX_SAMPLES);
+
+	// Read before drawing the overlay, so it doesn't count itself.
+	Graphics::Stats stats = gfx->getStats();
+
+	char buf[128];
+	std::vector<std::string> text;
+
+	if (sample.frameTime > 0.0)
+		snprintf(buf, sizeof(buf), "%.2f ms (%.0f fps)", sample.frameTime * 1000.0, 1.0 / sample.frameTime);
+	else
+		snprintf(buf, sizeof(buf), "- ms");
+	text.push_back(buf);
+
+	std::string cpu = "-";
+	std::string gpu = "-";
+	if (sample.cpuTime >= 0.0)
+	{
+		snprintf(buf, sizeof(buf), "%.2f ms", sample.cpuTime * 1000.0);
+		cpu = buf;
+	}
+	if (sample.gpuTime >= 0.0)
+	{
+		snprintf(buf, sizeof(buf), "%.2f ms", sample.gpuTime * 1000.0);
+		gpu = buf;
+	}
+	text.push_back("cpu " + cpu + "  gpu " + gpu);
+
+	snprintf(buf, sizeof(buf), "draws %d (%d batched)", stats.drawCalls, stats.drawCallsBatched);
+	text.push_back(buf);
+
+	snprintf(buf, sizeof(buf), "canvas switches %d  shader switches %d", stats.renderTargetSwitches, stats.shaderSwitches);
+	text.push_back(buf);
+
+	snprintf(buf, sizeof(buf), "textures %.1f MB  buffers %.1f MB", stats.textureMemory / (1024.0 * 1024.0), stats.bufferMemory / (1024.0 * 1024.0));
+	text.push_back(buf);
+
+	text.insert(text.end(), lines.begin(), lines.end());
+
+	gfx->push(Graphics::STACK_ALL);
+
+	try
+	{
+		gfx->reset();
+
+		Font *font = gfx->getFont();
+		float lineheight = font->getHeight();
+		float height = PADDING * 3.0f + GRAPH_HEIGHT + lineheight * text.size();
+
+		gfx->setColor(BACKGROUND_COLOR);
+		gfx->rectangle(Graphics::DRAW_FILL, MARGIN, MARGIN, WIDTH, height);
+
+		float graphx = MARGIN + PADDING;
+		float graphy = MARGIN + PADDING;
+		float graphw = WIDTH - PADDING * 2.0f;
+
+		std::vector<Vector2> points;
+		points.reserve(MAX_SAMPLES);
+
+		auto drawgraph = [&](double Sample::*member, const Colorf &color)
+		{
+			points.clear();
+
+			for (int i = 0; i < sampleCount; i++)
+			{
+				// Oldest sample first.
+				int index = (nextSample - sampleCount + i + MAX_SAMPLES) % MAX_SAMPLES;
+				double t = samples[index].*member;
+				if (t < 0.0)
+					continue;
+
+				float x = graphx + graphw * (float) i / (float) (MAX_SAMPLES - 1);
+				float y = graphy + GRAPH_HEIGHT * (1.0f - (float) std::min(t / GRAPH_MAX_TIME, 1.0));
+				points.emplace_back(x, y);
+			}
+
+			if (points.size() >= 2)
+			{
+				gfx->setColor(color);
+				gfx->polyline(points.data(), points.size());
+			}
+		};
+
+		drawgraph(&Sample::gpuTime, GPU_COLOR);
+		drawgraph(&Sample::cpuTime, CPU_COLOR);
+		drawgraph(&Sample::frameTime, FRAME_COLOR);
+
+		gfx->setColor(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+
+		float texty = graphy + GRAPH_HEIGHT + PADDING;
+		for (const std::string &str : text)
+		{
+			std::vector<love::font::ColoredString> coloredstr = {{str, TEXT_COLOR}};
+			gfx->print(coloredstr, Matrix4(graphx, texty, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+			texty += lineheight;
+		}
+	}
+	catch (...)
+	{
+		gfx->pop();
+		throw;
+	}
+
+	gfx->pop();
+}
+
+} // graphics
+} // love
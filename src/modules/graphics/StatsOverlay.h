@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// C++
+#include <vector>
+#include <string>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Draws frame, CPU and GPU times as graphs along with the renderer's stats
+ * in the top-left corner of the screen. Frame times are measured between
+ * draw calls; the GPU time comes from the GPU timer scope named
+ * GPU_TIMER_NAME, when the caller pushes one around the frame (love.run does).
+ **/
+class StatsOverlay
+{
+public:
+
+	// "frame"
+	static const char *GPU_TIMER_NAME;
+
+	StatsOverlay();
+	~StatsOverlay();
+
+	/**
+	 * Records this frame's times and draws the overlay over whatever is on
+	 * the active render target. cputime is the time the caller spent on the
+	 * frame, or negative if it's unknown. Each of lines is printed below the
+	 * built-in stats.
+	 **/
+	void draw(Graphics *gfx, double cputime, const std::vector<std::string> &lines);
+
+	/**
+	 * Forgets all recorded times, so the next frame time isn't measured from
+	 * the last time the overlay was visible.
+	 **/
+	void clear();
+
+private:
+
+	struct Sample
+	{
+		double frameTime;
+		double cpuTime;
+		double gpuTime;
+	};
+
+	static const int MAX_SAMPLES = 120;
+
+	Sample samples[MAX_SAMPLES];
+	int sampleCount;
+	int nextSample;
+
+	double lastTime;
+
+}; // StatsOverlay
+
+} // graphics
+} // love
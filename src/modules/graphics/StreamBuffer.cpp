@@ -26,6 +26,8 @@ namespace love
 namespace graphics
 {
 
+double StreamBuffer::frameStallTime = 0.0;
+
 StreamBuffer::StreamBuffer(BufferUsage mode, size_t size)
 	: bufferSize(size)
 	, frameGPUReadOffset(0)
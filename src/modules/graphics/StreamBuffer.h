@@ -51,11 +51,16 @@ public:
 		{}
 	};
 
+	// Time in seconds spent waiting for the GPU to release previously used
+	// sections of stream buffers, since the last present.
+	static double frameStallTime;
+
 	virtual ~StreamBuffer() {}
 
 	size_t getSize() const { return bufferSize; }
 	BufferUsage getMode() const { return mode; }
 	size_t getUsableSize() const { return bufferSize - frameGPUReadOffset; }
+	size_t getFrameUsedSize() const { return frameGPUReadOffset; }
 
 	virtual size_t getGPUReadOffset() const = 0;
 
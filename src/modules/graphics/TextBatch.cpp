@@ -37,6 +37,13 @@ TextBatch::TextBatch(Font *font, const std::vector<love::font::ColoredString> &t
 	, modifiedVertices()
 	, vertOffset(0)
 	, textureCacheID(font->getTextureCacheID())
+	, prewarmEnabled(false)
+	, verticesPending(false)
+	, drawCommandsDirty(false)
+	, regenerateAll(false)
+	, unusedVertices(0)
+	, maxEntries(0)
+	, nextRingEntry(0)
 {
 	set(text);
 }
@@ -82,12 +89,17 @@ void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, s
 		vertexBuffer = newbuffer;
 
 		vertexBuffers.set(0, vertexBuffer, 0);
+
+		// The new buffer doesn't have any of the existing vertices yet.
+		if (vertOffset > 0)
+			modifiedVertices.encapsulate(0, std::min(vertOffset * sizeof(Font::GlyphVertex), offset + datasize));
 	}
 
 	if (vertexData != nullptr && datasize > 0)
 	{
 		memcpy(vertexData + offset, &vertices[0], datasize);
 		modifiedVertices.encapsulate(offset, datasize);
+		culler.invalidate((int) (vertoffset / 4), (int) (vertices.size() / 4));
 	}
 }
 
@@ -95,82 +107,231 @@ void TextBatch::regenerateVertices()
 {
 	// If the font's texture cache was invalidated then we need to recreate the
 	// text's vertices, since glyph texcoords might have changed.
-	if (font->getTextureCacheID() != textureCacheID)
+	if (font->getTextureCacheID() != textureCacheID || regenerateAll)
 	{
 		std::vector<TextData> textdata = textData;
+		int nextringentry = nextRingEntry;
 
 		clear();
 
 		for (const TextData &t : textdata)
-			addTextData(t);
+			addTextData(t, -1, false);
 
+		nextRingEntry = nextringentry;
 		textureCacheID = font->getTextureCacheID();
+		regenerateAll = false;
 	}
 }
 
-void TextBatch::addTextData(const TextData &t)
+void TextBatch::updatePendingVertices()
+{
+	if (!verticesPending)
+		return;
+
+	verticesPending = false;
+
+	// Any glyphs which are still being prewarmed are rasterized immediately.
+	textureCacheID = (uint32) -1;
+	regenerateVertices();
+}
+
+int TextBatch::addTextData(const TextData &t, int index, bool prewarm)
+{
+	if (index < -1 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	if (!t.appendVertices)
+	{
+		clear();
+		index = -1;
+	}
+
+	// Replace the oldest entry in place once the ring is full.
+	if (index == -1 && maxEntries > 0 && (int) textData.size() >= maxEntries)
+	{
+		index = nextRingEntry;
+		nextRingEntry = (nextRingEntry + 1) % maxEntries;
+	}
+
+	if (index == -1)
+	{
+		index = (int) textData.size();
+		textData.push_back(t);
+		textData.back().vertexStart = vertOffset;
+		textData.back().vertexCapacity = 0;
+	}
+	else
+	{
+		// Keep the vertex range reserved for the entry, so the new text can
+		// reuse it when it fits.
+		TextData &existing = textData[index];
+		size_t vertexstart = existing.vertexStart;
+		size_t vertexcapacity = existing.vertexCapacity;
+
+		existing = t;
+		existing.appendVertices = true;
+		existing.vertexStart = vertexstart;
+		existing.vertexCapacity = vertexcapacity;
+	}
+
+	textData[index].textInfo = {};
+	textData[index].drawCommands.clear();
+	drawCommandsDirty = true;
+
+	// Earlier text may also be waiting for its vertices, so the new text must
+	// wait as well to keep everything in order.
+	if (verticesPending || (prewarm && font->prewarm(t.codepoints.cps, true)))
+	{
+		verticesPending = true;
+		return index;
+	}
+
+	updateTextVertices(index);
+	return index;
+}
+
+void TextBatch::updateTextVertices(int index)
 {
 	std::vector<Font::GlyphVertex> vertices;
 	std::vector<Font::DrawCommand> newcommands;
 
-	love::font::TextShaper::TextInfo textinfo;
+	love::font::TextShaper::TextInfo textinfo = {};
 
 	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
 
-	// We only have formatted text if the align mode is valid.
-	if (t.align == Font::ALIGN_MAX_ENUM)
-		newcommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo);
-	else
-		newcommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo);
-
-	size_t voffset = vertOffset;
+	const TextData &t = textData[index];
 
-	if (!t.appendVertices)
+	if (!t.codepoints.cps.empty())
 	{
-		voffset = 0;
-		vertOffset = 0;
-		drawCommands.clear();
-		textData.clear();
+		// We only have formatted text if the align mode is valid.
+		if (t.align == Font::ALIGN_MAX_ENUM)
+			newcommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo);
+		else
+			newcommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo);
 	}
 
+	// Font::generateVertices can invalidate the font's texture cache, in which
+	// case all text (including this one) needs new vertices.
+	if (font->getTextureCacheID() != textureCacheID)
+		return regenerateVertices();
+
 	if (t.useMatrix && !vertices.empty())
 		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
 
-	uploadVertices(vertices, voffset);
+	TextData &data = textData[index];
 
-	if (!newcommands.empty())
+	if (vertices.size() > data.vertexCapacity)
 	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : newcommands)
-			cmd.startvertex += (int) voffset;
+		// The text doesn't fit in its old range anymore, so it's moved to the
+		// end of the buffer unless it's already there.
+		if (data.vertexStart + data.vertexCapacity != vertOffset)
+		{
+			unusedVertices += data.vertexCapacity;
+			data.vertexStart = vertOffset;
+		}
+
+		data.vertexCapacity = vertices.size();
+		vertOffset = data.vertexStart + data.vertexCapacity;
+	}
 
-		auto firstcmd = newcommands.begin();
+	uploadVertices(vertices, data.vertexStart);
 
-		// If the first draw command in the new list has the same texture as the
-		// last one in the existing list we're building and its vertices are
-		// in-order, we can combine them (saving a draw call.)
-		if (!drawCommands.empty())
+	// The start vertex should be adjusted to account for the vertex offset.
+	for (Font::DrawCommand &cmd : newcommands)
+		cmd.startvertex += (int) data.vertexStart;
+
+	data.drawCommands = std::move(newcommands);
+	data.textInfo = textinfo;
+	drawCommandsDirty = true;
+
+	if (unusedVertices > vertOffset / 2)
+		compactVertices();
+}
+
+void TextBatch::compactVertices()
+{
+	std::vector<TextData *> sorted;
+	sorted.reserve(textData.size());
+
+	for (TextData &t : textData)
+		sorted.push_back(&t);
+
+	std::sort(sorted.begin(), sorted.end(), [](const TextData *a, const TextData *b)
+	{
+		return a->vertexStart < b->vertexStart;
+	});
+
+	size_t offset = 0;
+
+	for (TextData *t : sorted)
+	{
+		size_t vertexcount = 0;
+		for (const Font::DrawCommand &cmd : t->drawCommands)
+			vertexcount = std::max(vertexcount, (size_t) (cmd.startvertex + cmd.vertexcount) - t->vertexStart);
+
+		// Ranges only ever move towards the start of the buffer here.
+		if (vertexcount > 0 && t->vertexStart != offset)
 		{
-			auto prevcmd = drawCommands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
-			{
-				drawCommands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
-			}
+			size_t stride = sizeof(Font::GlyphVertex);
+			memmove(vertexData + offset * stride, vertexData + t->vertexStart * stride, vertexcount * stride);
 		}
 
-		// Append the new draw commands to the list we're building.
-		drawCommands.insert(drawCommands.end(), firstcmd, newcommands.end());
+		for (Font::DrawCommand &cmd : t->drawCommands)
+			cmd.startvertex = cmd.startvertex - (int) t->vertexStart + (int) offset;
+
+		t->vertexStart = offset;
+		t->vertexCapacity = vertexcount;
+		offset += vertexcount;
+	}
+
+	vertOffset = offset;
+	unusedVertices = 0;
+	drawCommandsDirty = true;
+
+	if (offset > 0)
+	{
+		modifiedVertices.encapsulate(0, offset * sizeof(Font::GlyphVertex));
+		culler.invalidate(0, (int) (offset / 4));
 	}
+}
 
-	vertOffset = voffset + vertices.size();
+void TextBatch::updateDrawCommands()
+{
+	if (!drawCommandsDirty)
+		return;
 
-	textData.push_back(t);
-	textData.back().textInfo = textinfo;
+	drawCommandsDirty = false;
+	drawCommands.clear();
 
-	// Font::generateVertices can invalidate the font's texture cache.
-	if (font->getTextureCacheID() != textureCacheID)
-		regenerateVertices();
+	for (const TextData &t : textData)
+		drawCommands.insert(drawCommands.end(), t.drawCommands.begin(), t.drawCommands.end());
+
+	std::sort(drawCommands.begin(), drawCommands.end(), [](const Font::DrawCommand &a, const Font::DrawCommand &b)
+	{
+		return a.startvertex < b.startvertex;
+	});
+
+	// If a draw command has the same texture as the previous one and its
+	// vertices are in-order, we can combine them (saving a draw call.)
+	size_t count = 0;
+	for (size_t i = 0; i < drawCommands.size(); i++)
+	{
+		const Font::DrawCommand &cmd = drawCommands[i];
+
+		if (count > 0)
+		{
+			Font::DrawCommand &prevcmd = drawCommands[count - 1];
+			if (prevcmd.texture == cmd.texture && (prevcmd.startvertex + prevcmd.vertexcount) == cmd.startvertex)
+			{
+				prevcmd.vertexcount += cmd.vertexcount;
+				continue;
+			}
+		}
+
+		drawCommands[count++] = cmd;
+	}
+
+	drawCommands.resize(count);
 }
 
 void TextBatch::set(const std::vector<love::font::ColoredString> &text)
@@ -186,22 +347,33 @@ void TextBatch::set(const std::vector<love::font::ColoredString> &text, float wr
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
-	addTextData({codepoints, wrap, align, {}, false, false, Matrix4()});
+	addTextData({codepoints, wrap, align, {}, false, false, Matrix4(), 0, 0, {}}, -1, prewarmEnabled);
 }
 
-int TextBatch::add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m)
+int TextBatch::add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m, int index)
 {
-	return addf(text, -1.0f, Font::ALIGN_MAX_ENUM, m);
+	return addf(text, -1.0f, Font::ALIGN_MAX_ENUM, m, index);
 }
 
-int TextBatch::addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m)
+int TextBatch::addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m, int index)
 {
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
-	addTextData({codepoints, wrap, align, {}, true, true, m});
+	return addTextData({codepoints, wrap, align, {}, true, true, m, 0, 0, {}}, index, prewarmEnabled);
+}
 
-	return (int) textData.size() - 1;
+void TextBatch::remove(int index)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	// The entry keeps its vertex range, so replacing it later can reuse it.
+	TextData &t = textData[index];
+	t.codepoints = love::font::ColoredCodepoints();
+	t.textInfo = {};
+	t.drawCommands.clear();
+	drawCommandsDirty = true;
 }
 
 void TextBatch::clear()
@@ -210,6 +382,29 @@ void TextBatch::clear()
 	drawCommands.clear();
 	textureCacheID = font->getTextureCacheID();
 	vertOffset = 0;
+	verticesPending = false;
+	drawCommandsDirty = false;
+	unusedVertices = 0;
+	nextRingEntry = 0;
+}
+
+void TextBatch::setMaxEntries(int max)
+{
+	maxEntries = std::max(max, 0);
+	nextRingEntry = 0;
+
+	if (maxEntries > 0 && (int) textData.size() > maxEntries)
+	{
+		textData.erase(textData.begin() + maxEntries, textData.end());
+
+		regenerateAll = true;
+		regenerateVertices();
+	}
+}
+
+int TextBatch::getMaxEntries() const
+{
+	return maxEntries;
 }
 
 void TextBatch::setFont(Font *f)
@@ -228,8 +423,30 @@ Font *TextBatch::getFont() const
 	return font.get();
 }
 
-int TextBatch::getWidth(int index) const
+void TextBatch::setCullingEnabled(bool enable)
+{
+	culler.setEnabled(enable);
+}
+
+bool TextBatch::isCullingEnabled() const
+{
+	return culler.isEnabled();
+}
+
+void TextBatch::setPrewarmEnabled(bool enable)
+{
+	prewarmEnabled = enable;
+}
+
+bool TextBatch::isPrewarmEnabled() const
+{
+	return prewarmEnabled;
+}
+
+int TextBatch::getWidth(int index)
 {
+	updatePendingVertices();
+
 	if (index < 0)
 		index = std::max((int) textData.size() - 1, 0);
 
@@ -239,8 +456,10 @@ int TextBatch::getWidth(int index) const
 	return textData[index].textInfo.width;
 }
 
-int TextBatch::getHeight(int index) const
+int TextBatch::getHeight(int index)
 {
+	updatePendingVertices();
+
 	if (index < 0)
 		index = std::max((int) textData.size() - 1, 0);
 
@@ -252,17 +471,26 @@ int TextBatch::getHeight(int index) const
 
 void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 {
+	updatePendingVertices();
+	updateDrawCommands();
+
 	if (vertexBuffer == nullptr || vertexData == nullptr || drawCommands.empty())
 		return;
 
-	gfx->flushBatchedDraws();
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("TextBatches cannot be recorded into a DrawList.");
+
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
 
 	// Re-generate the text if the Font's texture cache was invalidated.
 	if (font->getTextureCacheID() != textureCacheID)
+	{
 		regenerateVertices();
+		updateDrawCommands();
+	}
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->getStandardShader());
 
 	Texture *firsttex = nullptr;
 	if (!drawCommands.empty())
@@ -289,12 +517,30 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 		modifiedVertices.invalidate();
 	}
 
+	if (culler.isEnabled())
+	{
+		culler.update(totalverts / 4, [&](int quad, Vector2 corners[4])
+		{
+			auto verts = (const Font::GlyphVertex *) vertexData + quad * 4;
+			for (int i = 0; i < 4; i++)
+				corners[i] = Vector2(verts[i].x, verts[i].y);
+		});
+	}
+
 	Graphics::TempTransform transform(gfx, m);
 
 	for (const Font::DrawCommand &cmd : drawCommands)
 	{
 		Texture *tex = gfx->getTextureOrDefaultForActiveShader(cmd.texture);
-		gfx->drawQuads(cmd.startvertex / 4, cmd.vertexcount / 4, vertexAttributesID, vertexBuffers, tex);
+
+		// The transform stack already includes m at this point.
+		if (culler.isEnabled() && culler.getVisibleRanges(gfx, Matrix4(), cmd.startvertex / 4, cmd.vertexcount / 4, drawRanges))
+		{
+			for (const Range &r : drawRanges)
+				gfx->drawQuads((int) r.getOffset(), (int) r.getSize(), vertexAttributesID, vertexBuffers, tex);
+		}
+		else
+			gfx->drawQuads(cmd.startvertex / 4, cmd.vertexcount / 4, vertexAttributesID, vertexBuffers, tex);
 	}
 }
 
@@ -26,6 +26,7 @@
 #include "Drawable.h"
 #include "Font.h"
 #include "Buffer.h"
+#include "QuadCuller.h"
 
 namespace love
 {
@@ -46,23 +47,57 @@ public:
 	void set(const std::vector<love::font::ColoredString> &text);
 	void set(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align);
 
-	int add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
-	int addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
+	/**
+	 * Adds text to the batch, or replaces the text at the given index when it
+	 * isn't -1. Only the vertices of the affected entry are regenerated.
+	 **/
+	int add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m, int index = -1);
+	int addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m, int index = -1);
+
+	/**
+	 * Removes the text at the given index. The indices of other entries don't
+	 * change, and a later add can reuse the removed entry.
+	 **/
+	void remove(int index);
 
 	void clear();
 
+	/**
+	 * When greater than 0, adding text once the batch has this many entries
+	 * replaces the oldest entry in place instead of growing the batch, which
+	 * is useful for scrolling logs.
+	 **/
+	void setMaxEntries(int max);
+	int getMaxEntries() const;
+
 	void setFont(Font *f);
 	Font *getFont() const;
 
 	/**
 	 * Gets the width of the currently set text.
 	 **/
-	int getWidth(int index = 0) const;
+	int getWidth(int index = 0);
 
 	/**
 	 * Gets the height of the currently set text.
 	 **/
-	int getHeight(int index = 0) const;
+	int getHeight(int index = 0);
+
+	/**
+	 * When enabled, glyphs are grouped into chunks with their own bounds, and
+	 * chunks outside the visible area are skipped when the TextBatch is drawn
+	 * with a 2D transform.
+	 **/
+	void setCullingEnabled(bool enable);
+	bool isCullingEnabled() const;
+
+	/**
+	 * When enabled, the glyphs of newly set or added text are rasterized on a
+	 * separate thread, and the text's vertices are generated when they're
+	 * first needed instead of immediately.
+	 **/
+	void setPrewarmEnabled(bool enable);
+	bool isPrewarmEnabled() const;
 
 	// Implements Drawable.
 	void draw(love::graphics::Graphics *gfx, const Matrix4 &m) override;
@@ -78,11 +113,21 @@ private:
 		bool useMatrix;
 		bool appendVertices;
 		Matrix4 matrix;
+
+		// The range of the vertex buffer reserved for this text.
+		size_t vertexStart = 0;
+		size_t vertexCapacity = 0;
+
+		std::vector<Font::DrawCommand> drawCommands;
 	};
 
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
-	void addTextData(const TextData &s);
+	void updatePendingVertices();
+	void updateTextVertices(int index);
+	void updateDrawCommands();
+	void compactVertices();
+	int addTextData(const TextData &s, int index, bool prewarm);
 
 	StrongRef<Font> font;
 
@@ -101,6 +146,27 @@ private:
 	
 	// Used so we know when the font's texture cache is invalidated.
 	uint32 textureCacheID;
+
+	bool prewarmEnabled;
+
+	// Whether textData has text whose vertices haven't been generated yet.
+	bool verticesPending;
+
+	// Whether drawCommands needs to be rebuilt from the per-text commands.
+	bool drawCommandsDirty;
+
+	// Whether all text needs new vertices, even if the font's texture cache
+	// wasn't invalidated.
+	bool regenerateAll;
+
+	// Vertices in the buffer which no longer belong to any text.
+	size_t unusedVertices;
+
+	int maxEntries;
+	int nextRingEntry;
+
+	QuadCuller culler;
+	std::vector<Range> drawRanges;
 	
 }; // Text
 
@@ -22,6 +22,10 @@
 #include "common/config.h"
 #include "Texture.h"
 #include "Graphics.h"
+#include "FrameCapture.h"
+#include "Buffer.h"
+#include "Shader.h"
+#include "profiler/Profiler.h"
 
 // C
 #include <cmath>
@@ -157,13 +161,156 @@ std::vector<std::string> SamplerState::getConstants(WrapMode)
 	return wrapModes.getNames();
 }
 
+// Decodes the raw bytes of an image into a texture with a wider pixel format,
+// for pixel formats which can't be sampled on some systems. Pixels are tightly
+// packed, so two-byte pixels can start halfway through a word.
+static const char uploadConversionShaderCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+readonly buffer love_UploadSource { uint love_UploadWords[]; };
+layout (LOVE_UPLOAD_FORMAT) uniform writeonly image2D love_UploadTarget;
+
+uniform ivec4 love_UploadRect;
+uniform ivec4 love_UploadDecode; // x: layout (0: 4x8, 1: 4x16, 2: la8), y: swap red and blue, z: sRGB
+
+void computemain()
+{
+	ivec2 p = ivec2(love_GlobalThreadID.xy);
+	if (p.x >= love_UploadRect.z || p.y >= love_UploadRect.w)
+		return;
+
+	int index = p.y * love_UploadRect.z + p.x;
+	vec4 c;
+
+	if (love_UploadDecode.x == 1)
+	{
+		c.rg = unpackUnorm2x16(love_UploadWords[index * 2 + 0]);
+		c.ba = unpackUnorm2x16(love_UploadWords[index * 2 + 1]);
+	}
+	else if (love_UploadDecode.x == 2)
+	{
+		uint word = love_UploadWords[index / 2] >> uint(16 * (index % 2));
+		c = unpackUnorm4x8(word).xxxy;
+	}
+	else
+		c = unpackUnorm4x8(love_UploadWords[index]);
+
+	if (love_UploadDecode.y != 0)
+		c = c.bgra;
+	if (love_UploadDecode.z != 0)
+		c.rgb = gammaToLinearPrecise(c.rgb);
+
+	imageStore(love_UploadTarget, love_UploadRect.xy + p, c);
+}
+)";
+
+enum UploadLayout
+{
+	UPLOAD_LAYOUT_4X8,
+	UPLOAD_LAYOUT_4X16,
+	UPLOAD_LAYOUT_LA8,
+};
+
+struct UploadConversion
+{
+	PixelFormat source;
+	UploadLayout layout;
+	bool swapRedBlue;
+	bool sRGB;
+
+	// Stored formats, in order of preference.
+	PixelFormat targets[2];
+};
+
+static const UploadConversion uploadConversions[] =
+{
+	{ PIXELFORMAT_BGRA8_UNORM,  UPLOAD_LAYOUT_4X8,  true,  false, { PIXELFORMAT_RGBA8_UNORM, PIXELFORMAT_RGBA16_FLOAT } },
+	{ PIXELFORMAT_BGRA8_sRGB,   UPLOAD_LAYOUT_4X8,  true,  true,  { PIXELFORMAT_RGBA16_FLOAT, PIXELFORMAT_RGBA32_FLOAT } },
+	{ PIXELFORMAT_RGBA8_sRGB,   UPLOAD_LAYOUT_4X8,  false, true,  { PIXELFORMAT_RGBA16_FLOAT, PIXELFORMAT_RGBA32_FLOAT } },
+	{ PIXELFORMAT_RGBA16_UNORM, UPLOAD_LAYOUT_4X16, false, false, { PIXELFORMAT_RGBA32_FLOAT, PIXELFORMAT_RGBA16_FLOAT } },
+	{ PIXELFORMAT_LA8_UNORM,    UPLOAD_LAYOUT_LA8,  false, false, { PIXELFORMAT_RGBA8_UNORM, PIXELFORMAT_RGBA16_FLOAT } },
+};
+
+// One shader per stored format, since storage textures declare their format.
+static const PixelFormat uploadTargetFormats[] = { PIXELFORMAT_RGBA8_UNORM, PIXELFORMAT_RGBA16_FLOAT, PIXELFORMAT_RGBA32_FLOAT };
+static const char *uploadTargetFormatNames[] = { "rgba8", "rgba16f", "rgba32f" };
+static const int UPLOAD_TARGET_FORMAT_COUNT = sizeof(uploadTargetFormats) / sizeof(uploadTargetFormats[0]);
+
+static Shader *uploadConversionShaders[UPLOAD_TARGET_FORMAT_COUNT] = {};
+
+static const UploadConversion *getUploadConversion(PixelFormat source)
+{
+	for (const UploadConversion &conversion : uploadConversions)
+	{
+		if (conversion.source == source)
+			return &conversion;
+	}
+	return nullptr;
+}
+
+static Shader *getUploadConversionShader(Graphics *gfx, PixelFormat target)
+{
+	for (int i = 0; i < UPLOAD_TARGET_FORMAT_COUNT; i++)
+	{
+		if (uploadTargetFormats[i] != target)
+			continue;
+
+		if (uploadConversionShaders[i] == nullptr)
+		{
+			std::string code = uploadConversionShaderCode;
+			const char *token = "LOVE_UPLOAD_FORMAT";
+			code.replace(code.find(token), strlen(token), uploadTargetFormatNames[i]);
+
+			Shader::CompileOptions options;
+			options.debugName = "Texture upload conversion";
+
+			uploadConversionShaders[i] = gfx->newComputeShader(code, options);
+		}
+
+		return uploadConversionShaders[i];
+	}
+
+	return nullptr;
+}
+
+static void sendUploadParams(Shader *shader, const char *name, int x, int y, int z, int w)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr)
+		return;
+
+	int params[4] = {x, y, z, w};
+	memcpy(info->data, params, std::min(sizeof(params), info->dataSize));
+	shader->updateUniform(info, info->count);
+}
+
+static PixelFormat getUploadConversionTarget(Graphics *gfx, PixelFormat source)
+{
+	const UploadConversion *conversion = getUploadConversion(source);
+	if (conversion == nullptr || !gfx->getCapabilities().features[Graphics::FEATURE_GLSL4])
+		return PIXELFORMAT_UNKNOWN;
+
+	uint32 usage = PIXELFORMATUSAGEFLAGS_SAMPLE | PIXELFORMATUSAGEFLAGS_COMPUTEWRITE;
+	for (PixelFormat target : conversion->targets)
+	{
+		if (gfx->isPixelFormatSupported(target, usage))
+			return target;
+	}
+
+	return PIXELFORMAT_UNKNOWN;
+}
+
 love::Type Texture::type("Texture", &Drawable::type);
 int Texture::textureCount = 0;
 int64 Texture::totalGraphicsMemory = 0;
+int Texture::evictableTextureCount = 0;
 
 Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	: texType(settings.type)
 	, format(settings.format)
+	, uploadFormat(PIXELFORMAT_UNKNOWN)
 	, renderTarget(settings.renderTarget)
 	, computeWrite(settings.computeWrite)
 	, readable(true)
@@ -180,6 +327,13 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	, samplerState()
 	, graphicsMemorySize(0)
 	, debugName(settings.debugName)
+	, evictable(settings.evictable || settings.streaming)
+	, transient(settings.transient)
+	, resolvePending(false)
+	, residentMipmap(0)
+	, framesSinceUse(0)
+	, streaming(settings.streaming)
+	, streamingDemand(0)
 	, rootView({this, 0, 0})
 	, parentView({this, 0, 0})
 {
@@ -235,6 +389,8 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 
 	if (settings.readable.hasValue)
 		readable = settings.readable.value;
+	else if (transient)
+		readable = settings.msaa > 1 && !isPixelFormatDepthStencil(format);
 	else
 		readable = !renderTarget || !isPixelFormatDepthStencil(format);
 
@@ -242,6 +398,22 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	if (!isGammaCorrect() || settings.linear)
 		format = getLinearPixelFormat(format);
 
+	// Image data in a format this system can't sample from (bgra8 or rgba16 on
+	// many GLES devices, for example) is uploaded as-is and converted into a
+	// wider format by a compute shader, instead of failing.
+	if (slices != nullptr && slices->get(0, 0) != nullptr && slices->getMipmapCount() <= 1
+		&& texType == TEXTURE_2D && !renderTarget && !computeWrite && !evictable && viewFormats.empty()
+		&& !gfx->isPixelFormatSupported(format, PIXELFORMATUSAGEFLAGS_SAMPLE))
+	{
+		PixelFormat target = getUploadConversionTarget(gfx, format);
+		if (target != PIXELFORMAT_UNKNOWN)
+		{
+			uploadFormat = format;
+			format = target;
+			computeWrite = true;
+		}
+	}
+
 	if (mipmapsMode == MIPMAPS_AUTO && isCompressed())
 		mipmapsMode = MIPMAPS_MANUAL;
 
@@ -323,6 +495,37 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 
 	validateDimensions(true);
 
+	if (evictable)
+	{
+		if (renderTarget || computeWrite)
+			throw love::Exception("Evictable textures cannot be render targets or compute-writable.");
+
+		if (slices == nullptr || slices->get(0, 0) == nullptr)
+			throw love::Exception("Evictable textures must be created with image data.");
+
+		if (mipmapCount <= 1)
+			throw love::Exception("Evictable textures must have mipmaps.");
+	}
+
+	// Levels are streamed in from their own data, rather than generated from
+	// a base level which wouldn't be resident yet.
+	if (streaming && slices->getMipmapCount() < mipmapCount)
+		throw love::Exception("Streaming textures must be created with image data for every mipmap level.");
+
+	resetStreamingDemand();
+
+	if (transient)
+	{
+		if (!renderTarget || computeWrite)
+			throw love::Exception("Transient textures must be render targets, and cannot be compute-writable.");
+
+		if (slices != nullptr && slices->get(0, 0) != nullptr)
+			throw love::Exception("Transient textures cannot be created with image data.");
+
+		if (readable && settings.msaa <= 1)
+			throw love::Exception("Transient textures must be non-readable, unless they use MSAA.");
+	}
+
 	samplerState = gfx->getDefaultSamplerState();
 
 	if (getMipmapCount() == 1)
@@ -332,11 +535,18 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	quad.set(new Quad(v, width, height), Acquire::NORETAIN);
 
 	++textureCount;
+
+	if (evictable)
+	{
+		++evictableTextureCount;
+		gfx->registerEvictableTexture(this);
+	}
 }
 
 Texture::Texture(Graphics *gfx, Texture *base, const ViewSettings &viewsettings)
 	: texType(viewsettings.type.get(base->getTextureType()))
 	, format(viewsettings.format.get(base->getPixelFormat()))
+	, uploadFormat(base->uploadFormat)
 	, renderTarget(base->renderTarget)
 	, computeWrite(base->computeWrite)
 	, readable(base->readable)
@@ -354,6 +564,13 @@ Texture::Texture(Graphics *gfx, Texture *base, const ViewSettings &viewsettings)
 	, quad(base->quad)
 	, graphicsMemorySize(0)
 	, debugName(viewsettings.debugName)
+	, evictable(false)
+	, transient(base->transient)
+	, resolvePending(false)
+	, residentMipmap(0)
+	, framesSinceUse(0)
+	, streaming(false)
+	, streamingDemand(0)
 	, rootView({base->rootView.texture, 0, 0})
 	, parentView({base, viewsettings.mipmapStart.get(0), viewsettings.layerStart.get(0)})
 {
@@ -414,6 +631,9 @@ Texture::Texture(Graphics *gfx, Texture *base, const ViewSettings &viewsettings)
 	if (!readable)
 		throw love::Exception("Texture views are not supported for non-readable textures.");
 
+	if (base->isEvictable())
+		throw love::Exception("Texture views are not supported for evictable textures.");
+
 	if (base->getTextureType() == TEXTURE_2D)
 	{
 		if (texType != TEXTURE_2D && texType != TEXTURE_2D_ARRAY)
@@ -455,6 +675,14 @@ Texture::~Texture()
 	if (this == rootView.texture)
 		--textureCount;
 
+	if (evictable)
+	{
+		--evictableTextureCount;
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			gfx->unregisterEvictableTexture(this);
+	}
+
 	if (rootView.texture != this && rootView.texture != nullptr)
 		rootView.texture->release();
 	if (parentView.texture != this && parentView.texture != nullptr)
@@ -467,7 +695,8 @@ void Texture::updateGraphicsMemorySize(bool loaded)
 
 	if (loaded)
 	{
-		for (int mip = 0; mip < getMipmapCount(); mip++)
+		// Evicted mipmap levels don't use any memory.
+		for (int mip = residentMipmap; mip < getMipmapCount(); mip++)
 		{
 			int w = getPixelWidth(mip);
 			int h = getPixelHeight(mip);
@@ -504,14 +733,33 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 		return;
 	}
 
+	if (gfx->isArrayLayerBatching() && isArrayLayerView())
+	{
+		// Sampling the array directly gives the same result as sampling the
+		// view, but draws of other layers won't break the batch.
+		rootView.texture->drawLayer(gfx, rootView.startLayer, q, localTransform);
+		return;
+	}
+
 	if (!readable)
 		throw love::Exception("Textures with non-readable formats cannot be drawn.");
 
 	if (renderTarget && gfx->isRenderTargetActive(this))
 		throw love::Exception("Cannot render a Texture to itself.");
 
-	const Matrix4 &tm = gfx->getTransform();
-	bool is2D = tm.isAffine2DTransform();
+	// setPaletteTexture may flush batched draws, so it has to be called before
+	// requestBatchedDraw.
+	if (palette.get() != nullptr)
+	{
+		auto shader = Shader::current;
+		if (Shader::isDefaultActive())
+			shader = Shader::standardShaders[Shader::STANDARD_PALETTE];
+
+		if (shader != nullptr)
+			shader->setPaletteTexture(palette);
+	}
+
+	bool is2D = gfx->isTransformAffine2D();
 
 	Graphics::BatchedDrawCommand cmd;
 	cmd.formats[0] = getSinglePositionFormat(is2D);
@@ -520,9 +768,15 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 	cmd.vertexCount = 4;
 	cmd.texture = this;
 
+	if (palette.get() != nullptr)
+		cmd.standardShaderType = Shader::STANDARD_PALETTE;
+
 	Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
 
-	Matrix4 t(tm, localTransform);
+	Matrix4 t = gfx->getCombinedTransform(localTransform);
+
+	if (streaming)
+		updateStreamingDemand(gfx, q, t);
 
 	if (is2D)
 		t.transformXY((Vector2 *) data.stream[0], q->getVertexPositions(), 4);
@@ -542,6 +796,107 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 	}
 }
 
+void Texture::drawMany(Graphics *gfx, Quad * const *quads, int quadcount, const ManySprite *sprites, int count)
+{
+	if (texType != TEXTURE_2D)
+		throw love::Exception("drawMany can only be used with 2D textures.");
+
+	if (!readable)
+		throw love::Exception("Textures with non-readable formats cannot be drawn.");
+
+	if (renderTarget && gfx->isRenderTargetActive(this))
+		throw love::Exception("Cannot render a Texture to itself.");
+
+	// Checked up front, so nothing is drawn when a sprite is invalid.
+	for (int i = 0; i < count; i++)
+	{
+		float q = sprites[i].quad;
+		if (!(q >= 0.0f && q <= (float) quadcount) || q != std::floor(q))
+			throw love::Exception("Invalid quad index %g for sprite %d.", q, i + 1);
+	}
+
+	if (palette.get() != nullptr)
+	{
+		auto shader = Shader::current;
+		if (Shader::isDefaultActive())
+			shader = Shader::standardShaders[Shader::STANDARD_PALETTE];
+
+		if (shader != nullptr)
+			shader->setPaletteTexture(palette);
+	}
+
+	bool is2D = gfx->isTransformAffine2D();
+	Colorf color = gfx->getColor();
+
+	// Batches use 16 bit indices.
+	const int maxsprites = LOVE_UINT16_MAX / 4;
+
+	for (int start = 0; start < count; start += maxsprites)
+	{
+		int n = std::min(count - start, maxsprites);
+
+		Graphics::BatchedDrawCommand cmd;
+		cmd.formats[0] = getSinglePositionFormat(is2D);
+		cmd.formats[1] = CommonFormat::STf_RGBAub;
+		cmd.indexMode = TRIANGLEINDEX_QUADS;
+		cmd.vertexCount = n * 4;
+		cmd.texture = this;
+
+		if (palette.get() != nullptr)
+			cmd.standardShaderType = Shader::STANDARD_PALETTE;
+
+		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+
+		STf_RGBAub *vertexdata = (STf_RGBAub *) data.stream[1];
+
+		for (int i = 0; i < n; i++)
+		{
+			const ManySprite &sprite = sprites[start + i];
+			int quadindex = (int) sprite.quad;
+			Quad *q = quadindex > 0 ? quads[quadindex - 1] : quad.get();
+
+			Matrix4 local(sprite.x, sprite.y, sprite.angle, sprite.sx, sprite.sy, sprite.ox, sprite.oy, sprite.kx, sprite.ky);
+			Matrix4 t = gfx->getCombinedTransform(local);
+
+			if (streaming)
+				updateStreamingDemand(gfx, q, t);
+
+			if (is2D)
+				t.transformXY((Vector2 *) data.stream[0] + i * 4, q->getVertexPositions(), 4);
+			else
+				t.transformXY0((Vector3 *) data.stream[0] + i * 4, q->getVertexPositions(), 4);
+
+			Colorf c(color.r * sprite.r, color.g * sprite.g, color.b * sprite.b, color.a * sprite.a);
+			Color32 c32 = toColor32(c);
+
+			const Vector2 *texcoords = q->getVertexTexCoords();
+			for (int j = 0; j < 4; j++)
+			{
+				vertexdata[i * 4 + j].s = texcoords[j].x;
+				vertexdata[i * 4 + j].t = texcoords[j].y;
+				vertexdata[i * 4 + j].color = c32;
+			}
+		}
+	}
+}
+
+bool Texture::isArrayLayerView() const
+{
+	const Texture *root = rootView.texture;
+
+	if (root == this || texType != TEXTURE_2D || root->getTextureType() != TEXTURE_2D_ARRAY)
+		return false;
+
+	// The array's sampling behaviour has to match the view's exactly.
+	if (rootView.startMipmap != 0 || mipmapCount != root->getMipmapCount())
+		return false;
+
+	if (format != root->getPixelFormat() || samplerState.toKey() != root->getSamplerState().toKey())
+		return false;
+
+	return Shader::isDefaultActive();
+}
+
 void Texture::drawLayer(Graphics *gfx, int layer, const Matrix4 &m)
 {
 	drawLayer(gfx, layer, quad, m);
@@ -563,10 +918,12 @@ void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
 
 	Color32 c = toColor32(gfx->getColor());
 
-	const Matrix4 &tm = gfx->getTransform();
-	bool is2D = tm.isAffine2DTransform();
+	bool is2D = gfx->isTransformAffine2D();
+
+	Matrix4 t = gfx->getCombinedTransform(m);
 
-	Matrix4 t(tm, m);
+	if (streaming)
+		updateStreamingDemand(gfx, q, t);
 
 	Graphics::BatchedDrawCommand cmd;
 	cmd.formats[0] = getSinglePositionFormat(is2D);
@@ -597,34 +954,95 @@ void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
 
 void Texture::uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y)
 {
+	LOVE_PROFILE_ZONE("love.graphics.uploadTexture");
+
+	if (uploadFormat != PIXELFORMAT_UNKNOWN)
+	{
+		uploadConvertedImageData(d, x, y);
+		return;
+	}
+
 	Rect rect = {x, y, d->getWidth(), d->getHeight()};
 	uploadByteData(d->getData(), d->getSize(), level, slice, rect);
 }
 
-void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+void Texture::uploadConvertedImageData(love::image::ImageDataBase *d, int x, int y)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	const UploadConversion *conversion = getUploadConversion(uploadFormat);
+	Shader *shader = gfx != nullptr ? getUploadConversionShader(gfx, format) : nullptr;
+
+	if (conversion == nullptr || shader == nullptr)
+		throw love::Exception("Cannot convert the texture's image data on the GPU.");
+
+	// The shader reads whole words.
+	size_t size = (d->getSize() + 3) & ~(size_t) 3;
+	Buffer *buffer = gfx->getTemporaryBuffer(size, DATAFORMAT_UINT32, BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+
+	const Shader::UniformInfo *targetinfo = shader->getUniformInfo("love_UploadTarget");
+
+	try
+	{
+		buffer->fill(0, d->getSize(), d->getData());
+
+		sendUploadParams(shader, "love_UploadRect", x, y, d->getWidth(), d->getHeight());
+		sendUploadParams(shader, "love_UploadDecode", (int) conversion->layout, conversion->swapRedBlue ? 1 : 0, conversion->sRGB ? 1 : 0, 0);
+
+		const Shader::UniformInfo *info = shader->getUniformInfo("love_UploadSource");
+		if (info != nullptr)
+			shader->sendBuffers(info, &buffer, 1);
+
+		Texture *target = this;
+		if (targetinfo != nullptr)
+			shader->sendTextures(targetinfo, &target, 1);
+
+		gfx->dispatchThreadgroups(shader, (d->getWidth() + 7) / 8, (d->getHeight() + 7) / 8, 1);
+	}
+	catch (love::Exception &)
+	{
+		gfx->releaseTemporaryBuffer(buffer);
+		throw;
+	}
+
+	// The cached shader shouldn't keep this texture alive.
+	if (targetinfo != nullptr)
+	{
+		Texture *none = nullptr;
+		shader->sendTextures(targetinfo, &none, 1);
+	}
+
+	gfx->releaseTemporaryBuffer(buffer);
+}
+
+void Texture::validateReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, const char *funcname)
 {
 	if (!isReadable())
-		throw love::Exception("replacePixels can only be called on readable Textures.");
+		throw love::Exception("%s can only be called on readable Textures.", funcname);
 
 	if (getMSAA() > 1)
-		throw love::Exception("replacePixels cannot be called on a MSAA Texture.");
+		throw love::Exception("%s cannot be called on a MSAA Texture.", funcname);
 
 	if (isPixelFormatDepthStencil(format))
-		throw love::Exception("replacePixels cannot be called on depth or stencil Textures.");
+		throw love::Exception("%s cannot be called on depth or stencil Textures.", funcname);
+
+	// Evicted data is reloaded from the source ImageData, which would lose
+	// the new pixels.
+	if (evictable)
+		throw love::Exception("%s cannot be called on evictable Textures.", funcname);
 
 	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 	if (gfx != nullptr && gfx->isRenderTargetActive(this))
-		throw love::Exception("replacePixels cannot be called on this Texture while it's an active render target.");
-
-	// No effect if the texture hasn't been created yet.
-	if (getHandle() == 0)
-		return;
+		throw love::Exception("%s cannot be called on this Texture while it's an active render target.", funcname);
 
 	// ImageData format might be linear but intended to be used as sRGB, so we
 	// don't error if only the sRGBness is different.
-	if (getLinearPixelFormat(d->getFormat()) != getLinearPixelFormat(getPixelFormat()))
+	PixelFormat dataformat = uploadFormat != PIXELFORMAT_UNKNOWN ? uploadFormat : getPixelFormat();
+	if (getLinearPixelFormat(d->getFormat()) != getLinearPixelFormat(dataformat))
 		throw love::Exception("Pixel formats must match.");
 
+	if (uploadFormat != PIXELFORMAT_UNKNOWN && mipmap != 0)
+		throw love::Exception("%s can only replace the base mipmap level of Textures whose pixel format is converted on upload.", funcname);
+
 	if (mipmap < 0 || mipmap >= getMipmapCount())
 		throw love::Exception("Invalid texture mipmap index %d.", mipmap + 1);
 
@@ -658,8 +1076,24 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 			throw love::Exception("Compressed texture format %s only supports replacing a sub-rectangle with offset and dimensions that are a multiple of %d x %d.", name, bw, bh);
 		}
 	}
+}
+
+void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	validateReplacePixels(d, slice, mipmap, x, y, "replacePixels");
 
-	Graphics::flushBatchedDrawsGlobal();
+	// No effect if the texture hasn't been created yet.
+	if (getHandle() == 0)
+		return;
+
+	Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_TEXTURE);
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr && gfx->getActiveFrameCapture() != nullptr && uploadFormat == PIXELFORMAT_UNKNOWN)
+	{
+		Rect rect = {x, y, d->getWidth(), d->getHeight()};
+		gfx->getActiveFrameCapture()->captureTextureUpload(this, d->getData(), d->getSize(), slice, mipmap, rect, reloadmipmaps);
+	}
 
 	uploadImageData(d, mipmap, slice, x, y);
 
@@ -669,6 +1103,8 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 
 void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
 {
+	LOVE_PROFILE_ZONE("love.graphics.replacePixels");
+
 	if (!isReadable() || getMSAA() > 1)
 		return;
 
@@ -676,7 +1112,10 @@ void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap
 	if (gfx != nullptr && gfx->isRenderTargetActive(this))
 		return;
 
-	Graphics::flushBatchedDrawsGlobal();
+	Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_TEXTURE);
+
+	if (gfx != nullptr && gfx->getActiveFrameCapture() != nullptr)
+		gfx->getActiveFrameCapture()->captureTextureUpload(this, data, size, slice, mipmap, rect, reloadmipmaps);
 
 	uploadByteData(data, size, mipmap, slice, rect);
 
@@ -684,6 +1123,22 @@ void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap
 		generateMipmaps();
 }
 
+TextureUpload *Texture::replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	validateReplacePixels(d, slice, mipmap, x, y, "replacePixelsAsync");
+
+	if (uploadFormat != PIXELFORMAT_UNKNOWN)
+		throw love::Exception("replacePixelsAsync cannot be used with Textures whose pixel format is converted on upload.");
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		throw love::Exception("replacePixelsAsync requires the love.graphics module.");
+
+	Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_TEXTURE);
+
+	return gfx->uploadTextureAsync(this, d, slice, mipmap, x, y, reloadmipmaps);
+}
+
 bool Texture::supportsGenerateMipmaps(const char *&outReason) const
 {
 	if (getMipmapsMode() == MIPMAPS_NONE)
@@ -788,6 +1243,34 @@ int Texture::getMipmapCount() const
 	return mipmapCount;
 }
 
+int Texture::getInitialStreamingMipmap() const
+{
+	int mip = 0;
+	while (mip < mipmapCount - 1 && std::max(getPixelWidth(mip), getPixelHeight(mip)) > MAX_INITIAL_STREAMING_SIZE)
+		mip++;
+	return mip;
+}
+
+void Texture::updateStreamingDemand(Graphics *gfx, const Quad *q, const Matrix4 &t)
+{
+	Quad::Viewport v = q->getViewport();
+	const float *e = t.getElements();
+
+	// Lengths of the quad's edges on screen, in pixels.
+	double dpiscale = gfx->getCurrentDPIScale();
+	double screenw = v.w * sqrt(e[0] * e[0] + e[1] * e[1]) * dpiscale;
+	double screenh = v.h * sqrt(e[4] * e[4] + e[5] * e[5]) * dpiscale;
+
+	double texelsx = v.w * ((double) pixelWidth / width);
+	double texelsy = v.h * ((double) pixelHeight / height);
+
+	// Like the GPU, the axis with the most texels per pixel decides the level.
+	double ratio = std::max(texelsx / std::max(screenw, 1e-4), texelsy / std::max(screenh, 1e-4));
+	int mip = ratio > 1.0 ? (int) floor(log2(ratio)) : 0;
+
+	streamingDemand = std::min(streamingDemand, std::min(mip, mipmapCount - 1));
+}
+
 int Texture::getPixelWidth(int mip) const
 {
 	return std::max(pixelWidth >> mip, 1);
@@ -838,7 +1321,7 @@ SamplerState Texture::validateSamplerState(SamplerState s) const
 		}
 	}
 
-	Graphics::flushBatchedDrawsGlobal();
+	Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_TEXTURE);
 
 	return s;
 }
@@ -848,6 +1331,38 @@ Quad *Texture::getQuad() const
 	return quad;
 }
 
+void Texture::setPalette(Texture *palette)
+{
+	if (palette != nullptr)
+	{
+		if (format != PIXELFORMAT_R8_UNORM || texType != TEXTURE_2D)
+			throw love::Exception("Only 2D textures with the r8 pixel format can use a palette.");
+
+		if (palette == this || palette->getTextureType() != TEXTURE_2D || !palette->isReadable())
+			throw love::Exception("A palette must be a different readable 2D texture.");
+
+		if (palette->getPixelHeight() != 1 || palette->getPixelWidth() > 256)
+			throw love::Exception("A palette must be 1 pixel tall and at most 256 pixels wide.");
+	}
+
+	this->palette.set(palette);
+}
+
+Texture *Texture::getPalette() const
+{
+	return palette;
+}
+
+void Texture::releaseSharedResources()
+{
+	for (Shader *&shader : uploadConversionShaders)
+	{
+		if (shader != nullptr)
+			shader->release();
+		shader = nullptr;
+	}
+}
+
 int Texture::getTotalMipmapCount(int w, int h)
 {
 	return (int) log2(std::max(w, h)) + 1;
@@ -1137,6 +1652,9 @@ static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM>::Entry setting
 	{ "viewformats",  Texture::SETTING_VIEW_FORMATS  },
 	{ "readable",     Texture::SETTING_READABLE      },
 	{ "debugname",    Texture::SETTING_DEBUGNAME     },
+	{ "evictable",    Texture::SETTING_EVICTABLE     },
+	{ "transient",    Texture::SETTING_TRANSIENT     },
+	{ "streaming",    Texture::SETTING_STREAMING     },
 };
 
 static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM> settingTypes(settingTypeEntries, sizeof(settingTypeEntries));
@@ -48,6 +48,7 @@ namespace graphics
 
 class Graphics;
 class Buffer;
+class TextureUpload;
 
 enum TextureType
 {
@@ -178,6 +179,9 @@ public:
 		SETTING_VIEW_FORMATS,
 		SETTING_READABLE,
 		SETTING_DEBUGNAME,
+		SETTING_EVICTABLE,
+		SETTING_TRANSIENT,
+		SETTING_STREAMING,
 		SETTING_MAX_ENUM
 	};
 
@@ -199,6 +203,9 @@ public:
 		std::vector<PixelFormat> viewFormats;
 		OptionalBool readable;
 		std::string debugName;
+		bool evictable = false;
+		bool transient = false;
+		bool streaming = false;
 	};
 
 	struct ViewSettings
@@ -249,7 +256,24 @@ public:
 		int startLayer;
 	};
 
+	/**
+	 * A single sprite given to drawMany. The quad is a 1-based index into the
+	 * Quads given with it, or 0 for the whole texture. The rest are the same
+	 * as the arguments of draw, followed by a color which is multiplied with
+	 * the current one.
+	 **/
+	struct ManySprite
+	{
+		float quad;
+		float x, y, angle, sx, sy, ox, oy, kx, ky;
+		float r, g, b, a;
+	};
+
 	static int64 totalGraphicsMemory;
+	static int evictableTextureCount;
+
+	// Streaming textures initially load the levels which fit in this size.
+	static const int MAX_INITIAL_STREAMING_SIZE = 128;
 
 	// Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
@@ -262,9 +286,21 @@ public:
 	void drawLayer(Graphics *gfx, int layer, const Matrix4 &m);
 	void drawLayer(Graphics *gfx, int layer, Quad *quad, const Matrix4 &m);
 
+	/**
+	 * Draws many sprites of this texture in one call, writing them all into
+	 * the batched draw stream without going through draw for each one.
+	 **/
+	void drawMany(Graphics *gfx, Quad * const *quads, int quadcount, const ManySprite *sprites, int count);
+
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
+	/**
+	 * Copies the pixels into a staging buffer and queues a GPU copy into the
+	 * texture, instead of uploading them synchronously.
+	 **/
+	TextureUpload *replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
 	void generateMipmaps();
 
 	virtual void copyFromBuffer(Buffer *source, size_t sourceoffset, int sourcewidth, size_t size, int slice, int mipmap, const Rect &rect) = 0;
@@ -310,11 +346,83 @@ public:
 
 	Quad *getQuad() const;
 
+	/**
+	 * Sets a 1 pixel tall texture whose colors are looked up by the indices
+	 * stored in this r8 texture when it's drawn with the default shader.
+	 * The texture should use nearest neighbour filtering, since the indices
+	 * can't be interpolated.
+	 **/
+	void setPalette(Texture *palette);
+	Texture *getPalette() const;
+
 	const ViewInfo &getRootViewInfo() const { return rootView; }
 	const ViewInfo &getParentViewInfo() const { return parentView; }
 
 	const std::string &getDebugName() const { return debugName; }
 
+	int64 getGraphicsMemorySize() const { return graphicsMemorySize; }
+
+	bool isEvictable() const { return evictable; }
+
+	/**
+	 * Streaming textures are evictable textures which start out with only
+	 * their smallest mipmap levels resident. Larger levels are uploaded a few
+	 * at a time at the end of each frame, down to the level the texture was
+	 * last drawn at.
+	 **/
+	bool isStreaming() const { return streaming; }
+	int getStreamingDemand() const { return streamingDemand; }
+	void resetStreamingDemand() { streamingDemand = mipmapCount; }
+	int getInitialStreamingMipmap() const;
+
+	/**
+	 * Transient render targets don't keep their contents after a render pass
+	 * ends, which lets tile-based GPUs skip storing them and sometimes skip
+	 * allocating memory for them at all. For readable MSAA textures only the
+	 * multisampled data is transient; the resolved result is kept.
+	 **/
+	bool isTransient() const { return transient; }
+
+	/**
+	 * Whether a readable MSAA texture was last rendered to by a pass which
+	 * didn't resolve it, so its single-sampled contents are out of date.
+	 **/
+	bool isResolvePending() const { return resolvePending; }
+	void setResolvePending(bool pending) { resolvePending = pending; }
+
+	int getResidentMipmap() const { return residentMipmap; }
+	int getFramesSinceUse() const { return framesSinceUse; }
+	void incrementFramesSinceUse() { framesSinceUse++; }
+
+	/**
+	 * Marks an evictable texture as used, and brings back any of its mipmap
+	 * levels which were evicted to stay within the texture memory budget.
+	 **/
+	void markUsed()
+	{
+		if (!evictable)
+			return;
+		framesSinceUse = 0;
+		if (streaming)
+		{
+			// Uses which don't know their on-screen size want every level.
+			if (streamingDemand >= mipmapCount)
+				streamingDemand = 0;
+		}
+		else if (residentMipmap > 0)
+			setResidentMipmap(0);
+	}
+
+	/**
+	 * Frees the memory of all mipmap levels larger than the given one, or
+	 * reloads them from the texture's source data. The texture is sampled from
+	 * the given level until it's made fully resident again. Returns false if
+	 * the texture's data can't be evicted.
+	 **/
+	virtual bool setResidentMipmap(int /*mipmap*/) { return false; }
+
+	static void releaseSharedResources();
+
 	static int getTotalMipmapCount(int w, int h);
 	static int getTotalMipmapCount(int w, int h, int d);
 
@@ -339,7 +447,10 @@ protected:
 
 	void updateGraphicsMemorySize(bool loaded);
 
+	void validateReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, const char *funcname);
+
 	void uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y);
+	void uploadConvertedImageData(love::image::ImageDataBase *d, int x, int y);
 	virtual void uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r) = 0;
 
 	bool supportsGenerateMipmaps(const char *&outReason) const;
@@ -348,11 +459,24 @@ protected:
 	SamplerState validateSamplerState(SamplerState s) const;
 
 	bool validateDimensions(bool throwException) const;
+
+	// Finds the mipmap level needed to draw the given quad without visible
+	// loss of detail, from its size on screen.
+	void updateStreamingDemand(Graphics *gfx, const Quad *q, const Matrix4 &t);
 	void validatePixelFormat(Graphics *gfx) const;
 
+	// Whether this is a 2D view of an array texture layer which can be drawn
+	// via the array texture without any visible difference.
+	bool isArrayLayerView() const;
+
 	TextureType texType;
 
 	PixelFormat format;
+
+	// The format of the image data the texture was created with, when it's
+	// converted to format on the GPU at upload. PIXELFORMAT_UNKNOWN otherwise.
+	PixelFormat uploadFormat;
+
 	bool renderTarget;
 	bool computeWrite;
 	bool readable;
@@ -377,10 +501,21 @@ protected:
 
 	StrongRef<Quad> quad;
 
+	StrongRef<Texture> palette;
+
 	int64 graphicsMemorySize;
 
 	std::string debugName;
 
+	bool evictable;
+	bool transient;
+	bool resolvePending;
+	int residentMipmap;
+	int framesSinceUse;
+
+	bool streaming;
+	int streamingDemand;
+
 	ViewInfo rootView;
 	ViewInfo parentView;
 
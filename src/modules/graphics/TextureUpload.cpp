@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TextureUpload.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "Graphics.h"
+#include "image/ImageDataBase.h"
+#include "thread/threads.h"
+
+// C
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TextureUpload::type("TextureUpload", &Object::type);
+
+TextureUpload::TextureUpload(Graphics *gfx, Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+	: texture(texture)
+{
+	// The Texture validates the arguments before creating the upload.
+	Rect rect = {x, y, data->getWidth(), data->getHeight()};
+	size_t size = data->getSize();
+
+	// Buffer to texture copies need a 4 byte aligned size. Uploads that can't
+	// use one are rare enough that a regular synchronous upload is fine.
+	if (size % 4 != 0)
+	{
+		love::thread::Lock lock(data->getMutex());
+		texture->replacePixels(data->getData(), size, slice, mipmap, rect, reloadmipmaps);
+
+		complete = true;
+		return;
+	}
+
+	stagingBuffer = gfx->getTemporaryBuffer(size, DATAFORMAT_FLOAT, 0, BUFFERDATAUSAGE_STREAM);
+
+	void *dest = stagingBuffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, size);
+	if (dest == nullptr)
+	{
+		releaseStagingBuffer();
+		throw love::Exception("Could not map the staging buffer for a texture upload.");
+	}
+
+	{
+		// The ImageData may still be in use by a loader thread.
+		love::thread::Lock lock(data->getMutex());
+		memcpy(dest, data->getData(), size);
+	}
+
+	stagingBuffer->unmap(0, size);
+
+	try
+	{
+		gfx->copyBufferToTexture(stagingBuffer, texture, 0, rect.w, slice, mipmap, rect);
+	}
+	catch (love::Exception &)
+	{
+		releaseStagingBuffer();
+		throw;
+	}
+
+	if (reloadmipmaps && mipmap == 0 && texture->getMipmapCount() > 1)
+		texture->generateMipmaps();
+}
+
+TextureUpload::~TextureUpload()
+{
+	releaseStagingBuffer();
+}
+
+void TextureUpload::releaseStagingBuffer()
+{
+	if (stagingBuffer.get() == nullptr)
+		return;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr)
+		gfx->releaseTemporaryBuffer(stagingBuffer);
+
+	stagingBuffer.set(nullptr);
+}
+
+} // graphics
+} // love
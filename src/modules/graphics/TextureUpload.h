@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/math.h"
+#include "common/Object.h"
+
+namespace love::image
+{
+class ImageDataBase;
+}
+
+namespace love
+{
+namespace graphics
+{
+
+class Buffer;
+class Texture;
+class Graphics;
+
+/**
+ * An in-flight copy of pixel data into a Texture. The pixels are copied into
+ * a staging buffer when the upload is created, so the source ImageData can be
+ * reused right away, and the GPU copies them into the Texture at its leisure.
+ **/
+class TextureUpload : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	TextureUpload(Graphics *gfx, Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+	virtual ~TextureUpload();
+
+	virtual void wait() = 0;
+	virtual void update() = 0;
+
+	bool isComplete() const { return complete; }
+	Texture *getTexture() const { return texture; }
+
+protected:
+
+	void releaseStagingBuffer();
+
+	StrongRef<Texture> texture;
+	StrongRef<Buffer> stagingBuffer;
+	bool complete = false;
+
+}; // TextureUpload
+
+} // graphics
+} // love
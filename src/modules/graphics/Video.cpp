@@ -23,6 +23,7 @@
 // LOVE
 #include "Shader.h"
 #include "Graphics.h"
+#include "common/memory.h"
 
 namespace love
 {
@@ -36,6 +37,10 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 	, width(stream->getWidth() / dpiscale)
 	, height(stream->getHeight() / dpiscale)
 	, samplerState()
+	, uploadBufferIndex(0)
+	, uploadMapped(false)
+	, uploadSize(0)
+	, planeOffsets()
 {
 	const SamplerState &defaultSampler = gfx->getDefaultSamplerState();
 	samplerState.minFilter = defaultSampler.minFilter;
@@ -98,12 +103,66 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 
 		textures[i].set(tex, Acquire::NORETAIN);
 	}
+
+	// Buffer to texture copies need 4 byte aligned sizes. Streams with other
+	// plane widths keep uploading from their own back buffer.
+	if (widths[0] % 4 == 0 && widths[1] % 4 == 0)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			planeOffsets[i] = uploadSize;
+			uploadSize += alignUp((size_t) widths[i] * heights[i], 16);
+		}
+
+		Buffer::Settings buffersettings(0, BUFFERDATAUSAGE_STREAM);
+		for (int i = 0; i < 2; i++)
+			uploadBuffers[i].set(gfx->newBuffer(buffersettings, DATAFORMAT_FLOAT, nullptr, uploadSize, 0), Acquire::NORETAIN);
+
+		if (!mapUploadBuffer())
+		{
+			for (int i = 0; i < 2; i++)
+				uploadBuffers[i].set(nullptr);
+		}
+	}
 }
 
 Video::~Video()
 {
 	if (source)
 		source->stop();
+
+	if (uploadMapped)
+	{
+		// The stream may outlive the Video, so it has to stop writing into the
+		// buffer first.
+		stream->setFrameTarget(nullptr);
+
+		if (Module::getInstance<Graphics>(Module::M_GRAPHICS) != nullptr)
+			uploadBuffers[uploadBufferIndex]->unmap(0, uploadSize);
+	}
+}
+
+bool Video::mapUploadBuffer()
+{
+	Buffer *buffer = uploadBuffers[uploadBufferIndex];
+
+	uint8 *data = (uint8 *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, uploadSize);
+	if (data == nullptr)
+		return false;
+
+	love::video::VideoStream::FrameTarget target;
+	target.yplane = data + planeOffsets[0];
+	target.cbplane = data + planeOffsets[1];
+	target.crplane = data + planeOffsets[2];
+
+	if (!stream->setFrameTarget(&target))
+	{
+		buffer->unmap(0, uploadSize);
+		return false;
+	}
+
+	uploadMapped = true;
+	return true;
 }
 
 love::video::VideoStream *Video::getStream()
@@ -113,7 +172,14 @@ love::video::VideoStream *Video::getStream()
 
 void Video::draw(Graphics *gfx, const Matrix4 &m)
 {
-	update();
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("Videos cannot be recorded into a DrawList.");
+
+	update(gfx);
+
+	// Keep new frames coming while redrawing on demand.
+	if (stream->isPlaying())
+		gfx->invalidate();
 
 	// setVideoTextures may call flushBatchedDraws before setting the textures, so
 	// we can't call it after requestBatchedDraw.
@@ -124,10 +190,9 @@ void Video::draw(Graphics *gfx, const Matrix4 &m)
 	if (shader != nullptr)
 		shader->setVideoTextures(textures[0], textures[1], textures[2]);
 
-	const Matrix4 &tm = gfx->getTransform();
-	bool is2D = tm.isAffine2DTransform();
+	bool is2D = gfx->isTransformAffine2D();
 
-	Matrix4 t(tm, m);
+	Matrix4 t = gfx->getCombinedTransform(m);
 
 	Graphics::BatchedDrawCommand cmd;
 	cmd.formats[0] = getSinglePositionFormat(is2D);
@@ -154,21 +219,42 @@ void Video::draw(Graphics *gfx, const Matrix4 &m)
 		verts[i].color = c;
 	}
 
-	gfx->flushBatchedDraws();
+	gfx->flushBatchedDraws(Graphics::BATCHFLUSH_DRAW);
 }
 
-void Video::update()
+void Video::update(Graphics *gfx)
 {
 	bool bufferschanged = stream->swapBuffers();
+	bool targetchanged = uploadMapped && stream->takeTargetFrame();
 	stream->fillBackBuffer();
 
-	if (bufferschanged)
+	auto frame = (const love::video::VideoStream::Frame*) stream->getFrontBuffer();
+
+	int widths[3]  = {frame->yw, frame->cw, frame->cw};
+	int heights[3] = {frame->yh, frame->ch, frame->ch};
+
+	// The decoder wrote the due frame into the mapped buffer, so the only
+	// copy left is the GPU's. The stream writes later frames into the other
+	// buffer while this one is in use.
+	if (targetchanged)
 	{
-		auto frame = (const love::video::VideoStream::Frame*) stream->getFrontBuffer();
+		Buffer *buffer = uploadBuffers[uploadBufferIndex];
+		buffer->unmap(0, uploadSize);
+		uploadMapped = false;
 
-		int widths[3]  = {frame->yw, frame->cw, frame->cw};
-		int heights[3] = {frame->yh, frame->ch, frame->ch};
+		for (int i = 0; i < 3; i++)
+		{
+			Rect rect = {0, 0, widths[i], heights[i]};
+			gfx->copyBufferToTexture(buffer, textures[i], planeOffsets[i], widths[i], 0, 0, rect);
+		}
 
+		uploadBufferIndex = (uploadBufferIndex + 1) % 2;
+		mapUploadBuffer();
+	}
+
+	// The due frame was decoded while no buffer was mapped.
+	if (bufferschanged)
+	{
 		const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
 
 		for (int i = 0; i < 3; i++)
@@ -24,6 +24,7 @@
 #include "common/math.h"
 #include "Drawable.h"
 #include "Texture.h"
+#include "Buffer.h"
 #include "vertex.h"
 #include "video/VideoStream.h"
 #include "audio/Source.h"
@@ -63,7 +64,8 @@ public:
 
 private:
 
-	void update();
+	void update(Graphics *gfx);
+	bool mapUploadBuffer();
 
 	StrongRef<love::video::VideoStream> stream;
 
@@ -76,7 +78,15 @@ private:
 
 	StrongRef<Texture> textures[3];
 	StrongRef<love::audio::Source> source;
-	
+
+	// The stream decodes frames straight into one of these while it's mapped,
+	// and the other is copied into the textures by the GPU.
+	StrongRef<Buffer> uploadBuffers[2];
+	int uploadBufferIndex;
+	bool uploadMapped;
+	size_t uploadSize;
+	size_t planeOffsets[3];
+
 }; // Video
 
 } // graphics
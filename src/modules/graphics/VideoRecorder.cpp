@@ -0,0 +1,324 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "VideoRecorder.h"
+#include "Graphics.h"
+#include "Texture.h"
+#include "Buffer.h"
+#include "Shader.h"
+#include "image/ImageData.h"
+
+namespace love
+{
+namespace graphics
+{
+
+// Frames which are waiting on the GPU or the encoding thread. Past this,
+// frames are dropped instead of stalling the game.
+static const int MAX_QUEUED_FRAMES = 16;
+
+// Converts an 8x2 block of pixels per thread, so every thread writes whole
+// words: four luma words (two per row) and one word each for Cb and Cr.
+static const char conversionShaderCode[] = R"(
+#pragma language glsl4
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D love_RecorderSource;
+writeonly buffer love_RecorderOutput { uint love_RecorderYUV[]; };
+
+uniform ivec4 love_RecorderParams; // x: width, y: height, z: sRGB source
+
+void computemain()
+{
+	int w = love_RecorderParams.x;
+	int h = love_RecorderParams.y;
+	ivec2 block = ivec2(love_GlobalThreadID.xy);
+
+	if (block.x * 8 >= w || block.y * 2 >= h)
+		return;
+
+	ivec2 origin = block * ivec2(8, 2);
+
+	uint luma[4] = uint[4](0u, 0u, 0u, 0u);
+	vec3 chroma[4] = vec3[4](vec3(0.0), vec3(0.0), vec3(0.0), vec3(0.0));
+
+	for (int row = 0; row < 2; row++)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			vec3 c = clamp(texelFetch(love_RecorderSource, origin + ivec2(i, row), 0).rgb, 0.0, 1.0);
+			if (love_RecorderParams.z != 0)
+				c = linearToGammaPrecise(c);
+
+			// BT.601 limited range.
+			uint y = uint(16.0 + dot(c, vec3(65.481, 128.553, 24.966)) + 0.5);
+			luma[row * 2 + i / 4] |= y << uint(8 * (i % 4));
+			chroma[i / 2] += c * 0.25;
+		}
+	}
+
+	uint cb = 0u;
+	uint cr = 0u;
+	for (int i = 0; i < 4; i++)
+	{
+		cb |= uint(128.0 + dot(chroma[i], vec3(-37.797, -74.203, 112.0)) + 0.5) << uint(8 * i);
+		cr |= uint(128.0 + dot(chroma[i], vec3(112.0, -93.786, -18.214)) + 0.5) << uint(8 * i);
+	}
+
+	int rowwords = w / 4;
+	int yindex = origin.y * rowwords + block.x * 2;
+	love_RecorderYUV[yindex + 0] = luma[0];
+	love_RecorderYUV[yindex + 1] = luma[1];
+	love_RecorderYUV[yindex + rowwords + 0] = luma[2];
+	love_RecorderYUV[yindex + rowwords + 1] = luma[3];
+
+	int chromawords = (w / 2) * (h / 2) / 4;
+	int cindex = w * h / 4 + block.y * (w / 8) + block.x;
+	love_RecorderYUV[cindex] = cb;
+	love_RecorderYUV[cindex + chromawords] = cr;
+}
+)";
+
+struct VideoRecorderScreenshot
+{
+	static void callback(const Graphics::ScreenshotInfo *info, love::image::ImageData *i, void */*gd*/)
+	{
+		if (info == nullptr)
+			return;
+
+		auto recorder = (VideoRecorder *) info->data;
+
+		if (recorder->recording && i != nullptr && i->getWidth() == recorder->width && i->getHeight() == recorder->height
+			&& getLinearPixelFormat(i->getFormat()) == PIXELFORMAT_RGBA8_UNORM)
+		{
+			VideoRecorder::PendingFrame frame;
+			frame.data.set(i);
+			frame.format = love::video::Y4MEncoder::FRAME_RGBA8;
+			recorder->pendingFrames.push_back(frame);
+		}
+		else if (recorder->recording)
+			recorder->droppedFrames++;
+
+		// Retained in captureBackbufferFrame.
+		recorder->release();
+	}
+};
+
+love::Type VideoRecorder::type("VideoRecorder", &Object::type);
+
+VideoRecorder::VideoRecorder(Graphics *gfx, love::filesystem::File *file, int width, int height, int fpsNumerator, int fpsDenominator)
+	: width(width)
+	, height(height)
+	, recording(true)
+	, capturedFrames(0)
+	, droppedFrames(0)
+{
+	encoder.set(new love::video::Y4MEncoder(file, width, height, fpsNumerator, fpsDenominator), Acquire::NORETAIN);
+
+	// The conversion shader writes whole words, which needs the dimensions to
+	// line up with its 8x2 pixel blocks. Otherwise frames are converted on the
+	// encoding thread instead.
+	const auto &caps = gfx->getCapabilities();
+	if (caps.features[Graphics::FEATURE_GLSL4] && width % 8 == 0 && height % 2 == 0)
+	{
+		Shader::CompileOptions options;
+		options.debugName = "VideoRecorder";
+
+		conversionShader.set(gfx->newComputeShader(conversionShaderCode, options), Acquire::NORETAIN);
+
+		size_t size = love::video::Y4MEncoder::getFrameSize(width, height, love::video::Y4MEncoder::FRAME_YUV420);
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+		settings.debugName = "VideoRecorder frame";
+		conversionBuffer.set(gfx->newBuffer(settings, DATAFORMAT_UINT32, nullptr, size, 0), Acquire::NORETAIN);
+	}
+}
+
+VideoRecorder::~VideoRecorder()
+{
+	stop();
+}
+
+int64 VideoRecorder::getWrittenFrameCount() const
+{
+	return encoder->getWrittenFrameCount();
+}
+
+bool VideoRecorder::reserveFrame()
+{
+	if (!recording)
+		throw love::Exception("Cannot capture frames after the VideoRecorder has been stopped.");
+
+	std::string err;
+	if (encoder->getError(err))
+		throw love::Exception("%s", err.c_str());
+
+	update();
+
+	capturedFrames++;
+
+	if ((int) pendingFrames.size() + encoder->getQueuedFrameCount() >= MAX_QUEUED_FRAMES)
+	{
+		droppedFrames++;
+		return false;
+	}
+
+	return true;
+}
+
+void VideoRecorder::captureFrame(Texture *source)
+{
+	if (source->getTextureType() != TEXTURE_2D)
+		throw love::Exception("VideoRecorder can only capture 2D textures.");
+
+	if (source->getPixelWidth() != width || source->getPixelHeight() != height)
+		throw love::Exception("Texture dimensions (%dx%d) must match the VideoRecorder's dimensions (%dx%d).", source->getPixelWidth(), source->getPixelHeight(), width, height);
+
+	if (!source->isReadable() || isPixelFormatDepthStencil(source->getPixelFormat()))
+		throw love::Exception("VideoRecorder can only capture readable color textures.");
+
+	bool gpuconvert = conversionShader.get() != nullptr;
+
+	if (!gpuconvert && getLinearPixelFormat(source->getPixelFormat()) != PIXELFORMAT_RGBA8_UNORM)
+		throw love::Exception("VideoRecorder can only capture rgba8 textures on this system.");
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	if (gfx->isRenderTargetActive(source))
+		throw love::Exception("Cannot capture a texture while it's an active render target.");
+
+	if (!reserveFrame())
+		return;
+
+	PendingFrame frame;
+
+	if (gpuconvert)
+	{
+		frame.format = love::video::Y4MEncoder::FRAME_YUV420;
+		size_t size = love::video::Y4MEncoder::getFrameSize(width, height, frame.format);
+
+		int params[4] = {width, height, isPixelFormatSRGB(source->getPixelFormat()) ? 1 : 0, 0};
+
+		const Shader::UniformInfo *info = conversionShader->getUniformInfo("love_RecorderParams");
+		if (info != nullptr)
+		{
+			memcpy(info->data, params, std::min(sizeof(params), info->dataSize));
+			conversionShader->updateUniform(info, info->count);
+		}
+
+		info = conversionShader->getUniformInfo("love_RecorderSource");
+		if (info != nullptr)
+			conversionShader->sendTextures(info, &source, 1);
+
+		Buffer *buffer = conversionBuffer;
+		info = conversionShader->getUniformInfo("love_RecorderOutput");
+		if (info != nullptr)
+			conversionShader->sendBuffers(info, &buffer, 1);
+
+		gfx->dispatchThreadgroups(conversionShader, (width / 8 + 7) / 8, (height / 2 + 7) / 8, 1);
+
+		frame.data.set(encoder->getFrameData(size), Acquire::NORETAIN);
+		frame.readback.set(gfx->readbackBufferAsync(conversionBuffer, 0, size, (love::data::ByteData *) frame.data.get(), 0), Acquire::NORETAIN);
+	}
+	else
+	{
+		frame.format = love::video::Y4MEncoder::FRAME_RGBA8;
+		size_t size = love::video::Y4MEncoder::getFrameSize(width, height, frame.format);
+
+		Rect rect = {0, 0, width, height};
+
+		frame.data.set(encoder->getFrameData(size), Acquire::NORETAIN);
+		frame.readback.set(gfx->readbackTextureAsync(source, 0, 0, rect, nullptr, 0, 0, (love::data::ByteData *) frame.data.get(), 0), Acquire::NORETAIN);
+	}
+
+	pendingFrames.push_back(frame);
+}
+
+void VideoRecorder::captureBackbufferFrame()
+{
+	if (!reserveFrame())
+		return;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	Graphics::ScreenshotInfo info;
+	info.callback = VideoRecorderScreenshot::callback;
+	info.data = this;
+
+	// Released in the callback.
+	retain();
+	gfx->captureScreenshot(info);
+}
+
+void VideoRecorder::update()
+{
+	flushFrames(false);
+}
+
+void VideoRecorder::flushFrames(bool wait)
+{
+	// Frames are handed over in capture order, so a finished readback waits
+	// for the ones before it.
+	size_t count = 0;
+
+	for (; count < pendingFrames.size(); count++)
+	{
+		PendingFrame &frame = pendingFrames[count];
+
+		if (frame.readback.get() != nullptr)
+		{
+			if (wait)
+				frame.readback->wait();
+			else
+				frame.readback->update();
+
+			if (!frame.readback->isComplete())
+				break;
+
+			if (frame.readback->hasError())
+			{
+				droppedFrames++;
+				continue;
+			}
+		}
+
+		encoder->addFrame(frame.data, 0, frame.format);
+	}
+
+	pendingFrames.erase(pendingFrames.begin(), pendingFrames.begin() + count);
+}
+
+void VideoRecorder::stop()
+{
+	if (!recording)
+		return;
+
+	flushFrames(true);
+
+	recording = false;
+	pendingFrames.clear();
+
+	encoder->finish();
+}
+
+} // graphics
+} // love
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "video/Y4MEncoder.h"
+#include "filesystem/File.h"
+#include "GraphicsReadback.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+class Texture;
+class Buffer;
+class Shader;
+struct VideoRecorderScreenshot;
+
+/**
+ * Records a Canvas or the backbuffer to a video file, one frame per capture
+ * call. Canvas frames are converted to YUV 4:2:0 by a compute shader when
+ * possible, and read back asynchronously straight into the frame data which
+ * is handed to the encoding thread, so the main thread never waits on the
+ * GPU or touches the pixels.
+ **/
+class VideoRecorder : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	VideoRecorder(Graphics *gfx, love::filesystem::File *file, int width, int height, int fpsNumerator, int fpsDenominator);
+	virtual ~VideoRecorder();
+
+	/**
+	 * Queues a frame using the contents of the given Canvas.
+	 **/
+	void captureFrame(Texture *source);
+
+	/**
+	 * Queues a frame using the backbuffer's contents at the end of the
+	 * current frame (in love.graphics.present).
+	 **/
+	void captureBackbufferFrame();
+
+	/**
+	 * Hands any frames whose readbacks have finished to the encoder.
+	 **/
+	void update();
+
+	/**
+	 * Waits for all queued frames to be written and closes the file.
+	 **/
+	void stop();
+
+	bool isRecording() const { return recording; }
+	bool isGPUConversionUsed() const { return conversionShader.get() != nullptr; }
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	int64 getCapturedFrameCount() const { return capturedFrames; }
+	int64 getDroppedFrameCount() const { return droppedFrames; }
+	int64 getWrittenFrameCount() const;
+
+private:
+
+	struct PendingFrame
+	{
+		StrongRef<GraphicsReadback> readback;
+		StrongRef<love::Data> data;
+		love::video::Y4MEncoder::FrameFormat format;
+	};
+
+	friend struct VideoRecorderScreenshot;
+
+	bool reserveFrame();
+	void flushFrames(bool wait);
+
+	StrongRef<love::video::Y4MEncoder> encoder;
+
+	StrongRef<Shader> conversionShader;
+	StrongRef<Buffer> conversionBuffer;
+
+	std::vector<PendingFrame> pendingFrames;
+
+	int width;
+	int height;
+
+	bool recording;
+
+	int64 capturedFrames;
+	int64 droppedFrames;
+
+}; // VideoRecorder
+
+} // graphics
+} // love
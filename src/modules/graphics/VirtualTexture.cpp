@@ -0,0 +1,386 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "VirtualTexture.h"
+#include "Graphics.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type VirtualTexture::type("VirtualTexture", &Drawable::type);
+
+VirtualTexture::VirtualTexture(Graphics *gfx, int width, int height, int pageSize, int cacheSize, PixelFormat format, bool linear)
+	: width(width)
+	, height(height)
+	, pageSize(pageSize)
+	, mipmapCount(1)
+	, drawCounter(0)
+{
+	if (width <= 0 || height <= 0)
+		throw love::Exception("VirtualTexture dimensions must be greater than 0.");
+
+	if (pageSize <= 0)
+		throw love::Exception("VirtualTexture page size must be greater than 0.");
+
+	if (cacheSize <= 0)
+		throw love::Exception("VirtualTexture page cache size must be greater than 0.");
+
+	// The coarsest mipmap level is the first one that fits in a single page.
+	int64 span = pageSize;
+	while (span < std::max(width, height))
+	{
+		span *= 2;
+		mipmapCount++;
+	}
+
+	Texture::Settings settings;
+	settings.type = TEXTURE_2D_ARRAY;
+	settings.width = pageSize;
+	settings.height = pageSize;
+	settings.layers = cacheSize;
+	settings.format = format;
+	settings.linear = linear;
+	settings.debugName = "VirtualTexture page cache";
+
+	cache.set(gfx->newTexture(settings, nullptr), Acquire::NORETAIN);
+
+	slots.resize(cacheSize);
+	for (Slot &slot : slots)
+	{
+		slot.key = 0;
+		slot.lastUsed = 0;
+		slot.occupied = false;
+	}
+}
+
+VirtualTexture::~VirtualTexture()
+{
+}
+
+int VirtualTexture::getPageCountX(int mipmap) const
+{
+	int64 span = (int64) pageSize << mipmap;
+	return (int) ((width + span - 1) / span);
+}
+
+int VirtualTexture::getPageCountY(int mipmap) const
+{
+	int64 span = (int64) pageSize << mipmap;
+	return (int) ((height + span - 1) / span);
+}
+
+void VirtualTexture::validatePage(const Page &page) const
+{
+	if (page.mipmap < 0 || page.mipmap >= mipmapCount)
+		throw love::Exception("Invalid VirtualTexture mipmap level: %d (VirtualTexture has %d mipmap levels)", page.mipmap + 1, mipmapCount);
+
+	int countx = getPageCountX(page.mipmap);
+	int county = getPageCountY(page.mipmap);
+
+	if (page.x < 0 || page.x >= countx || page.y < 0 || page.y >= county)
+		throw love::Exception("Invalid VirtualTexture page (%d, %d) at mipmap level %d (the level has %dx%d pages)", page.x, page.y, page.mipmap + 1, countx, county);
+}
+
+int VirtualTexture::setPage(const Page &page, love::image::ImageData *data)
+{
+	validatePage(page);
+
+	if (data->getWidth() != pageSize || data->getHeight() != pageSize)
+		throw love::Exception("VirtualTexture page data dimensions (%dx%d) must match the page size (%d).", data->getWidth(), data->getHeight(), pageSize);
+
+	uint64 key = getKey(page.mipmap, page.x, page.y);
+	int slotindex = -1;
+
+	auto it = residentPages.find(key);
+	if (it != residentPages.end())
+		slotindex = it->second;
+
+	// Pick a free slot, or else the least recently drawn page. The coarsest
+	// level is the fallback for every other page, so it's only evicted when
+	// nothing else is available.
+	for (int i = 0; slotindex < 0 && i < (int) slots.size(); i++)
+	{
+		if (!slots[i].occupied)
+			slotindex = i;
+	}
+
+	if (slotindex < 0)
+	{
+		int oldest = -1;
+		int oldestany = 0;
+
+		for (int i = 0; i < (int) slots.size(); i++)
+		{
+			const Slot &slot = slots[i];
+
+			if (slot.lastUsed < slots[oldestany].lastUsed)
+				oldestany = i;
+
+			if (getPage(slot.key).mipmap == mipmapCount - 1)
+				continue;
+
+			if (oldest < 0 || slot.lastUsed < slots[oldest].lastUsed)
+				oldest = i;
+		}
+
+		slotindex = oldest >= 0 ? oldest : oldestany;
+	}
+
+	// Upload before touching any bookkeeping, in case it throws.
+	cache->replacePixels(data, slotindex, 0, 0, 0, false);
+
+	Slot &slot = slots[slotindex];
+	if (slot.occupied && slot.key != key)
+		residentPages.erase(slot.key);
+
+	slot.key = key;
+	slot.lastUsed = drawCounter;
+	slot.occupied = true;
+
+	residentPages[key] = slotindex;
+	requested.erase(key);
+
+	return slotindex;
+}
+
+bool VirtualTexture::hasPage(const Page &page) const
+{
+	validatePage(page);
+	return residentPages.find(getKey(page.mipmap, page.x, page.y)) != residentPages.end();
+}
+
+bool VirtualTexture::evictPage(const Page &page)
+{
+	validatePage(page);
+
+	auto it = residentPages.find(getKey(page.mipmap, page.x, page.y));
+	if (it == residentPages.end())
+		return false;
+
+	slots[it->second].occupied = false;
+	residentPages.erase(it);
+	return true;
+}
+
+void VirtualTexture::clearPages()
+{
+	for (Slot &slot : slots)
+		slot.occupied = false;
+
+	residentPages.clear();
+	requests.clear();
+	requested.clear();
+}
+
+void VirtualTexture::getPageRequests(std::vector<Page> &outrequests)
+{
+	outrequests.clear();
+
+	for (uint64 key : requests)
+	{
+		if (requested.find(key) != requested.end())
+			outrequests.push_back(getPage(key));
+	}
+
+	requests.clear();
+	requested.clear();
+
+	std::stable_sort(outrequests.begin(), outrequests.end(), [](const Page &a, const Page &b)
+	{
+		return a.mipmap > b.mipmap;
+	});
+}
+
+void VirtualTexture::addRequest(uint64 key)
+{
+	if (requested.find(key) != requested.end())
+		return;
+
+	requested[key] = true;
+	requests.push_back(key);
+}
+
+int VirtualTexture::findResident(int mipmap, int x, int y, int &residentmip) const
+{
+	for (int mip = mipmap; mip < mipmapCount; mip++)
+	{
+		int shift = mip - mipmap;
+		auto it = residentPages.find(getKey(mip, x >> shift, y >> shift));
+		if (it != residentPages.end())
+		{
+			residentmip = mip;
+			return it->second;
+		}
+	}
+
+	return -1;
+}
+
+void VirtualTexture::setSamplerState(const SamplerState &s)
+{
+	cache->setSamplerState(s);
+}
+
+const SamplerState &VirtualTexture::getSamplerState() const
+{
+	return cache->getSamplerState();
+}
+
+void VirtualTexture::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (!cache->isReadable())
+		throw love::Exception("VirtualTextures with non-readable formats cannot be drawn.");
+
+	Matrix4 t = gfx->getCombinedTransform(m);
+
+	// Page selection works on the texture's screen-space footprint, which
+	// is only well-defined for 2D transforms.
+	if (!t.isAffine2DTransform())
+		throw love::Exception("VirtualTextures can only be drawn with 2D transforms.");
+
+	drawCounter++;
+
+	const float *e = t.getElements();
+	float pixelscale = sqrtf(fabsf(e[0] * e[5] - e[1] * e[4])) * (float) gfx->getCurrentDPIScale();
+
+	if (pixelscale <= 0.0f)
+		return;
+
+	int mipmap = (int) floorf(log2f(1.0f / pixelscale));
+	mipmap = std::min(std::max(mipmap, 0), mipmapCount - 1);
+
+	// Visible area, in the same units as the transform.
+	Rect view = gfx->getVisibleArea();
+
+	if (view.w <= 0 || view.h <= 0)
+		return;
+
+	const Vector2 viewcorners[4] =
+	{
+		Vector2((float) view.x, (float) view.y),
+		Vector2((float) view.x, (float) (view.y + view.h)),
+		Vector2((float) (view.x + view.w), (float) view.y),
+		Vector2((float) (view.x + view.w), (float) (view.y + view.h)),
+	};
+
+	Vector2 localcorners[4];
+	t.inverse().transformXY(localcorners, viewcorners, 4);
+
+	float minx = localcorners[0].x, maxx = localcorners[0].x;
+	float miny = localcorners[0].y, maxy = localcorners[0].y;
+	for (int i = 1; i < 4; i++)
+	{
+		minx = std::min(minx, localcorners[i].x);
+		maxx = std::max(maxx, localcorners[i].x);
+		miny = std::min(miny, localcorners[i].y);
+		maxy = std::max(maxy, localcorners[i].y);
+	}
+
+	minx = std::max(minx, 0.0f);
+	miny = std::max(miny, 0.0f);
+	maxx = std::min(maxx, (float) width);
+	maxy = std::min(maxy, (float) height);
+
+	if (minx >= maxx || miny >= maxy)
+		return;
+
+	float span = (float) ((int64) pageSize << mipmap);
+
+	int px1 = (int) (minx / span);
+	int py1 = (int) (miny / span);
+	int px2 = std::min((int) ceilf(maxx / span), getPageCountX(mipmap));
+	int py2 = std::min((int) ceilf(maxy / span), getPageCountY(mipmap));
+
+	Color32 c = toColor32(gfx->getColor());
+
+	Graphics::BatchedDrawCommand cmd;
+	cmd.formats[0] = CommonFormat::XYf;
+	cmd.formats[1] = CommonFormat::STPf_RGBAub;
+	cmd.indexMode = TRIANGLEINDEX_QUADS;
+	cmd.vertexCount = 4;
+	cmd.texture = cache;
+	cmd.standardShaderType = Shader::STANDARD_ARRAY;
+
+	for (int py = py1; py < py2; py++)
+	{
+		for (int px = px1; px < px2; px++)
+		{
+			int residentmip = mipmap;
+			int slotindex = findResident(mipmap, px, py, residentmip);
+
+			if (residentmip != mipmap || slotindex < 0)
+				addRequest(getKey(mipmap, px, py));
+
+			if (slotindex < 0)
+			{
+				// Nothing covers this area yet. The coarsest page is what
+				// will eventually, so make sure it gets streamed in first.
+				addRequest(getKey(mipmapCount - 1, 0, 0));
+				continue;
+			}
+
+			slots[slotindex].lastUsed = drawCounter;
+
+			// Region of the virtual texture covered by this page, and the
+			// origin and size of the (possibly coarser) page drawn there.
+			float x1 = px * span;
+			float y1 = py * span;
+			float x2 = std::min(x1 + span, (float) width);
+			float y2 = std::min(y1 + span, (float) height);
+
+			int shift = residentmip - mipmap;
+			float rspan = span * (float) (1 << shift);
+			float rx = (px >> shift) * rspan;
+			float ry = (py >> shift) * rspan;
+
+			const Vector2 positions[4] =
+			{
+				Vector2(x1, y1),
+				Vector2(x1, y2),
+				Vector2(x2, y1),
+				Vector2(x2, y2),
+			};
+
+			Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+
+			t.transformXY((Vector2 *) data.stream[0], positions, 4);
+
+			STPf_RGBAub *vertexdata = (STPf_RGBAub *) data.stream[1];
+
+			for (int i = 0; i < 4; i++)
+			{
+				vertexdata[i].s = (positions[i].x - rx) / rspan;
+				vertexdata[i].t = (positions[i].y - ry) / rspan;
+				vertexdata[i].p = (float) slotindex;
+				vertexdata[i].color = c;
+			}
+		}
+	}
+}
+
+} // graphics
+} // love
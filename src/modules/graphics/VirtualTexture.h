@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "common/math.h"
+#include "common/Matrix.h"
+#include "Drawable.h"
+#include "Texture.h"
+#include "image/ImageData.h"
+
+// C++
+#include <vector>
+#include <unordered_map>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A very large 2D texture which is never fully resident in memory. It's
+ * split into fixed-size pages (at every mipmap level of the full texture),
+ * and only the pages that are actually visible are kept in a page cache,
+ * which is a single Array Texture where each layer holds one page.
+ *
+ * Every draw figures out which pages it needs at the mipmap level matching
+ * the current screen-space scale. Missing pages fall back to the closest
+ * resident coarser page and are added to a request list, which the game
+ * fulfills by loading the page's pixels (e.g. on another thread) and calling
+ * setPage. Least-recently-drawn pages are evicted when the cache is full.
+ **/
+class VirtualTexture : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	struct Page
+	{
+		int mipmap;
+		int x;
+		int y;
+	};
+
+	VirtualTexture(Graphics *gfx, int width, int height, int pageSize, int cacheSize, PixelFormat format, bool linear);
+	virtual ~VirtualTexture();
+
+	// Drawable
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+	/**
+	 * Copies the given ImageData into the page cache, evicting the least
+	 * recently used page if the cache is full. Returns the replaced page's
+	 * cache slot.
+	 **/
+	int setPage(const Page &page, love::image::ImageData *data);
+	bool hasPage(const Page &page) const;
+	bool evictPage(const Page &page);
+	void clearPages();
+
+	/**
+	 * Gets (and clears) the list of pages which were needed by draws since
+	 * the last call, but weren't resident. Coarser mipmap levels come first,
+	 * since they're used as fallbacks for finer levels.
+	 **/
+	void getPageRequests(std::vector<Page> &requests);
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	int getPageSize() const { return pageSize; }
+	int getCacheSize() const { return (int) slots.size(); }
+	int getResidentPageCount() const { return (int) residentPages.size(); }
+	int getMipmapCount() const { return mipmapCount; }
+	int getPageCountX(int mipmap) const;
+	int getPageCountY(int mipmap) const;
+
+	Texture *getCacheTexture() const { return cache; }
+
+	void setSamplerState(const SamplerState &s);
+	const SamplerState &getSamplerState() const;
+
+private:
+
+	struct Slot
+	{
+		uint64 key;
+		uint64 lastUsed;
+		bool occupied;
+	};
+
+	static uint64 getKey(int mipmap, int x, int y)
+	{
+		return ((uint64) mipmap << 48) | ((uint64) (uint32) y << 24) | (uint64) (uint32) x;
+	}
+
+	static Page getPage(uint64 key)
+	{
+		return { (int) (key >> 48), (int) (key & 0xFFFFFF), (int) ((key >> 24) & 0xFFFFFF) };
+	}
+
+	void validatePage(const Page &page) const;
+	int findResident(int mipmap, int x, int y, int &residentmip) const;
+	void addRequest(uint64 key);
+
+	StrongRef<Texture> cache;
+
+	int width;
+	int height;
+	int pageSize;
+	int mipmapCount;
+
+	std::vector<Slot> slots;
+	std::unordered_map<uint64, int> residentPages;
+
+	std::vector<uint64> requests;
+	std::unordered_map<uint64, bool> requested;
+
+	uint64 drawCounter;
+
+}; // VirtualTexture
+
+} // graphics
+} // love
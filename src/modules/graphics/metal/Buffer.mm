@@ -114,12 +114,27 @@ Buffer::Buffer(love::graphics::Graphics *gfx, id<MTLDevice> device, const Settin
 			throw love::Exception("Could not create Metal texel buffer.");
 	}
 
-	if (data != nullptr)
-		fill(0, size, data);
+	// Nothing can be using the new buffer yet, so its initial contents don't
+	// need to interrupt the active render pass.
+	if (data != nullptr && buffer.storageMode == MTLStorageModeShared)
+	{
+		memcpy(buffer.contents, data, getSize());
+		frameBytesUploaded += getSize();
+	}
+	else if (data != nullptr)
+	{
+		auto *mgfx = (Graphics *) gfx;
+		id<MTLBuffer> staging = [device newBufferWithBytes:data length:getSize() options:MTLResourceStorageModeShared];
+		if (staging == nil)
+			throw love::Exception("Could not create buffer with %d bytes (out of VRAM?)", getSize());
+
+		[mgfx->useInitBlitEncoder() copyFromBuffer:staging sourceOffset:0 toBuffer:buffer destinationOffset:0 size:getSize()];
+		frameBytesUploaded += getSize();
+	}
 	else if (settings.zeroInitialize)
 	{
 		auto *mgfx = (Graphics *) gfx;
-		auto encoder = mgfx->useBlitEncoder();
+		auto encoder = mgfx->useInitBlitEncoder();
 
 		size_t clearsize = size;
 
@@ -219,6 +234,8 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 	memcpy(dest, data, size);
 
 	unmap(offset, size);
+
+	frameBytesUploaded += size;
 	return true;
 }}
 
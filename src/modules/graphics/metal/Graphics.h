@@ -131,6 +131,16 @@ public:
 	id<MTLComputeCommandEncoder> getComputeEncoder() const { return computeEncoder; }
 	void submitComputeEncoder();
 
+	/**
+	 * Work which initializes newly created resources is recorded in its own
+	 * command buffer, committed before the main one. Nothing recorded so far
+	 * can use those resources, so it doesn't need to interrupt the active
+	 * render pass like useBlitEncoder does.
+	 **/
+	id<MTLCommandBuffer> useInitCommandBuffer();
+	id<MTLBlitCommandEncoder> useInitBlitEncoder();
+	void submitInitCommandBuffer();
+
 	id<MTLSamplerState> getCachedSampler(const SamplerState &s);
 
 	bool isDepthCompareSamplerSupported() const;
@@ -198,7 +208,8 @@ private:
 	love::graphics::StreamBuffer *newStreamBuffer(BufferUsage usage, size_t size) override;
 
 	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) override;
-	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty) override;
+	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset) override;
+	love::graphics::TextureUpload *newTextureUploadInternal(love::graphics::Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps) override;
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBcanvas) override;
 	void initCapabilities() override;
@@ -220,7 +231,11 @@ private:
 	id<MTLBlitCommandEncoder> blitEncoder;
 	id<MTLComputeCommandEncoder> computeEncoder;
 
+	id<MTLCommandBuffer> initCommandBuffer;
+	id<MTLBlitCommandEncoder> initBlitEncoder;
+
 	CAMetalLayer *metalLayer;
+	bool ownsMetalLayer;
 	id<CAMetalDrawable> activeDrawable;
 	MTLRenderPassDescriptor *passDesc;
 
@@ -242,6 +257,11 @@ private:
 	size_t uniformBufferOffset;
 	size_t uniformBufferGPUStart;
 
+	// The last uniform data uploaded for a draw, which later draws with the
+	// same uniform values can reuse. A size of 0 means there's none.
+	size_t lastUniformSize;
+	size_t lastUniformOffset;
+
 	Buffer *defaultAttributesBuffer;
 
 	std::map<uint64, void *> cachedSamplers;
@@ -249,6 +269,9 @@ private:
 
 	std::vector<id<MTLCommandBuffer>> activeCommandBuffers;
 
+	id<MTLCommandBuffer> frameLatencyCommandBuffers[MAX_FRAME_LATENCY];
+	int frameLatencyIndex = 0;
+
 	DeviceFamilies families;
 
 	bool isVMDevice;
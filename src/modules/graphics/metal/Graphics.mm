@@ -23,10 +23,12 @@
 #include "Buffer.h"
 #include "Texture.h"
 #include "GraphicsReadback.h"
+#include "TextureUpload.h"
 #include "Shader.h"
 #include "ShaderStage.h"
 #include "window/Window.h"
 #include "image/Image.h"
+#include "profiler/Profiler.h"
 #include "common/memory.h"
 
 #import <QuartzCore/CAMetalLayer.h>
@@ -187,44 +189,70 @@ static inline void setBuffer(id<MTLComputeCommandEncoder> encoder, Graphics::Ren
 	}
 }
 
-static inline void setTexture(id<MTLRenderCommandEncoder> encoder, Graphics::RenderEncoderBindings &bindings, ShaderStageType stage, int index, id<MTLTexture> texture)
+static inline void setTexture(id<MTLComputeCommandEncoder> encoder, Graphics::RenderEncoderBindings &bindings, int index, id<MTLTexture> texture)
 {
 	void *t = (__bridge void *)texture;
-	auto &binding = bindings.textures[index][stage];
+	auto &binding = bindings.textures[index][SHADERSTAGE_COMPUTE];
 	if (binding != t)
 	{
 		binding = t;
-		if (stage == SHADERSTAGE_VERTEX)
-			[encoder setVertexTexture:texture atIndex:index];
-		else if (stage == SHADERSTAGE_PIXEL)
-			[encoder setFragmentTexture:texture atIndex:index];
+		[encoder setTexture:texture atIndex:index];
 	}
 }
 
-static inline void setTexture(id<MTLComputeCommandEncoder> encoder, Graphics::RenderEncoderBindings &bindings, int index, id<MTLTexture> texture)
+// Calls func(first, count) for each run of consecutive set bits.
+template <typename F>
+static inline void forEachBitRange(uint32 bits, F func)
 {
-	void *t = (__bridge void *)texture;
-	auto &binding = bindings.textures[index][SHADERSTAGE_COMPUTE];
-	if (binding != t)
+	int index = 0;
+	while (bits != 0)
 	{
-		binding = t;
-		[encoder setTexture:texture atIndex:index];
+		if ((bits & 1) == 0)
+		{
+			bits >>= 1;
+			index++;
+			continue;
+		}
+
+		int first = index;
+		while ((bits & 1) != 0)
+		{
+			bits >>= 1;
+			index++;
+		}
+
+		func(first, index - first);
 	}
 }
 
-static inline void setSampler(id<MTLRenderCommandEncoder> encoder, Graphics::RenderEncoderBindings &bindings, ShaderStageType stage, int index, love::graphics::Texture *samplertex)
+static void setTextureRanges(id<MTLRenderCommandEncoder> encoder, const Graphics::RenderEncoderBindings &bindings, ShaderStageType stage, uint32 changed)
 {
-	void *s = samplertex != nullptr ? (void *)samplertex->getSamplerHandle() : nullptr;
-	auto &binding = bindings.samplers[index][stage];
-	if (binding != s)
+	forEachBitRange(changed, [&](int first, int count)
 	{
-		binding = s;
-		id<MTLSamplerState> sampler = (__bridge id<MTLSamplerState>) s;
+		__unsafe_unretained id<MTLTexture> textures[32];
+		for (int i = 0; i < count; i++)
+			textures[i] = (__bridge id<MTLTexture>) bindings.textures[first + i][stage];
+
 		if (stage == SHADERSTAGE_VERTEX)
-			[encoder setVertexSamplerState:sampler atIndex:index];
+			[encoder setVertexTextures:textures withRange:NSMakeRange(first, count)];
 		else if (stage == SHADERSTAGE_PIXEL)
-			[encoder setFragmentSamplerState:sampler atIndex:index];
-	}
+			[encoder setFragmentTextures:textures withRange:NSMakeRange(first, count)];
+	});
+}
+
+static void setSamplerRanges(id<MTLRenderCommandEncoder> encoder, const Graphics::RenderEncoderBindings &bindings, ShaderStageType stage, uint32 changed)
+{
+	forEachBitRange(changed, [&](int first, int count)
+	{
+		__unsafe_unretained id<MTLSamplerState> samplers[32];
+		for (int i = 0; i < count; i++)
+			samplers[i] = (__bridge id<MTLSamplerState>) bindings.samplers[first + i][stage];
+
+		if (stage == SHADERSTAGE_VERTEX)
+			[encoder setVertexSamplerStates:samplers withRange:NSMakeRange(first, count)];
+		else if (stage == SHADERSTAGE_PIXEL)
+			[encoder setFragmentSamplerStates:samplers withRange:NSMakeRange(first, count)];
+	});
 }
 
 static inline void setSampler(id<MTLComputeCommandEncoder> encoder, Graphics::RenderEncoderBindings &bindings, int index, love::graphics::Texture *samplertex)
@@ -271,7 +299,10 @@ Graphics::Graphics()
 	, commandBuffer(nil)
 	, renderEncoder(nil)
 	, blitEncoder(nil)
+	, initCommandBuffer(nil)
+	, initBlitEncoder(nil)
 	, metalLayer(nil)
+	, ownsMetalLayer(false)
 	, activeDrawable(nil)
 	, passDesc(nil)
 	, dirtyRenderState(STATEBIT_ALL)
@@ -283,6 +314,8 @@ Graphics::Graphics()
 	, renderBindings()
 	, uniformBufferOffset(0)
 	, uniformBufferGPUStart(0)
+	, lastUniformSize(0)
+	, lastUniformOffset(0)
 	, defaultAttributesBuffer(nullptr)
 	, families()
 	, isVMDevice(false)
@@ -481,9 +514,14 @@ love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod m
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
 }
 
-love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset)
 {
-	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty);
+	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty, destbytes, destbytesoffset);
+}
+
+love::graphics::TextureUpload *Graphics::newTextureUploadInternal(love::graphics::Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	return new TextureUpload(this, texture, data, slice, mipmap, x, y, reloadmipmaps);
 }
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
@@ -503,6 +541,10 @@ void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixe
 	this->backbufferHasDepth = backbufferdepth;
 	this->requestedBackbufferMSAA = msaa;
 
+	// Layers of views are resized along with the view.
+	if (ownsMetalLayer && metalLayer != nil)
+		metalLayer.drawableSize = CGSizeMake(pixelwidth, pixelheight);
+
 	if (!isRenderTargetActive())
 	{
 		dirtyRenderState |= STATEBIT_VIEWPORT | STATEBIT_SCISSOR;
@@ -547,7 +589,15 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 { @autoreleasepool {
 	this->width = width;
 	this->height = height;
-	this->metalLayer = (__bridge CAMetalLayer *) context;
+
+	// Headless windows don't have a view to get a layer from. A layer that
+	// isn't displayed still hands out drawables, so rendering and readbacks
+	// work the same way.
+	ownsMetalLayer = context == nullptr;
+	if (ownsMetalLayer)
+		this->metalLayer = [CAMetalLayer layer];
+	else
+		this->metalLayer = (__bridge CAMetalLayer *) context;
 
 	metalLayer.device = device;
 	metalLayer.pixelFormat = isGammaCorrect() ? MTLPixelFormatBGRA8Unorm_sRGB : MTLPixelFormatBGRA8Unorm;
@@ -621,6 +671,7 @@ void Graphics::processCompletedCommandBuffers()
 
 void Graphics::submitCommandBuffer(SubmitType type)
 {
+	submitInitCommandBuffer();
 	submitAllEncoders(type);
 
 	if (commandBuffer != nil)
@@ -637,7 +688,7 @@ void Graphics::submitAllEncoders(SubmitType type)
 	submitComputeEncoder();
 }
 
-static inline void setAttachment(const Graphics::RenderTarget &rt, MTLRenderPassAttachmentDescriptor *desc, MTLStoreAction &storeaction, bool setload = true)
+static inline void setAttachment(const Graphics::RenderTarget &rt, MTLRenderPassAttachmentDescriptor *desc, MTLStoreAction &storeaction, bool setload = true, bool resolve = true)
 {
 	bool isvolume = rt.texture->getTextureType() == TEXTURE_VOLUME;
 
@@ -657,11 +708,16 @@ static inline void setAttachment(const Graphics::RenderTarget &rt, MTLRenderPass
 
 	desc.resolveTexture = nil;
 
-	if (rt.texture->getMSAA() > 1 && rt.texture->isReadable())
+	// The resolve is part of the render pass' store action, so skipping it
+	// just keeps the multisampled contents for a later pass.
+	if (resolve && rt.texture->getMSAA() > 1 && rt.texture->isReadable())
 	{
 		storeaction = MTLStoreActionStoreAndMultisampleResolve;
 		desc.resolveTexture = getMTLTexture(rt.texture);
 	}
+
+	if (rt.texture->isTransient())
+		storeaction = desc.resolveTexture != nil ? MTLStoreActionMultisampleResolve : MTLStoreActionDontCare;
 }
 
 id<MTLRenderCommandEncoder> Graphics::useRenderEncoder()
@@ -746,18 +802,25 @@ void Graphics::submitRenderEncoder(SubmitType type)
 		if (isbackbuffer)
 			[renderEncoder setColorStoreAction:(store ? MTLStoreActionStore : actions.color[0]) atIndex:0];
 
+		// Transient attachments can't be stored, so their contents are lost
+		// even if the render pass is interrupted.
 		for (size_t i = 0; i < rts.colors.size(); i++)
-			[renderEncoder setColorStoreAction:(store ? MTLStoreActionStore : actions.color[i]) atIndex:i];
+		{
+			bool storecolor = store && !rts.colors[i].texture->isTransient();
+			[renderEncoder setColorStoreAction:(storecolor ? MTLStoreActionStore : actions.color[i]) atIndex:i];
+		}
 
 		love::graphics::Texture *ds = rts.depthStencil.texture.get();
 		if (isbackbuffer)
 			ds = backbufferDepthStencil;
 
+		bool storeds = store && (ds == nullptr || !ds->isTransient());
+
 		if ((rts.temporaryRTFlags & TEMPORARY_RT_DEPTH) != 0 || (ds != nullptr && isPixelFormatDepth(ds->getPixelFormat())))
-			[renderEncoder setDepthStoreAction:store ? MTLStoreActionStore : actions.depth];
+			[renderEncoder setDepthStoreAction:storeds ? MTLStoreActionStore : actions.depth];
 
 		if ((rts.temporaryRTFlags & TEMPORARY_RT_STENCIL) != 0 || (ds != nullptr && isPixelFormatStencil(ds->getPixelFormat())))
-			[renderEncoder setStencilStoreAction:store ? MTLStoreActionStore : actions.stencil];
+			[renderEncoder setStencilStoreAction:storeds ? MTLStoreActionStore : actions.stencil];
 
 		[renderEncoder endEncoding];
 		renderEncoder = nil;
@@ -827,6 +890,48 @@ void Graphics::submitComputeEncoder()
 	}
 }
 
+id<MTLCommandBuffer> Graphics::useInitCommandBuffer()
+{
+	if (initBlitEncoder != nil)
+	{
+		[initBlitEncoder endEncoding];
+		initBlitEncoder = nil;
+	}
+
+	if (initCommandBuffer == nil)
+	{
+		initCommandBuffer = [commandQueue commandBuffer];
+		activeCommandBuffers.push_back(initCommandBuffer);
+	}
+
+	return initCommandBuffer;
+}
+
+id<MTLBlitCommandEncoder> Graphics::useInitBlitEncoder()
+{
+	if (initBlitEncoder == nil)
+		initBlitEncoder = [useInitCommandBuffer() blitCommandEncoder];
+
+	return initBlitEncoder;
+}
+
+void Graphics::submitInitCommandBuffer()
+{
+	if (initBlitEncoder != nil)
+	{
+		[initBlitEncoder endEncoding];
+		initBlitEncoder = nil;
+	}
+
+	// Command buffers run in the order they're committed, so this has to
+	// happen before the main command buffer is committed.
+	if (initCommandBuffer != nil)
+	{
+		[initCommandBuffer commit];
+		initCommandBuffer = nil;
+	}
+}
+
 static bool isClampOne(SamplerState::WrapMode w)
 {
 	return w == SamplerState::WRAP_CLAMP_ONE;
@@ -1066,6 +1171,7 @@ bool Graphics::applyShaderUniforms(id<MTLComputeCommandEncoder> encoder, love::g
 		uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_UNIFORM, newsize);
 		uniformBufferData = {};
 		uniformBufferOffset = 0;
+		lastUniformSize = 0;
 	}
 
 	if (uniformBufferData.data == nullptr)
@@ -1075,6 +1181,7 @@ bool Graphics::applyShaderUniforms(id<MTLComputeCommandEncoder> encoder, love::g
 	}
 
 	memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+	Shader::frameUniformBytesUploaded += size;
 
 	id<MTLBuffer> buffer = getMTLBuffer(uniformBuffer);
 	int uniformindex = Shader::getUniformBufferBinding();
@@ -1163,6 +1270,7 @@ void Graphics::applyShaderUniforms(id<MTLRenderCommandEncoder> renderEncoder, lo
 		uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_UNIFORM, newsize);
 		uniformBufferData = {};
 		uniformBufferOffset = 0;
+		lastUniformSize = 0;
 	}
 
 	if (uniformBufferData.data == nullptr)
@@ -1171,43 +1279,70 @@ void Graphics::applyShaderUniforms(id<MTLRenderCommandEncoder> renderEncoder, lo
 		uniformBufferGPUStart = uniformBuffer->getGPUReadOffset();
 	}
 
-	memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+	// Consecutive draws with the same shader often have identical uniform
+	// values (sprites with the same transform and color, for example), so
+	// the data uploaded for the previous draw can be reused.
+	size_t uniformoffset = lastUniformOffset;
+	if (lastUniformSize != size || memcmp(uniformBufferData.data + lastUniformOffset, bufferdata, size) != 0)
+	{
+		memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+		Shader::frameUniformBytesUploaded += size;
+
+		uniformoffset = uniformBufferOffset;
+		uniformBufferOffset += alignUp(size, alignment);
+
+		lastUniformSize = size;
+		lastUniformOffset = uniformoffset;
+	}
 
 	id<MTLBuffer> buffer = getMTLBuffer(uniformBuffer);
 	int uniformindex = Shader::getUniformBufferBinding();
 
 	auto &bindings = renderBindings;
-	setBuffer(renderEncoder, bindings, SHADERSTAGE_VERTEX, uniformindex, buffer, uniformBufferGPUStart + uniformBufferOffset);
-	setBuffer(renderEncoder, bindings, SHADERSTAGE_PIXEL, uniformindex, buffer, uniformBufferGPUStart + uniformBufferOffset);
+	setBuffer(renderEncoder, bindings, SHADERSTAGE_VERTEX, uniformindex, buffer, uniformBufferGPUStart + uniformoffset);
+	setBuffer(renderEncoder, bindings, SHADERSTAGE_PIXEL, uniformindex, buffer, uniformBufferGPUStart + uniformoffset);
 
-	uniformBufferOffset += alignUp(size, alignment);
+	// Textures and samplers which changed are bound in contiguous ranges, to
+	// use fewer encoder calls for shaders with many of them.
+	uint32 changedtextures[SHADERSTAGE_MAX_ENUM] = {};
+	uint32 changedsamplers[SHADERSTAGE_MAX_ENUM] = {};
 
 	for (const Shader::TextureBinding &b : s->getTextureBindings())
 	{
-		id<MTLTexture> texture = b.texture;
+		void *texture = (__bridge void *) b.texture;
 		auto samplertex = b.samplerTexture;
 
 		if (b.isMainTexture)
 		{
-			texture = getMTLTexture(maintex);
+			texture = (__bridge void *) getMTLTexture(maintex);
 			samplertex = maintex;
 		}
 
-		uint8 texindex = b.textureStages[SHADERSTAGE_VERTEX];
-		uint8 sampindex = b.samplerStages[SHADERSTAGE_VERTEX];
+		void *sampler = samplertex != nullptr ? (void *) samplertex->getSamplerHandle() : nullptr;
 
-		if (texindex != LOVE_UINT8_MAX)
-			setTexture(renderEncoder, bindings, SHADERSTAGE_VERTEX, texindex, texture);
-		if (sampindex != LOVE_UINT8_MAX)
-			setSampler(renderEncoder, bindings, SHADERSTAGE_VERTEX, sampindex, samplertex);
+		for (ShaderStageType stage : {SHADERSTAGE_VERTEX, SHADERSTAGE_PIXEL})
+		{
+			uint8 texindex = b.textureStages[stage];
+			uint8 sampindex = b.samplerStages[stage];
 
-		texindex = b.textureStages[SHADERSTAGE_PIXEL];
-		sampindex = b.samplerStages[SHADERSTAGE_PIXEL];
+			if (texindex != LOVE_UINT8_MAX && bindings.textures[texindex][stage] != texture)
+			{
+				bindings.textures[texindex][stage] = texture;
+				changedtextures[stage] |= 1u << texindex;
+			}
 
-		if (texindex != LOVE_UINT8_MAX)
-			setTexture(renderEncoder, bindings, SHADERSTAGE_PIXEL, texindex, texture);
-		if (sampindex != LOVE_UINT8_MAX)
-			setSampler(renderEncoder, bindings, SHADERSTAGE_PIXEL, sampindex, samplertex);
+			if (sampindex != LOVE_UINT8_MAX && bindings.samplers[sampindex][stage] != sampler)
+			{
+				bindings.samplers[sampindex][stage] = sampler;
+				changedsamplers[stage] |= 1u << sampindex;
+			}
+		}
+	}
+
+	for (ShaderStageType stage : {SHADERSTAGE_VERTEX, SHADERSTAGE_PIXEL})
+	{
+		setTextureRanges(renderEncoder, bindings, stage, changedtextures[stage]);
+		setSamplerRanges(renderEncoder, bindings, stage, changedsamplers[stage]);
 	}
 
 	for (const Shader::BufferBinding &b : s->getBufferBindings())
@@ -1260,9 +1395,15 @@ void Graphics::draw(const DrawCommand &cmd)
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		[encoder drawPrimitives:getMTLPrimitiveType(cmd.primitiveType)
-				 indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
-		   indirectBufferOffset:cmd.indirectBufferOffset];
+		// Metal has no multi-draw indirect call outside of indirect command
+		// buffers, so each argument record is encoded separately.
+		size_t stride = getIndirectArgsStride(INDIRECT_ARGS_DRAW_VERTICES);
+		for (int i = 0; i < cmd.indirectDrawCount; i++)
+		{
+			[encoder drawPrimitives:getMTLPrimitiveType(cmd.primitiveType)
+					 indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
+			   indirectBufferOffset:cmd.indirectBufferOffset + i * stride];
+		}
 	}
 	else
 	{
@@ -1294,12 +1435,16 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		[encoder drawIndexedPrimitives:getMTLPrimitiveType(cmd.primitiveType)
-							 indexType:indexType
-						   indexBuffer:getMTLBuffer(cmd.indexBuffer)
-					 indexBufferOffset:cmd.indexBufferOffset
-						indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
-				  indirectBufferOffset:cmd.indexBufferOffset];
+		size_t stride = getIndirectArgsStride(INDIRECT_ARGS_DRAW_INDICES);
+		for (int i = 0; i < cmd.indirectDrawCount; i++)
+		{
+			[encoder drawIndexedPrimitives:getMTLPrimitiveType(cmd.primitiveType)
+								 indexType:indexType
+							   indexBuffer:getMTLBuffer(cmd.indexBuffer)
+						 indexBufferOffset:cmd.indexBufferOffset
+							indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
+					  indirectBufferOffset:cmd.indirectBufferOffset + i * stride];
+		}
 	}
 	else
 	{
@@ -1470,7 +1615,7 @@ void Graphics::setRenderTargetsInternal(const RenderTargets &rts, int /*pixelw*/
 	for (size_t i = 0; i < rts.colors.size(); i++)
 	{
 		auto desc = passDesc.colorAttachments[i];
-		setAttachment(rts.colors[i], desc, attachmentStoreActions.color[i]);
+		setAttachment(rts.colors[i], desc, attachmentStoreActions.color[i], true, rts.resolve);
 		passDesc.colorAttachments[i] = desc;
 	}
 
@@ -1497,10 +1642,10 @@ void Graphics::setRenderTargetsInternal(const RenderTargets &rts, int /*pixelw*/
 		dsformat = ds->getPixelFormat();
 
 		if (isPixelFormatDepth(dsformat))
-			setAttachment(rt, passDesc.depthAttachment, attachmentStoreActions.depth);
+			setAttachment(rt, passDesc.depthAttachment, attachmentStoreActions.depth, true, rts.resolve);
 
 		if (isPixelFormatStencil(dsformat))
-			setAttachment(rt, passDesc.stencilAttachment, attachmentStoreActions.stencil);
+			setAttachment(rt, passDesc.stencilAttachment, attachmentStoreActions.stencil, true, rts.resolve);
 	}
 
 	if (!isbackbuffer)
@@ -1523,7 +1668,7 @@ void Graphics::endPass(bool presenting)
 	// Make sure the encoder gets set up, if nothing else has done it yet.
 	useRenderEncoder();
 
-	flushBatchedDraws();
+	flushBatchedDraws(presenting ? BATCHFLUSH_PRESENT : BATCHFLUSH_RENDER_TARGET);
 
 	auto &rts = states.back().renderTargets;
 	love::graphics::Texture *depthstencil = rts.depthStencil.texture.get();
@@ -1544,7 +1689,7 @@ void Graphics::clear(OptionalColorD c, OptionalInt stencil, OptionalDouble depth
 { @autoreleasepool {
 	if (c.hasValue || stencil.hasValue || depth.hasValue)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 		// Handle clearing mid-pass by starting a new pass.
 		if (renderEncoder != nil)
@@ -1593,7 +1738,7 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 		return;
 	}
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 	// Handle clearing mid-pass by starting a new pass.
 	if (renderEncoder != nil)
@@ -1630,7 +1775,7 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 
 void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 { @autoreleasepool {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 	// TODO
 	if (renderEncoder != nil)
@@ -1654,6 +1799,8 @@ void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 
 void Graphics::present(void *screenshotCallbackData)
 { @autoreleasepool {
+	LOVE_PROFILE_ZONE("love.graphics.present");
+
 	if (!isActive())
 		return;
 
@@ -1694,13 +1841,12 @@ void Graphics::present(void *screenshotCallbackData)
 		submitBlitEncoder();
 	}
 
-	for (StreamBuffer *buffer : batchedDrawState.vb)
-		buffer->nextFrame();
-	batchedDrawState.indexBuffer->nextFrame();
+	updateBatchedDrawBuffers();
 
 	uniformBuffer->nextFrame();
 	uniformBufferData = {};
 	uniformBufferOffset = 0;
+	lastUniformSize = 0;
 
 	id<MTLCommandBuffer> cmd = getCommandBuffer();
 
@@ -1762,6 +1908,16 @@ void Graphics::present(void *screenshotCallbackData)
 	if (window != nullptr)
 		window->swapBuffers();
 
+	if (frameLatency > 0)
+	{
+		// Wait for the command buffer presented frameLatency-1 frames ago.
+		frameLatencyCommandBuffers[frameLatencyIndex] = cmd;
+		int waitindex = (frameLatencyIndex - (frameLatency - 1) + MAX_FRAME_LATENCY) % MAX_FRAME_LATENCY;
+		if (frameLatencyCommandBuffers[waitindex] != nil)
+			[frameLatencyCommandBuffers[waitindex] waitUntilCompleted];
+		frameLatencyIndex = (frameLatencyIndex + 1) % MAX_FRAME_LATENCY;
+	}
+
 	// This is set to NO when there are pending screen captures.
 	metalLayer.framebufferOnly = YES;
 
@@ -1770,8 +1926,16 @@ void Graphics::present(void *screenshotCallbackData)
 	shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	memset(batchFlushCounts, 0, sizeof(batchFlushCounts));
+	Buffer::frameBytesUploaded = 0;
+	Shader::frameUniformBytesUploaded = 0;
+	StreamBuffer::frameStallTime = 0.0;
 
 	updatePendingReadbacks();
+	updateMainThreadJobs();
+	updatePendingTextureUploads();
+	updateGPUTimers();
+	updateTextureResidency();
 	updateTemporaryResources();
 	processCompletedCommandBuffers();
 }}
@@ -1798,7 +1962,7 @@ void Graphics::setColor(Colorf c)
 
 void Graphics::setScissor(const Rect &rect)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	DisplayState &state = states.back();
 	state.scissor = true;
@@ -1811,7 +1975,7 @@ void Graphics::setScissor()
 	DisplayState &state = states.back();
 	if (state.scissor)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 		state.scissor = false;
 		dirtyRenderState |= STATEBIT_SCISSOR;
 	}
@@ -1821,7 +1985,7 @@ void Graphics::setStencilState(const StencilState &s)
 {
 	validateStencilState(s);
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().stencil = s;
 	dirtyRenderState |= STATEBIT_STENCIL;
@@ -1835,7 +1999,7 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 	if (state.depthTest != compare || state.depthWrite != write)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 		state.depthTest = compare;
 		state.depthWrite = write;
 		dirtyRenderState |= STATEBIT_DEPTH;
@@ -1846,7 +2010,7 @@ void Graphics::setFrontFaceWinding(Winding winding)
 {
 	if (states.back().winding != winding)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 		states.back().winding = winding;
 		dirtyRenderState |= STATEBIT_FACEWINDING;
 	}
@@ -1856,7 +2020,7 @@ void Graphics::setColorMask(ColorChannelMask mask)
 {
 	if (states.back().colorMask != mask)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 		states.back().colorMask = mask;
 		dirtyRenderState |= STATEBIT_COLORMASK;
 	}
@@ -1866,7 +2030,7 @@ void Graphics::setBlendState(const BlendState &blend)
 {
 	if (!(blend == states.back().blend))
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 		states.back().blend = blend;
 		dirtyRenderState |= STATEBIT_BLEND;
 	}
@@ -1875,7 +2039,7 @@ void Graphics::setBlendState(const BlendState &blend)
 void Graphics::setPointSize(float size)
 {
 	if (size != states.back().pointSize)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().pointSize = size;
 }
@@ -1884,7 +2048,7 @@ void Graphics::setWireframe(bool enable)
 {
 	if (enable != states.back().wireframe)
 	{
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 		states.back().wireframe = enable;
 		dirtyRenderState |= STATEBIT_WIREFRAME;
 	}
@@ -2265,8 +2429,10 @@ void Graphics::initCapabilities()
 		capabilities.features[FEATURE_INDIRECT_DRAW] = true;
 	else
 		capabilities.features[FEATURE_INDIRECT_DRAW] = false;
+	capabilities.features[FEATURE_GPU_TIMESTAMPS] = false;
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = false;
 	
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	static_assert(FEATURE_MAX_ENUM == 15, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	// https://developer.apple.com/metal/Metal-Feature-Set-Tables.pdf
 	capabilities.limits[LIMIT_POINT_SIZE] = 511;
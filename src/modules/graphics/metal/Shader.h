@@ -140,11 +140,17 @@ private:
 		}
 	};
 
+	std::string getPipelineLogFilename() const;
+	void prewarmRenderPipelines();
+	void recordRenderPipeline(graphics::Graphics *gfx, const RenderPipelineKey &key);
+
+	void compile(id<MTLDevice> device);
 	void buildLocalUniforms(const spirv_cross::CompilerMSL &msl, const spirv_cross::SPIRType &type, size_t baseoffset, const std::string &basename);
 	void compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &program);
 
 	void applyTexture(const UniformInfo *info, int i, love::graphics::Texture *texture, UniformType basetype, bool isdefault) override;
 	void applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer *buffer, UniformType basetype, bool isdefault) override;
+	void finishCompiling() override;
 
 	id<MTLFunction> functions[SHADERSTAGE_MAX_ENUM];
 
@@ -163,6 +169,11 @@ private:
 	std::vector<BufferBinding> bufferBindings;
 
 	std::unordered_map<RenderPipelineKey, const void *, RenderPipelineHasher> cachedRenderPipelines;
+
+	// Every render pipeline key this shader has used, in the format of its
+	// file in the shader cache. Used to pre-create the pipelines in later runs.
+	std::vector<uint8> pipelineLog;
+	bool prewarmingPipelines = false;
 	id<MTLComputePipelineState> computePipeline;
 
 }; // Metal
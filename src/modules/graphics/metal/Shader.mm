@@ -21,6 +21,7 @@
 #include "Shader.h"
 #include "Graphics.h"
 #include "common/int.h"
+#include "common/version.h"
 
 // glslang
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
@@ -152,6 +153,18 @@ Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stag
 	, localUniformBufferSize(0)
 	, builtinUniformDataOffset(0)
 	, firstVertexBufferBinding(DEFAULT_VERTEX_BUFFER_BINDING + 1)
+{
+	// Async shaders are compiled by finishCompiling once they're validated.
+	if (!options.async)
+		compile(device);
+}
+
+void Shader::finishCompiling()
+{
+	compile(Graphics::getInstance()->device);
+}
+
+void Shader::compile(id<MTLDevice> device)
 { @autoreleasepool {
 	using namespace glslang;
 
@@ -641,14 +654,14 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 			setTextureBinding(msl, stageindex, resource);
 		}
 
-		for (const auto &resource : resources.storage_buffers)
+		auto setBufferBinding = [this](CompilerMSL &msl, int stageindex, const spirv_cross::Resource &resource, std::map<std::string, UniformInfo> &uniforms) -> void
 		{
 			std::string name = canonicaliizeUniformName(resource.name);
-			auto it = reflection.storageBuffers.find(name);
-			if (it == reflection.storageBuffers.end())
+			auto it = uniforms.find(name);
+			if (it == uniforms.end())
 			{
 				handleUnknownUniformName(name.c_str());
-				continue;
+				return;
 			}
 
 			UniformInfo &u = it->second;
@@ -657,7 +670,7 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 			if (bufferbinding == (uint32)-1)
 			{
 				// No valid binding, the uniform was likely optimized out because it's not used.
-				continue;
+				return;
 			}
 
 			u.active = true;
@@ -679,6 +692,17 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 
 			for (int i = 0; i < u.count; i++)
 				bufferBindings[u.location + i].stages[stageindex] = (uint8) bufferbinding;
+		};
+
+		for (const auto &resource : resources.storage_buffers)
+		{
+			setBufferBinding(msl, stageindex, resource, reflection.storageBuffers);
+		}
+
+		for (const auto &resource : resources.uniform_buffers)
+		{
+			if (resource.name != "gl_DefaultUniformBlock")
+				setBufferBinding(msl, stageindex, resource, reflection.uniformBuffers);
 		}
 	}
 
@@ -694,6 +718,7 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 			break;
 		case UNIFORM_TEXELBUFFER:
 		case UNIFORM_STORAGEBUFFER:
+		case UNIFORM_UNIFORMBUFFER:
 			sendBuffers(info, &activeBuffers[info->resourceIndex], info->count, true);
 			break;
 		default:
@@ -702,6 +727,9 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 	}
 
 	firstVertexBufferBinding = metalBufferIndices[SHADERSTAGE_VERTEX];
+
+	if (functions[SHADERSTAGE_COMPUTE] == nil)
+		prewarmRenderPipelines();
 }
 
 Shader::~Shader()
@@ -720,17 +748,23 @@ Shader::~Shader()
 
 void Shader::attach()
 {
+	waitUntilReady();
+
 	if (current != this)
 	{
 		Graphics *gfx = Graphics::getInstance();
-		gfx->flushBatchedDraws();
+		gfx->flushBatchedDraws(Graphics::BATCHFLUSH_SHADER);
 		gfx->setShaderChanged();
 		current = this;
 	}
+
+	updateSharedUniformBuffers();
 }
 
 int Shader::getVertexAttributeIndex(const std::string &name)
 {
+	waitUntilReady();
+
 	const auto it = attributes.find(name);
 	return it != attributes.end() ? it->second.index : -1;
 }
@@ -742,17 +776,23 @@ const Shader::UniformInfo *Shader::getUniformInfo(BuiltinUniform builtin) const
 
 void Shader::updateUniform(const UniformInfo *info, int count)
 {
+	waitUntilReady();
+
 	if (info->dataSize == 0)
 		return;
 
-	if (current == this)
-		Graphics::flushBatchedDrawsGlobal();
-
 	count = std::min(count, info->count);
 
 	size_t offset = (const uint8 *)info->data - localUniformStagingData;
 	uint8 *dst = localUniformBufferData + offset;
 
+	// Don't break the current batch when the values haven't changed.
+	if (isUniformBufferDataEqual(info, info->data, dst, count))
+		return;
+
+	if (current == this)
+		Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_UNIFORM);
+
 	copyToUniformBuffer(info, info->data, dst, count);
 }
 
@@ -788,7 +828,7 @@ void Shader::applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer
 	{
 		textureBindings[bindingindex].texture = getMTLTexture(buffer);
 	}
-	else if (basetype == UNIFORM_STORAGEBUFFER && bindingindex >= 0)
+	else if ((basetype == UNIFORM_STORAGEBUFFER || basetype == UNIFORM_UNIFORMBUFFER) && bindingindex >= 0)
 	{
 		auto &binding = bufferBindings[bindingindex];
 		if (isdefault && (binding.access & ACCESS_WRITE) != 0)
@@ -938,9 +978,114 @@ id<MTLRenderPipelineState> Shader::getCachedRenderPipeline(graphics::Graphics *g
 
 	cachedRenderPipelines[key] = CFBridgingRetain(pipeline);
 
+	if (!prewarmingPipelines)
+		recordRenderPipeline(gfx, key);
+
 	return pipeline;
 }
 
+static const uint32 PIPELINE_LOG_MAGIC = 0x4C50504C; // "LPPL"
+static const uint32 PIPELINE_LOG_VERSION = 1;
+static const size_t PIPELINE_LOG_HEADER_SIZE = sizeof(uint32) * 2;
+
+// Vertex attribute IDs only exist for the current run, so the log stores the
+// attributes they were created from instead.
+struct PipelineLogEntry
+{
+	Shader::RenderPipelineKey key;
+	VertexAttributes attributes;
+};
+
+std::string Shader::getPipelineLogFilename() const
+{
+	XXH64_state_t *state = XXH64_createState();
+	XXH64_reset(state, 0);
+
+	XXH64_update(state, love::VERSION, strlen(love::VERSION));
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (!stages[i])
+			continue;
+
+		const std::string &source = stages[i]->getSource();
+		uint32 stageindex = (uint32) i;
+		XXH64_update(state, &stageindex, sizeof(stageindex));
+		XXH64_update(state, source.c_str(), source.length());
+	}
+
+	unsigned long long hash = XXH64_digest(state);
+	XXH64_freeState(state);
+
+	char name[64];
+	snprintf(name, sizeof(name), "pipelines_%016llx.bin", hash);
+	return name;
+}
+
+void Shader::prewarmRenderPipelines()
+{
+	if (!isShaderCacheEnabled())
+		return;
+
+	if (!readShaderCacheFile(getPipelineLogFilename(), pipelineLog))
+		return;
+
+	uint32 header[2] = {};
+	if (pipelineLog.size() >= PIPELINE_LOG_HEADER_SIZE)
+		memcpy(header, pipelineLog.data(), PIPELINE_LOG_HEADER_SIZE);
+
+	if (header[0] != PIPELINE_LOG_MAGIC || header[1] != PIPELINE_LOG_VERSION
+		|| (pipelineLog.size() - PIPELINE_LOG_HEADER_SIZE) % sizeof(PipelineLogEntry) != 0)
+	{
+		pipelineLog.clear();
+		return;
+	}
+
+	auto gfx = Graphics::getInstance();
+	size_t count = (pipelineLog.size() - PIPELINE_LOG_HEADER_SIZE) / sizeof(PipelineLogEntry);
+
+	prewarmingPipelines = true;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		PipelineLogEntry entry;
+		memcpy(&entry, pipelineLog.data() + PIPELINE_LOG_HEADER_SIZE + i * sizeof(PipelineLogEntry), sizeof(PipelineLogEntry));
+
+		entry.key.vertexAttributesID = gfx->registerVertexAttributes(entry.attributes);
+		getCachedRenderPipeline(gfx, entry.key);
+	}
+
+	prewarmingPipelines = false;
+}
+
+void Shader::recordRenderPipeline(graphics::Graphics *gfx, const RenderPipelineKey &key)
+{
+	if (!isShaderCacheEnabled())
+		return;
+
+	PipelineLogEntry entry;
+	if (!gfx->findVertexAttributes(key.vertexAttributesID, entry.attributes))
+		return;
+
+	entry.key = key;
+	entry.key.vertexAttributesID.invalidate();
+
+	if (pipelineLog.empty())
+	{
+		uint32 header[2] = { PIPELINE_LOG_MAGIC, PIPELINE_LOG_VERSION };
+		pipelineLog.resize(PIPELINE_LOG_HEADER_SIZE);
+		memcpy(pipelineLog.data(), header, PIPELINE_LOG_HEADER_SIZE);
+	}
+
+	size_t offset = pipelineLog.size();
+	pipelineLog.resize(offset + sizeof(PipelineLogEntry));
+	memcpy(pipelineLog.data() + offset, &entry, sizeof(PipelineLogEntry));
+
+	// New keys are rare after the first few frames, so rewriting the whole log
+	// each time is cheap compared to the pipeline compile itself.
+	writeShaderCacheFile(getPipelineLogFilename(), pipelineLog.data(), pipelineLog.size());
+}
+
 int Shader::getUniformBufferBinding()
 {
 	return spirv_cross::ResourceBindingPushConstantBinding;
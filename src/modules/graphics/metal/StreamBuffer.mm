@@ -22,6 +22,7 @@
 #include "Metal.h"
 #include "Graphics.h"
 #include "common/int.h"
+#include "timer/Timer.h"
 
 #include <dispatch/semaphore.h>
 
@@ -77,7 +78,9 @@ public:
 		// Make sure this frame's section of the buffer is done being used.
 		if (!mappedFrames[frameIndex])
 		{
+			double start = love::timer::Timer::getTime();
 			dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+			frameStallTime += love::timer::Timer::getTime() - start;
 			mappedFrames[frameIndex] = true;
 		}
 
@@ -65,6 +65,9 @@ private:
 
 	int actualMSAASamples = 1;
 
+	// Set while the constructor fills in the initial contents.
+	bool initializing = false;
+
 }; // Texture
 
 } // metal
@@ -41,6 +41,13 @@ static MTLTextureType getMTLTextureType(TextureType type, int msaa)
 	return MTLTextureType2D;
 }
 
+static bool isMemorylessSupported(id<MTLDevice> device)
+{
+	if (@available(macOS 11.0, iOS 13.0, *))
+		return [device supportsFamily:MTLGPUFamilyApple1];
+	return false;
+}
+
 Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const Settings &settings, const Slices *data)
 	: love::graphics::Texture(gfxbase, settings, data)
 { @autoreleasepool {
@@ -70,6 +77,15 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 
 	desc.storageMode = MTLStorageModePrivate;
 
+	// Memoryless textures only exist in tile memory during a render pass.
+	// Without a resolve texture there's nothing that needs to be kept.
+	bool memoryless = transient && isMemorylessSupported(device);
+	if (memoryless && !readable)
+	{
+		if (@available(macOS 11.0, iOS 10.0, *))
+			desc.storageMode = MTLStorageModeMemoryless;
+	}
+
 	if (readable)
 		desc.usage |= MTLTextureUsageShaderRead;
 	if (renderTarget)
@@ -102,6 +118,12 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 		desc.textureType = getMTLTextureType(texType, actualMSAASamples);
 		desc.usage &= ~MTLTextureUsageShaderRead;
 
+		if (memoryless)
+		{
+			if (@available(macOS 11.0, iOS 10.0, *))
+				desc.storageMode = MTLStorageModeMemoryless;
+		}
+
 		msaaTexture = [device newTextureWithDescriptor:desc];
 		if (msaaTexture == nil)
 		{
@@ -131,8 +153,15 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 	std::vector<uint8> emptydata;
 	MTLRenderPassDescriptor *passdesc = nil;
 
+	// Transient textures without a resolve texture have nothing to initialize.
+	bool initialize = !transient || readable;
+
+	// Nothing can be using the new texture yet, so its initial contents don't
+	// need to interrupt the active render pass.
+	initializing = true;
+
 	// Initialize texture.
-	for (int mip = 0; mip < mipcount; mip++)
+	for (int mip = 0; mip < mipcount && initialize; mip++)
 	{
 		for (int slice = 0; slice < getSliceCount(mip); slice++)
 		{
@@ -159,8 +188,7 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 			else if (isRenderTarget())
 			{
 				// Clear to transparent black.
-				gfx->submitAllEncoders(Graphics::SUBMIT_STORE);
-				id<MTLCommandBuffer> cmd = gfx->useCommandBuffer();
+				id<MTLCommandBuffer> cmd = gfx->useInitCommandBuffer();
 
 				if (passdesc == nil)
 					passdesc = [MTLRenderPassDescriptor renderPassDescriptor];
@@ -178,7 +206,7 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 					{
 						attachment.texture = msaaTexture;
 						attachment.resolveTexture = texture;
-						attachment.storeAction = MTLStoreActionStoreAndMultisampleResolve;
+						attachment.storeAction = transient ? MTLStoreActionMultisampleResolve : MTLStoreActionStoreAndMultisampleResolve;
 					}
 				};
 
@@ -216,6 +244,8 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 	if (shouldgeneratemips)
 		generateMipmaps();
 
+	initializing = false;
+
 	setSamplerState(samplerState);
 }}
 
@@ -268,7 +298,7 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 													length:size
 												   options:MTLResourceStorageModeShared];
 
-	id<MTLBlitCommandEncoder> encoder = gfx->useBlitEncoder();
+	id<MTLBlitCommandEncoder> encoder = initializing ? gfx->useInitBlitEncoder() : gfx->useBlitEncoder();
 
 	int z = 0;
 	if (texType == TEXTURE_VOLUME)
@@ -315,7 +345,8 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 
 void Texture::generateMipmapsInternal()
 { @autoreleasepool {
-	id<MTLBlitCommandEncoder> encoder = Graphics::getInstance()->useBlitEncoder();
+	auto gfx = Graphics::getInstance();
+	id<MTLBlitCommandEncoder> encoder = initializing ? gfx->useInitBlitEncoder() : gfx->useBlitEncoder();
 	[encoder generateMipmapsForTexture:texture];
 }}
 
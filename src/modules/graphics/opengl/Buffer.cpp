@@ -80,6 +80,8 @@ Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const st
 		mapUsage = BUFFERUSAGE_INDEX;
 	else if (usageFlags & BUFFERUSAGEFLAG_SHADER_STORAGE)
 		mapUsage = BUFFERUSAGE_SHADER_STORAGE;
+	else if (usageFlags & BUFFERUSAGEFLAG_UNIFORM)
+		mapUsage = BUFFERUSAGE_UNIFORM;
 	else if (usageFlags & BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS)
 		mapUsage = BUFFERUSAGE_INDIRECT_ARGUMENTS;
 
@@ -292,6 +294,7 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 		glBufferSubData(target, (GLintptr) offset, (GLsizeiptr) size, data);
 	}
 
+	frameBytesUploaded += size;
 	return true;
 }
 
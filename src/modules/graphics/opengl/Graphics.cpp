@@ -27,10 +27,13 @@
 #include "font/Font.h"
 #include "StreamBuffer.h"
 #include "GraphicsReadback.h"
+#include "TextureUpload.h"
 #include "math/MathModule.h"
 #include "window/Window.h"
 #include "Buffer.h"
+#include "OcclusionQuery.h"
 #include "ShaderStage.h"
+#include "profiler/Profiler.h"
 
 #include "libraries/xxHash/xxhash.h"
 
@@ -178,14 +181,24 @@ love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, co
 	return new Buffer(this, settings, format, data, size, arraylength);
 }
 
+love::graphics::OcclusionQuery *Graphics::newOcclusionQuery()
+{
+	return new OcclusionQuery();
+}
+
 love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
 }
 
-love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset)
+{
+	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty, destbytes, destbytesoffset);
+}
+
+love::graphics::TextureUpload *Graphics::newTextureUploadInternal(love::graphics::Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
 {
-	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty);
+	return new TextureUpload(this, texture, data, slice, mipmap, x, y, reloadmipmaps);
 }
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
@@ -438,6 +451,16 @@ void Graphics::unSetMode()
 		mainVAO = 0;
 	}
 
+	for (auto &queries : timestampQueries)
+	{
+		if (!queries.empty())
+			glDeleteQueries((GLsizei) queries.size(), queries.data());
+		queries.clear();
+	}
+
+	for (FenceSync &sync : frameLatencyFences)
+		sync.cleanup();
+
 	gl.deInitContext();
 
 	created = false;
@@ -509,10 +532,26 @@ static bool computeDispatchBarriers(Shader *shader, GLbitfield &preDispatchBarri
 	return true;
 }
 
+static void markTexturesUsed(love::graphics::Texture *maintexture)
+{
+	// Evicted mipmap levels of these textures are reloaded here, before
+	// anything is bound for the draw.
+	if (love::graphics::Texture::evictableTextureCount == 0)
+		return;
+
+	if (maintexture != nullptr)
+		maintexture->markUsed();
+
+	if (love::graphics::Shader::current != nullptr)
+		love::graphics::Shader::current->markTexturesUsed();
+}
+
 bool Graphics::dispatch(love::graphics::Shader *s, int x, int y, int z)
 {
 	auto shader = (Shader *) s;
 
+	shader->markTexturesUsed();
+
 	GLbitfield preDispatchBarriers = 0;
 	GLbitfield postDispatchBarriers = 0;
 
@@ -542,6 +581,8 @@ bool Graphics::dispatch(love::graphics::Shader *s, love::graphics::Buffer *indir
 {
 	auto shader = (Shader *) s;
 
+	shader->markTexturesUsed();
+
 	GLbitfield preDispatchBarriers = 0;
 	GLbitfield postDispatchBarriers = 0;
 
@@ -567,11 +608,16 @@ bool Graphics::dispatch(love::graphics::Shader *s, love::graphics::Buffer *indir
 
 void Graphics::draw(const DrawCommand &cmd)
 {
+	if (isConditionalRenderSkippingDraws())
+		return;
+
 	VertexAttributes attributes;
 	findVertexAttributes(cmd.attributesID, attributes);
 
+	markTexturesUsed(cmd.texture);
+
 	gl.prepareDraw(this);
-	gl.setVertexAttributes(attributes, *cmd.buffers);
+	gl.setVertexAttributes(cmd.attributesID, attributes, *cmd.buffers);
 	gl.bindTextureToUnit(cmd.texture, 0, false);
 	gl.setCullMode(cmd.cullMode);
 
@@ -580,7 +626,16 @@ void Graphics::draw(const DrawCommand &cmd)
 	if (cmd.indirectBuffer != nullptr)
 	{
 		gl.bindBuffer(BUFFERUSAGE_INDIRECT_ARGUMENTS, (GLuint) cmd.indirectBuffer->getHandle());
-		glDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset));
+
+		size_t stride = getIndirectArgsStride(INDIRECT_ARGS_DRAW_VERTICES);
+
+		if (cmd.indirectDrawCount > 1 && gl.isMultiDrawIndirectSupported())
+			glMultiDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset), cmd.indirectDrawCount, (GLsizei) stride);
+		else
+		{
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+				glDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset + i * stride));
+		}
 	}
 	else if (cmd.instanceCount > 1)
 		glDrawArraysInstanced(glprimitivetype, cmd.vertexStart, cmd.vertexCount, cmd.instanceCount);
@@ -592,11 +647,16 @@ void Graphics::draw(const DrawCommand &cmd)
 
 void Graphics::draw(const DrawIndexedCommand &cmd)
 {
+	if (isConditionalRenderSkippingDraws())
+		return;
+
 	VertexAttributes attributes;
 	findVertexAttributes(cmd.attributesID, attributes);
 
+	markTexturesUsed(cmd.texture);
+
 	gl.prepareDraw(this);
-	gl.setVertexAttributes(attributes, *cmd.buffers);
+	gl.setVertexAttributes(cmd.attributesID, attributes, *cmd.buffers);
 	gl.bindTextureToUnit(cmd.texture, 0, false);
 	gl.setCullMode(cmd.cullMode);
 
@@ -611,7 +671,16 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 		// Note: OpenGL doesn't support indirect indexed draws with a non-zero
 		// index buffer offset.
 		gl.bindBuffer(BUFFERUSAGE_INDIRECT_ARGUMENTS, (GLuint) cmd.indirectBuffer->getHandle());
-		glDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset));
+
+		size_t stride = getIndirectArgsStride(INDIRECT_ARGS_DRAW_INDICES);
+
+		if (cmd.indirectDrawCount > 1 && gl.isMultiDrawIndirectSupported())
+			glMultiDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset), cmd.indirectDrawCount, (GLsizei) stride);
+		else
+		{
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+				glDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset + i * stride));
+		}
 	}
 	else if (cmd.instanceCount > 1)
 		glDrawElementsInstanced(glprimitivetype, cmd.indexCount, gldatatype, gloffset, cmd.instanceCount);
@@ -646,21 +715,26 @@ static inline void advanceVertexOffsets(const VertexAttributes &attributes, Buff
 
 void Graphics::drawQuads(int start, int count, VertexAttributesID attributesID, const BufferBindings &buffers, love::graphics::Texture *texture)
 {
+	if (isConditionalRenderSkippingDraws())
+		return;
+
 	const int MAX_VERTICES_PER_DRAW = LOVE_UINT16_MAX;
 	const int MAX_QUADS_PER_DRAW    = MAX_VERTICES_PER_DRAW / 4;
 
 	VertexAttributes attributes;
 	findVertexAttributes(attributesID, attributes);
 
+	markTexturesUsed(texture);
+
 	gl.prepareDraw(this);
 	gl.bindTextureToUnit(texture, 0, false);
 	gl.setCullMode(CULL_NONE);
 
-	gl.bindBuffer(BUFFERUSAGE_INDEX, quadIndexBuffer->getHandle());
-
 	if (gl.isBaseVertexSupported())
 	{
-		gl.setVertexAttributes(attributes, buffers);
+		// The index buffer binding is part of the VAO state.
+		gl.setVertexAttributes(attributesID, attributes, buffers);
+		gl.bindBuffer(BUFFERUSAGE_INDEX, quadIndexBuffer->getHandle());
 
 		int basevertex = start * 4;
 
@@ -682,7 +756,8 @@ void Graphics::drawQuads(int start, int count, VertexAttributesID attributesID,
 
 		for (int quadindex = 0; quadindex < count; quadindex += MAX_QUADS_PER_DRAW)
 		{
-			gl.setVertexAttributes(attributes, bufferscopy);
+			gl.setVertexAttributes(attributesID, attributes, bufferscopy);
+			gl.bindBuffer(BUFFERUSAGE_INDEX, quadIndexBuffer->getHandle());
 
 			int quadcount = std::min(MAX_QUADS_PER_DRAW, count - quadindex);
 
@@ -812,9 +887,10 @@ void Graphics::endPass(bool presenting)
 		discard({}, true);
 	}
 
-	// Resolve MSAA buffers. MSAA is only supported for 2D render targets so we
-	// don't have to worry about resolving to slices.
-	if (rts.colors.size() > 0 && rts.colors[0].texture->getMSAA() > 1)
+	// Resolve MSAA buffers, unless the targets were set with resolving turned
+	// off. MSAA is only supported for 2D render targets so we don't have to
+	// worry about resolving to slices.
+	if (rts.resolve && rts.colors.size() > 0 && rts.colors[0].texture->getMSAA() > 1)
 	{
 		int mip = rts.colors[0].mipmap;
 		int w = rts.colors[0].texture->getPixelWidth(mip);
@@ -838,7 +914,7 @@ void Graphics::endPass(bool presenting)
 		}
 	}
 
-	if (depthstencil != nullptr && depthstencil->getMSAA() > 1 && depthstencil->isReadable())
+	if (rts.resolve && depthstencil != nullptr && depthstencil->getMSAA() > 1 && depthstencil->isReadable())
 	{
 		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_DRAW, ((Texture *) depthstencil)->getFBO());
 
@@ -891,7 +967,7 @@ void Graphics::clear(OptionalColorD c, OptionalInt stencil, OptionalDouble depth
 	}
 
 	if (c.hasValue || stencil.hasValue || depth.hasValue)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 	GLbitfield flags = 0;
 
@@ -946,7 +1022,7 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 		return;
 	}
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 	ncolors = std::min(ncolors, ncolorRTs);
 
@@ -1011,7 +1087,7 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 
 void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 	discard(OpenGL::FRAMEBUFFER_ALL, colorbuffers, depthstencil);
 }
 
@@ -1181,15 +1257,20 @@ GLuint Graphics::bindCachedFBO(const RenderTargets &targets)
 
 void Graphics::present(void *screenshotCallbackData)
 {
+	LOVE_PROFILE_ZONE("love.graphics.present");
+
 	if (!isActive())
 		return;
 
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
+	if (getActiveOcclusionQuery() != nullptr)
+		throw love::Exception("present cannot be called while an occlusion query is active.");
+
 	deprecations.draw(this);
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_PRESENT);
 
 	endPass(true);
 
@@ -1294,14 +1375,14 @@ void Graphics::present(void *screenshotCallbackData)
 	glBindRenderbuffer(GL_RENDERBUFFER, colorbuffer);
 #endif
 
-	for (StreamBuffer *buffer : batchedDrawState.vb)
-		buffer->nextFrame();
-	batchedDrawState.indexBuffer->nextFrame();
+	updateBatchedDrawBuffers();
 
 	auto window = getInstance<love::window::Window>(M_WINDOW);
 	if (window != nullptr)
 		window->swapBuffers();
 
+	waitForFrameLatency();
+
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getInternalBackbufferFBO());
 
 	// Reset the per-frame stat counts.
@@ -1309,11 +1390,36 @@ void Graphics::present(void *screenshotCallbackData)
 	gl.stats.shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	memset(batchFlushCounts, 0, sizeof(batchFlushCounts));
+	Buffer::frameBytesUploaded = 0;
+	Shader::frameUniformBytesUploaded = 0;
+	StreamBuffer::frameStallTime = 0.0;
 
 	updatePendingReadbacks();
+	updateMainThreadJobs();
+	updatePendingTextureUploads();
+	updateGPUTimers();
+	updateTextureResidency();
 	updateTemporaryResources();
 }
 
+void Graphics::waitForFrameLatency()
+{
+	if (frameLatency <= 0)
+		return;
+
+	// A fence placed after the buffer swap completes once the GPU has
+	// finished the frame. Waiting on the fence from frameLatency-1 frames ago
+	// keeps the driver from queueing frames further ahead than that.
+	frameLatencyFences[frameLatencyIndex].fence();
+
+	int waitindex = (frameLatencyIndex - (frameLatency - 1) + MAX_FRAME_LATENCY) % MAX_FRAME_LATENCY;
+
+	frameLatencyFences[waitindex].cpuWait();
+
+	frameLatencyIndex = (frameLatencyIndex + 1) % MAX_FRAME_LATENCY;
+}
+
 int Graphics::getRequestedBackbufferMSAA() const
 {
 	return requestedBackbufferMSAA;
@@ -1326,7 +1432,7 @@ int Graphics::getBackbufferMSAA() const
 
 void Graphics::setScissor(const Rect &rect, bool rtActive)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	DisplayState &state = states.back();
 
@@ -1356,7 +1462,7 @@ void Graphics::setScissor(const Rect &rect)
 void Graphics::setScissor()
 {
 	if (states.back().scissor)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().scissor = false;
 
@@ -1368,7 +1474,7 @@ void Graphics::setStencilState(const StencilState &s)
 {
 	validateStencilState(s);
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	bool enablestencil = s.action != STENCIL_KEEP || s.compare != COMPARE_ALWAYS;
 	if (enablestencil != gl.isStateEnabled(OpenGL::ENABLE_STENCIL_TEST))
@@ -1436,7 +1542,7 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 	DisplayState &state = states.back();
 
 	if (state.depthTest != compare || state.depthWrite != write)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	state.depthTest = compare;
 	state.depthWrite = write;
@@ -1458,7 +1564,7 @@ void Graphics::setFrontFaceWinding(Winding winding)
 	DisplayState &state = states.back();
 
 	if (state.winding != winding)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	state.winding = winding;
 
@@ -1480,7 +1586,7 @@ void Graphics::setColor(Colorf c)
 
 void Graphics::setColorMask(ColorChannelMask mask)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	uint32 maskbits =
 		((mask.r ? 1 : 0) << 0) | ((mask.g ? 1 : 0) << 1) |
@@ -1493,7 +1599,7 @@ void Graphics::setColorMask(ColorChannelMask mask)
 void Graphics::setBlendState(const BlendState &blend)
 {
 	if (!(blend == states.back().blend))
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	if (blend.enable != gl.isStateEnabled(OpenGL::ENABLE_BLEND))
 		gl.setEnableState(OpenGL::ENABLE_BLEND, blend.enable);
@@ -1517,7 +1623,7 @@ void Graphics::setBlendState(const BlendState &blend)
 void Graphics::setPointSize(float size)
 {
 	if (size != states.back().pointSize)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().pointSize = size;
 }
@@ -1528,7 +1634,7 @@ void Graphics::setWireframe(bool enable)
 	if (GLAD_ES_VERSION_2_0)
 		return;
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	glPolygonMode(GL_FRONT_AND_BACK, enable ? GL_LINE : GL_FILL);
 	states.back().wireframe = enable;
@@ -1594,6 +1700,44 @@ void Graphics::getAPIStats(int &shaderswitches) const
 	shaderswitches = gl.stats.shaderSwitches;
 }
 
+void Graphics::writeTimestampQuery(int frame, int index)
+{
+	std::vector<GLuint> &queries = timestampQueries[frame];
+
+	if (index >= (int) queries.size())
+	{
+		size_t oldsize = queries.size();
+		queries.resize(std::max((size_t) index + 1, oldsize * 2));
+		glGenQueries((GLsizei) (queries.size() - oldsize), &queries[oldsize]);
+	}
+
+	glQueryCounter(queries[index], GL_TIMESTAMP);
+}
+
+bool Graphics::getTimestampQueryResults(int frame, int count, uint64 *results)
+{
+	const std::vector<GLuint> &queries = timestampQueries[frame];
+
+	if (count <= 0 || count > (int) queries.size())
+		return false;
+
+	// Queries complete in order, so the last one being available means the
+	// rest are as well.
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(queries[count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == GL_FALSE)
+		return false;
+
+	for (int i = 0; i < count; i++)
+	{
+		GLuint64 result = 0;
+		glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &result);
+		results[i] = (uint64) result;
+	}
+
+	return true;
+}
+
 void Graphics::initCapabilities()
 {
 	capabilities.features[FEATURE_MULTI_RENDER_TARGET_FORMATS] = true;
@@ -1609,7 +1753,9 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_TEXEL_BUFFER] = gl.isBufferUsageSupported(BUFFERUSAGE_TEXEL);
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = gl.isCopyTextureToBufferSupported();
 	capabilities.features[FEATURE_INDIRECT_DRAW] = capabilities.features[FEATURE_GLSL4];
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_GPU_TIMESTAMPS] = gl.isTimestampQuerySupported();
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = true;
+	static_assert(FEATURE_MAX_ENUM == 15, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	capabilities.limits[LIMIT_POINT_SIZE] = gl.getMaxPointSize();
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = gl.getMax2DTextureSize();
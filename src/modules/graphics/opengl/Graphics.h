@@ -38,6 +38,7 @@
 
 #include "Texture.h"
 #include "Shader.h"
+#include "FenceSync.h"
 
 #include "libraries/xxHash/xxhash.h"
 
@@ -59,6 +60,7 @@ public:
 	love::graphics::Texture *newTexture(const Texture::Settings &settings, const Texture::Slices *data = nullptr) override;
 	love::graphics::Texture *newTextureView(love::graphics::Texture *base, const Texture::ViewSettings &viewsettings) override;
 	love::graphics::Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) override;
+	love::graphics::OcclusionQuery *newOcclusionQuery() override;
 
 	void backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa) override;
 	bool setMode(void *context, int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa) override;
@@ -139,11 +141,14 @@ private:
 	love::graphics::StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) override;
 
 	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) override;
-	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty) override;
+	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset) override;
+	love::graphics::TextureUpload *newTextureUploadInternal(love::graphics::Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps) override;
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
+	void writeTimestampQuery(int frame, int index) override;
+	bool getTimestampQueryResults(int frame, int count, uint64 *results) override;
 
 	void endPass(bool presenting);
 	GLuint bindCachedFBO(const RenderTargets &targets);
@@ -157,12 +162,19 @@ private:
 
 	void setScissor(const Rect &rect, bool rtActive);
 
+	void waitForFrameLatency();
+
 	uint32 computePixelFormatUsage(PixelFormat format, bool readable);
 
 	std::unordered_map<RenderTargets, GLuint, CachedFBOHasher> framebufferObjects;
 	bool windowHasStencil;
 	GLuint mainVAO;
 
+	std::vector<GLuint> timestampQueries[GPU_TIMER_FRAMES];
+
+	FenceSync frameLatencyFences[MAX_FRAME_LATENCY];
+	int frameLatencyIndex = 0;
+
 	StrongRef<love::graphics::Texture> internalBackbuffer;
 	StrongRef<love::graphics::Texture> internalBackbufferDepthStencil;
 	GLuint internalBackbufferFBO;
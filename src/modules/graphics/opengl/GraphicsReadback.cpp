@@ -59,8 +59,8 @@ GraphicsReadback::GraphicsReadback(love::graphics::Graphics *gfx, ReadbackMethod
 	}
 }
 
-GraphicsReadback::GraphicsReadback(love::graphics::Graphics *gfx, ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
-	: love::graphics::GraphicsReadback(gfx, method, texture, slice, mipmap, rect, dest, destx, desty)
+GraphicsReadback::GraphicsReadback(love::graphics::Graphics *gfx, ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset)
+	: love::graphics::GraphicsReadback(gfx, method, texture, slice, mipmap, rect, dest, destx, desty, destbytes, destbytesoffset)
 {
 	size_t size = getPixelFormatSliceSize(textureFormat, rect.w, rect.h);
 
@@ -71,7 +71,8 @@ GraphicsReadback::GraphicsReadback(love::graphics::Graphics *gfx, ReadbackMethod
 		// Direct readback without copying avoids the need for a staging buffer,
 		// and lowers the system requirements of immediate RT readback.
 		Texture *t = (Texture *) texture;
-		t->readbackInternal(slice, mipmap, rect, imageData->getWidth(), size, dest);
+		int destwidth = imageData.get() ? imageData->getWidth() : rect.w;
+		t->readbackInternal(slice, mipmap, rect, destwidth, size, dest);
 
 		status = STATUS_COMPLETE;
 	}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+OcclusionQuery::OcclusionQuery()
+{
+	for (int i = 0; i < QUERY_SLOTS; i++)
+	{
+		queries[i] = 0;
+		issued[i] = false;
+	}
+
+	loadVolatile();
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	unloadVolatile();
+}
+
+bool OcclusionQuery::loadVolatile()
+{
+	if (queries[0] != 0)
+		return true;
+
+	glGenQueries(QUERY_SLOTS, queries);
+
+	for (int i = 0; i < QUERY_SLOTS; i++)
+		issued[i] = false;
+
+	return true;
+}
+
+void OcclusionQuery::unloadVolatile()
+{
+	if (queries[0] == 0)
+		return;
+
+	glDeleteQueries(QUERY_SLOTS, queries);
+
+	for (int i = 0; i < QUERY_SLOTS; i++)
+	{
+		queries[i] = 0;
+		issued[i] = false;
+	}
+}
+
+GLenum OcclusionQuery::getTarget() const
+{
+	// OpenGL ES only has the conservative variant, which is fine for a yes/no
+	// visibility test.
+	return GLAD_ES_VERSION_3_0 ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED;
+}
+
+void OcclusionQuery::beginQuery(int slot)
+{
+	glBeginQuery(getTarget(), queries[slot]);
+}
+
+void OcclusionQuery::endQuery(int slot)
+{
+	glEndQuery(getTarget());
+	issued[slot] = true;
+}
+
+bool OcclusionQuery::getQueryResult(int slot, bool &anysamples)
+{
+	if (!issued[slot])
+		return false;
+
+	GLuint available = GL_FALSE;
+	glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == GL_FALSE)
+		return false;
+
+	GLuint result = 0;
+	glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT, &result);
+	anysamples = result != 0;
+	return true;
+}
+
+bool OcclusionQuery::beginConditionalRender()
+{
+	// Conditional rendering is only in desktop GL. GL_QUERY_NO_WAIT draws
+	// normally if the result isn't available yet, instead of stalling.
+	if (!GLAD_VERSION_3_0 || lastEndedSlot < 0 || !issued[lastEndedSlot])
+		return false;
+
+	glBeginConditionalRender(queries[lastEndedSlot], GL_QUERY_NO_WAIT);
+	return true;
+}
+
+void OcclusionQuery::endConditionalRender()
+{
+	glEndConditionalRender();
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "graphics/OcclusionQuery.h"
+#include "graphics/Volatile.h"
+
+// OpenGL
+#include "OpenGL.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+class OcclusionQuery final : public love::graphics::OcclusionQuery, public Volatile
+{
+public:
+
+	OcclusionQuery();
+	virtual ~OcclusionQuery();
+
+	// Implements Volatile.
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+	bool beginConditionalRender() override;
+	void endConditionalRender() override;
+
+protected:
+
+	void beginQuery(int slot) override;
+	void endQuery(int slot) override;
+	bool getQueryResult(int slot, bool &anysamples) override;
+
+private:
+
+	GLenum getTarget() const;
+
+	GLuint queries[QUERY_SLOTS];
+
+	// Queries which have been ended since they were (re)created.
+	bool issued[QUERY_SLOTS];
+
+}; // OcclusionQuery
+
+} // opengl
+} // graphics
+} // love
@@ -131,6 +131,9 @@ OpenGL::OpenGL()
 	, bugs()
 	, contextInitialized(false)
 	, baseVertexSupported(false)
+	, vertexArraysSupported(false)
+	, defaultVertexArray()
+	, currentVertexArray(&defaultVertexArray)
 	, maxAnisotropy(1.0f)
 	, maxLODBias(0.0f)
 	, max2DTextureSize(0)
@@ -146,6 +149,7 @@ OpenGL::OpenGL()
 	, maxSamples(1)
 	, maxTextureUnits(1)
 	, maxShaderStorageBufferBindings(0)
+	, maxUniformBufferBindings(0)
 	, maxPointSize(1)
 	, coreProfile(false)
 	, vendor(VENDOR_UNKNOWN)
@@ -238,7 +242,22 @@ void OpenGL::setupContext()
 	state.enabledAttribArrays = (uint32) ((1ull << uint32(maxvertexattribs)) - 1);
 	state.instancedAttribArrays = 0;
 
-	setVertexAttributes(VertexAttributes(), BufferBindings());
+	defaultVertexArray = VertexArray();
+	currentVertexArray = &defaultVertexArray;
+
+	if (vertexArraysSupported)
+	{
+		GLint vao = 0;
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+		defaultVertexArray.vao = (GLuint) vao;
+	}
+
+	setVertexAttributes(VertexAttributesID(), VertexAttributes(), BufferBindings());
+
+	// Let the driver pick how many threads to use for background shader
+	// compilation, rather than its (possibly single-threaded) default.
+	if (isParallelShaderCompileSupported())
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
 
 	// Get the current viewport.
 	glGetIntegerv(GL_VIEWPORT, (GLint *) &state.viewport.x);
@@ -277,6 +296,8 @@ void OpenGL::setupContext()
 	if (isBufferUsageSupported(BUFFERUSAGE_SHADER_STORAGE))
 		state.boundIndexedBuffers[BUFFERUSAGE_SHADER_STORAGE].resize(maxShaderStorageBufferBindings, 0);
 
+	state.boundIndexedBuffers[BUFFERUSAGE_UNIFORM].resize(maxUniformBufferBindings, 0);
+
 	// Initialize multiple texture unit support for shaders.
 	for (int i = 0; i < TEXTURE_MAX_ENUM + 1; i++)
 	{
@@ -310,6 +331,10 @@ void OpenGL::deInitContext()
 	if (!contextInitialized)
 		return;
 
+	// Deleting a bound VAO reverts the binding to 0, so there's no need to
+	// rebind the default one (which may already be deleted at this point.)
+	deleteVertexArrays();
+
 	contextInitialized = false;
 }
 
@@ -382,6 +407,7 @@ void OpenGL::initOpenGLFunctions()
 
 void OpenGL::initMaxValues()
 {
+	vertexArraysSupported = GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0;
 	baseVertexSupported = GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_2 || GLAD_ARB_draw_elements_base_vertex
 		|| GLAD_OES_draw_elements_base_vertex || GLAD_EXT_draw_elements_base_vertex;
 
@@ -412,6 +438,8 @@ void OpenGL::initMaxValues()
 		maxShaderStorageBufferBindings = 0;
 	}
 
+	glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxUniformBufferBindings);
+
 	if (GLAD_ES_VERSION_3_1 || GLAD_VERSION_4_3)
 	{
 		glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &maxComputeWorkGroupsX);
@@ -679,6 +707,30 @@ void OpenGL::deleteBuffer(GLuint buffer)
 {
 	glDeleteBuffers(1, &buffer);
 
+	// Cached VAOs keep referencing a deleted buffer, and its name can be
+	// reused by a new buffer later.
+	for (auto it = vertexArrays.begin(); it != vertexArrays.end(); )
+	{
+		const VertexArrayKey &key = it->first;
+		VertexArray &vertexarray = it->second;
+
+		bool referenced = &vertexarray != currentVertexArray && vertexarray.indexBuffer == buffer;
+
+		for (int i = 0; i < MAX_VERTEX_ARRAY_BUFFERS; i++)
+			referenced = referenced || key.buffers[i] == buffer;
+
+		if (referenced)
+		{
+			if (&vertexarray == currentVertexArray)
+				bindVertexArray(&defaultVertexArray);
+
+			glDeleteVertexArrays(1, &vertexarray.vao);
+			it = vertexArrays.erase(it);
+		}
+		else
+			++it;
+	}
+
 	for (int i = 0; i < (int) BUFFERUSAGE_MAX_ENUM; i++)
 	{
 		if (state.boundBuffers[i] == buffer)
@@ -692,7 +744,112 @@ void OpenGL::deleteBuffer(GLuint buffer)
 	}
 }
 
-void OpenGL::setVertexAttributes(const VertexAttributes &attributes, const BufferBindings &buffers)
+void OpenGL::bindVertexArray(VertexArray *vertexarray)
+{
+	if (vertexarray == currentVertexArray)
+		return;
+
+	currentVertexArray->enabledAttribArrays = state.enabledAttribArrays;
+	currentVertexArray->instancedAttribArrays = state.instancedAttribArrays;
+	currentVertexArray->indexBuffer = state.boundBuffers[BUFFERUSAGE_INDEX];
+
+	glBindVertexArray(vertexarray->vao);
+
+	bool colorwasenabled = (state.enabledAttribArrays & ATTRIBFLAG_COLOR) != 0;
+
+	state.enabledAttribArrays = vertexarray->enabledAttribArrays;
+	state.instancedAttribArrays = vertexarray->instancedAttribArrays;
+	state.boundBuffers[BUFFERUSAGE_INDEX] = vertexarray->indexBuffer;
+
+	currentVertexArray = vertexarray;
+
+	// The constant color value is context state rather than VAO state, see
+	// applyVertexAttributes.
+	if (colorwasenabled && !(state.enabledAttribArrays & ATTRIBFLAG_COLOR))
+		glVertexAttrib4f(ATTRIB_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+void OpenGL::deleteVertexArrays()
+{
+	for (const auto &pair : vertexArrays)
+		glDeleteVertexArrays(1, &pair.second.vao);
+
+	vertexArrays.clear();
+	currentVertexArray = &defaultVertexArray;
+}
+
+void OpenGL::setVertexAttributes(VertexAttributesID attributesID, const VertexAttributes &attributes, const BufferBindings &buffers)
+{
+	uint32 usedbuffers = 0;
+	for (uint32 i = 0; i < VertexAttributes::MAX; i++)
+	{
+		if (attributes.isEnabled(i))
+			usedbuffers |= 1u << attributes.attribs[i].bufferIndex;
+	}
+
+	if (!vertexArraysSupported || !attributesID.isValid() || (usedbuffers >> MAX_VERTEX_ARRAY_BUFFERS) != 0)
+	{
+		bindVertexArray(&defaultVertexArray);
+		applyVertexAttributes(attributes, buffers);
+		return;
+	}
+
+	VertexArrayKey key = {};
+	key.attributesID = attributesID.id;
+
+	for (int i = 0; i < MAX_VERTEX_ARRAY_BUFFERS; i++)
+	{
+		if (usedbuffers & (1u << i))
+			key.buffers[i] = (GLuint) buffers.info[i].buffer->getHandle();
+	}
+
+	auto it = vertexArrays.find(key);
+
+	if (it == vertexArrays.end())
+	{
+		if (vertexArrays.size() >= MAX_CACHED_VERTEX_ARRAYS)
+		{
+			bindVertexArray(&defaultVertexArray);
+			deleteVertexArrays();
+		}
+
+		VertexArray vertexarray = {};
+		glGenVertexArrays(1, &vertexarray.vao);
+
+		it = vertexArrays.emplace(key, vertexarray).first;
+
+		bindVertexArray(&it->second);
+		applyVertexAttributes(attributes, buffers);
+
+		for (int i = 0; i < MAX_VERTEX_ARRAY_BUFFERS; i++)
+		{
+			if (usedbuffers & (1u << i))
+				it->second.offsets[i] = buffers.info[i].offset;
+		}
+
+		return;
+	}
+
+	VertexArray &vertexarray = it->second;
+	bindVertexArray(&vertexarray);
+
+	// Streamed vertex data (batched draws for example) uses the same buffers
+	// with a different offset each time, which needs new attribute pointers.
+	bool offsetschanged = false;
+	for (int i = 0; i < MAX_VERTEX_ARRAY_BUFFERS; i++)
+	{
+		if ((usedbuffers & (1u << i)) && vertexarray.offsets[i] != buffers.info[i].offset)
+		{
+			vertexarray.offsets[i] = buffers.info[i].offset;
+			offsetschanged = true;
+		}
+	}
+
+	if (offsetschanged)
+		applyVertexAttributes(attributes, buffers);
+}
+
+void OpenGL::applyVertexAttributes(const VertexAttributes &attributes, const BufferBindings &buffers)
 {
 	uint32 enablediff = attributes.enableBits ^ state.enabledAttribArrays;
 	uint32 instanceattribbits = 0;
@@ -1170,7 +1327,7 @@ void OpenGL::setSamplerState(TextureType target, SamplerState &s)
 	}
 }
 
-bool OpenGL::rawTexStorage(TextureType target, int levels, PixelFormat pixelformat, int width, int height, int depth)
+bool OpenGL::rawTexStorage(TextureType target, int levels, PixelFormat pixelformat, int width, int height, int depth, bool immutable)
 {
 	GLenum gltarget = getGLTextureType(target);
 	TextureFormat fmt = convertPixelFormat(pixelformat);
@@ -1189,7 +1346,7 @@ bool OpenGL::rawTexStorage(TextureType target, int levels, PixelFormat pixelform
 		glTexParameteri(gltarget, GL_TEXTURE_SWIZZLE_A, fmt.swizzle[3]);
 	}
 
-	bool usetexstorage = isTexStorageSupported();
+	bool usetexstorage = immutable && isTexStorageSupported();
 
 	// The fallback for bugs.brokenR8PixelFormat is GL_LUMINANCE, which doesn't have a sized
 	// version in ES3 so it can't be used with glTexStorage.
@@ -1293,6 +1450,21 @@ bool OpenGL::isCopyTextureToBufferSupported() const
 	return GLAD_VERSION_4_5 || GLAD_ARB_get_texture_sub_image;
 }
 
+bool OpenGL::isMultiDrawIndirectSupported() const
+{
+	return GLAD_VERSION_4_3 || GLAD_ARB_multi_draw_indirect;
+}
+
+bool OpenGL::isTimestampQuerySupported() const
+{
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query;
+}
+
+bool OpenGL::isParallelShaderCompileSupported() const
+{
+	return GLAD_ARB_parallel_shader_compile;
+}
+
 int OpenGL::getMax2DTextureSize() const
 {
 	return std::max(max2DTextureSize, 1);
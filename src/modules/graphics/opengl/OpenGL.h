@@ -34,9 +34,14 @@
 // GLAD
 #include "libraries/glad/gladfuncs.hpp"
 
+// xxHash
+#include "libraries/xxHash/xxhash.h"
+
 // C++
 #include <vector>
 #include <stack>
+#include <unordered_map>
+#include <cstring>
 
 // The last argument to AttribPointer takes a buffer offset casted to a pointer.
 #define BUFFER_OFFSET(i) ((char *) NULL + (i))
@@ -247,8 +252,8 @@ public:
 
 	/**
 	 * State-tracked glBindBuffer.
-	 * NOTE: This does not account for multiple VAOs being used! Index buffer
-	 * bindings are per-VAO in OpenGL, but this doesn't know about that.
+	 * Index buffer bindings are per-VAO in OpenGL, the tracked index buffer is
+	 * saved and restored when setVertexAttributes switches VAOs.
 	 **/
 	void bindBuffer(BufferUsage type, GLuint buffer);
 
@@ -258,9 +263,11 @@ public:
 	void deleteBuffer(GLuint buffer);
 
 	/**
-	 * Set all vertex attribute state.
+	 * Set all vertex attribute state. When VAOs are supported, each recurring
+	 * combination of vertex layout and vertex buffers gets its own cached VAO,
+	 * so switching between them only needs a bind.
 	 **/
-	void setVertexAttributes(const VertexAttributes &attributes, const BufferBindings &buffers);
+	void setVertexAttributes(VertexAttributesID attributesID, const VertexAttributes &attributes, const BufferBindings &buffers);
 
 	/**
 	 * Wrapper for glCullFace which eliminates redundant state setting.
@@ -357,16 +364,25 @@ public:
 
 	/**
 	 * Equivalent to glTexStorage2D/3D on platforms that support it. Equivalent
-	 * to glTexImage2D/3D for all levels and slices of a texture otherwise.
+	 * to glTexImage2D/3D for all levels and slices of a texture otherwise, or
+	 * when immutable is false.
 	 * NOTE: this does not handle compressed texture formats.
 	 **/
-	bool rawTexStorage(TextureType target, int levels, PixelFormat pixelformat, int width, int height, int depth = 1);
+	bool rawTexStorage(TextureType target, int levels, PixelFormat pixelformat, int width, int height, int depth = 1, bool immutable = true);
 
 	bool isBufferUsageSupported(BufferUsage usage) const;
 	bool isClampZeroOneTextureWrapSupported() const;
 	bool isSamplerLODBiasSupported() const;
 	bool isBaseVertexSupported() const;
 	bool isCopyTextureToBufferSupported() const;
+	bool isMultiDrawIndirectSupported() const;
+	bool isTimestampQuerySupported() const;
+
+	/**
+	 * Returns whether the driver can compile and link shaders in the
+	 * background without blocking on glCompileShader / glLinkProgram.
+	 **/
+	bool isParallelShaderCompileSupported() const;
 
 	/**
 	 * Returns the maximum supported width or height of a texture.
@@ -460,14 +476,59 @@ public:
 
 private:
 
+	static const int MAX_VERTEX_ARRAY_BUFFERS = 8;
+	static const size_t MAX_CACHED_VERTEX_ARRAYS = 64;
+
+	struct VertexArrayKey
+	{
+		int attributesID;
+		GLuint buffers[MAX_VERTEX_ARRAY_BUFFERS];
+
+		bool operator == (const VertexArrayKey &other) const
+		{
+			return memcmp(this, &other, sizeof(VertexArrayKey)) == 0;
+		}
+	};
+
+	struct VertexArrayKeyHasher
+	{
+		size_t operator() (const VertexArrayKey &key) const
+		{
+			return XXH32(&key, sizeof(VertexArrayKey), 0);
+		}
+	};
+
+	// Tracked state which OpenGL stores per-VAO rather than per-context.
+	struct VertexArray
+	{
+		GLuint vao;
+		uint32 enabledAttribArrays;
+		uint32 instancedAttribArrays;
+		GLuint indexBuffer;
+		size_t offsets[MAX_VERTEX_ARRAY_BUFFERS];
+	};
+
 	void initVendor();
 	void initOpenGLFunctions();
 	void initMaxValues();
 
+	void bindVertexArray(VertexArray *vertexarray);
+	void applyVertexAttributes(const VertexAttributes &attributes, const BufferBindings &buffers);
+	void deleteVertexArrays();
+
 	bool contextInitialized;
 
 	bool baseVertexSupported;
 
+	bool vertexArraysSupported;
+
+	// The VAO which was bound when the context was set up (0 or the one made
+	// by Graphics), used when a layout can't be cached.
+	VertexArray defaultVertexArray;
+	VertexArray *currentVertexArray;
+
+	std::unordered_map<VertexArrayKey, VertexArray, VertexArrayKeyHasher> vertexArrays;
+
 	float maxAnisotropy;
 	float maxLODBias;
 	int max2DTextureSize;
@@ -483,6 +544,7 @@ private:
 	int maxSamples;
 	int maxTextureUnits;
 	int maxShaderStorageBufferBindings;
+	int maxUniformBufferBindings;
 	float maxPointSize;
 
 	bool coreProfile;
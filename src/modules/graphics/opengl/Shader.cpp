@@ -41,11 +41,26 @@ namespace opengl
 Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const CompileOptions &options)
 	: love::graphics::Shader(stages, options)
 	, program(0)
+	, linkPending(false)
 	, builtinUniforms()
 	, builtinUniformInfo()
 {
-	// load shader source and create program object
-	loadVolatile();
+	if (options.async)
+	{
+		// The code is validated on a worker thread, and the program is set up
+		// by finishCompiling once that's done. If the driver can compile in
+		// the background as well, both can happen at the same time.
+		if (gl.isParallelShaderCompileSupported())
+		{
+			startLinking();
+			linkPending = true;
+		}
+	}
+	else
+	{
+		// load shader source and create program object
+		loadVolatile();
+	}
 }
 
 Shader::~Shader()
@@ -62,6 +77,9 @@ Shader::~Shader()
 
 void Shader::mapActiveUniforms()
 {
+	// The program's uniform values are reset when it's (re)linked.
+	builtinUniformDataUploaded = false;
+
 	// Built-in uniform locations default to -1 (nonexistent.)
 	for (int i = 0; i < int(BUILTIN_MAX_ENUM); i++)
 	{
@@ -171,8 +189,8 @@ void Shader::mapActiveUniforms()
 			else
 				u.dataSize = sizeof(uint32) * u.components * u.count;
 
-			u.data = malloc(u.dataSize);
-			memset(u.data, 0, u.dataSize);
+			u.data = malloc(u.dataSize * 2);
+			memset(u.data, 0, u.dataSize * 2);
 
 			const auto &valuesit = reflection.localUniformInitializerValues.find(u.name);
 			if (valuesit != reflection.localUniformInitializerValues.end())
@@ -200,7 +218,7 @@ void Shader::mapActiveUniforms()
 				u.ints[i] = startbinding + i;
 		}
 
-		updateUniform(&u, u.count, true);
+		uploadUniform(&u, u.count);
 
 		if (builtin != BUILTIN_MAX_ENUM)
 			builtinUniformInfo[(int)builtin] = &u;
@@ -275,10 +293,66 @@ void Shader::mapActiveUniforms()
 		}
 	}
 
+	if (!reflection.uniformBuffers.empty())
+	{
+		GLint numuniformblocks = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numuniformblocks);
+
+		char namebuffer[2048] = { '\0' };
+
+		for (int bindex = 0; bindex < numuniformblocks; bindex++)
+		{
+			GLsizei namelength = 0;
+			glGetActiveUniformBlockName(program, (GLuint) bindex, 2048, &namelength, namebuffer);
+
+			std::string name = canonicaliizeUniformName(std::string(namebuffer, namelength));
+
+			const auto &uniformit = reflection.uniformBuffers.find(name);
+			if (uniformit == reflection.uniformBuffers.end())
+			{
+				handleUnknownUniformName(name.c_str());
+				continue;
+			}
+
+			UniformInfo &u = uniformit->second;
+
+			u.active = true;
+
+			if (u.dataSize == 0)
+			{
+				u.dataSize = sizeof(int) * u.count;
+				u.data = malloc(u.dataSize);
+			}
+
+			// Like storage blocks, uniform block bindings are assigned here
+			// rather than in the shader code.
+			u.ints[0] = (int) activeUniformBufferBindings.size();
+			glUniformBlockBinding(program, (GLuint) bindex, (GLuint) u.ints[0]);
+
+			BufferBinding binding;
+			binding.bindingindex = u.ints[0];
+			binding.buffer = 0;
+			activeUniformBufferBindings.push_back(binding);
+
+			sendBuffers(&u, &activeBuffers[u.resourceIndex], u.count, true);
+		}
+	}
+
 	gl.useProgram(activeprogram);
 }
 
 bool Shader::loadVolatile()
+{
+	// Async shaders are linked by finishCompiling once they're validated.
+	if (!isValidated())
+		return true;
+
+	startLinking();
+	finishLinking();
+	return true;
+}
+
+void Shader::startLinking()
 {
 	OpenGL::TempDebugGroup debuggroup("Shader load");
 
@@ -287,6 +361,7 @@ bool Shader::loadVolatile()
 	textureUnits.push_back(TextureUnit());
 
 	activeStorageBufferBindings.clear();
+	activeUniformBufferBindings.clear();
 
 	storageBufferBindingIndexToActiveBinding.resize(gl.getMaxShaderStorageBufferBindings(), std::make_pair(-1, -1));
 	activeStorageBufferBindings.clear();
@@ -321,6 +396,24 @@ bool Shader::loadVolatile()
 	}
 
 	glLinkProgram(program);
+}
+
+void Shader::finishLinking()
+{
+	try
+	{
+		for (const auto &stage : stages)
+		{
+			if (stage.get() != nullptr)
+				((ShaderStage*)stage.get())->checkCompileStatus();
+		}
+	}
+	catch (love::Exception &)
+	{
+		glDeleteProgram(program);
+		program = 0;
+		throw;
+	}
 
 	GLint status;
 	glGetProgramiv(program, GL_LINK_STATUS, &status);
@@ -342,12 +435,36 @@ bool Shader::loadVolatile()
 		current = nullptr;
 		attach();
 	}
+}
 
-	return true;
+bool Shader::isReady()
+{
+	if (!love::graphics::Shader::isReady())
+		return false;
+
+	// Shaders which failed to compile are ready, the error is thrown on use.
+	if (!linkPending || !asyncError.empty())
+		return true;
+
+	GLint complete = GL_FALSE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_ARB, &complete);
+	return complete != GL_FALSE;
+}
+
+void Shader::finishCompiling()
+{
+	if (!linkPending)
+		startLinking();
+
+	linkPending = false;
+	finishLinking();
 }
 
 void Shader::unloadVolatile()
 {
+	// Reloading is always synchronous.
+	linkPending = false;
+
 	if (program != 0)
 	{
 		if (current == this)
@@ -411,9 +528,11 @@ std::string Shader::getWarnings() const
 
 void Shader::attach()
 {
+	waitUntilReady();
+
 	if (current != this)
 	{
-		Graphics::flushBatchedDrawsGlobal();
+		Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_SHADER);
 
 		gl.useProgram(program);
 		current = this;
@@ -441,12 +560,17 @@ void Shader::attach()
 		for (auto bufferbinding : activeStorageBufferBindings)
 			gl.bindIndexedBuffer(bufferbinding.buffer, BUFFERUSAGE_SHADER_STORAGE, bufferbinding.bindingindex);
 
+		for (auto bufferbinding : activeUniformBufferBindings)
+			gl.bindIndexedBuffer(bufferbinding.buffer, BUFFERUSAGE_UNIFORM, bufferbinding.bindingindex);
+
 		// send any pending uniforms to the shader program.
 		for (const auto &p : pendingUniformUpdates)
 			updateUniform(p.first, p.second, true);
 
 		pendingUniformUpdates.clear();
 	}
+
+	updateSharedUniformBuffers();
 }
 
 const Shader::UniformInfo *Shader::getUniformInfo(BuiltinUniform builtin) const
@@ -456,6 +580,7 @@ const Shader::UniformInfo *Shader::getUniformInfo(BuiltinUniform builtin) const
 
 void Shader::updateUniform(const UniformInfo *info, int count)
 {
+	waitUntilReady();
 	updateUniform(info, count, false);
 }
 
@@ -467,9 +592,29 @@ void Shader::updateUniform(const UniformInfo *info, int count, bool internalupda
 		return;
 	}
 
+	count = std::min(count, info->count);
+
+	// Sending the values a uniform already has doesn't need to break batches
+	// or call into the GL.
+	size_t size = (info->dataSize / std::max(info->count, 1)) * count;
+	if (info->data != nullptr && memcmp(info->data, getUploadedUniformData(info), size) == 0)
+		return;
+
 	if (!internalupdate)
 		flushBatchedDraws();
 
+	uploadUniform(info, count);
+}
+
+void Shader::uploadUniform(const UniformInfo *info, int count)
+{
+	if (info->data != nullptr)
+	{
+		size_t size = (info->dataSize / std::max(info->count, 1)) * count;
+		memcpy(getUploadedUniformData(info), info->data, size);
+		frameUniformBytesUploaded += (int64) size;
+	}
+
 	int location = info->location;
 	UniformType type = info->baseType;
 
@@ -623,6 +768,16 @@ void Shader::applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer
 		if (activeindex.second >= 0)
 			activeWritableStorageBuffers[activeindex.second] = isdefault ? nullptr : buffer;
 	}
+	else if (basetype == UNIFORM_UNIFORMBUFFER)
+	{
+		GLuint glbuffer = (GLuint)buffer->getHandle();
+		int bindingindex = info->ints[i];
+
+		if (shaderactive)
+			gl.bindIndexedBuffer(glbuffer, BUFFERUSAGE_UNIFORM, bindingindex);
+
+		activeUniformBufferBindings[bindingindex].buffer = glbuffer;
+	}
 }
 
 ptrdiff_t Shader::getHandle() const
@@ -632,6 +787,8 @@ ptrdiff_t Shader::getHandle() const
 
 int Shader::getVertexAttributeIndex(const std::string &name)
 {
+	waitUntilReady();
+
 	auto it = attributes.find(name);
 	if (it != attributes.end())
 		return it->second;
@@ -693,9 +850,19 @@ void Shader::updateBuiltinUniforms(love::graphics::Graphics *gfx, int viewportW,
 	data.constantColor = gfx->getColor();
 	gammaCorrectColor(data.constantColor);
 
+	// Consecutive draws often have identical built-in values.
+	if (builtinUniformDataUploaded && memcmp(&data, &uploadedBuiltinUniformData, sizeof(data)) == 0)
+		return;
+
 	GLint location = builtinUniforms[BUILTIN_UNIFORMS_PER_DRAW];
 	if (location >= 0)
+	{
 		glUniform4fv(location, 12, (const GLfloat *) &data);
+		frameUniformBytesUploaded += (int64) sizeof(data);
+	}
+
+	uploadedBuiltinUniformData = data;
+	builtinUniformDataUploaded = true;
 }
 
 } // opengl
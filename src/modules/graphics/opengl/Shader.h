@@ -62,6 +62,7 @@ public:
 	// Implements Shader.
 	void attach() override;
 	std::string getWarnings() const override;
+	bool isReady() override;
 	int getVertexAttributeIndex(const std::string &name) override;
 	const UniformInfo *getUniformInfo(BuiltinUniform builtin) const override;
 	void updateUniform(const UniformInfo *info, int count) override;
@@ -93,15 +94,33 @@ private:
 
 	void updateUniform(const UniformInfo *info, int count, bool internalupdate);
 
+	// Sends a uniform's values to the GL, whether or not they've changed.
+	void uploadUniform(const UniformInfo *info, int count);
+
+	// The values last sent to the GL are kept right after each uniform's own
+	// values, in the same allocation.
+	uint8 *getUploadedUniformData(const UniformInfo *info) const { return (uint8 *) info->data + info->dataSize; }
+
 	void applyTexture(const UniformInfo *info, int i, love::graphics::Texture *texture, UniformType basetype, bool isdefault) override;
 	void applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer *buffer, UniformType basetype, bool isdefault) override;
+	void finishCompiling() override;
 
 	// Get any warnings or errors generated only by the shader program object.
 	std::string getProgramWarnings() const;
 
+	// Issues the compile and link commands for the program. The driver may do
+	// the work in the background if parallel shader compilation is supported.
+	void startLinking();
+
+	// Blocks until linking is done, and sets up reflection state.
+	void finishLinking();
+
 	// volatile
 	GLuint program;
 
+	// Whether an async compile was started and finishLinking hasn't run yet.
+	bool linkPending;
+
 	// Location values for any built-in uniform variables.
 	GLint builtinUniforms[BUILTIN_MAX_ENUM];
 	UniformInfo *builtinUniformInfo[BUILTIN_MAX_ENUM];
@@ -116,10 +135,16 @@ private:
 	std::vector<std::pair<int, int>> storageBufferBindingIndexToActiveBinding;
 	std::vector<BufferBinding> activeStorageBufferBindings;
 
+	// Indexed by the uniform block binding assigned in mapActiveUniforms.
+	std::vector<BufferBinding> activeUniformBufferBindings;
+
 	std::vector<Buffer *> activeWritableStorageBuffers;
 
 	std::vector<std::pair<const UniformInfo *, int>> pendingUniformUpdates;
 
+	BuiltinUniformData uploadedBuiltinUniformData;
+	bool builtinUniformDataUploaded = false;
+
 }; // Shader
 
 } // opengl
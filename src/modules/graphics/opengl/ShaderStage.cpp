@@ -30,6 +30,7 @@ namespace opengl
 ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey)
 	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey)
 	, glShader(0)
+	, compileStatusChecked(false)
 {
 	loadVolatile();
 }
@@ -68,8 +69,37 @@ bool ShaderStage::loadVolatile()
 	GLint srclen = (GLint) sourcestring.length();
 
 	glShaderSource(glShader, 1, (const GLchar **)&src, &srclen);
+
+	// Querying the compile status blocks until the driver is done, so that's
+	// deferred to checkCompileStatus (called before or after linking).
 	glCompileShader(glShader);
 
+	compileStatusChecked = false;
+	compileError.clear();
+
+	return true;
+}
+
+void ShaderStage::unloadVolatile()
+{
+	if (glShader != 0)
+		glDeleteShader(glShader);
+
+	glShader = 0;
+	compileStatusChecked = false;
+}
+
+void ShaderStage::checkCompileStatus()
+{
+	if (compileStatusChecked)
+	{
+		if (!compileError.empty())
+			throw love::Exception("%s", compileError.c_str());
+		return;
+	}
+
+	compileStatusChecked = true;
+
 	GLint infologlen;
 	glGetShaderiv(glShader, GL_INFO_LOG_LENGTH, &infologlen);
 
@@ -87,19 +117,12 @@ bool ShaderStage::loadVolatile()
 
 	if (status == GL_FALSE)
 	{
-		glDeleteShader(glShader);
-		throw love::Exception("Cannot compile %s shader code:\n%s", typestr, warnings.c_str());
-	}
-
-	return true;
-}
+		const char *typestr = "unknown";
+		getConstant(getStageType(), typestr);
 
-void ShaderStage::unloadVolatile()
-{
-	if (glShader != 0)
-		glDeleteShader(glShader);
-
-	glShader = 0;
+		compileError = std::string("Cannot compile ") + typestr + " shader code:\n" + warnings;
+		throw love::Exception("%s", compileError.c_str());
+	}
 }
 
 } // opengl
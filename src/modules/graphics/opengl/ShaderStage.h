@@ -44,9 +44,15 @@ public:
 	bool loadVolatile() override;
 	void unloadVolatile() override;
 
+	// Blocks until the driver has compiled the shader, and throws an exception
+	// if compilation failed.
+	void checkCompileStatus();
+
 private:
 
 	GLuint glShader;
+	bool compileStatusChecked;
+	std::string compileError;
 
 }; // ShaderStage
 
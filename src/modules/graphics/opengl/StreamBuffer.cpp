@@ -25,6 +25,7 @@
 #include "graphics/Volatile.h"
 #include "common/Exception.h"
 #include "common/memory.h"
+#include "timer/Timer.h"
 
 #include <vector>
 #include <algorithm>
@@ -226,6 +227,15 @@ public:
 
 protected:
 
+	// Makes sure this frame's section of the buffer is done being used.
+	void waitForFrame()
+	{
+		double start = love::timer::Timer::getTime();
+
+		if (syncs[frameIndex].cpuWait())
+			frameStallTime += love::timer::Timer::getTime() - start;
+	}
+
 	int frameIndex;
 	FenceSync syncs[BUFFER_FRAMES];
 
@@ -252,8 +262,7 @@ public:
 	{
 		gl.bindBuffer(mode, vbo);
 
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -334,8 +343,7 @@ public:
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -437,8 +445,7 @@ public:
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -232,8 +232,10 @@ Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const
 	}
 
 	// ImageData is referenced by the first loadVolatile call, but we don't
-	// hang on to it after that so we can save memory.
-	slices.clear();
+	// hang on to it after that so we can save memory. Evictable textures keep
+	// it so evicted mipmap levels can be reloaded.
+	if (!evictable)
+		slices.clear();
 }
 
 Texture::Texture(love::graphics::Graphics *gfx, love::graphics::Texture *base, const Texture::ViewSettings &viewsettings)
@@ -305,20 +307,28 @@ void Texture::createTexture()
 	// correct value for all compressed texture formats, and I also vaguely
 	// remember some driver issues on some old Android systems, maybe...
 	// For now, the base class enforces data on init for compressed textures.
+	// Evictable textures free and reallocate individual mipmap levels, which
+	// needs mutable storage.
 	if (!isCompressed())
-		gl.rawTexStorage(texType, mipcount, format, pixelWidth, pixelHeight, texType == TEXTURE_VOLUME ? depth : layers);
+		gl.rawTexStorage(texType, mipcount, format, pixelWidth, pixelHeight, texType == TEXTURE_VOLUME ? depth : layers, !evictable);
 
 	// rawTexStorage handles this for uncompressed textures.
 	if (isCompressed())
 		glTexParameteri(gltype, GL_TEXTURE_MAX_LEVEL, mipcount - 1);
 
-	int w = pixelWidth;
-	int h = pixelHeight;
-	int d = depth;
+	// Streaming textures start out with only their smallest levels. The rest
+	// are uploaded by setResidentMipmap as they're needed.
+	int firstmip = 0;
+	if (streaming && (GLAD_VERSION_1_2 || GLAD_ES_VERSION_3_0))
+		firstmip = getInitialStreamingMipmap();
+
+	int w = getPixelWidth(firstmip);
+	int h = getPixelHeight(firstmip);
+	int d = texType == TEXTURE_VOLUME ? getDepth(firstmip) : depth;
 
 	OpenGL::TextureFormat fmt = gl.convertPixelFormat(format);
 
-	for (int mip = 0; mip < mipcount; mip++)
+	for (int mip = firstmip; mip < mipcount; mip++)
 	{
 		if (isCompressed() && (texType == TEXTURE_2D_ARRAY || texType == TEXTURE_VOLUME))
 		{
@@ -350,6 +360,16 @@ void Texture::createTexture()
 			d = std::max(d / 2, 1);
 	}
 
+	if (firstmip > 0)
+	{
+		glTexParameteri(gltype, GL_TEXTURE_BASE_LEVEL, firstmip);
+
+		for (int mip = 0; mip < firstmip; mip++)
+			allocateMipmap(mip, true);
+
+		residentMipmap = firstmip;
+	}
+
 	bool hasdata = slices.get(0, 0) != nullptr;
 
 	// All mipmap levels need to be initialized - for color formats we can clear
@@ -412,6 +432,8 @@ bool Texture::loadVolatile()
 	framebufferStatus = GL_FRAMEBUFFER_COMPLETE;
 	textureGLError = GL_NO_ERROR;
 
+	residentMipmap = 0;
+
 	if (isReadable())
 		createTexture();
 
@@ -509,6 +531,9 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 
 void Texture::generateMipmapsInternal()
 {
+	if (residentMipmap > 0)
+		setResidentMipmap(0);
+
 	gl.bindTextureToUnit(this, 0, false);
 
 	GLenum gltextype = OpenGL::getGLTextureType(texType);
@@ -521,6 +546,9 @@ void Texture::generateMipmapsInternal()
 
 void Texture::readbackInternal(int slice, int mipmap, const Rect &rect, int destwidth, size_t size, void *dest)
 {
+	if (residentMipmap > 0)
+		setResidentMipmap(0);
+
 	// Not supported in GL with compressed textures...
 	if (!isCompressed())
 		glPixelStorei(GL_PACK_ROW_LENGTH, destwidth);
@@ -595,6 +623,104 @@ void Texture::copyToBuffer(love::graphics::Buffer *dest, int slice, int mipmap,
 	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
+void Texture::allocateMipmap(int mipmap, bool empty)
+{
+	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(format);
+	GLenum gltarget = OpenGL::getGLTextureType(texType);
+
+	int w = empty ? 0 : getPixelWidth(mipmap);
+	int h = empty ? 0 : getPixelHeight(mipmap);
+	int d = empty ? 0 : (texType == TEXTURE_VOLUME ? getDepth(mipmap) : layers);
+	size_t size = empty ? 0 : getPixelFormatSliceSize(format, w, h);
+
+	if (texType == TEXTURE_2D || texType == TEXTURE_CUBE)
+	{
+		int faces = texType == TEXTURE_CUBE ? 6 : 1;
+		for (int face = 0; face < faces; face++)
+		{
+			if (texType == TEXTURE_CUBE)
+				gltarget = GL_TEXTURE_CUBE_MAP_POSITIVE_X + face;
+
+			if (isCompressed())
+				glCompressedTexImage2D(gltarget, mipmap, fmt.internalformat, w, h, 0, size, nullptr);
+			else
+				glTexImage2D(gltarget, mipmap, fmt.internalformat, w, h, 0, fmt.externalformat, fmt.type, nullptr);
+		}
+	}
+	else if (texType == TEXTURE_2D_ARRAY || texType == TEXTURE_VOLUME)
+	{
+		if (isCompressed())
+			glCompressedTexImage3D(gltarget, mipmap, fmt.internalformat, w, h, d, 0, size * d, nullptr);
+		else
+			glTexImage3D(gltarget, mipmap, fmt.internalformat, w, h, d, 0, fmt.externalformat, fmt.type, nullptr);
+	}
+}
+
+bool Texture::setResidentMipmap(int mipmap)
+{
+	if (!evictable || texture == 0 || slices.get(0, 0) == nullptr)
+		return false;
+
+	// GL_TEXTURE_BASE_LEVEL is needed to sample from a smaller mipmap level.
+	if (!(GLAD_VERSION_1_2 || GLAD_ES_VERSION_3_0))
+		return false;
+
+	mipmap = std::max(0, std::min(mipmap, getMipmapCount() - 1));
+
+	if (mipmap == residentMipmap)
+		return true;
+
+	OpenGL::TempDebugGroup debuggroup("Texture residency change");
+
+	gl.bindTextureToUnit(this, 0, false);
+
+	GLenum gltype = OpenGL::getGLTextureType(texType);
+	int oldmipmap = residentMipmap;
+
+	if (mipmap > oldmipmap)
+	{
+		// Sample from the new base level before the larger ones are freed, so
+		// the texture stays complete.
+		glTexParameteri(gltype, GL_TEXTURE_BASE_LEVEL, mipmap);
+
+		for (int mip = oldmipmap; mip < mipmap; mip++)
+			allocateMipmap(mip, true);
+
+		residentMipmap = mipmap;
+	}
+	else
+	{
+		// Mipmaps which were generated rather than given as data can only be
+		// rebuilt from the base level.
+		bool hasmipdata = slices.getMipmapCount() > 1;
+		if (!hasmipdata)
+			mipmap = 0;
+
+		for (int mip = mipmap; mip < oldmipmap; mip++)
+			allocateMipmap(mip, false);
+
+		residentMipmap = mipmap;
+
+		for (int mip = mipmap; mip < (hasmipdata ? oldmipmap : 1); mip++)
+		{
+			for (int slice = 0; slice < slices.getSliceCount(mip); slice++)
+			{
+				love::image::ImageDataBase *id = slices.get(slice, mip);
+				if (id != nullptr)
+					uploadImageData(id, mip, slice, 0, 0);
+			}
+		}
+
+		glTexParameteri(gltype, GL_TEXTURE_BASE_LEVEL, mipmap);
+
+		if (!hasmipdata)
+			generateMipmapsInternal();
+	}
+
+	updateGraphicsMemorySize(true);
+	return true;
+}
+
 void Texture::setSamplerState(const SamplerState &s)
 {
 	samplerState = validateSamplerState(s);
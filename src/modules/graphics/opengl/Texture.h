@@ -52,6 +52,8 @@ public:
 
 	void setSamplerState(const SamplerState &s) override;
 
+	bool setResidentMipmap(int mipmap) override;
+
 	ptrdiff_t getHandle() const override;
 	ptrdiff_t getRenderTargetHandle() const override;
 	ptrdiff_t getSamplerHandle() const override { return 0; }
@@ -64,6 +66,7 @@ public:
 private:
 
 	void createTexture();
+	void allocateMipmap(int mipmap, bool empty);
 
 	void uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r) override;
 
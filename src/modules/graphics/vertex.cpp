@@ -379,6 +379,7 @@ STRINGMAP_BEGIN(BufferUsage, BUFFERUSAGE_MAX_ENUM, bufferUsageName)
 	{ "vertex",            BUFFERUSAGE_VERTEX             },
 	{ "index",             BUFFERUSAGE_INDEX              },
 	{ "texel",             BUFFERUSAGE_TEXEL              },
+	{ "uniform",           BUFFERUSAGE_UNIFORM            },
 	{ "shaderstorage",     BUFFERUSAGE_SHADER_STORAGE     },
 	{ "indirectarguments", BUFFERUSAGE_INDIRECT_ARGUMENTS },
 }
@@ -81,6 +81,11 @@ Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const st
 		barrierDstAccessFlags |= VK_ACCESS_SHADER_READ_BIT;
 		barrierDstStageFlags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 	}
+	if (usageFlags & BUFFERUSAGEFLAG_UNIFORM)
+	{
+		barrierDstAccessFlags |= VK_ACCESS_UNIFORM_READ_BIT;
+		barrierDstStageFlags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	}
 	if (usageFlags & BUFFERUSAGEFLAG_SHADER_STORAGE)
 	{
 		barrierDstAccessFlags |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
@@ -109,7 +114,7 @@ bool Buffer::loadVolatile()
 	if (dataUsage == BUFFERDATAUSAGE_READBACK)
 		allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-	auto result = vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, &allocInfo);
+	auto result = vgfx->createBuffer(bufferInfo, allocCreateInfo, buffer, allocation, &allocInfo);
 	if (result != VK_SUCCESS)
 		throw love::Exception("Failed to create Vulkan buffer: %s", Vulkan::getErrorString(result));
 
@@ -262,6 +267,8 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 
 	memcpy(fillAllocInfo.pMappedData, data, size);
 
+	frameBytesUploaded += size;
+
 	VkMemoryPropertyFlags memoryProperties;
 	vmaGetAllocationMemoryProperties(allocator, fillAllocation, &memoryProperties);
 	if (~memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
@@ -23,9 +23,13 @@
 #include "common/version.h"
 #include "common/memory.h"
 #include "window/Window.h"
+#include "timer/Timer.h"
+#include "profiler/Profiler.h"
 #include "Buffer.h"
 #include "Graphics.h"
 #include "GraphicsReadback.h"
+#include "OcclusionQuery.h"
+#include "TextureUpload.h"
 #include "Shader.h"
 #include "Vulkan.h"
 
@@ -211,6 +215,11 @@ love::graphics::Buffer *Graphics::newBuffer(const love::graphics::Buffer::Settin
 	return new Buffer(this, settings, format, data, size, arraylength);
 }
 
+love::graphics::OcclusionQuery *Graphics::newOcclusionQuery()
+{
+	return new OcclusionQuery(this);
+}
+
 void Graphics::clear(OptionalColorD color, OptionalInt stencil, OptionalDouble depth)
 {
 	if (!color.hasValue && !stencil.hasValue && !depth.hasValue)
@@ -229,7 +238,7 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 	if (colors.empty() && !stencil.hasValue && !depth.hasValue)
 		return;
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_RENDER_TARGET);
 
 	const auto &rts = states.back().renderTargets;
 	bool rtactive = isRenderTargetActive();
@@ -349,7 +358,16 @@ void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 
 void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallbackData)
 {
-	flushBatchedDraws();
+	// Queries can't span command buffers.
+	if (submitMode != SUBMIT_NOPRESENT && getActiveOcclusionQuery() != nullptr)
+		throw love::Exception("An occlusion query cannot be active when presenting or waiting for the GPU.");
+
+	if (submitMode == SUBMIT_PRESENT)
+		flushBatchedDraws(BATCHFLUSH_PRESENT);
+	else if (submitMode == SUBMIT_RESTART)
+		flushBatchedDraws(BATCHFLUSH_READBACK);
+	else
+		flushBatchedDraws();
 
 	if (renderPassState.active)
 		endRenderPass();
@@ -552,6 +570,8 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 
 void Graphics::present(void *screenshotCallbackdata)
 {
+	LOVE_PROFILE_ZONE("love.graphics.present");
+
 	if (!isActive())
 		return;
 
@@ -600,18 +620,33 @@ void Graphics::present(void *screenshotCallbackdata)
 	else if (result != VK_SUCCESS)
 		throw love::Exception("failed to present swap chain image");
 
-	for (love::graphics::StreamBuffer *buffer : batchedDrawState.vb)
-		buffer->nextFrame();
-	batchedDrawState.indexBuffer->nextFrame();
+	// beginFrame already waits on the fence from framesInFlight frames ago,
+	// so only lower latencies need an extra wait.
+	uint32_t framesinflight = Vulkan::getFramesInFlight();
+	if (frameLatency > 0 && (uint32_t) frameLatency < framesinflight)
+	{
+		uint32_t waitframe = (currentFrame + framesinflight - (frameLatency - 1)) % framesinflight;
+		vkWaitForFences(device, 1, &inFlightFences[waitframe], VK_TRUE, UINT64_MAX);
+	}
+
+	updateBatchedDrawBuffers();
 
 	drawCalls = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	memset(batchFlushCounts, 0, sizeof(batchFlushCounts));
+	Buffer::frameBytesUploaded = 0;
+	Shader::frameUniformBytesUploaded = 0;
+	StreamBuffer::frameStallTime = 0.0;
 
 	updatePendingReadbacks();
+	updateMainThreadJobs();
+	updatePendingTextureUploads();
+	updateGPUTimers();
+	updateTextureResidency();
 	updateTemporaryResources();
 
-	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+	currentFrame = (currentFrame + 1) % Vulkan::getFramesInFlight();
 	realFrameIndex++;
 
 	beginFrame();
@@ -655,11 +690,21 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 	// Must be called before the swapchain is created.
 	backbufferChanged(width, height, pixelwidth, pixelheight, backbufferstencil, backbufferdepth, msaa);
 
+	// Anything still queued belongs to the previous mode, e.g. retired swap
+	// chains.
+	if (device != VK_NULL_HANDLE)
+	{
+		vkDeviceWaitIdle(device);
+		for (auto &cleanUpFns : cleanUpFunctions)
+			for (auto &cleanUpFn : cleanUpFns)
+				cleanUpFn();
+	}
+
 	cleanUpFunctions.clear();
-	cleanUpFunctions.resize(MAX_FRAMES_IN_FLIGHT);
+	cleanUpFunctions.resize(Vulkan::getFramesInFlight());
 
 	readbackCallbacks.clear();
-	readbackCallbacks.resize(MAX_FRAMES_IN_FLIGHT);
+	readbackCallbacks.resize(Vulkan::getFramesInFlight());
 
 	bool createBaseObjects = physicalDevice == VK_NULL_HANDLE;
 
@@ -687,6 +732,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 		createCommandPool();
 		createCommandBuffers();
 		createSyncObjects();
+		createTimestampQueryPools();
 	}
 
 	if (localUniformBuffer == nullptr)
@@ -758,6 +804,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 	created = true;
 	drawCalls = 0;
 	drawCallsBatched = 0;
+	memset(batchFlushCounts, 0, sizeof(batchFlushCounts));
 
 	return true;
 }
@@ -777,11 +824,15 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_TEXEL_BUFFER] = true;
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = true;
 	capabilities.features[FEATURE_INDIRECT_DRAW] = true;
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = true;
+	static_assert(FEATURE_MAX_ENUM == 15, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	VkPhysicalDeviceProperties properties;
 	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 
+	capabilities.features[FEATURE_GPU_TIMESTAMPS] = properties.limits.timestampComputeAndGraphics == VK_TRUE;
+	timestampPeriod = properties.limits.timestampPeriod;
+
 	capabilities.limits[LIMIT_POINT_SIZE] = properties.limits.pointSizeRange[1];
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = properties.limits.maxImageDimension2D;
 	capabilities.limits[LIMIT_TEXTURE_LAYERS] = properties.limits.maxImageArrayLayers;
@@ -803,11 +854,93 @@ void Graphics::initCapabilities()
 	capabilities.textureTypes[TEXTURE_CUBE] = true;
 }
 
+void Graphics::writeTimestampQuery(int frame, int index)
+{
+	vkCmdWriteTimestamp(commandBuffers.at(currentFrame), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPools[frame], (uint32) index);
+}
+
+bool Graphics::getTimestampQueryResults(int frame, int count, uint64 *results)
+{
+	if (timestampQueryPools.empty() || count <= 0)
+		return false;
+
+	VkResult result = vkGetQueryPoolResults(
+		device, timestampQueryPools[frame], 0, (uint32) count,
+		sizeof(uint64) * count, results, sizeof(uint64), VK_QUERY_RESULT_64_BIT);
+
+	if (result != VK_SUCCESS)
+		return false;
+
+	// Convert from timestamp ticks to nanoseconds.
+	for (int i = 0; i < count; i++)
+		results[i] = (uint64) ((double) results[i] * timestampPeriod);
+
+	return true;
+}
+
 void Graphics::getAPIStats(int &shaderswitches) const
 {
 	shaderswitches = static_cast<int>(Vulkan::getNumShaderSwitches());
 }
 
+void Graphics::getMemoryBudget(int64 &usage, int64 &budget) const
+{
+	usage = 0;
+	budget = 0;
+
+	if (vmaAllocator == VK_NULL_HANDLE)
+		return;
+
+	const VkPhysicalDeviceMemoryProperties *properties = nullptr;
+	vmaGetMemoryProperties(vmaAllocator, &properties);
+
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+	vmaGetHeapBudgets(vmaAllocator, budgets);
+
+	for (uint32 i = 0; i < properties->memoryHeapCount; i++)
+	{
+		if ((properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0)
+			continue;
+
+		usage += (int64) budgets[i].usage;
+		budget += (int64) budgets[i].budget;
+	}
+}
+
+VkResult Graphics::createImage(const VkImageCreateInfo &imageInfo, const VmaAllocationCreateInfo &allocInfo, VkImage &image, VmaAllocation &allocation)
+{
+	// Stay within the memory budget the OS gives us when possible, going over
+	// it can make the driver page memory in and out or fail allocations later.
+	VmaAllocationCreateInfo budgetInfo = allocInfo;
+	budgetInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+
+	VkResult result = vmaCreateImage(vmaAllocator, &imageInfo, &budgetInfo, &image, &allocation, nullptr);
+	if (result == VK_SUCCESS || allocInfo.usage != VMA_MEMORY_USAGE_AUTO)
+		return result;
+
+	// Over budget: spill to host memory the GPU can still use if the image
+	// supports it, and otherwise let the driver decide.
+	VmaAllocationCreateInfo hostInfo = allocInfo;
+	hostInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+
+	return vmaCreateImage(vmaAllocator, &imageInfo, &hostInfo, &image, &allocation, nullptr);
+}
+
+VkResult Graphics::createBuffer(const VkBufferCreateInfo &bufferInfo, const VmaAllocationCreateInfo &allocInfo, VkBuffer &buffer, VmaAllocation &allocation, VmaAllocationInfo *info)
+{
+	VmaAllocationCreateInfo budgetInfo = allocInfo;
+	budgetInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+
+	VkResult result = vmaCreateBuffer(vmaAllocator, &bufferInfo, &budgetInfo, &buffer, &allocation, info);
+	if (result == VK_SUCCESS || allocInfo.usage != VMA_MEMORY_USAGE_AUTO)
+		return result;
+
+	VmaAllocationCreateInfo hostInfo = allocInfo;
+	hostInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+
+	return vmaCreateBuffer(vmaAllocator, &bufferInfo, &hostInfo, &buffer, &allocation, info);
+}
+
 void Graphics::unSetMode()
 {
 	if (created)
@@ -815,6 +948,10 @@ void Graphics::unSetMode()
 
 	created = false;
 
+	// The filesystem module might not be around anymore by the time the
+	// device is destroyed, so save here as well.
+	savePipelineCache();
+
 	cleanupSwapChain(true);
 
 	if (surface != VK_NULL_HANDLE)
@@ -847,7 +984,7 @@ void Graphics::setFrontFaceWinding(Winding winding)
 	if (currentState.winding == winding)
 		return;
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().winding = winding;
 
@@ -859,14 +996,14 @@ void Graphics::setFrontFaceWinding(Winding winding)
 
 void Graphics::setColorMask(ColorChannelMask mask)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().colorMask = mask;
 }
 
 void Graphics::setBlendState(const BlendState &blend)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().blend = blend;
 }
@@ -874,7 +1011,7 @@ void Graphics::setBlendState(const BlendState &blend)
 void Graphics::setPointSize(float size)
 {
 	if (size != states.back().pointSize)
-		flushBatchedDraws();
+		flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().pointSize = size;
 }
@@ -901,16 +1038,36 @@ Graphics::RendererInfo Graphics::getRendererInfo() const
 
 void Graphics::draw(const DrawCommand &cmd)
 {
+	if (isConditionalRenderSkippingDraws())
+		return;
+
 	prepareDraw(cmd.attributesID, *cmd.buffers, cmd.texture, cmd.primitiveType, cmd.cullMode);
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		vkCmdDrawIndirect(
-			commandBuffers.at(currentFrame),
-			(VkBuffer) cmd.indirectBuffer->getHandle(),
-			cmd.indirectBufferOffset,
-			1,
-			0);
+		uint32 stride = (uint32) getIndirectArgsStride(INDIRECT_ARGS_DRAW_VERTICES);
+
+		if (multiDrawIndirectSupported)
+		{
+			vkCmdDrawIndirect(
+				commandBuffers.at(currentFrame),
+				(VkBuffer) cmd.indirectBuffer->getHandle(),
+				cmd.indirectBufferOffset,
+				(uint32) cmd.indirectDrawCount,
+				stride);
+		}
+		else
+		{
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+			{
+				vkCmdDrawIndirect(
+					commandBuffers.at(currentFrame),
+					(VkBuffer) cmd.indirectBuffer->getHandle(),
+					cmd.indirectBufferOffset + i * stride,
+					1,
+					stride);
+			}
+		}
 	}
 	else
 	{
@@ -927,22 +1084,41 @@ void Graphics::draw(const DrawCommand &cmd)
 
 void Graphics::draw(const DrawIndexedCommand &cmd)
 {
+	if (isConditionalRenderSkippingDraws())
+		return;
+
 	prepareDraw(cmd.attributesID, *cmd.buffers, cmd.texture, cmd.primitiveType, cmd.cullMode);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
+	bindIndexBuffer(
 		(VkBuffer) cmd.indexBuffer->getHandle(),
 		(VkDeviceSize) cmd.indexBufferOffset,
 		Vulkan::getVulkanIndexBufferType(cmd.indexType));
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		vkCmdDrawIndexedIndirect(
-			commandBuffers.at(currentFrame),
-			(VkBuffer) cmd.indirectBuffer->getHandle(),
-			cmd.indirectBufferOffset,
-			1,
-			0);
+		uint32 stride = (uint32) getIndirectArgsStride(INDIRECT_ARGS_DRAW_INDICES);
+
+		if (multiDrawIndirectSupported)
+		{
+			vkCmdDrawIndexedIndirect(
+				commandBuffers.at(currentFrame),
+				(VkBuffer) cmd.indirectBuffer->getHandle(),
+				cmd.indirectBufferOffset,
+				(uint32) cmd.indirectDrawCount,
+				stride);
+		}
+		else
+		{
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+			{
+				vkCmdDrawIndexedIndirect(
+					commandBuffers.at(currentFrame),
+					(VkBuffer) cmd.indirectBuffer->getHandle(),
+					cmd.indirectBufferOffset + i * stride,
+					1,
+					stride);
+			}
+		}
 	}
 	else
 	{
@@ -960,13 +1136,15 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 
 void Graphics::drawQuads(int start, int count, VertexAttributesID attributesID, const BufferBindings &buffers, graphics::Texture *texture)
 {
+	if (isConditionalRenderSkippingDraws())
+		return;
+
 	const int MAX_VERTICES_PER_DRAW = LOVE_UINT16_MAX;
 	const int MAX_QUADS_PER_DRAW = MAX_VERTICES_PER_DRAW / 4;
 
 	prepareDraw(attributesID, buffers, texture, PRIMITIVE_TRIANGLES, CULL_NONE);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
+	bindIndexBuffer(
 		(VkBuffer)quadIndexBuffer->getHandle(),
 		0,
 		Vulkan::getVulkanIndexBufferType(INDEX_UINT16));
@@ -1045,7 +1223,7 @@ void Graphics::applyScissor()
 
 void Graphics::setScissor(const Rect &rect)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().scissor = true;
 	states.back().scissorRect = rect;
@@ -1056,7 +1234,7 @@ void Graphics::setScissor(const Rect &rect)
 
 void Graphics::setScissor()
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().scissor = false;
 
@@ -1068,7 +1246,7 @@ void Graphics::setStencilState(const StencilState &s)
 {
 	validateStencilState(s);
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	vkCmdSetStencilWriteMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, s.writeMask);
 	
@@ -1089,7 +1267,7 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 {
 	validateDepthState(write);
 
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	if (optionalDeviceExtensions.extendedDynamicState)
 	{
@@ -1106,7 +1284,7 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 void Graphics::setWireframe(bool enable)
 {
-	flushBatchedDraws();
+	flushBatchedDraws(BATCHFLUSH_STATE);
 
 	states.back().wireframe = enable;
 }
@@ -1208,9 +1386,14 @@ graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method,
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
 }
 
-graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset)
 {
-	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty);
+	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty, destbytes, destbytesoffset);
+}
+
+graphics::TextureUpload *Graphics::newTextureUploadInternal(love::graphics::Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	return new TextureUpload(this, texture, data, slice, mipmap, x, y, reloadmipmaps);
 }
 
 graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles)
@@ -1322,6 +1505,21 @@ bool Graphics::dispatch(love::graphics::Shader *shader, love::graphics::Buffer *
 
 void Graphics::setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture)
 {
+	// Render passes only start when something is drawn, so an empty pass
+	// which should resolve the contents of earlier unresolved passes has to
+	// be started explicitly.
+	if (!renderPassState.active && !renderPassState.isWindow && renderPassState.renderPassConfiguration.staticData.resolve)
+	{
+		for (const auto &rt : states.back().renderTargets.colors)
+		{
+			if (rt.texture->isResolvePending())
+			{
+				startRenderPass();
+				break;
+			}
+		}
+	}
+
 	if (renderPassState.active)
 		endRenderPass();
 
@@ -1420,7 +1618,10 @@ void Graphics::beginSwapChainFrame()
 
 void Graphics::beginFrame()
 {
+	// Stream buffer sections for this frame are also protected by this fence.
+	double waitstart = love::timer::Timer::getTime();
 	vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+	StreamBuffer::frameStallTime += love::timer::Timer::getTime() - waitstart;
 
 	for (auto &readbackCallback : readbackCallbacks.at(currentFrame))
 		readbackCallback();
@@ -1430,6 +1631,9 @@ void Graphics::beginFrame()
 		cleanUpFn();
 	cleanUpFunctions.at(currentFrame).clear();
 
+	// Lets VMA refresh its memory budget numbers once per frame.
+	vmaSetCurrentFrameIndex(vmaAllocator, (uint32) realFrameIndex);
+
 	beginSwapChainFrame();
 
 	Vulkan::resetShaderSwitches();
@@ -1437,6 +1641,7 @@ void Graphics::beginFrame()
 	for (const auto &shader : usedShadersInFrame)
 		shader->newFrame(realFrameIndex);
 	usedShadersInFrame.clear();
+	lastUsedShaderInFrame = nullptr;
 
 	localUniformBuffer->nextFrame();
 }
@@ -1452,8 +1657,17 @@ void Graphics::startRecordingGraphicsCommands()
 	if (result != VK_SUCCESS)
 		throw love::Exception("Failed to begin recording Vulkan command buffer: %s", Vulkan::getErrorString(result));
 
+	resetBoundBufferState();
 	initDynamicState();
 
+	// Commands can be submitted more than once per frame, but the frame's
+	// timestamp queries must only be reset before the first submission.
+	if (!timestampQueryPools.empty() && timestampPoolResetFrame != realFrameIndex)
+	{
+		vkCmdResetQueryPool(commandBuffers.at(currentFrame), timestampQueryPools[currentGPUTimerFrame], 0, MAX_GPU_TIMER_QUERIES);
+		timestampPoolResetFrame = realFrameIndex;
+	}
+
 	// This must be done after vkBeginCommandBuffer (since newTexture needs an
 	// active command buffer for layout transitions), and before setDefaultRenderPass
 	// (since that tries to use fakeBackbuffer).
@@ -1789,6 +2003,8 @@ static void findOptionalDeviceExtensions(VkPhysicalDevice physicalDevice, Option
 			optionalDeviceExtensions.shaderFloatControls = true;
 		if (strcmp(extension.extensionName, VK_KHR_SPIRV_1_4_EXTENSION_NAME) == 0)
 			optionalDeviceExtensions.spirv14 = true;
+		if (strcmp(extension.extensionName, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) == 0)
+			optionalDeviceExtensions.pushDescriptor = true;
 	}
 }
 
@@ -1827,10 +2043,18 @@ void Graphics::createLogicalDevice()
 		optionalDeviceExtensions.spirv14 = false;
 	if (optionalDeviceExtensions.spirv14 && deviceApiVersion < VK_API_VERSION_1_1)
 		optionalDeviceExtensions.spirv14 = false;
+	if (optionalDeviceExtensions.pushDescriptor && deviceApiVersion < VK_API_VERSION_1_1)
+		optionalDeviceExtensions.pushDescriptor = false;
+
+	VkPhysicalDeviceFeatures supportedFeatures{};
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 	deviceFeatures.fillModeNonSolid = VK_TRUE;
+	deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+
+	multiDrawIndirectSupported = supportedFeatures.multiDrawIndirect == VK_TRUE;
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1851,6 +2075,8 @@ void Graphics::createLogicalDevice()
 		enabledExtensions.push_back(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME);
 	if (optionalDeviceExtensions.spirv14)
 		enabledExtensions.push_back(VK_KHR_SPIRV_1_4_EXTENSION_NAME);
+	if (optionalDeviceExtensions.pushDescriptor)
+		enabledExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
 	if (deviceApiVersion >= VK_API_VERSION_1_1)
 		enabledExtensions.push_back(VK_KHR_BIND_MEMORY_2_EXTENSION_NAME);
 
@@ -1877,18 +2103,103 @@ void Graphics::createLogicalDevice()
 
 	volkLoadDevice(device);
 
+	maxPushDescriptors = 0;
+	if (optionalDeviceExtensions.pushDescriptor)
+	{
+		VkPhysicalDevicePushDescriptorPropertiesKHR pushDescriptorProperties{};
+		pushDescriptorProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
+
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &pushDescriptorProperties;
+
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+		maxPushDescriptors = pushDescriptorProperties.maxPushDescriptors;
+	}
+
 	vkGetDeviceQueue(device, indices.graphicsFamily.value, 0, &graphicsQueue);
 	vkGetDeviceQueue(device, indices.presentFamily.value, 0, &presentQueue);
 }
 
+std::string Graphics::getPipelineCacheFilename() const
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	// The pipeline cache UUID changes whenever the driver's cache format
+	// does, but include the IDs and driver version so different GPUs or
+	// drivers never stomp on each other's files.
+	std::stringstream ss;
+	ss << "vulkan_" << std::hex << properties.vendorID << "_" << properties.deviceID << "_" << properties.driverVersion << "_";
+	for (uint8_t b : properties.pipelineCacheUUID)
+		ss << (b >> 4) << (b & 0xF);
+	ss << ".bin";
+
+	return ss.str();
+}
+
 void Graphics::createPipelineCache()
 {
 	VkPipelineCacheCreateInfo cacheInfo{};
 	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
+	std::vector<uint8> cacheData;
+	pipelineCacheSavedSize = 0;
+
+	if (readShaderCacheFile(getPipelineCacheFilename(), cacheData) && cacheData.size() >= sizeof(VkPipelineCacheHeaderVersionOne))
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		VkPipelineCacheHeaderVersionOne header;
+		memcpy(&header, cacheData.data(), sizeof(header));
+
+		// Drivers are supposed to validate this, but some don't.
+		if (header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+			&& header.vendorID == properties.vendorID
+			&& header.deviceID == properties.deviceID
+			&& memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0)
+		{
+			cacheInfo.initialDataSize = cacheData.size();
+			cacheInfo.pInitialData = cacheData.data();
+		}
+	}
+
 	VkResult result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache);
+
+	if (result != VK_SUCCESS && cacheInfo.pInitialData != nullptr)
+	{
+		cacheInfo.initialDataSize = 0;
+		cacheInfo.pInitialData = nullptr;
+		result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache);
+	}
+
 	if (result != VK_SUCCESS)
 		throw love::Exception("Could not create Vulkan pipeline cache: %s", Vulkan::getErrorString(result));
+
+	pipelineCacheSavedSize = cacheInfo.initialDataSize;
+}
+
+void Graphics::savePipelineCache()
+{
+	if (pipelineCache == VK_NULL_HANDLE || !isShaderCacheEnabled())
+		return;
+
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+		return;
+
+	// Pipeline caches only grow, so an unchanged size means nothing new to save.
+	if (size == pipelineCacheSavedSize)
+		return;
+
+	std::vector<uint8> data(size);
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) != VK_SUCCESS)
+		return;
+
+	writeShaderCacheFile(getPipelineCacheFilename(), data.data(), size);
+	pipelineCacheSavedSize = size;
 }
 
 void Graphics::initVMA()
@@ -1986,7 +2297,7 @@ void Graphics::createSwapChain()
 	SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice);
 
 	VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
-	VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+	presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
 	VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
 	if (extent.width > 0 && extent.height > 0)
@@ -2034,9 +2345,13 @@ void Graphics::createSwapChain()
 		if (result != VK_SUCCESS)
 			throw love::Exception("Failed to create Vulkan swap chain: %s", Vulkan::getErrorString(result));
 
+		// The old swap chain is retired by creating the new one, but frames in
+		// flight may still be presenting its images.
 		if (swapChain != VK_NULL_HANDLE)
 		{
-			vkDestroySwapchainKHR(device, swapChain, nullptr);
+			queueCleanUp([device = device, oldSwapChain = swapChain]() {
+				vkDestroySwapchainKHR(device, oldSwapChain, nullptr);
+			});
 			swapChain = VK_NULL_HANDLE;
 		}
 
@@ -2050,7 +2365,9 @@ void Graphics::createSwapChain()
 	{
 		if (swapChain != VK_NULL_HANDLE)
 		{
-			vkDestroySwapchainKHR(device, swapChain, nullptr);
+			queueCleanUp([device = device, oldSwapChain = swapChain]() {
+				vkDestroySwapchainKHR(device, oldSwapChain, nullptr);
+			});
 			swapChain = VK_NULL_HANDLE;
 		}
 
@@ -2128,6 +2445,9 @@ VkPresentModeKHR Graphics::chooseSwapPresentMode(const std::vector<VkPresentMode
 	const auto begin = availablePresentModes.begin();
 	const auto end = availablePresentModes.end();
 
+	if (requestedPresentMode != VK_PRESENT_MODE_MAX_ENUM_KHR && std::find(begin, end, requestedPresentMode) != end)
+		return requestedPresentMode;
+
 	switch (vsync)
 	{
 	case -1:
@@ -2272,7 +2592,7 @@ VkFramebuffer Graphics::getFramebuffer(FramebufferConfiguration &configuration)
 	return framebuffer;
 }
 
-void Graphics::cleanupFramebuffers(VkImageView imageView, PixelFormat format)
+void Graphics::cleanupFramebuffers(VkImageView imageView, PixelFormat format, std::vector<VkFramebuffer> *retired)
 {
 	bool depthstencil = isPixelFormatDepthStencil(format);
 
@@ -2310,7 +2630,10 @@ void Graphics::cleanupFramebuffers(VkImageView imageView, PixelFormat format)
 
 		if (foundView)
 		{
-			vkDestroyFramebuffer(device, it->second, nullptr);
+			if (retired != nullptr)
+				retired->push_back(it->second);
+			else
+				vkDestroyFramebuffer(device, it->second, nullptr);
 			it = framebuffers.erase(it);
 		}
 		else
@@ -2376,7 +2699,7 @@ VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
 		colorDescription.format = colorAttachment.format;
 		colorDescription.samples = colorAttachment.msaaSamples;
 		colorDescription.loadOp = colorAttachment.loadOp;
-		colorDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorDescription.storeOp = colorAttachment.storeOp;
 		colorDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		if (colorAttachment.msaaSamples > 1)
@@ -2419,9 +2742,9 @@ VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
 		depthStencilAttachment.format = configuration.staticData.depthStencilAttachment.format;
 		depthStencilAttachment.samples = configuration.staticData.depthStencilAttachment.msaaSamples;
 		depthStencilAttachment.loadOp = configuration.staticData.depthStencilAttachment.depthLoadOp;
-		depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthStencilAttachment.storeOp = configuration.staticData.depthStencilAttachment.storeOp;
 		depthStencilAttachment.stencilLoadOp = configuration.staticData.depthStencilAttachment.stencilLoadOp;
-		depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthStencilAttachment.stencilStoreOp = configuration.staticData.depthStencilAttachment.storeOp;
 		depthStencilAttachment.initialLayout = configuration.staticData.depthStencilAttachment.layout;
 		depthStencilAttachment.finalLayout = configuration.staticData.depthStencilAttachment.layout;
 		attachments.push_back(depthStencilAttachment);
@@ -2587,7 +2910,12 @@ void Graphics::prepareDraw(VertexAttributesID attributesID, const BufferBindings
 
 	auto s = dynamic_cast<Shader*>(Shader::current);
 
-	usedShadersInFrame.insert(s);
+	// Avoid a set lookup (and StrongRef churn) for every draw using the same shader.
+	if (s != lastUsedShaderInFrame)
+	{
+		usedShadersInFrame.insert(s);
+		lastUsedShaderInFrame = s;
+	}
 
 	GraphicsPipelineConfigurationFull configuration{};
 
@@ -2652,7 +2980,45 @@ void Graphics::prepareDraw(VertexAttributesID attributesID, const BufferBindings
 	}
 
 	if (buffercount > 0)
-		vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), VERTEX_BUFFER_BINDING_START, buffercount, vkbuffers, vkoffsets);
+	{
+		bool changed = buffercount > boundVertexBufferCount;
+		for (uint32 j = 0; j < buffercount && !changed; j++)
+			changed = vkbuffers[j] != boundVertexBuffers[j] || vkoffsets[j] != boundVertexBufferOffsets[j];
+
+		if (changed)
+		{
+			vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), VERTEX_BUFFER_BINDING_START, buffercount, vkbuffers, vkoffsets);
+
+			for (uint32 j = 0; j < buffercount; j++)
+			{
+				boundVertexBuffers[j] = vkbuffers[j];
+				boundVertexBufferOffsets[j] = vkoffsets[j];
+			}
+
+			boundVertexBufferCount = std::max(boundVertexBufferCount, buffercount);
+		}
+	}
+}
+
+void Graphics::bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType type)
+{
+	if (buffer == boundIndexBuffer && offset == boundIndexBufferOffset && type == boundIndexType)
+		return;
+
+	vkCmdBindIndexBuffer(commandBuffers.at(currentFrame), buffer, offset, type);
+
+	boundIndexBuffer = buffer;
+	boundIndexBufferOffset = offset;
+	boundIndexType = type;
+}
+
+void Graphics::resetBoundBufferState()
+{
+	// Bindings don't carry over between command buffers.
+	boundVertexBufferCount = 0;
+	boundIndexBuffer = VK_NULL_HANDLE;
+	boundIndexBufferOffset = 0;
+	boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
 }
 
 void Graphics::setDefaultRenderPass()
@@ -2737,6 +3103,13 @@ void Graphics::setDefaultRenderPass()
 	}
 }
 
+static VkAttachmentStoreOp getAttachmentStoreOp(Texture *texture)
+{
+	// Only the multisampled image of a readable MSAA texture is transient, its
+	// resolve attachment is always stored.
+	return texture->isTransient() ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+}
+
 void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh)
 {
 	RenderPassConfiguration renderPassConfiguration{};
@@ -2750,9 +3123,11 @@ void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh)
 			tex->getImageLayout(),
 			tex->getMSAAImageLayout(),
 			VK_ATTACHMENT_LOAD_OP_LOAD,
-			tex->getMsaaSamples() });
+			tex->getMsaaSamples(),
+			getAttachmentStoreOp(tex) });
 
-		if (tex->getMSAAImageLayout() != VK_IMAGE_LAYOUT_UNDEFINED && tex->getImageLayout() != VK_IMAGE_LAYOUT_UNDEFINED)
+		// Skipping the resolve keeps the multisampled contents for a later pass.
+		if (rts.resolve && tex->getMSAAImageLayout() != VK_IMAGE_LAYOUT_UNDEFINED && tex->getImageLayout() != VK_IMAGE_LAYOUT_UNDEFINED)
 			renderPassConfiguration.staticData.resolve = true;
 
 		msaa = tex->getMsaaSamples();
@@ -2766,7 +3141,8 @@ void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh)
 			tex->getImageLayout(),
 			VK_ATTACHMENT_LOAD_OP_LOAD,
 			VK_ATTACHMENT_LOAD_OP_LOAD,
-			tex->getMsaaSamples() };
+			tex->getMsaaSamples(),
+			getAttachmentStoreOp(tex) };
 
 		msaa = tex->getMsaaSamples();
 	}
@@ -2779,7 +3155,8 @@ void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh)
 		if (tex->getMSAA() > 1)
 		{
 			configuration.colorViews.push_back(tex->getMSAARenderTargetView(color.mipmap, color.slice));
-			configuration.colorResolveViews.push_back(tex->getRenderTargetView(color.mipmap, color.slice));
+			if (renderPassConfiguration.staticData.resolve)
+				configuration.colorResolveViews.push_back(tex->getRenderTargetView(color.mipmap, color.slice));
 		}
 		else
 		{
@@ -2850,6 +3227,23 @@ void Graphics::startRenderPass()
 	applyScissor();
 }
 
+void Graphics::beginQuery(VkQueryPool pool, uint32 index)
+{
+	if (renderPassState.active)
+		endRenderPass();
+
+	vkCmdResetQueryPool(commandBuffers.at(currentFrame), pool, index, 1);
+	vkCmdBeginQuery(commandBuffers.at(currentFrame), pool, index, 0);
+}
+
+void Graphics::endQuery(VkQueryPool pool, uint32 index)
+{
+	if (renderPassState.active)
+		endRenderPass();
+
+	vkCmdEndQuery(commandBuffers.at(currentFrame), pool, index);
+}
+
 void Graphics::endRenderPass()
 {
 	renderPassState.active = false;
@@ -2929,18 +3323,19 @@ VkSampler Graphics::getCachedSampler(const SamplerState &samplerState)
 	}
 }
 
-static uint64 getDescriptorPoolsKey(int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers)
+static uint64 getDescriptorPoolsKey(int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers, int uniformBuffers)
 {
 	return (((int64)dynamicUniformBuffers & 0xFF) << 0)
 		| (((int64)sampledTextures & 0xFF) << 8)
 		| (((int64)storageTextures & 0xFF) << 16)
 		| (((int64)texelBuffers    & 0xFF) << 24)
-		| (((int64)storageBuffers  & 0xFF) << 32);
+		| (((int64)storageBuffers  & 0xFF) << 32)
+		| (((int64)uniformBuffers  & 0xFF) << 40);
 }
 
-SharedDescriptorPools *Graphics::acquireDescriptorPools(int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers)
+SharedDescriptorPools *Graphics::acquireDescriptorPools(int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers, int uniformBuffers)
 {
-	uint64 key = getDescriptorPoolsKey(dynamicUniformBuffers, sampledTextures, storageTextures, texelBuffers, storageBuffers);
+	uint64 key = getDescriptorPoolsKey(dynamicUniformBuffers, sampledTextures, storageTextures, texelBuffers, storageBuffers, uniformBuffers);
 
 	auto it = sharedDescriptorPools.find(key);
 	if (it != sharedDescriptorPools.end())
@@ -2949,7 +3344,7 @@ SharedDescriptorPools *Graphics::acquireDescriptorPools(int dynamicUniformBuffer
 		return it->second.pools;
 	}
 
-	auto pools = new SharedDescriptorPools(device, dynamicUniformBuffers, sampledTextures, storageTextures, texelBuffers, storageBuffers);
+	auto pools = new SharedDescriptorPools(device, dynamicUniformBuffers, sampledTextures, storageTextures, texelBuffers, storageBuffers, uniformBuffers);
 
 	SharedDescriptorPoolsRef ref{};
 	ref.pools = pools;
@@ -2961,7 +3356,7 @@ SharedDescriptorPools *Graphics::acquireDescriptorPools(int dynamicUniformBuffer
 
 void Graphics::releaseDescriptorPools(SharedDescriptorPools *p)
 {
-	uint64 key = getDescriptorPoolsKey(p->dynamicUniformBuffers, p->sampledTextures, p->storageTextures, p->texelBuffers, p->storageBuffers);
+	uint64 key = getDescriptorPoolsKey(p->dynamicUniformBuffers, p->sampledTextures, p->storageTextures, p->texelBuffers, p->storageBuffers, p->uniformBuffers);
 
 	auto it = sharedDescriptorPools.find(key);
 	if (it != sharedDescriptorPools.end())
@@ -3170,9 +3565,10 @@ VkSampleCountFlagBits Graphics::getMsaaCount(int requestedMsaa) const
 
 void Graphics::setVsync(int vsync)
 {
-	if (vsync != this->vsync)
+	if (vsync != this->vsync || requestedPresentMode != VK_PRESENT_MODE_MAX_ENUM_KHR)
 	{
 		this->vsync = vsync;
+		requestedPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
 
 		// With the extension VK_EXT_swapchain_maintenance1 a swapchain recreation might not be needed
 		// https://github.com/KhronosGroup/Vulkan-Docs/blob/main/proposals/VK_EXT_swapchain_maintenance1.adoc
@@ -3188,6 +3584,39 @@ int Graphics::getVsync() const
 	return vsync;
 }
 
+void Graphics::setPresentMode(VkPresentModeKHR mode)
+{
+	if (mode == requestedPresentMode)
+		return;
+
+	requestedPresentMode = mode;
+
+	// Keep the vsync value consistent, it's used if the mode isn't supported.
+	// Mailbox doesn't tear, so it falls back to regular vsync.
+	switch (mode)
+	{
+	case VK_PRESENT_MODE_FIFO_KHR:
+	case VK_PRESENT_MODE_MAILBOX_KHR:
+		vsync = 1;
+		break;
+	case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+		vsync = -1;
+		break;
+	case VK_PRESENT_MODE_IMMEDIATE_KHR:
+		vsync = 0;
+		break;
+	default:
+		break;
+	}
+
+	requestSwapchainRecreation();
+}
+
+VkPresentModeKHR Graphics::getPresentMode() const
+{
+	return presentMode;
+}
+
 void Graphics::mapLocalUniformData(void *data, size_t size, VkDescriptorBufferInfo &bufferInfo)
 {
 	size_t alignedSize = alignUp(size, minUniformBufferOffsetAlignment);
@@ -3355,13 +3784,13 @@ void Graphics::createCommandPool()
 
 void Graphics::createCommandBuffers()
 {
-	commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+	commandBuffers.resize(Vulkan::getFramesInFlight());
 
 	VkCommandBufferAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	allocInfo.commandPool = commandPool;
 	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	allocInfo.commandBufferCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+	allocInfo.commandBufferCount = Vulkan::getFramesInFlight();
 
 	VkResult result = vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data());
 	if (result != VK_SUCCESS)
@@ -3370,9 +3799,9 @@ void Graphics::createCommandBuffers()
 
 void Graphics::createSyncObjects()
 {
-	imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-	renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-	inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+	imageAvailableSemaphores.resize(Vulkan::getFramesInFlight());
+	renderFinishedSemaphores.resize(Vulkan::getFramesInFlight());
+	inFlightFences.resize(Vulkan::getFramesInFlight());
 	imagesInFlight.resize(swapChainImages.size(), VK_NULL_HANDLE);
 
 	VkSemaphoreCreateInfo semaphoreInfo{};
@@ -3382,13 +3811,32 @@ void Graphics::createSyncObjects()
 	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	for (size_t i = 0; i < Vulkan::getFramesInFlight(); i++)
 		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores.at(i)) != VK_SUCCESS ||
 			vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores.at(i)) != VK_SUCCESS ||
 			vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences.at(i)) != VK_SUCCESS)
 			throw love::Exception("Failed to create Vulkan synchronization objects for a frame!");
 }
 
+void Graphics::createTimestampQueryPools()
+{
+	if (!capabilities.features[FEATURE_GPU_TIMESTAMPS])
+		return;
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = MAX_GPU_TIMER_QUERIES;
+
+	timestampQueryPools.resize(GPU_TIMER_FRAMES, VK_NULL_HANDLE);
+
+	for (VkQueryPool &pool : timestampQueryPools)
+	{
+		if (vkCreateQueryPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+			throw love::Exception("Failed to create Vulkan timestamp query pool.");
+	}
+}
+
 void Graphics::cleanup()
 {
 	for (auto &cleanUpFns : cleanUpFunctions)
@@ -3410,6 +3858,10 @@ void Graphics::cleanup()
 		vkDestroyFence(device, f, nullptr);
 	inFlightFences.clear();
 
+	for (VkQueryPool pool : timestampQueryPools)
+		vkDestroyQueryPool(device, pool, nullptr);
+	timestampQueryPools.clear();
+
 	if (!commandBuffers.empty())
 		vkFreeCommandBuffers(device, commandPool, (uint32)commandBuffers.size(), commandBuffers.data());
 	commandBuffers.clear();
@@ -3434,6 +3886,7 @@ void Graphics::cleanup()
 
 	if (pipelineCache != VK_NULL_HANDLE)
 	{
+		savePipelineCache();
 		vkDestroyPipelineCache(device, pipelineCache, nullptr);
 		pipelineCache = VK_NULL_HANDLE;
 	}
@@ -3483,17 +3936,72 @@ void Graphics::cleanupSwapChain(bool destroySwapChainObject)
 	}
 }
 
-void Graphics::recreateSwapChain()
+void Graphics::retireSwapChainResources()
 {
-	vkDeviceWaitIdle(device);
+	// Frames in flight may still use these, so they're destroyed once the
+	// current frame's fence has signaled instead of after waiting for the whole
+	// device to go idle.
+	std::vector<VkFramebuffer> retiredFramebuffers;
+	std::vector<VkImageView> retiredViews = swapChainImageViews;
+
+	for (VkImageView view : swapChainImageViews)
+		cleanupFramebuffers(view, swapChainPixelFormat, &retiredFramebuffers);
 
-	cleanupSwapChain(false);
+	if (colorImage)
+	{
+		cleanupFramebuffers(colorImageView, swapChainPixelFormat, &retiredFramebuffers);
+		retiredViews.push_back(colorImageView);
+	}
+
+	if (depthImage)
+	{
+		cleanupFramebuffers(depthImageView, depthStencilPixelFormat, &retiredFramebuffers);
+		retiredViews.push_back(depthImageView);
+	}
+
+	queueCleanUp([
+		device = device,
+		allocator = vmaAllocator,
+		retiredFramebuffers,
+		retiredViews,
+		colorImage = colorImage,
+		colorImageAllocation = colorImageAllocation,
+		depthImage = depthImage,
+		depthImageAllocation = depthImageAllocation] () {
+		for (VkFramebuffer framebuffer : retiredFramebuffers)
+			vkDestroyFramebuffer(device, framebuffer, nullptr);
+		for (VkImageView view : retiredViews)
+			vkDestroyImageView(device, view, nullptr);
+		if (colorImage != VK_NULL_HANDLE)
+			vmaDestroyImage(allocator, colorImage, colorImageAllocation);
+		if (depthImage != VK_NULL_HANDLE)
+			vmaDestroyImage(allocator, depthImage, depthImageAllocation);
+	});
+
+	colorImage = VK_NULL_HANDLE;
+	colorImageView = VK_NULL_HANDLE;
+	depthImage = VK_NULL_HANDLE;
+	depthImageView = VK_NULL_HANDLE;
+
+	swapChainImageViews.clear();
+	swapChainImages.clear();
+	fakeBackbuffer.set(nullptr);
+}
+
+void Graphics::recreateSwapChain()
+{
+	// Render passes and pipelines only depend on formats and sample counts,
+	// not the extent, so they're kept.
+	retireSwapChainResources();
 
 	createSwapChain();
 	createImageViews();
 	createColorResources();
 	createDepthResources();
 
+	// The new images haven't been used by any frame yet.
+	imagesInFlight.assign(swapChainImages.size(), VK_NULL_HANDLE);
+
 	transitionColorDepthLayouts = true;
 }
 
@@ -53,6 +53,7 @@ struct ColorAttachment
 	VkImageLayout msaaLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+	VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 
 	bool operator==(const ColorAttachment &attachment) const
 	{
@@ -60,7 +61,8 @@ struct ColorAttachment
 			layout == attachment.layout &&
 			msaaLayout == attachment.msaaLayout &&
 			loadOp == attachment.loadOp &&
-			msaaSamples == attachment.msaaSamples;
+			msaaSamples == attachment.msaaSamples &&
+			storeOp == attachment.storeOp;
 	}
 };
 
@@ -71,6 +73,7 @@ struct DepthStencilAttachment
 	VkAttachmentLoadOp depthLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	VkAttachmentLoadOp stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+	VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 
 	bool operator==(const DepthStencilAttachment &attachment) const
 	{
@@ -78,7 +81,8 @@ struct DepthStencilAttachment
 			layout == attachment.layout &&
 			depthLoadOp == attachment.depthLoadOp &&
 			stencilLoadOp == attachment.stencilLoadOp &&
-			msaaSamples == attachment.msaaSamples;
+			msaaSamples == attachment.msaaSamples &&
+			storeOp == attachment.storeOp;
 	}
 };
 
@@ -175,6 +179,9 @@ struct OptionalDeviceExtensions
 
 	// VK_KHR_spirv_1_4
 	bool spirv14 = false;
+
+	// VK_KHR_push_descriptor
+	bool pushDescriptor = false;
 };
 
 struct QueueFamilyIndices
@@ -234,8 +241,10 @@ public:
 	love::graphics::Texture *newTexture(const love::graphics::Texture::Settings &settings, const love::graphics::Texture::Slices *data) override;
 	love::graphics::Texture *newTextureView(love::graphics::Texture *base, const Texture::ViewSettings &viewsettings) override;
 	love::graphics::Buffer *newBuffer(const love::graphics::Buffer::Settings &settings, const std::vector<love::graphics::Buffer::DataDeclaration>& format, const void *data, size_t size, size_t arraylength) override;
+	love::graphics::OcclusionQuery *newOcclusionQuery() override;
 	graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) override;
-	graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty) override;
+	graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty, data::ByteData *destbytes, size_t destbytesoffset) override;
+	graphics::TextureUpload *newTextureUploadInternal(love::graphics::Texture *texture, image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps) override;
 	void clear(OptionalColorD color, OptionalInt stencil, OptionalDouble depth) override;
 	void clear(const std::vector<OptionalColorD> &colors, OptionalInt stencil, OptionalDouble depth) override;
 	void discard(const std::vector<bool>& colorbuffers, bool depthstencil) override;
@@ -268,12 +277,14 @@ public:
 
 	VkDevice getDevice() const;
 	VmaAllocator getVmaAllocator() const;
+	VkResult createImage(const VkImageCreateInfo &imageInfo, const VmaAllocationCreateInfo &allocInfo, VkImage &image, VmaAllocation &allocation);
+	VkResult createBuffer(const VkBufferCreateInfo &bufferInfo, const VmaAllocationCreateInfo &allocInfo, VkBuffer &buffer, VmaAllocation &allocation, VmaAllocationInfo *info);
 	VkCommandBuffer getCommandBufferForDataTransfer();
 	void queueCleanUp(std::function<void()> cleanUp);
 	void addReadbackCallback(std::function<void()> callback);
 	void submitGpuCommands(SubmitMode, void *screenshotCallbackData = nullptr);
 	VkSampler getCachedSampler(const SamplerState &sampler);
-	SharedDescriptorPools *acquireDescriptorPools(int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers);
+	SharedDescriptorPools *acquireDescriptorPools(int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers, int uniformBuffers);
 	void releaseDescriptorPools(SharedDescriptorPools *pools);
 	graphics::Shader::BuiltinUniformData getCurrentBuiltinUniformData();
 	const OptionalDeviceExtensions &getEnabledOptionalDeviceExtensions() const;
@@ -281,16 +292,32 @@ public:
 	VkSampleCountFlagBits getMsaaCount(int requestedMsaa) const;
 	void setVsync(int vsync);
 	int getVsync() const;
+	// Overrides the present mode picked from the vsync value, when the surface
+	// supports it. Passing VK_PRESENT_MODE_MAX_ENUM_KHR removes the override.
+	void setPresentMode(VkPresentModeKHR mode);
+	// The present mode of the current swapchain.
+	VkPresentModeKHR getPresentMode() const;
 	void mapLocalUniformData(void *data, size_t size, VkDescriptorBufferInfo &bufferInfo);
 
-	void cleanupFramebuffers(VkImageView imageView, PixelFormat format);
+	// Removes cached framebuffers which use the image view. They're destroyed
+	// immediately, or added to retired to be destroyed later.
+	void cleanupFramebuffers(VkImageView imageView, PixelFormat format, std::vector<VkFramebuffer> *retired = nullptr);
 
 	VkPipeline createGraphicsPipeline(Shader *shader, const GraphicsPipelineConfigurationCore &configuration, const GraphicsPipelineConfigurationNoDynamicState *noDynamicStateConfiguration);
 
+	VkRenderPass getRenderPass(RenderPassConfiguration &configuration);
+	const RenderPassConfiguration &getRenderPassConfiguration() const { return renderPassState.renderPassConfiguration; }
+
 	uint32 getDeviceApiVersion() const { return deviceApiVersion; }
+	uint32 getMaxPushDescriptors() const { return maxPushDescriptors; }
 
 	uint64 getRealFrameIndex() const { return realFrameIndex; }
 
+	// Queries are reset, begun and ended outside of render passes, so they can
+	// cover draws to several render targets.
+	void beginQuery(VkQueryPool pool, uint32 index);
+	void endQuery(VkQueryPool pool, uint32 index);
+
 protected:
 	graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) override;
 	graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::CompileOptions &options) override;
@@ -299,6 +326,9 @@ protected:
 	bool dispatch(love::graphics::Shader *shader, love::graphics::Buffer *indirectargs, size_t argsoffset) override;
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
+	void getMemoryBudget(int64 &usage, int64 &budget) const override;
+	void writeTimestampQuery(int frame, int index) override;
+	bool getTimestampQueryResults(int frame, int count, uint64 *results) override;
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 
 private:
@@ -315,6 +345,8 @@ private:
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 	void createLogicalDevice();
 	void createPipelineCache();
+	std::string getPipelineCacheFilename() const;
+	void savePipelineCache();
 	void initVMA();
 	void createSurface();
 	SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
@@ -328,7 +360,6 @@ private:
 	VkFramebuffer getFramebuffer(FramebufferConfiguration &configuration);
 	void createDefaultShaders();
 	VkRenderPass createRenderPass(RenderPassConfiguration &configuration);
-	VkRenderPass getRenderPass(RenderPassConfiguration &configuration);
 	void createColorResources();
 	VkFormat findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 	VkFormat findDepthFormat();
@@ -336,8 +367,10 @@ private:
 	void createCommandPool();
 	void createCommandBuffers();
 	void createSyncObjects();
+	void createTimestampQueryPools();
 	void cleanup();
 	void cleanupSwapChain(bool destroySwapChainObject);
+	void retireSwapChainResources();
 	void recreateSwapChain();
 	void initDynamicState();
 	void beginSwapChainFrame();
@@ -360,6 +393,8 @@ private:
 	void applyScissor();
 	VkSampler createSampler(const SamplerState &sampler);
 	void requestSwapchainRecreation();
+	void bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType type);
+	void resetBoundBufferState();
 
 	VkInstance instance = VK_NULL_HANDLE;
 	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
@@ -368,6 +403,8 @@ private:
 	VkDevice device = VK_NULL_HANDLE; 
 	OptionalInstanceExtensions optionalInstanceExtensions;
 	OptionalDeviceExtensions optionalDeviceExtensions;
+	bool multiDrawIndirectSupported = false;
+	uint32 maxPushDescriptors = 0;
 	VkQueue graphicsQueue = VK_NULL_HANDLE;
 	VkQueue presentQueue = VK_NULL_HANDLE;
 	VkSurfaceKHR surface = VK_NULL_HANDLE;
@@ -388,6 +425,7 @@ private:
 	VkImageView depthImageView = VK_NULL_HANDLE;
 	VmaAllocation depthImageAllocation = VK_NULL_HANDLE;
 	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+	size_t pipelineCacheSavedSize = 0;
 	std::unordered_map<RenderPassConfiguration, VkRenderPass, RenderPassConfigurationHasher> renderPasses;
 	std::unordered_map<FramebufferConfiguration, VkFramebuffer, FramebufferConfigurationHasher> framebuffers;
 	std::unordered_map<VkFramebuffer, bool> framebufferUsages;
@@ -400,11 +438,16 @@ private:
 	std::vector<VkFence> inFlightFences;
 	std::vector<VkFence> imagesInFlight;
 	int vsync = 1;
+	VkPresentModeKHR requestedPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+	VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
 	VkDeviceSize minUniformBufferOffsetAlignment = 0;
 	bool imageRequested = false;
 	size_t currentFrame = 0;
 	uint32_t imageIndex = 0;
 	uint64 realFrameIndex = 0;
+	std::vector<VkQueryPool> timestampQueryPools;
+	float timestampPeriod = 1.0f;
+	uint64 timestampPoolResetFrame = (uint64) -1;
 	bool swapChainRecreationRequested = false;
 	bool transitionColorDepthLayouts = false;
 	VmaAllocator vmaAllocator = VK_NULL_HANDLE;
@@ -415,7 +458,17 @@ private:
 	std::vector<std::vector<std::function<void()>>> cleanUpFunctions;
 	std::vector<std::vector<std::function<void()>>> readbackCallbacks;
 	std::set<StrongRef<Shader>> usedShadersInFrame;
+	Shader *lastUsedShaderInFrame = nullptr;
 	RenderpassState renderPassState;
+
+	// Buffer bindings recorded into the current command buffer, so redundant
+	// vkCmdBind* calls can be skipped between consecutive draws.
+	uint32 boundVertexBufferCount = 0;
+	VkBuffer boundVertexBuffers[BufferBindings::MAX] = {};
+	VkDeviceSize boundVertexBufferOffsets[BufferBindings::MAX] = {};
+	VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+	VkDeviceSize boundIndexBufferOffset = 0;
+	VkIndexType boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
 };
 
 } // vulkan
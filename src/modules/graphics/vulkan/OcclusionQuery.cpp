@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+OcclusionQuery::OcclusionQuery(Graphics *gfx)
+	: vgfx(gfx)
+{
+	loadVolatile();
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	unloadVolatile();
+}
+
+bool OcclusionQuery::loadVolatile()
+{
+	if (pool != VK_NULL_HANDLE)
+		return true;
+
+	for (int i = 0; i < QUERY_SLOTS; i++)
+		issued[i] = false;
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+	poolInfo.queryCount = QUERY_SLOTS;
+
+	if (vkCreateQueryPool(vgfx->getDevice(), &poolInfo, nullptr, &pool) != VK_SUCCESS)
+		throw love::Exception("Failed to create Vulkan occlusion query pool.");
+
+	return true;
+}
+
+void OcclusionQuery::unloadVolatile()
+{
+	if (pool == VK_NULL_HANDLE)
+		return;
+
+	// The GPU may still be using the pool.
+	vgfx->queueCleanUp([device = vgfx->getDevice(), pool = pool]() {
+		vkDestroyQueryPool(device, pool, nullptr);
+	});
+
+	pool = VK_NULL_HANDLE;
+}
+
+void OcclusionQuery::beginQuery(int slot)
+{
+	vgfx->beginQuery(pool, (uint32) slot);
+}
+
+void OcclusionQuery::endQuery(int slot)
+{
+	vgfx->endQuery(pool, (uint32) slot);
+	issued[slot] = true;
+}
+
+bool OcclusionQuery::getQueryResult(int slot, bool &anysamples)
+{
+	if (!issued[slot])
+		return false;
+
+	uint64 result = 0;
+	VkResult status = vkGetQueryPoolResults(
+		vgfx->getDevice(), pool, (uint32) slot, 1,
+		sizeof(uint64), &result, sizeof(uint64), VK_QUERY_RESULT_64_BIT);
+
+	// VK_NOT_READY means the result isn't available yet.
+	if (status != VK_SUCCESS)
+		return false;
+
+	anysamples = result != 0;
+	return true;
+}
+
+} // vulkan
+} // graphics
+} // love
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "graphics/OcclusionQuery.h"
+#include "graphics/Volatile.h"
+
+#include "VulkanWrapper.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+class Graphics;
+
+class OcclusionQuery final
+	: public love::graphics::OcclusionQuery
+	, public Volatile
+{
+public:
+
+	OcclusionQuery(Graphics *gfx);
+	virtual ~OcclusionQuery();
+
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+protected:
+
+	void beginQuery(int slot) override;
+	void endQuery(int slot) override;
+	bool getQueryResult(int slot, bool &anysamples) override;
+
+private:
+
+	Graphics *vgfx;
+	VkQueryPool pool = VK_NULL_HANDLE;
+
+	// Queries which have been ended since the pool was created.
+	bool issued[QUERY_SLOTS];
+
+}; // OcclusionQuery
+
+} // vulkan
+} // graphics
+} // love
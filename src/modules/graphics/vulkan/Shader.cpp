@@ -22,6 +22,7 @@
 #include "Shader.h"
 #include "Graphics.h"
 #include "common/Range.h"
+#include "common/version.h"
 
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
 #include "libraries/glslang/glslang/Public/ResourceLimits.h"
@@ -38,13 +39,14 @@ namespace vulkan
 
 static const uint32_t DESCRIPTOR_POOL_SIZE = 1000;
 
-SharedDescriptorPools::SharedDescriptorPools(VkDevice device, int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers)
+SharedDescriptorPools::SharedDescriptorPools(VkDevice device, int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers, int uniformBuffers)
 	: device(device)
 	, dynamicUniformBuffers(dynamicUniformBuffers)
 	, sampledTextures(sampledTextures)
 	, storageTextures(storageTextures)
 	, texelBuffers(texelBuffers)
 	, storageBuffers(storageBuffers)
+	, uniformBuffers(uniformBuffers)
 {
 	VkDescriptorPoolSize size{};
 
@@ -83,7 +85,14 @@ SharedDescriptorPools::SharedDescriptorPools(VkDevice device, int dynamicUniform
 		descriptorPoolSizes.push_back(size);
 	}
 
-	pools.resize(MAX_FRAMES_IN_FLIGHT);
+	if (uniformBuffers > 0)
+	{
+		size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		size.descriptorCount = uniformBuffers;
+		descriptorPoolSizes.push_back(size);
+	}
+
+	pools.resize(Vulkan::getFramesInFlight());
 }
 
 SharedDescriptorPools::~SharedDescriptorPools()
@@ -107,7 +116,7 @@ void SharedDescriptorPools::newFrame(uint64 frameIndex)
 	if (!lastFrameIndex.hasValue || lastFrameIndex.value != frameIndex)
 	{
 		lastFrameIndex.set(frameIndex);
-		currentFrame = (size_t)((currentFrame + 1) % MAX_FRAMES_IN_FLIGHT);
+		currentFrame = (size_t)((currentFrame + 1) % Vulkan::getFramesInFlight());
 		currentPool = 0;
 		for (VkDescriptorPool pool : pools[currentFrame])
 			vkResetDescriptorPool(device, pool, 0);
@@ -300,6 +309,10 @@ Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[], const CompileOpt
 
 bool Shader::loadVolatile()
 {
+	// Async shaders are compiled by finishCompiling once they're validated.
+	if (!isValidated())
+		return true;
+
 	device = vgfx->getDevice();
 
 	computePipeline = VK_NULL_HANDLE;
@@ -313,16 +326,26 @@ bool Shader::loadVolatile()
 	acquireDescriptorPools();
 	newFrame(vgfx->getRealFrameIndex());
 
+	if (!isCompute)
+		prewarmGraphicsPipelines();
+
 	return true;
 }
 
+void Shader::finishCompiling()
+{
+	loadVolatile();
+}
+
 void Shader::unloadVolatile()
 {
 	if (shaderModules.empty())
 		return;
 
-	vgfx->releaseDescriptorPools(descriptorPools);
+	if (descriptorPools != nullptr)
+		vgfx->releaseDescriptorPools(descriptorPools);
 	descriptorPools = nullptr;
+	cachedDescriptorSets.clear();
 
 	vgfx->queueCleanUp([shaderModules = std::move(shaderModules), device = device, descriptorSetLayout = descriptorSetLayout, pipelineLayout = pipelineLayout,
 		computePipeline = computePipeline,
@@ -362,8 +385,13 @@ void Shader::newFrame(uint64 graphicsFrameIndex)
 {
 	currentDescriptorSet = VK_NULL_HANDLE;
 	resourceDescriptorsDirty = true;
+	localUniformDataMapped = false;
 
-	descriptorPools->newFrame(graphicsFrameIndex);
+	// The pools the cached sets came from are reset for the new frame.
+	cachedDescriptorSets.clear();
+
+	if (descriptorPools != nullptr)
+		descriptorPools->newFrame(graphicsFrameIndex);
 }
 
 void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint)
@@ -377,23 +405,38 @@ void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBind
 		{
 			auto builtinData = vgfx->getCurrentBuiltinUniformData();
 			auto dst = (BuiltinUniformData *) (localUniformData.data() + builtinUniformDataOffset.value);
-			memcpy(dst, &builtinData, sizeof(builtinData));
+			if (memcmp(dst, &builtinData, sizeof(builtinData)) != 0)
+			{
+				memcpy(dst, &builtinData, sizeof(builtinData));
+				localUniformDataDirty = true;
+			}
 		}
 
-		VkDescriptorBufferInfo info = {};
-		vgfx->mapLocalUniformData(localUniformData.data(), localUniformData.size(), info);
+		// Data uploaded earlier in this frame stays valid until the frame's
+		// section of the stream buffer is reused, so draws which don't change
+		// any uniforms can keep using it.
+		if (localUniformDataDirty || !localUniformDataMapped)
+		{
+			VkDescriptorBufferInfo info = {};
+			vgfx->mapLocalUniformData(localUniformData.data(), localUniformData.size(), info);
+			frameUniformBytesUploaded += (int64) localUniformData.size();
 
-		// This is a dynamic uniform buffer, so the offset is specified in BindDescriptorSets
-		// and it only needs to update the descriptor sets if the buffer changes.
-		if (info.buffer != descriptorBuffers[0].buffer)
-			resourceDescriptorsDirty = true;
+			// This is a dynamic uniform buffer, so the offset is specified in BindDescriptorSets
+			// and it only needs to update the descriptor sets if the buffer changes.
+			if (info.buffer != descriptorBuffers[0].buffer)
+				resourceDescriptorsDirty = true;
+
+			descriptorBuffers[0].buffer = info.buffer;
+			descriptorBuffers[0].range = info.range;
+			descriptorBuffers[0].offset = 0;
 
-		descriptorBuffers[0].buffer = info.buffer;
-		descriptorBuffers[0].range = info.range;
-		descriptorBuffers[0].offset = 0;
+			mappedLocalUniformOffset = (uint32) info.offset;
+			localUniformDataMapped = true;
+			localUniformDataDirty = false;
+		}
 
 		useLocalUniformOffset = true;
-		localUniformOffset = info.offset;
+		localUniformOffset = mappedLocalUniformOffset;
 	}
 
 	// Sampler updates need to happen here because the handles may change after sendTextures.
@@ -421,20 +464,82 @@ void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBind
 		}
 	}
 
-	if (resourceDescriptorsDirty || currentDescriptorSet == VK_NULL_HANDLE)
+	if (usePushDescriptors)
 	{
-		currentDescriptorSet = descriptorPools->allocateDescriptorSet(descriptorSetLayout);
+		// Push descriptors can't have dynamic offsets, so the local uniform
+		// offset goes in the descriptor itself.
+		if (useLocalUniformOffset)
+			descriptorBuffers[0].offset = localUniformOffset;
 
-		for (auto &write : descriptorWrites)
-			write.dstSet = currentDescriptorSet;
+		if (!descriptorWrites.empty())
+			vkCmdPushDescriptorSetKHR(commandBuffer, bindPoint, pipelineLayout, 0, (uint32) descriptorWrites.size(), descriptorWrites.data());
 
-		vkUpdateDescriptorSets(device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+		resourceDescriptorsDirty = false;
+		return;
+	}
+
+	if (resourceDescriptorsDirty || currentDescriptorSet == VK_NULL_HANDLE)
+	{
+		currentDescriptorSet = getCachedDescriptorSet();
 		resourceDescriptorsDirty = false;
 	}
 
 	vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, 0, 1, &currentDescriptorSet, useLocalUniformOffset ? 1 : 0, &localUniformOffset);
 }
 
+template <typename T>
+static void appendDescriptorKey(std::vector<uint8> &key, const T &value)
+{
+	const uint8 *bytes = (const uint8 *) &value;
+	key.insert(key.end(), bytes, bytes + sizeof(T));
+}
+
+VkDescriptorSet Shader::getCachedDescriptorSet()
+{
+	// Draws often switch back and forth between the same few sets of
+	// resources (a couple of textures, for example), which can reuse the
+	// descriptor set from their last use this frame instead of allocating
+	// and writing a new one. Fields are appended individually so struct
+	// padding doesn't end up in the key.
+	descriptorSetKey.clear();
+
+	for (const auto &info : descriptorBuffers)
+	{
+		appendDescriptorKey(descriptorSetKey, info.buffer);
+		appendDescriptorKey(descriptorSetKey, info.offset);
+		appendDescriptorKey(descriptorSetKey, info.range);
+	}
+
+	for (const auto &info : descriptorImages)
+	{
+		appendDescriptorKey(descriptorSetKey, info.sampler);
+		appendDescriptorKey(descriptorSetKey, info.imageView);
+		appendDescriptorKey(descriptorSetKey, info.imageLayout);
+	}
+
+	for (VkBufferView view : descriptorBufferViews)
+		appendDescriptorKey(descriptorSetKey, view);
+
+	uint64 hash = XXH64(descriptorSetKey.data(), descriptorSetKey.size(), 0);
+
+	auto it = cachedDescriptorSets.find(hash);
+	if (it != cachedDescriptorSets.end() && it->second.key == descriptorSetKey)
+		return it->second.set;
+
+	VkDescriptorSet set = descriptorPools->allocateDescriptorSet(descriptorSetLayout);
+
+	for (auto &write : descriptorWrites)
+		write.dstSet = set;
+
+	vkUpdateDescriptorSets(device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+
+	CachedDescriptorSet &cached = cachedDescriptorSets[hash];
+	cached.key = descriptorSetKey;
+	cached.set = set;
+
+	return set;
+}
+
 Shader::~Shader()
 {
 	unloadVolatile();
@@ -442,19 +547,25 @@ Shader::~Shader()
 
 void Shader::attach()
 {
+	waitUntilReady();
+
 	if (!isCompute)
 	{
 		if (Shader::current != this)
 		{
-			Graphics::flushBatchedDrawsGlobal();
+			Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_SHADER);
 			Shader::current = this;
 			Vulkan::shaderSwitch();
 		}
 	}
+
+	updateSharedUniformBuffers();
 }
 
 int Shader::getVertexAttributeIndex(const std::string &name)
 {
+	waitUntilReady();
+
 	auto it = attributes.find(name);
 	return it == attributes.end() ? -1 : it->second.index;
 }
@@ -466,8 +577,7 @@ const Shader::UniformInfo *Shader::getUniformInfo(BuiltinUniform builtin) const
 
 void Shader::updateUniform(const UniformInfo *info, int count)
 {
-	if (current == this)
-		Graphics::flushBatchedDrawsGlobal();
+	waitUntilReady();
 
 	count = std::min(count, info->count);
 
@@ -475,8 +585,20 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 	{
 		size_t offset = (const uint8*)info->data - localUniformStagingData.data();
 		uint8 *dst = localUniformData.data() + offset;
+
+		// Sending the values a uniform already has doesn't need to break
+		// batches or upload anything.
+		if (isUniformBufferDataEqual(info, info->data, dst, count))
+			return;
+
+		if (current == this)
+			Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_UNIFORM);
+
 		copyToUniformBuffer(info, info->data, dst, count);
+		localUniformDataDirty = true;
 	}
+	else if (current == this)
+		Graphics::flushBatchedDrawsGlobal(Graphics::BATCHFLUSH_UNIFORM);
 }
 
 void Shader::applyTexture(const UniformInfo *info, int i, love::graphics::Texture *texture, UniformType /*basetype*/, bool isdefault)
@@ -570,10 +692,110 @@ void Shader::buildLocalUniforms(spirv_cross::Compiler &comp, const spirv_cross::
 	}
 }
 
-void Shader::compileShaders()
+static const uint32 SPIRV_CACHE_MAGIC = 0x5650534C; // "LSPV"
+static const uint32 SPIRV_CACHE_VERSION = 1;
+
+unsigned long long Shader::getSourceHash() const
+{
+	// Linking can change the generated code for each stage (e.g. location
+	// mapping), so the key covers every stage's source.
+	XXH64_state_t *state = XXH64_createState();
+	XXH64_reset(state, 0);
+
+	XXH64_update(state, love::VERSION, strlen(love::VERSION));
+
+	uint32 spirv14 = vgfx->getEnabledOptionalDeviceExtensions().spirv14 ? 1 : 0;
+	XXH64_update(state, &spirv14, sizeof(spirv14));
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (!stages[i])
+			continue;
+
+		const std::string &source = stages[i]->getSource();
+		uint32 stageindex = (uint32) i;
+		XXH64_update(state, &stageindex, sizeof(stageindex));
+		XXH64_update(state, source.c_str(), source.length());
+	}
+
+	unsigned long long hash = XXH64_digest(state);
+	XXH64_freeState(state);
+
+	return hash;
+}
+
+std::string Shader::getSpirvCacheFilename() const
+{
+	char name[64];
+	snprintf(name, sizeof(name), "spirv_%016llx.bin", getSourceHash());
+	return name;
+}
+
+std::string Shader::getPipelineLogFilename() const
+{
+	char name[64];
+	snprintf(name, sizeof(name), "pipelines_%016llx.bin", getSourceHash());
+	return name;
+}
+
+bool Shader::loadCachedSpirv(const std::string &filename, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]) const
+{
+	std::vector<uint8> data;
+	if (!readShaderCacheFile(filename, data) || data.size() % sizeof(uint32) != 0)
+		return false;
+
+	std::vector<uint32> words(data.size() / sizeof(uint32));
+	memcpy(words.data(), data.data(), data.size());
+
+	if (words.size() < 3 || words[0] != SPIRV_CACHE_MAGIC || words[1] != SPIRV_CACHE_VERSION)
+		return false;
+
+	uint32 stagemask = words[2];
+	size_t offset = 3;
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		bool cachedstage = (stagemask & (1u << i)) != 0;
+		if (cachedstage != (stages[i].get() != nullptr))
+			return false;
+
+		if (!cachedstage)
+			continue;
+
+		if (offset >= words.size())
+			return false;
+
+		size_t count = words[offset++];
+		if (count == 0 || count > words.size() - offset)
+			return false;
+
+		spirv[i].assign(words.begin() + offset, words.begin() + offset + count);
+		offset += count;
+	}
+
+	return offset == words.size();
+}
+
+void Shader::saveCachedSpirv(const std::string &filename, const std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]) const
+{
+	std::vector<uint32> words = { SPIRV_CACHE_MAGIC, SPIRV_CACHE_VERSION, 0 };
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (spirv[i].empty())
+			continue;
+
+		words[2] |= 1u << i;
+		words.push_back((uint32) spirv[i].size());
+		words.insert(words.end(), spirv[i].begin(), spirv[i].end());
+	}
+
+	writeShaderCacheFile(filename, words.data(), words.size() * sizeof(uint32));
+}
+
+void Shader::generateSpirv(std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM])
 {
 	using namespace glslang;
-	using namespace spirv_cross;
 
 	std::vector<std::unique_ptr<TShader>> glslangShaders;
 
@@ -588,9 +810,6 @@ void Shader::compileShaders()
 
 		auto stage = (ShaderStageType)i;
 
-		if (stage == SHADERSTAGE_COMPUTE)
-			isCompute = true;
-
 		auto glslangShaderStage = getGlslShaderType(stage);
 		auto tshader = std::make_unique<TShader>(glslangShaderStage);
 
@@ -638,15 +857,9 @@ void Shader::compileShaders()
 	if (!program->mapIO())
 		throw love::Exception("mapIO failed");
 
-	BindingMapper bindingMapper(spv::DecorationBinding);
-	BindingMapper ioLocationMapper(spv::DecorationLocation);
-	BindingMapper vertexInputLocationMapper(spv::DecorationLocation);
-
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		auto shaderStage = (ShaderStageType)i;
-		auto glslangStage = getGlslShaderType(shaderStage);
-		auto intermediate = program->getIntermediate(glslangStage);
+		auto intermediate = program->getIntermediate(getGlslShaderType((ShaderStageType)i));
 
 		if (intermediate == nullptr)
 			continue;
@@ -655,9 +868,56 @@ void Shader::compileShaders()
 		glslang::SpvOptions opt;
 		opt.validate = true;
 
-		std::vector<uint32> spirv;
+		GlslangToSpv(*intermediate, spirv[i], &logger, &opt);
+	}
+}
+
+void Shader::compileShaders()
+{
+	using namespace spirv_cross;
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (stages[i] && (ShaderStageType)i == SHADERSTAGE_COMPUTE)
+			isCompute = true;
+	}
+
+	// The SPIR-V generated here is device-independent, so it can be reused
+	// across runs when the shader cache is enabled. Resource bindings are
+	// still remapped below, since that depends on reflection data.
+	std::vector<uint32> stageSpirv[SHADERSTAGE_MAX_ENUM];
+	std::string cacheFilename;
+
+	bool cached = false;
+	if (isShaderCacheEnabled())
+	{
+		cacheFilename = getSpirvCacheFilename();
+		cached = loadCachedSpirv(cacheFilename, stageSpirv);
+	}
+
+	if (!cached)
+	{
+		for (auto &spirv : stageSpirv)
+			spirv.clear();
+
+		generateSpirv(stageSpirv);
+
+		if (isShaderCacheEnabled())
+			saveCachedSpirv(cacheFilename, stageSpirv);
+	}
+
+	BindingMapper bindingMapper(spv::DecorationBinding);
+	BindingMapper ioLocationMapper(spv::DecorationLocation);
+	BindingMapper vertexInputLocationMapper(spv::DecorationLocation);
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		auto shaderStage = (ShaderStageType)i;
+
+		if (stageSpirv[i].empty())
+			continue;
 
-		GlslangToSpv(*intermediate, spirv, &logger, &opt);
+		std::vector<uint32> &spirv = stageSpirv[i];
 
 		auto compiler = std::make_unique<spirv_cross::CompilerGLSL>(spirv);
 		auto &comp = *compiler;
@@ -693,7 +953,19 @@ void Shader::compileShaders()
 				buildLocalUniforms(comp, type, 0, basename);
 			}
 			else
-				throw love::Exception("unimplemented: non default uniform blocks.");
+			{
+				std::string name = canonicaliizeUniformName(resource.name);
+				const auto &uniformit = reflection.uniformBuffers.find(name);
+				if (uniformit == reflection.uniformBuffers.end())
+				{
+					handleUnknownUniformName(name.c_str());
+					continue;
+				}
+
+				UniformInfo &u = uniformit->second;
+				u.active = true;
+				u.location = bindingMapper(comp, spirv, name, u.count, resource.id);
+			}
 		}
 
 		for (const auto &r : shaderResources.sampled_images)
@@ -869,6 +1141,7 @@ void Shader::compileShaders()
 			numTextures += kvp.second->count;
 			break;
 		case UNIFORM_STORAGEBUFFER:
+		case UNIFORM_UNIFORMBUFFER:
 			numBuffers += kvp.second->count;
 			break;
 		case UNIFORM_TEXELBUFFER:
@@ -1034,6 +1307,37 @@ void Shader::compileShaders()
 		descriptorWrites.push_back(write);
 	}
 
+	for (auto &u : reflection.uniformBuffers)
+	{
+		UniformInfo &info = u.second;
+		if (!info.active)
+			continue;
+
+		info.bindingStartIndex = (int)descriptorBuffers.size();
+
+		for (int i = 0; i < info.count; i++)
+		{
+			VkDescriptorBufferInfo bufferInfo{};
+			descriptorBuffers.push_back(bufferInfo);
+
+			storageBufferInfo.push_back({ nullptr, info.access });
+
+			auto buffer = activeBuffers[info.resourceIndex + i];
+			if (buffer != nullptr)
+				setBufferDescriptor(&info, buffer, i);
+		}
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstBinding = info.location;
+		write.dstArrayElement = 0;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		write.descriptorCount = info.count;
+		write.pBufferInfo = &descriptorBuffers[info.bindingStartIndex];
+
+		descriptorWrites.push_back(write);
+	}
+
 	resourceDescriptorsDirty = true;
 }
 
@@ -1073,11 +1377,38 @@ void Shader::createDescriptorSetLayout()
 		bindings.push_back(uniformBinding);
 	}
 
+	uint32 descriptorCount = 0;
+	for (const auto &binding : bindings)
+		descriptorCount += binding.descriptorCount;
+
+	// Push descriptors skip descriptor set allocation and updates entirely,
+	// as long as the shader doesn't use more descriptors than they allow.
+	usePushDescriptors = vgfx->getEnabledOptionalDeviceExtensions().pushDescriptor
+		&& descriptorCount <= vgfx->getMaxPushDescriptors();
+
 	VkDescriptorSetLayoutCreateInfo layoutInfo{};
 	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
 	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
 	layoutInfo.pBindings = bindings.data();
 
+	if (usePushDescriptors)
+	{
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+
+		// Dynamic uniform buffers aren't allowed in push descriptor layouts.
+		for (auto &binding : bindings)
+		{
+			if (binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+				binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		}
+
+		for (auto &write : descriptorWrites)
+		{
+			if (write.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+				write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		}
+	}
+
 	VkResult result = vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout);
 	if (result != VK_SUCCESS)
 		throw love::Exception("Failed to create Vulkan descriptor set layout: %s", Vulkan::getErrorString(result));
@@ -1123,6 +1454,9 @@ static int getDescriptorPoolSize(const std::map<std::string, Shader::UniformInfo
 
 void Shader::acquireDescriptorPools()
 {
+	if (usePushDescriptors)
+		return;
+
 	int dynamicUniformBuffers = 0;
 	if (!localUniformData.empty())
 		dynamicUniformBuffers++;
@@ -1131,8 +1465,9 @@ void Shader::acquireDescriptorPools()
 	int storageTextures = getDescriptorPoolSize(reflection.storageTextures);
 	int texelBuffers = getDescriptorPoolSize(reflection.texelBuffers);
 	int storageBuffers = getDescriptorPoolSize(reflection.storageBuffers);
+	int uniformBuffers = getDescriptorPoolSize(reflection.uniformBuffers);
 
-	descriptorPools = vgfx->acquireDescriptorPools(dynamicUniformBuffers, sampledTextures, storageTextures, texelBuffers, storageBuffers);
+	descriptorPools = vgfx->acquireDescriptorPools(dynamicUniformBuffers, sampledTextures, storageTextures, texelBuffers, storageBuffers, uniformBuffers);
 }
 
 void Shader::setMainTex(graphics::Texture *texture)
@@ -1172,7 +1507,7 @@ void Shader::setTextureDescriptor(const UniformInfo *info, love::graphics::Textu
 
 void Shader::setBufferDescriptor(const UniformInfo *info, love::graphics::Buffer *buffer, int index)
 {
-	if (info->baseType == UNIFORM_STORAGEBUFFER)
+	if (info->baseType == UNIFORM_STORAGEBUFFER || info->baseType == UNIFORM_UNIFORMBUFFER)
 	{
 		VkDescriptorBufferInfo &bufferInfo = descriptorBuffers[info->bindingStartIndex + index];
 		VkBuffer vkbuffer = buffer != nullptr ? (VkBuffer)buffer->getHandle() : VK_NULL_HANDLE;
@@ -1205,6 +1540,7 @@ VkPipeline Shader::getCachedGraphicsPipeline(Graphics *vgfx, const GraphicsPipel
 
 	VkPipeline pipeline = vgfx->createGraphicsPipeline(this, configuration, nullptr);
 	graphicsPipelinesDynamicState.insert({ configuration, pipeline });
+	recordGraphicsPipeline(configuration, nullptr);
 	
 	return pipeline;
 }
@@ -1217,10 +1553,140 @@ VkPipeline Shader::getCachedGraphicsPipeline(Graphics *vgfx, const GraphicsPipel
 
 	VkPipeline pipeline = vgfx->createGraphicsPipeline(this, configuration.core, &configuration.noDynamicState);
 	graphicsPipelinesNoDynamicState.insert({ configuration, pipeline });
+	recordGraphicsPipeline(configuration.core, &configuration.noDynamicState);
 	
 	return pipeline;
 }
 
+static const uint32 PIPELINE_LOG_MAGIC = 0x4C50504C; // "LPPL"
+static const uint32 PIPELINE_LOG_VERSION = 2;
+static const size_t PIPELINE_LOG_HEADER_SIZE = sizeof(uint32) * 2;
+
+// Render passes and vertex attribute IDs only exist for the current run, so
+// the log stores what they were created from instead.
+struct PipelineLogEntry
+{
+	uint32 dynamicState;
+	uint32 resolve;
+	uint32 numColorAttachments;
+	ColorAttachment colorAttachments[MAX_COLOR_RENDER_TARGETS];
+	DepthStencilAttachment depthStencilAttachment;
+	VertexAttributes attributes;
+	GraphicsPipelineConfigurationCore core;
+	GraphicsPipelineConfigurationNoDynamicState noDynamicState;
+};
+
+void Shader::prewarmGraphicsPipelines()
+{
+	if (!isShaderCacheEnabled())
+		return;
+
+	// The log is kept across unloadVolatile, so it only needs to be read once.
+	if (pipelineLog.empty())
+	{
+		if (!readShaderCacheFile(getPipelineLogFilename(), pipelineLog))
+			return;
+
+		uint32 header[2] = {};
+		if (pipelineLog.size() >= PIPELINE_LOG_HEADER_SIZE)
+			memcpy(header, pipelineLog.data(), PIPELINE_LOG_HEADER_SIZE);
+
+		if (header[0] != PIPELINE_LOG_MAGIC || header[1] != PIPELINE_LOG_VERSION
+			|| (pipelineLog.size() - PIPELINE_LOG_HEADER_SIZE) % sizeof(PipelineLogEntry) != 0)
+		{
+			pipelineLog.clear();
+			return;
+		}
+	}
+
+	bool dynamicstate = vgfx->getEnabledOptionalDeviceExtensions().extendedDynamicState;
+	size_t count = (pipelineLog.size() - PIPELINE_LOG_HEADER_SIZE) / sizeof(PipelineLogEntry);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		PipelineLogEntry entry;
+		memcpy(&entry, pipelineLog.data() + PIPELINE_LOG_HEADER_SIZE + i * sizeof(PipelineLogEntry), sizeof(PipelineLogEntry));
+
+		// Entries recorded on a device with different pipeline state support
+		// don't map to anything this device will ask for.
+		if ((entry.dynamicState != 0) != dynamicstate || entry.numColorAttachments > MAX_COLOR_RENDER_TARGETS)
+			continue;
+
+		RenderPassConfiguration renderPassConfiguration;
+		renderPassConfiguration.colorAttachments.assign(entry.colorAttachments, entry.colorAttachments + entry.numColorAttachments);
+		renderPassConfiguration.staticData.depthStencilAttachment = entry.depthStencilAttachment;
+		renderPassConfiguration.staticData.resolve = entry.resolve != 0;
+
+		entry.core.renderPass = vgfx->getRenderPass(renderPassConfiguration);
+		entry.core.attributesID = vgfx->registerVertexAttributes(entry.attributes);
+
+		if (dynamicstate)
+		{
+			if (graphicsPipelinesDynamicState.find(entry.core) == graphicsPipelinesDynamicState.end())
+			{
+				VkPipeline pipeline = vgfx->createGraphicsPipeline(this, entry.core, nullptr);
+				graphicsPipelinesDynamicState.insert({ entry.core, pipeline });
+			}
+		}
+		else
+		{
+			GraphicsPipelineConfigurationFull configuration;
+			configuration.core = entry.core;
+			configuration.noDynamicState = entry.noDynamicState;
+
+			if (graphicsPipelinesNoDynamicState.find(configuration) == graphicsPipelinesNoDynamicState.end())
+			{
+				VkPipeline pipeline = vgfx->createGraphicsPipeline(this, configuration.core, &configuration.noDynamicState);
+				graphicsPipelinesNoDynamicState.insert({ configuration, pipeline });
+			}
+		}
+	}
+}
+
+void Shader::recordGraphicsPipeline(const GraphicsPipelineConfigurationCore &configuration, const GraphicsPipelineConfigurationNoDynamicState *noDynamicStateConfiguration)
+{
+	if (!isShaderCacheEnabled())
+		return;
+
+	const RenderPassConfiguration &renderPassConfiguration = vgfx->getRenderPassConfiguration();
+	if (renderPassConfiguration.colorAttachments.size() > MAX_COLOR_RENDER_TARGETS)
+		return;
+
+	PipelineLogEntry entry{};
+
+	if (!vgfx->findVertexAttributes(configuration.attributesID, entry.attributes))
+		return;
+
+	entry.dynamicState = noDynamicStateConfiguration == nullptr ? 1 : 0;
+	entry.resolve = renderPassConfiguration.staticData.resolve ? 1 : 0;
+	entry.numColorAttachments = (uint32) renderPassConfiguration.colorAttachments.size();
+	for (uint32 i = 0; i < entry.numColorAttachments; i++)
+		entry.colorAttachments[i] = renderPassConfiguration.colorAttachments[i];
+	entry.depthStencilAttachment = renderPassConfiguration.staticData.depthStencilAttachment;
+
+	entry.core = configuration;
+	entry.core.renderPass = VK_NULL_HANDLE;
+	entry.core.attributesID.invalidate();
+
+	if (noDynamicStateConfiguration != nullptr)
+		entry.noDynamicState = *noDynamicStateConfiguration;
+
+	if (pipelineLog.empty())
+	{
+		uint32 header[2] = { PIPELINE_LOG_MAGIC, PIPELINE_LOG_VERSION };
+		pipelineLog.resize(PIPELINE_LOG_HEADER_SIZE);
+		memcpy(pipelineLog.data(), header, PIPELINE_LOG_HEADER_SIZE);
+	}
+
+	size_t offset = pipelineLog.size();
+	pipelineLog.resize(offset + sizeof(PipelineLogEntry));
+	memcpy(pipelineLog.data() + offset, &entry, sizeof(PipelineLogEntry));
+
+	// New configurations are rare after the first few frames, so rewriting the
+	// whole log each time is cheap compared to the pipeline compile itself.
+	writeShaderCacheFile(getPipelineLogFilename(), pipelineLog.data(), pipelineLog.size());
+}
+
 } // vulkan
 } // graphics
 } // love
@@ -116,7 +116,7 @@ class SharedDescriptorPools
 {
 public:
 
-	SharedDescriptorPools(VkDevice device, int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers);
+	SharedDescriptorPools(VkDevice device, int dynamicUniformBuffers, int sampledTextures, int storageTextures, int texelBuffers, int storageBuffers, int uniformBuffers);
 	virtual ~SharedDescriptorPools();
 
 	VkDescriptorSet allocateDescriptorSet(const VkDescriptorSetLayout &descriptorSetLayout);
@@ -128,6 +128,7 @@ public:
 	int storageTextures = 0;
 	int texelBuffers = 0;
 	int storageBuffers = 0;
+	int uniformBuffers = 0;
 
 private:
 
@@ -204,17 +205,27 @@ public:
 	const std::vector<BufferInfo> &getActiveStorageBufferInfo() const { return storageBufferInfo; }
 
 private:
+	unsigned long long getSourceHash() const;
+	std::string getSpirvCacheFilename() const;
+	std::string getPipelineLogFilename() const;
+	bool loadCachedSpirv(const std::string &filename, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]) const;
+	void saveCachedSpirv(const std::string &filename, const std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]) const;
+	void generateSpirv(std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]);
 	void compileShaders();
 	void createDescriptorSetLayout();
 	void createPipelineLayout();
 	void acquireDescriptorPools();
+	void prewarmGraphicsPipelines();
+	void recordGraphicsPipeline(const GraphicsPipelineConfigurationCore &configuration, const GraphicsPipelineConfigurationNoDynamicState *noDynamicStateConfiguration);
 	void buildLocalUniforms(spirv_cross::Compiler &comp, const spirv_cross::SPIRType &type, size_t baseoff, const std::string &basename);
 
 	void setTextureDescriptor(const UniformInfo *info, love::graphics::Texture *texture, int index);
 	void setBufferDescriptor(const UniformInfo *info, love::graphics::Buffer *buffer, int index);
+	VkDescriptorSet getCachedDescriptorSet();
 
 	void applyTexture(const UniformInfo *info, int i, love::graphics::Texture *texture, UniformType basetype, bool isdefault) override;
 	void applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer *buffer, UniformType basetype, bool isdefault) override;
+	void finishCompiling() override;
 
 	VkPipeline computePipeline = VK_NULL_HANDLE;
 
@@ -226,6 +237,16 @@ private:
 	std::vector<VkBufferView> descriptorBufferViews;
 	std::vector<VkWriteDescriptorSet> descriptorWrites;
 
+	struct CachedDescriptorSet
+	{
+		std::vector<uint8> key;
+		VkDescriptorSet set;
+	};
+
+	// Descriptor sets allocated this frame, keyed by the resources they use.
+	std::unordered_map<uint64, CachedDescriptorSet> cachedDescriptorSets;
+	std::vector<uint8> descriptorSetKey;
+
 	std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
 	std::vector<VkShaderModule> shaderModules;
 
@@ -238,6 +259,7 @@ private:
 	SharedDescriptorPools *descriptorPools = nullptr;
 
 	bool isCompute = false;
+	bool usePushDescriptors = false;
 	bool resourceDescriptorsDirty = false;
 	VkDescriptorSet currentDescriptorSet = VK_NULL_HANDLE;
 
@@ -249,10 +271,20 @@ private:
 	uint32_t localUniformLocation = 0;
 	OptionalInt builtinUniformDataOffset;
 
+	// Whether localUniformData has changed since it was last uploaded, and
+	// where that upload is if it happened during the current frame.
+	bool localUniformDataDirty = true;
+	bool localUniformDataMapped = false;
+	uint32 mappedLocalUniformOffset = 0;
+
 	std::unordered_map<std::string, AttributeInfo> attributes;
 
 	std::unordered_map<GraphicsPipelineConfigurationCore, VkPipeline, GraphicsPipelineConfigurationCoreHasher> graphicsPipelinesDynamicState;
 	std::unordered_map<GraphicsPipelineConfigurationFull, VkPipeline, GraphicsPipelineConfigurationFullHasher> graphicsPipelinesNoDynamicState;
+
+	// Every pipeline configuration this shader has used, in the format of its
+	// file in the shader cache. Used to pre-create the pipelines in later runs.
+	std::vector<uint8> pipelineLog;
 };
 
 }
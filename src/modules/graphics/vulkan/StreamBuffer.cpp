@@ -54,7 +54,7 @@ bool StreamBuffer::loadVolatile()
 
 	VkBufferCreateInfo bufferInfo{};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferInfo.size = getSize() * MAX_FRAMES_IN_FLIGHT; // TODO: Is this sufficient or should it be +1?
+	bufferInfo.size = getSize() * Vulkan::getFramesInFlight(); // TODO: Is this sufficient or should it be +1?
 	bufferInfo.usage = getUsageFlags(mode);
 	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
@@ -129,7 +129,7 @@ void StreamBuffer::markUsed(size_t usedSize)
 
 void StreamBuffer::nextFrame()
 {
-	frameIndex = (frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+	frameIndex = (frameIndex + 1) % Vulkan::getFramesInFlight();
 	frameGPUReadOffset = 0;
 }
 
@@ -92,6 +92,14 @@ bool Texture::loadVolatile()
 			usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 	}
 
+	// Transient attachments are only ever used inside render passes, which
+	// lets the driver back them with lazily allocated (tile) memory.
+	VkImageUsageFlags transientUsageFlags = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+	if (isPixelFormatDepthStencil(format))
+		transientUsageFlags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	else
+		transientUsageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
 	layerCount = 1;
 
 	if (texType == TEXTURE_2D_ARRAY)
@@ -148,23 +156,48 @@ bool Texture::loadVolatile()
 
 		VmaAllocationCreateInfo imageAllocationCreateInfo{};
 
-		// Dedicated allocations are recommended for fullscreen RTs.
-		if (renderTarget && pixelWidth >= vgfx->getPixelWidth() && pixelHeight >= vgfx->getPixelHeight())
+		// Dedicated allocations are recommended for fullscreen RTs. Other large
+		// RTs get one too, so creating and destroying them over a long session
+		// doesn't leave holes in shared memory blocks.
+		bool fullscreen = pixelWidth >= vgfx->getPixelWidth() && pixelHeight >= vgfx->getPixelHeight();
+		if (renderTarget && (fullscreen || (int64) pixelWidth * pixelHeight >= 1024 * 1024))
 			imageAllocationCreateInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
 
 		imageAllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
 
-		if ((msaaSamples & VK_SAMPLE_COUNT_1_BIT) != 0 || readable)
+		bool msaa = (msaaSamples & VK_SAMPLE_COUNT_1_BIT) == 0;
+
+		// Not every device has lazily allocated memory, regular device memory
+		// works too.
+		auto createimage = [&](VulkanImageData &data, bool transientimage) -> VkResult
+		{
+			if (!transientimage)
+				return vgfx->createImage(imageInfo, imageAllocationCreateInfo, data.image, data.allocation);
+
+			VkImageCreateInfo transientInfo = imageInfo;
+			transientInfo.usage = transientUsageFlags;
+
+			VmaAllocationCreateInfo transientAllocationInfo = imageAllocationCreateInfo;
+			transientAllocationInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+			VkResult result = vgfx->createImage(transientInfo, transientAllocationInfo, data.image, data.allocation);
+			if (result == VK_SUCCESS)
+				return result;
+
+			return vgfx->createImage(transientInfo, imageAllocationCreateInfo, data.image, data.allocation);
+		};
+
+		if (!msaa || readable)
 		{
-			VkResult result = vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &imageData.image, &imageData.allocation, nullptr);
+			VkResult result = createimage(imageData, transient && !msaa);
 			if (result != VK_SUCCESS)
 				throw love::Exception("Failed to create Vulkan image: %s", Vulkan::getErrorString(result));
 		}
 
-		if ((msaaSamples & VK_SAMPLE_COUNT_1_BIT) == 0)
+		if (msaa)
 		{
 			imageInfo.samples = msaaSamples;
-			VkResult result = vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &msaaImageData.image, &msaaImageData.allocation, nullptr);
+			VkResult result = createimage(msaaImageData, transient);
 			if (result != VK_SUCCESS)
 				throw love::Exception("Failed to create Vulkan MSAA image: %s", Vulkan::getErrorString(result));
 		}
@@ -227,9 +260,11 @@ bool Texture::loadVolatile()
 		}
 		else
 		{
-			if (imageData.image != VK_NULL_HANDLE)
+			// Transient images can't be transfer destinations, and their
+			// contents are undefined at the start of each render pass anyway.
+			if (imageData.image != VK_NULL_HANDLE && !(transient && !msaa))
 				clear(imageData);
-			if (msaaImageData.image != VK_NULL_HANDLE)
+			if (msaaImageData.image != VK_NULL_HANDLE && !transient)
 				clear(msaaImageData);
 		}
 	}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TextureUpload.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+TextureUpload::TextureUpload(love::graphics::Graphics *gfx, love::graphics::Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+	: graphics::TextureUpload(gfx, texture, data, slice, mipmap, x, y, reloadmipmaps)
+	, vgfx(dynamic_cast<Graphics*>(gfx))
+{
+	if (complete)
+		return;
+
+	// The copy is recorded into the data transfer command buffer, which is
+	// submitted ahead of the frame's draws. The callback runs once the fence
+	// for this frame has been signalled.
+	retain();
+	vgfx->addReadbackCallback([this]() {
+		releaseStagingBuffer();
+		complete = true;
+		release();
+	});
+}
+
+TextureUpload::~TextureUpload()
+{
+}
+
+void TextureUpload::wait()
+{
+	if (!complete)
+		vgfx->submitGpuCommands(SUBMIT_RESTART);
+}
+
+void TextureUpload::update()
+{
+}
+
+} // vulkan
+} // graphics
+} // love
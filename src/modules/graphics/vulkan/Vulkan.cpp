@@ -19,6 +19,7 @@
  **/
 
 #include "Vulkan.h"
+#include "graphics/Graphics.h"
 
 #include <sstream>
 
@@ -47,6 +48,22 @@ void Vulkan::resetShaderSwitches()
 	numShaderSwitches = 0;
 }
 
+uint32_t Vulkan::getFramesInFlight()
+{
+	static uint32_t framesInFlight = 0;
+
+	if (framesInFlight == 0)
+	{
+		int requested = graphics::getFramesInFlight();
+		if (requested > 0)
+			framesInFlight = std::min((uint32_t) requested, MAX_FRAMES_IN_FLIGHT);
+		else
+			framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+	}
+
+	return framesInFlight;
+}
+
 const char *Vulkan::getErrorString(VkResult result)
 {
 	switch (result)
@@ -813,6 +830,8 @@ VkDescriptorType Vulkan::getDescriptorType(graphics::Shader::UniformType type)
 		return VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
 	case graphics::Shader::UniformType::UNIFORM_STORAGEBUFFER:
 		return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	case graphics::Shader::UniformType::UNIFORM_UNIFORMBUFFER:
+		return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 	default:
 		throw love::Exception("unknown uniform type");
 	}
@@ -49,7 +49,8 @@ struct TextureFormat
 	VkComponentSwizzle swizzleA = VK_COMPONENT_SWIZZLE_IDENTITY;
 };
 
-constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
 
 class Vulkan
 {
@@ -58,6 +59,11 @@ public:
 	static uint32_t getNumShaderSwitches();
 	static void resetShaderSwitches();
 
+	// The number of frames the CPU can record ahead of the GPU. It's read from
+	// t.graphics.framesinflight the first time it's needed, and doesn't change
+	// afterwards since per-frame resources are sized by it.
+	static uint32_t getFramesInFlight();
+
 	static const char *getErrorString(VkResult result);
 	static VkFormat getVulkanVertexFormat(DataFormat format);
 	static TextureFormat getTextureFormat(PixelFormat format);
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Atlas.h"
+#include "Texture.h"
+
+namespace love
+{
+namespace graphics
+{
+
+Atlas *luax_checkatlas(lua_State *L, int idx)
+{
+	return luax_checktype<Atlas>(L, idx);
+}
+
+int w_Atlas_add(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+
+	if (lua_istable(L, 2))
+	{
+		// Adding a list of images only regenerates the mipmaps once.
+		int count = (int) luax_objlen(L, 2);
+		bool updatemipmaps = luax_optboolean(L, 3, true);
+
+		std::vector<love::image::ImageData *> datas;
+		datas.reserve(count);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			datas.push_back(luax_checktype<love::image::ImageData>(L, -1));
+			lua_pop(L, 1);
+		}
+
+		lua_createtable(L, count, 0);
+
+		for (int i = 0; i < count; i++)
+		{
+			Quad *quad = nullptr;
+			luax_catchexcept(L, [&]() { quad = atlas->add(datas[i], false); });
+			luax_pushtype(L, quad);
+			quad->release();
+			lua_rawseti(L, -2, i + 1);
+		}
+
+		if (updatemipmaps && count > 0)
+			luax_catchexcept(L, [&]() { atlas->generateMipmaps(); });
+
+		return 1;
+	}
+
+	love::image::ImageData *data = luax_checktype<love::image::ImageData>(L, 2);
+	bool updatemipmaps = luax_optboolean(L, 3, true);
+
+	Quad *quad = nullptr;
+	luax_catchexcept(L, [&]() { quad = atlas->add(data, updatemipmaps); });
+
+	luax_pushtype(L, quad);
+	quad->release();
+	return 1;
+}
+
+int w_Atlas_generateMipmaps(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	luax_catchexcept(L, [&]() { atlas->generateMipmaps(); });
+	return 0;
+}
+
+int w_Atlas_getTexture(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	luax_pushtype(L, atlas->getTexture());
+	return 1;
+}
+
+int w_Atlas_getPageTexture(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	int page = (int) luaL_checkinteger(L, 2) - 1;
+	Texture *texture = nullptr;
+	luax_catchexcept(L, [&]() { texture = atlas->getPageTexture(page); });
+	luax_pushtype(L, texture);
+	return 1;
+}
+
+int w_Atlas_getPageCount(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	lua_pushinteger(L, atlas->getPageCount());
+	return 1;
+}
+
+int w_Atlas_getImageCount(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	lua_pushinteger(L, atlas->getImageCount());
+	return 1;
+}
+
+int w_Atlas_getDimensions(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	const Atlas::Settings &settings = atlas->getSettings();
+	lua_pushinteger(L, settings.width);
+	lua_pushinteger(L, settings.height);
+	return 2;
+}
+
+int w_Atlas_getPadding(lua_State *L)
+{
+	Atlas *atlas = luax_checkatlas(L, 1);
+	lua_pushinteger(L, atlas->getSettings().padding);
+	return 1;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "add", w_Atlas_add },
+	{ "generateMipmaps", w_Atlas_generateMipmaps },
+	{ "getTexture", w_Atlas_getTexture },
+	{ "getPageTexture", w_Atlas_getPageTexture },
+	{ "getPageCount", w_Atlas_getPageCount },
+	{ "getImageCount", w_Atlas_getImageCount },
+	{ "getDimensions", w_Atlas_getDimensions },
+	{ "getPadding", w_Atlas_getPadding },
+	{ 0, 0 }
+};
+
+int luaopen_atlas(lua_State *L)
+{
+	return luax_register_type(L, &Atlas::type, functions, nullptr);
+}
+
+} // graphics
+} // love
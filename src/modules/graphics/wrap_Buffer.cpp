@@ -23,12 +23,17 @@
 #include "common/Data.h"
 
 #include <limits>
+#include <vector>
 
 namespace love
 {
 namespace graphics
 {
 
+static const char buffer_lua[] =
+#include "wrap_Buffer.lua"
+;
+
 static const double defaultComponents[] = {0.0, 0.0, 0.0, 1.0};
 
 template <typename T>
@@ -77,59 +82,124 @@ static inline size_t writeDataRequired(lua_State *L, int startidx, int component
 	return sizeof(T) * components;
 }
 
-void luax_writebufferdata(lua_State *L, int startidx, DataFormat format, char *data)
+// The component count is a template parameter so the loops above can be
+// unrolled, and a writer can be looked up once per member instead of once per
+// element.
+template <typename T, int components>
+static void writeDataN(lua_State *L, int startidx, char *data)
+{
+	writeData<T>(L, startidx, components, data);
+}
+
+template <typename T, int components>
+static void writeSNormDataN(lua_State *L, int startidx, char *data)
+{
+	writeSNormData<T>(L, startidx, components, data);
+}
+
+template <typename T, int components>
+static void writeUNormDataN(lua_State *L, int startidx, char *data)
+{
+	writeUNormData<T>(L, startidx, components, data);
+}
+
+template <typename T, int components>
+static void writeDataRequiredN(lua_State *L, int startidx, char *data)
+{
+	writeDataRequired<T>(L, startidx, components, data);
+}
+
+// Positions and texture coordinates of most vertex formats.
+static void writeFloatVec2(lua_State *L, int startidx, char *data)
+{
+	float *componentdata = (float *) data;
+
+	if (lua_type(L, startidx) == LUA_TNUMBER && lua_type(L, startidx + 1) == LUA_TNUMBER)
+	{
+		componentdata[0] = (float) lua_tonumber(L, startidx);
+		componentdata[1] = (float) lua_tonumber(L, startidx + 1);
+	}
+	else
+		writeData<float>(L, startidx, 2, data);
+}
+
+// Colors of most vertex formats.
+static void writeUNorm8Vec4(lua_State *L, int startidx, char *data)
+{
+	uint8 *componentdata = (uint8 *) data;
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (lua_type(L, startidx + i) == LUA_TNUMBER)
+		{
+			lua_Number n = lua_tonumber(L, startidx + i);
+			componentdata[i] = (uint8) ((n < 0.0 ? 0.0 : (n > 1.0 ? 1.0 : n)) * 255);
+		}
+		else
+			componentdata[i] = (uint8) (luax_optnumberclamped01(L, startidx + i, 1.0) * 255);
+	}
+}
+
+BufferDataWriter luax_getbufferdatawriter(DataFormat format)
 {
 	switch (format)
 	{
-		case DATAFORMAT_FLOAT:      writeData<float>(L, startidx, 1, data); break;
-		case DATAFORMAT_FLOAT_VEC2: writeData<float>(L, startidx, 2, data); break;
-		case DATAFORMAT_FLOAT_VEC3: writeData<float>(L, startidx, 3, data); break;
-		case DATAFORMAT_FLOAT_VEC4: writeData<float>(L, startidx, 4, data); break;
+		case DATAFORMAT_FLOAT:      return writeDataN<float, 1>;
+		case DATAFORMAT_FLOAT_VEC2: return writeFloatVec2;
+		case DATAFORMAT_FLOAT_VEC3: return writeDataN<float, 3>;
+		case DATAFORMAT_FLOAT_VEC4: return writeDataN<float, 4>;
 
-		case DATAFORMAT_FLOAT_MAT2X2: writeDataRequired<float>(L, startidx, 4, data); break;
-		case DATAFORMAT_FLOAT_MAT2X3: writeDataRequired<float>(L, startidx, 6, data); break;
-		case DATAFORMAT_FLOAT_MAT2X4: writeDataRequired<float>(L, startidx, 8, data); break;
+		case DATAFORMAT_FLOAT_MAT2X2: return writeDataRequiredN<float, 4>;
+		case DATAFORMAT_FLOAT_MAT2X3: return writeDataRequiredN<float, 6>;
+		case DATAFORMAT_FLOAT_MAT2X4: return writeDataRequiredN<float, 8>;
 
-		case DATAFORMAT_FLOAT_MAT3X2: writeDataRequired<float>(L, startidx, 6, data); break;
-		case DATAFORMAT_FLOAT_MAT3X3: writeDataRequired<float>(L, startidx, 9, data); break;
-		case DATAFORMAT_FLOAT_MAT3X4: writeDataRequired<float>(L, startidx, 12, data); break;
+		case DATAFORMAT_FLOAT_MAT3X2: return writeDataRequiredN<float, 6>;
+		case DATAFORMAT_FLOAT_MAT3X3: return writeDataRequiredN<float, 9>;
+		case DATAFORMAT_FLOAT_MAT3X4: return writeDataRequiredN<float, 12>;
 
-		case DATAFORMAT_FLOAT_MAT4X2: writeDataRequired<float>(L, startidx, 8, data); break;
-		case DATAFORMAT_FLOAT_MAT4X3: writeDataRequired<float>(L, startidx, 12, data); break;
-		case DATAFORMAT_FLOAT_MAT4X4: writeDataRequired<float>(L, startidx, 16, data); break;
+		case DATAFORMAT_FLOAT_MAT4X2: return writeDataRequiredN<float, 8>;
+		case DATAFORMAT_FLOAT_MAT4X3: return writeDataRequiredN<float, 12>;
+		case DATAFORMAT_FLOAT_MAT4X4: return writeDataRequiredN<float, 16>;
 
-		case DATAFORMAT_INT32:      writeData<int32>(L, startidx, 1, data); break;
-		case DATAFORMAT_INT32_VEC2: writeData<int32>(L, startidx, 2, data); break;
-		case DATAFORMAT_INT32_VEC3: writeData<int32>(L, startidx, 3, data); break;
-		case DATAFORMAT_INT32_VEC4: writeData<int32>(L, startidx, 4, data); break;
+		case DATAFORMAT_INT32:      return writeDataN<int32, 1>;
+		case DATAFORMAT_INT32_VEC2: return writeDataN<int32, 2>;
+		case DATAFORMAT_INT32_VEC3: return writeDataN<int32, 3>;
+		case DATAFORMAT_INT32_VEC4: return writeDataN<int32, 4>;
 
-		case DATAFORMAT_UINT32:      writeData<uint32>(L, startidx, 1, data); break;
-		case DATAFORMAT_UINT32_VEC2: writeData<uint32>(L, startidx, 2, data); break;
-		case DATAFORMAT_UINT32_VEC3: writeData<uint32>(L, startidx, 3, data); break;
-		case DATAFORMAT_UINT32_VEC4: writeData<uint32>(L, startidx, 4, data); break;
+		case DATAFORMAT_UINT32:      return writeDataN<uint32, 1>;
+		case DATAFORMAT_UINT32_VEC2: return writeDataN<uint32, 2>;
+		case DATAFORMAT_UINT32_VEC3: return writeDataN<uint32, 3>;
+		case DATAFORMAT_UINT32_VEC4: return writeDataN<uint32, 4>;
 
-		case DATAFORMAT_SNORM8_VEC4: writeSNormData<int8>(L, startidx, 4, data); break;
-		case DATAFORMAT_UNORM8_VEC4: writeUNormData<uint8>(L, startidx, 4, data); break;
-		case DATAFORMAT_INT8_VEC4:   writeData<int8>(L, startidx, 4, data); break;
-		case DATAFORMAT_UINT8_VEC4:  writeData<uint8>(L, startidx, 4, data); break;
+		case DATAFORMAT_SNORM8_VEC4: return writeSNormDataN<int8, 4>;
+		case DATAFORMAT_UNORM8_VEC4: return writeUNorm8Vec4;
+		case DATAFORMAT_INT8_VEC4:   return writeDataN<int8, 4>;
+		case DATAFORMAT_UINT8_VEC4:  return writeDataN<uint8, 4>;
 
-		case DATAFORMAT_SNORM16_VEC2: writeSNormData<int16>(L, startidx, 2, data); break;
-		case DATAFORMAT_SNORM16_VEC4: writeSNormData<int16>(L, startidx, 4, data); break;
+		case DATAFORMAT_SNORM16_VEC2: return writeSNormDataN<int16, 2>;
+		case DATAFORMAT_SNORM16_VEC4: return writeSNormDataN<int16, 4>;
 
-		case DATAFORMAT_UNORM16_VEC2: writeUNormData<uint16>(L, startidx, 2, data); break;
-		case DATAFORMAT_UNORM16_VEC4: writeUNormData<uint16>(L, startidx, 4, data); break;
+		case DATAFORMAT_UNORM16_VEC2: return writeUNormDataN<uint16, 2>;
+		case DATAFORMAT_UNORM16_VEC4: return writeUNormDataN<uint16, 4>;
 
-		case DATAFORMAT_INT16_VEC2: writeData<int16>(L, startidx, 2, data); break;
-		case DATAFORMAT_INT16_VEC4: writeData<int16>(L, startidx, 4, data); break;
+		case DATAFORMAT_INT16_VEC2: return writeDataN<int16, 2>;
+		case DATAFORMAT_INT16_VEC4: return writeDataN<int16, 4>;
 
-		case DATAFORMAT_UINT16:      writeData<uint16>(L, startidx, 1, data); break;
-		case DATAFORMAT_UINT16_VEC2: writeData<uint16>(L, startidx, 2, data); break;
-		case DATAFORMAT_UINT16_VEC4: writeData<uint16>(L, startidx, 4, data); break;
+		case DATAFORMAT_UINT16:      return writeDataN<uint16, 1>;
+		case DATAFORMAT_UINT16_VEC2: return writeDataN<uint16, 2>;
+		case DATAFORMAT_UINT16_VEC4: return writeDataN<uint16, 4>;
 
-		default: break;
+		default: return nullptr;
 	}
 }
 
+void luax_writebufferdata(lua_State *L, int startidx, DataFormat format, char *data)
+{
+	BufferDataWriter writer = luax_getbufferdatawriter(format);
+	if (writer != nullptr)
+		writer(L, startidx, data);
+}
+
 template <typename T>
 static inline size_t readData(lua_State *L, int components, const char *data)
 {
@@ -215,6 +285,9 @@ static int w_Buffer_setArrayData(lua_State *L)
 {
 	Buffer *t = luax_checkbuffer(L, 1);
 
+	if (t->isWriteMapped())
+		return luaL_error(L, "Cannot set the data of a mapped Buffer.");
+
 	int sourceindex = (int) luaL_optnumber(L, 3, 1) - 1;
 	int destindex = (int) luaL_optnumber(L, 4, 1) - 1;
 
@@ -264,8 +337,13 @@ static int w_Buffer_setArrayData(lua_State *L)
 	const std::vector<Buffer::DataMember> &members = t->getDataMembers();
 
 	int ncomponents = 0;
+	std::vector<BufferDataWriter> writers;
+	writers.reserve(members.size());
 	for (const Buffer::DataMember &member : members)
+	{
 		ncomponents += member.info.components;
+		writers.push_back(luax_getbufferdatawriter(member.decl.format));
+	}
 
 	luaL_checktype(L, 2, LUA_TTABLE);
 	int tablelen = (int) luax_objlen(L, 2);
@@ -305,10 +383,11 @@ static int w_Buffer_setArrayData(lua_State *L)
 
 			int idx = -ncomponents;
 
-			for (const Buffer::DataMember &member : members)
+			for (size_t m = 0; m < members.size(); m++)
 			{
-				luax_writebufferdata(L, idx, member.decl.format, data + member.offset);
-				idx += member.info.components;
+				if (writers[m] != nullptr)
+					writers[m](L, idx, data + members[m].offset);
+				idx += members[m].info.components;
 			}
 
 			lua_pop(L, ncomponents + 1);
@@ -325,10 +404,11 @@ static int w_Buffer_setArrayData(lua_State *L)
 
 			int idx = -ncomponents;
 
-			for (const Buffer::DataMember &member : members)
+			for (size_t m = 0; m < members.size(); m++)
 			{
-				luax_writebufferdata(L, idx, member.decl.format, data + member.offset);
-				idx += member.info.components;
+				if (writers[m] != nullptr)
+					writers[m](L, idx, data + members[m].offset);
+				idx += members[m].info.components;
 			}
 
 			lua_pop(L, ncomponents);
@@ -341,6 +421,45 @@ static int w_Buffer_setArrayData(lua_State *L)
 	return 0;
 }
 
+static int w_Buffer_map(lua_State *L)
+{
+	Buffer *t = luax_checkbuffer(L, 1);
+
+	int start = (int) luaL_optnumber(L, 2, 1) - 1;
+	int arraylength = (int) t->getArrayLength();
+
+	if (start < 0 || start >= arraylength)
+		return luaL_error(L, "Invalid start index (must be between 1 and %d)", arraylength);
+
+	int count = (int) luaL_optnumber(L, 3, arraylength - start);
+	if (count <= 0)
+		return luaL_error(L, "Element count must be greater than 0.");
+	if (start + count > arraylength)
+		return luaL_error(L, "Too many array elements (expected at most %d, got %d)", arraylength - start, count);
+
+	size_t stride = t->getArrayStride();
+	void *data = nullptr;
+	luax_catchexcept(L, [&]() { data = t->mapWrite(start * stride, count * stride); });
+
+	lua_pushlightuserdata(L, data);
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+static int w_Buffer_unmap(lua_State *L)
+{
+	Buffer *t = luax_checkbuffer(L, 1);
+	luax_catchexcept(L, [&]() { t->unmapWrite(); });
+	return 0;
+}
+
+static int w_Buffer_isMapped(lua_State *L)
+{
+	Buffer *t = luax_checkbuffer(L, 1);
+	luax_pushboolean(L, t->isWriteMapped());
+	return 1;
+}
+
 static int w_Buffer_clear(lua_State *L)
 {
 	Buffer *t = luax_checkbuffer(L, 1);
@@ -444,6 +563,9 @@ static int w_Buffer_getDebugName(lua_State *L)
 static const luaL_Reg w_Buffer_functions[] =
 {
 	{ "setArrayData", w_Buffer_setArrayData },
+	{ "map", w_Buffer_map },
+	{ "unmap", w_Buffer_unmap },
+	{ "isMapped", w_Buffer_isMapped },
 	{ "clear", w_Buffer_clear },
 	{ "getElementCount", w_Buffer_getElementCount },
 	{ "getElementStride", w_Buffer_getElementStride },
@@ -456,7 +578,11 @@ static const luaL_Reg w_Buffer_functions[] =
 
 extern "C" int luaopen_graphicsbuffer(lua_State *L)
 {
-	return luax_register_type(L, &Buffer::type, w_Buffer_functions, nullptr);
+	int n = luax_register_type(L, &Buffer::type, w_Buffer_functions, nullptr);
+
+	luax_runwrapper(L, buffer_lua, sizeof(buffer_lua), "Buffer.lua", Buffer::type, nullptr);
+
+	return n;
 }
 
 } // graphics
@@ -29,6 +29,11 @@ namespace love
 namespace graphics
 {
 
+typedef void (*BufferDataWriter)(lua_State *L, int startidx, char *data);
+
+// Returns nullptr for formats that can't be written from Lua.
+BufferDataWriter luax_getbufferdatawriter(DataFormat format);
+
 void luax_writebufferdata(lua_State *L, int startidx, DataFormat format, char *data);
 void luax_readbufferdata(lua_State *L, DataFormat format, const char *data);
 
@@ -0,0 +1,154 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Buffer_mt = ...
+local Buffer = Buffer_mt.__index
+
+local type, tostring, tonumber, setmetatable, ipairs = type, tostring, tonumber, setmetatable, ipairs
+local concat = table.concat
+
+-- Everything below this point is FFI-only functionality.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+-- C types and sizes of the components of each data format.
+local componenttypes = {
+	float = {"float", 4},
+	int32 = {"int32_t", 4},
+	uint32 = {"uint32_t", 4},
+	snorm8 = {"int8_t", 1},
+	unorm8 = {"uint8_t", 1},
+	int8 = {"int8_t", 1},
+	uint8 = {"uint8_t", 1},
+	snorm16 = {"int16_t", 2},
+	unorm16 = {"uint16_t", 2},
+	int16 = {"int16_t", 2},
+	uint16 = {"uint16_t", 2},
+	bool = {"uint32_t", 4},
+}
+
+local function getmemberdecl(member, index)
+	local format = member.format
+	local base, columns, components
+
+	local matbase, matcolumns, matrows = format:match("^(%a+)mat(%d)x(%d)$")
+	local vecbase, veccomponents = format:match("^(%a+%d*)vec(%d)$")
+
+	if matbase then
+		base, columns, components = matbase, tonumber(matcolumns), tonumber(matrows)
+	elseif vecbase then
+		base, columns, components = vecbase, 1, tonumber(veccomponents)
+	else
+		base, columns, components = format, 1, 1
+	end
+
+	local ctype = componenttypes[base]
+	if ctype == nil then
+		error("Buffer data format '" .. format .. "' can't be mapped.", 4)
+	end
+
+	-- Uniform and shader storage buffer layouts can pad vectors and matrix
+	-- columns. The padding shows up as extra components.
+	local arraylength = member.arraylength > 0 and member.arraylength or 1
+	local elementsize = member.size / arraylength
+	components = elementsize / (columns * ctype[2])
+
+	local name = member.name
+	if not name:match("^[%a_][%w_]*$") then
+		name = "_" .. tostring(index)
+	end
+
+	local dims = ""
+	if member.arraylength > 0 then
+		dims = dims .. "[" .. member.arraylength .. "]"
+	end
+	if columns > 1 then
+		dims = dims .. "[" .. columns .. "]"
+	end
+	if components > 1 then
+		dims = dims .. "[" .. components .. "]"
+	end
+
+	return ctype[1] .. " " .. name .. dims .. ";"
+end
+
+-- Pointer types of the formats seen so far, keyed by their declaration.
+local pointertypes = {}
+
+-- Pointer types of each Buffer, so the format is only looked at once.
+local bufferpointertypes = setmetatable({}, {__mode = "k"})
+
+local function getpointertype(buffer)
+	local pointertype = bufferpointertypes[buffer]
+	if pointertype then
+		return pointertype
+	end
+
+	local decls = {}
+	local offset = 0
+
+	for i, member in ipairs(buffer:getFormat()) do
+		if member.offset > offset then
+			decls[#decls + 1] = "uint8_t _pad" .. i .. "[" .. (member.offset - offset) .. "];"
+		end
+		decls[#decls + 1] = getmemberdecl(member, i)
+		offset = member.offset + member.size
+	end
+
+	local stride = buffer:getElementStride()
+	if stride > offset then
+		decls[#decls + 1] = "uint8_t _padend[" .. (stride - offset) .. "];"
+	end
+
+	local decl = "struct __attribute__((packed)) { " .. concat(decls, " ") .. " } *"
+
+	pointertype = pointertypes[decl]
+	if pointertype == nil then
+		pointertype = ffi.typeof(decl)
+		pointertypes[decl] = pointertype
+	end
+
+	bufferpointertypes[buffer] = pointertype
+	return pointertype
+end
+
+local _map = Buffer.map
+
+-- Returns a pointer to a struct per array element, with a field for each
+-- member of the Buffer's format. The pointer is 0-based, unlike array indices.
+function Buffer:map(start, count)
+	local pointer, mapcount = _map(self, start, count)
+	return ffi.cast(getpointertype(self), pointer), mapcount
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
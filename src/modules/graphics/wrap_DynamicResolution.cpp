@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_DynamicResolution.h"
+
+namespace love
+{
+namespace graphics
+{
+
+DynamicResolution *luax_checkdynamicresolution(lua_State *L, int idx)
+{
+	return luax_checktype<DynamicResolution>(L, idx);
+}
+
+int w_DynamicResolution_beginFrame(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	luax_catchexcept(L, [&]() { dr->beginFrame(); });
+	return 0;
+}
+
+int w_DynamicResolution_endFrame(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	luax_catchexcept(L, [&]() { dr->endFrame(); });
+	return 0;
+}
+
+int w_DynamicResolution_isInFrame(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	luax_pushboolean(L, dr->isInFrame());
+	return 1;
+}
+
+int w_DynamicResolution_setScale(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	dr->setScale((float) luaL_checknumber(L, 2));
+	return 0;
+}
+
+int w_DynamicResolution_getScale(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	lua_pushnumber(L, dr->getScale());
+	return 1;
+}
+
+int w_DynamicResolution_setScaleRange(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	float minscale = (float) luaL_checknumber(L, 2);
+	float maxscale = (float) luaL_checknumber(L, 3);
+	luax_catchexcept(L, [&]() { dr->setScaleRange(minscale, maxscale); });
+	return 0;
+}
+
+int w_DynamicResolution_getScaleRange(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	float minscale = 0.0f;
+	float maxscale = 0.0f;
+	dr->getScaleRange(minscale, maxscale);
+	lua_pushnumber(L, minscale);
+	lua_pushnumber(L, maxscale);
+	return 2;
+}
+
+int w_DynamicResolution_setTargetFrameTime(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	double seconds = luaL_checknumber(L, 2);
+	luax_catchexcept(L, [&]() { dr->setTargetFrameTime(seconds); });
+	return 0;
+}
+
+int w_DynamicResolution_getTargetFrameTime(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	lua_pushnumber(L, dr->getTargetFrameTime());
+	return 1;
+}
+
+int w_DynamicResolution_setUpscaler(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	const char *str = luaL_checkstring(L, 2);
+	DynamicResolution::Upscaler upscaler;
+	if (!DynamicResolution::getConstant(str, upscaler))
+		return luax_enumerror(L, "upscaler", DynamicResolution::getConstants(upscaler), str);
+	dr->setUpscaler(upscaler);
+	return 0;
+}
+
+int w_DynamicResolution_getUpscaler(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	const char *str = nullptr;
+	if (!DynamicResolution::getConstant(dr->getUpscaler(), str))
+		return luaL_error(L, "Unknown upscaler.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_DynamicResolution_setSharpness(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	dr->setSharpness((float) luaL_checknumber(L, 2));
+	return 0;
+}
+
+int w_DynamicResolution_getSharpness(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	lua_pushnumber(L, dr->getSharpness());
+	return 1;
+}
+
+int w_DynamicResolution_getLastFrameTime(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	lua_pushnumber(L, dr->getLastFrameTime());
+	return 1;
+}
+
+int w_DynamicResolution_isGPUTimed(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	luax_pushboolean(L, dr->isGPUTimed());
+	return 1;
+}
+
+int w_DynamicResolution_getRenderDimensions(lua_State *L)
+{
+	DynamicResolution *dr = luax_checkdynamicresolution(L, 1);
+	int w = 0;
+	int h = 0;
+	dr->getRenderDimensions(w, h);
+	lua_pushinteger(L, w);
+	lua_pushinteger(L, h);
+	return 2;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "beginFrame", w_DynamicResolution_beginFrame },
+	{ "endFrame", w_DynamicResolution_endFrame },
+	{ "isInFrame", w_DynamicResolution_isInFrame },
+	{ "setScale", w_DynamicResolution_setScale },
+	{ "getScale", w_DynamicResolution_getScale },
+	{ "setScaleRange", w_DynamicResolution_setScaleRange },
+	{ "getScaleRange", w_DynamicResolution_getScaleRange },
+	{ "setTargetFrameTime", w_DynamicResolution_setTargetFrameTime },
+	{ "getTargetFrameTime", w_DynamicResolution_getTargetFrameTime },
+	{ "setUpscaler", w_DynamicResolution_setUpscaler },
+	{ "getUpscaler", w_DynamicResolution_getUpscaler },
+	{ "setSharpness", w_DynamicResolution_setSharpness },
+	{ "getSharpness", w_DynamicResolution_getSharpness },
+	{ "getLastFrameTime", w_DynamicResolution_getLastFrameTime },
+	{ "isGPUTimed", w_DynamicResolution_isGPUTimed },
+	{ "getRenderDimensions", w_DynamicResolution_getRenderDimensions },
+	{ 0, 0 }
+};
+
+int luaopen_dynamicresolution(lua_State *L)
+{
+	return luax_register_type(L, &DynamicResolution::type, functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -225,6 +225,55 @@ int w_Font_hasGlyphs(lua_State *L)
 	return 1;
 }
 
+int w_Font_isSDF(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isSDF());
+	return 1;
+}
+
+int w_Font_prewarm(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	std::vector<uint32> codepoints;
+	bool async = true;
+
+	luax_catchexcept(L, [&]() {
+		if (lua_type(L, 2) == LUA_TSTRING)
+		{
+			love::font::getCodepointsFromString(luax_checkstring(L, 2), codepoints);
+			async = luax_optboolean(L, 3, true);
+		}
+		else
+		{
+			uint32 first = (uint32) luaL_checknumber(L, 2);
+			uint32 last = (uint32) luaL_optnumber(L, 3, first);
+			async = luax_optboolean(L, 4, true);
+
+			if (last < first)
+				throw love::Exception("Invalid codepoint range: %d to %d.", first, last);
+
+			for (uint32 c = first; c <= last; c++)
+				codepoints.push_back(c);
+		}
+	});
+
+	bool pending = false;
+	luax_catchexcept(L, [&]() { pending = t->prewarm(codepoints, async); });
+
+	luax_pushboolean(L, pending);
+	return 1;
+}
+
+int w_Font_isPrewarming(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	bool prewarming = false;
+	luax_catchexcept(L, [&]() { prewarming = t->isPrewarming(); });
+	luax_pushboolean(L, prewarming);
+	return 1;
+}
+
 int w_Font_getKerning(lua_State *L)
 {
 	Font *t = luax_checkfont(L, 1);
@@ -283,6 +332,9 @@ static const luaL_Reg w_Font_functions[] =
 	{ "hasGlyphs", w_Font_hasGlyphs },
 	{ "getKerning", w_Font_getKerning },
 	{ "setFallbacks", w_Font_setFallbacks },
+	{ "isSDF", w_Font_isSDF },
+	{ "prewarm", w_Font_prewarm },
+	{ "isPrewarming", w_Font_isPrewarming },
 	{ "getDPIScale", w_Font_getDPIScale },
 	{ 0, 0 }
 };
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#include "wrap_FrameCapture.h"
+
+namespace love
+{
+namespace graphics
+{
+
+FrameCapture *luax_checkframecapture(lua_State *L, int idx)
+{
+	return luax_checktype<FrameCapture>(L, idx);
+}
+
+int w_FrameCapture_beginCapture(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	luax_catchexcept(L, [&]() { capture->beginCapture(); });
+	return 0;
+}
+
+int w_FrameCapture_endCapture(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	luax_catchexcept(L, [&]() { capture->endCapture(); });
+	return 0;
+}
+
+int w_FrameCapture_isCapturing(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	luax_pushboolean(L, capture->isCapturing());
+	return 1;
+}
+
+int w_FrameCapture_clear(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	if (capture->isCapturing())
+		return luaL_error(L, "A FrameCapture cannot be cleared while it's capturing.");
+	capture->clear();
+	return 0;
+}
+
+int w_FrameCapture_getCommandCount(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	lua_pushinteger(L, capture->getCommandCount());
+	return 1;
+}
+
+int w_FrameCapture_getCommand(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	if (index < 0 || index >= capture->getCommandCount())
+		return luaL_error(L, "Invalid command index: %d", index + 1);
+
+	const char *typestr = nullptr;
+	if (!FrameCapture::getConstant(capture->getCommandType(index), typestr))
+		return luaL_error(L, "Unknown command type.");
+
+	lua_pushstring(L, typestr);
+
+	double time = capture->getCommandTime(index);
+	if (time >= 0.0)
+		lua_pushnumber(L, time);
+	else
+		lua_pushnil(L);
+
+	return 2;
+}
+
+int w_FrameCapture_replay(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	double time = 0.0;
+	luax_catchexcept(L, [&]() { time = capture->replay(); });
+	lua_pushnumber(L, time);
+	return 1;
+}
+
+int w_FrameCapture_save(lua_State *L)
+{
+	FrameCapture *capture = luax_checkframecapture(L, 1);
+	const char *filename = luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { capture->save(filename); });
+	return 0;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "beginCapture", w_FrameCapture_beginCapture },
+	{ "endCapture", w_FrameCapture_endCapture },
+	{ "isCapturing", w_FrameCapture_isCapturing },
+	{ "clear", w_FrameCapture_clear },
+	{ "getCommandCount", w_FrameCapture_getCommandCount },
+	{ "getCommand", w_FrameCapture_getCommand },
+	{ "replay", w_FrameCapture_replay },
+	{ "save", w_FrameCapture_save },
+	{ 0, 0 }
+};
+
+int luaopen_framecapture(lua_State *L)
+{
+	return luax_register_type(L, &FrameCapture::type, functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -60,6 +60,43 @@ static int luax_checkgraphicscreated(lua_State *L)
 	return 0;
 }
 
+/**
+ * Lets resource creation functions be called from love.thread threads. The
+ * whole function runs on the main thread while the calling thread waits, so
+ * the calling thread's Lua state is still only used by one thread at a time.
+ * Errors are caught there and raised again on the calling thread.
+ **/
+template <lua_CFunction F>
+static int w__onMainThread(lua_State *L)
+{
+	if (instance()->isMainThread())
+		return F(L);
+
+	int nargs = lua_gettop(L);
+	bool success = false;
+
+	luax_catchexcept(L, [&]() {
+		instance()->runOnMainThread([&]() {
+			lua_pushcfunction(L, F);
+			lua_insert(L, 1);
+			success = lua_pcall(L, nargs, LUA_MULTRET, 0) == 0;
+
+			// The created objects must be destroyed on the main thread too.
+			for (int i = 1; success && i <= lua_gettop(L); i++)
+			{
+				Object *object = luax_totype<Object>(L, i, Object::type);
+				if (object != nullptr)
+					instance()->deferThreadedRelease(object);
+			}
+		});
+	});
+
+	if (!success)
+		return lua_error(L);
+
+	return lua_gettop(L);
+}
+
 int w_reset(lua_State *)
 {
 	instance()->reset();
@@ -141,6 +178,10 @@ int w_clear(lua_State *L)
 			depth.value = luaL_checknumber(L, startidx + 1);
 	}
 
+	FrameCapture *capture = instance()->getActiveFrameCapture();
+	if (capture != nullptr)
+		capture->captureClear(color, colors, stencil, depth);
+
 	if (colors.empty())
 		luax_catchexcept(L, [&]() { instance()->clear(color, stencil, depth); });
 	else
@@ -192,6 +233,73 @@ int w_isActive(lua_State *L)
 	return 1;
 }
 
+int w_setRedrawOnDemand(lua_State *L)
+{
+	instance()->setRedrawOnDemand(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isRedrawOnDemand(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isRedrawOnDemand());
+	return 1;
+}
+
+int w_invalidate(lua_State *L)
+{
+	instance()->invalidate(luaL_optnumber(L, 1, 0.0));
+	return 0;
+}
+
+int w_validate(lua_State *)
+{
+	instance()->validate();
+	return 0;
+}
+
+int w_getRedrawDelay(lua_State *L)
+{
+	double delay = instance()->getRedrawDelay();
+	if (delay < 0.0)
+		lua_pushnil(L);
+	else
+		lua_pushnumber(L, delay);
+	return 1;
+}
+
+int w_setStatsOverlayEnabled(lua_State *L)
+{
+	instance()->setStatsOverlayEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isStatsOverlayEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isStatsOverlayEnabled());
+	return 1;
+}
+
+int w_drawStatsOverlay(lua_State *L)
+{
+	double cputime = luaL_optnumber(L, 1, -1.0);
+
+	std::vector<std::string> lines;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int count = (int) luax_objlen(L, 2);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			lines.push_back(luax_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&]() { instance()->drawStatsOverlay(cputime, lines); });
+	return 0;
+}
+
 int w_isGammaCorrect(lua_State *L)
 {
 	luax_pushboolean(L, graphics::isGammaCorrect());
@@ -204,6 +312,12 @@ int w_isLowPowerPreferred(lua_State *L)
 	return 1;
 }
 
+int w_isShaderCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, graphics::isShaderCacheEnabled());
+	return 1;
+}
+
 int w_getWidth(lua_State *L)
 {
 	lua_pushinteger(L, instance()->getWidth());
@@ -324,6 +438,8 @@ int w_setCanvas(lua_State *L)
 
 		if (targets.depthStencil.texture == nullptr && (targets.temporaryRTFlags & tempstencilflag) == 0)
 			targets.temporaryRTFlags |= luax_boolflag(L, 1, "stencil", false) ? tempstencilflag : 0;
+
+		targets.resolve = luax_boolflag(L, 1, "resolve", true);
 	}
 	else
 	{
@@ -397,7 +513,7 @@ int w_getCanvas(lua_State *L)
 		return 1;
 	}
 
-	bool shouldUseTablesVariant = targets.depthStencil.texture != nullptr;
+	bool shouldUseTablesVariant = targets.depthStencil.texture != nullptr || !targets.resolve;
 
 	if (!shouldUseTablesVariant)
 	{
@@ -427,6 +543,12 @@ int w_getCanvas(lua_State *L)
 			lua_setfield(L, -2, "depthstencil");
 		}
 
+		if (!targets.resolve)
+		{
+			lua_pushboolean(L, 0);
+			lua_setfield(L, -2, "resolve");
+		}
+
 		return 1;
 	}
 	else
@@ -756,7 +878,7 @@ static int w__pushNewTexture(lua_State *L, Texture::Slices *slices, const Textur
 	return 1;
 }
 
-static void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool checkType, bool checkDimensions, OptionalBool forceRenderTarget, Texture::Settings &s, bool &setdpiscale)
+void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool checkType, bool checkDimensions, OptionalBool forceRenderTarget, Texture::Settings &s, bool &setdpiscale)
 {
 	setdpiscale = false;
 	if (forceRenderTarget.hasValue)
@@ -861,6 +983,10 @@ static void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool chec
 		s.readable.set(luax_checkboolean(L, -1));
 	lua_pop(L, 1);
 
+	s.evictable = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_EVICTABLE), s.evictable);
+	s.transient = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_TRANSIENT), s.transient);
+	s.streaming = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_STREAMING), s.streaming);
+
 	lua_getfield(L, idx, Texture::getConstant(Texture::SETTING_DPI_SCALE));
 	if (lua_isnumber(L, -1))
 	{
@@ -913,6 +1039,31 @@ int w_newCanvas(lua_State *L)
 	return 1;
 }
 
+int w_getTemporaryCanvas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int width = (int) luaL_checkinteger(L, 1);
+	int height = (int) luaL_checkinteger(L, 2);
+
+	PixelFormat format = PIXELFORMAT_NORMAL;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!getConstant(str, format))
+			return luax_enumerror(L, "pixel format", str);
+	}
+
+	int msaa = (int) luaL_optinteger(L, 4, 1);
+
+	Texture *texture = nullptr;
+	luax_catchexcept(L, [&](){ texture = instance()->getTemporaryCanvas(format, width, height, msaa); });
+
+	// The temporary pool keeps its own reference.
+	luax_pushtype(L, texture);
+	return 1;
+}
+
 int w_newTexture(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1441,16 +1592,18 @@ int w_newSpriteBatch(lua_State *L)
 	Texture *texture = luax_checktexture(L, 1);
 	int size = (int) luaL_optinteger(L, 2, 1000);
 	BufferDataUsage usage = BUFFERDATAUSAGE_DYNAMIC;
-	if (lua_gettop(L) > 2)
+	if (!lua_isnoneornil(L, 3))
 	{
 		const char *usagestr = luaL_checkstring(L, 3);
 		if (!getConstant(usagestr, usage))
 			return luax_enumerror(L, "usage hint", getConstants(usage), usagestr);
 	}
 
+	bool instanced = luax_optboolean(L, 4, false);
+
 	SpriteBatch *t = nullptr;
 	luax_catchexcept(L,
-		[&](){ t = instance()->newSpriteBatch(texture, size, usage); }
+		[&](){ t = instance()->newSpriteBatch(texture, size, usage, instanced); }
 	);
 
 	luax_pushtype(L, t);
@@ -1464,12 +1617,13 @@ int w_newParticleSystem(lua_State *L)
 
 	Texture *texture = luax_checktexture(L, 1);
 	lua_Number size = luaL_optnumber(L, 2, 1000);
+	bool gpusimulated = luax_optboolean(L, 3, false);
 	ParticleSystem *t = nullptr;
 	if (size < 1.0 || size > ParticleSystem::MAX_PARTICLES)
 		return luaL_error(L, "Invalid ParticleSystem size");
 
 	luax_catchexcept(L,
-		[&](){ t = instance()->newParticleSystem(texture, int(size)); }
+		[&](){ t = instance()->newParticleSystem(texture, int(size), gpusimulated); }
 	);
 
 	luax_pushtype(L, t);
@@ -1551,34 +1705,7 @@ static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string
 			if (!lua_istable(L, -1))
 				luaL_argerror(L, optionsidx, "expected 'defines' field to be a table");
 
-			lua_pushnil(L);
-			while (lua_next(L, -2))
-			{
-				std::string defname;
-				std::string defval;
-
-				if (lua_type(L, -2) == LUA_TNUMBER && lua_type(L, -1) == LUA_TSTRING)
-					defname = luaL_checkstring(L, -1);
-				else if (lua_type(L, -2) != LUA_TSTRING)
-					luaL_argerror(L, optionsidx, "all fields in the 'defines' table must use string keys.");
-				else
-				{
-					defname = luaL_checkstring(L, -2);
-					if (lua_type(L, -1) == LUA_TBOOLEAN)
-						defval = luax_toboolean(L, -1) ? "1" : "0";
-					else
-					{
-						const char *val = lua_tostring(L, -1);
-						if (val == nullptr)
-							luaL_argerror(L, optionsidx, "'defines' table values must be strings, numbers, or booleans.");
-						defval = val;
-					}
-				}
-
-				options.defines[defname] = defval;
-
-				lua_pop(L, 1);
-			}
+			luax_checkshaderdefines(L, lua_gettop(L), optionsidx, options.defines);
 		}
 		lua_pop(L, 1);
 
@@ -1586,6 +1713,11 @@ static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string
 		if (!lua_isnoneornil(L, -1))
 			options.debugName = luax_checkstring(L, -1);
 		lua_pop(L, 1);
+
+		lua_getfield(L, optionsidx, "async");
+		if (!lua_isnoneornil(L, -1))
+			options.async = luax_checkboolean(L, -1);
+		lua_pop(L, 1);
 	}
 
 	return 0;
@@ -2344,6 +2476,201 @@ int w_newVideo(lua_State *L)
 	return 1;
 }
 
+int w_newVideoRecorder(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int width = (int) luaL_checkinteger(L, 2);
+	int height = (int) luaL_checkinteger(L, 3);
+	double fps = luaL_optnumber(L, 4, 60.0);
+
+	if (fps <= 0.0)
+		return luaL_error(L, "Invalid frame rate: %f", fps);
+
+	// Y4M stores the frame rate as a ratio.
+	int fpsnumerator = (int) (fps * 1000.0 + 0.5);
+	int fpsdenominator = 1000;
+	while (fpsnumerator % 10 == 0 && fpsdenominator > 1)
+	{
+		fpsnumerator /= 10;
+		fpsdenominator /= 10;
+	}
+
+	love::filesystem::File *file = love::filesystem::luax_getfile(L, 1);
+
+	VideoRecorder *recorder = nullptr;
+	luax_catchexcept(L,
+		[&]() { recorder = instance()->newVideoRecorder(file, width, height, fpsnumerator, fpsdenominator); },
+		[&](bool) { file->release(); }
+	);
+
+	luax_pushtype(L, recorder);
+	recorder->release();
+	return 1;
+}
+
+int w_newVirtualTexture(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int width = (int) luaL_checkinteger(L, 1);
+	int height = (int) luaL_checkinteger(L, 2);
+
+	int pagesize = 256;
+	int cachesize = 64;
+	PixelFormat format = PIXELFORMAT_NORMAL;
+	bool linear = false;
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+
+		lua_getfield(L, 3, "pagesize");
+		pagesize = (int) luaL_optinteger(L, -1, pagesize);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "cachesize");
+		cachesize = (int) luaL_optinteger(L, -1, cachesize);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "format");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!getConstant(str, format))
+				return luax_enumerror(L, "pixel format", str);
+		}
+		lua_pop(L, 1);
+
+		linear = luax_boolflag(L, 3, "linear", linear);
+	}
+
+	VirtualTexture *vt = nullptr;
+	luax_catchexcept(L, [&]() { vt = instance()->newVirtualTexture(width, height, pagesize, cachesize, format, linear); });
+
+	luax_pushtype(L, vt);
+	vt->release();
+	return 1;
+}
+
+int w_newDrawList(lua_State *L)
+{
+	DrawList *list = nullptr;
+	luax_catchexcept(L, [&]() { list = instance()->newDrawList(); });
+
+	luax_pushtype(L, list);
+	list->release();
+	return 1;
+}
+
+int w_newFrameCapture(lua_State *L)
+{
+	FrameCapture *capture = nullptr;
+	luax_catchexcept(L, [&]() { capture = instance()->newFrameCapture(); });
+
+	luax_pushtype(L, capture);
+	capture->release();
+	return 1;
+}
+
+int w_newRenderGraph(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	RenderGraph *graph = nullptr;
+	luax_catchexcept(L, [&]() { graph = instance()->newRenderGraph(); });
+
+	luax_pushtype(L, graph);
+	graph->release();
+	return 1;
+}
+
+int w_newDynamicResolution(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	DynamicResolution::Settings settings;
+
+	if (!lua_isnoneornil(L, 1))
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+
+		settings.minScale = (float) luax_numberflag(L, 1, "minscale", settings.minScale);
+		settings.maxScale = (float) luax_numberflag(L, 1, "maxscale", settings.maxScale);
+		settings.targetFrameTime = luax_numberflag(L, 1, "targetframetime", settings.targetFrameTime);
+		settings.sharpness = (float) luax_numberflag(L, 1, "sharpness", settings.sharpness);
+
+		lua_getfield(L, 1, "upscaler");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!DynamicResolution::getConstant(str, settings.upscaler))
+				return luax_enumerror(L, "upscaler", DynamicResolution::getConstants(settings.upscaler), str);
+		}
+		lua_pop(L, 1);
+	}
+
+	DynamicResolution *dr = nullptr;
+	luax_catchexcept(L, [&]() { dr = instance()->newDynamicResolution(settings); });
+
+	luax_pushtype(L, dr);
+	dr->release();
+	return 1;
+}
+
+int w_newAtlas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Atlas::Settings settings;
+
+	settings.width = (int) luaL_optinteger(L, 1, settings.width);
+	settings.height = (int) luaL_optinteger(L, 2, settings.height);
+	settings.pages = (int) luaL_optinteger(L, 3, settings.pages);
+
+	if (!lua_isnoneornil(L, 4))
+	{
+		luaL_checktype(L, 4, LUA_TTABLE);
+
+		settings.padding = luax_intflag(L, 4, "padding", settings.padding);
+		settings.mipmaps = luax_boolflag(L, 4, "mipmaps", settings.mipmaps);
+		settings.linear = luax_boolflag(L, 4, "linear", settings.linear);
+
+		lua_getfield(L, 4, "format");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!getConstant(str, settings.format))
+				luax_enumerror(L, "pixel format", str);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 4, "debugname");
+		if (!lua_isnoneornil(L, -1))
+			settings.debugName = luaL_checkstring(L, -1);
+		lua_pop(L, 1);
+	}
+
+	Atlas *atlas = nullptr;
+	luax_catchexcept(L, [&]() { atlas = instance()->newAtlas(settings); });
+
+	luax_pushtype(L, atlas);
+	atlas->release();
+	return 1;
+}
+
+int w_newOcclusionQuery(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	OcclusionQuery *query = nullptr;
+	luax_catchexcept(L, [&]() { query = instance()->newOcclusionQuery(); });
+
+	luax_pushtype(L, query);
+	query->release();
+	return 1;
+}
+
 int w_readbackBuffer(lua_State *L)
 {
 	Buffer *b = luax_checkbuffer(L, 1);
@@ -2449,7 +2776,15 @@ int w_readbackTextureAsync(lua_State *L)
 	int destx = 0;
 	int desty = 0;
 
-	if (!lua_isnoneornil(L, 8))
+	data::ByteData *destbytes = nullptr;
+	size_t destbytesoffset = 0;
+
+	if (luax_istype(L, 8, data::ByteData::type))
+	{
+		destbytes = luax_checktype<data::ByteData>(L, 8);
+		destbytesoffset = (size_t) luaL_optinteger(L, 9, 0);
+	}
+	else if (!lua_isnoneornil(L, 8))
 	{
 		dest = luax_checktype<image::ImageData>(L, 8);
 		destx = (int) luaL_optinteger(L, 9, 0);
@@ -2457,7 +2792,7 @@ int w_readbackTextureAsync(lua_State *L)
 	}
 
 	GraphicsReadback *r = nullptr;
-	luax_catchexcept(L, [&]() { r = instance()->readbackTextureAsync(t, slice, mipmap, rect, dest, destx, desty); });
+	luax_catchexcept(L, [&]() { r = instance()->readbackTextureAsync(t, slice, mipmap, rect, dest, destx, desty, destbytes, destbytesoffset); });
 
 	luax_pushtype(L, r);
 	r->release();
@@ -2844,6 +3179,27 @@ int w_getLineJoin(lua_State *L)
 	return 1;
 }
 
+int w_setShapeRendering(lua_State *L)
+{
+	Graphics::ShapeRendering rendering;
+	const char *str = luaL_checkstring(L, 1);
+	if (!Graphics::getConstant(str, rendering))
+		return luax_enumerror(L, "shape rendering mode", Graphics::getConstants(rendering), str);
+
+	instance()->setShapeRendering(rendering);
+	return 0;
+}
+
+int w_getShapeRendering(lua_State *L)
+{
+	Graphics::ShapeRendering rendering = instance()->getShapeRendering();
+	const char *str;
+	if (!Graphics::getConstant(rendering, str))
+		return luaL_error(L, "Unknown shape rendering mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_setPointSize(lua_State *L)
 {
 	float size = (float)luaL_checknumber(L, 1);
@@ -2947,6 +3303,18 @@ int w_isWireframe(lua_State *L)
 	return 1;
 }
 
+int w_setArrayLayerBatching(lua_State *L)
+{
+	instance()->setArrayLayerBatching(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isArrayLayerBatching(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isArrayLayerBatching());
+	return 1;
+}
+
 int w_setShader(lua_State *L)
 {
 	if (lua_isnoneornil(L,1))
@@ -2956,7 +3324,7 @@ int w_setShader(lua_State *L)
 	}
 
 	Shader *shader = luax_checkshader(L, 1);
-	instance()->setShader(shader);
+	luax_catchexcept(L, [&]() { instance()->setShader(shader); });
 	return 0;
 }
 
@@ -2971,6 +3339,26 @@ int w_getShader(lua_State *L)
 	return 1;
 }
 
+int w_setUniformBuffer(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	Buffer *buffer = lua_isnoneornil(L, 2) ? nullptr : luax_checkbuffer(L, 2);
+	luax_catchexcept(L, [&]() { instance()->setUniformBuffer(name, buffer); });
+	return 0;
+}
+
+int w_getUniformBuffer(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	Buffer *buffer = instance()->getUniformBuffer(name);
+	if (buffer)
+		luax_pushtype(L, buffer);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
 int w_getSupported(lua_State *L)
 {
 	const Graphics::Capabilities &caps = instance()->getCapabilities();
@@ -3176,6 +3564,71 @@ int w_getSystemLimits(lua_State *L)
 	return 1;
 }
 
+int w_setTextureMemoryBudget(lua_State *L)
+{
+	int64 bytes = (int64) luaL_checknumber(L, 1);
+	instance()->setTextureMemoryBudget(bytes);
+	return 0;
+}
+
+int w_getTextureMemoryBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getTextureMemoryBudget());
+	return 1;
+}
+
+int w_setTextureStreamingBudget(lua_State *L)
+{
+	int64 bytes = (int64) luaL_checknumber(L, 1);
+	instance()->setTextureStreamingBudget(bytes);
+	return 0;
+}
+
+int w_getTextureStreamingBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getTextureStreamingBudget());
+	return 1;
+}
+
+int w_setThreadedCreationBudget(lua_State *L)
+{
+	double seconds = luaL_checknumber(L, 1);
+	instance()->setThreadedCreationBudget(seconds);
+	return 0;
+}
+
+int w_getThreadedCreationBudget(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getThreadedCreationBudget());
+	return 1;
+}
+
+int w_setFrameLatency(lua_State *L)
+{
+	int frames = (int) luaL_checkinteger(L, 1);
+	instance()->setFrameLatency(frames);
+	return 0;
+}
+
+int w_getFrameLatency(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getFrameLatency());
+	return 1;
+}
+
+int w_setDrawReorderWindow(lua_State *L)
+{
+	int draws = (int) luaL_checkinteger(L, 1);
+	instance()->setDrawReorderWindow(draws);
+	return 0;
+}
+
+int w_getDrawReorderWindow(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getDrawReorderWindow());
+	return 1;
+}
+
 int w_getStats(lua_State *L)
 {
 	Graphics::Stats stats = instance()->getStats();
@@ -3212,9 +3665,112 @@ int w_getStats(lua_State *L)
 	lua_pushnumber(L, (lua_Number) stats.bufferMemory);
 	lua_setfield(L, -2, "buffermemory");
 
+	lua_pushnumber(L, (lua_Number) stats.bufferBytesUploaded);
+	lua_setfield(L, -2, "bufferbytesuploaded");
+
+	lua_pushnumber(L, (lua_Number) stats.uniformBytesUploaded);
+	lua_setfield(L, -2, "uniformbytesuploaded");
+
+	lua_pushnumber(L, stats.streamBufferStallTime);
+	lua_setfield(L, -2, "streambufferstalltime");
+
+	lua_pushnumber(L, (lua_Number) stats.gpuMemoryUsage);
+	lua_setfield(L, -2, "gpumemoryusage");
+
+	lua_pushnumber(L, (lua_Number) stats.gpuMemoryBudget);
+	lua_setfield(L, -2, "gpumemorybudget");
+
+	lua_createtable(L, 0, Graphics::BATCHFLUSH_MAX_ENUM);
+	for (int i = 0; i < Graphics::BATCHFLUSH_MAX_ENUM; i++)
+	{
+		const char *name = nullptr;
+		if (!Graphics::getConstant((Graphics::BatchFlushReason) i, name))
+			continue;
+		lua_pushinteger(L, stats.batchFlushes[i]);
+		lua_setfield(L, -2, name);
+	}
+	lua_setfield(L, -2, "batchflushes");
+
 	return 1;
 }
 
+int w_pushGPUTimer(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	luax_catchexcept(L, [&](){ instance()->pushGPUTimer(name); });
+	return 0;
+}
+
+int w_popGPUTimer(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->popGPUTimer(); });
+	return 0;
+}
+
+int w_getGPUTimings(lua_State *L)
+{
+	const auto &timings = instance()->getGPUTimings();
+
+	lua_createtable(L, (int) timings.size(), 0);
+
+	for (size_t i = 0; i < timings.size(); i++)
+	{
+		const Graphics::GPUTiming &timing = timings[i];
+
+		lua_createtable(L, 0, 3);
+
+		luax_pushstring(L, timing.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushinteger(L, timing.depth);
+		lua_setfield(L, -2, "depth");
+
+		lua_pushnumber(L, timing.time);
+		lua_setfield(L, -2, "time");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_beginOcclusionQuery(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&](){ instance()->beginOcclusionQuery(query); });
+	return 0;
+}
+
+int w_endOcclusionQuery(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endOcclusionQuery(); });
+	return 0;
+}
+
+int w_getActiveOcclusionQuery(lua_State *L)
+{
+	OcclusionQuery *query = instance()->getActiveOcclusionQuery();
+	if (query)
+		luax_pushtype(L, query);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+int w_beginConditionalRender(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&](){ instance()->beginConditionalRender(query); });
+	return 0;
+}
+
+int w_endConditionalRender(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endConditionalRender(); });
+	return 0;
+}
+
 int w_draw(lua_State *L)
 {
 	Drawable *drawable = nullptr;
@@ -3224,7 +3780,9 @@ int w_draw(lua_State *L)
 
 	if (quad != nullptr)
 	{
-		texture = luax_checktexture(L, 1);
+		// Quads from an Atlas can be drawn with the Atlas itself.
+		Atlas *atlas = luax_totype<Atlas>(L, 1);
+		texture = atlas != nullptr ? atlas->getTexture() : luax_checktexture(L, 1);
 		startidx = 3;
 	}
 	else if (lua_isnil(L, 2) && !lua_isnoneornil(L, 3))
@@ -3283,6 +3841,41 @@ int w_drawLayer(lua_State *L)
 	return 0;
 }
 
+int w_drawMany(lua_State *L)
+{
+	// Quads from an Atlas can be drawn with the Atlas itself.
+	Atlas *atlas = luax_totype<Atlas>(L, 1);
+	Texture *texture = atlas != nullptr ? atlas->getTexture() : luax_checktexture(L, 1);
+
+	std::vector<Quad *> quads;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int quadcount = (int) luax_objlen(L, 2);
+		quads.reserve(quadcount);
+
+		for (int i = 1; i <= quadcount; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			quads.push_back(luax_checktype<Quad>(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	love::Data *data = luax_checktype<love::Data>(L, 3);
+
+	int maxcount = (int) (data->getSize() / sizeof(Texture::ManySprite));
+	int count = (int) luaL_optinteger(L, 4, maxcount);
+
+	if (count < 0 || count > maxcount)
+		return luaL_error(L, "Invalid sprite count %d (the Data holds %d sprites.)", count, maxcount);
+
+	const Texture::ManySprite *sprites = (const Texture::ManySprite *) data->getData();
+
+	luax_catchexcept(L, [&]() { instance()->drawMany(texture, quads.data(), (int) quads.size(), sprites, count); });
+	return 0;
+}
+
 int w_drawInstanced(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -3304,7 +3897,22 @@ int w_drawIndirect(lua_State *L)
 
 	luax_checkstandardtransform(L, 4, [&](const Matrix4 &m)
 	{
-		luax_catchexcept(L, [&]() { instance()->drawIndirect(t, m, argsbuffer, argsindex); });
+		luax_catchexcept(L, [&]() { instance()->drawIndirect(t, m, argsbuffer, argsindex, 1); });
+	});
+
+	return 0;
+}
+
+int w_multiDrawIndirect(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Buffer *argsbuffer = luax_checkbuffer(L, 2);
+	int argsindex = (int) luaL_checkinteger(L, 3) - 1;
+	int drawcount = (int) luaL_checkinteger(L, 4);
+
+	luax_checkstandardtransform(L, 5, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&]() { instance()->drawIndirect(t, m, argsbuffer, argsindex, drawcount); });
 	});
 
 	return 0;
@@ -3359,7 +3967,9 @@ int w_drawFromShaderIndirect(lua_State *L)
 		if (!lua_isnoneornil(L, 4))
 			tex = luax_checktexture(L, 4);
 
-		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(t, argsbuffer, argsindex, tex); });
+		int drawcount = (int) luaL_optinteger(L, 5, 1);
+
+		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(t, argsbuffer, argsindex, drawcount, tex); });
 	}
 	else
 	{
@@ -3375,7 +3985,9 @@ int w_drawFromShaderIndirect(lua_State *L)
 		if (!lua_isnoneornil(L, 4))
 			tex = luax_checktexture(L, 4);
 
-		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(primtype, argsbuffer, argsindex, tex); });
+		int drawcount = (int) luaL_optinteger(L, 5, 1);
+
+		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(primtype, argsbuffer, argsindex, drawcount, tex); });
 	}
 	return 0;
 }
@@ -3783,6 +4395,37 @@ int w_dispatchIndirect(lua_State *L)
 	return 0;
 }
 
+int w_prefixSum(lua_State *L)
+{
+	Buffer *source = luax_checkbuffer(L, 1);
+	Buffer *dest = luax_checkbuffer(L, 2);
+	int count = (int) luaL_optinteger(L, 3, source->getArrayLength());
+	luax_catchexcept(L, [&]() { instance()->prefixSum(source, dest, count); });
+	return 0;
+}
+
+int w_radixSort(lua_State *L)
+{
+	Buffer *keys = luax_checkbuffer(L, 1);
+	Buffer *values = lua_isnoneornil(L, 2) ? nullptr : luax_checkbuffer(L, 2);
+	int count = (int) luaL_optinteger(L, 3, keys->getArrayLength());
+	int keybits = (int) luaL_optinteger(L, 4, 32);
+	luax_catchexcept(L, [&]() { instance()->radixSort(keys, values, count, keybits); });
+	return 0;
+}
+
+int w_compactBuffer(lua_State *L)
+{
+	Buffer *flags = luax_checkbuffer(L, 1);
+	Buffer *dest = luax_checkbuffer(L, 2);
+	Buffer *source = lua_isnoneornil(L, 3) ? nullptr : luax_checkbuffer(L, 3);
+	int count = (int) luaL_optinteger(L, 4, flags->getArrayLength());
+	Buffer *countbuffer = lua_isnoneornil(L, 5) ? nullptr : luax_checkbuffer(L, 5);
+	int countindex = (int) luaL_optinteger(L, 6, 1) - 1;
+	luax_catchexcept(L, [&]() { instance()->compactBuffer(flags, source, dest, count, countbuffer, countindex); });
+	return 0;
+}
+
 int w_copyBuffer(lua_State *L)
 {
 	Buffer *source = luax_checkbuffer(L, 1);
@@ -3870,7 +4513,7 @@ int w_copyTextureToBuffer(lua_State *L)
 
 int w_flushBatch(lua_State *)
 {
-	instance()->flushBatchedDraws();
+	instance()->flushBatchedDraws(Graphics::BATCHFLUSH_EXPLICIT);
 	return 0;
 }
 
@@ -3892,7 +4535,14 @@ int w_push(lua_State *L)
 	if (luax_istype(L, 2, math::Transform::type))
 	{
 		math::Transform *t = luax_totype<math::Transform>(L, 2);
-		luax_catchexcept(L, [&]() { instance()->applyTransform(t->getMatrix()); });
+		bool replace = luax_optboolean(L, 3, false);
+		luax_catchexcept(L, [&]()
+		{
+			if (replace)
+				instance()->replaceTransform(t->getMatrix());
+			else
+				instance()->applyTransform(t->getMatrix());
+		});
 	}
 
 	return 0;
@@ -4016,6 +4666,63 @@ int w_resetProjection(lua_State */*L*/)
 }
 
 
+// C functions in a struct, necessary for the FFI versions of love.graphics
+// functions. They return false instead of throwing, and the regular function is
+// then called to raise the error (the checks happen before anything is drawn.)
+struct FFI_Graphics
+{
+	bool (*draw)(Proxy *drawable, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawQuad)(Proxy *texture, Proxy *quad, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+};
+
+static FFI_Graphics ffifuncs =
+{
+	[](Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // draw
+	{
+		auto drawable = luax_ffi_checktype<Drawable>(p);
+		auto gfx = instance();
+		if (drawable == nullptr || gfx == nullptr)
+			return false;
+
+		try
+		{
+			gfx->draw(drawable, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](Proxy *p, Proxy *q, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // drawQuad
+	{
+		auto texture = luax_ffi_checktype<Texture>(p);
+		auto quad = luax_ffi_checktype<Quad>(q);
+		auto gfx = instance();
+		if (texture == nullptr)
+		{
+			auto atlas = luax_ffi_checktype<Atlas>(p);
+			if (atlas != nullptr)
+				texture = atlas->getTexture();
+		}
+		if (texture == nullptr || quad == nullptr || gfx == nullptr)
+			return false;
+
+		try
+		{
+			gfx->draw(texture, quad, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+};
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -4024,23 +4731,32 @@ static const luaL_Reg functions[] =
 	{ "discard", w_discard },
 	{ "present", w_present },
 
-	{ "newCanvas", w_newCanvas },
-	{ "newTexture", w_newTexture },
-	{ "newCubeTexture", w_newCubeTexture },
-	{ "newArrayTexture", w_newArrayTexture },
-	{ "newVolumeTexture", w_newVolumeTexture },
-	{ "newTextureView", w_newTextureView },
+	{ "newCanvas", w__onMainThread<w_newCanvas> },
+	{ "getTemporaryCanvas", w__onMainThread<w_getTemporaryCanvas> },
+	{ "newTexture", w__onMainThread<w_newTexture> },
+	{ "newCubeTexture", w__onMainThread<w_newCubeTexture> },
+	{ "newArrayTexture", w__onMainThread<w_newArrayTexture> },
+	{ "newVolumeTexture", w__onMainThread<w_newVolumeTexture> },
+	{ "newTextureView", w__onMainThread<w_newTextureView> },
 	{ "newQuad", w_newQuad },
-	{ "newFont", w_newFont },
-	{ "newImageFont", w_newImageFont },
+	{ "newFont", w__onMainThread<w_newFont> },
+	{ "newImageFont", w__onMainThread<w_newImageFont> },
 	{ "newSpriteBatch", w_newSpriteBatch },
 	{ "newParticleSystem", w_newParticleSystem },
-	{ "newShader", w_newShader },
-	{ "newComputeShader", w_newComputeShader },
-	{ "newBuffer", w_newBuffer },
-	{ "newMesh", w_newMesh },
+	{ "newShader", w__onMainThread<w_newShader> },
+	{ "newComputeShader", w__onMainThread<w_newComputeShader> },
+	{ "newBuffer", w__onMainThread<w_newBuffer> },
+	{ "newMesh", w__onMainThread<w_newMesh> },
 	{ "newTextBatch", w_newTextBatch },
 	{ "_newVideo", w_newVideo },
+	{ "newVideoRecorder", w_newVideoRecorder },
+	{ "newVirtualTexture", w_newVirtualTexture },
+	{ "newDrawList", w_newDrawList },
+	{ "newFrameCapture", w_newFrameCapture },
+	{ "newRenderGraph", w_newRenderGraph },
+	{ "newDynamicResolution", w_newDynamicResolution },
+	{ "newAtlas", w_newAtlas },
+	{ "newOcclusionQuery", w_newOcclusionQuery },
 
 	{ "readbackBuffer", w_readbackBuffer },
 	{ "readbackBufferAsync", w_readbackBufferAsync },
@@ -4077,6 +4793,8 @@ static const luaL_Reg functions[] =
 	{ "getLineWidth", w_getLineWidth },
 	{ "getLineStyle", w_getLineStyle },
 	{ "getLineJoin", w_getLineJoin },
+	{ "setShapeRendering", w_setShapeRendering },
+	{ "getShapeRendering", w_getShapeRendering },
 	{ "setPointSize", w_setPointSize },
 	{ "getPointSize", w_getPointSize },
 	{ "setDepthMode", w_setDepthMode },
@@ -4087,9 +4805,13 @@ static const luaL_Reg functions[] =
 	{ "getFrontFaceWinding", w_getFrontFaceWinding },
 	{ "setWireframe", w_setWireframe },
 	{ "isWireframe", w_isWireframe },
+	{ "setArrayLayerBatching", w_setArrayLayerBatching },
+	{ "isArrayLayerBatching", w_isArrayLayerBatching },
 
 	{ "setShader", w_setShader },
 	{ "getShader", w_getShader },
+	{ "setUniformBuffer", w_setUniformBuffer },
+	{ "getUniformBuffer", w_getUniformBuffer },
 
 	{ "getSupported", w_getSupported },
 	{ "getTextureFormats", w_getTextureFormats },
@@ -4097,13 +4819,33 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "pushGPUTimer", w_pushGPUTimer },
+	{ "popGPUTimer", w_popGPUTimer },
+	{ "getGPUTimings", w_getGPUTimings },
+	{ "beginOcclusionQuery", w_beginOcclusionQuery },
+	{ "endOcclusionQuery", w_endOcclusionQuery },
+	{ "getActiveOcclusionQuery", w_getActiveOcclusionQuery },
+	{ "beginConditionalRender", w_beginConditionalRender },
+	{ "endConditionalRender", w_endConditionalRender },
+	{ "setTextureMemoryBudget", w_setTextureMemoryBudget },
+	{ "getTextureMemoryBudget", w_getTextureMemoryBudget },
+	{ "setTextureStreamingBudget", w_setTextureStreamingBudget },
+	{ "getTextureStreamingBudget", w_getTextureStreamingBudget },
+	{ "setThreadedCreationBudget", w_setThreadedCreationBudget },
+	{ "getThreadedCreationBudget", w_getThreadedCreationBudget },
+	{ "setFrameLatency", w_setFrameLatency },
+	{ "getFrameLatency", w_getFrameLatency },
+	{ "setDrawReorderWindow", w_setDrawReorderWindow },
+	{ "getDrawReorderWindow", w_getDrawReorderWindow },
 
 	{ "captureScreenshot", w_captureScreenshot },
 
 	{ "draw", w_draw },
 	{ "drawLayer", w_drawLayer },
+	{ "drawMany", w_drawMany },
 	{ "drawInstanced", w_drawInstanced },
 	{ "drawIndirect", w_drawIndirect },
+	{ "multiDrawIndirect", w_multiDrawIndirect },
 	{ "drawFromShader", w_drawFromShader },
 	{ "drawFromShaderIndirect", w_drawFromShaderIndirect },
 
@@ -4112,6 +4854,9 @@ static const luaL_Reg functions[] =
 
 	{ "dispatchThreadgroups", w_dispatchThreadgroups },
 	{ "dispatchIndirect", w_dispatchIndirect },
+	{ "prefixSum", w_prefixSum },
+	{ "radixSort", w_radixSort },
+	{ "compactBuffer", w_compactBuffer },
 
 	{ "copyBuffer", w_copyBuffer },
 	{ "copyBufferToTexture", w_copyBufferToTexture },
@@ -4119,8 +4864,17 @@ static const luaL_Reg functions[] =
 
 	{ "isCreated", w_isCreated },
 	{ "isActive", w_isActive },
+	{ "setRedrawOnDemand", w_setRedrawOnDemand },
+	{ "isRedrawOnDemand", w_isRedrawOnDemand },
+	{ "invalidate", w_invalidate },
+	{ "validate", w_validate },
+	{ "getRedrawDelay", w_getRedrawDelay },
+	{ "setStatsOverlayEnabled", w_setStatsOverlayEnabled },
+	{ "isStatsOverlayEnabled", w_isStatsOverlayEnabled },
+	{ "drawStatsOverlay", w_drawStatsOverlay },
 	{ "isGammaCorrect", w_isGammaCorrect },
 	{ "isLowPowerPreferred", w_isLowPowerPreferred },
+	{ "isShaderCacheEnabled", w_isShaderCacheEnabled },
 	{ "getWidth", w_getWidth },
 	{ "getHeight", w_getHeight },
 	{ "getDimensions", w_getDimensions },
@@ -4166,10 +4920,10 @@ static const luaL_Reg functions[] =
 	{ "resetProjection", w_resetProjection },
 
 	// Deprecated
-	{ "newImage", w_newImage },
-	{ "newArrayImage", w_newArrayImage },
-	{ "newVolumeImage", w_newVolumeImage },
-	{ "newCubeImage", w_newCubeImage },
+	{ "newImage", w__onMainThread<w_newImage> },
+	{ "newArrayImage", w__onMainThread<w_newArrayImage> },
+	{ "newVolumeImage", w__onMainThread<w_newVolumeImage> },
+	{ "newCubeImage", w__onMainThread<w_newCubeImage> },
 	{ "newText", w_newText },
 	{ "getCanvasFormats", w_getCanvasFormats },
 	{ "getImageFormats", w_getImageFormats },
@@ -4191,12 +4945,21 @@ static const lua_CFunction types[] =
 	luaopen_quad,
 	luaopen_graphicsbuffer,
 	luaopen_graphicsreadback,
+	luaopen_textureupload,
 	luaopen_spritebatch,
 	luaopen_particlesystem,
 	luaopen_shader,
 	luaopen_mesh,
 	luaopen_textbatch,
 	luaopen_video,
+	luaopen_virtualtexture,
+	luaopen_videorecorder,
+	luaopen_drawlist,
+	luaopen_framecapture,
+	luaopen_rendergraph,
+	luaopen_occlusionquery,
+	luaopen_dynamicresolution,
+	luaopen_atlas,
 	0
 };
 
@@ -4220,7 +4983,10 @@ extern "C" int luaopen_love_graphics(lua_State *L)
 	int n = luax_register_module(L, w);
 
 	if (luaL_loadbuffer(L, (const char *)graphics_lua, sizeof(graphics_lua), "=[love \"wrap_Graphics.lua\"]") == 0)
-		lua_call(L, 0, 0);
+	{
+		luax_pushpointerasstring(L, &ffifuncs);
+		lua_call(L, 1, 0);
+	}
 	else
 		lua_error(L);
 
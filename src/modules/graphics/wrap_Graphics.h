@@ -31,8 +31,17 @@
 #include "wrap_Mesh.h"
 #include "wrap_TextBatch.h"
 #include "wrap_Video.h"
+#include "wrap_VirtualTexture.h"
+#include "wrap_VideoRecorder.h"
+#include "wrap_DrawList.h"
+#include "wrap_FrameCapture.h"
+#include "wrap_RenderGraph.h"
+#include "wrap_OcclusionQuery.h"
+#include "wrap_DynamicResolution.h"
+#include "wrap_Atlas.h"
 #include "wrap_Buffer.h"
 #include "wrap_GraphicsReadback.h"
+#include "wrap_TextureUpload.h"
 #include "Graphics.h"
 
 namespace love
@@ -40,6 +49,8 @@ namespace love
 namespace graphics
 {
 
+void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool checkType, bool checkDimensions, OptionalBool forceRenderTarget, Texture::Settings &s, bool &setdpiscale);
+
 extern "C" LOVE_EXPORT int luaopen_love_graphics(lua_State *L);
 
 } // graphics
@@ -22,6 +22,8 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
+local ffifuncspointer_str = ...
+
 local table_concat = table.concat
 local ipairs = ipairs
 local pcall, type, error = pcall, type, error
@@ -129,5 +131,67 @@ function graphics._transformGLSLErrorMessages(message)
 	return table_concat(lines, "\n")
 end
 
+-- Everything below this point is efficient FFI replacements for existing
+-- love.graphics functionality.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Graphics
+{
+	bool (*draw)(Proxy *drawable, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawQuad)(Proxy *texture, Proxy *quad, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+} FFI_Graphics;
+]])
+
+local ffifuncs = ffi.cast("FFI_Graphics **", ffifuncspointer_str)[0]
+
+local function isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky)
+	return (x == nil or type(x) == "number") and (y == nil or type(y) == "number")
+		and (a == nil or type(a) == "number") and (sx == nil or type(sx) == "number")
+		and (sy == nil or type(sy) == "number") and (ox == nil or type(ox) == "number")
+		and (oy == nil or type(oy) == "number") and (kx == nil or type(kx) == "number")
+		and (ky == nil or type(ky) == "number")
+end
+
+-- The regular function is used when the FFI versions can't handle the
+-- arguments (for example a Transform instead of numbers), and to raise errors.
+local _draw = graphics.draw
+
+function graphics.draw(drawable, ...)
+	if type(drawable) == "userdata" then
+		local quad, x, y, a, sx, sy, ox, oy, kx, ky = ...
+		if type(quad) ~= "userdata" then
+			x, y, a, sx, sy, ox, oy, kx, ky = ...
+			quad = nil
+		end
+
+		if type(x) == "number" and isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky) then
+			sx = sx or 1
+			y, a, sy = y or 0, a or 0, sy or sx
+			ox, oy, kx, ky = ox or 0, oy or 0, kx or 0, ky or 0
+
+			-- love.graphics.draw(texture, quad, x, y, ...)
+			if quad ~= nil then
+				if ffifuncs.drawQuad(drawable, quad, x, y, a, sx, sy, ox, oy, kx, ky) then
+					return
+				end
+			elseif ffifuncs.draw(drawable, x, y, a, sx, sy, ox, oy, kx, ky) then
+				return
+			end
+		end
+	end
+	return _draw(drawable, ...)
+end
+
 -- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
 --)luastring"--"
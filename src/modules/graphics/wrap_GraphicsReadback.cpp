@@ -22,6 +22,7 @@
 #include "wrap_GraphicsReadback.h"
 #include "data/ByteData.h"
 #include "image/ImageData.h"
+#include "common/Reference.h"
 
 namespace love
 {
@@ -51,13 +52,14 @@ int w_GraphicsReadback_wait(lua_State *L)
 {
 	GraphicsReadback *t = luax_checkgraphicsreadback(L, 1);
 	t->wait();
+	luax_catchexcept(L, [&]() { t->runCompletionCallback(); });
 	return 0;
 }
 
 int w_GraphicsReadback_update(lua_State *L)
 {
 	GraphicsReadback *t = luax_checkgraphicsreadback(L, 1);
-	luax_catchexcept(L, [&]() { t->update(); });
+	luax_catchexcept(L, [&]() { t->update(); t->runCompletionCallback(); });
 	return 0;
 }
 
@@ -75,6 +77,51 @@ int w_GraphicsReadback_getImageData(lua_State *L)
 	return 1;
 }
 
+static void completionCallback(void *context, GraphicsReadback *readback)
+{
+	auto r = (Reference *) context;
+	lua_State *L = r->getPinnedL();
+
+	r->push(L);
+	luax_pushtype(L, readback);
+
+	int err = lua_pcall(L, 1, 0, 0);
+
+	if (err != 0)
+	{
+		std::string errstr = lua_tostring(L, -1);
+		lua_pop(L, 1);
+		throw love::Exception("Error in readback callback: %s", errstr.c_str());
+	}
+}
+
+static void cleanupCallback(void *context)
+{
+	auto r = (Reference *) context;
+	delete r;
+}
+
+int w_GraphicsReadback_setCallback(lua_State *L)
+{
+	GraphicsReadback *t = luax_checkgraphicsreadback(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+	{
+		t->setCompletionCallback(nullptr, nullptr, nullptr);
+		return 0;
+	}
+
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	// Save the callback function as a Reference.
+	lua_pushvalue(L, 2);
+	Reference *r = new Reference(L);
+	lua_pop(L, 1);
+
+	luax_catchexcept(L, [&]() { t->setCompletionCallback(completionCallback, cleanupCallback, r); });
+	return 0;
+}
+
 static const luaL_Reg w_GraphicsReadback_functions[] =
 {
 	{ "isComplete", w_GraphicsReadback_isComplete },
@@ -83,6 +130,7 @@ static const luaL_Reg w_GraphicsReadback_functions[] =
 	{ "update", w_GraphicsReadback_update },
 	{ "getBufferData", w_GraphicsReadback_getBufferData },
 	{ "getImageData", w_GraphicsReadback_getImageData },
+	{ "setCallback", w_GraphicsReadback_setCallback },
 	{ 0, 0 }
 };
 
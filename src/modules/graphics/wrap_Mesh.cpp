@@ -32,6 +32,10 @@ namespace love
 namespace graphics
 {
 
+static const char mesh_lua[] =
+#include "wrap_Mesh.lua"
+;
+
 Mesh *luax_checkmesh(lua_State *L, int idx)
 {
 	return luax_checktype<Mesh>(L, idx);
@@ -87,8 +91,13 @@ int w_Mesh_setVertices(lua_State *L)
 	const std::vector<Buffer::DataMember> &vertexformat = t->getVertexFormat();
 
 	int ncomponents = 0;
+	std::vector<BufferDataWriter> writers;
+	writers.reserve(vertexformat.size());
 	for (const Buffer::DataMember &member : vertexformat)
+	{
 		ncomponents += member.info.components;
+		writers.push_back(luax_getbufferdatawriter(member.decl.format));
+	}
 
 	char *data = (char *) t->getVertexData() + byteoffset;
 
@@ -104,11 +113,12 @@ int w_Mesh_setVertices(lua_State *L)
 
 		int idx = -ncomponents;
 
-		for (const Buffer::DataMember &member : vertexformat)
+		for (size_t m = 0; m < vertexformat.size(); m++)
 		{
 			// Fetch the values from Lua and store them in data buffer.
-			luax_writebufferdata(L, idx, member.decl.format, data + member.offset);
-			idx += member.info.components;
+			if (writers[m] != nullptr)
+				writers[m](L, idx, data + vertexformat[m].offset);
+			idx += vertexformat[m].info.components;
 		}
 
 		lua_pop(L, ncomponents + 1);
@@ -422,6 +432,35 @@ int w_Mesh_getVertexBuffer(lua_State *L)
 	return 1;
 }
 
+int w_Mesh_mapVertices(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	int vertstart = (int) luaL_optnumber(L, 2, 1) - 1;
+	int totalverts = (int) t->getVertexCount();
+
+	if (vertstart >= totalverts || vertstart < 0)
+		return luaL_error(L, "Invalid vertex start index (must be between 1 and %d)", totalverts);
+
+	int vertcount = (int) luaL_optnumber(L, 3, totalverts - vertstart);
+	if (vertcount <= 0)
+		return luaL_error(L, "Vertex count must be greater than 0.");
+	if (vertstart + vertcount > totalverts)
+		return luaL_error(L, "Too many vertices (expected at most %d, got %d)", totalverts - vertstart, vertcount);
+
+	char *data = nullptr;
+	size_t offset = 0;
+	luax_catchexcept(L, [&](){ data = (char *) t->checkVertexDataOffset(vertstart, &offset); });
+
+	// Anything written to the returned memory is uploaded the next time the
+	// Mesh is drawn or flushed.
+	t->setVertexDataModified(offset, vertcount * t->getVertexStride());
+
+	lua_pushlightuserdata(L, data);
+	lua_pushinteger(L, vertcount);
+	return 2;
+}
+
 int w_Mesh_flush(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -529,6 +568,23 @@ int w_Mesh_getIndexBuffer(lua_State *L)
 	return 1;
 }
 
+int w_Mesh_setBoneBuffer(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Buffer *b = nullptr;
+	if (!lua_isnoneornil(L, 2))
+		b = luax_checkbuffer(L, 2);
+	luax_catchexcept(L, [&]() { t->setBoneBuffer(b); });
+	return 0;
+}
+
+int w_Mesh_getBoneBuffer(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	luax_pushtype(L, t->getBoneBuffer());
+	return 1;
+}
+
 int w_Mesh_setTexture(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -612,6 +668,30 @@ int w_Mesh_getDrawRange(lua_State *L)
 	return 2;
 }
 
+int w_Mesh_optimize(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	Mesh::OptimizeSettings settings;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		settings.vertexCache = luax_boolflag(L, 2, "vertexcache", settings.vertexCache);
+		settings.overdraw = luax_boolflag(L, 2, "overdraw", settings.overdraw);
+		settings.overdrawThreshold = (float) luax_numberflag(L, 2, "overdrawthreshold", settings.overdrawThreshold);
+		settings.vertexFetch = luax_boolflag(L, 2, "vertexfetch", settings.vertexFetch);
+	}
+
+	float before = 0.0f;
+	float after = 0.0f;
+	luax_catchexcept(L, [&]() { t->optimize(settings, before, after); });
+
+	lua_pushnumber(L, before);
+	lua_pushnumber(L, after);
+	return 2;
+}
+
 static const luaL_Reg w_Mesh_functions[] =
 {
 	{ "setVertices", w_Mesh_setVertices },
@@ -627,23 +707,31 @@ static const luaL_Reg w_Mesh_functions[] =
 	{ "detachAttribute", w_Mesh_detachAttribute },
 	{ "getAttachedAttributes", w_Mesh_getAttachedAttributes },
 	{ "getVertexBuffer", w_Mesh_getVertexBuffer },
+	{ "mapVertices", w_Mesh_mapVertices },
 	{ "flush", w_Mesh_flush },
 	{ "setVertexMap", w_Mesh_setVertexMap },
 	{ "getVertexMap", w_Mesh_getVertexMap },
 	{ "setIndexBuffer", w_Mesh_setIndexBuffer },
 	{ "getIndexBuffer", w_Mesh_getIndexBuffer },
+	{ "setBoneBuffer", w_Mesh_setBoneBuffer },
+	{ "getBoneBuffer", w_Mesh_getBoneBuffer },
 	{ "setTexture", w_Mesh_setTexture },
 	{ "getTexture", w_Mesh_getTexture },
 	{ "setDrawMode", w_Mesh_setDrawMode },
 	{ "getDrawMode", w_Mesh_getDrawMode },
 	{ "setDrawRange", w_Mesh_setDrawRange },
 	{ "getDrawRange", w_Mesh_getDrawRange },
+	{ "optimize", w_Mesh_optimize },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_mesh(lua_State *L)
 {
-	return luax_register_type(L, &Mesh::type, w_Mesh_functions, nullptr);
+	int n = luax_register_type(L, &Mesh::type, w_Mesh_functions, nullptr);
+
+	luax_runwrapper(L, mesh_lua, sizeof(mesh_lua), "Mesh.lua", Mesh::type, nullptr);
+
+	return n;
 }
 
 } // graphics
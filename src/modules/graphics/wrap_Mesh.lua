@@ -0,0 +1,131 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Mesh_mt = ...
+local Mesh = Mesh_mt.__index
+
+local type, tostring, setmetatable = type, tostring, setmetatable
+local concat = table.concat
+
+-- Everything below this point is FFI-only functionality.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+-- C types of the components of each vertex attribute data format.
+local componenttypes = {
+	float = "float",
+	int32 = "int32_t",
+	uint32 = "uint32_t",
+	snorm8 = "int8_t",
+	unorm8 = "uint8_t",
+	int8 = "int8_t",
+	uint8 = "uint8_t",
+	snorm16 = "int16_t",
+	unorm16 = "uint16_t",
+	int16 = "int16_t",
+	uint16 = "uint16_t",
+}
+
+local function getmemberdecl(member, index)
+	local format = member.format
+	local base, dims
+
+	local matbase, columns, rows = format:match("^(%a+)mat(%d)x(%d)$")
+	local vecbase, components = format:match("^(%a+%d*)vec(%d)$")
+
+	if matbase then
+		base, dims = matbase, "[" .. columns .. "][" .. rows .. "]"
+	elseif vecbase then
+		base, dims = vecbase, "[" .. components .. "]"
+	else
+		base, dims = format, ""
+	end
+
+	local ctype = componenttypes[base]
+	if ctype == nil then
+		error("Vertex attribute format '" .. format .. "' can't be mapped.", 4)
+	end
+
+	local name = member.name
+	if not name:match("^[%a_][%w_]*$") then
+		name = "_" .. tostring(index)
+	end
+
+	if member.arraylength > 0 then
+		dims = "[" .. member.arraylength .. "]" .. dims
+	end
+
+	return ctype .. " " .. name .. dims .. ";"
+end
+
+-- Pointer types of the vertex formats seen so far, keyed by their declaration.
+local vertexpointertypes = {}
+
+-- Pointer types of each Mesh, so the format is only looked at once.
+local meshpointertypes = setmetatable({}, {__mode = "k"})
+
+local function getvertexpointertype(mesh)
+	local pointertype = meshpointertypes[mesh]
+	if pointertype then
+		return pointertype
+	end
+
+	local format = mesh:getVertexFormat()
+	local decls = {}
+	for i, member in ipairs(format) do
+		decls[i] = getmemberdecl(member, i)
+	end
+
+	-- Vertex attributes are tightly packed.
+	local decl = "struct __attribute__((packed)) { " .. concat(decls, " ") .. " } *"
+
+	pointertype = vertexpointertypes[decl]
+	if pointertype == nil then
+		pointertype = ffi.typeof(decl)
+		vertexpointertypes[decl] = pointertype
+	end
+
+	meshpointertypes[mesh] = pointertype
+	return pointertype
+end
+
+local _mapVertices = Mesh.mapVertices
+
+-- Returns a pointer to a struct per vertex, with a field for each attribute
+-- named after it. The pointer is 0-based, unlike vertex indices.
+function Mesh:mapVertices(start, count)
+	local pointer, mapcount = _mapVertices(self, start, count)
+	return ffi.cast(getvertexpointertype(self), pointer), mapcount
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+
+OcclusionQuery *luax_checkocclusionquery(lua_State *L, int idx)
+{
+	return luax_checktype<OcclusionQuery>(L, idx);
+}
+
+int w_OcclusionQuery_getResult(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+
+	bool anysamples = false;
+	bool available = false;
+	luax_catchexcept(L, [&]() { available = query->getResult(anysamples); });
+
+	if (available)
+		luax_pushboolean(L, anysamples);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_OcclusionQuery_isActive(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_pushboolean(L, query->isActive());
+	return 1;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "getResult", w_OcclusionQuery_getResult },
+	{ "isActive", w_OcclusionQuery_isActive },
+	{ 0, 0 }
+};
+
+int luaopen_occlusionquery(lua_State *L)
+{
+	return luax_register_type(L, &OcclusionQuery::type, functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -186,6 +186,82 @@ int w_ParticleSystem_moveTo(lua_State *L)
 	return 0;
 }
 
+int w_ParticleSystem_addEmitter(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	float x = (float)luaL_optnumber(L, 2, 0.0);
+	float y = (float)luaL_optnumber(L, 3, 0.0);
+	int id = 0;
+	luax_catchexcept(L, [&](){ id = t->addEmitter(x, y); });
+	lua_pushinteger(L, id);
+	return 1;
+}
+
+int w_ParticleSystem_removeEmitter(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	int id = (int)luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ t->removeEmitter(id); });
+	return 0;
+}
+
+int w_ParticleSystem_getEmitterCount(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	lua_pushinteger(L, t->getEmitterCount());
+	return 1;
+}
+
+int w_ParticleSystem_setEmitterPosition(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	int id = (int)luaL_checkinteger(L, 2);
+	float x = (float)luaL_checknumber(L, 3);
+	float y = (float)luaL_checknumber(L, 4);
+	luax_catchexcept(L, [&](){ t->setEmitterPosition(id, x, y); });
+	return 0;
+}
+
+int w_ParticleSystem_moveEmitter(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	int id = (int)luaL_checkinteger(L, 2);
+	float x = (float)luaL_checknumber(L, 3);
+	float y = (float)luaL_checknumber(L, 4);
+	luax_catchexcept(L, [&](){ t->moveEmitter(id, x, y); });
+	return 0;
+}
+
+int w_ParticleSystem_getEmitterPosition(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	int id = (int)luaL_checkinteger(L, 2);
+	love::Vector2 pos;
+	luax_catchexcept(L, [&](){ pos = t->getEmitterPosition(id); });
+	lua_pushnumber(L, pos.x);
+	lua_pushnumber(L, pos.y);
+	return 2;
+}
+
+int w_ParticleSystem_setEmitterActive(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	int id = (int)luaL_checkinteger(L, 2);
+	bool active = luax_checkboolean(L, 3);
+	luax_catchexcept(L, [&](){ t->setEmitterActive(id, active); });
+	return 0;
+}
+
+int w_ParticleSystem_isEmitterActive(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	int id = (int)luaL_checkinteger(L, 2);
+	bool active = false;
+	luax_catchexcept(L, [&](){ active = t->isEmitterActive(id); });
+	luax_pushboolean(L, active);
+	return 1;
+}
+
 int w_ParticleSystem_setEmissionArea(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -631,6 +707,13 @@ int w_ParticleSystem_hasRelativeRotation(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_isGPUSimulated(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	luax_pushboolean(L, t->isGPUSimulated());
+	return 1;
+}
+
 int w_ParticleSystem_getCount(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -662,7 +745,7 @@ int w_ParticleSystem_pause(lua_State *L)
 int w_ParticleSystem_reset(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
-	t->reset();
+	luax_catchexcept(L, [&](){ t->reset(); });
 	return 0;
 }
 
@@ -670,7 +753,7 @@ int w_ParticleSystem_emit(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
 	int num = (int) luaL_checkinteger(L, 2);
-	t->emit(num);
+	luax_catchexcept(L, [&](){ t->emit(num); });
 	return 0;
 }
 
@@ -699,7 +782,7 @@ int w_ParticleSystem_update(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
 	float dt = (float)luaL_checknumber(L, 2);
-	t->update(dt);
+	luax_catchexcept(L, [&](){ t->update(dt); });
 	return 0;
 }
 
@@ -721,6 +804,14 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "setPosition", w_ParticleSystem_setPosition },
 	{ "getPosition", w_ParticleSystem_getPosition },
 	{ "moveTo", w_ParticleSystem_moveTo },
+	{ "addEmitter", w_ParticleSystem_addEmitter },
+	{ "removeEmitter", w_ParticleSystem_removeEmitter },
+	{ "getEmitterCount", w_ParticleSystem_getEmitterCount },
+	{ "setEmitterPosition", w_ParticleSystem_setEmitterPosition },
+	{ "moveEmitter", w_ParticleSystem_moveEmitter },
+	{ "getEmitterPosition", w_ParticleSystem_getEmitterPosition },
+	{ "setEmitterActive", w_ParticleSystem_setEmitterActive },
+	{ "isEmitterActive", w_ParticleSystem_isEmitterActive },
 	{ "setEmissionArea", w_ParticleSystem_setEmissionArea },
 	{ "getEmissionArea", w_ParticleSystem_getEmissionArea },
 	{ "setDirection", w_ParticleSystem_setDirection },
@@ -755,6 +846,7 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "getOffset", w_ParticleSystem_getOffset },
 	{ "setRelativeRotation", w_ParticleSystem_setRelativeRotation },
 	{ "hasRelativeRotation", w_ParticleSystem_hasRelativeRotation },
+	{ "isGPUSimulated", w_ParticleSystem_isGPUSimulated },
 	{ "getCount", w_ParticleSystem_getCount },
 	{ "start", w_ParticleSystem_start },
 	{ "stop", w_ParticleSystem_stop },
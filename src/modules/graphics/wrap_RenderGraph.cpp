@@ -0,0 +1,309 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_RenderGraph.h"
+#include "wrap_Texture.h"
+#include "wrap_Graphics.h"
+#include "common/Reference.h"
+
+namespace love
+{
+namespace graphics
+{
+
+RenderGraph *luax_checkrendergraph(lua_State *L, int idx)
+{
+	return luax_checktype<RenderGraph>(L, idx);
+}
+
+static RenderGraph::Resource luax_checkrendergraphresource(lua_State *L, int idx, RenderGraph *graph)
+{
+	RenderGraph::Resource r;
+
+	if (lua_type(L, idx) == LUA_TSTRING)
+	{
+		const char *name = lua_tostring(L, idx);
+		r.transient = graph->getTransientCanvasIndex(name);
+		if (r.transient < 0)
+			luaL_error(L, "Unknown transient canvas '%s'.", name);
+	}
+	else
+		r.texture.set(luax_checktexture(L, idx));
+
+	return r;
+}
+
+static void passFunction(void *context, RenderGraph *graph)
+{
+	auto r = (Reference *) context;
+	lua_State *L = r->getPinnedL();
+
+	r->push(L);
+	luax_pushtype(L, graph);
+
+	int err = lua_pcall(L, 1, 0, 0);
+
+	if (err != 0)
+	{
+		std::string errstr = lua_tostring(L, -1);
+		lua_pop(L, 1);
+		throw love::Exception("Error in render pass: %s", errstr.c_str());
+	}
+}
+
+static void cleanupFunction(void *context)
+{
+	auto r = (Reference *) context;
+	delete r;
+}
+
+int w_RenderGraph_addTransientCanvas(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+
+	Texture::Settings s;
+	s.width = (int) luaL_checkinteger(L, 3);
+	s.height = (int) luaL_checkinteger(L, 4);
+
+	bool setdpiscale = false;
+	luax_checktexturesettings(L, 5, true, true, false, OptionalBool(true), s, setdpiscale);
+
+	if (!setdpiscale)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			s.dpiScale = gfx->getScreenDPIScale();
+	}
+
+	luax_catchexcept(L, [&]() { graph->addTransientCanvas(name, s); });
+	return 0;
+}
+
+int w_RenderGraph_getCanvas(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+
+	int transient = graph->getTransientCanvasIndex(name);
+	if (transient < 0)
+		return luaL_error(L, "Unknown transient canvas '%s'.", name);
+
+	Texture *texture = nullptr;
+	luax_catchexcept(L, [&]() { texture = graph->getCanvas(transient); });
+
+	luax_pushtype(L, texture);
+	return 1;
+}
+
+int w_RenderGraph_addPass(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+
+	RenderGraph::PassSettings settings;
+	settings.name = luaL_checkstring(L, 2);
+
+	int funcidx = 3;
+
+	if (lua_istable(L, 3))
+	{
+		funcidx = 4;
+
+		lua_getfield(L, 3, "canvas");
+		if (lua_istable(L, -1))
+		{
+			int ncolors = (int) luax_objlen(L, -1);
+			for (int i = 1; i <= ncolors; i++)
+			{
+				lua_rawgeti(L, -1, i);
+				settings.colors.push_back(luax_checkrendergraphresource(L, -1, graph));
+				lua_pop(L, 1);
+			}
+
+			lua_getfield(L, -1, "depthstencil");
+			if (!lua_isnoneornil(L, -1))
+				settings.depthStencil = luax_checkrendergraphresource(L, -1, graph);
+			lua_pop(L, 1);
+		}
+		else if (!lua_isnoneornil(L, -1))
+			settings.colors.push_back(luax_checkrendergraphresource(L, -1, graph));
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "reads");
+		if (lua_istable(L, -1))
+		{
+			int nreads = (int) luax_objlen(L, -1);
+			for (int i = 1; i <= nreads; i++)
+			{
+				lua_rawgeti(L, -1, i);
+				settings.reads.push_back(luax_checkrendergraphresource(L, -1, graph));
+				lua_pop(L, 1);
+			}
+		}
+		else if (!lua_isnoneornil(L, -1))
+			settings.reads.push_back(luax_checkrendergraphresource(L, -1, graph));
+		lua_pop(L, 1);
+
+		size_t ncolors = std::max(settings.colors.size(), (size_t) 1);
+		bool hasdepthstencil = settings.depthStencil.isValid();
+
+		lua_getfield(L, 3, "clear");
+		if (lua_istable(L, -1))
+		{
+			int tidx = lua_gettop(L);
+			for (int j = 1; j <= 4; j++)
+				lua_rawgeti(L, tidx, j);
+
+			OptionalColorD c;
+			c.hasValue = true;
+			c.value.r = luaL_checknumber(L, -4);
+			c.value.g = luaL_checknumber(L, -3);
+			c.value.b = luaL_checknumber(L, -2);
+			c.value.a = luaL_optnumber(L, -1, 1.0);
+			lua_pop(L, 4);
+
+			settings.clearColors.resize(ncolors, c);
+		}
+		else if (luax_toboolean(L, -1))
+		{
+			settings.clearColors.resize(ncolors, OptionalColorD(ColorD(0.0, 0.0, 0.0, 0.0)));
+			if (hasdepthstencil || settings.colors.empty())
+			{
+				settings.clearDepth = OptionalDouble(1.0);
+				settings.clearStencil = OptionalInt(0);
+			}
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "cleardepth");
+		if (!lua_isnoneornil(L, -1))
+			settings.clearDepth = OptionalDouble(luaL_checknumber(L, -1));
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "clearstencil");
+		if (!lua_isnoneornil(L, -1))
+			settings.clearStencil = OptionalInt((int) luaL_checkinteger(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luaL_checktype(L, funcidx, LUA_TFUNCTION);
+
+	// Save the pass function as a Reference.
+	lua_pushvalue(L, funcidx);
+	Reference *r = new Reference(L);
+	lua_pop(L, 1);
+
+	luax_catchexcept(L, [&]() { graph->addPass(settings, passFunction, cleanupFunction, r); });
+	return 0;
+}
+
+int w_RenderGraph_getPassCount(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+	lua_pushinteger(L, graph->getPassCount());
+	return 1;
+}
+
+int w_RenderGraph_reset(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+	luax_catchexcept(L, [&]() { graph->reset(); });
+	return 0;
+}
+
+int w_RenderGraph_execute(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+	luax_catchexcept(L, [&]() { graph->execute(); });
+	return 0;
+}
+
+int w_RenderGraph_isExecuting(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+	luax_pushboolean(L, graph->isExecuting());
+	return 1;
+}
+
+int w_RenderGraph_getExecutionOrder(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+
+	std::vector<std::string> names;
+	luax_catchexcept(L, [&]() { names = graph->getExecutionOrder(); });
+
+	lua_createtable(L, (int) names.size(), 0);
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		luax_pushstring(L, names[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_RenderGraph_getStats(lua_State *L)
+{
+	RenderGraph *graph = luax_checkrendergraph(L, 1);
+
+	RenderGraph::Stats stats;
+	luax_catchexcept(L, [&]() { stats = graph->getStats(); });
+
+	lua_createtable(L, 0, 5);
+
+	lua_pushinteger(L, stats.passes);
+	lua_setfield(L, -2, "passes");
+
+	lua_pushinteger(L, stats.culledPasses);
+	lua_setfield(L, -2, "culledpasses");
+
+	lua_pushinteger(L, stats.mergedPasses);
+	lua_setfield(L, -2, "mergedpasses");
+
+	lua_pushinteger(L, stats.transientCanvases);
+	lua_setfield(L, -2, "transientcanvases");
+
+	lua_pushinteger(L, stats.transientTextures);
+	lua_setfield(L, -2, "transienttextures");
+
+	return 1;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "addTransientCanvas", w_RenderGraph_addTransientCanvas },
+	{ "getCanvas", w_RenderGraph_getCanvas },
+	{ "addPass", w_RenderGraph_addPass },
+	{ "getPassCount", w_RenderGraph_getPassCount },
+	{ "reset", w_RenderGraph_reset },
+	{ "execute", w_RenderGraph_execute },
+	{ "isExecuting", w_RenderGraph_isExecuting },
+	{ "getExecutionOrder", w_RenderGraph_getExecutionOrder },
+	{ "getStats", w_RenderGraph_getStats },
+	{ 0, 0 }
+};
+
+int luaopen_rendergraph(lua_State *L)
+{
+	return luax_register_type(L, &RenderGraph::type, functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -39,9 +39,17 @@ Shader *luax_checkshader(lua_State *L, int idx)
 	return luax_checktype<Shader>(L, idx);
 }
 
+int w_Shader_isReady(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	luax_pushboolean(L, shader->isReady());
+	return 1;
+}
+
 int w_Shader_getWarnings(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 	std::string warnings = shader->getWarnings();
 	lua_pushstring(L, warnings.c_str());
 	return 1;
@@ -322,6 +330,8 @@ static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, co
 	case Shader::UNIFORM_TEXELBUFFER:
 	case Shader::UNIFORM_STORAGEBUFFER:
 		return w_Shader_sendBuffers(L, startidx, shader, info);
+	case Shader::UNIFORM_UNIFORMBUFFER:
+		return luaL_error(L, "Uniform block '%s' is shared by all shaders, use love.graphics.setUniformBuffer instead.", name);
 	default:
 		return luaL_error(L, "Unknown variable type for shader uniform '%s", name);
 	}
@@ -330,7 +340,8 @@ static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, co
 static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, bool colors)
 {
 	if (info->baseType == Shader::UNIFORM_SAMPLER || info->baseType == Shader::UNIFORM_STORAGETEXTURE
-		|| info->baseType == Shader::UNIFORM_TEXELBUFFER || info->baseType == Shader::UNIFORM_STORAGEBUFFER)
+		|| info->baseType == Shader::UNIFORM_TEXELBUFFER || info->baseType == Shader::UNIFORM_STORAGEBUFFER
+		|| info->baseType == Shader::UNIFORM_UNIFORMBUFFER)
 		return luaL_error(L, "Only value types (floats, ints, vectors, matrices, etc) be sent to Shaders via Data objects.");
 
 	math::Transform::MatrixLayout layout = math::Transform::MATRIX_ROW_MAJOR;
@@ -444,6 +455,7 @@ int w_Shader_send(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 
 	const Shader::UniformInfo *info = shader->getUniformInfo(name);
 	if (info == nullptr || !info->active)
@@ -459,6 +471,7 @@ int w_Shader_sendColors(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 
 	const Shader::UniformInfo *info = shader->getUniformInfo(name);
 	if (info == nullptr || !info->active)
@@ -480,6 +493,7 @@ int w_Shader_hasUniform(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 	luax_pushboolean(L, shader->hasUniform(name));
 	return 1;
 }
@@ -499,6 +513,7 @@ int w_Shader_hasStage(lua_State* L)
 int w_Shader_getLocalThreadgroupSize(lua_State* L)
 {
 	Shader *shader = luax_checkshader(L, 1);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 
 	if (!shader->hasStage(SHADERSTAGE_COMPUTE))
 	{
@@ -518,6 +533,7 @@ int w_Shader_getBufferFormat(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 	const std::vector<Buffer::DataDeclaration> *format = shader->getBufferFormat(name);
 	if (format != nullptr)
 	{
@@ -549,6 +565,53 @@ int w_Shader_getBufferFormat(lua_State *L)
 	return luaL_error(L, "Buffer '%s' does not exist in the Shader.", name);
 }
 
+void luax_checkshaderdefines(lua_State *L, int idx, int argidx, std::map<std::string, std::string> &defines)
+{
+	lua_pushnil(L);
+	while (lua_next(L, idx))
+	{
+		std::string defname;
+		std::string defval;
+
+		if (lua_type(L, -2) == LUA_TNUMBER && lua_type(L, -1) == LUA_TSTRING)
+			defname = luaL_checkstring(L, -1);
+		else if (lua_type(L, -2) != LUA_TSTRING)
+			luaL_argerror(L, argidx, "all fields in the 'defines' table must use string keys.");
+		else
+		{
+			defname = luaL_checkstring(L, -2);
+			if (lua_type(L, -1) == LUA_TBOOLEAN)
+				defval = luax_toboolean(L, -1) ? "1" : "0";
+			else
+			{
+				const char *val = lua_tostring(L, -1);
+				if (val == nullptr)
+					luaL_argerror(L, argidx, "'defines' table values must be strings, numbers, or booleans.");
+				defval = val;
+			}
+		}
+
+		defines[defname] = defval;
+
+		lua_pop(L, 1);
+	}
+}
+
+int w_Shader_getVariant(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	std::map<std::string, std::string> defines;
+	luax_checkshaderdefines(L, 2, 2, defines);
+
+	Shader *variant = nullptr;
+	luax_catchexcept(L, [&]() { variant = shader->getVariant(defines); });
+
+	luax_pushtype(L, variant);
+	return 1;
+}
+
 int w_Shader_getDebugName(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
@@ -562,6 +625,7 @@ int w_Shader_getDebugName(lua_State *L)
 
 static const luaL_Reg w_Shader_functions[] =
 {
+	{ "isReady",                 w_Shader_isReady },
 	{ "getWarnings",             w_Shader_getWarnings },
 	{ "send",                    w_Shader_send },
 	{ "sendColor",               w_Shader_sendColors },
@@ -570,6 +634,7 @@ static const luaL_Reg w_Shader_functions[] =
 	{ "getLocalThreadgroupSize", w_Shader_getLocalThreadgroupSize },
 	{ "getBufferFormat",         w_Shader_getBufferFormat },
 	{ "getDebugName",            w_Shader_getDebugName },
+	{ "getVariant",              w_Shader_getVariant },
 	{ 0, 0 }
 };
 
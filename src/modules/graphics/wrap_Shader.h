@@ -30,6 +30,10 @@ namespace graphics
 {
 
 Shader *luax_checkshader(lua_State *L, int idx);
+
+// Reads a table of #define names and values, as used by newShader's options.
+// Errors refer to argument argidx.
+void luax_checkshaderdefines(lua_State *L, int idx, int argidx, std::map<std::string, std::string> &defines);
 extern "C" int luaopen_shader(lua_State *L);
 
 } // graphics
@@ -23,6 +23,11 @@
 #include "Texture.h"
 #include "wrap_Texture.h"
 
+// Put the Lua code directly into a raw string literal.
+static const char spritebatch_lua[] =
+#include "wrap_SpriteBatch.lua"
+;
+
 namespace love
 {
 namespace graphics
@@ -207,6 +212,13 @@ int w_SpriteBatch_getBufferSize(lua_State *L)
 	return 1;
 }
 
+int w_SpriteBatch_isInstanced(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isInstanced());
+	return 1;
+}
+
 int w_SpriteBatch_attachAttribute(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -260,6 +272,47 @@ int w_SpriteBatch_getDrawRange(lua_State *L)
 	return 2;
 }
 
+int w_SpriteBatch_setCullingEnabled(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	t->setCullingEnabled(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_SpriteBatch_isCullingEnabled(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isCullingEnabled());
+	return 1;
+}
+
+// C functions in a struct, necessary for the FFI versions of SpriteBatch methods.
+struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+};
+
+static FFI_SpriteBatch ffifuncs =
+{
+	// Returns the 1-based index of the new sprite, or 0 if the regular function
+	// should be called to raise an error.
+	[](Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> int // add
+	{
+		auto t = luax_ffi_checktype<SpriteBatch>(p);
+		if (t == nullptr)
+			return 0;
+
+		try
+		{
+			return t->add(Matrix4(x, y, a, sx, sy, ox, oy, kx, ky), -1) + 1;
+		}
+		catch (std::exception &)
+		{
+			return 0;
+		}
+	},
+};
+
 static const luaL_Reg w_SpriteBatch_functions[] =
 {
 	{ "add", w_SpriteBatch_add },
@@ -274,15 +327,22 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "getColor", w_SpriteBatch_getColor },
 	{ "getCount", w_SpriteBatch_getCount },
 	{ "getBufferSize", w_SpriteBatch_getBufferSize },
+	{ "isInstanced", w_SpriteBatch_isInstanced },
 	{ "attachAttribute", w_SpriteBatch_attachAttribute },
 	{ "setDrawRange", w_SpriteBatch_setDrawRange },
 	{ "getDrawRange", w_SpriteBatch_getDrawRange },
+	{ "setCullingEnabled", w_SpriteBatch_setCullingEnabled },
+	{ "isCullingEnabled", w_SpriteBatch_isCullingEnabled },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_spritebatch(lua_State *L)
 {
-	return luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+	int n = luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+
+	luax_runwrapper(L, spritebatch_lua, sizeof(spritebatch_lua), "SpriteBatch.lua", SpriteBatch::type, &ffifuncs);
+
+	return n;
 }
 
 } // graphics
@@ -0,0 +1,77 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+local SpriteBatch_mt, ffifuncspointer_str = ...
+local SpriteBatch = SpriteBatch_mt.__index
+
+local type = type
+
+-- Everything below this point is efficient FFI replacements for existing
+-- SpriteBatch functionality.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+} FFI_SpriteBatch;
+]])
+
+local ffifuncs = ffi.cast("FFI_SpriteBatch **", ffifuncspointer_str)[0]
+
+local function isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky)
+	return (x == nil or type(x) == "number") and (y == nil or type(y) == "number")
+		and (a == nil or type(a) == "number") and (sx == nil or type(sx) == "number")
+		and (sy == nil or type(sy) == "number") and (ox == nil or type(ox) == "number")
+		and (oy == nil or type(oy) == "number") and (kx == nil or type(kx) == "number")
+		and (ky == nil or type(ky) == "number")
+end
+
+-- The regular method is used when the FFI version can't handle the arguments
+-- (a Quad or Transform), and to raise errors.
+local _add = SpriteBatch.add
+
+function SpriteBatch:add(x, y, a, sx, sy, ox, oy, kx, ky)
+	if type(self) == "userdata" and type(x) == "number" and isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky) then
+		local dsx = sx or 1
+		local index = ffifuncs.add(self, x, y or 0, a or 0, dsx, sy or dsx, ox or 0, oy or 0, kx or 0, ky or 0)
+		if index > 0 then
+			return index
+		end
+	end
+	return _add(self, x, y, a, sx, sy, ox, oy, kx, ky)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
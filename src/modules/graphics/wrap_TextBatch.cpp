@@ -62,82 +62,95 @@ int w_TextBatch_setf(lua_State *L)
 	return 0;
 }
 
-int w_TextBatch_add(lua_State *L)
+static Matrix4 luax_checktextmatrix(lua_State *L, int idx)
 {
-	TextBatch *t = luax_checktextbatch(L, 1);
+	if (luax_istype(L, idx, math::Transform::type))
+	{
+		math::Transform *tf = luax_totype<math::Transform>(L, idx);
+		return tf->getMatrix();
+	}
 
-	int index = 0;
+	float x  = (float) luaL_optnumber(L, idx + 0, 0.0);
+	float y  = (float) luaL_optnumber(L, idx + 1, 0.0);
+	float a  = (float) luaL_optnumber(L, idx + 2, 0.0);
+	float sx = (float) luaL_optnumber(L, idx + 3, 1.0);
+	float sy = (float) luaL_optnumber(L, idx + 4, sx);
+	float ox = (float) luaL_optnumber(L, idx + 5, 0.0);
+	float oy = (float) luaL_optnumber(L, idx + 6, 0.0);
+	float kx = (float) luaL_optnumber(L, idx + 7, 0.0);
+	float ky = (float) luaL_optnumber(L, idx + 8, 0.0);
+
+	return Matrix4(x, y, a, sx, sy, ox, oy, kx, ky);
+}
 
+static int textbatch_add(lua_State *L, TextBatch *t, int startidx, int index)
+{
 	std::vector<love::font::ColoredString> text;
-	luax_checkcoloredstring(L, 2, text);
+	luax_checkcoloredstring(L, startidx, text);
 
-	if (luax_istype(L, 3, math::Transform::type))
-	{
-		math::Transform *tf = luax_totype<math::Transform>(L, 3);
-		luax_catchexcept(L, [&](){ index = t->add(text, tf->getMatrix()); });
-	}
-	else
-	{
-		float x  = (float) luaL_optnumber(L, 3, 0.0);
-		float y  = (float) luaL_optnumber(L, 4, 0.0);
-		float a  = (float) luaL_optnumber(L, 5, 0.0);
-		float sx = (float) luaL_optnumber(L, 6, 1.0);
-		float sy = (float) luaL_optnumber(L, 7, sx);
-		float ox = (float) luaL_optnumber(L, 8, 0.0);
-		float oy = (float) luaL_optnumber(L, 9, 0.0);
-		float kx = (float) luaL_optnumber(L, 10, 0.0);
-		float ky = (float) luaL_optnumber(L, 11, 0.0);
-
-		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
-		luax_catchexcept(L, [&](){ index = t->add(text, m); });
-	}
+	Matrix4 m = luax_checktextmatrix(L, startidx + 1);
+
+	luax_catchexcept(L, [&](){ index = t->add(text, m, index); });
 
 	lua_pushnumber(L, index + 1);
 	return 1;
 }
 
-int w_TextBatch_addf(lua_State *L)
+static int textbatch_addf(lua_State *L, TextBatch *t, int startidx, int index)
 {
-	TextBatch *t = luax_checktextbatch(L, 1);
-
-	int index = 0;
-
 	std::vector<love::font::ColoredString> text;
-	luax_checkcoloredstring(L, 2, text);
+	luax_checkcoloredstring(L, startidx, text);
 
-	float wrap = (float) luaL_checknumber(L, 3);
+	float wrap = (float) luaL_checknumber(L, startidx + 1);
 
 	Font::AlignMode align = Font::ALIGN_MAX_ENUM;
-	const char *alignstr = luaL_checkstring(L, 4);
+	const char *alignstr = luaL_checkstring(L, startidx + 2);
 
 	if (!Font::getConstant(alignstr, align))
 		return luax_enumerror(L, "align mode", Font::getConstants(align), alignstr);
 
-	if (luax_istype(L, 5, math::Transform::type))
-	{
-		math::Transform *tf = luax_totype<math::Transform>(L, 5);
-		luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, tf->getMatrix()); });
-	}
-	else
-	{
-		float x  = (float) luaL_optnumber(L, 5, 0.0);
-		float y  = (float) luaL_optnumber(L, 6, 0.0);
-		float a  = (float) luaL_optnumber(L, 7, 0.0);
-		float sx = (float) luaL_optnumber(L, 8, 1.0);
-		float sy = (float) luaL_optnumber(L, 9, sx);
-		float ox = (float) luaL_optnumber(L, 10, 0.0);
-		float oy = (float) luaL_optnumber(L, 11, 0.0);
-		float kx = (float) luaL_optnumber(L, 12, 0.0);
-		float ky = (float) luaL_optnumber(L, 13, 0.0);
-
-		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
-		luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, m); });
-	}
+	Matrix4 m = luax_checktextmatrix(L, startidx + 3);
+
+	luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, m, index); });
 
 	lua_pushnumber(L, index + 1);
 	return 1;
 }
 
+int w_TextBatch_add(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	return textbatch_add(L, t, 2, -1);
+}
+
+int w_TextBatch_addf(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	return textbatch_addf(L, t, 2, -1);
+}
+
+int w_TextBatch_replace(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	return textbatch_add(L, t, 3, index);
+}
+
+int w_TextBatch_replacef(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	return textbatch_addf(L, t, 3, index);
+}
+
+int w_TextBatch_remove(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ t->remove(index); });
+	return 0;
+}
+
 int w_TextBatch_clear(lua_State *L)
 {
 	TextBatch *t = luax_checktextbatch(L, 1);
@@ -145,6 +158,21 @@ int w_TextBatch_clear(lua_State *L)
 	return 0;
 }
 
+int w_TextBatch_setMaxEntries(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int max = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ t->setMaxEntries(max); });
+	return 0;
+}
+
+int w_TextBatch_getMaxEntries(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	lua_pushinteger(L, t->getMaxEntries());
+	return 1;
+}
+
 int w_TextBatch_setFont(lua_State *L)
 {
 	TextBatch *t = luax_checktextbatch(L, 1);
@@ -186,18 +214,55 @@ int w_TextBatch_getDimensions(lua_State *L)
 	return 2;
 }
 
+int w_TextBatch_setCullingEnabled(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	t->setCullingEnabled(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_TextBatch_isCullingEnabled(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	luax_pushboolean(L, t->isCullingEnabled());
+	return 1;
+}
+
+int w_TextBatch_setPrewarmEnabled(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	t->setPrewarmEnabled(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_TextBatch_isPrewarmEnabled(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	luax_pushboolean(L, t->isPrewarmEnabled());
+	return 1;
+}
+
 static const luaL_Reg w_TextBatch_functions[] =
 {
 	{ "set", w_TextBatch_set },
 	{ "setf", w_TextBatch_setf },
 	{ "add", w_TextBatch_add },
 	{ "addf", w_TextBatch_addf },
+	{ "replace", w_TextBatch_replace },
+	{ "replacef", w_TextBatch_replacef },
+	{ "remove", w_TextBatch_remove },
 	{ "clear", w_TextBatch_clear },
+	{ "setMaxEntries", w_TextBatch_setMaxEntries },
+	{ "getMaxEntries", w_TextBatch_getMaxEntries },
 	{ "setFont", w_TextBatch_setFont },
 	{ "getFont", w_TextBatch_getFont },
 	{ "getWidth", w_TextBatch_getWidth },
 	{ "getHeight", w_TextBatch_getHeight },
 	{ "getDimensions", w_TextBatch_getDimensions },
+	{ "setCullingEnabled", w_TextBatch_setCullingEnabled },
+	{ "isCullingEnabled", w_TextBatch_isCullingEnabled },
+	{ "setPrewarmEnabled", w_TextBatch_setPrewarmEnabled },
+	{ "isPrewarmEnabled", w_TextBatch_isPrewarmEnabled },
 	{ 0, 0 }
 };
 
@@ -225,6 +225,24 @@ int w_Texture_getMipmapFilter(lua_State *L)
 	return 2;
 }
 
+int w_Texture_setPalette(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	Texture *palette = nullptr;
+	if (!lua_isnoneornil(L, 2))
+		palette = luax_checktexture(L, 2);
+
+	luax_catchexcept(L, [&](){ t->setPalette(palette); });
+	return 0;
+}
+
+int w_Texture_getPalette(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushtype(L, t->getPalette());
+	return 1;
+}
+
 int w_Texture_setWrap(lua_State *L)
 {
 	Texture *t = luax_checktexture(L, 1);
@@ -300,6 +318,34 @@ int w_Texture_isReadable(lua_State *L)
 	return 1;
 }
 
+int w_Texture_isEvictable(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->isEvictable());
+	return 1;
+}
+
+int w_Texture_isTransient(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->isTransient());
+	return 1;
+}
+
+int w_Texture_isStreaming(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->isStreaming());
+	return 1;
+}
+
+int w_Texture_getResidentMipmap(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	lua_pushinteger(L, t->getResidentMipmap() + 1);
+	return 1;
+}
+
 int w_Texture_getViewFormats(lua_State *L)
 {
 	Texture *t = luax_checktexture(L, 1);
@@ -372,23 +418,27 @@ int w_Texture_generateMipmaps(lua_State *L)
 	return 0;
 }
 
-int w_Texture_replacePixels(lua_State *L)
+static love::image::ImageDataBase *luax_checkreplacepixelsargs(lua_State *L, Texture *t, int &slice, int &dstmip, int &x, int &y, bool &reloadmipmaps)
 {
-	Texture *t = luax_checktexture(L, 1);
-
 	love::image::ImageData *id = nullptr;
 	love::image::CompressedImageData *cid = nullptr;
 
 	if (luax_istype(L, 2, love::image::CompressedImageData::type))
 		cid = luax_checktype<love::image::CompressedImageData>(L, 2);
+	else if (luax_istype(L, 2, love::image::ImageDecode::type))
+	{
+		// Waits for the decode to finish if it hasn't already.
+		love::image::ImageDecode *decode = luax_checktype<love::image::ImageDecode>(L, 2);
+		luax_catchexcept(L, [&]() { id = decode->getImageData(); });
+	}
 	else
 		id = luax_checktype<love::image::ImageData>(L, 2);
 
-	int slice = 0;
-	int dstmip = 0;
-	int x = 0;
-	int y = 0;
-	bool reloadmipmaps = t->getMipmapsMode() == Texture::MIPMAPS_AUTO;
+	slice = 0;
+	dstmip = 0;
+	x = 0;
+	y = 0;
+	reloadmipmaps = t->getMipmapsMode() == Texture::MIPMAPS_AUTO;
 
 	if (t->getTextureType() != TEXTURE_2D)
 		slice = (int) luaL_checkinteger(L, 3) - 1;
@@ -412,17 +462,42 @@ int w_Texture_replacePixels(lua_State *L)
 			srcmip = (int) luaL_checkinteger(L, 8) - 1;
 
 		if (srcmip < 0 || srcmip >= cid->getMipmapCount())
-			return luaL_error(L, "Invalid source mipmap level.");
+			luaL_error(L, "Invalid source mipmap level.");
 
-		luax_catchexcept(L, [&](){ t->replacePixels(cid->getSlice(0, srcmip), slice, dstmip, x, y, reloadmipmaps); });
-	}
-	else
-	{
-		luax_catchexcept(L, [&](){ t->replacePixels(id, slice, dstmip, x, y, reloadmipmaps); });
+		return cid->getSlice(0, srcmip);
 	}
+
+	return id;
+}
+
+int w_Texture_replacePixels(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+
+	int slice, dstmip, x, y;
+	bool reloadmipmaps;
+	love::image::ImageDataBase *d = luax_checkreplacepixelsargs(L, t, slice, dstmip, x, y, reloadmipmaps);
+
+	luax_catchexcept(L, [&](){ t->replacePixels(d, slice, dstmip, x, y, reloadmipmaps); });
 	return 0;
 }
 
+int w_Texture_replacePixelsAsync(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+
+	int slice, dstmip, x, y;
+	bool reloadmipmaps;
+	love::image::ImageDataBase *d = luax_checkreplacepixelsargs(L, t, slice, dstmip, x, y, reloadmipmaps);
+
+	TextureUpload *upload = nullptr;
+	luax_catchexcept(L, [&](){ upload = t->replacePixelsAsync(d, slice, dstmip, x, y, reloadmipmaps); });
+
+	luax_pushtype(L, upload);
+	upload->release();
+	return 1;
+}
+
 int w_Texture_newImageData(lua_State *L)
 {
 	luax_markdeprecated(L, 1, "Texture:newImageData", API_METHOD, DEPRECATED_RENAMED, "love.graphics.readbackTexture");
@@ -547,16 +622,23 @@ const luaL_Reg w_Texture_functions[] =
 	{ "getMipmapFilter", w_Texture_getMipmapFilter },
 	{ "setWrap", w_Texture_setWrap },
 	{ "getWrap", w_Texture_getWrap },
+	{ "setPalette", w_Texture_setPalette },
+	{ "getPalette", w_Texture_getPalette },
 	{ "getFormat", w_Texture_getFormat },
 	{ "isCanvas", w_Texture_isCanvas },
 	{ "isComputeWritable", w_Texture_isComputeWritable },
 	{ "isReadable", w_Texture_isReadable },
+	{ "isEvictable", w_Texture_isEvictable },
+	{ "isStreaming", w_Texture_isStreaming },
+	{ "isTransient", w_Texture_isTransient },
+	{ "getResidentMipmap", w_Texture_getResidentMipmap },
 	{ "getViewFormats", w_Texture_getViewFormats },
 	{ "getMipmapMode", w_Texture_getMipmapMode },
 	{ "getDepthSampleMode", w_Texture_getDepthSampleMode },
 	{ "setDepthSampleMode", w_Texture_setDepthSampleMode },
 	{ "generateMipmaps", w_Texture_generateMipmaps },
 	{ "replacePixels", w_Texture_replacePixels },
+	{ "replacePixelsAsync", w_Texture_replacePixelsAsync },
 	{ "renderTo", w_Texture_renderTo },
 	{ "getDebugName", w_Texture_getDebugName },
 
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_TextureUpload.h"
+#include "Texture.h"
+
+namespace love
+{
+namespace graphics
+{
+
+TextureUpload *luax_checktextureupload(lua_State *L, int idx)
+{
+	return luax_checktype<TextureUpload>(L, idx);
+}
+
+int w_TextureUpload_isComplete(lua_State *L)
+{
+	TextureUpload *t = luax_checktextureupload(L, 1);
+	luax_pushboolean(L, t->isComplete());
+	return 1;
+}
+
+int w_TextureUpload_wait(lua_State *L)
+{
+	TextureUpload *t = luax_checktextureupload(L, 1);
+	t->wait();
+	return 0;
+}
+
+int w_TextureUpload_update(lua_State *L)
+{
+	TextureUpload *t = luax_checktextureupload(L, 1);
+	luax_catchexcept(L, [&]() { t->update(); });
+	return 0;
+}
+
+int w_TextureUpload_getTexture(lua_State *L)
+{
+	TextureUpload *t = luax_checktextureupload(L, 1);
+	luax_pushtype(L, t->getTexture());
+	return 1;
+}
+
+static const luaL_Reg w_TextureUpload_functions[] =
+{
+	{ "isComplete", w_TextureUpload_isComplete },
+	{ "wait", w_TextureUpload_wait },
+	{ "update", w_TextureUpload_update },
+	{ "getTexture", w_TextureUpload_getTexture },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_textureupload(lua_State *L)
+{
+	return luax_register_type(L, &TextureUpload::type, w_TextureUpload_functions, nullptr);
+}
+
+} // graphics
+} // love
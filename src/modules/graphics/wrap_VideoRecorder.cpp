@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_VideoRecorder.h"
+#include "wrap_Texture.h"
+
+namespace love
+{
+namespace graphics
+{
+
+VideoRecorder *luax_checkvideorecorder(lua_State *L, int idx)
+{
+	return luax_checktype<VideoRecorder>(L, idx);
+}
+
+int w_VideoRecorder_captureFrame(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+		luax_catchexcept(L, [&]() { r->captureBackbufferFrame(); });
+	else
+	{
+		Texture *t = luax_checktexture(L, 2);
+		luax_catchexcept(L, [&]() { r->captureFrame(t); });
+	}
+
+	return 0;
+}
+
+int w_VideoRecorder_update(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	luax_catchexcept(L, [&]() { r->update(); });
+	return 0;
+}
+
+int w_VideoRecorder_stop(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	luax_catchexcept(L, [&]() { r->stop(); });
+	return 0;
+}
+
+int w_VideoRecorder_isRecording(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	luax_pushboolean(L, r->isRecording());
+	return 1;
+}
+
+int w_VideoRecorder_isGPUConversionUsed(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	luax_pushboolean(L, r->isGPUConversionUsed());
+	return 1;
+}
+
+int w_VideoRecorder_getDimensions(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushinteger(L, r->getWidth());
+	lua_pushinteger(L, r->getHeight());
+	return 2;
+}
+
+int w_VideoRecorder_getCapturedFrameCount(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushinteger(L, (lua_Integer) r->getCapturedFrameCount());
+	return 1;
+}
+
+int w_VideoRecorder_getDroppedFrameCount(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushinteger(L, (lua_Integer) r->getDroppedFrameCount());
+	return 1;
+}
+
+int w_VideoRecorder_getWrittenFrameCount(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushinteger(L, (lua_Integer) r->getWrittenFrameCount());
+	return 1;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "captureFrame", w_VideoRecorder_captureFrame },
+	{ "update", w_VideoRecorder_update },
+	{ "stop", w_VideoRecorder_stop },
+	{ "isRecording", w_VideoRecorder_isRecording },
+	{ "isGPUConversionUsed", w_VideoRecorder_isGPUConversionUsed },
+	{ "getDimensions", w_VideoRecorder_getDimensions },
+	{ "getCapturedFrameCount", w_VideoRecorder_getCapturedFrameCount },
+	{ "getDroppedFrameCount", w_VideoRecorder_getDroppedFrameCount },
+	{ "getWrittenFrameCount", w_VideoRecorder_getWrittenFrameCount },
+	{ 0, 0 }
+};
+
+int luaopen_videorecorder(lua_State *L)
+{
+	return luax_register_type(L, &VideoRecorder::type, functions, nullptr);
+}
+
+} // graphics
+} // love
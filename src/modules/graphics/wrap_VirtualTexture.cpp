@@ -0,0 +1,247 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_VirtualTexture.h"
+#include "wrap_Texture.h"
+
+namespace love
+{
+namespace graphics
+{
+
+VirtualTexture *luax_checkvirtualtexture(lua_State *L, int idx)
+{
+	return luax_checktype<VirtualTexture>(L, idx);
+}
+
+static VirtualTexture::Page luax_checkpage(lua_State *L, int idx)
+{
+	VirtualTexture::Page page;
+	page.mipmap = (int) luaL_checkinteger(L, idx + 0) - 1;
+	page.x = (int) luaL_checkinteger(L, idx + 1);
+	page.y = (int) luaL_checkinteger(L, idx + 2);
+	return page;
+}
+
+int w_VirtualTexture_setPage(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	VirtualTexture::Page page = luax_checkpage(L, 2);
+	love::image::ImageData *data = luax_checktype<love::image::ImageData>(L, 5);
+
+	int slot = 0;
+	luax_catchexcept(L, [&]() { slot = vt->setPage(page, data); });
+
+	lua_pushinteger(L, slot + 1);
+	return 1;
+}
+
+int w_VirtualTexture_hasPage(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	VirtualTexture::Page page = luax_checkpage(L, 2);
+
+	bool resident = false;
+	luax_catchexcept(L, [&]() { resident = vt->hasPage(page); });
+
+	lua_pushboolean(L, resident);
+	return 1;
+}
+
+int w_VirtualTexture_evictPage(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	VirtualTexture::Page page = luax_checkpage(L, 2);
+
+	bool evicted = false;
+	luax_catchexcept(L, [&]() { evicted = vt->evictPage(page); });
+
+	lua_pushboolean(L, evicted);
+	return 1;
+}
+
+int w_VirtualTexture_clearPages(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	vt->clearPages();
+	return 0;
+}
+
+int w_VirtualTexture_getPageRequests(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+
+	std::vector<VirtualTexture::Page> requests;
+	vt->getPageRequests(requests);
+
+	lua_createtable(L, (int) requests.size(), 0);
+
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		const VirtualTexture::Page &page = requests[i];
+
+		lua_createtable(L, 3, 0);
+
+		lua_pushinteger(L, page.mipmap + 1);
+		lua_rawseti(L, -2, 1);
+		lua_pushinteger(L, page.x);
+		lua_rawseti(L, -2, 2);
+		lua_pushinteger(L, page.y);
+		lua_rawseti(L, -2, 3);
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_VirtualTexture_getPageCount(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	int mipmap = (int) luaL_optinteger(L, 2, 1) - 1;
+
+	if (mipmap < 0 || mipmap >= vt->getMipmapCount())
+		return luaL_error(L, "Invalid mipmap level: %d (VirtualTexture has %d mipmap levels)", mipmap + 1, vt->getMipmapCount());
+
+	lua_pushinteger(L, vt->getPageCountX(mipmap));
+	lua_pushinteger(L, vt->getPageCountY(mipmap));
+	return 2;
+}
+
+int w_VirtualTexture_getPageSize(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getPageSize());
+	return 1;
+}
+
+int w_VirtualTexture_getCacheSize(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getCacheSize());
+	return 1;
+}
+
+int w_VirtualTexture_getResidentPageCount(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getResidentPageCount());
+	return 1;
+}
+
+int w_VirtualTexture_getMipmapCount(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getMipmapCount());
+	return 1;
+}
+
+int w_VirtualTexture_getWidth(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getWidth());
+	return 1;
+}
+
+int w_VirtualTexture_getHeight(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getHeight());
+	return 1;
+}
+
+int w_VirtualTexture_getDimensions(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, vt->getWidth());
+	lua_pushinteger(L, vt->getHeight());
+	return 2;
+}
+
+int w_VirtualTexture_getCacheTexture(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	luax_pushtype(L, vt->getCacheTexture());
+	return 1;
+}
+
+int w_VirtualTexture_setFilter(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	SamplerState s = vt->getSamplerState();
+
+	const char *minstr = luaL_checkstring(L, 2);
+	const char *magstr = luaL_optstring(L, 3, minstr);
+
+	if (!SamplerState::getConstant(minstr, s.minFilter))
+		return luax_enumerror(L, "filter mode", SamplerState::getConstants(s.minFilter), minstr);
+	if (!SamplerState::getConstant(magstr, s.magFilter))
+		return luax_enumerror(L, "filter mode", SamplerState::getConstants(s.magFilter), magstr);
+
+	luax_catchexcept(L, [&](){ vt->setSamplerState(s); });
+	return 0;
+}
+
+int w_VirtualTexture_getFilter(lua_State *L)
+{
+	VirtualTexture *vt = luax_checkvirtualtexture(L, 1);
+	const SamplerState &s = vt->getSamplerState();
+
+	const char *minstr = nullptr;
+	const char *magstr = nullptr;
+
+	if (!SamplerState::getConstant(s.minFilter, minstr))
+		return luaL_error(L, "Unknown filter mode.");
+	if (!SamplerState::getConstant(s.magFilter, magstr))
+		return luaL_error(L, "Unknown filter mode.");
+
+	lua_pushstring(L, minstr);
+	lua_pushstring(L, magstr);
+	return 2;
+}
+
+static const luaL_Reg functions[] =
+{
+	{ "setPage", w_VirtualTexture_setPage },
+	{ "hasPage", w_VirtualTexture_hasPage },
+	{ "evictPage", w_VirtualTexture_evictPage },
+	{ "clearPages", w_VirtualTexture_clearPages },
+	{ "getPageRequests", w_VirtualTexture_getPageRequests },
+	{ "getPageCount", w_VirtualTexture_getPageCount },
+	{ "getPageSize", w_VirtualTexture_getPageSize },
+	{ "getCacheSize", w_VirtualTexture_getCacheSize },
+	{ "getResidentPageCount", w_VirtualTexture_getResidentPageCount },
+	{ "getMipmapCount", w_VirtualTexture_getMipmapCount },
+	{ "getWidth", w_VirtualTexture_getWidth },
+	{ "getHeight", w_VirtualTexture_getHeight },
+	{ "getDimensions", w_VirtualTexture_getDimensions },
+	{ "getCacheTexture", w_VirtualTexture_getCacheTexture },
+	{ "setFilter", w_VirtualTexture_setFilter },
+	{ "getFilter", w_VirtualTexture_getFilter },
+	{ 0, 0 }
+};
+
+int luaopen_virtualtexture(lua_State *L)
+{
+	return luax_register_type(L, &VirtualTexture::type, functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,549 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "BlockCompression.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace love
+{
+namespace image
+{
+
+// Block encoders are simple and fast rather than exhaustive, since they're
+// meant for content generated at runtime.
+
+static inline int clamp255(int v)
+{
+	return std::min(std::max(v, 0), 255);
+}
+
+static inline int colorDistance(const int *a, const int *b)
+{
+	int dr = a[0] - b[0];
+	int dg = a[1] - b[1];
+	int db = a[2] - b[2];
+	return dr * dr + dg * dg + db * db;
+}
+
+static inline uint16 packRGB565(const float *c)
+{
+	int r = clamp255((int) (c[0] + 0.5f));
+	int g = clamp255((int) (c[1] + 0.5f));
+	int b = clamp255((int) (c[2] + 0.5f));
+	return (uint16) ((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static inline void unpackRGB565(uint16 c, int *rgb)
+{
+	int r = (c >> 11) & 0x1F;
+	int g = (c >> 5) & 0x3F;
+	int b = c & 0x1F;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+struct BC1Block
+{
+	uint16 color0;
+	uint16 color1;
+	uint32 indices;
+	int error;
+};
+
+// Picks the nearest palette entry for each pixel, given the two endpoints.
+static BC1Block fitBC1Indices(uint16 c0, uint16 c1, const uint8 *rgba, const bool *transparent, bool threecolor)
+{
+	if (threecolor ? c0 > c1 : c0 < c1)
+		std::swap(c0, c1);
+
+	int palette[4][3];
+	unpackRGB565(c0, palette[0]);
+	unpackRGB565(c1, palette[1]);
+
+	int colorcount = 4;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (threecolor)
+		{
+			palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+			palette[3][i] = 0;
+			colorcount = 3;
+		}
+		else
+		{
+			palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+			palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+		}
+	}
+
+	BC1Block block = {c0, c1, 0, 0};
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (transparent[i])
+		{
+			block.indices |= 3u << (i * 2);
+			continue;
+		}
+
+		int pixel[3] = {rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2]};
+
+		int best = 0;
+		int besterror = colorDistance(pixel, palette[0]);
+
+		for (int j = 1; j < colorcount; j++)
+		{
+			int error = colorDistance(pixel, palette[j]);
+			if (error < besterror)
+			{
+				best = j;
+				besterror = error;
+			}
+		}
+
+		block.indices |= (uint32) best << (i * 2);
+		block.error += besterror;
+	}
+
+	return block;
+}
+
+// Least-squares fit of the two endpoints to the pixels, given their indices.
+static bool refineBC1Endpoints(const BC1Block &block, const uint8 *rgba, const bool *transparent, bool threecolor, uint16 &c0, uint16 &c1)
+{
+	static const float weights4[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+	static const float weights3[4] = {1.0f, 0.0f, 0.5f, 0.0f};
+	const float *weights = threecolor ? weights3 : weights4;
+
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[3] = {0.0f, 0.0f, 0.0f};
+	float bx[3] = {0.0f, 0.0f, 0.0f};
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (transparent[i])
+			continue;
+
+		float w = weights[(block.indices >> (i * 2)) & 3];
+		float iw = 1.0f - w;
+
+		aa += w * w;
+		ab += w * iw;
+		bb += iw * iw;
+
+		for (int c = 0; c < 3; c++)
+		{
+			ax[c] += w * rgba[i * 4 + c];
+			bx[c] += iw * rgba[i * 4 + c];
+		}
+	}
+
+	float det = aa * bb - ab * ab;
+	if (fabsf(det) < 1e-6f)
+		return false;
+
+	float e0[3];
+	float e1[3];
+	for (int c = 0; c < 3; c++)
+	{
+		e0[c] = (bb * ax[c] - ab * bx[c]) / det;
+		e1[c] = (aa * bx[c] - ab * ax[c]) / det;
+	}
+
+	c0 = packRGB565(e0);
+	c1 = packRGB565(e1);
+	return true;
+}
+
+static void compressBC1Color(const uint8 *rgba, uint8 *dst, bool allowtransparency)
+{
+	bool transparent[16];
+	bool threecolor = false;
+	int colorcount = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		transparent[i] = allowtransparency && rgba[i * 4 + 3] < 128;
+		if (transparent[i])
+			threecolor = true;
+		else
+			colorcount++;
+	}
+
+	BC1Block block = {0, 0, 0xFFFFFFFF, 0};
+
+	if (colorcount > 0)
+	{
+		// Use the principal axis of the colors to find the endpoints.
+		float mean[3] = {0.0f, 0.0f, 0.0f};
+		for (int i = 0; i < 16; i++)
+		{
+			if (transparent[i])
+				continue;
+			for (int c = 0; c < 3; c++)
+				mean[c] += rgba[i * 4 + c];
+		}
+
+		for (int c = 0; c < 3; c++)
+			mean[c] /= colorcount;
+
+		float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+		for (int i = 0; i < 16; i++)
+		{
+			if (transparent[i])
+				continue;
+
+			float r = rgba[i * 4 + 0] - mean[0];
+			float g = rgba[i * 4 + 1] - mean[1];
+			float b = rgba[i * 4 + 2] - mean[2];
+
+			cov[0] += r * r;
+			cov[1] += r * g;
+			cov[2] += r * b;
+			cov[3] += g * g;
+			cov[4] += g * b;
+			cov[5] += b * b;
+		}
+
+		float axis[3] = {1.0f, 1.0f, 1.0f};
+		for (int iteration = 0; iteration < 4; iteration++)
+		{
+			float x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+			float y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+			float z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+
+			float len = std::max(std::max(fabsf(x), fabsf(y)), fabsf(z));
+			if (len < 1e-6f)
+				break;
+
+			axis[0] = x / len;
+			axis[1] = y / len;
+			axis[2] = z / len;
+		}
+
+		int mini = -1, maxi = -1;
+		float mindot = 0.0f, maxdot = 0.0f;
+
+		for (int i = 0; i < 16; i++)
+		{
+			if (transparent[i])
+				continue;
+
+			float dot = rgba[i * 4 + 0] * axis[0] + rgba[i * 4 + 1] * axis[1] + rgba[i * 4 + 2] * axis[2];
+			if (mini < 0 || dot < mindot)
+			{
+				mini = i;
+				mindot = dot;
+			}
+			if (maxi < 0 || dot > maxdot)
+			{
+				maxi = i;
+				maxdot = dot;
+			}
+		}
+
+		float e0[3] = {(float) rgba[maxi * 4 + 0], (float) rgba[maxi * 4 + 1], (float) rgba[maxi * 4 + 2]};
+		float e1[3] = {(float) rgba[mini * 4 + 0], (float) rgba[mini * 4 + 1], (float) rgba[mini * 4 + 2]};
+
+		block = fitBC1Indices(packRGB565(e0), packRGB565(e1), rgba, transparent, threecolor);
+
+		uint16 c0, c1;
+		if (block.error > 0 && refineBC1Endpoints(block, rgba, transparent, threecolor, c0, c1))
+		{
+			BC1Block refined = fitBC1Indices(c0, c1, rgba, transparent, threecolor);
+			if (refined.error < block.error)
+				block = refined;
+		}
+
+		// With equal endpoints a 4 color block would be decoded as a 3 color
+		// block, which doesn't matter since every index is 0 or the endpoint.
+	}
+
+	dst[0] = (uint8) (block.color0 & 0xFF);
+	dst[1] = (uint8) (block.color0 >> 8);
+	dst[2] = (uint8) (block.color1 & 0xFF);
+	dst[3] = (uint8) (block.color1 >> 8);
+	dst[4] = (uint8) ((block.indices >> 0) & 0xFF);
+	dst[5] = (uint8) ((block.indices >> 8) & 0xFF);
+	dst[6] = (uint8) ((block.indices >> 16) & 0xFF);
+	dst[7] = (uint8) ((block.indices >> 24) & 0xFF);
+}
+
+// Encodes one channel (every 4th byte starting at src) as a BC4 block, which
+// is also used for the alpha of BC3 blocks.
+static void compressBC4Channel(const uint8 *src, uint8 *dst)
+{
+	int minv = 255, maxv = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		minv = std::min(minv, (int) src[i * 4]);
+		maxv = std::max(maxv, (int) src[i * 4]);
+	}
+
+	uint64 indices = 0;
+
+	if (maxv > minv)
+	{
+		int palette[8];
+		palette[0] = maxv;
+		palette[1] = minv;
+		for (int i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * maxv + i * minv + 3) / 7;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int v = src[i * 4];
+			int best = 0;
+			int besterror = abs(v - palette[0]);
+
+			for (int j = 1; j < 8; j++)
+			{
+				int error = abs(v - palette[j]);
+				if (error < besterror)
+				{
+					best = j;
+					besterror = error;
+				}
+			}
+
+			indices |= (uint64) best << (i * 3);
+		}
+	}
+
+	dst[0] = (uint8) maxv;
+	dst[1] = (uint8) minv;
+	for (int i = 0; i < 6; i++)
+		dst[i + 2] = (uint8) ((indices >> (i * 8)) & 0xFF);
+}
+
+static const int etc1Modifiers[8][2] =
+{
+	{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183},
+};
+
+struct ETC1Subblock
+{
+	int table;
+	int error;
+	int pixelIndices[8];
+};
+
+// Picks the best modifier table and per-pixel modifiers for a subblock.
+static ETC1Subblock fitETC1Subblock(const int *base, const uint8 *const *pixels)
+{
+	ETC1Subblock best = {0, -1, {}};
+
+	for (int t = 0; t < 8; t++)
+	{
+		const int modifiers[4] = {etc1Modifiers[t][0], etc1Modifiers[t][1], -etc1Modifiers[t][0], -etc1Modifiers[t][1]};
+
+		ETC1Subblock sub = {t, 0, {}};
+
+		for (int i = 0; i < 8; i++)
+		{
+			int pixel[3] = {pixels[i][0], pixels[i][1], pixels[i][2]};
+			int besterror = -1;
+
+			for (int m = 0; m < 4; m++)
+			{
+				int c[3] = {clamp255(base[0] + modifiers[m]), clamp255(base[1] + modifiers[m]), clamp255(base[2] + modifiers[m])};
+				int error = colorDistance(pixel, c);
+				if (besterror < 0 || error < besterror)
+				{
+					besterror = error;
+					sub.pixelIndices[i] = m;
+				}
+			}
+
+			sub.error += besterror;
+		}
+
+		if (best.error < 0 || sub.error < best.error)
+			best = sub;
+	}
+
+	return best;
+}
+
+static void compressETC1(const uint8 *rgba, uint8 *dst)
+{
+	uint64 bestblock = 0;
+	int besterror = -1;
+
+	for (int flip = 0; flip < 2; flip++)
+	{
+		// Pixels and their block-relative (x * 4 + y) positions per subblock.
+		const uint8 *pixels[2][8];
+		int positions[2][8];
+		int counts[2] = {0, 0};
+
+		for (int y = 0; y < 4; y++)
+		{
+			for (int x = 0; x < 4; x++)
+			{
+				int sub = flip ? (y >= 2) : (x >= 2);
+				pixels[sub][counts[sub]] = rgba + (y * 4 + x) * 4;
+				positions[sub][counts[sub]] = x * 4 + y;
+				counts[sub]++;
+			}
+		}
+
+		float average[2][3];
+		for (int sub = 0; sub < 2; sub++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				int sum = 0;
+				for (int i = 0; i < 8; i++)
+					sum += pixels[sub][i][c];
+				average[sub][c] = sum / 8.0f;
+			}
+		}
+
+		// Prefer differential mode (5 bit colors) when the averages are close
+		// enough, and fall back to individual mode (4 bit colors).
+		int q5[2][3];
+		bool differential = true;
+		for (int c = 0; c < 3; c++)
+		{
+			q5[0][c] = (int) (average[0][c] * 31.0f / 255.0f + 0.5f);
+			q5[1][c] = (int) (average[1][c] * 31.0f / 255.0f + 0.5f);
+			int d = q5[1][c] - q5[0][c];
+			if (d < -4 || d > 3)
+				differential = false;
+		}
+
+		uint64 block = 0;
+		int base[2][3];
+
+		if (differential)
+		{
+			for (int sub = 0; sub < 2; sub++)
+			{
+				for (int c = 0; c < 3; c++)
+					base[sub][c] = (q5[sub][c] << 3) | (q5[sub][c] >> 2);
+			}
+
+			block |= (uint64) q5[0][0] << 59 | (uint64) ((q5[1][0] - q5[0][0]) & 7) << 56;
+			block |= (uint64) q5[0][1] << 51 | (uint64) ((q5[1][1] - q5[0][1]) & 7) << 48;
+			block |= (uint64) q5[0][2] << 43 | (uint64) ((q5[1][2] - q5[0][2]) & 7) << 40;
+			block |= 1ull << 33;
+		}
+		else
+		{
+			int q4[2][3];
+			for (int sub = 0; sub < 2; sub++)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					q4[sub][c] = (int) (average[sub][c] * 15.0f / 255.0f + 0.5f);
+					base[sub][c] = (q4[sub][c] << 4) | q4[sub][c];
+				}
+			}
+
+			block |= (uint64) q4[0][0] << 60 | (uint64) q4[1][0] << 56;
+			block |= (uint64) q4[0][1] << 52 | (uint64) q4[1][1] << 48;
+			block |= (uint64) q4[0][2] << 44 | (uint64) q4[1][2] << 40;
+		}
+
+		block |= (uint64) flip << 32;
+
+		int error = 0;
+
+		for (int sub = 0; sub < 2; sub++)
+		{
+			ETC1Subblock fit = fitETC1Subblock(base[sub], pixels[sub]);
+			error += fit.error;
+
+			block |= (uint64) fit.table << (sub == 0 ? 37 : 34);
+
+			for (int i = 0; i < 8; i++)
+			{
+				int index = fit.pixelIndices[i];
+				int pos = positions[sub][i];
+				block |= (uint64) (index >> 1) << (16 + pos);
+				block |= (uint64) (index & 1) << pos;
+			}
+		}
+
+		if (besterror < 0 || error < besterror)
+		{
+			besterror = error;
+			bestblock = block;
+		}
+	}
+
+	// ETC blocks are stored big-endian.
+	for (int i = 0; i < 8; i++)
+		dst[i] = (uint8) ((bestblock >> (56 - i * 8)) & 0xFF);
+}
+
+bool isBlockCompressionSupported(PixelFormat format)
+{
+	switch (getLinearPixelFormat(format))
+	{
+	case PIXELFORMAT_DXT1_UNORM:
+	case PIXELFORMAT_DXT5_UNORM:
+	case PIXELFORMAT_BC4_UNORM:
+	case PIXELFORMAT_BC5_UNORM:
+	case PIXELFORMAT_ETC1_UNORM:
+	case PIXELFORMAT_ETC2_RGB_UNORM:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void compressBlock(PixelFormat format, const uint8 *rgba, uint8 *dst)
+{
+	switch (getLinearPixelFormat(format))
+	{
+	case PIXELFORMAT_DXT1_UNORM:
+		compressBC1Color(rgba, dst, true);
+		break;
+	case PIXELFORMAT_DXT5_UNORM:
+		compressBC4Channel(rgba + 3, dst);
+		compressBC1Color(rgba, dst + 8, false);
+		break;
+	case PIXELFORMAT_BC4_UNORM:
+		compressBC4Channel(rgba, dst);
+		break;
+	case PIXELFORMAT_BC5_UNORM:
+		compressBC4Channel(rgba + 0, dst);
+		compressBC4Channel(rgba + 1, dst + 8);
+		break;
+	case PIXELFORMAT_ETC1_UNORM:
+	case PIXELFORMAT_ETC2_RGB_UNORM:
+		// ETC1 blocks are valid ETC2 RGB blocks.
+		compressETC1(rgba, dst);
+		break;
+	default:
+		break;
+	}
+}
+
+} // image
+} // love
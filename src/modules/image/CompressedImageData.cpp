@@ -21,6 +21,9 @@
 #include "CompressedImageData.h"
 #include "common/Exception.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace image
@@ -30,6 +33,8 @@ love::Type CompressedImageData::type("CompressedImageData", &Data::type);
 
 CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &formats, Data *filedata)
 	: format(PIXELFORMAT_UNKNOWN)
+	, dataImagesBegin(0)
+	, dataImagesEnd(0)
 {
 	FormatHandler *parser = nullptr;
 
@@ -59,10 +64,27 @@ CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &forma
 	// This throws away some information the decoder could give us, but we
 	// can't really rely on it I think...
 	format = getLinearPixelFormat(format);
+
+	computeDataRange();
+}
+
+CompressedImageData::CompressedImageData(PixelFormat format, Data *memory, const std::vector<StrongRef<CompressedSlice>> &slices)
+	: format(getLinearPixelFormat(format))
+	, memory(memory)
+	, dataImages(slices)
+	, dataImagesBegin(0)
+	, dataImagesEnd(0)
+{
+	if (dataImages.size() == 0 || memory->getSize() == 0)
+		throw love::Exception("Could not create compressed data: No valid data?");
+
+	computeDataRange();
 }
 
 CompressedImageData::CompressedImageData(const CompressedImageData &c)
 	: format(c.format)
+	, dataImagesBegin(0)
+	, dataImagesEnd(0)
 {
 	memory.set(c.memory->clone(), Acquire::NORETAIN);
 
@@ -72,6 +94,8 @@ CompressedImageData::CompressedImageData(const CompressedImageData &c)
 		dataImages.push_back(slice);
 		slice->release();
 	}
+
+	computeDataRange();
 }
 
 CompressedImageData *CompressedImageData::clone() const
@@ -85,12 +109,12 @@ CompressedImageData::~CompressedImageData()
 
 size_t CompressedImageData::getSize() const
 {
-	return memory->getSize();
+	return dataImagesEnd - dataImagesBegin;
 }
 
 void *CompressedImageData::getData() const
 {
-	return memory->getData();
+	return (uint8 *) memory->getData() + dataImagesBegin;
 }
 
 int CompressedImageData::getMipmapCount() const
@@ -154,6 +178,23 @@ CompressedSlice *CompressedImageData::getSlice(int slice, int miplevel) const
 	return dataImages[miplevel].get();
 }
 
+void CompressedImageData::computeDataRange()
+{
+	// The memory block may be the whole source file, so only the range that
+	// the sub-images cover is exposed as this Data's contents.
+	dataImagesBegin = memory->getSize();
+	dataImagesEnd = 0;
+
+	for (const auto &slice : dataImages)
+	{
+		dataImagesBegin = std::min(dataImagesBegin, slice->getOffset());
+		dataImagesEnd = std::max(dataImagesEnd, slice->getOffset() + slice->getSize());
+	}
+
+	if (dataImagesBegin > dataImagesEnd)
+		dataImagesBegin = dataImagesEnd = 0;
+}
+
 void CompressedImageData::checkSliceExists(int slice, int miplevel) const
 {
 	if (slice != 0)
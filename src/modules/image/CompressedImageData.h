@@ -49,6 +49,7 @@ public:
 	static love::Type type;
 
 	CompressedImageData(const std::list<FormatHandler *> &formats, Data *filedata);
+	CompressedImageData(PixelFormat format, Data *memory, const std::vector<StrongRef<CompressedSlice>> &slices);
 	CompressedImageData(const CompressedImageData &c);
 	virtual ~CompressedImageData();
 
@@ -102,12 +103,18 @@ protected:
 
 	PixelFormat format;
 
-	// Single block of memory containing all of the sub-images.
-	StrongRef<ByteData> memory;
+	// Single block of memory containing all of the sub-images. This can be the
+	// source file's data itself when its sub-images are used in place.
+	StrongRef<Data> memory;
 
 	// Texture info for each mipmap level.
 	std::vector<StrongRef<CompressedSlice>> dataImages;
 
+	// Range of the memory block covered by the sub-images.
+	size_t dataImagesBegin;
+	size_t dataImagesEnd;
+
+	void computeDataRange();
 	void checkSliceExists(int slice, int miplevel) const;
 
 }; // CompressedImageData
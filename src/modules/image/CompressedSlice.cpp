@@ -26,7 +26,7 @@ namespace love
 namespace image
 {
 
-CompressedSlice::CompressedSlice(PixelFormat format, int width, int height, ByteData *memory, size_t offset, size_t size)
+CompressedSlice::CompressedSlice(PixelFormat format, int width, int height, Data *memory, size_t offset, size_t size)
 	: ImageDataBase(format, width, height)
 	, memory(memory)
 	, offset(offset)
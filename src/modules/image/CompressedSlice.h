@@ -21,6 +21,7 @@
 #pragma once
 
 // LOVE
+#include "common/Data.h"
 #include "common/int.h"
 #include "common/pixelformat.h"
 #include "data/ByteData.h"
@@ -39,7 +40,7 @@ class CompressedSlice : public ImageDataBase
 {
 public:
 
-	CompressedSlice(PixelFormat format, int width, int height, ByteData *memory, size_t offset, size_t size);
+	CompressedSlice(PixelFormat format, int width, int height, Data *memory, size_t offset, size_t size);
 	CompressedSlice(const CompressedSlice &slice);
 	virtual ~CompressedSlice();
 
@@ -50,7 +51,7 @@ public:
 
 private:
 
-	StrongRef<ByteData> memory;
+	StrongRef<Data> memory;
 	size_t offset;
 	size_t dataSize;
 
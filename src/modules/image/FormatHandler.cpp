@@ -50,17 +50,33 @@ FormatHandler::DecodedImage FormatHandler::decode(Data* /*data*/)
 	throw love::Exception("Image decoding is not implemented for this format backend.");
 }
 
+FormatHandler::DecodedImage FormatHandler::decodeCompact(Data *data)
+{
+	return decode(data);
+}
+
 FormatHandler::EncodedImage FormatHandler::encode(const DecodedImage& /*img*/, EncodedFormat /*format*/)
 {
 	throw love::Exception("Image encoding is not implemented for this format backend.");
 }
 
+void FormatHandler::encodeStream(const DecodedImage &img, EncodedFormat format, Stream *stream)
+{
+	EncodedImage encoded = encode(img, format);
+
+	bool success = encoded.data != nullptr && stream->write(encoded.data, (int64) encoded.size);
+	freeEncodedImage(encoded.data);
+
+	if (!success)
+		throw love::Exception("Could not write encoded image data.");
+}
+
 bool FormatHandler::canParseCompressed(Data* /*data*/)
 {
 	return false;
 }
 
-StrongRef<ByteData> FormatHandler::parseCompressed(Data* /*filedata*/, std::vector<StrongRef<CompressedSlice>>& /*images*/, PixelFormat& /*format*/)
+StrongRef<Data> FormatHandler::parseCompressed(Data* /*filedata*/, std::vector<StrongRef<CompressedSlice>>& /*images*/, PixelFormat& /*format*/)
 {
 	throw love::Exception("Compressed image parsing is not implemented for this format backend.");
 }
@@ -23,7 +23,9 @@
 // LOVE
 #include "common/Object.h"
 #include "common/Data.h"
+#include "common/Stream.h"
 #include "common/pixelformat.h"
+#include "common/Color.h"
 #include "CompressedSlice.h"
 
 #include <vector>
@@ -57,6 +59,10 @@ public:
 		int height  = 0;
 		size_t size = 0;
 		unsigned char *data = nullptr;
+
+		// Colors of an indexed image decoded by decodeCompact, whose pixels are
+		// the indices into this list.
+		std::vector<Color32> palette;
 	};
 
 	// Pixel data encoded in a particular format.
@@ -87,11 +93,26 @@ public:
 	 **/
 	virtual DecodedImage decode(Data *data);
 
+	/**
+	 * Decodes an image into raw pixel data, keeping grayscale, grayscale with
+	 * alpha, and indexed images in the r8/r16, rg8/rg16, and r8 (with a
+	 * palette) formats where the handler supports it. The default
+	 * implementation calls decode.
+	 **/
+	virtual DecodedImage decodeCompact(Data *data);
+
 	/**
 	 * Encodes an image from raw pixel data into a particular format.
 	 **/
 	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
 
+	/**
+	 * Encodes an image from raw pixel data into a particular format, writing
+	 * the encoded data to a Stream. The default implementation encodes the
+	 * whole image in memory and then writes it.
+	 **/
+	virtual void encodeStream(const DecodedImage &img, EncodedFormat format, Stream *stream);
+
 	/**
 	 * Whether this format handler can parse the given Data into a
 	 * CompressedImageData object.
@@ -107,9 +128,11 @@ public:
 	 *             pointer to the returned data.
 	 * @param[out] format The format of the Compressed Data.
 	 *
-	 * @return The single block of memory containing the parsed images.
+	 * @return The single block of memory containing the parsed images. Handlers
+	 *         whose sub-images can be used in place return filedata itself
+	 *         rather than a copy.
 	 **/
-	virtual StrongRef<ByteData> parseCompressed(Data *filedata,
+	virtual StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format);
 
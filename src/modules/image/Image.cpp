@@ -32,6 +32,24 @@
 #include "magpie/PKMHandler.h"
 #include "magpie/ASTCHandler.h"
 
+#include "BlockCompression.h"
+#include "math/MathModule.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#elif defined(LOVE_SIMD_SSE)
+#	include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
 namespace love
 {
 namespace image
@@ -60,6 +78,10 @@ Image::Image()
 
 Image::~Image()
 {
+	// Decodes and encodes use the format handlers (and this module), so they
+	// have to finish first.
+	jobs.wait();
+
 	// ImageData objects reference the FormatHandlers in our list, so we should
 	// release them instead of deleting them completely here.
 	for (FormatHandler *handler : formatHandlers)
@@ -71,6 +93,11 @@ love::image::ImageData *Image::newImageData(Data *data)
 	return new ImageData(data);
 }
 
+love::image::ImageData *Image::newImageData(Data *data, bool compact, std::vector<Color32> *palette)
+{
+	return new ImageData(data, compact, palette);
+}
+
 love::image::ImageData *Image::newImageData(int width, int height, PixelFormat format)
 {
 	return new ImageData(width, height, format);
@@ -81,11 +108,176 @@ love::image::ImageData *Image::newImageData(int width, int height, PixelFormat f
 	return new ImageData(width, height, format, data, own);
 }
 
+void Image::queueDecode(ImageDecode *decode)
+{
+	StrongRef<ImageDecode> ref(decode);
+	jobSystem->submit([ref]() { ref->decode(); }, [ref]() { ref->cancel(); }, &jobs);
+}
+
+void Image::queueEncode(ImageEncode *encode)
+{
+	StrongRef<ImageEncode> ref(encode);
+	jobSystem->submit([ref]() { ref->encode(); }, [ref]() { ref->cancel(); }, &jobs);
+}
+
+ImageDecode *Image::newImageDataAsync(Data *data)
+{
+	ImageDecode *decode = new ImageDecode(data);
+	queueDecode(decode);
+	return decode;
+}
+
+ImageDecode *Image::newImageDataAsync(love::filesystem::File *file)
+{
+	ImageDecode *decode = new ImageDecode(file);
+	queueDecode(decode);
+	return decode;
+}
+
+ImageEncode *Image::encodeAsync(ImageData *data, FormatHandler::EncodedFormat format, love::filesystem::File *file)
+{
+	ImageEncode *encode = new ImageEncode(data, format, file);
+	queueEncode(encode);
+	return encode;
+}
+
 love::image::CompressedImageData *Image::newCompressedData(Data *data)
 {
 	return new CompressedImageData(formatHandlers, data);
 }
 
+CompressedImageData *Image::newCompressedData(ImageData *src, PixelFormat format, bool mipmaps)
+{
+	PixelFormat linearformat = getLinearPixelFormat(format);
+
+	if (!isPixelFormatCompressed(linearformat) || !isBlockCompressionSupported(linearformat))
+	{
+		const char *name = "unknown";
+		love::getConstant(format, name);
+		throw love::Exception("Compressing ImageData to the %s pixel format is not supported.", name);
+	}
+
+	int width = src->getWidth();
+	int height = src->getHeight();
+
+	// The encoders work on RGBA8 pixels.
+	StrongRef<ImageData> rgba(src);
+	if (src->getFormat() != PIXELFORMAT_RGBA8_UNORM)
+	{
+		rgba.set(newImageData(width, height, PIXELFORMAT_RGBA8_UNORM), Acquire::NORETAIN);
+		rgba->paste(src, 0, 0, 0, 0, width, height);
+	}
+
+	struct MipLevel
+	{
+		int width;
+		int height;
+		std::vector<uint8> pixels;
+		size_t offset;
+		size_t size;
+	};
+
+	std::vector<MipLevel> levels(1);
+	levels[0].width = width;
+	levels[0].height = height;
+
+	const uint8 *pixels = (const uint8 *) rgba->getData();
+	levels[0].pixels.assign(pixels, pixels + (size_t) width * height * 4);
+
+	// Each mipmap level is a 2x2 box filter of the previous one.
+	while (mipmaps && (levels.back().width > 1 || levels.back().height > 1))
+	{
+		const MipLevel &prev = levels.back();
+
+		MipLevel level;
+		level.width = std::max(prev.width / 2, 1);
+		level.height = std::max(prev.height / 2, 1);
+		level.pixels.resize((size_t) level.width * level.height * 4);
+
+		for (int y = 0; y < level.height; y++)
+		{
+			int y0 = std::min(y * 2, prev.height - 1);
+			int y1 = std::min(y * 2 + 1, prev.height - 1);
+
+			for (int x = 0; x < level.width; x++)
+			{
+				int x0 = std::min(x * 2, prev.width - 1);
+				int x1 = std::min(x * 2 + 1, prev.width - 1);
+
+				const uint8 *p00 = &prev.pixels[((size_t) y0 * prev.width + x0) * 4];
+				const uint8 *p01 = &prev.pixels[((size_t) y0 * prev.width + x1) * 4];
+				const uint8 *p10 = &prev.pixels[((size_t) y1 * prev.width + x0) * 4];
+				const uint8 *p11 = &prev.pixels[((size_t) y1 * prev.width + x1) * 4];
+
+				uint8 *dst = &level.pixels[((size_t) y * level.width + x) * 4];
+				for (int c = 0; c < 4; c++)
+					dst[c] = (uint8) ((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+			}
+		}
+
+		levels.push_back(std::move(level));
+	}
+
+	size_t totalsize = 0;
+	for (MipLevel &level : levels)
+	{
+		level.offset = totalsize;
+		level.size = getPixelFormatSliceSize(linearformat, level.width, level.height);
+		totalsize += level.size;
+	}
+
+	StrongRef<ByteData> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
+	uint8 *memorydata = (uint8 *) memory->getData();
+
+	size_t blocksize = getPixelFormatBlockSize(linearformat);
+
+	// Every row of blocks in every level is an independent job.
+	std::vector<std::pair<int, int>> blockrows;
+	for (int i = 0; i < (int) levels.size(); i++)
+	{
+		for (int y = 0; y < levels[i].height; y += 4)
+			blockrows.push_back(std::make_pair(i, y));
+	}
+
+	jobSystem->runParallel((int) blockrows.size(), [&](int row)
+	{
+		const MipLevel &level = levels[blockrows[row].first];
+		int by = blockrows[row].second;
+
+		int blockcount = (level.width + 3) / 4;
+		uint8 *dst = memorydata + level.offset + (size_t) (by / 4) * blockcount * blocksize;
+
+		uint8 block[16 * 4];
+
+		for (int bx = 0; bx < blockcount; bx++)
+		{
+			// Partial blocks at the edges repeat the last row and column.
+			for (int y = 0; y < 4; y++)
+			{
+				int py = std::min(by + y, level.height - 1);
+				for (int x = 0; x < 4; x++)
+				{
+					int px = std::min(bx * 4 + x, level.width - 1);
+					memcpy(&block[(y * 4 + x) * 4], &level.pixels[((size_t) py * level.width + px) * 4], 4);
+				}
+			}
+
+			compressBlock(linearformat, block, dst + bx * blocksize);
+		}
+	});
+
+	std::vector<StrongRef<CompressedSlice>> slices;
+	for (const MipLevel &level : levels)
+	{
+		StrongRef<CompressedSlice> slice(new CompressedSlice(linearformat, level.width, level.height, memory, level.offset, level.size), Acquire::NORETAIN);
+		slices.push_back(slice);
+	}
+
+	CompressedImageData *data = new CompressedImageData(linearformat, memory, slices);
+	data->setLinear(!isPixelFormatSRGB(format) && src->isLinear());
+	return data;
+}
+
 bool Image::isCompressed(Data *data)
 {
 	for (FormatHandler *handler : formatHandlers)
@@ -189,6 +381,302 @@ std::vector<StrongRef<ImageData>> Image::newCubeFaces(love::image::ImageData *sr
 	return faces;
 }
 
+// Averages each 2x2 square of RGBA8 pixels in two source rows into one row
+// of destination pixels.
+static void downsampleRowRGBA8(const uint8 *row0, const uint8 *row1, uint8 *dst, int dstwidth)
+{
+	int x = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+
+	// Two destination pixels from four source pixels per row.
+	for (; x + 2 <= dstwidth; x += 2)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *) (row0 + x * 8));
+		__m128i b = _mm_loadu_si128((const __m128i *) (row1 + x * 8));
+
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+		lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+		hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+		__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+		_mm_storel_epi64((__m128i *) (dst + x * 4), _mm_packus_epi16(sum, sum));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	// Four destination pixels from eight source pixels per row.
+	for (; x + 4 <= dstwidth; x += 4)
+	{
+		// vld2q splits the pixels into even and odd ones, so each pair of
+		// neighbouring pixels lines up.
+		uint32x4x2_t a = vld2q_u32((const uint32_t *) (row0 + x * 8));
+		uint32x4x2_t b = vld2q_u32((const uint32_t *) (row1 + x * 8));
+
+		uint16x8_t lo = vaddl_u8(vget_low_u8(vreinterpretq_u8_u32(a.val[0])), vget_low_u8(vreinterpretq_u8_u32(a.val[1])));
+		uint16x8_t hi = vaddl_u8(vget_high_u8(vreinterpretq_u8_u32(a.val[0])), vget_high_u8(vreinterpretq_u8_u32(a.val[1])));
+		lo = vaddq_u16(lo, vaddl_u8(vget_low_u8(vreinterpretq_u8_u32(b.val[0])), vget_low_u8(vreinterpretq_u8_u32(b.val[1]))));
+		hi = vaddq_u16(hi, vaddl_u8(vget_high_u8(vreinterpretq_u8_u32(b.val[0])), vget_high_u8(vreinterpretq_u8_u32(b.val[1]))));
+
+		vst1q_u8(dst + x * 4, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+	}
+#endif
+
+	for (; x < dstwidth; x++)
+	{
+		const uint8 *p00 = row0 + x * 8;
+		const uint8 *p10 = row1 + x * 8;
+		uint8 *d = dst + x * 4;
+		for (int c = 0; c < 4; c++)
+			d[c] = (uint8) ((p00[c] + p00[c + 4] + p10[c] + p10[c + 4] + 2) / 4);
+	}
+}
+
+// Adds a weighted RGBA float pixel to sum.
+static inline void accumulatePixel(float *sum, const float *pixel, float weight)
+{
+#if defined(LOVE_SIMD_SSE)
+	_mm_storeu_ps(sum, _mm_add_ps(_mm_loadu_ps(sum), _mm_mul_ps(_mm_loadu_ps(pixel), _mm_set1_ps(weight))));
+#elif defined(LOVE_SIMD_NEON)
+	vst1q_f32(sum, vmlaq_n_f32(vld1q_f32(sum), vld1q_f32(pixel), weight));
+#else
+	for (int c = 0; c < 4; c++)
+		sum[c] += pixel[c] * weight;
+#endif
+}
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser
+// window.
+static double besselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 32; k++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+// Weights of a Kaiser windowed sinc filter which halves the size of an image.
+// Tap i covers the source pixel at offset i - 3 from twice the destination
+// pixel's position.
+static const int KAISER_TAPS = 8;
+
+static void getKaiserWeights(float weights[KAISER_TAPS])
+{
+	const double alpha = 4.0;
+	const double pi = 3.14159265358979323846;
+
+	double total = 0.0;
+	double w[KAISER_TAPS];
+
+	for (int i = 0; i < KAISER_TAPS; i++)
+	{
+		double d = i - KAISER_TAPS / 2 + 0.5;
+		double t = d / (KAISER_TAPS / 2);
+
+		double x = pi * d * 0.5;
+		double sinc = x == 0.0 ? 1.0 : std::sin(x) / x;
+		double window = besselI0(alpha * std::sqrt(std::max(1.0 - t * t, 0.0))) / besselI0(alpha);
+
+		w[i] = sinc * window;
+		total += w[i];
+	}
+
+	for (int i = 0; i < KAISER_TAPS; i++)
+		weights[i] = (float) (w[i] / total);
+}
+
+std::vector<StrongRef<ImageData>> Image::newMipmaps(ImageData *src, MipmapFilter filter, bool gammacorrect)
+{
+	PixelFormat format = src->getFormat();
+
+	ImageData::PixelGetFunction getpixel = src->getPixelGetFunction();
+	ImageData::PixelSetFunction setpixel = src->getPixelSetFunction();
+
+	if (getpixel == nullptr || setpixel == nullptr)
+		throw love::Exception("Generating mipmaps for ImageData with the %s pixel format is not supported.", getPixelFormatName(format));
+
+	std::vector<StrongRef<ImageData>> levels;
+	levels.emplace_back(src);
+
+	int width = src->getWidth();
+	int height = src->getHeight();
+
+	if (filter == MIPMAP_FILTER_BOX && !gammacorrect && format == PIXELFORMAT_RGBA8_UNORM)
+	{
+		while (width > 1 || height > 1)
+		{
+			ImageData *prev = levels.back();
+			int w = std::max(width / 2, 1);
+			int h = std::max(height / 2, 1);
+
+			StrongRef<ImageData> level(newImageData(w, h, format), Acquire::NORETAIN);
+
+			const uint8 *prevpixels = (const uint8 *) prev->getData();
+			uint8 *pixels = (uint8 *) level->getData();
+
+			jobSystem->runParallel(h, [&](int y)
+			{
+				const uint8 *row0 = prevpixels + (size_t) std::min(y * 2, height - 1) * width * 4;
+				const uint8 *row1 = prevpixels + (size_t) std::min(y * 2 + 1, height - 1) * width * 4;
+				uint8 *dst = pixels + (size_t) y * w * 4;
+
+				if (width > 1)
+					downsampleRowRGBA8(row0, row1, dst, w);
+				else
+				{
+					for (int c = 0; c < 4; c++)
+						dst[c] = (uint8) ((row0[c] + row1[c] + 1) / 2);
+				}
+			});
+
+			levels.push_back(level);
+			width = w;
+			height = h;
+		}
+
+		return levels;
+	}
+
+	// Everything else is filtered as RGBA floats. Each level is made from the
+	// float pixels of the previous one rather than its stored pixels, so
+	// rounding errors don't build up down the chain.
+	size_t pixelsize = src->getPixelSize();
+
+	std::vector<float> prevpixels((size_t) width * height * 4);
+
+	jobSystem->runParallel(height, [&](int y)
+	{
+		const uint8 *row = (const uint8 *) src->getData() + (size_t) y * width * pixelsize;
+		float *dst = &prevpixels[(size_t) y * width * 4];
+
+		for (int x = 0; x < width; x++)
+		{
+			Colorf c;
+			getpixel((const ImageData::Pixel *) (row + x * pixelsize), c);
+
+			if (gammacorrect)
+			{
+				c.r = love::math::gammaToLinear(c.r);
+				c.g = love::math::gammaToLinear(c.g);
+				c.b = love::math::gammaToLinear(c.b);
+			}
+
+			dst[x * 4 + 0] = c.r;
+			dst[x * 4 + 1] = c.g;
+			dst[x * 4 + 2] = c.b;
+			dst[x * 4 + 3] = c.a;
+		}
+	});
+
+	float kaiser[KAISER_TAPS];
+	getKaiserWeights(kaiser);
+
+	std::vector<float> pixels;
+	std::vector<float> columns;
+
+	while (width > 1 || height > 1)
+	{
+		int w = std::max(width / 2, 1);
+		int h = std::max(height / 2, 1);
+
+		pixels.assign((size_t) w * h * 4, 0.0f);
+
+		if (filter == MIPMAP_FILTER_KAISER)
+		{
+			// The filter is separable, so rows are filtered horizontally first
+			// and the results are filtered vertically.
+			columns.assign((size_t) w * height * 4, 0.0f);
+
+			jobSystem->runParallel(height, [&](int y)
+			{
+				const float *row = &prevpixels[(size_t) y * width * 4];
+				float *dst = &columns[(size_t) y * w * 4];
+
+				for (int x = 0; x < w; x++)
+				{
+					for (int i = 0; i < KAISER_TAPS; i++)
+					{
+						int sx = std::min(std::max(x * 2 + i - KAISER_TAPS / 2 + 1, 0), width - 1);
+						accumulatePixel(dst + x * 4, row + sx * 4, kaiser[i]);
+					}
+				}
+			});
+
+			jobSystem->runParallel(h, [&](int y)
+			{
+				float *dst = &pixels[(size_t) y * w * 4];
+
+				for (int i = 0; i < KAISER_TAPS; i++)
+				{
+					int sy = std::min(std::max(y * 2 + i - KAISER_TAPS / 2 + 1, 0), height - 1);
+					const float *row = &columns[(size_t) sy * w * 4];
+
+					for (int x = 0; x < w; x++)
+						accumulatePixel(dst + x * 4, row + x * 4, kaiser[i]);
+				}
+			});
+		}
+		else
+		{
+			jobSystem->runParallel(h, [&](int y)
+			{
+				const float *row0 = &prevpixels[(size_t) std::min(y * 2, height - 1) * width * 4];
+				const float *row1 = &prevpixels[(size_t) std::min(y * 2 + 1, height - 1) * width * 4];
+				float *dst = &pixels[(size_t) y * w * 4];
+
+				for (int x = 0; x < w; x++)
+				{
+					int x0 = std::min(x * 2, width - 1);
+					int x1 = std::min(x * 2 + 1, width - 1);
+
+					accumulatePixel(dst + x * 4, row0 + x0 * 4, 0.25f);
+					accumulatePixel(dst + x * 4, row0 + x1 * 4, 0.25f);
+					accumulatePixel(dst + x * 4, row1 + x0 * 4, 0.25f);
+					accumulatePixel(dst + x * 4, row1 + x1 * 4, 0.25f);
+				}
+			});
+		}
+
+		StrongRef<ImageData> level(newImageData(w, h, format), Acquire::NORETAIN);
+		level->setLinear(src->isLinear());
+
+		jobSystem->runParallel(h, [&](int y)
+		{
+			const float *row = &pixels[(size_t) y * w * 4];
+			uint8 *dst = (uint8 *) level->getData() + (size_t) y * w * pixelsize;
+
+			for (int x = 0; x < w; x++)
+			{
+				// The Kaiser filter's negative lobes can overshoot below 0.
+				Colorf c(std::max(row[x * 4 + 0], 0.0f), std::max(row[x * 4 + 1], 0.0f),
+				         std::max(row[x * 4 + 2], 0.0f), std::max(row[x * 4 + 3], 0.0f));
+
+				if (gammacorrect)
+				{
+					c.r = love::math::linearToGamma(c.r);
+					c.g = love::math::linearToGamma(c.g);
+					c.b = love::math::linearToGamma(c.b);
+				}
+
+				setpixel(c, (ImageData::Pixel *) (dst + x * pixelsize));
+			}
+		});
+
+		levels.push_back(level);
+		prevpixels.swap(pixels);
+		width = w;
+		height = h;
+	}
+
+	return levels;
+}
+
 std::vector<StrongRef<ImageData>> Image::newVolumeLayers(ImageData *src)
 {
 	std::vector<StrongRef<ImageData>> layers;
@@ -212,5 +700,12 @@ std::vector<StrongRef<ImageData>> Image::newVolumeLayers(ImageData *src)
 	return layers;
 }
 
+STRINGMAP_CLASS_BEGIN(Image, Image::MipmapFilter, Image::MIPMAP_FILTER_MAX_ENUM, mipmapFilter)
+{
+	{ "box",    Image::MIPMAP_FILTER_BOX    },
+	{ "kaiser", Image::MIPMAP_FILTER_KAISER },
+}
+STRINGMAP_CLASS_END(Image, Image::MipmapFilter, Image::MIPMAP_FILTER_MAX_ENUM, mipmapFilter)
+
 } // image
 } // love
@@ -26,7 +26,10 @@
 #include "common/Module.h"
 #include "filesystem/File.h"
 #include "ImageData.h"
+#include "ImageDecode.h"
+#include "ImageEncode.h"
 #include "CompressedImageData.h"
+#include "thread/JobSystem.h"
 
 // C++
 #include <list>
@@ -47,6 +50,13 @@ class Image : public Module
 {
 public:
 
+	enum MipmapFilter
+	{
+		MIPMAP_FILTER_BOX,
+		MIPMAP_FILTER_KAISER,
+		MIPMAP_FILTER_MAX_ENUM
+	};
+
 	static love::Type type;
 
 	Image();
@@ -59,6 +69,16 @@ public:
 	 **/
 	ImageData *newImageData(Data *data);
 
+	/**
+	 * Creates new ImageData from FileData, optionally keeping grayscale and
+	 * indexed images in a compact pixel format.
+	 * @param data The FileData containing the encoded image data.
+	 * @param compact Whether to keep the image's own number of components.
+	 * @param palette Gets the colors of an indexed image. May be null.
+	 * @return The new ImageData.
+	 **/
+	ImageData *newImageData(Data *data, bool compact, std::vector<Color32> *palette);
+
 	/**
 	 * Creates empty ImageData with the given size.
 	 * @param width The width of the ImageData.
@@ -78,6 +98,31 @@ public:
 	 **/
 	ImageData *newImageData(int width, int height, PixelFormat format, void *data, bool own = false);
 
+	/**
+	 * Starts decoding encoded image data on one of the decoding threads.
+	 * @param data The Data containing the encoded image data.
+	 * @return The in-flight decode, which provides the ImageData when done.
+	 **/
+	ImageDecode *newImageDataAsync(Data *data);
+
+	/**
+	 * Starts reading and decoding an image file on one of the decoding threads.
+	 * @param file The File containing the encoded image data.
+	 * @return The in-flight decode, which provides the ImageData when done.
+	 **/
+	ImageDecode *newImageDataAsync(love::filesystem::File *file);
+
+	/**
+	 * Starts encoding ImageData and writing it to a file on one of the worker
+	 * threads.
+	 * @param data The ImageData to encode. It shouldn't be modified until the
+	 *        encode has finished.
+	 * @param format The format to encode to.
+	 * @param file The File to write the encoded image data to.
+	 * @return The in-flight encode.
+	 **/
+	ImageEncode *encodeAsync(ImageData *data, FormatHandler::EncodedFormat format, love::filesystem::File *file);
+
 	/**
 	 * Creates new CompressedImageData from FileData.
 	 * @param data The FileData containing the compressed image data.
@@ -85,6 +130,16 @@ public:
 	 **/
 	CompressedImageData *newCompressedData(Data *data);
 
+	/**
+	 * Compresses ImageData into a GPU compressed format, using the calling
+	 * thread and the worker threads.
+	 * @param src The ImageData to compress.
+	 * @param format The compressed pixel format to encode to.
+	 * @param mipmaps Whether to also generate and compress a mipmap chain.
+	 * @return The new CompressedImageData.
+	 **/
+	CompressedImageData *newCompressedData(ImageData *src, PixelFormat format, bool mipmaps);
+
 	/**
 	 * Determines whether a FileData is Compressed image data or not.
 	 * @param data The FileData to test.
@@ -94,15 +149,34 @@ public:
 	std::vector<StrongRef<ImageData>> newCubeFaces(ImageData *src);
 	std::vector<StrongRef<ImageData>> newVolumeLayers(ImageData *src);
 
+	/**
+	 * Generates a full mipmap chain for ImageData, using the calling thread and
+	 * the worker threads.
+	 * @param src The ImageData to use as the first level.
+	 * @param filter The filter used to make each level from the previous one.
+	 * @param gammacorrect Whether to filter the color channels in linear space.
+	 * @return Every level, starting with src itself.
+	 **/
+	std::vector<StrongRef<ImageData>> newMipmaps(ImageData *src, MipmapFilter filter, bool gammacorrect);
+
+	STRINGMAP_CLASS_DECLARE(MipmapFilter);
+
 	const std::list<FormatHandler *> &getFormatHandlers() const;
 
 private:
 
+	void queueDecode(ImageDecode *decode);
+	void queueEncode(ImageEncode *encode);
+
 	ImageData *newPastedImageData(ImageData *src, int sx, int sy, int w, int h);
 
 	// Image format handlers we can use for decoding and encoding ImageData.
 	std::list<FormatHandler *> formatHandlers;
 
+	// Runs async decodes and encodes, and block compression.
+	love::thread::JobSystemRef jobSystem;
+	love::thread::JobGroup jobs;
+
 }; // Image
 
 } // image
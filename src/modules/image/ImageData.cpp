@@ -21,9 +21,19 @@
 #include "ImageData.h"
 #include "Image.h"
 #include "filesystem/Filesystem.h"
+#include "math/MathModule.h"
+#include "common/memory.h"
 
 #include <algorithm> // min/max
 
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
 using love::thread::Lock;
 
 namespace love
@@ -36,7 +46,13 @@ love::Type ImageData::type("ImageData", &Data::type);
 ImageData::ImageData(Data *data)
 	: ImageDataBase(PIXELFORMAT_UNKNOWN, 0, 0)
 {
-	decode(data);
+	decode(data, false, nullptr);
+}
+
+ImageData::ImageData(Data *data, bool compact, std::vector<Color32> *palette)
+	: ImageDataBase(PIXELFORMAT_UNKNOWN, 0, 0)
+{
+	decode(data, compact, palette);
 }
 
 ImageData::ImageData(int width, int height, PixelFormat format)
@@ -58,7 +74,10 @@ ImageData::ImageData(int width, int height, PixelFormat format, void *data, bool
 		throw love::Exception("ImageData does not support the %s pixel format.", getPixelFormatName(format));
 
 	if (own)
+	{
 		this->data = (unsigned char *) data;
+		trackAllocation(MEMORY_IMAGE, getSize());
+	}
 	else
 		create(width, height, format, data);
 }
@@ -71,6 +90,9 @@ ImageData::ImageData(const ImageData &c)
 
 ImageData::~ImageData()
 {
+	if (data != nullptr)
+		trackDeallocation(MEMORY_IMAGE, getSize());
+
 	if (decodeHandler.get())
 		decodeHandler->freeRawPixels(data);
 	else
@@ -98,6 +120,8 @@ void ImageData::create(int width, int height, PixelFormat format, void *data)
 	if (data)
 		memcpy(this->data, data, datasize);
 
+	trackAllocation(MEMORY_IMAGE, datasize);
+
 	decodeHandler = nullptr;
 	this->format = format;
 
@@ -105,7 +129,7 @@ void ImageData::create(int width, int height, PixelFormat format, void *data)
 	pixelGetFunction = getPixelGetFunction(format);
 }
 
-void ImageData::decode(Data *data)
+void ImageData::decode(Data *data, bool compact, std::vector<Color32> *palette)
 {
 	FormatHandler *decoder = nullptr;
 	FormatHandler::DecodedImage decodedimage;
@@ -125,7 +149,7 @@ void ImageData::decode(Data *data)
 	}
 
 	if (decoder)
-		decodedimage = decoder->decode(data);
+		decodedimage = compact ? decoder->decodeCompact(data) : decoder->decode(data);
 
 	if (decodedimage.data == nullptr)
 	{
@@ -147,6 +171,9 @@ void ImageData::decode(Data *data)
 	}
 
 	// Clean up any old data.
+	if (this->data != nullptr)
+		trackDeallocation(MEMORY_IMAGE, getSize());
+
 	if (decodeHandler)
 		decodeHandler->freeRawPixels(this->data);
 	else
@@ -163,40 +190,24 @@ void ImageData::decode(Data *data)
 
 	decodeHandler = decoder;
 
+	trackAllocation(MEMORY_IMAGE, decodedimage.size);
+
 	pixelSetFunction = getPixelSetFunction(format);
 	pixelGetFunction = getPixelGetFunction(format);
+
+	if (palette != nullptr)
+		palette->swap(decodedimage.palette);
 }
 
 love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile) const
 {
-	FormatHandler *encoder = nullptr;
 	FormatHandler::EncodedImage encodedimage;
-	FormatHandler::DecodedImage rawimage;
-
-	rawimage.width = width;
-	rawimage.height = height;
-	rawimage.size = getSize();
-	rawimage.data = data;
-	rawimage.format = format;
-
-	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+	FormatHandler::DecodedImage rawimage = getDecodedImage();
 
-	if (module == nullptr)
-		throw love::Exception("love.image must be loaded in order to encode an ImageData.");
+	FormatHandler *encoder = getEncoder(encodedFormat);
+	encodedimage = encoder->encode(rawimage, encodedFormat);
 
-	for (FormatHandler *handler : module->getFormatHandlers())
-	{
-		if (handler->canEncode(format, encodedFormat))
-		{
-			encoder = handler;
-			break;
-		}
-	}
-
-	if (encoder != nullptr)
-		encodedimage = encoder->encode(rawimage, encodedFormat);
-
-	if (encoder == nullptr || encodedimage.data == nullptr)
+	if (encodedimage.data == nullptr)
 		throw love::Exception("No suitable image encoder for the %s pixel format.", getPixelFormatName(format));
 
 	love::filesystem::FileData *filedata = nullptr;
@@ -238,6 +249,41 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	return filedata;
 }
 
+void ImageData::encode(FormatHandler::EncodedFormat encodedFormat, Stream *stream) const
+{
+	FormatHandler *encoder = getEncoder(encodedFormat);
+	encoder->encodeStream(getDecodedImage(), encodedFormat, stream);
+}
+
+FormatHandler *ImageData::getEncoder(FormatHandler::EncodedFormat encodedFormat) const
+{
+	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+
+	if (module == nullptr)
+		throw love::Exception("love.image must be loaded in order to encode an ImageData.");
+
+	for (FormatHandler *handler : module->getFormatHandlers())
+	{
+		if (handler->canEncode(format, encodedFormat))
+			return handler;
+	}
+
+	throw love::Exception("No suitable image encoder for the %s pixel format.", getPixelFormatName(format));
+}
+
+FormatHandler::DecodedImage ImageData::getDecodedImage() const
+{
+	FormatHandler::DecodedImage rawimage;
+
+	rawimage.width = width;
+	rawimage.height = height;
+	rawimage.size = getSize();
+	rawimage.data = data;
+	rawimage.format = format;
+
+	return rawimage;
+}
+
 size_t ImageData::getSize() const
 {
 	return size_t(getWidth() * getHeight()) * getPixelSize();
@@ -572,18 +618,134 @@ static void pasteRGBA8toRGBA16(Row src, Row dst, int w)
 		dst.u16[i] = (uint16) src.u8[i] << 8u;
 }
 
+// Lookup tables for conversions to and from 8 bit unorm values, which would
+// otherwise need a float16 conversion or a pow per component.
+struct UNorm8Tables
+{
+	float16 toFloat16[256];
+	uint8 fromFloat16[65536];
+	uint8 gammaToLinear[256];
+	uint8 linearToGamma[256];
+
+	UNorm8Tables()
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			float c = i / 255.0f;
+			toFloat16[i] = float32to16(c);
+			gammaToLinear[i] = (uint8) (love::math::gammaToLinear(c) * 255.0f + 0.5f);
+			linearToGamma[i] = (uint8) (love::math::linearToGamma(c) * 255.0f + 0.5f);
+		}
+
+		for (int i = 0; i < 65536; i++)
+			fromFloat16[i] = (uint8) (clamp01(float16to32((float16) i)) * 255.0f + 0.5f);
+	}
+};
+
+static const UNorm8Tables &getUNorm8Tables()
+{
+	static const UNorm8Tables tables;
+	return tables;
+}
+
 static void pasteRGBA8toRGBA16F(Row src, Row dst, int w)
 {
+	const float16 *table = getUNorm8Tables().toFloat16;
 	for (int i = 0; i < w * 4; i++)
-		dst.f16[i] = float32to16(src.u8[i] / 255.0f);
+		dst.f16[i] = table[src.u8[i]];
 }
 
 static void pasteRGBA8toRGBA32F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 max = _mm_set1_ps(255.0f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (src.u8 + i));
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+
+		_mm_storeu_ps(dst.f32 + i + 0, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), max));
+		_mm_storeu_ps(dst.f32 + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), max));
+		_mm_storeu_ps(dst.f32 + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), max));
+		_mm_storeu_ps(dst.f32 + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), max));
+	}
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+	const float32x4_t max = vdupq_n_f32(255.0f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		uint8x16_t p = vld1q_u8(src.u8 + i);
+		uint16x8_t lo = vmovl_u8(vget_low_u8(p));
+		uint16x8_t hi = vmovl_u8(vget_high_u8(p));
+
+		vst1q_f32(dst.f32 + i + 0, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), max));
+		vst1q_f32(dst.f32 + i + 4, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), max));
+		vst1q_f32(dst.f32 + i + 8, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), max));
+		vst1q_f32(dst.f32 + i + 12, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), max));
+	}
+#endif
+
+	for (; i < w * 4; i++)
 		dst.f32[i] = src.u8[i] / 255.0f;
 }
 
+static void pasteRGBA8toR8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+		dst.u8[i] = src.u8[i * 4];
+}
+
+static void pasteR8toRGBA8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 4 + 0] = src.u8[i];
+		dst.u8[i * 4 + 1] = 0;
+		dst.u8[i * 4 + 2] = 0;
+		dst.u8[i * 4 + 3] = 255;
+	}
+}
+
+static void pasteRGBA8toRG8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 2 + 0] = src.u8[i * 4 + 0];
+		dst.u8[i * 2 + 1] = src.u8[i * 4 + 1];
+	}
+}
+
+static void pasteRG8toRGBA8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 4 + 0] = src.u8[i * 2 + 0];
+		dst.u8[i * 4 + 1] = src.u8[i * 2 + 1];
+		dst.u8[i * 4 + 2] = 0;
+		dst.u8[i * 4 + 3] = 255;
+	}
+}
+
+static void pasteR8toRG8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 2 + 0] = src.u8[i];
+		dst.u8[i * 2 + 1] = 0;
+	}
+}
+
+static void pasteRG8toR8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+		dst.u8[i] = src.u8[i * 2];
+}
+
 static void pasteRGBA16toRGBA8(Row src, Row dst, int w)
 {
 	for (int i = 0; i < w * 4; i++)
@@ -604,8 +766,9 @@ static void pasteRGBA16toRGBA32F(Row src, Row dst, int w)
 
 static void pasteRGBA16FtoRGBA8(Row src, Row dst, int w)
 {
+	const uint8 *table = getUNorm8Tables().fromFloat16;
 	for (int i = 0; i < w * 4; i++)
-		dst.u8[i] = (uint8) (clamp01(float16to32(src.f16[i])) * 255.0f + 0.5f);
+		dst.u8[i] = table[src.f16[i]];
 }
 
 static void pasteRGBA16FtoRGBA16(Row src, Row dst, int w)
@@ -622,7 +785,44 @@ static void pasteRGBA16FtoRGBA32F(Row src, Row dst, int w)
 
 static void pasteRGBA32FtoRGBA8(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 max = _mm_set1_ps(255.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		__m128i c[4];
+		for (int j = 0; j < 4; j++)
+		{
+			__m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src.f32 + i + j * 4), zero), one);
+			c[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, max), half));
+		}
+
+		__m128i p = _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]), _mm_packs_epi32(c[2], c[3]));
+		_mm_storeu_si128((__m128i *) (dst.u8 + i), p);
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t half = vdupq_n_f32(0.5f);
+
+	for (; i + 8 <= w * 4; i += 8)
+	{
+		float32x4_t f0 = vminq_f32(vmaxq_f32(vld1q_f32(src.f32 + i + 0), zero), one);
+		float32x4_t f1 = vminq_f32(vmaxq_f32(vld1q_f32(src.f32 + i + 4), zero), one);
+
+		uint32x4_t c0 = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(f0, 255.0f), half));
+		uint32x4_t c1 = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(f1, 255.0f), half));
+
+		vst1_u8(dst.u8 + i, vmovn_u16(vcombine_u16(vmovn_u32(c0), vmovn_u32(c1))));
+	}
+#endif
+
+	for (; i < w * 4; i++)
 		dst.u8[i] = (uint8) (clamp01(src.f32[i]) * 255.0f + 0.5f);
 }
 
@@ -722,6 +922,18 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 				pasteRGBA8toRGBA16F(rowsrc, rowdst, sw);
 			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
 				pasteRGBA8toRGBA32F(rowsrc, rowdst, sw);
+			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_R8_UNORM)
+				pasteRGBA8toR8(rowsrc, rowdst, sw);
+			else if (srcformat == PIXELFORMAT_R8_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+				pasteR8toRGBA8(rowsrc, rowdst, sw);
+			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RG8_UNORM)
+				pasteRGBA8toRG8(rowsrc, rowdst, sw);
+			else if (srcformat == PIXELFORMAT_RG8_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+				pasteRG8toRGBA8(rowsrc, rowdst, sw);
+			else if (srcformat == PIXELFORMAT_R8_UNORM && dstformat == PIXELFORMAT_RG8_UNORM)
+				pasteR8toRG8(rowsrc, rowdst, sw);
+			else if (srcformat == PIXELFORMAT_RG8_UNORM && dstformat == PIXELFORMAT_R8_UNORM)
+				pasteRG8toR8(rowsrc, rowdst, sw);
 
 			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
 				pasteRGBA16toRGBA8(rowsrc, rowdst, sw);
@@ -764,6 +976,174 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 	}
 }
 
+static void premultiplyRGBA8(Row row, int w)
+{
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rgbmask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alphascale = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const __m128i round = _mm_set1_epi16(128);
+
+	for (; i + 4 <= w; i += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (row.u8 + i * 4));
+		__m128i c[2] = {_mm_unpacklo_epi8(p, zero), _mm_unpackhi_epi8(p, zero)};
+
+		for (int j = 0; j < 2; j++)
+		{
+			// Multiply rgb by alpha and alpha by 255, then divide by 255.
+			__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c[j], 0xFF), 0xFF);
+			a = _mm_or_si128(_mm_and_si128(a, rgbmask), alphascale);
+
+			__m128i m = _mm_add_epi16(_mm_mullo_epi16(c[j], a), round);
+			c[j] = _mm_srli_epi16(_mm_add_epi16(m, _mm_srli_epi16(m, 8)), 8);
+		}
+
+		_mm_storeu_si128((__m128i *) (row.u8 + i * 4), _mm_packus_epi16(c[0], c[1]));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 8 <= w; i += 8)
+	{
+		uint8x8x4_t p = vld4_u8(row.u8 + i * 4);
+
+		for (int j = 0; j < 3; j++)
+		{
+			uint16x8_t m = vaddq_u16(vmull_u8(p.val[j], p.val[3]), vdupq_n_u16(128));
+			p.val[j] = vshrn_n_u16(vaddq_u16(m, vshrq_n_u16(m, 8)), 8);
+		}
+
+		vst4_u8(row.u8 + i * 4, p);
+	}
+#endif
+
+	for (; i < w; i++)
+	{
+		uint8 *p = row.u8 + i * 4;
+		for (int j = 0; j < 3; j++)
+		{
+			uint32 m = p[j] * p[3] + 128;
+			p[j] = (uint8) ((m + (m >> 8)) >> 8);
+		}
+	}
+}
+
+static void mapRGBA8(Row row, int w, const uint8 *table)
+{
+	for (int i = 0; i < w; i++)
+	{
+		uint8 *p = row.u8 + i * 4;
+		p[0] = table[p[0]];
+		p[1] = table[p[1]];
+		p[2] = table[p[2]];
+	}
+}
+
+void ImageData::checkRect(int x, int y, int w, int h) const
+{
+	if (w <= 0 || h <= 0 || !(inside(x, y) && inside(x + w - 1, y + h - 1)))
+		throw love::Exception("Invalid rectangle dimensions.");
+}
+
+template <typename RowFunc, typename PixelFunc>
+void ImageData::mapRows(int x, int y, int w, int h, const char *name, RowFunc rowfunc, PixelFunc pixelfunc)
+{
+	checkRect(x, y, w, h);
+
+	if (pixelGetFunction == nullptr || pixelSetFunction == nullptr)
+		throw love::Exception("ImageData:%s does not currently support the %s pixel format.", name, getPixelFormatName(format));
+
+	size_t pixelsize = getPixelSize();
+
+	for (int row = y; row < y + h; row++)
+	{
+		Row r = {data + (row * width + x) * pixelsize};
+
+		if (rowfunc(r, w))
+			continue;
+
+		// Slow path: convert to Colorf and back.
+		for (int i = 0; i < w; i++)
+		{
+			Pixel *p = (Pixel *) (r.u8 + i * pixelsize);
+			Colorf c;
+			pixelGetFunction(p, c);
+			pixelfunc(c);
+			pixelSetFunction(c, p);
+		}
+	}
+}
+
+void ImageData::premultiplyAlpha(int x, int y, int w, int h)
+{
+	// Formats without alpha are always opaque.
+	if (getPixelFormatColorComponents(format) < 4)
+		return checkRect(x, y, w, h);
+
+	PixelFormat fmt = format;
+
+	mapRows(x, y, w, h, "premultiplyAlpha",
+		[fmt](Row row, int count)
+		{
+			if (fmt != PIXELFORMAT_RGBA8_UNORM)
+				return false;
+			premultiplyRGBA8(row, count);
+			return true;
+		},
+		[](Colorf &c)
+		{
+			c.r *= c.a;
+			c.g *= c.a;
+			c.b *= c.a;
+		}
+	);
+}
+
+void ImageData::gammaToLinear(int x, int y, int w, int h)
+{
+	PixelFormat fmt = format;
+	const uint8 *table = getUNorm8Tables().gammaToLinear;
+
+	mapRows(x, y, w, h, "gammaToLinear",
+		[fmt, table](Row row, int count)
+		{
+			if (fmt != PIXELFORMAT_RGBA8_UNORM)
+				return false;
+			mapRGBA8(row, count, table);
+			return true;
+		},
+		[](Colorf &c)
+		{
+			c.r = love::math::gammaToLinear(c.r);
+			c.g = love::math::gammaToLinear(c.g);
+			c.b = love::math::gammaToLinear(c.b);
+		}
+	);
+}
+
+void ImageData::linearToGamma(int x, int y, int w, int h)
+{
+	PixelFormat fmt = format;
+	const uint8 *table = getUNorm8Tables().linearToGamma;
+
+	mapRows(x, y, w, h, "linearToGamma",
+		[fmt, table](Row row, int count)
+		{
+			if (fmt != PIXELFORMAT_RGBA8_UNORM)
+				return false;
+			mapRGBA8(row, count, table);
+			return true;
+		},
+		[](Colorf &c)
+		{
+			c.r = love::math::linearToGamma(c.r);
+			c.g = love::math::linearToGamma(c.g);
+			c.b = love::math::linearToGamma(c.b);
+		}
+	);
+}
+
 size_t ImageData::getPixelSize() const
 {
 	return getPixelFormatBlockSize(format);
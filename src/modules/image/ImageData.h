@@ -62,6 +62,14 @@ public:
 	static love::Type type;
 
 	ImageData(Data *data);
+
+	/**
+	 * Decodes an image, optionally keeping grayscale and indexed images in a
+	 * compact pixel format (see FormatHandler::decodeCompact).
+	 * @param palette Gets the colors of an indexed image, or is cleared if the
+	 *        image isn't indexed. May be null.
+	 **/
+	ImageData(Data *data, bool compact, std::vector<Color32> *palette);
 	ImageData(int width, int height, PixelFormat format);
 	ImageData(int width, int height, PixelFormat format, void *data, bool own);
 	ImageData(const ImageData &c);
@@ -79,6 +87,19 @@ public:
 	 **/
 	void paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh);
 
+	/**
+	 * Multiplies the color channels of the pixels in the given area by their
+	 * alpha. Operates on whole rows at a time.
+	 **/
+	void premultiplyAlpha(int x, int y, int w, int h);
+
+	/**
+	 * Converts the color channels of the pixels in the given area from sRGB
+	 * to linear, or from linear to sRGB.
+	 **/
+	void gammaToLinear(int x, int y, int w, int h);
+	void linearToGamma(int x, int y, int w, int h);
+
 	/**
 	 * Checks whether a position is inside this ImageData. Useful for checking bounds.
 	 * @param x The position along the x-axis.
@@ -110,6 +131,14 @@ public:
 	 **/
 	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile) const;
 
+	/**
+	 * Encodes raw pixel data into a given format, writing the encoded data to
+	 * a Stream. Encoders which support it (PNG) write while they encode.
+	 * @param format The format of the encoded data.
+	 * @param stream The Stream to write the encoded image data to.
+	 **/
+	void encode(FormatHandler::EncodedFormat format, Stream *stream) const;
+
 	// Implements ImageDataBase.
 	ImageData *clone() const override;
 	void *getData() const override;
@@ -135,7 +164,17 @@ private:
 	void create(int width, int height, PixelFormat format, void *data = nullptr);
 
 	// Decode and load an encoded format.
-	void decode(Data *data);
+	void decode(Data *data, bool compact, std::vector<Color32> *palette);
+
+	FormatHandler *getEncoder(FormatHandler::EncodedFormat format) const;
+	FormatHandler::DecodedImage getDecodedImage() const;
+
+	void checkRect(int x, int y, int w, int h) const;
+
+	// Calls rowfunc on each row of the area. Rows it doesn't handle go through
+	// pixelfunc one pixel at a time instead.
+	template <typename RowFunc, typename PixelFunc>
+	void mapRows(int x, int y, int w, int h, const char *name, RowFunc rowfunc, PixelFunc pixelfunc);
 
 	// The actual data.
 	unsigned char *data = nullptr;
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ImageDecode.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace image
+{
+
+love::Type ImageDecode::type("ImageDecode", &Object::type);
+
+ImageDecode::ImageDecode(Data *data)
+	: data(data)
+	, complete(false)
+{
+}
+
+ImageDecode::ImageDecode(love::filesystem::File *file)
+	: file(file)
+	, complete(false)
+{
+}
+
+ImageDecode::~ImageDecode()
+{
+}
+
+bool ImageDecode::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+void ImageDecode::wait()
+{
+	love::thread::Lock lock(mutex);
+	while (!complete)
+		completeCond->wait(mutex);
+}
+
+ImageData *ImageDecode::getImageData()
+{
+	wait();
+
+	love::thread::Lock lock(mutex);
+
+	if (imageData.get() == nullptr)
+		throw love::Exception("Could not decode image: %s", error.c_str());
+
+	return imageData.get();
+}
+
+std::string ImageDecode::getError() const
+{
+	love::thread::Lock lock(mutex);
+	return error;
+}
+
+void ImageDecode::decode()
+{
+	ImageData *result = nullptr;
+	std::string err;
+
+	try
+	{
+		StrongRef<Data> source = data;
+
+		if (source.get() == nullptr)
+			source.set(file->read(), Acquire::NORETAIN);
+
+		result = new ImageData(source.get());
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+	}
+
+	finish(result, err);
+
+	if (result != nullptr)
+		result->release();
+}
+
+void ImageDecode::cancel()
+{
+	finish(nullptr, "The decode was cancelled.");
+}
+
+void ImageDecode::finish(ImageData *result, const std::string &err)
+{
+	love::thread::Lock lock(mutex);
+
+	imageData.set(result);
+	error = err;
+	complete = true;
+
+	// The source is no longer needed once the decode is done.
+	data.set(nullptr);
+	file.set(nullptr);
+
+	completeCond->broadcast();
+}
+
+} // image
+} // love
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/Data.h"
+#include "filesystem/File.h"
+#include "thread/threads.h"
+#include "ImageData.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * An in-flight decode of an encoded image into ImageData. The file is read
+ * and decoded on one of love.image's decoding threads.
+ **/
+class ImageDecode : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	ImageDecode(Data *data);
+	ImageDecode(love::filesystem::File *file);
+	virtual ~ImageDecode();
+
+	bool isComplete() const;
+
+	/**
+	 * Blocks until the decode has finished.
+	 **/
+	void wait();
+
+	/**
+	 * Waits for the decode to finish and returns the decoded ImageData. Throws
+	 * an exception if the image couldn't be decoded.
+	 **/
+	ImageData *getImageData();
+
+	/**
+	 * Returns the error message if the decode has finished and failed, or an
+	 * empty string otherwise.
+	 **/
+	std::string getError() const;
+
+	// Called by a decoding thread.
+	void decode();
+	void cancel();
+
+private:
+
+	void finish(ImageData *result, const std::string &err);
+
+	StrongRef<Data> data;
+	StrongRef<love::filesystem::File> file;
+
+	StrongRef<ImageData> imageData;
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef completeCond;
+
+}; // ImageDecode
+
+} // image
+} // love
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ImageEncode.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace image
+{
+
+love::Type ImageEncode::type("ImageEncode", &Object::type);
+
+ImageEncode::ImageEncode(ImageData *imageData, FormatHandler::EncodedFormat format, love::filesystem::File *file)
+	: imageData(imageData)
+	, format(format)
+	, file(file)
+	, complete(false)
+{
+}
+
+ImageEncode::~ImageEncode()
+{
+}
+
+bool ImageEncode::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+void ImageEncode::wait()
+{
+	love::thread::Lock lock(mutex);
+	while (!complete)
+		completeCond->wait(mutex);
+}
+
+std::string ImageEncode::getError() const
+{
+	love::thread::Lock lock(mutex);
+	return error;
+}
+
+void ImageEncode::encode()
+{
+	std::string err;
+
+	try
+	{
+		if (!file->isOpen() && !file->open(love::filesystem::File::MODE_WRITE))
+			throw love::Exception("Could not open file %s.", file->getFilename().c_str());
+
+		// Encoders write in small pieces, which should be batched up.
+		file->setBuffer(love::filesystem::File::BUFFER_FULL, 256 * 1024);
+
+		imageData->encode(format, file.get());
+		file->close();
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+		file->close();
+	}
+
+	finish(err);
+}
+
+void ImageEncode::cancel()
+{
+	finish("The encode was cancelled.");
+}
+
+void ImageEncode::finish(const std::string &err)
+{
+	love::thread::Lock lock(mutex);
+
+	error = err;
+	complete = true;
+
+	// The ImageData and file are no longer needed once the encode is done.
+	imageData.set(nullptr);
+	file.set(nullptr);
+
+	completeCond->broadcast();
+}
+
+} // image
+} // love
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "filesystem/File.h"
+#include "thread/threads.h"
+#include "ImageData.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * An in-flight encode of ImageData to a File. The image is encoded and
+ * written on one of love.image's worker threads. The ImageData shouldn't be
+ * modified until the encode is complete.
+ **/
+class ImageEncode : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	ImageEncode(ImageData *imageData, FormatHandler::EncodedFormat format, love::filesystem::File *file);
+	virtual ~ImageEncode();
+
+	bool isComplete() const;
+
+	/**
+	 * Blocks until the encode has finished.
+	 **/
+	void wait();
+
+	/**
+	 * Returns the error message if the encode has finished and failed, or an
+	 * empty string otherwise.
+	 **/
+	std::string getError() const;
+
+	// Called by a worker thread.
+	void encode();
+	void cancel();
+
+private:
+
+	void finish(const std::string &err);
+
+	StrongRef<ImageData> imageData;
+	FormatHandler::EncodedFormat format;
+	StrongRef<love::filesystem::File> file;
+
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef completeCond;
+
+}; // ImageEncode
+
+} // image
+} // love
@@ -22,6 +22,8 @@
 #include "KTXHandler.h"
 #include "common/int.h"
 #include "common/Exception.h"
+#include "data/ByteData.h"
+#include "data/Compressor.h"
 
 // C
 #include <string.h>
@@ -64,6 +66,86 @@ struct KTXHeader
 
 static_assert(sizeof(KTXHeader) == KTX_HEADER_SIZE, "Real size of KTX header doesn't match struct size!");
 
+#define KTX2_IDENTIFIER_REF {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A}
+#define KTX2_HEADER_SIZE    (80)
+
+// KTX2 files are always little-endian.
+struct KTX2Header
+{
+	uint8  identifier[12];
+	uint32 vkFormat;
+	uint32 typeSize;
+	uint32 pixelWidth;
+	uint32 pixelHeight;
+	uint32 pixelDepth;
+	uint32 layerCount;
+	uint32 faceCount;
+	uint32 levelCount;
+	uint32 supercompressionScheme;
+	uint32 dfdByteOffset;
+	uint32 dfdByteLength;
+	uint32 kvdByteOffset;
+	uint32 kvdByteLength;
+	uint64 sgdByteOffset;
+	uint64 sgdByteLength;
+};
+
+static_assert(sizeof(KTX2Header) == KTX2_HEADER_SIZE, "Real size of KTX2 header doesn't match struct size!");
+
+struct KTX2LevelIndex
+{
+	uint64 byteOffset;
+	uint64 byteLength;
+	uint64 uncompressedByteLength;
+};
+
+enum KTX2SupercompressionScheme
+{
+	KTX2_SUPERCOMPRESSION_NONE = 0,
+	KTX2_SUPERCOMPRESSION_BASISLZ = 1,
+	KTX2_SUPERCOMPRESSION_ZSTD = 2,
+	KTX2_SUPERCOMPRESSION_ZLIB = 3,
+};
+
+enum KTX2VkFormat
+{
+	KTX2_VK_FORMAT_BC1_RGB_UNORM_BLOCK       = 131,
+	KTX2_VK_FORMAT_BC1_RGB_SRGB_BLOCK        = 132,
+	KTX2_VK_FORMAT_BC1_RGBA_UNORM_BLOCK      = 133,
+	KTX2_VK_FORMAT_BC1_RGBA_SRGB_BLOCK       = 134,
+	KTX2_VK_FORMAT_BC2_UNORM_BLOCK           = 135,
+	KTX2_VK_FORMAT_BC2_SRGB_BLOCK            = 136,
+	KTX2_VK_FORMAT_BC3_UNORM_BLOCK           = 137,
+	KTX2_VK_FORMAT_BC3_SRGB_BLOCK            = 138,
+	KTX2_VK_FORMAT_BC4_UNORM_BLOCK           = 139,
+	KTX2_VK_FORMAT_BC4_SNORM_BLOCK           = 140,
+	KTX2_VK_FORMAT_BC5_UNORM_BLOCK           = 141,
+	KTX2_VK_FORMAT_BC5_SNORM_BLOCK           = 142,
+	KTX2_VK_FORMAT_BC6H_UFLOAT_BLOCK         = 143,
+	KTX2_VK_FORMAT_BC6H_SFLOAT_BLOCK         = 144,
+	KTX2_VK_FORMAT_BC7_UNORM_BLOCK           = 145,
+	KTX2_VK_FORMAT_BC7_SRGB_BLOCK            = 146,
+	KTX2_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK   = 147,
+	KTX2_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK    = 148,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK  = 150,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK  = 152,
+	KTX2_VK_FORMAT_EAC_R11_UNORM_BLOCK       = 153,
+	KTX2_VK_FORMAT_EAC_R11_SNORM_BLOCK       = 154,
+	KTX2_VK_FORMAT_EAC_R11G11_UNORM_BLOCK    = 155,
+	KTX2_VK_FORMAT_EAC_R11G11_SNORM_BLOCK    = 156,
+
+	// ASTC formats alternate between UNORM and SRGB, starting at 4x4 UNORM.
+	KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK      = 157,
+	KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK     = 184,
+
+	KTX2_VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG = 1000054000,
+	KTX2_VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG = 1000054001,
+	KTX2_VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG  = 1000054004,
+	KTX2_VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG  = 1000054005,
+};
+
 enum KTXGLInternalFormat
 {
 	KTX_GL_ETC1_RGB8_OES = 0x8D64,
@@ -274,10 +356,210 @@ PixelFormat convertFormat(uint32 glformat)
 	}
 }
 
+PixelFormat convertVkFormat(uint32 vkformat)
+{
+	static const PixelFormat astcformats[] =
+	{
+		PIXELFORMAT_ASTC_4x4_UNORM, PIXELFORMAT_ASTC_5x4_UNORM, PIXELFORMAT_ASTC_5x5_UNORM,
+		PIXELFORMAT_ASTC_6x5_UNORM, PIXELFORMAT_ASTC_6x6_UNORM, PIXELFORMAT_ASTC_8x5_UNORM,
+		PIXELFORMAT_ASTC_8x6_UNORM, PIXELFORMAT_ASTC_8x8_UNORM, PIXELFORMAT_ASTC_10x5_UNORM,
+		PIXELFORMAT_ASTC_10x6_UNORM, PIXELFORMAT_ASTC_10x8_UNORM, PIXELFORMAT_ASTC_10x10_UNORM,
+		PIXELFORMAT_ASTC_12x10_UNORM, PIXELFORMAT_ASTC_12x12_UNORM,
+	};
+
+	static const PixelFormat astcsrgbformats[] =
+	{
+		PIXELFORMAT_ASTC_4x4_sRGB, PIXELFORMAT_ASTC_5x4_sRGB, PIXELFORMAT_ASTC_5x5_sRGB,
+		PIXELFORMAT_ASTC_6x5_sRGB, PIXELFORMAT_ASTC_6x6_sRGB, PIXELFORMAT_ASTC_8x5_sRGB,
+		PIXELFORMAT_ASTC_8x6_sRGB, PIXELFORMAT_ASTC_8x8_sRGB, PIXELFORMAT_ASTC_10x5_sRGB,
+		PIXELFORMAT_ASTC_10x6_sRGB, PIXELFORMAT_ASTC_10x8_sRGB, PIXELFORMAT_ASTC_10x10_sRGB,
+		PIXELFORMAT_ASTC_12x10_sRGB, PIXELFORMAT_ASTC_12x12_sRGB,
+	};
+
+	if (vkformat >= KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK && vkformat <= KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+	{
+		uint32 index = vkformat - KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+		return (index & 1) ? astcsrgbformats[index / 2] : astcformats[index / 2];
+	}
+
+	switch (vkformat)
+	{
+	case KTX2_VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case KTX2_VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		return PIXELFORMAT_DXT1_UNORM;
+	case KTX2_VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case KTX2_VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		return PIXELFORMAT_DXT1_sRGB;
+	case KTX2_VK_FORMAT_BC2_UNORM_BLOCK:
+		return PIXELFORMAT_DXT3_UNORM;
+	case KTX2_VK_FORMAT_BC2_SRGB_BLOCK:
+		return PIXELFORMAT_DXT3_sRGB;
+	case KTX2_VK_FORMAT_BC3_UNORM_BLOCK:
+		return PIXELFORMAT_DXT5_UNORM;
+	case KTX2_VK_FORMAT_BC3_SRGB_BLOCK:
+		return PIXELFORMAT_DXT5_sRGB;
+	case KTX2_VK_FORMAT_BC4_UNORM_BLOCK:
+		return PIXELFORMAT_BC4_UNORM;
+	case KTX2_VK_FORMAT_BC4_SNORM_BLOCK:
+		return PIXELFORMAT_BC4_SNORM;
+	case KTX2_VK_FORMAT_BC5_UNORM_BLOCK:
+		return PIXELFORMAT_BC5_UNORM;
+	case KTX2_VK_FORMAT_BC5_SNORM_BLOCK:
+		return PIXELFORMAT_BC5_SNORM;
+	case KTX2_VK_FORMAT_BC6H_UFLOAT_BLOCK:
+		return PIXELFORMAT_BC6H_UFLOAT;
+	case KTX2_VK_FORMAT_BC6H_SFLOAT_BLOCK:
+		return PIXELFORMAT_BC6H_FLOAT;
+	case KTX2_VK_FORMAT_BC7_UNORM_BLOCK:
+		return PIXELFORMAT_BC7_UNORM;
+	case KTX2_VK_FORMAT_BC7_SRGB_BLOCK:
+		return PIXELFORMAT_BC7_sRGB;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGB_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+		return PIXELFORMAT_ETC2_RGB_sRGB;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA1_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA1_sRGB;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA_sRGB;
+	case KTX2_VK_FORMAT_EAC_R11_UNORM_BLOCK:
+		return PIXELFORMAT_EAC_R_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11_SNORM_BLOCK:
+		return PIXELFORMAT_EAC_R_SNORM;
+	case KTX2_VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+		return PIXELFORMAT_EAC_RG_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+		return PIXELFORMAT_EAC_RG_SNORM;
+	case KTX2_VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG:
+		return PIXELFORMAT_PVR1_RGBA2_UNORM;
+	case KTX2_VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
+		return PIXELFORMAT_PVR1_RGBA4_UNORM;
+	case KTX2_VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
+		return PIXELFORMAT_PVR1_RGBA2_sRGB;
+	case KTX2_VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
+		return PIXELFORMAT_PVR1_RGBA4_sRGB;
+	default:
+		return PIXELFORMAT_UNKNOWN;
+	}
+}
+
+bool isKTX2(Data *data)
+{
+	if (data->getSize() < sizeof(KTX2Header))
+		return false;
+
+	uint8 ktx2identifier[12] = KTX2_IDENTIFIER_REF;
+	return memcmp(data->getData(), ktx2identifier, 12) == 0;
+}
+
+StrongRef<Data> parseKTX2(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+{
+	KTX2Header header = *(const KTX2Header *) filedata->getData();
+
+	PixelFormat cformat = convertVkFormat(header.vkFormat);
+
+	if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_BASISLZ)
+		throw love::Exception("KTX2 files with BasisLZ supercompression are not supported.");
+
+	if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_ZSTD)
+		throw love::Exception("KTX2 files with Zstandard supercompression are not supported.");
+
+	if (header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE && header.supercompressionScheme != KTX2_SUPERCOMPRESSION_ZLIB)
+		throw love::Exception("Unknown supercompression scheme in KTX2 file.");
+
+	if (cformat == PIXELFORMAT_UNKNOWN)
+		throw love::Exception("Unsupported image format in KTX2 file.");
+
+	if (header.layerCount > 0)
+		throw love::Exception("Texture arrays in KTX2 files are not supported.");
+
+	if (header.pixelDepth > 0)
+		throw love::Exception("3D textures in KTX2 files are not supported.");
+
+	if (header.faceCount > 1)
+		throw love::Exception("Cubemap textures in KTX2 files are not supported.");
+
+	uint32 levelcount = std::max(header.levelCount, 1u);
+
+	size_t filesize = filedata->getSize();
+	const uint8 *filebytes = (const uint8 *) filedata->getData();
+
+	if (sizeof(KTX2Header) + levelcount * sizeof(KTX2LevelIndex) > filesize)
+		throw love::Exception("Could not parse KTX2 file: unexpected EOF.");
+
+	const KTX2LevelIndex *levels = (const KTX2LevelIndex *) (filebytes + sizeof(KTX2Header));
+
+	for (uint32 i = 0; i < levelcount; i++)
+	{
+		if (levels[i].byteOffset > filesize || levels[i].byteLength > filesize - levels[i].byteOffset)
+			throw love::Exception("Could not parse KTX2 file: unexpected EOF.");
+	}
+
+	StrongRef<Data> memory(filedata);
+
+	// Supercompressed levels have to be decompressed into a separate block,
+	// otherwise the levels are used in place.
+	if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_ZLIB)
+	{
+		size_t totalsize = 0;
+		for (uint32 i = 0; i < levelcount; i++)
+			totalsize += levels[i].uncompressedByteLength;
+
+		memory.set(new ByteData(totalsize, false), Acquire::NORETAIN);
+
+		auto compressor = love::data::Compressor::getCompressor(love::data::Compressor::FORMAT_ZLIB);
+		if (compressor == nullptr)
+			throw love::Exception("zlib decompression is not supported.");
+
+		size_t dataoffset = 0;
+
+		for (uint32 i = 0; i < levelcount; i++)
+		{
+			size_t size = levels[i].uncompressedByteLength;
+			char *decompressed = compressor->decompress(love::data::Compressor::FORMAT_ZLIB, (const char *) filebytes + levels[i].byteOffset, levels[i].byteLength, size);
+
+			if (size != levels[i].uncompressedByteLength)
+			{
+				delete[] decompressed;
+				throw love::Exception("Could not parse KTX2 file: unexpected decompressed size.");
+			}
+
+			memcpy((uint8 *) memory->getData() + dataoffset, decompressed, size);
+			delete[] decompressed;
+
+			int width = (int) std::max(header.pixelWidth >> i, 1u);
+			int height = (int) std::max(header.pixelHeight >> i, 1u);
+
+			images.emplace_back(new CompressedSlice(cformat, width, height, memory, dataoffset, size), Acquire::NORETAIN);
+			dataoffset += size;
+		}
+	}
+	else
+	{
+		for (uint32 i = 0; i < levelcount; i++)
+		{
+			int width = (int) std::max(header.pixelWidth >> i, 1u);
+			int height = (int) std::max(header.pixelHeight >> i, 1u);
+
+			images.emplace_back(new CompressedSlice(cformat, width, height, memory, levels[i].byteOffset, levels[i].byteLength), Acquire::NORETAIN);
+		}
+	}
+
+	format = cformat;
+	return memory;
+}
+
 } // Anonymous namespace.
 
 bool KTXHandler::canParseCompressed(Data *data)
 {
+	if (isKTX2(data))
+		return true;
+
 	if (data->getSize() < sizeof(KTXHeader))
 		return false;
 
@@ -293,11 +575,14 @@ bool KTXHandler::canParseCompressed(Data *data)
 	return true;
 }
 
-StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+StrongRef<Data> KTXHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
 {
 	if (!canParseCompressed(filedata))
 		throw love::Exception("Could not decode compressed data (not a KTX file?)");
 
+	if (isKTX2(filedata))
+		return parseKTX2(filedata, images, format);
+
 	KTXHeader header = *(KTXHeader *) filedata->getData();
 
 	if (header.endianness == KTX_ENDIAN_REF_REV)
@@ -325,9 +610,9 @@ StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<Stro
 
 	size_t fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
 	const uint8 *filebytes = (uint8 *) filedata->getData();
-	size_t totalsize = 0;
 
-	// Calculate the total size needed to hold the data in memory.
+	// The mipmap levels are used in place rather than copied out of the file's
+	// data, so loading doesn't need twice the file's size in memory.
 	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
 	{
 		if (fileoffset + sizeof(uint32) > filedata->getSize())
@@ -340,47 +625,25 @@ StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<Stro
 
 		fileoffset += sizeof(uint32);
 
+		if (fileoffset + mipsize > filedata->getSize())
+			throw love::Exception("Could not parse KTX file: unexpected EOF.");
+
 		// All mipsize fields are at a file offset that's a multiple of 4, so
 		// there might be some padding after the actual data in this mip level.
 		uint32 mipsizepadded = (mipsize + 3) & ~uint32(3);
 
-		totalsize += mipsizepadded;
-		fileoffset += mipsizepadded;
-	}
-
-	StrongRef<ByteData> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
-
-	// Reset the file offset to the start of the file's image data.
-	fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
-	size_t dataoffset = 0;
-
-	// Copy each mipmap level of the image from the file to our block of memory.
-	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
-	{
-		uint32 mipsize = *(uint32 *) (filebytes + fileoffset);
-
-		if (header.endianness == KTX_ENDIAN_REF_REV)
-			mipsize = swapuint32(mipsize);
-
-		fileoffset += sizeof(uint32);
-
-		uint32 mipsizepadded = (mipsize + 3) & ~uint32(3);
-
 		int width = (int) std::max(header.pixelWidth >> i, 1u);
 		int height = (int) std::max(header.pixelHeight >> i, 1u);
 
-		memcpy((uint8 *) memory->getData() + dataoffset, filebytes + fileoffset, mipsize);
-
-		auto slice = new CompressedSlice(cformat, width, height, memory, dataoffset, mipsize);
+		auto slice = new CompressedSlice(cformat, width, height, filedata, fileoffset, mipsize);
 		images.push_back(slice);
 		slice->release();
 
 		fileoffset += mipsizepadded;
-		dataoffset += mipsizepadded;
 	}
 
 	format = cformat;
-	return memory;
+	return filedata;
 }
 
 } // magpie
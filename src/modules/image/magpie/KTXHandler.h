@@ -31,7 +31,7 @@ namespace magpie
 {
 
 /**
- * Handles KTX files with compressed image data inside.
+ * Handles KTX and KTX2 files with compressed image data inside.
  **/
 class KTXHandler : public FormatHandler
 {
@@ -42,7 +42,7 @@ public:
 	// Implements FormatHandler.
 	bool canParseCompressed(Data *data) override;
 
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format) override;
 
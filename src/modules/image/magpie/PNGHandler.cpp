@@ -32,9 +32,19 @@
 
 // C++
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 // C
 #include <cstdlib>
+#include <cstring>
+
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#elif defined(LOVE_SIMD_NEON)
+#	define LOVE_PNG_NEON
+#	include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -128,6 +138,607 @@ static unsigned zlibCompress(unsigned char **out, size_t *outsize, const unsigne
 	return 0; // Success.
 }
 
+// Writes PNG chunks to a Stream, for the streaming encoder.
+class PNGChunkWriter
+{
+public:
+
+	PNGChunkWriter(Stream *stream)
+		: stream(stream)
+	{
+	}
+
+	void writeBytes(const void *data, size_t size)
+	{
+		if (!stream->write(data, (int64) size))
+			throw love::Exception("Could not write PNG data.");
+	}
+
+	void writeUint32(uint32 value)
+	{
+		uint8 bytes[4] = {(uint8) (value >> 24), (uint8) (value >> 16), (uint8) (value >> 8), (uint8) value};
+		writeBytes(bytes, 4);
+	}
+
+	void writeChunk(const char *type, const uint8 *data, size_t size)
+	{
+		writeUint32((uint32) size);
+		writeBytes(type, 4);
+
+		uLong crc = crc32(0L, (const Bytef *) type, 4);
+
+		if (size > 0)
+		{
+			writeBytes(data, size);
+			crc = crc32(crc, data, (uInt) size);
+		}
+
+		writeUint32((uint32) crc);
+	}
+
+private:
+
+	Stream *stream;
+};
+
+static inline uint8 paethPredictor(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = abs(p - a);
+	int pb = abs(p - b);
+	int pc = abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return (uint8) a;
+	else if (pb <= pc)
+		return (uint8) b;
+	else
+		return (uint8) c;
+}
+
+// Applies a PNG filter to a row. out has room for the filter type byte.
+static void filterPNGRow(int filter, const uint8 *row, const uint8 *prev, size_t size, size_t bpp, uint8 *out)
+{
+	out[0] = (uint8) filter;
+	out++;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		int a = i >= bpp ? row[i - bpp] : 0;
+		int b = prev != nullptr ? prev[i] : 0;
+		int c = (i >= bpp && prev != nullptr) ? prev[i - bpp] : 0;
+
+		switch (filter)
+		{
+		case 0:
+			out[i] = row[i];
+			break;
+		case 1:
+			out[i] = (uint8) (row[i] - a);
+			break;
+		case 2:
+			out[i] = (uint8) (row[i] - b);
+			break;
+		case 3:
+			out[i] = (uint8) (row[i] - ((a + b) >> 1));
+			break;
+		case 4:
+			out[i] = (uint8) (row[i] - paethPredictor(a, b, c));
+			break;
+		}
+	}
+}
+
+// Minimum sum of absolute differences, the usual adaptive filter heuristic.
+static size_t scorePNGRow(const uint8 *filtered, size_t size)
+{
+	size_t sum = 0;
+	for (size_t i = 1; i <= size; i++)
+		sum += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+	return sum;
+}
+
+#if defined(LOVE_SIMD_SSE2)
+
+static inline __m128i load4(const uint8 *p)
+{
+	int v;
+	memcpy(&v, p, 4);
+	return _mm_cvtsi32_si128(v);
+}
+
+static inline void store4(uint8 *p, __m128i v)
+{
+	int i = _mm_cvtsi128_si32(v);
+	memcpy(p, &i, 4);
+}
+
+// Reverses the Sub, Average and Paeth filters for rows of 4 byte pixels. Each
+// pixel depends on the one before it, so the SIMD work is across its channels.
+static void unfilterRow4(int filter, uint8 *row, const uint8 *prev, size_t size)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i a = zero;
+	__m128i c = zero;
+
+	for (size_t i = 0; i < size; i += 4)
+	{
+		__m128i x = load4(row + i);
+
+		if (filter == 1)
+			a = _mm_add_epi8(x, a);
+		else if (filter == 3)
+		{
+			// The PNG average rounds down, unlike _mm_avg_epu8.
+			__m128i b = load4(prev + i);
+			__m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+			a = _mm_add_epi8(x, avg);
+		}
+		else
+		{
+			__m128i b = load4(prev + i);
+
+			__m128i a16 = _mm_unpacklo_epi8(a, zero);
+			__m128i b16 = _mm_unpacklo_epi8(b, zero);
+			__m128i c16 = _mm_unpacklo_epi8(c, zero);
+
+			__m128i pa = _mm_sub_epi16(b16, c16);
+			__m128i pb = _mm_sub_epi16(a16, c16);
+			__m128i pc = _mm_add_epi16(pa, pb);
+
+			pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+			pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+			pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+			__m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+			// Ties favor a over b over c.
+			__m128i usea = _mm_cmpeq_epi16(smallest, pa);
+			__m128i useb = _mm_andnot_si128(usea, _mm_cmpeq_epi16(smallest, pb));
+			__m128i usec = _mm_andnot_si128(_mm_or_si128(usea, useb), _mm_set1_epi16(-1));
+
+			__m128i nearest = _mm_or_si128(_mm_and_si128(usea, a16), _mm_or_si128(_mm_and_si128(useb, b16), _mm_and_si128(usec, c16)));
+
+			a = _mm_add_epi8(x, _mm_packus_epi16(nearest, nearest));
+			c = b;
+		}
+
+		store4(row + i, a);
+	}
+}
+
+#elif defined(LOVE_PNG_NEON)
+
+static inline uint8x8_t load4(const uint8 *p)
+{
+	uint32 v;
+	memcpy(&v, p, 4);
+	return vreinterpret_u8_u32(vdup_n_u32(v));
+}
+
+static inline void store4(uint8 *p, uint8x8_t v)
+{
+	uint32 i = vget_lane_u32(vreinterpret_u32_u8(v), 0);
+	memcpy(p, &i, 4);
+}
+
+// Reverses the Sub, Average and Paeth filters for rows of 4 byte pixels. Each
+// pixel depends on the one before it, so the SIMD work is across its channels.
+static void unfilterRow4(int filter, uint8 *row, const uint8 *prev, size_t size)
+{
+	uint8x8_t a = vdup_n_u8(0);
+	uint8x8_t c = vdup_n_u8(0);
+
+	for (size_t i = 0; i < size; i += 4)
+	{
+		uint8x8_t x = load4(row + i);
+
+		if (filter == 1)
+			a = vadd_u8(x, a);
+		else if (filter == 3)
+			a = vadd_u8(x, vhadd_u8(a, load4(prev + i)));
+		else
+		{
+			uint8x8_t b = load4(prev + i);
+
+			uint16x8_t pa = vmovl_u8(vabd_u8(b, c));
+			uint16x8_t pb = vmovl_u8(vabd_u8(a, c));
+			int16x8_t sum = vaddq_s16(vreinterpretq_s16_u16(vsubl_u8(b, c)), vreinterpretq_s16_u16(vsubl_u8(a, c)));
+			uint16x8_t pc = vreinterpretq_u16_s16(vabsq_s16(sum));
+
+			// Ties favor a over b over c.
+			uint8x8_t usea = vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+			uint8x8_t useb = vmovn_u16(vcleq_u16(pb, pc));
+
+			a = vadd_u8(x, vbsl_u8(usea, a, vbsl_u8(useb, b, c)));
+			c = b;
+		}
+
+		store4(row + i, a);
+	}
+}
+
+#endif
+
+// Reverses the filter applied to a row of the image. The row before the first
+// one is all zeros.
+static bool unfilterPNGRow(int filter, uint8 *row, const uint8 *prev, size_t size, size_t bpp)
+{
+	switch (filter)
+	{
+	case 0:
+		return true;
+	case 2:
+		for (size_t i = 0; i < size; i++)
+			row[i] += prev[i];
+		return true;
+	case 1:
+	case 3:
+	case 4:
+		break;
+	default:
+		return false;
+	}
+
+#if defined(LOVE_SIMD_SSE2) || defined(LOVE_PNG_NEON)
+	if (bpp == 4)
+	{
+		unfilterRow4(filter, row, prev, size);
+		return true;
+	}
+#endif
+
+	if (filter == 1)
+	{
+		for (size_t i = bpp; i < size; i++)
+			row[i] += row[i - bpp];
+	}
+	else if (filter == 3)
+	{
+		for (size_t i = 0; i < bpp; i++)
+			row[i] += prev[i] >> 1;
+		for (size_t i = bpp; i < size; i++)
+			row[i] += (row[i - bpp] + prev[i]) >> 1;
+	}
+	else
+	{
+		for (size_t i = 0; i < bpp; i++)
+			row[i] += prev[i];
+		for (size_t i = bpp; i < size; i++)
+			row[i] += paethPredictor(row[i - bpp], prev[i], prev[i - bpp]);
+	}
+
+	return true;
+}
+
+static inline uint32 readUint32BE(const uint8 *p)
+{
+	return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+}
+
+// Converts an unfiltered row to RGBA in the output's bit depth.
+static void convertPNGRow(const uint8 *row, uint8 *out, int width, int colortype, int bitdepth, const uint8 *palette)
+{
+	if (bitdepth == 8)
+	{
+		switch (colortype)
+		{
+		case 6:
+			memcpy(out, row, (size_t) width * 4);
+			break;
+		case 2:
+			for (int x = 0; x < width; x++, row += 3, out += 4)
+			{
+				out[0] = row[0];
+				out[1] = row[1];
+				out[2] = row[2];
+				out[3] = 255;
+			}
+			break;
+		case 0:
+			for (int x = 0; x < width; x++, out += 4)
+			{
+				out[0] = out[1] = out[2] = row[x];
+				out[3] = 255;
+			}
+			break;
+		case 4:
+			for (int x = 0; x < width; x++, row += 2, out += 4)
+			{
+				out[0] = out[1] = out[2] = row[0];
+				out[3] = row[1];
+			}
+			break;
+		case 3:
+			for (int x = 0; x < width; x++, out += 4)
+				memcpy(out, palette + row[x] * 4, 4);
+			break;
+		}
+
+		return;
+	}
+
+	// 16 bit components are stored big-endian.
+	int channels = colortype == 6 ? 4 : colortype == 2 ? 3 : colortype == 4 ? 2 : 1;
+	uint16 *out16 = (uint16 *) out;
+
+	for (int x = 0; x < width; x++, row += channels * 2, out16 += 4)
+	{
+		uint16 v[4];
+		for (int c = 0; c < channels; c++)
+			v[c] = (uint16) ((row[c * 2] << 8) | row[c * 2 + 1]);
+
+		if (channels >= 3)
+		{
+			out16[0] = v[0];
+			out16[1] = v[1];
+			out16[2] = v[2];
+		}
+		else
+			out16[0] = out16[1] = out16[2] = v[0];
+
+		out16[3] = channels == 4 ? v[3] : channels == 2 ? v[1] : 0xFFFF;
+	}
+}
+
+// Copies a row of an image that's kept in its compact format, converting 16
+// bit components to native endianness.
+static void copyCompactPNGRow(const uint8 *row, uint8 *out, size_t rowsize, int bitdepth)
+{
+	if (bitdepth == 8)
+	{
+		memcpy(out, row, rowsize);
+		return;
+	}
+
+	uint16 *out16 = (uint16 *) out;
+	for (size_t i = 0; i < rowsize / 2; i++)
+		out16[i] = (uint16) ((row[i * 2] << 8) | row[i * 2 + 1]);
+}
+
+// Decodes the most common kinds of PNG (not interlaced, 8 or 16 bits per
+// component, no transparent color key) without LodePNG. The compressed data
+// is inflated a row at a time as it's read from each IDAT chunk, and each row
+// is unfiltered and converted straight into the output pixels, instead of
+// inflating the whole image into a separate buffer first.
+// If compact is set, grayscale and indexed images keep their own number of
+// components instead of being expanded to RGBA.
+// Returns false if the image is one of the kinds LodePNG needs to handle.
+static bool decodeFastPNG(const uint8 *in, size_t insize, bool compact, FormatHandler::DecodedImage &img)
+{
+	const uint8 signature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+	if (insize < 8 + 25 || memcmp(in, signature, 8) != 0 || memcmp(in + 12, "IHDR", 4) != 0)
+		return false;
+
+	const uint8 *ihdr = in + 16;
+	uint32 width = readUint32BE(ihdr);
+	uint32 height = readUint32BE(ihdr + 4);
+	int bitdepth = ihdr[8];
+	int colortype = ihdr[9];
+	int interlace = ihdr[12];
+
+	if (width == 0 || height == 0 || width > 0x7FFFFFF || height > 0x7FFFFFF || interlace != 0)
+		return false;
+
+	int channels = 0;
+	switch (colortype)
+	{
+	case 0: channels = 1; break;
+	case 2: channels = 3; break;
+	case 3: channels = 1; break;
+	case 4: channels = 2; break;
+	case 6: channels = 4; break;
+	default: return false;
+	}
+
+	if (!(bitdepth == 8 || (bitdepth == 16 && colortype != 3)))
+		return false;
+
+	compact = compact && (colortype == 0 || colortype == 3 || colortype == 4);
+
+	size_t bpp = (size_t) channels * bitdepth / 8;
+	size_t rowsize = bpp * width;
+	size_t outpixelsize = compact ? bpp : bitdepth == 16 ? 8 : 4;
+
+	// Palette entries which aren't set are opaque black.
+	uint8 palette[256 * 4];
+	for (int i = 0; i < 256; i++)
+	{
+		palette[i * 4 + 0] = palette[i * 4 + 1] = palette[i * 4 + 2] = 0;
+		palette[i * 4 + 3] = 255;
+	}
+
+	uint32 palettesize = 0;
+
+	// Check every chunk before decoding anything, so images LodePNG needs to
+	// handle are found before any work is done.
+	size_t pos = 8;
+	bool hasdata = false;
+	while (pos + 12 <= insize)
+	{
+		uint32 length = readUint32BE(in + pos);
+		const uint8 *type = in + pos + 4;
+		const uint8 *data = in + pos + 8;
+
+		if (length > insize - pos - 12)
+			return false;
+
+		if (crc32(crc32(0L, Z_NULL, 0), type, length + 4) != readUint32BE(data + length))
+			return false;
+
+		if (memcmp(type, "PLTE", 4) == 0)
+		{
+			palettesize = std::min<uint32>(length / 3, 256);
+			for (uint32 i = 0; i < palettesize; i++)
+				memcpy(palette + i * 4, data + i * 3, 3);
+		}
+		else if (memcmp(type, "tRNS", 4) == 0)
+		{
+			if (colortype != 3)
+				return false;
+
+			for (uint32 i = 0; i < length && i < 256; i++)
+				palette[i * 4 + 3] = data[i];
+		}
+		else if (memcmp(type, "IDAT", 4) == 0)
+			hasdata = true;
+		else if (memcmp(type, "IEND", 4) == 0)
+			break;
+
+		pos += length + 12;
+	}
+
+	if (!hasdata)
+		return false;
+
+	if ((size_t) width * height > std::numeric_limits<size_t>::max() / outpixelsize)
+		throw love::Exception("Could not decode PNG image (image is too large)");
+
+	size_t outsize = (size_t) width * height * outpixelsize;
+
+	// LodePNG uses malloc, so freeRawPixels does too.
+	uint8 *out = (uint8 *) malloc(outsize);
+	if (out == nullptr)
+		throw love::Exception("Out of memory.");
+
+	// The filter type byte, then the row, for the current and previous rows.
+	std::vector<uint8> rows;
+
+	z_stream zstream = {};
+	if (inflateInit(&zstream) != Z_OK)
+	{
+		free(out);
+		throw love::Exception("Could not initialize PNG decompression.");
+	}
+
+	const char *error = nullptr;
+	uint32 y = 0;
+
+	try
+	{
+		rows.resize((rowsize + 1) * 2, 0);
+	}
+	catch (std::exception &)
+	{
+		error = "out of memory";
+	}
+
+	uint8 *current = rows.data();
+	uint8 *previous = current + rowsize + 1;
+	size_t filled = 0;
+	bool streamend = false;
+
+	pos = 8;
+	while (error == nullptr && !streamend && pos + 12 <= insize)
+	{
+		uint32 length = readUint32BE(in + pos);
+		const uint8 *type = in + pos + 4;
+
+		if (memcmp(type, "IEND", 4) == 0)
+			break;
+
+		if (memcmp(type, "IDAT", 4) != 0)
+		{
+			pos += length + 12;
+			continue;
+		}
+
+		zstream.next_in = (Bytef *) (in + pos + 8);
+		zstream.avail_in = length;
+
+		while (zstream.avail_in > 0 && !streamend)
+		{
+			zstream.next_out = current + filled;
+			zstream.avail_out = (uInt) (rowsize + 1 - filled);
+
+			int status = inflate(&zstream, Z_NO_FLUSH);
+
+			if (status == Z_STREAM_END)
+				streamend = true;
+			else if (status != Z_OK)
+			{
+				error = zstream.msg != nullptr ? zstream.msg : "invalid compressed data";
+				break;
+			}
+
+			filled = rowsize + 1 - zstream.avail_out;
+
+			if (filled == rowsize + 1)
+			{
+				if (y >= height)
+				{
+					error = "too much image data";
+					break;
+				}
+
+				if (!unfilterPNGRow(current[0], current + 1, previous + 1, rowsize, bpp))
+				{
+					error = "invalid filter type";
+					break;
+				}
+
+				uint8 *outrow = out + (size_t) y * width * outpixelsize;
+
+				if (compact)
+					copyCompactPNGRow(current + 1, outrow, rowsize, bitdepth);
+				else
+					convertPNGRow(current + 1, outrow, (int) width, colortype, bitdepth, palette);
+
+				std::swap(current, previous);
+				filled = 0;
+				y++;
+			}
+		}
+
+		pos += length + 12;
+	}
+
+	inflateEnd(&zstream);
+
+	if (error == nullptr && y < height)
+		error = "image data is incomplete";
+
+	if (error != nullptr)
+	{
+		free(out);
+		throw love::Exception("Could not decode PNG image (%s)", error);
+	}
+
+	img.width = (int) width;
+	img.height = (int) height;
+	img.size = outsize;
+	img.data = out;
+
+	if (!compact)
+		img.format = bitdepth == 16 ? PIXELFORMAT_RGBA16_UNORM : PIXELFORMAT_RGBA8_UNORM;
+	else if (colortype == 4)
+		img.format = bitdepth == 16 ? PIXELFORMAT_RG16_UNORM : PIXELFORMAT_RG8_UNORM;
+	else
+		img.format = bitdepth == 16 ? PIXELFORMAT_R16_UNORM : PIXELFORMAT_R8_UNORM;
+
+	if (compact && colortype == 3)
+	{
+		// Indices past the end of the palette are opaque black, so they're kept.
+		uint32 maxindex = 0;
+		for (size_t i = 0; i < outsize; i++)
+			maxindex = std::max<uint32>(maxindex, out[i]);
+
+		try
+		{
+			img.palette.resize(std::max(palettesize, maxindex + 1));
+		}
+		catch (std::exception &)
+		{
+			free(out);
+			throw love::Exception("Out of memory.");
+		}
+
+		memcpy(img.palette.data(), palette, img.palette.size() * 4);
+	}
+
+	return true;
+}
+
 bool PNGHandler::canDecode(Data *data)
 {
 	unsigned int width = 0, height = 0;
@@ -154,6 +765,9 @@ PNGHandler::DecodedImage PNGHandler::decode(Data *fdata)
 
 	DecodedImage img;
 
+	if (decodeFastPNG(indata, insize, false, img))
+		return img;
+
 	lodepng::State state;
 	unsigned status = lodepng_inspect(&width, &height, &state, indata, insize);
 
@@ -199,6 +813,17 @@ PNGHandler::DecodedImage PNGHandler::decode(Data *fdata)
 	return img;
 }
 
+PNGHandler::DecodedImage PNGHandler::decodeCompact(Data *fdata)
+{
+	DecodedImage img;
+
+	// Interlaced images are rare enough that they're always expanded to RGBA.
+	if (decodeFastPNG((const uint8 *) fdata->getData(), fdata->getSize(), true, img))
+		return img;
+
+	return decode(fdata);
+}
+
 FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
 {
 	if (!canEncode(img.format, encodedFormat))
@@ -257,6 +882,121 @@ FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedF
 	return encimg;
 }
 
+void PNGHandler::encodeStream(const DecodedImage &img, EncodedFormat encodedFormat, Stream *stream)
+{
+	if (!canEncode(img.format, encodedFormat))
+		throw love::Exception("PNG encoder cannot encode to non-PNG format.");
+
+	// Favor speed over size: big screenshots should be written quickly, and
+	// the adaptive row filters recover most of the difference.
+	const int compressionLevel = 2;
+
+	int bitdepth = img.format == PIXELFORMAT_RGBA16_UNORM ? 16 : 8;
+	size_t bpp = (size_t) bitdepth / 2;
+	size_t rowsize = bpp * img.width;
+
+	PNGChunkWriter writer(stream);
+
+	const uint8 signature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+	writer.writeBytes(signature, sizeof(signature));
+
+	uint8 ihdr[13] =
+	{
+		(uint8) (img.width >> 24), (uint8) (img.width >> 16), (uint8) (img.width >> 8), (uint8) img.width,
+		(uint8) (img.height >> 24), (uint8) (img.height >> 16), (uint8) (img.height >> 8), (uint8) img.height,
+		(uint8) bitdepth, 6, 0, 0, 0, // RGBA, deflate, adaptive filtering, no interlacing.
+	};
+	writer.writeChunk("IHDR", ihdr, sizeof(ihdr));
+
+	z_stream zstream = {};
+	if (deflateInit2(&zstream, compressionLevel, Z_DEFLATED, 15, 8, Z_FILTERED) != Z_OK)
+		throw love::Exception("Could not initialize PNG compression.");
+
+	std::vector<uint8> rows[2];
+	std::vector<uint8> filtered[5];
+	std::vector<uint8> idat(256 * 1024);
+
+	try
+	{
+		rows[0].resize(rowsize);
+		rows[1].resize(rowsize);
+		for (int f = 0; f < 5; f++)
+			filtered[f].resize(rowsize + 1);
+
+		zstream.next_out = idat.data();
+		zstream.avail_out = (uInt) idat.size();
+
+		for (int y = 0; y <= img.height; y++)
+		{
+			const uint8 *filteredrow = nullptr;
+
+			if (y < img.height)
+			{
+				uint8 *row = rows[y & 1].data();
+				const uint8 *prev = y > 0 ? rows[(y - 1) & 1].data() : nullptr;
+				memcpy(row, img.data + rowsize * y, rowsize);
+
+				// PNG stores 16 bit components as big-endian.
+#ifndef LOVE_BIG_ENDIAN
+				if (bitdepth == 16)
+				{
+					uint16 *components = (uint16 *) row;
+					for (size_t i = 0; i < rowsize / 2; i++)
+						components[i] = swapuint16(components[i]);
+				}
+#endif
+
+				size_t bestscore = 0;
+				for (int f = 0; f < 5; f++)
+				{
+					filterPNGRow(f, row, prev, rowsize, bpp, filtered[f].data());
+					size_t score = scorePNGRow(filtered[f].data(), rowsize);
+					if (filteredrow == nullptr || score < bestscore)
+					{
+						filteredrow = filtered[f].data();
+						bestscore = score;
+					}
+				}
+
+				zstream.next_in = (Bytef *) filteredrow;
+				zstream.avail_in = (uInt) (rowsize + 1);
+			}
+
+			int flush = y < img.height ? Z_NO_FLUSH : Z_FINISH;
+			int status = Z_OK;
+
+			// Compressed data is written out as IDAT chunks while rows are
+			// still being compressed.
+			do
+			{
+				status = deflate(&zstream, flush);
+				if (status == Z_STREAM_ERROR)
+					throw love::Exception("Could not compress PNG data.");
+
+				size_t written = idat.size() - zstream.avail_out;
+				if (zstream.avail_out == 0 || (status == Z_STREAM_END && written > 0))
+				{
+					writer.writeChunk("IDAT", idat.data(), written);
+					zstream.next_out = idat.data();
+					zstream.avail_out = (uInt) idat.size();
+				}
+			} while (zstream.avail_in > 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+		}
+	}
+	catch (love::Exception &)
+	{
+		deflateEnd(&zstream);
+		throw;
+	}
+
+	deflateEnd(&zstream);
+
+	writer.writeChunk("IEND", nullptr, 0);
+
+	if (!stream->flush())
+		throw love::Exception("Could not write PNG data.");
+}
+
 void PNGHandler::freeRawPixels(unsigned char *mem)
 {
 	// LodePNG uses malloc, realloc, and free.
@@ -45,7 +45,9 @@ public:
 	bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat) override;
 
 	DecodedImage decode(Data *data) override;
+	DecodedImage decodeCompact(Data *data) override;
 	EncodedImage encode(const DecodedImage &img, EncodedFormat format) override;
+	void encodeStream(const DecodedImage &img, EncodedFormat format, Stream *stream) override;
 
 	void freeRawPixels(unsigned char *mem) override;
 	void freeEncodedImage(unsigned char *mem) override;
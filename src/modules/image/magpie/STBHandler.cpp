@@ -108,6 +108,39 @@ FormatHandler::DecodedImage STBHandler::decode(Data *data)
 	return img;
 }
 
+FormatHandler::DecodedImage STBHandler::decodeCompact(Data *data)
+{
+	const stbi_uc *buffer = (const stbi_uc *) data->getData();
+	int bufferlen = (int) data->getSize();
+
+	int w = 0;
+	int h = 0;
+	int comp = 0;
+
+	if (stbi_is_hdr_from_memory(buffer, bufferlen)
+		|| !stbi_info_from_memory(buffer, bufferlen, &w, &h, &comp)
+		|| comp > 2)
+	{
+		return decode(data);
+	}
+
+	DecodedImage img;
+
+	img.data = stbi_load_from_memory(buffer, bufferlen, &img.width, &img.height, &comp, comp);
+	img.size = img.width * img.height * comp;
+	img.format = comp == 2 ? PIXELFORMAT_RG8_UNORM : PIXELFORMAT_R8_UNORM;
+
+	if (img.data == nullptr || img.width <= 0 || img.height <= 0)
+	{
+		const char *err = stbi_failure_reason();
+		if (err == nullptr)
+			err = "unknown error";
+		throw love::Exception("Could not decode image with stb_image (%s).", err);
+	}
+
+	return img;
+}
+
 FormatHandler::EncodedImage STBHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
 {
 	if (!canEncode(img.format, encodedFormat))
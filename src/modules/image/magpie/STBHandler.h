@@ -48,6 +48,7 @@ public:
 	bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat) override;
 
 	DecodedImage decode(Data *data) override;
+	DecodedImage decodeCompact(Data *data) override;
 	EncodedImage encode(const DecodedImage &img, EncodedFormat format) override;
 
 	void freeRawPixels(unsigned char *mem) override;
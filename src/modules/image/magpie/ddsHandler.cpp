@@ -239,15 +239,13 @@ bool DDSHandler::canParseCompressed(Data *data)
 	return dds::isCompressedDDS(data->getData(), data->getSize());
 }
 
-StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+StrongRef<Data> DDSHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
 {
 	if (!dds::isCompressedDDS(filedata->getData(), filedata->getSize()))
 		throw love::Exception("Could not decode compressed data (not a DDS file?)");
 
 	PixelFormat texformat = PIXELFORMAT_UNKNOWN;
 
-	size_t dataSize = 0;
-
 	images.clear();
 
 	// Attempt to parse the dds file.
@@ -261,34 +259,21 @@ StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<Stro
 	if (parser.getMipmapCount() == 0)
 		throw love::Exception("Could not parse compressed data: No readable texture data.");
 
-	// Calculate the size of the block of memory we're returning.
-	for (size_t i = 0; i < parser.getMipmapCount(); i++)
-	{
-		const dds::Image *img = parser.getImageData(i);
-		dataSize += img->dataSize;
-	}
+	const uint8 *filebytes = (const uint8 *) filedata->getData();
 
-	StrongRef<ByteData> memory(new ByteData(dataSize, false), Acquire::NORETAIN);
-
-	size_t dataOffset = 0;
-
-	// Copy the parsed mipmap levels from the FileData to our CompressedImageData.
+	// The mipmap levels are used in place rather than copied out of the file's
+	// data, so loading doesn't need twice the file's size in memory.
 	for (size_t i = 0; i < parser.getMipmapCount(); i++)
 	{
-		// Fetch the data for this mipmap level.
 		const dds::Image *img = parser.getImageData(i);
+		size_t dataOffset = img->data - filebytes;
 
-		// Copy the mipmap image from the FileData to our block of memory.
-		memcpy((uint8 *) memory->getData() + dataOffset, img->data, img->dataSize);
-
-		auto slice = new CompressedSlice(texformat, img->width, img->height, memory, dataOffset, img->dataSize);
+		auto slice = new CompressedSlice(texformat, img->width, img->height, filedata, dataOffset, img->dataSize);
 		images.emplace_back(slice, Acquire::NORETAIN);
-
-		dataOffset += img->dataSize;
 	}
 
 	format = texformat;
-	return memory;
+	return filedata;
 }
 
 } // magpie
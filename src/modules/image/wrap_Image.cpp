@@ -85,17 +85,37 @@ int w_newImageData(lua_State *L)
 	}
 	else if (filesystem::luax_cangetdata(L, 1)) // Case 2: File(Data).
 	{
+		bool compact = false;
+		if (!lua_isnoneornil(L, 2))
+		{
+			luaL_checktype(L, 2, LUA_TTABLE);
+			compact = luax_boolflag(L, 2, "compact", false);
+		}
+
 		Data *data = love::filesystem::luax_getdata(L, 1);
 
 		ImageData *t = nullptr;
+		std::vector<Color32> palette;
 		luax_catchexcept(L,
-			[&]() { t = instance()->newImageData(data); },
+			[&]() { t = instance()->newImageData(data, compact, &palette); },
 			[&](bool) { data->release(); }
 		);
 
 		luax_pushtype(L, t);
 		t->release();
-		return 1;
+
+		if (palette.empty())
+			return 1;
+
+		// The palette of an indexed image is returned as a 1 pixel tall ImageData.
+		ImageData *p = nullptr;
+		luax_catchexcept(L, [&]() {
+			p = instance()->newImageData((int) palette.size(), 1, PIXELFORMAT_RGBA8_UNORM, palette.data());
+		});
+
+		luax_pushtype(L, p);
+		p->release();
+		return 2;
 	}
 	else
 	{
@@ -103,6 +123,58 @@ int w_newImageData(lua_State *L)
 	}
 }
 
+static ImageDecode *luax_newimagedataasync(lua_State *L, int idx)
+{
+	ImageDecode *decode = nullptr;
+
+	// Files are read on the decoding threads as well.
+	if (lua_isstring(L, idx) || luax_istype(L, idx, love::filesystem::File::type))
+	{
+		love::filesystem::File *file = love::filesystem::luax_getfile(L, idx);
+		luax_catchexcept(L,
+			[&]() { decode = instance()->newImageDataAsync(file); },
+			[&](bool) { file->release(); }
+		);
+	}
+	else
+	{
+		Data *data = love::filesystem::luax_getdata(L, idx);
+		luax_catchexcept(L,
+			[&]() { decode = instance()->newImageDataAsync(data); },
+			[&](bool) { data->release(); }
+		);
+	}
+
+	return decode;
+}
+
+int w_newImageDataAsync(lua_State *L)
+{
+	if (lua_istable(L, 1))
+	{
+		int count = (int) luax_objlen(L, 1);
+		lua_createtable(L, count, 0);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 1, i);
+			ImageDecode *decode = luax_newimagedataasync(L, -1);
+			lua_pop(L, 1);
+
+			luax_pushtype(L, decode);
+			decode->release();
+			lua_rawseti(L, -2, i);
+		}
+
+		return 1;
+	}
+
+	ImageDecode *decode = luax_newimagedataasync(L, 1);
+	luax_pushtype(L, decode);
+	decode->release();
+	return 1;
+}
+
 int w_newCompressedData(lua_State *L)
 {
 	Data *data = love::filesystem::luax_getdata(L, 1);
@@ -118,6 +190,25 @@ int w_newCompressedData(lua_State *L)
 	return 1;
 }
 
+int w_compress(lua_State *L)
+{
+	ImageData *id = luax_checkimagedata(L, 1);
+
+	const char *fname = luaL_checkstring(L, 2);
+	PixelFormat format = PIXELFORMAT_UNKNOWN;
+	if (!getConstant(fname, format))
+		return luax_enumerror(L, "pixel format", fname);
+
+	bool mipmaps = luax_optboolean(L, 3, false);
+
+	CompressedImageData *t = nullptr;
+	luax_catchexcept(L, [&]() { t = instance()->newCompressedData(id, format, mipmaps); });
+
+	luax_pushtype(L, CompressedImageData::type, t);
+	t->release();
+	return 1;
+}
+
 int w_isCompressed(lua_State *L)
 {
 	Data *data = love::filesystem::luax_getdata(L, 1);
@@ -142,8 +233,10 @@ int w_newCubeFaces(lua_State *L)
 static const luaL_Reg functions[] =
 {
 	{ "newImageData",  w_newImageData },
+	{ "newImageDataAsync", w_newImageDataAsync },
 	{ "newCompressedData", w_newCompressedData },
 	{ "isCompressed", w_isCompressed },
+	{ "compress", w_compress },
 	{ "newCubeFaces", w_newCubeFaces },
 	{ 0, 0 }
 };
@@ -152,6 +245,8 @@ static const lua_CFunction types[] =
 {
 	luaopen_imagedata,
 	luaopen_compressedimagedata,
+	luaopen_imagedecode,
+	luaopen_imageencode,
 	0
 };
 
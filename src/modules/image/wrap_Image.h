@@ -25,6 +25,8 @@
 #include "Image.h"
 #include "wrap_ImageData.h"
 #include "wrap_CompressedImageData.h"
+#include "wrap_ImageDecode.h"
+#include "wrap_ImageEncode.h"
 
 namespace love
 {
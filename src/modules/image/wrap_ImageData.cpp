@@ -23,6 +23,8 @@
 #include "data/wrap_Data.h"
 #include "filesystem/File.h"
 #include "filesystem/Filesystem.h"
+#include "filesystem/wrap_Filesystem.h"
+#include "Image.h"
 
 // Shove the wrap_ImageData.lua code directly into a raw string literal.
 static const char imagedata_lua[] =
@@ -234,6 +236,41 @@ int w_ImageData_paste(lua_State *L)
 	return 0;
 }
 
+static void luax_optimagedatarect(lua_State *L, int idx, ImageData *t, int &x, int &y, int &w, int &h)
+{
+	x = (int) luaL_optinteger(L, idx + 0, 0);
+	y = (int) luaL_optinteger(L, idx + 1, 0);
+	w = (int) luaL_optinteger(L, idx + 2, t->getWidth());
+	h = (int) luaL_optinteger(L, idx + 3, t->getHeight());
+}
+
+int w_ImageData_premultiplyAlpha(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	int x, y, w, h;
+	luax_optimagedatarect(L, 2, t, x, y, w, h);
+	luax_catchexcept(L, [&](){ t->premultiplyAlpha(x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_gammaToLinear(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	int x, y, w, h;
+	luax_optimagedatarect(L, 2, t, x, y, w, h);
+	luax_catchexcept(L, [&](){ t->gammaToLinear(x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_linearToGamma(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	int x, y, w, h;
+	luax_optimagedatarect(L, 2, t, x, y, w, h);
+	luax_catchexcept(L, [&](){ t->linearToGamma(x, y, w, h); });
+	return 0;
+}
+
 int w_ImageData_encode(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -261,6 +298,63 @@ int w_ImageData_encode(lua_State *L)
 	return 1;
 }
 
+int w_ImageData_encodeAsync(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	FormatHandler::EncodedFormat format;
+	const char *fmt = luaL_checkstring(L, 2);
+	if (!ImageData::getConstant(fmt, format))
+		return luax_enumerror(L, "encoded image format", ImageData::getConstants(format), fmt);
+
+	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+	if (module == nullptr)
+		return luaL_error(L, "love.image must be loaded in order to encode an ImageData.");
+
+	love::filesystem::File *file = love::filesystem::luax_getfile(L, 3);
+
+	ImageEncode *encode = nullptr;
+	luax_catchexcept(L,
+		[&]() { encode = module->encodeAsync(t, format, file); },
+		[&](bool) { file->release(); }
+	);
+
+	luax_pushtype(L, encode);
+	encode->release();
+	return 1;
+}
+
+int w_ImageData_generateMipmaps(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	Image::MipmapFilter filter = Image::MIPMAP_FILTER_BOX;
+	if (!lua_isnoneornil(L, 2))
+	{
+		const char *str = luaL_checkstring(L, 2);
+		if (!Image::getConstant(str, filter))
+			return luax_enumerror(L, "mipmap filter", Image::getConstants(filter), str);
+	}
+
+	bool gammacorrect = luax_optboolean(L, 3, false);
+
+	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+	if (module == nullptr)
+		return luaL_error(L, "love.image must be loaded in order to generate mipmaps.");
+
+	std::vector<StrongRef<ImageData>> levels;
+	luax_catchexcept(L, [&]() { levels = module->newMipmaps(t, filter, gammacorrect); });
+
+	lua_createtable(L, (int) levels.size(), 0);
+	for (int i = 0; i < (int) levels.size(); i++)
+	{
+		luax_pushtype(L, levels[i].get());
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 // C functions in a struct, necessary for the FFI versions of ImageData methods.
 struct FFI_ImageData
 {
@@ -297,7 +391,12 @@ static const luaL_Reg w_ImageData_functions[] =
 	{ "setPixel", w_ImageData_setPixel },
 	{ "paste", w_ImageData_paste },
 	{ "mapPixel", w_ImageData_mapPixel },
+	{ "premultiplyAlpha", w_ImageData_premultiplyAlpha },
+	{ "gammaToLinear", w_ImageData_gammaToLinear },
+	{ "linearToGamma", w_ImageData_linearToGamma },
 	{ "encode", w_ImageData_encode },
+	{ "encodeAsync", w_ImageData_encodeAsync },
+	{ "generateMipmaps", w_ImageData_generateMipmaps },
 	{ 0, 0 }
 };
 
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ImageDecode.h"
+
+namespace love
+{
+namespace image
+{
+
+ImageDecode *luax_checkimagedecode(lua_State *L, int idx)
+{
+	return luax_checktype<ImageDecode>(L, idx);
+}
+
+int w_ImageDecode_isComplete(lua_State *L)
+{
+	ImageDecode *d = luax_checkimagedecode(L, 1);
+	luax_pushboolean(L, d->isComplete());
+	return 1;
+}
+
+int w_ImageDecode_wait(lua_State *L)
+{
+	ImageDecode *d = luax_checkimagedecode(L, 1);
+	d->wait();
+	return 0;
+}
+
+int w_ImageDecode_getImageData(lua_State *L)
+{
+	ImageDecode *d = luax_checkimagedecode(L, 1);
+	ImageData *imagedata = nullptr;
+	luax_catchexcept(L, [&]() { imagedata = d->getImageData(); });
+	luax_pushtype(L, imagedata);
+	return 1;
+}
+
+int w_ImageDecode_getError(lua_State *L)
+{
+	ImageDecode *d = luax_checkimagedecode(L, 1);
+	std::string err = d->getError();
+	if (err.empty())
+		lua_pushnil(L);
+	else
+		luax_pushstring(L, err);
+	return 1;
+}
+
+static const luaL_Reg w_ImageDecode_functions[] =
+{
+	{ "isComplete", w_ImageDecode_isComplete },
+	{ "wait", w_ImageDecode_wait },
+	{ "getImageData", w_ImageDecode_getImageData },
+	{ "getError", w_ImageDecode_getError },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_imagedecode(lua_State *L)
+{
+	return luax_register_type(L, &ImageDecode::type, w_ImageDecode_functions, nullptr);
+}
+
+} // image
+} // love
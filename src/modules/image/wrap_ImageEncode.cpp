@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ImageEncode.h"
+
+namespace love
+{
+namespace image
+{
+
+ImageEncode *luax_checkimageencode(lua_State *L, int idx)
+{
+	return luax_checktype<ImageEncode>(L, idx);
+}
+
+int w_ImageEncode_isComplete(lua_State *L)
+{
+	ImageEncode *e = luax_checkimageencode(L, 1);
+	luax_pushboolean(L, e->isComplete());
+	return 1;
+}
+
+int w_ImageEncode_wait(lua_State *L)
+{
+	ImageEncode *e = luax_checkimageencode(L, 1);
+	e->wait();
+	return 0;
+}
+
+int w_ImageEncode_getError(lua_State *L)
+{
+	ImageEncode *e = luax_checkimageencode(L, 1);
+	std::string err = e->getError();
+	if (err.empty())
+		lua_pushnil(L);
+	else
+		luax_pushstring(L, err);
+	return 1;
+}
+
+static const luaL_Reg w_ImageEncode_functions[] =
+{
+	{ "isComplete", w_ImageEncode_isComplete },
+	{ "wait", w_ImageEncode_wait },
+	{ "getError", w_ImageEncode_getError },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_imageencode(lua_State *L)
+{
+	return luax_register_type(L, &ImageEncode::type, w_ImageEncode_functions, nullptr);
+}
+
+} // image
+} // love
@@ -171,6 +171,23 @@ public:
 		};
 	};
 
+	// Every input of a joystick at one point in time.
+	struct State
+	{
+		std::vector<float> axes;
+		std::vector<uint8> buttons;
+		std::vector<Hat> hats;
+
+		// Indexed by GamepadAxis and GamepadButton. Zero and false if the
+		// joystick isn't a gamepad.
+		float gamepadAxes[GAMEPAD_AXIS_MAX_ENUM];
+		bool gamepadButtons[GAMEPAD_BUTTON_MAX_ENUM];
+
+		// The data of a sensor is only valid if it's enabled.
+		bool sensorEnabled[Sensor::SENSOR_MAX_ENUM];
+		float sensorData[Sensor::SENSOR_MAX_ENUM][3];
+	};
+
 	virtual ~Joystick() {}
 
 	virtual bool open(int64 deviceid) = 0;
@@ -224,6 +241,19 @@ public:
 	virtual void setSensorEnabled(Sensor::SensorType type, bool enabled) = 0;
 	virtual std::vector<float> getSensorData(Sensor::SensorType type) const = 0;
 
+	/**
+	 * Reads every axis, button, hat, gamepad input and enabled sensor at once.
+	 * The vectors in the State are resized as needed, so reusing one doesn't
+	 * allocate.
+	 **/
+	virtual void getState(State &state) const = 0;
+
+	/**
+	 * Like getState, but reads into a State owned by this Joystick, which
+	 * every call reuses.
+	 **/
+	const State &getReusedState() { getState(reusedState); return reusedState; }
+
 	STRINGMAP_CLASS_DECLARE(Hat);
 	STRINGMAP_CLASS_DECLARE(JoystickType);
 	STRINGMAP_CLASS_DECLARE(GamepadType);
@@ -233,6 +263,10 @@ public:
 
 	static float clampval(float x);
 
+private:
+
+	State reusedState;
+
 }; // Joystick
 
 } // joystick
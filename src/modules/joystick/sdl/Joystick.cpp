@@ -584,6 +584,62 @@ std::vector<float> Joystick::getSensorData(Sensor::SensorType type) const
 #endif
 }
 
+void Joystick::getState(State &state) const
+{
+	bool connected = isConnected();
+
+	state.axes.resize(connected ? getAxisCount() : 0);
+	state.buttons.resize(connected ? getButtonCount() : 0);
+	state.hats.resize(connected ? getHatCount() : 0);
+
+	// SDL updates its copy of the input state while pumping events, so none of
+	// these talk to the device.
+	for (size_t i = 0; i < state.axes.size(); i++)
+		state.axes[i] = clampval(((float) SDL_GetJoystickAxis(joyhandle, (int) i))/32768.0f);
+
+	for (size_t i = 0; i < state.buttons.size(); i++)
+		state.buttons[i] = SDL_GetJoystickButton(joyhandle, (int) i) ? 1 : 0;
+
+	for (size_t i = 0; i < state.hats.size(); i++)
+	{
+		state.hats[i] = HAT_INVALID;
+		getConstant(SDL_GetJoystickHat(joyhandle, (int) i), state.hats[i]);
+	}
+
+	bool gamepad = connected && isGamepad();
+
+	for (int i = 0; i < GAMEPAD_AXIS_MAX_ENUM; i++)
+	{
+		SDL_GamepadAxis sdlaxis;
+		state.gamepadAxes[i] = 0.0f;
+		if (gamepad && getConstant((GamepadAxis) i, sdlaxis))
+			state.gamepadAxes[i] = clampval((float) SDL_GetGamepadAxis(controller, sdlaxis) / 32768.0f);
+	}
+
+	for (int i = 0; i < GAMEPAD_BUTTON_MAX_ENUM; i++)
+	{
+		SDL_GamepadButton sdlbutton;
+		state.gamepadButtons[i] = gamepad && getConstant((GamepadButton) i, sdlbutton) && SDL_GetGamepadButton(controller, sdlbutton);
+	}
+
+	for (int i = 0; i < Sensor::SENSOR_MAX_ENUM; i++)
+	{
+		state.sensorEnabled[i] = false;
+		state.sensorData[i][0] = state.sensorData[i][1] = state.sensorData[i][2] = 0.0f;
+
+#if defined(LOVE_ENABLE_SENSOR)
+		using SDLSensor = love::sensor::sdl::Sensor;
+
+		if (!gamepad)
+			continue;
+
+		SDL_SensorType sdltype = SDLSensor::convert((Sensor::SensorType) i);
+		if (SDL_GamepadSensorEnabled(controller, sdltype))
+			state.sensorEnabled[i] = SDL_GetGamepadSensorData(controller, sdltype, state.sensorData[i], 3);
+#endif
+	}
+}
+
 bool Joystick::getConstant(Uint8 in, Joystick::Hat &out)
 {
 	return hats.find(in, out);
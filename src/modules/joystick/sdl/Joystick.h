@@ -95,6 +95,8 @@ public:
 	void setSensorEnabled(Sensor::SensorType type, bool enabled) override;
 	std::vector<float> getSensorData(Sensor::SensorType type) const override;
 
+	void getState(State &state) const override;
+
 	static bool getConstant(Hat in, Uint8 &out);
 	static bool getConstant(Uint8 in, Hat &out);
 
@@ -22,6 +22,7 @@
 #include "wrap_Joystick.h"
 #include "wrap_JoystickModule.h"
 #include "sensor/Sensor.h"
+#include "common/Data.h"
 
 #include <vector>
 
@@ -449,6 +450,174 @@ int w_Joystick_getSensorData(lua_State *L)
 
 #endif // LOVE_ENABLE_SENSOR
 
+// Pushes t[name], replacing it with a new table first if it isn't one.
+static void pushStateField(lua_State *L, int idx, const char *name)
+{
+	lua_getfield(L, idx, name);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, idx, name);
+	}
+}
+
+// Removes entries past count from a reused array.
+static void trimStateArray(lua_State *L, int idx, int count)
+{
+	for (int i = (int) luax_objlen(L, idx); i > count; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, idx, i);
+	}
+}
+
+// Same bits as SDL's hat values.
+static float getHatMask(Joystick::Hat hat)
+{
+	switch (hat)
+	{
+	case Joystick::HAT_UP: return 1.0f;
+	case Joystick::HAT_RIGHT: return 2.0f;
+	case Joystick::HAT_DOWN: return 4.0f;
+	case Joystick::HAT_LEFT: return 8.0f;
+	case Joystick::HAT_RIGHTUP: return 3.0f;
+	case Joystick::HAT_RIGHTDOWN: return 6.0f;
+	case Joystick::HAT_LEFTUP: return 9.0f;
+	case Joystick::HAT_LEFTDOWN: return 12.0f;
+	default: return 0.0f;
+	}
+}
+
+int w_Joystick_getState(lua_State *L)
+{
+	Joystick *j = luax_checkjoystick(L, 1);
+
+	const Joystick::State &state = j->getReusedState();
+
+	if (luax_istype(L, 2, love::Data::type))
+	{
+		// Packed floats: axes, buttons, hat bitmasks, gamepad axes, gamepad
+		// buttons, then x/y/z for each sensor.
+		love::Data *data = luax_totype<love::Data>(L, 2);
+
+		size_t count = state.axes.size() + state.buttons.size() + state.hats.size();
+		count += (Joystick::GAMEPAD_AXIS_MAX_ENUM - 1) + (Joystick::GAMEPAD_BUTTON_MAX_ENUM - 1);
+		count += Joystick::Sensor::SENSOR_MAX_ENUM * 3;
+
+		if (data->getSize() < count * sizeof(float))
+			return luaL_error(L, "Data is too small to hold the joystick state (%d bytes needed).", (int) (count * sizeof(float)));
+
+		float *out = (float *) data->getData();
+
+		for (float value : state.axes)
+			*out++ = value;
+		for (uint8 value : state.buttons)
+			*out++ = value ? 1.0f : 0.0f;
+		for (Joystick::Hat value : state.hats)
+			*out++ = getHatMask(value);
+		for (int i = 1; i < Joystick::GAMEPAD_AXIS_MAX_ENUM; i++)
+			*out++ = state.gamepadAxes[i];
+		for (int i = 1; i < Joystick::GAMEPAD_BUTTON_MAX_ENUM; i++)
+			*out++ = state.gamepadButtons[i] ? 1.0f : 0.0f;
+		for (int i = 0; i < Joystick::Sensor::SENSOR_MAX_ENUM; i++)
+		{
+			for (int c = 0; c < 3; c++)
+				*out++ = state.sensorData[i][c];
+		}
+
+		lua_pushinteger(L, (lua_Integer) count);
+		return 1;
+	}
+
+	// Reuse the given table (and its subtables) to avoid garbage.
+	if (lua_istable(L, 2))
+		lua_settop(L, 2);
+	else
+	{
+		lua_settop(L, 1);
+		lua_newtable(L);
+	}
+
+	pushStateField(L, 2, "axes");
+	for (size_t i = 0; i < state.axes.size(); i++)
+	{
+		lua_pushnumber(L, state.axes[i]);
+		lua_rawseti(L, 3, (int) i + 1);
+	}
+	trimStateArray(L, 3, (int) state.axes.size());
+	lua_pop(L, 1);
+
+	pushStateField(L, 2, "buttons");
+	for (size_t i = 0; i < state.buttons.size(); i++)
+	{
+		luax_pushboolean(L, state.buttons[i] != 0);
+		lua_rawseti(L, 3, (int) i + 1);
+	}
+	trimStateArray(L, 3, (int) state.buttons.size());
+	lua_pop(L, 1);
+
+	pushStateField(L, 2, "hats");
+	for (size_t i = 0; i < state.hats.size(); i++)
+	{
+		const char *direction = "";
+		Joystick::getConstant(state.hats[i], direction);
+		lua_pushstring(L, direction);
+		lua_rawseti(L, 3, (int) i + 1);
+	}
+	trimStateArray(L, 3, (int) state.hats.size());
+	lua_pop(L, 1);
+
+	pushStateField(L, 2, "gamepadaxes");
+	for (int i = 1; i < Joystick::GAMEPAD_AXIS_MAX_ENUM; i++)
+	{
+		const char *name = nullptr;
+		if (!Joystick::getConstant((Joystick::GamepadAxis) i, name))
+			continue;
+		lua_pushnumber(L, state.gamepadAxes[i]);
+		lua_setfield(L, 3, name);
+	}
+	lua_pop(L, 1);
+
+	pushStateField(L, 2, "gamepadbuttons");
+	for (int i = 1; i < Joystick::GAMEPAD_BUTTON_MAX_ENUM; i++)
+	{
+		const char *name = nullptr;
+		if (!Joystick::getConstant((Joystick::GamepadButton) i, name))
+			continue;
+		luax_pushboolean(L, state.gamepadButtons[i]);
+		lua_setfield(L, 3, name);
+	}
+	lua_pop(L, 1);
+
+	pushStateField(L, 2, "sensors");
+	for (int i = 0; i < Joystick::Sensor::SENSOR_MAX_ENUM; i++)
+	{
+		const char *name = nullptr;
+		if (!Joystick::Sensor::getConstant((Joystick::Sensor::SensorType) i, name))
+			continue;
+
+		if (!state.sensorEnabled[i])
+		{
+			lua_pushnil(L);
+			lua_setfield(L, 3, name);
+			continue;
+		}
+
+		pushStateField(L, 3, name);
+		for (int c = 0; c < 3; c++)
+		{
+			lua_pushnumber(L, state.sensorData[i][c]);
+			lua_rawseti(L, 4, c + 1);
+		}
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg w_Joystick_functions[] =
 {
@@ -466,6 +635,7 @@ static const luaL_Reg w_Joystick_functions[] =
 	{ "getHat", w_Joystick_getHat },
 	{ "isDown", w_Joystick_isDown },
 	{ "setPlayerIndex", w_Joystick_setPlayerIndex },
+	{ "getState", w_Joystick_getState },
 	{ "getPlayerIndex", w_Joystick_getPlayerIndex },
 
 	{ "isGamepad", w_Joystick_isGamepad },
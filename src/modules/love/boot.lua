@@ -39,6 +39,21 @@ local no_game_code = false
 local invalid_game_path = nil
 local main_file = "main.lua"
 
+-- Time spent in each part of love.init, in order.
+local startuptimes = {}
+
+local function addstartuptime(name, starttime, lazy)
+	table.insert(startuptimes, {name = name, time = love._getTime() - starttime, lazy = lazy})
+end
+
+function love.getStartupTimes()
+	local times = {}
+	for i,v in ipairs(startuptimes) do
+		times[i] = {name = v.name, time = v.time, lazy = v.lazy}
+	end
+	return times
+end
+
 -- This can't be overridden.
 function love.boot()
 
@@ -175,17 +190,23 @@ function love.init()
 			fullscreentype = "desktop",
 			displayindex = 1,
 			vsync = 1,
+			presentmode = nil,
 			msaa = 0,
 			borderless = false,
 			resizable = false,
 			centered = true,
 			usedpiscale = true,
+			headless = false,
 		},
 		graphics = {
 			gammacorrect = false,
 			lowpower = false,
+			shadercache = false,
+			framesinflight = nil,
 			renderers = nil,
 			excluderenderers = nil,
+			statsoverlay = false,
+			statsoverlaykey = nil,
 		},
 		modules = {
 			data = true,
@@ -199,14 +220,15 @@ function love.init()
 			graphics = true,
 			audio = true,
 			math = true,
-			physics = true,
-			sensor = true,
+			physics = "lazy",
+			profiler = "lazy",
+			sensor = "lazy",
 			sound = true,
 			system = true,
 			font = true,
 			thread = true,
 			window = true,
-			video = true,
+			video = "lazy",
 		},
 		audio = {
 			mixwithsystem = true, -- Only relevant for Android / iOS.
@@ -232,6 +254,7 @@ function love.init()
 
 	-- If config file exists, load it and allow it to update config table.
 	local confok, conferr
+	local starttime = love._getTime()
 	if (not love.conf) and love.filesystem and love.filesystem.getInfo("conf.lua") then
 		confok, conferr = pcall(require, "conf")
 	end
@@ -243,6 +266,7 @@ function love.init()
 		-- If love.conf errors, we'll trigger the error after loading modules so
 		-- the error message can be displayed in the window.
 	end
+	addstartuptime("conf", starttime)
 
 	-- Console hack, part 2.
 	if c.console and love._openConsole and not openedconsole then
@@ -265,6 +289,14 @@ function love.init()
 		love._setLowPowerPreferred(c.graphics.lowpower)
 	end
 
+	if love._setShaderCacheEnabled and type(c.graphics) == "table" then
+		love._setShaderCacheEnabled(c.graphics.shadercache)
+	end
+
+	if love._setFramesInFlight and type(c.graphics) == "table" then
+		love._setFramesInFlight(c.graphics.framesinflight)
+	end
+
 	if love._setRenderers then
 		local renderers = love._getDefaultRenderers()
 		if type(c.renderers) == "table" then
@@ -316,6 +348,10 @@ function love.init()
 		love._setHighDPIAllowed(c.highdpi)
 	end
 
+	if love._setHeadless and type(c.window) == "table" then
+		love._setHeadless(c.window.headless)
+	end
+
 	if love._setTrackpadTouch then
 		love._setTrackpadTouch(c.trackpadtouch)
 	end
@@ -330,9 +366,12 @@ function love.init()
 		love._requestRecordingPermission(c.audio and c.audio.mic)
 	end
 
-	-- Gets desired modules.
+	-- Gets desired modules. Modules set to "lazy" are loaded the first time
+	-- they're accessed in the love table, instead of before the game starts.
+	local lazymodules = {}
 	for k,v in ipairs{
 		"data",
+		"profiler",
 		"thread",
 		"timer",
 		"event",
@@ -352,11 +391,29 @@ function love.init()
 		"math",
 		"physics",
 	} do
-		if c.modules[v] then
+		if c.modules[v] == "lazy" then
+			lazymodules[v] = true
+		elseif c.modules[v] then
+			starttime = love._getTime()
 			require("love." .. v)
+			addstartuptime("love." .. v, starttime)
 		end
 	end
 
+	if next(lazymodules) ~= nil then
+		setmetatable(love, {
+			__index = function(t, name)
+				if lazymodules[name] then
+					lazymodules[name] = nil
+					local lazystarttime = love._getTime()
+					require("love." .. name)
+					addstartuptime("love." .. name, lazystarttime, true)
+					return rawget(t, name)
+				end
+			end,
+		})
+	end
+
 	if love.event then
 		love.createhandlers()
 	end
@@ -382,6 +439,7 @@ function love.init()
 	end
 
 	-- Setup window here.
+	starttime = love._getTime()
 	if c.window and c.modules.window then
 		if c.window.icon then
 			assert(love.image, "If an icon is set in love.conf, love.image must be loaded.")
@@ -409,6 +467,17 @@ function love.init()
 			x = c.window.x,
 			y = c.window.y,
 		}), "Could not set window mode")
+
+		if c.window.presentmode then
+			love.window.setPresentMode(c.window.presentmode)
+		end
+	end
+	addstartuptime("window", starttime)
+
+	-- The default love.run draws the overlay and toggles it with the key.
+	if love.graphics and type(c.graphics) == "table" then
+		love.graphics.setStatsOverlayEnabled(c.graphics.statsoverlay == true)
+		love._statsoverlaykey = c.graphics.statsoverlaykey
 	end
 
 	-- The first couple event pumps on some systems (e.g. macOS) can take a
@@ -427,7 +496,9 @@ function love.init()
 		love.filesystem._setAndroidSaveExternal(c.externalstorage)
 		love.filesystem.setIdentity(c.identity or love.filesystem.getIdentity(), c.appendidentity)
 		if love.filesystem.getInfo(main_file) then
+			starttime = love._getTime()
 			require(main_file:gsub("%.lua$", ""))
+			addstartuptime("main", starttime)
 		end
 	end
 
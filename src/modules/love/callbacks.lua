@@ -122,6 +122,9 @@ function love.createhandlers()
 		directorydropped = function (dir, x, y)
 			if love.directorydropped then return love.directorydropped(dir, x, y) end
 		end,
+		filechanged = function (path, change)
+			if love.filechanged then return love.filechanged(path, change) end
+		end,
 		dropbegan = function ()
 			if love.dropbegan then return love.dropbegan() end
 		end,
@@ -162,6 +165,32 @@ end
 -- Default callbacks.
 -----------------------------------------------------------
 
+local lastphysicssteptime = 0
+
+-- Extra lines for love.graphics.drawStatsOverlay, from other modules.
+function love._getStatsOverlayLines()
+	local lines = {}
+
+	lines[#lines + 1] = string.format("lua memory %.1f MB", collectgarbage("count") / 1024)
+
+	local gc = love.getGCStats()
+	lines[#lines + 1] = string.format("gc pause %.2f ms (max %.2f ms)", gc.lastpause * 1000, gc.maxpause * 1000)
+
+	if love.audio then
+		lines[#lines + 1] = string.format("audio voices %d", love.audio.getActiveSourceCount())
+	end
+
+	-- Don't load love.physics just to show that it's unused.
+	local physics = rawget(love, "physics")
+	if physics then
+		local steptime = physics.getStepTime()
+		lines[#lines + 1] = string.format("physics %.2f ms", (steptime - lastphysicssteptime) * 1000)
+		lastphysicssteptime = steptime
+	end
+
+	return lines
+end
+
 function love.run()
 	if love.load then love.load(love.parsedGameArguments, love.rawGameArguments) end
 
@@ -170,35 +199,75 @@ function love.run()
 
 	-- Main loop time.
 	return function()
+		-- See love.graphics.setRedrawOnDemand.
+		local ondemand = love.graphics and love.graphics.isActive() and love.graphics.isRedrawOnDemand()
+
 		-- Process events.
 		if love.event then
-			love.event.pump()
+			-- When redrawing on demand, sleep until an event arrives or a
+			-- requested redraw is due.
+			local timeout = 0
+			if ondemand then timeout = love.graphics.getRedrawDelay() or -1 end
+
+			love.event.pump(timeout)
 			for name, a,b,c,d,e,f,g,h in love.event.poll() do
 				if name == "quit" then
 					if not love.quit or not love.quit() then
 						return a or 0, b
 					end
 				end
+				if ondemand then love.graphics.invalidate() end
+				if name == "keypressed" and love.graphics and a == love._statsoverlaykey then
+					love.graphics.setStatsOverlayEnabled(not love.graphics.isStatsOverlayEnabled())
+				end
 				love.handlers[name](a,b,c,d,e,f,g,h)
 			end
 		end
 
 		-- Update dt, as we'll be passing it to update
 		local dt = love.timer and love.timer.step() or 0
+		local framestart = love.timer and love.timer.getTime()
+		local busy = 0
 
 		-- Call update and draw
 		if love.update then love.update(dt) end -- will pass 0 if love.timer is disabled
 
-		if love.graphics and love.graphics.isActive() then
+		if love.graphics and love.graphics.isActive() and (not ondemand or love.graphics.getRedrawDelay() == 0) then
+			-- Anything invalidated from here on is drawn in the next frame.
+			love.graphics.validate()
+
+			-- The overlay reads the GPU time from the "frame" timer.
+			local overlay = love.graphics.isStatsOverlayEnabled()
+			local gputimed = overlay and love.graphics.getSupported().gputimestamps
+			if gputimed then love.graphics.pushGPUTimer("frame") end
+
 			love.graphics.origin()
 			love.graphics.clear(love.graphics.getBackgroundColor())
 
 			if love.draw then love.draw() end
 
+			-- Waiting for vsync in present isn't work the frame has to do.
+			if framestart then busy = love.timer.getTime() - framestart end
+
+			if gputimed then love.graphics.popGPUTimer() end
+			if overlay then love.graphics.drawStatsOverlay(busy, love._getStatsOverlayLines()) end
+
 			love.graphics.present()
+		elseif framestart then
+			busy = love.timer.getTime() - framestart
 		end
 
-		if love.timer then love.timer.sleep(0.001) end
+		-- Spend what's left of the frame budget (see love.setGCFrameBudget)
+		-- on incremental garbage collection.
+		if framestart then love._stepGC(busy) end
+
+		if love.timer then
+			if love.timer.getFrameLimit() > 0 then
+				love.timer.waitForNextFrame()
+			else
+				love.timer.sleep(0.001)
+			end
+		end
 	end
 end
 
@@ -240,13 +309,14 @@ function love.errorhandler(msg)
 			love.mouse.setCursor()
 		end
 	end
-	if love.joystick then
+	-- rawget, so modules set to be loaded lazily aren't loaded just for this.
+	if rawget(love, "joystick") then
 		-- Stop all joystick vibrations.
 		for i,v in ipairs(love.joystick.getJoysticks()) do
 			v:setVibration()
 		end
 	end
-	if love.audio then love.audio.stop() end
+	if rawget(love, "audio") then love.audio.stop() end
 
 	love.graphics.reset()
 	love.graphics.setFont(love.graphics.newFont(15))
@@ -22,6 +22,7 @@
 #include "common/config.h"
 #include "common/version.h"
 #include "common/deprecation.h"
+#include "common/memory.h"
 #include "common/runtime.h"
 #include "modules/window/Window.h"
 
@@ -30,6 +31,9 @@
 // C++
 #include <string>
 #include <sstream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
 
 #ifdef LOVE_WINDOWS
 #define WIN32_LEAN_AND_MEAN
@@ -144,6 +148,9 @@ extern "C"
 #if defined(LOVE_ENABLE_PHYSICS)
 	extern int luaopen_love_physics(lua_State*);
 #endif
+#if defined(LOVE_ENABLE_PROFILER)
+	extern int luaopen_love_profiler(lua_State*);
+#endif
 #if defined(LOVE_ENABLE_SENSOR)
 	extern int luaopen_love_sensor(lua_State*);
 #endif
@@ -216,6 +223,9 @@ static const luaL_Reg modules[] = {
 #if defined(LOVE_ENABLE_PHYSICS)
 	{ "love.physics", luaopen_love_physics },
 #endif
+#if defined(LOVE_ENABLE_PROFILER)
+	{ "love.profiler", luaopen_love_profiler },
+#endif
 #if defined(LOVE_ENABLE_SENSOR)
 	{ "love.sensor", luaopen_love_sensor },
 #endif
@@ -436,6 +446,22 @@ static int w__setLowPowerPreferred(lua_State *L)
 	return 0;
 }
 
+static int w__setShaderCacheEnabled(lua_State *L)
+{
+#ifdef LOVE_ENABLE_GRAPHICS
+	love::graphics::setShaderCacheEnabled(love::luax_checkboolean(L, 1));
+#endif
+	return 0;
+}
+
+static int w__setFramesInFlight(lua_State *L)
+{
+#ifdef LOVE_ENABLE_GRAPHICS
+	love::graphics::setFramesInFlight((int) luaL_optinteger(L, 1, 0));
+#endif
+	return 0;
+}
+
 static int w__setHighDPIAllowed(lua_State *L)
 {
 #ifdef LOVE_ENABLE_WINDOW
@@ -444,6 +470,14 @@ static int w__setHighDPIAllowed(lua_State *L)
 	return 0;
 }
 
+static int w__setHeadless(lua_State *L)
+{
+#ifdef LOVE_ENABLE_WINDOW
+	love::window::setHeadless((bool) lua_toboolean(L, 1));
+#endif
+	return 0;
+}
+
 static int w__setTrackpadTouch(lua_State *L)
 {
 #ifdef LOVE_ENABLE_TOUCH
@@ -509,6 +543,208 @@ static int w_love_hasDeprecationOutput(lua_State *L)
 	return 1;
 }
 
+static void luax_pushmemorystats(lua_State *L, const love::MemoryStats &stats)
+{
+	lua_createtable(L, 0, 3);
+
+	lua_pushnumber(L, (lua_Number) stats.current);
+	lua_setfield(L, -2, "current");
+
+	lua_pushnumber(L, (lua_Number) stats.peak);
+	lua_setfield(L, -2, "peak");
+
+	lua_pushnumber(L, (lua_Number) stats.allocations);
+	lua_setfield(L, -2, "allocations");
+}
+
+static int w_love_getMemoryStats(lua_State *L)
+{
+	if (!lua_isnoneornil(L, 1))
+	{
+		const char *name = luaL_checkstring(L, 1);
+		love::MemoryCategory category;
+		if (!love::getConstant(name, category))
+			return love::luax_enumerror(L, "memory category", love::getConstants(category), name);
+
+		love::MemoryStats stats = love::getMemoryStats(category);
+		lua_pushnumber(L, (lua_Number) stats.current);
+		lua_pushnumber(L, (lua_Number) stats.peak);
+		lua_pushnumber(L, (lua_Number) stats.allocations);
+		return 3;
+	}
+
+	lua_createtable(L, 0, (int) love::MEMORY_MAX_ENUM + 1);
+
+	for (int i = 0; i < (int) love::MEMORY_MAX_ENUM; i++)
+	{
+		love::MemoryCategory category = (love::MemoryCategory) i;
+		const char *name = nullptr;
+		if (!love::getConstant(category, name))
+			continue;
+
+		luax_pushmemorystats(L, love::getMemoryStats(category));
+		lua_setfield(L, -2, name);
+	}
+
+	// The Lua heap of the calling thread. Lua tracks this itself.
+	lua_createtable(L, 0, 1);
+	lua_pushnumber(L, (lua_Number) lua_gc(L, LUA_GCCOUNT, 0) * 1024.0 + lua_gc(L, LUA_GCCOUNTB, 0));
+	lua_setfield(L, -2, "current");
+	lua_setfield(L, -2, "lua");
+
+	return 1;
+}
+
+static int w_love_resetMemoryPeaks(lua_State *)
+{
+	love::resetMemoryPeaks();
+	return 0;
+}
+
+static double getSteadyTime()
+{
+	using namespace std::chrono;
+	return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Used by boot.lua to time startup before love.timer is loaded.
+static int w_love__getTime(lua_State *L)
+{
+	lua_pushnumber(L, getSteadyTime());
+	return 1;
+}
+
+// Incremental garbage collection steps taken in the idle part of each frame,
+// scheduled by love.run in the main thread.
+struct GCSchedulerStats
+{
+	double frameBudget = 0.0;
+	double time = 0.0;
+	double lastPause = 0.0;
+	double maxPause = 0.0;
+	lua_Number frames = 0;
+	lua_Number steps = 0;
+	lua_Number cycles = 0;
+};
+
+static GCSchedulerStats gcScheduler;
+
+static int w_love_setGCFrameBudget(lua_State *L)
+{
+	double budget = luaL_optnumber(L, 1, 0.0);
+	if (budget < 0.0)
+		return luaL_error(L, "The frame budget must not be negative.");
+	gcScheduler.frameBudget = budget;
+	return 0;
+}
+
+static int w_love_getGCFrameBudget(lua_State *L)
+{
+	if (gcScheduler.frameBudget <= 0.0)
+		lua_pushnil(L);
+	else
+		lua_pushnumber(L, gcScheduler.frameBudget);
+	return 1;
+}
+
+static int w_love_setGCMode(lua_State *L)
+{
+	const char *mode = luaL_checkstring(L, 1);
+
+	if (strcmp(mode, "incremental") == 0)
+	{
+#ifdef LUA_GCINC
+		lua_gc(L, LUA_GCINC, 0, 0, 0);
+#endif
+		love::luax_pushboolean(L, true);
+	}
+	else if (strcmp(mode, "generational") == 0)
+	{
+#ifdef LUA_GCGEN
+		lua_gc(L, LUA_GCGEN, 0, 0);
+		love::luax_pushboolean(L, true);
+#else
+		// Not available before Lua 5.4.
+		love::luax_pushboolean(L, false);
+#endif
+	}
+	else
+		return luaL_error(L, "Invalid garbage collector mode '%s', expected one of: 'incremental', 'generational'", mode);
+
+	return 1;
+}
+
+static int w_love__stepGC(lua_State *L)
+{
+	double busy = luaL_checknumber(L, 1);
+
+	if (gcScheduler.frameBudget <= 0.0)
+		return 0;
+
+	double remaining = gcScheduler.frameBudget - busy;
+	if (remaining <= 0.0)
+		return 0;
+
+	double start = getSteadyTime();
+	double end = start + remaining;
+	double now = start;
+
+	do
+	{
+		gcScheduler.steps++;
+		if (lua_gc(L, LUA_GCSTEP, 0) != 0)
+		{
+			// Don't start the next cycle until the next frame.
+			gcScheduler.cycles++;
+			now = getSteadyTime();
+			break;
+		}
+		now = getSteadyTime();
+	}
+	while (now < end);
+
+	double pause = now - start;
+	gcScheduler.frames++;
+	gcScheduler.time += pause;
+	gcScheduler.lastPause = pause;
+	gcScheduler.maxPause = std::max(gcScheduler.maxPause, pause);
+
+	return 0;
+}
+
+static int w_love_getGCStats(lua_State *L)
+{
+	lua_createtable(L, 0, 6);
+
+	lua_pushnumber(L, gcScheduler.frames);
+	lua_setfield(L, -2, "frames");
+
+	lua_pushnumber(L, gcScheduler.steps);
+	lua_setfield(L, -2, "steps");
+
+	lua_pushnumber(L, gcScheduler.cycles);
+	lua_setfield(L, -2, "cycles");
+
+	lua_pushnumber(L, gcScheduler.time);
+	lua_setfield(L, -2, "time");
+
+	lua_pushnumber(L, gcScheduler.lastPause);
+	lua_setfield(L, -2, "lastpause");
+
+	lua_pushnumber(L, gcScheduler.maxPause);
+	lua_setfield(L, -2, "maxpause");
+
+	return 1;
+}
+
+static int w_love_resetGCStats(lua_State *)
+{
+	double budget = gcScheduler.frameBudget;
+	gcScheduler = GCSchedulerStats();
+	gcScheduler.frameBudget = budget;
+	return 0;
+}
+
 static int w_deprecation__gc(lua_State *)
 {
 	love::deinitDeprecation();
@@ -580,9 +816,18 @@ int luaopen_love(lua_State *L)
 	lua_pushcfunction(L, w__setLowPowerPreferred);
 	lua_setfield(L, -2, "_setLowPowerPreferred");
 
+	lua_pushcfunction(L, w__setShaderCacheEnabled);
+	lua_setfield(L, -2, "_setShaderCacheEnabled");
+
+	lua_pushcfunction(L, w__setFramesInFlight);
+	lua_setfield(L, -2, "_setFramesInFlight");
+
 	lua_pushcfunction(L, w__setHighDPIAllowed);
 	lua_setfield(L, -2, "_setHighDPIAllowed");
 
+	lua_pushcfunction(L, w__setHeadless);
+	lua_setfield(L, -2, "_setHeadless");
+
 	lua_pushcfunction(L, w__setTrackpadTouch);
 	lua_setfield(L, -2, "_setTrackpadTouch");
 
@@ -609,6 +854,33 @@ int luaopen_love(lua_State *L)
 	lua_pushcfunction(L, w_love_isVersionCompatible);
 	lua_setfield(L, -2, "isVersionCompatible");
 
+	lua_pushcfunction(L, w_love_getMemoryStats);
+	lua_setfield(L, -2, "getMemoryStats");
+
+	lua_pushcfunction(L, w_love_resetMemoryPeaks);
+	lua_setfield(L, -2, "resetMemoryPeaks");
+
+	lua_pushcfunction(L, w_love_setGCFrameBudget);
+	lua_setfield(L, -2, "setGCFrameBudget");
+
+	lua_pushcfunction(L, w_love_getGCFrameBudget);
+	lua_setfield(L, -2, "getGCFrameBudget");
+
+	lua_pushcfunction(L, w_love_setGCMode);
+	lua_setfield(L, -2, "setGCMode");
+
+	lua_pushcfunction(L, w_love__getTime);
+	lua_setfield(L, -2, "_getTime");
+
+	lua_pushcfunction(L, w_love__stepGC);
+	lua_setfield(L, -2, "_stepGC");
+
+	lua_pushcfunction(L, w_love_getGCStats);
+	lua_setfield(L, -2, "getGCStats");
+
+	lua_pushcfunction(L, w_love_resetGCStats);
+	lua_setfield(L, -2, "resetGCStats");
+
 #ifdef LOVE_ENABLE_SYSTEM
 	lua_pushstring(L, love::system::System::getOS());
 #else
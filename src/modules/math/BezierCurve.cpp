@@ -79,6 +79,68 @@ void subdivide(vector<love::Vector2> &points, int k)
 		points[i-1 + left.size() - 1] = right[right.size() - i - 1];
 }
 
+// Deepest subdivision of renderAdaptive, at most 2^16 segments.
+const int MAX_ADAPTIVE_DEPTH = 16;
+
+/**
+ * Adaptive subdivision. Splits the n control points in half with de casteljau
+ * until all of them are within tolerance of the segment between the
+ * endpoints. The curve lies in the convex hull of its control points, so that
+ * bounds the distance of the curve from the segment. Appends every point
+ * except the first. scratch holds 2 * n points per depth level.
+ **/
+void subdivideAdaptive(const love::Vector2 *points, size_t n, float toleranceSq, int depth, love::Vector2 *scratch, vector<love::Vector2> &out)
+{
+	const love::Vector2 &first = points[0];
+	const love::Vector2 &last = points[n - 1];
+
+	love::Vector2 chord = last - first;
+	float chordLengthSq = chord.x * chord.x + chord.y * chord.y;
+
+	bool flat = true;
+	for (size_t i = 1; i + 1 < n && flat; i++)
+	{
+		// Distance to the chord segment rather than its line, so curves that
+		// double back past an endpoint still get split.
+		love::Vector2 d = points[i] - first;
+		float t = chordLengthSq > 0.0f ? (d.x * chord.x + d.y * chord.y) / chordLengthSq : 0.0f;
+		t = std::min(std::max(t, 0.0f), 1.0f);
+		love::Vector2 offset = d - chord * t;
+		float distSq = offset.x * offset.x + offset.y * offset.y;
+
+		flat = distSq <= toleranceSq;
+	}
+
+	if (flat || depth >= MAX_ADAPTIVE_DEPTH)
+	{
+		out.push_back(last);
+		return;
+	}
+
+	love::Vector2 *left = scratch;
+	love::Vector2 *right = scratch + n;
+	love::Vector2 *next = scratch + 2 * n;
+
+	// Split at t = 0.5 with the same scheme as subdivide(). The next level's
+	// scratch space holds the intermediate points until it's needed.
+	love::Vector2 *column = next;
+	for (size_t i = 0; i < n; i++)
+		column[i] = points[i];
+
+	left[0] = column[0];
+	right[n - 1] = column[n - 1];
+	for (size_t step = 1; step < n; ++step)
+	{
+		for (size_t i = 0; i < n - step; ++i)
+			column[i] = (column[i] + column[i+1]) * .5;
+		left[step] = column[0];
+		right[n - 1 - step] = column[n - 1 - step];
+	}
+
+	subdivideAdaptive(left, n, toleranceSq, depth + 1, next, out);
+	subdivideAdaptive(right, n, toleranceSq, depth + 1, next, out);
+}
+
 }
 
 namespace love
@@ -90,7 +152,14 @@ love::Type BezierCurve::type("BezierCurve", &Object::type);
 
 BezierCurve::BezierCurve(const vector<Vector2> &pts)
 	: controlPoints(pts)
+	, adaptiveTolerance(-1.0f)
+{
+}
+
+void BezierCurve::invalidate()
 {
+	adaptiveTolerance = -1.0f;
+	adaptivePoints.clear();
 }
 
 
@@ -134,6 +203,7 @@ void BezierCurve::setControlPoint(int i, const Vector2 &point)
 		i -= controlPoints.size();
 
 	controlPoints[i] = point;
+	invalidate();
 }
 
 void BezierCurve::insertControlPoint(const Vector2 &point, int i)
@@ -148,6 +218,7 @@ void BezierCurve::insertControlPoint(const Vector2 &point, int i)
 		i -= controlPoints.size();
 
 	controlPoints.insert(controlPoints.begin() + i, point);
+	invalidate();
 }
 
 void BezierCurve::removeControlPoint(int i)
@@ -162,12 +233,14 @@ void BezierCurve::removeControlPoint(int i)
 		i -= controlPoints.size();
 
 	controlPoints.erase(controlPoints.begin() + i);
+	invalidate();
 }
 
 void BezierCurve::translate(const Vector2 &t)
 {
 	for (size_t i = 0; i < controlPoints.size(); ++i)
 		controlPoints[i] += t;
+	invalidate();
 }
 
 void BezierCurve::rotate(double phi, const Vector2 &center)
@@ -179,12 +252,14 @@ void BezierCurve::rotate(double phi, const Vector2 &center)
 		controlPoints[i].x = c * v.x - s * v.y + center.x;
 		controlPoints[i].y = s * v.x + c * v.y + center.y;
 	}
+	invalidate();
 }
 
 void BezierCurve::scale(double s, const Vector2 &center)
 {
 	for (size_t i = 0; i < controlPoints.size(); ++i)
 		controlPoints[i] = (controlPoints[i] - center) * s + center;
+	invalidate();
 }
 
 Vector2 BezierCurve::evaluate(double t) const
@@ -275,5 +350,53 @@ vector<Vector2> BezierCurve::renderSegment(double start, double end, int accurac
 	return vertices;
 }
 
+const vector<Vector2> &BezierCurve::renderAdaptive(float tolerance) const
+{
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+	if (!(tolerance > 0.0f))
+		throw Exception("Invalid tolerance: must be greater than 0.");
+
+	if (tolerance == adaptiveTolerance)
+		return adaptivePoints;
+
+	size_t n = controlPoints.size();
+	vector<Vector2> scratch(2 * n * (MAX_ADAPTIVE_DEPTH + 2));
+
+	adaptivePoints.clear();
+	adaptivePoints.push_back(controlPoints[0]);
+	subdivideAdaptive(controlPoints.data(), n, tolerance * tolerance, 0, scratch.data(), adaptivePoints);
+
+	adaptiveTolerance = tolerance;
+	return adaptivePoints;
+}
+
+void BezierCurve::evaluate(double start, double end, int count, float *dst) const
+{
+	if (start < 0 || start > 1 || end < 0 || end > 1)
+		throw Exception("Invalid evaluation parameter: must be between 0 and 1");
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+
+	// de casteljau, reusing one buffer for every point.
+	size_t n = controlPoints.size();
+	vector<Vector2> points(n);
+
+	for (int p = 0; p < count; p++)
+	{
+		double t = count > 1 ? start + (end - start) * p / (count - 1) : start;
+
+		for (size_t i = 0; i < n; i++)
+			points[i] = controlPoints[i];
+
+		for (size_t step = 1; step < n; ++step)
+			for (size_t i = 0; i < n - step; ++i)
+				points[i] = points[i] * (1-t) + points[i+1] * t;
+
+		dst[p * 2 + 0] = points[0].x;
+		dst[p * 2 + 1] = points[0].y;
+	}
+}
+
 } // namespace math
 } // namespace love
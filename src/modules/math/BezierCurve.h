@@ -140,8 +140,33 @@ public:
 	 **/
 	std::vector<Vector2> renderSegment(double start, double end, int accuracy = 4) const;
 
+	/**
+	 * Renders the curve by adaptive subdivision: parts of the curve are split
+	 * until their control polygon is within tolerance of a straight line, so
+	 * flat parts get few points and sharp bends get many. The result is
+	 * cached until the control points or the tolerance change.
+	 * @param tolerance Maximum distance between the curve and the polygon
+	 *        chain, in the same units as the control points. To get a
+	 *        screen-space tolerance, divide it by the curve's drawing scale.
+	 * @returns A polygon chain that approximates the bezier curve.
+	 **/
+	const std::vector<Vector2> &renderAdaptive(float tolerance) const;
+
+	/**
+	 * Evaluates the curve at count evenly spaced times between start and end
+	 * (inclusive), writing count x,y pairs to dst.
+	 **/
+	void evaluate(double start, double end, int count, float *dst) const;
+
 private:
+
+	void invalidate();
+
 	std::vector<Vector2> controlPoints;
+
+	// Cached result of renderAdaptive. A negative tolerance means it's stale.
+	mutable std::vector<Vector2> adaptivePoints;
+	mutable float adaptiveTolerance;
 };
 
 }
@@ -60,6 +60,17 @@ struct Triangle
  **/
 std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
 
+/**
+ * Triangulate a simple polygon with holes, writing indices into the vertex
+ * list instead of copying the vertices.
+ *
+ * @param points Vertices of the polygon, followed by the vertices of each hole.
+ * @param holeStarts Index in points of the first vertex of each hole, in
+ *        increasing order. Empty if the polygon has no holes.
+ * @param indices Receives 3 indices into points for each triangle.
+ **/
+void triangulate(const std::vector<love::Vector2> &points, const std::vector<size_t> &holeStarts, std::vector<uint32> &indices);
+
 /**
  * Checks whether a polygon is convex.
  *
@@ -0,0 +1,353 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "NoiseGrid.h"
+#include "common/config.h"
+#include "thread/JobSystem.h"
+
+// Noise
+#include "libraries/noise1234/noise1234.h"
+#include "libraries/noise1234/simplexnoise1234.h"
+
+// STL
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#elif defined(LOVE_SIMD_NEON)
+#	define LOVE_NOISEGRID_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace math
+{
+
+namespace
+{
+
+// Four float lanes. The noise functions below are written once against these
+// helpers; only the lattice hashing (a table lookup per lane) is scalar.
+
+#if defined(LOVE_SIMD_SSE2)
+
+typedef __m128 vfloat;
+
+inline vfloat vload(const float *p) { return _mm_loadu_ps(p); }
+inline void vstore(float *p, vfloat v) { _mm_storeu_ps(p, v); }
+inline vfloat vset(float f) { return _mm_set1_ps(f); }
+inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+inline vfloat vmax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+
+// 1 in the lanes where a > b, 0 elsewhere.
+inline vfloat vgreater(vfloat a, vfloat b) { return _mm_and_ps(_mm_cmpgt_ps(a, b), _mm_set1_ps(1.0f)); }
+
+inline vfloat vfloor(vfloat v)
+{
+	vfloat t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+	return _mm_sub_ps(t, vgreater(t, v));
+}
+
+#elif defined(LOVE_NOISEGRID_NEON)
+
+typedef float32x4_t vfloat;
+
+inline vfloat vload(const float *p) { return vld1q_f32(p); }
+inline void vstore(float *p, vfloat v) { vst1q_f32(p, v); }
+inline vfloat vset(float f) { return vdupq_n_f32(f); }
+inline vfloat vadd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+inline vfloat vsub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+inline vfloat vmul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+inline vfloat vmax(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+
+inline vfloat vgreater(vfloat a, vfloat b)
+{
+	uint32x4_t mask = vcgtq_f32(a, b);
+	return vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+}
+
+inline vfloat vfloor(vfloat v)
+{
+	vfloat t = vcvtq_f32_s32(vcvtq_s32_f32(v));
+	return vsubq_f32(t, vgreater(t, v));
+}
+
+#else
+
+struct vfloat
+{
+	float v[4];
+};
+
+inline vfloat vload(const float *p) { vfloat r; for (int i = 0; i < 4; i++) r.v[i] = p[i]; return r; }
+inline void vstore(float *p, vfloat v) { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+inline vfloat vset(float f) { vfloat r; for (int i = 0; i < 4; i++) r.v[i] = f; return r; }
+inline vfloat vadd(vfloat a, vfloat b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+inline vfloat vsub(vfloat a, vfloat b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+inline vfloat vmul(vfloat a, vfloat b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+inline vfloat vmax(vfloat a, vfloat b) { for (int i = 0; i < 4; i++) a.v[i] = std::max(a.v[i], b.v[i]); return a; }
+inline vfloat vgreater(vfloat a, vfloat b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] > b.v[i] ? 1.0f : 0.0f; return a; }
+inline vfloat vfloor(vfloat v) { for (int i = 0; i < 4; i++) v.v[i] = std::floor(v.v[i]); return v; }
+
+#endif
+
+inline vfloat vmadd(vfloat a, vfloat b, vfloat c)
+{
+	return vadd(vmul(a, b), c);
+}
+
+// The 8 gradient directions of noise1234's 2D grad(hash, x, y), indexed by
+// hash & 7, so each grad() becomes gx * x + gy * y.
+const float gradX[8] = { 1.0f, -1.0f,  1.0f, -1.0f, 2.0f,  2.0f, -2.0f, -2.0f };
+const float gradY[8] = { 2.0f,  2.0f, -2.0f, -2.0f, 1.0f, -1.0f,  1.0f, -1.0f };
+
+struct Gradients
+{
+	float x[4];
+	float y[4];
+
+	inline void set(int lane, int hash)
+	{
+		x[lane] = gradX[hash & 7];
+		y[lane] = gradY[hash & 7];
+	}
+
+	inline vfloat dot(vfloat px, vfloat py) const
+	{
+		return vmadd(vload(x), px, vmul(vload(y), py));
+	}
+};
+
+// Noise1234::noise(x, y) without the 0.507 scale.
+vfloat perlin2(vfloat x, vfloat y)
+{
+	const unsigned char *perm = Noise1234::getPermutation();
+	const vfloat one = vset(1.0f);
+
+	vfloat fx = vfloor(x);
+	vfloat fy = vfloor(y);
+
+	vfloat x0 = vsub(x, fx);
+	vfloat y0 = vsub(y, fy);
+	vfloat x1 = vsub(x0, one);
+	vfloat y1 = vsub(y0, one);
+
+	float cellx[4], celly[4];
+	vstore(cellx, fx);
+	vstore(celly, fy);
+
+	Gradients g00, g01, g10, g11;
+	for (int i = 0; i < 4; i++)
+	{
+		int ix0 = (int) cellx[i] & 0xFF;
+		int iy0 = (int) celly[i] & 0xFF;
+		int ix1 = (ix0 + 1) & 0xFF;
+		int iy1 = (iy0 + 1) & 0xFF;
+
+		g00.set(i, perm[ix0 + perm[iy0]]);
+		g01.set(i, perm[ix0 + perm[iy1]]);
+		g10.set(i, perm[ix1 + perm[iy0]]);
+		g11.set(i, perm[ix1 + perm[iy1]]);
+	}
+
+	// t * t * t * (t * (t * 6 - 15) + 10)
+	const vfloat six = vset(6.0f);
+	const vfloat minus15 = vset(-15.0f);
+	const vfloat ten = vset(10.0f);
+	vfloat s = vmul(vmul(vmul(x0, x0), x0), vmadd(x0, vmadd(x0, six, minus15), ten));
+	vfloat t = vmul(vmul(vmul(y0, y0), y0), vmadd(y0, vmadd(y0, six, minus15), ten));
+
+	vfloat n00 = g00.dot(x0, y0);
+	vfloat n01 = g01.dot(x0, y1);
+	vfloat n10 = g10.dot(x1, y0);
+	vfloat n11 = g11.dot(x1, y1);
+
+	vfloat n0 = vmadd(t, vsub(n01, n00), n00);
+	vfloat n1 = vmadd(t, vsub(n11, n10), n10);
+	return vmadd(s, vsub(n1, n0), n0);
+}
+
+// SimplexNoise1234::noise(x, y) without the 45.23 scale.
+vfloat simplex2(vfloat x, vfloat y)
+{
+	const unsigned char *perm = SimplexNoise1234::getPermutation();
+	const float F2 = 0.366025403f;
+	const float G2 = 0.211324865f;
+	const vfloat one = vset(1.0f);
+	const vfloat half = vset(0.5f);
+	const vfloat zero = vset(0.0f);
+
+	vfloat skew = vmul(vadd(x, y), vset(F2));
+	vfloat fi = vfloor(vadd(x, skew));
+	vfloat fj = vfloor(vadd(y, skew));
+
+	vfloat unskew = vmul(vadd(fi, fj), vset(G2));
+	vfloat x0 = vsub(x, vsub(fi, unskew));
+	vfloat y0 = vsub(y, vsub(fj, unskew));
+
+	// Offsets of the middle corner: (1, 0) in the lower triangle, (0, 1) in
+	// the upper one.
+	vfloat i1 = vgreater(x0, y0);
+	vfloat j1 = vsub(one, i1);
+
+	vfloat x1 = vadd(vsub(x0, i1), vset(G2));
+	vfloat y1 = vadd(vsub(y0, j1), vset(G2));
+	vfloat x2 = vadd(x0, vset(-1.0f + 2.0f * G2));
+	vfloat y2 = vadd(y0, vset(-1.0f + 2.0f * G2));
+
+	float celli[4], cellj[4], lower[4];
+	vstore(celli, fi);
+	vstore(cellj, fj);
+	vstore(lower, i1);
+
+	Gradients g0, g1, g2;
+	for (int i = 0; i < 4; i++)
+	{
+		int ii = (int) celli[i] & 0xFF;
+		int jj = (int) cellj[i] & 0xFF;
+		int di = lower[i] > 0.0f ? 1 : 0;
+
+		g0.set(i, perm[ii + perm[jj]]);
+		g1.set(i, perm[ii + di + perm[jj + 1 - di]]);
+		g2.set(i, perm[ii + 1 + perm[jj + 1]]);
+	}
+
+	// Each corner contributes max(0.5 - x*x - y*y, 0)^4 * grad.
+	vfloat t0 = vmax(vsub(half, vmadd(x0, x0, vmul(y0, y0))), zero);
+	vfloat t1 = vmax(vsub(half, vmadd(x1, x1, vmul(y1, y1))), zero);
+	vfloat t2 = vmax(vsub(half, vmadd(x2, x2, vmul(y2, y2))), zero);
+	t0 = vmul(t0, t0);
+	t1 = vmul(t1, t1);
+	t2 = vmul(t2, t2);
+
+	vfloat n = vmul(vmul(t0, t0), g0.dot(x0, y0));
+	n = vmadd(vmul(t1, t1), g1.dot(x1, y1), n);
+	n = vmadd(vmul(t2, t2), g2.dot(x2, y2), n);
+	return n;
+}
+
+struct Octave
+{
+	double frequency;
+	float amplitude;
+};
+
+// Rows handed to each job.
+const int ROWS_PER_JOB = 16;
+
+// Grids with fewer samples than this aren't worth splitting between threads.
+const int MIN_PARALLEL_SAMPLES = 64 * 64;
+
+} // anonymous namespace
+
+void generateNoiseGrid(const NoiseGridSettings &settings, int width, int height, const std::function<void(int y, const float *row)> &writeRow)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	auto noise = settings.type == NOISE_PERLIN ? perlin2 : simplex2;
+	float noiseScale = settings.type == NOISE_PERLIN ? 0.507f : 45.23f;
+
+	int octaveCount = std::max(settings.octaves, 1);
+	std::vector<Octave> octaves(octaveCount);
+
+	double frequency = 1.0;
+	double amplitude = 1.0;
+	double amplitudeSum = 0.0;
+	for (Octave &octave : octaves)
+	{
+		octave.frequency = frequency;
+		octave.amplitude = (float) amplitude;
+		amplitudeSum += amplitude;
+		frequency *= settings.lacunarity;
+		amplitude *= settings.persistence;
+	}
+
+	// Maps the summed octaves from [-1, 1] to [0, 1].
+	float normalize = amplitudeSum != 0.0 ? (float) (0.5 / amplitudeSum) : 0.0f;
+	for (Octave &octave : octaves)
+		octave.amplitude *= noiseScale * normalize;
+
+	// Every row samples the same x coordinates, so they're computed once per
+	// octave, in double precision so large offsets don't drift across the row.
+	int paddedWidth = (width + 3) & ~3;
+	std::vector<float> columns(paddedWidth * octaveCount);
+	for (int o = 0; o < octaveCount; o++)
+	{
+		float *xs = &columns[o * paddedWidth];
+		for (int i = 0; i < paddedWidth; i++)
+			xs[i] = (float) ((settings.x + i * settings.scaleX) * octaves[o].frequency);
+	}
+
+	auto generateRows = [&](int firstrow, int lastrow)
+	{
+		std::vector<float> row(paddedWidth);
+
+		for (int y = firstrow; y < lastrow; y++)
+		{
+			double rowy = settings.y + y * settings.scaleY;
+
+			for (int i = 0; i < paddedWidth; i += 4)
+			{
+				vfloat total = vset(0.5f);
+
+				for (int o = 0; o < octaveCount; o++)
+				{
+					vfloat xs = vload(&columns[o * paddedWidth + i]);
+					vfloat ys = vset((float) (rowy * octaves[o].frequency));
+					total = vmadd(noise(xs, ys), vset(octaves[o].amplitude), total);
+				}
+
+				vstore(&row[i], total);
+			}
+
+			writeRow(y, row.data());
+		}
+	};
+
+	if ((long long) width * height < MIN_PARALLEL_SAMPLES)
+	{
+		generateRows(0, height);
+		return;
+	}
+
+	int jobs = (height + ROWS_PER_JOB - 1) / ROWS_PER_JOB;
+
+	love::thread::JobSystemRef jobSystem;
+	jobSystem->runParallel(jobs, [&](int i)
+	{
+		generateRows(i * ROWS_PER_JOB, std::min((i + 1) * ROWS_PER_JOB, height));
+	});
+}
+
+STRINGMAP_BEGIN(NoiseType, NOISE_MAX_ENUM, noiseType)
+{
+	{ "simplex", NOISE_SIMPLEX },
+	{ "perlin",  NOISE_PERLIN  },
+}
+STRINGMAP_END(NoiseType, NOISE_MAX_ENUM, noiseType)
+
+} // math
+} // love
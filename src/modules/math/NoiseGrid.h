@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_MATH_NOISE_GRID_H
+#define LOVE_MATH_NOISE_GRID_H
+
+// LOVE
+#include "common/StringMap.h"
+
+// STL
+#include <functional>
+
+namespace love
+{
+namespace math
+{
+
+enum NoiseType
+{
+	NOISE_SIMPLEX,
+	NOISE_PERLIN,
+	NOISE_MAX_ENUM
+};
+
+struct NoiseGridSettings
+{
+	NoiseType type = NOISE_SIMPLEX;
+
+	// Noise coordinates of the first sample.
+	double x = 0.0;
+	double y = 0.0;
+
+	// Distance in noise coordinates between neighbouring samples.
+	double scaleX = 1.0 / 16.0;
+	double scaleY = 1.0 / 16.0;
+
+	int octaves = 1;
+
+	// Frequency and amplitude multipliers applied for each additional octave.
+	double lacunarity = 2.0;
+	double persistence = 0.5;
+};
+
+/**
+ * Samples 2D fractal noise on a width x height grid. Every octave is summed
+ * and the total is normalized to [0, 1], so a single octave matches the
+ * values of simplexNoise2 and perlinNoise2 (within float precision).
+ *
+ * Rows are computed 4 samples at a time using SSE2 or NEON when available,
+ * and large grids are split between the shared job system's threads.
+ *
+ * @param writeRow Called once for every row with its width samples. It may
+ *        be called from several threads at once, for different rows.
+ **/
+void generateNoiseGrid(const NoiseGridSettings &settings, int width, int height, const std::function<void(int y, const float *row)> &writeRow);
+
+STRINGMAP_DECLARE(NoiseType);
+
+} // math
+} // love
+
+#endif // LOVE_MATH_NOISE_GRID_H
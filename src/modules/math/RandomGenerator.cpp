@@ -19,10 +19,13 @@
  **/
 
 #include "RandomGenerator.h"
+#include "thread/JobSystem.h"
 
 // C++
 #include <sstream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 
 // C
 #include <cmath>
@@ -47,11 +50,91 @@ static uint64 wangHash64(uint64 key)
 	return key;
 }
 
-love::Type RandomGenerator::type("RandomGenerator", &Object::type);
-
 // 64 bit Xorshift implementation taken from the end of Sec. 3 (page 4) in
 // George Marsaglia, "Xorshift RNGs", Journal of Statistical Software, Vol.8 (Issue 14), 2003
 // Use an 'Xorshift*' variant, as shown here: http://xorshift.di.unimi.it
+static inline uint64 xorshiftStar(uint64 &state)
+{
+	state ^= (state >> 12);
+	state ^= (state << 25);
+	state ^= (state >> 27);
+	return state * 2685821657736338717ULL;
+}
+
+static inline double toDouble(uint64 r)
+{
+	// From http://xoroshiro.di.unimi.it
+	union { uint64 i; double d; } u;
+	u.i = ((0x3FFULL) << 52) | (r >> 12);
+
+	return u.d - 1.0;
+}
+
+// The xorshift state update is linear over GF(2), so n steps of it can be
+// expressed as a 64x64 bit matrix. Column i holds the result of advancing a
+// state which only has bit i set.
+struct StepMatrix
+{
+	uint64 columns[64];
+
+	uint64 apply(uint64 state) const
+	{
+		uint64 result = 0;
+		for (int i = 0; state != 0; i++, state >>= 1)
+		{
+			if (state & 1)
+				result ^= columns[i];
+		}
+		return result;
+	}
+
+	StepMatrix operator * (const StepMatrix &other) const
+	{
+		StepMatrix m;
+		for (int i = 0; i < 64; i++)
+			m.columns[i] = apply(other.columns[i]);
+		return m;
+	}
+};
+
+static StepMatrix getStepMatrix()
+{
+	StepMatrix m;
+	for (int i = 0; i < 64; i++)
+	{
+		uint64 state = 1ULL << i;
+		xorshiftStar(state);
+		m.columns[i] = state;
+	}
+	return m;
+}
+
+static StepMatrix getAdvanceMatrix(uint64 steps)
+{
+	StepMatrix result;
+	for (int i = 0; i < 64; i++)
+		result.columns[i] = 1ULL << i;
+
+	// Powers of the same matrix commute, so they can be multiplied in any order.
+	StepMatrix power = getStepMatrix();
+	for (; steps != 0; steps >>= 1)
+	{
+		if (steps & 1)
+			result = result * power;
+		if (steps > 1)
+			power = power * power;
+	}
+
+	return result;
+}
+
+// Values generated by each job when fill is split between threads.
+static const size_t FILL_VALUES_PER_JOB = 16384;
+
+// Arrays smaller than this are filled on the calling thread.
+static const size_t FILL_MIN_PARALLEL_VALUES = FILL_VALUES_PER_JOB * 4;
+
+love::Type RandomGenerator::type("RandomGenerator", &Object::type);
 
 RandomGenerator::RandomGenerator()
 	: last_randomnormal(std::numeric_limits<double>::infinity())
@@ -66,10 +149,7 @@ RandomGenerator::RandomGenerator()
 
 uint64 RandomGenerator::rand()
 {
-	rng_state.b64 ^= (rng_state.b64 >> 12);
-	rng_state.b64 ^= (rng_state.b64 << 25);
-	rng_state.b64 ^= (rng_state.b64 >> 27);
-	return rng_state.b64 * 2685821657736338717ULL;
+	return xorshiftStar(rng_state.b64);
 }
 
 // Box–Muller transform
@@ -90,6 +170,104 @@ double RandomGenerator::randomNormal(double stddev)
 	return r * sin(phi) * stddev;
 }
 
+void RandomGenerator::fill(Distribution distribution, double a, double b, void *dst, size_t count)
+{
+	if (count == 0)
+		return;
+
+	float *floats = (float *) dst;
+	int32 *ints = (int32 *) dst;
+
+	// Normal values are generated in pairs from two uniform values, the same
+	// way randomNormal produces and caches them.
+	if (distribution == DISTRIBUTION_NORMAL && last_randomnormal != std::numeric_limits<double>::infinity())
+	{
+		floats[0] = (float) (randomNormal(a) + b);
+		floats++;
+		count--;
+	}
+
+	size_t valuesPerStep = distribution == DISTRIBUTION_NORMAL ? 2 : 1;
+	size_t values = count - count % valuesPerStep;
+
+	// Returns the state after the last generated value.
+	auto generate = [&](uint64 state, size_t first, size_t last) -> uint64
+	{
+		switch (distribution)
+		{
+		case DISTRIBUTION_UNIFORM:
+		default:
+		{
+			// Rounding to float can land on the excluded upper bound.
+			bool clamp = b > a;
+			float fmax = (float) b;
+			float below = std::nextafter(fmax, (float) a);
+			for (size_t i = first; i < last; i++)
+			{
+				float v = (float) (toDouble(xorshiftStar(state)) * (b - a) + a);
+				floats[i] = clamp && v >= fmax ? below : v;
+			}
+			break;
+		}
+		case DISTRIBUTION_NORMAL:
+			for (size_t i = first; i < last; i += 2)
+			{
+				double r   = sqrt(-2.0 * log(1. - toDouble(xorshiftStar(state))));
+				double phi = 2.0 * LOVE_M_PI * (1. - toDouble(xorshiftStar(state)));
+				floats[i + 0] = (float) (r * sin(phi) * a + b);
+				floats[i + 1] = (float) (r * cos(phi) * a + b);
+			}
+			break;
+		case DISTRIBUTION_INTEGER:
+			for (size_t i = first; i < last; i++)
+				ints[i] = (int32) (floor(toDouble(xorshiftStar(state)) * (b - a + 1)) + a);
+			break;
+		}
+
+		return state;
+	};
+
+	if (values < FILL_MIN_PARALLEL_VALUES)
+		rng_state.b64 = generate(rng_state.b64, 0, values);
+	else
+	{
+		// Every job starts from the state the sequence would have reached by
+		// its first value, so the result matches a single-threaded fill.
+		static const StepMatrix jobMatrix = getAdvanceMatrix(FILL_VALUES_PER_JOB);
+
+		int jobs = (int) ((values + FILL_VALUES_PER_JOB - 1) / FILL_VALUES_PER_JOB);
+		std::vector<uint64> states(jobs);
+		states[0] = rng_state.b64;
+		for (int i = 1; i < jobs; i++)
+			states[i] = jobMatrix.apply(states[i - 1]);
+
+		love::thread::JobSystemRef jobSystem;
+		jobSystem->runParallel(jobs, [&](int i)
+		{
+			size_t first = i * FILL_VALUES_PER_JOB;
+			uint64 endstate = generate(states[i], first, std::min(first + FILL_VALUES_PER_JOB, values));
+			if (i == jobs - 1)
+				rng_state.b64 = endstate;
+		});
+	}
+
+	// An odd number of normal values leaves the second value of the last
+	// pair cached, just like randomNormal.
+	if (values < count)
+		floats[values] = (float) (randomNormal(a) + b);
+}
+
+void RandomGenerator::advance(uint64 steps)
+{
+	rng_state.b64 = getAdvanceMatrix(steps).apply(rng_state.b64);
+}
+
+void RandomGenerator::jump()
+{
+	static const StepMatrix jumpMatrix = getAdvanceMatrix(1ULL << 48);
+	rng_state.b64 = jumpMatrix.apply(rng_state.b64);
+}
+
 void RandomGenerator::setSeed(RandomGenerator::Seed newseed)
 {
 	seed = newseed;
@@ -145,5 +323,13 @@ std::string RandomGenerator::getState() const
 	return ss.str();
 }
 
+STRINGMAP_CLASS_BEGIN(RandomGenerator, RandomGenerator::Distribution, RandomGenerator::DISTRIBUTION_MAX_ENUM, distribution)
+{
+	{ "uniform", RandomGenerator::DISTRIBUTION_UNIFORM },
+	{ "normal",  RandomGenerator::DISTRIBUTION_NORMAL  },
+	{ "integer", RandomGenerator::DISTRIBUTION_INTEGER },
+}
+STRINGMAP_CLASS_END(RandomGenerator, RandomGenerator::Distribution, RandomGenerator::DISTRIBUTION_MAX_ENUM, distribution)
+
 } // math
 } // love
@@ -27,6 +27,7 @@
 #include "common/math.h"
 #include "common/int.h"
 #include "common/Object.h"
+#include "common/StringMap.h"
 
 // C++
 #include <limits>
@@ -43,6 +44,14 @@ public:
 
 	static love::Type type;
 
+	enum Distribution
+	{
+		DISTRIBUTION_UNIFORM,
+		DISTRIBUTION_NORMAL,
+		DISTRIBUTION_INTEGER,
+		DISTRIBUTION_MAX_ENUM
+	};
+
 	union Seed
 	{
 		uint64 b64;
@@ -112,6 +121,32 @@ public:
 	 **/
 	double randomNormal(double stddev);
 
+	/**
+	 * Fill an array with random values. The generator ends up in the same
+	 * state, and the array holds the same values, as if each value had been
+	 * requested individually. Large arrays are split between threads by
+	 * jumping ahead in the sequence.
+	 *
+	 * @param distribution DISTRIBUTION_UNIFORM writes floats in [a, b).
+	 *        DISTRIBUTION_NORMAL writes floats with standard deviation a and
+	 *        mean b. DISTRIBUTION_INTEGER writes int32s in [a, b].
+	 * @param dst Array of count floats or int32s.
+	 **/
+	void fill(Distribution distribution, double a, double b, void *dst, size_t count);
+
+	/**
+	 * Advance the generator as if rand() had been called 'steps' times,
+	 * without computing the skipped values.
+	 **/
+	void advance(uint64 steps);
+
+	/**
+	 * Advance the generator by 2^48 values. Generators which start from the
+	 * same state and are jumped a different number of times produce
+	 * independent streams which won't overlap for 2^48 values.
+	 **/
+	void jump();
+
 	/**
 	 * Set pseudo-random seed.
 	 * It's up to the implementation how to use this.
@@ -134,6 +169,8 @@ public:
 	 **/
 	std::string getState() const;
 
+	STRINGMAP_CLASS_DECLARE(Distribution);
+
 private:
 
 	Seed seed;
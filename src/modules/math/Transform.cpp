@@ -19,6 +19,16 @@
  **/
 
 #include "Transform.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -118,6 +128,113 @@ love::Vector2 Transform::inverseTransformPoint(love::Vector2 p)
 	return result;
 }
 
+void Transform::transformPoints(const float *src, float *dst, int count) const
+{
+	const float *e = matrix.getElements();
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two points per iteration: x0 y0 x1 y1.
+	__m128 col1 = _mm_setr_ps(e[0], e[1], e[0], e[1]);
+	__m128 col2 = _mm_setr_ps(e[4], e[5], e[4], e[5]);
+	__m128 col4 = _mm_setr_ps(e[12], e[13], e[12], e[13]);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 p = _mm_loadu_ps(&src[i * 2]);
+		__m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, col1), _mm_mul_ps(ys, col2)), col4);
+		_mm_storeu_ps(&dst[i * 2], r);
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	// Four points per iteration, deinterleaved into x and y vectors.
+	for (; i + 4 <= count; i += 4)
+	{
+		float32x4x2_t p = vld2q_f32(&src[i * 2]);
+
+		float32x4x2_t r;
+		r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[12]), p.val[0], e[0]), p.val[1], e[4]);
+		r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[13]), p.val[0], e[1]), p.val[1], e[5]);
+
+		vst2q_f32(&dst[i * 2], r);
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float x = src[i * 2 + 0];
+		float y = src[i * 2 + 1];
+		dst[i * 2 + 0] = e[0] * x + e[4] * y + e[12];
+		dst[i * 2 + 1] = e[1] * x + e[5] * y + e[13];
+	}
+}
+
+// Multiplies 2D affine transforms p * c. result may alias c, but not p.
+static inline void multiplyAffine(const float *p, const float *c, float *result)
+{
+	float tx = p[0] * c[4] + p[2] * c[5] + p[4];
+	float ty = p[1] * c[4] + p[3] * c[5] + p[5];
+
+#if defined(LOVE_SIMD_SSE)
+
+	__m128 pm = _mm_loadu_ps(p);
+	__m128 cm = _mm_loadu_ps(c);
+	__m128 pab = _mm_shuffle_ps(pm, pm, _MM_SHUFFLE(1, 0, 1, 0));
+	__m128 pcd = _mm_shuffle_ps(pm, pm, _MM_SHUFFLE(3, 2, 3, 2));
+	__m128 cac = _mm_shuffle_ps(cm, cm, _MM_SHUFFLE(2, 2, 0, 0));
+	__m128 cbd = _mm_shuffle_ps(cm, cm, _MM_SHUFFLE(3, 3, 1, 1));
+	_mm_storeu_ps(result, _mm_add_ps(_mm_mul_ps(pab, cac), _mm_mul_ps(pcd, cbd)));
+
+#elif defined(LOVE_SIMD_NEON)
+
+	float32x2_t pab = vld1_f32(&p[0]);
+	float32x2_t pcd = vld1_f32(&p[2]);
+	float32x4_t pabab = vcombine_f32(pab, pab);
+	float32x4_t pcdcd = vcombine_f32(pcd, pcd);
+	float32x4_t cac = vcombine_f32(vdup_n_f32(c[0]), vdup_n_f32(c[2]));
+	float32x4_t cbd = vcombine_f32(vdup_n_f32(c[1]), vdup_n_f32(c[3]));
+	vst1q_f32(result, vmlaq_f32(vmulq_f32(pabab, cac), pcdcd, cbd));
+
+#else
+
+	float a = p[0] * c[0] + p[2] * c[1];
+	float b = p[1] * c[0] + p[3] * c[1];
+	float cc = p[0] * c[2] + p[2] * c[3];
+	float d = p[1] * c[2] + p[3] * c[3];
+	result[0] = a;
+	result[1] = b;
+	result[2] = cc;
+	result[3] = d;
+
+#endif
+
+	result[4] = tx;
+	result[5] = ty;
+}
+
+void Transform::composeAffine(const float *local, const int32 *parents, int count, const Matrix4 &root, float *world)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (parents[i] >= i)
+			throw love::Exception("Invalid parent index %d for transform %d: parents must come before their children.", parents[i] + 1, i + 1);
+	}
+
+	const float *e = root.getElements();
+	const float rootaffine[AFFINE_FLOATS] = {e[0], e[1], e[4], e[5], e[12], e[13]};
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *parent = parents[i] < 0 ? rootaffine : &world[parents[i] * AFFINE_FLOATS];
+		multiplyAffine(parent, &local[i * AFFINE_FLOATS], &world[i * AFFINE_FLOATS]);
+	}
+}
+
 const Matrix4 &Transform::getMatrix() const
 {
 	return matrix;
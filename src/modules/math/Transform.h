@@ -25,6 +25,7 @@
 #include "common/Matrix.h"
 #include "common/Vector.h"
 #include "common/StringMap.h"
+#include "common/int.h"
 
 namespace love
 {
@@ -66,9 +67,28 @@ public:
 	love::Vector2 transformPoint(love::Vector2 p) const;
 	love::Vector2 inverseTransformPoint(love::Vector2 p);
 
+	/**
+	 * Transforms count points stored as packed x,y float pairs. The source
+	 * and destination arrays may be the same.
+	 **/
+	void transformPoints(const float *src, float *dst, int count) const;
+
 	const Matrix4 &getMatrix() const;
 	void setMatrix(const Matrix4 &m);
 
+	/**
+	 * Composes a hierarchy of 2D affine transforms, such as the bones of a
+	 * skeleton: world[i] = world[parents[i]] * local[i], or root * local[i]
+	 * when parents[i] is negative. Parents must come before their children.
+	 * local and world may be the same array.
+	 *
+	 * Each transform is AFFINE_FLOATS floats: the upper-left 2x2 matrix column
+	 * by column, then the translation. Only the 2D affine part of root is used.
+	 **/
+	static void composeAffine(const float *local, const int32 *parents, int count, const Matrix4 &root, float *world);
+
+	static const int AFFINE_FLOATS = 6;
+
 	static bool getConstant(const char *in, MatrixLayout &out);
 	static bool getConstant(MatrixLayout in, const char *&out);
 	static std::vector<std::string> getConstants(MatrixLayout);
@@ -0,0 +1,809 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "MathModule.h"
+#include "common/Exception.h"
+
+// STL
+#include <deque>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Ear clipping triangulation with hole bridging and z-order curve hashing,
+// following the approach of Mapbox's earcut (ISC license). Candidate ears of
+// large polygons only test the vertices whose z-order lies inside the ear's
+// bounding box, which keeps triangulation close to O(n log n) in practice.
+
+namespace love
+{
+namespace math
+{
+
+namespace
+{
+
+struct Node
+{
+	Node(uint32 i, double x, double y)
+		: i(i), x(x), y(y)
+	{}
+
+	// Index of the vertex in the input.
+	uint32 i;
+	double x, y;
+
+	// Polygon ring.
+	Node *prev = nullptr;
+	Node *next = nullptr;
+
+	// Position on the z-order curve, and the ring sorted by it.
+	int32 z = 0;
+	Node *prevZ = nullptr;
+	Node *nextZ = nullptr;
+
+	// Set for single vertex holes, which filterPoints must keep.
+	bool steiner = false;
+};
+
+class Earcut
+{
+public:
+
+	Earcut(const std::vector<Vector2> &points, std::vector<uint32> &indices)
+		: points(points)
+		, indices(indices)
+	{}
+
+	void run(const std::vector<size_t> &holeStarts);
+
+private:
+
+	Node *linkedList(size_t start, size_t end, bool clockwise);
+	Node *filterPoints(Node *start, Node *end = nullptr);
+	void earcutLinked(Node *ear, int pass);
+	bool isEar(Node *ear) const;
+	bool isEarHashed(Node *ear) const;
+	Node *cureLocalIntersections(Node *start);
+	void splitEarcut(Node *start);
+	Node *eliminateHole(Node *hole, Node *outerNode);
+	Node *findHoleBridge(Node *hole, Node *outerNode) const;
+	void indexCurve(Node *start) const;
+	int32 zOrder(double x, double y) const;
+	Node *splitPolygon(Node *a, Node *b);
+	Node *insertNode(uint32 i, const Vector2 &p, Node *last);
+
+	void addTriangle(const Node *a, const Node *b, const Node *c)
+	{
+		indices.push_back(a->i);
+		indices.push_back(b->i);
+		indices.push_back(c->i);
+	}
+
+	const std::vector<Vector2> &points;
+	std::vector<uint32> &indices;
+
+	// A deque never moves its elements, so the ring pointers stay valid.
+	std::deque<Node> nodes;
+
+	bool hashed = false;
+	double minX = 0.0;
+	double minY = 0.0;
+	double invSize = 0.0;
+
+}; // Earcut
+
+// Vertex count above which ears are tested through the z-order hash.
+const size_t HASH_THRESHOLD = 80;
+
+inline double area(const Node *p, const Node *q, const Node *r)
+{
+	return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+inline bool equals(const Node *a, const Node *b)
+{
+	return a->x == b->x && a->y == b->y;
+}
+
+inline int sign(double v)
+{
+	return (v > 0.0) - (v < 0.0);
+}
+
+inline bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+{
+	return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+		&& (ax - px) * (by - py) >= (bx - px) * (ay - py)
+		&& (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+// Whether q lies on segment pr, given that p, q and r are collinear.
+inline bool onSegment(const Node *p, const Node *q, const Node *r)
+{
+	return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x)
+		&& q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+}
+
+bool intersects(const Node *p1, const Node *q1, const Node *p2, const Node *q2)
+{
+	int o1 = sign(area(p1, q1, p2));
+	int o2 = sign(area(p1, q1, q2));
+	int o3 = sign(area(p2, q2, p1));
+	int o4 = sign(area(p2, q2, q1));
+
+	if (o1 != o2 && o3 != o4)
+		return true;
+
+	if (o1 == 0 && onSegment(p1, p2, q1)) return true;
+	if (o2 == 0 && onSegment(p1, q2, q1)) return true;
+	if (o3 == 0 && onSegment(p2, p1, q2)) return true;
+	if (o4 == 0 && onSegment(p2, q1, q2)) return true;
+
+	return false;
+}
+
+// Whether the diagonal ab crosses any edge of the polygon.
+bool intersectsPolygon(const Node *a, const Node *b)
+{
+	const Node *p = a;
+	do
+	{
+		if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i && intersects(p, p->next, a, b))
+			return true;
+		p = p->next;
+	} while (p != a);
+
+	return false;
+}
+
+// Whether the diagonal ab starts inside the polygon at a.
+bool locallyInside(const Node *a, const Node *b)
+{
+	if (area(a->prev, a, a->next) < 0.0)
+		return area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0;
+	else
+		return area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+}
+
+// Whether the middle of the diagonal ab is inside the polygon.
+bool middleInside(const Node *a, const Node *b)
+{
+	const Node *p = a;
+	bool inside = false;
+	double px = (a->x + b->x) / 2.0;
+	double py = (a->y + b->y) / 2.0;
+
+	do
+	{
+		if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y
+			&& (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+			inside = !inside;
+		p = p->next;
+	} while (p != a);
+
+	return inside;
+}
+
+bool isValidDiagonal(const Node *a, const Node *b)
+{
+	if (a->next->i == b->i || a->prev->i == b->i || intersectsPolygon(a, b))
+		return false;
+
+	// Locally visible, without creating opposite-facing sectors.
+	if (locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+		&& (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0))
+		return true;
+
+	// Zero-length diagonal between two convex vertices.
+	return equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0;
+}
+
+bool sectorContainsSector(const Node *m, const Node *p)
+{
+	return area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0;
+}
+
+void removeNode(Node *p)
+{
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if (p->prevZ)
+		p->prevZ->nextZ = p->nextZ;
+	if (p->nextZ)
+		p->nextZ->prevZ = p->prevZ;
+}
+
+Node *getLeftmost(Node *start)
+{
+	Node *p = start;
+	Node *leftmost = start;
+	do
+	{
+		if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+			leftmost = p;
+		p = p->next;
+	} while (p != start);
+
+	return leftmost;
+}
+
+// Merge sort of the z-order list (Simon Tatham's linked list algorithm).
+void sortLinked(Node *list)
+{
+	int inSize = 1;
+	int numMerges = 0;
+
+	do
+	{
+		Node *p = list;
+		Node *tail = nullptr;
+		list = nullptr;
+		numMerges = 0;
+
+		while (p)
+		{
+			numMerges++;
+
+			Node *q = p;
+			int pSize = 0;
+			for (int i = 0; i < inSize; i++)
+			{
+				pSize++;
+				q = q->nextZ;
+				if (!q)
+					break;
+			}
+
+			int qSize = inSize;
+
+			while (pSize > 0 || (qSize > 0 && q))
+			{
+				Node *e = nullptr;
+				if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z))
+				{
+					e = p;
+					p = p->nextZ;
+					pSize--;
+				}
+				else
+				{
+					e = q;
+					q = q->nextZ;
+					qSize--;
+				}
+
+				if (tail)
+					tail->nextZ = e;
+				else
+					list = e;
+
+				e->prevZ = tail;
+				tail = e;
+			}
+
+			p = q;
+		}
+
+		tail->nextZ = nullptr;
+		inSize *= 2;
+	} while (numMerges > 1);
+}
+
+void Earcut::run(const std::vector<size_t> &holeStarts)
+{
+	size_t outerEnd = holeStarts.empty() ? points.size() : holeStarts[0];
+
+	Node *outerNode = linkedList(0, outerEnd, true);
+	if (outerNode == nullptr || outerNode->next == outerNode->prev)
+		return;
+
+	if (!holeStarts.empty())
+	{
+		std::vector<Node *> queue;
+		queue.reserve(holeStarts.size());
+
+		for (size_t h = 0; h < holeStarts.size(); h++)
+		{
+			size_t end = h + 1 < holeStarts.size() ? holeStarts[h + 1] : points.size();
+			Node *list = linkedList(holeStarts[h], end, false);
+			if (list == nullptr)
+				continue;
+			if (list == list->next)
+				list->steiner = true;
+			queue.push_back(getLeftmost(list));
+		}
+
+		std::sort(queue.begin(), queue.end(), [](const Node *a, const Node *b) { return a->x < b->x; });
+
+		// Bridge each hole to the outer ring, left to right.
+		for (Node *hole : queue)
+			outerNode = eliminateHole(hole, outerNode);
+	}
+
+	if (points.size() > HASH_THRESHOLD)
+	{
+		double maxX = minX = points[0].x;
+		double maxY = minY = points[0].y;
+
+		// Holes are included in case they poke out of the outer ring.
+		for (size_t i = 1; i < points.size(); i++)
+		{
+			minX = std::min(minX, (double) points[i].x);
+			minY = std::min(minY, (double) points[i].y);
+			maxX = std::max(maxX, (double) points[i].x);
+			maxY = std::max(maxY, (double) points[i].y);
+		}
+
+		// z-order coordinates are 15 bit integers.
+		double size = std::max(maxX - minX, maxY - minY);
+		invSize = size != 0.0 ? 32767.0 / size : 0.0;
+		hashed = invSize != 0.0;
+	}
+
+	earcutLinked(outerNode, 0);
+}
+
+// Creates a ring from points [start, end) with the given winding.
+Node *Earcut::linkedList(size_t start, size_t end, bool clockwise)
+{
+	if (start >= end)
+		return nullptr;
+
+	double signedArea = 0.0;
+	for (size_t i = start, j = end - 1; i < end; j = i++)
+		signedArea += ((double) points[j].x - points[i].x) * ((double) points[i].y + points[j].y);
+
+	Node *last = nullptr;
+	if (clockwise == (signedArea > 0.0))
+	{
+		for (size_t i = start; i < end; i++)
+			last = insertNode((uint32) i, points[i], last);
+	}
+	else
+	{
+		for (size_t i = end; i-- > start;)
+			last = insertNode((uint32) i, points[i], last);
+	}
+
+	if (last && equals(last, last->next))
+	{
+		removeNode(last);
+		last = last->next;
+	}
+
+	return last;
+}
+
+// Removes duplicate and collinear points.
+Node *Earcut::filterPoints(Node *start, Node *end)
+{
+	if (start == nullptr)
+		return start;
+
+	if (end == nullptr)
+		end = start;
+
+	Node *p = start;
+	bool again = false;
+	do
+	{
+		again = false;
+
+		if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0))
+		{
+			removeNode(p);
+			p = end = p->prev;
+			if (p == p->next)
+				break;
+			again = true;
+		}
+		else
+			p = p->next;
+	} while (again || p != end);
+
+	return end;
+}
+
+void Earcut::earcutLinked(Node *ear, int pass)
+{
+	if (ear == nullptr)
+		return;
+
+	if (pass == 0 && hashed)
+		indexCurve(ear);
+
+	Node *stop = ear;
+
+	while (ear->prev != ear->next)
+	{
+		Node *prev = ear->prev;
+		Node *next = ear->next;
+
+		if (hashed ? isEarHashed(ear) : isEar(ear))
+		{
+			addTriangle(prev, ear, next);
+			removeNode(ear);
+
+			// Skipping the next vertex leads to fewer sliver triangles.
+			ear = next->next;
+			stop = next->next;
+			continue;
+		}
+
+		ear = next;
+
+		// Went around the whole ring without finding an ear.
+		if (ear == stop)
+		{
+			if (pass == 0)
+				earcutLinked(filterPoints(ear), 1);
+			else if (pass == 1)
+				earcutLinked(cureLocalIntersections(filterPoints(ear)), 2);
+			else
+				splitEarcut(ear);
+			break;
+		}
+	}
+}
+
+bool Earcut::isEar(Node *ear) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	// Reflex vertices can't be ears.
+	if (area(a, b, c) >= 0.0)
+		return false;
+
+	double x0 = std::min(a->x, std::min(b->x, c->x));
+	double y0 = std::min(a->y, std::min(b->y, c->y));
+	double x1 = std::max(a->x, std::max(b->x, c->x));
+	double y1 = std::max(a->y, std::max(b->y, c->y));
+
+	for (const Node *p = c->next; p != a; p = p->next)
+	{
+		if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+			&& pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+			&& area(p->prev, p, p->next) >= 0.0)
+			return false;
+	}
+
+	return true;
+}
+
+bool Earcut::isEarHashed(Node *ear) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	if (area(a, b, c) >= 0.0)
+		return false;
+
+	double x0 = std::min(a->x, std::min(b->x, c->x));
+	double y0 = std::min(a->y, std::min(b->y, c->y));
+	double x1 = std::max(a->x, std::max(b->x, c->x));
+	double y1 = std::max(a->y, std::max(b->y, c->y));
+
+	// Only vertices within the z-order range of the bounding box can be in
+	// the triangle.
+	int32 minZ = zOrder(x0, y0);
+	int32 maxZ = zOrder(x1, y1);
+
+	auto blocks = [&](const Node *p)
+	{
+		return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && p != a && p != c
+			&& pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+			&& area(p->prev, p, p->next) >= 0.0;
+	};
+
+	const Node *p = ear->prevZ;
+	const Node *n = ear->nextZ;
+
+	// Search both directions at once, then whichever is left.
+	while (p && p->z >= minZ && n && n->z <= maxZ)
+	{
+		if (blocks(p))
+			return false;
+		p = p->prevZ;
+
+		if (blocks(n))
+			return false;
+		n = n->nextZ;
+	}
+
+	for (; p && p->z >= minZ; p = p->prevZ)
+	{
+		if (blocks(p))
+			return false;
+	}
+
+	for (; n && n->z <= maxZ; n = n->nextZ)
+	{
+		if (blocks(n))
+			return false;
+	}
+
+	return true;
+}
+
+// Clips the triangles at small self-intersections, where the ring crosses
+// itself over two consecutive edges.
+Node *Earcut::cureLocalIntersections(Node *start)
+{
+	Node *p = start;
+	do
+	{
+		Node *a = p->prev;
+		Node *b = p->next->next;
+
+		if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a))
+		{
+			addTriangle(a, p, b);
+
+			removeNode(p);
+			removeNode(p->next);
+
+			p = start = b;
+		}
+
+		p = p->next;
+	} while (p != start);
+
+	return filterPoints(p);
+}
+
+// Splits the ring along a valid diagonal and triangulates both halves.
+void Earcut::splitEarcut(Node *start)
+{
+	Node *a = start;
+	do
+	{
+		Node *b = a->next->next;
+		while (b != a->prev)
+		{
+			if (a->i != b->i && isValidDiagonal(a, b))
+			{
+				Node *c = splitPolygon(a, b);
+
+				a = filterPoints(a, a->next);
+				c = filterPoints(c, c->next);
+
+				earcutLinked(a, 0);
+				earcutLinked(c, 0);
+				return;
+			}
+			b = b->next;
+		}
+		a = a->next;
+	} while (a != start);
+}
+
+Node *Earcut::eliminateHole(Node *hole, Node *outerNode)
+{
+	Node *bridge = findHoleBridge(hole, outerNode);
+	if (bridge == nullptr)
+		return outerNode;
+
+	Node *bridgeReverse = splitPolygon(bridge, hole);
+
+	// Filter collinear points around the cuts.
+	filterPoints(bridgeReverse, bridgeReverse->next);
+	return filterPoints(bridge, bridge->next);
+}
+
+// Finds the outer ring vertex that the hole's leftmost vertex can connect to.
+Node *Earcut::findHoleBridge(Node *hole, Node *outerNode) const
+{
+	Node *p = outerNode;
+	double hx = hole->x;
+	double hy = hole->y;
+	double qx = -std::numeric_limits<double>::infinity();
+	Node *m = nullptr;
+
+	// Find the closest segment crossed by a ray from the hole to the left. Its
+	// endpoint with the lesser x is a potential connection point.
+	do
+	{
+		if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+		{
+			double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if (x <= hx && x > qx)
+			{
+				qx = x;
+				m = p->x < p->next->x ? p : p->next;
+
+				// The hole touches the segment.
+				if (x == hx)
+					return m;
+			}
+		}
+		p = p->next;
+	} while (p != outerNode);
+
+	if (m == nullptr)
+		return nullptr;
+
+	// If any vertices are inside the triangle between the hole point, the
+	// intersection and the endpoint, connect to the one with the smallest
+	// angle to the ray instead.
+	const Node *stop = m;
+	double mx = m->x;
+	double my = m->y;
+	double tanMin = std::numeric_limits<double>::infinity();
+
+	p = m;
+	do
+	{
+		if (hx >= p->x && p->x >= mx && hx != p->x
+			&& pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+		{
+			double tan = std::abs(hy - p->y) / (hx - p->x);
+
+			if (locallyInside(p, hole)
+				&& (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p))))))
+			{
+				m = p;
+				tanMin = tan;
+			}
+		}
+		p = p->next;
+	} while (p != stop);
+
+	return m;
+}
+
+void Earcut::indexCurve(Node *start) const
+{
+	Node *p = start;
+	do
+	{
+		if (p->z == 0)
+			p->z = zOrder(p->x, p->y);
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	} while (p != start);
+
+	p->prevZ->nextZ = nullptr;
+	p->prevZ = nullptr;
+
+	sortLinked(p);
+}
+
+// Interleaves the bits of the 15 bit integer coordinates.
+int32 Earcut::zOrder(double x, double y) const
+{
+	uint32 ix = (uint32) ((x - minX) * invSize);
+	uint32 iy = (uint32) ((y - minY) * invSize);
+
+	ix = (ix | (ix << 8)) & 0x00FF00FF;
+	ix = (ix | (ix << 4)) & 0x0F0F0F0F;
+	ix = (ix | (ix << 2)) & 0x33333333;
+	ix = (ix | (ix << 1)) & 0x55555555;
+
+	iy = (iy | (iy << 8)) & 0x00FF00FF;
+	iy = (iy | (iy << 4)) & 0x0F0F0F0F;
+	iy = (iy | (iy << 2)) & 0x33333333;
+	iy = (iy | (iy << 1)) & 0x55555555;
+
+	return (int32) (ix | (iy << 1));
+}
+
+// Connects a and b with a diagonal. a and b are both duplicated so the ring
+// becomes two: a -> b and the returned b2 -> a2.
+Node *Earcut::splitPolygon(Node *a, Node *b)
+{
+	nodes.emplace_back(a->i, a->x, a->y);
+	Node *a2 = &nodes.back();
+	nodes.emplace_back(b->i, b->x, b->y);
+	Node *b2 = &nodes.back();
+
+	Node *an = a->next;
+	Node *bp = b->prev;
+
+	a->next = b;
+	b->prev = a;
+
+	a2->next = an;
+	an->prev = a2;
+
+	b2->next = a2;
+	a2->prev = b2;
+
+	bp->next = b2;
+	b2->prev = bp;
+
+	return b2;
+}
+
+Node *Earcut::insertNode(uint32 i, const Vector2 &p, Node *last)
+{
+	nodes.emplace_back(i, p.x, p.y);
+	Node *node = &nodes.back();
+
+	if (last == nullptr)
+	{
+		node->prev = node;
+		node->next = node;
+	}
+	else
+	{
+		node->next = last->next;
+		node->prev = last;
+		last->next->prev = node;
+		last->next = node;
+	}
+
+	return node;
+}
+
+} // anonymous namespace
+
+void triangulate(const std::vector<Vector2> &points, const std::vector<size_t> &holeStarts, std::vector<uint32> &indices)
+{
+	size_t outerEnd = holeStarts.empty() ? points.size() : holeStarts[0];
+	if (outerEnd < 3)
+		throw love::Exception("Not a polygon");
+
+	if (points.size() > std::numeric_limits<uint32>::max())
+		throw love::Exception("Too many polygon vertices to triangulate.");
+
+	for (size_t h = 0; h < holeStarts.size(); h++)
+	{
+		size_t end = h + 1 < holeStarts.size() ? holeStarts[h + 1] : points.size();
+		if (holeStarts[h] < outerEnd || holeStarts[h] >= end)
+			throw love::Exception("Invalid polygon hole start index: %d", (int) holeStarts[h]);
+	}
+
+	indices.clear();
+	indices.reserve((points.size() + holeStarts.size() * 2) * 3);
+
+	Earcut earcut(points, indices);
+	earcut.run(holeStarts);
+}
+
+std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
+{
+	if (polygon.size() < 3)
+		throw love::Exception("Not a polygon");
+	else if (polygon.size() == 3)
+		return std::vector<Triangle>(1, Triangle(polygon[0], polygon[1], polygon[2]));
+
+	std::vector<uint32> indices;
+	triangulate(polygon, std::vector<size_t>(), indices);
+
+	if (indices.empty())
+		throw love::Exception("Cannot triangulate polygon.");
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(indices.size() / 3);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		triangles.push_back(Triangle(polygon[indices[i]], polygon[indices[i + 1]], polygon[indices[i + 2]]));
+
+	return triangles;
+}
+
+} // math
+} // love
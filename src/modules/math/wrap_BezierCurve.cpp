@@ -20,8 +20,10 @@
 
 #include "common/Exception.h"
 #include "wrap_BezierCurve.h"
+#include "data/ByteData.h"
 
 #include <cmath>
+#include <algorithm>
 
 namespace love
 {
@@ -213,6 +215,69 @@ int w_BezierCurve_renderSegment(lua_State *L)
 	return 1;
 }
 
+// Returns data if it can hold size bytes, or a new ByteData otherwise.
+static StrongRef<Data> luax_reusedata(lua_State *L, Data *data, size_t size)
+{
+	StrongRef<Data> dst(data);
+	if (data == nullptr || data->getSize() < size)
+		luax_catchexcept(L, [&]() { dst.set(new love::data::ByteData(std::max<size_t>(size, 1), false), Acquire::NORETAIN); });
+	return dst;
+}
+
+int w_BezierCurve_renderAdaptive(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	float tolerance = (float) luaL_checknumber(L, 2);
+
+	const std::vector<Vector2> *points = nullptr;
+	luax_catchexcept(L, [&](){ points = &curve->renderAdaptive(tolerance); });
+
+	if (lua_isnoneornil(L, 3))
+	{
+		lua_createtable(L, (int) points->size() * 2, 0);
+		for (int i = 0; i < (int) points->size(); ++i)
+		{
+			lua_pushnumber(L, (*points)[i].x);
+			lua_rawseti(L, -2, 2*i+1);
+			lua_pushnumber(L, (*points)[i].y);
+			lua_rawseti(L, -2, 2*i+2);
+		}
+		return 1;
+	}
+
+	StrongRef<Data> dst = luax_reusedata(L, luax_checktype<Data>(L, 3), points->size() * sizeof(float) * 2);
+
+	float *coords = (float *) dst->getData();
+	for (size_t i = 0; i < points->size(); ++i)
+	{
+		coords[2*i+0] = (*points)[i].x;
+		coords[2*i+1] = (*points)[i].y;
+	}
+
+	luax_pushtype(L, dst.get());
+	lua_pushinteger(L, (lua_Integer) points->size());
+	return 2;
+}
+
+int w_BezierCurve_evaluatePoints(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	double start = luaL_optnumber(L, 3, 0.0);
+	double end = luaL_optnumber(L, 4, 1.0);
+
+	if (count < 1)
+		return luaL_error(L, "Invalid point count: %d", count);
+
+	Data *data = lua_isnoneornil(L, 5) ? nullptr : luax_checktype<Data>(L, 5);
+	StrongRef<Data> dst = luax_reusedata(L, data, (size_t) count * sizeof(float) * 2);
+
+	luax_catchexcept(L, [&](){ curve->evaluate(start, end, count, (float *) dst->getData()); });
+
+	luax_pushtype(L, dst.get());
+	return 1;
+}
+
 static const luaL_Reg w_BezierCurve_functions[] =
 {
 	{"getDegree", w_BezierCurve_getDegree},
@@ -229,6 +294,8 @@ static const luaL_Reg w_BezierCurve_functions[] =
 	{"getSegment", w_BezierCurve_getSegment},
 	{"render", w_BezierCurve_render},
 	{"renderSegment", w_BezierCurve_renderSegment},
+	{"renderAdaptive", w_BezierCurve_renderAdaptive},
+	{"evaluatePoints", w_BezierCurve_evaluatePoints},
 	{ 0, 0 }
 };
 
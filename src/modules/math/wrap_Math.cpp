@@ -25,10 +25,14 @@
 #include "MathModule.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "NoiseGrid.h"
+#include "image/ImageData.h"
+#include "data/ByteData.h"
 
 #include <cmath>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // Put the Lua code directly into a raw string literal.
 static const char math_lua[] =
@@ -145,25 +149,55 @@ int w_newTransform(lua_State *L)
 	return 1;
 }
 
+static void checkPolygonTable(lua_State *L, int idx, std::vector<love::Vector2> &points)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int top = (int) luax_objlen(L, idx);
+	points.reserve(points.size() + top / 2);
+	for (int i = 1; i <= top; i += 2)
+	{
+		lua_rawgeti(L, idx, i);
+		lua_rawgeti(L, idx, i+1);
+
+		Vector2 v;
+		v.x = (float) luaL_checknumber(L, -2);
+		v.y = (float) luaL_checknumber(L, -1);
+		points.push_back(v);
+
+		lua_pop(L, 2);
+	}
+}
+
+// Appends the vertices of each hole in a table of vertex tables.
+static void checkPolygonHoles(lua_State *L, int idx, std::vector<love::Vector2> &points, std::vector<size_t> &holeStarts)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = (int) luax_objlen(L, idx);
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		size_t start = points.size();
+		checkPolygonTable(L, -1, points);
+		lua_pop(L, 1);
+
+		if (points.size() - start < 3)
+			luaL_error(L, "Need at least 3 vertices in polygon hole %d (got %d).", i, (int) (points.size() - start));
+
+		holeStarts.push_back(start);
+	}
+}
+
 int w_triangulate(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
+	std::vector<size_t> holeStarts;
 	if (lua_istable(L, 1))
 	{
-		int top = (int) luax_objlen(L, 1);
-		vertices.reserve(top / 2);
-		for (int i = 1; i <= top; i += 2)
-		{
-			lua_rawgeti(L, 1, i);
-			lua_rawgeti(L, 1, i+1);
-
-			Vector2 v;
-			v.x = (float) luaL_checknumber(L, -2);
-			v.y = (float) luaL_checknumber(L, -1);
-			vertices.push_back(v);
-
-			lua_pop(L, 2);
-		}
+		checkPolygonTable(L, 1, vertices);
+		checkPolygonHoles(L, 2, vertices, holeStarts);
 	}
 	else
 	{
@@ -178,13 +212,22 @@ int w_triangulate(lua_State *L)
 		}
 	}
 
-	if (vertices.size() < 3)
-		return luaL_error(L, "Need at least 3 vertices to triangulate (got %d).", (int)vertices.size());
+	size_t outercount = holeStarts.empty() ? vertices.size() : holeStarts[0];
+	if (outercount < 3)
+		return luaL_error(L, "Need at least 3 vertices to triangulate (got %d).", (int) outercount);
 
 	std::vector<Triangle> triangles;
 
 	luax_catchexcept(L, [&]() {
-		if (vertices.size() == 3)
+		if (!holeStarts.empty())
+		{
+			std::vector<uint32> indices;
+			triangulate(vertices, holeStarts, indices);
+			triangles.reserve(indices.size() / 3);
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+				triangles.push_back(Triangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]));
+		}
+		else if (vertices.size() == 3)
 			triangles.push_back(Triangle(vertices[0], vertices[1], vertices[2]));
 		else
 			triangles = triangulate(vertices);
@@ -215,6 +258,89 @@ int w_triangulate(lua_State *L)
 	return 1;
 }
 
+int w_triangulateIndices(lua_State *L)
+{
+	std::vector<love::Vector2> vertices;
+	checkPolygonTable(L, 1, vertices);
+
+	if (vertices.size() < 3)
+		return luaL_error(L, "Need at least 3 vertices to triangulate (got %d).", (int) vertices.size());
+
+	std::vector<size_t> holeStarts;
+	checkPolygonHoles(L, 2, vertices, holeStarts);
+
+	std::vector<uint32> indices;
+	luax_catchexcept(L, [&]() { triangulate(vertices, holeStarts, indices); });
+
+	if (indices.empty())
+		return luaL_error(L, "Cannot triangulate polygon.");
+
+	// The returned values can be passed straight to Mesh:setVertexMap.
+	bool use16bit = vertices.size() <= LOVE_UINT16_MAX + 1;
+	size_t indexsize = use16bit ? sizeof(uint16) : sizeof(uint32);
+
+	StrongRef<love::data::ByteData> data;
+	luax_catchexcept(L, [&]() { data.set(new love::data::ByteData(indices.size() * indexsize, false), Acquire::NORETAIN); });
+
+	if (use16bit)
+	{
+		uint16 *dst = (uint16 *) data->getData();
+		for (size_t i = 0; i < indices.size(); i++)
+			dst[i] = (uint16) indices[i];
+	}
+	else
+		memcpy(data->getData(), indices.data(), indices.size() * sizeof(uint32));
+
+	luax_pushtype(L, data);
+	lua_pushstring(L, use16bit ? "uint16" : "uint32");
+	lua_pushinteger(L, (lua_Integer) indices.size());
+	return 3;
+}
+
+int w_composeTransforms(lua_State *L)
+{
+	Data *local = luax_checktype<Data>(L, 1);
+
+	std::vector<int32> parents;
+	if (lua_istable(L, 2))
+	{
+		// 1-based indices, 0 for transforms without a parent.
+		int count = (int) luax_objlen(L, 2);
+		parents.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			parents[i] = (int32) luaL_checkinteger(L, -1) - 1;
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		// 0-based int32 indices, negative for transforms without a parent.
+		Data *data = luax_checktype<Data>(L, 2);
+		parents.resize(data->getSize() / sizeof(int32));
+		if (!parents.empty())
+			memcpy(parents.data(), data->getData(), parents.size() * sizeof(int32));
+	}
+
+	Data *world = lua_isnoneornil(L, 3) ? local : luax_checktype<Data>(L, 3);
+	Matrix4 root;
+	if (!lua_isnoneornil(L, 4))
+		root = luax_checktransform(L, 4)->getMatrix();
+
+	size_t datasize = parents.size() * Transform::AFFINE_FLOATS * sizeof(float);
+	if (datasize > local->getSize())
+		return luaL_error(L, "The local transform Data is too small for %d transforms.", (int) parents.size());
+	if (datasize > world->getSize())
+		return luaL_error(L, "The world transform Data is too small for %d transforms.", (int) parents.size());
+
+	luax_catchexcept(L, [&]() {
+		Transform::composeAffine((const float *) local->getData(), parents.data(), (int) parents.size(), root, (float *) world->getData());
+	});
+
+	return 0;
+}
+
 int w_isConvex(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
@@ -408,6 +534,89 @@ int w_simplexNoise(lua_State* L)
 	return 1;
 }
 
+static void checkNoiseGridSettings(lua_State *L, int idx, NoiseGridSettings &settings)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_getfield(L, idx, "type");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *typestr = luaL_checkstring(L, -1);
+		if (!getConstant(typestr, settings.type))
+			luax_enumerror(L, "noise type", getConstants(settings.type), typestr);
+	}
+	lua_pop(L, 1);
+
+	settings.x = luax_numberflag(L, idx, "x", settings.x);
+	settings.y = luax_numberflag(L, idx, "y", settings.y);
+
+	double scale = luax_numberflag(L, idx, "scale", settings.scaleX);
+	settings.scaleX = luax_numberflag(L, idx, "scalex", scale);
+	settings.scaleY = luax_numberflag(L, idx, "scaley", scale);
+
+	settings.octaves = luax_intflag(L, idx, "octaves", settings.octaves);
+	settings.lacunarity = luax_numberflag(L, idx, "lacunarity", settings.lacunarity);
+	settings.persistence = luax_numberflag(L, idx, "persistence", settings.persistence);
+
+	if (settings.octaves < 1 || settings.octaves > 32)
+		luaL_error(L, "Invalid octave count: %d (must be between 1 and 32)", settings.octaves);
+}
+
+int w_fillNoise(lua_State *L)
+{
+	NoiseGridSettings settings;
+
+	if (luax_istype(L, 1, image::ImageData::type))
+	{
+		image::ImageData *imagedata = luax_checktype<image::ImageData>(L, 1);
+		checkNoiseGridSettings(L, 2, settings);
+
+		image::ImageData::PixelSetFunction setPixel = imagedata->getPixelSetFunction();
+		if (setPixel == nullptr)
+			return luaL_error(L, "love.math.fillNoise does not currently support the %s pixel format.", getPixelFormatName(imagedata->getFormat()));
+
+		int width = imagedata->getWidth();
+		size_t pixelsize = imagedata->getPixelSize();
+		uint8 *pixels = (uint8 *) imagedata->getData();
+
+		luax_catchexcept(L, [&]() {
+			generateNoiseGrid(settings, width, imagedata->getHeight(), [&](int y, const float *row)
+			{
+				uint8 *p = pixels + y * width * pixelsize;
+				for (int x = 0; x < width; x++, p += pixelsize)
+					setPixel(Colorf(row[x], row[x], row[x], 1.0f), (image::ImageData::Pixel *) p);
+			});
+		});
+	}
+	else
+	{
+		Data *data = luax_checktype<Data>(L, 1);
+		int width = (int) luaL_checkinteger(L, 2);
+		int height = (int) luaL_checkinteger(L, 3);
+		checkNoiseGridSettings(L, 4, settings);
+
+		if (width <= 0 || height <= 0)
+			return luaL_error(L, "Noise grid dimensions must be greater than 0.");
+
+		if ((double) width * height * sizeof(float) > (double) data->getSize())
+			return luaL_error(L, "Data is too small for a %dx%d grid of floats.", width, height);
+
+		float *values = (float *) data->getData();
+
+		luax_catchexcept(L, [&]() {
+			generateNoiseGrid(settings, width, height, [&](int y, const float *row)
+			{
+				memcpy(values + (size_t) y * width, row, width * sizeof(float));
+			});
+		});
+	}
+
+	return 0;
+}
+
 // C functions in a struct, necessary for the FFI versions of math functions.
 struct FFI_Math
 {
@@ -450,12 +659,15 @@ static const luaL_Reg functions[] =
 	{ "newBezierCurve", w_newBezierCurve },
 	{ "newTransform", w_newTransform },
 	{ "triangulate", w_triangulate },
+	{ "triangulateIndices", w_triangulateIndices },
 	{ "isConvex", w_isConvex },
+	{ "composeTransforms", w_composeTransforms },
 	{ "gammaToLinear", w_gammaToLinear },
 	{ "linearToGamma", w_linearToGamma },
 	{ "noise", w_noise },
 	{ "perlinNoise", w_perlinNoise },
 	{ "simplexNoise", w_simplexNoise },
+	{ "fillNoise", w_fillNoise },
 
 	{ 0, 0 }
 };
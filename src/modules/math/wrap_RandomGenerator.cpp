@@ -19,6 +19,7 @@
  **/
 
 #include "wrap_RandomGenerator.h"
+#include "common/Data.h"
 
 #include <cmath>
 #include <algorithm>
@@ -85,6 +86,60 @@ int w_RandomGenerator_randomNormal(lua_State *L)
 	return 1;
 }
 
+int w_RandomGenerator_fill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+
+	RandomGenerator::Distribution distribution = RandomGenerator::DISTRIBUTION_UNIFORM;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!RandomGenerator::getConstant(str, distribution))
+			return luax_enumerror(L, "random distribution", RandomGenerator::getConstants(distribution), str);
+	}
+
+	double a = 0.0;
+	double b = 0.0;
+
+	if (distribution == RandomGenerator::DISTRIBUTION_UNIFORM)
+	{
+		a = luaL_optnumber(L, 4, 0.0);
+		b = luaL_optnumber(L, 5, 1.0);
+	}
+	else if (distribution == RandomGenerator::DISTRIBUTION_NORMAL)
+	{
+		a = luaL_optnumber(L, 4, 1.0);
+		b = luaL_optnumber(L, 5, 0.0);
+	}
+	else
+	{
+		a = luaL_checknumber(L, 4);
+		b = luaL_checknumber(L, 5);
+
+		if (a != floor(a) || b != floor(b))
+			return luaL_error(L, "Integer range bounds must be whole numbers.");
+		if (a > b)
+			return luaL_error(L, "Invalid integer range: the minimum must not be greater than the maximum.");
+		if (a < (double) std::numeric_limits<int32>::min() || b > (double) std::numeric_limits<int32>::max())
+			return luaL_error(L, "Integer range must fit in a 32-bit signed integer.");
+	}
+
+	// Both floats and int32s are 4 bytes.
+	size_t count = data->getSize() / sizeof(float);
+	luax_catchexcept(L, [&](){ rng->fill(distribution, a, b, data->getData(), count); });
+
+	lua_pushinteger(L, (lua_Integer) count);
+	return 1;
+}
+
+int w_RandomGenerator_jump(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	rng->jump();
+	return 0;
+}
+
 int w_RandomGenerator_setSeed(lua_State *L)
 {
 	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
@@ -141,6 +196,8 @@ static const luaL_Reg w_RandomGenerator_functions[] =
 {
 	{ "_random", w_RandomGenerator__random }, // random() is defined in wrap_RandomGenerator.lua.
 	{ "randomNormal", w_RandomGenerator_randomNormal },
+	{ "fill", w_RandomGenerator_fill },
+	{ "jump", w_RandomGenerator_jump },
 	{ "setSeed", w_RandomGenerator_setSeed },
 	{ "getSeed", w_RandomGenerator_getSeed },
 	{ "setState", w_RandomGenerator_setState },
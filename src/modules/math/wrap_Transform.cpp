@@ -19,6 +19,12 @@
  **/
 
 #include "wrap_Transform.h"
+#include "common/Data.h"
+
+// Put the Lua code directly into a raw string literal.
+static const char transform_lua[] =
+#include "wrap_Transform.lua"
+;
 
 namespace love
 {
@@ -284,6 +290,25 @@ int w_Transform_inverseTransformPoint(lua_State *L)
 	return 2;
 }
 
+int w_Transform_transformPoints(lua_State *L)
+{
+	Transform *t = luax_checktransform(L, 1);
+	Data *src = luax_checktype<Data>(L, 2);
+	Data *dst = lua_isnoneornil(L, 3) ? src : luax_checktype<Data>(L, 3);
+
+	size_t pointsize = sizeof(float) * 2;
+	int count = (int) luaL_optinteger(L, 4, src->getSize() / pointsize);
+
+	if (count < 0 || count * pointsize > src->getSize())
+		return luaL_error(L, "Invalid point count %d for the source Data.", count);
+
+	if (count * pointsize > dst->getSize())
+		return luaL_error(L, "The destination Data is too small for %d points.", count);
+
+	t->transformPoints((const float *) src->getData(), (float *) dst->getData(), count);
+	return 0;
+}
+
 int w_Transform__mul(lua_State *L)
 {
 	Transform *t1 = luax_checktransform(L, 1);
@@ -294,6 +319,38 @@ int w_Transform__mul(lua_State *L)
 	return 1;
 }
 
+// C functions in a struct, necessary for the FFI versions of Transform methods.
+struct FFI_Transform
+{
+	bool (*transformPoint)(Proxy *p, float x, float y, float *out);
+	bool (*inverseTransformPoint)(Proxy *p, float x, float y, float *out);
+};
+
+static FFI_Transform ffifuncs =
+{
+	[](Proxy *p, float x, float y, float *out) -> bool // transformPoint
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		love::Vector2 v = t->transformPoint(love::Vector2(x, y));
+		out[0] = v.x;
+		out[1] = v.y;
+		return true;
+	},
+
+	[](Proxy *p, float x, float y, float *out) -> bool // inverseTransformPoint
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		love::Vector2 v = t->inverseTransformPoint(love::Vector2(x, y));
+		out[0] = v.x;
+		out[1] = v.y;
+		return true;
+	},
+};
+
 static const luaL_Reg functions[] =
 {
 	{ "clone", w_Transform_clone },
@@ -310,13 +367,18 @@ static const luaL_Reg functions[] =
 	{ "getMatrix", w_Transform_getMatrix },
 	{ "transformPoint", w_Transform_transformPoint },
 	{ "inverseTransformPoint", w_Transform_inverseTransformPoint },
+	{ "transformPoints", w_Transform_transformPoints },
 	{ "__mul", w_Transform__mul },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_transform(lua_State *L)
 {
-	return luax_register_type(L, &Transform::type, functions, nullptr);
+	int n = luax_register_type(L, &Transform::type, functions, nullptr);
+
+	luax_runwrapper(L, transform_lua, sizeof(transform_lua), "Transform.lua", Transform::type, &ffifuncs);
+
+	return n;
 }
 
 } // math
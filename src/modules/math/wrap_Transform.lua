@@ -0,0 +1,78 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+local Transform_mt, ffifuncspointer_str = ...
+local Transform = Transform_mt.__index
+
+local type, tonumber = type, tonumber
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Transform functionality.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Transform
+{
+	bool (*transformPoint)(Proxy *p, float x, float y, float *out);
+	bool (*inverseTransformPoint)(Proxy *p, float x, float y, float *out);
+} FFI_Transform;
+]])
+
+local ffifuncs = ffi.cast("FFI_Transform **", ffifuncspointer_str)[0]
+
+local point = ffi.new("float[2]")
+
+-- The regular methods are used when the FFI versions can't handle the
+-- arguments, so errors are the same either way.
+local _transformPoint = Transform.transformPoint
+local _inverseTransformPoint = Transform.inverseTransformPoint
+
+function Transform:transformPoint(x, y)
+	if type(self) == "userdata" and type(x) == "number" and type(y) == "number"
+		and ffifuncs.transformPoint(self, x, y, point) then
+		return tonumber(point[0]), tonumber(point[1])
+	end
+	return _transformPoint(self, x, y)
+end
+
+function Transform:inverseTransformPoint(x, y)
+	if type(self) == "userdata" and type(x) == "number" and type(y) == "number"
+		and ffifuncs.inverseTransformPoint(self, x, y, point) then
+		return tonumber(point[0]), tonumber(point[1])
+	end
+	return _inverseTransformPoint(self, x, y)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
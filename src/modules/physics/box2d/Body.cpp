@@ -23,6 +23,7 @@
 #include "common/math.h"
 
 #include "Shape.h"
+#include "ChainShape.h"
 #include "World.h"
 #include "Physics.h"
 
@@ -40,11 +41,13 @@ namespace box2d
 Body::Body(World *world, b2Vec2 p, Body::Type type)
 	: world(world)
 	, hasCustomMass(false)
+	, previousAngle(0.0f)
 {
 	b2BodyDef def;
 	def.position = Physics::scaleDown(p);
 	def.userData.pointer = (uintptr_t)this;
 	body = world->world->CreateBody(&def);
+	previousPosition = body->GetPosition();
 	// Box2D body holds a reference to the love Body.
 	this->retain();
 	this->setType(type);
@@ -112,6 +115,19 @@ void Body::getKinematicState(b2Vec2 &pos_o, float &a_o, b2Vec2 &vel_o, float &da
 	da_o = body->GetAngularVelocity();
 }
 
+void Body::getInterpolatedTransform(float alpha, b2Vec2 &pos_o, float &a_o) const
+{
+	const b2Vec2 &position = body->GetPosition();
+	pos_o = Physics::scaleUp(previousPosition + alpha * (position - previousPosition));
+	a_o = previousAngle + alpha * (body->GetAngle() - previousAngle);
+}
+
+void Body::savePreviousTransform()
+{
+	previousPosition = body->GetPosition();
+	previousAngle = body->GetAngle();
+}
+
 float Body::getMass() const
 {
 	return body->GetMass();
@@ -499,6 +515,67 @@ int Body::getShapes(lua_State *L) const
 	return 1;
 }
 
+void Body::setChains(bool loop, const Vector2 *coords, const int *counts, int chaincount)
+{
+	int mincount = loop ? 3 : 2;
+	for (int i = 0; i < chaincount; i++)
+	{
+		if (counts[i] < mincount)
+			throw love::Exception("Expected a minimum of %d vertices in chain %d, got %d.", mincount, i + 1, counts[i]);
+	}
+
+	std::vector<StrongRef<ChainShape>> newchains;
+	newchains.reserve(chaincount);
+
+	std::vector<b2Vec2> vecs;
+
+	for (int i = 0; i < chaincount; i++)
+	{
+		int count = counts[i];
+
+		vecs.clear();
+		for (int j = 0; j < count; j++)
+			vecs.push_back(Physics::scaleDown(b2Vec2(coords[j].x, coords[j].y)));
+
+		coords += count;
+
+		b2ChainShape s;
+
+		if (loop)
+			s.CreateLoop(vecs.data(), count);
+		else
+			s.CreateChain(vecs.data(), count, vecs[0], vecs[count - 1]);
+
+		ChainShape *old = i < (int) chains.size() ? chains[i].get() : nullptr;
+
+		if (old != nullptr && old->isValid())
+		{
+			if (old->hasSameVertices(s))
+			{
+				newchains.push_back(chains[i]);
+				continue;
+			}
+
+			old->destroy();
+		}
+
+		newchains.emplace_back(new ChainShape(this, s), Acquire::NORETAIN);
+	}
+
+	for (size_t i = chaincount; i < chains.size(); i++)
+	{
+		if (chains[i]->isValid())
+			chains[i]->destroy();
+	}
+
+	chains = std::move(newchains);
+}
+
+const std::vector<StrongRef<ChainShape>> &Body::getChains() const
+{
+	return chains;
+}
+
 int Body::getJoints(lua_State *L) const
 {
 	lua_newtable(L);
@@ -533,7 +610,7 @@ int Body::getContacts(lua_State *L) const
 		if (!ce)
 			break;
 
-		Contact *contact = (Contact *) world->findObject(ce->contact);
+		Contact *contact = (Contact *) ce->contact->GetUserData().pointer;
 		if (!contact)
 			contact = new Contact(world, ce->contact);
 		else
@@ -561,6 +638,8 @@ void Body::destroy()
 	world->world->DestroyBody(body);
 	body = nullptr;
 
+	chains.clear();
+
 	// Remove userdata reference to avoid it sticking around after GC
 	if (ref)
 		ref->unref();
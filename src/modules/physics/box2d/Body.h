@@ -25,11 +25,16 @@
 #include "common/math.h"
 #include "common/runtime.h"
 #include "common/Object.h"
+#include "common/Vector.h"
 #include "physics/Body.h"
+#include "ObjectPool.h"
 
 // Box2D
 #include <box2d/Box2D.h>
 
+// C++
+#include <vector>
+
 namespace love
 {
 namespace physics
@@ -39,6 +44,7 @@ namespace box2d
 // Forward declarations.
 class World;
 class Shape;
+class ChainShape;
 
 /**
  * A Body is an entity which has position and orientation
@@ -56,6 +62,7 @@ public:
 	friend class CircleShape;
 	friend class PolygonShape;
 	friend class Shape;
+	friend class World;
 
 	// Public because joints et al ask for b2body
 	b2Body *body;
@@ -67,6 +74,10 @@ public:
 
 	virtual ~Body();
 
+	// Allocated from ObjectPool.
+	static void *operator new(size_t size) { return ObjectPool::allocate(size); }
+	static void operator delete(void *mem, size_t size) { ObjectPool::deallocate(mem, size); }
+
 	/**
 	 * Gets the current x-position of the Body.
 	 **/
@@ -122,6 +133,19 @@ public:
 	 **/
 	void getKinematicState(b2Vec2 &pos_o, float &a_o, b2Vec2& vel_o, float &da_o) const;
 
+	/**
+	 * Blends the Body's position and angle from before the World's last fixed
+	 * time step with its current ones (see World::setFixedTimestep).
+	 * @param alpha 0 for the previous state, 1 for the current one.
+	 **/
+	void getInterpolatedTransform(float alpha, b2Vec2 &pos_o, float &a_o) const;
+
+	/**
+	 * Remembers the current position and angle as the previous state used by
+	 * getInterpolatedTransform. Called by the World before each fixed step.
+	 **/
+	void savePreviousTransform();
+
 	/**
 	 * Gets the Body's mass.
 	 **/
@@ -400,6 +424,16 @@ public:
 	 **/
 	int getShapes(lua_State *L) const;
 
+	/**
+	 * Replaces the chains set by the last call with one ChainShape per
+	 * polyline. coords holds the vertices of every polyline one after the
+	 * other, and counts holds the number of vertices in each. Chains whose
+	 * vertices haven't changed since the last call keep their existing
+	 * shapes, so only the parts which changed create new fixtures.
+	 **/
+	void setChains(bool loop, const Vector2 *coords, const int *counts, int chaincount);
+	const std::vector<StrongRef<ChainShape>> &getChains() const;
+
 	/**
 	 * Get an array of all Joints attached to this Body.
 	 **/
@@ -437,9 +471,16 @@ private:
 
 	bool hasCustomMass;
 
+	// Position and angle before the World's last fixed time step.
+	b2Vec2 previousPosition;
+	float previousAngle;
+
 	// Reference to arbitrary data.
 	Reference* ref = nullptr;
 
+	// Shapes created by setChains, in order.
+	std::vector<StrongRef<ChainShape>> chains;
+
 }; // Body
 
 } // box2d
@@ -109,6 +109,23 @@ const b2Vec2 *ChainShape::getPoints() const
 	return c->m_vertices;
 }
 
+bool ChainShape::hasSameVertices(const b2ChainShape &other) const
+{
+	throwIfShapeNotValid();
+	b2ChainShape *c = (b2ChainShape *)shape;
+
+	if (c->m_count != other.m_count || c->m_prevVertex != other.m_prevVertex || c->m_nextVertex != other.m_nextVertex)
+		return false;
+
+	for (int i = 0; i < c->m_count; i++)
+	{
+		if (c->m_vertices[i] != other.m_vertices[i])
+			return false;
+	}
+
+	return true;
+}
+
 } // box2d
 } // physics
 } // love
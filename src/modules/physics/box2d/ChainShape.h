@@ -101,6 +101,12 @@ public:
 	 **/
 	const b2Vec2 *getPoints() const;
 
+	/**
+	 * Returns true if the shape's vertices (including the previous and next
+	 * ghost vertices) are exactly the same as the given chain's.
+	 **/
+	bool hasSameVertices(const b2ChainShape &c) const;
+
 };
 
 } // box2d
@@ -25,6 +25,7 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "World.h"
+#include "ObjectPool.h"
 
 // Box2D
 #include <box2d/Box2D.h>
@@ -61,6 +62,10 @@ public:
 
 	virtual ~Contact();
 
+	// Allocated from ObjectPool.
+	static void *operator new(size_t size) { return ObjectPool::allocate(size); }
+	static void operator delete(void *mem, size_t size) { ObjectPool::deallocate(mem, size); }
+
 	/**
 	 * Removes the b2Contact pointer from Memoizer and sets it
 	 * to null on the Contact.
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "DebugDraw.h"
+#include "Physics.h"
+#include "graphics/Graphics.h"
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+DebugDraw::DebugDraw(graphics::Graphics *gfx)
+	: gfx(gfx)
+	, color(gfx->getColor())
+{
+}
+
+DebugDraw::~DebugDraw()
+{
+	gfx->setColor(color);
+}
+
+void DebugDraw::setVertices(const b2Vec2 *verts, int32 count)
+{
+	vertices.resize(count);
+	for (int32 i = 0; i < count; i++)
+	{
+		b2Vec2 v = Physics::scaleUp(verts[i]);
+		vertices[i] = Vector2(v.x, v.y);
+	}
+}
+
+void DebugDraw::setCircleVertices(const b2Vec2 &center, float radius)
+{
+	b2Vec2 c = Physics::scaleUp(center);
+	float r = Physics::scaleUp(radius);
+
+	vertices.resize(CIRCLE_SEGMENTS);
+	for (int i = 0; i < CIRCLE_SEGMENTS; i++)
+	{
+		float phi = (float) i * (2.0f * b2_pi / (float) CIRCLE_SEGMENTS);
+		vertices[i] = Vector2(c.x + r * cosf(phi), c.y + r * sinf(phi));
+	}
+}
+
+void DebugDraw::fill(const b2Color &c)
+{
+	if (vertices.size() < 3)
+		return;
+
+	const Matrix4 &t = gfx->getTransform();
+	bool is2D = t.isAffine2DTransform();
+
+	graphics::Graphics::BatchedDrawCommand cmd;
+	cmd.formats[0] = graphics::getSinglePositionFormat(is2D);
+	cmd.formats[1] = graphics::CommonFormat::STf_RGBAub;
+	cmd.indexMode = graphics::TRIANGLEINDEX_FAN;
+	cmd.vertexCount = (int) vertices.size();
+
+	graphics::Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+
+	if (is2D)
+		t.transformXY((Vector2 *) data.stream[0], vertices.data(), cmd.vertexCount);
+	else
+		t.transformXY0((Vector3 *) data.stream[0], vertices.data(), cmd.vertexCount);
+
+	Color32 c32 = toColor32(color * Colorf(c.r, c.g, c.b, c.a));
+	graphics::STf_RGBAub *attributes = (graphics::STf_RGBAub *) data.stream[1];
+	for (int i = 0; i < cmd.vertexCount; i++)
+	{
+		attributes[i].s = 0.0f;
+		attributes[i].t = 0.0f;
+		attributes[i].color = c32;
+	}
+}
+
+void DebugDraw::outline(const b2Color &c)
+{
+	if (vertices.size() < 2)
+		return;
+
+	// Close the loop for polyline.
+	vertices.push_back(vertices[0]);
+	gfx->setColor(color * Colorf(c.r, c.g, c.b, c.a));
+	gfx->polyline(vertices.data(), vertices.size());
+}
+
+void DebugDraw::DrawPolygon(const b2Vec2 *verts, int32 vertexCount, const b2Color &c)
+{
+	setVertices(verts, vertexCount);
+	outline(c);
+}
+
+void DebugDraw::DrawSolidPolygon(const b2Vec2 *verts, int32 vertexCount, const b2Color &c)
+{
+	setVertices(verts, vertexCount);
+	fill(b2Color(c.r * 0.5f, c.g * 0.5f, c.b * 0.5f, c.a * 0.5f));
+	outline(c);
+}
+
+void DebugDraw::DrawCircle(const b2Vec2 &center, float radius, const b2Color &c)
+{
+	setCircleVertices(center, radius);
+	outline(c);
+}
+
+void DebugDraw::DrawSolidCircle(const b2Vec2 &center, float radius, const b2Vec2 &axis, const b2Color &c)
+{
+	setCircleVertices(center, radius);
+	fill(b2Color(c.r * 0.5f, c.g * 0.5f, c.b * 0.5f, c.a * 0.5f));
+	outline(c);
+	DrawSegment(center, center + radius * axis, c);
+}
+
+void DebugDraw::DrawSegment(const b2Vec2 &p1, const b2Vec2 &p2, const b2Color &c)
+{
+	b2Vec2 a = Physics::scaleUp(p1);
+	b2Vec2 b = Physics::scaleUp(p2);
+	Vector2 line[2] = {Vector2(a.x, a.y), Vector2(b.x, b.y)};
+	gfx->setColor(color * Colorf(c.r, c.g, c.b, c.a));
+	gfx->polyline(line, 2);
+}
+
+void DebugDraw::DrawTransform(const b2Transform &xf)
+{
+	const float axisScale = 0.4f;
+	DrawSegment(xf.p, xf.p + axisScale * xf.q.GetXAxis(), b2Color(1.0f, 0.0f, 0.0f));
+	DrawSegment(xf.p, xf.p + axisScale * xf.q.GetYAxis(), b2Color(0.0f, 1.0f, 0.0f));
+}
+
+void DebugDraw::DrawPoint(const b2Vec2 &p, float size, const b2Color &c)
+{
+	b2Vec2 center = Physics::scaleUp(p);
+	float h = size * 0.5f;
+	vertices.resize(4);
+	vertices[0] = Vector2(center.x - h, center.y - h);
+	vertices[1] = Vector2(center.x + h, center.y - h);
+	vertices[2] = Vector2(center.x + h, center.y + h);
+	vertices[3] = Vector2(center.x - h, center.y + h);
+	fill(c);
+}
+
+} // box2d
+} // physics
+} // love
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_DEBUG_DRAW_H
+#define LOVE_PHYSICS_BOX2D_DEBUG_DRAW_H
+
+// LOVE
+#include "common/Color.h"
+#include "common/Vector.h"
+
+// Box2D
+#include <box2d/Box2D.h>
+
+// STD
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+class Graphics;
+}
+
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * Draws a Box2D world's debug geometry with love.graphics. Filled shapes are
+ * written straight into the batched draw stream, so a whole World is drawn
+ * with a handful of draw calls.
+ **/
+class DebugDraw : public b2Draw
+{
+public:
+
+	DebugDraw(graphics::Graphics *gfx);
+	virtual ~DebugDraw();
+
+	void DrawPolygon(const b2Vec2 *vertices, int32 vertexCount, const b2Color &color) override;
+	void DrawSolidPolygon(const b2Vec2 *vertices, int32 vertexCount, const b2Color &color) override;
+	void DrawCircle(const b2Vec2 &center, float radius, const b2Color &color) override;
+	void DrawSolidCircle(const b2Vec2 &center, float radius, const b2Vec2 &axis, const b2Color &color) override;
+	void DrawSegment(const b2Vec2 &p1, const b2Vec2 &p2, const b2Color &color) override;
+	void DrawTransform(const b2Transform &xf) override;
+	void DrawPoint(const b2Vec2 &p, float size, const b2Color &color) override;
+
+	// The number of segments used for circles.
+	static const int CIRCLE_SEGMENTS = 24;
+
+private:
+
+	// Fills or outlines the closed polygon in the vertices array.
+	void fill(const b2Color &color);
+	void outline(const b2Color &color);
+
+	void setVertices(const b2Vec2 *vertices, int32 count);
+	void setCircleVertices(const b2Vec2 &center, float radius);
+
+	graphics::Graphics *gfx;
+
+	// The color set when drawing started, applied on top of Box2D's colors.
+	Colorf color;
+
+	std::vector<Vector2> vertices;
+
+}; // DebugDraw
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_DEBUG_DRAW_H
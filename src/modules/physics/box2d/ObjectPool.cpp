@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ObjectPool.h"
+#include "thread/threads.h"
+
+// STD
+#include <new>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+namespace
+{
+
+struct FreeBlock
+{
+	FreeBlock *next;
+};
+
+const size_t SIZE_CLASS_COUNT = ObjectPool::MAX_BLOCK_SIZE / ObjectPool::BLOCK_ALIGN;
+
+struct Pool
+{
+	love::thread::MutexRef mutex;
+	FreeBlock *freeBlocks[SIZE_CLASS_COUNT] = {};
+	size_t freeCounts[SIZE_CLASS_COUNT] = {};
+
+	void clear()
+	{
+		for (size_t i = 0; i < SIZE_CLASS_COUNT; i++)
+		{
+			while (freeBlocks[i] != nullptr)
+			{
+				FreeBlock *block = freeBlocks[i];
+				freeBlocks[i] = block->next;
+				::operator delete(block);
+			}
+			freeCounts[i] = 0;
+		}
+	}
+};
+
+Pool &getPool()
+{
+	// Never destroyed, objects can still be freed during static destruction.
+	static Pool *pool = new Pool();
+	return *pool;
+}
+
+size_t getSizeClass(size_t size)
+{
+	return (size + ObjectPool::BLOCK_ALIGN - 1) / ObjectPool::BLOCK_ALIGN - 1;
+}
+
+} // anonymous namespace
+
+void *ObjectPool::allocate(size_t size)
+{
+	if (size == 0 || size > MAX_BLOCK_SIZE)
+		return ::operator new(size);
+
+	size_t sizeclass = getSizeClass(size);
+	Pool &pool = getPool();
+
+	{
+		love::thread::Lock lock(pool.mutex);
+		FreeBlock *block = pool.freeBlocks[sizeclass];
+		if (block != nullptr)
+		{
+			pool.freeBlocks[sizeclass] = block->next;
+			pool.freeCounts[sizeclass]--;
+			return block;
+		}
+	}
+
+	return ::operator new((sizeclass + 1) * BLOCK_ALIGN);
+}
+
+void ObjectPool::deallocate(void *mem, size_t size)
+{
+	if (mem == nullptr)
+		return;
+
+	if (size == 0 || size > MAX_BLOCK_SIZE)
+	{
+		::operator delete(mem);
+		return;
+	}
+
+	size_t sizeclass = getSizeClass(size);
+	Pool &pool = getPool();
+
+	{
+		love::thread::Lock lock(pool.mutex);
+		if (pool.freeCounts[sizeclass] < MAX_FREE_BLOCKS)
+		{
+			FreeBlock *block = (FreeBlock *) mem;
+			block->next = pool.freeBlocks[sizeclass];
+			pool.freeBlocks[sizeclass] = block;
+			pool.freeCounts[sizeclass]++;
+			return;
+		}
+	}
+
+	::operator delete(mem);
+}
+
+void ObjectPool::clear()
+{
+	Pool &pool = getPool();
+	love::thread::Lock lock(pool.mutex);
+	pool.clear();
+}
+
+} // box2d
+} // physics
+} // love
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_OBJECT_POOL_H
+#define LOVE_PHYSICS_BOX2D_OBJECT_POOL_H
+
+// STD
+#include <cstddef>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * Memory for Bodies, Shapes and Contacts. Freed blocks are kept for reuse,
+ * since games can create and destroy hundreds of them every second.
+ **/
+class ObjectPool
+{
+public:
+
+	static void *allocate(size_t size);
+	static void deallocate(void *mem, size_t size);
+
+	/**
+	 * Frees all memory kept for reuse.
+	 **/
+	static void clear();
+
+	// Blocks bigger than this are not pooled.
+	static const size_t MAX_BLOCK_SIZE = 512;
+
+	// Block sizes are rounded up to a multiple of this.
+	static const size_t BLOCK_ALIGN = 16;
+
+	// The number of free blocks kept per block size.
+	static const size_t MAX_FREE_BLOCKS = 1024;
+
+}; // ObjectPool
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_OBJECT_POOL_H
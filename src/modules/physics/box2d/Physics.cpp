@@ -23,6 +23,7 @@
 // LOVE
 #include "common/math.h"
 #include "wrap_Body.h"
+#include "ObjectPool.h"
 
 namespace love
 {
@@ -33,6 +34,7 @@ namespace box2d
 
 // TODO: Make this not static.
 float Physics::meter = Physics::DEFAULT_METER;
+std::atomic<int64> Physics::stepTimeMicroseconds(0);
 
 Physics::Physics()
 	: Module(M_PHYSICS, "love.physics.box2d")
@@ -43,6 +45,7 @@ Physics::Physics()
 
 Physics::~Physics()
 {
+	ObjectPool::clear();
 }
 
 World *Physics::newWorld(float gx, float gy, bool sleep)
@@ -50,6 +53,11 @@ World *Physics::newWorld(float gx, float gy, bool sleep)
 	return new World(b2Vec2(gx, gy), sleep);
 }
 
+SpatialIndex *Physics::newSpatialIndex(SpatialIndex::Method method, float cellSize)
+{
+	return new SpatialIndex(method, cellSize);
+}
+
 Body *Physics::newBody(World *world, float x, float y, Body::Type type)
 {
 	return new Body(world, b2Vec2(x, y), type);
@@ -350,6 +358,16 @@ float Physics::getMeter()
 	return meter;
 }
 
+double Physics::getStepTime()
+{
+	return (double) stepTimeMicroseconds.load() / 1000000.0;
+}
+
+void Physics::addStepTime(double seconds)
+{
+	stepTimeMicroseconds += (int64) (seconds * 1000000.0);
+}
+
 void Physics::scaleDown(float &x, float &y)
 {
 	x /= meter;
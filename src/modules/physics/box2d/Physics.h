@@ -45,6 +45,10 @@
 #include "WheelJoint.h"
 #include "RopeJoint.h"
 #include "MotorJoint.h"
+#include "SpatialIndex.h"
+
+// C++
+#include <atomic>
 
 namespace love
 {
@@ -73,6 +77,13 @@ public:
 	 **/
 	World *newWorld(float gx, float gy, bool sleep);
 
+	/**
+	 * Creates a new SpatialIndex, independent of any World.
+	 * @param method Whether to use a dynamic AABB tree or a uniform grid.
+	 * @param cellSize The size of the grid's cells. Unused by trees.
+	 **/
+	SpatialIndex *newSpatialIndex(SpatialIndex::Method method, float cellSize);
+
 	/**
 	 * Creates a new Body at the specified position.
 	 * @param world The world to create the Body in.
@@ -283,6 +294,17 @@ public:
 	 **/
 	static float getMeter();
 
+	/**
+	 * Gets the total time spent inside World steps since the module was
+	 * loaded, in seconds. Callers take the difference between two readings.
+	 **/
+	static double getStepTime();
+
+	/**
+	 * Adds to the total returned by getStepTime.
+	 **/
+	static void addStepTime(double seconds);
+
 	/**
 	 * Scales a value down according to the current meter in pixels.
 	 * @param f The unscaled input value.
@@ -390,6 +412,9 @@ private:
 	// The length of one meter in pixels.
 	static float meter;
 
+	// Total time spent in World steps, in microseconds.
+	static std::atomic<int64> stepTimeMicroseconds;
+
 	b2BlockAllocator blockAllocator;
 
 }; // Physics
@@ -25,6 +25,7 @@
 #include "physics/Shape.h"
 #include "physics/box2d/Body.h"
 #include "common/Reference.h"
+#include "ObjectPool.h"
 
 // Box2D
 #include <box2d/Box2D.h>
@@ -55,6 +56,10 @@ public:
 
 	virtual ~Shape();
 
+	// Allocated from ObjectPool.
+	static void *operator new(size_t size) { return ObjectPool::allocate(size); }
+	static void operator delete(void *mem, size_t size) { ObjectPool::deallocate(mem, size); }
+
 	void destroy(bool implicit = false);
 
 	/**
@@ -163,8 +168,8 @@ public:
 	int setMask(lua_State *L);
 	int getCategory(lua_State *L);
 	int getMask(lua_State *L);
-	uint16 getBits(lua_State *L);
-	int pushBits(lua_State *L, uint16 bits);
+	static uint16 getBits(lua_State *L);
+	static int pushBits(lua_State *L, uint16 bits);
 
 	/**
 	 * Gets the bounding box for this Shape.
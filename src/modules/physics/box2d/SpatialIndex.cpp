@@ -0,0 +1,509 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SpatialIndex.h"
+
+#include "Physics.h"
+#include "common/Exception.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cfloat>
+#include <algorithm>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+love::Type SpatialIndex::type("SpatialIndex", &Object::type);
+
+// Cell coordinates are clamped so huge or non-finite boxes can't overflow.
+static const float MAX_CELL_COORD = 1 << 30;
+
+template <typename T>
+class TreeQueryCallback
+{
+public:
+
+	TreeQueryCallback(const b2DynamicTree &tree, const T &func)
+		: tree(tree)
+		, func(func)
+	{
+	}
+
+	bool QueryCallback(int32 proxy)
+	{
+		func((int) (intptr_t) tree.GetUserData(proxy));
+		return true;
+	}
+
+	float RayCastCallback(const b2RayCastInput &input, int32 proxy)
+	{
+		func((int) (intptr_t) tree.GetUserData(proxy));
+		return input.maxFraction;
+	}
+
+private:
+
+	const b2DynamicTree &tree;
+	const T &func;
+};
+
+// Returns whether the segment p + d * t, 0 <= t <= 1 hits the box, and the
+// smallest t at which it does.
+static bool rayCastBox(const b2Vec2 &p, const b2Vec2 &d, const b2AABB &box, float &fraction)
+{
+	float tmin = 0.0f;
+	float tmax = 1.0f;
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (fabsf(d(i)) < b2_epsilon)
+		{
+			if (p(i) < box.lowerBound(i) || p(i) > box.upperBound(i))
+				return false;
+		}
+		else
+		{
+			float inv = 1.0f / d(i);
+			float t1 = (box.lowerBound(i) - p(i)) * inv;
+			float t2 = (box.upperBound(i) - p(i)) * inv;
+			if (t1 > t2)
+				std::swap(t1, t2);
+
+			tmin = std::max(tmin, t1);
+			tmax = std::min(tmax, t2);
+			if (tmin > tmax)
+				return false;
+		}
+	}
+
+	fraction = tmin;
+	return true;
+}
+
+SpatialIndex::SpatialIndex(Method method, float cellSize)
+	: method(method)
+	, cellSize(cellSize)
+	, count(0)
+	, queryMark(0)
+{
+	if (method == METHOD_GRID && !(cellSize > 0.0f && std::isfinite(cellSize)))
+		throw love::Exception("The cell size of a grid SpatialIndex must be a positive number.");
+}
+
+SpatialIndex::~SpatialIndex()
+{
+}
+
+SpatialIndex::Method SpatialIndex::getMethod() const
+{
+	return method;
+}
+
+float SpatialIndex::getCellSize() const
+{
+	return method == METHOD_GRID ? cellSize : 0.0f;
+}
+
+int SpatialIndex::insert(float x, float y, float w, float h)
+{
+	b2AABB aabb = makeAABB(x, y, w, h);
+
+	int index = 0;
+	if (!freeEntries.empty())
+	{
+		index = freeEntries.back();
+		freeEntries.pop_back();
+	}
+	else
+	{
+		index = (int) entries.size();
+		entries.emplace_back();
+	}
+
+	Entry &entry = entries[index];
+	entry.aabb = aabb;
+	entry.used = true;
+	entry.proxy = -1;
+
+	if (method == METHOD_TREE)
+		entry.proxy = tree.CreateProxy(Physics::scaleDown(aabb), (void *) (intptr_t) index);
+	else
+	{
+		entry.range = getCellRange(aabb);
+		addToCells(index, entry.range);
+	}
+
+	count++;
+	return index + 1;
+}
+
+void SpatialIndex::move(int handle, float x, float y, float w, float h)
+{
+	Entry &entry = getEntry(handle);
+	b2AABB aabb = makeAABB(x, y, w, h);
+
+	if (method == METHOD_TREE)
+	{
+		b2Vec2 displacement = aabb.GetCenter() - entry.aabb.GetCenter();
+		tree.MoveProxy(entry.proxy, Physics::scaleDown(aabb), Physics::scaleDown(displacement));
+	}
+	else
+	{
+		CellRange range = getCellRange(aabb);
+		const CellRange &old = entry.range;
+
+		if (range.minX != old.minX || range.minY != old.minY || range.maxX != old.maxX || range.maxY != old.maxY)
+		{
+			removeFromCells(handle - 1, old);
+			addToCells(handle - 1, range);
+			entry.range = range;
+		}
+	}
+
+	entry.aabb = aabb;
+}
+
+void SpatialIndex::remove(int handle)
+{
+	Entry &entry = getEntry(handle);
+
+	if (method == METHOD_TREE)
+		tree.DestroyProxy(entry.proxy);
+	else
+		removeFromCells(handle - 1, entry.range);
+
+	entry.used = false;
+	freeEntries.push_back(handle - 1);
+	count--;
+}
+
+void SpatialIndex::clear()
+{
+	for (int i = 0; i < (int) entries.size(); i++)
+	{
+		if (entries[i].used && method == METHOD_TREE)
+			tree.DestroyProxy(entries[i].proxy);
+	}
+
+	entries.clear();
+	freeEntries.clear();
+	cells.clear();
+	queryMarks.clear();
+	count = 0;
+}
+
+bool SpatialIndex::contains(int handle) const
+{
+	return handle >= 1 && handle <= (int) entries.size() && entries[handle - 1].used;
+}
+
+void SpatialIndex::getBoundingBox(int handle, float &x, float &y, float &w, float &h) const
+{
+	const Entry &entry = getEntry(handle);
+	x = entry.aabb.lowerBound.x;
+	y = entry.aabb.lowerBound.y;
+	w = entry.aabb.upperBound.x - x;
+	h = entry.aabb.upperBound.y - y;
+}
+
+int SpatialIndex::getCount() const
+{
+	return count;
+}
+
+void SpatialIndex::queryBoundingBox(float x, float y, float w, float h, std::vector<int> &handles) const
+{
+	b2AABB aabb = makeAABB(x, y, w, h);
+
+	queryCandidates(aabb, [&](int index)
+	{
+		const b2AABB &box = entries[index].aabb;
+		if (box.lowerBound.x <= aabb.upperBound.x && box.upperBound.x >= aabb.lowerBound.x
+			&& box.lowerBound.y <= aabb.upperBound.y && box.upperBound.y >= aabb.lowerBound.y)
+			handles.push_back(index + 1);
+	});
+}
+
+void SpatialIndex::queryRadius(float x, float y, float radius, std::vector<int> &handles) const
+{
+	if (radius < 0.0f)
+		throw love::Exception("Query radius must not be negative.");
+
+	b2AABB aabb = makeAABB(x - radius, y - radius, radius * 2.0f, radius * 2.0f);
+	float radius2 = radius * radius;
+
+	queryCandidates(aabb, [&](int index)
+	{
+		const b2AABB &box = entries[index].aabb;
+		float dx = x - std::min(std::max(x, box.lowerBound.x), box.upperBound.x);
+		float dy = y - std::min(std::max(y, box.lowerBound.y), box.upperBound.y);
+		if (dx * dx + dy * dy <= radius2)
+			handles.push_back(index + 1);
+	});
+}
+
+void SpatialIndex::rayCast(float x1, float y1, float x2, float y2, std::vector<RayHit> &hits) const
+{
+	b2Vec2 p1(x1, y1);
+	b2Vec2 p2(x2, y2);
+	b2Vec2 d = p2 - p1;
+
+	size_t first = hits.size();
+
+	auto test = [&](int index)
+	{
+		float fraction = 0.0f;
+		if (rayCastBox(p1, d, entries[index].aabb, fraction))
+			hits.push_back({index + 1, fraction});
+	};
+
+	// Box2D's ray casts need a segment with a length.
+	if (d.LengthSquared() > 0.0f)
+		rayCastCandidates(p1, p2, test);
+	else
+		queryCandidates(makeAABB(x1, y1, 0.0f, 0.0f), test);
+
+	std::stable_sort(hits.begin() + first, hits.end(), [](const RayHit &a, const RayHit &b)
+	{
+		return a.fraction < b.fraction;
+	});
+}
+
+SpatialIndex::Entry &SpatialIndex::getEntry(int handle)
+{
+	if (!contains(handle))
+		throw love::Exception("Invalid SpatialIndex handle: %d", handle);
+	return entries[handle - 1];
+}
+
+const SpatialIndex::Entry &SpatialIndex::getEntry(int handle) const
+{
+	if (!contains(handle))
+		throw love::Exception("Invalid SpatialIndex handle: %d", handle);
+	return entries[handle - 1];
+}
+
+b2AABB SpatialIndex::makeAABB(float x, float y, float w, float h) const
+{
+	if (!(w >= 0.0f && h >= 0.0f))
+		throw love::Exception("Bounding box width and height must not be negative.");
+
+	b2AABB aabb;
+	aabb.lowerBound = b2Vec2(x, y);
+	aabb.upperBound = b2Vec2(x + w, y + h);
+	return aabb;
+}
+
+int SpatialIndex::getCellCoord(float v) const
+{
+	float c = floorf(v / cellSize);
+	if (!(c > -MAX_CELL_COORD))
+		return (int) -MAX_CELL_COORD;
+	if (!(c < MAX_CELL_COORD))
+		return (int) MAX_CELL_COORD;
+	return (int) c;
+}
+
+SpatialIndex::CellRange SpatialIndex::getCellRange(const b2AABB &aabb) const
+{
+	CellRange range;
+	range.minX = getCellCoord(aabb.lowerBound.x);
+	range.minY = getCellCoord(aabb.lowerBound.y);
+	range.maxX = getCellCoord(aabb.upperBound.x);
+	range.maxY = getCellCoord(aabb.upperBound.y);
+	return range;
+}
+
+int64 SpatialIndex::getCellKey(int x, int y)
+{
+	return (int64) (((uint64) (uint32) x << 32) | (uint32) y);
+}
+
+void SpatialIndex::addToCells(int index, const CellRange &range)
+{
+	for (int y = range.minY; y <= range.maxY; y++)
+	{
+		for (int x = range.minX; x <= range.maxX; x++)
+			cells[getCellKey(x, y)].push_back(index);
+	}
+}
+
+void SpatialIndex::removeFromCells(int index, const CellRange &range)
+{
+	for (int y = range.minY; y <= range.maxY; y++)
+	{
+		for (int x = range.minX; x <= range.maxX; x++)
+		{
+			auto it = cells.find(getCellKey(x, y));
+			if (it == cells.end())
+				continue;
+
+			std::vector<int> &cell = it->second;
+			auto pos = std::find(cell.begin(), cell.end(), index);
+			if (pos != cell.end())
+			{
+				*pos = cell.back();
+				cell.pop_back();
+			}
+
+			if (cell.empty())
+				cells.erase(it);
+		}
+	}
+}
+
+template <typename T>
+void SpatialIndex::queryCandidates(const b2AABB &aabb, const T &func) const
+{
+	if (method == METHOD_TREE)
+	{
+		TreeQueryCallback<T> callback(tree, func);
+		tree.Query(&callback, Physics::scaleDown(aabb));
+		return;
+	}
+
+	CellRange range = getCellRange(aabb);
+	uint32 mark = beginQuery();
+
+	for (int y = range.minY; y <= range.maxY; y++)
+	{
+		for (int x = range.minX; x <= range.maxX; x++)
+		{
+			auto it = cells.find(getCellKey(x, y));
+			if (it == cells.end())
+				continue;
+
+			for (int index : it->second)
+			{
+				if (queryMarks[index] != mark)
+				{
+					queryMarks[index] = mark;
+					func(index);
+				}
+			}
+		}
+	}
+}
+
+template <typename T>
+void SpatialIndex::rayCastCandidates(const b2Vec2 &p1, const b2Vec2 &p2, const T &func) const
+{
+	if (method == METHOD_TREE)
+	{
+		b2RayCastInput input;
+		input.p1 = Physics::scaleDown(p1);
+		input.p2 = Physics::scaleDown(p2);
+		input.maxFraction = 1.0f;
+
+		TreeQueryCallback<T> callback(tree, func);
+		tree.RayCast(&callback, input);
+		return;
+	}
+
+	// Walk the cells crossed by the segment, in order.
+	b2Vec2 d = p2 - p1;
+
+	int x = getCellCoord(p1.x);
+	int y = getCellCoord(p1.y);
+	int endX = getCellCoord(p2.x);
+	int endY = getCellCoord(p2.y);
+
+	int stepX = endX > x ? 1 : -1;
+	int stepY = endY > y ? 1 : -1;
+
+	float tmaxX = FLT_MAX, tdeltaX = FLT_MAX;
+	float tmaxY = FLT_MAX, tdeltaY = FLT_MAX;
+
+	if (d.x != 0.0f)
+	{
+		tmaxX = ((x + (stepX > 0 ? 1 : 0)) * cellSize - p1.x) / d.x;
+		tdeltaX = cellSize / fabsf(d.x);
+	}
+
+	if (d.y != 0.0f)
+	{
+		tmaxY = ((y + (stepY > 0 ? 1 : 0)) * cellSize - p1.y) / d.y;
+		tdeltaY = cellSize / fabsf(d.y);
+	}
+
+	int64 steps = std::abs((int64) endX - x) + std::abs((int64) endY - y);
+	uint32 mark = beginQuery();
+
+	for (int64 i = 0; ; i++)
+	{
+		auto it = cells.find(getCellKey(x, y));
+		if (it != cells.end())
+		{
+			for (int index : it->second)
+			{
+				if (queryMarks[index] != mark)
+				{
+					queryMarks[index] = mark;
+					func(index);
+				}
+			}
+		}
+
+		if (i >= steps)
+			break;
+
+		// Always end up in the end cell, even if rounding disagrees.
+		if (x != endX && (y == endY || tmaxX < tmaxY))
+		{
+			x += stepX;
+			tmaxX += tdeltaX;
+		}
+		else
+		{
+			y += stepY;
+			tmaxY += tdeltaY;
+		}
+	}
+}
+
+uint32 SpatialIndex::beginQuery() const
+{
+	if (queryMarks.size() < entries.size())
+		queryMarks.resize(entries.size(), 0);
+
+	if (++queryMark == 0)
+	{
+		std::fill(queryMarks.begin(), queryMarks.end(), 0);
+		queryMark = 1;
+	}
+
+	return queryMark;
+}
+
+STRINGMAP_CLASS_BEGIN(SpatialIndex, SpatialIndex::Method, SpatialIndex::METHOD_MAX_ENUM, method)
+{
+	{ "tree", SpatialIndex::METHOD_TREE },
+	{ "grid", SpatialIndex::METHOD_GRID },
+}
+STRINGMAP_CLASS_END(SpatialIndex, SpatialIndex::Method, SpatialIndex::METHOD_MAX_ENUM, method)
+
+} // box2d
+} // physics
+} // love
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_SPATIAL_INDEX_H
+#define LOVE_PHYSICS_BOX2D_SPATIAL_INDEX_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "common/int.h"
+
+// STD
+#include <vector>
+#include <unordered_map>
+
+// Box2D
+#include <box2d/Box2D.h>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * A broad-phase index of axis-aligned boxes which aren't tied to a World,
+ * for things like culling, triggers and AI queries. Boxes are identified by
+ * integer handles (starting at 1), which are reused after being removed.
+ *
+ * The index is either a Box2D dynamic AABB tree, which suits boxes of mixed
+ * sizes spread over a large area, or a uniform grid, which is cheaper to
+ * update when many similarly-sized boxes move every frame.
+ *
+ * Query results are exact: only boxes which really overlap the queried
+ * area, circle or ray are returned.
+ **/
+class SpatialIndex : public Object
+{
+public:
+
+	static love::Type type;
+
+	enum Method
+	{
+		METHOD_TREE,
+		METHOD_GRID,
+		METHOD_MAX_ENUM
+	};
+
+	struct RayHit
+	{
+		int handle;
+		float fraction;
+	};
+
+	SpatialIndex(Method method, float cellSize);
+	virtual ~SpatialIndex();
+
+	Method getMethod() const;
+	float getCellSize() const;
+
+	int insert(float x, float y, float w, float h);
+	void move(int handle, float x, float y, float w, float h);
+	void remove(int handle);
+	void clear();
+
+	bool contains(int handle) const;
+	void getBoundingBox(int handle, float &x, float &y, float &w, float &h) const;
+	int getCount() const;
+
+	/**
+	 * Each query appends the handles of the boxes it finds to the given
+	 * vector, in no particular order.
+	 **/
+	void queryBoundingBox(float x, float y, float w, float h, std::vector<int> &handles) const;
+	void queryRadius(float x, float y, float radius, std::vector<int> &handles) const;
+
+	/**
+	 * Appends every box hit by the segment from (x1, y1) to (x2, y2), sorted by
+	 * the fraction along the segment at which it's entered. Boxes containing
+	 * the start of the segment are hit at fraction 0.
+	 **/
+	void rayCast(float x1, float y1, float x2, float y2, std::vector<RayHit> &hits) const;
+
+	STRINGMAP_CLASS_DECLARE(Method);
+
+private:
+
+	struct CellRange
+	{
+		int minX, minY, maxX, maxY;
+	};
+
+	struct Entry
+	{
+		b2AABB aabb;
+		bool used;
+
+		// Tree proxy for METHOD_TREE, or covered cells for METHOD_GRID.
+		int proxy;
+		CellRange range;
+	};
+
+	Entry &getEntry(int handle);
+	const Entry &getEntry(int handle) const;
+
+	b2AABB makeAABB(float x, float y, float w, float h) const;
+
+	int getCellCoord(float v) const;
+	CellRange getCellRange(const b2AABB &aabb) const;
+	static int64 getCellKey(int x, int y);
+
+	void addToCells(int index, const CellRange &range);
+	void removeFromCells(int index, const CellRange &range);
+
+	// Calls func(index) once for each box whose grid cells or tree proxy
+	// overlap aabb. Boxes aren't tested against the area itself.
+	template <typename T>
+	void queryCandidates(const b2AABB &aabb, const T &func) const;
+
+	// Same as queryCandidates, for the boxes near the segment from p1 to p2.
+	template <typename T>
+	void rayCastCandidates(const b2Vec2 &p1, const b2Vec2 &p2, const T &func) const;
+
+	// Starts a new query, returning the mark value used to visit each box in
+	// the grid at most once.
+	uint32 beginQuery() const;
+
+	Method method;
+	float cellSize;
+
+	std::vector<Entry> entries;
+	std::vector<int> freeEntries;
+	int count;
+
+	b2DynamicTree tree;
+	std::unordered_map<int64, std::vector<int>> cells;
+
+	mutable std::vector<uint32> queryMarks;
+	mutable uint32 queryMark;
+
+}; // SpatialIndex
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_SPATIAL_INDEX_H
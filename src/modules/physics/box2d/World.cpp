@@ -23,12 +23,21 @@
 #include "Shape.h"
 #include "Contact.h"
 #include "Physics.h"
+#include "DebugDraw.h"
 #include "common/Reference.h"
+#include "thread/JobSystem.h"
+#include "profiler/Profiler.h"
+#include "timer/Timer.h"
 
 // Needed for World::getJoints. It should be moved to wrapper code...
 #include "wrap_Joint.h"
 #include "wrap_Shape.h"
 
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <functional>
+
 namespace love
 {
 namespace physics
@@ -76,7 +85,7 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 				throw love::Exception("A Shape has escaped Memoizer!");
 		}
 
-		Contact *cobj = (Contact *)world->findObject(contact);
+		Contact *cobj = (Contact *) contact->GetUserData().pointer;
 		if (!cobj)
 			cobj = new Contact(world, contact);
 		else
@@ -261,14 +270,69 @@ void World::SayGoodbye(b2Joint *joint)
 	if (j) j->destroyJoint(true);
 }
 
+// Collects the Shapes found by one query of World::getShapesInAreaBatch.
+class BatchQueryCallback : public b2QueryCallback
+{
+public:
+
+	BatchQueryCallback(uint16 categoryMask, std::vector<Shape *> &shapes)
+		: categoryMask(categoryMask)
+		, shapes(shapes)
+	{}
+
+	bool ReportFixture(b2Fixture *f) override
+	{
+		if (categoryMask == 0xFFFF || (categoryMask & f->GetFilterData().categoryBits) != 0)
+			shapes.push_back((Shape *)(f->GetUserData().pointer));
+		return true;
+	}
+
+private:
+
+	uint16 categoryMask;
+	std::vector<Shape *> &shapes;
+};
+
+// Calls func(first, last) on consecutive blocks of [0, count), on the
+// runner's threads if there is one.
+static void runBatchBlocks(b2TaskRunner *runner, int count, const std::function<void(int, int)> &func)
+{
+	const int blockSize = 64;
+	int blockCount = (count + blockSize - 1) / blockSize;
+
+	std::function<void(int)> block = [&](int i)
+	{
+		func(i * blockSize, std::min(count, (i + 1) * blockSize));
+	};
+
+	if (runner != nullptr && blockCount > 1)
+	{
+		auto task = [](int32 i, void *context) { (*(std::function<void(int)> *) context)(i); };
+		runner->ParallelFor(blockCount, task, &block);
+	}
+	else
+	{
+		for (int i = 0; i < blockCount; i++)
+			block(i);
+	}
+}
+
 World::World()
 	: world(nullptr)
+	, taskRunner(nullptr)
 	, destructWorld(false)
 	, begin(this)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, contactEventCategories(0xFFFF)
+	, fixedTimestep(0.0f)
+	, maxFixedSteps(0)
+	, fixedTimeAccumulator(0.0f)
 {
+	for (int i = 0; i < CONTACT_EVENT_MAX_ENUM; i++)
+		contactEventBuffered[i] = false;
+
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
 	world->SetContactListener(this);
@@ -276,17 +340,44 @@ World::World()
 	world->SetDestructionListener(this);
 	b2BodyDef def;
 	groundBody = world->CreateBody(&def);
-	registerObject(world, this);
+}
+
+World::TaskRunner::TaskRunner()
+	: jobSystem(love::thread::JobSystem::acquireShared())
+{
+}
+
+World::TaskRunner::~TaskRunner()
+{
+	love::thread::JobSystem::releaseShared();
+}
+
+void World::TaskRunner::ParallelFor(int32 count, b2TaskFunction *task, void *context)
+{
+	jobSystem->runParallel(count, [&](int i) { task(i, context); });
+}
+
+int32 World::TaskRunner::GetThreadCount() const
+{
+	return jobSystem->getWorkerCount() + 1;
 }
 
 World::World(b2Vec2 gravity, bool sleep)
 	: world(nullptr)
+	, taskRunner(nullptr)
 	, destructWorld(false)
 	, begin(this)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, contactEventCategories(0xFFFF)
+	, fixedTimestep(0.0f)
+	, maxFixedSteps(0)
+	, fixedTimeAccumulator(0.0f)
 {
+	for (int i = 0; i < CONTACT_EVENT_MAX_ENUM; i++)
+		contactEventBuffered[i] = false;
+
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
 	world->SetContactListener(this);
@@ -294,7 +385,6 @@ World::World(b2Vec2 gravity, bool sleep)
 	world->SetDestructionListener(this);
 	b2BodyDef def;
 	groundBody = world->CreateBody(&def);
-	registerObject(world, this);
 }
 
 World::~World()
@@ -309,8 +399,47 @@ void World::update(float dt)
 
 void World::update(float dt, int velocityIterations, int positionIterations)
 {
+	LOVE_PROFILE_ZONE("love.physics.World:update");
+
+	contactEvents.clear();
+
+	if (fixedTimestep <= 0.0f)
+	{
+		step(dt, velocityIterations, positionIterations);
+		return;
+	}
+
+	fixedTimeAccumulator += dt;
+
+	int steps = 0;
+	while (fixedTimeAccumulator >= fixedTimestep && steps < maxFixedSteps && isValid())
+	{
+		for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+		{
+			Body *body = (Body *)(b->GetUserData().pointer);
+			if (body != nullptr)
+				body->savePreviousTransform();
+		}
+
+		step(fixedTimestep, velocityIterations, positionIterations);
+		fixedTimeAccumulator -= fixedTimestep;
+		steps++;
+	}
+
+	// Drop the time we couldn't catch up on, rather than falling further
+	// behind every update.
+	if (fixedTimeAccumulator >= fixedTimestep)
+		fixedTimeAccumulator = fmodf(fixedTimeAccumulator, fixedTimestep);
+}
+
+void World::step(float dt, int velocityIterations, int positionIterations)
+{
+	double starttime = love::timer::Timer::getTime();
+
 	world->Step(dt, velocityIterations, positionIterations);
 
+	Physics::addStepTime(love::timer::Timer::getTime() - starttime);
+
 	// Destroy all objects marked during the time step.
 	for (Body *b : destructBodies)
 	{
@@ -340,15 +469,28 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 
 void World::BeginContact(b2Contact *contact)
 {
-	begin.process(contact);
+	if (contactEventBuffered[CONTACT_EVENT_BEGIN])
+		bufferContactEvent(CONTACT_EVENT_BEGIN, contact, nullptr);
+	else
+		begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (contactEventBuffered[CONTACT_EVENT_END])
+		bufferContactEvent(CONTACT_EVENT_END, contact, nullptr);
+	else
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
-	Contact *c = (Contact *)findObject(contact);
+	Contact *c = (Contact *) contact->GetUserData().pointer;
+	if (c != nullptr)
+		c->invalidate();
+}
+
+void World::DestroyContact(b2Contact *contact)
+{
+	Contact *c = (Contact *) contact->GetUserData().pointer;
 	if (c != nullptr)
 		c->invalidate();
 }
@@ -356,12 +498,59 @@ void World::EndContact(b2Contact *contact)
 void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 {
 	B2_NOT_USED(oldManifold); // not sure what to do with this
-	presolve.process(contact);
+	if (contactEventBuffered[CONTACT_EVENT_PRESOLVE])
+		bufferContactEvent(CONTACT_EVENT_PRESOLVE, contact, nullptr);
+	else
+		presolve.process(contact);
 }
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
-	postsolve.process(contact, impulse);
+	if (contactEventBuffered[CONTACT_EVENT_POSTSOLVE])
+		bufferContactEvent(CONTACT_EVENT_POSTSOLVE, contact, impulse);
+	else
+		postsolve.process(contact, impulse);
+}
+
+void World::bufferContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	b2Fixture *fixtureA = contact->GetFixtureA();
+	b2Fixture *fixtureB = contact->GetFixtureB();
+
+	uint16 categories = fixtureA->GetFilterData().categoryBits | fixtureB->GetFilterData().categoryBits;
+	if ((categories & contactEventCategories) == 0)
+		return;
+
+	Shape *a = (Shape *)(fixtureA->GetUserData().pointer);
+	Shape *b = (Shape *)(fixtureB->GetUserData().pointer);
+	if (a == nullptr || b == nullptr)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	contactEvents.emplace_back();
+	ContactEvent &e = contactEvents.back();
+	e.type = type;
+	e.shapeA.set(a);
+	e.shapeB.set(b);
+	e.normal = b2Vec2(0.0f, 0.0f);
+	e.pointCount = 0;
+
+	if (impulse != nullptr)
+		e.pointCount = impulse->count;
+	else if (type != CONTACT_EVENT_END)
+		e.pointCount = contact->GetManifold()->pointCount;
+
+	if (e.pointCount > 0)
+	{
+		b2WorldManifold manifold;
+		contact->GetWorldManifold(&manifold);
+		e.normal = manifold.normal;
+	}
+
+	for (int i = 0; i < b2_maxManifoldPoints; i++)
+	{
+		e.normalImpulses[i] = impulse != nullptr && i < impulse->count ? Physics::scaleUp(impulse->normalImpulses[i]) : 0.0f;
+		e.tangentImpulses[i] = impulse != nullptr && i < impulse->count ? Physics::scaleUp(impulse->tangentImpulses[i]) : 0.0f;
+	}
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
@@ -505,6 +694,245 @@ bool World::isSleepingAllowed() const
 	return world->GetAllowSleeping();
 }
 
+void World::setContactEventBuffered(ContactEventType type, bool buffered)
+{
+	contactEventBuffered[type] = buffered;
+}
+
+bool World::isContactEventBuffered(ContactEventType type) const
+{
+	return contactEventBuffered[type];
+}
+
+void World::setContactEventCategories(uint16 categories)
+{
+	contactEventCategories = categories;
+}
+
+uint16 World::getContactEventCategories() const
+{
+	return contactEventCategories;
+}
+
+const std::vector<World::ContactEvent> &World::getContactEvents() const
+{
+	return contactEvents;
+}
+
+void World::clearContactEvents()
+{
+	contactEvents.clear();
+}
+
+int World::getKinematicStates(const std::vector<Body *> &bodies, void *dst, size_t size, bool interpolate) const
+{
+	const size_t stride = sizeof(float) * KINEMATIC_STATE_FLOATS;
+	size_t count = bodies.empty() ? (size_t) getBodyCount() : bodies.size();
+	if (count * stride > size)
+		throw love::Exception("Data is too small to hold the states of %d bodies.", (int) count);
+
+	uint8 *out = (uint8 *) dst;
+
+	float alpha = getInterpolationAlpha();
+
+	auto write = [&](const Body *body)
+	{
+		b2Vec2 pos, vel;
+		float angle, spin;
+		body->getKinematicState(pos, angle, vel, spin);
+		if (interpolate)
+			body->getInterpolatedTransform(alpha, pos, angle);
+		float state[KINEMATIC_STATE_FLOATS] = {pos.x, pos.y, angle, vel.x, vel.y, spin};
+		memcpy(out, state, stride);
+		out += stride;
+	};
+
+	if (bodies.empty())
+	{
+		for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+		{
+			const Body *body = (const Body *)(b->GetUserData().pointer);
+			if (b != groundBody && body != nullptr)
+				write(body);
+		}
+	}
+	else
+	{
+		for (const Body *body : bodies)
+			write(body);
+	}
+
+	return (int) count;
+}
+
+int World::setKinematicStates(const std::vector<Body *> &bodies, const void *src, size_t size)
+{
+	if (world->IsLocked())
+		throw love::Exception("Cannot set body states while the World is being updated.");
+
+	const size_t stride = sizeof(float) * KINEMATIC_STATE_FLOATS;
+	size_t count = bodies.empty() ? (size_t) getBodyCount() : bodies.size();
+	if (count * stride > size)
+		throw love::Exception("Data is too small to hold the states of %d bodies.", (int) count);
+
+	const uint8 *in = (const uint8 *) src;
+
+	auto read = [&](b2Body *b)
+	{
+		float state[KINEMATIC_STATE_FLOATS];
+		memcpy(state, in, stride);
+		in += stride;
+		b->SetTransform(Physics::scaleDown(b2Vec2(state[0], state[1])), state[2]);
+		b->SetLinearVelocity(Physics::scaleDown(b2Vec2(state[3], state[4])));
+		b->SetAngularVelocity(state[5]);
+	};
+
+	if (bodies.empty())
+	{
+		for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+		{
+			if (b != groundBody)
+				read(b);
+		}
+	}
+	else
+	{
+		for (Body *body : bodies)
+			read(body->body);
+	}
+
+	return (int) count;
+}
+
+void World::setFixedTimestep(float step, int maxSteps)
+{
+	if (step < 0.0f)
+		throw love::Exception("The fixed time step must not be negative.");
+	if (step > 0.0f && maxSteps < 1)
+		throw love::Exception("The maximum number of fixed time steps must be at least 1.");
+
+	fixedTimestep = step;
+	maxFixedSteps = maxSteps;
+	fixedTimeAccumulator = 0.0f;
+
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		Body *body = (Body *)(b->GetUserData().pointer);
+		if (body != nullptr)
+			body->savePreviousTransform();
+	}
+}
+
+void World::getFixedTimestep(float &step, int &maxSteps) const
+{
+	step = fixedTimestep;
+	maxSteps = maxFixedSteps;
+}
+
+float World::getInterpolationAlpha() const
+{
+	if (fixedTimestep <= 0.0f)
+		return 1.0f;
+	return std::min(fixedTimeAccumulator / fixedTimestep, 1.0f);
+}
+
+// A saved World state starts with the size of the Box2D state and the fixed
+// time step state, followed by the Box2D state.
+size_t World::getStateSize() const
+{
+	size_t bodies = (size_t) getBodyCount() * sizeof(float) * 3;
+	return sizeof(int32) + sizeof(float) + bodies + (size_t) world->GetStateSize();
+}
+
+void World::saveState(void *dst, size_t size) const
+{
+	if (world->IsLocked())
+		throw love::Exception("Cannot save the World's state while it is being updated.");
+
+	if (size < getStateSize())
+		throw love::Exception("Data is too small to hold the World's state.");
+
+	uint8 *out = (uint8 *) dst;
+
+	int32 box2dSize = world->GetStateSize();
+	memcpy(out, &box2dSize, sizeof(int32));
+	out += sizeof(int32);
+
+	memcpy(out, &fixedTimeAccumulator, sizeof(float));
+	out += sizeof(float);
+
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		const Body *body = (const Body *)(b->GetUserData().pointer);
+		if (b == groundBody || body == nullptr)
+			continue;
+		float previous[3] = {body->previousPosition.x, body->previousPosition.y, body->previousAngle};
+		memcpy(out, previous, sizeof(previous));
+		out += sizeof(previous);
+	}
+
+	world->SaveState(out);
+}
+
+void World::restoreState(const void *src, size_t size)
+{
+	if (world->IsLocked())
+		throw love::Exception("Cannot restore the World's state while it is being updated.");
+
+	const uint8 *in = (const uint8 *) src;
+	size_t headerSize = sizeof(int32) + sizeof(float) + (size_t) getBodyCount() * sizeof(float) * 3;
+
+	int32 box2dSize = 0;
+	if (size >= sizeof(int32))
+		memcpy(&box2dSize, in, sizeof(int32));
+
+	if (size < headerSize || box2dSize < 0 || (size_t) box2dSize > size - headerSize
+		|| !world->RestoreState(in + headerSize, box2dSize))
+		throw love::Exception("The state doesn't belong to this World, or its Bodies, Shapes or Joints have changed.");
+
+	in += sizeof(int32);
+	memcpy(&fixedTimeAccumulator, in, sizeof(float));
+	in += sizeof(float);
+
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		Body *body = (Body *)(b->GetUserData().pointer);
+		if (b == groundBody || body == nullptr)
+			continue;
+		float previous[3];
+		memcpy(previous, in, sizeof(previous));
+		in += sizeof(previous);
+		body->previousPosition.Set(previous[0], previous[1]);
+		body->previousAngle = previous[2];
+	}
+}
+
+void World::setMultithreaded(bool enable)
+{
+	if (enable == isMultithreaded())
+		return;
+
+	if (world->IsLocked())
+		throw love::Exception("Cannot change multithreading while the World is being updated.");
+
+	if (enable)
+	{
+		taskRunner = new TaskRunner();
+		world->SetTaskRunner(taskRunner);
+	}
+	else
+	{
+		world->SetTaskRunner(nullptr);
+		delete taskRunner;
+		taskRunner = nullptr;
+	}
+}
+
+bool World::isMultithreaded() const
+{
+	return taskRunner != nullptr;
+}
+
 bool World::isLocked() const
 {
 	return world->IsLocked();
@@ -573,7 +1001,7 @@ int World::getContacts(lua_State *L)
 	do
 	{
 		if (!c) break;
-		Contact *contact = (Contact *)findObject(c);
+		Contact *contact = (Contact *) c->GetUserData().pointer;
 		if (!contact)
 			contact = new Contact(this, c);
 		else
@@ -694,6 +1122,106 @@ int World::rayCastClosest(lua_State *L)
 	return 0;
 }
 
+int World::rayCastBatch(const void *rays, int count, uint16 categoryMask, bool any, void *hits, Shape **shapes) const
+{
+	const uint8 *in = (const uint8 *) rays;
+	uint8 *out = (uint8 *) hits;
+
+	// Queries only read the broad-phase, so rays can be cast concurrently as
+	// long as the World isn't in the middle of a step.
+	b2TaskRunner *runner = world->IsLocked() ? nullptr : taskRunner;
+	std::atomic<int> hitCount(0);
+	std::atomic<bool> escaped(false);
+
+	runBatchBlocks(runner, count, [&](int first, int last)
+	{
+		int blockHits = 0;
+		for (int i = first; i < last; i++)
+		{
+			float ray[QUERY_FLOATS];
+			memcpy(ray, in + i * sizeof(ray), sizeof(ray));
+
+			RayCastOneCallback raycast(categoryMask, any);
+			b2Vec2 v1 = Physics::scaleDown(b2Vec2(ray[0], ray[1]));
+			b2Vec2 v2 = Physics::scaleDown(b2Vec2(ray[2], ray[3]));
+			world->RayCast(&raycast, v1, v2);
+
+			float hit[RAYCAST_HIT_FLOATS] = {0.0f, 0.0f, 0.0f, 0.0f, -1.0f};
+			shapes[i] = nullptr;
+
+			if (raycast.hitFixture)
+			{
+				b2Vec2 hitPoint = Physics::scaleUp(raycast.hitPoint);
+				hit[0] = hitPoint.x;
+				hit[1] = hitPoint.y;
+				hit[2] = raycast.hitNormal.x;
+				hit[3] = raycast.hitNormal.y;
+				hit[4] = raycast.hitFraction;
+				shapes[i] = (Shape *)(raycast.hitFixture->GetUserData().pointer);
+				if (shapes[i] == nullptr)
+					escaped = true;
+				blockHits++;
+			}
+
+			memcpy(out + i * sizeof(hit), hit, sizeof(hit));
+		}
+		hitCount += blockHits;
+	});
+
+	if (escaped)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	return hitCount;
+}
+
+void World::getShapesInAreaBatch(const void *areas, int count, uint16 categoryMask, std::vector<Shape *> &shapes, std::vector<int> &counts) const
+{
+	const uint8 *in = (const uint8 *) areas;
+
+	std::vector<std::vector<Shape *>> found(count);
+	b2TaskRunner *runner = world->IsLocked() ? nullptr : taskRunner;
+
+	runBatchBlocks(runner, count, [&](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			float area[QUERY_FLOATS];
+			memcpy(area, in + i * sizeof(area), sizeof(area));
+
+			b2AABB box;
+			box.lowerBound = Physics::scaleDown(b2Vec2(area[0], area[1]));
+			box.upperBound = Physics::scaleDown(b2Vec2(area[2], area[3]));
+
+			BatchQueryCallback query(categoryMask, found[i]);
+			world->QueryAABB(&query, box);
+		}
+	});
+
+	counts.reserve(counts.size() + count);
+	for (const std::vector<Shape *> &result : found)
+	{
+		for (Shape *shape : result)
+		{
+			if (shape == nullptr)
+				throw love::Exception("A Shape has escaped Memoizer!");
+			shapes.push_back(shape);
+		}
+		counts.push_back((int) result.size());
+	}
+}
+
+void World::debugDraw(graphics::Graphics *gfx, uint32 flags)
+{
+	if (world->IsLocked())
+		throw love::Exception("Cannot draw the World while it is being updated.");
+
+	DebugDraw draw(gfx);
+	draw.SetFlags(flags);
+	world->SetDebugDraw(&draw);
+	world->DebugDraw();
+	world->SetDebugDraw(nullptr);
+}
+
 void World::destroy()
 {
 	if (world == nullptr)
@@ -730,31 +1258,41 @@ void World::destroy()
 	}
 
 	world->DestroyBody(groundBody);
-	unregisterObject(world);
 
 	delete world;
 	world = nullptr;
+
+	contactEvents.clear();
+
+	delete taskRunner;
+	taskRunner = nullptr;
 }
 
-void World::registerObject(void *b2object, love::Object *object)
+bool World::getConstant(const char *in, ContactEventType &out)
 {
-	box2dObjectMap[b2object] = object;
+	return contactEventTypes.find(in, out);
 }
 
-void World::unregisterObject(void *b2object)
+bool World::getConstant(ContactEventType in, const char *&out)
 {
-	box2dObjectMap.erase(b2object);
+	return contactEventTypes.find(in, out);
 }
 
-love::Object *World::findObject(void *b2object) const
+std::vector<std::string> World::getConstants(ContactEventType)
 {
-	auto it = box2dObjectMap.find(b2object);
-	if (it != box2dObjectMap.end())
-		return it->second;
-	else
-		return nullptr;
+	return contactEventTypes.getNames();
 }
 
+StringMap<World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM>::Entry World::contactEventTypeEntries[] =
+{
+	{"begincontact", World::CONTACT_EVENT_BEGIN},
+	{"endcontact", World::CONTACT_EVENT_END},
+	{"presolve", World::CONTACT_EVENT_PRESOLVE},
+	{"postsolve", World::CONTACT_EVENT_POSTSOLVE},
+};
+
+StringMap<World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM> World::contactEventTypes(World::contactEventTypeEntries, sizeof(World::contactEventTypeEntries));
+
 } // box2d
 } // physics
 } // love
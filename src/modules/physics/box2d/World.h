@@ -25,16 +25,26 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/StringMap.h"
 
 // STD
 #include <vector>
-#include <unordered_map>
 
 // Box2D
 #include <box2d/Box2D.h>
 
 namespace love
 {
+namespace thread
+{
+class JobSystem;
+}
+
+namespace graphics
+{
+class Graphics;
+}
+
 namespace physics
 {
 namespace box2d
@@ -69,6 +79,36 @@ public:
 
 	static love::Type type;
 
+	// x, y, angle, linear velocity x and y, angular velocity.
+	static const int KINEMATIC_STATE_FLOATS = 6;
+
+	// x1, y1, x2, y2 of a ray, or of the corners of an area.
+	static const int QUERY_FLOATS = 4;
+
+	// x, y, normal x and y, and fraction of a raycast hit.
+	static const int RAYCAST_HIT_FLOATS = 5;
+
+	enum ContactEventType
+	{
+		CONTACT_EVENT_BEGIN,
+		CONTACT_EVENT_END,
+		CONTACT_EVENT_PRESOLVE,
+		CONTACT_EVENT_POSTSOLVE,
+		CONTACT_EVENT_MAX_ENUM
+	};
+
+	// A contact callback recorded during update, see setContactEventBuffered.
+	struct ContactEvent
+	{
+		ContactEventType type;
+		StrongRef<Shape> shapeA;
+		StrongRef<Shape> shapeB;
+		b2Vec2 normal;
+		int pointCount;
+		float normalImpulses[b2_maxManifoldPoints];
+		float tangentImpulses[b2_maxManifoldPoints];
+	};
+
 	class ContactCallback
 	{
 	public:
@@ -90,6 +130,18 @@ public:
 		bool process(Shape *a, Shape *b);
 	};
 
+	// Runs parts of the world's time step on the shared job system.
+	class TaskRunner : public b2TaskRunner
+	{
+	public:
+		TaskRunner();
+		virtual ~TaskRunner();
+		void ParallelFor(int32 count, b2TaskFunction *task, void *context) override;
+		int32 GetThreadCount() const override;
+	private:
+		love::thread::JobSystem *jobSystem;
+	};
+
 	class QueryCallback : public b2QueryCallback
 	{
 	public:
@@ -168,9 +220,24 @@ public:
 	void update(float dt);
 	void update(float dt, int velocityIterations, int positionIterations);
 
+	/**
+	 * Makes update advance the World in steps of exactly the given size, at
+	 * most maxSteps times per update. Time left over is carried over to the
+	 * next update. A step size of 0 disables fixed time steps.
+	 **/
+	void setFixedTimestep(float step, int maxSteps);
+	void getFixedTimestep(float &step, int &maxSteps) const;
+
+	/**
+	 * Gets how far the World is between its previous and current fixed time
+	 * step, from 0 to 1. This is 1 when fixed time steps are disabled.
+	 **/
+	float getInterpolationAlpha() const;
+
 	// From b2ContactListener
 	void BeginContact(b2Contact *contact);
 	void EndContact(b2Contact *contact);
+	void DestroyContact(b2Contact *contact);
 	void PreSolve(b2Contact *contact, const b2Manifold *oldManifold);
 	void PostSolve(b2Contact *contact, const b2ContactImpulse *impulse);
 
@@ -206,6 +273,26 @@ public:
 	 **/
 	void setCallbacksL(lua_State *L);
 
+	/**
+	 * Sets whether contact events of the given type are recorded during update
+	 * and kept until the next update, instead of calling their callback.
+	 **/
+	void setContactEventBuffered(ContactEventType type, bool buffered);
+	bool isContactEventBuffered(ContactEventType type) const;
+
+	/**
+	 * Only buffered contact events where either shape belongs to one of
+	 * these categories are recorded.
+	 **/
+	void setContactEventCategories(uint16 categories);
+	uint16 getContactEventCategories() const;
+
+	/**
+	 * Gets the contact events recorded during the last update.
+	 **/
+	const std::vector<ContactEvent> &getContactEvents() const;
+	void clearContactEvents();
+
 	/**
 	 * Sets the ContactFilter callback.
 	 **/
@@ -249,6 +336,53 @@ public:
 	 **/
 	bool isSleepingAllowed() const;
 
+	/**
+	 * Sets whether this World solves separate groups of touching bodies, and
+	 * updates contacts, on multiple threads. Callbacks are still called from
+	 * the thread updating the World, but postSolve is called once all groups
+	 * have been solved.
+	 **/
+	void setMultithreaded(bool enable);
+
+	/**
+	 * Returns whether this World updates on multiple threads.
+	 **/
+	bool isMultithreaded() const;
+
+	/**
+	 * Writes the kinematic state of each body (see Body::getKinematicState) as
+	 * KINEMATIC_STATE_FLOATS consecutive floats to dst, which has room for
+	 * size bytes. Uses every body in the World, in the order of getBodies, if
+	 * bodies is empty. Positions and angles are interpolated between the last
+	 * two fixed time steps if interpolate is true. Returns the number of
+	 * bodies written.
+	 **/
+	int getKinematicStates(const std::vector<Body *> &bodies, void *dst, size_t size, bool interpolate = false) const;
+
+	/**
+	 * Sets the kinematic state of each body from floats laid out as in
+	 * getKinematicStates. Returns the number of bodies read.
+	 **/
+	int setKinematicStates(const std::vector<Body *> &bodies, const void *src, size_t size);
+
+	/**
+	 * Gets the number of bytes written by saveState.
+	 **/
+	size_t getStateSize() const;
+
+	/**
+	 * Writes the simulation state of the World to dst, which has room for
+	 * size bytes. The state can be restored into this World as long as no
+	 * Bodies, Shapes or Joints were created or destroyed since it was saved.
+	 **/
+	void saveState(void *dst, size_t size) const;
+
+	/**
+	 * Restores a state written by saveState. Contacts are recreated, so
+	 * existing Contact objects become invalid.
+	 **/
+	void restoreState(const void *src, size_t size);
+
 	/**
 	 * Returns whether this World is currently locked.
 	 * If it's locked, it's in the middle of a timestep.
@@ -316,14 +450,37 @@ public:
 	int rayCastAny(lua_State *L);
 	int rayCastClosest(lua_State *L);
 
+	/**
+	 * Casts count rays, each read as QUERY_FLOATS floats from rays, and finds
+	 * the closest Shape (or any Shape, if any is true) hit by each ray. Writes
+	 * RAYCAST_HIT_FLOATS floats per ray to hits and the hit Shape to shapes.
+	 * Rays that hit nothing get a null Shape and a fraction of -1. Rays are
+	 * cast on multiple threads if the World is multithreaded.
+	 * @return The number of rays that hit a Shape.
+	 **/
+	int rayCastBatch(const void *rays, int count, uint16 categoryMask, bool any, void *hits, Shape **shapes) const;
+
+	/**
+	 * Gets the Shapes overlapping each of count areas, read as QUERY_FLOATS
+	 * floats each from areas. The Shapes of all areas are appended to shapes
+	 * in order, and the number of Shapes found in each area to counts.
+	 **/
+	void getShapesInAreaBatch(const void *areas, int count, uint16 categoryMask, std::vector<Shape *> &shapes, std::vector<int> &counts) const;
+
+	/**
+	 * Draws the World's debug geometry (see b2Draw's flags) with the given
+	 * graphics module, using the current transform.
+	 **/
+	void debugDraw(graphics::Graphics *gfx, uint32 flags);
+
 	/**
 	 * Destroy this world.
 	 **/
 	void destroy();
 
-	void registerObject(void *b2object, love::Object *object);
-	void unregisterObject(void *b2object);
-	love::Object *findObject(void *b2object) const;
+	static bool getConstant(const char *in, ContactEventType &out);
+	static bool getConstant(ContactEventType in, const char *&out);
+	static std::vector<std::string> getConstants(ContactEventType);
 
 private:
 
@@ -333,6 +490,9 @@ private:
 	// Ground body
 	b2Body *groundBody;
 
+	// Used by Box2D when the world is multithreaded.
+	TaskRunner *taskRunner;
+
 	// The list of to be destructed bodies.
 	std::vector<Body *> destructBodies;
 	std::vector<Shape *> destructShapes;
@@ -343,7 +503,22 @@ private:
 	ContactCallback begin, end, presolve, postsolve;
 	ContactFilter filter;
 
-	std::unordered_map<void *, love::Object *> box2dObjectMap;
+	void step(float dt, int velocityIterations, int positionIterations);
+
+	void bufferContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse);
+
+	// Buffered contact events.
+	bool contactEventBuffered[CONTACT_EVENT_MAX_ENUM];
+	uint16 contactEventCategories;
+	std::vector<ContactEvent> contactEvents;
+
+	// Fixed time steps. Disabled when fixedTimestep is 0.
+	float fixedTimestep;
+	int maxFixedSteps;
+	float fixedTimeAccumulator;
+
+	static StringMap<ContactEventType, CONTACT_EVENT_MAX_ENUM>::Entry contactEventTypeEntries[];
+	static StringMap<ContactEventType, CONTACT_EVENT_MAX_ENUM> contactEventTypes;
 
 }; // World
 
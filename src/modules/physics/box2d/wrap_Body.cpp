@@ -21,6 +21,14 @@
 #include "wrap_Body.h"
 #include "wrap_Physics.h"
 #include "wrap_Shape.h"
+#include "ChainShape.h"
+
+#include "common/Data.h"
+
+// Put the Lua code directly into a raw string literal.
+static const char body_lua[] =
+#include "wrap_Body.lua"
+;
 
 namespace love
 {
@@ -633,6 +641,49 @@ int w_Body_getFixtures(lua_State *L)
 	return w_Body_getShapes(L);
 }
 
+int w_Body_setChains(lua_State *L)
+{
+	Body *t = luax_checkbody(L, 1);
+	love::Data *data = luax_checktype<love::Data>(L, 2);
+	luaL_checktype(L, 3, LUA_TTABLE);
+	bool loop = luax_optboolean(L, 4, false);
+
+	int chaincount = (int) luax_objlen(L, 3);
+	std::vector<int> counts;
+	counts.reserve(chaincount);
+
+	size_t vertexcount = 0;
+	for (int i = 1; i <= chaincount; i++)
+	{
+		lua_rawgeti(L, 3, i);
+		int count = (int) luaL_checkinteger(L, -1);
+		lua_pop(L, 1);
+
+		if (count < 0)
+			return luaL_error(L, "Invalid vertex count for chain %d: %d", i, count);
+
+		counts.push_back(count);
+		vertexcount += count;
+	}
+
+	// Two floats per vertex.
+	if (vertexcount * sizeof(Vector2) > data->getSize())
+		return luaL_error(L, "The Data is too small for %d vertices.", (int) vertexcount);
+
+	const Vector2 *coords = (const Vector2 *) data->getData();
+	luax_catchexcept(L, [&](){ t->setChains(loop, coords, counts.data(), chaincount); });
+
+	const auto &chains = t->getChains();
+	lua_createtable(L, (int) chains.size(), 0);
+	for (int i = 0; i < (int) chains.size(); i++)
+	{
+		luax_pushtype(L, chains[i].get());
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 int w_Body_getJoints(lua_State *L)
 {
 	Body *t = luax_checkbody(L, 1);
@@ -679,6 +730,93 @@ int w_Body_getUserData(lua_State *L)
 	return t->getUserData(L);
 }
 
+static Body *luax_ffi_checkbody(Proxy *p)
+{
+	Body *b = luax_ffi_checktype<Body>(p);
+	if (b == nullptr || b->body == nullptr)
+		return nullptr;
+	return b;
+}
+
+// C functions in a struct, necessary for the FFI versions of Body methods.
+struct FFI_Body
+{
+	bool (*getPosition)(Proxy *p, float *out);
+	bool (*getAngle)(Proxy *p, float *out);
+	bool (*getTransform)(Proxy *p, float *out);
+	bool (*getLinearVelocity)(Proxy *p, float *out);
+	bool (*getAngularVelocity)(Proxy *p, float *out);
+	bool (*getWorldPoint)(Proxy *p, float x, float y, float *out);
+	bool (*getLocalPoint)(Proxy *p, float x, float y, float *out);
+};
+
+static FFI_Body ffifuncs =
+{
+	[](Proxy *p, float *out) -> bool // getPosition
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		b->getPosition(out[0], out[1]);
+		return true;
+	},
+
+	[](Proxy *p, float *out) -> bool // getAngle
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		out[0] = b->getAngle();
+		return true;
+	},
+
+	[](Proxy *p, float *out) -> bool // getTransform
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		b->getPosition(out[0], out[1]);
+		out[2] = b->getAngle();
+		return true;
+	},
+
+	[](Proxy *p, float *out) -> bool // getLinearVelocity
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		b->getLinearVelocity(out[0], out[1]);
+		return true;
+	},
+
+	[](Proxy *p, float *out) -> bool // getAngularVelocity
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		out[0] = b->getAngularVelocity();
+		return true;
+	},
+
+	[](Proxy *p, float x, float y, float *out) -> bool // getWorldPoint
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		b->getWorldPoint(x, y, out[0], out[1]);
+		return true;
+	},
+
+	[](Proxy *p, float x, float y, float *out) -> bool // getLocalPoint
+	{
+		Body *b = luax_ffi_checkbody(p);
+		if (b == nullptr)
+			return false;
+		b->getLocalPoint(x, y, out[0], out[1]);
+		return true;
+	},
+};
+
 static const luaL_Reg w_Body_functions[] =
 {
 	{ "getX", w_Body_getX },
@@ -741,6 +879,7 @@ static const luaL_Reg w_Body_functions[] =
 	{ "getWorld", w_Body_getWorld },
 	{ "getShape", w_Body_getShape },
 	{ "getShapes", w_Body_getShapes },
+	{ "setChains", w_Body_setChains },
 	{ "getJoints", w_Body_getJoints },
 	{ "getContacts", w_Body_getContacts },
 	{ "destroy", w_Body_destroy },
@@ -756,7 +895,11 @@ static const luaL_Reg w_Body_functions[] =
 
 extern "C" int luaopen_body(lua_State *L)
 {
-	return luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+	int n = luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+
+	luax_runwrapper(L, body_lua, sizeof(body_lua), "Body.lua", Body::type, &ffifuncs);
+
+	return n;
 }
 
 } // box2d
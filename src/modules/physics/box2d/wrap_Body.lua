@@ -0,0 +1,123 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+local Body_mt, ffifuncspointer_str = ...
+local Body = Body_mt.__index
+
+local type, tonumber = type, tonumber
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Body functionality.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Body
+{
+	bool (*getPosition)(Proxy *p, float *out);
+	bool (*getAngle)(Proxy *p, float *out);
+	bool (*getTransform)(Proxy *p, float *out);
+	bool (*getLinearVelocity)(Proxy *p, float *out);
+	bool (*getAngularVelocity)(Proxy *p, float *out);
+	bool (*getWorldPoint)(Proxy *p, float x, float y, float *out);
+	bool (*getLocalPoint)(Proxy *p, float x, float y, float *out);
+} FFI_Body;
+]])
+
+local ffifuncs = ffi.cast("FFI_Body **", ffifuncspointer_str)[0]
+
+local values = ffi.new("float[3]")
+
+-- The regular methods are used when the FFI versions can't handle the
+-- arguments (including destroyed Bodies), so errors are the same either way.
+local _getPosition = Body.getPosition
+local _getAngle = Body.getAngle
+local _getTransform = Body.getTransform
+local _getLinearVelocity = Body.getLinearVelocity
+local _getAngularVelocity = Body.getAngularVelocity
+local _getWorldPoint = Body.getWorldPoint
+local _getLocalPoint = Body.getLocalPoint
+
+function Body:getPosition()
+	if type(self) == "userdata" and ffifuncs.getPosition(self, values) then
+		return tonumber(values[0]), tonumber(values[1])
+	end
+	return _getPosition(self)
+end
+
+function Body:getAngle()
+	if type(self) == "userdata" and ffifuncs.getAngle(self, values) then
+		return tonumber(values[0])
+	end
+	return _getAngle(self)
+end
+
+function Body:getTransform()
+	if type(self) == "userdata" and ffifuncs.getTransform(self, values) then
+		return tonumber(values[0]), tonumber(values[1]), tonumber(values[2])
+	end
+	return _getTransform(self)
+end
+
+function Body:getLinearVelocity()
+	if type(self) == "userdata" and ffifuncs.getLinearVelocity(self, values) then
+		return tonumber(values[0]), tonumber(values[1])
+	end
+	return _getLinearVelocity(self)
+end
+
+function Body:getAngularVelocity()
+	if type(self) == "userdata" and ffifuncs.getAngularVelocity(self, values) then
+		return tonumber(values[0])
+	end
+	return _getAngularVelocity(self)
+end
+
+function Body:getWorldPoint(x, y)
+	if type(self) == "userdata" and type(x) == "number" and type(y) == "number"
+		and ffifuncs.getWorldPoint(self, x, y, values) then
+		return tonumber(values[0]), tonumber(values[1])
+	end
+	return _getWorldPoint(self, x, y)
+end
+
+function Body:getLocalPoint(x, y)
+	if type(self) == "userdata" and type(x) == "number" and type(y) == "number"
+		and ffifuncs.getLocalPoint(self, x, y, values) then
+		return tonumber(values[0]), tonumber(values[1])
+	end
+	return _getLocalPoint(self, x, y)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
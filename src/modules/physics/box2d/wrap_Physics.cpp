@@ -40,6 +40,7 @@
 #include "wrap_WheelJoint.h"
 #include "wrap_RopeJoint.h"
 #include "wrap_MotorJoint.h"
+#include "wrap_SpatialIndex.h"
 
 namespace love
 {
@@ -64,6 +65,23 @@ int w_newWorld(lua_State *L)
 	return 1;
 }
 
+int w_newSpatialIndex(lua_State *L)
+{
+	SpatialIndex::Method method = SpatialIndex::METHOD_TREE;
+	const char *methodstr = lua_isnoneornil(L, 1) ? nullptr : luaL_checkstring(L, 1);
+	if (methodstr && !SpatialIndex::getConstant(methodstr, method))
+		return luax_enumerror(L, "spatial index method", SpatialIndex::getConstants(method), methodstr);
+
+	float cellsize = (float) luaL_optnumber(L, 2, 64.0);
+
+	SpatialIndex *index = nullptr;
+	luax_catchexcept(L, [&](){ index = instance()->newSpatialIndex(method, cellsize); });
+	luax_pushtype(L, index);
+	index->release();
+
+	return 1;
+}
+
 int w_newBody(lua_State *L)
 {
 	World *world = luax_checkworld(L, 1);
@@ -778,6 +796,12 @@ int w_getMeter(lua_State *L)
 	return 1;
 }
 
+int w_getStepTime(lua_State *L)
+{
+	lua_pushnumber(L, Physics::getStepTime());
+	return 1;
+}
+
 int w_computeLinearStiffness(lua_State *L)
 {
 	float frequency = (float)luaL_checknumber(L, 1);
@@ -888,9 +912,11 @@ static const luaL_Reg functions[] =
 	{ "newWheelJoint", w_newWheelJoint },
 	{ "newRopeJoint", w_newRopeJoint },
 	{ "newMotorJoint", w_newMotorJoint },
+	{ "newSpatialIndex", w_newSpatialIndex },
 	{ "getDistance", w_getDistance },
 	{ "getMeter", w_getMeter },
 	{ "setMeter", w_setMeter },
+	{ "getStepTime", w_getStepTime },
 	{ "computeLinearStiffness", w_computeLinearStiffness },
 	{ "computeLinearFrequency", w_computeLinearFrequency },
 	{ "computeAngularStiffness", w_computeAngularStiffness },
@@ -924,6 +950,7 @@ static const lua_CFunction types[] =
 	luaopen_wheeljoint,
 	luaopen_ropejoint,
 	luaopen_motorjoint,
+	luaopen_spatialindex,
 	0
 };
 
@@ -0,0 +1,397 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_SpatialIndex.h"
+#include "common/Data.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+SpatialIndex *luax_checkspatialindex(lua_State *L, int idx)
+{
+	return luax_checktype<SpatialIndex>(L, idx);
+}
+
+// Reads a flat list of queries with the given number of numbers each, from
+// either a table or a Data containing floats.
+static void readQueries(lua_State *L, int idx, int components, std::vector<float> &queries)
+{
+	if (luax_istype(L, idx, love::Data::type))
+	{
+		love::Data *data = luax_checktype<love::Data>(L, idx);
+		size_t count = data->getSize() / (sizeof(float) * components);
+		queries.resize(count * components);
+		if (count > 0)
+			memcpy(queries.data(), data->getData(), queries.size() * sizeof(float));
+		return;
+	}
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = (int) luax_objlen(L, idx);
+	if (count % components != 0)
+		luaL_error(L, "Number of query components must be a multiple of %d (got %d)", components, count);
+
+	queries.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, idx, i + 1);
+		queries[i] = (float) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+}
+
+// Writes the values to the table or Data at idx, or to a new table if there
+// isn't one, and leaves it on the stack. Data outputs hold int32 values, and
+// get as many as fit. Stale entries in reused tables are removed.
+static void pushIntegers(lua_State *L, int idx, const std::vector<int> &values)
+{
+	if (luax_istype(L, idx, love::Data::type))
+	{
+		love::Data *data = luax_checktype<love::Data>(L, idx);
+		int32 *out = (int32 *) data->getData();
+		size_t count = std::min(values.size(), data->getSize() / sizeof(int32));
+		for (size_t i = 0; i < count; i++)
+			out[i] = values[i];
+		lua_pushvalue(L, idx);
+		return;
+	}
+
+	int oldlen = 0;
+	if (lua_istable(L, idx))
+	{
+		oldlen = (int) luax_objlen(L, idx);
+		lua_pushvalue(L, idx);
+	}
+	else
+		lua_createtable(L, (int) values.size(), 0);
+
+	for (int i = 0; i < (int) values.size(); i++)
+	{
+		lua_pushinteger(L, values[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	for (int i = (int) values.size() + 1; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+}
+
+// Same as pushIntegers, with handle and fraction pairs. Data outputs hold an
+// int32 handle followed by a float fraction for each hit.
+static void pushRayHits(lua_State *L, int idx, const std::vector<SpatialIndex::RayHit> &hits)
+{
+	if (luax_istype(L, idx, love::Data::type))
+	{
+		love::Data *data = luax_checktype<love::Data>(L, idx);
+		uint8 *out = (uint8 *) data->getData();
+		size_t count = std::min(hits.size(), data->getSize() / (sizeof(int32) + sizeof(float)));
+		for (size_t i = 0; i < count; i++)
+		{
+			int32 handle = hits[i].handle;
+			memcpy(out + i * 8, &handle, sizeof(int32));
+			memcpy(out + i * 8 + 4, &hits[i].fraction, sizeof(float));
+		}
+		lua_pushvalue(L, idx);
+		return;
+	}
+
+	int oldlen = 0;
+	if (lua_istable(L, idx))
+	{
+		oldlen = (int) luax_objlen(L, idx);
+		lua_pushvalue(L, idx);
+	}
+	else
+		lua_createtable(L, (int) hits.size() * 2, 0);
+
+	for (int i = 0; i < (int) hits.size(); i++)
+	{
+		lua_pushinteger(L, hits[i].handle);
+		lua_rawseti(L, -2, i * 2 + 1);
+		lua_pushnumber(L, hits[i].fraction);
+		lua_rawseti(L, -2, i * 2 + 2);
+	}
+
+	for (int i = (int) hits.size() * 2 + 1; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+}
+
+int w_SpatialIndex_insert(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	float w = (float) luaL_optnumber(L, 4, 0.0);
+	float h = (float) luaL_optnumber(L, 5, w);
+
+	int handle = 0;
+	luax_catchexcept(L, [&]() { handle = t->insert(x, y, w, h); });
+	lua_pushinteger(L, handle);
+	return 1;
+}
+
+int w_SpatialIndex_move(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int handle = (int) luaL_checkinteger(L, 2);
+	float x = (float) luaL_checknumber(L, 3);
+	float y = (float) luaL_checknumber(L, 4);
+
+	// The size is kept when it isn't given.
+	bool haswidth = !lua_isnoneornil(L, 5);
+	bool hasheight = !lua_isnoneornil(L, 6);
+	float w = haswidth ? (float) luaL_checknumber(L, 5) : 0.0f;
+	float h = hasheight ? (float) luaL_checknumber(L, 6) : 0.0f;
+
+	luax_catchexcept(L, [&]()
+	{
+		if (!haswidth || !hasheight)
+		{
+			float oldx, oldy, oldw, oldh;
+			t->getBoundingBox(handle, oldx, oldy, oldw, oldh);
+			w = haswidth ? w : oldw;
+			h = hasheight ? h : oldh;
+		}
+		t->move(handle, x, y, w, h);
+	});
+	return 0;
+}
+
+int w_SpatialIndex_remove(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int handle = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&]() { t->remove(handle); });
+	return 0;
+}
+
+int w_SpatialIndex_clear(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	t->clear();
+	return 0;
+}
+
+int w_SpatialIndex_contains(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int handle = (int) luaL_checkinteger(L, 2);
+	luax_pushboolean(L, t->contains(handle));
+	return 1;
+}
+
+int w_SpatialIndex_getBoundingBox(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int handle = (int) luaL_checkinteger(L, 2);
+
+	float x, y, w, h;
+	luax_catchexcept(L, [&]() { t->getBoundingBox(handle, x, y, w, h); });
+
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	lua_pushnumber(L, w);
+	lua_pushnumber(L, h);
+	return 4;
+}
+
+int w_SpatialIndex_getCount(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	lua_pushinteger(L, t->getCount());
+	return 1;
+}
+
+int w_SpatialIndex_getMethod(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	const char *str = nullptr;
+	if (!SpatialIndex::getConstant(t->getMethod(), str))
+		return luaL_error(L, "Unknown SpatialIndex method.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_SpatialIndex_getCellSize(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	lua_pushnumber(L, t->getCellSize());
+	return 1;
+}
+
+int w_SpatialIndex_queryBoundingBox(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	float w = (float) luaL_checknumber(L, 4);
+	float h = (float) luaL_checknumber(L, 5);
+
+	std::vector<int> handles;
+	luax_catchexcept(L, [&]() { t->queryBoundingBox(x, y, w, h, handles); });
+
+	pushIntegers(L, 6, handles);
+	lua_pushinteger(L, (lua_Integer) handles.size());
+	return 2;
+}
+
+int w_SpatialIndex_queryRadius(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	float radius = (float) luaL_checknumber(L, 4);
+
+	std::vector<int> handles;
+	luax_catchexcept(L, [&]() { t->queryRadius(x, y, radius, handles); });
+
+	pushIntegers(L, 5, handles);
+	lua_pushinteger(L, (lua_Integer) handles.size());
+	return 2;
+}
+
+int w_SpatialIndex_rayCast(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	float x1 = (float) luaL_checknumber(L, 2);
+	float y1 = (float) luaL_checknumber(L, 3);
+	float x2 = (float) luaL_checknumber(L, 4);
+	float y2 = (float) luaL_checknumber(L, 5);
+
+	std::vector<SpatialIndex::RayHit> hits;
+	luax_catchexcept(L, [&]() { t->rayCast(x1, y1, x2, y2, hits); });
+
+	pushRayHits(L, 6, hits);
+	lua_pushinteger(L, (lua_Integer) hits.size());
+	return 2;
+}
+
+int w_SpatialIndex_queryBoundingBoxBatch(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+
+	std::vector<float> queries;
+	readQueries(L, 2, 4, queries);
+
+	std::vector<int> handles;
+	std::vector<int> counts;
+	luax_catchexcept(L, [&]()
+	{
+		for (size_t i = 0; i < queries.size(); i += 4)
+		{
+			size_t first = handles.size();
+			t->queryBoundingBox(queries[i + 0], queries[i + 1], queries[i + 2], queries[i + 3], handles);
+			counts.push_back((int) (handles.size() - first));
+		}
+	});
+
+	pushIntegers(L, 3, handles);
+	pushIntegers(L, 4, counts);
+	return 2;
+}
+
+int w_SpatialIndex_queryRadiusBatch(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+
+	std::vector<float> queries;
+	readQueries(L, 2, 3, queries);
+
+	std::vector<int> handles;
+	std::vector<int> counts;
+	luax_catchexcept(L, [&]()
+	{
+		for (size_t i = 0; i < queries.size(); i += 3)
+		{
+			size_t first = handles.size();
+			t->queryRadius(queries[i + 0], queries[i + 1], queries[i + 2], handles);
+			counts.push_back((int) (handles.size() - first));
+		}
+	});
+
+	pushIntegers(L, 3, handles);
+	pushIntegers(L, 4, counts);
+	return 2;
+}
+
+int w_SpatialIndex_rayCastBatch(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+
+	std::vector<float> queries;
+	readQueries(L, 2, 4, queries);
+
+	std::vector<SpatialIndex::RayHit> hits;
+	std::vector<int> counts;
+	luax_catchexcept(L, [&]()
+	{
+		for (size_t i = 0; i < queries.size(); i += 4)
+		{
+			size_t first = hits.size();
+			t->rayCast(queries[i + 0], queries[i + 1], queries[i + 2], queries[i + 3], hits);
+			counts.push_back((int) (hits.size() - first));
+		}
+	});
+
+	pushRayHits(L, 3, hits);
+	pushIntegers(L, 4, counts);
+	return 2;
+}
+
+static const luaL_Reg w_SpatialIndex_functions[] =
+{
+	{ "insert", w_SpatialIndex_insert },
+	{ "move", w_SpatialIndex_move },
+	{ "remove", w_SpatialIndex_remove },
+	{ "clear", w_SpatialIndex_clear },
+	{ "contains", w_SpatialIndex_contains },
+	{ "getBoundingBox", w_SpatialIndex_getBoundingBox },
+	{ "getCount", w_SpatialIndex_getCount },
+	{ "getMethod", w_SpatialIndex_getMethod },
+	{ "getCellSize", w_SpatialIndex_getCellSize },
+	{ "queryBoundingBox", w_SpatialIndex_queryBoundingBox },
+	{ "queryRadius", w_SpatialIndex_queryRadius },
+	{ "rayCast", w_SpatialIndex_rayCast },
+	{ "queryBoundingBoxBatch", w_SpatialIndex_queryBoundingBoxBatch },
+	{ "queryRadiusBatch", w_SpatialIndex_queryRadiusBatch },
+	{ "rayCastBatch", w_SpatialIndex_rayCastBatch },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_spatialindex(lua_State *L)
+{
+	return luax_register_type(L, &SpatialIndex::type, w_SpatialIndex_functions, nullptr);
+}
+
+} // box2d
+} // physics
+} // love
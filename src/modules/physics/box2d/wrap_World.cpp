@@ -19,6 +19,11 @@
  **/
 
 #include "wrap_World.h"
+#include "wrap_Shape.h"
+#include "wrap_Body.h"
+#include "common/Data.h"
+#include "data/ByteData.h"
+#include "graphics/Graphics.h"
 
 namespace love
 {
@@ -55,6 +60,33 @@ int w_World_update(lua_State *L)
 	return 0;
 }
 
+int w_World_setFixedTimestep(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float step = (float) luaL_checknumber(L, 2);
+	int maxsteps = (int) luaL_optinteger(L, 3, 5);
+	luax_catchexcept(L, [&]() { t->setFixedTimestep(step, maxsteps); });
+	return 0;
+}
+
+int w_World_getFixedTimestep(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float step = 0.0f;
+	int maxsteps = 0;
+	t->getFixedTimestep(step, maxsteps);
+	lua_pushnumber(L, step);
+	lua_pushinteger(L, maxsteps);
+	return 2;
+}
+
+int w_World_getInterpolationAlpha(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushnumber(L, t->getInterpolationAlpha());
+	return 1;
+}
+
 int w_World_setCallbacks(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -69,6 +101,115 @@ int w_World_getCallbacks(lua_State *L)
 	return t->getCallbacks(L);
 }
 
+int w_World_setBufferedContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int argc = lua_gettop(L);
+
+	bool buffered[World::CONTACT_EVENT_MAX_ENUM] = {};
+	for (int i = 2; i <= argc; i++)
+	{
+		const char *typestr = luaL_checkstring(L, i);
+		World::ContactEventType type;
+		if (!World::getConstant(typestr, type))
+			return luax_enumerror(L, "contact event type", World::getConstants(type), typestr);
+		buffered[type] = true;
+	}
+
+	for (int i = 0; i < World::CONTACT_EVENT_MAX_ENUM; i++)
+		t->setContactEventBuffered((World::ContactEventType) i, buffered[i]);
+
+	return 0;
+}
+
+int w_World_getBufferedContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int count = 0;
+	for (int i = 0; i < World::CONTACT_EVENT_MAX_ENUM; i++)
+	{
+		const char *typestr = nullptr;
+		if (t->isContactEventBuffered((World::ContactEventType) i) && World::getConstant((World::ContactEventType) i, typestr))
+		{
+			lua_pushstring(L, typestr);
+			count++;
+		}
+	}
+	return count;
+}
+
+int w_World_setContactEventCategories(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_remove(L, 1);
+	t->setContactEventCategories(lua_gettop(L) > 0 ? Shape::getBits(L) : 0xFFFF);
+	return 0;
+}
+
+int w_World_getContactEventCategories(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	return Shape::pushBits(L, t->getContactEventCategories());
+}
+
+int w_World_getContactEventCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getContactEvents().size());
+	return 1;
+}
+
+static int w_World_pollContactEvents_i(lua_State *L)
+{
+	World *t = luax_checkworld(L, lua_upvalueindex(1));
+	size_t index = (size_t) lua_tointeger(L, lua_upvalueindex(2));
+
+	const std::vector<World::ContactEvent> &events = t->getContactEvents();
+	if (index >= events.size())
+	{
+		// All events have been handled.
+		t->clearContactEvents();
+		lua_pushinteger(L, 0);
+		lua_replace(L, lua_upvalueindex(2));
+		return 0;
+	}
+
+	lua_pushinteger(L, (lua_Integer) index + 1);
+	lua_replace(L, lua_upvalueindex(2));
+
+	const World::ContactEvent &e = events[index];
+
+	const char *typestr = nullptr;
+	World::getConstant(e.type, typestr);
+	lua_pushstring(L, typestr);
+	luax_pushshape(L, e.shapeA.get());
+	luax_pushshape(L, e.shapeB.get());
+	lua_pushnumber(L, e.normal.x);
+	lua_pushnumber(L, e.normal.y);
+
+	int args = 5;
+	if (e.type == World::CONTACT_EVENT_POSTSOLVE)
+	{
+		for (int i = 0; i < e.pointCount; i++)
+		{
+			lua_pushnumber(L, e.normalImpulses[i]);
+			lua_pushnumber(L, e.tangentImpulses[i]);
+			args += 2;
+		}
+	}
+
+	return args;
+}
+
+int w_World_pollContactEvents(lua_State *L)
+{
+	luax_checkworld(L, 1);
+	lua_pushvalue(L, 1);
+	lua_pushinteger(L, 0);
+	lua_pushcclosure(L, w_World_pollContactEvents_i, 2);
+	return 1;
+}
+
 int w_World_setContactFilter(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -123,6 +264,108 @@ int w_World_isSleepingAllowed(lua_State *L)
 	return 1;
 }
 
+int w_World_setMultithreaded(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	bool b = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setMultithreaded(b); });
+	return 0;
+}
+
+int w_World_isMultithreaded(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isMultithreaded());
+	return 1;
+}
+
+static void luax_checkbodylist(lua_State *L, int idx, std::vector<Body *> &bodies)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = (int) luax_objlen(L, idx);
+	bodies.reserve(count);
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		bodies.push_back(luax_checkbody(L, -1));
+		lua_pop(L, 1);
+	}
+}
+
+static void luax_checkstatedata(lua_State *L, int idx, Data *data, size_t &offset)
+{
+	lua_Integer o = luaL_optinteger(L, idx, 0);
+	if (o < 0 || (size_t) o > data->getSize())
+		luaL_error(L, "Invalid Data offset: %d", (int) o);
+	offset = (size_t) o;
+}
+
+int w_World_getKinematicStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	std::vector<Body *> bodies;
+	luax_checkbodylist(L, 3, bodies);
+	size_t offset = 0;
+	luax_checkstatedata(L, 4, data, offset);
+
+	bool interpolate = luax_optboolean(L, 5, false);
+
+	int count = 0;
+	luax_catchexcept(L, [&]() {
+		count = t->getKinematicStates(bodies, (uint8 *) data->getData() + offset, data->getSize() - offset, interpolate);
+	});
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
+int w_World_setKinematicStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	std::vector<Body *> bodies;
+	luax_checkbodylist(L, 3, bodies);
+	size_t offset = 0;
+	luax_checkstatedata(L, 4, data, offset);
+
+	int count = 0;
+	luax_catchexcept(L, [&]() {
+		count = t->setKinematicStates(bodies, (const uint8 *) data->getData() + offset, data->getSize() - offset);
+	});
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
+int w_World_saveState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_totype<Data>(L, 2);
+
+	size_t size = t->getStateSize();
+
+	StrongRef<Data> dst(data);
+	if (data == nullptr || data->getSize() < size)
+		luax_catchexcept(L, [&]() { dst.set(new love::data::ByteData(size, false), Acquire::NORETAIN); });
+
+	luax_catchexcept(L, [&]() { t->saveState(dst->getData(), dst->getSize()); });
+
+	luax_pushtype(L, dst.get());
+	return 1;
+}
+
+int w_World_restoreState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	luax_catchexcept(L, [&]() { t->restoreState(data->getData(), data->getSize()); });
+	return 0;
+}
+
 int w_World_isLocked(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -227,6 +470,114 @@ int w_World_rayCastClosest(lua_State *L)
 	return ret;
 }
 
+static int w_World_rayCastBatch(lua_State *L, bool any)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *rays = luax_checktype<Data>(L, 2);
+	Data *hits = luax_checktype<Data>(L, 3);
+	uint16 categoryMaskBits = (uint16) luaL_optinteger(L, 4, 0xFFFF);
+
+	size_t count = rays->getSize() / (sizeof(float) * World::QUERY_FLOATS);
+	if (hits->getSize() < count * sizeof(float) * World::RAYCAST_HIT_FLOATS)
+		return luaL_error(L, "Data is too small to hold the results of %d rays.", (int) count);
+
+	std::vector<Shape *> shapes(count);
+	int hitCount = 0;
+	luax_catchexcept(L, [&]() {
+		hitCount = t->rayCastBatch(rays->getData(), (int) count, categoryMaskBits, any, hits->getData(), shapes.data());
+	});
+
+	lua_pushinteger(L, hitCount);
+	lua_createtable(L, (int) count, 0);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (shapes[i] != nullptr)
+			luax_pushshape(L, shapes[i]);
+		else
+			luax_pushboolean(L, false);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+	return 2;
+}
+
+int w_World_rayCastAnyBatch(lua_State *L)
+{
+	return w_World_rayCastBatch(L, true);
+}
+
+int w_World_rayCastClosestBatch(lua_State *L)
+{
+	return w_World_rayCastBatch(L, false);
+}
+
+int w_World_getShapesInAreaBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *areas = luax_checktype<Data>(L, 2);
+	uint16 categoryMaskBits = (uint16) luaL_optinteger(L, 3, 0xFFFF);
+
+	int count = (int) (areas->getSize() / (sizeof(float) * World::QUERY_FLOATS));
+	std::vector<Shape *> shapes;
+	std::vector<int> counts;
+	luax_catchexcept(L, [&]() {
+		t->getShapesInAreaBatch(areas->getData(), count, categoryMaskBits, shapes, counts);
+	});
+
+	lua_createtable(L, (int) shapes.size(), 0);
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		luax_pushshape(L, shapes[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		lua_pushinteger(L, counts[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 2;
+}
+
+int w_World_debugDraw(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return luaL_error(L, "love.graphics must be loaded to draw a World.");
+
+	uint32 flags = b2Draw::e_shapeBit | b2Draw::e_jointBit;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		const struct { const char *name; uint32 bit; } options[] =
+		{
+			{ "shapes", b2Draw::e_shapeBit },
+			{ "joints", b2Draw::e_jointBit },
+			{ "boundingboxes", b2Draw::e_aabbBit },
+			{ "centers", b2Draw::e_centerOfMassBit },
+		};
+
+		for (const auto &option : options)
+		{
+			lua_getfield(L, 2, option.name);
+			if (!lua_isnoneornil(L, -1))
+			{
+				if (luax_toboolean(L, -1))
+					flags |= option.bit;
+				else
+					flags &= ~option.bit;
+			}
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&]() { t->debugDraw(gfx, flags); });
+	return 0;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -244,8 +595,17 @@ int w_World_isDestroyed(lua_State *L)
 static const luaL_Reg w_World_functions[] =
 {
 	{ "update", w_World_update },
+	{ "setFixedTimestep", w_World_setFixedTimestep },
+	{ "getFixedTimestep", w_World_getFixedTimestep },
+	{ "getInterpolationAlpha", w_World_getInterpolationAlpha },
 	{ "setCallbacks", w_World_setCallbacks },
 	{ "getCallbacks", w_World_getCallbacks },
+	{ "setBufferedContactEvents", w_World_setBufferedContactEvents },
+	{ "getBufferedContactEvents", w_World_getBufferedContactEvents },
+	{ "setContactEventCategories", w_World_setContactEventCategories },
+	{ "getContactEventCategories", w_World_getContactEventCategories },
+	{ "getContactEventCount", w_World_getContactEventCount },
+	{ "pollContactEvents", w_World_pollContactEvents },
 	{ "setContactFilter", w_World_setContactFilter },
 	{ "getContactFilter", w_World_getContactFilter },
 	{ "setGravity", w_World_setGravity },
@@ -253,6 +613,12 @@ static const luaL_Reg w_World_functions[] =
 	{ "translateOrigin", w_World_translateOrigin },
 	{ "setSleepingAllowed", w_World_setSleepingAllowed },
 	{ "isSleepingAllowed", w_World_isSleepingAllowed },
+	{ "setMultithreaded", w_World_setMultithreaded },
+	{ "isMultithreaded", w_World_isMultithreaded },
+	{ "getKinematicStates", w_World_getKinematicStates },
+	{ "setKinematicStates", w_World_setKinematicStates },
+	{ "saveState", w_World_saveState },
+	{ "restoreState", w_World_restoreState },
 	{ "isLocked", w_World_isLocked },
 	{ "getBodyCount", w_World_getBodyCount },
 	{ "getJointCount", w_World_getJointCount },
@@ -262,9 +628,13 @@ static const luaL_Reg w_World_functions[] =
 	{ "getContacts", w_World_getContacts },
 	{ "queryShapesInArea", w_World_queryShapesInArea },
 	{ "getShapesInArea", w_World_getShapesInArea },
+	{ "getShapesInAreaBatch", w_World_getShapesInAreaBatch },
 	{ "rayCast", w_World_rayCast },
 	{ "rayCastAny", w_World_rayCastAny },
 	{ "rayCastClosest", w_World_rayCastClosest },
+	{ "rayCastAnyBatch", w_World_rayCastAnyBatch },
+	{ "rayCastClosestBatch", w_World_rayCastClosestBatch },
+	{ "debugDraw", w_World_debugDraw },
 	{ "destroy", w_World_destroy },
 	{ "isDestroyed", w_World_isDestroyed },
 
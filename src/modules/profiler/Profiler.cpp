@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Profiler.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <set>
+
+namespace love
+{
+namespace profiler
+{
+
+namespace
+{
+
+// Zones pushed from Lua on the current thread: name and start time.
+thread_local std::vector<std::pair<const char *, double>> zoneStack;
+
+void appendEscaped(std::string &out, const char *str)
+{
+	for (const char *c = str; *c != '\0'; c++)
+	{
+		unsigned char ch = (unsigned char) *c;
+		if (ch == '"' || ch == '\\')
+		{
+			out += '\\';
+			out += (char) ch;
+		}
+		else if (ch < 0x20)
+		{
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", ch);
+			out += buf;
+		}
+		else
+			out += (char) ch;
+	}
+}
+
+} // anonymous namespace
+
+Profiler::Profiler()
+	: Module(M_PROFILER, "love.profiler")
+	, running(false)
+	, maxZones(DEFAULT_MAX_ZONES)
+	, droppedZones(0)
+	, mainThread(getThreadID())
+{
+}
+
+Profiler::~Profiler()
+{
+}
+
+int Profiler::getThreadID()
+{
+	static std::atomic<int> nextID(1);
+	thread_local int id = nextID.fetch_add(1);
+	return id;
+}
+
+void Profiler::start(size_t maxZones)
+{
+	if (maxZones == 0)
+		throw love::Exception("The maximum number of zones must be greater than 0.");
+
+	love::thread::Lock lock(mutex);
+	this->maxZones = maxZones;
+	zones.reserve(std::min(maxZones, (size_t) DEFAULT_MAX_ZONES));
+	running.store(true);
+}
+
+void Profiler::stop()
+{
+	running.store(false);
+}
+
+void Profiler::clear()
+{
+	love::thread::Lock lock(mutex);
+	zones.clear();
+	droppedZones = 0;
+}
+
+void Profiler::push(const std::string &name)
+{
+	const char *interned = nullptr;
+	{
+		love::thread::Lock lock(mutex);
+		interned = names.insert(name).first->c_str();
+	}
+
+	zoneStack.emplace_back(interned, love::timer::Timer::getTime());
+}
+
+void Profiler::pop()
+{
+	if (zoneStack.empty())
+		throw love::Exception("No profiler zone to pop (push and pop calls must be balanced).");
+
+	auto zone = zoneStack.back();
+	zoneStack.pop_back();
+
+	if (isRunning())
+		addZone(zone.first, zone.second, love::timer::Timer::getTime());
+}
+
+void Profiler::addZone(const char *name, double start, double end)
+{
+	int thread = getThreadID();
+
+	love::thread::Lock lock(mutex);
+
+	if (zones.size() >= maxZones)
+	{
+		droppedZones++;
+		return;
+	}
+
+	zones.push_back({name, start, end - start, thread});
+}
+
+size_t Profiler::getZoneCount() const
+{
+	love::thread::Lock lock(mutex);
+	return zones.size();
+}
+
+size_t Profiler::getDroppedZoneCount() const
+{
+	love::thread::Lock lock(mutex);
+	return droppedZones;
+}
+
+std::vector<Profiler::ZoneTotal> Profiler::getZoneTotals() const
+{
+	std::map<std::string, ZoneTotal> totals;
+
+	{
+		love::thread::Lock lock(mutex);
+		for (const Zone &zone : zones)
+		{
+			ZoneTotal &total = totals[zone.name];
+			total.count++;
+			total.time += zone.duration;
+		}
+	}
+
+	std::vector<ZoneTotal> result;
+	result.reserve(totals.size());
+
+	for (auto &kvp : totals)
+	{
+		kvp.second.name = kvp.first;
+		result.push_back(kvp.second);
+	}
+
+	std::stable_sort(result.begin(), result.end(), [](const ZoneTotal &a, const ZoneTotal &b)
+	{
+		return a.time > b.time;
+	});
+
+	return result;
+}
+
+std::string Profiler::getChromeTrace() const
+{
+	std::string out;
+	std::set<int> threads;
+	char buf[128];
+
+	out += "{\"traceEvents\":[";
+
+	love::thread::Lock lock(mutex);
+
+	out.reserve(out.size() + zones.size() * 80);
+
+	for (const Zone &zone : zones)
+	{
+		out += "{\"name\":\"";
+		appendEscaped(out, zone.name);
+		snprintf(buf, sizeof(buf), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},",
+			zone.thread, zone.start * 1000000.0, zone.duration * 1000000.0);
+		out += buf;
+		threads.insert(zone.thread);
+	}
+
+	for (int thread : threads)
+	{
+		if (thread == mainThread)
+			snprintf(buf, sizeof(buf), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"Main\"}},", thread);
+		else
+			snprintf(buf, sizeof(buf), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"Thread %d\"}},", thread, thread);
+		out += buf;
+	}
+
+	if (out.back() == ',')
+		out.pop_back();
+
+	out += "],\"displayTimeUnit\":\"ms\"}";
+	return out;
+}
+
+} // profiler
+} // love
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PROFILER_PROFILER_H
+#define LOVE_PROFILER_PROFILER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Module.h"
+#include "thread/threads.h"
+#include "timer/Timer.h"
+
+// C++
+#include <atomic>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace love
+{
+namespace profiler
+{
+
+/**
+ * Records timed zones from the engine and from Lua while a capture is
+ * running, for exporting as a Chrome trace (chrome://tracing, Perfetto).
+ **/
+class Profiler : public Module
+{
+public:
+
+	struct Zone
+	{
+		const char *name;
+		double start;
+		double duration;
+		int thread;
+	};
+
+	struct ZoneTotal
+	{
+		std::string name;
+		int count = 0;
+		double time = 0.0;
+	};
+
+	static const size_t DEFAULT_MAX_ZONES = 1 << 20;
+
+	Profiler();
+	virtual ~Profiler();
+
+	/**
+	 * Starts recording zones. Zones past maxZones are counted but not kept.
+	 **/
+	void start(size_t maxZones = DEFAULT_MAX_ZONES);
+	void stop();
+	bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+	/**
+	 * Removes all recorded zones.
+	 **/
+	void clear();
+
+	/**
+	 * Opens and closes zones on the calling thread's stack. Names are copied.
+	 **/
+	void push(const std::string &name);
+	void pop();
+
+	/**
+	 * Records a finished zone. The name must stay valid for as long as the
+	 * Profiler (string literals, for example).
+	 **/
+	void addZone(const char *name, double start, double end);
+
+	size_t getZoneCount() const;
+	size_t getDroppedZoneCount() const;
+
+	/**
+	 * Gets the number of times each zone was recorded and its total time,
+	 * sorted by total time.
+	 **/
+	std::vector<ZoneTotal> getZoneTotals() const;
+
+	/**
+	 * Gets the recorded zones in the Chrome trace event JSON format.
+	 **/
+	std::string getChromeTrace() const;
+
+private:
+
+	static int getThreadID();
+
+	std::atomic<bool> running;
+
+	love::thread::MutexRef mutex;
+	std::vector<Zone> zones;
+	size_t maxZones;
+	size_t droppedZones;
+
+	// Names of zones pushed from Lua.
+	std::unordered_set<std::string> names;
+
+	int mainThread;
+
+}; // Profiler
+
+/**
+ * Records the enclosing scope as a zone, if the profiler module is loaded and
+ * running.
+ **/
+class ScopedZone
+{
+public:
+
+	ScopedZone(const char *name)
+		: name(name)
+		, profiler(Module::getInstance<Profiler>(Module::M_PROFILER))
+		, start(0.0)
+	{
+		if (profiler != nullptr && profiler->isRunning())
+			start = love::timer::Timer::getTime();
+		else
+			profiler = nullptr;
+	}
+
+	~ScopedZone()
+	{
+		if (profiler != nullptr)
+			profiler->addZone(name, start, love::timer::Timer::getTime());
+	}
+
+private:
+
+	const char *name;
+	Profiler *profiler;
+	double start;
+
+}; // ScopedZone
+
+} // profiler
+} // love
+
+#define LOVE_PROFILE_CONCAT_(a, b) a##b
+#define LOVE_PROFILE_CONCAT(a, b) LOVE_PROFILE_CONCAT_(a, b)
+
+#if defined(LOVE_ENABLE_PROFILER)
+#	define LOVE_PROFILE_ZONE(name) love::profiler::ScopedZone LOVE_PROFILE_CONCAT(loveProfileZone, __LINE__)(name)
+#else
+#	define LOVE_PROFILE_ZONE(name)
+#endif
+
+#endif // LOVE_PROFILER_PROFILER_H
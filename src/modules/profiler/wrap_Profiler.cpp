@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Profiler.h"
+
+namespace love
+{
+namespace profiler
+{
+
+#define instance() (Module::getInstance<Profiler>(Module::M_PROFILER))
+
+int w_start(lua_State *L)
+{
+	lua_Number maxzones = luaL_optnumber(L, 1, (lua_Number) Profiler::DEFAULT_MAX_ZONES);
+	if (maxzones < 1)
+		return luaL_error(L, "The maximum number of zones must be greater than 0.");
+	luax_catchexcept(L, [&]() { instance()->start((size_t) maxzones); });
+	return 0;
+}
+
+int w_stop(lua_State *)
+{
+	instance()->stop();
+	return 0;
+}
+
+int w_isRunning(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isRunning());
+	return 1;
+}
+
+int w_clear(lua_State *)
+{
+	instance()->clear();
+	return 0;
+}
+
+int w_push(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	instance()->push(name);
+	return 0;
+}
+
+int w_pop(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->pop(); });
+	return 0;
+}
+
+int w_getZoneCount(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getZoneCount());
+	lua_pushnumber(L, (lua_Number) instance()->getDroppedZoneCount());
+	return 2;
+}
+
+int w_getZoneTotals(lua_State *L)
+{
+	std::vector<Profiler::ZoneTotal> totals = instance()->getZoneTotals();
+
+	lua_createtable(L, (int) totals.size(), 0);
+
+	for (size_t i = 0; i < totals.size(); i++)
+	{
+		const Profiler::ZoneTotal &total = totals[i];
+
+		lua_createtable(L, 0, 3);
+
+		luax_pushstring(L, total.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushinteger(L, total.count);
+		lua_setfield(L, -2, "count");
+
+		lua_pushnumber(L, total.time);
+		lua_setfield(L, -2, "time");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_getChromeTrace(lua_State *L)
+{
+	std::string trace;
+	luax_catchexcept(L, [&]() { trace = instance()->getChromeTrace(); });
+	luax_pushstring(L, trace);
+	return 1;
+}
+
+// List of functions to wrap.
+static const luaL_Reg functions[] =
+{
+	{ "start", w_start },
+	{ "stop", w_stop },
+	{ "isRunning", w_isRunning },
+	{ "clear", w_clear },
+	{ "push", w_push },
+	{ "pop", w_pop },
+	{ "getZoneCount", w_getZoneCount },
+	{ "getZoneTotals", w_getZoneTotals },
+	{ "getChromeTrace", w_getChromeTrace },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_love_profiler(lua_State *L)
+{
+	Profiler *instance = instance();
+	if (instance == nullptr)
+	{
+		luax_catchexcept(L, [&](){ instance = new Profiler(); });
+	}
+	else
+		instance->retain();
+
+	WrappedModule w;
+	w.module = instance;
+	w.name = "profiler";
+	w.type = &Module::type;
+	w.functions = functions;
+	w.types = nullptr;
+
+	return luax_register_module(L, w);
+}
+
+} // profiler
+} // love
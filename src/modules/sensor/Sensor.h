@@ -25,6 +25,9 @@
 #include "common/Module.h"
 #include "common/StringMap.h"
 
+// C++
+#include <vector>
+
 namespace love
 {
 namespace sensor
@@ -41,6 +44,16 @@ public:
 		SENSOR_MAX_ENUM
 	};
 
+	struct Sample
+	{
+		// In seconds, relative to an arbitrary point in time.
+		double time;
+		float data[3];
+	};
+
+	// Samples beyond this many are dropped (oldest first) until they're read.
+	static const int MAX_BUFFERED_SAMPLES = 4096;
+
 	virtual ~Sensor() {}
 
 	/**
@@ -63,6 +76,21 @@ public:
 	 **/
 	virtual std::vector<float> getData(SensorType type) = 0;
 
+	/**
+	 * Starts or stops keeping every sample the sensor reports, rather than
+	 * only the latest one, so they can be read in bulk with getSamples.
+	 * @param rate The most samples per second to keep, or 0 to keep all of
+	 * them.
+	 **/
+	virtual void setBuffered(SensorType type, bool buffered, double rate) = 0;
+	virtual bool isBuffered(SensorType type, double &rate) = 0;
+
+	/**
+	 * Moves the samples buffered since the last call into samples, oldest
+	 * first.
+	 **/
+	virtual void getSamples(SensorType type, std::vector<Sample> &samples) = 0;
+
 	/**
 	 * Get backend-dependent handle of sensor.
 	 **/
@@ -38,13 +38,58 @@ Sensor::Sensor()
 {
 	if (!SDL_InitSubSystem(SDL_INIT_SENSOR))
 		throw love::Exception("Could not initialize SDL sensor subsystem (%s)", SDL_GetError());
+
+	if (!SDL_AddEventWatch(watchSensorEvents, this))
+	{
+		SDL_QuitSubSystem(SDL_INIT_SENSOR);
+		throw love::Exception("Could not watch SDL sensor events (%s)", SDL_GetError());
+	}
 }
 
 Sensor::~Sensor()
 {
+	SDL_RemoveEventWatch(watchSensorEvents, this);
 	SDL_QuitSubSystem(SDL_INIT_SENSOR);
 }
 
+bool SDLCALL Sensor::watchSensorEvents(void *udata, SDL_Event *event)
+{
+	if (event->type != SDL_EVENT_SENSOR_UPDATE)
+		return true;
+
+	auto sensor = (Sensor *) udata;
+	SensorType type = convert(SDL_GetSensorTypeForID(event->sensor.which));
+	if (type == SENSOR_MAX_ENUM)
+		return true;
+
+	thread::Lock lock(sensor->sampleMutex);
+	SampleBuffer &buffer = sensor->sampleBuffers[type];
+
+	if (!buffer.enabled)
+		return true;
+
+	// Not every platform provides the time the sensor read the sample.
+	Uint64 ns = event->sensor.sensor_timestamp != 0 ? event->sensor.sensor_timestamp : event->sensor.timestamp;
+	double time = (double) ns / 1.0e9;
+
+	if (!buffer.samples.empty() && time - buffer.lastTime < buffer.interval)
+		return true;
+
+	Sample sample;
+	sample.time = time;
+	sample.data[0] = event->sensor.data[0];
+	sample.data[1] = event->sensor.data[1];
+	sample.data[2] = event->sensor.data[2];
+
+	if ((int) buffer.samples.size() >= MAX_BUFFERED_SAMPLES)
+		buffer.samples.pop_front();
+
+	buffer.samples.push_back(sample);
+	buffer.lastTime = time;
+
+	return true;
+}
+
 bool Sensor::hasSensor(SensorType type)
 {
 	int count = 0;
@@ -123,6 +168,36 @@ std::vector<float> Sensor::getData(SensorType type)
 	return values;
 }
 
+void Sensor::setBuffered(SensorType type, bool buffered, double rate)
+{
+	thread::Lock lock(sampleMutex);
+	SampleBuffer &buffer = sampleBuffers[type];
+
+	buffer.enabled = buffered;
+	buffer.interval = rate > 0.0 ? 1.0 / rate : 0.0;
+
+	if (!buffered)
+		buffer.samples.clear();
+}
+
+bool Sensor::isBuffered(SensorType type, double &rate)
+{
+	thread::Lock lock(sampleMutex);
+	const SampleBuffer &buffer = sampleBuffers[type];
+
+	rate = buffer.interval > 0.0 ? 1.0 / buffer.interval : 0.0;
+	return buffer.enabled;
+}
+
+void Sensor::getSamples(SensorType type, std::vector<Sample> &samples)
+{
+	thread::Lock lock(sampleMutex);
+	SampleBuffer &buffer = sampleBuffers[type];
+
+	samples.assign(buffer.samples.begin(), buffer.samples.end());
+	buffer.samples.clear();
+}
+
 std::vector<void*> Sensor::getHandles()
 {
 	std::vector<void*> nativeSensor;
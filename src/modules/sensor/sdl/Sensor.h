@@ -23,12 +23,15 @@
 
 // LOVE
 #include "sensor/Sensor.h"
+#include "thread/threads.h"
 
 // SDL
 #include <SDL3/SDL_sensor.h>
+#include <SDL3/SDL_events.h>
 
 // std
 #include <map>
+#include <deque>
 
 namespace love
 {
@@ -47,6 +50,9 @@ public:
 	bool isEnabled(SensorType type) override;
 	void setEnabled(SensorType type, bool enable) override;
 	std::vector<float> getData(SensorType type) override;
+	void setBuffered(SensorType type, bool buffered, double rate) override;
+	bool isBuffered(SensorType type, double &rate) override;
+	void getSamples(SensorType type, std::vector<Sample> &samples) override;
 	std::vector<void*> getHandles() override;
 	const char *getSensorName(SensorType type) override;
 
@@ -54,8 +60,23 @@ public:
 	static SDL_SensorType convert(SensorType type);
 
 private:
+
+	struct SampleBuffer
+	{
+		bool enabled = false;
+		double interval = 0.0;
+		double lastTime = 0.0;
+		std::deque<Sample> samples;
+	};
+
+	static bool SDLCALL watchSensorEvents(void *udata, SDL_Event *event);
+
 	std::map<SensorType, SDL_Sensor*> sensors;
 
+	// Filled from an event watch, which may run on another thread.
+	SampleBuffer sampleBuffers[SENSOR_MAX_ENUM];
+	love::thread::MutexRef sampleMutex;
+
 }; // Sensor
 
 } // sdl
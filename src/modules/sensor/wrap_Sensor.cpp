@@ -78,6 +78,70 @@ static int w_getData(lua_State *L)
 	return (int) data.size();
 }
 
+static int w_setBuffered(lua_State *L)
+{
+	Sensor::SensorType type = luax_checksensortype(L, 1);
+	bool buffered = luax_checkboolean(L, 2);
+	double rate = luaL_optnumber(L, 3, 0.0);
+
+	if (rate < 0.0)
+		return luaL_error(L, "Sample rate must not be negative.");
+
+	instance()->setBuffered(type, buffered, rate);
+	return 0;
+}
+
+static int w_isBuffered(lua_State *L)
+{
+	Sensor::SensorType type = luax_checksensortype(L, 1);
+
+	double rate = 0.0;
+	bool buffered = instance()->isBuffered(type, rate);
+
+	lua_pushboolean(L, buffered);
+	lua_pushnumber(L, rate);
+	return 2;
+}
+
+static int w_getSamples(lua_State *L)
+{
+	Sensor::SensorType type = luax_checksensortype(L, 1);
+
+	std::vector<Sensor::Sample> samples;
+	instance()->getSamples(type, samples);
+
+	// Flat array of time, x, y, z for each sample, reusing the given table.
+	if (lua_istable(L, 2))
+		lua_settop(L, 2);
+	else
+	{
+		lua_settop(L, 1);
+		lua_createtable(L, (int) samples.size() * 4, 0);
+	}
+
+	int index = 1;
+	for (const Sensor::Sample &sample : samples)
+	{
+		lua_pushnumber(L, sample.time);
+		lua_rawseti(L, 2, index++);
+
+		for (int i = 0; i < 3; i++)
+		{
+			lua_pushnumber(L, sample.data[i]);
+			lua_rawseti(L, 2, index++);
+		}
+	}
+
+	for (int i = (int) luax_objlen(L, 2); i >= index; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, 2, i);
+	}
+
+	lua_pushinteger(L, (lua_Integer) samples.size());
+	return 2;
+}
+
 static int w_getName(lua_State *L)
 {
 	Sensor::SensorType type = luax_checksensortype(L, 1);
@@ -94,6 +158,9 @@ static const luaL_Reg functions[] =
 	{ "isEnabled", w_isEnabled },
 	{ "setEnabled", w_setEnabled },
 	{ "getData", w_getData },
+	{ "setBuffered", w_setBuffered },
+	{ "isBuffered", w_isBuffered },
+	{ "getSamples", w_getSamples },
 	{ "getName", w_getName },
 	{ nullptr, nullptr }
 };
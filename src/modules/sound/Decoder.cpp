@@ -49,6 +49,22 @@ Decoder::Decoder(Stream *stream, int bufferSize)
 	}
 }
 
+Decoder::Decoder(int bufferSize)
+	: bufferSize(bufferSize)
+	, sampleRate(DEFAULT_SAMPLE_RATE)
+	, buffer(0)
+	, eof(false)
+{
+	try
+	{
+		buffer = new char[bufferSize];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+}
+
 Decoder::~Decoder()
 {
 	if (buffer != 0)
@@ -82,5 +98,12 @@ STRINGMAP_CLASS_BEGIN(Decoder, Decoder::StreamSource, Decoder::STREAM_MAX_ENUM,
 }
 STRINGMAP_CLASS_END(Decoder, Decoder::StreamSource, Decoder::STREAM_MAX_ENUM, streamSource)
 
+STRINGMAP_CLASS_BEGIN(Decoder, Decoder::ResampleQuality, Decoder::RESAMPLE_MAX_ENUM, resampleQuality)
+{
+	{ "linear", Decoder::RESAMPLE_LINEAR },
+	{ "cubic",  Decoder::RESAMPLE_CUBIC  },
+}
+STRINGMAP_CLASS_END(Decoder, Decoder::ResampleQuality, Decoder::RESAMPLE_MAX_ENUM, resampleQuality)
+
 } // sound
 } // love
@@ -47,6 +47,13 @@ public:
 		STREAM_MAX_ENUM
 	};
 
+	enum ResampleQuality
+	{
+		RESAMPLE_LINEAR,
+		RESAMPLE_CUBIC,
+		RESAMPLE_MAX_ENUM
+	};
+
 	static love::Type type;
 
 	Decoder(Stream *stream, int bufferSize);
@@ -152,9 +159,13 @@ public:
 	virtual double getDuration() = 0;
 
 	STRINGMAP_CLASS_DECLARE(StreamSource);
+	STRINGMAP_CLASS_DECLARE(ResampleQuality);
 
 protected:
 
+	// For decoders which read from another Decoder instead of a Stream.
+	Decoder(int bufferSize);
+
 	// A readable stream containing the encoded data.
 	StrongRef<Stream> stream;
 
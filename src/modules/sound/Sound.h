@@ -86,6 +86,15 @@ public:
 	 **/
 	virtual Decoder *newDecoder(Stream *stream, int bufferSize) = 0;
 
+	/**
+	 * Creates a Decoder which converts another Decoder's output to a
+	 * different sample rate while decoding.
+	 * @param source The Decoder to read from.
+	 * @param sampleRate The sample rate of the new Decoder.
+	 * @param quality The interpolation used for resampling.
+	 **/
+	virtual Decoder *newResamplingDecoder(Decoder *source, int sampleRate, Decoder::ResampleQuality quality) = 0;
+
 protected:
 
 	Sound(const char *name);
@@ -19,16 +19,27 @@
  **/
 
 #include "SoundData.h"
+#include "common/memory.h"
 
 // C
 #include <cstdlib>
 #include <cstring>
 
 // C++
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <iostream>
 #include <vector>
 
+#if defined(LOVE_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
 namespace love
 {
 namespace sound
@@ -36,6 +47,227 @@ namespace sound
 
 love::Type SoundData::type("SoundData", &Data::type);
 
+static const float INT16_MIN_FLOAT = -32768.0f;
+
+// Conversions match getSample and setSample, but clamp instead of wrapping.
+static inline float toFloat(uint8 v)
+{
+	return ((float) v - 128.0f) / 127.0f;
+}
+
+static inline float toFloat(int16 v)
+{
+	return (float) v / (float) LOVE_INT16_MAX;
+}
+
+static inline uint8 toUint8(float sample)
+{
+	return (uint8) std::min(std::max((sample * 127.0f) + 128.0f, 0.0f), 255.0f);
+}
+
+static inline int16 toInt16(float sample)
+{
+	return (int16) std::min(std::max(sample * (float) LOVE_INT16_MAX, INT16_MIN_FLOAT), (float) LOVE_INT16_MAX);
+}
+
+static inline float getSampleAt(const uint8 *data, int bitDepth, size_t i)
+{
+	if (bitDepth == 16)
+		return toFloat(((const int16 *) data)[i]);
+	else
+		return toFloat(data[i]);
+}
+
+static inline void setSampleAt(uint8 *data, int bitDepth, size_t i, float sample)
+{
+	if (bitDepth == 16)
+		((int16 *) data)[i] = toInt16(sample);
+	else
+		data[i] = toUint8(sample);
+}
+
+// Multiplies 16 bit samples by a gain which increases by step every sample
+// frame. The vectorized loops need 8 samples to always span the same number
+// of frames.
+static void scaleInt16(int16 *s, size_t count, int channels, float gain, float step)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2) || defined(LOVE_SIMD_NEON)
+	bool vectorize = step == 0.0f || (8 % channels) == 0;
+	float lanes[8];
+	for (int k = 0; k < 8; k++)
+		lanes[k] = gain + step * (float) (k / channels);
+	float stride = step * (float) (8 / std::min(channels, 8));
+#endif
+
+#if defined(LOVE_SIMD_SSE2)
+	if (vectorize)
+	{
+		__m128 g0 = _mm_loadu_ps(lanes + 0);
+		__m128 g1 = _mm_loadu_ps(lanes + 4);
+		const __m128 inc = _mm_set1_ps(stride);
+		const __m128 minv = _mm_set1_ps(INT16_MIN_FLOAT);
+		const __m128 maxv = _mm_set1_ps((float) LOVE_INT16_MAX);
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i p = _mm_loadu_si128((const __m128i *) (s + i));
+			__m128i sign = _mm_srai_epi16(p, 15);
+
+			__m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(p, sign)), g0);
+			__m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(p, sign)), g1);
+
+			lo = _mm_min_ps(_mm_max_ps(lo, minv), maxv);
+			hi = _mm_min_ps(_mm_max_ps(hi, minv), maxv);
+
+			_mm_storeu_si128((__m128i *) (s + i), _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi)));
+
+			g0 = _mm_add_ps(g0, inc);
+			g1 = _mm_add_ps(g1, inc);
+		}
+	}
+#elif defined(LOVE_SIMD_NEON)
+	if (vectorize)
+	{
+		float32x4_t g0 = vld1q_f32(lanes + 0);
+		float32x4_t g1 = vld1q_f32(lanes + 4);
+		const float32x4_t inc = vdupq_n_f32(stride);
+		const float32x4_t minv = vdupq_n_f32(INT16_MIN_FLOAT);
+		const float32x4_t maxv = vdupq_n_f32((float) LOVE_INT16_MAX);
+
+		for (; i + 8 <= count; i += 8)
+		{
+			int16x8_t p = vld1q_s16(s + i);
+
+			float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(p))), g0);
+			float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(p))), g1);
+
+			lo = vminq_f32(vmaxq_f32(lo, minv), maxv);
+			hi = vminq_f32(vmaxq_f32(hi, minv), maxv);
+
+			vst1q_s16(s + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+
+			g0 = vaddq_f32(g0, inc);
+			g1 = vaddq_f32(g1, inc);
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float g = gain + step * (float) (i / channels);
+		float v = std::min(std::max((float) s[i] * g, INT16_MIN_FLOAT), (float) LOVE_INT16_MAX);
+		s[i] = (int16) v;
+	}
+}
+
+// dst += src * gain, for 16 bit samples.
+static void mixInt16(int16 *dst, const int16 *src, size_t count, float gain)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128 g = _mm_set1_ps(gain);
+	const __m128 minv = _mm_set1_ps(INT16_MIN_FLOAT);
+	const __m128 maxv = _mm_set1_ps((float) LOVE_INT16_MAX);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i dsign = _mm_srai_epi16(d, 15);
+		__m128i ssign = _mm_srai_epi16(s, 15);
+
+		__m128 lo = _mm_add_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, dsign)), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(s, ssign)), g));
+		__m128 hi = _mm_add_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, dsign)), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(s, ssign)), g));
+
+		lo = _mm_min_ps(_mm_max_ps(lo, minv), maxv);
+		hi = _mm_min_ps(_mm_max_ps(hi, minv), maxv);
+
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi)));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const float32x4_t g = vdupq_n_f32(gain);
+	const float32x4_t minv = vdupq_n_f32(INT16_MIN_FLOAT);
+	const float32x4_t maxv = vdupq_n_f32((float) LOVE_INT16_MAX);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		int16x8_t d = vld1q_s16(dst + i);
+		int16x8_t s = vld1q_s16(src + i);
+
+		float32x4_t lo = vmlaq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(d))), vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), g);
+		float32x4_t hi = vmlaq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(d))), vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), g);
+
+		lo = vminq_f32(vmaxq_f32(lo, minv), maxv);
+		hi = vminq_f32(vmaxq_f32(hi, minv), maxv);
+
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float v = std::min(std::max((float) dst[i] + (float) src[i] * gain, INT16_MIN_FLOAT), (float) LOVE_INT16_MAX);
+		dst[i] = (int16) v;
+	}
+}
+
+// Largest absolute value of 16 bit samples.
+static int peakInt16(const int16 *s, size_t count)
+{
+	size_t i = 0;
+	int16 maxv = 0;
+	int16 minv = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	__m128i vmax = _mm_setzero_si128();
+	__m128i vmin = _mm_setzero_si128();
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (s + i));
+		vmax = _mm_max_epi16(vmax, p);
+		vmin = _mm_min_epi16(vmin, p);
+	}
+
+	int16 lanes[16];
+	_mm_storeu_si128((__m128i *) (lanes + 0), vmax);
+	_mm_storeu_si128((__m128i *) (lanes + 8), vmin);
+#elif defined(LOVE_SIMD_NEON)
+	int16x8_t vmax = vdupq_n_s16(0);
+	int16x8_t vmin = vdupq_n_s16(0);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		int16x8_t p = vld1q_s16(s + i);
+		vmax = vmaxq_s16(vmax, p);
+		vmin = vminq_s16(vmin, p);
+	}
+
+	int16 lanes[16];
+	vst1q_s16(lanes + 0, vmax);
+	vst1q_s16(lanes + 8, vmin);
+#endif
+
+#if defined(LOVE_SIMD_SSE2) || defined(LOVE_SIMD_NEON)
+	for (int k = 0; k < 8; k++)
+	{
+		maxv = std::max(maxv, lanes[k]);
+		minv = std::min(minv, lanes[k + 8]);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		maxv = std::max(maxv, s[i]);
+		minv = std::min(minv, s[i]);
+	}
+
+	return std::max((int) maxv, -(int) minv);
+}
+
 SoundData::SoundData(Decoder *decoder)
 	: data(0)
 	, size(0)
@@ -86,6 +318,9 @@ SoundData::SoundData(Decoder *decoder)
 	channels = decoder->getChannelCount();
 	bitDepth = decoder->getBitDepth();
 	sampleRate = decoder->getSampleRate();
+
+	if (data != 0)
+		trackAllocation(MEMORY_SOUND, size);
 }
 
 SoundData::SoundData(int samples, int sampleRate, int bitDepth, int channels)
@@ -121,7 +356,10 @@ SoundData::SoundData(const SoundData &c)
 SoundData::~SoundData()
 {
 	if (data != 0)
+	{
+		trackDeallocation(MEMORY_SOUND, size);
 		free(data);
+	}
 }
 
 SoundData *SoundData::clone() const
@@ -145,6 +383,7 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 
 	if (data != 0)
 	{
+		trackDeallocation(MEMORY_SOUND, size);
 		free(data);
 		data = 0;
 	}
@@ -163,6 +402,8 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 	if (!data)
 		throw love::Exception("Not enough memory.");
 
+	trackAllocation(MEMORY_SOUND, size);
+
 	if (newData)
 		memcpy(data, newData, size);
 	else
@@ -300,5 +541,145 @@ SoundData *SoundData::slice(int start, int length) const
 	return new SoundData(data + start * channels * bitDepth/8, length, sampleRate, bitDepth, channels);
 }
 
+void SoundData::checkRange(int start, int &count, const char *what) const
+{
+	int totalSamples = getSampleCount();
+
+	if (count < 0)
+		count = totalSamples - start;
+
+	if (start < 0 || start + count > totalSamples)
+		throw love::Exception("%s out-of-range!", what);
+}
+
+void SoundData::mix(const SoundData *src, float gain, int srcStart, int count, int dstStart)
+{
+	if (channels != src->channels)
+		throw love::Exception("Channel count mismatch!");
+
+	if (count < 0)
+		count = std::min(src->getSampleCount() - srcStart, getSampleCount() - dstStart);
+
+	checkRange(dstStart, count, "Destination");
+	src->checkRange(srcStart, count, "Source");
+
+	size_t first = (size_t) dstStart * channels;
+	size_t srcFirst = (size_t) srcStart * channels;
+	size_t n = (size_t) count * channels;
+
+	if (bitDepth == 16 && src->bitDepth == 16 && data != src->data)
+	{
+		mixInt16((int16 *) data + first, (const int16 *) src->data + srcFirst, n, gain);
+		return;
+	}
+
+	// Ranges in the same SoundData may overlap.
+	std::vector<float> temp(n);
+	for (size_t i = 0; i < n; i++)
+		temp[i] = getSampleAt(src->data, src->bitDepth, srcFirst + i);
+
+	for (size_t i = 0; i < n; i++)
+		setSampleAt(data, bitDepth, first + i, getSampleAt(data, bitDepth, first + i) + temp[i] * gain);
+}
+
+void SoundData::fade(float startGain, float endGain, int start, int count)
+{
+	checkRange(start, count, "Fade");
+
+	if (count == 0)
+		return;
+
+	float step = count > 1 ? (endGain - startGain) / (float) (count - 1) : 0.0f;
+	size_t first = (size_t) start * channels;
+
+	if (bitDepth == 16)
+		scaleInt16((int16 *) data + first, (size_t) count * channels, channels, startGain, step);
+	else
+	{
+		for (int i = 0; i < count * channels; i++)
+		{
+			float g = startGain + step * (float) (i / channels);
+			data[first + i] = toUint8(toFloat(data[first + i]) * g);
+		}
+	}
+}
+
+float SoundData::getPeak(int start, int count) const
+{
+	checkRange(start, count, "Sample range");
+
+	size_t first = (size_t) start * channels;
+	size_t n = (size_t) count * channels;
+
+	if (bitDepth == 16)
+		return std::min((float) peakInt16((const int16 *) data + first, n) / (float) LOVE_INT16_MAX, 1.0f);
+
+	float peak = 0.0f;
+	for (size_t i = 0; i < n; i++)
+		peak = std::max(peak, fabsf(toFloat(data[first + i])));
+
+	return std::min(peak, 1.0f);
+}
+
+float SoundData::normalize(float peak)
+{
+	float current = getPeak(0, -1);
+
+	// Silence can't be scaled up to anything.
+	if (current <= 0.0f)
+		return 1.0f;
+
+	float gain = peak / current;
+	fade(gain, gain, 0, -1);
+	return gain;
+}
+
+SoundData *SoundData::resample(int newSampleRate) const
+{
+	if (newSampleRate <= 0)
+		throw love::Exception("Invalid sample rate: %d", newSampleRate);
+
+	int totalSamples = getSampleCount();
+	int newSamples = std::max((int) ceil((double) totalSamples * newSampleRate / sampleRate), 1);
+
+	SoundData *resampled = new SoundData(newSamples, newSampleRate, bitDepth, channels);
+
+	double ratio = (double) sampleRate / (double) newSampleRate;
+
+	for (int i = 0; i < newSamples; i++)
+	{
+		double pos = i * ratio;
+		int i0 = std::min((int) pos, totalSamples - 1);
+		int i1 = std::min(i0 + 1, totalSamples - 1);
+		float t = (float) (pos - i0);
+
+		for (int c = 0; c < channels; c++)
+		{
+			float s0 = getSampleAt(data, bitDepth, (size_t) i0 * channels + c);
+			float s1 = getSampleAt(data, bitDepth, (size_t) i1 * channels + c);
+			setSampleAt(resampled->data, bitDepth, (size_t) i * channels + c, s0 + (s1 - s0) * t);
+		}
+	}
+
+	return resampled;
+}
+
+SoundData *SoundData::convert(int newBitDepth) const
+{
+	if (newBitDepth != 8 && newBitDepth != 16)
+		throw love::Exception("Invalid bit depth: %d", newBitDepth);
+
+	if (newBitDepth == bitDepth)
+		return clone();
+
+	SoundData *converted = new SoundData(getSampleCount(), sampleRate, newBitDepth, channels);
+
+	size_t n = (size_t) getSampleCount() * channels;
+	for (size_t i = 0; i < n; i++)
+		setSampleAt(converted->data, newBitDepth, i, getSampleAt(data, bitDepth, i));
+
+	return converted;
+}
+
 } // sound
 } // love
@@ -64,10 +64,49 @@ public:
 	void copyFrom(const SoundData *src, int srcStart, int count, int dstStart);
 	SoundData *slice(int start, int length = -1) const;
 
+	/**
+	 * Adds another SoundData's samples, multiplied by gain, to this one's.
+	 * Results are clamped instead of wrapping around. A count of -1 mixes
+	 * until the end of either SoundData.
+	 **/
+	void mix(const SoundData *src, float gain, int srcStart, int count, int dstStart);
+
+	/**
+	 * Multiplies a range of sample frames by a gain which changes linearly
+	 * from startGain to endGain. A count of -1 goes until the end.
+	 **/
+	void fade(float startGain, float endGain, int start, int count);
+
+	/**
+	 * Gets the largest absolute sample value in a range of sample frames, in
+	 * [0, 1]. A count of -1 goes until the end.
+	 **/
+	float getPeak(int start, int count) const;
+
+	/**
+	 * Scales every sample so the largest absolute sample value becomes peak.
+	 * @return The gain that was applied.
+	 **/
+	float normalize(float peak);
+
+	/**
+	 * Creates a new SoundData with the same audio at another sample rate,
+	 * using linear interpolation.
+	 **/
+	SoundData *resample(int newSampleRate) const;
+
+	/**
+	 * Creates a new SoundData with the same audio at another bit depth.
+	 **/
+	SoundData *convert(int newBitDepth) const;
+
 private:
 
 	void load(int samples, int sampleRate, int bitDepth, int channels, const void *newData = 0);
 
+	// Gets the range of sample frames [start, start + count), or throws.
+	void checkRange(int start, int &count, const char *what) const;
+
 	uint8 *data;
 	size_t size;
 
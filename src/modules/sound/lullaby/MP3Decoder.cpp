@@ -136,16 +136,9 @@ drmp3_bool32 MP3Decoder::onSeek(void *pUserData, int offset, drmp3_seek_origin o
 MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 : Decoder(stream, bufferSize)
 {
-	// Check for possible ID3 tag and skip it if necessary.
-	offset = findFirstValidHeader(stream);
-	if (offset == -1)
-		throw love::Exception("Could not find first valid mp3 header.");
-
-	// initialize mp3 handle
-	if (!drmp3_init(&mp3, onRead, onSeek, this, nullptr))
-		throw love::Exception("Could not read mp3 data.");
+	init();
 
-	sampleRate = mp3.sampleRate;
+	auto data = std::make_shared<SeekData>();
 
 	// calculate duration
 	drmp3_uint64 pcmCount, mp3FrameCount;
@@ -154,25 +147,55 @@ MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 		drmp3_uninit(&mp3);
 		throw love::Exception("Could not calculate mp3 duration.");
 	}
-	duration = ((double) pcmCount) / ((double) mp3.sampleRate);
+	data->duration = ((double) pcmCount) / ((double) mp3.sampleRate);
 
 	// create seek table
 	drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
-	seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
-	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, seekTable.data()))
+	data->seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
+	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, data->seekTable.data()))
 	{
 		drmp3_uninit(&mp3);
 		throw love::Exception("Could not calculate mp3 seek table");
 	}
+	data->seekTable.resize(mp3FrameInt);
 
 	// bind seek table
-	if (!drmp3_bind_seek_table(&mp3, mp3FrameInt, seekTable.data()))
+	if (!drmp3_bind_seek_table(&mp3, mp3FrameInt, data->seekTable.data()))
+	{
+		drmp3_uninit(&mp3);
+		throw love::Exception("Could not bind mp3 seek table");
+	}
+
+	seekData = data;
+}
+
+MP3Decoder::MP3Decoder(Stream *stream, int bufferSize, const std::shared_ptr<SeekData> &seekData)
+: Decoder(stream, bufferSize)
+, seekData(seekData)
+{
+	init();
+
+	if (!drmp3_bind_seek_table(&mp3, (drmp3_uint32) seekData->seekTable.size(), seekData->seekTable.data()))
 	{
 		drmp3_uninit(&mp3);
 		throw love::Exception("Could not bind mp3 seek table");
 	}
 }
 
+void MP3Decoder::init()
+{
+	// Check for possible ID3 tag and skip it if necessary.
+	offset = findFirstValidHeader(stream);
+	if (offset == -1)
+		throw love::Exception("Could not find first valid mp3 header.");
+
+	// initialize mp3 handle
+	if (!drmp3_init(&mp3, onRead, onSeek, this, nullptr))
+		throw love::Exception("Could not read mp3 data.");
+
+	sampleRate = mp3.sampleRate;
+}
+
 MP3Decoder::~MP3Decoder()
 {
 	drmp3_uninit(&mp3);
@@ -181,7 +204,7 @@ MP3Decoder::~MP3Decoder()
 love::sound::Decoder *MP3Decoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new MP3Decoder(s, bufferSize);
+	return new MP3Decoder(s, bufferSize, seekData);
 }
 
 int MP3Decoder::decode()
@@ -229,7 +252,7 @@ int MP3Decoder::getBitDepth() const
 
 double MP3Decoder::getDuration()
 {
-	return duration;
+	return seekData->duration;
 }
 
 } // lullaby
@@ -28,6 +28,7 @@
 // dr_mp3
 #include "dr/dr_mp3.h"
 
+#include <memory>
 #include <vector>
 
 namespace love
@@ -54,17 +55,28 @@ public:
 	double getDuration() override;
 
 private:
+
+	// Decoding the whole stream to find its seek points and duration is slow
+	// for long files, so clones share the results instead of scanning again.
+	struct SeekData
+	{
+		std::vector<drmp3_seek_point> seekTable;
+		double duration;
+	};
+
+	MP3Decoder(Stream *stream, int bufsize, const std::shared_ptr<SeekData> &seekData);
+
+	void init();
+
 	static size_t onRead(void *pUserData, void *pBufferOut, size_t bytesToRead);
 	static drmp3_bool32 onSeek(void *pUserData, int offset, drmp3_seek_origin origin);
 
 	// MP3 handle
 	drmp3 mp3;
-	// Used for fast seeking
-	std::vector<drmp3_seek_point> seekTable;
+	// Used for fast seeking, and shared with clones.
+	std::shared_ptr<SeekData> seekData;
 	// Position of first MP3 frame found
 	int64 offset;
-
-	double duration;
 }; // MP3Decoder
 
 } // lullaby
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ResamplingDecoder.h"
+#include "common/Exception.h"
+#include "common/int.h"
+
+// STD
+#include <algorithm>
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+ResamplingDecoder::ResamplingDecoder(Decoder *source, int sampleRate, ResampleQuality quality)
+	: Decoder(source->getSize())
+	, source(source)
+	, quality(quality)
+	, channels(source->getChannelCount())
+	, bitDepth(source->getBitDepth())
+	, step(1.0)
+	, position(1.0)
+	, sourceFinished(false)
+{
+	if (sampleRate <= 0)
+		throw love::Exception("Invalid sample rate: %d", sampleRate);
+
+	if (bitDepth != 8 && bitDepth != 16)
+		throw love::Exception("Invalid bit depth: %d", bitDepth);
+
+	this->sampleRate = sampleRate;
+	step = (double) source->getSampleRate() / (double) sampleRate;
+}
+
+ResamplingDecoder::~ResamplingDecoder()
+{
+}
+
+love::sound::Decoder *ResamplingDecoder::clone()
+{
+	StrongRef<Decoder> c(source->clone(), Acquire::NORETAIN);
+	return new ResamplingDecoder(c, sampleRate, quality);
+}
+
+void ResamplingDecoder::reset()
+{
+	input.clear();
+	position = 1.0;
+	sourceFinished = false;
+	eof = false;
+}
+
+bool ResamplingDecoder::readSource()
+{
+	int decoded = source->decode();
+
+	if (decoded <= 0)
+	{
+		sourceFinished = true;
+		return false;
+	}
+
+	size_t count = decoded / (bitDepth / 8);
+	size_t start = input.size();
+	bool first = start == 0;
+
+	// Repeat the first frame, so there's history before the start.
+	if (first)
+	{
+		input.resize(channels);
+		start = channels;
+	}
+
+	input.resize(start + count);
+
+	if (bitDepth == 16)
+	{
+		const int16 *s = (const int16 *) source->getBuffer();
+		for (size_t i = 0; i < count; i++)
+			input[start + i] = (float) s[i];
+	}
+	else
+	{
+		const uint8 *s = (const uint8 *) source->getBuffer();
+		for (size_t i = 0; i < count; i++)
+			input[start + i] = (float) s[i] - 128.0f;
+	}
+
+	if (first)
+		std::copy(input.begin() + channels, input.begin() + channels * 2, input.begin());
+
+	return true;
+}
+
+int ResamplingDecoder::decode()
+{
+	int framesize = channels * (bitDepth / 8);
+	int maxFrames = bufferSize / framesize;
+	int frames = 0;
+
+	float minv = bitDepth == 16 ? -32768.0f : -128.0f;
+	float maxv = bitDepth == 16 ? 32767.0f : 127.0f;
+
+	while (frames < maxFrames)
+	{
+		int i0 = (int) position;
+
+		// Interpolation reads from frame i0 - 1 to i0 + 2.
+		while (!sourceFinished && (int) (input.size() / channels) <= i0 + 2)
+			readSource();
+
+		int n = (int) (input.size() / channels);
+		if (i0 >= n)
+			break;
+
+		float t = (float) (position - i0);
+		int im1 = std::max(i0 - 1, 0);
+		int i1 = std::min(i0 + 1, n - 1);
+		int i2 = std::min(i0 + 2, n - 1);
+
+		for (int c = 0; c < channels; c++)
+		{
+			float x0 = input[i0 * channels + c];
+			float x1 = input[i1 * channels + c];
+			float v;
+
+			if (quality == RESAMPLE_CUBIC)
+			{
+				// Catmull-Rom spline.
+				float xm1 = input[im1 * channels + c];
+				float x2 = input[i2 * channels + c];
+				v = x0 + 0.5f * t * (x1 - xm1 + t * (2.0f * xm1 - 5.0f * x0 + 4.0f * x1 - x2 + t * (3.0f * (x0 - x1) + x2 - xm1)));
+			}
+			else
+				v = x0 + (x1 - x0) * t;
+
+			v = std::min(std::max(v, minv), maxv);
+
+			if (bitDepth == 16)
+				((int16 *) buffer)[frames * channels + c] = (int16) v;
+			else
+				((uint8 *) buffer)[frames * channels + c] = (uint8) (v + 128.0f);
+		}
+
+		frames++;
+		position += step;
+	}
+
+	// Keep one frame of history before the current position.
+	int consumed = (int) position - 1;
+	if (consumed > 0)
+	{
+		consumed = std::min(consumed, (int) (input.size() / channels));
+		input.erase(input.begin(), input.begin() + consumed * channels);
+		position -= consumed;
+	}
+
+	if (frames == 0)
+		eof = true;
+
+	return frames * framesize;
+}
+
+bool ResamplingDecoder::seek(double s)
+{
+	bool success = source->seek(s);
+	reset();
+	return success;
+}
+
+bool ResamplingDecoder::rewind()
+{
+	bool success = source->rewind();
+	reset();
+	return success;
+}
+
+bool ResamplingDecoder::isSeekable()
+{
+	return source->isSeekable();
+}
+
+int ResamplingDecoder::getChannelCount() const
+{
+	return channels;
+}
+
+int ResamplingDecoder::getBitDepth() const
+{
+	return bitDepth;
+}
+
+double ResamplingDecoder::getDuration()
+{
+	return source->getDuration();
+}
+
+} // lullaby
+} // sound
+} // love
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_LULLABY_RESAMPLING_DECODER_H
+#define LOVE_SOUND_LULLABY_RESAMPLING_DECODER_H
+
+// LOVE
+#include "sound/Decoder.h"
+
+// STD
+#include <vector>
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+/**
+ * Converts another Decoder's output to a different sample rate as it's
+ * decoded, so audio can be brought to the output device's rate once instead
+ * of being resampled by OpenAL every time it's mixed.
+ **/
+class ResamplingDecoder : public Decoder
+{
+public:
+
+	ResamplingDecoder(Decoder *source, int sampleRate, ResampleQuality quality);
+	virtual ~ResamplingDecoder();
+
+	love::sound::Decoder *clone() override;
+	int decode() override;
+	bool seek(double s) override;
+	bool rewind() override;
+	bool isSeekable() override;
+	int getChannelCount() const override;
+	int getBitDepth() const override;
+	double getDuration() override;
+
+private:
+
+	void reset();
+
+	// Appends the source's next decoded chunk to the input frames.
+	bool readSource();
+
+	StrongRef<Decoder> source;
+	ResampleQuality quality;
+
+	int channels;
+	int bitDepth;
+
+	// Source sample frames per output sample frame.
+	double step;
+
+	// Interleaved input samples, starting with one frame of history before
+	// the current position.
+	std::vector<float> input;
+	double position;
+	bool sourceFinished;
+
+}; // ResamplingDecoder
+
+} // lullaby
+} // sound
+} // love
+
+#endif // LOVE_SOUND_LULLABY_RESAMPLING_DECODER_H
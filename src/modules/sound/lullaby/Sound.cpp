@@ -30,6 +30,7 @@
 #include "WaveDecoder.h"
 #include "FLACDecoder.h"
 #include "MP3Decoder.h"
+#include "ResamplingDecoder.h"
 
 #ifdef LOVE_SUPPORT_COREAUDIO
 #	include "CoreAudioDecoder.h"
@@ -105,6 +106,11 @@ sound::Decoder *Sound::newDecoder(Stream *stream, int bufferSize)
 	return nullptr;
 }
 
+sound::Decoder *Sound::newResamplingDecoder(sound::Decoder *source, int sampleRate, sound::Decoder::ResampleQuality quality)
+{
+	return new ResamplingDecoder(source, sampleRate, quality);
+}
+
 } // lullaby
 } // sound
 } // love
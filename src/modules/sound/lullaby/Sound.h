@@ -51,6 +51,9 @@ public:
 	/// @copydoc love::sound::Sound::newDecoder
 	sound::Decoder *newDecoder(Stream *stream, int bufferSize) override;
 
+	/// @copydoc love::sound::Sound::newResamplingDecoder
+	sound::Decoder *newResamplingDecoder(sound::Decoder *source, int sampleRate, sound::Decoder::ResampleQuality quality) override;
+
 }; // Sound
 
 } // lullaby
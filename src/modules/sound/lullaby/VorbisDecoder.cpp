@@ -23,6 +23,11 @@
 #include <string.h>
 #include "common/config.h"
 #include "common/Exception.h"
+#include "thread/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace love
 {
@@ -75,9 +80,145 @@ static long vorbisTell(void *datasource)
  * END CALLBACK FUNCTIONS
  **/
 
+struct VorbisDecoder::SeekIndex
+{
+	struct Page
+	{
+		// Granule position at the end of the page, and the byte offset of the
+		// page after it, where decoding can resume from.
+		ogg_int64_t granule;
+		int64 nextOffset;
+	};
+
+	std::vector<Page> pages;
+	std::atomic<bool> ready;
+
+	SeekIndex() : ready(false) {}
+};
+
+// Smaller streams are quick enough to seek through with ov_time_seek.
+static const int64 MIN_SEEK_INDEX_STREAM_SIZE = 1024 * 1024;
+
+// Reads the Ogg page headers of a single logical stream, skipping the page
+// bodies. Stops early if every decoder using the index has been destroyed.
+void VorbisDecoder::buildSeekIndex(Stream *stream, std::weak_ptr<SeekIndex> weakIndex)
+{
+	// Large enough for the biggest possible Ogg page.
+	std::vector<uint8> data(128 * 1024);
+	int64 bufferStart = 0;
+	int64 bufferLength = 0;
+
+	auto ensure = [&](int64 offset, int64 size) -> bool
+	{
+		int64 bufferEnd = bufferStart + bufferLength;
+		if (offset >= bufferStart && offset + size <= bufferEnd)
+			return true;
+
+		int64 keep = 0;
+		if (offset >= bufferStart && offset < bufferEnd)
+		{
+			keep = bufferEnd - offset;
+			memmove(data.data(), data.data() + (offset - bufferStart), (size_t) keep);
+		}
+		else if (!stream->seek(offset, Stream::SEEKORIGIN_BEGIN))
+			return false;
+
+		bufferStart = offset;
+		bufferLength = keep;
+
+		while (bufferLength < size)
+		{
+			int64 read = stream->read(data.data() + bufferLength, (int64) data.size() - bufferLength);
+			if (read <= 0)
+				return false;
+			bufferLength += read;
+		}
+
+		return true;
+	};
+
+	std::vector<SeekIndex::Page> pages;
+	int64 offset = 0;
+	uint32 serial = 0;
+
+	while (ensure(offset, 27))
+	{
+		if (pages.size() % 256 == 0 && weakIndex.expired())
+			return;
+
+		const uint8 *header = data.data() + (offset - bufferStart);
+		if (memcmp(header, "OggS", 4) != 0)
+			return;
+
+		uint32 pageSerial = header[14] | (header[15] << 8) | (header[16] << 16) | ((uint32) header[17] << 24);
+
+		// Multiplexed streams aren't indexed.
+		if (offset == 0)
+			serial = pageSerial;
+		else if (pageSerial != serial)
+			return;
+
+		ogg_int64_t granule = 0;
+		for (int i = 7; i >= 0; i--)
+			granule = (granule << 8) | header[6 + i];
+
+		int segments = header[26];
+		if (!ensure(offset, 27 + segments))
+			break;
+
+		header = data.data() + (offset - bufferStart);
+
+		int64 size = 27 + segments;
+		for (int i = 0; i < segments; i++)
+			size += header[27 + i];
+
+		offset += size;
+
+		// Pages which don't finish a packet have a granule position of -1.
+		if (granule >= 0)
+			pages.push_back({granule, offset});
+	}
+
+	auto index = weakIndex.lock();
+	if (index)
+	{
+		index->pages = std::move(pages);
+		index->ready.store(true, std::memory_order_release);
+	}
+}
+
 VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
 	: Decoder(stream, bufferSize)
 	, duration(-2.0)
+{
+	init();
+
+	if (ov_seekable(&handle) && ov_streams(&handle) == 1 && stream->getSize() >= MIN_SEEK_INDEX_STREAM_SIZE)
+	{
+		seekIndex = std::make_shared<SeekIndex>();
+
+		StrongRef<Stream> indexStream(stream->clone(), Acquire::NORETAIN);
+		std::weak_ptr<SeekIndex> weakIndex = seekIndex;
+
+		love::thread::JobSystem::acquireShared()->submit([indexStream, weakIndex]()
+		{
+			buildSeekIndex(indexStream, weakIndex);
+		});
+	}
+}
+
+VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize, const std::shared_ptr<SeekIndex> &seekIndex)
+	: Decoder(stream, bufferSize)
+	, duration(-2.0)
+	, seekIndex(seekIndex)
+{
+	init();
+
+	if (seekIndex)
+		love::thread::JobSystem::acquireShared();
+}
+
+void VorbisDecoder::init()
 {
 	ov_callbacks callbacks = {};
 	callbacks.close_func = vorbisClose;
@@ -95,12 +236,20 @@ VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
 VorbisDecoder::~VorbisDecoder()
 {
 	ov_clear(&handle);
+
+	// Decoders with a seek index hold the shared job system, so it's not
+	// destroyed while the index could still be building.
+	if (seekIndex)
+	{
+		seekIndex.reset();
+		love::thread::JobSystem::releaseShared();
+	}
 }
 
 love::sound::Decoder *VorbisDecoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new VorbisDecoder(s, bufferSize);
+	return new VorbisDecoder(s, bufferSize, seekIndex);
 }
 
 int VorbisDecoder::decode()
@@ -133,6 +282,53 @@ int VorbisDecoder::decode()
 	return size;
 }
 
+bool VorbisDecoder::seekWithIndex(ogg_int64_t sample)
+{
+	if (!seekIndex || !seekIndex->ready.load(std::memory_order_acquire))
+		return false;
+
+	// Resume decoding after the last page which ends before the target.
+	const auto &pages = seekIndex->pages;
+	ogg_int64_t granule = sample + handle.pcmlengths[0];
+
+	auto it = std::upper_bound(pages.begin(), pages.end(), granule, [](ogg_int64_t g, const SeekIndex::Page &page)
+	{
+		return g < page.granule;
+	});
+
+	int64 offset = it == pages.begin() ? 0 : (it - 1)->nextOffset;
+
+	if (ov_raw_seek(&handle, offset) != 0)
+		return false;
+
+	ogg_int64_t position = ov_pcm_tell(&handle);
+	if (position < 0 || position > sample)
+		return false;
+
+#ifdef LOVE_BIG_ENDIAN
+	int endian = 1;
+#else
+	int endian = 0;
+#endif
+
+	// Decode and discard up to the target, which is less than a page away.
+	int64 frameSize = 2 * getChannelCount();
+	while (position < sample)
+	{
+		int64 size = std::min<int64>((sample - position) * frameSize, bufferSize);
+		long result = ov_read(&handle, (char *) buffer, (int) size, endian, 2, 1, 0);
+
+		if (result == OV_HOLE)
+			continue;
+		else if (result <= 0)
+			return false;
+
+		position += result / frameSize;
+	}
+
+	return true;
+}
+
 bool VorbisDecoder::seek(double s)
 {
 	int result = 0;
@@ -141,6 +337,8 @@ bool VorbisDecoder::seek(double s)
 	// a bug in libvorbis <= 1.3.4 when seeking to PCM 0 in multiplexed streams.
 	if (s <= 0.000001)
 		result = ov_raw_seek(&handle, 0);
+	else if (seekWithIndex((ogg_int64_t) (s * vorbisInfo->rate)))
+		result = 0;
 	else
 		result = ov_time_seek(&handle, s);
 
@@ -31,6 +31,9 @@
 #include <vorbis/codec.h>
 #include <vorbis/vorbisfile.h>
 
+// C++
+#include <memory>
+
 namespace love
 {
 namespace sound
@@ -57,10 +60,23 @@ public:
 
 private:
 
+	// The stream's page offsets, built on a background thread and shared
+	// with clones.
+	struct SeekIndex;
+
+	VorbisDecoder(Stream *stream, int bufferSize, const std::shared_ptr<SeekIndex> &seekIndex);
+
+	void init();
+	bool seekWithIndex(ogg_int64_t sample);
+
+	static void buildSeekIndex(Stream *stream, std::weak_ptr<SeekIndex> weakIndex);
+
 	OggVorbis_File handle;
 	vorbis_info *vorbisInfo;
 	double duration;
 
+	std::shared_ptr<SeekIndex> seekIndex;
+
 }; // VorbisDecoder
 
 } // lullaby
@@ -21,6 +21,7 @@
 #include "wrap_Sound.h"
 
 #include "filesystem/wrap_Filesystem.h"
+#include "filesystem/Filesystem.h"
 #include "data/DataStream.h"
 
 // Implementations.
@@ -33,6 +34,40 @@ namespace sound
 
 #define instance() (Module::getInstance<Sound>(Module::M_SOUND))
 
+// Wraps the Decoder at the top of the stack in a ResamplingDecoder, if the
+// settings table at idx asks for a different sample rate.
+static void luax_resampledecoder(lua_State *L, int idx)
+{
+	if (!lua_istable(L, idx))
+		return;
+
+	lua_getfield(L, idx, "samplerate");
+	int sampleRate = (int) luaL_optinteger(L, -1, 0);
+	lua_pop(L, 1);
+
+	Decoder::ResampleQuality quality = Decoder::RESAMPLE_CUBIC;
+
+	lua_getfield(L, idx, "quality");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!Decoder::getConstant(str, quality))
+			luax_enumerror(L, "resample quality", Decoder::getConstants(quality), str);
+	}
+	lua_pop(L, 1);
+
+	Decoder *decoder = luax_checkdecoder(L, -1);
+	if (sampleRate <= 0 || sampleRate == decoder->getSampleRate())
+		return;
+
+	Decoder *t = nullptr;
+	luax_catchexcept(L, [&]() { t = instance()->newResamplingDecoder(decoder, sampleRate, quality); });
+
+	lua_pop(L, 1);
+	luax_pushtype(L, t);
+	t->release();
+}
+
 int w_newDecoder(lua_State *L)
 {
 	int bufferSize = (int)luaL_optinteger(L, 2, Decoder::DEFAULT_BUFFER_SIZE);
@@ -54,9 +89,18 @@ int w_newDecoder(lua_State *L)
 		}
 		else
 		{
+			auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+
 			luax_catchexcept(L, [&]()
 			{
-				StrongRef<love::filesystem::FileData> data(love::filesystem::luax_getfiledata(L, 1), Acquire::NORETAIN);
+				// Decode straight from a memory mapping of the file when possible.
+				love::filesystem::FileData *fd = nullptr;
+				if (fs != nullptr && lua_type(L, 1) == LUA_TSTRING)
+					fd = fs->mapFile(lua_tostring(L, 1));
+				else
+					fd = love::filesystem::luax_getfiledata(L, 1);
+
+				StrongRef<love::filesystem::FileData> data(fd, Acquire::NORETAIN);
 				stream = new data::DataStream(data);
 			});
 		}
@@ -81,6 +125,8 @@ int w_newDecoder(lua_State *L)
 
 	luax_pushtype(L, t);
 	t->release();
+
+	luax_resampledecoder(L, 4);
 	return 1;
 }
 
@@ -103,9 +149,25 @@ int w_newSoundData(lua_State *L)
 		// Convert to Decoder, if necessary.
 		if (!luax_istype(L, 1, Decoder::type))
 		{
+			// Pass the settings table on as newDecoder's 4th argument.
+			if (lua_istable(L, 2))
+			{
+				lua_settop(L, 2);
+				lua_pushnil(L);
+				lua_pushnil(L);
+				lua_pushvalue(L, 2);
+				lua_remove(L, 2);
+			}
+
 			w_newDecoder(L);
 			lua_replace(L, 1);
 		}
+		else if (lua_istable(L, 2))
+		{
+			lua_pushvalue(L, 1);
+			luax_resampledecoder(L, 2);
+			lua_replace(L, 1);
+		}
 
 		luax_catchexcept(L, [&](){ t = instance()->newSoundData(luax_checkdecoder(L, 1)); });
 	}
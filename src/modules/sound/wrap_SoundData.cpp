@@ -146,6 +146,75 @@ int w_SoundData_slice(lua_State *L)
 	return 1;
 }
 
+int w_SoundData_mix(lua_State *L)
+{
+	SoundData *dst = luax_checksounddata(L, 1);
+	const SoundData *src = luax_checksounddata(L, 2);
+
+	float gain = (float) luaL_optnumber(L, 3, 1.0);
+	int srcStart = (int) luaL_optinteger(L, 4, 0);
+	int count = (int) luaL_optinteger(L, 5, -1);
+	int dstStart = (int) luaL_optinteger(L, 6, 0);
+
+	luax_catchexcept(L, [&](){ dst->mix(src, gain, srcStart, count, dstStart); });
+	return 0;
+}
+
+int w_SoundData_fade(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	float startGain = (float) luaL_checknumber(L, 2);
+	float endGain = (float) luaL_optnumber(L, 3, startGain);
+	int start = (int) luaL_optinteger(L, 4, 0);
+	int count = (int) luaL_optinteger(L, 5, -1);
+
+	luax_catchexcept(L, [&](){ t->fade(startGain, endGain, start, count); });
+	return 0;
+}
+
+int w_SoundData_getPeak(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	int start = (int) luaL_optinteger(L, 2, 0);
+	int count = (int) luaL_optinteger(L, 3, -1);
+
+	float peak = 0.0f;
+	luax_catchexcept(L, [&](){ peak = t->getPeak(start, count); });
+	lua_pushnumber(L, peak);
+	return 1;
+}
+
+int w_SoundData_normalize(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	float peak = (float) luaL_optnumber(L, 2, 1.0);
+
+	lua_pushnumber(L, t->normalize(peak));
+	return 1;
+}
+
+int w_SoundData_resample(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
+	int sampleRate = (int) luaL_checkinteger(L, 2);
+
+	luax_catchexcept(L, [&](){ c = t->resample(sampleRate); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SoundData_convert(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
+	int bitDepth = (int) luaL_checkinteger(L, 2);
+
+	luax_catchexcept(L, [&](){ c = t->convert(bitDepth); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
 static const luaL_Reg w_SoundData_functions[] =
 {
 	{ "clone", w_SoundData_clone },
@@ -158,6 +227,12 @@ static const luaL_Reg w_SoundData_functions[] =
 	{ "getSample", w_SoundData_getSample },
 	{ "copyFrom", w_SoundData_copyFrom },
 	{ "slice", w_SoundData_slice },
+	{ "mix", w_SoundData_mix },
+	{ "fade", w_SoundData_fade },
+	{ "getPeak", w_SoundData_getPeak },
+	{ "normalize", w_SoundData_normalize },
+	{ "resample", w_SoundData_resample },
+	{ "convert", w_SoundData_convert },
 
 	{ 0, 0 }
 };
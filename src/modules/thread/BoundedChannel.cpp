@@ -0,0 +1,276 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "BoundedChannel.h"
+#include "common/Exception.h"
+
+#include <timer/Timer.h>
+
+#if defined(LOVE_SIMD_SSE)
+#include <immintrin.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <thread>
+
+namespace love
+{
+namespace thread
+{
+
+// How many times a blocked thread retries before sleeping.
+static const int SPIN_COUNT = 256;
+
+static inline void relax()
+{
+#if defined(LOVE_SIMD_SSE)
+	_mm_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+	__asm__ __volatile__("yield");
+#endif
+}
+
+love::Type BoundedChannel::type("BoundedChannel", &Object::type);
+
+BoundedChannel::BoundedChannel(size_t capacity)
+	: capacity(2)
+	, mask(0)
+	, pushPosition(0)
+	, popPosition(0)
+	, waiters(0)
+{
+	if (capacity == 0)
+		throw love::Exception("BoundedChannel capacity must be greater than 0.");
+
+	if (capacity > (size_t) 1 << 30)
+		throw love::Exception("BoundedChannel capacity is too large.");
+
+	while (this->capacity < capacity)
+		this->capacity *= 2;
+
+	mask = this->capacity - 1;
+	slots.reset(new Slot[this->capacity]);
+
+	// Each slot's sequence is the position it can next be pushed at. Popping
+	// waits for it to be one higher, after the push.
+	for (size_t i = 0; i < this->capacity; i++)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+BoundedChannel::~BoundedChannel()
+{
+}
+
+size_t BoundedChannel::claim(std::atomic<size_t> &position, size_t offset, size_t count, size_t &first)
+{
+	size_t pos = position.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		size_t n = 0;
+		bool stale = false;
+
+		while (n < count)
+		{
+			const Slot &slot = slots[(pos + n) & mask];
+			intptr_t diff = (intptr_t) slot.sequence.load(std::memory_order_acquire) - (intptr_t) (pos + n + offset);
+
+			if (diff == 0)
+				n++;
+			else
+			{
+				// Another thread already claimed this position.
+				stale = diff > 0 && n == 0;
+				break;
+			}
+		}
+
+		if (stale)
+		{
+			pos = position.load(std::memory_order_relaxed);
+			continue;
+		}
+
+		if (n == 0)
+			return 0;
+
+		if (position.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+		{
+			first = pos;
+			return n;
+		}
+	}
+}
+
+bool BoundedChannel::push(const Variant &var)
+{
+	return pushMany(&var, 1) == 1;
+}
+
+size_t BoundedChannel::pushMany(const Variant *vars, size_t count)
+{
+	size_t first = 0;
+	size_t n = claim(pushPosition, 0, count, first);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		Slot &slot = slots[(first + i) & mask];
+		slot.value = vars[i];
+		slot.sequence.store(first + i + 1, std::memory_order_release);
+	}
+
+	if (n > 0)
+		wake();
+
+	return n;
+}
+
+bool BoundedChannel::supply(const Variant &var)
+{
+	return block([&]() { return push(var); }, -1.0);
+}
+
+bool BoundedChannel::supply(const Variant &var, double timeout)
+{
+	return block([&]() { return push(var); }, std::max(timeout, 0.0));
+}
+
+bool BoundedChannel::pop(Variant *var)
+{
+	size_t first = 0;
+	if (claim(popPosition, 1, 1, first) == 0)
+		return false;
+
+	Slot &slot = slots[first & mask];
+	*var = slot.value;
+	slot.value = Variant();
+	slot.sequence.store(first + capacity, std::memory_order_release);
+
+	wake();
+	return true;
+}
+
+size_t BoundedChannel::popMany(std::vector<Variant> &vars, size_t max)
+{
+	size_t first = 0;
+	size_t n = claim(popPosition, 1, max, first);
+
+	vars.reserve(vars.size() + n);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		Slot &slot = slots[(first + i) & mask];
+		vars.push_back(std::move(slot.value));
+		slot.sequence.store(first + i + capacity, std::memory_order_release);
+	}
+
+	if (n > 0)
+		wake();
+
+	return n;
+}
+
+bool BoundedChannel::demand(Variant *var)
+{
+	return block([&]() { return pop(var); }, -1.0);
+}
+
+bool BoundedChannel::demand(Variant *var, double timeout)
+{
+	return block([&]() { return pop(var); }, std::max(timeout, 0.0));
+}
+
+template <typename T>
+bool BoundedChannel::block(const T &tryOperation, double timeout)
+{
+	for (int i = 0; i < SPIN_COUNT; i++)
+	{
+		if (tryOperation())
+			return true;
+		relax();
+	}
+
+	std::this_thread::yield();
+
+	// Registering as a waiter before trying again means a thread that pushes
+	// or pops after our last attempt is guaranteed to see us and wake us.
+	waiters.fetch_add(1);
+
+	bool result = false;
+
+	{
+		Lock l(mutex);
+
+		while (true)
+		{
+			if (tryOperation())
+			{
+				result = true;
+				break;
+			}
+
+			if (timeout < 0.0)
+				waitAndRunMainThreadCallback(cond, mutex);
+			else if (timeout > 0.0)
+			{
+				double start = love::timer::Timer::getTime();
+				waitAndRunMainThreadCallback(cond, mutex, std::max((int) (timeout * 1000), 1));
+				double stop = love::timer::Timer::getTime();
+
+				timeout = std::max(timeout - (stop - start), 0.0);
+			}
+			else
+				break;
+		}
+	}
+
+	waiters.fetch_sub(1);
+	return result;
+}
+
+void BoundedChannel::wake()
+{
+	// Pairs with the waiter count increment in block.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (waiters.load() > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+int BoundedChannel::getCount() const
+{
+	size_t popped = popPosition.load(std::memory_order_relaxed);
+	size_t pushed = pushPosition.load(std::memory_order_relaxed);
+	return pushed > popped ? (int) std::min(pushed - popped, capacity) : 0;
+}
+
+void BoundedChannel::clear()
+{
+	std::vector<Variant> vars;
+	while (popMany(vars, capacity) > 0)
+		vars.clear();
+}
+
+} // thread
+} // love
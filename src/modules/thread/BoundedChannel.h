@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_BOUNDED_CHANNEL_H
+#define LOVE_THREAD_BOUNDED_CHANNEL_H
+
+// STL
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// LOVE
+#include "common/Variant.h"
+#include "common/int.h"
+#include "threads.h"
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A fixed-capacity channel which many threads can push to and pop from at once
+ * without taking a lock, for job systems with several workers pulling tasks.
+ *
+ * Threads that block in demand or supply spin for a short while before
+ * sleeping, and are only woken by other threads when something is waiting.
+ **/
+class BoundedChannel : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	// The capacity is rounded up to a power of two.
+	BoundedChannel(size_t capacity);
+	virtual ~BoundedChannel();
+
+	// Returns false if the channel is full.
+	bool push(const Variant &var);
+
+	// Returns the number of values pushed, which is less than count if the
+	// channel fills up.
+	size_t pushMany(const Variant *vars, size_t count);
+
+	// Blocks until there's room in the channel.
+	bool supply(const Variant &var);
+	bool supply(const Variant &var, double timeout);
+
+	// Returns false if the channel is empty.
+	bool pop(Variant *var);
+
+	// Appends up to max values to the given vector, and returns the number
+	// popped.
+	size_t popMany(std::vector<Variant> &vars, size_t max);
+
+	// Blocks until there's a value in the channel.
+	bool demand(Variant *var);
+	bool demand(Variant *var, double timeout);
+
+	int getCount() const;
+	size_t getCapacity() const { return capacity; }
+	void clear();
+
+private:
+
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		Variant value;
+	};
+
+	// Claims up to count consecutive slots for pushing (or popping), and
+	// returns the first claimed position and the number claimed.
+	size_t claim(std::atomic<size_t> &position, size_t offset, size_t count, size_t &first);
+
+	// Spins and then sleeps until tryOperation succeeds or the timeout (in
+	// seconds, or forever if negative) runs out.
+	template <typename T>
+	bool block(const T &tryOperation, double timeout);
+
+	// Wakes threads sleeping in block, if there are any.
+	void wake();
+
+	size_t capacity;
+	size_t mask;
+	std::unique_ptr<Slot[]> slots;
+
+	// Kept on separate cache lines so pushing and popping threads don't
+	// contend on them.
+	alignas(64) std::atomic<size_t> pushPosition;
+	alignas(64) std::atomic<size_t> popPosition;
+
+	alignas(64) std::atomic<int> waiters;
+	MutexRef mutex;
+	ConditionalRef cond;
+
+}; // BoundedChannel
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_BOUNDED_CHANNEL_H
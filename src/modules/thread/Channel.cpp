@@ -22,6 +22,10 @@
 
 #include <timer/Timer.h>
 
+// C++
+#include <algorithm>
+#include <utility>
+
 namespace love
 {
 namespace thread
@@ -46,6 +50,13 @@ uint64 Channel::push(const Variant &var)
 	queue.push(var);
 	cond->broadcast();
 
+	for (Selector *selector : selectors)
+	{
+		Lock sl(selector->mutex);
+		selector->signaled = true;
+		selector->cond->broadcast();
+	}
+
 	return ++sent;
 }
 
@@ -55,7 +66,7 @@ bool Channel::supply(const Variant &var)
 	uint64 id = push(var);
 
 	while (received < id)
-		cond->wait(mutex);
+		waitAndRunMainThreadCallback(cond, mutex);
 
 	return true;
 }
@@ -71,7 +82,7 @@ bool Channel::supply(const Variant &var, double timeout)
 			return true;
 
 		double start = love::timer::Timer::getTime();
-		cond->wait(mutex, timeout*1000);
+		waitAndRunMainThreadCallback(cond, mutex, timeout*1000);
 		double stop = love::timer::Timer::getTime();
 
 		timeout -= (stop-start);
@@ -87,7 +98,7 @@ bool Channel::pop(Variant *var)
 	if (queue.empty())
 		return false;
 
-	*var = queue.front();
+	*var = std::move(queue.front());
 	queue.pop();
 
 	received++;
@@ -101,7 +112,7 @@ bool Channel::demand(Variant *var)
 	Lock l(mutex);
 
 	while (!pop(var))
-		cond->wait(mutex);
+		waitAndRunMainThreadCallback(cond, mutex);
 
 	return true;
 }
@@ -116,7 +127,7 @@ bool Channel::demand(Variant *var, double timeout)
 			return true;
 
 		double start = love::timer::Timer::getTime();
-		cond->wait(mutex, timeout*1000);
+		waitAndRunMainThreadCallback(cond, mutex, timeout*1000);
 		double stop = love::timer::Timer::getTime();
 
 		timeout -= (stop-start);
@@ -174,5 +185,78 @@ void Channel::unlockMutex()
 	mutex->unlock();
 }
 
+void Channel::addSelector(Selector *selector)
+{
+	Lock l(mutex);
+	selectors.push_back(selector);
+}
+
+void Channel::removeSelector(Selector *selector)
+{
+	Lock l(mutex);
+	auto it = std::find(selectors.begin(), selectors.end(), selector);
+	if (it != selectors.end())
+		selectors.erase(it);
+}
+
+int Channel::select(const std::vector<Channel *> &channels, Variant *var, double timeout)
+{
+	if (channels.empty())
+		return -1;
+
+	bool forever = timeout < 0;
+	Selector selector;
+
+	for (Channel *c : channels)
+		c->addSelector(&selector);
+
+	int index = -1;
+
+	while (true)
+	{
+		// Clear the flag before checking the channels, so a push which happens
+		// after a channel is checked still wakes us up below.
+		{
+			Lock l(selector.mutex);
+			selector.signaled = false;
+		}
+
+		for (size_t i = 0; i < channels.size(); i++)
+		{
+			if (channels[i]->pop(var))
+			{
+				index = (int) i;
+				break;
+			}
+		}
+
+		if (index >= 0)
+			break;
+
+		Lock l(selector.mutex);
+
+		if (selector.signaled)
+			continue;
+
+		if (forever)
+			waitAndRunMainThreadCallback(selector.cond, selector.mutex);
+		else if (timeout >= 0)
+		{
+			double start = love::timer::Timer::getTime();
+			waitAndRunMainThreadCallback(selector.cond, selector.mutex, (int) (timeout*1000));
+			double stop = love::timer::Timer::getTime();
+
+			timeout -= (stop-start);
+		}
+		else
+			break;
+	}
+
+	for (Channel *c : channels)
+		c->removeSelector(&selector);
+
+	return index;
+}
+
 } // thread
 } // love
@@ -23,6 +23,7 @@
 
 // STL
 #include <queue>
+#include <vector>
 
 // LOVE
 #include "common/Variant.h"
@@ -57,11 +58,32 @@ public:
 	void lockMutex();
 	void unlockMutex();
 
+	/**
+	 * Blocks until any of the given channels has a value, and pops it. Returns
+	 * the index of the channel the value came from, or -1 if the timeout (in
+	 * seconds) runs out first. A negative timeout waits forever. Channels
+	 * earlier in the list are checked first.
+	 **/
+	static int select(const std::vector<Channel *> &channels, Variant *var, double timeout = -1.0);
+
 private:
 
+	// Shared by every channel a select call is waiting on, so a push to any
+	// of them wakes it.
+	struct Selector
+	{
+		MutexRef mutex;
+		ConditionalRef cond;
+		bool signaled = false;
+	};
+
+	void addSelector(Selector *selector);
+	void removeSelector(Selector *selector);
+
 	MutexRef mutex;
 	ConditionalRef cond;
 	std::queue<Variant> queue;
+	std::vector<Selector *> selectors;
 
 	uint64 sent;
 	uint64 received;
@@ -0,0 +1,450 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "JobSystem.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace love
+{
+namespace thread
+{
+
+JobGroup::JobGroup()
+	: pending(0)
+{
+}
+
+JobGroup::~JobGroup()
+{
+}
+
+void JobGroup::add()
+{
+	Lock lock(mutex);
+	pending++;
+}
+
+void JobGroup::done()
+{
+	Lock lock(mutex);
+	if (--pending == 0)
+		doneCond->broadcast();
+}
+
+void JobGroup::wait()
+{
+	Lock lock(mutex);
+	while (pending > 0)
+		doneCond->wait(mutex);
+}
+
+class JobSystem::Worker : public Threadable
+{
+public:
+
+	Worker(JobSystem *system)
+		: system(system)
+		, stopping(false)
+	{
+		threadName = "JobWorker";
+	}
+
+	void threadFunction() override
+	{
+		currentWorker = this;
+		system->workerLoop(this);
+		currentWorker = nullptr;
+	}
+
+	JobSystem *system;
+
+	MutexRef mutex;
+	std::deque<Job> jobs;
+
+	std::atomic<bool> stopping;
+};
+
+thread_local JobSystem::Worker *JobSystem::currentWorker = nullptr;
+
+JobSystem::JobSystem(int workerCount)
+	: workerCount(std::max(workerCount, 1))
+	, started(false)
+	, queuedJobs(0)
+{
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		Lock lock(workersMutex);
+		stopWorkers();
+	}
+
+	// Anything still waiting for a job shouldn't block forever.
+	for (Job &job : queue)
+	{
+		if (job.cancel)
+			job.cancel();
+		else
+			job.run();
+	}
+}
+
+int JobSystem::getWorkerCount() const
+{
+	Lock lock(workersMutex);
+	return workerCount;
+}
+
+void JobSystem::setWorkerCount(int count)
+{
+	if (isWorkerThread())
+		throw love::Exception("The number of job system workers can't be changed from a job.");
+
+	Lock lock(workersMutex);
+
+	count = std::max(count, 1);
+	if (count == workerCount)
+		return;
+
+	workerCount = count;
+
+	if (started)
+	{
+		stopWorkers();
+		startWorkers(workerCount);
+	}
+}
+
+void JobSystem::startWorkers(int count)
+{
+	// The list is filled before any worker starts, since they read it to find
+	// jobs to steal.
+	for (int i = 0; i < count; i++)
+		workers.push_back(new Worker(this));
+
+	for (Worker *worker : workers)
+		worker->start();
+}
+
+void JobSystem::stopWorkers()
+{
+	for (Worker *worker : workers)
+		worker->stopping = true;
+
+	{
+		Lock lock(sleepMutex);
+		sleepCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+		worker->wait();
+
+	// Jobs the workers hadn't started yet go back to the shared queue.
+	{
+		Lock lock(queueMutex);
+		for (Worker *worker : workers)
+		{
+			queue.insert(queue.end(), worker->jobs.begin(), worker->jobs.end());
+			worker->jobs.clear();
+			worker->release();
+		}
+	}
+
+	workers.clear();
+}
+
+void JobSystem::ensureStarted()
+{
+	if (started.load(std::memory_order_acquire))
+		return;
+
+	Lock lock(workersMutex);
+
+	if (!started)
+	{
+		startWorkers(workerCount);
+		started.store(true, std::memory_order_release);
+	}
+}
+
+void JobSystem::submit(const std::function<void()> &run, const std::function<void()> &cancel, JobGroup *group)
+{
+	Job job;
+
+	if (group != nullptr)
+	{
+		group->add();
+		job.run = [run, group]() { run(); group->done(); };
+		job.cancel = [cancel, group]() { if (cancel) cancel(); group->done(); };
+	}
+	else
+	{
+		job.run = run;
+		job.cancel = cancel;
+	}
+
+	Worker *worker = currentWorker;
+
+	if (worker != nullptr && worker->system == this)
+	{
+		Lock lock(worker->mutex);
+		worker->jobs.push_back(std::move(job));
+	}
+	else
+	{
+		ensureStarted();
+
+		Lock lock(queueMutex);
+		queue.push_back(std::move(job));
+	}
+
+	queuedJobs++;
+
+	Lock lock(sleepMutex);
+	sleepCond->signal();
+}
+
+bool JobSystem::takeJob(Worker *self, Job &job)
+{
+	// Our own newest job first, since its data is most likely to be cached.
+	{
+		Lock lock(self->mutex);
+		if (!self->jobs.empty())
+		{
+			job = std::move(self->jobs.back());
+			self->jobs.pop_back();
+			queuedJobs--;
+			return true;
+		}
+	}
+
+	{
+		Lock lock(queueMutex);
+		if (!queue.empty())
+		{
+			job = std::move(queue.front());
+			queue.pop_front();
+			queuedJobs--;
+			return true;
+		}
+	}
+
+	// Workers only change while none are running, so the list can be read
+	// without the workers mutex here.
+	size_t count = workers.size();
+	size_t start = std::find(workers.begin(), workers.end(), self) - workers.begin();
+
+	for (size_t i = 1; i < count; i++)
+	{
+		Worker *other = workers[(start + i) % count];
+
+		Lock lock(other->mutex);
+		if (!other->jobs.empty())
+		{
+			job = std::move(other->jobs.front());
+			other->jobs.pop_front();
+			queuedJobs--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::workerLoop(Worker *self)
+{
+	while (!self->stopping)
+	{
+		Job job;
+		if (takeJob(self, job))
+		{
+			job.run();
+			continue;
+		}
+
+		Lock lock(sleepMutex);
+
+		// Jobs queued after takeJob looked are counted before the submitting
+		// thread signals, which it can't do until we're waiting.
+		if (!self->stopping && queuedJobs.load() == 0)
+			sleepCond->wait(sleepMutex);
+	}
+}
+
+bool JobSystem::isWorkerThread() const
+{
+	return currentWorker != nullptr && currentWorker->system == this;
+}
+
+namespace
+{
+
+struct ParallelWork
+{
+	std::atomic<int> next {0};
+	int finished = 0;
+	int count = 0;
+	std::function<void(int)> func;
+
+	MutexRef mutex;
+	ConditionalRef finishedCond;
+
+	void run()
+	{
+		int done = 0;
+
+		for (int i = next++; i < count; i = next++)
+		{
+			func(i);
+			done++;
+		}
+
+		if (done > 0)
+		{
+			Lock lock(mutex);
+			finished += done;
+			if (finished == count)
+				finishedCond->broadcast();
+		}
+	}
+};
+
+} // anonymous namespace
+
+void JobSystem::runParallel(int count, const std::function<void(int)> &func)
+{
+	if (count <= 0)
+		return;
+
+	if (count == 1)
+	{
+		func(0);
+		return;
+	}
+
+	// Helper jobs can start after this function returns if the workers are
+	// busy with other things, so the shared state outlives it.
+	auto work = std::make_shared<ParallelWork>();
+	work->count = count;
+	work->func = func;
+
+	int helpers = std::min(count - 1, getWorkerCount());
+	for (int i = 0; i < helpers; i++)
+		submit([work]() { work->run(); });
+
+	work->run();
+
+	Lock lock(work->mutex);
+	while (work->finished < count)
+		work->finishedCond->wait(work->mutex);
+}
+
+static JobSystem *sharedJobSystem = nullptr;
+static int sharedUsers = 0;
+static int sharedWorkerCount = 0;
+
+static Mutex *getSharedMutex()
+{
+	static MutexRef mutex;
+	return mutex;
+}
+
+static int getDefaultWorkerCount()
+{
+	// Leave a core for the main thread.
+	int count = (int) std::thread::hardware_concurrency() - 1;
+	return std::max(std::min(count, 16), 1);
+}
+
+JobSystem *JobSystem::acquireShared()
+{
+	Lock lock(getSharedMutex());
+
+	if (sharedJobSystem == nullptr)
+		sharedJobSystem = new JobSystem(sharedWorkerCount > 0 ? sharedWorkerCount : getDefaultWorkerCount());
+
+	sharedUsers++;
+	return sharedJobSystem;
+}
+
+void JobSystem::releaseShared()
+{
+	Lock lock(getSharedMutex());
+
+	if (--sharedUsers > 0 || sharedJobSystem == nullptr)
+		return;
+
+	// A worker can't wait for itself to stop, so in that case the job system
+	// is kept around for the next user.
+	if (sharedJobSystem->isWorkerThread())
+		return;
+
+	delete sharedJobSystem;
+	sharedJobSystem = nullptr;
+}
+
+int JobSystem::getSharedWorkerCount()
+{
+	Lock lock(getSharedMutex());
+
+	if (sharedJobSystem != nullptr)
+		return sharedJobSystem->getWorkerCount();
+
+	return sharedWorkerCount > 0 ? sharedWorkerCount : getDefaultWorkerCount();
+}
+
+void JobSystem::setSharedWorkerCount(int count)
+{
+	Lock lock(getSharedMutex());
+
+	sharedWorkerCount = std::max(count, 1);
+
+	if (sharedJobSystem != nullptr)
+		sharedJobSystem->setWorkerCount(sharedWorkerCount);
+}
+
+JobSystemRef::JobSystemRef()
+	: jobSystem(JobSystem::acquireShared())
+{
+}
+
+JobSystemRef::~JobSystemRef()
+{
+	JobSystem::releaseShared();
+}
+
+JobSystemRef::operator JobSystem*() const
+{
+	return jobSystem;
+}
+
+JobSystem *JobSystemRef::operator->() const
+{
+	return jobSystem;
+}
+
+} // thread
+} // love
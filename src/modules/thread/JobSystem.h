@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_JOB_SYSTEM_H
+#define LOVE_THREAD_JOB_SYSTEM_H
+
+// LOVE
+#include "common/config.h"
+#include "threads.h"
+
+// C++
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * Tracks a set of jobs submitted to a JobSystem, so whatever queued them can
+ * wait for all of them to finish.
+ **/
+class JobGroup
+{
+public:
+
+	JobGroup();
+	~JobGroup();
+
+	void add();
+	void done();
+
+	// Blocks until every added job is done.
+	void wait();
+
+private:
+
+	int pending;
+	MutexRef mutex;
+	ConditionalRef doneCond;
+
+}; // JobGroup
+
+/**
+ * A pool of worker threads shared by LOVE's modules, so parallel work such as
+ * image decoding, compression and particle updates shares the CPU's cores
+ * instead of every module starting its own threads.
+ *
+ * Each worker has its own queue of jobs. Jobs queued by a worker go to its own
+ * queue and are taken newest first, and idle workers steal the oldest jobs
+ * from the others. Jobs queued by other threads go to a shared queue.
+ **/
+class JobSystem
+{
+public:
+
+	JobSystem(int workerCount);
+	~JobSystem();
+
+	int getWorkerCount() const;
+
+	/**
+	 * Changes the number of worker threads. Waits for the jobs the current
+	 * workers are running to finish, and keeps any queued jobs.
+	 **/
+	void setWorkerCount(int count);
+
+	/**
+	 * Queues a job. If the job system is destroyed before the job has started,
+	 * cancel (if given) is called instead of run.
+	 * @param group If given, the job is added to it until it's done.
+	 **/
+	void submit(const std::function<void()> &run, const std::function<void()> &cancel = nullptr, JobGroup *group = nullptr);
+
+	/**
+	 * Calls func(i) for every i in [0, count), split between the calling
+	 * thread and the workers. Returns once all calls have finished.
+	 **/
+	void runParallel(int count, const std::function<void(int)> &func);
+
+	// Whether the calling thread is one of this job system's workers.
+	bool isWorkerThread() const;
+
+	/**
+	 * Gets the job system shared by all of LOVE's modules, creating it if
+	 * needed. Every call must be matched with a call to releaseShared. The
+	 * shared job system is destroyed once nothing is using it.
+	 **/
+	static JobSystem *acquireShared();
+	static void releaseShared();
+
+	/**
+	 * The number of workers the shared job system has. Changing it affects the
+	 * shared job system immediately if it exists.
+	 **/
+	static int getSharedWorkerCount();
+	static void setSharedWorkerCount(int count);
+
+private:
+
+	struct Job
+	{
+		std::function<void()> run;
+		std::function<void()> cancel;
+	};
+
+	class Worker;
+
+	void startWorkers(int count);
+	void stopWorkers();
+	void ensureStarted();
+	bool takeJob(Worker *self, Job &job);
+	void workerLoop(Worker *self);
+
+	static thread_local Worker *currentWorker;
+
+	// Guards starting and stopping the workers.
+	MutexRef workersMutex;
+	std::vector<Worker *> workers;
+	int workerCount;
+	std::atomic<bool> started;
+
+	MutexRef queueMutex;
+	std::deque<Job> queue;
+
+	// Jobs waiting in any queue.
+	std::atomic<int> queuedJobs;
+
+	MutexRef sleepMutex;
+	ConditionalRef sleepCond;
+
+}; // JobSystem
+
+/**
+ * Holds a reference to the shared JobSystem for as long as it exists.
+ **/
+class JobSystemRef
+{
+public:
+
+	JobSystemRef();
+	~JobSystemRef();
+
+	operator JobSystem*() const;
+	JobSystem *operator->() const;
+
+private:
+
+	JobSystem *jobSystem;
+
+}; // JobSystemRef
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_SYSTEM_H
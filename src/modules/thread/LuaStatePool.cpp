@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LuaStatePool.h"
+#include "common/Exception.h"
+#include "common/runtime.h"
+
+// C++
+#include <algorithm>
+
+#ifdef LOVE_BUILD_STANDALONE
+extern "C" int luaopen_love(lua_State * L);
+extern "C" int luaopen_love_jitsetup(lua_State * L);
+#endif // LOVE_BUILD_STANDALONE
+
+namespace love
+{
+namespace thread
+{
+
+static const char THREAD_STATE_KEY[] = "_love_threadstate";
+
+LuaStatePool::LuaStatePool()
+	: size(0)
+	, generation(0)
+{
+}
+
+LuaStatePool::~LuaStatePool()
+{
+	// Threads keep the pool alive while they use its states, so only idle
+	// states can be left.
+	for (const State &state : idle)
+		lua_close(state.L);
+}
+
+void LuaStatePool::configure(int size, const std::vector<std::string> &modules)
+{
+	size = std::max(size, 0);
+
+	// Create the new states first, so a module which fails to load leaves
+	// the old settings in place.
+	std::vector<lua_State *> states;
+
+	try
+	{
+		for (int i = 0; i < size; i++)
+			states.push_back(newState(modules));
+	}
+	catch (love::Exception &)
+	{
+		for (lua_State *L : states)
+			lua_close(L);
+		throw;
+	}
+
+	std::vector<State> old;
+
+	{
+		Lock lock(mutex);
+
+		this->size = size;
+		this->modules = modules;
+		generation++;
+
+		old.swap(idle);
+		for (lua_State *L : states)
+			idle.push_back({L, generation});
+	}
+
+	for (const State &state : old)
+		lua_close(state.L);
+}
+
+int LuaStatePool::getSize() const
+{
+	Lock lock(mutex);
+	return size;
+}
+
+std::vector<std::string> LuaStatePool::getModules() const
+{
+	Lock lock(mutex);
+	return modules;
+}
+
+lua_State *LuaStatePool::acquireState(bool &reusable)
+{
+	int stategeneration = 0;
+	std::vector<std::string> statemodules;
+
+	{
+		Lock lock(mutex);
+
+		reusable = size > 0;
+
+		if (!idle.empty())
+		{
+			State state = idle.back();
+			idle.pop_back();
+			busy.push_back(state);
+			return state.L;
+		}
+
+		stategeneration = generation;
+		statemodules = modules;
+	}
+
+	lua_State *L = newState(statemodules);
+
+	Lock lock(mutex);
+	busy.push_back({L, stategeneration});
+	return L;
+}
+
+void LuaStatePool::releaseState(lua_State *L, bool reuse)
+{
+	if (reuse)
+	{
+		lua_settop(L, 0);
+		lua_gc(L, LUA_GCCOLLECT, 0);
+	}
+
+	{
+		Lock lock(mutex);
+
+		auto it = std::find_if(busy.begin(), busy.end(), [&](const State &s) { return s.L == L; });
+		if (it != busy.end())
+		{
+			State state = *it;
+			busy.erase(it);
+
+			if (reuse && state.generation == generation && (int) idle.size() < size)
+			{
+				idle.push_back(state);
+				return;
+			}
+		}
+	}
+
+	lua_close(L);
+}
+
+void LuaStatePool::clear()
+{
+	std::vector<State> old;
+
+	{
+		Lock lock(mutex);
+		size = 0;
+		generation++;
+		old.swap(idle);
+	}
+
+	for (const State &state : old)
+		lua_close(state.L);
+}
+
+lua_State *LuaStatePool::newState(const std::vector<std::string> &modules)
+{
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+
+	lua_pushboolean(L, 1);
+	lua_setfield(L, LUA_REGISTRYINDEX, THREAD_STATE_KEY);
+
+#ifdef LOVE_BUILD_STANDALONE
+	// Call LuaJIT-specific setup again. While it's quite late to call it at
+	// this point, it still needed to turn off JIT compilation (if necessary)
+	// for this thread.
+	luax_preload(L, luaopen_love_jitsetup, "love.jitsetup");
+	luax_require(L, "love.jitsetup");
+	lua_pop(L, 1);
+
+	luax_preload(L, luaopen_love, "love");
+	luax_require(L, "love");
+	lua_pop(L, 1);
+#endif // LOVE_BUILD_STANDALONE
+
+	luax_require(L, "love.thread");
+	lua_pop(L, 1);
+
+	// We load love.filesystem by default, since require still exists without it
+	// but won't load files from the proper paths. love.filesystem also must be
+	// loaded before using any love function that can take a filepath argument.
+	luax_require(L, "love.filesystem");
+	lua_pop(L, 1);
+
+	for (const std::string &module : modules)
+	{
+		lua_getglobal(L, "require");
+		lua_pushstring(L, module.c_str());
+
+		if (lua_pcall(L, 1, 0, 0) != 0)
+		{
+			std::string err = luax_tostring(L, -1);
+			lua_close(L);
+			throw love::Exception("Could not load module '%s' for a thread: %s", module.c_str(), err.c_str());
+		}
+	}
+
+	return L;
+}
+
+bool LuaStatePool::isThreadState(lua_State *L)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, THREAD_STATE_KEY);
+	bool threadstate = lua_toboolean(L, -1) != 0;
+	lua_pop(L, 1);
+	return threadstate;
+}
+
+} // thread
+} // love
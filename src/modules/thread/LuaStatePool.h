@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LUA_STATE_POOL_H
+#define LOVE_THREAD_LUA_STATE_POOL_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "threads.h"
+
+// C++
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * Keeps Lua states which have already loaded LOVE's modules, so new Threads
+ * can reuse them instead of setting up a new state every time they start.
+ * Each state is reused by one Thread at a time.
+ **/
+class LuaStatePool : public love::Object
+{
+public:
+
+	LuaStatePool();
+	virtual ~LuaStatePool();
+
+	/**
+	 * Sets how many idle states are kept, and which modules (in addition to
+	 * love.thread and love.filesystem) they load when they're created. The
+	 * pool is filled with new states right away. States which were set up
+	 * with the previous settings aren't reused.
+	 **/
+	void configure(int size, const std::vector<std::string> &modules);
+
+	int getSize() const;
+	std::vector<std::string> getModules() const;
+
+	/**
+	 * Gets an idle state, or creates a new one if none are left.
+	 * @param reusable Set to whether the state will be kept after release,
+	 *        so code run in it should leave no trace in its globals.
+	 **/
+	lua_State *acquireState(bool &reusable);
+
+	/**
+	 * Gives back a state from acquireState. It's closed instead of kept if
+	 * reuse is false, the pool is full, or the settings changed since it was
+	 * made.
+	 **/
+	void releaseState(lua_State *L, bool reuse);
+
+	/**
+	 * Closes every idle state. States which are in use are closed when
+	 * they're released, until the pool is configured again.
+	 **/
+	void clear();
+
+	/**
+	 * Creates a Lua state which has loaded love.thread, love.filesystem and
+	 * the given modules.
+	 **/
+	static lua_State *newState(const std::vector<std::string> &modules);
+
+	// Whether the state was created by newState, rather than being the main
+	// Lua state.
+	static bool isThreadState(lua_State *L);
+
+private:
+
+	struct State
+	{
+		lua_State *L;
+		int generation;
+	};
+
+	MutexRef mutex;
+
+	int size;
+	std::vector<std::string> modules;
+
+	// Incremented whenever the settings change, so states made with older
+	// settings aren't reused.
+	int generation;
+
+	std::vector<State> idle;
+	std::vector<State> busy;
+
+}; // LuaStatePool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LUA_STATE_POOL_H
@@ -23,11 +23,6 @@
 #include "common/config.h"
 #include "common/runtime.h"
 
-#ifdef LOVE_BUILD_STANDALONE
-extern "C" int luaopen_love(lua_State * L);
-extern "C" int luaopen_love_jitsetup(lua_State * L);
-#endif // LOVE_BUILD_STANDALONE
-
 namespace love
 {
 namespace thread
@@ -35,8 +30,9 @@ namespace thread
 
 love::Type LuaThread::type("Thread", &Threadable::type);
 
-LuaThread::LuaThread(const std::string &name, love::Data *code)
+LuaThread::LuaThread(const std::string &name, love::Data *code, LuaStatePool *pool)
 	: code(code)
+	, pool(pool)
 	, name(name)
 	, haserror(false)
 {
@@ -52,30 +48,23 @@ void LuaThread::threadFunction()
 	error.clear();
 	haserror = false;
 
-	lua_State *L = luaL_newstate();
-	luaL_openlibs(L);
-
-#ifdef LOVE_BUILD_STANDALONE
-	// Call LuaJIT-specific setup again. While it's quite late to call it at
-	// this point, it still needed to turn off JIT compilation (if necessary)
-	// for this thread.
-	luax_preload(L, luaopen_love_jitsetup, "love.jitsetup");
-	luax_require(L, "love.jitsetup");
-	lua_pop(L, 1);
-
-	luax_preload(L, luaopen_love, "love");
-	luax_require(L, "love");
-	lua_pop(L, 1);
-#endif // LOVE_BUILD_STANDALONE
-
-	luax_require(L, "love.thread");
-	lua_pop(L, 1);
+	lua_State *L = nullptr;
+	bool reusable = false;
 
-	// We load love.filesystem by default, since require still exists without it
-	// but won't load files from the proper paths. love.filesystem also must be
-	// loaded before using any love function that can take a filepath argument.
-	luax_require(L, "love.filesystem");
-	lua_pop(L, 1);
+	try
+	{
+		if (pool.get() != nullptr)
+			L = pool->acquireState(reusable);
+		else
+			L = LuaStatePool::newState({});
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+		haserror = true;
+		onError();
+		return;
+	}
 
 	lua_pushcfunction(L, luax_traceback);
 	int tracebackidx = lua_gettop(L);
@@ -87,6 +76,27 @@ void LuaThread::threadFunction()
 	}
 	else
 	{
+		// The state will run other code later, so globals set by this code go
+		// into their own table instead of the state's.
+		if (reusable)
+		{
+			lua_newtable(L);
+			lua_newtable(L);
+#if LUA_VERSION_NUM == 501
+			lua_pushvalue(L, LUA_GLOBALSINDEX);
+#else
+			lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+#endif
+			lua_setfield(L, -2, "__index");
+			lua_setmetatable(L, -2);
+#if LUA_VERSION_NUM == 501
+			lua_setfenv(L, -2);
+#else
+			// The main chunk's only upvalue is _ENV.
+			lua_setupvalue(L, -2, 1);
+#endif
+		}
+
 		int pushedargs = (int) args.size();
 
 		for (int i = 0; i < pushedargs; i++)
@@ -101,7 +111,10 @@ void LuaThread::threadFunction()
 		}
 	}
 
-	lua_close(L);
+	if (pool.get() != nullptr)
+		pool->releaseState(L, reusable && !haserror);
+	else
+		lua_close(L);
 
 	if (haserror)
 		onError();
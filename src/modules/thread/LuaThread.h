@@ -30,6 +30,7 @@
 #include "common/Object.h"
 #include "common/Variant.h"
 #include "threads.h"
+#include "LuaStatePool.h"
 
 namespace love
 {
@@ -42,7 +43,7 @@ public:
 
 	static love::Type type;
 
-	LuaThread(const std::string &name, love::Data *code);
+	LuaThread(const std::string &name, love::Data *code, LuaStatePool *pool = nullptr);
 	virtual ~LuaThread();
 	void threadFunction();
 	const std::string &getError() const;
@@ -55,6 +56,7 @@ private:
 	void onError();
 
 	StrongRef<love::Data> code;
+	StrongRef<LuaStatePool> pool;
 	std::string name;
 	std::string error;
 	bool haserror;
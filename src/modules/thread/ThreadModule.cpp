@@ -27,12 +27,13 @@ namespace thread
 
 ThreadModule::ThreadModule()
 	: love::Module(M_THREAD, "love.thread.sdl")
+	, statePool(new LuaStatePool(), Acquire::NORETAIN)
 {
 }
 
 LuaThread *ThreadModule::newThread(const std::string &name, love::Data *data)
 {
-	return new LuaThread(name, data);
+	return new LuaThread(name, data, statePool);
 }
 
 Channel *ThreadModule::newChannel()
@@ -40,6 +41,11 @@ Channel *ThreadModule::newChannel()
 	return new Channel();
 }
 
+BoundedChannel *ThreadModule::newBoundedChannel(size_t capacity)
+{
+	return new BoundedChannel(capacity);
+}
+
 Channel *ThreadModule::getChannel(const std::string &name)
 {
 	Lock lock(namedChannelMutex);
@@ -53,5 +59,28 @@ Channel *ThreadModule::getChannel(const std::string &name)
 	return c;
 }
 
+void ThreadModule::setStatePool(int size, const std::vector<std::string> &modules)
+{
+	statePool->configure(size, modules);
+}
+
+int ThreadModule::getStatePoolSize() const
+{
+	return statePool->getSize();
+}
+
+std::vector<std::string> ThreadModule::getStatePoolModules() const
+{
+	return statePool->getModules();
+}
+
+void ThreadModule::clearStatePool()
+{
+	// Closing the last state which uses this module destroys it, so the pool
+	// is kept alive separately until clear returns.
+	StrongRef<LuaStatePool> pool(statePool);
+	pool->clear();
+}
+
 } // thread
 } // love
@@ -32,7 +32,9 @@
 
 #include "Thread.h"
 #include "Channel.h"
+#include "BoundedChannel.h"
 #include "LuaThread.h"
+#include "LuaStatePool.h"
 #include "threads.h"
 
 namespace love
@@ -47,10 +49,28 @@ public:
 	virtual ~ThreadModule() {}
 	virtual LuaThread *newThread(const std::string &name, love::Data *data);
 	virtual Channel *newChannel();
+	virtual BoundedChannel *newBoundedChannel(size_t capacity);
 	virtual Channel *getChannel(const std::string &name);
 
+	/**
+	 * Threads created after this call reuse Lua states from a pool of the
+	 * given size, which have loaded the given modules up front.
+	 **/
+	void setStatePool(int size, const std::vector<std::string> &modules);
+	int getStatePoolSize() const;
+	std::vector<std::string> getStatePoolModules() const;
+
+	/**
+	 * Closes the idle pooled Lua states. The states keep the modules they
+	 * loaded (including this one) alive, so this has to be called when the
+	 * main Lua state is closed.
+	 **/
+	void clearStatePool();
+
 private:
 
+	StrongRef<LuaStatePool> statePool;
+
 	std::map<std::string, StrongRef<Channel>> namedChannels;
 	MutexRef namedChannelMutex;
 
@@ -20,12 +20,62 @@
 
 #include "Thread.h"
 
+#if defined(LOVE_LINUX)
+#include <sched.h>
+#elif defined(LOVE_WINDOWS)
+#include <windows.h>
+#endif
+
 namespace love
 {
 namespace thread
 {
 namespace sdl
 {
+
+static SDL_ThreadPriority getSDLPriority(Threadable::Priority priority)
+{
+	switch (priority)
+	{
+	case Threadable::PRIORITY_LOW: return SDL_THREAD_PRIORITY_LOW;
+	case Threadable::PRIORITY_HIGH: return SDL_THREAD_PRIORITY_HIGH;
+	case Threadable::PRIORITY_TIME_CRITICAL: return SDL_THREAD_PRIORITY_TIME_CRITICAL;
+	case Threadable::PRIORITY_NORMAL:
+	default: return SDL_THREAD_PRIORITY_NORMAL;
+	}
+}
+
+// Affinity is only a hint, so failures are ignored. macOS and iOS have no way
+// to pin threads to cores.
+static void setCurrentThreadAffinity(const std::vector<int> &cores)
+{
+	if (cores.empty())
+		return;
+
+#if defined(LOVE_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int core : cores)
+	{
+		if (core >= 0 && core < CPU_SETSIZE)
+			CPU_SET(core, &set);
+	}
+
+	if (CPU_COUNT(&set) > 0)
+		sched_setaffinity(0, sizeof(set), &set);
+#elif defined(LOVE_WINDOWS)
+	DWORD_PTR mask = 0;
+	for (int core : cores)
+	{
+		if (core >= 0 && core < (int) sizeof(DWORD_PTR) * 8)
+			mask |= (DWORD_PTR) 1 << core;
+	}
+
+	if (mask != 0)
+		SetThreadAffinityMask(GetCurrentThread(), mask);
+#endif
+}
+
 Thread::Thread(Threadable *t)
 	: t(t)
 	, running(false)
@@ -92,6 +142,11 @@ int Thread::thread_runner(void *data)
 {
 	Thread *self = (Thread *) data; // some compilers don't like 'this'
 
+	if (self->t->getPriority() != Threadable::PRIORITY_NORMAL)
+		SDL_SetCurrentThreadPriority(getSDLPriority(self->t->getPriority()));
+
+	setCurrentThreadAffinity(self->t->getAffinity());
+
 	self->t->threadFunction();
 
 	{
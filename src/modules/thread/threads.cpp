@@ -19,16 +19,31 @@
  **/
 
 #include "threads.h"
+#include "common/delay.h"
 
 #if defined(LOVE_LINUX)
 #include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
 #endif
 
+// C++
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 namespace love
 {
 namespace thread
 {
 
+// How long, in milliseconds, the main thread blocks before running its wait
+// callback again.
+static const int MAIN_THREAD_WAIT_SLICE = 1;
+
+static std::atomic<void (*)()> mainThreadWaitCallback(nullptr);
+static std::atomic<std::thread::id> mainThreadWaitID;
+
 Lock::Lock(Mutex *m)
 	: mutex(m)
 {
@@ -88,6 +103,7 @@ void EmptyLock::setLock(Mutex &m)
 love::Type Threadable::type("Threadable", &Object::type);
 
 Threadable::Threadable()
+	: priority(PRIORITY_NORMAL)
 {
 	owner = newThread(this);
 }
@@ -104,6 +120,9 @@ bool Threadable::start()
 
 void Threadable::wait()
 {
+	while (owner->isRunning() && runMainThreadWaitCallback())
+		love::sleep(MAIN_THREAD_WAIT_SLICE);
+
 	owner->wait();
 }
 
@@ -117,6 +136,100 @@ const char *Threadable::getThreadName() const
 	return threadName.empty() ? nullptr : threadName.c_str();
 }
 
+void Threadable::setThreadName(const std::string &name)
+{
+	threadName = name;
+}
+
+void Threadable::setPriority(Priority priority)
+{
+	this->priority = priority;
+}
+
+Threadable::Priority Threadable::getPriority() const
+{
+	return priority;
+}
+
+void Threadable::setAffinity(const std::vector<int> &cores)
+{
+	affinity = cores;
+}
+
+const std::vector<int> &Threadable::getAffinity() const
+{
+	return affinity;
+}
+
+std::vector<int> Threadable::getCores(CoreType type)
+{
+	std::vector<int> cores;
+	std::vector<long> frequencies;
+
+	if (type == CORE_ANY)
+		return cores;
+
+#if defined(LOVE_LINUX)
+	// Covers Android as well. Offline cores have no cpufreq entry, and are
+	// left out.
+	long corecount = sysconf(_SC_NPROCESSORS_CONF);
+	for (int i = 0; i < (int) corecount; i++)
+	{
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
+
+		FILE *file = fopen(path, "r");
+		if (file == nullptr)
+			continue;
+
+		long frequency = 0;
+		if (fscanf(file, "%ld", &frequency) == 1 && frequency > 0)
+		{
+			cores.push_back(i);
+			frequencies.push_back(frequency);
+		}
+
+		fclose(file);
+	}
+#endif
+
+	if (cores.empty())
+		return cores;
+
+	long maxfrequency = *std::max_element(frequencies.begin(), frequencies.end());
+	long minfrequency = *std::min_element(frequencies.begin(), frequencies.end());
+
+	// All cores are the same, so there's no preference to express.
+	if (maxfrequency == minfrequency)
+		return std::vector<int>();
+
+	std::vector<int> matches;
+	for (size_t i = 0; i < cores.size(); i++)
+	{
+		if (type == CORE_PERFORMANCE ? frequencies[i] == maxfrequency : frequencies[i] < maxfrequency)
+			matches.push_back(cores[i]);
+	}
+
+	return matches;
+}
+
+STRINGMAP_CLASS_BEGIN(Threadable, Threadable::Priority, Threadable::PRIORITY_MAX_ENUM, priority)
+{
+	{ "low",          Threadable::PRIORITY_LOW           },
+	{ "normal",       Threadable::PRIORITY_NORMAL        },
+	{ "high",         Threadable::PRIORITY_HIGH          },
+	{ "timecritical", Threadable::PRIORITY_TIME_CRITICAL },
+}
+STRINGMAP_CLASS_END(Threadable, Threadable::Priority, Threadable::PRIORITY_MAX_ENUM, priority)
+
+STRINGMAP_CLASS_BEGIN(Threadable, Threadable::CoreType, Threadable::CORE_MAX_ENUM, coreType)
+{
+	{ "any",         Threadable::CORE_ANY         },
+	{ "performance", Threadable::CORE_PERFORMANCE },
+	{ "efficiency",  Threadable::CORE_EFFICIENCY  },
+}
+STRINGMAP_CLASS_END(Threadable, Threadable::CoreType, Threadable::CORE_MAX_ENUM, coreType)
+
 MutexRef::MutexRef()
 	: mutex(newMutex())
 {
@@ -157,6 +270,39 @@ Conditional *ConditionalRef::operator->() const
 	return conditional;
 }
 
+void setMainThreadWaitCallback(void (*callback)())
+{
+	mainThreadWaitID.store(std::this_thread::get_id());
+	mainThreadWaitCallback.store(callback);
+}
+
+bool runMainThreadWaitCallback()
+{
+	void (*callback)() = mainThreadWaitCallback.load();
+	if (callback == nullptr || mainThreadWaitID.load() != std::this_thread::get_id())
+		return false;
+
+	callback();
+	return true;
+}
+
+bool waitAndRunMainThreadCallback(Conditional *cond, Mutex *mutex, int timeout)
+{
+	if (mainThreadWaitCallback.load() == nullptr || mainThreadWaitID.load() != std::this_thread::get_id())
+		return cond->wait(mutex, timeout);
+
+	if (timeout < 0 || timeout > MAIN_THREAD_WAIT_SLICE)
+		timeout = MAIN_THREAD_WAIT_SLICE;
+
+	bool signaled = cond->wait(mutex, timeout);
+
+	mutex->unlock();
+	runMainThreadWaitCallback();
+	mutex->lock();
+
+	return signaled;
+}
+
 #if defined(LOVE_LINUX)
 static sigset_t oldset;
 
@@ -23,10 +23,12 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/StringMap.h"
 #include "Thread.h"
 
 // C++
 #include <string>
+#include <vector>
 
 namespace love
 {
@@ -82,6 +84,23 @@ class Threadable : public love::Object
 public:
 	static love::Type type;
 
+	enum Priority
+	{
+		PRIORITY_LOW,
+		PRIORITY_NORMAL,
+		PRIORITY_HIGH,
+		PRIORITY_TIME_CRITICAL,
+		PRIORITY_MAX_ENUM
+	};
+
+	enum CoreType
+	{
+		CORE_ANY,
+		CORE_PERFORMANCE,
+		CORE_EFFICIENCY,
+		CORE_MAX_ENUM
+	};
+
 	Threadable();
 	virtual ~Threadable();
 
@@ -92,10 +111,40 @@ public:
 	bool isRunning() const;
 	const char *getThreadName() const;
 
+	/**
+	 * The name, priority and affinity are applied when the thread starts. The
+	 * name is shown by debuggers and profilers.
+	 **/
+	void setThreadName(const std::string &name);
+	void setPriority(Priority priority);
+	Priority getPriority() const;
+
+	/**
+	 * Limits the thread to the given CPU cores (numbered from 0). An empty
+	 * list lets it run on any core. This is a hint, and is ignored on
+	 * platforms which don't support it.
+	 **/
+	void setAffinity(const std::vector<int> &cores);
+	const std::vector<int> &getAffinity() const;
+
+	/**
+	 * Gets the CPU cores of the given type, for use with setAffinity. On CPUs
+	 * which mix fast and power-efficient cores (such as big.LITTLE), the
+	 * performance cores are the ones with the highest maximum frequency.
+	 * Returns an empty list (any core) when the core types aren't known or
+	 * every core is the same.
+	 **/
+	static std::vector<int> getCores(CoreType type);
+
+	STRINGMAP_CLASS_DECLARE(Priority);
+	STRINGMAP_CLASS_DECLARE(CoreType);
+
 protected:
 
 	Thread *owner;
 	std::string threadName;
+	Priority priority;
+	std::vector<int> affinity;
 
 };
 
@@ -129,6 +178,29 @@ Mutex *newMutex();
 Conditional *newConditional();
 Thread *newThread(Threadable *t);
 
+/**
+ * Sets a function the calling (main) thread runs while it's blocked in
+ * Thread:wait or a Channel's supply, demand or select. Other threads can
+ * queue work for the main thread (love.graphics object creation) and wait
+ * for it, so this stops the main thread from deadlocking while it waits on
+ * one of them. Pass nullptr to remove it.
+ **/
+void setMainThreadWaitCallback(void (*callback)());
+
+/**
+ * Runs the main thread wait callback, if there is one and this is the
+ * thread which set it. Returns whether it was run.
+ **/
+bool runMainThreadWaitCallback();
+
+/**
+ * Like cond->wait(mutex, timeout), but on the thread which set a main thread
+ * wait callback the wait is cut short and the callback is run with the
+ * mutex unlocked. Callers must check what they're waiting for again, and
+ * timed waits must measure the time which passed themselves.
+ **/
+bool waitAndRunMainThreadCallback(Conditional *cond, Mutex *mutex, int timeout = -1);
+
 #if defined(LOVE_LINUX)
 void disableSignals();
 void reenableSignals();
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_BoundedChannel.h"
+#include "wrap_Channel.h"
+
+namespace love
+{
+namespace thread
+{
+
+BoundedChannel *luax_checkboundedchannel(lua_State *L, int idx)
+{
+	return luax_checktype<BoundedChannel>(L, idx);
+}
+
+int w_BoundedChannel_push(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	bool transfer = luax_optboolean(L, 3, false);
+	bool result = false;
+	luax_catchexcept(L, [&]() {
+		Variant var = luax_checkchannelmessage(L, 2, transfer);
+		result = c->push(var);
+	});
+	luax_pushboolean(L, result);
+	return 1;
+}
+
+int w_BoundedChannel_pushMany(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	bool transfer = luax_optboolean(L, 3, false);
+
+	int count = (int) luax_objlen(L, 2);
+	size_t pushed = 0;
+
+	luax_catchexcept(L, [&]() {
+		std::vector<Variant> vars;
+		vars.reserve(count);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			vars.push_back(luax_checkchannelmessage(L, -1, transfer));
+			lua_pop(L, 1);
+		}
+
+		if (!vars.empty())
+			pushed = c->pushMany(vars.data(), vars.size());
+	});
+
+	lua_pushinteger(L, (lua_Integer) pushed);
+	return 1;
+}
+
+int w_BoundedChannel_supply(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	bool transfer = luax_optboolean(L, 4, false);
+	bool result = false;
+	luax_catchexcept(L, [&]() {
+		Variant var = luax_checkchannelmessage(L, 2, transfer);
+		if (lua_isnumber(L, 3))
+			result = c->supply(var, lua_tonumber(L, 3));
+		else
+			result = c->supply(var);
+	});
+	luax_pushboolean(L, result);
+	return 1;
+}
+
+int w_BoundedChannel_pop(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	Variant var;
+	if (c->pop(&var))
+		luax_pushvariant(L, var);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_BoundedChannel_popMany(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	lua_Integer max = luaL_optinteger(L, 2, (lua_Integer) c->getCapacity());
+
+	std::vector<Variant> vars;
+	if (max > 0)
+		c->popMany(vars, (size_t) max);
+
+	lua_createtable(L, (int) vars.size(), 0);
+	for (size_t i = 0; i < vars.size(); i++)
+	{
+		luax_pushvariant(L, vars[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+	return 1;
+}
+
+int w_BoundedChannel_demand(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	Variant var;
+	bool result = false;
+
+	if (lua_isnumber(L, 2))
+		result = c->demand(&var, lua_tonumber(L, 2));
+	else
+		result = c->demand(&var);
+
+	if (result)
+		luax_pushvariant(L, var);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_BoundedChannel_getCount(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	lua_pushnumber(L, c->getCount());
+	return 1;
+}
+
+int w_BoundedChannel_getCapacity(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	lua_pushnumber(L, (lua_Number) c->getCapacity());
+	return 1;
+}
+
+int w_BoundedChannel_clear(lua_State *L)
+{
+	BoundedChannel *c = luax_checkboundedchannel(L, 1);
+	c->clear();
+	return 0;
+}
+
+static const luaL_Reg w_BoundedChannel_functions[] =
+{
+	{ "push", w_BoundedChannel_push },
+	{ "pushMany", w_BoundedChannel_pushMany },
+	{ "supply", w_BoundedChannel_supply },
+	{ "pop", w_BoundedChannel_pop },
+	{ "popMany", w_BoundedChannel_popMany },
+	{ "demand", w_BoundedChannel_demand },
+	{ "getCount", w_BoundedChannel_getCount },
+	{ "getCapacity", w_BoundedChannel_getCapacity },
+	{ "clear", w_BoundedChannel_clear },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_boundedchannel(lua_State *L)
+{
+	return luax_register_type(L, &BoundedChannel::type, w_BoundedChannel_functions, nullptr);
+}
+
+} // thread
+} // love
@@ -19,6 +19,7 @@
 **/
 
 #include "wrap_Channel.h"
+#include "data/ByteData.h"
 
 namespace love
 {
@@ -30,13 +31,43 @@ Channel *luax_checkchannel(lua_State *L, int idx)
 	return luax_checktype<Channel>(L, idx);
 }
 
+// When transferring, ByteData gives its memory to a new ByteData instead of
+// being shared between threads, and strings are sent as ByteData so the
+// receiving thread doesn't need to copy them again.
+Variant luax_checkchannelmessage(lua_State *L, int idx, bool transfer)
+{
+	if (transfer)
+	{
+		if (luax_istype(L, idx, love::data::ByteData::type))
+		{
+			love::data::ByteData *d = luax_checktype<love::data::ByteData>(L, idx);
+			StrongRef<love::data::ByteData> moved(d->transfer(), Acquire::NORETAIN);
+			return Variant(&love::data::ByteData::type, moved.get());
+		}
+		else if (lua_type(L, idx) == LUA_TSTRING)
+		{
+			size_t len = 0;
+			const char *str = lua_tolstring(L, idx, &len);
+			if (len > 0)
+			{
+				StrongRef<love::data::ByteData> d(new love::data::ByteData(str, len), Acquire::NORETAIN);
+				return Variant(&love::data::ByteData::type, d.get());
+			}
+		}
+	}
+
+	Variant var = luax_checkvariant(L, idx);
+	if (var.getType() == Variant::UNKNOWN)
+		luaL_argerror(L, idx, "boolean, number, string, love type, or table expected");
+	return var;
+}
+
 int w_Channel_push(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
+	bool transfer = luax_optboolean(L, 3, false);
 	luax_catchexcept(L, [&]() {
-		Variant var = luax_checkvariant(L, 2);
-		if (var.getType() == Variant::UNKNOWN)
-			luaL_argerror(L, 2, "boolean, number, string, love type, or table expected");
+		Variant var = luax_checkchannelmessage(L, 2, transfer);
 		uint64 id = c->push(var);
 		lua_pushnumber(L, (lua_Number) id);
 	});
@@ -47,10 +78,9 @@ int w_Channel_supply(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	bool result = false;
+	bool transfer = luax_optboolean(L, 4, false);
 	luax_catchexcept(L, [&]() {
-		Variant var = luax_checkvariant(L, 2);
-		if (var.getType() == Variant::UNKNOWN)
-			luaL_argerror(L, 2, "boolean, number, string, love type, or table expected");
+		Variant var = luax_checkchannelmessage(L, 2, transfer);
 		if (lua_isnumber(L, 3))
 			result = c->supply(var, lua_tonumber(L, 3));
 		else
@@ -31,6 +31,13 @@ namespace thread
 {
 
 Channel *luax_checkchannel(lua_State *L, int idx);
+
+/**
+ * Gets a value to send through a channel. With transfer, ByteData and strings
+ * are sent without being shared with (or copied again by) the receiver.
+ **/
+Variant luax_checkchannelmessage(lua_State *L, int idx, bool transfer);
+
 extern "C" int luaopen_channel(lua_State *L);
 
 } // thread
@@ -22,7 +22,9 @@
 #include "wrap_ThreadModule.h"
 #include "wrap_LuaThread.h"
 #include "wrap_Channel.h"
+#include "wrap_BoundedChannel.h"
 #include "ThreadModule.h"
+#include "JobSystem.h"
 
 #include "filesystem/File.h"
 #include "filesystem/FileData.h"
@@ -75,7 +77,59 @@ int w_newThread(lua_State *L)
 		data = luax_checktype<love::Data>(L, 1);
 	}
 
+	Threadable::Priority priority = Threadable::PRIORITY_NORMAL;
+	std::vector<int> affinity;
+	std::string threadname;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		lua_getfield(L, 2, "name");
+		if (!lua_isnoneornil(L, -1))
+			threadname = luax_checkstring(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "priority");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!Threadable::getConstant(str, priority))
+				return luax_enumerror(L, "thread priority", Threadable::getConstants(priority), str);
+		}
+		lua_pop(L, 1);
+
+		// Either a core type, or a list of core numbers starting at 1.
+		lua_getfield(L, 2, "affinity");
+		if (lua_type(L, -1) == LUA_TSTRING)
+		{
+			const char *str = lua_tostring(L, -1);
+			Threadable::CoreType coretype = Threadable::CORE_ANY;
+			if (!Threadable::getConstant(str, coretype))
+				return luax_enumerror(L, "CPU core type", Threadable::getConstants(coretype), str);
+			affinity = Threadable::getCores(coretype);
+		}
+		else if (lua_istable(L, -1))
+		{
+			for (int i = 1; i <= (int) luax_objlen(L, -1); i++)
+			{
+				lua_rawgeti(L, -1, i);
+				affinity.push_back((int) luaL_checkinteger(L, -1) - 1);
+				lua_pop(L, 1);
+			}
+		}
+		else if (!lua_isnoneornil(L, -1))
+			return luaL_error(L, "Thread affinity must be a CPU core type or a table of core numbers.");
+		lua_pop(L, 1);
+	}
+
 	LuaThread *t = instance()->newThread(name, data);
+
+	if (!threadname.empty())
+		t->setThreadName(threadname);
+	t->setPriority(priority);
+	t->setAffinity(affinity);
+
 	luax_pushtype(L, t);
 	t->release();
 	return 1;
@@ -89,6 +143,19 @@ int w_newChannel(lua_State *L)
 	return 1;
 }
 
+int w_newBoundedChannel(lua_State *L)
+{
+	lua_Integer capacity = luaL_checkinteger(L, 1);
+	if (capacity <= 0)
+		return luaL_error(L, "BoundedChannel capacity must be greater than 0.");
+
+	BoundedChannel *c = nullptr;
+	luax_catchexcept(L, [&]() { c = instance()->newBoundedChannel((size_t) capacity); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
 int w_getChannel(lua_State *L)
 {
 	std::string name = luax_checkstring(L, 1);
@@ -97,18 +164,116 @@ int w_getChannel(lua_State *L)
 	return 1;
 }
 
+int w_select(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	std::vector<Channel *> channels;
+	for (int i = 1; i <= (int) luax_objlen(L, 1); i++)
+	{
+		lua_rawgeti(L, 1, i);
+		channels.push_back(luax_checkchannel(L, -1));
+		lua_pop(L, 1);
+	}
+
+	double timeout = luaL_optnumber(L, 2, -1.0);
+	if (channels.empty())
+		return luaL_error(L, "At least one Channel must be given.");
+
+	Variant var;
+	int index = Channel::select(channels, &var, timeout);
+
+	if (index < 0)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_rawgeti(L, 1, index + 1);
+	luax_pushvariant(L, var);
+	return 2;
+}
+
+int w_getWorkerCount(lua_State *L)
+{
+	lua_pushinteger(L, JobSystem::getSharedWorkerCount());
+	return 1;
+}
+
+int w_setWorkerCount(lua_State *L)
+{
+	int count = (int) luaL_checkinteger(L, 1);
+	if (count < 1)
+		return luaL_error(L, "The worker count must be at least 1.");
+
+	luax_catchexcept(L, [&]() { JobSystem::setSharedWorkerCount(count); });
+	return 0;
+}
+
+int w_setStatePool(lua_State *L)
+{
+	int size = (int) luaL_checkinteger(L, 1);
+	if (size < 0)
+		return luaL_error(L, "The state pool size can't be negative.");
+
+	std::vector<std::string> modules;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		for (int i = 1; i <= (int) luax_objlen(L, 2); i++)
+		{
+			lua_rawgeti(L, 2, i);
+			modules.push_back(luax_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&]() { instance()->setStatePool(size, modules); });
+	return 0;
+}
+
+int w_getStatePool(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getStatePoolSize());
+
+	std::vector<std::string> modules = instance()->getStatePoolModules();
+	lua_createtable(L, (int) modules.size(), 0);
+	for (int i = 0; i < (int) modules.size(); i++)
+	{
+		luax_pushstring(L, modules[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 2;
+}
+
+static int w__clearStatePool(lua_State *)
+{
+	ThreadModule *module = instance();
+	if (module != nullptr)
+		module->clearStatePool();
+	return 0;
+}
+
 // List of functions to wrap.
 static const luaL_Reg module_functions[] =
 {
 	{ "newThread", w_newThread },
 	{ "newChannel", w_newChannel },
+	{ "newBoundedChannel", w_newBoundedChannel },
 	{ "getChannel", w_getChannel },
+	{ "select", w_select },
+	{ "getWorkerCount", w_getWorkerCount },
+	{ "setWorkerCount", w_setWorkerCount },
+	{ "setStatePool", w_setStatePool },
+	{ "getStatePool", w_getStatePool },
 	{ 0, 0 }
 };
 
 static const lua_CFunction types[] = {
 	luaopen_thread,
 	luaopen_channel,
+	luaopen_boundedchannel,
 	0
 };
 
@@ -122,6 +287,18 @@ extern "C" int luaopen_love_thread(lua_State *L)
 	else
 		instance->retain();
 
+	// Pooled Lua states keep love.thread and the other modules they loaded
+	// alive, so the pool is emptied when a main Lua state is closed.
+	if (!LuaStatePool::isThreadState(L))
+	{
+		lua_newuserdata(L, 0);
+		lua_newtable(L);
+		lua_pushcfunction(L, w__clearStatePool);
+		lua_setfield(L, -2, "__gc");
+		lua_setmetatable(L, -2);
+		lua_setfield(L, LUA_REGISTRYINDEX, "_love_thread_statepool");
+	}
+
 	WrappedModule w;
 	w.module = instance;
 	w.name = "thread";
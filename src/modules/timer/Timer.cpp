@@ -25,6 +25,7 @@
 #include "Timer.h"
 
 #include <iostream>
+#include <thread>
 #if defined(LOVE_WINDOWS)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -51,8 +52,35 @@ Timer::Timer()
 	, fpsUpdateFrequency(1)
 	, frames(0)
 	, dt(0)
+	, framePeriod(0)
+	, nextFrameTime(0)
+	, spinMargin(0.002)
+	, frameTimer(nullptr)
 {
 	prevFpsUpdate = currTime = getTime();
+
+#if defined(LOVE_WINDOWS)
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+	// High resolution waitable timers are available since Windows 10 1803,
+	// and aren't tied to the 15.6ms system timer resolution.
+	frameTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (frameTimer != nullptr)
+		spinMargin = 0.001;
+#elif defined(LOVE_LINUX)
+	spinMargin = 0.0005;
+#elif defined(LOVE_MACOS) || defined(LOVE_IOS)
+	spinMargin = 0.0005;
+#endif
+}
+
+Timer::~Timer()
+{
+#if defined(LOVE_WINDOWS)
+	if (frameTimer != nullptr)
+		CloseHandle((HANDLE) frameTimer);
+#endif
 }
 
 double Timer::step()
@@ -88,6 +116,75 @@ void Timer::sleep(double seconds) const
 		love::sleep(seconds*1000);
 }
 
+void Timer::setFrameLimit(double fps)
+{
+	framePeriod = fps > 0.0 ? 1.0 / fps : 0.0;
+	nextFrameTime = getTime() + framePeriod;
+}
+
+double Timer::getFrameLimit() const
+{
+	return framePeriod > 0.0 ? 1.0 / framePeriod : 0.0;
+}
+
+double Timer::waitForNextFrame()
+{
+	if (framePeriod <= 0.0)
+		return 0.0;
+
+	double start = getTime();
+
+	// Don't try to catch up after a hitch, that would run several frames back
+	// to back.
+	if (start - nextFrameTime > framePeriod)
+		nextFrameTime = start;
+
+	sleepUntil(nextFrameTime);
+	nextFrameTime += framePeriod;
+
+	return getTime() - start;
+}
+
+void Timer::sleepUntil(double time)
+{
+	while (true)
+	{
+		double remaining = time - getTime();
+		if (remaining <= 0.0)
+			break;
+
+		if (remaining > spinMargin)
+			sleepOS(remaining - spinMargin);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void Timer::sleepOS(double seconds)
+{
+#if defined(LOVE_WINDOWS)
+	if (frameTimer != nullptr)
+	{
+		// Negative values are relative, in 100 nanosecond intervals.
+		LARGE_INTEGER due;
+		due.QuadPart = -(LONGLONG) (seconds * 1.0e7);
+		if (SetWaitableTimer((HANDLE) frameTimer, &due, 0, nullptr, nullptr, FALSE))
+		{
+			WaitForSingleObject((HANDLE) frameTimer, INFINITE);
+			return;
+		}
+	}
+#elif defined(LOVE_LINUX) && _POSIX_TIMERS > 0
+	timespec ts;
+	ts.tv_sec = (time_t) seconds;
+	ts.tv_nsec = (long) ((seconds - (double) ts.tv_sec) * 1.0e9);
+	clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, nullptr);
+	return;
+#endif
+
+	love::sleep(seconds * 1000);
+}
+
 double Timer::getDelta() const
 {
 	return dt;
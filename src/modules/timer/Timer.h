@@ -34,7 +34,7 @@ class Timer : public Module
 public:
 
 	Timer();
-	virtual ~Timer() {}
+	virtual ~Timer();
 
 	/**
 	 * Measures the time between this call and the previous call,
@@ -49,6 +49,22 @@ public:
 	 **/
 	void sleep(double seconds) const;
 
+	/**
+	 * Sets the frame rate waitForNextFrame paces frames to, or 0 to disable
+	 * the limit.
+	 **/
+	void setFrameLimit(double fps);
+	double getFrameLimit() const;
+
+	/**
+	 * Waits until the next frame should start, according to the frame limit.
+	 * The OS is asked to sleep for most of the wait and the rest is spent
+	 * spinning, so frames start within a fraction of a millisecond of when
+	 * they should.
+	 * @return The number of seconds spent waiting.
+	 **/
+	double waitForNextFrame();
+
 	/**
 	 * Gets the time between the last two frames, assuming step is called
 	 * each frame.
@@ -79,6 +95,11 @@ public:
 
 private:
 
+	// Sleeps for roughly the given time with the most precise OS timer
+	// available. May return early or late.
+	void sleepOS(double seconds);
+	void sleepUntil(double time);
+
 	// Frame delta vars.
 	double currTime;
 	double prevTime;
@@ -97,6 +118,17 @@ private:
 	// The current timestep.
 	double dt;
 
+	// Frame limiter. Frames are paced against fixed deadlines rather than
+	// the end of the previous wait, so oversleeping doesn't accumulate.
+	double framePeriod;
+	double nextFrameTime;
+
+	// How long before a deadline to stop sleeping and start spinning.
+	double spinMargin;
+
+	// Waitable timer handle on Windows.
+	void *frameTimer;
+
 }; // Timer
 
 } // timer
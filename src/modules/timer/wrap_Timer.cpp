@@ -60,6 +60,28 @@ int w_sleep(lua_State *L)
 	return 0;
 }
 
+int w_setFrameLimit(lua_State *L)
+{
+	double fps = luaL_checknumber(L, 1);
+	if (fps < 0.0)
+		return luaL_error(L, "Frame limit must not be negative.");
+
+	instance()->setFrameLimit(fps);
+	return 0;
+}
+
+int w_getFrameLimit(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getFrameLimit());
+	return 1;
+}
+
+int w_waitForNextFrame(lua_State *L)
+{
+	lua_pushnumber(L, instance()->waitForNextFrame());
+	return 1;
+}
+
 int w_getTime(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getTime());
@@ -74,6 +96,9 @@ static const luaL_Reg functions[] =
 	{ "getFPS", w_getFPS },
 	{ "getAverageDelta", w_getAverageDelta },
 	{ "sleep", w_sleep },
+	{ "setFrameLimit", w_setFrameLimit },
+	{ "getFrameLimit", w_getFrameLimit },
+	{ "waitForNextFrame", w_waitForNextFrame },
 	{ "getTime", w_getTime },
 	{ 0, 0 }
 };
@@ -25,6 +25,7 @@
 
 #include "sdl/Touch.h"
 #include "common/Optional.h"
+#include "common/Data.h"
 
 namespace love
 {
@@ -75,6 +76,86 @@ int w_getTouches(lua_State *L)
 	return 1;
 }
 
+int w_getTouchState(lua_State *L)
+{
+	Optional<Touch::DeviceType> typefilter;
+	if (!lua_isnoneornil(L, 2))
+	{
+		const char *typestr = luaL_checkstring(L, 2);
+		if (!Touch::getConstant(typestr, typefilter.value))
+			return luax_enumerror(L, "touch device type", Touch::getConstants(typefilter.value), typestr);
+		typefilter.hasValue = true;
+	}
+
+	const std::vector<Touch::TouchInfo> &touches = instance()->getTouches();
+
+	if (luax_istype(L, 1, love::Data::type))
+	{
+		// Same layout as a C struct { int64 id; double x, y, pressure; }.
+		struct TouchState
+		{
+			int64 id;
+			double x;
+			double y;
+			double pressure;
+		};
+
+		love::Data *data = luax_totype<love::Data>(L, 1);
+		size_t capacity = data->getSize() / sizeof(TouchState);
+		TouchState *out = (TouchState *) data->getData();
+
+		size_t count = 0;
+		for (const Touch::TouchInfo &touch : touches)
+		{
+			if (typefilter.hasValue && typefilter.value != touch.deviceType)
+				continue;
+
+			if (count >= capacity)
+				return luaL_error(L, "Data is too small to hold every active touch.");
+
+			out[count++] = {touch.id, touch.x, touch.y, touch.pressure};
+		}
+
+		lua_pushinteger(L, (lua_Integer) count);
+		return 1;
+	}
+
+	// Flat array of id, x, y, pressure for each touch, reusing the given
+	// table.
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, (int) touches.size() * 4, 0);
+
+	int t = lua_gettop(L);
+	int index = 1;
+
+	for (const Touch::TouchInfo &touch : touches)
+	{
+		if (typefilter.hasValue && typefilter.value != touch.deviceType)
+			continue;
+
+		// See getTouches for why ids are lightuserdata.
+		lua_pushlightuserdata(L, (void *)(intptr_t)touch.id);
+		lua_rawseti(L, t, index++);
+		lua_pushnumber(L, touch.x);
+		lua_rawseti(L, t, index++);
+		lua_pushnumber(L, touch.y);
+		lua_rawseti(L, t, index++);
+		lua_pushnumber(L, touch.pressure);
+		lua_rawseti(L, t, index++);
+	}
+
+	for (int i = (int) luax_objlen(L, t); i >= index; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, t, i);
+	}
+
+	lua_pushinteger(L, (index - 1) / 4);
+	return 2;
+}
+
 int w_getPosition(lua_State *L)
 {
 	int64 id = luax_checktouchid(L, 1);
@@ -128,6 +209,7 @@ int w_isMouse(lua_State *L)
 static const luaL_Reg functions[] =
 {
 	{ "getTouches", w_getTouches },
+	{ "getTouchState", w_getTouchState },
 	{ "getPosition", w_getPosition },
 	{ "getPressure", w_getPressure },
 	{ "getDeviceType", w_getDeviceType },
@@ -26,6 +26,7 @@
 #include "filesystem/File.h"
 
 #include "VideoStream.h"
+#include "VideoFormat.h"
 
 namespace love
 {
@@ -43,6 +44,11 @@ public:
 	 **/
 	virtual VideoStream *newVideoStream(love::filesystem::File *file) = 0;
 
+	/**
+	 * Whether videos with the given container and codec can be decoded.
+	 **/
+	virtual bool isSupported(const VideoFormat &format) const = 0;
+
 protected:
 
 	Video(const char *name)
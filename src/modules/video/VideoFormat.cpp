@@ -0,0 +1,290 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "VideoFormat.h"
+#include "common/int.h"
+
+// C++
+#include <vector>
+#include <algorithm>
+
+// C
+#include <string.h>
+
+namespace love
+{
+namespace video
+{
+
+namespace
+{
+
+// How much of the start of a file is searched for Ogg stream headers and
+// Matroska track info.
+const int64 OGG_PROBE_SIZE = 64 * 1024;
+const int64 MATROSKA_PROBE_SIZE = 1024 * 1024;
+
+// MP4 'moov' boxes larger than this aren't read to find the codec.
+const uint64 MP4_MAX_MOOV_SIZE = 64 * 1024 * 1024;
+
+uint32 readBE32(const uint8 *p)
+{
+	return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+}
+
+uint64 readBE64(const uint8 *p)
+{
+	return ((uint64) readBE32(p) << 32) | readBE32(p + 4);
+}
+
+bool hasType(const uint8 *type, const char *name)
+{
+	return memcmp(type, name, 4) == 0;
+}
+
+bool contains(const std::vector<uint8> &data, const char *str, size_t length)
+{
+	const uint8 *bytes = (const uint8 *) str;
+	return std::search(data.begin(), data.end(), bytes, bytes + length) != data.end();
+}
+
+std::vector<uint8> readStart(Stream *stream, int64 size)
+{
+	std::vector<uint8> data((size_t) size);
+	int64 read = stream->seek(0) ? stream->read(data.data(), size) : 0;
+	data.resize((size_t) std::max<int64>(read, 0));
+	return data;
+}
+
+Codec getMP4SampleEntryCodec(const uint8 *type)
+{
+	if (hasType(type, "avc1") || hasType(type, "avc3"))
+		return CODEC_H264;
+	if (hasType(type, "hvc1") || hasType(type, "hev1"))
+		return CODEC_H265;
+	if (hasType(type, "av01"))
+		return CODEC_AV1;
+	return CODEC_MAX_ENUM;
+}
+
+// Walks the boxes in [data, data + size), descending into the ones on the path
+// to each track's sample descriptions (moov/trak/mdia/minf/stbl/stsd).
+Codec findMP4Codec(const uint8 *data, size_t size)
+{
+	size_t pos = 0;
+
+	while (pos + 8 <= size)
+	{
+		uint64 boxsize = readBE32(data + pos);
+		const uint8 *type = data + pos + 4;
+		size_t headersize = 8;
+
+		if (boxsize == 1)
+		{
+			if (pos + 16 > size)
+				break;
+			boxsize = readBE64(data + pos + 8);
+			headersize = 16;
+		}
+		else if (boxsize == 0)
+			boxsize = size - pos;
+
+		if (boxsize < headersize || boxsize > size - pos)
+			break;
+
+		const uint8 *body = data + pos + headersize;
+		size_t bodysize = (size_t) boxsize - headersize;
+
+		if (hasType(type, "trak") || hasType(type, "mdia") || hasType(type, "minf") || hasType(type, "stbl"))
+		{
+			Codec codec = findMP4Codec(body, bodysize);
+			if (codec != CODEC_MAX_ENUM)
+				return codec;
+		}
+		else if (hasType(type, "stsd"))
+		{
+			// Version, flags and entry count come before the sample entries,
+			// which start with their size and format like a box.
+			size_t entry = 8;
+			while (entry + 8 <= bodysize)
+			{
+				Codec codec = getMP4SampleEntryCodec(body + entry + 4);
+				if (codec != CODEC_MAX_ENUM)
+					return codec;
+
+				uint32 entrysize = readBE32(body + entry);
+				if (entrysize < 8)
+					break;
+				entry += entrysize;
+			}
+		}
+
+		pos += (size_t) boxsize;
+	}
+
+	return CODEC_MAX_ENUM;
+}
+
+// Finds the top-level 'moov' box without reading the media data around it,
+// which can come before it.
+Codec probeMP4Codec(Stream *stream)
+{
+	int64 filesize = stream->getSize();
+	int64 pos = 0;
+
+	while (pos + 8 <= filesize)
+	{
+		uint8 header[16];
+		if (!stream->seek(pos) || stream->read(header, 16) < 8)
+			break;
+
+		uint64 boxsize = readBE32(header);
+		uint64 headersize = 8;
+
+		if (boxsize == 1)
+		{
+			boxsize = readBE64(header + 8);
+			headersize = 16;
+		}
+		else if (boxsize == 0)
+			boxsize = (uint64) (filesize - pos);
+
+		if (boxsize < headersize || boxsize > (uint64) (filesize - pos))
+			break;
+
+		if (hasType(header + 4, "moov"))
+		{
+			uint64 bodysize = boxsize - headersize;
+			if (bodysize > MP4_MAX_MOOV_SIZE)
+				break;
+
+			std::vector<uint8> body((size_t) bodysize);
+			if (!stream->seek(pos + (int64) headersize) || stream->read(body.data(), (int64) bodysize) != (int64) bodysize)
+				break;
+
+			return findMP4Codec(body.data(), body.size());
+		}
+
+		pos += (int64) boxsize;
+	}
+
+	return CODEC_MAX_ENUM;
+}
+
+} // anonymous namespace
+
+VideoFormat probeVideoFormat(Stream *stream)
+{
+	VideoFormat format;
+
+	uint8 header[8] = {};
+	if (!stream->seek(0) || stream->read(header, sizeof(header)) != (int64) sizeof(header))
+	{
+		stream->seek(0);
+		return format;
+	}
+
+	if (memcmp(header, "OggS", 4) == 0)
+	{
+		format.container = CONTAINER_OGG;
+
+		// Every logical stream starts with a header page before any data, and
+		// a Theora stream's identification header starts with 0x80 "theora".
+		std::vector<uint8> start = readStart(stream, OGG_PROBE_SIZE);
+		if (contains(start, "\x80theora", 7))
+			format.codec = CODEC_THEORA;
+	}
+	else if (readBE32(header) == 0x1A45DFA3)
+	{
+		format.container = CONTAINER_MATROSKA;
+
+		// Track entries name their codec with a CodecID string.
+		static const struct { const char *id; Codec codec; } codecIDs[] =
+		{
+			{ "V_MPEG4/ISO/AVC",  CODEC_H264   },
+			{ "V_MPEGH/ISO/HEVC", CODEC_H265   },
+			{ "V_AV1",            CODEC_AV1    },
+			{ "V_THEORA",         CODEC_THEORA },
+		};
+
+		std::vector<uint8> start = readStart(stream, MATROSKA_PROBE_SIZE);
+		for (const auto &codecID : codecIDs)
+		{
+			if (contains(start, codecID.id, strlen(codecID.id)))
+			{
+				format.codec = codecID.codec;
+				break;
+			}
+		}
+	}
+	else if (memcmp(header + 4, "ftyp", 4) == 0)
+	{
+		format.container = CONTAINER_MP4;
+		format.codec = probeMP4Codec(stream);
+	}
+
+	stream->seek(0);
+	return format;
+}
+
+const char *getCodecDisplayName(Codec codec)
+{
+	switch (codec)
+	{
+	case CODEC_THEORA: return "Theora";
+	case CODEC_H264: return "H.264";
+	case CODEC_H265: return "H.265";
+	case CODEC_AV1: return "AV1";
+	case CODEC_MAX_ENUM: break;
+	}
+	return "unknown";
+}
+
+const char *getContainerDisplayName(Container container)
+{
+	switch (container)
+	{
+	case CONTAINER_OGG: return "Ogg";
+	case CONTAINER_MP4: return "MP4";
+	case CONTAINER_MATROSKA: return "Matroska";
+	case CONTAINER_MAX_ENUM: break;
+	}
+	return "unknown";
+}
+
+STRINGMAP_BEGIN(Container, CONTAINER_MAX_ENUM, container)
+{
+	{ "ogg",      CONTAINER_OGG      },
+	{ "mp4",      CONTAINER_MP4      },
+	{ "matroska", CONTAINER_MATROSKA },
+}
+STRINGMAP_END(Container, CONTAINER_MAX_ENUM, container)
+
+STRINGMAP_BEGIN(Codec, CODEC_MAX_ENUM, codec)
+{
+	{ "theora", CODEC_THEORA },
+	{ "h264",   CODEC_H264   },
+	{ "h265",   CODEC_H265   },
+	{ "av1",    CODEC_AV1    },
+}
+STRINGMAP_END(Codec, CODEC_MAX_ENUM, codec)
+
+} // video
+} // love
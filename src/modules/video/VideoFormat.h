@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_VIDEO_VIDEO_FORMAT_H
+#define LOVE_VIDEO_VIDEO_FORMAT_H
+
+// LOVE
+#include "common/config.h"
+#include "common/StringMap.h"
+#include "common/Stream.h"
+
+namespace love
+{
+namespace video
+{
+
+enum Container
+{
+	CONTAINER_OGG,
+	CONTAINER_MP4,
+	CONTAINER_MATROSKA,
+	CONTAINER_MAX_ENUM
+};
+
+enum Codec
+{
+	CODEC_THEORA,
+	CODEC_H264,
+	CODEC_H265,
+	CODEC_AV1,
+	CODEC_MAX_ENUM
+};
+
+struct VideoFormat
+{
+	Container container = CONTAINER_MAX_ENUM;
+	Codec codec = CODEC_MAX_ENUM;
+};
+
+/**
+ * Works out the container and video codec of a file from its headers, without
+ * decoding anything. Ogg, ISO base media (MP4, MOV) and Matroska (MKV, WebM)
+ * files are recognized. Fields which can't be determined are left as
+ * MAX_ENUM. The stream is read from the start and seeked back there after.
+ **/
+VideoFormat probeVideoFormat(Stream *stream);
+
+// Human-readable names, for error messages.
+const char *getCodecDisplayName(Codec codec);
+const char *getContainerDisplayName(Container container);
+
+STRINGMAP_DECLARE(Container);
+STRINGMAP_DECLARE(Codec);
+
+} // video
+} // love
+
+#endif // LOVE_VIDEO_VIDEO_FORMAT_H
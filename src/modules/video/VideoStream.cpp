@@ -19,6 +19,7 @@
  **/
 
 #include "VideoStream.h"
+#include "timer/Timer.h"
 
 using love::thread::Lock;
 
@@ -96,6 +97,7 @@ VideoStream::DeltaSync::DeltaSync()
 	: playing(false)
 	, position(0)
 	, speed(1)
+	, playStartTime(0)
 {
 }
 
@@ -105,23 +107,32 @@ VideoStream::DeltaSync::~DeltaSync()
 
 double VideoStream::DeltaSync::getPosition() const
 {
-	return position;
+	Lock l(mutex);
+	return getPositionLocked();
 }
 
-void VideoStream::DeltaSync::update(double dt)
+double VideoStream::DeltaSync::getPositionLocked() const
 {
-	Lock l(mutex);
-	if (playing)
-		position += dt*speed;
+	if (!playing)
+		return position;
+
+	return position + (love::timer::Timer::getTime() - playStartTime) * speed;
 }
 
 void VideoStream::DeltaSync::play()
 {
+	Lock l(mutex);
+	if (playing)
+		return;
+
+	playStartTime = love::timer::Timer::getTime();
 	playing = true;
 }
 
 void VideoStream::DeltaSync::pause()
 {
+	Lock l(mutex);
+	position = getPositionLocked();
 	playing = false;
 }
 
@@ -129,6 +140,7 @@ void VideoStream::DeltaSync::seek(double time)
 {
 	Lock l(mutex);
 	position = time;
+	playStartTime = love::timer::Timer::getTime();
 }
 
 bool VideoStream::DeltaSync::isPlaying() const
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "common/Object.h"
+#include "common/int.h"
 #include "audio/Source.h"
 #include "thread/threads.h"
 
@@ -93,6 +94,48 @@ public:
 		unsigned char *crplane;
 	};
 
+	/**
+	 * Memory owned by the consumer of the stream (for example a mapped GPU
+	 * upload buffer), with tightly packed planes of the same dimensions as the
+	 * stream's Frames.
+	 **/
+	struct FrameTarget
+	{
+		unsigned char *yplane;
+		unsigned char *cbplane;
+		unsigned char *crplane;
+	};
+
+	/**
+	 * Makes the stream write its next decoded frame straight into the target
+	 * instead of its back buffer, or stops it with nullptr. Waits for a frame
+	 * that's currently being written to finish. The memory must stay valid
+	 * until takeTargetFrame returns true or the target is replaced.
+	 * Returns false if the stream can't write into external memory.
+	 **/
+	virtual bool setFrameTarget(const FrameTarget * /*target*/) { return false; }
+
+	/**
+	 * Returns true if the frame written to the target should be shown now.
+	 * Call it after swapBuffers, which decides which frame is due. The target
+	 * is cleared afterwards, and later frames go to the back buffer until a
+	 * new target is set.
+	 **/
+	virtual bool takeTargetFrame() { return false; }
+
+	/**
+	 * Sets how many decoded frames the stream may keep ready ahead of
+	 * playback, so decoding can fall behind briefly without dropping frames.
+	 **/
+	virtual void setFrameQueueDepth(int /*depth*/) {}
+	virtual int getFrameQueueDepth() const { return 1; }
+
+	/**
+	 * Gets the number of frames shown by swapBuffers so far, and the number
+	 * of frames which were decoded too late to be shown.
+	 **/
+	virtual void getFrameCounts(uint64 &presented, uint64 &dropped) const { presented = dropped = 0; }
+
 	class FrameSync : public Object
 	{
 	public:
@@ -116,8 +159,9 @@ public:
 		DeltaSync();
 		~DeltaSync();
 
+		// The position follows the system clock while playing, so it doesn't
+		// depend on how often the stream's decoder gets to run.
 		virtual double getPosition() const override;
-		virtual void update(double dt) override;
 
 		virtual void play() override;
 		virtual void pause() override;
@@ -125,9 +169,12 @@ public:
 		virtual bool isPlaying() const override;
 
 	private:
+		double getPositionLocked() const;
+
 		bool playing;
 		double position;
 		double speed;
+		double playStartTime;
 		love::thread::MutexRef mutex;
 	};
 
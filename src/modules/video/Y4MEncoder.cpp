@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Y4MEncoder.h"
+#include "common/Exception.h"
+
+// C
+#include <cstdio>
+#include <cstring>
+
+// STL
+#include <algorithm>
+
+namespace love
+{
+namespace video
+{
+
+// Frames which have been written are kept around for reuse, up to this many.
+static const size_t MAX_FREE_FRAME_DATA = 8;
+
+Y4MEncoder::Y4MEncoder(love::filesystem::File *file, int width, int height, int fpsNumerator, int fpsDenominator)
+	: file(file)
+	, width(width)
+	, height(height)
+	, writtenFrames(0)
+	, finishing(false)
+	, finished(false)
+{
+	threadName = "VideoEncoder";
+
+	if (width <= 0 || height <= 0)
+		throw love::Exception("Invalid video dimensions: %dx%d", width, height);
+
+	if (fpsNumerator <= 0 || fpsDenominator <= 0)
+		throw love::Exception("Invalid video frame rate: %d/%d", fpsNumerator, fpsDenominator);
+
+	if (!file->isOpen() && !file->open(love::filesystem::File::MODE_WRITE))
+		throw love::Exception("Could not open file %s for writing.", file->getFilename().c_str());
+
+	if (!file->isWritable())
+		throw love::Exception("File %s is not open for writing.", file->getFilename().c_str());
+
+	file->setBuffer(love::filesystem::File::BUFFER_FULL, 1024 * 1024);
+
+	char header[128];
+	int len = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 C420jpeg\n", width, height, fpsNumerator, fpsDenominator);
+
+	if (!file->write(header, len))
+		throw love::Exception("Could not write to file %s.", file->getFilename().c_str());
+
+	if (!start())
+		throw love::Exception("Could not start the video encoding thread.");
+}
+
+Y4MEncoder::~Y4MEncoder()
+{
+	finish();
+}
+
+size_t Y4MEncoder::getFrameSize(int width, int height, FrameFormat format)
+{
+	if (format == FRAME_RGBA8)
+		return (size_t) width * height * 4;
+
+	size_t chromasize = (size_t) ((width + 1) / 2) * ((height + 1) / 2);
+	return (size_t) width * height + chromasize * 2;
+}
+
+void Y4MEncoder::addFrame(love::Data *data, size_t offset, FrameFormat format)
+{
+	if (offset + getFrameSize(width, height, format) > data->getSize())
+		throw love::Exception("Video frame data is too small for a %dx%d frame.", width, height);
+
+	love::thread::Lock l(mutex);
+
+	if (finishing)
+		throw love::Exception("Cannot add frames to a finished video.");
+
+	Frame frame;
+	frame.data.set(data);
+	frame.offset = offset;
+	frame.format = format;
+
+	queue.push_back(frame);
+	cond->broadcast();
+}
+
+love::data::ByteData *Y4MEncoder::getFrameData(size_t size)
+{
+	{
+		love::thread::Lock l(mutex);
+
+		for (size_t i = 0; i < freeData.size(); i++)
+		{
+			if (freeData[i]->getSize() == size)
+			{
+				love::data::ByteData *data = freeData[i];
+				data->retain();
+				freeData.erase(freeData.begin() + i);
+				return data;
+			}
+		}
+	}
+
+	return new love::data::ByteData(size, false);
+}
+
+void Y4MEncoder::finish()
+{
+	{
+		love::thread::Lock l(mutex);
+
+		if (finished)
+			return;
+
+		finishing = true;
+		finished = true;
+		cond->broadcast();
+	}
+
+	wait();
+}
+
+int Y4MEncoder::getQueuedFrameCount() const
+{
+	love::thread::Lock l(mutex);
+	return (int) queue.size();
+}
+
+int64 Y4MEncoder::getWrittenFrameCount() const
+{
+	love::thread::Lock l(mutex);
+	return writtenFrames;
+}
+
+bool Y4MEncoder::getError(std::string &err) const
+{
+	love::thread::Lock l(mutex);
+	err = error;
+	return !error.empty();
+}
+
+void Y4MEncoder::threadFunction()
+{
+	while (true)
+	{
+		Frame frame;
+
+		{
+			love::thread::Lock l(mutex);
+
+			while (queue.empty() && !finishing)
+				cond->wait(mutex);
+
+			if (queue.empty())
+				break;
+
+			frame = queue.front();
+			queue.erase(queue.begin());
+		}
+
+		writeFrame(frame);
+
+		love::thread::Lock l(mutex);
+
+		writtenFrames++;
+
+		auto bytedata = dynamic_cast<love::data::ByteData *>(frame.data.get());
+		if (bytedata != nullptr && freeData.size() < MAX_FREE_FRAME_DATA)
+			freeData.push_back(bytedata);
+	}
+
+	file->close();
+}
+
+void Y4MEncoder::writeFrame(const Frame &frame)
+{
+	{
+		love::thread::Lock l(mutex);
+		if (!error.empty())
+			return;
+	}
+
+	const uint8 *src = (const uint8 *) frame.data->getData() + frame.offset;
+	size_t size = getFrameSize(width, height, FRAME_YUV420);
+
+	if (frame.format == FRAME_RGBA8)
+	{
+		conversionData.resize(size);
+		convertFrame(src);
+		src = conversionData.data();
+	}
+
+	if (!file->write("FRAME\n", 6) || !file->write(src, (int64) size))
+	{
+		love::thread::Lock l(mutex);
+		error = "Could not write to file " + file->getFilename() + ".";
+	}
+}
+
+void Y4MEncoder::convertFrame(const uint8 *rgba)
+{
+	// BT.601 limited range, with chroma averaged over each 2x2 block.
+	int cw = (width + 1) / 2;
+	int ch = (height + 1) / 2;
+
+	uint8 *yplane = conversionData.data();
+	uint8 *uplane = yplane + (size_t) width * height;
+	uint8 *vplane = uplane + (size_t) cw * ch;
+
+	for (int y = 0; y < height; y++)
+	{
+		const uint8 *row = rgba + (size_t) y * width * 4;
+		uint8 *dst = yplane + (size_t) y * width;
+
+		for (int x = 0; x < width; x++)
+		{
+			int r = row[x * 4 + 0], g = row[x * 4 + 1], b = row[x * 4 + 2];
+			dst[x] = (uint8) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+		}
+	}
+
+	for (int cy = 0; cy < ch; cy++)
+	{
+		for (int cx = 0; cx < cw; cx++)
+		{
+			int r = 0, g = 0, b = 0, n = 0;
+
+			for (int y = cy * 2; y < std::min(cy * 2 + 2, height); y++)
+			{
+				for (int x = cx * 2; x < std::min(cx * 2 + 2, width); x++)
+				{
+					const uint8 *p = rgba + ((size_t) y * width + x) * 4;
+					r += p[0];
+					g += p[1];
+					b += p[2];
+					n++;
+				}
+			}
+
+			r /= n;
+			g /= n;
+			b /= n;
+
+			uplane[(size_t) cy * cw + cx] = (uint8) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			vplane[(size_t) cy * cw + cx] = (uint8) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+}
+
+} // video
+} // love
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_VIDEO_Y4M_ENCODER_H
+#define LOVE_VIDEO_Y4M_ENCODER_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "data/ByteData.h"
+#include "filesystem/File.h"
+#include "thread/threads.h"
+
+// STL
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace video
+{
+
+/**
+ * Writes frames to a YUV4MPEG2 (.y4m) stream on its own thread. Frames are
+ * handed over either already converted to planar 8 bit YUV 4:2:0, or as
+ * RGBA8 pixels which are converted on the encoding thread.
+ **/
+class Y4MEncoder : public love::thread::Threadable
+{
+public:
+
+	enum FrameFormat
+	{
+		FRAME_YUV420,
+		FRAME_RGBA8,
+	};
+
+	Y4MEncoder(love::filesystem::File *file, int width, int height, int fpsNumerator, int fpsDenominator);
+	virtual ~Y4MEncoder();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+	/**
+	 * Queues a frame for writing. The encoder keeps a reference to the data
+	 * until the frame is written, after which ByteData frames are recycled
+	 * through getFrameData.
+	 **/
+	void addFrame(love::Data *data, size_t offset, FrameFormat format);
+
+	/**
+	 * Gets a ByteData of the given size for a new frame, reusing one which has
+	 * already been written if possible.
+	 **/
+	love::data::ByteData *getFrameData(size_t size);
+
+	/**
+	 * Writes all queued frames, then closes the file and stops the thread.
+	 **/
+	void finish();
+
+	int getQueuedFrameCount() const;
+	int64 getWrittenFrameCount() const;
+	bool getError(std::string &err) const;
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	static size_t getFrameSize(int width, int height, FrameFormat format);
+
+private:
+
+	struct Frame
+	{
+		StrongRef<love::Data> data;
+		size_t offset;
+		FrameFormat format;
+	};
+
+	void writeFrame(const Frame &frame);
+	void convertFrame(const uint8 *rgba);
+
+	StrongRef<love::filesystem::File> file;
+
+	int width;
+	int height;
+
+	std::vector<Frame> queue;
+	std::vector<StrongRef<love::data::ByteData>> freeData;
+	std::vector<uint8> conversionData;
+
+	int64 writtenFrames;
+	std::string error;
+
+	bool finishing;
+	bool finished;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+}; // Y4MEncoder
+
+} // video
+} // love
+
+#endif // LOVE_VIDEO_Y4M_ENCODER_H
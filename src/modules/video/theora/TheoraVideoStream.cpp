@@ -20,6 +20,7 @@
 
 // STL
 #include <iostream>
+#include <algorithm>
 
 // LOVE
 #include "TheoraVideoStream.h"
@@ -37,8 +38,18 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
-	, lastFrame(0)
+	, queueFrames(0)
+	, queueDepth(DEFAULT_QUEUE_DEPTH)
+	, displayedTime(0)
+	, flushRequested(false)
+	, presentedFrames(0)
+	, droppedFrames(0)
+	, countSkipped(true)
+	, target()
+	, hasTarget(false)
+	, targetQueued(false)
+	, targetReady(false)
+	, frameDuration(0)
 	, nextFrame(0)
 {
 	if (demuxer.findStream() != OggDemuxer::TYPE_THEORA)
@@ -47,7 +58,6 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	th_info_init(&videoInfo);
 
 	frontBuffer = new Frame();
-	backBuffer = new Frame();
 
 	try
 	{
@@ -55,7 +65,6 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
 		delete frontBuffer;
 		th_info_clear(&videoInfo);
 		throw ex;
@@ -72,7 +81,12 @@ TheoraVideoStream::~TheoraVideoStream()
 	th_info_clear(&videoInfo);
 
 	delete frontBuffer;
-	delete backBuffer;
+
+	for (const QueuedFrame &queued : frameQueue)
+		delete queued.frame;
+
+	for (Frame *frame : freeFrames)
+		delete frame;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -98,8 +112,78 @@ const std::string &TheoraVideoStream::getFilename() const
 
 void TheoraVideoStream::setSync(FrameSync *frameSync)
 {
+	{
+		love::thread::Lock l(bufferMutex);
+		this->frameSync = frameSync;
+		flushRequested = true;
+	}
+
+	notifyWorker();
+}
+
+void TheoraVideoStream::play()
+{
+	VideoStream::play();
+	notifyWorker();
+}
+
+void TheoraVideoStream::pause()
+{
+	VideoStream::pause();
+	notifyWorker();
+}
+
+void TheoraVideoStream::seek(double offset)
+{
+	VideoStream::seek(offset);
+
+	{
+		love::thread::Lock l(bufferMutex);
+		flushRequested = true;
+	}
+
+	notifyWorker();
+}
+
+void TheoraVideoStream::setWorkerSignal(WorkerSignal *signal)
+{
+	workerSignal.set(signal);
+}
+
+void TheoraVideoStream::notifyWorker()
+{
+	if (workerSignal.get() != nullptr)
+		workerSignal->notify();
+}
+
+double TheoraVideoStream::getTimeUntilNextFrame() const
+{
+	{
+		love::thread::Lock l(bufferMutex);
+		if (flushRequested)
+			return 0.0;
+	}
+
+	double position = frameSync->getPosition();
+
 	love::thread::Lock l(bufferMutex);
-	this->frameSync = frameSync;
+
+	// Seeking backwards, which also works after the end of the stream.
+	if (position < displayedTime)
+		return 0.0;
+
+	if (demuxer.isEos())
+		return -1.0;
+
+	if ((int) frameQueue.size() < queueDepth)
+		return 0.0;
+
+	// The queue is full. Showing a frame wakes the worker up, but if nothing
+	// shows them the oldest frames are dropped once newer ones are due.
+	if (frameQueue.size() < 2 || !frameSync->isPlaying())
+		return -1.0;
+
+	return std::max(frameQueue[1].time - position, 0.0);
 }
 
 const void *TheoraVideoStream::getFrontBuffer() const
@@ -114,7 +198,11 @@ size_t TheoraVideoStream::getSize() const
 
 bool TheoraVideoStream::isPlaying() const
 {
-	return frameSync->isPlaying() && !demuxer.isEos();
+	if (!frameSync->isPlaying())
+		return false;
+
+	love::thread::Lock l(bufferMutex);
+	return !demuxer.isEos() || !frameQueue.empty();
 }
 
 template<typename T>
@@ -162,33 +250,41 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
-
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
-	{
-		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
-		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
-
-		scaleFormat(videoInfo.pixel_fmt, buffers[i]->cw, buffers[i]->ch);
-
-		buffers[i]->yplane = new unsigned char[buffers[i]->yw * buffers[i]->yh];
-		buffers[i]->cbplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
-		buffers[i]->crplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
+	if (videoInfo.fps_numerator > 0)
+		frameDuration = (double) videoInfo.fps_denominator / (double) videoInfo.fps_numerator;
 
-		memset(buffers[i]->yplane, 16, buffers[i]->yw * buffers[i]->yh);
-		memset(buffers[i]->cbplane, 128, buffers[i]->cw * buffers[i]->ch);
-		memset(buffers[i]->crplane, 128, buffers[i]->cw * buffers[i]->ch);
-	}
+	delete frontBuffer;
+	frontBuffer = newFrame();
 
 	headerParsed = true;
 	th_decode_packetin(decoder, &packet, nullptr);
 }
 
+TheoraVideoStream::Frame *TheoraVideoStream::newFrame() const
+{
+	Frame *frame = new Frame();
+
+	frame->cw = frame->yw = videoInfo.pic_width;
+	frame->ch = frame->yh = videoInfo.pic_height;
+
+	scaleFormat(videoInfo.pixel_fmt, frame->cw, frame->ch);
+
+	frame->yplane = new unsigned char[frame->yw * frame->yh];
+	frame->cbplane = new unsigned char[frame->cw * frame->ch];
+	frame->crplane = new unsigned char[frame->cw * frame->ch];
+
+	memset(frame->yplane, 16, frame->yw * frame->yh);
+	memset(frame->cbplane, 128, frame->cw * frame->ch);
+	memset(frame->crplane, 128, frame->cw * frame->ch);
+
+	return frame;
+}
+
 void TheoraVideoStream::seekDecoder(double target)
 {
 	bool success = demuxer.seek(packet, target, [this](int64 granulepos) {
@@ -199,38 +295,76 @@ void TheoraVideoStream::seekDecoder(double target)
 		return;
 
 	// Now update theora and our decoder on this new position of ours
-	lastFrame = nextFrame = -1;
+	nextFrame = -1;
 	th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
 }
 
 void TheoraVideoStream::threadedFillBackBuffer(double dt)
 {
+	bool seeking = false;
+	{
+		love::thread::Lock l(bufferMutex);
+		std::swap(seeking, flushRequested);
+	}
+
 	// Synchronize
 	frameSync->update(dt);
 	double position = frameSync->getPosition();
 
-	// Seeking backwards
-	if (position < lastFrame)
+	{
+		love::thread::Lock l(bufferMutex);
+
+		// Seeking backwards
+		if (position < displayedTime)
+			seeking = true;
+
+		if (seeking)
+		{
+			flushQueue();
+			displayedTime = position;
+			countSkipped = false;
+		}
+		else
+			pruneQueue(position);
+	}
+
+	if (seeking)
 		seekDecoder(position);
 
 	th_ycbcr_buffer bufferinfo;
-	bool hasFrame = false;
 
-	// Until we are at the end of the stream, or we are displaying the right frame
+	// Until we are at the end of the stream, or the queue is full
 	unsigned int framesBehind = 0;
 	bool failedSeek = false;
-	while (!demuxer.isEos() && position >= nextFrame)
+	while (!demuxer.isEos())
 	{
-		// If we can't catch up, seek
-		if (framesBehind++ > 5 && !failedSeek)
+		{
+			love::thread::Lock l(bufferMutex);
+			if ((int) frameQueue.size() >= queueDepth)
+				break;
+		}
+
+		th_decode_ycbcr_out(decoder, bufferinfo);
+
+		// Frames which would be replaced by the next one right away are
+		// skipped. If we can't catch up, seek.
+		if (nextFrame + frameDuration > position)
+		{
+			queueFrame(bufferinfo, nextFrame);
+			countSkipped = true;
+			framesBehind = 0;
+		}
+		else if (framesBehind++ > 5 && !failedSeek)
 		{
 			seekDecoder(position);
 			framesBehind = 0;
 			failedSeek = true;
 		}
-
-		th_decode_ycbcr_out(decoder, bufferinfo);
-		hasFrame = true;
+		else if (countSkipped)
+		{
+			love::thread::Lock l(bufferMutex);
+			droppedFrames++;
+		}
 
 		ogg_int64_t decoderPosition;
 		do
@@ -242,48 +376,106 @@ void TheoraVideoStream::threadedFillBackBuffer(double dt)
 				th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
 		} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
 
-		lastFrame = nextFrame;
 		nextFrame = th_granule_time(decoder, decoderPosition);
 	}
+}
+
+void TheoraVideoStream::queueFrame(th_ycbcr_buffer bufferinfo, double time)
+{
+	love::thread::Lock w(writeMutex);
+
+	Frame *frame = nullptr;
+	unsigned char *planes[3] = {target.yplane, target.cbplane, target.crplane};
+	bool toTarget = false;
 
-	// Only swap once, even if we read many frames to get here
-	if (hasFrame)
 	{
-		// Don't swap whilst we're writing to the backbuffer
-		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = false;
-		}
+		love::thread::Lock l(bufferMutex);
 
-		for (int y = 0; y < backBuffer->yh; ++y)
+		if (hasTarget && !targetQueued)
 		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
+			targetQueued = true;
+			toTarget = true;
 		}
-
-		for (int y = 0; y < backBuffer->ch; ++y)
+		else if (!freeFrames.empty())
 		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
+			frame = freeFrames.back();
+			freeFrames.pop_back();
 		}
+	}
 
-		for (int y = 0; y < backBuffer->ch; ++y)
+	if (!toTarget)
+	{
+		if (frame == nullptr)
 		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+			frame = newFrame();
 
-		// Re-enable swapping
-		{
 			love::thread::Lock l(bufferMutex);
-			frameReady = true;
+			queueFrames++;
 		}
+
+		planes[0] = frame->yplane;
+		planes[1] = frame->cbplane;
+		planes[2] = frame->crplane;
+	}
+
+	for (int y = 0; y < frontBuffer->yh; ++y)
+	{
+		memcpy(planes[0]+frontBuffer->yw*y,
+				bufferinfo[0].data+
+					bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
+				frontBuffer->yw);
+	}
+
+	for (int y = 0; y < frontBuffer->ch; ++y)
+	{
+		memcpy(planes[1]+frontBuffer->cw*y,
+				bufferinfo[1].data+
+					bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frontBuffer->cw);
+	}
+
+	for (int y = 0; y < frontBuffer->ch; ++y)
+	{
+		memcpy(planes[2]+frontBuffer->cw*y,
+				bufferinfo[2].data+
+					bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frontBuffer->cw);
+	}
+
+	love::thread::Lock l(bufferMutex);
+	frameQueue.push_back({frame, time});
+}
+
+void TheoraVideoStream::releaseFrame(const QueuedFrame &queued)
+{
+	if (queued.frame == nullptr)
+		targetQueued = false;
+	else if (queueFrames > queueDepth)
+	{
+		// The queue depth was lowered.
+		delete queued.frame;
+		queueFrames--;
+	}
+	else
+		freeFrames.push_back(queued.frame);
+}
+
+void TheoraVideoStream::flushQueue()
+{
+	for (const QueuedFrame &queued : frameQueue)
+		releaseFrame(queued);
+
+	frameQueue.clear();
+}
+
+void TheoraVideoStream::pruneQueue(double position)
+{
+	// Nothing showed these before the frame after them was due.
+	while (frameQueue.size() >= 2 && frameQueue[1].time <= position)
+	{
+		releaseFrame(frameQueue.front());
+		frameQueue.pop_front();
+		droppedFrames++;
 	}
 }
 
@@ -294,24 +486,128 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
-
 	if (!frameSync->isPlaying())
 		return false;
 
+	double position = frameSync->getPosition();
+
+	QueuedFrame shown = {};
+	bool found = false;
+
+	{
+		love::thread::Lock l(bufferMutex);
+
+		// Queued frames are from before the seek.
+		if (flushRequested)
+			return false;
+
+		// Show the newest frame which is due, older ones were never shown.
+		while (!frameQueue.empty() && frameQueue.front().time <= position)
+		{
+			if (found)
+			{
+				releaseFrame(shown);
+				droppedFrames++;
+			}
+
+			shown = frameQueue.front();
+			frameQueue.pop_front();
+			found = true;
+		}
+
+		if (!found)
+			return false;
+
+		presentedFrames++;
+		displayedTime = shown.time;
+
+		if (shown.frame == nullptr)
+			targetReady = true;
+		else
+		{
+			releaseFrame({frontBuffer, 0.0});
+			frontBuffer = shown.frame;
+		}
+	}
+
+	// There's room in the queue now.
+	notifyWorker();
+
+	return shown.frame != nullptr;
+}
+
+bool TheoraVideoStream::setFrameTarget(const FrameTarget *newTarget)
+{
+	// Wait for a frame which may be going into the old target.
+	love::thread::Lock w(writeMutex);
+	love::thread::Lock l(bufferMutex);
+
+	// A frame queued in the old target is lost along with it.
+	if (targetQueued)
+	{
+		auto it = std::find_if(frameQueue.begin(), frameQueue.end(), [](const QueuedFrame &queued) {
+			return queued.frame == nullptr;
+		});
+
+		if (it != frameQueue.end())
+			frameQueue.erase(it);
+	}
+
+	hasTarget = newTarget != nullptr;
+	target = hasTarget ? *newTarget : FrameTarget();
+	targetQueued = false;
+	targetReady = false;
+
+	return true;
+}
+
+bool TheoraVideoStream::takeTargetFrame()
+{
 	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
+	if (!targetReady)
 		return false;
-	frameReady = false;
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+	targetReady = false;
+	targetQueued = false;
+	hasTarget = false;
 
 	return true;
 }
 
+void TheoraVideoStream::setFrameQueueDepth(int depth)
+{
+	if (depth < 1 || depth > MAX_QUEUE_DEPTH)
+		throw love::Exception("Invalid frame queue depth %d (must be between 1 and %d).", depth, MAX_QUEUE_DEPTH);
+
+	{
+		love::thread::Lock l(bufferMutex);
+		queueDepth = depth;
+
+		// Extra frames are freed as the queue drains.
+		while (queueFrames > queueDepth && !freeFrames.empty())
+		{
+			delete freeFrames.back();
+			freeFrames.pop_back();
+			queueFrames--;
+		}
+	}
+
+	notifyWorker();
+}
+
+int TheoraVideoStream::getFrameQueueDepth() const
+{
+	love::thread::Lock l(bufferMutex);
+	return queueDepth;
+}
+
+void TheoraVideoStream::getFrameCounts(uint64 &presented, uint64 &dropped) const
+{
+	love::thread::Lock l(bufferMutex);
+	presented = presentedFrames;
+	dropped = droppedFrames;
+}
+
 } // theora
 } // video
 } // love
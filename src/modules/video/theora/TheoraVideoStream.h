@@ -23,11 +23,16 @@
 
 #include "video/VideoStream.h"
 
+// STL
+#include <deque>
+#include <vector>
+
 // LOVE
 #include "common/int.h"
 #include "filesystem/File.h"
 #include "thread/threads.h"
 #include "OggDemuxer.h"
+#include "WorkerSignal.h"
 
 // OGG/Theora
 #include <ogg/ogg.h>
@@ -51,17 +56,46 @@ public:
 	size_t getSize() const;
 	void fillBackBuffer();
 	bool swapBuffers();
+	bool setFrameTarget(const FrameTarget *target);
+	bool takeTargetFrame();
+
+	void setFrameQueueDepth(int depth);
+	int getFrameQueueDepth() const;
+	void getFrameCounts(uint64 &presented, uint64 &dropped) const;
 
 	int getWidth() const;
 	int getHeight() const;
 	const std::string &getFilename() const;
 	void setSync(FrameSync *frameSync);
 
+	void play();
+	void pause();
+	void seek(double offset);
 	bool isPlaying() const;
 
+	void setWorkerSignal(WorkerSignal *signal);
+
+	/**
+	 * Seconds until the next frame should be decoded, 0 if it's due now, or
+	 * a negative number if no frame is needed until playback changes or a
+	 * queued frame is shown.
+	 **/
+	double getTimeUntilNextFrame() const;
+
 	void threadedFillBackBuffer(double dt);
 
 private:
+
+	static const int DEFAULT_QUEUE_DEPTH = 3;
+	static const int MAX_QUEUE_DEPTH = 64;
+
+	struct QueuedFrame
+	{
+		// nullptr if the frame was written to the frame target.
+		Frame *frame;
+		double time;
+	};
+
 	OggDemuxer demuxer;
 
 	bool headerParsed;
@@ -72,20 +106,54 @@ private:
 	th_dec_ctx *decoder;
 
 	Frame *frontBuffer;
-	Frame *backBuffer;
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
 
-	double lastFrame;
+	// Decoded frames waiting to be shown, oldest first.
+	std::deque<QueuedFrame> frameQueue;
+	std::vector<Frame *> freeFrames;
+
+	// Frames owned by the queue and the free list.
+	int queueFrames;
+	int queueDepth;
+
+	// Time of the newest frame shown, or of the last seek. A sync position
+	// before it means the sync was moved backwards.
+	double displayedTime;
+	bool flushRequested;
+
+	uint64 presentedFrames;
+	uint64 droppedFrames;
+
+	// Frames skipped to reach a seek target aren't counted as dropped.
+	bool countSkipped;
+
+	// Held while a decoded frame is copied out of the decoder.
+	love::thread::MutexRef writeMutex;
+
+	FrameTarget target;
+	bool hasTarget;
+	bool targetQueued;
+	bool targetReady;
+
+	double frameDuration;
 	double nextFrame;
 
+	StrongRef<WorkerSignal> workerSignal;
+
 	void parseHeader();
 	void seekDecoder(double target);
+	void notifyWorker();
+
+	Frame *newFrame() const;
+	void queueFrame(th_ycbcr_buffer bufferinfo, double time);
+	void releaseFrame(const QueuedFrame &queued);
+	void flushQueue();
+	void pruneQueue(double position);
 }; // TheoraVideoStream
 
 } // theora
@@ -20,10 +20,11 @@
 
 // STL
 #include <vector>
+#include <algorithm>
 
 // LOVE
 #include "Video.h"
-#include "common/delay.h"
+#include "thread/JobSystem.h"
 #include "timer/Timer.h"
 
 namespace love
@@ -47,13 +48,30 @@ Video::~Video()
 
 VideoStream *Video::newVideoStream(love::filesystem::File *file)
 {
+	// Files which can't be identified get TheoraVideoStream's own error.
+	VideoFormat format = probeVideoFormat(file);
+	if (format.codec != CODEC_MAX_ENUM && !isSupported(format))
+	{
+		throw love::Exception("Cannot decode %s video in %s files: no decoder for it is available. Ogg Theora videos are supported.",
+			getCodecDisplayName(format.codec), getContainerDisplayName(format.container));
+	}
+
 	TheoraVideoStream *stream = new TheoraVideoStream(file);
 	workerThread->addStream(stream);
 	return stream;
 }
 
+bool Video::isSupported(const VideoFormat &format) const
+{
+	return format.container == CONTAINER_OGG && format.codec == CODEC_THEORA;
+}
+
+const double Worker::MAX_WAIT = 0.1;
+const double Worker::RETRY_WAIT = 0.002;
+
 Worker::Worker()
-	: stopping(false)
+	: signal(new WorkerSignal(), Acquire::NORETAIN)
+	, stopping(false)
 {
 	threadName = "VideoWorker";
 }
@@ -65,9 +83,14 @@ Worker::~Worker()
 
 void Worker::addStream(TheoraVideoStream *stream)
 {
-	love::thread::Lock l(mutex);
-	streams.push_back(stream);
-	cond->broadcast();
+	stream->setWorkerSignal(signal);
+
+	{
+		love::thread::Lock l(mutex);
+		streams.push_back({stream, love::timer::Timer::getTime()});
+	}
+
+	signal->notify();
 }
 
 void Worker::stop()
@@ -75,47 +98,84 @@ void Worker::stop()
 	{
 		love::thread::Lock l(mutex);
 		stopping = true;
-		cond->broadcast();
 	}
 
+	signal->notify();
 	owner->wait();
 }
 
+void Worker::decode(const std::vector<StreamEntry> &due)
+{
+	double now = love::timer::Timer::getTime();
+
+	if (due.size() == 1)
+	{
+		due[0].stream->threadedFillBackBuffer(now - due[0].lastUpdate);
+		return;
+	}
+
+	// Streams don't share any decoder state, so they can be decoded at the
+	// same time.
+	love::thread::JobSystemRef jobSystem;
+	jobSystem->runParallel((int) due.size(), [&](int i)
+	{
+		due[i].stream->threadedFillBackBuffer(now - due[i].lastUpdate);
+	});
+}
+
 void Worker::threadFunction()
 {
-	double lastFrame = love::timer::Timer::getTime();
+	std::vector<StreamEntry> due;
 
 	while (true)
 	{
-		love::sleep(2);
-
-		love::thread::Lock l(mutex);
+		double wait = MAX_WAIT;
+		due.clear();
 
-		while (!stopping && streams.empty())
 		{
-			cond->wait(mutex);
-			lastFrame = love::timer::Timer::getTime();
-		}
+			love::thread::Lock l(mutex);
 
-		if (stopping)
-			return;
+			if (stopping)
+				return;
 
-		double curFrame = love::timer::Timer::getTime();
-		double dt = curFrame-lastFrame;
-		lastFrame = curFrame;
+			double now = love::timer::Timer::getTime();
 
-		for (auto it = streams.begin(); it != streams.end(); ++it)
-		{
-			TheoraVideoStream *stream = *it;
-			if (stream->getReferenceCount() == 1)
+			for (auto it = streams.begin(); it != streams.end();)
 			{
-				// We're the only ones left
-				streams.erase(it);
-				break;
+				if (it->stream->getReferenceCount() == 1)
+				{
+					// We're the only ones left
+					it = streams.erase(it);
+					continue;
+				}
+
+				double untilNext = it->stream->getTimeUntilNextFrame();
+				if (untilNext == 0.0)
+				{
+					due.push_back(*it);
+					it->lastUpdate = now;
+				}
+				else if (untilNext > 0.0)
+					wait = std::min(wait, untilNext);
+
+				++it;
 			}
+		}
+
+		if (!due.empty())
+		{
+			decode(due);
 
-			stream->threadedFillBackBuffer(dt);
+			// Anything still due couldn't catch up, don't spin on it.
+			for (const StreamEntry &entry : due)
+			{
+				double untilNext = entry.stream->getTimeUntilNextFrame();
+				if (untilNext >= 0.0)
+					wait = std::min(wait, std::max(untilNext, RETRY_WAIT));
+			}
 		}
+
+		signal->wait(wait);
 	}
 }
 
@@ -47,6 +47,7 @@ public:
 	virtual ~Video();
 
 	VideoStream *newVideoStream(love::filesystem::File* file);
+	bool isSupported(const VideoFormat &format) const;
 
 private:
 	Worker *workerThread;
@@ -67,10 +68,26 @@ public:
 
 private:
 
-	std::vector<StrongRef<TheoraVideoStream>> streams;
+	struct StreamEntry
+	{
+		StrongRef<TheoraVideoStream> stream;
+		double lastUpdate;
+	};
+
+	// Longest the worker sleeps without a notification. Streams synced to an
+	// audio Source can start or seek without the stream itself being told.
+	static const double MAX_WAIT;
+
+	// How long to wait before retrying a stream which is still behind after
+	// decoding, for example because its data isn't available yet.
+	static const double RETRY_WAIT;
+
+	void decode(const std::vector<StreamEntry> &due);
+
+	std::vector<StreamEntry> streams;
 
 	love::thread::MutexRef mutex;
-	love::thread::ConditionalRef cond;
+	StrongRef<WorkerSignal> signal;
 
 	bool stopping;
 }; // Worker
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_VIDEO_THEORA_WORKER_SIGNAL_H
+#define LOVE_VIDEO_THEORA_WORKER_SIGNAL_H
+
+// LOVE
+#include "common/Object.h"
+#include "thread/threads.h"
+
+namespace love
+{
+namespace video
+{
+namespace theora
+{
+
+/**
+ * Wakes the video worker thread early, when a stream is added or its playback
+ * state changes. Streams keep a reference to it since they can outlive the
+ * worker.
+ **/
+class WorkerSignal : public love::Object
+{
+public:
+
+	WorkerSignal();
+	virtual ~WorkerSignal() {}
+
+	void notify();
+
+	/**
+	 * Waits until notify is called or the timeout (in seconds) runs out.
+	 * Returns right away if notify was called since the last wait.
+	 **/
+	void wait(double timeout);
+
+private:
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+	bool notified;
+
+}; // WorkerSignal
+
+} // theora
+} // video
+} // love
+
+#endif // LOVE_VIDEO_THEORA_WORKER_SIGNAL_H
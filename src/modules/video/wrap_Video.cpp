@@ -51,6 +51,37 @@ int w_newVideoStream(lua_State *L)
 	return 1;
 }
 
+int w_getSupportedCodecs(lua_State *L)
+{
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, (int) CODEC_MAX_ENUM);
+
+	for (int i = 0; i < (int) CODEC_MAX_ENUM; i++)
+	{
+		Codec codec = (Codec) i;
+		const char *name = nullptr;
+
+		if (!getConstant(codec, name))
+			continue;
+
+		bool supported = false;
+		for (int j = 0; j < (int) CONTAINER_MAX_ENUM; j++)
+		{
+			VideoFormat format;
+			format.container = (Container) j;
+			format.codec = codec;
+			supported = supported || instance()->isSupported(format);
+		}
+
+		luax_pushboolean(L, supported);
+		lua_setfield(L, -2, name);
+	}
+
+	return 1;
+}
+
 static const lua_CFunction types[] =
 {
 	luaopen_videostream,
@@ -60,6 +91,7 @@ static const lua_CFunction types[] =
 static const luaL_Reg functions[] =
 {
 	{ "newVideoStream", w_newVideoStream },
+	{ "getSupportedCodecs", w_getSupportedCodecs },
 	{ 0, 0 }
 };
 
@@ -109,6 +109,32 @@ int w_VideoStream_isPlaying(lua_State *L)
 	return 1;
 }
 
+int w_VideoStream_setFrameQueueDepth(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	int depth = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&]() { stream->setFrameQueueDepth(depth); });
+	return 0;
+}
+
+int w_VideoStream_getFrameQueueDepth(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	lua_pushinteger(L, stream->getFrameQueueDepth());
+	return 1;
+}
+
+int w_VideoStream_getFrameCounts(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	uint64 presented = 0;
+	uint64 dropped = 0;
+	stream->getFrameCounts(presented, dropped);
+	lua_pushnumber(L, (lua_Number) presented);
+	lua_pushnumber(L, (lua_Number) dropped);
+	return 2;
+}
+
 static const luaL_Reg videostream_functions[] =
 {
 	{ "setSync", w_VideoStream_setSync },
@@ -119,6 +145,9 @@ static const luaL_Reg videostream_functions[] =
 	{ "rewind", w_VideoStream_rewind },
 	{ "tell", w_VideoStream_tell },
 	{ "isPlaying", w_VideoStream_isPlaying },
+	{ "setFrameQueueDepth", w_VideoStream_setFrameQueueDepth },
+	{ "getFrameQueueDepth", w_VideoStream_getFrameQueueDepth },
+	{ "getFrameCounts", w_VideoStream_getFrameCounts },
 	{ 0, 0 }
 };
 
@@ -43,6 +43,22 @@ bool isHighDPIAllowed()
 	return highDPIAllowed;
 }
 
+static bool headless = false;
+
+// The window backend is expected to implement this.
+void setHeadlessImplementation(bool enable);
+
+void setHeadless(bool enable)
+{
+	setHeadlessImplementation(enable);
+	headless = enable;
+}
+
+bool isHeadless()
+{
+	return headless;
+}
+
 Window::Window(const char *name)
 	: Module(M_WINDOW, name)
 {
@@ -86,6 +102,15 @@ STRINGMAP_CLASS_BEGIN(Window, Window::FullscreenType, Window::FULLSCREEN_MAX_ENU
 }
 STRINGMAP_CLASS_END(Window, Window::FullscreenType, Window::FULLSCREEN_MAX_ENUM, fullscreenType)
 
+STRINGMAP_CLASS_BEGIN(Window, Window::PresentMode, Window::PRESENT_MODE_MAX_ENUM, presentMode)
+{
+	{"fifo", Window::PRESENT_MODE_FIFO},
+	{"fiforelaxed", Window::PRESENT_MODE_FIFO_RELAXED},
+	{"mailbox", Window::PRESENT_MODE_MAILBOX},
+	{"immediate", Window::PRESENT_MODE_IMMEDIATE},
+}
+STRINGMAP_CLASS_END(Window, Window::PresentMode, Window::PRESENT_MODE_MAX_ENUM, presentMode)
+
 STRINGMAP_CLASS_BEGIN(Window, Window::MessageBoxType, Window::MESSAGEBOX_MAX_ENUM, messageBoxType)
 {
 	{"error", Window::MESSAGEBOX_ERROR},
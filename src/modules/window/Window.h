@@ -47,6 +47,11 @@ namespace window
 void setHighDPIAllowed(bool enable);
 bool isHighDPIAllowed();
 
+// Renders without showing a window or presenting to the screen. Has to be set
+// before any module initializes the video subsystem.
+void setHeadless(bool enable);
+bool isHeadless();
+
 // Forward-declared so it can be used in the class methods. We can't define the
 // whole thing here because it uses the Window::Type enum.
 struct WindowSettings;
@@ -88,6 +93,17 @@ public:
 		FULLSCREEN_MAX_ENUM
 	};
 
+	// Matches Vulkan's present modes. Only fifo, fifo relaxed and immediate
+	// have equivalents in the other backends.
+	enum PresentMode
+	{
+		PRESENT_MODE_FIFO, // Waits for vblank, like vsync = 1.
+		PRESENT_MODE_FIFO_RELAXED, // Adaptive vsync, like vsync = -1.
+		PRESENT_MODE_MAILBOX, // Replaces the queued frame, without tearing.
+		PRESENT_MODE_IMMEDIATE, // Doesn't wait, tearing is allowed.
+		PRESENT_MODE_MAX_ENUM
+	};
+
 	enum MessageBoxType
 	{
 		MESSAGEBOX_ERROR,
@@ -197,6 +213,15 @@ public:
 	virtual void setVSync(int vsync) = 0;
 	virtual int getVSync() const = 0;
 
+	/**
+	 * Overrides the vsync setting with a specific present mode. Modes which
+	 * aren't supported fall back to the closest one that is (mailbox falls
+	 * back to fifo, so it never tears), and getPresentMode returns the mode
+	 * actually in use.
+	 **/
+	virtual void setPresentMode(PresentMode mode) = 0;
+	virtual PresentMode getPresentMode() const = 0;
+
 	virtual void setDisplaySleepEnabled(bool enable) = 0;
 	virtual bool isDisplaySleepEnabled() const = 0;
 
@@ -254,6 +279,7 @@ public:
 
 	STRINGMAP_CLASS_DECLARE(Setting);
 	STRINGMAP_CLASS_DECLARE(FullscreenType);
+	STRINGMAP_CLASS_DECLARE(PresentMode);
 	STRINGMAP_CLASS_DECLARE(MessageBoxType);
 	STRINGMAP_CLASS_DECLARE(FileDialogType);
 	STRINGMAP_CLASS_DECLARE(DisplayOrientation);
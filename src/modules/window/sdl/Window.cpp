@@ -72,6 +72,14 @@ void setHighDPIAllowedImplementation(bool enable)
 	LOVE_UNUSED(enable);
 }
 
+void setHeadlessImplementation(bool enable)
+{
+	// SDL's offscreen video driver never shows its windows, and gives them
+	// EGL pbuffer or surfaceless OpenGL contexts and headless Vulkan surfaces.
+	if (enable)
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+}
+
 namespace sdl
 {
 
@@ -401,10 +409,12 @@ bool Window::createWindowAndContext(int x, int y, int w, int h, Uint32 windowfla
 #ifdef LOVE_GRAPHICS_METAL
 	else if (renderer == graphics::RENDERER_METAL)
 	{
-		if (create(nullptr) && window != nullptr)
+		// Headless windows have no view. The Metal backend renders to a layer
+		// of its own instead.
+		if (create(nullptr) && window != nullptr && !isHeadless())
 			metalView = SDL_Metal_CreateView(window);
 
-		if (metalView == nullptr && window != nullptr)
+		if (metalView == nullptr && window != nullptr && !isHeadless())
 		{
 			contexterror = SDL_GetError();
 			SDL_DestroyWindow(window);
@@ -598,7 +608,7 @@ bool Window::setWindow(int width, int height, WindowSettings *settings)
 		if (renderer == graphics::RENDERER_OPENGL)
 			sdlflags |= SDL_WINDOW_OPENGL;
 	#ifdef LOVE_GRAPHICS_METAL
-		if (renderer == graphics::RENDERER_METAL)
+		if (renderer == graphics::RENDERER_METAL && !isHeadless())
 			sdlflags |= SDL_WINDOW_METAL;
 	#endif
 
@@ -1159,6 +1169,82 @@ int Window::getVSync() const
 	return 0;
 }
 
+void Window::setPresentMode(PresentMode mode)
+{
+#ifdef LOVE_GRAPHICS_VULKAN
+	if (windowRenderer == love::graphics::RENDERER_VULKAN)
+	{
+		VkPresentModeKHR vkmode = VK_PRESENT_MODE_FIFO_KHR;
+		switch (mode)
+		{
+		case PRESENT_MODE_FIFO:
+		case PRESENT_MODE_MAX_ENUM:
+			vkmode = VK_PRESENT_MODE_FIFO_KHR;
+			break;
+		case PRESENT_MODE_FIFO_RELAXED:
+			vkmode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+			break;
+		case PRESENT_MODE_MAILBOX:
+			vkmode = VK_PRESENT_MODE_MAILBOX_KHR;
+			break;
+		case PRESENT_MODE_IMMEDIATE:
+			vkmode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+			break;
+		}
+
+		auto vgfx = dynamic_cast<love::graphics::vulkan::Graphics*>(graphics.get());
+		vgfx->setPresentMode(vkmode);
+		return;
+	}
+#endif
+
+	// Other backends only choose whether to wait for vblank. Mailbox doesn't
+	// tear, so the closest match is regular vsync.
+	switch (mode)
+	{
+	case PRESENT_MODE_FIFO_RELAXED:
+		setVSync(-1);
+		break;
+	case PRESENT_MODE_IMMEDIATE:
+		setVSync(0);
+		break;
+	case PRESENT_MODE_FIFO:
+	case PRESENT_MODE_MAILBOX:
+	case PRESENT_MODE_MAX_ENUM:
+		setVSync(1);
+		break;
+	}
+}
+
+Window::PresentMode Window::getPresentMode() const
+{
+#ifdef LOVE_GRAPHICS_VULKAN
+	if (windowRenderer == love::graphics::RENDERER_VULKAN)
+	{
+		auto vgfx = dynamic_cast<love::graphics::vulkan::Graphics*>(graphics.get());
+		switch (vgfx->getPresentMode())
+		{
+		case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+			return PRESENT_MODE_FIFO_RELAXED;
+		case VK_PRESENT_MODE_MAILBOX_KHR:
+			return PRESENT_MODE_MAILBOX;
+		case VK_PRESENT_MODE_IMMEDIATE_KHR:
+			return PRESENT_MODE_IMMEDIATE;
+		default:
+			return PRESENT_MODE_FIFO;
+		}
+	}
+#endif
+
+	int vsync = getVSync();
+	if (vsync == 0)
+		return PRESENT_MODE_IMMEDIATE;
+	else if (vsync < 0)
+		return PRESENT_MODE_FIFO_RELAXED;
+	else
+		return PRESENT_MODE_FIFO;
+}
+
 void Window::setDisplaySleepEnabled(bool enable)
 {
 	if (enable)
@@ -1220,7 +1306,8 @@ bool Window::isMinimized() const
 
 void Window::swapBuffers()
 {
-	if (glcontext)
+	// Nothing is shown, so there's nothing to present.
+	if (glcontext && !isHeadless())
 	{
 #ifdef LOVE_WINDOWS
 		bool useDwmFlush = false;
@@ -81,6 +81,9 @@ public:
 	void setVSync(int vsync) override;
 	int getVSync() const override;
 
+	void setPresentMode(PresentMode mode) override;
+	PresentMode getPresentMode() const override;
+
 	void setDisplaySleepEnabled(bool enable) override;
 	bool isDisplaySleepEnabled() const override;
 
@@ -250,6 +250,12 @@ int w_isHighDPIAllowed(lua_State *L)
 	return 1;
 }
 
+int w_isHeadless(lua_State *L)
+{
+	luax_pushboolean(L, isHeadless());
+	return 1;
+}
+
 int w_getDisplayOrientation(lua_State *L)
 {
 	int displayindex = 0;
@@ -444,6 +450,25 @@ int w_getVSync(lua_State *L)
 	return 1;
 }
 
+int w_setPresentMode(lua_State *L)
+{
+	const char *str = luaL_checkstring(L, 1);
+	Window::PresentMode mode;
+	if (!Window::getConstant(str, mode))
+		return luax_enumerror(L, "present mode", Window::getConstants(mode), str);
+	instance()->setPresentMode(mode);
+	return 0;
+}
+
+int w_getPresentMode(lua_State *L)
+{
+	const char *str = nullptr;
+	if (!Window::getConstant(instance()->getPresentMode(), str))
+		return luaL_error(L, "Unknown present mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_setDisplaySleepEnabled(lua_State *L)
 {
 	instance()->setDisplaySleepEnabled(luax_checkboolean(L, 1));
@@ -773,6 +798,7 @@ static const luaL_Reg functions[] =
 	{ "updateMode", w_updateMode },
 	{ "getMode", w_getMode },
 	{ "isHighDPIAllowed", w_isHighDPIAllowed },
+	{ "isHeadless", w_isHeadless },
 	{ "getDisplayOrientation", w_getDisplayOrientation },
 	{ "getFullscreenModes", w_getFullscreenModes },
 	{ "setFullscreen", w_setFullscreen },
@@ -787,6 +813,8 @@ static const luaL_Reg functions[] =
 	{ "getIcon", w_getIcon },
 	{ "setVSync", w_setVSync },
 	{ "getVSync", w_getVSync },
+	{ "setPresentMode", w_setPresentMode },
+	{ "getPresentMode", w_getPresentMode },
 	{ "setDisplaySleepEnabled", w_setDisplaySleepEnabled },
 	{ "isDisplaySleepEnabled", w_isDisplaySleepEnabled },
 	{ "setTitle", w_setTitle },
@@ -0,0 +1,25 @@
+-- love.filesystem
+
+
+-- 1 MiB file read from the save directory
+love.benchmark.filesystem.read = function(bench)
+  local size = 1024 * 1024
+  love.filesystem.write('benchmark.bin', string.rep('0123456789abcdef', size / 16))
+  bench:setWork(size / 1024, 'KiB')
+  bench:run(function()
+    love.filesystem.read('benchmark.bin')
+  end)
+  love.filesystem.remove('benchmark.bin')
+end
+
+
+-- 1000 reads of a small file from the source directory
+love.benchmark.filesystem.readSmall = function(bench)
+  local count = 1000
+  bench:setWork(count, 'files')
+  bench:run(function()
+    for _=1,count do
+      love.filesystem.read('resources/test.txt')
+    end
+  end)
+end
@@ -0,0 +1,60 @@
+-- love.graphics
+-- times cpu-side cost of submitting common draws, the gpu runs asynchronously
+
+
+-- SpriteBatch with 100k sprites, rebuilt and drawn every sample
+love.benchmark.graphics.spriteBatch = function(bench)
+  local count = 100000
+  local image = love.graphics.newImage('resources/love.png')
+  local batch = love.graphics.newSpriteBatch(image, count, 'stream')
+  local canvas = love.graphics.newCanvas(256, 256)
+  bench:setWork(count, 'sprites')
+  bench:run(function()
+    batch:clear()
+    for i=1,count do
+      batch:add(i % 256, math.floor(i / 256) % 256, 0, 0.125, 0.125)
+    end
+    love.graphics.setCanvas(canvas)
+    love.graphics.draw(batch)
+    love.graphics.setCanvas()
+  end)
+end
+
+
+-- wrapped text printed 100 times
+love.benchmark.graphics.text = function(bench)
+  local count = 100
+  local font = love.graphics.newFont('resources/font.ttf', 14)
+  local text = string.rep('The quick brown fox jumps over the lazy dog. ', 10)
+  local canvas = love.graphics.newCanvas(256, 256)
+  local oldfont = love.graphics.getFont()
+  bench:setWork(count, 'paragraphs')
+  bench:run(function()
+    love.graphics.setCanvas(canvas)
+    love.graphics.setFont(font)
+    for i=1,count do
+      love.graphics.printf(text, 0, (i % 16) * 16, 256)
+    end
+    love.graphics.setFont(oldfont)
+    love.graphics.setCanvas()
+  end)
+end
+
+
+-- ParticleSystem kept at 10k particles, updated by a 60hz frame
+love.benchmark.graphics.particleUpdate = function(bench)
+  local count = 10000
+  local image = love.graphics.newImage('resources/pixel.png')
+  local particles = love.graphics.newParticleSystem(image, count)
+  particles:setEmissionRate(count * 10)
+  particles:setParticleLifetime(1, 2)
+  particles:setSpeed(10, 100)
+  particles:setSpread(math.pi * 2)
+  particles:setLinearAcceleration(0, 10, 0, 50)
+  particles:setSizes(1, 2, 1)
+  particles:update(2)
+  bench:setWork(count, 'particles')
+  bench:run(function()
+    particles:update(1 / 60)
+  end)
+end
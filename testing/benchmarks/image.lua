@@ -0,0 +1,16 @@
+-- love.image
+
+
+-- 512x512 png decoded into an ImageData
+love.benchmark.image.decode = function(bench)
+  local size = 512
+  local imagedata = love.image.newImageData(size, size)
+  imagedata:mapPixel(function(x, y)
+    return x / size, y / size, ((x * y) % 256) / 255, 1
+  end)
+  local png = imagedata:encode('png')
+  bench:setWork(size * size, 'pixels')
+  bench:run(function()
+    love.image.newImageData(png):release()
+  end)
+end
@@ -0,0 +1,21 @@
+-- love.physics
+
+
+-- one 60hz step of a world with 500 circles falling onto the ground
+love.benchmark.physics.worldStep = function(bench)
+  local count = 500
+  local world = love.physics.newWorld(0, 9.81 * 64)
+  local ground = love.physics.newBody(world, 400, 600, 'static')
+  love.physics.newRectangleShape(ground, 800, 20)
+  for i=1,count do
+    local x = 100 + (i % 25) * 24
+    local y = 580 - math.floor(i / 25) * 24
+    local body = love.physics.newBody(world, x, y, 'dynamic')
+    love.physics.newCircleShape(body, 10)
+  end
+  bench:setWork(count, 'bodies')
+  bench:run(function()
+    world:update(1 / 60)
+  end, 60)
+  world:destroy()
+end
@@ -0,0 +1,16 @@
+-- love.sound
+
+
+-- ogg stream decoded from start to end through a Decoder
+love.benchmark.sound.streamDecode = function(bench)
+  local decoder = love.sound.newDecoder('resources/tone.ogg', 16384)
+  bench:setWork(decoder:getDuration(), 'seconds')
+  bench:run(function()
+    decoder:seek(0)
+    local chunk = decoder:decode()
+    while chunk ~= nil do
+      chunk:release()
+      chunk = decoder:decode()
+    end
+  end)
+end
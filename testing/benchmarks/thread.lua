@@ -0,0 +1,44 @@
+-- love.thread
+
+
+-- 100k values pushed and popped on the same thread
+love.benchmark.thread.channel = function(bench)
+  local count = 100000
+  local channel = love.thread.newChannel()
+  bench:setWork(count, 'messages')
+  bench:run(function()
+    for i=1,count do
+      channel:push(i)
+    end
+    for _=1,count do
+      channel:pop()
+    end
+  end)
+end
+
+
+-- 100k values sent to another thread
+love.benchmark.thread.channelThreaded = function(bench)
+  local count = 100000
+  local input = love.thread.newChannel()
+  local output = love.thread.newChannel()
+  local thread = love.thread.newThread([[
+    local input, output = ...
+    while true do
+      local value = input:demand()
+      if value == false then break end
+      if value == 'done' then output:push(true) end
+    end
+  ]])
+  thread:start(input, output)
+  bench:setWork(count, 'messages')
+  bench:run(function()
+    for i=1,count do
+      input:push(i)
+    end
+    input:push('done')
+    output:demand()
+  end)
+  input:push(false)
+  thread:wait()
+end
@@ -0,0 +1,336 @@
+-- @class - BenchmarkSuite
+-- @desc - times the workloads in /benchmarks and writes the results as JSON, so
+--         runs from different engine builds can be compared
+BenchmarkSuite = {
+
+
+  -- @method - BenchmarkSuite:new()
+  -- @desc - creates a new BenchmarkSuite object that handles all the benchmarks
+  -- @return {table} - returns the new BenchmarkSuite object
+  new = function(self)
+    local suite = {
+
+      -- benchmarks to run, as {module, name}
+      queue = {},
+      index = 1,
+      bench = nil,
+      results = {},
+      baseline = nil,
+      regressions = 0,
+      output = 'lovebench',
+      time = 0,
+
+      -- love modules with benchmarks
+      filesystem = {},
+      graphics = {},
+      image = {},
+      physics = {},
+      sound = {},
+      thread = {}
+
+    }
+    setmetatable(suite, self)
+    self.__index = self
+    return suite
+  end,
+
+
+  -- @method - BenchmarkSuite:start()
+  -- @desc - queues all benchmarks of the given modules
+  -- @param {table} modules - list of module names, all modules if empty
+  -- @param {string} baseline - path to results of an earlier run to compare with
+  -- @return {nil}
+  start = function(self, modules, baseline)
+    if #modules == 0 then
+      modules = { 'filesystem', 'graphics', 'image', 'physics', 'sound', 'thread' }
+    end
+    table.sort(modules)
+    for m=1,#modules do
+      local names = {}
+      for name,_ in pairs(self[modules[m]] or {}) do
+        table.insert(names, name)
+      end
+      table.sort(names)
+      for n=1,#names do
+        table.insert(self.queue, {modules[m], names[n]})
+      end
+    end
+    if baseline ~= nil then
+      self.baseline = self:readResults(baseline)
+      if self.baseline == nil then
+        print('\27[31mCould not read baseline results from ' .. baseline .. '\27[37m')
+      end
+    end
+    self.time = love.timer.getTime()
+    print('\27[33m\nlove.benchmark.start\27[37m')
+  end,
+
+
+  -- @method - BenchmarkSuite:runSuite()
+  -- @desc - called in love.update, runs the current benchmark for a frame
+  -- @return {nil}
+  runSuite = function(self)
+    if self.bench == nil then
+      local entry = self.queue[self.index]
+      if entry == nil then
+        self:printResult()
+        love.event.quit(self.regressions > 0 and 1 or 0)
+        return
+      end
+      self.bench = Benchmark:new(entry[1], entry[2])
+      TextRun = 'love.' .. entry[1] .. '.' .. entry[2]
+      self.bench.co = coroutine.create(function()
+        local ok, err = pcall(love.benchmark[entry[1]][entry[2]], love.benchmark.bench)
+        if ok == false then
+          love.benchmark.bench.err = tostring(err)
+        end
+      end)
+    end
+
+    -- each sample yields, so the window keeps responding between them
+    coroutine.resume(self.bench.co)
+    if coroutine.status(self.bench.co) == 'dead' then
+      self:addResult(self.bench)
+      self.bench = nil
+      self.index = self.index + 1
+      collectgarbage('collect')
+    end
+  end,
+
+
+  -- @method - BenchmarkSuite:addResult()
+  -- @desc - summarises the samples of a finished benchmark and prints them
+  -- @param {table} bench - the finished Benchmark object
+  -- @return {nil}
+  addResult = function(self, bench)
+    local name = bench.module .. '.' .. bench.name
+    local result = { name = name }
+
+    if bench.err ~= nil then
+      result.error = bench.err
+      print('\27[31m' .. name .. ' ERROR ' .. bench.err .. '\27[37m')
+    elseif bench.skipped ~= nil then
+      result.skipped = bench.skipped
+      print('\27[37m' .. name .. ' SKIP ' .. bench.skipped)
+    else
+      local stats = bench:getStats()
+      for k,v in pairs(stats) do result[k] = v end
+      result.work = bench.work
+      result.unit = bench.unit
+
+      local line = string.format('%-32s median %9.3fms  min %9.3fms  max %9.3fms',
+        name, stats.median, stats.min, stats.max)
+      if bench.work ~= nil and stats.median > 0 then
+        line = line .. string.format('  %.0f %s/s', bench.work / (stats.median / 1000), bench.unit)
+      end
+
+      local color = '\27[32m'
+      local old = self.baseline and self.baseline[name]
+      if old ~= nil and old > 0 then
+        result.baseline = old
+        result.change = (stats.median - old) / old
+        line = line .. string.format('  %+.1f%%', result.change * 100)
+        if result.change > bench.threshold then
+          result.regression = true
+          self.regressions = self.regressions + 1
+          color = '\27[31m'
+        end
+      end
+      print(color .. line .. '\27[37m')
+    end
+
+    table.insert(self.results, result)
+  end,
+
+
+  -- @method - BenchmarkSuite:readResults()
+  -- @desc - reads the median times of a results file written by printResult
+  -- @param {string} path - full path of the file
+  -- @return {table} - median times keyed by benchmark name, or nil
+  readResults = function(self, path)
+    local file = io.open(path, 'r')
+    if file == nil then return nil end
+    local medians = {}
+    for line in file:lines() do
+      local name = line:match('"name":"(.-)"')
+      local median = line:match('"median":([%d%.eE%+%-]+)')
+      if name ~= nil and median ~= nil then
+        medians[name] = tonumber(median)
+      end
+    end
+    file:close()
+    return medians
+  end,
+
+
+  -- @method - BenchmarkSuite:printResult()
+  -- @desc - writes the results of all benchmarks as JSON, one per line
+  -- @return {nil}
+  printResult = function(self)
+    local name, version, vendor, device = 'NONE', 'NONE', 'NONE', 'NONE'
+    if love.graphics then
+      name, version, vendor, device = love.graphics.getRendererInfo()
+    end
+    local major, minor, revision = love.getVersion()
+
+    local function encode(value)
+      if type(value) == 'string' then
+        return '"' .. value:gsub('[%c"\\]', function(c)
+          return string.format('\\u%04x', c:byte())
+        end) .. '"'
+      elseif type(value) == 'number' then
+        return string.format('%.6g', value)
+      end
+      return tostring(value)
+    end
+
+    local lines = {}
+    for r=1,#self.results do
+      local result = self.results[r]
+      local keys = {}
+      for k,_ in pairs(result) do
+        if k ~= 'name' then table.insert(keys, k) end
+      end
+      table.sort(keys)
+      local fields = { '"name":' .. encode(result.name) }
+      for k=1,#keys do
+        table.insert(fields, '"' .. keys[k] .. '":' .. encode(result[keys[k]]))
+      end
+      table.insert(lines, '    {' .. table.concat(fields, ',') .. '}')
+    end
+
+    local json = '{\n' ..
+      '  "version": ' .. encode(major .. '.' .. minor .. '.' .. revision) .. ',\n' ..
+      '  "os": ' .. encode(love.system and love.system.getOS() or 'NONE') .. ',\n' ..
+      '  "renderer": ' .. encode(name .. ' | ' .. version .. ' | ' .. vendor .. ' | ' .. device) .. ',\n' ..
+      '  "results": [\n' .. table.concat(lines, ',\n') .. '\n  ]\n}\n'
+
+    love.filesystem.write('tempoutput/' .. self.output .. '.json', json)
+
+    local finaltime = UtilTimeFormat(love.timer.getTime() - self.time)
+    print('\27[33mlove.benchmark.end\27[37m')
+    local color = self.regressions > 0 and '\27[31m' or '\27[32m'
+    print(color .. tostring(#self.results) .. ' BENCHMARKS || ' ..
+      tostring(self.regressions) .. ' REGRESSIONS || ' .. finaltime .. 's\27[37m')
+  end
+
+
+}
+
+
+-- @class - Benchmark
+-- @desc - passed to each benchmark function, times the samples of one workload
+Benchmark = {
+
+
+  -- @method - Benchmark:new()
+  -- @desc - creates a new Benchmark object
+  -- @param {string} module - module the benchmark belongs to
+  -- @param {string} name - name of the benchmark
+  -- @return {table} - returns the new Benchmark object
+  new = function(self, module, name)
+    local bench = {
+      module = module,
+      name = name,
+      samples = {},
+      work = nil,
+      unit = nil,
+      threshold = 0.1,
+      skipped = nil,
+      err = nil,
+      co = nil
+    }
+    setmetatable(bench, self)
+    self.__index = self
+    return bench
+  end,
+
+
+  -- @method - Benchmark:setWork()
+  -- @desc - sets how much work one sample does, to report throughput
+  -- @param {number} amount - amount of work per sample
+  -- @param {string} unit - name of the unit of work, i.e. 'sprites'
+  -- @return {nil}
+  setWork = function(self, amount, unit)
+    self.work = amount
+    self.unit = unit
+  end,
+
+
+  -- @method - Benchmark:setThreshold()
+  -- @desc - sets how much slower than the baseline the median can get before
+  --         it's reported as a regression, 0.1 (10%) by default
+  -- @param {number} threshold - fraction of the baseline time
+  -- @return {nil}
+  setThreshold = function(self, threshold)
+    self.threshold = threshold
+  end,
+
+
+  -- @method - Benchmark:skip()
+  -- @desc - skips the benchmark, i.e. when something it needs isn't supported
+  -- @param {string} reason - reason to show in the output
+  -- @return {nil}
+  skip = function(self, reason)
+    self.skipped = reason
+  end,
+
+
+  -- @method - Benchmark:run()
+  -- @desc - times the given function, one sample per frame
+  -- @param {function} func - the workload to time
+  -- @param {number} samples - number of timed samples, 20 by default
+  -- @param {number} warmup - number of untimed calls first, 3 by default
+  -- @return {nil}
+  run = function(self, func, samples, warmup)
+    for _=1,(warmup or 3) do
+      func()
+      coroutine.yield()
+    end
+    collectgarbage('collect')
+    for _=1,(samples or 20) do
+      local start = love.timer.getTime()
+      func()
+      table.insert(self.samples, (love.timer.getTime() - start) * 1000)
+      coroutine.yield()
+    end
+  end,
+
+
+  -- @method - Benchmark:getStats()
+  -- @desc - gets the median, mean, min, max and standard deviation of the
+  --         samples, in milliseconds
+  -- @return {table} - the stats
+  getStats = function(self)
+    local sorted = {}
+    local total = 0
+    for s=1,#self.samples do
+      sorted[s] = self.samples[s]
+      total = total + self.samples[s]
+    end
+    table.sort(sorted)
+    local count = #sorted
+    if count == 0 then
+      return { samples = 0, median = 0, mean = 0, min = 0, max = 0, stddev = 0 }
+    end
+    local median = sorted[math.floor((count + 1) / 2)]
+    if count % 2 == 0 then
+      median = (sorted[count / 2] + sorted[count / 2 + 1]) / 2
+    end
+    local mean = total / count
+    local variance = 0
+    for s=1,count do
+      variance = variance + (sorted[s] - mean) ^ 2
+    end
+    return {
+      samples = count,
+      median = median,
+      mean = mean,
+      min = sorted[1],
+      max = sorted[count],
+      stddev = math.sqrt(variance / count)
+    }
+  end
+
+
+}
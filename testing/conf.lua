@@ -8,6 +8,10 @@ function love.conf(t)
   t.window.depth = true
   t.window.stencil = true
   t.window.usedpiscale = false
+  -- render without showing a window, i.e. on servers or CI without a display
+  for _,a in ipairs(arg or {}) do
+    if a == '--headless' then t.window.headless = true end
+  end
 end
 
 -- custom crash message here to catch anything that might occur with modules 
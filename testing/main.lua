@@ -21,6 +21,7 @@ if love.keyboard ~= nil then require('tests.keyboard') end
 if love.math ~= nil then require('tests.math') end
 if love.mouse ~= nil then require('tests.mouse') end
 if love.physics ~= nil then require('tests.physics') end
+if love.profiler ~= nil then require('tests.profiler') end
 if love.sensor ~= nil then require('tests.sensor') end
 if love.sound ~= nil then require('tests.sound') end
 if love.system ~= nil then require('tests.system') end
@@ -66,10 +67,14 @@ love.load = function(args)
 
   -- get all args with any comma lists split out as seperate
   local arglist = {}
+  -- --headless is handled in conf.lua
+  HEADLESS = love.window ~= nil and love.window.isHeadless()
   for a=1,#args do
-    local splits = UtilStringSplit(args[a], '([^,]+)')
-    for s=1,#splits do
-      table.insert(arglist, splits[s])
+    if args[a] ~= '--headless' then
+      local splits = UtilStringSplit(args[a], '([^,]+)')
+      for s=1,#splits do
+        table.insert(arglist, splits[s])
+      end
     end
   end
 
@@ -80,10 +85,11 @@ love.load = function(args)
   local cmderr = 'Invalid flag used'
   local modules = {
     'audio', 'data', 'event', 'filesystem', 'font', 'graphics', 'image',
-    'joystick', 'keyboard', 'love', 'math', 'mouse', 'physics', 'sensor',
-    'sound', 'system', 'thread', 'timer', 'touch', 'video', 'window'
+    'joystick', 'keyboard', 'love', 'math', 'mouse', 'physics', 'profiler',
+    'sensor', 'sound', 'system', 'thread', 'timer', 'touch', 'video', 'window'
   }
   GITHUB_RUNNER = false
+  local baseline = nil
   for a=1,#arglist do
     if testcmd == '--method' then
       if module == '' and (arglist[a] == 'love' or love[ arglist[a] ] ~= nil) then 
@@ -98,6 +104,13 @@ love.load = function(args)
         table.insert(modules, arglist[a]) 
       end
     end
+    if testcmd == '--benchmark' then
+      if arglist[a - 1] == '--baseline' then
+        baseline = arglist[a]
+      elseif love[ arglist[a] ] ~= nil then
+        table.insert(modules, arglist[a])
+      end
+    end
     if arglist[a] == '--method' then
       testcmd = arglist[a]
       modules = {}
@@ -106,11 +119,30 @@ love.load = function(args)
       testcmd = arglist[a]
       modules = {}
     end
+    if arglist[a] == '--benchmark' then
+      testcmd = arglist[a]
+      modules = {}
+    end
     if arglist[a] == '--isRunner' then
       GITHUB_RUNNER = true
     end
   end
 
+  -- benchmark times the workloads of the given modules (all by default)
+  if testcmd == '--benchmark' then
+    require('classes.BenchmarkSuite')
+    love.benchmark = BenchmarkSuite:new()
+    if love.filesystem ~= nil then require('benchmarks.filesystem') end
+    if love.graphics ~= nil then require('benchmarks.graphics') end
+    if love.image ~= nil then require('benchmarks.image') end
+    if love.physics ~= nil then require('benchmarks.physics') end
+    if love.sound ~= nil then require('benchmarks.sound') end
+    if love.thread ~= nil then require('benchmarks.thread') end
+    TextCommand = testcmd
+    love.benchmark:start(modules, baseline)
+    return
+  end
+
   -- method uses the module + method given
   if testcmd == '--method' then
     local testmodule = TestModule:new(module, method)
@@ -172,7 +204,11 @@ end
 -- love.update
 -- run test suite logic 
 love.update = function(delta)
-  love.test:runSuite(delta)
+  if love.benchmark ~= nil then
+    love.benchmark:runSuite()
+  else
+    love.test:runSuite(delta)
+  end
 end
 
 
@@ -51,6 +51,25 @@ love.test.audio.RecordingDevice = function(test)
   test:assertEquals(nil, device:getData(), 'using stop should clear buffer')
   test:assertObject(recording)
 
+  -- check blocks are delivered to a channel
+  local channel = love.thread.newChannel()
+  device:setChannel(channel, 400)
+  local setchannel, blocksamples = device:getChannel()
+  test:assertEquals(channel, setchannel, 'check channel set')
+  test:assertEquals(400, blocksamples, 'check block samples set')
+  test:assertTrue(device:start(32000, 4000, 16, 1), 'check channel recording started')
+  test:waitFrames(30)
+  test:assertEquals(nil, device:getData(), 'check getData empty with channel')
+  device:stop()
+  local block = channel:pop()
+  if block ~= nil then
+    test:assertEquals(400, block:getSampleCount(), 'check block sample count')
+  end
+  device:setChannel(nil)
+  test:assertEquals(nil, device:getChannel(), 'check channel cleared')
+  local ok = pcall(device.setChannel, device, channel, 0)
+  test:assertFalse(ok, 'check invalid block size errors')
+
 end
 
 
@@ -192,6 +211,35 @@ love.test.audio.Source = function(test)
   love.audio.stop(mono)
   love.audio.stop(effsource)
 
+  -- check priority
+  local click = love.audio.newSource('resources/click.ogg', 'static')
+  test:assertEquals(0, click:getPriority(), 'check def priority')
+  click:setPriority(5)
+  test:assertEquals(5, click:getPriority(), 'check set priority')
+  test:assertFalse(click:isVirtual(), 'check not virtual by def')
+
+  -- check sources past the mixing limit keep playing virtually, and that
+  -- more important sources take over their voices
+  click:setPriority(0)
+  click:setLooping(true)
+  local voices = {}
+  for i=1,80 do
+    voices[i] = click:clone()
+    voices[i]:play()
+  end
+  local important = click:clone()
+  important:setPriority(10)
+  important:play()
+  local virtual = 0
+  for i=1,#voices do
+    test:assertTrue(voices[i]:isPlaying(), 'check voice ' .. i .. ' playing')
+    if voices[i]:isVirtual() then virtual = virtual + 1 end
+  end
+  test:assertTrue(virtual > 0, 'check some voices virtual')
+  test:assertFalse(important:isVirtual(), 'check priority voice mixed')
+  love.audio.stop()
+  test:assertFalse(voices[1]:isVirtual(), 'check stopped voices not virtual')
+
 end
 
 
@@ -299,6 +347,13 @@ love.test.audio.getOrientation = function(test)
 end
 
 
+-- love.audio.getOutputSampleRate
+love.test.audio.getOutputSampleRate = function(test)
+  -- check we get a plausible device rate
+  test:assertGreaterEqual(8000, love.audio.getOutputSampleRate(), 'check sample rate')
+end
+
+
 -- love.audio.getPlaybackDevice
 love.test.audio.getPlaybackDevice = function(test)
   test:assertNotNil(love.audio.getPlaybackDevice)
@@ -361,6 +416,23 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.audio.newQueueableSource = function(test)
   test:assertObject(love.audio.newQueueableSource(32, 8, 1, 8))
+  -- check ring buffered sources accept data until the ring is full
+  local ringsource = love.audio.newQueueableSource(44100, 16, 1, 4, 1024)
+  test:assertObject(ringsource)
+  test:assertEquals(4, ringsource:getFreeBufferCount(), 'check ring empty')
+  local sounddata = love.sound.newSoundData(256, 44100, 16, 1)
+  test:assertTrue(ringsource:queue(sounddata), 'check queued')
+  test:assertEquals(3, ringsource:getFreeBufferCount(), 'check ring used')
+  test:assertEquals(256, ringsource:getDuration('samples'), 'check ring duration')
+  for i=1,3 do ringsource:queue(sounddata) end
+  test:assertFalse(ringsource:queue(sounddata), 'check ring full')
+  -- check starved ring sources keep playing until stopped
+  ringsource:play()
+  test:assertTrue(ringsource:isPlaying(), 'check playing')
+  ringsource:stop()
+  test:assertEquals(4, ringsource:getFreeBufferCount(), 'check stop clears ring')
+  ringsource:release()
+  sounddata:release()
 end
 
 
@@ -369,6 +441,10 @@ end
 love.test.audio.newSource = function(test)
   test:assertObject(love.audio.newSource('resources/click.ogg', 'static'))
   test:assertObject(love.audio.newSource('resources/click.ogg', 'stream'))
+  local compressed = love.audio.newSource('resources/click.ogg', 'compressed')
+  test:assertObject(compressed)
+  test:assertEquals('compressed', compressed:getType(), 'check compressed type')
+  test:assertEquals('compressed', compressed:clone():getType(), 'check compressed clone type')
 end
 
 
@@ -396,6 +472,22 @@ love.test.audio.play = function(test)
 end
 
 
+-- love.audio.playOneShot
+love.test.audio.playOneShot = function(test)
+  local sounddata = love.sound.newSoundData('resources/clickmono.ogg')
+  local count = love.audio.getActiveSourceCount()
+  -- check one shots play without creating a source
+  test:assertTrue(love.audio.playOneShot(sounddata), 'check played')
+  test:assertTrue(love.audio.playOneShot(sounddata, 0.5, 2, 1, 2, 3), 'check played positioned')
+  test:assertEquals(count + 2, love.audio.getActiveSourceCount(), 'check both voices playing')
+  -- check positioning stereo sounds errors like Source:setPosition
+  local stereo = love.sound.newSoundData('resources/click.ogg')
+  local ok = pcall(love.audio.playOneShot, stereo, 1, 1, 1, 2, 3)
+  test:assertFalse(ok, 'check stereo position errors')
+  love.audio.stop()
+end
+
+
 -- love.audio.setDistanceModel
 love.test.audio.setDistanceModel = function(test)
   -- check setting each of the distance models is accepted and val returned
@@ -436,6 +528,27 @@ love.test.audio.setEffect = function(test)
 end
 
 
+-- love.audio.setEffectTarget
+love.test.audio.setEffectTarget = function(test)
+  love.audio.setEffect('testsubmix', { type = 'compressor' })
+  love.audio.setEffect('testbus', { type = 'reverb' })
+  -- check routing one effect into another is reported back
+  if not love.audio.setEffectTarget('testsubmix', 'testbus') then
+    love.audio.setEffect('testsubmix')
+    love.audio.setEffect('testbus')
+    return test:skipTest('effect targets not supported')
+  end
+  test:assertEquals('testbus', love.audio.getEffectTarget('testsubmix'), 'check target set')
+  -- check loops are rejected
+  local ok = pcall(love.audio.setEffectTarget, 'testbus', 'testsubmix')
+  test:assertFalse(ok, 'check routing loop errors')
+  -- check removing the target effect clears the route
+  love.audio.setEffect('testbus')
+  test:assertEquals(nil, love.audio.getEffectTarget('testsubmix'), 'check target cleared')
+  love.audio.setEffect('testsubmix')
+end
+
+
 -- love.audio.setMixWithSystem
 love.test.audio.setMixWithSystem = function(test)
   test:assertNotNil(love.audio.setMixWithSystem(true))
@@ -505,6 +618,60 @@ love.test.audio.setPosition = function(test)
 end
 
 
+-- love.audio.setSourceTransforms
+love.test.audio.setSourceTransforms = function(test)
+  local source1 = love.audio.newSource('resources/clickmono.ogg', 'static')
+  local source2 = love.audio.newSource('resources/clickmono.ogg', 'static')
+  -- check positions and velocities are set for every source
+  love.audio.setSourceTransforms({source1, source2}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12})
+  local x, y, z = source2:getPosition()
+  test:assertEquals(7, x, 'check position x')
+  test:assertEquals(8, y, 'check position y')
+  test:assertEquals(9, z, 'check position z')
+  x, y, z = source1:getVelocity()
+  test:assertEquals(4, x, 'check velocity x')
+  test:assertEquals(5, y, 'check velocity y')
+  test:assertEquals(6, z, 'check velocity z')
+  -- check positions only
+  love.audio.setSourceTransforms({source1}, {-1, -2, -3}, 3)
+  x, y, z = source1:getPosition()
+  test:assertEquals(-1, x, 'check position only')
+  x, y, z = source1:getVelocity()
+  test:assertEquals(4, x, 'check velocity unchanged')
+  -- check too little data errors
+  local ok = pcall(love.audio.setSourceTransforms, {source1, source2}, {1, 2, 3})
+  test:assertFalse(ok, 'check missing data errors')
+end
+
+
+-- love.audio.setSoundCacheLimit
+love.test.audio.setSoundCacheLimit = function(test)
+  love.audio.clearSoundCache()
+  test:assertEquals(0, love.audio.getSoundCacheSize(), 'check empty cache')
+  -- check static sources loaded from the same file share decoded audio
+  local source1 = love.audio.newSource('resources/click.ogg', 'static')
+  local size = love.audio.getSoundCacheSize()
+  test:assertGreaterEqual(1, size, 'check cached')
+  local source2 = love.audio.newSource('resources/click.ogg', 'static')
+  test:assertEquals(size, love.audio.getSoundCacheSize(), 'check shared')
+  test:assertEquals(source1:getDuration('samples'), source2:getDuration('samples'), 'check same audio')
+  -- check streaming sources are never cached
+  local stream = love.audio.newSource('resources/click.ogg', 'stream')
+  test:assertEquals(size, love.audio.getSoundCacheSize(), 'check stream not cached')
+  -- check lowering the limit evicts entries but keeps existing sources
+  local limit = love.audio.getSoundCacheLimit()
+  love.audio.setSoundCacheLimit(0)
+  test:assertEquals(0, love.audio.getSoundCacheLimit(), 'check limit set')
+  test:assertEquals(0, love.audio.getSoundCacheSize(), 'check evicted')
+  test:assertEquals(source1:getDuration('samples'), source2:getDuration('samples'), 'check sources kept')
+  love.audio.setSoundCacheLimit(limit)
+  love.audio.clearSoundCache()
+  source1:release()
+  source2:release()
+  stream:release()
+end
+
+
 -- love.audio.setVelocity
 love.test.audio.setVelocity = function(test)
   -- check setting velocity vals are returned
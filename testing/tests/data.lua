@@ -37,6 +37,25 @@ love.test.data.ByteData = function(test)
   data:setString('love!', 5)
   test:assertEquals('hellolove!', data:getString(), 'check change string')
 
+  -- check atomic operations
+  local shared = love.data.newByteData(16)
+  shared:atomicStore('int32', 0, -5)
+  test:assertEquals(-5, shared:atomicLoad('int32', 0), 'check atomic store')
+  test:assertEquals(4294967291, shared:atomicLoad('uint32', 0, 'acquire'), 'check atomic unsigned load')
+  test:assertEquals(-5, shared:atomicAdd('int32', 0, 7), 'check atomic add result')
+  test:assertEquals(2, shared:atomicLoad('int32', 0), 'check atomic add')
+  test:assertEquals(2, shared:atomicExchange('int32', 0, 10, 'acqrel'), 'check atomic exchange')
+  local success, previous = shared:atomicCompareExchange('uint32', 0, 3, 20)
+  test:assertFalse(success, 'check failed compare exchange')
+  test:assertEquals(10, previous, 'check failed compare exchange value')
+  success, previous = shared:atomicCompareExchange('uint32', 0, 10, 20, 'relaxed')
+  test:assertTrue(success, 'check compare exchange')
+  test:assertEquals(20, shared:atomicLoad('uint32', 0), 'check compare exchange value')
+  local ok = pcall(shared.atomicLoad, shared, 'int32', 2)
+  test:assertFalse(ok, 'check misaligned offset')
+  ok = pcall(shared.atomicLoad, shared, 'int32', 16)
+  test:assertFalse(ok, 'check offset out of range')
+
 end
 
 
@@ -62,6 +81,97 @@ love.test.data.CompressedData = function(test)
 end
 
 
+-- CompressionStream (love.data.newCompressionStream)
+love.test.data.CompressionStream = function(test)
+
+  -- check each format round trips when pushed a chunk at a time
+  local formats = { 'lz4', 'zlib', 'gzip', 'deflate' }
+  local text = string.rep('helloworld', 1000)
+  for f=1,#formats do
+    local compressor = love.data.newCompressionStream('compress', formats[f])
+    test:assertObject(compressor)
+    test:assertEquals('compress', compressor:getMode(), 'check mode')
+    test:assertEquals(formats[f], compressor:getFormat(), 'check format')
+    local compressed = {}
+    for i=1,#text,3000 do
+      table.insert(compressed, compressor:push('string', text:sub(i, i + 2999)))
+    end
+    table.insert(compressed, compressor:finish('string'))
+    test:assertTrue(compressor:isFinished(), 'check compress finished')
+    compressed = table.concat(compressed)
+    local decompressor = love.data.newCompressionStream('decompress', formats[f])
+    local output = decompressor:push('data', compressed)
+    test:assertEquals(text, output:getString(), 'check ' .. formats[f] .. ' round trip')
+    test:assertTrue(decompressor:isFinished(), 'check decompress finished')
+    -- check truncated streams are an error
+    local truncated = love.data.newCompressionStream('decompress', formats[f])
+    truncated:push('string', compressed:sub(1, #compressed / 2))
+    local ok = pcall(truncated.finish, truncated, 'string')
+    test:assertFalse(ok, 'check ' .. formats[f] .. ' truncated')
+  end
+
+  -- check gzip streams can be read by love.data.decompress
+  local gzip = love.data.newCompressionStream('compress', 'gzip')
+  local compressed = gzip:push('string', text) .. gzip:finish('string')
+  test:assertEquals(text, love.data.decompress('string', 'gzip', compressed), 'check one-shot')
+
+  -- check processing files
+  love.filesystem.write('stream.txt', text)
+  local source = love.filesystem.openFile('stream.txt', 'r')
+  local dest = love.filesystem.openFile('stream.lz4', 'w')
+  love.data.newCompressionStream('compress', 'lz4'):process(source, dest, 1000)
+  source:close()
+  dest:close()
+  source = love.filesystem.openFile('stream.lz4', 'r')
+  dest = love.filesystem.openFile('stream2.txt', 'w')
+  love.data.newCompressionStream('decompress', 'lz4'):process(source, dest)
+  source:close()
+  dest:close()
+  test:assertEquals(text, love.filesystem.read('stream2.txt'), 'check processed files')
+  love.filesystem.remove('stream.txt')
+  love.filesystem.remove('stream.lz4')
+  love.filesystem.remove('stream2.txt')
+
+end
+
+
+-- Hasher (love.data.newHasher)
+love.test.data.Hasher = function(test)
+
+  -- check hashing a chunk at a time matches hashing everything at once
+  local functions = { 'md5', 'sha1', 'sha224', 'sha256', 'sha384', 'sha512', 'xxh32', 'xxh64' }
+  local text = string.rep('helloworld', 1000)
+  for f=1,#functions do
+    local hasher = love.data.newHasher(functions[f])
+    test:assertObject(hasher)
+    test:assertEquals(functions[f], hasher:getFunction(), 'check function')
+    for i=1,#text,333 do
+      hasher:update(text:sub(i, i + 332))
+    end
+    test:assertFalse(hasher:isFinished(), 'check not finished')
+    local expected = love.data.hash('string', functions[f], text)
+    test:assertEquals(expected, hasher:finish('string'), 'check ' .. functions[f] .. ' chunked')
+    test:assertTrue(hasher:isFinished(), 'check finished')
+    local ok = pcall(hasher.update, hasher, 'hello')
+    test:assertFalse(ok, 'check update after finish')
+    -- check Data input and container
+    hasher = love.data.newHasher(functions[f])
+    hasher:update(love.data.newByteData(text))
+    test:assertEquals(expected, hasher:finish('data'):getString(), 'check ' .. functions[f] .. ' data')
+  end
+
+  -- check hashing files
+  love.filesystem.write('hasher.txt', text)
+  local file = love.filesystem.openFile('hasher.txt', 'r')
+  local hasher = love.data.newHasher('sha256')
+  hasher:update(file, 1000)
+  file:close()
+  test:assertEquals(love.data.hash('string', 'sha256', text), hasher:finish('string'), 'check file')
+  love.filesystem.remove('hasher.txt')
+
+end
+
+
 --------------------------------------------------------------------------------
 --------------------------------------------------------------------------------
 ------------------------------------METHODS-------------------------------------
@@ -69,6 +179,48 @@ end
 --------------------------------------------------------------------------------
 
 
+-- PackFormat (love.data.newPackFormat)
+love.test.data.PackFormat = function(test)
+  -- check sizes
+  local format = love.data.newPackFormat('<I4fB')
+  test:assertObject(format)
+  test:assertEquals(9, format:getSize(), 'check size')
+  test:assertEquals(3, format:getValueCount(), 'check value count')
+  test:assertEquals('<I4fB', format:getFormat(), 'check format')
+  test:assertEquals(nil, love.data.newPackFormat('<s4'):getSize(), 'check variable size')
+  test:assertFalse(pcall(love.data.newPackFormat, 'q'), 'check invalid format')
+  -- check it matches the format string
+  local packed = format:pack('string', 100, 0.5, 255)
+  test:assertEquals(love.data.pack('string', '<I4fB', 100, 0.5, 255), packed, 'check pack')
+  local a, b, c, pos = format:unpack(packed)
+  test:assertEquals(100, a, 'check unpack 1')
+  test:assertEquals(0.5, b, 'check unpack 2')
+  test:assertEquals(255, c, 'check unpack 3')
+  test:assertEquals(10, pos, 'check unpack pos')
+  test:assertEquals(100, love.data.unpack(format, packed), 'check love.data.unpack')
+  test:assertEquals(packed, love.data.pack('string', format, 100, 0.5, 255), 'check love.data.pack')
+  -- check unpacking records into a table
+  local records = format:pack('string', 1, 1.5, 2) .. format:pack('string', 3, 3.5, 4)
+  local t, next = format:unpackArray(records, 2)
+  test:assertEquals(6, #t, 'check array size')
+  test:assertEquals(3.5, t[5], 'check array value')
+  test:assertEquals(19, next, 'check array pos')
+  local existing = {'keep'}
+  format:unpackArray(records, 1, 10, existing, 2)
+  test:assertEquals('keep', existing[1], 'check existing kept')
+  test:assertEquals(3, existing[2], 'check existing offset')
+  test:assertFalse(pcall(format.unpackArray, format, records, 3), 'check too short')
+  -- check reading one field of each record from a Data
+  local f1, f2 = love.data.newByteData(records):getFloat(4, 2, 9)
+  test:assertEquals(1.5, f1, 'check strided 1')
+  test:assertEquals(3.5, f2, 'check strided 2')
+  -- check variable size formats
+  local strformat = love.data.newPackFormat('s1z')
+  local x, y = strformat:unpack(strformat:pack('string', 'hello', 'world'))
+  test:assertEquals('hello world', x .. ' ' .. y, 'check strings')
+end
+
+
 -- love.data.compress
 love.test.data.compress = function(test)
   -- here just testing each combo 'works' - in decompress's test method
@@ -108,6 +260,36 @@ love.test.data.compress = function(test)
       test:assertNotEquals(nil, compressions[c][1]:type(), 'check has :type()')
     end
   end
+  -- check parallel compression of inputs split into several blocks
+  local large = string.rep('helloworld', 500000)
+  local formats = { 'lz4', 'zlib', 'gzip', 'deflate' }
+  for f=1,#formats do
+    local compressed = love.data.compress('data', formats[f], large, -1, true)
+    test:assertEquals(large, love.data.decompress('string', compressed), 'check parallel ' .. formats[f])
+  end
+end
+
+
+-- love.data.compressAsync
+love.test.data.compressAsync = function(test)
+  -- check each format round trips through the job system
+  local text = string.rep('helloworld', 10000)
+  local formats = { 'lz4', 'zlib', 'gzip', 'deflate' }
+  for f=1,#formats do
+    local job = love.data.compressAsync(formats[f], text)
+    test:assertObject(job)
+    job:wait()
+    test:assertTrue(job:isComplete(), 'check complete ' .. formats[f])
+    test:assertEquals(nil, job:getError(), 'check no error ' .. formats[f])
+    local compressed = job:getResult()
+    test:assertObject(compressed)
+    test:assertEquals(formats[f], compressed:getFormat(), 'check format ' .. formats[f])
+    test:assertEquals(text, love.data.decompress('string', compressed), 'check round trip ' .. formats[f])
+  end
+  -- check Data inputs work too
+  local job = love.data.compressAsync('zlib', love.data.newByteData(text), 9)
+  job:wait()
+  test:assertEquals(text, love.data.decompress('string', job:getResult()), 'check data input')
 end
 
 
@@ -169,6 +351,38 @@ love.test.data.decompress = function(test)
 end
 
 
+-- love.data.deserialize
+love.test.data.deserialize = function(test)
+  -- check values round trip, including shared and cyclic tables
+  local shared = {1, 2, 3}
+  local value = {
+    'a', 'b', nil, 'b',
+    name = 'love', count = -12345, ratio = 0.25, big = 2^60, flag = true,
+    nested = {shared = shared, again = shared}
+  }
+  value.self = value
+  local data = love.data.serialize('data', value)
+  local result, size = love.data.deserialize(data)
+  test:assertEquals(data:getSize(), size, 'check size read')
+  test:assertEquals('a', result[1], 'check array 1')
+  test:assertEquals(nil, result[3], 'check array hole')
+  test:assertEquals('b', result[4], 'check array 4')
+  test:assertEquals('love', result.name, 'check string')
+  test:assertEquals(-12345, result.count, 'check integer')
+  test:assertEquals(0.25, result.ratio, 'check number')
+  test:assertEquals(2^60, result.big, 'check large number')
+  test:assertEquals(true, result.flag, 'check boolean')
+  test:assertEquals(result, result.self, 'check cycle')
+  test:assertEquals(result.nested.shared, result.nested.again, 'check shared')
+  test:assertEquals(3, result.nested.shared[3], 'check shared contents')
+  -- check offsets and errors
+  local str = 'xx' .. love.data.serialize('string', 'hello')
+  test:assertEquals('hello', love.data.deserialize(str, 2), 'check offset')
+  test:assertFalse(pcall(love.data.deserialize, str:sub(1, -2), 2), 'check truncated error')
+  test:assertFalse(pcall(love.data.deserialize, ''), 'check empty error')
+end
+
+
 -- love.data.encode
 love.test.data.encode = function(test)
   -- here just testing each combo 'works' - in decode's test method
@@ -190,6 +404,26 @@ love.test.data.encode = function(test)
     end
   end
 
+  -- check the output matches the reference encoding, including line breaks
+  local bytes = ''
+  for b=0,255 do bytes = bytes .. string.char(b) end
+  local hex = love.data.encode('string', 'hex', bytes)
+  test:assertEquals(512, #hex, 'check hex length')
+  test:assertEquals('000102', hex:sub(1, 6), 'check hex start')
+  test:assertEquals('fdfeff', hex:sub(-6), 'check hex end')
+  test:assertEquals('aGVsbG93b3JsZA==', love.data.encode('string', 'base64', 'helloworld'), 'check base64')
+  test:assertEquals('aGVsbG93\nb3JsZA==', love.data.encode('string', 'base64', 'helloworld', 8), 'check base64 lines')
+  test:assertEquals('aGVs\nbG93\n', love.data.encode('string', 'base64', 'hellow', 4), 'check base64 full lines')
+  test:assertEquals(bytes, love.data.decode('string', 'base64', love.data.encode('string', 'base64', bytes, 76)), 'check base64 roundtrip')
+
+  -- encoding into an existing bytedata
+  local target = love.data.newByteData(32)
+  local result, size = love.data.encode(target, 4, 'hex', 'helloworld')
+  test:assertEquals(target, result, 'check same bytedata')
+  test:assertEquals(20, size, 'check encoded size')
+  test:assertEquals('68656c6c6f776f726c64', target:getString(4, size), 'check encoded bytes')
+  test:assertFalse(pcall(love.data.encode, target, 20, 'hex', 'helloworld'), 'check overflow error')
+
 end
 
 
@@ -213,12 +447,16 @@ love.test.data.hash = function(test)
   local str4 = love.data.hash('string', 'sha256', 'helloworld')
   local str5 = love.data.hash('string', 'sha384', 'helloworld')
   local str6 = love.data.hash('string', 'sha512', 'helloworld')
+  local str7 = love.data.hash('string', 'xxh32', 'helloworld')
+  local str8 = love.data.hash('string', 'xxh64', 'helloworld')
   local data1 = love.data.hash('data', 'md5', 'helloworld')
   local data2 = love.data.hash('data', 'sha1', 'helloworld')
   local data3 = love.data.hash('data', 'sha224', 'helloworld')
   local data4 = love.data.hash('data', 'sha256', 'helloworld')
   local data5 = love.data.hash('data', 'sha384', 'helloworld')
   local data6 = love.data.hash('data', 'sha512', 'helloworld')
+  local data7 = love.data.hash('data', 'xxh32', 'helloworld')
+  local data8 = love.data.hash('data', 'xxh64', 'helloworld')
   -- check encoded hash value matches what's expected for that algo
     -- test container string
   test:assertEquals('fc5e038d38a57032085441e7fe7010b0', love.data.encode("string", "hex", str1), 'check string md5 encode')
@@ -227,6 +465,8 @@ love.test.data.hash = function(test)
   test:assertEquals('936a185caaa266bb9cbe981e9e05cb78cd732b0b3280eb944412bb6f8f8f07af', love.data.encode("string", "hex", str4), 'check string sha256 encode')
   test:assertEquals('97982a5b1414b9078103a1c008c4e3526c27b41cdbcf80790560a40f2a9bf2ed4427ab1428789915ed4b3dc07c454bd9', love.data.encode("string", "hex", str5), 'check string sha384 encode')
   test:assertEquals('1594244d52f2d8c12b142bb61f47bc2eaf503d6d9ca8480cae9fcf112f66e4967dc5e8fa98285e36db8af1b8ffa8b84cb15e0fbcf836c3deb803c13f37659a60', love.data.encode("string", "hex", str6), 'check string sha512 encode')
+  test:assertEquals('2362e202', love.data.encode("string", "hex", str7), 'check string xxh32 encode')
+  test:assertEquals('80111601aa1c6a4f', love.data.encode("string", "hex", str8), 'check string xxh64 encode')
     -- test container data
   test:assertEquals('fc5e038d38a57032085441e7fe7010b0', love.data.encode("string", "hex", data1), 'check data md5 encode')
   test:assertEquals('6adfb183a4a2c94a2f92dab5ade762a47889a5a1', love.data.encode("string", "hex", data2), 'check data sha1 encode')
@@ -234,6 +474,8 @@ love.test.data.hash = function(test)
   test:assertEquals('936a185caaa266bb9cbe981e9e05cb78cd732b0b3280eb944412bb6f8f8f07af', love.data.encode("string", "hex", data4), 'check data sha256 encode')
   test:assertEquals('97982a5b1414b9078103a1c008c4e3526c27b41cdbcf80790560a40f2a9bf2ed4427ab1428789915ed4b3dc07c454bd9', love.data.encode("string", "hex", data5), 'check data sha384 encode')
   test:assertEquals('1594244d52f2d8c12b142bb61f47bc2eaf503d6d9ca8480cae9fcf112f66e4967dc5e8fa98285e36db8af1b8ffa8b84cb15e0fbcf836c3deb803c13f37659a60', love.data.encode("string", "hex", data6), 'check data sha512 encode')
+  test:assertEquals('2362e202', love.data.encode("string", "hex", data7), 'check data xxh32 encode')
+  test:assertEquals('80111601aa1c6a4f', love.data.encode("string", "hex", data8), 'check data xxh64 encode')
 end
 
 
@@ -241,6 +483,15 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.data.newByteData = function(test)
   test:assertObject(love.data.newByteData('helloworld'))
+  -- the collector is stepped for the memory Data objects hold, so unused
+  -- ones are collected without calling collectgarbage
+  local alive = setmetatable({}, { __mode = 'v' })
+  for i = 1, 128 do
+    alive[i] = love.data.newByteData(1024 * 1024)
+  end
+  local count = 0
+  for _ in pairs(alive) do count = count + 1 end
+  test:assertRange(count, 0, 127, 'check unused data collected')
 end
 
 
@@ -251,6 +502,20 @@ love.test.data.newDataView = function(test)
 end
 
 
+-- love.data.newHasher
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.data.newHasher = function(test)
+  test:assertObject(love.data.newHasher('sha256'))
+end
+
+
+-- love.data.newPackFormat
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.data.newPackFormat = function(test)
+  test:assertObject(love.data.newPackFormat('>I4I4'))
+end
+
+
 -- love.data.pack
 love.test.data.pack = function(test)
   local packed1 = love.data.pack('string', '>I4I4I4I4', 9999, 1000, 1010, 2030)
@@ -264,6 +529,28 @@ love.test.data.pack = function(test)
 end
 
 
+-- love.data.serialize
+love.test.data.serialize = function(test)
+  -- check containers
+  test:assertEquals('string', type(love.data.serialize('string', {1, 2, 3})), 'check string')
+  test:assertObject(love.data.serialize('data', {1, 2, 3}))
+  -- check repeated strings are only stored once
+  local once = love.data.serialize('string', {'some long string'})
+  local many = love.data.serialize('string', {'some long string', 'some long string', 'some long string'})
+  test:assertTrue(#many < #once + 8, 'check strings interned')
+  -- check writing into a bytedata
+  local bytedata = love.data.newByteData(64)
+  local d, size = love.data.serialize(bytedata, 4, {x = 1, y = 2})
+  test:assertEquals(bytedata, d, 'check same bytedata')
+  test:assertEquals(1, love.data.deserialize(bytedata, 4).x, 'check written')
+  test:assertTrue(size > 0, 'check written size')
+  test:assertFalse(pcall(love.data.serialize, bytedata, 60, {1, 2, 3, 4, 5}), 'check fit error')
+  -- check unsupported values
+  test:assertFalse(pcall(love.data.serialize, 'string', print), 'check function error')
+  test:assertFalse(pcall(love.data.serialize, 'string', {bytedata}), 'check userdata error')
+end
+
+
 -- love.data.unpack
 love.test.data.unpack = function(test)
   local packed1 = love.data.pack('string', '>s5s4I3', 'hello', 'love', 100)
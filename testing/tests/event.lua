@@ -39,6 +39,28 @@ love.test.event.poll = function(test)
 end
 
 
+-- love.event.pollBatch
+love.test.event.pollBatch = function(test)
+  love.event.clear()
+  love.event.push('test', 1, 2, 3)
+  love.event.push('test2', 'a')
+  love.event.push('test3')
+  -- check events are written into the given table
+  local events = {}
+  test:assertEquals(2, love.event.pollBatch(events, 2), 'check max count')
+  test:assertEquals('test', events[1][1], 'check name')
+  test:assertEquals(3, events[1][4], 'check args')
+  test:assertEquals(4, events[1].n, 'check size')
+  -- check tables are reused and leftover args cleared
+  local first = events[1]
+  test:assertEquals(1, love.event.pollBatch(events), 'check remaining count')
+  test:assertEquals(first, events[1], 'check table reused')
+  test:assertEquals('test3', events[1][1], 'check reused name')
+  test:assertEquals(nil, events[1][2], 'check leftover args cleared')
+  test:assertEquals(0, love.event.pollBatch(events), 'check no events')
+end
+
+
 -- love.event.pump
 -- @NOTE dont think can really test as internally used
 love.test.event.pump = function(test)
@@ -73,6 +95,25 @@ love.test.event.quit = function(test)
 end
 
 
+-- love.event.setInputSampling
+love.test.event.setInputSampling = function(test)
+  test:assertFalse(love.event.isInputSampling(), 'check off by def')
+  love.event.setInputSampling(true, 16)
+  test:assertTrue(love.event.isInputSampling(), 'check enabled')
+  love.event.pump()
+  -- check samples are written into the given table
+  local samples = {}
+  local count, lost = love.event.getInputSamples(samples)
+  test:assertEquals(0, lost, 'check nothing lost')
+  for i=1,count do
+    test:assertEquals('number', type(samples[i][2]), 'check sample time')
+  end
+  test:assertFalse(pcall(love.event.setInputSampling, true, 0), 'check invalid capacity')
+  love.event.setInputSampling(false)
+  test:assertFalse(love.event.isInputSampling(), 'check disabled')
+end
+
+
 -- love.event.wait
 -- @NOTE not sure best way to test this one
 love.test.event.wait = function(test)
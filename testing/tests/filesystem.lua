@@ -352,6 +352,36 @@ love.test.filesystem.load = function(test)
 end
 
 
+-- love.filesystem.mapFile
+love.test.filesystem.mapFile = function(test)
+  love.filesystem.write('test.txt', 'helloworld')
+  -- check mapped contents match the file
+  local data = love.filesystem.mapFile('test.txt')
+  test:assertObject(data)
+  test:assertEquals('helloworld', data:getString(), 'check mapped contents')
+  test:assertEquals('test.txt', data:getFilename(), 'check filename')
+  -- check clones are independent of the mapping
+  local clone = data:clone()
+  data:release()
+  test:assertEquals('helloworld', clone:getString(), 'check clone contents')
+  -- check missing files fail
+  local missing, err = love.filesystem.mapFile('faker.txt')
+  test:assertEquals(nil, missing, 'check missing file')
+  test:assertNotEquals(nil, err, 'check error message')
+  love.filesystem.remove('test.txt')
+  -- check files stored in a mounted zip can be mapped too
+  local contents, size = love.filesystem.read('resources/test.zip') -- contains test.txt
+  love.filesystem.write('test.zip', contents, size)
+  love.filesystem.mount('test.zip', 'test')
+  local stored = love.filesystem.mapFile('test/test.txt')
+  test:assertObject(stored)
+  test:assertEquals(love.filesystem.read('test/test.txt'), stored:getString(), 'check stored contents')
+  stored:release()
+  love.filesystem.unmount('test.zip')
+  love.filesystem.remove('test.zip')
+end
+
+
 -- love.filesystem.mount
 love.test.filesystem.mount = function(test)
   -- write an example zip to savedir to use
@@ -371,6 +401,45 @@ love.test.filesystem.mount = function(test)
 end
 
 
+-- love.filesystem.mount (.lpk)
+love.test.filesystem.mountPack = function(test)
+  -- resources/test.lpk was built by lovepack and contains test.txt (stored)
+  -- and folder/repeat.txt (lz4 compressed)
+  local contents, size = love.filesystem.read('resources/test.lpk')
+  love.filesystem.write('test.lpk', contents, size)
+  test:assertTrue(love.filesystem.mount('test.lpk', 'pack'), 'check success')
+  -- check getInfo
+  test:assertEquals('directory', love.filesystem.getInfo('pack/folder').type, 'check directory type')
+  test:assertEquals('file', love.filesystem.getInfo('pack/test.txt').type, 'check file type')
+  test:assertEquals(10, love.filesystem.getInfo('pack/test.txt').size, 'check file size')
+  test:assertEquals(nil, love.filesystem.getInfo('pack/faker.txt'), 'check missing file')
+  -- check enumerate
+  local items = love.filesystem.getDirectoryItems('pack')
+  table.sort(items)
+  test:assertEquals(2, #items, 'check item count')
+  test:assertEquals('folder', items[1], 'check directory listed')
+  test:assertEquals('test.txt', items[2], 'check file listed')
+  -- check read of stored and compressed files
+  test:assertEquals('helloworld', love.filesystem.read('pack/test.txt'), 'check stored contents')
+  test:assertEquals(string.rep('helloworld', 64), love.filesystem.read('pack/folder/repeat.txt'), 'check compressed contents')
+  -- check mapFile
+  local mapped = love.filesystem.mapFile('pack/test.txt')
+  test:assertObject(mapped)
+  test:assertEquals('helloworld', mapped:getString(), 'check mapped contents')
+  mapped:release()
+  test:assertTrue(love.filesystem.unmount('test.lpk'), 'check unmount')
+  -- check a pack mounted from Data, named after a file on disk that isn't it
+  local data = love.filesystem.newFileData(contents, 'test.lpk')
+  test:assertTrue(love.filesystem.mount(data, 'main.lua', 'datapack'), 'check data mount')
+  test:assertEquals('helloworld', love.filesystem.read('datapack/test.txt'), 'check data contents')
+  local datamapped = love.filesystem.mapFile('datapack/test.txt')
+  test:assertEquals('helloworld', datamapped:getString(), 'check data mapped contents')
+  datamapped:release()
+  love.filesystem.unmount(data)
+  love.filesystem.remove('test.lpk')
+end
+
+
 -- love.filesystem.mountFullPath
 love.test.filesystem.mountFullPath = function(test)
   -- mount something in the working directory
@@ -486,6 +555,57 @@ love.test.filesystem.read = function(test)
 end
 
 
+-- love.filesystem.readAsync
+love.test.filesystem.readAsync = function(test)
+  -- check the read finishes with the file's contents
+  local op = love.filesystem.readAsync('resources/test.txt')
+  test:assertObject(op)
+  op:wait()
+  test:assertTrue(op:isComplete(), 'check read complete')
+  test:assertEquals(nil, op:getError(), 'check no error')
+  test:assertEquals('helloworld', op:getFileData():getString(), 'check content match')
+  -- check the operation is pushed to a channel once done
+  local channel = love.thread.newChannel()
+  love.filesystem.readAsync('resources/test.txt', channel)
+  local done = channel:demand(5)
+  test:assertNotEquals(nil, done, 'check channel notified')
+  test:assertEquals('resources/test.txt', done:getFilename(), 'check filename')
+  -- check missing files report an error
+  local missing = love.filesystem.readAsync('resources/missing.txt')
+  missing:wait()
+  test:assertNotEquals(nil, missing:getError(), 'check missing file error')
+  local ok = pcall(missing.getFileData, missing)
+  test:assertFalse(ok, 'check getFileData errors')
+end
+
+
+-- love.filesystem.readMany
+love.test.filesystem.readMany = function(test)
+  love.filesystem.write('test.txt', 'helloworld')
+  -- check contents come back in the order they were asked for
+  local contents = love.filesystem.readMany({'test.txt', 'resources/test.txt'})
+  test:assertNotEquals(nil, contents, 'check not nil')
+  test:assertEquals(2, #contents, 'check count')
+  test:assertEquals('helloworld', contents[1], 'check first content')
+  test:assertEquals(love.filesystem.read('resources/test.txt'), contents[2], 'check second content')
+  -- check files inside a mounted zip and data containers
+  local zip, size = love.filesystem.read('resources/test.zip') -- contains test.txt
+  love.filesystem.write('test.zip', zip, size)
+  love.filesystem.mount('test.zip', 'test')
+  local datas = love.filesystem.readMany('data', {'test/test.txt', 'test.txt'})
+  test:assertObject(datas[1])
+  test:assertEquals(love.filesystem.read('test/test.txt'), datas[1]:getString(), 'check zip content')
+  test:assertEquals('helloworld', datas[2]:getString(), 'check data content')
+  love.filesystem.unmount('test.zip')
+  love.filesystem.remove('test.zip')
+  -- check a missing file fails the whole batch
+  local missing, err = love.filesystem.readMany({'test.txt', 'faker.txt'})
+  test:assertEquals(nil, missing, 'check missing file')
+  test:assertNotEquals(nil, err, 'check error message')
+  love.filesystem.remove('test.txt')
+end
+
+
 -- love.filesystem.remove
 love.test.filesystem.remove = function(test)
   -- create a dir + subdir with a file
@@ -501,6 +621,78 @@ love.test.filesystem.remove = function(test)
 end
 
 
+-- love.filesystem.scanDirectory
+love.test.filesystem.scanDirectory = function(test)
+  -- create a dir + subdir with 2 files
+  love.filesystem.createDirectory('scan/bar')
+  love.filesystem.write('scan/file1.txt', 'file1')
+  love.filesystem.write('scan/bar/file2.png', 'file2')
+  -- check every item is found with its info, sorted by path
+  local entries = love.filesystem.scanDirectory('scan')
+  test:assertEquals(3, #entries, 'check entry count')
+  test:assertEquals('bar', entries[1].path, 'check dir path')
+  test:assertEquals('directory', entries[1].type, 'check dir type')
+  test:assertEquals('bar/file2.png', entries[2].path, 'check nested path')
+  test:assertEquals('file1.txt', entries[3].path, 'check file path')
+  test:assertEquals('file', entries[3].type, 'check file type')
+  test:assertEquals(5, entries[3].size, 'check file size')
+  test:assertNotEquals(nil, entries[3].modtime, 'check file modtime')
+  -- check glob filtering
+  local pngs = love.filesystem.scanDirectory('scan', '**/*.png')
+  test:assertEquals(1, #pngs, 'check glob count')
+  test:assertEquals('bar/file2.png', pngs[1].path, 'check glob match')
+  test:assertEquals(1, #love.filesystem.scanDirectory('scan', '*.txt'), 'check glob single level')
+  -- check scanning on the I/O thread
+  local channel = love.thread.newChannel()
+  local op = love.filesystem.scanDirectoryAsync('scan', nil, channel)
+  test:assertObject(op)
+  test:assertEquals(op, channel:demand(5), 'check channel notified')
+  test:assertEquals(3, #op:getDirectoryEntries(), 'check async entry count')
+  -- cleanup
+  love.filesystem.remove('scan/file1.txt')
+  love.filesystem.remove('scan/bar/file2.png')
+  love.filesystem.remove('scan/bar')
+  love.filesystem.remove('scan')
+end
+
+
+-- love.filesystem.setBytecodeCacheEnabled
+love.test.filesystem.setBytecodeCacheEnabled = function(test)
+  test:assertFalse(love.filesystem.isBytecodeCacheEnabled(), 'check disabled by default')
+  love.filesystem.setBytecodeCacheEnabled(true)
+  test:assertTrue(love.filesystem.isBytecodeCacheEnabled(), 'check enabled')
+  -- check the first require compiles and caches the module
+  love.filesystem.write('bytecodetest.lua', 'return 1 + 41')
+  test:assertEquals(42, require('bytecodetest'), 'check first require')
+  local cached = {}
+  for i=1,100 do
+    cached = love.filesystem.getDirectoryItems('.bytecodecache')
+    if #cached > 0 then break end
+    love.timer.sleep(0.02)
+  end
+  test:assertEquals(1, #cached, 'check bytecode cached')
+  -- check the cached bytecode gives the same result
+  package.loaded['bytecodetest'] = nil
+  test:assertEquals(42, require('bytecodetest'), 'check cached require')
+  -- check changed source isn't loaded from the old bytecode
+  package.loaded['bytecodetest'] = nil
+  love.filesystem.write('bytecodetest.lua', 'return 7')
+  test:assertEquals(7, require('bytecodetest'), 'check changed source')
+  package.loaded['bytecodetest'] = nil
+  love.filesystem.setBytecodeCacheEnabled(false)
+  -- let the second cache write finish before cleaning up
+  for i=1,100 do
+    if #love.filesystem.getDirectoryItems('.bytecodecache') > 1 then break end
+    love.timer.sleep(0.02)
+  end
+  for _, name in ipairs(love.filesystem.getDirectoryItems('.bytecodecache')) do
+    love.filesystem.remove('.bytecodecache/' .. name)
+  end
+  love.filesystem.remove('.bytecodecache')
+  love.filesystem.remove('bytecodetest.lua')
+end
+
+
 -- love.filesystem.setCRequirePath
 love.test.filesystem.setCRequirePath = function(test)
   -- check setting path val is returned
@@ -521,6 +713,95 @@ love.test.filesystem.setIdentity = function(test)
 end
 
 
+-- love.filesystem.setPathCacheEnabled
+love.test.filesystem.setPathCacheEnabled = function(test)
+  test:assertFalse(love.filesystem.isPathCacheEnabled(), 'check disabled by default')
+  love.filesystem.setPathCacheEnabled(true)
+  test:assertTrue(love.filesystem.isPathCacheEnabled(), 'check enabled')
+  -- check cached lookups see files created and removed afterwards
+  test:assertEquals(nil, love.filesystem.getInfo('cachetest/test.txt'), 'check missing')
+  love.filesystem.createDirectory('cachetest')
+  love.filesystem.write('cachetest/test.txt', 'helloworld')
+  test:assertEquals('file', love.filesystem.getInfo('cachetest/test.txt').type, 'check created')
+  love.filesystem.remove('cachetest/test.txt')
+  test:assertFalse(love.filesystem.exists('cachetest/test.txt'), 'check removed')
+  love.filesystem.remove('cachetest')
+  -- check disabling it
+  love.filesystem.setPathCacheEnabled(false)
+  test:assertFalse(love.filesystem.isPathCacheEnabled(), 'check disabled')
+  test:assertNotEquals(nil, love.filesystem.getInfo('resources/test.txt'), 'check uncached lookup')
+end
+
+
+-- love.filesystem.setReadRecording
+love.test.filesystem.setReadRecording = function(test)
+  test:assertEquals(nil, love.filesystem.getReadRecording(), 'check off by default')
+  test:assertEquals(nil, love.filesystem.prefetch('testlevel'), 'check nothing recorded')
+  -- check reads are recorded and saved once recording stops
+  love.filesystem.write('prefetch1.txt', 'one')
+  love.filesystem.write('prefetch2.txt', 'two')
+  love.filesystem.setReadRecording('testlevel')
+  test:assertEquals('testlevel', love.filesystem.getReadRecording(), 'check recording')
+  love.filesystem.read('prefetch1.txt')
+  love.filesystem.read('prefetch2.txt')
+  love.filesystem.read('prefetch1.txt')
+  love.filesystem.setReadRecording(nil)
+  test:assertEquals(nil, love.filesystem.getReadRecording(), 'check stopped')
+  local recording = '.readrecordings/testlevel.txt'
+  local contents = nil
+  for i=1,100 do
+    contents = love.filesystem.read(recording)
+    if contents ~= nil then break end
+    love.timer.sleep(0.02)
+  end
+  test:assertEquals('prefetch1.txt\nprefetch2.txt\n', contents, 'check recorded files')
+  -- check prefetched files are read with the same contents
+  local op = love.filesystem.prefetch('testlevel')
+  test:assertObject(op)
+  op:wait()
+  test:assertEquals(nil, op:getError(), 'check prefetch error')
+  test:assertEquals('testlevel', op:getFilename(), 'check prefetch tag')
+  test:assertEquals('one', love.filesystem.read('prefetch1.txt'), 'check prefetched 1')
+  test:assertEquals('two', love.filesystem.read('prefetch2.txt'), 'check prefetched 2')
+  -- check writes aren't hidden by prefetched contents
+  love.filesystem.prefetch('testlevel'):wait()
+  love.filesystem.write('prefetch1.txt', 'changed')
+  test:assertEquals('changed', love.filesystem.read('prefetch1.txt'), 'check write after prefetch')
+  local ok = pcall(love.filesystem.setReadRecording, '../escape')
+  test:assertFalse(ok, 'check invalid tag')
+  love.filesystem.remove('prefetch1.txt')
+  love.filesystem.remove('prefetch2.txt')
+  love.filesystem.remove(recording)
+  love.filesystem.remove('.readrecordings')
+end
+
+
+-- love.filesystem.setWatchEnabled
+love.test.filesystem.setWatchEnabled = function(test)
+  test:assertFalse(love.filesystem.isWatchEnabled(), 'check disabled by default')
+  if not love.filesystem.setWatchEnabled(true) then
+    return test:skipTest('watching not supported')
+  end
+  test:assertTrue(love.filesystem.isWatchEnabled(), 'check enabled')
+  -- check writing a file in the save directory reports a change
+  love.event.clear()
+  love.filesystem.write('watchtest.txt', 'helloworld')
+  local changed = nil
+  for i=1,100 do
+    for n, a, b in love.event.poll() do
+      if n == 'filechanged' and a == 'watchtest.txt' then changed = b end
+    end
+    if changed ~= nil then break end
+    love.timer.sleep(0.02)
+  end
+  test:assertNotEquals(nil, changed, 'check change reported')
+  love.filesystem.remove('watchtest.txt')
+  -- check disabling it
+  love.filesystem.setWatchEnabled(false)
+  test:assertFalse(love.filesystem.isWatchEnabled(), 'check disabled')
+end
+
+
 -- love.filesystem.setRequirePath
 love.test.filesystem.setRequirePath = function(test)
   -- check setting path val is returned
@@ -568,3 +849,37 @@ love.test.filesystem.write = function(test)
   love.filesystem.remove('test2.txt')
   love.filesystem.remove('test3.txt')
 end
+
+
+-- love.filesystem.commitAsync
+love.test.filesystem.commitAsync = function(test)
+  love.filesystem.write('commit1.txt', 'old')
+  -- check every file is replaced, including ones in new directories
+  local op = love.filesystem.commitAsync({
+    ['commit1.txt'] = 'hello',
+    ['commitdir/commit2.txt'] = love.data.newByteData('world')
+  })
+  op:wait()
+  test:assertEquals(nil, op:getError(), 'check no error')
+  test:assertEquals('hello', love.filesystem.read('commit1.txt'), 'check replaced file')
+  test:assertEquals('world', love.filesystem.read('commitdir/commit2.txt'), 'check new file')
+  test:assertEquals(nil, love.filesystem.getInfo('commit1.txt.commit~'), 'check no temp file left')
+  -- cleanup
+  love.filesystem.remove('commit1.txt')
+  love.filesystem.remove('commitdir/commit2.txt')
+  love.filesystem.remove('commitdir')
+end
+
+
+-- love.filesystem.writeAsync
+love.test.filesystem.writeAsync = function(test)
+  -- check writes and appends run in order
+  love.filesystem.writeAsync('test1.txt', 'hello')
+  local op = love.filesystem.appendAsync('test1.txt', love.data.newByteData('world'))
+  op:wait()
+  test:assertEquals(nil, op:getError(), 'check no error')
+  test:assertEquals(nil, op:getFileData(), 'check no data for writes')
+  test:assertEquals('helloworld', love.filesystem.read('test1.txt'), 'check read file')
+  -- cleanup
+  love.filesystem.remove('test1.txt')
+end
@@ -8,6 +8,61 @@
 --------------------------------------------------------------------------------
 
 
+-- Atlas (love.graphics.newAtlas)
+love.test.graphics.Atlas = function(test)
+
+  -- check settings
+  local atlas = love.graphics.newAtlas(64, 64, 2, {padding = 2})
+  test:assertObject(atlas)
+  local w, h = atlas:getDimensions()
+  test:assertEquals(64, w, 'check width')
+  test:assertEquals(64, h, 'check height')
+  test:assertEquals(2, atlas:getPageCount(), 'check page count')
+  test:assertEquals(2, atlas:getPadding(), 'check padding')
+  test:assertEquals('array', atlas:getTexture():getTextureType(), 'check array texture')
+  test:assertEquals(0, atlas:getImageCount(), 'check no images by def')
+
+  -- check images are packed with padding, and overflow onto the next page
+  local red = love.image.newImageData(16, 16)
+  red:mapPixel(function() return 1, 0, 0, 1 end)
+  local quad = atlas:add(red)
+  test:assertObject(quad)
+  local x, y, qw, qh = quad:getViewport()
+  test:assertEquals(2, x, 'check padded x')
+  test:assertEquals(2, y, 'check padded y')
+  test:assertEquals(16, qw, 'check quad width')
+  test:assertEquals(16, qh, 'check quad height')
+  test:assertEquals(1, quad:getLayer(), 'check first page')
+  local big = love.image.newImageData(60, 60)
+  local quads = atlas:add({big})
+  test:assertEquals(1, #quads, 'check list add')
+  test:assertEquals(2, quads[1]:getLayer(), 'check second page')
+  test:assertEquals(2, atlas:getImageCount(), 'check image count')
+  test:assertFalse(pcall(atlas.add, atlas, big), 'check full error')
+  local rg = love.image.newImageData(4, 4, 'rg8')
+  test:assertFalse(pcall(atlas.add, atlas, rg), 'check format error')
+
+  -- check page views
+  local page = atlas:getPageTexture(1)
+  test:assertEquals('2d', page:getTextureType(), 'check page view')
+  test:assertEquals(page, atlas:getPageTexture(1), 'check page view reused')
+
+  -- check drawing with the atlas samples the packed image
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(atlas, quad, -1, -1, 0, 18/16, 18/16)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b = imgdata:getPixel(8, 8)
+  test:assertEquals(1, r, 'check drawn red')
+  test:assertEquals(0, g, 'check drawn green')
+  r, g, b = imgdata:getPixel(0, 0)
+  test:assertEquals(1, r, 'check edge red')
+
+end
+
+
 -- GraphicsBuffer (love.graphics.newBuffer)
 love.test.graphics.Buffer = function(test)
 
@@ -44,6 +99,18 @@ love.test.graphics.Buffer = function(test)
   vertexbuffer1:setArrayData(flatvertexdata)
   vertexbuffer1:clear(8, 8) -- partial clear (the first texcoord)
 
+  -- check mapping a range of the buffer for writing
+  local mapped, mapcount = vertexbuffer1:map(2, 2)
+  test:assertEquals(2, mapcount, 'check mapped element count')
+  test:assertTrue(vertexbuffer1:isMapped(), 'check buffer is mapped')
+  test:assertFalse(pcall(vertexbuffer1.map, vertexbuffer1), 'check mapping twice fails')
+  if type(mapped) == 'cdata' then
+    mapped[0].VertexPosition[0] = 5
+    mapped[1].VertexColor[3] = 255
+  end
+  vertexbuffer1:unmap()
+  test:assertFalse(vertexbuffer1:isMapped(), 'check buffer is unmapped')
+
   -- check buffer types
   test:assertTrue(vertexbuffer1:isBufferType('vertex'), 'check is vertex buffer')
   test:assertFalse(vertexbuffer1:isBufferType('index'), 'check is not index buffer')
@@ -257,6 +324,136 @@ love.test.graphics.Canvas = function(test)
     test:assertTrue(ccanvas:isComputeWritable())
   end
 
+  -- check transient render targets
+  local tcanvas = love.graphics.newCanvas(16, 16, {
+    format = 'depth24',
+    transient = true
+  })
+  test:assertTrue(tcanvas:isTransient(), 'check transient set')
+  test:assertFalse(tcanvas:isReadable(), 'check transient not readable by def')
+  test:assertFalse(canvas:isTransient(), 'check transient false by def')
+  local rcanvas = love.graphics.newCanvas(16, 16)
+  love.graphics.push("all")
+    love.graphics.setCanvas({rcanvas, depthstencil = tcanvas})
+    love.graphics.clear(1, 0, 0, 1)
+    love.graphics.setDepthMode('less', true)
+    love.graphics.rectangle('fill', 0, 0, 16, 16)
+  love.graphics.pop()
+  local r, g, b, a = love.graphics.readbackTexture(rcanvas):getPixel(8, 8)
+  test:assertEquals(1, r, 'check drawing with transient depth')
+  local ok = pcall(love.graphics.newCanvas, 16, 16, { transient = true, readable = true })
+  test:assertFalse(ok, 'check transient readable without msaa errors')
+  ok = pcall(love.graphics.newTexture, 16, 16, { transient = true })
+  test:assertFalse(ok, 'check transient non-canvas errors')
+
+end
+
+
+-- DrawList (love.graphics.newDrawList)
+love.test.graphics.DrawList = function(test)
+
+  -- check nothing is recorded by default
+  local list = love.graphics.newDrawList()
+  test:assertObject(list)
+  test:assertFalse(list:isRecording(), 'check not recording')
+  test:assertEquals(0, list:getDrawCallCount(), 'check no draw calls')
+  test:assertEquals(0, list:getVertexCount(), 'check no vertices')
+
+  -- record some shapes, recorded geometry shouldn't be drawn immediately
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    list:beginRecording()
+      test:assertTrue(list:isRecording(), 'check recording')
+      love.graphics.setColor(1, 0, 0, 1)
+      love.graphics.rectangle('fill', 0, 0, 8, 8)
+      love.graphics.setColor(0, 0, 1, 1)
+      love.graphics.rectangle('fill', 8, 8, 8, 8)
+      love.graphics.setColor(1, 1, 1, 1)
+    list:endRecording()
+  love.graphics.setCanvas()
+  test:assertFalse(list:isRecording(), 'check recording ended')
+  test:assertEquals(1, list:getDrawCallCount(), 'check draws merged')
+  test:assertEquals(8, list:getVertexCount(), 'check vertex count')
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r1, g1, b1 = imgdata:getPixel(2, 2)
+  test:assertEquals(0, r1, 'check not drawn while recording')
+
+  -- check replaying draws the recorded geometry with the current transform
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(list, 0, 0)
+  love.graphics.setCanvas()
+  imgdata = love.graphics.readbackTexture(canvas)
+  r1, g1, b1 = imgdata:getPixel(2, 2)
+  local r2, g2, b2 = imgdata:getPixel(12, 12)
+  local r3, g3, b3 = imgdata:getPixel(12, 2)
+  test:assertEquals(1, r1, 'check first rectangle')
+  test:assertEquals(1, b2, 'check second rectangle')
+  test:assertEquals(0, r3 + g3 + b3, 'check empty area')
+
+  -- draws which can't be batched aren't allowed while recording
+  local mesh = love.graphics.newMesh({{0, 0}, {1, 0}, {1, 1}}, 'triangles')
+  list:beginRecording()
+    test:assertFalse(pcall(love.graphics.draw, mesh), 'check mesh error')
+    test:assertFalse(pcall(love.graphics.draw, list), 'check drawlist error')
+    test:assertFalse(pcall(list.clear, list), 'check clear error')
+  list:endRecording()
+  test:assertEquals(0, list:getVertexCount(), 'check recording restarted')
+  test:assertFalse(pcall(list.endRecording, list), 'check end error')
+
+end
+
+
+-- DynamicResolution (love.graphics.newDynamicResolution)
+love.test.graphics.DynamicResolution = function(test)
+
+  -- check settings
+  local dr = love.graphics.newDynamicResolution({
+    minscale = 0.25, maxscale = 1, upscaler = 'sharpen', sharpness = 0.75
+  })
+  test:assertObject(dr)
+  local minscale, maxscale = dr:getScaleRange()
+  test:assertEquals(0.25, minscale, 'check min scale')
+  test:assertEquals(1, maxscale, 'check max scale')
+  test:assertEquals(1, dr:getScale(), 'check starts at max scale')
+  test:assertEquals('sharpen', dr:getUpscaler(), 'check upscaler')
+  test:assertEquals(0.75, dr:getSharpness(), 'check sharpness')
+  test:assertFalse(dr:isInFrame(), 'check not in frame by def')
+  test:assertFalse(pcall(dr.setScaleRange, dr, 1, 0.5), 'check range error')
+  test:assertFalse(pcall(dr.setTargetFrameTime, dr, 0), 'check frame time error')
+  test:assertFalse(pcall(dr.setUpscaler, dr, 'cubic'), 'check upscaler error')
+
+  -- check the scale is clamped to the range
+  dr:setScale(0.1)
+  test:assertEquals(0.25, dr:getScale(), 'check scale clamped')
+  dr:setScale(0.5)
+  test:assertEquals(0.5, dr:getScale(), 'check scale set')
+
+  -- check a frame renders at the scaled resolution
+  local rw, rh
+  love.graphics.push('all')
+    dr:beginFrame()
+      test:assertTrue(dr:isInFrame(), 'check in frame')
+      test:assertFalse(pcall(dr.beginFrame, dr), 'check nested begin error')
+      rw, rh = dr:getRenderDimensions()
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.rectangle('fill', 0, 0, 16, 16)
+    dr:endFrame()
+    test:assertFalse(dr:isInFrame(), 'check frame ended')
+    test:assertEquals(nil, love.graphics.getCanvas(), 'check screen restored')
+  love.graphics.pop()
+  local pw, ph = love.graphics.getPixelDimensions()
+  test:assertRange(rw, math.floor(pw * 0.5) - 1, math.ceil(pw * 0.5) + 1, 'check render width')
+  test:assertRange(rh, math.floor(ph * 0.5) - 1, math.ceil(ph * 0.5) + 1, 'check render height')
+  test:assertFalse(pcall(dr.endFrame, dr), 'check end without begin error')
+
+  -- frames can only be scaled when rendering to the screen
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    test:assertFalse(pcall(dr.beginFrame, dr), 'check canvas error')
+  love.graphics.setCanvas()
+
 end
 
 
@@ -303,6 +500,19 @@ love.test.graphics.Font = function(test)
   test:assertEquals(8, #wrappedtext, 'check wrapped lines')
   test:assertEquals('LÖVE is an ', wrappedtext[1], 'check wrapped line')
 
+  -- check repeated wrapping and measuring give the same results
+  local width2, wrappedtext2 = font:getWrap('LÖVE is an *awesome* framework you can use to make 2D games in Lua.', 50)
+  test:assertEquals(width, width2, 'check repeated wrap width')
+  test:assertEquals(#wrappedtext, #wrappedtext2, 'check repeated wrapped lines')
+  local _, unwrappedtext = font:getWrap('LÖVE is an *awesome* framework you can use to make 2D games in Lua.', 1000)
+  test:assertEquals(1, #unwrappedtext, 'check wrap with different limit')
+  test:assertEquals(24, font:getWidth('test'), 'check repeated width')
+
+  -- check long ascii runs and mixed text decode the same as short ones
+  test:assertEquals(240, font:getWidth(string.rep('test', 10)), 'check long ascii width')
+  test:assertEquals(font:getWidth('Ö') + 240, font:getWidth('Ö' .. string.rep('test', 10)), 'check mixed width')
+  test:assertFalse(pcall(font.getWidth, font, string.rep('test', 10) .. '\255'), 'check invalid utf-8 error')
+
   -- check drawing font 
   local canvas = love.graphics.newCanvas(16, 16)
   love.graphics.setCanvas(canvas)
@@ -312,6 +522,97 @@ love.test.graphics.Font = function(test)
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
 
+  -- adding more glyphs to the atlas shouldn't change existing ones
+  local glyphs = {}
+  for c=33,126 do
+    glyphs[#glyphs+1] = string.char(c)
+  end
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.print(table.concat(glyphs), 0, 0)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.print('Aa', 0, 5)
+  love.graphics.setCanvas()
+  local imgdata3 = love.graphics.readbackTexture(canvas)
+  local matching = true
+  for x=0,15 do
+    for y=0,15 do
+      local r1, g1, b1, a1 = imgdata:getPixel(x, y)
+      local r2, g2, b2, a2 = imgdata3:getPixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        matching = false
+      end
+    end
+  end
+  test:assertTrue(matching, 'check glyphs unchanged after atlas growth')
+
+  -- text drawn again in later frames reuses its vertices, which must not
+  -- outlive changes to the layout
+  local function drawlines()
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.print('A\nA', 0, 0)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(canvas)
+  end
+  local function sameimg(a, b)
+    for x=0,15 do
+      for y=0,15 do
+        local r1, g1, b1, a1 = a:getPixel(x, y)
+        local r2, g2, b2, a2 = b:getPixel(x, y)
+        if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+          return false
+        end
+      end
+    end
+    return true
+  end
+  local lines1 = drawlines()
+  test:waitFrames(1)
+  test:assertTrue(sameimg(lines1, drawlines()), 'check reused text matches')
+  font:setLineHeight(2)
+  test:assertFalse(sameimg(lines1, drawlines()), 'check line height change redraws text')
+  font:setLineHeight(1)
+  test:assertTrue(sameimg(lines1, drawlines()), 'check line height reset')
+
+  -- check prewarming glyphs
+  test:assertFalse(font:prewarm('Aa', false), 'check sync prewarm finished')
+  font:prewarm(0x20, 0x7E)
+  local frames = 0
+  while font:isPrewarming() and frames < 60 do
+    test:waitFrames(1)
+    frames = frames + 1
+  end
+  test:assertFalse(font:isPrewarming(), 'check async prewarm finished')
+
+  -- check distance field fonts draw with the sdf shader
+  test:assertFalse(font:isSDF(), 'check regular font')
+  local sdffont = love.graphics.newFont('resources/font.ttf', 16, {sdf = true})
+  test:assertTrue(sdffont:isSDF(), 'check sdf font')
+  test:assertEquals('linear', sdffont:getFilter(), 'check sdf filter')
+  local sdfcanvas = love.graphics.newCanvas(64, 64)
+  love.graphics.setCanvas(sdfcanvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.setFont(sdffont)
+    love.graphics.print('A', 0, 0, 0, 3, 3)
+  love.graphics.setCanvas()
+  local sdfdata = love.graphics.readbackTexture(sdfcanvas)
+  local opaque, partial = 0, 0
+  for x=0,63 do
+    for y=0,63 do
+      local _, _, _, alpha = sdfdata:getPixel(x, y)
+      if alpha == 1 then
+        opaque = opaque + 1
+      elseif alpha > 0 then
+        partial = partial + 1
+      end
+    end
+  end
+  test:assertGreaterEqual(1, opaque, 'check sdf glyph has solid pixels')
+  -- edges should stay thin when scaled, rather than being a blurry ramp
+  test:assertTrue(partial < opaque, 'check sdf glyph edges are sharp')
+  love.graphics.setFont(font)
+
   -- check font substitution
   local fontab = love.graphics.newImageFont('resources/font-letters-ab.png', 'AB')
   local fontcd = love.graphics.newImageFont('resources/font-letters-cd.png', 'CD')
@@ -325,6 +626,121 @@ love.test.graphics.Font = function(test)
   local imgdata2 = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata2)
 
+  -- check glyph lookups through fallbacks, with a second font sharing them
+  local fontab2 = love.graphics.newImageFont('resources/font-letters-ab.png', 'AB')
+  fontab2:setFallbacks(fontcd)
+  for _, f in ipairs({fontab, fontab2}) do
+    test:assertTrue(f:hasGlyphs('ABCD'), 'check fallback glyphs')
+    test:assertFalse(f:hasGlyphs('E'), 'check missing glyph')
+    test:assertEquals(fontcd:getWidth('CD'), f:getWidth('CD'), 'check fallback width')
+  end
+  fontab2:setFallbacks()
+  test:assertFalse(fontab2:hasGlyphs('C'), 'check fallbacks removed')
+  test:assertTrue(fontab:hasGlyphs('C'), 'check other font unaffected')
+
+end
+
+
+-- FrameCapture (love.graphics.newFrameCapture)
+love.test.graphics.FrameCapture = function(test)
+
+  -- check nothing is captured by default
+  local capture = love.graphics.newFrameCapture()
+  test:assertObject(capture)
+  test:assertFalse(capture:isCapturing(), 'check not capturing')
+  test:assertEquals(0, capture:getCommandCount(), 'check no commands')
+
+  -- capture a clear and some shapes, which should still be drawn
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    capture:beginCapture()
+      test:assertTrue(capture:isCapturing(), 'check capturing')
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.setColor(1, 0, 0, 1)
+      love.graphics.rectangle('fill', 0, 0, 8, 8)
+      love.graphics.setBlendMode('add')
+      love.graphics.setColor(0, 0, 1, 1)
+      love.graphics.rectangle('fill', 0, 0, 8, 8)
+      love.graphics.setBlendMode('alpha')
+      love.graphics.setColor(1, 1, 1, 1)
+    capture:endCapture()
+  love.graphics.setCanvas()
+  test:assertFalse(capture:isCapturing(), 'check capture ended')
+  test:assertEquals(3, capture:getCommandCount(), 'check command count')
+  local cmdtype, time = capture:getCommand(1)
+  test:assertEquals('clear', cmdtype, 'check clear command')
+  test:assertEquals(nil, time, 'check no time before replay')
+  test:assertEquals('batch', capture:getCommand(2), 'check batch command')
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b = imgdata:getPixel(2, 2)
+  test:assertEquals(1, r, 'check drawn while capturing')
+  test:assertEquals(1, b, 'check blend state while capturing')
+
+  -- check replaying restores the captured state and canvas
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 1, 0, 1)
+  love.graphics.setCanvas()
+  local total = capture:replay()
+  test:assertNotEquals(nil, total, 'check replay time')
+  imgdata = love.graphics.readbackTexture(canvas)
+  r, g, b = imgdata:getPixel(2, 2)
+  local r2, g2, b2 = imgdata:getPixel(12, 12)
+  test:assertEquals(1, r, 'check replayed first rectangle')
+  test:assertEquals(1, b, 'check replayed blend state')
+  test:assertEquals(0, g2, 'check replayed clear')
+  test:assertNotEquals(nil, select(2, capture:getCommand(1)), 'check command time')
+  test:assertEquals('alpha', love.graphics.getBlendMode(), 'check state restored')
+  test:assertEquals(nil, love.graphics.getCanvas(), 'check canvas restored')
+
+  -- check the summary can be saved
+  capture:save('framecapture.txt')
+  test:assertNotEquals(nil, love.filesystem.getInfo('framecapture.txt'), 'check saved')
+  love.filesystem.remove('framecapture.txt')
+
+  -- only one capture can be active, and it can't be cleared or replayed
+  local other = love.graphics.newFrameCapture()
+  capture:beginCapture()
+    test:assertFalse(pcall(other.beginCapture, other), 'check single capture')
+    test:assertFalse(pcall(capture.clear, capture), 'check clear error')
+    test:assertFalse(pcall(other.replay, other), 'check replay error')
+  capture:endCapture()
+  test:assertEquals(0, capture:getCommandCount(), 'check capture restarted')
+  test:assertFalse(pcall(capture.endCapture, capture), 'check end error')
+
+end
+
+
+-- GraphicsReadback (love.graphics.readbackTextureAsync)
+love.test.graphics.GraphicsReadback = function(test)
+
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas()
+
+  -- check readback into an imagedata
+  local readback = love.graphics.readbackTextureAsync(canvas)
+  test:assertObject(readback)
+  readback:wait()
+  test:assertTrue(readback:isComplete(), 'check complete')
+  test:assertFalse(readback:hasError(), 'check no error')
+  local r, g, b, a = readback:getImageData():getPixel(0, 0)
+  test:assertEquals(1, r, 'check imagedata r')
+  test:assertEquals(0, g, 'check imagedata g')
+
+  -- check readback directly into a bytedata, with a completion callback
+  local bytes = love.data.newByteData(16*16*4*2)
+  local called = nil
+  local readback2 = love.graphics.readbackTextureAsync(canvas, nil, 1, 0, 0, 16, 16, bytes, 16*16*4)
+  readback2:setCallback(function(rb) called = rb end)
+  readback2:wait()
+  test:assertEquals(readback2, called, 'check callback called')
+  test:assertEquals(bytes, readback2:getBufferData(), 'check bytedata dest')
+  test:assertEquals(nil, readback2:getImageData(), 'check no imagedata')
+  local br, bg = love.data.unpack('BB', bytes, 16*16*4 + 1)
+  test:assertEquals(255, br, 'check bytedata r')
+  test:assertEquals(0, bg, 'check bytedata g')
+
 end
 
 
@@ -427,6 +843,45 @@ love.test.graphics.Image = function(test)
   test:assertEquals(3, r1+g1+b1, 'check back to white')
   test:compareImg(imgdata)
 
+  -- check async pixel replacement
+  local aimage = love.graphics.newImage('resources/love.png')
+  local upload = aimage:replacePixelsAsync(rimage)
+  test:assertObject(upload)
+  test:assertEquals(aimage, upload:getTexture(), 'check upload texture')
+  upload:wait()
+  test:assertTrue(upload:isComplete(), 'check upload complete')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(aimage, 0, 0)
+  love.graphics.setCanvas()
+  local adata = love.graphics.readbackTexture(canvas)
+  local r2, g2, b2 = adata:getPixel(25, 25)
+  test:assertEquals(r1 + g1 + b1, r2 + g2 + b2, 'check async upload matches')
+
+  -- check palette lookups for r8 index textures
+  local indexdata = love.image.newImageData(2, 1, 'r8')
+  indexdata:setPixel(1, 0, 1 / 255, 0, 0, 1)
+  local paldata = love.image.newImageData(2, 1, 'rgba8')
+  paldata:setPixel(0, 0, 0, 0, 1, 1)
+  paldata:setPixel(1, 0, 0, 1, 0, 1)
+  local indeximage = love.graphics.newImage(indexdata)
+  local palimage = love.graphics.newImage(paldata)
+  test:assertEquals(nil, indeximage:getPalette(), 'check no palette')
+  indeximage:setPalette(palimage)
+  test:assertEquals(palimage, indeximage:getPalette(), 'check palette set')
+  test:assertFalse(pcall(image.setPalette, image, palimage), 'check palette needs r8')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(indeximage, 0, 0)
+  love.graphics.setCanvas()
+  local pdata = love.graphics.readbackTexture(canvas)
+  local pr0, pg0, pb0 = pdata:getPixel(0, 0)
+  local pr1, pg1, pb1 = pdata:getPixel(1, 0)
+  test:assertEquals(1, pb0 - pr0 - pg0, 'check palette index 0')
+  test:assertEquals(1, pg1 - pr1 - pb1, 'check palette index 1')
+  indeximage:setPalette(nil)
+  test:assertEquals(nil, indeximage:getPalette(), 'check palette cleared')
+
 end
 
 
@@ -527,6 +982,17 @@ love.test.graphics.Mesh = function(test)
   test:assertEquals(4, #vmap2, 'check set map len')
   test:assertEquals(2, vmap2[3], 'check set map val')
 
+  -- check writing vertices through a mapped pointer, when the FFI is available
+  local vertexptr, mapcount = mesh1:mapVertices(2, 2)
+  test:assertEquals(2, mapcount, 'check mapped vertex count')
+  if type(vertexptr) == 'cdata' then
+    vertexptr[1].VertexPosition[0] = 5
+    vertexptr[1].VertexColor[1] = 128
+    local x7, _, _, _, _, g7 = mesh1:getVertex(3)
+    test:assertEquals(5, x7, 'check mapped vertex x')
+    test:assertRange(g7, 0.5, 0.51, 'check mapped vertex g')
+  end
+
   -- check using custom attributes
   local mesh2 = love.graphics.newMesh({
     { name = 'VertexPosition', format = 'floatvec2', location = 0},
@@ -555,6 +1021,125 @@ love.test.graphics.Mesh = function(test)
   mesh1:detachAttribute('VertexPosition')
   test:assertTrue(mesh1:isAttributeEnabled('VertexPosition'), 'check cant detach def attribute')
 
+  -- check optimizing keeps the same triangles
+  local gridverts, gridmap = {}, {}
+  for y = 0, 8 do
+    for x = 0, 8 do
+      table.insert(gridverts, { x, y, x + y * 9, 0 })
+    end
+  end
+  for y = 0, 7 do
+    for x = 7, 0, -1 do
+      local i = y * 9 + x + 1
+      table.insert(gridmap, 1, i + 9); table.insert(gridmap, 1, i + 1); table.insert(gridmap, 1, i)
+      table.insert(gridmap, i + 1); table.insert(gridmap, i + 9); table.insert(gridmap, i + 10)
+    end
+  end
+  local mesh3 = love.graphics.newMesh({
+    { name = 'VertexPosition', format = 'floatvec3' },
+    { name = 'VertexTexCoord', format = 'floatvec2' },
+  }, gridverts, 'triangles', 'static')
+  mesh3:setVertexMap(gridmap)
+  local function gettriangles(mesh)
+    local tris = {}
+    local map = mesh:getVertexMap()
+    for i = 1, #map, 3 do
+      local ids = {}
+      for j = 0, 2 do
+        local _, _, _, id = mesh:getVertex(map[i + j])
+        ids[j + 1] = id
+      end
+      table.sort(ids)
+      table.insert(tris, table.concat(ids, ','))
+    end
+    table.sort(tris)
+    return table.concat(tris, ';')
+  end
+  local trisbefore = gettriangles(mesh3)
+  local missbefore, missafter = mesh3:optimize()
+  test:assertEquals(trisbefore, gettriangles(mesh3), 'check optimized triangles')
+  test:assertTrue(missafter <= missbefore, 'check optimized cache misses')
+  test:assertEquals(#gridmap, #mesh3:getVertexMap(), 'check optimized vertex map length')
+  mesh3:setDrawRange(1, 6)
+  test:assertFalse(pcall(mesh3.optimize, mesh3), 'check optimize with draw range')
+
+  -- check skinning with a bone buffer
+  if love.graphics.getSupported().texelbuffer then
+    test:assertFalse(pcall(mesh3.setBoneBuffer, mesh3, love.graphics.newBuffer('float', 4, {texel=true})), 'check bone buffer format')
+    local bones = love.graphics.newBuffer('floatvec4', 3, {texel=true})
+    bones:setArrayData({ {1, 0, 0, 8}, {0, 1, 0, 0}, {0, 0, 1, 0} })
+    local skinned = love.graphics.newMesh({
+      { name = 'VertexPosition', format = 'floatvec2' },
+      { name = 'love_BoneIndices', format = 'floatvec4' },
+      { name = 'love_BoneWeights', format = 'floatvec4' },
+    }, {
+      { 0, 0, 0, 0, 0, 0, 1, 0, 0, 0 },
+      { 8, 0, 0, 0, 0, 0, 1, 0, 0, 0 },
+      { 8, 8, 0, 0, 0, 0, 1, 0, 0, 0 },
+      { 0, 8, 0, 0, 0, 0, 1, 0, 0, 0 },
+    }, 'fan')
+    skinned:setBoneBuffer(bones)
+    test:assertEquals(bones, skinned:getBoneBuffer(), 'check bone buffer set')
+    local canvas = love.graphics.newCanvas(16, 16)
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.draw(skinned)
+    love.graphics.setCanvas()
+    local imgdata = love.graphics.readbackTexture(canvas)
+    test:assertEquals(0, imgdata:getPixel(4, 4), 'check skinned mesh moved')
+    test:assertEquals(1, imgdata:getPixel(12, 4), 'check skinned mesh drawn')
+    skinned:setBoneBuffer(nil)
+    test:assertEquals(nil, skinned:getBoneBuffer(), 'check bone buffer removed')
+  end
+
+end
+
+
+-- OcclusionQuery (love.graphics.newOcclusionQuery)
+love.test.graphics.OcclusionQuery = function(test)
+  if not love.graphics.getSupported().occlusionquery then
+    test:skipTest('occlusion queries are not supported on this system')
+    return
+  end
+
+  local query = love.graphics.newOcclusionQuery()
+  test:assertObject(query)
+  test:assertFalse(query:isActive(), 'check not active by def')
+  test:assertEquals(nil, query:getResult(), 'check no result by def')
+
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.push("all")
+    love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.beginOcclusionQuery(query)
+    test:assertTrue(query:isActive(), 'check active')
+    test:assertEquals(query, love.graphics.getActiveOcclusionQuery(), 'check active query')
+    local ok = pcall(love.graphics.beginOcclusionQuery, query)
+    test:assertFalse(ok, 'check nested begin errors')
+    love.graphics.rectangle('fill', 0, 0, 8, 16)
+    love.graphics.endOcclusionQuery()
+    test:assertFalse(query:isActive(), 'check not active after end')
+    test:assertEquals(nil, love.graphics.getActiveOcclusionQuery(), 'check no active query')
+
+    -- the query saw samples pass, so conditional draws must still happen
+    love.graphics.beginConditionalRender(query)
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.rectangle('fill', 8, 0, 8, 16)
+    love.graphics.endConditionalRender()
+  love.graphics.pop()
+
+  local ok = pcall(love.graphics.endOcclusionQuery)
+  test:assertFalse(ok, 'check end without begin errors')
+  ok = pcall(love.graphics.endConditionalRender)
+  test:assertFalse(ok, 'check end conditional without begin errors')
+
+  local r, g, b, a = love.graphics.readbackTexture(canvas):getPixel(12, 8)
+  test:assertEquals(1, r, 'check conditional draw happened')
+
+  local result = query:getResult()
+  if result ~= nil then
+    test:assertTrue(result, 'check samples passed')
+  end
 end
 
 
@@ -757,6 +1342,44 @@ love.test.graphics.ParticleSystem = function(test)
   psystem:setTexture(love.graphics.newImage('resources/love.png'))
   test:assertObject(psystem:getTexture())
 
+  -- check insert modes with a system big enough to be updated across threads
+  local psystem4 = love.graphics.newParticleSystem(image, 20000)
+  psystem4:setParticleLifetime(2, 2)
+  psystem4:setInsertMode('bottom')
+  psystem4:emit(5000)
+  psystem4:setInsertMode('random')
+  psystem4:emit(5000)
+  psystem4:setInsertMode('top')
+  psystem4:emit(10000)
+  test:assertTrue(psystem4:isFull(), 'check full')
+  psystem4:update(1)
+  test:assertEquals(20000, psystem4:getCount(), 'check large update kept particles')
+  psystem4:update(1.5)
+  test:assertEquals(0, psystem4:getCount(), 'check large update removed particles')
+
+  -- check extra emitters sharing one system's settings and particle buffer
+  local group = love.graphics.newParticleSystem(image, 1000)
+  group:setParticleLifetime(5, 5)
+  group:setEmissionRate(10)
+  group:stop()
+  local e1 = group:addEmitter(10, 10)
+  local e2 = group:addEmitter(50, 50)
+  test:assertEquals(2, group:getEmitterCount(), 'check emitter count')
+  group:update(1)
+  test:assertRange(group:getCount(), 18, 20, 'check emitters emitted')
+  group:moveEmitter(e2, 60, 50)
+  test:assertEquals(60, select(1, group:getEmitterPosition(e2)), 'check emitter moved')
+  group:setEmitterActive(e1, false)
+  test:assertFalse(group:isEmitterActive(e1), 'check emitter stopped')
+  local before = group:getCount()
+  group:update(1)
+  test:assertRange(group:getCount() - before, 9, 10, 'check stopped emitter')
+  group:removeEmitter(e1)
+  test:assertEquals(1, group:getEmitterCount(), 'check emitter removed')
+  test:assertEquals(e1, group:addEmitter(0, 0), 'check emitter id reused')
+  group:reset()
+  test:assertEquals(0, group:getCount(), 'check emitters reset')
+
   -- try a graphics test!
   -- hard to get exactly because of the variation but we can use some pixel 
   -- tolerance and volume to try and cover the randomness
@@ -818,6 +1441,80 @@ love.test.graphics.Quad = function(test)
 end
 
 
+-- RenderGraph (love.graphics.newRenderGraph)
+love.test.graphics.RenderGraph = function(test)
+
+  -- check passes are reordered, merged and culled
+  local graph = love.graphics.newRenderGraph()
+  test:assertObject(graph)
+  local target = love.graphics.newCanvas(16, 16)
+  graph:addTransientCanvas('bloom', 16, 16)
+  graph:addTransientCanvas('blur', 16, 16)
+  local order = {}
+  graph:addPass('scene', {canvas = target, clear = {0, 0, 1, 1}}, function()
+    table.insert(order, 'scene')
+  end)
+  graph:addPass('bloom', {canvas = 'bloom', clear = {1, 0, 0, 1}}, function()
+    table.insert(order, 'bloom')
+  end)
+  graph:addPass('overlay', {canvas = target}, function()
+    table.insert(order, 'overlay')
+    love.graphics.setColor(0, 1, 0, 1)
+    love.graphics.rectangle('fill', 0, 0, 4, 4)
+    love.graphics.setColor(1, 1, 1, 1)
+  end)
+  graph:addPass('composite', {canvas = target, reads = {'bloom'}}, function(g)
+    table.insert(order, 'composite')
+    love.graphics.draw(g:getCanvas('bloom'), 8, 0)
+  end)
+  graph:addPass('blur', {canvas = 'blur', reads = 'bloom'}, function()
+    table.insert(order, 'blur')
+  end)
+  test:assertEquals(5, graph:getPassCount(), 'check pass count')
+  local stats = graph:getStats()
+  test:assertEquals(4, stats.passes, 'check executed passes')
+  test:assertEquals(1, stats.culledpasses, 'check unused pass culled')
+  test:assertEquals(1, stats.mergedpasses, 'check merged passes')
+  test:assertEquals(1, stats.transienttextures, 'check transient textures')
+  test:assertEquals(nil, graph:getCanvas('blur'), 'check unused canvas')
+  graph:execute()
+  test:assertEquals('scene,overlay,bloom,composite', table.concat(order, ','), 'check pass order')
+  test:assertEquals('scene,overlay,bloom,composite', table.concat(graph:getExecutionOrder(), ','), 'check execution order')
+  test:assertEquals(nil, love.graphics.getCanvas(), 'check canvas restored')
+  local imgdata = love.graphics.readbackTexture(target)
+  local r1, g1, b1 = imgdata:getPixel(1, 1)
+  local r2, g2, b2 = imgdata:getPixel(12, 12)
+  local r3, g3, b3 = imgdata:getPixel(4, 12)
+  test:assertEquals(1, g1, 'check overlay pass')
+  test:assertEquals(1, r2, 'check composite pass')
+  test:assertEquals(1, b3, 'check scene pass')
+
+  -- check transient canvases with separate lifetimes share a texture
+  local graph2 = love.graphics.newRenderGraph()
+  graph2:addTransientCanvas('x', 16, 16)
+  graph2:addTransientCanvas('y', 16, 16)
+  graph2:addPass('drawx', {canvas = 'x', clear = true}, function() end)
+  graph2:addPass('usex', {canvas = target, reads = 'x'}, function() end)
+  graph2:addPass('drawy', {canvas = 'y', clear = true}, function() end)
+  graph2:addPass('usey', {canvas = target, reads = 'y'}, function() end)
+  test:assertEquals(1, graph2:getStats().transienttextures, 'check aliased textures')
+  test:assertEquals(graph2:getCanvas('x'), graph2:getCanvas('y'), 'check same texture')
+
+  -- check errors
+  test:assertFalse(pcall(graph2.addPass, graph2, 'bad', {canvas = 'missing'}, function() end), 'check unknown canvas')
+  test:assertFalse(pcall(graph2.addTransientCanvas, graph2, 'x', 16, 16), 'check duplicate canvas')
+  graph2:addPass('nested', {}, function(g)
+    test:assertTrue(g:isExecuting(), 'check executing')
+    g:execute()
+  end)
+  test:assertFalse(pcall(graph2.execute, graph2), 'check nested execute')
+  test:assertFalse(graph2:isExecuting(), 'check not executing')
+  graph2:reset()
+  test:assertEquals(0, graph2:getPassCount(), 'check reset')
+
+end
+
+
 -- Shader (love.graphics.newShader)
 love.test.graphics.Shader = function(test)
 
@@ -841,6 +1538,13 @@ love.test.graphics.Shader = function(test)
   test:assertTrue(shader1:hasUniform('tex2'), 'check valid uniform')
   test:assertEquals('testshader', shader1:getDebugName())
 
+  -- check async compiled shader
+  local asyncshader = love.graphics.newShader(pixelcode1, vertexcode1, {async = true})
+  test:assertObject(asyncshader)
+  test:assertEquals('boolean', type(asyncshader:isReady()), 'check ready state')
+  test:assertTrue(asyncshader:hasUniform('tex2'), 'check async uniform')
+  test:assertTrue(asyncshader:isReady(), 'check ready after use')
+
   -- check invalid shader
   local pixelcode2 = [[
     uniform float ww;
@@ -853,6 +1557,14 @@ love.test.graphics.Shader = function(test)
   local res, err = pcall(love.graphics.newShader, pixelcode2, vertexcode1)
   test:assertNotEquals(nil, err, 'check shader compile fails')
 
+  -- async shader errors are reported once the shader is used
+  local asyncbad = love.graphics.newShader(pixelcode2, vertexcode1, {async = true})
+  test:assertObject(asyncbad)
+  local ok = pcall(love.graphics.setShader, asyncbad)
+  test:assertFalse(ok, 'check async shader compile fails on use')
+  test:assertTrue(asyncbad:isReady(), 'check failed shader is ready')
+  love.graphics.setShader()
+
   -- check using a shader to draw + sending uniforms
   -- shader will return a given color if overwrite set to 1, otherwise def. draw
   local pixelcode3 = [[
@@ -1003,6 +1715,29 @@ love.test.graphics.Shader = function(test)
   else
     test:assertTrue(true, "skip shader IO test")
   end
+
+  -- variants recompile with extra defines and are cached per permutation
+  local variantcode = [[
+    #ifndef TINT
+    #define TINT vec4(1.0)
+    #endif
+    vec4 effect(vec4 c, Image t, vec2 tc, vec2 sc) { return TINT; }
+  ]]
+  local basevariant = love.graphics.newShader(variantcode)
+  local redvariant = basevariant:getVariant({TINT = 'vec4(1.0, 0.0, 0.0, 1.0)'})
+  test:assertObject(redvariant)
+  test:assertEquals(redvariant, basevariant:getVariant({TINT = 'vec4(1.0, 0.0, 0.0, 1.0)'}), 'check variant cached')
+  test:assertNotEquals(redvariant, basevariant:getVariant({TINT = 'vec4(0.0, 1.0, 0.0, 1.0)'}), 'check different variant')
+  test:assertEquals(basevariant, basevariant:getVariant({}), 'check same defines variant')
+  local variantcanvas = love.graphics.newCanvas(4, 4)
+  love.graphics.push("all")
+    love.graphics.setCanvas(variantcanvas)
+    love.graphics.setShader(redvariant)
+    love.graphics.rectangle("fill", 0, 0, 4, 4)
+  love.graphics.pop()
+  local vr, vg, vb, va = love.graphics.readbackTexture(variantcanvas):getPixel(1, 1)
+  test:assertEquals(1, vr, 'check variant red')
+  test:assertEquals(0, vg, 'check variant green')
 end
 
 
@@ -1129,6 +1864,67 @@ love.test.graphics.SpriteBatch = function(test)
   local imgdata5 = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata5)
 
+  -- instanced sbatch should draw the same as a regular one
+  local isbatch = love.graphics.newSpriteBatch(texture2, 64, 'dynamic', true)
+  local rsbatch = love.graphics.newSpriteBatch(texture2, 64, 'dynamic')
+  test:assertTrue(isbatch:isInstanced(), 'check instanced')
+  test:assertFalse(rsbatch:isInstanced(), 'check not instanced')
+  for s=1,64 do
+    isbatch:add(quad1, (s%8)*2, math.floor(s/8)*2, 0, 2, 2)
+    rsbatch:add(quad1, (s%8)*2, math.floor(s/8)*2, 0, 2, 2)
+  end
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(isbatch, 0, 0)
+  love.graphics.setCanvas()
+  local imgdata6 = love.graphics.readbackTexture(canvas)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(rsbatch, 0, 0)
+  love.graphics.setCanvas()
+  local imgdata7 = love.graphics.readbackTexture(canvas)
+  local matching = true
+  for x=0,imgdata6:getWidth()-1 do
+    for y=0,imgdata6:getHeight()-1 do
+      local r1, g1, b1, a1 = imgdata6:getPixel(x, y)
+      local r2, g2, b2, a2 = imgdata7:getPixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        matching = false
+      end
+    end
+  end
+  test:assertTrue(matching, 'check instanced batch matches regular batch')
+
+  -- culling should skip offscreen chunks without changing what's drawn
+  local cbatch = love.graphics.newSpriteBatch(texture2, 1024)
+  test:assertFalse(cbatch:isCullingEnabled(), 'check culling off by default')
+  for s=0,1023 do
+    cbatch:add(quad1, (s%32)*4, math.floor(s/32)*4, 0, 2, 2)
+  end
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(cbatch, -40, -40)
+  love.graphics.setCanvas()
+  local imgdata8 = love.graphics.readbackTexture(canvas)
+  cbatch:setCullingEnabled(true)
+  test:assertTrue(cbatch:isCullingEnabled(), 'check culling enabled')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(cbatch, -40, -40)
+  love.graphics.setCanvas()
+  local imgdata9 = love.graphics.readbackTexture(canvas)
+  matching = true
+  for x=0,imgdata8:getWidth()-1 do
+    for y=0,imgdata8:getHeight()-1 do
+      local r1, g1, b1, a1 = imgdata8:getPixel(x, y)
+      local r2, g2, b2, a2 = imgdata9:getPixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        matching = false
+      end
+    end
+  end
+  test:assertTrue(matching, 'check culled batch matches unculled batch')
+
 end
 
 
@@ -1170,6 +1966,82 @@ love.test.graphics.Text = function(test)
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
 
+  -- check culling can be toggled
+  test:assertFalse(colortext:isCullingEnabled(), 'check culling off by default')
+  colortext:setCullingEnabled(true)
+  test:assertTrue(colortext:isCullingEnabled(), 'check culling enabled')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.draw(colortext, 0, 10)
+  love.graphics.setCanvas()
+  local culleddata = love.graphics.readbackTexture(canvas)
+  local matching = true
+  for x=0,imgdata:getWidth()-1 do
+    for y=0,imgdata:getHeight()-1 do
+      local r1, g1, b1, a1 = imgdata:getPixel(x, y)
+      local r2, g2, b2, a2 = culleddata:getPixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        matching = false
+      end
+    end
+  end
+  test:assertTrue(matching, 'check culled text matches unculled text')
+
+  -- check text with prewarmed glyphs draws the same as regular text
+  local font3 = love.graphics.newFont('resources/font.ttf', 8)
+  local prewarmtext = love.graphics.newTextBatch(font3)
+  test:assertFalse(prewarmtext:isPrewarmEnabled(), 'check prewarm off by default')
+  prewarmtext:setPrewarmEnabled(true)
+  test:assertTrue(prewarmtext:isPrewarmEnabled(), 'check prewarm enabled')
+  prewarmtext:setf('LÖVE is an *awesome* framework you can use to make 2D games in Lua', 60, 'right')
+  prewarmtext:addf({{1, 1, 0}, 'overlap'}, 1000, 'left')
+  local frames = 0
+  while font3:isPrewarming() and frames < 60 do
+    test:waitFrames(1)
+    frames = frames + 1
+  end
+  test:assertFalse(font3:isPrewarming(), 'check prewarm finished')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.draw(prewarmtext, 0, 10)
+  love.graphics.setCanvas()
+  local prewarmdata = love.graphics.readbackTexture(canvas)
+  matching = true
+  for x=0,imgdata:getWidth()-1 do
+    for y=0,imgdata:getHeight()-1 do
+      local r1, g1, b1, a1 = imgdata:getPixel(x, y)
+      local r2, g2, b2, a2 = prewarmdata:getPixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        matching = false
+      end
+    end
+  end
+  test:assertTrue(matching, 'check prewarmed text matches regular text')
+
+  -- check replacing and removing entries
+  local entrytext = love.graphics.newTextBatch(font3)
+  test:assertEquals(1, entrytext:add('first', 0, 0), 'check first index')
+  test:assertEquals(2, entrytext:add('second', 0, 10), 'check second index')
+  test:assertEquals(2, entrytext:replace(2, 'a much longer second', 0, 10), 'check replace index')
+  test:assertEquals(font3:getWidth('a much longer second'), entrytext:getWidth(2), 'check replaced width')
+  test:assertEquals(font3:getWidth('first'), entrytext:getWidth(1), 'check other entry unchanged')
+  entrytext:remove(1)
+  test:assertEquals(0, entrytext:getWidth(1), 'check removed width')
+  test:assertEquals(font3:getWidth('a much longer second'), entrytext:getWidth(2), 'check index kept after remove')
+  local ok = pcall(entrytext.remove, entrytext, 5)
+  test:assertFalse(ok, 'check invalid index errors')
+
+  -- check ring mode replaces the oldest entry
+  test:assertEquals(0, entrytext:getMaxEntries(), 'check no entry limit by default')
+  entrytext:clear()
+  entrytext:setMaxEntries(2)
+  test:assertEquals(2, entrytext:getMaxEntries(), 'check entry limit')
+  entrytext:add('one', 0, 0)
+  entrytext:add('two', 0, 10)
+  test:assertEquals(1, entrytext:add('three', 0, 20), 'check ring wraps around')
+  test:assertEquals(font3:getWidth('three'), entrytext:getWidth(1), 'check oldest entry replaced')
+  test:assertEquals(2, entrytext:add('four', 0, 30), 'check ring continues')
+
 end
 
 
@@ -1231,6 +2103,116 @@ love.test.graphics.Video = function(test)
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
 
+  -- check drawing while playing, which uploads newly decoded frames
+  video:play()
+  for i=1,3 do
+    test:waitSeconds(0.1)
+    love.graphics.setCanvas(canvas)
+      love.graphics.draw(video, 0, 0)
+    love.graphics.setCanvas()
+  end
+  video:pause()
+  if not GITHUB_RUNNER then
+    test:assertGreaterEqual(0.1, video:tell(), 'check video drawn while playing')
+  end
+
+end
+
+
+-- VideoRecorder (love.graphics.newVideoRecorder)
+love.test.graphics.VideoRecorder = function(test)
+
+  -- record a few frames of a canvas
+  local canvas = love.graphics.newCanvas(64, 32)
+  local recorder = love.graphics.newVideoRecorder('recording.y4m', 64, 32, 30)
+  test:assertObject(recorder)
+  test:assertTrue(recorder:isRecording(), 'check recording')
+  local w, h = recorder:getDimensions()
+  test:assertEquals(64, w, 'check width')
+  test:assertEquals(32, h, 'check height')
+  for i=1,3 do
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(i/3, 0, 0, 1)
+    love.graphics.setCanvas()
+    recorder:captureFrame(canvas)
+  end
+  recorder:stop()
+  test:assertFalse(recorder:isRecording(), 'check stopped')
+  test:assertEquals(3, recorder:getCapturedFrameCount(), 'check captured')
+  test:assertEquals(0, recorder:getDroppedFrameCount(), 'check dropped')
+  test:assertEquals(3, recorder:getWrittenFrameCount(), 'check written')
+
+  -- check the y4m stream layout
+  local header = 'YUV4MPEG2 W64 H32 F30:1 Ip A1:1 C420jpeg\n'
+  local contents = love.filesystem.read('recording.y4m')
+  test:assertEquals(header, contents:sub(1, #header), 'check header')
+  test:assertEquals(#header + 3*(6 + 64*32*3/2), #contents, 'check size')
+  test:assertEquals('FRAME\n', contents:sub(#header + 1, #header + 6), 'check frame')
+  love.filesystem.remove('recording.y4m')
+
+end
+
+
+-- VirtualTexture (love.graphics.newVirtualTexture)
+love.test.graphics.VirtualTexture = function(test)
+
+  -- check basic properties
+  local vt = love.graphics.newVirtualTexture(1024, 512, {
+    pagesize = 64,
+    cachesize = 4
+  })
+  test:assertObject(vt)
+  test:assertEquals(1024, vt:getWidth(), 'check width')
+  test:assertEquals(512, vt:getHeight(), 'check height')
+  test:assertEquals(64, vt:getPageSize(), 'check page size')
+  test:assertEquals(4, vt:getCacheSize(), 'check cache size')
+  test:assertEquals(5, vt:getMipmapCount(), 'check mipmap count')
+  local px, py = vt:getPageCount(1)
+  test:assertEquals(16, px, 'check page count x')
+  test:assertEquals(8, py, 'check page count y')
+  test:assertObject(vt:getCacheTexture())
+
+  -- drawing with nothing resident should request the coarsest page
+  local canvas = love.graphics.newCanvas(64, 64)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(vt, 0, 0, 0, 1/16, 1/16)
+  love.graphics.setCanvas()
+  local requests = vt:getPageRequests()
+  test:assertEquals(1, #requests, 'check requests')
+  test:assertEquals(5, requests[1][1], 'check request mipmap')
+  test:assertEquals(0, requests[1][2], 'check request x')
+  test:assertEquals(0, requests[1][3], 'check request y')
+  test:assertEquals(0, #vt:getPageRequests(), 'check requests cleared')
+
+  -- check the page is drawn once it's resident
+  local red = love.image.newImageData(64, 64)
+  red:mapPixel(function(x, y, r, g, b, a) return 1, 0, 0, 1 end)
+  vt:setPage(5, 0, 0, red)
+  test:assertTrue(vt:hasPage(5, 0, 0), 'check page resident')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(vt, 0, 0, 0, 1/16, 1/16)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r1, g1, b1 = imgdata:getPixel(10, 10)
+  local r2, g2, b2 = imgdata:getPixel(10, 48)
+  test:assertEquals(1, r1, 'check page drawn')
+  test:assertEquals(0, r2, 'check draw bounds')
+  test:assertEquals(0, #vt:getPageRequests(), 'check no requests when resident')
+
+  -- check lru eviction keeps the coarsest page
+  for x=0,3 do
+    vt:setPage(1, x, 0, red)
+  end
+  test:assertEquals(4, vt:getResidentPageCount(), 'check cache full')
+  test:assertTrue(vt:hasPage(5, 0, 0), 'check coarsest page kept')
+  test:assertFalse(vt:hasPage(1, 0, 0), 'check oldest page evicted')
+  test:assertTrue(vt:evictPage(1, 3, 0), 'check evict')
+  test:assertEquals(3, vt:getResidentPageCount(), 'check evicted count')
+  vt:clearPages()
+  test:assertEquals(0, vt:getResidentPageCount(), 'check cleared')
+
 end
 
 
@@ -1329,6 +2311,35 @@ love.test.graphics.clear = function(test)
 end
 
 
+-- love.graphics.compactBuffer
+love.test.graphics.compactBuffer = function(test)
+  if not love.graphics.getSupported().glsl4 then
+    test:skipTest('compute shaders are not supported on this system')
+    return
+  end
+  local flags, source = {}, {}
+  for i = 1, 1000 do
+    flags[i] = i % 3 == 0 and 1 or 0
+    source[i] = i * 2
+  end
+  local settings = {shaderstorage = true}
+  local flagbuffer = love.graphics.newBuffer('uint32', flags, settings)
+  local sourcebuffer = love.graphics.newBuffer('uint32', source, settings)
+  local dest = love.graphics.newBuffer('uint32', 1000, settings)
+  local countbuffer = love.graphics.newBuffer('uint32', 4, settings)
+  love.graphics.compactBuffer(flagbuffer, dest, sourcebuffer, 1000, countbuffer, 2)
+  local count = love.graphics.readbackBuffer(countbuffer):getUInt32(4)
+  test:assertEquals(333, count, 'check compacted count')
+  local results = {love.graphics.readbackBuffer(dest):getUInt32(0, count)}
+  for i = 1, count do
+    test:assertEquals(i * 6, results[i], 'check compacted value ' .. i)
+  end
+  -- without a source the indices of flagged values are written
+  love.graphics.compactBuffer(flagbuffer, dest)
+  test:assertEquals(2, love.graphics.readbackBuffer(dest):getUInt32(0), 'check compacted index')
+end
+
+
 -- love.graphics.discard
 love.test.graphics.discard = function(test)
   -- from the docs: "on some desktops this may do nothing"
@@ -1361,6 +2372,62 @@ love.test.graphics.draw = function(test)
 end
 
 
+-- love.graphics.drawMany
+love.test.graphics.drawMany = function(test)
+  local image = love.graphics.newImage('resources/love.png')
+  local quads = {
+    love.graphics.newQuad(0, 0, 8, 8, image),
+    love.graphics.newQuad(8, 8, 8, 8, image),
+  }
+  -- quad, x, y, angle, sx, sy, ox, oy, kx, ky, r, g, b, a
+  local sprites = {
+    { 1, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1 },
+    { 2, 16, 4, 0.5, 2, 2, 4, 4, 0, 0, 1, 0, 0, 1 },
+    { 0, 8, 20, 0, 0.5, 0.5, 0, 0, 0.25, 0, 1, 1, 1, 0.5 },
+  }
+  local values = {}
+  for _, sprite in ipairs(sprites) do
+    for _, v in ipairs(sprite) do
+      table.insert(values, v)
+    end
+  end
+  local data = love.data.pack('data', string.rep('f', #values), unpack(values))
+  local canvas1 = love.graphics.newCanvas(32, 32)
+  local canvas2 = love.graphics.newCanvas(32, 32)
+  love.graphics.setCanvas(canvas1)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.drawMany(image, quads, data)
+  love.graphics.setCanvas(canvas2)
+    love.graphics.clear(0, 0, 0, 1)
+    for _, s in ipairs(sprites) do
+      love.graphics.setColor(s[11], s[12], s[13], s[14])
+      if s[1] > 0 then
+        love.graphics.draw(image, quads[s[1]], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10])
+      else
+        love.graphics.draw(image, s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10])
+      end
+    end
+    love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setCanvas()
+  local imgdata1 = love.graphics.readbackTexture(canvas1)
+  local imgdata2 = love.graphics.readbackTexture(canvas2)
+  for y = 0, 31 do
+    for x = 0, 31 do
+      local r1, g1, b1, a1 = imgdata1:getPixel(x, y)
+      local r2, g2, b2, a2 = imgdata2:getPixel(x, y)
+      test:assertEquals(r2, r1, 'check red ' .. x .. ',' .. y)
+      test:assertEquals(g2, g1, 'check green ' .. x .. ',' .. y)
+      test:assertEquals(b2, b1, 'check blue ' .. x .. ',' .. y)
+      test:assertEquals(a2, a1, 'check alpha ' .. x .. ',' .. y)
+    end
+  end
+  -- a count limits the sprites drawn, and invalid quad indices are errors
+  test:assertEquals(true, pcall(love.graphics.drawMany, image, quads, data, 1), 'check count')
+  test:assertEquals(false, pcall(love.graphics.drawMany, image, quads, data, 4), 'check count too high')
+  test:assertEquals(false, pcall(love.graphics.drawMany, image, nil, data), 'check invalid quad index')
+end
+
+
 -- love.graphics.drawInstanced
 love.test.graphics.drawInstanced = function(test)
   local image = love.graphics.newImage('resources/love.png')
@@ -1452,6 +2519,44 @@ love.test.graphics.line = function(test)
 end
 
 
+-- love.graphics.multiDrawIndirect
+love.test.graphics.multiDrawIndirect = function(test)
+  if not love.graphics.getSupported().indirectdraw then
+    test:skipTest('indirect draws are not supported on this system')
+    return
+  end
+  -- red quad on the left half, green quad on the right half
+  local vertices = {}
+  local function quad(x, r, g)
+    for _, v in ipairs({{0,0}, {8,0}, {8,16}, {0,0}, {8,16}, {0,16}}) do
+      table.insert(vertices, {x + v[1], v[2], 0, 0, r, g, 0, 1})
+    end
+  end
+  quad(0, 1, 0)
+  quad(8, 0, 1)
+  local mesh = love.graphics.newMesh(vertices, 'triangles', 'static')
+  -- vertex count, instance count, first vertex, first instance
+  local args = love.graphics.newBuffer('uint32', {6, 1, 0, 0, 6, 1, 6, 0}, {indirectarguments=true})
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.multiDrawIndirect(mesh, args, 1, 2)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  test:assertEquals('1,0,0,1', table.concat({imgdata:getPixel(2, 8)}, ','), 'check first draw')
+  test:assertEquals('0,1,0,1', table.concat({imgdata:getPixel(12, 8)}, ','), 'check second draw')
+  -- only the second record, which starts at the buffer's 5th value
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.multiDrawIndirect(mesh, args, 5, 1)
+  love.graphics.setCanvas()
+  imgdata = love.graphics.readbackTexture(canvas)
+  test:assertEquals('0,0,0,1', table.concat({imgdata:getPixel(2, 8)}, ','), 'check first record skipped')
+  test:assertEquals('0,1,0,1', table.concat({imgdata:getPixel(12, 8)}, ','), 'check second record drawn')
+  test:assertFalse(pcall(love.graphics.multiDrawIndirect, mesh, args, 5, 2), 'check out of range count errors')
+end
+
+
 -- love.graphics.points
 love.test.graphics.points = function(test)
   local canvas = love.graphics.newCanvas(16, 16)
@@ -1485,6 +2590,31 @@ love.test.graphics.polygon = function(test)
 end
 
 
+-- love.graphics.prefixSum
+love.test.graphics.prefixSum = function(test)
+  if not love.graphics.getSupported().glsl4 then
+    test:skipTest('compute shaders are not supported on this system')
+    return
+  end
+  -- spans several threadgroups so the block sums are scanned too
+  local values = {}
+  for i = 1, 1500 do
+    values[i] = i % 7
+  end
+  local settings = {shaderstorage = true}
+  local source = love.graphics.newBuffer('uint32', values, settings)
+  local dest = love.graphics.newBuffer('uint32', 1500, settings)
+  love.graphics.prefixSum(source, dest)
+  local results = {love.graphics.readbackBuffer(dest):getUInt32(0, 1500)}
+  local sum = 0
+  for i = 1, 1500 do
+    test:assertEquals(sum, results[i], 'check prefix sum ' .. i)
+    sum = sum + values[i]
+  end
+  test:assertFalse(pcall(love.graphics.prefixSum, source, dest, 2000), 'check count past the end errors')
+end
+
+
 -- love.graphics.print
 love.test.graphics.print = function(test)
   love.graphics.setFont(Font)
@@ -1523,6 +2653,36 @@ love.test.graphics.printf = function(test)
 end
 
 
+-- love.graphics.radixSort
+love.test.graphics.radixSort = function(test)
+  if not love.graphics.getSupported().glsl4 then
+    test:skipTest('compute shaders are not supported on this system')
+    return
+  end
+  local keys, values = {}, {}
+  local seed = 12345
+  for i = 1, 700 do
+    seed = (seed * 1103515245 + 12345) % 2147483648
+    keys[i] = seed % 100000
+    values[i] = i
+  end
+  local settings = {shaderstorage = true}
+  local keybuffer = love.graphics.newBuffer('uint32', keys, settings)
+  local valuebuffer = love.graphics.newBuffer('uint32', values, settings)
+  -- 17 bits is an odd number of passes, which ends with a copy back
+  love.graphics.radixSort(keybuffer, valuebuffer, 700, 17)
+  local sortedkeys = {love.graphics.readbackBuffer(keybuffer):getUInt32(0, 700)}
+  local sortedvalues = {love.graphics.readbackBuffer(valuebuffer):getUInt32(0, 700)}
+  for i = 1, 700 do
+    test:assertEquals(keys[sortedvalues[i]], sortedkeys[i], 'check value follows key ' .. i)
+    if i > 1 then
+      local prev, cur = sortedkeys[i - 1], sortedkeys[i]
+      test:assertTrue(prev < cur or (prev == cur and sortedvalues[i - 1] < sortedvalues[i]), 'check stable order ' .. i)
+    end
+  end
+end
+
+
 -- love.graphics.rectangle
 love.test.graphics.rectangle = function(test)
   -- setup, draw a 16x16 red rectangle with a blue central square
@@ -1597,6 +2757,14 @@ love.test.graphics.newArrayImage = function(test)
   }))
 end
 
+
+-- love.graphics.newAtlas
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.newAtlas = function(test)
+  test:assertObject(love.graphics.newAtlas())
+  test:assertObject(love.graphics.newAtlas(256, 256, 4, {mipmaps = true}))
+end
+
 -- love.graphics.newCanvas
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newCanvas = function(test)
@@ -1622,6 +2790,20 @@ love.test.graphics.newCubeImage = function(test)
 end
 
 
+-- love.graphics.newDrawList
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.newDrawList = function(test)
+  test:assertObject(love.graphics.newDrawList())
+end
+
+
+-- love.graphics.newDynamicResolution
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.newDynamicResolution = function(test)
+  test:assertObject(love.graphics.newDynamicResolution())
+end
+
+
 -- love.graphics.newFont
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newFont = function(test)
@@ -1630,6 +2812,13 @@ love.test.graphics.newFont = function(test)
 end
 
 
+-- love.graphics.newFrameCapture
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.newFrameCapture = function(test)
+  test:assertObject(love.graphics.newFrameCapture())
+end
+
+
 -- love.graphics.newImage
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newImage = function(test)
@@ -1655,11 +2844,36 @@ love.test.graphics.newMesh = function(test)
 end
 
 
+-- love.graphics.newOcclusionQuery
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.newOcclusionQuery = function(test)
+  if not love.graphics.getSupported().occlusionquery then
+    test:skipTest('occlusion queries are not supported on this system')
+    return
+  end
+  test:assertObject(love.graphics.newOcclusionQuery())
+end
+
+
 -- love.graphics.newParticleSystem
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newParticleSystem = function(test)
   local imgdata = love.graphics.newImage('resources/love.png')
   test:assertObject(love.graphics.newParticleSystem(imgdata, 1000))
+  local features = love.graphics.getSupported()
+  if features.glsl4 and features.indirectdraw then
+    local gpusystem = love.graphics.newParticleSystem(imgdata, 1000, true)
+    test:assertObject(gpusystem)
+    test:assertTrue(gpusystem:isGPUSimulated(), 'check gpu simulated')
+    gpusystem:setParticleLifetime(1, 2)
+    gpusystem:emit(100)
+    gpusystem:update(0.1)
+    local canvas = love.graphics.newCanvas(16, 16)
+    love.graphics.setCanvas(canvas)
+      love.graphics.draw(gpusystem)
+    love.graphics.setCanvas()
+  end
+  test:assertFalse(love.graphics.newParticleSystem(imgdata, 10):isGPUSimulated(), 'check cpu simulated')
 end
 
 
@@ -1671,6 +2885,12 @@ love.test.graphics.newQuad = function(test)
 end
 
 
+-- love.graphics.newRenderGraph
+love.test.graphics.newRenderGraph = function(test)
+  test:assertObject(love.graphics.newRenderGraph())
+end
+
+
 -- love.graphics.newShader
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newShader = function(test)
@@ -1723,6 +2943,13 @@ love.test.graphics.newVideo = function(test)
 end
 
 
+-- love.graphics.newVirtualTexture
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.newVirtualTexture = function(test)
+  test:assertObject(love.graphics.newVirtualTexture(4096, 4096))
+end
+
+
 -- love.graphics.newVolumeImage
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newVolumeImage = function(test)
@@ -1965,6 +3192,17 @@ love.test.graphics.getShader = function(test)
 end
 
 
+-- love.graphics.getShapeRendering
+love.test.graphics.getShapeRendering = function(test)
+  -- check default shape rendering
+  test:assertEquals('tessellate', love.graphics.getShapeRendering())
+  -- check set value returned correctly
+  love.graphics.setShapeRendering('sdf')
+  test:assertEquals('sdf', love.graphics.getShapeRendering())
+  love.graphics.setShapeRendering('tessellate') -- reset
+end
+
+
 -- love.graphics.getStackDepth
 love.test.graphics.getStackDepth = function(test)
   -- by default should be none
@@ -2027,6 +3265,36 @@ love.test.graphics.isActive = function(test)
 end
 
 
+-- love.graphics.isArrayLayerBatching
+love.test.graphics.isArrayLayerBatching = function(test)
+  test:assertFalse(love.graphics.isArrayLayerBatching(), 'check off by default')
+  love.graphics.setArrayLayerBatching(true)
+  test:assertTrue(love.graphics.isArrayLayerBatching(), 'check batching is set')
+  -- drawing layer views should look the same as without batching
+  local red = love.image.newImageData(4, 4)
+  red:mapPixel(function() return 1, 0, 0, 1 end)
+  local green = love.image.newImageData(4, 4)
+  green:mapPixel(function() return 0, 1, 0, 1 end)
+  local array = love.graphics.newArrayImage({red, green})
+  local view1 = love.graphics.newTextureView(array, {type = '2d', layerstart = 1, layers = 1})
+  local view2 = love.graphics.newTextureView(array, {type = '2d', layerstart = 2, layers = 1})
+  local canvas = love.graphics.newCanvas(8, 4)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(view1, 0, 0)
+    love.graphics.draw(view2, 4, 0)
+  love.graphics.setCanvas()
+  love.graphics.setArrayLayerBatching(false)
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r1, g1 = imgdata:getPixel(1, 1)
+  local r2, g2 = imgdata:getPixel(5, 1)
+  test:assertEquals(1, r1, 'check first layer drawn')
+  test:assertEquals(0, g1, 'check first layer drawn')
+  test:assertEquals(0, r2, 'check second layer drawn')
+  test:assertEquals(1, g2, 'check second layer drawn')
+end
+
+
 -- love.graphics.isGammaCorrect
 love.test.graphics.isGammaCorrect = function(test)
   -- we know the config so know this is false
@@ -2034,6 +3302,13 @@ love.test.graphics.isGammaCorrect = function(test)
 end
 
 
+-- love.graphics.isShaderCacheEnabled
+love.test.graphics.isShaderCacheEnabled = function(test)
+  -- off unless t.graphics.shadercache is set in conf
+  test:assertFalse(love.graphics.isShaderCacheEnabled(), 'check shader cache disabled by default')
+end
+
+
 -- love.graphics.isWireframe
 love.test.graphics.isWireframe = function(test)
   local name, version, vendor, device = love.graphics.getRendererInfo()
@@ -2129,6 +3404,25 @@ love.test.graphics.setCanvas = function(test)
   test:compareImg(imgdata)
   local imgdata2 = love.graphics.readbackTexture(canvas2, 1, 2) -- readback mipmap
   test:compareImg(imgdata2)
+
+  -- check msaa canvases can skip resolving until a later pass
+  local msaacanvas = love.graphics.newCanvas(16, 16, {msaa = 4})
+  love.graphics.setCanvas({msaacanvas, resolve = false})
+    local current = love.graphics.getCanvas()
+    test:assertEquals(false, current.resolve, 'check resolve disabled')
+    love.graphics.clear(0, 0, 1, 1)
+  love.graphics.setCanvas({msaacanvas, resolve = false})
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.rectangle('fill', 0, 0, 8, 16)
+    love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setCanvas(msaacanvas)
+    test:assertEquals(msaacanvas, love.graphics.getCanvas(), 'check resolve enabled')
+  love.graphics.setCanvas()
+  local msaadata = love.graphics.readbackTexture(msaacanvas)
+  local lr, lg, lb = msaadata:getPixel(2, 8)
+  local rr, rg, rb = msaadata:getPixel(12, 8)
+  test:assertEquals(1, lr + lg + lb, 'check resolved first half')
+  test:assertEquals(1, rb - rr - rg, 'check resolved second half')
 end
 
 
@@ -2211,6 +3505,54 @@ love.test.graphics.setDepthMode = function(test)
 end
 
 
+-- love.graphics.setDrawReorderWindow
+love.test.graphics.setDrawReorderWindow = function(test)
+  test:assertEquals(0, love.graphics.getDrawReorderWindow(), 'check default window')
+  local red = love.image.newImageData(1, 1)
+  red:setPixel(0, 0, 1, 0, 0, 1)
+  local green = love.image.newImageData(1, 1)
+  green:setPixel(0, 0, 0, 1, 0, 1)
+  local images = { love.graphics.newImage(red), love.graphics.newImage(green) }
+  local canvas = love.graphics.newCanvas(16, 16)
+  local function drawRows()
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.flushBatch()
+      local drawcalls = love.graphics.getStats().drawcalls
+      -- icon and label style rows which don't overlap
+      for y=0,7 do
+        love.graphics.draw(images[1], 0, y*2, 0, 8, 2)
+        love.graphics.draw(images[2], 8, y*2, 0, 8, 2)
+      end
+      -- overlapping draws have to stay in order
+      love.graphics.draw(images[1], 0, 0, 0, 4, 4)
+      love.graphics.draw(images[2], 0, 0, 0, 4, 4)
+      love.graphics.flushBatch()
+      drawcalls = love.graphics.getStats().drawcalls - drawcalls
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(canvas), drawcalls
+  end
+  local expected, unordered = drawRows()
+  love.graphics.setDrawReorderWindow(64)
+  test:assertEquals(64, love.graphics.getDrawReorderWindow(), 'check set window')
+  local imgdata, reordered = drawRows()
+  test:assertTrue(reordered < unordered, 'check fewer draw calls')
+  for y=0,15 do
+    for x=0,15 do
+      local r1, g1, b1 = expected:getPixel(x, y)
+      local r2, g2, b2 = imgdata:getPixel(x, y)
+      test:assertEquals(r1 .. ',' .. g1 .. ',' .. b1, r2 .. ',' .. g2 .. ',' .. b2, 'check pixel ' .. x .. ',' .. y)
+    end
+  end
+  local r, g = imgdata:getPixel(1, 1)
+  test:assertEquals('0,1', r .. ',' .. g, 'check overlapping draw on top')
+  r, g = imgdata:getPixel(1, 5)
+  test:assertEquals('1,0', r .. ',' .. g, 'check row drawn')
+  love.graphics.setDrawReorderWindow(0)
+  test:assertEquals(0, love.graphics.getDrawReorderWindow(), 'check reset window')
+end
+
+
 -- love.graphics.setFont
 love.test.graphics.setFont = function(test)
   -- set font doesnt return anything so draw with the test font
@@ -2227,6 +3569,20 @@ love.test.graphics.setFont = function(test)
 end
 
 
+-- love.graphics.setFrameLatency
+love.test.graphics.setFrameLatency = function(test)
+  test:assertEquals(0, love.graphics.getFrameLatency(), 'check default latency')
+  love.graphics.setFrameLatency(1)
+  test:assertEquals(1, love.graphics.getFrameLatency(), 'check set latency')
+  -- presenting with the lowest latency should still work
+  test:waitFrames(3)
+  love.graphics.setFrameLatency(100)
+  test:assertEquals(3, love.graphics.getFrameLatency(), 'check clamped latency')
+  love.graphics.setFrameLatency(0)
+  test:assertEquals(0, love.graphics.getFrameLatency(), 'check reset latency')
+end
+
+
 -- love.graphics.setFrontFaceWinding
 love.test.graphics.setFrontFaceWinding = function(test)
   -- check documented modes are valid
@@ -2353,6 +3709,26 @@ love.test.graphics.setMeshCullMode = function(test)
 end
 
 
+-- love.graphics.setRedrawOnDemand
+love.test.graphics.setRedrawOnDemand = function(test)
+  test:assertFalse(love.graphics.isRedrawOnDemand(), 'check off by default')
+  love.graphics.setRedrawOnDemand(true)
+  test:assertTrue(love.graphics.isRedrawOnDemand(), 'check enabled')
+  test:assertEquals(0, love.graphics.getRedrawDelay(), 'check first frame is drawn')
+  love.graphics.validate()
+  test:assertEquals(nil, love.graphics.getRedrawDelay(), 'check nothing requested')
+  -- check the earliest request wins
+  love.graphics.invalidate(10)
+  love.graphics.invalidate(5)
+  test:assertRange(love.graphics.getRedrawDelay(), 4, 5, 'check delayed redraw')
+  love.graphics.invalidate()
+  test:assertEquals(0, love.graphics.getRedrawDelay(), 'check immediate redraw')
+  love.graphics.validate()
+  love.graphics.setRedrawOnDemand(false)
+  test:assertFalse(love.graphics.isRedrawOnDemand(), 'check disabled')
+end
+
+
 -- love.graphics.setScissor
 love.test.graphics.setScissor = function(test)
   -- make a scissor for the left half
@@ -2402,6 +3778,59 @@ love.test.graphics.setShader = function(test)
 end
 
 
+-- love.graphics.setShapeRendering
+love.test.graphics.setShapeRendering = function(test)
+  -- draw sdf shapes and check they cover the right pixels
+  local canvas = love.graphics.newCanvas(32, 16)
+  love.graphics.push("all")
+    love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.origin()
+    love.graphics.setShapeRendering('sdf')
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.circle('fill', 8, 8, 6)
+    love.graphics.setLineWidth(2)
+    love.graphics.rectangle('line', 17, 1, 14, 14, 4, 4)
+  love.graphics.pop()
+  test:assertEquals('tessellate', love.graphics.getShapeRendering(), 'check state popped')
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b, a = imgdata:getPixel(8, 8)
+  test:assertEquals(1, r, 'check filled circle center')
+  r, g, b, a = imgdata:getPixel(0, 0)
+  test:assertEquals(0, r, 'check outside filled circle')
+  r, g, b, a = imgdata:getPixel(24, 8)
+  test:assertEquals(0, r, 'check inside rectangle outline')
+  r, g, b, a = imgdata:getPixel(17, 8)
+  test:assertEquals(1, r, 'check rectangle outline edge')
+  local ok = pcall(love.graphics.setShapeRendering, 'fancy')
+  test:assertFalse(ok, 'check invalid mode errors')
+end
+
+
+-- love.graphics.setStatsOverlayEnabled
+love.test.graphics.setStatsOverlayEnabled = function(test)
+  test:assertFalse(love.graphics.isStatsOverlayEnabled(), 'check off by default')
+  love.graphics.setStatsOverlayEnabled(true)
+  test:assertTrue(love.graphics.isStatsOverlayEnabled(), 'check enabled')
+  -- check drawing works with and without extra lines, and keeps the state
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.drawStatsOverlay()
+    love.graphics.drawStatsOverlay(0.001, {'line 1', 'line 2'})
+    test:assertEquals(canvas, love.graphics.getCanvas(), 'check canvas kept')
+    local r, g, b, a = love.graphics.getColor()
+    test:assertEquals(1, r, 'check color kept')
+    test:assertEquals(0, g, 'check color kept')
+  love.graphics.setCanvas()
+  love.graphics.setColor(1, 1, 1, 1)
+  local ok = pcall(love.graphics.drawStatsOverlay, 0, {{}})
+  test:assertFalse(ok, 'check invalid lines error')
+  love.graphics.setStatsOverlayEnabled(false)
+  test:assertFalse(love.graphics.isStatsOverlayEnabled(), 'check disabled')
+end
+
+
 -- love.graphics.setStencilState
 love.test.graphics.setStencilState = function(test)
   local canvas = love.graphics.newCanvas(16, 16)
@@ -2420,6 +3849,151 @@ love.test.graphics.setStencilState = function(test)
 end
 
 
+-- love.graphics.setTextureMemoryBudget
+love.test.graphics.setTextureMemoryBudget = function(test)
+  test:assertEquals(0, love.graphics.getTextureMemoryBudget(), 'check default budget')
+  local image = love.graphics.newImage('resources/love.png', {mipmaps = true, evictable = true})
+  test:assertTrue(image:isEvictable(), 'check evictable')
+  test:assertEquals(1, image:getResidentMipmap(), 'check fully resident')
+  love.graphics.setTextureMemoryBudget(1024)
+  test:assertEquals(1024, love.graphics.getTextureMemoryBudget(), 'check set budget')
+  -- evictable textures can't have their pixels replaced
+  local imgdata = love.image.newImageData('resources/loveinv.png')
+  local ok = pcall(image.replacePixels, image, imgdata)
+  test:assertFalse(ok, 'check evictable replacePixels error')
+  ok = pcall(love.graphics.newImage, 'resources/love.png', {evictable = true})
+  test:assertFalse(ok, 'check evictable requires mipmaps')
+  love.graphics.setTextureMemoryBudget(0)
+end
+
+
+-- love.graphics.setTextureStreamingBudget
+love.test.graphics.setTextureStreamingBudget = function(test)
+  test:assertEquals(8*1024*1024, love.graphics.getTextureStreamingBudget(), 'check default budget')
+  love.graphics.setTextureStreamingBudget(1024)
+  test:assertEquals(1024, love.graphics.getTextureStreamingBudget(), 'check set budget')
+  -- streaming textures need data for every mipmap level
+  local mips = {}
+  local size = 512
+  while size >= 1 do
+    table.insert(mips, love.image.newImageData(size, size))
+    size = math.floor(size / 2)
+  end
+  local image = love.graphics.newImage(mips, {mipmaps = true, streaming = true})
+  test:assertTrue(image:isStreaming(), 'check streaming')
+  test:assertTrue(image:isEvictable(), 'check streaming is evictable')
+  local ok = pcall(love.graphics.newImage, 'resources/love.png', {mipmaps = true, streaming = true})
+  test:assertFalse(ok, 'check streaming requires mipmap data')
+  -- drawing at full size streams in at least one larger level per frame
+  local canvas = love.graphics.newCanvas(512, 512)
+  for i=1,4 do
+    love.graphics.setCanvas(canvas)
+      love.graphics.draw(image, 0, 0)
+    love.graphics.setCanvas()
+    test:waitFrames(1)
+  end
+  test:assertEquals(1, image:getResidentMipmap(), 'check fully streamed in')
+  love.graphics.setTextureStreamingBudget(8*1024*1024)
+end
+
+
+-- love.graphics.setThreadedCreationBudget
+love.test.graphics.setThreadedCreationBudget = function(test)
+  local budget = love.graphics.getThreadedCreationBudget()
+  love.graphics.setThreadedCreationBudget(0.01)
+  test:assertEquals(0.01, love.graphics.getThreadedCreationBudget(), 'check budget set')
+  love.graphics.setThreadedCreationBudget(-1)
+  test:assertEquals(0, love.graphics.getThreadedCreationBudget(), 'check budget clamped')
+  love.graphics.setThreadedCreationBudget(budget)
+  -- textures can be created on a thread, the main thread runs the creation
+  -- while presenting
+  local channel = love.thread.getChannel('threadedcreation')
+  channel:clear()
+  local thread = love.thread.newThread([[
+    require('love.image')
+    require('love.graphics')
+    local imgdata = love.image.newImageData(8, 4)
+    local texture = love.graphics.newTexture(imgdata)
+    local ok = pcall(love.graphics.newCanvas, -1, -1)
+    love.thread.getChannel('threadedcreation'):push({texture, ok})
+  ]])
+  thread:start()
+  local result = nil
+  for i = 1, 60 do
+    result = channel:pop()
+    if result ~= nil then break end
+    test:waitFrames(1)
+  end
+  thread:wait()
+  test:assertNotEquals(nil, result, 'check thread finished')
+  if result ~= nil then
+    test:assertEquals(8, result[1]:getWidth(), 'check texture created on thread')
+    test:assertFalse(result[2], 'check errors are raised on the thread')
+  end
+  test:assertEquals(nil, thread:getError(), 'check no thread error')
+  -- the main thread also runs the creation while it's blocked waiting on a
+  -- Channel or a thread, instead of deadlocking
+  local waited = love.thread.newThread([[
+    require('love.image')
+    require('love.graphics')
+    local texture = love.graphics.newTexture(love.image.newImageData(4, 4))
+    love.thread.getChannel('threadedcreation'):supply(texture:getWidth())
+    love.graphics.newTexture(love.image.newImageData(2, 2))
+  ]])
+  waited:start()
+  test:assertEquals(4, channel:demand(5), 'check creation during demand')
+  waited:wait()
+  test:assertEquals(nil, waited:getError(), 'check creation during wait')
+end
+
+
+-- love.graphics.setUniformBuffer
+love.test.graphics.setUniformBuffer = function(test)
+  local format = {
+    { name="tint", format="floatvec4" },
+    { name="scale", format="float" }
+  }
+  local buffer = love.graphics.newBuffer(format, 1, {uniform = true})
+  test:assertTrue(buffer:isBufferType('uniform'), 'check is uniform buffer')
+  test:assertEquals(32, buffer:getElementStride(), 'check uniform buffer element stride')
+  buffer:setArrayData({0, 1, 0, 1, 0.5})
+  local vertexbuffer = love.graphics.newBuffer('float', 4, {vertex = true})
+  local ok = pcall(love.graphics.setUniformBuffer, 'Shared', vertexbuffer)
+  test:assertFalse(ok, 'check non-uniform buffer error')
+  -- every shader declaring the block reads the same buffer
+  local code = [[
+    layout(std140) uniform Shared { vec4 tint; float scale; };
+    vec4 effect(vec4 c, Image t, vec2 tc, vec2 sc) { return tint * %s; }
+  ]]
+  local shader1 = love.graphics.newShader(code:format('1.0'))
+  local shader2 = love.graphics.newShader(code:format('vec4(1.0, 1.0, 1.0, scale)'))
+  ok = pcall(shader1.send, shader1, 'Shared', buffer)
+  test:assertFalse(ok, 'check shared block send error')
+  love.graphics.setUniformBuffer('Shared', buffer)
+  test:assertEquals(buffer, love.graphics.getUniformBuffer('Shared'), 'check get uniform buffer')
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.push('all')
+    love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.setBlendMode('replace')
+    love.graphics.setShader(shader1)
+    love.graphics.rectangle('fill', 0, 0, 8, 16)
+    love.graphics.setShader(shader2)
+    love.graphics.rectangle('fill', 8, 0, 8, 16)
+  love.graphics.pop()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r1, g1, b1, a1 = imgdata:getPixel(2, 2)
+  test:assertEquals(0, r1, 'check shader 1 red')
+  test:assertEquals(1, g1, 'check shader 1 green')
+  test:assertEquals(1, a1, 'check shader 1 alpha')
+  local r2, g2, b2, a2 = imgdata:getPixel(12, 2)
+  test:assertEquals(1, g2, 'check shader 2 green')
+  test:assertRange(a2, 0.49, 0.51, 'check shader 2 alpha')
+  love.graphics.setUniformBuffer('Shared', nil)
+  test:assertEquals(nil, love.graphics.getUniformBuffer('Shared'), 'check unset uniform buffer')
+end
+
+
 -- love.graphics.setWireframe
 love.test.graphics.setWireframe = function(test)
   local name, version, vendor, device = love.graphics.getRendererInfo()
@@ -2548,6 +4122,23 @@ love.test.graphics.push = function(test)
   love.graphics.setCanvas()
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
+  -- pushing a transform applies it, unless it should replace the current one
+  local transform = love.math.newTransform(2, 3)
+  love.graphics.push()
+  love.graphics.translate(10, 10)
+  love.graphics.push('transform', transform)
+  local x, y = love.graphics.transformPoint(0, 0)
+  test:assertEquals(12, x, 'check applied x')
+  test:assertEquals(13, y, 'check applied y')
+  love.graphics.pop()
+  love.graphics.push('transform', transform, true)
+  x, y = love.graphics.transformPoint(0, 0)
+  test:assertEquals(2, x, 'check replaced x')
+  test:assertEquals(3, y, 'check replaced y')
+  love.graphics.pop()
+  x, y = love.graphics.transformPoint(0, 0)
+  test:assertEquals(10, x, 'check popped x')
+  love.graphics.pop()
 end
 
 
@@ -2774,6 +4365,31 @@ love.test.graphics.getTextureFormats = function(test)
 end
 
 
+-- love.graphics.getGPUTimings
+love.test.graphics.getGPUTimings = function(test)
+  if not love.graphics.getSupported().gputimestamps then
+    test:assertFalse(pcall(love.graphics.pushGPUTimer, 'frame'), 'check unsupported error')
+    return test:skipTest('GPU timestamp queries are not supported on this system')
+  end
+  -- unbalanced pops should error
+  test:assertFalse(pcall(love.graphics.popGPUTimer), 'check unbalanced pop error')
+  love.graphics.pushGPUTimer('frame')
+  love.graphics.pushGPUTimer('rectangle')
+  love.graphics.rectangle('fill', 0, 0, 16, 16)
+  love.graphics.popGPUTimer()
+  love.graphics.popGPUTimer()
+  -- results arrive a few frames later, without stalling
+  test:waitFrames(6)
+  local timings = love.graphics.getGPUTimings()
+  test:assertEquals('table', type(timings), 'check timings table')
+  for i=1,#timings do
+    test:assertEquals('string', type(timings[i].name), 'check timing name')
+    test:assertGreaterEqual(0, timings[i].depth, 'check timing depth')
+    test:assertGreaterEqual(0, timings[i].time, 'check timing time')
+  end
+end
+
+
 -- love.graphics.getRendererInfo
 -- @NOTE hardware dependent so best can do is nil checking
 love.test.graphics.getRendererInfo = function(test)
@@ -2790,12 +4406,60 @@ end
 love.test.graphics.getStats = function(test)
   local stattypes = {
     'drawcalls', 'canvasswitches', 'texturememory', 'shaderswitches',
-    'drawcallsbatched', 'textures', 'fonts'
+    'drawcallsbatched', 'textures', 'fonts', 'bufferbytesuploaded',
+    'uniformbytesuploaded', 'streambufferstalltime', 'gpumemoryusage',
+    'gpumemorybudget', 'batchflushes'
   }
   local stats = love.graphics.getStats()
   for s=1,#stattypes do
     test:assertNotEquals(nil, stats[stattypes[s] ], 'expected a key for stat: ' .. stattypes[s])
   end
+  -- modifying two distant sprites should only upload those sprites
+  local texture = love.graphics.newImage('resources/love.png')
+  local sbatch = love.graphics.newSpriteBatch(texture, 10000)
+  for s=1,10000 do
+    sbatch:add(0, 0)
+  end
+  sbatch:flush()
+  local before = love.graphics.getStats().bufferbytesuploaded
+  sbatch:set(1, 10, 10)
+  sbatch:set(10000, 10, 10)
+  sbatch:flush()
+  local uploaded = love.graphics.getStats().bufferbytesuploaded - before
+  test:assertTrue(uploaded > 0, 'check modified sprites uploaded')
+  test:assertTrue(uploaded < 10000*4*20/2, 'check only modified ranges uploaded')
+  -- re-sending an unchanged uniform value shouldn't break the batch
+  local shader = love.graphics.newShader[[
+    uniform vec4 tint;
+    vec4 effect(vec4 c, Image t, vec2 tc, vec2 sc) { return c * tint; }
+  ]]
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.push('all')
+    love.graphics.setCanvas(canvas)
+    love.graphics.setShader(shader)
+    shader:send('tint', {1, 0, 0, 1})
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    love.graphics.flushBatch()
+    local drawcalls = love.graphics.getStats().drawcalls
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    shader:send('tint', {1, 0, 0, 1})
+    love.graphics.rectangle('fill', 8, 8, 8, 8)
+    love.graphics.flushBatch()
+    test:assertEquals(drawcalls + 1, love.graphics.getStats().drawcalls, 'check redundant send batched')
+    shader:send('tint', {0, 1, 0, 1})
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    love.graphics.flushBatch()
+    test:assertTrue(love.graphics.getStats().uniformbytesuploaded > 0, 'check uniform bytes counted')
+    -- batch flushes are counted by reason
+    local flushes = love.graphics.getStats().batchflushes
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    shader:send('tint', {0, 0, 1, 1})
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    love.graphics.flushBatch()
+    local after = love.graphics.getStats().batchflushes
+    test:assertEquals(flushes.uniform + 1, after.uniform, 'check uniform flush counted')
+    test:assertEquals(flushes.explicit + 1, after.explicit, 'check explicit flush counted')
+  love.graphics.pop()
 end
 
 
@@ -2832,6 +4496,23 @@ love.test.graphics.getSystemLimits = function(test)
 end
 
 
+-- love.graphics.getTemporaryCanvas
+love.test.graphics.getTemporaryCanvas = function(test)
+  local canvas1 = love.graphics.getTemporaryCanvas(16, 32)
+  test:assertObject(canvas1)
+  test:assertTrue(canvas1:isCanvas(), 'check is canvas')
+  test:assertEquals(16, canvas1:getPixelWidth(), 'check width')
+  test:assertEquals(32, canvas1:getPixelHeight(), 'check height')
+  -- canvases in use this frame aren't handed out twice
+  local canvas2 = love.graphics.getTemporaryCanvas(16, 32)
+  test:assertNotEquals(canvas1, canvas2, 'check unique in frame')
+  local canvas3 = love.graphics.getTemporaryCanvas(8, 8, 'rgba16f')
+  test:assertEquals('rgba16f', canvas3:getFormat(), 'check format')
+  local ok = pcall(love.graphics.getTemporaryCanvas, 0, 8)
+  test:assertFalse(ok, 'check invalid size')
+end
+
+
 -- love.graphics.getTextureTypes
 love.test.graphics.getTextureTypes = function(test)
   -- cant check values as hardware dependent but we can check the keys in the 
@@ -83,6 +83,50 @@ love.test.image.ImageData = function(test)
   local r2, g2, b2 = idata:getPixel(25, 25)
   test:assertEquals(1, r2+g2+b2, 'check set to red')
 
+  -- check pasting between formats
+  local fdata = love.image.newImageData(4, 4, 'rgba32f')
+  fdata:paste(idata, 0, 0, 24, 24, 4, 4)
+  local fr, fg, fb, fa = fdata:getPixel(1, 1)
+  test:assertEquals(1, fr, 'check pasted float r')
+  test:assertEquals(0, fg + fb, 'check pasted float gb')
+  test:assertEquals(1, fa, 'check pasted float a')
+  local rdata = love.image.newImageData(4, 4, 'r8')
+  rdata:paste(idata, 0, 0, 24, 24, 4, 4)
+  test:assertEquals(1, rdata:getPixel(1, 1), 'check pasted r8')
+  local bdata = love.image.newImageData(4, 4, 'rgba8')
+  bdata:paste(rdata, 0, 0)
+  local br, bg, bb, ba = bdata:getPixel(1, 1)
+  test:assertEquals(1, br, 'check pasted from r8 r')
+  test:assertEquals(1, ba, 'check pasted from r8 a')
+  local rgdata = love.image.newImageData(4, 4, 'rg8')
+  rgdata:paste(idata, 0, 0, 24, 24, 4, 4)
+  local rgr, rgg = rgdata:getPixel(1, 1)
+  test:assertEquals(1, rgr, 'check pasted rg8 r')
+  test:assertEquals(0, rgg, 'check pasted rg8 g')
+  bdata:paste(rgdata, 0, 0)
+  br, bg, bb, ba = bdata:getPixel(1, 1)
+  test:assertEquals(1, br + ba - bg - bb, 'check pasted from rg8')
+
+  -- check premultiplying alpha and gamma conversion
+  local pdata = love.image.newImageData(8, 2, 'rgba8')
+  for x=0,7 do
+    pdata:setPixel(x, 0, 1, 1, 1, 0.2)
+    pdata:setPixel(x, 1, 1, 1, 1, 1)
+  end
+  pdata:premultiplyAlpha()
+  local pr, _, _, pa = pdata:getPixel(5, 0)
+  test:assertEquals(pa, pr, 'check premultiplied color')
+  test:assertEquals(1, pdata:getPixel(5, 1), 'check opaque color unchanged')
+  pdata:setPixel(0, 0, 0.5, 0.5, 0.5, 1)
+  pdata:gammaToLinear(0, 0, 1, 1)
+  local lr = pdata:getPixel(0, 0)
+  test:assertRange(lr, 0.2, 0.23, 'check gamma to linear')
+  pdata:linearToGamma(0, 0, 1, 1)
+  lr = pdata:getPixel(0, 0)
+  test:assertRange(lr, 0.49, 0.51, 'check linear to gamma')
+  local ok = pcall(pdata.premultiplyAlpha, pdata, 4, 0, 8, 2)
+  test:assertFalse(ok, 'check invalid rectangle errors')
+
   -- check encoding to an image (png)
   idata:encode('png', 'test-encode.png')
   local read1 = love.filesystem.openFile('test-encode.png', 'r')
@@ -96,6 +140,44 @@ love.test.image.ImageData = function(test)
   test:assertNotNil(read2)
   love.filesystem.remove('test-encode.exr')
 
+  -- check encoding asynchronously to a file
+  local encode = idata:encodeAsync('png', 'test-encode-async.png')
+  test:assertObject(encode)
+  encode:wait()
+  test:assertTrue(encode:isComplete(), 'check encode complete')
+  test:assertEquals(nil, encode:getError(), 'check no encode error')
+  local asyncdata = love.image.newImageData('test-encode-async.png')
+  test:assertEquals(idata:getWidth(), asyncdata:getWidth(), 'check async encode width')
+  for y=0,idata:getHeight()-1,5 do
+    for x=0,idata:getWidth()-1,5 do
+      local r1, g1, b1, a1 = idata:getPixel(x, y)
+      local r2, g2, b2, a2 = asyncdata:getPixel(x, y)
+      test:assertEquals(math.floor(r1*255+0.5), math.floor(r2*255+0.5), 'check async encode r ' .. x .. ',' .. y)
+      test:assertEquals(math.floor(a1*255+0.5), math.floor(a2*255+0.5), 'check async encode a ' .. x .. ',' .. y)
+    end
+  end
+  love.filesystem.remove('test-encode-async.png')
+
+  -- check generating mipmaps
+  local mdata = love.image.newImageData(16, 8, 'rgba8')
+  for x=0,15 do
+    for y=0,7 do
+      mdata:setPixel(x, y, x % 2, 0.5, 0, 1)
+    end
+  end
+  local mips = mdata:generateMipmaps()
+  test:assertEquals(5, #mips, 'check mipmap count')
+  test:assertEquals(mdata, mips[1], 'check first level is the source')
+  test:assertEquals(1, mips[5]:getWidth(), 'check last level width')
+  test:assertEquals(1, mips[5]:getHeight(), 'check last level height')
+  test:assertRange(mips[2]:getPixel(3, 2), 0.49, 0.51, 'check box filtered pixel')
+  local kmips = mdata:generateMipmaps('kaiser', true)
+  test:assertEquals(5, #kmips, 'check kaiser mipmap count')
+  test:assertRange(select(2, kmips[3]:getPixel(1, 1)), 0.49, 0.51, 'check kaiser flat channel')
+  local fmips = love.image.newImageData(4, 4, 'rgba32f'):generateMipmaps('kaiser')
+  test:assertEquals('rgba32f', fmips[3]:getFormat(), 'check float mipmap format')
+  test:assertFalse(pcall(mdata.generateMipmaps, mdata, 'invalid'), 'check invalid filter')
+
   -- check linear
   test:assertFalse(idata:isLinear(), 'check not linear')
   idata:setLinear(true)
@@ -111,6 +193,40 @@ end
 --------------------------------------------------------------------------------
 
 
+-- love.image.compress
+love.test.image.compress = function(test)
+  local imgdata = love.image.newImageData('resources/love.png')
+
+  local compressed = love.image.compress(imgdata, 'DXT5')
+  test:assertObject(compressed)
+  test:assertEquals('DXT5', compressed:getFormat(), 'check compressed format')
+  test:assertEquals(imgdata:getWidth(), compressed:getWidth(), 'check compressed width')
+  test:assertEquals(imgdata:getHeight(), compressed:getHeight(), 'check compressed height')
+  test:assertEquals(1, compressed:getMipmapCount(), 'check no mipmaps')
+
+  -- sizes which aren't a multiple of the block size, with mipmaps
+  local odd = love.image.newImageData(13, 6, 'rgba8')
+  odd:mapPixel(function(x, y) return x/12, y/5, 0.5, 1 end)
+  local mipmapped = love.image.compress(odd, 'ETC1', true)
+  test:assertEquals(4, mipmapped:getMipmapCount(), 'check mipmap count')
+  test:assertEquals(13, mipmapped:getWidth(1), 'check base width')
+  test:assertEquals(1, mipmapped:getWidth(4), 'check last mip width')
+  test:assertEquals((8 + 2 + 1 + 1)*8, mipmapped:getSize(), 'check compressed size')
+
+  -- a flat color should survive compression
+  local flat = love.image.newImageData(8, 8, 'rgba8')
+  flat:mapPixel(function() return 1, 0, 0, 1 end)
+  local rgba = love.image.compress(flat, 'DXT1')
+  test:assertEquals(8*4, rgba:getSize(), 'check dxt1 size')
+  test:assertEquals(0xF8, string.byte(rgba:getString(), 2), 'check dxt1 endpoint')
+
+  local ok = pcall(love.image.compress, imgdata, 'BC7')
+  test:assertFalse(ok, 'check unsupported format')
+  ok = pcall(love.image.compress, imgdata, 'rgba8')
+  test:assertFalse(ok, 'check uncompressed format')
+end
+
+
 -- love.image.isCompressed
 -- @NOTE really we need to test each of the files listed here:
 -- https://love2d.org/wiki/CompressedImageFormat
@@ -125,6 +241,32 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.image.newCompressedData = function(test)
   test:assertObject(love.image.newCompressedData('resources/love.dxt1'))
+
+  -- KTX2 files, with and without supercompression
+  local block = love.data.pack('string', '<I2I2I4', 0xF800, 0xF800, 0)
+  local function ktx2(scheme, leveldata)
+    return love.data.pack('string', '<c12I4I4I4I4I4I4I4I4I4I4I4I4I4I8I8I8I8I8',
+      '\xABKTX 20\xBB\r\n\x1A\n', 131, 1, 4, 4, 0, 0, 1, 1, scheme,
+      0, 0, 0, 0, 0, 0, 104, #leveldata, #block) .. leveldata
+  end
+  local plain = love.image.newCompressedData(love.filesystem.newFileData(ktx2(0, block), 'plain.ktx2'))
+  test:assertEquals('DXT1', plain:getFormat(), 'check ktx2 format')
+  test:assertEquals(4, plain:getWidth(), 'check ktx2 width')
+  test:assertEquals(#block, plain:getSize(), 'check ktx2 size')
+  test:assertEquals(block, plain:getString(), 'check ktx2 data')
+  local zlib = love.data.compress('string', 'zlib', block)
+  local deflated = love.image.newCompressedData(love.filesystem.newFileData(ktx2(3, zlib), 'zlib.ktx2'))
+  test:assertEquals(block, deflated:getString(), 'check ktx2 zlib data')
+  local ok = pcall(love.image.newCompressedData, love.filesystem.newFileData(ktx2(2, block), 'zstd.ktx2'))
+  test:assertFalse(ok, 'check ktx2 zstd unsupported')
+
+  -- check loading a slice of a larger bundle through a DataView
+  local dxt1 = love.filesystem.read('resources/love.dxt1')
+  local bundle = love.data.newByteData('header' .. dxt1 .. 'footer')
+  local view = love.data.newDataView(bundle, 6, #dxt1)
+  local fromview = love.image.newCompressedData(view)
+  test:assertEquals(64, fromview:getWidth(), 'check view width')
+  test:assertEquals(love.image.newCompressedData('resources/love.dxt1'):getString(), fromview:getString(), 'check view data')
 end
 
 
@@ -133,4 +275,86 @@ end
 love.test.image.newImageData = function(test)
   test:assertObject(love.image.newImageData('resources/love.png'))
   test:assertObject(love.image.newImageData(16, 16, 'rgba8', nil))
+  -- check decoding a slice of a larger bundle through a DataView
+  local png = love.filesystem.read('resources/love.png')
+  local bundle = love.data.newByteData('header' .. png .. 'footer')
+  local fromview = love.image.newImageData(love.data.newDataView(bundle, 6, #png))
+  test:assertEquals(64, fromview:getWidth(), 'check view width')
+
+  -- check png decoding gives back the encoded pixels, for 8 and 16 bits
+  for _, format in ipairs({'rgba8', 'rgba16'}) do
+    local src = love.image.newImageData(37, 5, format)
+    src:mapPixel(function(x, y)
+      return (x * 7 % 32) / 31, y / 4, ((x + y) % 3) / 2, 1 - x / 36
+    end)
+    local decoded = love.image.newImageData(src:encode('png'))
+    test:assertEquals(format, decoded:getFormat(), 'check ' .. format .. ' png format')
+    local matching = true
+    for y=0,4 do
+      for x=0,36 do
+        local r1, g1, b1, a1 = src:getPixel(x, y)
+        local r2, g2, b2, a2 = decoded:getPixel(x, y)
+        if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+          matching = false
+        end
+      end
+    end
+    test:assertTrue(matching, 'check ' .. format .. ' png pixels')
+  end
+  test:assertFalse(pcall(love.image.newImageData, love.data.newByteData('\137PNG\r\n\26\n')), 'check truncated png')
+
+  -- check compact decoding keeps indexed and grayscale pngs in r8 and rg8
+  local indexed = love.data.newByteData('\137PNG\13\10\26\10\0\0\0\13IHDR\0\0\0\3\0\0\0\2\8\3\0\0\0\170\170\150(\0\0\0\9PLTE\255\0\0\0\255\0\0\0\255-J\205\138\0\0\0\2tRNS\255\128\8\15\179j\0\0\0\16IDATx\156c``db`bd\0\0\0 \0\7\29+p\160\0\0\0\0IEND\174B`\130')
+  local expanded = love.image.newImageData(indexed)
+  test:assertEquals('rgba8', expanded:getFormat(), 'check indexed png default format')
+  local indices, palette = love.image.newImageData(indexed, { compact = true })
+  test:assertEquals('r8', indices:getFormat(), 'check indexed png compact format')
+  test:assertEquals(3, palette:getWidth(), 'check palette size')
+  test:assertEquals(1, palette:getHeight(), 'check palette height')
+  test:assertEquals(2, indices:getPixel(0, 1) * 255, 'check palette index')
+  local pr, pg, pb, pa = palette:getPixel(1, 0)
+  test:assertEquals(1, pg, 'check palette color')
+  test:assertRange(pa, 0.5, 0.51, 'check palette alpha')
+  local grayalpha = love.data.newByteData('\137PNG\13\10\26\10\0\0\0\13IHDR\0\0\0\2\0\0\0\1\8\4\0\0\0^+\183\1\0\0\0\13IDATx\156cp\248\127\128\1\0\5\130\2\0\8\231\221\152\0\0\0\0IEND\174B`\130')
+  local gadata, gapalette = love.image.newImageData(grayalpha, { compact = true })
+  test:assertEquals('rg8', gadata:getFormat(), 'check gray alpha png compact format')
+  test:assertEquals(nil, gapalette, 'check no palette for gray alpha png')
+  local gr, ga = gadata:getPixel(1, 0)
+  test:assertEquals(192, gr * 255, 'check gray alpha png gray')
+  test:assertEquals(0, ga, 'check gray alpha png alpha')
+end
+
+
+-- love.image.newImageDataAsync
+love.test.image.newImageDataAsync = function(test)
+  local imgdata = love.image.newImageData('resources/love.png')
+
+  -- single files
+  local decode = love.image.newImageDataAsync('resources/love.png')
+  test:assertObject(decode)
+  decode:wait()
+  test:assertTrue(decode:isComplete(), 'check decode complete')
+  test:assertEquals(nil, decode:getError(), 'check no decode error')
+  local asyncdata = decode:getImageData()
+  test:assertObject(asyncdata)
+  test:assertEquals(imgdata:getWidth(), asyncdata:getWidth(), 'check async width')
+  test:assertEquals(imgdata:getHeight(), asyncdata:getHeight(), 'check async height')
+  local r1, g1, b1, a1 = imgdata:getPixel(8, 8)
+  local r2, g2, b2, a2 = asyncdata:getPixel(8, 8)
+  test:assertEquals(r1, r2, 'check async pixel r')
+  test:assertEquals(a1, a2, 'check async pixel a')
+
+  -- batches of files
+  local decodes = love.image.newImageDataAsync({'resources/love.png', love.filesystem.newFileData('resources/love.png')})
+  test:assertEquals(2, #decodes, 'check batch decode count')
+  for i=1,#decodes do
+    test:assertEquals(imgdata:getWidth(), decodes[i]:getImageData():getWidth(), 'check batch decode ' .. i)
+  end
+
+  -- invalid data
+  local baddecode = love.image.newImageDataAsync(love.filesystem.newFileData('not an image', 'bad.png'))
+  baddecode:wait()
+  test:assertNotEquals(nil, baddecode:getError(), 'check decode error')
+  local ok = pcall(baddecode.getImageData, baddecode)
+  test:assertFalse(ok, 'check failed decode errors')
 end
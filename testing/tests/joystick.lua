@@ -2,6 +2,48 @@
 -- @NOTE we can't test this module fully as it's hardware dependent
 -- however we can test methods do what is expected and can handle certain params
 
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+------------------------------------OBJECTS-------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- Joystick (love.joystick.getJoysticks)
+love.test.joystick.Joystick = function(test)
+
+  -- skip without a connected joystick, runners don't have one
+  local joystick = love.joystick.getJoysticks()[1]
+  if joystick == nil then
+    return test:skipTest('cant test this works: no joysticks found')
+  end
+
+  -- check getState matches the single input getters
+  local state = joystick:getState()
+  test:assertEquals(joystick:getAxisCount(), #state.axes, 'check axis count')
+  test:assertEquals(joystick:getButtonCount(), #state.buttons, 'check button count')
+  test:assertEquals(joystick:getHatCount(), #state.hats, 'check hat count')
+  test:assertEquals('table', type(state.gamepadaxes), 'check gamepad axes')
+  test:assertEquals('table', type(state.gamepadbuttons), 'check gamepad buttons')
+  test:assertEquals('table', type(state.sensors), 'check sensors')
+
+  -- check a given table and its subtables are reused
+  local axes = state.axes
+  local reused = joystick:getState(state)
+  test:assertEquals(state, reused, 'check table reused')
+  test:assertEquals(axes, reused.axes, 'check subtable reused')
+
+  -- check packing into Data, which has to fit every value
+  local count = joystick:getAxisCount() + joystick:getButtonCount() + joystick:getHatCount()
+  local data = love.data.newByteData(4096)
+  local written = joystick:getState(data)
+  test:assertGreaterEqual(count, written, 'check value count')
+  local ok = pcall(joystick.getState, joystick, love.data.newByteData(4))
+  test:assertFalse(ok, 'check Data too small')
+
+end
+
+
 --------------------------------------------------------------------------------
 --------------------------------------------------------------------------------
 ------------------------------------METHODS-------------------------------------
@@ -8,6 +8,74 @@
 --------------------------------------------------------------------------------
 
 
+-- love.getMemoryStats
+love.test.love.getMemoryStats = function(test)
+  local before = love.getMemoryStats('data')
+  local data = love.data.newByteData(4096)
+  local current, peak, allocations = love.getMemoryStats('data')
+  test:assertEquals(before + 4096, current, 'check allocation tracked')
+  test:assertGreaterEqual(current, peak, 'check peak')
+  test:assertGreaterEqual(1, allocations, 'check allocation count')
+  data:release()
+  test:assertEquals(before, love.getMemoryStats('data'), 'check release tracked')
+
+  local stats = love.getMemoryStats()
+  for i, name in ipairs({'data', 'file', 'image', 'sound', 'font', 'physics'}) do
+    test:assertNotNil(stats[name])
+    test:assertGreaterEqual(0, stats[name].current, 'check ' .. name .. ' current')
+  end
+  test:assertGreaterEqual(1, stats.lua.current, 'check lua heap')
+
+  love.resetMemoryPeaks()
+  local _, newpeak = love.getMemoryStats('data')
+  test:assertEquals(before, newpeak, 'check peak reset')
+  test:assertEquals(false, pcall(love.getMemoryStats, 'invalid'), 'check invalid category')
+end
+
+
+-- love.getGCStats
+love.test.love.getGCStats = function(test)
+  test:assertEquals(nil, love.getGCFrameBudget(), 'check scheduler disabled by default')
+  love.resetGCStats()
+  test:assertEquals(0, love.getGCStats().frames, 'check no steps when disabled')
+  love.setGCFrameBudget(0.1)
+  test:assertEquals(0.1, love.getGCFrameBudget(), 'check budget set')
+  local garbage = {}
+  for i=1,10000 do garbage[i] = { i } end
+  garbage = nil
+  test:waitFrames(5)
+  local stats = love.getGCStats()
+  love.setGCFrameBudget(nil)
+  test:assertEquals(nil, love.getGCFrameBudget(), 'check budget cleared')
+  test:assertGreaterEqual(1, stats.frames, 'check frames with steps')
+  test:assertGreaterEqual(stats.frames, stats.steps, 'check steps')
+  test:assertGreaterEqual(0, stats.time, 'check time')
+  test:assertGreaterEqual(stats.lastpause, stats.maxpause, 'check max pause')
+  test:assertEquals(true, love.setGCMode('incremental'), 'check incremental mode')
+  test:assertEquals('boolean', type(love.setGCMode('generational')), 'check generational mode')
+  love.setGCMode('incremental')
+  test:assertEquals(false, pcall(love.setGCMode, 'invalid'), 'check invalid mode')
+end
+
+
+-- love.getStartupTimes
+love.test.love.getStartupTimes = function(test)
+  local times = love.getStartupTimes()
+  local names = {}
+  for _,v in ipairs(times) do
+    test:assertEquals('string', type(v.name), 'check name')
+    test:assertGreaterEqual(0, v.time, 'check time')
+    names[v.name] = true
+  end
+  test:assertTrue(names['conf'] ~= nil, 'check conf timed')
+  test:assertTrue(names['love.graphics'] ~= nil, 'check module timed')
+  test:assertTrue(names['main'] ~= nil, 'check main timed')
+  -- the returned table is a copy
+  if #times > 0 then times[1].time = -1 end
+  test:assertGreaterEqual(0, love.getStartupTimes()[1].time, 'check copy')
+end
+
+
 -- love.getVersion
 love.test.love.getVersion = function(test)
   local major, minor, revision, codename = love.getVersion()
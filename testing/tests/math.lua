@@ -60,6 +60,30 @@ love.test.math.BezierCurve = function(test)
   test:assertEquals(196, #coords1, 'check coords')
   test:assertEquals(20, #coords2, 'check segment coords')
 
+  -- check adaptive rendering: a straight curve needs only its endpoints,
+  -- a tighter tolerance gives more points, and the result follows edits
+  local straight = love.math.newBezierCurve(0, 0, 1, 1, 2, 2, 3, 3)
+  test:assertEquals(4, #straight:renderAdaptive(0.1), 'check straight adaptive coords')
+  local wave = love.math.newBezierCurve(0, 0, 100, 300, 200, -300, 300, 0)
+  local coarse = wave:renderAdaptive(1)
+  local fine = wave:renderAdaptive(0.01)
+  test:assertGreaterEqual(#coarse + 1, #fine, 'check finer tolerance adds coords')
+  test:assertCoords({0, 0}, {fine[1], fine[2]}, 'check adaptive start')
+  test:assertCoords({300, 0}, {fine[#fine - 1], fine[#fine]}, 'check adaptive end')
+  local data, count = wave:renderAdaptive(0.01, love.data.newByteData(8))
+  test:assertEquals(#fine / 2, count, 'check adaptive data count')
+  test:assertEquals(fine[3], data:getFloat(8), 'check adaptive data x')
+  wave:setControlPoint(2, 100, 0)
+  wave:setControlPoint(3, 200, 0)
+  test:assertEquals(4, #wave:renderAdaptive(0.01), 'check adaptive cache reset')
+
+  -- check evaluating many points at once
+  local points = wave:evaluatePoints(5)
+  for i=0,4 do
+    local x, y = wave:evaluate(i / 4)
+    test:assertCoords({x, y}, {points:getFloat(i * 8), points:getFloat(i * 8 + 4)}, 'check evaluatePoints ' .. i)
+  end
+
   -- check translation values
   px, py = curve:getControlPoint(2)
   test:assertCoords({3, 2}, {px, py}, 'check pretransform x/y')
@@ -104,6 +128,33 @@ love.test.math.RandomGenerator = function(test)
   test:assertNotEquals(rng1:random(), rng2:random(), 'check not matching states')
   test:assertNotEquals(rng1:randomNormal(), rng2:randomNormal(), 'check not matching states')
 
+  -- check bulk fills match individual calls and leave the same state
+  local data = love.data.newByteData(4 * 9)
+  rng2:setState(rng1:getState())
+  test:assertEquals(9, rng1:fill(data), 'check fill count')
+  for i=0,8 do
+    local expected = rng2:random()
+    test:assertRange(data:getFloat(i * 4), expected - 1e-6, expected + 1e-6, 'check fill uniform ' .. i)
+  end
+  test:assertEquals(rng1:getState(), rng2:getState(), 'check fill uniform state')
+  rng1:fill(data, 'integer', -5, 17)
+  for i=0,8 do
+    test:assertEquals(rng2:random(-5, 17), data:getInt32(i * 4), 'check fill integer ' .. i)
+  end
+  rng1:fill(data, 'normal', 2, 10)
+  for i=0,8 do
+    local expected = rng2:randomNormal(2, 10)
+    test:assertRange(data:getFloat(i * 4), expected - 1e-5, expected + 1e-5, 'check fill normal ' .. i)
+  end
+  test:assertEquals(rng1:randomNormal(), rng2:randomNormal(), 'check fill normal cache')
+
+  -- check jumping gives a matching independent stream
+  rng2:setState(rng1:getState())
+  rng1:jump()
+  test:assertNotEquals(rng1:getState(), rng2:getState(), 'check jump changes state')
+  rng2:jump()
+  test:assertEquals(rng1:random(), rng2:random(), 'check jump matching')
+
 end
 
 
@@ -164,6 +215,21 @@ love.test.math.Transform = function(test)
   transform:setMatrix(1, 3, 4, 5.5, 1, 4.5, 2, 1, 3.4, 5.1, 4.1, 13, 1, 1, 2, 3)
   test:assertFalse(transform:isAffine2DTransform(), 'check not affine')
 
+  -- check transforming many points in a Data
+  transform:setTransformation(10, 20, math.pi/2, 2, 2)
+  local points = love.data.newByteData(5 * 2 * 4)
+  for i=0,9 do points:setFloat(i * 4, i) end
+  local transformed = love.data.newByteData(5 * 2 * 4)
+  transform:transformPoints(points, transformed)
+  transform:transformPoints(points)
+  local function round(v) return math.floor(v * 1000 + 0.5) end
+  for i=0,4 do
+    px, py = transform:transformPoint(i * 2, i * 2 + 1)
+    local tx, ty = transformed:getFloat(i * 8), transformed:getFloat(i * 8 + 4)
+    test:assertCoords({round(px), round(py)}, {round(tx), round(ty)}, 'check transformPoints ' .. i)
+    test:assertCoords({tx, ty}, {points:getFloat(i * 8), points:getFloat(i * 8 + 4)}, 'check in-place transformPoints ' .. i)
+  end
+
 end
 
 
@@ -220,6 +286,77 @@ love.test.math.colorToBytes = function(test)
 end
 
 
+-- love.math.composeTransforms
+love.test.math.composeTransforms = function(test)
+  -- a chain of 3 bones, each translated by 10 along the rotated x axis of
+  -- its parent and rotated by 90 degrees
+  local locals = love.data.newByteData(3 * 6 * 4)
+  for i=0,2 do
+    local c, s = math.cos(math.pi/2), math.sin(math.pi/2)
+    local values = {c, s, -s, c, i == 0 and 0 or 10, 0}
+    for j=1,6 do locals:setFloat((i * 6 + j - 1) * 4, values[j]) end
+  end
+  local world = love.data.newByteData(3 * 6 * 4)
+  love.math.composeTransforms(locals, {0, 1, 2}, world, love.math.newTransform(5, 5))
+  -- the translation of each bone in world space
+  local expected = {{5, 5}, {5, 15}, {-5, 15}}
+  for i=0,2 do
+    local x, y = world:getFloat((i * 6 + 4) * 4), world:getFloat((i * 6 + 5) * 4)
+    test:assertCoords(expected[i + 1], {math.floor(x + 0.5), math.floor(y + 0.5)}, 'check bone ' .. i .. ' position')
+  end
+  -- parents given as 0-based int32 Data, composed in place
+  local parents = love.data.newByteData(3 * 4)
+  parents:setInt32(0, -1, 0, 1)
+  love.math.composeTransforms(locals, parents, nil, love.math.newTransform(5, 5))
+  for i=0,23 do
+    test:assertEquals(world:getFloat(i * 4), locals:getFloat(i * 4), 'check in-place compose ' .. i)
+  end
+  -- parents must come before their children
+  local ok = pcall(love.math.composeTransforms, locals, {0, 3, 1}, world)
+  test:assertFalse(ok, 'check invalid parent order')
+end
+
+
+-- love.math.fillNoise
+love.test.math.fillNoise = function(test)
+  -- a float grid should match sampling the noise functions one at a time
+  local width, height = 19, 7
+  local data = love.data.newByteData(width * height * 4)
+  love.math.fillNoise(data, width, height, { type = 'perlin', x = 1.5, y = -2.25, scale = 0.37 })
+  local worst = 0
+  for y=0,height-1 do
+    for x=0,width-1 do
+      local expected = love.math.perlinNoise(1.5 + x * 0.37, -2.25 + y * 0.37)
+      local actual = data:getFloat((y * width + x) * 4)
+      worst = math.max(worst, math.abs(expected - actual))
+    end
+  end
+  test:assertRange(worst, 0, 0.0001, 'check perlin grid matches perlinNoise')
+  -- octaves are summed and normalized back into [0, 1]
+  love.math.fillNoise(data, width, height, { octaves = 4, scalex = 0.11, scaley = 0.23 })
+  local minv, maxv = 1, 0
+  for i=0,width*height-1 do
+    local v = data:getFloat(i * 4)
+    minv, maxv = math.min(minv, v), math.max(maxv, v)
+  end
+  test:assertRange(minv, 0, 1, 'check fractal minimum')
+  test:assertRange(maxv, 0, 1, 'check fractal maximum')
+  test:assertNotEquals(minv, maxv, 'check fractal values vary')
+  -- imagedata is filled with grey, opaque pixels
+  local imgdata = love.image.newImageData(8, 8)
+  love.math.fillNoise(imgdata, { x = 3, y = 4, scale = 0.2 })
+  local r, g, b, a = imgdata:getPixel(5, 6)
+  local expected = love.math.simplexNoise(3 + 5 * 0.2, 4 + 6 * 0.2)
+  test:assertRange(r, expected - 1/255, expected + 1/255, 'check imagedata noise value')
+  test:assertEquals(r, g, 'check imagedata g')
+  test:assertEquals(r, b, 'check imagedata b')
+  test:assertEquals(1, a, 'check imagedata a')
+  -- data must be large enough for the grid
+  local ok = pcall(love.math.fillNoise, data, width, height + 1)
+  test:assertFalse(ok, 'check data too small')
+end
+
+
 -- love.math.gammaToLinear
 -- @NOTE I tried doing the same formula as the source from MathModule.cpp
 -- but get test failues due to slight differences
@@ -361,8 +498,49 @@ end
 
 -- love.math.triangulate
 love.test.math.triangulate = function(test)
-  local triangles1 = love.math.triangulate({0, 0, 1, 0, 1, 1, 1, 0, 0, 0}) -- square
-  local triangles2 = love.math.triangulate({1, 2, 2, 4, 3, 4, 2, 1, 3, 1}) -- weird shape
-  test:assertEquals(3, #triangles1, 'check polygon triangles')
+  local triangles1 = love.math.triangulate({0, 0, 1, 0, 1, 1, 0, 1}) -- square
+  local triangles2 = love.math.triangulate({1, 2, 2, 4, 3, 4, 2, 3, 3, 1}) -- weird shape
+  test:assertEquals(2, #triangles1, 'check polygon triangles')
   test:assertEquals(3, #triangles2, 'check polygon triangles')
+  -- a square hole in a square leaves 8 triangles covering the ring
+  local outer = {0, 0, 10, 0, 10, 10, 0, 10}
+  local hole = {3, 3, 7, 3, 7, 7, 3, 7}
+  local triangles3 = love.math.triangulate(outer, {hole})
+  test:assertEquals(8, #triangles3, 'check polygon with hole triangles')
+  local area = 0
+  for _, t in ipairs(triangles3) do
+    area = area + math.abs((t[3] - t[1]) * (t[6] - t[2]) - (t[4] - t[2]) * (t[5] - t[1])) / 2
+  end
+  test:assertEquals(84, area, 'check polygon with hole area')
+  -- a large polygon
+  local circle = {}
+  for i=0,1999 do
+    local a = i / 2000 * math.pi * 2
+    local r = 100 + 10 * math.sin(a * 17)
+    table.insert(circle, math.cos(a) * r)
+    table.insert(circle, math.sin(a) * r)
+  end
+  test:assertEquals(1998, #love.math.triangulate(circle), 'check large polygon triangles')
+end
+
+
+-- love.math.triangulateIndices
+love.test.math.triangulateIndices = function(test)
+  local outer = {0, 0, 10, 0, 10, 10, 0, 10}
+  local hole = {3, 3, 7, 3, 7, 7, 3, 7}
+  local data, indextype, count = love.math.triangulateIndices(outer, {hole})
+  test:assertObject(data)
+  test:assertEquals('uint16', indextype, 'check index type')
+  test:assertEquals(24, count, 'check index count')
+  test:assertEquals(count * 2, data:getSize(), 'check index data size')
+  -- indices refer to the outer vertices followed by the hole's
+  local used = {}
+  for i=0,count-1 do
+    local index = data:getUInt16(i * 2)
+    test:assertRange(index, 0, 7, 'check index range')
+    used[index] = true
+  end
+  for i=0,7 do
+    test:assertTrue(used[i] == true, 'check vertex ' .. i .. ' used')
+  end
 end
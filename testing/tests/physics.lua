@@ -204,10 +204,29 @@ love.test.physics.Body = function(test)
   test:assertRange(ang4, -1, 0, 'check angle after 4')
   test:assertRange(vel4, 0, 1, 'check velocity after 4')
 
+  -- check chains from a Data, and only changed chains being replaced
+  local terrain = love.physics.newBody(world, 0, 0, 'static')
+  local fmt = string.rep('f', 10)
+  local data1 = love.data.pack('data', fmt, 0, 0, 10, 0, 20, 5, 0, 20, 10, 20)
+  local chains1 = terrain:setChains(data1, { 3, 2 })
+  test:assertEquals(2, #chains1, 'check chain count')
+  test:assertEquals(3, chains1[1]:getVertexCount(), 'check chain vertices')
+  local data2 = love.data.pack('data', fmt, 0, 0, 10, 0, 20, 5, 0, 30, 10, 30)
+  local chains2 = terrain:setChains(data2, { 3, 2 })
+  test:assertEquals(chains1[1], chains2[1], 'check unchanged chain kept')
+  test:assertTrue(chains1[2]:isDestroyed(), 'check changed chain replaced')
+  test:assertEquals(2, #terrain:getShapes(), 'check shape count')
+  test:assertEquals(1, #terrain:setChains(data2, { 3 }), 'check fewer chains')
+  test:assertEquals(1, #terrain:getShapes(), 'check removed chains')
+  local ok = pcall(terrain.setChains, terrain, data2, { 3, 3 })
+  test:assertFalse(ok, 'check data too small')
+
   -- check destroy
   test:assertFalse(body1:isDestroyed(), 'check not destroyed')
   body1:destroy()
   test:assertTrue(body1:isDestroyed(), 'check destroyed')
+  local ok, _ = pcall(body1.getPosition, body1)
+  test:assertFalse(ok, 'check destroyed body errors')
 
 end
 
@@ -294,6 +313,27 @@ love.test.physics.Contact = function(test)
   world:update(1)
   test:assertEquals(2, pass, 'check ran twice')
 
+  -- contacts are invalidated along with their bodies
+  local contacts = world:getContacts()
+  test:assertGreaterEqual(1, #contacts, 'check contacts exist')
+  body2:destroy()
+  for i=1,#contacts do
+    test:assertTrue(contacts[i]:isDestroyed(), 'check contact destroyed ' .. i)
+  end
+
+  -- churn through bodies and contacts
+  world:setCallbacks()
+  for i=1,100 do
+    local body = love.physics.newBody(world, 0, 0, 'dynamic')
+    love.physics.newCircleShape(body, 5)
+    world:update(1/60)
+    for _, contact in ipairs(world:getContacts()) do
+      test:assertFalse(contact:isDestroyed(), 'check new contact valid')
+    end
+    body:destroy()
+  end
+  test:assertEquals(1, world:getBodyCount(), 'check bodies destroyed')
+
 end
 
 
@@ -504,6 +544,63 @@ love.test.physics.Shape = function(test)
 end
 
 
+-- SpatialIndex (love.physics.newSpatialIndex)
+love.test.physics.SpatialIndex = function(test)
+
+  for _, method in ipairs({'tree', 'grid'}) do
+    local index = love.physics.newSpatialIndex(method, 32)
+    test:assertObject(index)
+    test:assertEquals(method, index:getMethod(), 'check method ' .. method)
+
+    -- insert, move and remove by handle
+    local a = index:insert(0, 0, 10, 10)
+    local b = index:insert(100, 0, 10, 10)
+    local c = index:insert(0, 100, 10, 10)
+    test:assertEquals(3, index:getCount(), 'check count ' .. method)
+    index:move(c, 200, 200)
+    local x, y, w, h = index:getBoundingBox(c)
+    test:assertEquals(200, x, 'check moved x ' .. method)
+    test:assertEquals(10, w, 'check kept width ' .. method)
+    index:remove(b)
+    test:assertFalse(index:contains(b), 'check removed ' .. method)
+    test:assertEquals(b, index:insert(100, 0, 10, 10), 'check handle reuse ' .. method)
+
+    -- area and radius queries, reusing the output table
+    local out = {1, 2, 3, 4, 5}
+    local result, count = index:queryBoundingBox(-5, -5, 20, 20, out)
+    test:assertEquals(out, result, 'check reused table ' .. method)
+    test:assertEquals(1, count, 'check area count ' .. method)
+    test:assertEquals(a, out[1], 'check area handle ' .. method)
+    test:assertEquals(nil, out[2], 'check stale entries ' .. method)
+    local _, rcount = index:queryRadius(105, 5, 50)
+    test:assertEquals(1, rcount, 'check radius count ' .. method)
+
+    -- rays return handle, fraction pairs sorted by fraction
+    local hits, hcount = index:rayCast(-50, 5, 150, 5)
+    test:assertEquals(2, hcount, 'check ray count ' .. method)
+    test:assertEquals(a, hits[1], 'check closest hit ' .. method)
+    test:assertEquals(b, hits[3], 'check farthest hit ' .. method)
+    test:assertRange(hits[2], 0.24, 0.26, 'check hit fraction ' .. method)
+
+    -- batches of queries
+    local handles, counts = index:queryBoundingBoxBatch({-5, -5, 20, 20, 195, 195, 20, 20, 500, 500, 1, 1})
+    test:assertEquals(2, #handles, 'check batch handles ' .. method)
+    test:assertEquals(1, counts[1], 'check batch count 1 ' .. method)
+    test:assertEquals(c, handles[2], 'check batch handle ' .. method)
+    test:assertEquals(0, counts[3], 'check batch count 3 ' .. method)
+    local data = love.data.newByteData(4 * 2)
+    index:queryRadiusBatch({5, 5, 1, 205, 205, 1}, data)
+    local h1, h2 = love.data.unpack('i4i4', data)
+    test:assertEquals(a, h1, 'check batch data 1 ' .. method)
+    test:assertEquals(c, h2, 'check batch data 2 ' .. method)
+
+    index:clear()
+    test:assertEquals(0, index:getCount(), 'check cleared ' .. method)
+  end
+
+end
+
+
 -- World (love.physics.newWorld)
 love.test.physics.World = function(test)
 
@@ -532,6 +629,13 @@ love.test.physics.World = function(test)
   world:setSleepingAllowed(true)
   test:assertTrue(world:isSleepingAllowed(), 'check can sleep')
 
+  -- check multithreading
+  test:assertFalse(world:isMultithreaded(), 'check not multithreaded by default')
+  world:setMultithreaded(true)
+  test:assertTrue(world:isMultithreaded(), 'check multithreaded')
+  world:setMultithreaded(false)
+  test:assertFalse(world:isMultithreaded(), 'check multithreaded disabled')
+
   -- check world objects
   test:assertEquals(0, #world:getJoints(), 'check no joints')
   test:assertEquals(0, world:getJointCount(), 'check no joints count')
@@ -607,6 +711,344 @@ love.test.physics.World = function(test)
 end
 
 
+-- World (multithreaded)
+love.test.physics.WorldMultithreaded = function(test)
+
+  -- build the same piles of boxes in two worlds
+  local function build(world)
+    local bodies = {}
+    for p = 0, 9 do
+      local ground = love.physics.newBody(world, p * 200, 0, 'static')
+      love.physics.newRectangleShape(ground, 0, 0, 120, 10)
+      for i = 1, 10 do
+        local body = love.physics.newBody(world, p * 200 + (i % 3) * 11, -10 - i * 11, 'dynamic')
+        love.physics.newRectangleShape(body, 0, 0, 10, 10)
+        table.insert(bodies, body)
+      end
+    end
+    return bodies
+  end
+
+  local world1 = love.physics.newWorld(0, 100, true)
+  local world2 = love.physics.newWorld(0, 100, true)
+  world2:setMultithreaded(true)
+  local bodies1 = build(world1)
+  local bodies2 = build(world2)
+
+  -- callbacks are still called on this thread, in the same order
+  local events1, events2 = {}, {}
+  world1:setCallbacks(function() table.insert(events1, 'begin') end, nil, nil,
+    function(a, b, c, n) table.insert(events1, n) end)
+  world2:setCallbacks(function() table.insert(events2, 'begin') end, nil, nil,
+    function(a, b, c, n) table.insert(events2, n) end)
+
+  for i = 1, 60 do
+    world1:update(1/60)
+    world2:update(1/60)
+  end
+
+  for i = 1, #bodies1 do
+    local x1, y1 = bodies1[i]:getPosition()
+    local x2, y2 = bodies2[i]:getPosition()
+    test:assertEquals(x1, x2, 'check same x ' .. i)
+    test:assertEquals(y1, y2, 'check same y ' .. i)
+  end
+  test:assertEquals(#events1, #events2, 'check same callback count')
+  test:assertGreaterEqual(1, #events2, 'check callbacks called')
+  for i = 1, #events1 do
+    test:assertEquals(events1[i], events2[i], 'check same callback ' .. i)
+  end
+
+  world1:destroy()
+  world2:destroy()
+
+end
+
+
+-- World (kinematic states)
+love.test.physics.WorldKinematicStates = function(test)
+
+  local world = love.physics.newWorld(0, 0, false)
+  local body1 = love.physics.newBody(world, 10, 20, 'kinematic')
+  local body2 = love.physics.newBody(world, 30, 40, 'dynamic')
+  body1:setAngle(0.5)
+  body2:setLinearVelocity(5, 6)
+
+  -- read every body in the world, in the same order as getBodies
+  local data = love.data.newByteData(2 * 6 * 4)
+  test:assertEquals(2, world:getKinematicStates(data), 'check state count')
+  local bodies = world:getBodies()
+  for i, body in ipairs(bodies) do
+    local x, y, a, vx, vy = love.data.unpack('fffff', data, (i - 1) * 24 + 1)
+    local bx, by = body:getPosition()
+    local bvx, bvy = body:getLinearVelocity()
+    test:assertEquals(math.floor(bx + 0.5), math.floor(x + 0.5), 'check x ' .. i)
+    test:assertEquals(math.floor(by + 0.5), math.floor(y + 0.5), 'check y ' .. i)
+    test:assertRange(a, body:getAngle() - 0.01, body:getAngle() + 0.01, 'check angle ' .. i)
+    test:assertEquals(math.floor(bvx + 0.5), math.floor(vx + 0.5), 'check vx ' .. i)
+    test:assertEquals(math.floor(bvy + 0.5), math.floor(vy + 0.5), 'check vy ' .. i)
+  end
+
+  -- read and write a subset of bodies
+  test:assertEquals(1, world:getKinematicStates(data, {body2}), 'check subset count')
+  test:assertEquals(30, math.floor(love.data.unpack('f', data) + 0.5), 'check subset x')
+  local states = love.data.newByteData(love.data.pack('data', 'ffffff', 1, 2, 0, 3, 4, 1))
+  test:assertEquals(1, world:setKinematicStates(states, {body1}), 'check set count')
+  local x, y = body1:getPosition()
+  test:assertEquals(1, math.floor(x + 0.5), 'check set x')
+  test:assertEquals(2, math.floor(y + 0.5), 'check set y')
+  local vx, vy = body1:getLinearVelocity()
+  test:assertEquals(3, math.floor(vx + 0.5), 'check set vx')
+  test:assertEquals(4, math.floor(vy + 0.5), 'check set vy')
+  test:assertEquals(1, body1:getAngularVelocity(), 'check set angular velocity')
+
+  -- data must be big enough
+  local ok = pcall(world.getKinematicStates, world, love.data.newByteData(4))
+  test:assertFalse(ok, 'check data too small')
+
+  world:destroy()
+
+end
+
+
+-- World (buffered contact events)
+love.test.physics.WorldDebugDraw = function(test)
+
+  local world = love.physics.newWorld(0, 0, false)
+  local body = love.physics.newBody(world, 8, 8, 'static')
+  love.physics.newRectangleShape(body, 0, 0, 8, 8)
+
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.setColor(1, 1, 1, 1)
+    world:debugDraw({joints = false, centers = true})
+  love.graphics.setCanvas()
+
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b = imgdata:getPixel(9, 9)
+  test:assertGreaterEqual(0.1, g, 'check shape drawn')
+  r, g, b = imgdata:getPixel(0, 0)
+  test:assertEquals(0, r + g + b, 'check outside shape')
+  test:assertFalse(pcall(world.debugDraw, world, 1), 'check invalid options')
+
+  world:destroy()
+
+end
+
+
+love.test.physics.WorldFixedTimestep = function(test)
+
+  local world = love.physics.newWorld(0, 0, false)
+  local body = love.physics.newBody(world, 0, 0, 'dynamic')
+  body:setLinearVelocity(4, 0)
+  world:setFixedTimestep(0.25, 4)
+  local step, maxsteps = world:getFixedTimestep()
+  test:assertEquals(0.25, step, 'check step')
+  test:assertEquals(4, maxsteps, 'check max steps')
+
+  -- not enough time for a step yet
+  world:update(0.125)
+  test:assertEquals(0, math.floor(body:getX() + 0.5), 'check no step')
+  test:assertEquals(0.5, world:getInterpolationAlpha(), 'check partial alpha')
+
+  -- one step, with the leftover time carried over
+  world:update(0.25)
+  test:assertEquals(1, math.floor(body:getX() + 0.5), 'check one step')
+  test:assertEquals(0.5, world:getInterpolationAlpha(), 'check carried alpha')
+  local data = love.data.newByteData(6 * 4)
+  world:getKinematicStates(data, {body}, 0, true)
+  test:assertRange(love.data.unpack('f', data), 0.49, 0.51, 'check interpolated x')
+  world:getKinematicStates(data, {body})
+  test:assertEquals(1, math.floor(love.data.unpack('f', data) + 0.5), 'check current x')
+
+  -- the number of steps per update is limited
+  world:update(10)
+  test:assertEquals(5, math.floor(body:getX() + 0.5), 'check max steps')
+  test:assertEquals(0.5, world:getInterpolationAlpha(), 'check alpha after max steps')
+
+  -- disabling
+  world:setFixedTimestep(0)
+  test:assertEquals(1, world:getInterpolationAlpha(), 'check disabled alpha')
+  test:assertFalse(pcall(world.setFixedTimestep, world, -1), 'check negative step')
+
+  world:destroy()
+
+end
+
+
+love.test.physics.WorldState = function(test)
+
+  local world = love.physics.newWorld(0, 100, true)
+  local ground = love.physics.newBody(world, 0, 100, 'static')
+  love.physics.newRectangleShape(ground, 0, 0, 200, 10)
+  local bodies = {}
+  for i=1,5 do
+    local body = love.physics.newBody(world, i * 12 - 36, 50 - i * 10, 'dynamic')
+    love.physics.newRectangleShape(body, 0, 0, 10, 10)
+    body:setAngularVelocity(i)
+    table.insert(bodies, body)
+  end
+  local function positions()
+    local values = {}
+    for _, body in ipairs(bodies) do
+      local x, y = body:getPosition()
+      table.insert(values, x)
+      table.insert(values, y)
+      table.insert(values, body:getAngle())
+    end
+    return values
+  end
+
+  for i=1,30 do world:update(1/60) end
+  local state = world:saveState()
+  test:assertObject(state)
+  test:assertEquals(state, world:saveState(state), 'check data reused')
+
+  -- simulating again after restoring gives the same results
+  local expected = {}
+  for i=1,60 do
+    world:update(1/60)
+    table.insert(expected, positions())
+  end
+  for round=1,2 do
+    world:restoreState(state)
+    for i=1,60 do
+      world:update(1/60)
+      local values = positions()
+      for j=1,#values do
+        test:assertEquals(expected[i][j], values[j], 'check round ' .. round .. ' step ' .. i .. ' value ' .. j)
+      end
+    end
+  end
+
+  -- states only fit the World they were saved from
+  local body = love.physics.newBody(world, 0, 0, 'dynamic')
+  test:assertFalse(pcall(world.restoreState, world, state), 'check changed world')
+  body:destroy()
+  world:restoreState(state)
+  test:assertFalse(pcall(world.restoreState, world, love.data.newByteData(4)), 'check invalid data')
+
+  world:destroy()
+
+end
+
+
+love.test.physics.WorldQueryBatch = function(test)
+
+  local world = love.physics.newWorld(0, 0, false)
+  local body = love.physics.newBody(world, 0, 0, 'static')
+  local shape = love.physics.newRectangleShape(body, 0, 0, 10, 10)
+
+  -- one ray hitting the shape, one missing it
+  local rays = love.data.newByteData(love.data.pack('data', 'ffffffff', -20, 0, 20, 0, -20, 100, 20, 100))
+  local hits = love.data.newByteData(2 * 5 * 4)
+  local count, shapes = world:rayCastClosestBatch(rays, hits)
+  test:assertEquals(1, count, 'check hit count')
+  test:assertEquals(shape, shapes[1], 'check hit shape')
+  test:assertFalse(shapes[2], 'check missed shape')
+  local x, y, nx, ny, fraction = love.data.unpack('fffff', hits)
+  test:assertEquals(-5, math.floor(x + 0.5), 'check hit x')
+  test:assertEquals(0, math.floor(y + 0.5), 'check hit y')
+  test:assertEquals(-1, math.floor(nx + 0.5), 'check hit normal x')
+  test:assertRange(fraction, 0.37, 0.38, 'check hit fraction')
+  test:assertEquals(-1, love.data.unpack('f', hits, 5 * 4 + 17), 'check miss fraction')
+  test:assertEquals(1, world:rayCastAnyBatch(rays, hits), 'check any hit count')
+
+  -- results must fit
+  local ok = pcall(world.rayCastClosestBatch, world, rays, love.data.newByteData(4))
+  test:assertFalse(ok, 'check data too small')
+
+  -- areas
+  local areas = love.data.newByteData(love.data.pack('data', 'ffffffff', -1, -1, 1, 1, 50, 50, 60, 60))
+  local found, counts = world:getShapesInAreaBatch(areas)
+  test:assertEquals(1, #found, 'check shapes found')
+  test:assertEquals(shape, found[1], 'check shape found')
+  test:assertEquals(1, counts[1], 'check first area count')
+  test:assertEquals(0, counts[2], 'check second area count')
+
+  -- many rays on multiple threads match single raycasts
+  world:setMultithreaded(true)
+  local values = {}
+  for i=1,200 do
+    local y = i % 20 - 10
+    table.insert(values, love.data.pack('string', 'ffff', -20, y, 20, y))
+  end
+  rays = love.data.newByteData(table.concat(values))
+  hits = love.data.newByteData(200 * 5 * 4)
+  count, shapes = world:rayCastClosestBatch(rays, hits)
+  local expected = 0
+  for i=1,200 do
+    local y = i % 20 - 10
+    local hitshape = world:rayCastClosest(-20, y, 20, y)
+    if hitshape then expected = expected + 1 end
+    test:assertEquals(hitshape or false, shapes[i], 'check threaded hit ' .. i)
+  end
+  test:assertEquals(expected, count, 'check threaded hit count')
+
+  world:destroy()
+
+end
+
+
+love.test.physics.WorldContactEvents = function(test)
+
+  local world = love.physics.newWorld(0, 0, false)
+  local body1 = love.physics.newBody(world, 0, 0, 'static')
+  local shape1 = love.physics.newRectangleShape(body1, 0, 0, 10, 10)
+  local body2 = love.physics.newBody(world, 5, 5, 'dynamic')
+  local shape2 = love.physics.newRectangleShape(body2, 0, 0, 10, 10)
+
+  -- buffered events replace their callbacks
+  local callbacks = 0
+  world:setCallbacks(function() callbacks = callbacks + 1 end, nil, nil,
+    function() callbacks = callbacks + 1 end)
+  test:assertEquals(0, select('#', world:getBufferedContactEvents()), 'check no buffered events')
+  world:setBufferedContactEvents('begincontact', 'postsolve')
+  local types = {world:getBufferedContactEvents()}
+  test:assertEquals(2, #types, 'check buffered events')
+  test:assertEquals('begincontact', types[1], 'check buffered begin')
+  test:assertEquals('postsolve', types[2], 'check buffered postsolve')
+
+  world:update(1/60)
+  test:assertEquals(0, callbacks, 'check callbacks not called')
+  test:assertGreaterEqual(2, world:getContactEventCount(), 'check events recorded')
+
+  local begins, postsolves = 0, 0
+  for type, a, b, nx, ny, impulse in world:pollContactEvents() do
+    test:assertTrue(a == shape1 or a == shape2, 'check first shape')
+    test:assertTrue(b == shape1 or b == shape2, 'check second shape')
+    if type == 'begincontact' then
+      begins = begins + 1
+    elseif type == 'postsolve' then
+      postsolves = postsolves + 1
+      test:assertNotEquals(nil, impulse, 'check impulse')
+    end
+  end
+  test:assertEquals(1, begins, 'check begin event')
+  test:assertGreaterEqual(1, postsolves, 'check postsolve events')
+  test:assertEquals(0, world:getContactEventCount(), 'check events cleared by poll')
+
+  -- only record events for the given categories
+  world:setContactEventCategories(2)
+  test:assertEquals(2, world:getContactEventCategories(), 'check categories')
+  world:update(1/60)
+  test:assertEquals(0, world:getContactEventCount(), 'check events filtered')
+  shape2:setCategory(2)
+  world:update(1/60)
+  test:assertGreaterEqual(1, world:getContactEventCount(), 'check category events')
+
+  -- back to callbacks
+  world:setBufferedContactEvents()
+  world:update(1/60)
+  test:assertGreaterEqual(1, callbacks, 'check callbacks called')
+  test:assertEquals(0, world:getContactEventCount(), 'check no events')
+
+  world:destroy()
+
+end
+
+
 --------------------------------------------------------------------------------
 --------------------------------------------------------------------------------
 ------------------------------------METHODS-------------------------------------
@@ -634,6 +1076,20 @@ love.test.physics.getMeter = function(test)
 end
 
 
+-- love.physics.getStepTime
+love.test.physics.getStepTime = function(test)
+  local before = love.physics.getStepTime()
+  local world = love.physics.newWorld(0, 10, true)
+  for i=1,10 do
+    love.physics.newBody(world, i*10, 0, 'dynamic')
+  end
+  world:update(1/60)
+  local after = love.physics.getStepTime()
+  test:assertGreaterEqual(before, after, 'check step time only increases')
+  world:destroy()
+end
+
+
 -- love.physics.newBody
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.physics.newBody = function(test)
@@ -795,6 +1251,14 @@ love.test.physics.newRopeJoint = function(test)
 end
 
 
+-- love.physics.newSpatialIndex
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.physics.newSpatialIndex = function(test)
+  test:assertObject(love.physics.newSpatialIndex())
+  test:assertObject(love.physics.newSpatialIndex('grid', 16))
+end
+
+
 -- love.physics.newWeldJoint
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.physics.newWeldJoint = function(test)
@@ -0,0 +1,76 @@
+-- love.profiler
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+------------------------------------METHODS-------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- love.profiler.start, love.profiler.stop and love.profiler.isRunning
+love.test.profiler.start = function(test)
+  love.profiler.clear()
+  test:assertFalse(love.profiler.isRunning(), 'check not running by default')
+  love.profiler.push('ignored')
+  love.profiler.pop()
+  test:assertEquals(0, love.profiler.getZoneCount(), 'check no zones while stopped')
+
+  love.profiler.start(2)
+  test:assertTrue(love.profiler.isRunning(), 'check running after start')
+  for i=1,3 do
+    love.profiler.push('zone')
+    love.profiler.pop()
+  end
+  love.profiler.stop()
+  test:assertFalse(love.profiler.isRunning(), 'check stopped')
+
+  local count, dropped = love.profiler.getZoneCount()
+  test:assertEquals(2, count, 'check zones kept up to the limit')
+  test:assertEquals(1, dropped, 'check zones over the limit counted')
+  love.profiler.clear()
+  test:assertEquals(0, love.profiler.getZoneCount(), 'check clear')
+end
+
+
+-- love.profiler.push and love.profiler.pop
+love.test.profiler.push = function(test)
+  love.profiler.clear()
+  love.profiler.start()
+  love.profiler.push('outer')
+  love.profiler.push('inner')
+  love.profiler.pop()
+  love.profiler.pop()
+  love.profiler.stop()
+
+  local ok = pcall(love.profiler.pop)
+  test:assertFalse(ok, 'check unbalanced pop errors')
+
+  local totals = love.profiler.getZoneTotals()
+  local names = {}
+  for i, total in ipairs(totals) do
+    names[total.name] = total
+    test:assertGreaterEqual(0, total.time, 'check zone time')
+  end
+  test:assertNotNil(names.outer)
+  test:assertNotNil(names.inner)
+  test:assertEquals(1, names.outer.count, 'check zone count')
+  love.profiler.clear()
+end
+
+
+-- love.profiler.getChromeTrace
+love.test.profiler.getChromeTrace = function(test)
+  love.profiler.clear()
+  love.profiler.start()
+  love.profiler.push('quote"zone')
+  love.profiler.pop()
+  love.profiler.stop()
+
+  local trace = love.profiler.getChromeTrace()
+  test:assertEquals('string', type(trace), 'check trace type')
+  test:assertNotEquals(nil, trace:find('"traceEvents"', 1, true), 'check trace events')
+  test:assertNotEquals(nil, trace:find('"name":"quote\\"zone"', 1, true), 'check escaped name')
+  test:assertNotEquals(nil, trace:find('"ph":"X"', 1, true), 'check complete events')
+  love.profiler.clear()
+end
@@ -100,3 +100,21 @@ love.test.sensor.getData = function(test)
     test:skipTest('neither accelerometer nor gyroscope are supported in this system')
   end
 end
+
+
+-- love.sensor.setBuffered and love.sensor.getSamples
+love.test.sensor.setBuffered = function(test)
+  -- buffering doesn't need the sensor to exist
+  love.sensor.setBuffered('accelerometer', true, 60)
+  local buffered, rate = love.sensor.isBuffered('accelerometer')
+  test:assertTrue(buffered, 'check buffered')
+  test:assertEquals(60, rate, 'check rate')
+  -- check reading clears the buffer and reuses the table
+  local samples = {1, 2, 3, 4, 5}
+  love.sensor.getSamples('accelerometer')
+  local t, count = love.sensor.getSamples('accelerometer', samples)
+  test:assertEquals(samples, t, 'check table reused')
+  test:assertEquals(count * 4, #t, 'check 4 values per sample')
+  love.sensor.setBuffered('accelerometer', false)
+  test:assertFalse(love.sensor.isBuffered('accelerometer'), 'check not buffered')
+end
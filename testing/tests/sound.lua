@@ -92,6 +92,35 @@ love.test.sound.SoundData = function(test)
   local slice = copy1:slice(0, count)
   test:assertEquals(count, slice:getSampleCount(), 'check slice length')
 
+  -- check mixing clamps instead of wrapping
+  local mixa = love.sound.newSoundData(64, 44100, 16, 2)
+  local mixb = love.sound.newSoundData(64, 44100, 16, 2)
+  for i=0,127 do
+    mixa:setSample(i, 0.75)
+    mixb:setSample(i, 0.5)
+  end
+  mixa:mix(mixb, 1)
+  test:assertRange(mixa:getSample(0), 0.99, 1, 'check mix clamped')
+  mixb:mix(mixb, 0.5, 0, 32, 32)
+  test:assertRange(mixb:getSample(32, 1), 0.74, 0.76, 'check mix gain')
+  test:assertRange(mixb:getSample(0, 1), 0.49, 0.51, 'check mix range')
+
+  -- check fading, peak and normalizing
+  mixb:fade(1, 0)
+  test:assertRange(mixb:getSample(0, 1), 0.49, 0.51, 'check fade start')
+  test:assertEquals(0, mixb:getSample(63, 2), 'check fade end')
+  test:assertRange(mixb:getPeak(), 0.49, 0.51, 'check peak')
+  mixb:normalize(1)
+  test:assertRange(mixb:getPeak(), 0.99, 1, 'check normalized')
+
+  -- check resampling and converting
+  local resampled = mixa:resample(22050)
+  test:assertEquals(22050, resampled:getSampleRate(), 'check resample rate')
+  test:assertEquals(32, resampled:getSampleCount(), 'check resample count')
+  local converted = mixa:convert(8)
+  test:assertEquals(8, converted:getBitDepth(), 'check convert bit depth')
+  test:assertRange(converted:getSample(0), 0.99, 1, 'check convert sample')
+
 end
 
 
@@ -107,6 +136,17 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.sound.newDecoder = function(test)
   test:assertObject(love.sound.newDecoder('resources/click.ogg'))
+  -- check resampling while decoding
+  local resampled = love.sound.newDecoder('resources/click.ogg', nil, nil, {samplerate = 48000, quality = 'linear'})
+  test:assertObject(resampled)
+  test:assertEquals(48000, resampled:getSampleRate(), 'check decoder resampled')
+  local ok = pcall(love.sound.newDecoder, 'resources/click.ogg', nil, nil, {samplerate = 48000, quality = 'none'})
+  test:assertFalse(ok, 'check invalid quality')
+  -- check decoding a slice of a larger bundle through a DataView
+  local ogg = love.filesystem.read('resources/click.ogg')
+  local bundle = love.data.newByteData('header' .. ogg .. 'footer')
+  local fromview = love.sound.newDecoder(love.data.newDataView(bundle, 6, #ogg))
+  test:assertEquals(love.sound.newDecoder('resources/click.ogg'):getDuration(), fromview:getDuration(), 'check view duration')
 end
 
 
@@ -115,4 +155,8 @@ end
 love.test.sound.newSoundData = function(test)
   test:assertObject(love.sound.newSoundData('resources/click.ogg'))
   test:assertObject(love.sound.newSoundData(math.floor((1/32)*44100), 44100, 16, 1))
+  -- check resampling at decode time keeps the duration
+  local sdata = love.sound.newSoundData('resources/click.ogg', {samplerate = 22050})
+  test:assertEquals(22050, sdata:getSampleRate(), 'check sounddata resampled')
+  test:assertRange(sdata:getSampleCount(), 1462, 1465, 'check resampled sample count')
 end
@@ -8,6 +8,82 @@
 --------------------------------------------------------------------------------
 
 
+-- BoundedChannel (love.thread.newBoundedChannel)
+love.test.thread.BoundedChannel = function(test)
+
+  -- check capacity is rounded up to a power of two
+  local channel = love.thread.newBoundedChannel(6)
+  test:assertObject(channel)
+  test:assertEquals(8, channel:getCapacity(), 'check capacity')
+
+  -- check pushing stops when full
+  test:assertEquals(5, channel:pushMany({ 1, 2, 3, 4, 5 }), 'check push many')
+  test:assertTrue(channel:push('six'), 'check push')
+  test:assertEquals(2, channel:pushMany({ 7, 8, 9 }), 'check push many when nearly full')
+  test:assertFalse(channel:push(10), 'check push when full')
+  test:assertFalse(channel:supply(10, 0.01), 'check supply timeout')
+  test:assertEquals(8, channel:getCount(), 'check count')
+
+  -- check values come out in order
+  test:assertEquals(1, channel:pop(), 'check pop')
+  local values = channel:popMany(3)
+  test:assertEquals(3, #values, 'check pop many')
+  test:assertEquals(2, values[1], 'check pop many order 1')
+  test:assertEquals(4, values[3], 'check pop many order 3')
+  test:assertEquals('six', channel:demand(), 'check demand')
+  channel:clear()
+  test:assertEquals(0, channel:getCount(), 'check clear')
+  test:assertEquals(nil, channel:pop(), 'check pop when empty')
+  test:assertEquals(nil, channel:demand(0.01), 'check demand timeout')
+
+  -- check several workers can pull jobs from one channel
+  local jobs = love.thread.newBoundedChannel(64)
+  local results = love.thread.newBoundedChannel(64)
+  local workercode = [[
+    local jobs, results = ...
+    while true do
+      local job = jobs:demand()
+      if job == 'quit' then break end
+      results:supply(job * 2)
+    end
+  ]]
+  local workers = {}
+  for i=1,4 do
+    workers[i] = love.thread.newThread(workercode)
+    workers[i]:start(jobs, results)
+  end
+  local total = 0
+  for i=1,1000 do
+    jobs:supply(i)
+    for j,result in ipairs(results:popMany()) do total = total + result end
+  end
+  for i=1,4 do jobs:supply('quit') end
+  for i=1,4 do workers[i]:wait() end
+  for i,result in ipairs(results:popMany()) do total = total + result end
+  test:assertEquals(1000 * 1001, total, 'check worker results')
+
+  -- check threads can update one ByteData in place with atomics
+  local counters = love.data.newByteData(8)
+  local countercode = [[
+    require('love.data')
+    local counters = ...
+    for i=1,1000 do
+      counters:atomicAdd('int32', 0, 1)
+      counters:atomicAdd('uint32', 4, 2, 'relaxed')
+    end
+  ]]
+  local counterthreads = {}
+  for i=1,4 do
+    counterthreads[i] = love.thread.newThread(countercode)
+    counterthreads[i]:start(counters)
+  end
+  for i=1,4 do counterthreads[i]:wait() end
+  test:assertEquals(4000, counters:atomicLoad('int32', 0), 'check shared counter')
+  test:assertEquals(8000, counters:atomicLoad('uint32', 4), 'check shared relaxed counter')
+
+end
+
+
 -- Channel (love.thread.newChannel)
 love.test.thread.Channel = function(test)
 
@@ -76,6 +152,31 @@ love.test.thread.Channel = function(test)
   test:assertEquals('pong', msg4, 'check message recieved 2')
   test:assertEquals(0, channel:getCount())
 
+  -- check nested tables keep their contents
+  local long = string.rep('helloworld', 10)
+  channel:push({ 1, 'two', long, nested = { x = 3, y = { true, false } }, [4.5] = channel })
+  local msg5 = channel:pop()
+  test:assertEquals(1, msg5[1], 'check table number')
+  test:assertEquals('two', msg5[2], 'check table string')
+  test:assertEquals(long, msg5[3], 'check table long string')
+  test:assertEquals(3, msg5.nested.x, 'check nested table')
+  test:assertEquals(true, msg5.nested.y[1], 'check nested true')
+  test:assertEquals(false, msg5.nested.y[2], 'check nested false')
+  test:assertEquals(channel, msg5[4.5], 'check table object')
+
+  -- check transferring ByteData moves its memory rather than sharing it
+  local data = love.data.newByteData(long)
+  channel:push(data, true)
+  test:assertEquals(0, data:getSize(), 'check transferred data is empty')
+  local msg6 = channel:pop()
+  test:assertEquals(long, msg6:getString(), 'check transferred data')
+
+  -- check transferred strings arrive as ByteData
+  channel:push(long, true)
+  local msg7 = channel:pop()
+  test:assertEquals(long, msg7:getString(), 'check transferred string')
+  test:assertEquals(0, channel:getCount())
+
 end
 
 
@@ -123,6 +224,27 @@ love.test.thread.getChannel = function(test)
 end
 
 
+-- love.thread.getStatePool
+love.test.thread.getStatePool = function(test)
+  local size, modules = love.thread.getStatePool()
+  test:assertEquals(0, size, 'check pool off by default')
+  test:assertEquals(0, #modules, 'check no modules by default')
+end
+
+
+-- love.thread.getWorkerCount
+love.test.thread.getWorkerCount = function(test)
+  test:assertGreaterEqual(1, love.thread.getWorkerCount(), 'check at least one worker')
+end
+
+
+-- love.thread.newBoundedChannel
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.thread.newBoundedChannel = function(test)
+  test:assertObject(love.thread.newBoundedChannel(16))
+end
+
+
 -- love.thread.newChannel
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.thread.newChannel = function(test)
@@ -134,4 +256,78 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.thread.newThread = function(test)
   test:assertObject(love.thread.newThread('classes/TestSuite.lua'))
+  -- check thread settings are accepted, and the thread still runs
+  local settings = { name = 'Test worker', priority = 'low', affinity = 'performance' }
+  local thread = love.thread.newThread('local channel = ...\nchannel:push(1)', settings)
+  test:assertObject(thread)
+  local channel = love.thread.newChannel()
+  thread:start(channel)
+  thread:wait()
+  test:assertEquals(nil, thread:getError(), 'check thread ran')
+  test:assertEquals(1, channel:pop(), 'check thread result')
+  test:assertObject(love.thread.newThread('classes/TestSuite.lua', { affinity = { 1 } }))
+  local ok = pcall(love.thread.newThread, 'classes/TestSuite.lua', { priority = 'fastest' })
+  test:assertFalse(ok, 'check invalid priority')
+end
+
+
+-- love.thread.select
+love.test.thread.select = function(test)
+  local a = love.thread.newChannel()
+  local b = love.thread.newChannel()
+  test:assertEquals(nil, love.thread.select({ a, b }, 0), 'check timeout')
+  b:push('hello')
+  local channel, value = love.thread.select({ a, b }, 0)
+  test:assertEquals(b, channel, 'check channel')
+  test:assertEquals('hello', value, 'check value')
+  test:assertEquals(0, b:getCount(), 'check value popped')
+  -- check a push from another thread wakes up a blocking select
+  local thread = love.thread.newThread('local channel = ...\nchannel:push(5)')
+  thread:start(a)
+  channel, value = love.thread.select({ a, b })
+  thread:wait()
+  test:assertEquals(a, channel, 'check thread channel')
+  test:assertEquals(5, value, 'check thread value')
+end
+
+
+-- love.thread.setStatePool
+love.test.thread.setStatePool = function(test)
+  love.thread.setStatePool(2, { 'love.data' })
+  local size, modules = love.thread.getStatePool()
+  test:assertEquals(2, size, 'check pool size')
+  test:assertEquals('love.data', modules[1], 'check pool modules')
+  -- check pooled threads run, and globals don't leak between them
+  local code = [[
+    local channel = ...
+    channel:push(leaked == nil and love.data ~= nil)
+    leaked = true
+  ]]
+  local channel = love.thread.newChannel()
+  for i=1,4 do
+    local thread = love.thread.newThread(code)
+    thread:start(channel)
+    thread:wait()
+    test:assertEquals(nil, thread:getError(), 'check pooled thread ran')
+    test:assertTrue(channel:pop(), 'check clean pooled state')
+  end
+  local ok = pcall(love.thread.setStatePool, 1, { 'love.notamodule' })
+  test:assertFalse(ok, 'check invalid module')
+  test:assertEquals(2, love.thread.getStatePool(), 'check settings kept')
+  love.thread.setStatePool(0)
+  test:assertEquals(0, love.thread.getStatePool(), 'check pool disabled')
+end
+
+
+-- love.thread.setWorkerCount
+love.test.thread.setWorkerCount = function(test)
+  local count = love.thread.getWorkerCount()
+  love.thread.setWorkerCount(2)
+  test:assertEquals(2, love.thread.getWorkerCount(), 'check worker count set')
+  -- check jobs still run after the workers are restarted
+  local job = love.data.compressAsync('lz4', string.rep('helloworld', 1000))
+  job:wait()
+  test:assertEquals(nil, job:getError(), 'check job ran')
+  love.thread.setWorkerCount(count)
+  test:assertEquals(count, love.thread.getWorkerCount(), 'check worker count restored')
 end
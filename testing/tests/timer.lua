@@ -37,6 +37,20 @@ love.test.timer.getTime = function(test)
 end
 
 
+-- love.timer.setFrameLimit
+love.test.timer.setFrameLimit = function(test)
+  test:assertEquals(0, love.timer.getFrameLimit(), 'check no limit by default')
+  test:assertEquals(0, love.timer.waitForNextFrame(), 'check no wait without limit')
+  love.timer.setFrameLimit(20)
+  test:assertEquals(20, love.timer.getFrameLimit(), 'check limit set')
+  -- check frames are paced to the limit without drifting
+  local starttime = love.timer.getTime()
+  for i=1,5 do love.timer.waitForNextFrame() end
+  test:assertRange(love.timer.getTime() - starttime, 0.2, 0.35, 'check 5 frames take 0.25s')
+  love.timer.setFrameLimit(0)
+end
+
+
 -- love.timer.sleep
 love.test.timer.sleep = function(test)
   local starttime = love.timer.getTime()
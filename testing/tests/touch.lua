@@ -29,3 +29,15 @@ end
 love.test.touch.getTouches = function(test)
   test:assertEquals('function', type(love.touch.getTouches))
 end
+
+
+-- love.touch.getTouchState
+love.test.touch.getTouchState = function(test)
+  -- no touches are active while testing, so check stale entries are cleared
+  local state = {1, 2, 3, 4}
+  local t, count = love.touch.getTouchState(state)
+  test:assertEquals(state, t, 'check table reused')
+  test:assertEquals(count * 4, #t, 'check 4 values per touch')
+  local data = love.data.newByteData(32 * 10)
+  test:assertEquals(count, love.touch.getTouchState(data), 'check data count')
+end
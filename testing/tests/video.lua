@@ -26,9 +26,20 @@ love.test.video.VideoStream = function(test)
   test:assertRange(video:tell(), 0.3, 0.4, 'check seek/tell')
   video:rewind()
   test:assertRange(video:tell(), 0, 0.1, 'check rewind')
+  love.timer.sleep(0.1)
+  test:assertRange(video:tell(), 0.05, 0.5, 'check position advances while playing')
   video:pause()
   test:assertFalse(video:isPlaying(), 'check paused')
 
+  -- check frame queue
+  test:assertEquals(3, video:getFrameQueueDepth(), 'check def queue depth')
+  video:setFrameQueueDepth(6)
+  test:assertEquals(6, video:getFrameQueueDepth(), 'check set queue depth')
+  test:assertFalse(pcall(video.setFrameQueueDepth, video, 0), 'check invalid queue depth')
+  local presented, dropped = video:getFrameCounts()
+  test:assertGreaterEqual(0, presented, 'check presented count')
+  test:assertGreaterEqual(0, dropped, 'check dropped count')
+
 end
 
 
@@ -39,8 +50,35 @@ end
 --------------------------------------------------------------------------------
 
 
+-- love.video.getSupportedCodecs
+love.test.video.getSupportedCodecs = function(test)
+  local codecs = love.video.getSupportedCodecs()
+  test:assertTrue(codecs.theora, 'check theora supported')
+  for _, codec in ipairs({'h264', 'h265', 'av1'}) do
+    test:assertEquals('boolean', type(codecs[codec]), 'check ' .. codec .. ' listed')
+  end
+end
+
+
 -- love.video.newVideoStream
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.video.newVideoStream = function(test)
   test:assertObject(love.video.newVideoStream('resources/sample.ogv'))
+
+  -- unsupported codecs in recognized containers give a specific error
+  if not love.video.getSupportedCodecs().h264 then
+    local function be32(n)
+      return string.char(math.floor(n / 16777216) % 256, math.floor(n / 65536) % 256, math.floor(n / 256) % 256, n % 256)
+    end
+    local function box(boxtype, body)
+      return be32(#body + 8) .. boxtype .. body
+    end
+    local stsd = box('stsd', string.rep('\0', 7) .. '\1' .. box('avc1', string.rep('\0', 78)))
+    local moov = box('moov', box('trak', box('mdia', box('minf', box('stbl', stsd)))))
+    love.filesystem.write('h264.mp4', box('ftyp', 'isom0000') .. moov)
+    local ok, err = pcall(love.video.newVideoStream, 'h264.mp4')
+    test:assertFalse(ok, 'check h264 not decoded')
+    test:assertNotEquals(nil, string.find(err, 'H.264', 1, true), 'check h264 error names codec')
+    love.filesystem.remove('h264.mp4')
+  end
 end
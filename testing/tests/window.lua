@@ -166,11 +166,27 @@ love.test.window.isDisplaySleepEnabled = function(test)
 end
 
 
+-- love.window.isHeadless
+love.test.window.isHeadless = function(test)
+  test:assertEquals(HEADLESS, love.window.isHeadless(), 'check headless matches args')
+  -- headless windows still render and can be read back
+  local canvas = love.graphics.newCanvas(4, 4)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas()
+  local r, g = love.graphics.readbackTexture(canvas):getPixel(0, 0)
+  test:assertEquals('1,0', r .. ',' .. g, 'check canvas rendered')
+end
+
+
 -- love.window.isMaximized
 love.test.window.isMaximized = function(test)
   if GITHUB_RUNNER and test:isOS('Linux') then
     return test:skipTest("xvfb on Linux doesn't support window maximization")
   end
+  if HEADLESS then
+    return test:skipTest("headless windows can't be maximized")
+  end
 
   test:assertFalse(love.window.isMaximized(), 'check window not maximized')
   love.window.maximize()
@@ -186,6 +202,9 @@ love.test.window.isMinimized = function(test)
   if GITHUB_RUNNER and test:isOS('Linux') then
     return test:skipTest("xvfb on Linux doesn't support window minimization")
   end
+  if HEADLESS then
+    return test:skipTest("headless windows can't be minimized")
+  end
 
   -- check not minimized to start
   test:assertFalse(love.window.isMinimized(), 'check window not minimized')
@@ -341,6 +360,27 @@ love.test.window.setPosition = function(test)
 end
 
 
+-- love.window.setPresentMode
+love.test.window.setPresentMode = function(test)
+  local vsync = love.window.getVSync()
+  -- unsupported modes fall back, so only check a valid mode is in use
+  local modes = { fifo = true, fiforelaxed = true, mailbox = true, immediate = true }
+  for mode in pairs(modes) do
+    love.window.setPresentMode(mode)
+    test:waitFrames(1)
+    test:assertTrue(modes[love.window.getPresentMode()], 'check ' .. mode .. ' gives a valid mode')
+  end
+  -- fifo is always supported
+  love.window.setPresentMode('fifo')
+  test:waitFrames(1)
+  test:assertEquals('fifo', love.window.getPresentMode(), 'check fifo')
+  test:assertEquals(1, love.window.getVSync(), 'check fifo is vsync')
+  local ok = pcall(love.window.setPresentMode, 'fast')
+  test:assertFalse(ok, 'check invalid mode errors')
+  love.window.setVSync(vsync)
+end
+
+
 -- love.window.setTitle
 love.test.window.setTitle = function(test)
   -- check setting title val is returned